@@ -0,0 +1,218 @@
+/**
+ * @file ann_layer_benchmark.cpp
+ *
+ * Benchmarks for the Forward(), Backward() and Gradient() passes of some of the
+ * neural network layers, for several batch sizes and element types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmarks;
+
+//! Register the batch sizes to benchmark.
+static void BatchArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({ "batch" });
+  for (long batch : { 1, 32, 256 })
+    b->Arg(batch);
+}
+
+/**
+ * A fully connected layer with 256 inputs and 256 outputs.  Each fixture holds
+ * a layer with random parameters, a random input batch, and the output of a
+ * forward pass, so that the three passes can be run independently.
+ */
+template<typename MatType>
+class LinearFixture
+{
+ public:
+  LinearFixture(const size_t batchSize) : layer(256, 256)
+  {
+    layer.Parameters().randu();
+    layer.Reset();
+    input.randu(256, batchSize);
+    Forward();
+    error.randu(output.n_rows, output.n_cols);
+    gradient.set_size(layer.Parameters().n_rows, layer.Parameters().n_cols);
+  }
+
+  void Forward() { layer.Forward(std::move(input), std::move(output)); }
+
+  void Backward()
+  {
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+  }
+
+  void Gradient()
+  {
+    layer.Gradient(std::move(input), std::move(error), std::move(gradient));
+  }
+
+ private:
+  Linear<MatType, MatType> layer;
+  MatType input, output, error, delta, gradient;
+};
+
+/**
+ * A convolution of 28x28 images (the size of MNIST digits) with eight 5x5
+ * filters.
+ */
+template<typename MatType>
+class ConvolutionFixture
+{
+ public:
+  ConvolutionFixture(const size_t batchSize) :
+      layer(1, 8, 5, 5, 1, 1, 0, 0, 28, 28)
+  {
+    layer.Parameters().randu();
+    layer.Reset();
+    input.randu(28 * 28, batchSize);
+    Forward();
+    error.randu(output.n_rows, output.n_cols);
+  }
+
+  void Forward() { layer.Forward(std::move(input), std::move(output)); }
+
+  void Backward()
+  {
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+  }
+
+  void Gradient()
+  {
+    layer.Gradient(std::move(input), std::move(error), std::move(gradient));
+  }
+
+ private:
+  Convolution<Im2ColConvolution<ValidConvolution>,
+              Im2ColConvolution<FullConvolution>,
+              Im2ColConvolution<ValidConvolution>,
+              MatType, MatType> layer;
+  MatType input, output, error, delta, gradient;
+};
+
+/**
+ * 2x2 max pooling of the eight 24x24 maps given by the convolution above.  The
+ * layer has no parameters, so it has no Gradient() benchmark.
+ */
+class MaxPoolingFixture
+{
+ public:
+  MaxPoolingFixture(const size_t batchSize) : layer(2, 2, 2, 2)
+  {
+    layer.InputWidth() = 24;
+    layer.InputHeight() = 24;
+    // The pooling indices are only kept by non-deterministic passes.
+    layer.Deterministic() = false;
+    input.randu(24 * 24 * 8, batchSize);
+    Forward();
+    error.randu(output.n_rows, output.n_cols);
+  }
+
+  void Forward() { layer.Forward(std::move(input), std::move(output)); }
+
+  void Backward()
+  {
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+  }
+
+ private:
+  MaxPooling<> layer;
+  arma::mat input, output, error, delta;
+};
+
+/**
+ * Batch normalization of 256 units, in training mode.
+ */
+class BatchNormFixture
+{
+ public:
+  BatchNormFixture(const size_t batchSize) : layer(256)
+  {
+    layer.Reset();
+    layer.Deterministic() = false;
+    input.randu(256, batchSize);
+    Forward();
+    error.randu(output.n_rows, output.n_cols);
+  }
+
+  void Forward() { layer.Forward(std::move(input), std::move(output)); }
+
+  void Backward()
+  {
+    layer.Backward(std::move(input), std::move(error), std::move(delta));
+  }
+
+  void Gradient()
+  {
+    layer.Gradient(std::move(input), std::move(error), std::move(gradient));
+  }
+
+ private:
+  BatchNorm<> layer;
+  arma::mat input, output, error, delta, gradient;
+};
+
+//! Run the forward pass of the fixture's layer on a batch.
+template<typename FixtureType>
+static void LayerForward(benchmark::State& state)
+{
+  FixtureType fixture((size_t) state.range(0));
+  for (auto _ : state)
+    fixture.Forward();
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! Run the backward pass of the fixture's layer on a batch.
+template<typename FixtureType>
+static void LayerBackward(benchmark::State& state)
+{
+  FixtureType fixture((size_t) state.range(0));
+  for (auto _ : state)
+    fixture.Backward();
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//! Compute the gradient of the parameters of the fixture's layer on a batch.
+template<typename FixtureType>
+static void LayerGradient(benchmark::State& state)
+{
+  FixtureType fixture((size_t) state.range(0));
+  for (auto _ : state)
+    fixture.Gradient();
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+typedef LinearFixture<arma::mat> LinearDouble;
+typedef LinearFixture<arma::fmat> LinearFloat;
+typedef ConvolutionFixture<arma::mat> ConvolutionDouble;
+typedef ConvolutionFixture<arma::fmat> ConvolutionFloat;
+
+#define MLPACK_LAYER_BENCHMARK(FIXTURE) \
+    BENCHMARK_TEMPLATE(LayerForward, FIXTURE)->Apply(BatchArguments)-> \
+        Unit(benchmark::kMicrosecond); \
+    BENCHMARK_TEMPLATE(LayerBackward, FIXTURE)->Apply(BatchArguments)-> \
+        Unit(benchmark::kMicrosecond)
+
+#define MLPACK_PARAMETRIC_LAYER_BENCHMARK(FIXTURE) \
+    MLPACK_LAYER_BENCHMARK(FIXTURE); \
+    BENCHMARK_TEMPLATE(LayerGradient, FIXTURE)->Apply(BatchArguments)-> \
+        Unit(benchmark::kMicrosecond)
+
+MLPACK_PARAMETRIC_LAYER_BENCHMARK(LinearDouble);
+MLPACK_PARAMETRIC_LAYER_BENCHMARK(LinearFloat);
+MLPACK_PARAMETRIC_LAYER_BENCHMARK(ConvolutionDouble);
+MLPACK_PARAMETRIC_LAYER_BENCHMARK(ConvolutionFloat);
+MLPACK_LAYER_BENCHMARK(MaxPoolingFixture);
+MLPACK_PARAMETRIC_LAYER_BENCHMARK(BatchNormFixture);
@@ -0,0 +1,198 @@
+/**
+ * @file ann_training_benchmark.cpp
+ *
+ * Benchmarks of the number of samples per second with which small networks are
+ * trained (and, for recurrent networks, evaluated), for several batch sizes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/rnn.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmarks;
+
+//! Register the batch sizes to benchmark.
+static void BatchArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({ "batch" });
+  for (long batch : { 1, 32, 256 })
+    b->Arg(batch);
+}
+
+/**
+ * Fill the given matrix (or cube) with random labels between 1 and the given
+ * number of classes, as NegativeLogLikelihood expects them.
+ */
+template<typename T>
+static void RandomLabels(T& labels, const size_t numClasses)
+{
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, numClasses + 1);
+}
+
+/**
+ * A multilayer perceptron with two hidden layers of 128 and 64 units, on 4096
+ * random points in 784 dimensions (the size of MNIST digits) with 10 classes.
+ */
+class MLPSource
+{
+ public:
+  typedef FFN<NegativeLogLikelihood<>, RandomInitialization> ModelType;
+  typedef arma::mat DataType;
+
+  static ModelType* Create()
+  {
+    ModelType* model = new ModelType();
+    model->Add<Linear<>>(784, 128);
+    model->Add<ReLULayer<>>();
+    model->Add<Linear<>>(128, 64);
+    model->Add<ReLULayer<>>();
+    model->Add<Linear<>>(64, 10);
+    model->Add<LogSoftMax<>>();
+    return model;
+  }
+
+  static void Data(DataType& predictors, DataType& responses)
+  {
+    math::RandomSeed(784);
+    predictors.randu(784, 4096);
+    responses.set_size(1, 4096);
+    RandomLabels(responses, 10);
+  }
+};
+
+/**
+ * A convolutional network like LeNet, on 512 random 28x28 images (the size of
+ * MNIST digits) with 10 classes.
+ */
+class CNNSource
+{
+ public:
+  typedef FFN<NegativeLogLikelihood<>, RandomInitialization> ModelType;
+  typedef arma::mat DataType;
+
+  static ModelType* Create()
+  {
+    ModelType* model = new ModelType();
+    model->Add<Convolution<>>(1, 8, 5, 5, 1, 1, 0, 0, 28, 28);
+    model->Add<ReLULayer<>>();
+    model->Add<MaxPooling<>>(2, 2, 2, 2);
+    model->Add<Convolution<>>(8, 16, 5, 5, 1, 1, 0, 0, 12, 12);
+    model->Add<ReLULayer<>>();
+    model->Add<MaxPooling<>>(2, 2, 2, 2);
+    model->Add<Linear<>>(16 * 4 * 4, 64);
+    model->Add<ReLULayer<>>();
+    model->Add<Linear<>>(64, 10);
+    model->Add<LogSoftMax<>>();
+    return model;
+  }
+
+  static void Data(DataType& predictors, DataType& responses)
+  {
+    math::RandomSeed(28);
+    predictors.randu(28 * 28, 512);
+    responses.set_size(1, 512);
+    RandomLabels(responses, 10);
+  }
+};
+
+/**
+ * A recurrent network with one recurrent layer of 64 units, on 512 random
+ * sequences of 10 steps of 32 dimensions, with 10 classes at each step.
+ */
+template<typename RecurrentLayerType>
+class RecurrentSource
+{
+ public:
+  typedef RNN<NegativeLogLikelihood<>, RandomInitialization> ModelType;
+  typedef arma::cube DataType;
+
+  static ModelType* Create()
+  {
+    ModelType* model = new ModelType(10);
+    model->Add<IdentityLayer<>>();
+    model->Add<Linear<>>(32, 64);
+    model->Add<RecurrentLayerType>(64, 64, 10);
+    model->Add<Linear<>>(64, 10);
+    model->Add<LogSoftMax<>>();
+    return model;
+  }
+
+  static void Data(DataType& predictors, DataType& responses)
+  {
+    math::RandomSeed(10);
+    predictors.randu(32, 512, 10);
+    responses.set_size(1, 512, 10);
+    RandomLabels(responses, 10);
+  }
+};
+
+typedef RecurrentSource<LSTM<>> LSTMSource;
+typedef RecurrentSource<GRU<>> GRUSource;
+
+/**
+ * Train the network of the given source for one epoch of its dataset in each
+ * iteration, with batches of the size given by the benchmark argument.  The
+ * network is trained from where the previous iteration left it.
+ */
+template<typename SourceType>
+static void TrainEpoch(benchmark::State& state)
+{
+  typename SourceType::DataType predictors, responses;
+  SourceType::Data(predictors, responses);
+  std::unique_ptr<typename SourceType::ModelType> model(SourceType::Create());
+
+  const size_t batchSize = (size_t) state.range(0);
+  const size_t points = predictors.n_cols;
+  ens::StandardSGD optimizer(0.001, batchSize, points, -1.0, true);
+  for (auto _ : state)
+    model->Train(predictors, responses, optimizer);
+
+  state.SetItemsProcessed(state.iterations() * points);
+}
+
+/**
+ * Predict the outputs of every sequence with the recurrent network of the
+ * given source, with batches of the size given by the benchmark argument:
+ * this is the forward pass of the recurrent layer over whole sequences.
+ */
+template<typename SourceType>
+static void PredictSequences(benchmark::State& state)
+{
+  typename SourceType::DataType predictors, responses;
+  SourceType::Data(predictors, responses);
+  std::unique_ptr<typename SourceType::ModelType> model(SourceType::Create());
+
+  // Train for one epoch first, so that the parameters are initialized.
+  ens::StandardSGD optimizer(0.001, 32, predictors.n_cols, -1.0, true);
+  model->Train(predictors, responses, optimizer);
+
+  const size_t batchSize = (size_t) state.range(0);
+  arma::cube results;
+  for (auto _ : state)
+    model->Predict(predictors, results, batchSize);
+
+  state.SetItemsProcessed(state.iterations() * predictors.n_cols);
+}
+
+#define MLPACK_TRAINING_BENCHMARK(SOURCE) \
+    BENCHMARK_TEMPLATE(TrainEpoch, SOURCE)->Apply(BatchArguments)-> \
+        Unit(benchmark::kMillisecond)
+
+#define MLPACK_RECURRENT_BENCHMARK(SOURCE) \
+    MLPACK_TRAINING_BENCHMARK(SOURCE); \
+    BENCHMARK_TEMPLATE(PredictSequences, SOURCE)->Apply(BatchArguments)-> \
+        Unit(benchmark::kMillisecond)
+
+MLPACK_TRAINING_BENCHMARK(MLPSource);
+MLPACK_TRAINING_BENCHMARK(CNNSource);
+MLPACK_RECURRENT_BENCHMARK(LSTMSource);
+MLPACK_RECURRENT_BENCHMARK(GRUSource);
@@ -0,0 +1,224 @@
+/**
+ * @file benchmark_data.hpp
+ *
+ * Datasets for the mlpack benchmarks.  A benchmark is templated on a dataset
+ * source (SyntheticData or RealData), which registers the arguments of the
+ * benchmark and gives the dataset for each of them.  All datasets are scaled
+ * to the unit cube, so that search radii and bandwidths can be chosen in the
+ * same way for all of them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_DATA_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_DATA_HPP
+
+#include <mlpack/core.hpp>
+#include <benchmark/benchmark.h>
+
+#ifndef _WIN32
+  #include <sys/resource.h>
+#endif
+
+#ifndef MLPACK_BENCHMARK_DATA_DIR
+  #define MLPACK_BENCHMARK_DATA_DIR ""
+#endif
+
+namespace mlpack {
+namespace benchmarks {
+
+/**
+ * Scale each dimension of the given dataset to [0, 1].
+ *
+ * @param dataset Dataset to scale.
+ */
+inline void ScaleToUnitCube(arma::mat& dataset)
+{
+  for (size_t i = 0; i < dataset.n_rows; ++i)
+  {
+    const double minVal = dataset.row(i).min();
+    const double maxVal = dataset.row(i).max();
+    if (maxVal > minVal)
+      dataset.row(i) = (dataset.row(i) - minVal) / (maxVal - minVal);
+    else
+      dataset.row(i).zeros();
+  }
+}
+
+/**
+ * Return a radius that should contain about the given number of points of an
+ * evenly spread dataset in the unit cube, around each point.
+ *
+ * @param dataset Dataset in the unit cube.
+ * @param neighbors Expected number of points within the radius.
+ */
+inline double NeighborhoodRadius(const arma::mat& dataset,
+                                 const double neighbors = 10.0)
+{
+  // Volume of the unit ball in the dimensionality of the dataset.
+  const double d = dataset.n_rows;
+  const double ballVolume = std::pow(M_PI, d / 2.0) / std::tgamma(d / 2.0 + 1);
+  return std::pow(neighbors / (dataset.n_cols * ballVolume), 1.0 / d);
+}
+
+/**
+ * Uniformly distributed random points.  The arguments of the benchmark are the
+ * number of points and the dimensionality.
+ */
+class SyntheticData
+{
+ public:
+  //! Register the sizes and dimensionalities to benchmark.
+  static void Arguments(benchmark::internal::Benchmark* b)
+  {
+    b->ArgNames({ "points", "dims" });
+    for (long points : { 1000, 10000, 100000 })
+      for (long dims : { 3, 10 })
+        b->Args({ points, dims });
+  }
+
+  /**
+   * Get the dataset for the arguments of the given state.  The dataset is only
+   * generated once for each size and dimensionality.
+   */
+  static const arma::mat& Dataset(benchmark::State& state)
+  {
+    static std::map<std::pair<size_t, size_t>, arma::mat> datasets;
+
+    const std::pair<size_t, size_t> key((size_t) state.range(0),
+        (size_t) state.range(1));
+    if (datasets.count(key) == 0)
+    {
+      // Use a fixed seed, so that the runs are comparable.
+      math::RandomSeed(key.first + key.second);
+      datasets[key] = arma::randu<arma::mat>(key.second, key.first);
+    }
+
+    return datasets[key];
+  }
+};
+
+/**
+ * Some of the real datasets that are used by the tests.  The argument of the
+ * benchmark is the index of the dataset.
+ */
+class RealData
+{
+ public:
+  //! Register the datasets to benchmark.
+  static void Arguments(benchmark::internal::Benchmark* b)
+  {
+    b->ArgNames({ "dataset" });
+    for (size_t i = 0; i < Files().size(); ++i)
+      b->Arg((long) i);
+  }
+
+  /**
+   * Get the dataset for the argument of the given state.  The dataset is only
+   * loaded once.  If it cannot be loaded, the benchmark is marked as skipped
+   * and an empty matrix is returned.
+   */
+  static const arma::mat& Dataset(benchmark::State& state)
+  {
+    static std::map<size_t, arma::mat> datasets;
+
+    const size_t index = (size_t) state.range(0);
+    state.SetLabel(Files()[index]);
+    if (datasets.count(index) == 0)
+    {
+      arma::mat dataset;
+      if (data::Load(std::string(MLPACK_BENCHMARK_DATA_DIR) + Files()[index],
+          dataset, false))
+        ScaleToUnitCube(dataset);
+      datasets[index] = std::move(dataset);
+    }
+
+    // Benchmarks must return without running if the dataset is empty.
+    if (datasets[index].n_elem == 0)
+      state.SkipWithError("could not load dataset");
+
+    return datasets[index];
+  }
+
+ private:
+  //! The names of the dataset files.
+  static const std::vector<std::string>& Files()
+  {
+    static const std::vector<std::string> files = { "vc2.csv",
+        "rann_test_r_3_900.csv", "test_data_3_1000.csv", "thyroid_train.csv" };
+    return files;
+  }
+};
+
+/**
+ * Report the number of points processed per second for the given state.
+ *
+ * @param state State of the benchmark.
+ * @param dataset Dataset that was processed in each iteration.
+ */
+inline void SetPointsProcessed(benchmark::State& state,
+                               const arma::mat& dataset)
+{
+  state.SetItemsProcessed(state.iterations() * dataset.n_cols);
+}
+
+/**
+ * Return the size of the given file in bytes, or 0 if it can't be opened.
+ *
+ * @param filename Name of the file.
+ */
+inline size_t FileSize(const std::string& filename)
+{
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary |
+      std::ios::ate);
+  return stream.is_open() ? (size_t) stream.tellg() : 0;
+}
+
+/**
+ * Report the number of bytes of the given file processed per second for the
+ * given state (Google Benchmark shows it as a rate, e.g. MB/s), and the size
+ * of the file in MB.
+ *
+ * @param state State of the benchmark.
+ * @param filename File that was read or written in each iteration.
+ */
+inline void SetFileBytesProcessed(benchmark::State& state,
+                                  const std::string& filename)
+{
+  const size_t size = FileSize(filename);
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["file_mb"] = size / 1048576.0;
+}
+
+/**
+ * Report the peak resident memory of the process so far, in MB, for the given
+ * state.  Since this is the peak of the whole process, it is only an upper
+ * bound of the memory of the benchmark when other benchmarks ran before it;
+ * run a single benchmark (with --benchmark_filter) for an exact value.  It is
+ * not reported on Windows.
+ *
+ * @param state State of the benchmark.
+ */
+inline void SetPeakMemory(benchmark::State& state)
+{
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  {
+    #ifdef __APPLE__
+      // ru_maxrss is in bytes on macOS.
+      state.counters["peak_rss_mb"] = usage.ru_maxrss / 1048576.0;
+    #else
+      // ru_maxrss is in kilobytes on Linux and the BSDs.
+      state.counters["peak_rss_mb"] = usage.ru_maxrss / 1024.0;
+    #endif
+  }
+#endif
+}
+
+} // namespace benchmarks
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,15 @@
+/**
+ * @file benchmark_main.cpp
+ *
+ * Entry point of the mlpack benchmarks.  Run `mlpack_benchmarks --help` for the
+ * options of Google Benchmark, e.g. `--benchmark_filter=KNN` to run only the
+ * nearest neighbor search benchmarks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,60 @@
+/**
+ * @file emst_benchmark.cpp
+ *
+ * Benchmarks for the dual-tree Boruvka minimum spanning tree algorithm with
+ * each of the trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::emst;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+typedef DualTreeBoruvka<EuclideanDistance, arma::mat, KDTree> KDTreeDTB;
+typedef DualTreeBoruvka<EuclideanDistance, arma::mat, BallTree> BallTreeDTB;
+typedef DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+    CoverTreeDTB;
+
+/**
+ * Compute the minimum spanning tree of the dataset.  The tree of the dataset is
+ * built before the timing of each iteration, since the tree statistics are
+ * changed by the computation.
+ */
+template<typename DTBType, typename DataType>
+static void DualTreeEMST(benchmark::State& state)
+{
+  const arma::mat& dataset = DataType::Dataset(state);
+  if (dataset.n_elem == 0)
+    return;
+
+  arma::mat results;
+  for (auto _ : state)
+  {
+    state.PauseTiming();
+    DTBType dtb(dataset);
+    state.ResumeTiming();
+
+    dtb.ComputeMST(results);
+  }
+
+  SetPointsProcessed(state, dataset);
+}
+
+#define MLPACK_DTB_BENCHMARK(DTB) \
+    BENCHMARK_TEMPLATE(DualTreeEMST, DTB, SyntheticData)-> \
+        Apply(SyntheticData::Arguments)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(DualTreeEMST, DTB, RealData)-> \
+        Apply(RealData::Arguments)->Unit(benchmark::kMillisecond)
+
+MLPACK_DTB_BENCHMARK(KDTreeDTB);
+MLPACK_DTB_BENCHMARK(BallTreeDTB);
+MLPACK_DTB_BENCHMARK(CoverTreeDTB);
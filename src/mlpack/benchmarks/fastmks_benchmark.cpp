@@ -0,0 +1,53 @@
+/**
+ * @file fastmks_benchmark.cpp
+ *
+ * Benchmarks for dual-tree max-kernel search (FastMKS), which uses cover trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::fastmks;
+using namespace mlpack::kernel;
+
+typedef FastMKS<LinearKernel> LinearFastMKS;
+typedef FastMKS<PolynomialKernel> PolynomialFastMKS;
+
+/**
+ * Find the 5 largest kernel values for every point of the dataset with a
+ * monochromatic dual-tree search.  The reference tree is built before the
+ * timing.
+ */
+template<typename FastMKSType, typename DataType>
+static void DualTreeFastMKS(benchmark::State& state)
+{
+  const arma::mat& dataset = DataType::Dataset(state);
+  if (dataset.n_elem == 0)
+    return;
+
+  FastMKSType fastmks(dataset);
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  for (auto _ : state)
+    fastmks.Search(5, indices, kernels);
+
+  SetPointsProcessed(state, dataset);
+}
+
+#define MLPACK_FASTMKS_BENCHMARK(FASTMKS) \
+    BENCHMARK_TEMPLATE(DualTreeFastMKS, FASTMKS, SyntheticData)-> \
+        Apply(SyntheticData::Arguments)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(DualTreeFastMKS, FASTMKS, RealData)-> \
+        Apply(RealData::Arguments)->Unit(benchmark::kMillisecond)
+
+MLPACK_FASTMKS_BENCHMARK(LinearFastMKS);
+MLPACK_FASTMKS_BENCHMARK(PolynomialFastMKS);
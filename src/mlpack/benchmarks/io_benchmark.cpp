@@ -0,0 +1,142 @@
+/**
+ * @file io_benchmark.cpp
+ *
+ * Benchmarks for loading and saving datasets with data::Load() and
+ * data::Save(), in each of the common formats.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+/**
+ * Register the sizes of the datasets to load and save; there are 10 dimensions,
+ * so that the files are mostly made of numbers rather than delimiters.
+ */
+static void IOArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({ "points", "dims" });
+  for (long points : { 10000, 100000, 1000000 })
+    b->Args({ points, 10 });
+}
+
+//! The name of the file with the given extension used by the benchmarks.
+static std::string BenchmarkFile(const std::string& extension)
+{
+  return "mlpack_io_benchmark." + extension;
+}
+
+/**
+ * Write the given dataset to the given file.  data::Save() can't write ARFF or
+ * TSV files, so they are written here; ARFF files have one numeric attribute
+ * per dimension.
+ */
+static void WriteDataset(const arma::mat& dataset,
+                         const std::string& filename,
+                         const std::string& extension)
+{
+  if (extension != "arff" && extension != "tsv")
+  {
+    data::Save(filename, dataset, true);
+    return;
+  }
+
+  std::ofstream stream(filename.c_str());
+  stream.precision(17);
+  const char* delimiter = ",";
+  if (extension == "arff")
+  {
+    stream << "@relation benchmark" << std::endl;
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+      stream << "@attribute dim" << d << " numeric" << std::endl;
+    stream << "@data" << std::endl;
+  }
+  else
+  {
+    delimiter = "\t";
+  }
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t d = 0; d < dataset.n_rows; ++d)
+      stream << (d == 0 ? "" : delimiter) << dataset(d, i);
+    stream << std::endl;
+  }
+}
+
+/**
+ * Load a dataset of the given format, which is written before the timing.  The
+ * rate is the size of the file read per second of wall clock time, since some
+ * of the loaders use several threads.
+ */
+static void LoadDataset(benchmark::State& state, const std::string& extension)
+{
+  const arma::mat& dataset = SyntheticData::Dataset(state);
+  const std::string filename = BenchmarkFile(extension);
+  WriteDataset(dataset, filename, extension);
+
+  arma::mat loaded;
+  for (auto _ : state)
+  {
+    if (extension == "arff")
+    {
+      data::DatasetInfo info;
+      data::Load(filename, loaded, info, true);
+    }
+    else
+    {
+      data::Load(filename, loaded, true);
+    }
+  }
+
+  SetFileBytesProcessed(state, filename);
+  SetPeakMemory(state);
+  std::remove(filename.c_str());
+}
+
+/**
+ * Save a dataset in the given format; data::Save() writes whitespace-separated
+ * values as .txt rather than .tsv.  The rate is the size of the file written
+ * per second of wall clock time.
+ */
+static void SaveDataset(benchmark::State& state, const std::string& extension)
+{
+  const arma::mat& dataset = SyntheticData::Dataset(state);
+  const std::string filename = BenchmarkFile(extension);
+
+  for (auto _ : state)
+    data::Save(filename, dataset, true);
+
+  SetFileBytesProcessed(state, filename);
+  SetPeakMemory(state);
+  std::remove(filename.c_str());
+}
+
+#define MLPACK_LOAD_BENCHMARK(EXTENSION) \
+    BENCHMARK_CAPTURE(LoadDataset, EXTENSION, std::string(#EXTENSION))-> \
+        Apply(IOArguments)->Unit(benchmark::kMillisecond)->UseRealTime()
+
+#define MLPACK_SAVE_BENCHMARK(EXTENSION) \
+    BENCHMARK_CAPTURE(SaveDataset, EXTENSION, std::string(#EXTENSION))-> \
+        Apply(IOArguments)->Unit(benchmark::kMillisecond)->UseRealTime()
+
+MLPACK_LOAD_BENCHMARK(csv);
+MLPACK_LOAD_BENCHMARK(tsv);
+MLPACK_LOAD_BENCHMARK(txt);
+MLPACK_LOAD_BENCHMARK(arff);
+MLPACK_LOAD_BENCHMARK(bin);
+
+MLPACK_SAVE_BENCHMARK(csv);
+MLPACK_SAVE_BENCHMARK(txt);
+MLPACK_SAVE_BENCHMARK(bin);
+
+#ifdef ARMA_USE_HDF5
+MLPACK_LOAD_BENCHMARK(h5);
+MLPACK_SAVE_BENCHMARK(h5);
+#endif
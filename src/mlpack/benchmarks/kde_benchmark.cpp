@@ -0,0 +1,63 @@
+/**
+ * @file kde_benchmark.cpp
+ *
+ * Benchmarks for dual-tree kernel density estimation with each of the trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree> KDTreeKDE;
+typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, BallTree>
+    BallTreeKDE;
+typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, StandardCoverTree>
+    CoverTreeKDE;
+typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, RStarTree>
+    RStarTreeKDE;
+typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, Octree> OctreeKDE;
+
+/**
+ * Estimate the density at every point of the dataset, with a relative error of
+ * 5%.  The bandwidth is the radius that holds about 10 points, for evenly
+ * spread data.  The reference tree is built before the timing, but the query
+ * tree is built by each call to Evaluate().
+ */
+template<typename KDEType, typename DataType>
+static void DualTreeKDE(benchmark::State& state)
+{
+  const arma::mat& dataset = DataType::Dataset(state);
+  if (dataset.n_elem == 0)
+    return;
+
+  KDEType kde(0.05, 0.0, GaussianKernel(NeighborhoodRadius(dataset)));
+  kde.Train(dataset);
+  arma::vec estimations;
+  for (auto _ : state)
+    kde.Evaluate(dataset, estimations);
+
+  SetPointsProcessed(state, dataset);
+}
+
+#define MLPACK_KDE_BENCHMARK(KDETYPE) \
+    BENCHMARK_TEMPLATE(DualTreeKDE, KDETYPE, SyntheticData)-> \
+        Apply(SyntheticData::Arguments)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(DualTreeKDE, KDETYPE, RealData)-> \
+        Apply(RealData::Arguments)->Unit(benchmark::kMillisecond)
+
+MLPACK_KDE_BENCHMARK(KDTreeKDE);
+MLPACK_KDE_BENCHMARK(BallTreeKDE);
+MLPACK_KDE_BENCHMARK(CoverTreeKDE);
+MLPACK_KDE_BENCHMARK(RStarTreeKDE);
+MLPACK_KDE_BENCHMARK(OctreeKDE);
@@ -0,0 +1,74 @@
+/**
+ * @file neighbor_search_benchmark.cpp
+ *
+ * Benchmarks for dual-tree k-nearest-neighbor search with each of the trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    KDTree> KDTreeKNN;
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    BallTree> BallTreeKNN;
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    StandardCoverTree> CoverTreeKNN;
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    RStarTree> RStarTreeKNN;
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    Octree> OctreeKNN;
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    UBTree> UBTreeKNN;
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    VPTree> VPTreeKNN;
+// Spill trees use the defeatist traversals, so the search is approximate.
+typedef SpillKNN SpillTreeKNN;
+
+/**
+ * Find the 5 nearest neighbors of every point of the dataset with a
+ * monochromatic dual-tree search.  The reference tree is built before the
+ * timing.
+ */
+template<typename SearchType, typename DataType>
+static void DualTreeKNN(benchmark::State& state)
+{
+  const arma::mat& dataset = DataType::Dataset(state);
+  if (dataset.n_elem == 0)
+    return;
+
+  SearchType search(dataset, DUAL_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+    search.Search(5, neighbors, distances);
+
+  state.counters["base_cases"] = search.BaseCases();
+  state.counters["scores"] = search.Scores();
+  SetPointsProcessed(state, dataset);
+}
+
+#define MLPACK_KNN_BENCHMARK(SEARCH) \
+    BENCHMARK_TEMPLATE(DualTreeKNN, SEARCH, SyntheticData)-> \
+        Apply(SyntheticData::Arguments)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(DualTreeKNN, SEARCH, RealData)-> \
+        Apply(RealData::Arguments)->Unit(benchmark::kMillisecond)
+
+MLPACK_KNN_BENCHMARK(KDTreeKNN);
+MLPACK_KNN_BENCHMARK(BallTreeKNN);
+MLPACK_KNN_BENCHMARK(CoverTreeKNN);
+MLPACK_KNN_BENCHMARK(RStarTreeKNN);
+MLPACK_KNN_BENCHMARK(OctreeKNN);
+MLPACK_KNN_BENCHMARK(UBTreeKNN);
+MLPACK_KNN_BENCHMARK(VPTreeKNN);
+MLPACK_KNN_BENCHMARK(SpillTreeKNN);
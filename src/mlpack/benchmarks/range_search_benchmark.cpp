@@ -0,0 +1,66 @@
+/**
+ * @file range_search_benchmark.cpp
+ *
+ * Benchmarks for dual-tree range search with each of the trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::metric;
+using namespace mlpack::range;
+using namespace mlpack::tree;
+
+typedef RangeSearch<EuclideanDistance, arma::mat, KDTree> KDTreeRS;
+typedef RangeSearch<EuclideanDistance, arma::mat, BallTree> BallTreeRS;
+typedef RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree>
+    CoverTreeRS;
+typedef RangeSearch<EuclideanDistance, arma::mat, RStarTree> RStarTreeRS;
+typedef RangeSearch<EuclideanDistance, arma::mat, Octree> OctreeRS;
+typedef RangeSearch<EuclideanDistance, arma::mat, UBTree> UBTreeRS;
+typedef RangeSearch<EuclideanDistance, arma::mat, VPTree> VPTreeRS;
+
+/**
+ * Find the points within a radius of every point of the dataset (about 10 for
+ * evenly spread data) with a monochromatic dual-tree search.  The reference
+ * tree is built before the timing.
+ */
+template<typename SearchType, typename DataType>
+static void DualTreeRangeSearch(benchmark::State& state)
+{
+  const arma::mat& dataset = DataType::Dataset(state);
+  if (dataset.n_elem == 0)
+    return;
+
+  SearchType search(dataset);
+  const math::Range range(0.0, NeighborhoodRadius(dataset));
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<double>> distances;
+  for (auto _ : state)
+    search.Search(range, neighbors, distances);
+
+  state.counters["base_cases"] = search.BaseCases();
+  state.counters["scores"] = search.Scores();
+  SetPointsProcessed(state, dataset);
+}
+
+#define MLPACK_RS_BENCHMARK(SEARCH) \
+    BENCHMARK_TEMPLATE(DualTreeRangeSearch, SEARCH, SyntheticData)-> \
+        Apply(SyntheticData::Arguments)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(DualTreeRangeSearch, SEARCH, RealData)-> \
+        Apply(RealData::Arguments)->Unit(benchmark::kMillisecond)
+
+MLPACK_RS_BENCHMARK(KDTreeRS);
+MLPACK_RS_BENCHMARK(BallTreeRS);
+MLPACK_RS_BENCHMARK(CoverTreeRS);
+MLPACK_RS_BENCHMARK(RStarTreeRS);
+MLPACK_RS_BENCHMARK(OctreeRS);
+MLPACK_RS_BENCHMARK(UBTreeRS);
+MLPACK_RS_BENCHMARK(VPTreeRS);
@@ -0,0 +1,220 @@
+/**
+ * @file scaling_benchmark.cpp
+ *
+ * Benchmarks of the OpenMP paths of some of the algorithms with each number of
+ * threads, to measure how they scale.  The benchmarks report wall clock time;
+ * run them with JSON output and scaling_report.py to get the speedups and
+ * efficiencies, and to compare them with a baseline.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/init_rules/gaussian_init.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/lsh/lsh_search.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/reinforcement_learning/async_learning.hpp>
+#include <mlpack/methods/reinforcement_learning/environment/cart_pole.hpp>
+#include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
+#include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmarks;
+using namespace mlpack::kmeans;
+using namespace mlpack::neighbor;
+using namespace mlpack::rl;
+using namespace mlpack::svd;
+using namespace mlpack::tree;
+
+//! The number of threads OpenMP would use by default.
+static long MaxThreads()
+{
+  // This is evaluated before any benchmark changes the number of threads.
+  static const long maxThreads = (long) Threads();
+  return maxThreads;
+}
+
+/**
+ * Register the numbers of threads to benchmark: the powers of two up to the
+ * default number of threads of OpenMP, and that number.
+ */
+static void ThreadArguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({ "threads" });
+  long threads = 1;
+  for (; threads < MaxThreads(); threads *= 2)
+    b->Arg(threads);
+  b->Arg(MaxThreads());
+}
+
+//! 100000 uniformly distributed random points in 10 dimensions.
+static const arma::mat& ScalingDataset()
+{
+  static arma::mat dataset;
+  if (dataset.n_elem == 0)
+  {
+    math::RandomSeed(100000);
+    dataset = arma::randu<arma::mat>(10, 100000);
+  }
+
+  return dataset;
+}
+
+/**
+ * Ten iterations of Lloyd's algorithm (with NaiveKMeans) for 20 clusters,
+ * always starting from the same centroids.
+ */
+static void NaiveKMeansScaling(benchmark::State& state)
+{
+  ScopedThreads threads((size_t) state.range(0));
+  const arma::mat& dataset = ScalingDataset();
+  const arma::mat initialCentroids = dataset.cols(0, 19);
+
+  KMeans<> kmeans(10);
+  arma::mat centroids;
+  for (auto _ : state)
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(dataset, 20, centroids, true);
+  }
+
+  SetPointsProcessed(state, dataset);
+}
+
+/**
+ * Build an LSH model with 20 tables on the dataset, and find the 5 approximate
+ * nearest neighbors of 10000 of its points.
+ */
+static void LSHScaling(benchmark::State& state)
+{
+  ScopedThreads threads((size_t) state.range(0));
+  const arma::mat& dataset = ScalingDataset();
+  const arma::mat queries = dataset.cols(0, 9999);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    math::RandomSeed(20);
+    LSHSearch<> lsh(dataset, 10, 20);
+    lsh.Search(queries, 5, neighbors, distances);
+  }
+
+  SetPointsProcessed(state, dataset);
+}
+
+/**
+ * Train a random forest of 20 trees on 20000 points with three classes given
+ * by their first dimension.
+ */
+static void RandomForestScaling(benchmark::State& state)
+{
+  ScopedThreads threads((size_t) state.range(0));
+  const arma::mat dataset = ScalingDataset().cols(0, 19999);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = std::min((size_t) (3 * dataset(0, i)), (size_t) 2);
+
+  RandomForest<> forest;
+  for (auto _ : state)
+  {
+    math::RandomSeed(20);
+    forest.Train(dataset, labels, 3, 20);
+  }
+
+  SetPointsProcessed(state, dataset);
+}
+
+/**
+ * Five epochs of parallel SGD (split into strata of independent blocks) for a
+ * rank 10 regularized SVD of 500000 random ratings of 5000 users and 5000
+ * items.
+ */
+static void RegularizedSVDScaling(benchmark::State& state)
+{
+  ScopedThreads threads((size_t) state.range(0));
+  const size_t numUsers = 5000, numItems = 5000, numRatings = 500000;
+  math::RandomSeed(numRatings);
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = arma::floor(data.row(0) * numUsers);
+  data.row(1) = arma::floor(data.row(1) * numItems);
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+  data.row(2) = 5 * data.row(2);
+
+  RegularizedSVDFunction<arma::mat> function(data, 10, 0.02);
+  const arma::mat initialPoint = arma::randu(10, numUsers + numItems);
+  arma::mat parameters;
+  for (auto _ : state)
+  {
+    parameters = initialPoint;
+    ens::ExponentialBackoff decayPolicy(1000, 0.01, 0.5);
+    ens::ParallelSGD<ens::ExponentialBackoff> optimizer(5, numRatings, 1e-10,
+        true, decayPolicy);
+    optimizer.Optimize(function, parameters);
+  }
+
+  state.SetItemsProcessed(state.iterations() * 5 * numRatings);
+}
+
+/**
+ * One-step Q-learning on the cart pole with 8 exploration workers, until the
+ * deterministic evaluation worker has finished 20 episodes.  The workers are
+ * split between the threads, so the evaluation worker runs more often with
+ * more threads.
+ */
+static void AsyncLearningScaling(benchmark::State& state)
+{
+  ScopedThreads threads((size_t) state.range(0));
+  for (auto _ : state)
+  {
+    math::RandomSeed(8);
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    GreedyPolicy<CartPole> policy(0.7, 5000, 0.1);
+
+    TrainingConfig config;
+    config.StepSize() = 0.0001;
+    config.Discount() = 0.99;
+    config.NumWorkers() = 8;
+    config.UpdateInterval() = 6;
+    config.StepLimit() = 200;
+    config.TargetNetworkSyncInterval() = 200;
+
+    OneStepQLearning<CartPole, decltype(model), ens::VanillaUpdate,
+        decltype(policy)> agent(std::move(config), std::move(model),
+        std::move(policy));
+
+    size_t episodes = 0;
+    auto measure = [&episodes](double /* reward */)
+    {
+      return ++episodes >= 20;
+    };
+    agent.Train(measure);
+  }
+}
+
+#define MLPACK_SCALING_BENCHMARK(FUNCTION) \
+    BENCHMARK(FUNCTION)->Apply(ThreadArguments)->UseRealTime()-> \
+        Unit(benchmark::kMillisecond)
+
+MLPACK_SCALING_BENCHMARK(NaiveKMeansScaling);
+MLPACK_SCALING_BENCHMARK(LSHScaling);
+MLPACK_SCALING_BENCHMARK(RandomForestScaling);
+MLPACK_SCALING_BENCHMARK(RegularizedSVDScaling);
+MLPACK_SCALING_BENCHMARK(AsyncLearningScaling);
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""
+scaling_report.py: summarize the thread scaling benchmarks of mlpack.
+
+Runs the *Scaling benchmarks of mlpack_benchmarks (or reads the JSON output of
+an earlier run), computes the speedup and parallel efficiency of each algorithm
+for each number of threads, and writes them as JSON.  With --baseline, the
+results are compared with an earlier report, and the script exits with status 1
+if any time or speedup is worse than the baseline by more than the threshold.
+
+Example:
+
+  scaling_report.py --benchmark build/bin/mlpack_benchmarks \
+      --output scaling.json --baseline scaling_baseline.json --threshold 0.1
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+def run_benchmarks(binary, benchmark_filter, repetitions):
+  """Run the benchmarks and return their JSON output."""
+  handle, filename = tempfile.mkstemp(suffix='.json')
+  os.close(handle)
+  try:
+    subprocess.check_call([binary,
+                           '--benchmark_filter=' + benchmark_filter,
+                           '--benchmark_repetitions=' + str(repetitions),
+                           '--benchmark_out=' + filename,
+                           '--benchmark_out_format=json'])
+    with open(filename) as f:
+      return json.load(f)
+  finally:
+    os.remove(filename)
+
+def scaling(results):
+  """
+  Group the runs of each benchmark by number of threads, taking the median
+  when there are repetitions, and compute the speedups and efficiencies
+  relative to the run with one thread.
+  """
+  times = {}
+  for run in results['benchmarks']:
+    # Skip the mean and standard deviation of repetitions.
+    if run.get('run_type', 'iteration') != 'iteration':
+      continue
+    match = re.match(r'^(.*)/threads:(\d+)', run['name'])
+    if match is None:
+      continue
+    name, threads = match.group(1), int(match.group(2))
+    times.setdefault(name, {}).setdefault(threads, []).append(
+        run['real_time'])
+
+  report = {}
+  for name, runs in sorted(times.items()):
+    medians = {}
+    for threads, values in runs.items():
+      values = sorted(values)
+      medians[threads] = values[len(values) // 2]
+
+    base = medians.get(1)
+    report[name] = []
+    for threads in sorted(medians):
+      entry = { 'threads': threads, 'time': medians[threads] }
+      if base is not None:
+        entry['speedup'] = base / medians[threads]
+        entry['efficiency'] = entry['speedup'] / threads
+      report[name].append(entry)
+
+  return report
+
+def regressions(report, baseline, threshold):
+  """
+  Return a message for each time that is slower, or speedup that is lower, than
+  in the baseline by more than the given fraction.
+  """
+  messages = []
+  for name, entries in sorted(report.items()):
+    if name not in baseline:
+      continue
+    old = { entry['threads']: entry for entry in baseline[name] }
+    for entry in entries:
+      if entry['threads'] not in old:
+        continue
+      previous = old[entry['threads']]
+      if entry['time'] > previous['time'] * (1.0 + threshold):
+        messages.append('%s with %d threads: time %.3f vs. %.3f in baseline' %
+            (name, entry['threads'], entry['time'], previous['time']))
+      if 'speedup' in entry and 'speedup' in previous and \
+          entry['speedup'] < previous['speedup'] * (1.0 - threshold):
+        messages.append('%s with %d threads: speedup %.2f vs. %.2f in '
+            'baseline' % (name, entry['threads'], entry['speedup'],
+            previous['speedup']))
+
+  return messages
+
+def main():
+  parser = argparse.ArgumentParser(description='Summarize the thread '
+      'scaling benchmarks of mlpack, and compare them with a baseline.')
+  source = parser.add_mutually_exclusive_group(required=True)
+  source.add_argument('--benchmark', help='mlpack_benchmarks binary to run')
+  source.add_argument('--input', help='JSON output of an earlier run of '
+      'mlpack_benchmarks')
+  parser.add_argument('--filter', default='Scaling/',
+      help='benchmarks to run (default: %(default)s)')
+  parser.add_argument('--repetitions', type=int, default=3,
+      help='repetitions of each run (default: %(default)s)')
+  parser.add_argument('--output', help='file to write the report to '
+      '(default: standard output)')
+  parser.add_argument('--baseline', help='earlier report to compare with')
+  parser.add_argument('--threshold', type=float, default=0.1,
+      help='largest allowed relative regression (default: %(default)s)')
+  args = parser.parse_args()
+
+  if args.benchmark:
+    results = run_benchmarks(args.benchmark, args.filter, args.repetitions)
+  else:
+    with open(args.input) as f:
+      results = json.load(f)
+
+  report = scaling(results)
+  if args.output:
+    with open(args.output, 'w') as f:
+      json.dump(report, f, indent=2, sort_keys=True)
+  else:
+    json.dump(report, sys.stdout, indent=2, sort_keys=True)
+    print()
+
+  for name, entries in sorted(report.items()):
+    for entry in entries:
+      if 'speedup' in entry:
+        sys.stderr.write('%s: %d threads, %.3f ms, speedup %.2f, efficiency '
+            '%.2f\n' % (name, entry['threads'], entry['time'],
+            entry['speedup'], entry['efficiency']))
+
+  if args.baseline:
+    with open(args.baseline) as f:
+      baseline = json.load(f)
+    messages = regressions(report, baseline, args.threshold)
+    for message in messages:
+      sys.stderr.write('Regression: ' + message + '\n')
+    if messages:
+      sys.exit(1)
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,216 @@
+/**
+ * @file serialization_benchmark.cpp
+ *
+ * Benchmarks for saving and loading models with data::Save() and data::Load(),
+ * in each of the archive formats.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/random_forest/random_forest.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::benchmarks;
+using namespace mlpack::neighbor;
+using namespace mlpack::tree;
+
+/**
+ * Uniformly distributed random points in 10 dimensions, each labeled with one
+ * of three classes given by its first dimension.
+ */
+static void LabeledDataset(const size_t points,
+                           arma::mat& dataset,
+                           arma::Row<size_t>& labels)
+{
+  // Use a fixed seed, so that the runs are comparable.
+  math::RandomSeed(points);
+  dataset = arma::randu<arma::mat>(10, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = std::min((size_t) (3 * dataset(0, i)), (size_t) 2);
+}
+
+/**
+ * A kd-tree k-nearest-neighbor model, which holds its tree and reference set.
+ * The argument of the benchmark is the number of reference points.
+ */
+class KNNModelSource
+{
+ public:
+  typedef NSModel<NearestNeighborSort> ModelType;
+
+  //! Register the sizes of the reference sets.
+  static void Arguments(benchmark::internal::Benchmark* b)
+  {
+    b->ArgNames({ "points" });
+    for (long points : { 1000, 10000, 100000 })
+      b->Arg(points);
+  }
+
+  //! Build the model for the given state, once for each size.
+  static ModelType& Model(benchmark::State& state)
+  {
+    static std::map<size_t, std::unique_ptr<ModelType>> models;
+
+    const size_t points = (size_t) state.range(0);
+    if (models.count(points) == 0)
+    {
+      arma::mat dataset;
+      arma::Row<size_t> labels;
+      LabeledDataset(points, dataset, labels);
+
+      models[points].reset(new ModelType());
+      models[points]->BuildModel(std::move(dataset), 20, DUAL_TREE_MODE);
+    }
+
+    return *models[points];
+  }
+};
+
+/**
+ * A random forest of 10 trees.  The argument of the benchmark is the number of
+ * training points, which sets the size of the trees.
+ */
+class RandomForestSource
+{
+ public:
+  typedef RandomForest<> ModelType;
+
+  //! Register the sizes of the training sets.
+  static void Arguments(benchmark::internal::Benchmark* b)
+  {
+    b->ArgNames({ "points" });
+    for (long points : { 1000, 10000, 100000 })
+      b->Arg(points);
+  }
+
+  //! Train the model for the given state, once for each size.
+  static ModelType& Model(benchmark::State& state)
+  {
+    static std::map<size_t, std::unique_ptr<ModelType>> models;
+
+    const size_t points = (size_t) state.range(0);
+    if (models.count(points) == 0)
+    {
+      arma::mat dataset;
+      arma::Row<size_t> labels;
+      LabeledDataset(points, dataset, labels);
+
+      models[points].reset(new ModelType(dataset, labels, 3, 10, 1));
+    }
+
+    return *models[points];
+  }
+};
+
+/**
+ * A feedforward network with one hidden layer; its weights are not trained,
+ * since that doesn't change the size of the model.  The argument of the
+ * benchmark is the number of hidden units.
+ */
+class FFNSource
+{
+ public:
+  typedef FFN<NegativeLogLikelihood<>, RandomInitialization> ModelType;
+
+  //! Register the sizes of the hidden layer.
+  static void Arguments(benchmark::internal::Benchmark* b)
+  {
+    b->ArgNames({ "hidden" });
+    for (long hidden : { 64, 1024, 16384 })
+      b->Arg(hidden);
+  }
+
+  //! Build the model for the given state, once for each size.
+  static ModelType& Model(benchmark::State& state)
+  {
+    static std::map<size_t, std::unique_ptr<ModelType>> models;
+
+    const size_t hidden = (size_t) state.range(0);
+    if (models.count(hidden) == 0)
+    {
+      math::RandomSeed(hidden);
+      models[hidden].reset(new ModelType());
+      models[hidden]->Add<Linear<>>(10, hidden);
+      models[hidden]->Add<SigmoidLayer<>>();
+      models[hidden]->Add<Linear<>>(hidden, 3);
+      models[hidden]->Add<LogSoftMax<>>();
+      models[hidden]->ResetParameters();
+    }
+
+    return *models[hidden];
+  }
+};
+
+//! The name of the file with the given extension used by the benchmarks.
+static std::string ModelFile(const std::string& extension)
+{
+  return "mlpack_serialization_benchmark." + extension;
+}
+
+/**
+ * Save the model of the given source in the archive format of the given
+ * extension (xml, txt or bin).  The rate is the size of the file written per
+ * second.
+ */
+template<typename SourceType>
+static void SaveModel(benchmark::State& state, const std::string& extension)
+{
+  typename SourceType::ModelType& model = SourceType::Model(state);
+  const std::string filename = ModelFile(extension);
+
+  for (auto _ : state)
+    data::Save(filename, "model", model, true);
+
+  SetFileBytesProcessed(state, filename);
+  SetPeakMemory(state);
+  std::remove(filename.c_str());
+}
+
+/**
+ * Load the model of the given source from the archive format of the given
+ * extension, which is written before the timing.  The rate is the size of the
+ * file read per second.
+ */
+template<typename SourceType>
+static void LoadModel(benchmark::State& state, const std::string& extension)
+{
+  const std::string filename = ModelFile(extension);
+  data::Save(filename, "model", SourceType::Model(state), true);
+
+  for (auto _ : state)
+  {
+    typename SourceType::ModelType model;
+    data::Load(filename, "model", model, true);
+  }
+
+  SetFileBytesProcessed(state, filename);
+  SetPeakMemory(state);
+  std::remove(filename.c_str());
+}
+
+#define MLPACK_SERIALIZATION_BENCHMARK(SOURCE, EXTENSION) \
+    BENCHMARK_CAPTURE(SaveModel<SOURCE>, EXTENSION, \
+        std::string(#EXTENSION))->Apply(SOURCE::Arguments)-> \
+        Unit(benchmark::kMillisecond); \
+    BENCHMARK_CAPTURE(LoadModel<SOURCE>, EXTENSION, \
+        std::string(#EXTENSION))->Apply(SOURCE::Arguments)-> \
+        Unit(benchmark::kMillisecond)
+
+MLPACK_SERIALIZATION_BENCHMARK(KNNModelSource, xml);
+MLPACK_SERIALIZATION_BENCHMARK(KNNModelSource, txt);
+MLPACK_SERIALIZATION_BENCHMARK(KNNModelSource, bin);
+MLPACK_SERIALIZATION_BENCHMARK(RandomForestSource, xml);
+MLPACK_SERIALIZATION_BENCHMARK(RandomForestSource, txt);
+MLPACK_SERIALIZATION_BENCHMARK(RandomForestSource, bin);
+MLPACK_SERIALIZATION_BENCHMARK(FFNSource, xml);
+MLPACK_SERIALIZATION_BENCHMARK(FFNSource, txt);
+MLPACK_SERIALIZATION_BENCHMARK(FFNSource, bin);
@@ -0,0 +1,67 @@
+/**
+ * @file tree_benchmark.cpp
+ *
+ * Benchmarks for the construction of each of the trees in core/tree/.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/tree/spill_tree.hpp>
+#include "benchmark_data.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> KDTreeType;
+typedef BallTree<EuclideanDistance, EmptyStatistic, arma::mat> BallTreeType;
+typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+    CoverTreeType;
+typedef RStarTree<EuclideanDistance, EmptyStatistic, arma::mat> RStarTreeType;
+typedef Octree<EuclideanDistance, EmptyStatistic, arma::mat> OctreeType;
+typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> SpillTreeType;
+typedef UBTree<EuclideanDistance, EmptyStatistic, arma::mat> UBTreeType;
+typedef VPTree<EuclideanDistance, EmptyStatistic, arma::mat> VPTreeType;
+
+/**
+ * Build a tree on the whole dataset.  This includes the copy of the dataset
+ * that is held by the tree.
+ */
+template<typename TreeType, typename DataType>
+static void TreeConstruction(benchmark::State& state)
+{
+  const arma::mat& dataset = DataType::Dataset(state);
+  if (dataset.n_elem == 0)
+    return;
+
+  for (auto _ : state)
+  {
+    TreeType tree(dataset);
+    benchmark::DoNotOptimize(tree.NumChildren());
+  }
+
+  SetPointsProcessed(state, dataset);
+}
+
+#define MLPACK_TREE_BENCHMARK(TREE) \
+    BENCHMARK_TEMPLATE(TreeConstruction, TREE, SyntheticData)-> \
+        Apply(SyntheticData::Arguments)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(TreeConstruction, TREE, RealData)-> \
+        Apply(RealData::Arguments)->Unit(benchmark::kMillisecond)
+
+MLPACK_TREE_BENCHMARK(KDTreeType);
+MLPACK_TREE_BENCHMARK(BallTreeType);
+MLPACK_TREE_BENCHMARK(CoverTreeType);
+MLPACK_TREE_BENCHMARK(RStarTreeType);
+MLPACK_TREE_BENCHMARK(OctreeType);
+MLPACK_TREE_BENCHMARK(SpillTreeType);
+MLPACK_TREE_BENCHMARK(UBTreeType);
+MLPACK_TREE_BENCHMARK(VPTreeType);
@@ -71,6 +71,45 @@ inline void EndProgram()
       Log::Info << "  " << it2.first << ": ";
       CLI::GetSingleton().timer.PrintTimer(it2.first);
     }
+
+    const std::map<std::string, uint64_t> counters =
+        CLI::GetSingleton().timer.GetAllCounters();
+    if (!counters.empty())
+    {
+      Log::Info << "Program counters:" << std::endl;
+      for (auto it2 : counters)
+        Log::Info << "  " << it2.first << ": " << it2.second << std::endl;
+    }
+
+    const std::map<std::string, TimerMemory> memory =
+        CLI::GetSingleton().timer.GetAllMemory();
+    if (!memory.empty())
+    {
+      Log::Info << "Program memory:" << std::endl;
+      for (auto it2 : memory)
+      {
+        Log::Info << "  " << it2.first << ": peak RSS " << it2.second.peakRSS
+            << " bytes, " << it2.second.allocated << " bytes allocated"
+            << std::endl;
+      }
+    }
+
+    const std::map<std::string, util::HardwareCounterValues> hardware =
+        CLI::GetSingleton().timer.GetAllHardwareCounters();
+    if (!hardware.empty())
+    {
+      Log::Info << "Program hardware counters:" << std::endl;
+      for (auto it2 : hardware)
+      {
+        const util::HardwareCounterValues& h = it2.second;
+        Log::Info << "  " << it2.first << ": " << h.cycles << " cycles, "
+            << h.instructions << " instructions";
+        if (h.cycles > 0)
+          Log::Info << " (IPC " << double(h.instructions) / h.cycles << ")";
+        Log::Info << ", " << h.cacheMisses << " cache misses, "
+            << h.branchMisses << " branch misses" << std::endl;
+      }
+    }
   }
 
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
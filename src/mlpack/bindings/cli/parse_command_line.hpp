@@ -27,6 +27,15 @@ PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_FLAG("server", "Load the input parameters once, then run the program "
+    "for each line of extra parameters read from standard input, answering "
+    "each with a line 'ok' or 'error: <message>' on standard output.", "");
+PARAM_FLAG("hardware_counters", "Record the hardware performance counters "
+    "(cycles, instructions, cache misses, and branch misses) of each timer, "
+    "shown with --verbose.  Only supported on Linux.", "");
+PARAM_INT_IN("threads", "Number of threads to use (0 uses the default of "
+    "OpenMP, given by the OMP_NUM_THREADS environment variable or the number "
+    "of cores).", "", 0);
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -119,6 +128,7 @@ void ParseCommandLine(int argc, char** argv)
     const std::string identifier = boostNameMap[i->first];
     util::ParamData& param = parameters[identifier];
     param.wasPassed = true;
+    param.loaded = false;
     CLI::GetSingleton().functionMap[param.tname]["SetParam"](param,
         (void*) &vmap[i->first].value(), NULL);
   }
@@ -174,7 +184,8 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
-  // Now, issue an error if we forgot any required options.
+  // Now, issue an error if we forgot any required options.  (In server mode,
+  // they may have been passed on the command line instead of the request.)
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
   {
@@ -185,7 +196,7 @@ void ParseCommandLine(int argc, char** argv)
       CLI::GetSingleton().functionMap[d.tname]["MapParameterName"](d, NULL,
           (void*) &boostName);
 
-      if (!vmap.count(boostName))
+      if (!d.wasPassed)
       {
         Log::Fatal << "Required option --" << boostName << " is undefined."
             << std::endl;
@@ -93,7 +93,9 @@ std::string PrintTypeDoc(
         "of the data is detected by the extension of the filename.  The storage"
         " should be such that one row corresponds to one point, and one column "
         "corresponds to one dimension (this is the typical storage format for "
-        "on-disk data).  All values of the matrix will be loaded as double-"
+        "on-disk data); the only exception is mlpack's mapped matrix format "
+        "(.mmat), which stores one point per column and loads without any "
+        "parsing.  All values of the matrix will be loaded as double-"
         "precision floating point data.";
   }
   else if (std::is_same<T, arma::Mat<size_t>>::value)
@@ -106,8 +108,10 @@ std::string PrintTypeDoc(
         "compiled with HDF5 support.  The type of the data is detected by the "
         "extension of the filename.  The storage should be such that one row "
         "corresponds to one point, and one column corresponds to one dimension "
-        "(this is the typical storage format for on-disk data).  All values of "
-        "the matrix will be loaded as unsigned integers.";
+        "(this is the typical storage format for on-disk data); the only "
+        "exception is mlpack's mapped matrix format (.mmat), which stores one "
+        "point per column and loads without any parsing.  All values of the "
+        "matrix will be loaded as unsigned integers.";
   }
   else if (std::is_same<T, arma::rowvec>::value ||
            std::is_same<T, arma::vec>::value)
@@ -0,0 +1,227 @@
+/**
+ * @file serve.hpp
+ *
+ * Run a command-line program as a server that handles many requests, so that
+ * input models are only loaded once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core/util/cli.hpp>
+#include "parse_command_line.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <unordered_set>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Split a request line into arguments, at whitespace.  An argument can be
+ * quoted with double quotes to hold whitespace.
+ *
+ * @param line Request line.
+ * @return The arguments.
+ */
+inline std::vector<std::string> SplitRequest(const std::string& line)
+{
+  std::vector<std::string> arguments;
+  std::string argument;
+  bool quoted = false, inArgument = false;
+  for (size_t i = 0; i < line.size(); ++i)
+  {
+    const char c = line[i];
+    if (c == '"')
+    {
+      quoted = !quoted;
+      inArgument = true;
+    }
+    else if (!quoted && std::isspace((unsigned char) c))
+    {
+      if (inArgument)
+        arguments.push_back(argument);
+      argument.clear();
+      inArgument = false;
+    }
+    else
+    {
+      argument += c;
+      inArgument = true;
+    }
+  }
+
+  if (quoted)
+    throw std::invalid_argument("unterminated quote in request");
+  if (inArgument)
+    arguments.push_back(argument);
+
+  return arguments;
+}
+
+/**
+ * Delete the models allocated by the parameters, except the given ones.  The
+ * same model may be held by several parameters, so each is only deleted once.
+ *
+ * @param persistent Models that should not be deleted.
+ */
+inline void DeleteRequestMemory(const std::unordered_set<void*>& persistent)
+{
+  std::unordered_set<void*> deleted(persistent);
+  const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  std::map<std::string, util::ParamData>::const_iterator it;
+  for (it = parameters.begin(); it != parameters.end(); ++it)
+  {
+    const util::ParamData& d = it->second;
+
+    void* result;
+    CLI::GetSingleton().functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+        (void*) &result);
+    if (result != NULL && deleted.count(result) == 0)
+    {
+      CLI::GetSingleton().functionMap[d.tname]["DeleteAllocatedMemory"](d,
+          NULL, NULL);
+      deleted.insert(result);
+    }
+  }
+}
+
+/**
+ * Run the given program once for each request read from the given stream.
+ * The input parameters passed on the command line (such as an input model)
+ * are loaded once, before the first request, and each request is a line of
+ * extra command-line arguments, such as
+ *
+ * @code
+ * --query_file queries.csv --k 5 --neighbors_file neighbors.csv
+ * @endcode
+ *
+ * Each request starts from the parameters of the command line, so parameters
+ * given in one request don't carry over to the next; models loaded from the
+ * command line are shared by all requests, and any change a request makes to
+ * them is kept.  Output parameters are saved after each request, and a line
+ * "ok" or "error: <message>" is written to the given output stream when the
+ * request is done.  The server stops at the end of the input or at a line
+ * "exit".  Once it stops, the parameters are those of the command line again,
+ * so EndProgram() can be called as usual.
+ *
+ * Since Log::Info also goes to standard output, --verbose should not be
+ * passed if the responses are read from standard output.
+ *
+ * @param program The program to run for each request.
+ * @param in Stream to read the requests from.
+ * @param out Stream to write the responses to.
+ */
+inline void Serve(void (*program)(), std::istream& in, std::ostream& out)
+{
+  std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
+  std::map<std::string, util::ParamData>::iterator it;
+
+  // Load the input parameters of the command line, and remember the models so
+  // that they are kept between requests.
+  std::unordered_set<void*> persistent;
+  for (it = parameters.begin(); it != parameters.end(); ++it)
+  {
+    util::ParamData& d = it->second;
+    if (!d.input || !d.wasPassed)
+      continue;
+
+    void* value;
+    CLI::GetSingleton().functionMap[d.tname]["GetParam"](d, NULL,
+        (void*) &value);
+
+    void* result;
+    CLI::GetSingleton().functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+        (void*) &result);
+    if (result != NULL)
+      persistent.insert(result);
+  }
+
+  const std::map<std::string, util::ParamData> commandLine = parameters;
+  const std::string programName = CLI::GetSingleton().ProgramName();
+
+  std::string line;
+  while (std::getline(in, line))
+  {
+    std::vector<std::string> arguments;
+    try
+    {
+      arguments = SplitRequest(line);
+    }
+    catch (std::exception& e)
+    {
+      out << "error: " << e.what() << std::endl;
+      continue;
+    }
+
+    if (arguments.empty())
+      continue;
+    if (arguments.size() == 1 && arguments[0] == "exit")
+      break;
+
+    // These would stop the server.
+    bool reserved = false;
+    for (size_t i = 0; i < arguments.size(); ++i)
+    {
+      if (arguments[i] == "--help" || arguments[i] == "-h" ||
+          arguments[i] == "--version" || arguments[i] == "-V" ||
+          arguments[i].compare(0, 6, "--info") == 0)
+        reserved = true;
+    }
+    if (reserved)
+    {
+      out << "error: --help, --info, and --version can't be used in a request"
+          << std::endl;
+      continue;
+    }
+
+    parameters = commandLine;
+
+    std::vector<char*> argv;
+    argv.push_back(const_cast<char*>(programName.c_str()));
+    for (size_t i = 0; i < arguments.size(); ++i)
+      argv.push_back(const_cast<char*>(arguments[i].c_str()));
+
+    try
+    {
+      ParseCommandLine((int) argv.size(), argv.data());
+      program();
+
+      // Save the output parameters of the request.
+      for (it = parameters.begin(); it != parameters.end(); ++it)
+      {
+        const util::ParamData& d = it->second;
+        if (!d.input)
+        {
+          CLI::GetSingleton().functionMap[d.tname]["OutputParam"](d, NULL,
+              NULL);
+        }
+      }
+
+      out << "ok" << std::endl;
+    }
+    catch (std::exception& e)
+    {
+      // The message must fit on the response line.
+      std::string message = e.what();
+      std::replace(message.begin(), message.end(), '\n', ' ');
+      out << "error: " << message << std::endl;
+    }
+
+    DeleteRequestMemory(persistent);
+  }
+
+  parameters = commandLine;
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -45,8 +45,10 @@ cdef arma.Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
+    # C-ordered memory is used as is, as a column-major matrix with one point
+    # per column.  Otherwise, make a C-ordered copy that we own (memory that
+    # numpy doesn't own can't be given to Armadillo either).
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -65,8 +67,10 @@ cdef arma.Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   Convert a numpy ndarray to a matrix.  The memory will still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
+    # C-ordered memory is used as is, as a column-major matrix with one point
+    # per column.  Otherwise, make a C-ordered copy that we own (memory that
+    # numpy doesn't own can't be given to Armadillo either).
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -124,8 +128,10 @@ cdef arma.Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
+    # C-ordered memory is used as is, as a column-major matrix with one point
+    # per column.  Otherwise, make a C-ordered copy that we own (memory that
+    # numpy doesn't own can't be given to Armadillo either).
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -145,8 +151,10 @@ cdef arma.Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a row.  The memory will still be
   owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
+    # C-ordered memory is used as is, as a column-major matrix with one point
+    # per column.  Otherwise, make a C-ordered copy that we own (memory that
+    # numpy doesn't own can't be given to Armadillo either).
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -200,8 +208,10 @@ cdef arma.Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
+    # C-ordered memory is used as is, as a column-major matrix with one point
+    # per column.  Otherwise, make a C-ordered copy that we own (memory that
+    # numpy doesn't own can't be given to Armadillo either).
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -221,9 +231,12 @@ cdef arma.Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   Convert a numpy one-dimensional ndarray to a column vector.  The memory will
   still be owned by numpy.
   """
-  if not (X.flags.c_contiguous or X.flags.owndata):
-    # If needed, make a copy where we own the memory.
+  if not X.flags.c_contiguous or (takeOwnership and not X.flags.owndata):
+    # C-ordered memory is used as is, as a column-major matrix with one point
+    # per column.  Otherwise, make a C-ordered copy that we own (memory that
+    # numpy doesn't own can't be given to Armadillo either).
     X = X.copy(order="C")
+    takeOwnership = True
 
   cdef arma.Col[size_t]* m = new arma.Col[size_t](<size_t*> X.data, X.shape[0],
       False, False)
@@ -0,0 +1,32 @@
+#!/usr/bin/env python
+"""
+binding_lock.py: serialization of calls to mlpack bindings
+
+The parameters of mlpack programs are held by a single global object, so two
+bindings can't run at the same time.  Every binding is wrapped with
+run_exclusively(), which holds a lock shared by all the bindings during the
+whole call.  Since the bindings release the GIL while the mlpack program runs,
+other Python threads keep running meanwhile (and may call bindings, which wait
+for the lock).
+
+mlpack is free software; you may redistribute it and/or modify it under the
+terms of the 3-clause BSD license.  You should have received a copy of the
+3-clause BSD license along with mlpack.  If not, see
+http://www.opensource.org/licenses/BSD-3-Clause for more information.
+"""
+import functools
+import threading
+
+binding_lock = threading.RLock()
+
+def run_exclusively(binding):
+  """
+  Wrap the given binding so that it holds the lock of the bindings while it
+  runs.
+  """
+  @functools.wraps(binding)
+  def wrapper(*args, **kwargs):
+    with binding_lock:
+      return binding(*args, **kwargs)
+
+  return wrapper
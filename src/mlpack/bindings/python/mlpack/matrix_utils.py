@@ -39,7 +39,11 @@ except:
 
 def to_matrix(x, dtype=np.double, copy=False):
   """
-  Given some array-like X, return a numpy ndarray of the same type.
+  Given some array-like X, return a numpy ndarray of the same type.  A
+  C-ordered ndarray of the given dtype is returned as is, since its memory can
+  be used directly as a column-major matrix with one point per column; anything
+  else (such as a float32 or Fortran-ordered array) is converted with a single
+  copy.  The second element of the returned tuple is whether a copy was made.
   """
   # Make sure it's array-like at all.
   if not hasattr(x, '__len__') and \
@@ -70,13 +74,11 @@ def to_matrix_with_info(x, dtype, copy=False):
 
   if isinstance(x, np.ndarray):
     # It is already an ndarray, so the vector of info is all 0s (all numeric).
+    # It is only copied if it has another type or isn't C-ordered (or a copy is
+    # asked for).
     d = np.zeros([x.shape[1]], dtype=np.bool)
-
-    # Copy the matrix if needed.
-    if copy:
-      return (x.copy(order="C"), True, d)
-    else:
-      return (x, False, d)
+    t = to_matrix(x, dtype=dtype, copy=copy)
+    return (t[0], t[1], d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
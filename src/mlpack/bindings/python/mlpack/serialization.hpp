@@ -39,6 +39,28 @@ void SerializeIn(T* t, const std::string& str, const std::string& name)
   b >> boost::serialization::make_nvp(name.c_str(), *t);
 }
 
+/**
+ * Save the given model to a file, in the format given by the extension of the
+ * filename, under the same name the command-line programs use (so the file can
+ * be given to them as an input model).  A std::runtime_error is thrown on
+ * failure.
+ */
+template<typename T>
+void SaveModel(T* t, const std::string& filename)
+{
+  data::Save(filename, "model", *t, true);
+}
+
+/**
+ * Load the given model from a file (see SaveModel()).  A std::runtime_error is
+ * thrown on failure.
+ */
+template<typename T>
+void LoadModel(T* t, const std::string& filename)
+{
+  data::Load(filename, "model", *t, true);
+}
+
 } // namespace python
 } // namespace bindings
 } // namespace mlpack
@@ -12,3 +12,5 @@ from libcpp.string cimport string
 cdef extern from "serialization.hpp" namespace "mlpack::bindings::python" nogil:
   string SerializeOut[T](T* t, string name) nogil
   void SerializeIn[T](T* t, string str, string name) nogil
+  void SaveModel[T](T* t, string filename) nogil except +
+  void LoadModel[T](T* t, string filename) nogil except +
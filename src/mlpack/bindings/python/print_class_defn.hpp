@@ -76,6 +76,16 @@ void PrintClassDefn(
    *
    *   def __reduce_ex__(self):
    *     return (self.__class__, (), self.__getstate__())
+   *
+   *   def save(self, filename):
+   *     cdef string f = filename.encode("UTF-8")
+   *     with nogil:
+   *       SaveModel(self.modelptr, f)
+   *
+   *   def load(self, filename):
+   *     cdef string f = filename.encode("UTF-8")
+   *     with nogil:
+   *       LoadModel(self.modelptr, f)
    */
   std::cout << "cdef class " << strippedType << "Type:" << std::endl;
   std::cout << "  cdef " << printedType << "* modelptr" << std::endl;
@@ -98,6 +108,18 @@ void PrintClassDefn(
   std::cout << "    return (self.__class__, (), self.__getstate__())"
       << std::endl;
   std::cout << std::endl;
+  // A model loaded once can be given to any number of calls of the bindings,
+  // which use it in place without serializing it.
+  std::cout << "  def save(self, filename):" << std::endl;
+  std::cout << "    cdef string f = filename.encode(\"UTF-8\")" << std::endl;
+  std::cout << "    with nogil:" << std::endl;
+  std::cout << "      SaveModel(self.modelptr, f)" << std::endl;
+  std::cout << std::endl;
+  std::cout << "  def load(self, filename):" << std::endl;
+  std::cout << "    cdef string f = filename.encode(\"UTF-8\")" << std::endl;
+  std::cout << "    with nogil:" << std::endl;
+  std::cout << "      LoadModel(self.modelptr, f)" << std::endl;
+  std::cout << std::endl;
 }
 
 /**
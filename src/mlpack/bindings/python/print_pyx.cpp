@@ -81,7 +81,9 @@ void PrintPYX(const ProgramDoc& programInfo,
   cout << "from cli cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
       << "ResetTimers, EnableTimers" << endl;
   cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
-  cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
+  cout << "from binding_lock import run_exclusively" << endl;
+  cout << "from serialization cimport SerializeIn, SerializeOut, "
+      << "SaveModel, LoadModel" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
   cout << "cimport numpy as np" << endl;
@@ -123,7 +125,9 @@ void PrintPYX(const ProgramDoc& programInfo,
       CLI::GetSingleton().functionMap[d.tname]["PrintClassDefn"](d, NULL, NULL);
   }
 
-  // Print the definition.
+  // Print the definition.  mlpack's parameters are global, so bindings can't
+  // run at the same time.
+  cout << "@run_exclusively" << endl;
   cout << "def " << functionName << "(";
   size_t indent = 4 /* 'def ' */ + functionName.size() + 1 /* '(' */;
   for (size_t i = 0; i < inputOptions.size(); ++i)
@@ -209,9 +213,10 @@ void PrintPYX(const ProgramDoc& programInfo,
     cout << "  CLI.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
-  // Call the method.
+  // Call the method, without the GIL so that other Python threads can run.
   cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  cout << "  with nogil:" << endl;
+  cout << "    mlpackMain()" << endl;
 
   // Do any output processing and return.
   cout << "  # Initialize result dictionary." << endl;
@@ -227,9 +232,8 @@ void PrintPYX(const ProgramDoc& programInfo,
         (void*) &t, NULL);
   }
 
-  // Clear the parameters.
-  cout << endl;
-  cout << "  CLI.ClearSettings()" << endl;
+  // The parameters are not cleared, so that the next call of this binding
+  // only has to reset their values (see CLI::RestoreSettings()).
   cout << endl;
 
   cout << "  return result" << endl;
@@ -13,6 +13,8 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import os
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -140,6 +142,71 @@ class TestPythonBinding(unittest.TestCase):
     for j in range(100):
       self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
 
+  def testNumpyFortranMatrix(self):
+    """
+    A Fortran-ordered matrix should be converted, and give the same results as a
+    C-ordered one.
+    """
+    x = np.asfortranarray(np.random.rand(100, 5))
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=x)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(x[j, i], output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * x[j, 2], output['matrix_out'][j, 2])
+
+  def testNumpyFloat32Matrix(self):
+    """
+    A float32 matrix should be converted to a double matrix.
+    """
+    x = np.random.rand(100, 5).astype(np.float32)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=x)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(float(x[j, i]), output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * float(x[j, 2]), output['matrix_out'][j, 2])
+
+  def testThreads(self):
+    """
+    Bindings called from several threads at once should all give the right
+    results.
+    """
+    results = [None] * 8
+    def run(i):
+      results[i] = test_python_binding(string_in='hello',
+                                       int_in=12,
+                                       double_in=4.0,
+                                       flag1=True)
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for thread in threads:
+      thread.start()
+    for thread in threads:
+      thread.join()
+
+    for i in range(8):
+      self.assertEqual(results[i]['string_out'], 'hello2')
+      self.assertEqual(results[i]['int_out'], 13)
+      self.assertEqual(results[i]['double_out'], 5.0)
+
   def testArraylikeMatrix(self):
     """
     Test that we can pass an arraylike matrix.
@@ -608,5 +675,46 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testModelSaveLoad(self):
+    """
+    A model saved to a file and loaded once should be usable by several calls.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+    output['model_out'].save('python_binding_model.bin')
+
+    model = type(output['model_out'])()
+    model.load('python_binding_model.bin')
+    os.remove('python_binding_model.bin')
+
+    for i in range(3):
+      output2 = test_python_binding(string_in='hello',
+                                    int_in=12,
+                                    double_in=4.0,
+                                    model_in=model)
+      self.assertEqual(output2['model_bw_out'], 20.0)
+
+  def testRepeatedCalls(self):
+    """
+    Parameters given to one call should not be seen by the next call.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 flag1=True)
+    output2 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0)
+    output3 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0,
+                                  flag1=True)
+
+    self.assertEqual(output['int_out'], 13)
+    self.assertNotEqual(output2['int_out'], 13)
+    self.assertEqual(output3['int_out'], 13)
+
 if __name__ == '__main__':
   unittest.main()
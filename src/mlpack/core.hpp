@@ -90,6 +90,7 @@
  * - mlpack_range_search
  * - mlpack_softmax_regression
  * - mlpack_sparse_coding
+ * - mlpack_sparse_svm
  *
  * @section tutorial Tutorials
  *
@@ -265,8 +266,10 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/deprecated.hpp>
+#include <mlpack/core/util/parallel.hpp>
 #include <mlpack/core/data/load.hpp>
 #include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/mapped_matrix.hpp>
 #include <mlpack/core/data/normalize_labels.hpp>
 #include <mlpack/core/math/clamp.hpp>
 #include <mlpack/core/math/random.hpp>
@@ -24,11 +24,46 @@ op_ccov::direct_ccov(Mat<eT>& out, const Mat<eT>& A, const uword norm_type)
   else
     {
     const uword N = A.n_cols;
+    const uword D = A.n_rows;
     const eT norm_val = (norm_type == 0) ? ( (N > 1) ? eT(N-1) : eT(1) ) : eT(N);
 
-    const Col<eT> acc = sum(A, 1);
+    // The points are shifted by the first point, so that the sums don't lose
+    // precision when the mean is far from zero.  The sums are accumulated over
+    // blocks of columns in parallel, so that no centered copy of the whole
+    // matrix is made: each thread only holds one shifted block.
+    const Col<eT> shift = (N > 0) ? Col<eT>(A.col(0)) : Col<eT>(D, fill::zeros);
+    const uword block_size = 1024;
+    const uword n_blocks = (N + block_size - 1) / block_size;
+
+    out.zeros(D, D);
+    Col<eT> acc(D, fill::zeros);
+
+    #pragma omp parallel
+      {
+      Mat<eT> local_out(D, D, fill::zeros);
+      Col<eT> local_acc(D, fill::zeros);
+      Mat<eT> block;
+
+      #pragma omp for schedule(static)
+      for(sword b = 0; b < sword(n_blocks); ++b)
+        {
+        const uword first = uword(b) * block_size;
+        const uword last  = (std::min)(N, first + block_size) - 1;
+
+        block = A.cols(first, last);
+        block.each_col() -= shift;
+
+        local_acc += sum(block, 1);
+        local_out += block * trans(block);
+        }
+
+      #pragma omp critical
+        {
+        out += local_out;
+        acc += local_acc;
+        }
+      }
 
-    out = A * trans(A);
     out -= (acc * trans(acc)) / eT(N);
     out /= norm_val;
     }
@@ -44,6 +44,22 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * The training and validation subsets are not copied: before each fold the
+ * columns of the data are rotated in place, so that the training subset of the
+ * fold is at the beginning of the data and its validation subset at the end,
+ * and both are passed to the algorithm as aliases.  The data are rotated back
+ * once all the folds are done, and the folds see their points in the same
+ * order as without rotation.  When the folds are trained in parallel (or with
+ * EvaluateModel()), the data can't be rotated, so the training subset of each
+ * fold that wraps around the end of the data is copied for the time the fold
+ * is trained.
+ *
+ * If @c Parallel() is set to @c true, the k models are trained in parallel with
+ * OpenMP.  The random number generator of each fold is then seeded with a seed
+ * drawn beforehand on the calling thread, so the result does not depend on the
+ * number of threads (but may differ from that of a sequential run for
+ * algorithms that use random numbers).
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -177,9 +193,44 @@ class KFoldCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs& ...args);
 
+  /**
+   * Run k-fold cross-validation, and store a model from this run in the given
+   * pointer rather than in this object.  This does not modify the object, so
+   * it can be called from several threads at once.
+   *
+   * @param model Pointer to store the model trained on the last fold in.
+   * @param args Arguments for MLAlgorithm (in addition to the passed
+   *     ones in the constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                       const MLAlgorithmArgs& ...args);
+
+  /**
+   * Run k-fold cross-validation like EvaluateModel(), but train the model of
+   * each fold on the given fraction of its training subset only (the first
+   * points of it) and assess it on the whole validation subset.  This gives a
+   * cheaper, noisier estimate, as used by SuccessiveHalving.  Like
+   * EvaluateModel(), this can be called from several threads at once.
+   *
+   * @param model Pointer to store the model trained on the last fold in.
+   * @param fraction Fraction of the training points to train on, in (0, 1].
+   * @param args Arguments for MLAlgorithm (in addition to the passed
+   *     ones in the constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double EvaluateSubset(std::unique_ptr<MLAlgorithm>& model,
+                        const double fraction,
+                        const MLAlgorithmArgs& ...args);
+
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get whether the folds are trained in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the folds are trained in parallel.
+  bool& Parallel() { return parallel; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,19 +260,25 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
-  //! The extended (by repeating the first k - 2 bins) data points.
+  //! The data points.
   MatType xs;
-  //! The extended (by repeating the first k - 2 bins) predictions.
+  //! The predictions.
   PredictionsType ys;
-  //! The extended (by repeating the first k - 2 bins) weights.
+  //! The weights (optional).
   WeightsType weights;
 
-  //! The original size of the dataset.
+  //! The size of the last bin in terms of data points.
   size_t lastBinSize;
 
   //! The size of each bin in terms of data points.
   size_t binSize;
 
+  //! The number of columns the data are rotated by (to the left).
+  size_t rotation;
+
+  //! Whether the folds are trained in parallel.
+  bool parallel;
+
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
@@ -247,28 +304,47 @@ class KFoldCV
           const bool shuffle);
 
   /**
-   * Initialize the given destination matrix with the given source joined with
-   * its first k - 2 bins.
+   * Initialize the bin sizes and the given destination matrix from the given
+   * source.
    */
   template<typename DataType>
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train and run evaluation on all the folds, rotating the data in place if
+   * inPlace is true, or else copying the training subsets that need it.  The
+   * models are trained on the given fraction of their training subsets.
+   */
+  template<typename... MLAlgorithmArgs>
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const bool inPlace,
+                          const double fraction,
+                          const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Train on the given number of points of the ith training subset in the
+   * case of non-weighted learning.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  MLAlgorithm TrainFold(const size_t i,
+                        const bool inPlace,
+                        const size_t points,
+                        const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train on the given number of points of the ith training subset in the
+   * case of supporting weighted learning.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  MLAlgorithm TrainFold(const size_t i,
+                        const bool inPlace,
+                        const size_t points,
+                        const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
    * Calculate the index of the first column of the ith validation subset.
@@ -279,32 +355,62 @@ class KFoldCV
   inline size_t ValidationSubsetFirstCol(const size_t i);
 
   /**
-   * Get the ith training subset from a variable of a matrix type.
+   * Calculate the number of points to train on for the ith fold, when training
+   * on the given fraction of its training subset.
+   */
+  inline size_t TrainingPoints(const size_t i, const double fraction);
+
+  /**
+   * Rotate the data so that the training subset of the ith fold is at the
+   * beginning of the data and its validation subset at the end (with i = 0,
+   * rotate the data back to their original order).
+   */
+  inline void RotateFolds(const size_t i);
+
+  /**
+   * Rotate the columns of the given matrix to the left by the given number of
+   * columns, in place.
+   */
+  template<typename ElementType>
+  static void RotateColumns(arma::Mat<ElementType>& m, const size_t shift);
+
+  /**
+   * Get the first points of the ith training subset from a variable of a
+   * matrix type.  If inPlace is true, the data are rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetTrainingSubset(arma::Mat<ElementType>& m,
-                                                  const size_t i);
+                                                  const size_t i,
+                                                  const bool inPlace,
+                                                  const size_t points);
 
   /**
-   * Get the ith training subset from a variable of a row type.
+   * Get the first points of the ith training subset from a variable of a row
+   * type.  If inPlace is true, the data are rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetTrainingSubset(arma::Row<ElementType>& r,
-                                                  const size_t i);
+                                                  const size_t i,
+                                                  const bool inPlace,
+                                                  const size_t points);
 
   /**
-   * Get the ith validation subset from a variable of a matrix type.
+   * Get the ith validation subset from a variable of a matrix type.  If
+   * inPlace is true, the data are rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetValidationSubset(arma::Mat<ElementType>& m,
-                                                    const size_t i);
+                                                    const size_t i,
+                                                    const bool inPlace);
 
   /**
-   * Get the ith validation subset from a variable of a row type.
+   * Get the ith validation subset from a variable of a row type.  If inPlace
+   * is true, the data are rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetValidationSubset(arma::Row<ElementType>& r,
-                                                    const size_t i);
+                                                    const size_t i,
+                                                    const bool inPlace);
 };
 
 } // namespace cv
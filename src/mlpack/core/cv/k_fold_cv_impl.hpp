@@ -135,7 +135,9 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    rotation(0),
+    parallel(false)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +168,9 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    rotation(0),
+    parallel(false)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -191,7 +195,48 @@ double KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate(modelPtr, !parallel, 1.0, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                                           const MLAlgorithmArgs&... args)
+{
+  return TrainAndEvaluate(model, false, 1.0, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::EvaluateSubset(std::unique_ptr<MLAlgorithm>& model,
+                                            const double fraction,
+                                            const MLAlgorithmArgs&... args)
+{
+  if (fraction <= 0.0 || fraction > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "KFoldCV::EvaluateSubset(): the fraction of the training points ("
+        << fraction << ") should be in (0, 1]";
+    throw std::invalid_argument(oss.str());
+  }
+
+  return TrainAndEvaluate(model, false, fraction, args...);
 }
 
 template<typename MLAlgorithm,
@@ -228,8 +273,7 @@ void KFoldCV<MLAlgorithm,
   binSize = source.n_cols / k;
   lastBinSize = source.n_cols - ((k - 1) * binSize);
 
-  destination = (k == 2) ? source : arma::join_rows(source,
-      source.cols(0, source.n_cols - lastBinSize - 1));
+  destination = source;
 }
 
 template<typename MLAlgorithm,
@@ -237,25 +281,71 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename>
+template<typename... MLAlgorithmArgs>
 double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const bool inPlace,
+    const double fraction,
+    const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
 
-  for (size_t i = 0; i < k; ++i)
+  if (inPlace)
+  {
+    // Rotate the data before each fold so that its training subset is at the
+    // beginning of the data and its validation subset at the end; both of
+    // them are then aliases.  The data are rotated back at the end, or if
+    // training fails.
+    try
+    {
+      for (size_t i = 0; i < k; ++i)
+      {
+        RotateFolds(i);
+
+        MLAlgorithm&& foldModel = TrainFold(i, true,
+            TrainingPoints(i, fraction), args...);
+        evaluations(i) = Metric::Evaluate(foldModel,
+            GetValidationSubset(xs, i, true), GetValidationSubset(ys, i, true));
+        if (i == k - 1)
+          model.reset(new MLAlgorithm(std::move(foldModel)));
+      }
+    }
+    catch (...)
+    {
+      RotateFolds(0);
+      throw;
+    }
+
+    RotateFolds(0);
+    return arma::mean(evaluations);
+  }
+
+  // The last seed reseeds the calling thread once the folds are done, since
+  // the state of its generator depends on which folds it ran.
+  const std::vector<size_t> seeds = parallel ? math::RandomSeeds(k + 1) :
+      std::vector<size_t>();
+
+  #pragma omp parallel for if (parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    if (parallel)
+      math::RandomSeed(seeds[i]);
+
+    MLAlgorithm&& foldModel = TrainFold(i, false,
+        TrainingPoints(i, fraction), args...);
+    evaluations(i) = Metric::Evaluate(foldModel,
+        GetValidationSubset(xs, i, false), GetValidationSubset(ys, i, false));
+    if ((size_t) i == k - 1)
+      model.reset(new MLAlgorithm(std::move(foldModel)));
   }
 
+  if (parallel)
+    math::RandomSeed(seeds[k]);
+
   return arma::mean(evaluations);
 }
 
@@ -264,29 +354,44 @@ template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
          typename WeightsType>
-template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
-double KFoldCV<MLAlgorithm,
-                Metric,
-                MatType,
-                PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+template<typename... MLAlgorithmArgs, bool Enabled, typename>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainFold(const size_t i,
+                                            const bool inPlace,
+                                            const size_t points,
+                                            const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  return base.Train(GetTrainingSubset(xs, i, inPlace, points),
+      GetTrainingSubset(ys, i, inPlace, points), args...);
+}
 
-  for (size_t i = 0; i < k; ++i)
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainFold(const size_t i,
+                                            const bool inPlace,
+                                            const size_t points,
+                                            const MLAlgorithmArgs&... args)
+{
+  if (weights.n_elem > 0)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            GetTrainingSubset(weights, i), args...) :
-        base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
-            args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
+    return base.Train(GetTrainingSubset(xs, i, inPlace, points),
+        GetTrainingSubset(ys, i, inPlace, points),
+        GetTrainingSubset(weights, i, inPlace, points), args...);
   }
 
-  return arma::mean(evaluations);
+  return base.Train(GetTrainingSubset(xs, i, inPlace, points),
+      GetTrainingSubset(ys, i, inPlace, points), args...);
 }
 
 template<typename MLAlgorithm,
@@ -301,14 +406,7 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
-  math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  math::ShuffleData(xs, ys, xs, ys);
 }
 
 template<typename MLAlgorithm,
@@ -323,22 +421,10 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  WeightsType weightsOrig;
   if (weights.n_elem > 0)
-    weightsOrig = weights.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
-  if (weights.n_elem > 0)
-    math::ShuffleData(xsOrig, ysOrig, weightsOrig, xsOrig, ysOrig, weightsOrig);
+    math::ShuffleData(xs, ys, weights, xs, ys, weights);
   else
-    math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
-  if (weights.n_elem > 0)
-    InitKFoldCVMat(weightsOrig, weights);
+    math::ShuffleData(xs, ys, xs, ys);
 }
 
 template<typename MLAlgorithm,
@@ -356,6 +442,74 @@ size_t KFoldCV<MLAlgorithm,
   return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::TrainingPoints(const size_t i,
+                                            const double fraction)
+{
+  // If this is not the first fold, we have to handle it a little bit
+  // differently, since the last fold may contain slightly more than 'binSize'
+  // points.
+  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
+      (k - 1) * binSize;
+  if (fraction >= 1.0)
+    return subsetSize;
+
+  return std::min(subsetSize,
+      std::max((size_t) 1, (size_t) std::ceil(fraction * subsetSize)));
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::RotateFolds(const size_t i)
+{
+  // The training subset of fold i > 0 starts with bin i, and its validation
+  // subset (bin i - 1) ends the rotated data.
+  const size_t target = (i == 0) ? 0 : binSize * i;
+  const size_t shift = (target + xs.n_cols - rotation) % xs.n_cols;
+  if (shift == 0)
+    return;
+
+  RotateColumns(xs, shift);
+  RotateColumns(ys, shift);
+  if (weights.n_elem > 0)
+    RotateColumns(weights, shift);
+
+  rotation = target;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::RotateColumns(arma::Mat<ElementType>& m,
+                                         const size_t shift)
+{
+  // The columns are contiguous, so rotating the memory rotates the columns.
+  std::rotate(m.memptr(), m.memptr() + shift * m.n_rows,
+      m.memptr() + m.n_elem);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
@@ -368,16 +522,21 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetTrainingSubset(
     arma::Mat<ElementType>& m,
-    const size_t i)
+    const size_t i,
+    const bool inPlace,
+    const size_t points)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
-  return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
-      false, true);
+  // The training subset of fold i starts with bin i, except for the first fold
+  // (and for any fold in the rotated data), whose training subset starts at
+  // the beginning of the data.  Only if it wraps around the end of the data
+  // does it have to be copied.
+  const size_t first = (i == 0 || inPlace) ? 0 : binSize * i;
+  if (first + points <= m.n_cols)
+    return arma::Mat<ElementType>(m.colptr(first), m.n_rows, points, false,
+        true);
+
+  return arma::join_rows(m.cols(first, m.n_cols - 1),
+      m.cols(0, first + points - m.n_cols - 1));
 }
 
 template<typename MLAlgorithm,
@@ -392,15 +551,16 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetTrainingSubset(
     arma::Row<ElementType>& r,
-    const size_t i)
+    const size_t i,
+    const bool inPlace,
+    const size_t points)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
+  const size_t first = (i == 0 || inPlace) ? 0 : binSize * i;
+  if (first + points <= r.n_cols)
+    return arma::Row<ElementType>(r.colptr(first), points, false, true);
 
-  return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
+  return arma::join_rows(r.cols(first, r.n_cols - 1),
+      r.cols(0, first + points - r.n_cols - 1));
 }
 
 template<typename MLAlgorithm,
@@ -415,11 +575,14 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetValidationSubset(
     arma::Mat<ElementType>& m,
-    const size_t i)
+    const size_t i,
+    const bool inPlace)
 {
   const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Mat<ElementType>(m.colptr(ValidationSubsetFirstCol(i)), m.n_rows,
-      subsetSize, false, true);
+  const size_t firstCol = inPlace ? m.n_cols - subsetSize :
+      ValidationSubsetFirstCol(i);
+  return arma::Mat<ElementType>(m.colptr(firstCol), m.n_rows, subsetSize,
+      false, true);
 }
 
 template<typename MLAlgorithm,
@@ -434,11 +597,13 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
                                PredictionsType,
                                WeightsType>::GetValidationSubset(
     arma::Row<ElementType>& r,
-    const size_t i)
+    const size_t i,
+    const bool inPlace)
 {
   const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Row<ElementType>(r.colptr(ValidationSubsetFirstCol(i)),
-      subsetSize, false, true);
+  const size_t firstCol = inPlace ? r.n_cols - subsetSize :
+      ValidationSubsetFirstCol(i);
+  return arma::Row<ElementType>(r.colptr(firstCol), subsetSize, false, true);
 }
 
 } // namespace cv
@@ -208,6 +208,36 @@ class SimpleCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs&... args);
 
+  /**
+   * Train on the training set and assess performance on the validation set,
+   * and store the trained model in the given pointer rather than in this
+   * object.  This does not modify the object, so it can be called from
+   * several threads at once.
+   *
+   * @param model Pointer to store the trained model in.
+   * @param args Arguments for the given MLAlgorithm taken by its constructor
+   *     (in addition to the passed ones in the SimpleCV constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                       const MLAlgorithmArgs&... args);
+
+  /**
+   * Like EvaluateModel(), but train on the given fraction of the training set
+   * only (the first points of it), and assess performance on the whole
+   * validation set.  This gives a cheaper, noisier estimate, as used by
+   * SuccessiveHalving.
+   *
+   * @param model Pointer to store the trained model in.
+   * @param fraction Fraction of the training points to train on, in (0, 1].
+   * @param args Arguments for the given MLAlgorithm taken by its constructor
+   *     (in addition to the passed ones in the SimpleCV constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double EvaluateSubset(std::unique_ptr<MLAlgorithm>& model,
+                        const double fraction,
+                        const MLAlgorithmArgs&... args);
+
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
@@ -286,21 +316,27 @@ class SimpleCV
                                    const size_t lastCol);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train on the given number of training points and run evaluation in the
+   * case of non-weighted learning.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const size_t points,
+                          const MLAlgorithmArgs&... args);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train on the given number of training points and run evaluation in the
+   * case of supporting weighted learning.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = typename std::enable_if<Enabled>::type,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  double TrainAndEvaluate(std::unique_ptr<MLAlgorithm>& model,
+                          const size_t points,
+                          const MLAlgorithmArgs&... args);
 };
 
 } // namespace cv
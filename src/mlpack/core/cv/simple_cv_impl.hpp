@@ -194,7 +194,50 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate(modelPtr, trainingXs.n_cols, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::EvaluateModel(std::unique_ptr<MLAlgorithm>& model,
+                                            const MLAlgorithmArgs&... args)
+{
+  return TrainAndEvaluate(model, trainingXs.n_cols, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::EvaluateSubset(std::unique_ptr<MLAlgorithm>& model,
+                                             const double fraction,
+                                             const MLAlgorithmArgs&... args)
+{
+  if (fraction <= 0.0 || fraction > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "SimpleCV::EvaluateSubset(): the fraction of the training points ("
+        << fraction << ") should be in (0, 1]";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t points = std::min((size_t) trainingXs.n_cols, std::max(
+      (size_t) 1, (size_t) std::ceil(fraction * trainingXs.n_cols)));
+  return TrainAndEvaluate(model, points, args...);
 }
 
 template<typename MLAlgorithm,
@@ -291,11 +334,22 @@ double SimpleCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const size_t points,
+    const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  if (points < trainingXs.n_cols)
+  {
+    model.reset(new MLAlgorithm(base.Train(GetSubset(trainingXs, 0, points - 1),
+        GetSubset(trainingYs, 0, points - 1), args...)));
+  }
+  else
+  {
+    model.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  }
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*model, validationXs, validationYs);
 }
 
 template<typename MLAlgorithm,
@@ -308,16 +362,31 @@ double SimpleCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    std::unique_ptr<MLAlgorithm>& model,
+    const size_t points,
+    const MLAlgorithmArgs&... args)
 {
-  if (trainingWeights.n_elem > 0)
-    modelPtr.reset(new MLAlgorithm(
+  if (points < trainingXs.n_cols)
+  {
+    if (trainingWeights.n_elem > 0)
+      model.reset(new MLAlgorithm(base.Train(
+          GetSubset(trainingXs, 0, points - 1),
+          GetSubset(trainingYs, 0, points - 1),
+          GetSubset(trainingWeights, 0, points - 1), args...)));
+    else
+      model.reset(new MLAlgorithm(base.Train(
+          GetSubset(trainingXs, 0, points - 1),
+          GetSubset(trainingYs, 0, points - 1), args...)));
+  }
+  else if (trainingWeights.n_elem > 0)
+    model.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, trainingWeights, args...)));
   else
-    modelPtr.reset(new MLAlgorithm(
+    model.reset(new MLAlgorithm(
         base.Train(trainingXs, trainingYs, args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*model, validationXs, validationYs);
 }
 
 } // namespace cv
@@ -0,0 +1,210 @@
+/**
+ * @file batch_loader.cpp
+ *
+ * Implementation of BatchLoader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "batch_loader.hpp"
+#include "extension.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace mlpack {
+namespace data {
+
+BatchLoader::BatchLoader(const std::string& predictorsFile,
+                         const std::string& responsesFile,
+                         const size_t batchSize,
+                         const bool shuffle,
+                         const size_t shuffleWindow,
+                         const bool prefetch) :
+    batchSize(batchSize),
+    shuffle(shuffle),
+    shuffleWindow(std::max(shuffleWindow, batchSize)),
+    prefetch(prefetch),
+    mappedVisited(false),
+    position(0),
+    generator(math::RandInt(std::numeric_limits<int>::max())),
+    dimensionality(0),
+    responseDimensionality(0),
+    pointsRead(0)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("BatchLoader::BatchLoader(): the batch size "
+        "must be positive.");
+  }
+
+  if (Extension(predictorsFile) == "mmat" && Extension(responsesFile) == "mmat")
+  {
+    mappedPredictors.reset(new MappedMatrix<double>(predictorsFile));
+    mappedResponses.reset(new MappedMatrix<double>(responsesFile));
+    dimensionality = mappedPredictors->Matrix().n_rows;
+    responseDimensionality = mappedResponses->Matrix().n_rows;
+
+    if (mappedPredictors->Matrix().n_cols != mappedResponses->Matrix().n_cols)
+    {
+      std::ostringstream oss;
+      oss << "BatchLoader::BatchLoader(): '" << predictorsFile << "' holds "
+          << mappedPredictors->Matrix().n_cols << " points, but '"
+          << responsesFile << "' holds " << mappedResponses->Matrix().n_cols
+          << " responses.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+  else
+  {
+    predictorsReader.reset(new BatchReader(predictorsFile));
+    responsesReader.reset(new BatchReader(responsesFile));
+    dimensionality = predictorsReader->Dimensionality();
+    responseDimensionality = responsesReader->Dimensionality();
+  }
+
+  if (prefetch)
+    Prefetch();
+}
+
+BatchLoader::~BatchLoader()
+{
+  Cancel();
+}
+
+bool BatchLoader::Next(arma::mat& predictors, arma::mat& responses)
+{
+  if (!prefetch)
+  {
+    const bool loaded = Load(predictors, responses);
+    if (loaded)
+      pointsRead += predictors.n_cols;
+    return loaded;
+  }
+
+  if (!pending.valid())
+    Prefetch();
+
+  // Any error of the background thread is thrown here.
+  if (!pending.get())
+    return false;
+
+  predictors = std::move(nextPredictors);
+  responses = std::move(nextResponses);
+  pointsRead += predictors.n_cols;
+
+  Prefetch();
+  return true;
+}
+
+void BatchLoader::Rewind()
+{
+  Cancel();
+
+  mappedVisited = false;
+  if (predictorsReader)
+  {
+    predictorsReader->Rewind();
+    responsesReader->Rewind();
+  }
+
+  order.reset();
+  position = 0;
+  pointsRead = 0;
+
+  if (prefetch)
+    Prefetch();
+}
+
+bool BatchLoader::Load(arma::mat& predictors, arma::mat& responses)
+{
+  if (position == order.n_elem && !NextWindow())
+    return false;
+
+  const arma::mat& sourcePredictors = mappedPredictors ?
+      mappedPredictors->Matrix() : windowPredictors;
+  const arma::mat& sourceResponses = mappedResponses ?
+      mappedResponses->Matrix() : windowResponses;
+
+  const size_t points = std::min(batchSize, (size_t) order.n_elem - position);
+  predictors.set_size(dimensionality, points);
+  responses.set_size(responseDimensionality, points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    const size_t index = order[position + i];
+    std::copy(sourcePredictors.colptr(index),
+        sourcePredictors.colptr(index) + dimensionality, predictors.colptr(i));
+    std::copy(sourceResponses.colptr(index),
+        sourceResponses.colptr(index) + responseDimensionality,
+        responses.colptr(i));
+  }
+
+  position += points;
+  return true;
+}
+
+bool BatchLoader::NextWindow()
+{
+  size_t points = 0;
+  if (mappedPredictors)
+  {
+    if (mappedVisited)
+      return false;
+
+    mappedVisited = true;
+    points = mappedPredictors->Matrix().n_cols;
+  }
+  else
+  {
+    const bool predictorsRead = predictorsReader->Next(windowPredictors,
+        shuffleWindow);
+    const bool responsesRead = responsesReader->Next(windowResponses,
+        shuffleWindow);
+    if (!predictorsRead && !responsesRead)
+      return false;
+
+    if (windowPredictors.n_cols != windowResponses.n_cols ||
+        !predictorsRead || !responsesRead)
+    {
+      std::ostringstream oss;
+      oss << "BatchLoader::Next(): the files hold different numbers of points "
+          << "and responses (after " << predictorsReader->PointsRead()
+          << " points and " << responsesReader->PointsRead() << " responses).";
+      throw std::runtime_error(oss.str());
+    }
+
+    points = windowPredictors.n_cols;
+  }
+
+  if (points == 0)
+    return false;
+
+  order = arma::regspace<arma::uvec>(0, 1, points - 1);
+  if (shuffle)
+    std::shuffle(order.begin(), order.end(), generator);
+  position = 0;
+
+  return true;
+}
+
+void BatchLoader::Prefetch()
+{
+  pending = std::async(std::launch::async,
+      [this]() { return Load(nextPredictors, nextResponses); });
+}
+
+void BatchLoader::Cancel()
+{
+  if (pending.valid())
+  {
+    pending.wait();
+    pending = std::future<bool>();
+  }
+}
+
+} // namespace data
+} // namespace mlpack
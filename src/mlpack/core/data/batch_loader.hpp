@@ -0,0 +1,180 @@
+/**
+ * @file batch_loader.hpp
+ *
+ * Streaming of shuffled mini-batches of a labeled dataset from disk, with the
+ * next batch prefetched in the background.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BATCH_LOADER_HPP
+#define MLPACK_CORE_DATA_BATCH_LOADER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "batch_reader.hpp"
+#include "mapped_matrix.hpp"
+
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Stream the points of a dataset and their responses from disk, a batch at a
+ * time, so that datasets larger than memory can be trained on.  The predictors
+ * and the responses are in two files with one point per column (or per line,
+ * for text files), in any of the formats BatchReader reads.
+ *
+ * The points are shuffled with a permutation of their indices, never by
+ * copying the dataset:
+ *
+ *  - if both files are .mmat files (see MappedMatrix), they are mapped, and
+ *    each epoch visits all the points in a new random order, gathering the
+ *    columns of each batch from the mapping;
+ *  - otherwise, the files are read sequentially into a window of
+ *    shuffleWindow points, and the points of each window are visited in a
+ *    random order, so points are only shuffled within a window.
+ *
+ * A batch never spans two windows, so the last batch of a window can be
+ * smaller than batchSize.  If prefetch is true, the next batch is read on a
+ * background thread while the caller uses the current one, so training does
+ * not stall on the disk.  The loader uses its own random number generator,
+ * seeded from math::RandInt() when it is created, so the background thread
+ * never touches the global one.  A std::runtime_error is thrown if the files
+ * can't be read, are malformed, or hold different numbers of points.
+ *
+ * @code
+ * data::BatchLoader loader("images.mmat", "labels.mmat", 10000);
+ * arma::mat predictors, responses;
+ * for (size_t epoch = 0; epoch < 10; ++epoch)
+ * {
+ *   while (loader.Next(predictors, responses))
+ *   {
+ *     // Train on the batch.
+ *   }
+ *   loader.Rewind();
+ * }
+ * @endcode
+ */
+class BatchLoader
+{
+ public:
+  /**
+   * Open the given files.
+   *
+   * @param predictorsFile Name of the file holding the points.
+   * @param responsesFile Name of the file holding the responses.
+   * @param batchSize Largest number of points of each batch.
+   * @param shuffle Whether to visit the points in a random order.
+   * @param shuffleWindow Number of points read and shuffled at a time, for
+   *     files that are not mapped.
+   * @param prefetch Whether to read the next batch on a background thread.
+   */
+  BatchLoader(const std::string& predictorsFile,
+              const std::string& responsesFile,
+              const size_t batchSize,
+              const bool shuffle = true,
+              const size_t shuffleWindow = 100000,
+              const bool prefetch = true);
+
+  //! Wait for the batch being read in the background, if any.
+  ~BatchLoader();
+
+  BatchLoader(const BatchLoader&) = delete;
+  BatchLoader& operator=(const BatchLoader&) = delete;
+
+  /**
+   * Get the next batch of the epoch.
+   *
+   * @param predictors Matrix to store the points in (one per column).
+   * @param responses Matrix to store the responses in (one per column).
+   * @return false if there were no more points in the epoch.
+   */
+  bool Next(arma::mat& predictors, arma::mat& responses);
+
+  //! Start a new epoch, with a new order of the points.
+  void Rewind();
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the dimensionality of the responses.
+  size_t ResponseDimensionality() const { return responseDimensionality; }
+  //! Get the largest number of points of each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Get whether the points of the dataset are mapped.
+  bool Mapped() const { return (bool) mappedPredictors; }
+  //! Get the number of points given by Next() since the start of the epoch.
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  //! Read the next batch into the given matrices, returning false at the end
+  //! of the epoch.  This is what the background thread runs.
+  bool Load(arma::mat& predictors, arma::mat& responses);
+
+  //! Read (or map) the next window of points and shuffle it, returning false
+  //! at the end of the epoch.
+  bool NextWindow();
+
+  //! Start reading the next batch in the background.
+  void Prefetch();
+
+  //! Wait for the batch being read in the background and drop it.
+  void Cancel();
+
+  //! Largest number of points of each batch.
+  size_t batchSize;
+  //! Whether the points are shuffled.
+  bool shuffle;
+  //! Number of points read at a time from files that are not mapped.
+  size_t shuffleWindow;
+  //! Whether the next batch is read in the background.
+  bool prefetch;
+
+  //! The mapped points, if both files are .mmat files.
+  std::unique_ptr<MappedMatrix<double>> mappedPredictors;
+  //! The mapped responses, if both files are .mmat files.
+  std::unique_ptr<MappedMatrix<double>> mappedResponses;
+  //! Whether the mapped dataset was visited in this epoch.
+  bool mappedVisited;
+
+  //! The reader of the points, otherwise.
+  std::unique_ptr<BatchReader> predictorsReader;
+  //! The reader of the responses, otherwise.
+  std::unique_ptr<BatchReader> responsesReader;
+  //! The points of the current window.
+  arma::mat windowPredictors;
+  //! The responses of the current window.
+  arma::mat windowResponses;
+
+  //! Order in which the points of the window are visited.
+  arma::uvec order;
+  //! Number of points of the window that were visited.
+  size_t position;
+
+  //! Random number generator for the permutations.
+  std::mt19937 generator;
+
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Dimensionality of the responses.
+  size_t responseDimensionality;
+  //! Number of points given by Next() in this epoch.
+  size_t pointsRead;
+
+  //! The batch being read in the background.
+  std::future<bool> pending;
+  //! The points of the prefetched batch.
+  arma::mat nextPredictors;
+  //! The responses of the prefetched batch.
+  arma::mat nextResponses;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,589 @@
+/**
+ * @file batch_reader.cpp
+ *
+ * Implementation of BatchReader and BatchWriter.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "batch_reader.hpp"
+#include "extension.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+#ifdef HAS_HDF5
+  #include <hdf5.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+BatchReader::BatchReader(const std::string& filename) :
+    filename(filename),
+    type(TEXT_FILE),
+    info(NULL),
+    dataOffset(0),
+    numPoints(0),
+    line(0),
+    dimensionality(0),
+    pointsRead(0)
+{
+  Open();
+}
+
+BatchReader::BatchReader(const std::string& filename, DatasetInfo& info) :
+    filename(filename),
+    type(TEXT_FILE),
+    info(&info),
+    dataOffset(0),
+    numPoints(0),
+    line(0),
+    dimensionality(0),
+    pointsRead(0)
+{
+  Open();
+
+  if (info.Dimensionality() == 0)
+  {
+    info.SetDimensionality(dimensionality);
+  }
+  else if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "BatchReader::BatchReader(): '" << filename << "' has "
+        << dimensionality << " dimensions, but the DatasetInfo has "
+        << info.Dimensionality() << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (type == TEXT_FILE)
+    FirstPass();
+}
+
+void BatchReader::Open()
+{
+  const std::string extension = Extension(filename);
+  if (extension == "mmat")
+  {
+    type = MAPPED_FILE;
+    mapped.reset(new MappedMatrix<double>(filename));
+    dimensionality = mapped->Matrix().n_rows;
+    return;
+  }
+
+  if (extension == "h5" || extension == "hdf5" || extension == "hdf" ||
+      extension == "he5")
+  {
+    type = HDF5_FILE;
+#ifdef HAS_HDF5
+    const hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (file < 0)
+    {
+      std::ostringstream oss;
+      oss << "Cannot open file '" << filename << "'.";
+      throw std::runtime_error(oss.str());
+    }
+
+    const hid_t dataset = H5Dopen(file, "dataset", H5P_DEFAULT);
+    const hid_t space = (dataset < 0) ? dataset : H5Dget_space(dataset);
+    hsize_t dims[2] = { 0, 0 };
+    const bool valid = (space >= 0 && H5Sget_simple_extent_ndims(space) == 2 &&
+        H5Sget_simple_extent_dims(space, dims, NULL) == 2);
+    if (space >= 0)
+      H5Sclose(space);
+    if (dataset >= 0)
+      H5Dclose(dataset);
+    H5Fclose(file);
+
+    if (!valid)
+    {
+      std::ostringstream oss;
+      oss << "BatchReader::BatchReader(): '" << filename << "' has no "
+          << "two-dimensional dataset named 'dataset'.";
+      throw std::runtime_error(oss.str());
+    }
+
+    // HDF5 is row-major, so the features are the first dimension.
+    dimensionality = dims[0];
+    numPoints = dims[1];
+    return;
+#else
+    std::ostringstream oss;
+    oss << "BatchReader::BatchReader(): cannot read '" << filename << "' as "
+        << "HDF5 data, because mlpack was built without HDF5 support.";
+    throw std::runtime_error(oss.str());
+#endif
+  }
+
+  if (extension == "bin")
+  {
+    type = ARMA_BINARY_FILE;
+    stream.open(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+      std::ostringstream oss;
+      oss << "Cannot open file '" << filename << "'.";
+      throw std::runtime_error(oss.str());
+    }
+
+    // The header is the type of the values, and then the size of the matrix,
+    // which holds one point per row.
+    std::string header;
+    size_t rows = 0, cols = 0;
+    stream >> header >> rows >> cols;
+    stream.get();
+    if (!stream.good() || header != "ARMA_MAT_BIN_FN008")
+    {
+      std::ostringstream oss;
+      oss << "BatchReader::BatchReader(): '" << filename << "' is not an "
+          << "Armadillo binary file of doubles.";
+      throw std::runtime_error(oss.str());
+    }
+
+    dataOffset = stream.tellg();
+    numPoints = rows;
+    dimensionality = cols;
+    return;
+  }
+
+  if (extension != "csv" && extension != "txt" && extension != "tsv")
+  {
+    std::ostringstream oss;
+    oss << "BatchReader::BatchReader(): '" << filename << "' is not a .mmat, "
+        << ".csv, .txt, .tsv, .bin, or HDF5 file.";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.open(filename.c_str());
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Find the dimensionality from the first point.
+  std::vector<std::string> tokens;
+  if (ReadTokens(tokens))
+    dimensionality = tokens.size();
+  Rewind();
+}
+
+bool BatchReader::Next(arma::mat& batch, const size_t batchSize)
+{
+  if (type == MAPPED_FILE)
+  {
+    const arma::mat& matrix = mapped->Matrix();
+    if (pointsRead >= matrix.n_cols || batchSize == 0)
+      return false;
+
+    const size_t end = std::min(pointsRead + batchSize, (size_t) matrix.n_cols);
+    batch = matrix.cols(pointsRead, end - 1);
+    pointsRead = end;
+    return true;
+  }
+
+  if (type == ARMA_BINARY_FILE || type == HDF5_FILE)
+  {
+    if (pointsRead >= numPoints || batchSize == 0)
+      return false;
+
+    const size_t count = std::min(batchSize, numPoints - pointsRead);
+    arma::mat rows;
+    ReadRows(pointsRead, count, rows);
+    batch = rows.t();
+    pointsRead += count;
+    return true;
+  }
+
+  batch.set_size(dimensionality, batchSize);
+  std::vector<double> values;
+  size_t points = 0;
+  while (points < batchSize && ReadPoint(values))
+  {
+    if (values.size() != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "BatchReader::Next(): '" << filename << "', line " << line
+          << ": expected " << dimensionality << " values, but found "
+          << values.size() << ".";
+      throw std::runtime_error(oss.str());
+    }
+
+    std::copy(values.begin(), values.end(), batch.colptr(points));
+    ++points;
+  }
+
+  pointsRead += points;
+  if (points < batchSize)
+    batch.resize(dimensionality, points);
+  return (points > 0);
+}
+
+void BatchReader::Rewind()
+{
+  pointsRead = 0;
+  if (type != TEXT_FILE)
+    return;
+
+  stream.clear();
+  stream.seekg(0);
+  line = 0;
+}
+
+bool BatchReader::ReadPoint(std::vector<double>& values)
+{
+  std::string text;
+  while (std::getline(stream, text))
+  {
+    ++line;
+    values.clear();
+
+    const char* p = text.c_str();
+    while (true)
+    {
+      // Skip separators.
+      while (*p == ',' || *p == ' ' || *p == '\t' || *p == '\r')
+        ++p;
+      if (*p == '\0')
+        break;
+
+      char* end;
+      const double value = std::strtod(p, &end);
+      if (info == NULL)
+      {
+        if (end == p)
+        {
+          std::ostringstream oss;
+          oss << "BatchReader: '" << filename << "', line " << line
+              << ": cannot parse '" << p << "' as a number.";
+          throw std::runtime_error(oss.str());
+        }
+
+        values.push_back(value);
+        p = end;
+        continue;
+      }
+
+      // With a DatasetInfo, the token runs to the next separator; it is only
+      // read as a number in a numeric dimension, and mapped otherwise.
+      const char* tokenEnd = p;
+      while (*tokenEnd != '\0' && *tokenEnd != ',' && *tokenEnd != ' ' &&
+          *tokenEnd != '\t' && *tokenEnd != '\r')
+        ++tokenEnd;
+
+      const size_t dimension = values.size();
+      if (dimension >= dimensionality)
+      {
+        std::ostringstream oss;
+        oss << "BatchReader::Next(): '" << filename << "', line " << line
+            << ": expected " << dimensionality << " values, but found more.";
+        throw std::runtime_error(oss.str());
+      }
+
+      if (info->Type(dimension) == Datatype::numeric && end == tokenEnd)
+      {
+        values.push_back(value);
+      }
+      else
+      {
+        values.push_back(info->MapString<double>(std::string(p, tokenEnd),
+            dimension));
+      }
+      p = tokenEnd;
+    }
+
+    // Blank lines hold no point.
+    if (!values.empty())
+      return true;
+  }
+
+  if (stream.bad())
+  {
+    std::ostringstream oss;
+    oss << "BatchReader: error while reading '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return false;
+}
+
+bool BatchReader::ReadTokens(std::vector<std::string>& tokens)
+{
+  std::string text;
+  while (std::getline(stream, text))
+  {
+    ++line;
+    tokens.clear();
+
+    const char* p = text.c_str();
+    while (true)
+    {
+      // Skip separators.
+      while (*p == ',' || *p == ' ' || *p == '\t' || *p == '\r')
+        ++p;
+      if (*p == '\0')
+        break;
+
+      const char* end = p;
+      while (*end != '\0' && *end != ',' && *end != ' ' && *end != '\t' &&
+          *end != '\r')
+        ++end;
+
+      tokens.push_back(std::string(p, end));
+      p = end;
+    }
+
+    // Blank lines hold no point.
+    if (!tokens.empty())
+      return true;
+  }
+
+  if (stream.bad())
+  {
+    std::ostringstream oss;
+    oss << "BatchReader: error while reading '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return false;
+}
+
+void BatchReader::FirstPass()
+{
+  // A dimension is categorical if any of its values is not a number, as in
+  // data::Load(); the mappings themselves are made as the batches are read.
+  std::vector<std::string> tokens;
+  while (ReadTokens(tokens))
+  {
+    for (size_t d = 0; d < std::min(tokens.size(), dimensionality); ++d)
+    {
+      if (info->Type(d) == Datatype::categorical)
+        continue;
+
+      char* end;
+      const char* token = tokens[d].c_str();
+      std::strtod(token, &end);
+      if (end == token || *end != '\0')
+        info->Type(d) = Datatype::categorical;
+    }
+  }
+
+  Rewind();
+}
+
+void BatchReader::ReadRows(const size_t first,
+                           const size_t count,
+                           arma::mat& rows)
+{
+  rows.set_size(count, dimensionality);
+
+  if (type == ARMA_BINARY_FILE)
+  {
+    // The matrix is column-major, so the values of each dimension for the
+    // points of the batch are contiguous.
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      stream.clear();
+      stream.seekg(dataOffset + (std::streamoff) ((d * numPoints + first) *
+          sizeof(double)));
+      stream.read((char*) rows.colptr(d), count * sizeof(double));
+      if (!stream.good())
+      {
+        std::ostringstream oss;
+        oss << "BatchReader::Next(): error while reading '" << filename
+            << "'.";
+        throw std::runtime_error(oss.str());
+      }
+    }
+
+    return;
+  }
+
+#ifdef HAS_HDF5
+  // The hyperslab of the batch is a row-major (dimensionality x count) block,
+  // which is the column-major (count x dimensionality) matrix of the points.
+  const hid_t file = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  const hid_t dataset = (file < 0) ? file : H5Dopen(file, "dataset",
+      H5P_DEFAULT);
+  const hid_t fileSpace = (dataset < 0) ? dataset : H5Dget_space(dataset);
+
+  const hsize_t start[2] = { 0, (hsize_t) first };
+  const hsize_t size[2] = { (hsize_t) dimensionality, (hsize_t) count };
+  const hid_t memorySpace = H5Screate_simple(2, size, NULL);
+  const bool success = (fileSpace >= 0 && memorySpace >= 0 &&
+      H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, NULL, size,
+          NULL) >= 0 &&
+      H5Dread(dataset, H5T_NATIVE_DOUBLE, memorySpace, fileSpace, H5P_DEFAULT,
+          rows.memptr()) >= 0);
+
+  if (memorySpace >= 0)
+    H5Sclose(memorySpace);
+  if (fileSpace >= 0)
+    H5Sclose(fileSpace);
+  if (dataset >= 0)
+    H5Dclose(dataset);
+  if (file >= 0)
+    H5Fclose(file);
+
+  if (!success)
+  {
+    std::ostringstream oss;
+    oss << "BatchReader::Next(): error while reading '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+#endif
+}
+
+BatchWriter::BatchWriter(const std::string& filename,
+                         const size_t dimensionality,
+                         const size_t numPoints) :
+    filename(filename),
+    binary(Extension(filename) == "mmat"),
+    dimensionality(dimensionality),
+    numPoints(numPoints),
+    fixedSize(true),
+    pointsWritten(0)
+{
+  Open();
+}
+
+BatchWriter::BatchWriter(const std::string& filename,
+                         const size_t dimensionality) :
+    filename(filename),
+    binary(Extension(filename) == "mmat"),
+    dimensionality(dimensionality),
+    numPoints(std::numeric_limits<size_t>::max()),
+    fixedSize(false),
+    pointsWritten(0)
+{
+  Open();
+}
+
+void BatchWriter::Open()
+{
+  const std::string extension = Extension(filename);
+  if (!binary && extension != "csv" && extension != "txt" &&
+      extension != "tsv")
+  {
+    std::ostringstream oss;
+    oss << "BatchWriter::BatchWriter(): '" << filename << "' is not a .mmat, "
+        << ".csv, .txt, or .tsv file.";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.open(filename.c_str(), binary ? (std::ios::out | std::ios::binary |
+      std::ios::trunc) : (std::ios::out | std::ios::trunc));
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "' for writing.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (binary)
+  {
+    // If the number of points isn't known yet, the header is written again by
+    // Close().
+    WriteHeader(fixedSize ? numPoints : 0);
+  }
+  else
+  {
+    // Write enough digits for the values to be read back exactly.
+    stream.precision(std::numeric_limits<double>::max_digits10);
+  }
+}
+
+void BatchWriter::WriteHeader(const size_t numCols)
+{
+  MappedMatrixHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "MLPACKMM", 8);
+  header.byteOrder = 0x01020304;
+  header.elemKind = MappedElementKind<double>::value;
+  header.elemSize = sizeof(double);
+  header.nRows = dimensionality;
+  header.nCols = numCols;
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+void BatchWriter::Write(const arma::mat& batch)
+{
+  if (batch.n_cols > 0 && batch.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "BatchWriter::Write(): points of dimensionality " << batch.n_rows
+        << " were given, but the file holds points of dimensionality "
+        << dimensionality << ".";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (pointsWritten + batch.n_cols > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "BatchWriter::Write(): more than the announced " << numPoints
+        << " points were written to '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (binary)
+  {
+    stream.write(reinterpret_cast<const char*>(batch.memptr()),
+        std::streamsize(batch.n_elem * sizeof(double)));
+  }
+  else
+  {
+    const char separator = (Extension(filename) == "csv") ? ',' : ' ';
+    for (size_t i = 0; i < batch.n_cols; ++i)
+    {
+      for (size_t d = 0; d < batch.n_rows; ++d)
+      {
+        if (d > 0)
+          stream << separator;
+        stream << batch(d, i);
+      }
+      stream << '\n';
+    }
+  }
+
+  pointsWritten += batch.n_cols;
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "BatchWriter::Write(): error while writing '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+void BatchWriter::Close()
+{
+  if (binary && !fixedSize)
+  {
+    stream.seekp(0);
+    WriteHeader(pointsWritten);
+  }
+
+  stream.close();
+  if (stream.fail())
+  {
+    std::ostringstream oss;
+    oss << "BatchWriter::Close(): error while writing '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (fixedSize && pointsWritten != numPoints)
+  {
+    std::ostringstream oss;
+    oss << "BatchWriter::Close(): only " << pointsWritten << " of the "
+        << "announced " << numPoints << " points were written to '" << filename
+        << "'.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,232 @@
+/**
+ * @file batch_reader.hpp
+ *
+ * Reading and writing datasets a batch of points at a time, for algorithms
+ * that work on datasets that don't fit in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BATCH_READER_HPP
+#define MLPACK_CORE_DATA_BATCH_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "dataset_mapper.hpp"
+#include "mapped_matrix.hpp"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Read a dataset a batch of points at a time, so that only one batch has to be
+ * held in memory.  These kinds of files are supported:
+ *
+ *  - .mmat files (see MappedMatrix) holding doubles, which are mapped, so that
+ *    the pages of each batch are only read when the batch is;
+ *  - text files (.csv, .txt, .tsv), with one point per line and the values
+ *    separated by commas or whitespace, as data::Load() reads them;
+ *  - Armadillo binary files (.bin) of doubles, with one point per row, as
+ *    data::Save() writes them; only the values of each batch are read;
+ *  - HDF5 files (.h5, .hdf5, .hdf, .he5) with a dataset named "dataset" and one
+ *    point per row, as data::Save() writes them; each batch is read as a
+ *    hyperslab.  This needs Armadillo and mlpack to be built with HDF5.
+ *
+ * Text files may hold categorical features when a DatasetInfo is given: the
+ * whole file is then scanned once when it is opened, to find the categorical
+ * dimensions as data::Load() does, and the values of the categorical
+ * dimensions are mapped through the DatasetInfo as the batches are read, so
+ * each string has the same value in every batch (and the same value as in an
+ * earlier dataset, if the DatasetInfo already holds its mappings).
+ *
+ * The dataset can be read any number of times with Rewind().  A
+ * std::runtime_error is thrown if the file can't be read or is malformed.  To
+ * read the next batch in the background while the current one is used, see
+ * ForEachBatch().
+ *
+ * @code
+ * data::BatchReader reader("dataset.csv");
+ * arma::mat batch;
+ * while (reader.Next(batch, 10000))
+ * {
+ *   // Use the points in batch.
+ * }
+ * @endcode
+ */
+class BatchReader
+{
+ public:
+  /**
+   * Open the given file.  The first point of a text file is read to find the
+   * dimensionality of the dataset.
+   *
+   * @param filename Name of the file to read.
+   */
+  BatchReader(const std::string& filename);
+
+  /**
+   * Open the given file, whose categorical dimensions are mapped through the
+   * given DatasetInfo; see the class documentation.  If the DatasetInfo is
+   * empty, it is given the dimensionality of the file; otherwise it must have
+   * that dimensionality.  The DatasetInfo must outlive the reader.
+   *
+   * @param filename Name of the file to read.
+   * @param info Mappings of the categorical dimensions.
+   */
+  BatchReader(const std::string& filename, DatasetInfo& info);
+
+  BatchReader(const BatchReader&) = delete;
+  BatchReader& operator=(const BatchReader&) = delete;
+
+  /**
+   * Read the next batch of up to batchSize points into the given matrix (one
+   * point per column).
+   *
+   * @param batch Matrix to store the points in.
+   * @param batchSize Largest number of points to read.
+   * @return false if there were no more points to read.
+   */
+  bool Next(arma::mat& batch, const size_t batchSize);
+
+  //! Start reading the dataset from the first point again.
+  void Rewind();
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of points read since the file was opened or rewound.
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  //! Open the file, and find its dimensionality (and its number of points,
+  //! for binary files).
+  void Open();
+
+  //! Read the next line holding a point into the given vector, returning false
+  //! at the end of the file.  The values of the categorical dimensions are
+  //! mapped, if there is a DatasetInfo.
+  bool ReadPoint(std::vector<double>& values);
+
+  //! Read the next line holding a point, split into its values, returning
+  //! false at the end of the file.
+  bool ReadTokens(std::vector<std::string>& tokens);
+
+  //! Scan the text file to find its categorical dimensions.
+  void FirstPass();
+
+  //! Read the given points of an Armadillo binary or HDF5 file into the given
+  //! matrix, one point per row.
+  void ReadRows(const size_t first, const size_t count, arma::mat& rows);
+
+  //! Kinds of files that can be read.
+  enum FileType
+  {
+    TEXT_FILE,
+    MAPPED_FILE,
+    ARMA_BINARY_FILE,
+    HDF5_FILE
+  };
+
+  //! Name of the file.
+  std::string filename;
+  //! The kind of the file.
+  FileType type;
+  //! Mappings of the categorical dimensions of a text file, if any.
+  DatasetInfo* info;
+  //! The mapped .mmat file, if this is one.
+  std::unique_ptr<MappedMatrix<double>> mapped;
+  //! The text or Armadillo binary file, otherwise.
+  std::ifstream stream;
+  //! Position of the first value of an Armadillo binary file.
+  std::streamoff dataOffset;
+  //! Number of points of an Armadillo binary or HDF5 file.
+  size_t numPoints;
+  //! Line of the text file that was read last.
+  size_t line;
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Number of points read since the file was opened or rewound.
+  size_t pointsRead;
+};
+
+/**
+ * Write a dataset a batch of points at a time, to a .mmat file or a text file
+ * (.csv, .txt, .tsv) with one point per line.  The number of points can be
+ * given in advance, and is then checked; otherwise, the header of a .mmat file
+ * is completed by Close().  A std::runtime_error is thrown if the file can't be
+ * written, or if more points are written than were announced.
+ */
+class BatchWriter
+{
+ public:
+  /**
+   * Create the given file, which will hold the given number of points of the
+   * given dimensionality.
+   *
+   * @param filename Name of the file to write.
+   * @param dimensionality Dimensionality of the points.
+   * @param numPoints Number of points that will be written.
+   */
+  BatchWriter(const std::string& filename,
+              const size_t dimensionality,
+              const size_t numPoints);
+
+  /**
+   * Create the given file, which will hold points of the given
+   * dimensionality; the number of points is the number that are written
+   * before Close().
+   *
+   * @param filename Name of the file to write.
+   * @param dimensionality Dimensionality of the points.
+   */
+  BatchWriter(const std::string& filename, const size_t dimensionality);
+
+  BatchWriter(const BatchWriter&) = delete;
+  BatchWriter& operator=(const BatchWriter&) = delete;
+
+  /**
+   * Write the given points (one per column) after the ones written before.
+   *
+   * @param batch Points to write.
+   */
+  void Write(const arma::mat& batch);
+
+  /**
+   * Flush the file, and make sure all the announced points were written.
+   */
+  void Close();
+
+  //! Get the number of points written so far.
+  size_t PointsWritten() const { return pointsWritten; }
+
+ private:
+  //! Open the file and write the header of a .mmat file.
+  void Open();
+
+  //! Write the header of a .mmat file with the given number of points.
+  void WriteHeader(const size_t numCols);
+
+  //! Name of the file.
+  std::string filename;
+  //! The file.
+  std::ofstream stream;
+  //! Whether the file is a .mmat file.
+  bool binary;
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Number of points that will be written.
+  size_t numPoints;
+  //! Whether the number of points was given in advance.
+  bool fixedSize;
+  //! Number of points written so far.
+  size_t pointsWritten;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -79,11 +79,20 @@ void Binarize(const arma::Mat<T>& input,
               const double threshold,
               const size_t dimension)
 {
-  output = input;
+  // The copy and the binarization are done in the same pass over the columns.
+  // The input and the output may be the same matrix.
+  output.copy_size(input);
 
   #pragma omp parallel for
   for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    if (&output != &input)
+    {
+      std::copy(input.colptr(i), input.colptr(i) + input.n_rows,
+          output.colptr(i));
+    }
     output(dimension, i) = input(dimension, i) > threshold;
+  }
 }
 
 } // namespace data
@@ -0,0 +1,131 @@
+/**
+ * @file blob_archive.cpp
+ *
+ * Implementation of the blob archives, and instantiation of the parts of
+ * boost::serialization's binary archives that they use.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "blob_archive.hpp"
+
+#include <boost/archive/impl/archive_serializer_map.ipp>
+#include <boost/archive/impl/basic_binary_iarchive.ipp>
+#include <boost/archive/impl/basic_binary_iprimitive.ipp>
+#include <boost/archive/impl/basic_binary_oarchive.ipp>
+#include <boost/archive/impl/basic_binary_oprimitive.ipp>
+
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+BlobOArchive::BlobOArchive(std::ostream& stream, unsigned int flags) :
+    boost::archive::binary_oarchive_impl<BlobOArchive,
+        std::ostream::char_type, std::ostream::traits_type>(stream,
+        flags | boost::archive::no_header),
+    compactTrees(false)
+{
+  WriteHeader(flags);
+}
+
+BlobOArchive::BlobOArchive(std::streambuf& buffer, unsigned int flags) :
+    boost::archive::binary_oarchive_impl<BlobOArchive,
+        std::ostream::char_type, std::ostream::traits_type>(buffer,
+        flags | boost::archive::no_header),
+    compactTrees(false)
+{
+  WriteHeader(flags);
+}
+
+void BlobOArchive::WriteHeader(const unsigned int flags)
+{
+  BlobHeader header;
+  std::memcpy(header.magic, "MLPKBLOB", sizeof(header.magic));
+  header.version = blobVersion;
+  header.byteOrder = 0x01020304;
+  save_binary(&header, sizeof(header));
+
+  // The header of boost::serialization follows, so that files keep loading
+  // with later versions of boost.
+  init(flags);
+}
+
+BlobIArchive::BlobIArchive(std::istream& stream, unsigned int flags) :
+    boost::archive::binary_iarchive_impl<BlobIArchive,
+        std::istream::char_type, std::istream::traits_type>(stream,
+        flags | boost::archive::no_header),
+    version(0)
+{
+  ReadHeader(flags);
+}
+
+BlobIArchive::BlobIArchive(std::streambuf& buffer, unsigned int flags) :
+    boost::archive::binary_iarchive_impl<BlobIArchive,
+        std::istream::char_type, std::istream::traits_type>(buffer,
+        flags | boost::archive::no_header),
+    version(0)
+{
+  ReadHeader(flags);
+}
+
+void BlobIArchive::ReadHeader(const unsigned int flags)
+{
+  BlobHeader header;
+  try
+  {
+    load_binary(&header, sizeof(header));
+  }
+  catch (boost::archive::archive_exception&)
+  {
+    throw std::runtime_error("BlobIArchive: the data is too short to be a "
+        "blob model.");
+  }
+
+  if (std::memcmp(header.magic, "MLPKBLOB", sizeof(header.magic)) != 0)
+    throw std::runtime_error("BlobIArchive: the data is not a blob model.");
+
+  if (header.byteOrder != 0x01020304)
+  {
+    throw std::runtime_error("BlobIArchive: the blob model was written on a "
+        "machine with another byte order.");
+  }
+
+  if (header.version == 0 || header.version > blobVersion)
+  {
+    std::ostringstream oss;
+    oss << "BlobIArchive: the blob model has version " << header.version
+        << ", but this version of mlpack reads versions up to " << blobVersion
+        << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  version = header.version;
+  init(flags);
+}
+
+} // namespace data
+} // namespace mlpack
+
+// The parts of the binary archives that are templated on the archive are only
+// instantiated by boost for its own archives.
+namespace boost {
+namespace archive {
+
+template class basic_binary_oprimitive<mlpack::data::BlobOArchive,
+    std::ostream::char_type, std::ostream::traits_type>;
+template class basic_binary_iprimitive<mlpack::data::BlobIArchive,
+    std::istream::char_type, std::istream::traits_type>;
+template class basic_binary_oarchive<mlpack::data::BlobOArchive>;
+template class basic_binary_iarchive<mlpack::data::BlobIArchive>;
+template class binary_oarchive_impl<mlpack::data::BlobOArchive,
+    std::ostream::char_type, std::ostream::traits_type>;
+template class binary_iarchive_impl<mlpack::data::BlobIArchive,
+    std::istream::char_type, std::istream::traits_type>;
+template class detail::archive_serializer_map<mlpack::data::BlobOArchive>;
+template class detail::archive_serializer_map<mlpack::data::BlobIArchive>;
+
+} // namespace archive
+} // namespace boost
@@ -0,0 +1,194 @@
+/**
+ * @file blob_archive.hpp
+ *
+ * The archives of mlpack's blob model format: a versioned binary format that
+ * writes matrices as raw contiguous blocks and trees as flat preorder arrays
+ * of nodes, and that is read from a mapping of the file.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BLOB_ARCHIVE_HPP
+#define MLPACK_CORE_DATA_BLOB_ARCHIVE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <boost/archive/binary_iarchive_impl.hpp>
+#include <boost/archive/binary_oarchive_impl.hpp>
+#include <boost/archive/detail/register_archive.hpp>
+
+#include <istream>
+#include <ostream>
+#include <streambuf>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of a blob model file, which is followed by the archive itself.
+ * The version is that of the layout of the file; it is increased whenever
+ * mlpack changes how the blob archives write an object they both handle, so
+ * that older files are recognized.  The byte order mark is written in the byte
+ * order of the machine, so that files from machines with another byte order
+ * are rejected rather than misread.
+ */
+struct BlobHeader
+{
+  //! The magic bytes, "MLPKBLOB".
+  char magic[8];
+  //! The version of the layout of the file.
+  uint32_t version;
+  //! 0x01020304, in the byte order of the machine that wrote the file.
+  uint32_t byteOrder;
+};
+
+static_assert(sizeof(BlobHeader) == 16, "BlobHeader must be 16 bytes long.");
+
+//! The version of the layout of the blob files written by this version of
+//! mlpack.  Version 2 added compact trees.
+const uint32_t blobVersion = 2;
+
+/**
+ * A boost::serialization output archive for the blob model format.  It writes
+ * a BlobHeader, and then everything in the binary layout of
+ * boost::archive::binary_oarchive, so any object with a serialize() method can
+ * be saved with it.  Arrays of fundamental types (the memory of Armadillo
+ * matrices in particular) are written as single raw blocks.  Trees that check
+ * IsBlobArchive (such as BinarySpaceTree) write their nodes as a flat preorder
+ * array instead of as a chain of pointers, which avoids tracking every node.
+ * If CompactTrees() is true, these trees only write their structure (the
+ * range of points of each node) along with their permuted dataset, and their
+ * bounds and statistics are rebuilt from the points when the file is loaded;
+ * this makes files smaller and cold starts faster for large trees.
+ *
+ * Like the binary archive, the format depends on the byte order and the sizes
+ * of the fundamental types of the machine, so it is meant for fast saving and
+ * loading of models rather than for exchanging them between platforms.
+ */
+class BlobOArchive : public boost::archive::binary_oarchive_impl<
+    BlobOArchive, std::ostream::char_type, std::ostream::traits_type>
+{
+ public:
+  //! Write the header of the blob format to the given stream.
+  BlobOArchive(std::ostream& stream, unsigned int flags = 0);
+  //! Write the header of the blob format to the given stream buffer.
+  BlobOArchive(std::streambuf& buffer, unsigned int flags = 0);
+
+  //! Get the version of the layout of the file being written.
+  uint32_t BlobVersion() const { return blobVersion; }
+
+  //! Get whether trees are written without their bounds and statistics.
+  bool CompactTrees() const { return compactTrees; }
+  //! Modify whether trees are written without their bounds and statistics.
+  bool& CompactTrees() { return compactTrees; }
+
+ private:
+  //! Write the headers of the file.
+  void WriteHeader(const unsigned int flags);
+
+  //! Whether trees are written without their bounds and statistics.
+  bool compactTrees;
+};
+
+/**
+ * A boost::serialization input archive for the blob model format (see
+ * BlobOArchive).  A std::runtime_error is thrown if the data doesn't start with
+ * a valid BlobHeader, or if it was written by a newer version of mlpack.
+ */
+class BlobIArchive : public boost::archive::binary_iarchive_impl<
+    BlobIArchive, std::istream::char_type, std::istream::traits_type>
+{
+ public:
+  //! Read and check the header of the blob format from the given stream.
+  BlobIArchive(std::istream& stream, unsigned int flags = 0);
+  //! Read and check the header of the blob format from the given stream
+  //! buffer.
+  BlobIArchive(std::streambuf& buffer, unsigned int flags = 0);
+
+  //! Get the version of the layout of the file being read.
+  uint32_t BlobVersion() const { return version; }
+
+ private:
+  //! Read and check the headers of the file.
+  void ReadHeader(const unsigned int flags);
+
+  //! The version of the layout of the file.
+  uint32_t version;
+};
+
+/**
+ * A read-only stream buffer over a block of memory (such as a mapped file), so
+ * that a BlobIArchive reads each array with a single copy from the memory.
+ */
+class MemoryStreambuf : public std::streambuf
+{
+ public:
+  //! Read from the given memory, of the given size in bytes.
+  MemoryStreambuf(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+/**
+ * Whether the given archive is one of the blob archives, so that serialize()
+ * methods can choose a flatter layout for them.
+ */
+template<typename Archive>
+struct IsBlobArchive
+{
+  static const bool value = false;
+};
+
+template<>
+struct IsBlobArchive<BlobOArchive>
+{
+  static const bool value = true;
+};
+
+template<>
+struct IsBlobArchive<BlobIArchive>
+{
+  static const bool value = true;
+};
+
+/**
+ * Get the version of the layout of the blob file the given archive writes or
+ * reads, or 0 if it is not a blob archive.  This compiles for any archive, so
+ * serialize() methods can call it.
+ */
+template<typename Archive>
+uint32_t BlobVersion(const Archive& /* ar */) { return 0; }
+
+//! Get the version of the layout of the blob file being written.
+inline uint32_t BlobVersion(const BlobOArchive& ar) { return ar.BlobVersion(); }
+
+//! Get the version of the layout of the blob file being read.
+inline uint32_t BlobVersion(const BlobIArchive& ar) { return ar.BlobVersion(); }
+
+/**
+ * Get whether trees should be written to the given archive without their
+ * bounds and statistics; this is only the case for BlobOArchive, if
+ * CompactTrees() is true.
+ */
+template<typename Archive>
+bool CompactTrees(const Archive& /* ar */) { return false; }
+
+//! Get whether trees are written to the given archive without their bounds and
+//! statistics.
+inline bool CompactTrees(const BlobOArchive& ar) { return ar.CompactTrees(); }
+
+} // namespace data
+} // namespace mlpack
+
+// Required so that BOOST_CLASS_EXPORT() covers the blob archives, and so that
+// arrays of fundamental types are written as raw blocks.
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mlpack::data::BlobOArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(mlpack::data::BlobOArchive)
+BOOST_SERIALIZATION_REGISTER_ARCHIVE(mlpack::data::BlobIArchive)
+BOOST_SERIALIZATION_USE_ARRAY_OPTIMIZATION(mlpack::data::BlobIArchive)
+
+#endif
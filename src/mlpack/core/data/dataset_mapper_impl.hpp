@@ -179,8 +179,10 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     const InputType& input,
     const size_t dimension)
 {
-  // Throw an exception if the value doesn't exist.
-  if (maps[dimension].first.count(input) == 0)
+  // Throw an exception if the value doesn't exist.  The maps are only read, so
+  // this may be called from several threads at once.
+  typename MapType::const_iterator it = maps.find(dimension);
+  if (it == maps.end() || it->second.first.count(input) == 0)
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapValue(): input '"
@@ -188,7 +190,7 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     throw std::invalid_argument(oss.str());
   }
 
-  return maps[dimension].first.at(input);
+  return it->second.first.at(input);
 }
 
 // Get the type of a particular dimension.
@@ -0,0 +1,92 @@
+/**
+ * @file for_each_batch.hpp
+ *
+ * A pass over a dataset that is read a batch of columns at a time, with the
+ * next batch read in the background.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_FOR_EACH_BATCH_HPP
+#define MLPACK_CORE_DATA_FOR_EACH_BATCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <future>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Rewind the given source of batches, and call the given function on each of
+ * its batches of columns, in order, as function(batch, offset), where offset
+ * is the index of the first column of the batch in the whole dataset.  The
+ * source can be a BatchReader, or any other class with the same Next() and
+ * Rewind() methods, such as an iterator over the blocks of a matrix held
+ * elsewhere.  If prefetch is true, the next batch is read on a background
+ * thread while the function runs on the current one, so the pass does not
+ * alternate between the disk and the CPU; the source is still only used by
+ * one thread at a time.
+ *
+ * @code
+ * data::BatchReader reader("dataset.mmat");
+ * arma::vec sum;
+ * const size_t n = data::ForEachBatch(reader, 10000,
+ *     [&](const arma::mat& batch, const size_t offset)
+ *     {
+ *       if (offset == 0)
+ *         sum.zeros(batch.n_rows);
+ *       sum += arma::sum(batch, 1);
+ *     });
+ * @endcode
+ *
+ * @param source Source of the batches.
+ * @param batchSize Largest number of columns of each batch.
+ * @param function Function to call on each batch.
+ * @param prefetch Whether to read the next batch on a background thread.
+ * @return The number of columns of the dataset.
+ */
+template<typename SourceType, typename FunctionType>
+size_t ForEachBatch(SourceType& source,
+                    const size_t batchSize,
+                    FunctionType function,
+                    const bool prefetch = true)
+{
+  source.Rewind();
+
+  arma::mat batch, next;
+  size_t offset = 0;
+  bool hasBatch = source.Next(batch, batchSize);
+  while (hasBatch)
+  {
+    if (prefetch)
+    {
+      std::future<bool> pending = std::async(std::launch::async,
+          [&source, &next, batchSize]() {
+            return source.Next(next, batchSize);
+          });
+
+      function((const arma::mat&) batch, offset);
+      offset += batch.n_cols;
+
+      hasBatch = pending.get();
+      batch.swap(next);
+    }
+    else
+    {
+      function((const arma::mat&) batch, offset);
+      offset += batch.n_cols;
+
+      hasBatch = source.Next(batch, batchSize);
+    }
+  }
+
+  return offset;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
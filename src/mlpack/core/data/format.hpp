@@ -22,7 +22,9 @@ enum format
   autodetect,
   text,
   xml,
-  binary
+  binary,
+  blob,
+  compact_blob
 };
 
 } // namespace data
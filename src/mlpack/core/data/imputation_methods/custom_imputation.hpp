@@ -46,28 +46,19 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
+    // The elements of the dimension are at a fixed stride: a row of a
+    // column-major matrix, or a column otherwise.
+    T* elements = columnMajor ? input.memptr() + dimension :
+        input.colptr(dimension);
+    const size_t stride = columnMajor ? input.n_rows : 1;
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
+
     // replace the target value to custom value
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
-    }
-    else
+    for (size_t i = 0; i < n; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
-      }
+      T& value = elements[i * stride];
+      if (value == mappedValue || std::isnan(value))
+        value = customValue;
     }
   }
 
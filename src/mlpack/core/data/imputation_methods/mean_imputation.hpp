@@ -39,46 +39,24 @@ class MeanImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    double sum = 0;
-    size_t elems = 0; // excluding nan or missing target
-
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-
+    // The elements of the dimension are at a fixed stride: a row of a
+    // column-major matrix, or a column otherwise.
+    T* elements = columnMajor ? input.memptr() + dimension :
+        input.colptr(dimension);
+    const size_t stride = columnMajor ? input.n_rows : 1;
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
 
-    // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elems++;
-          sum += input(dimension, i);
-        }
-      }
-    }
-    else
+    // Calculate the number of elements and their sum, excluding the mapped
+    // value and NaNs.
+    double sum = 0;
+    size_t elems = 0;
+    for (size_t i = 0; i < n; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      const T value = elements[i * stride];
+      if (!(value == mappedValue || std::isnan(value)))
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
-        }
+        elems++;
+        sum += value;
       }
     }
 
@@ -86,14 +64,16 @@ class MeanImputation
       Log::Fatal << "it is impossible to calculate mean; no valid elements in "
           << "the dimension" << std::endl;
 
-    // calculate mean;
+    // Now replace the missing values with the mean.
     const double mean = sum / elems;
-
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    if (elems < n)
     {
-      input(target.first, target.second) = mean;
+      for (size_t i = 0; i < n; ++i)
+      {
+        T& value = elements[i * stride];
+        if (value == mappedValue || std::isnan(value))
+          value = mean;
+      }
     }
   }
 }; // class MeanImputation
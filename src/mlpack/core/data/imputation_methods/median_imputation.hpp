@@ -40,49 +40,47 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-    // good elements are kept inside this vector.
-    std::vector<double> elemsToKeep;
+    // The elements of the dimension are at a fixed stride: a row of a
+    // column-major matrix, or a column otherwise.
+    T* elements = columnMajor ? input.memptr() + dimension :
+        input.colptr(dimension);
+    const size_t stride = columnMajor ? input.n_rows : 1;
+    const size_t n = columnMajor ? input.n_cols : input.n_rows;
 
-    if (columnMajor)
+    // Good elements are kept inside this vector.
+    std::vector<double> elemsToKeep;
+    elemsToKeep.reserve(n);
+    for (size_t i = 0; i < n; ++i)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
-      }
+      const T value = elements[i * stride];
+      if (!(value == mappedValue || std::isnan(value)))
+        elemsToKeep.push_back(value);
     }
-    else
+
+    if (elemsToKeep.empty())
+      Log::Fatal << "it is impossible to calculate median; no valid elements "
+          << "in the dimension" << std::endl;
+
+    // Calculate the median (the mean of the two middle elements, if there is
+    // an even number of elements) with a partial sort.
+    const size_t middle = elemsToKeep.size() / 2;
+    std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + middle,
+        elemsToKeep.end());
+    double median = elemsToKeep[middle];
+    if (elemsToKeep.size() % 2 == 0)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-           elemsToKeep.push_back(input(i, dimension));
-        }
-      }
+      median = (median + *std::max_element(elemsToKeep.begin(),
+          elemsToKeep.begin() + middle)) / 2.0;
     }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
-
-    for (const PairType& target : targets)
+    if (elemsToKeep.size() < n)
     {
-       input(target.first, target.second) = median;
+      for (size_t i = 0; i < n; ++i)
+      {
+        T& value = elements[i * stride];
+        if (value == mappedValue || std::isnan(value))
+          value = median;
+      }
     }
   }
 }; // class MedianImputation
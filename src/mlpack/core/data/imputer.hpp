@@ -21,6 +21,40 @@
 namespace mlpack {
 namespace data {
 
+template<typename T> class MeanImputation;
+template<typename T> class MedianImputation;
+template<typename T> class CustomImputation;
+
+/**
+ * Whether an imputation strategy only modifies the elements of the dimension
+ * it imputes, so that several dimensions of a matrix can be imputed at once
+ * from different threads.  This is not the case for ListwiseDeletion, which
+ * removes points.
+ */
+template<typename StrategyType>
+struct ImputesInPlace
+{
+  static const bool value = false;
+};
+
+template<typename T>
+struct ImputesInPlace<MeanImputation<T>>
+{
+  static const bool value = true;
+};
+
+template<typename T>
+struct ImputesInPlace<MedianImputation<T>>
+{
+  static const bool value = true;
+};
+
+template<typename T>
+struct ImputesInPlace<CustomImputation<T>>
+{
+  static const bool value = true;
+};
+
 /**
  * Given a dataset of a particular datatype, replace user-specified missing
  * value with a variable dependent on the StrategyType and MapperType.
@@ -65,6 +99,42 @@ class Imputer
     strategy.Impute(input, mappedValue, dimension, columnMajor);
   }
 
+  /**
+  * Given an input dataset, replace missing values of the given dimensions with
+  * the imputation strategy.  If the strategy only modifies the dimension it
+  * imputes (see ImputesInPlace), the dimensions are imputed in parallel, each
+  * in a single pass to compute its statistic and one to fill it in.
+  *
+  * @param input Input dataset to apply imputation.
+  * @param missingValue User defined missing value; it can be anything.
+  * @param dimensions Dimensions to apply the imputation.
+  */
+  void Impute(arma::Mat<T>& input,
+              const std::string& missingValue,
+              const std::vector<size_t>& dimensions)
+  {
+    // Exceptions can't leave an OpenMP region, so keep them until the end.
+    std::vector<std::exception_ptr> exceptions(dimensions.size());
+
+    #pragma omp parallel for schedule(dynamic) \
+        if (ImputesInPlace<StrategyType>::value)
+    for (omp_size_t i = 0; i < (omp_size_t) dimensions.size(); ++i)
+    {
+      try
+      {
+        Impute(input, missingValue, dimensions[i]);
+      }
+      catch (...)
+      {
+        exceptions[i] = std::current_exception();
+      }
+    }
+
+    for (size_t i = 0; i < exceptions.size(); ++i)
+      if (exceptions[i])
+        std::rethrow_exception(exceptions[i]);
+  }
+
   //! Get the strategy
   const StrategyType& Strategy() const { return strategy; }
 
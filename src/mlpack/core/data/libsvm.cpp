@@ -0,0 +1,281 @@
+/**
+ * @file libsvm.cpp
+ *
+ * Parallel parsing of libsvm/svmlight data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "libsvm.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+namespace {
+
+//! The points parsed from a block of lines.
+struct LibSVMBlock
+{
+  LibSVMBlock() : maxIndex(0), lines(0), errorLine(0) { }
+
+  //! Row index of each nonzero value.
+  std::vector<arma::uword> rowIndices;
+  //! The nonzero values.
+  std::vector<double> values;
+  //! Number of nonzero values of each point.
+  std::vector<arma::uword> counts;
+  //! Label of each point.
+  std::vector<double> labels;
+  //! Largest feature index of the block.
+  size_t maxIndex;
+  //! Number of lines of the block that were read.
+  size_t lines;
+  //! Description of the first error in the block, if any.
+  std::string error;
+  //! Line of the block that holds the error.
+  size_t errorLine;
+};
+
+inline bool IsSpace(const char c)
+{
+  return (c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f');
+}
+
+//! Parse the number in [begin, end), returning false if it isn't one.
+bool ParseDouble(const char* begin, const char* end, double& value)
+{
+  // The data is not null-terminated, so strtod() can't be used on it directly.
+  char buffer[64];
+  const size_t length = end - begin;
+  if (length == 0 || length >= sizeof(buffer))
+    return false;
+
+  std::memcpy(buffer, begin, length);
+  buffer[length] = '\0';
+  char* parsed;
+  value = std::strtod(buffer, &parsed);
+  return (parsed == buffer + length);
+}
+
+//! Parse the positive feature index in [begin, end), returning false if it
+//! isn't one.
+bool ParseIndex(const char* begin, const char* end, size_t& index)
+{
+  // Indices beyond this can't be row indices of a matrix anyway.
+  const size_t maxIndex = std::numeric_limits<arma::uword>::max() / 10;
+
+  index = 0;
+  for (const char* p = begin; p != end; ++p)
+  {
+    if (*p < '0' || *p > '9' || index > maxIndex)
+      return false;
+    index = 10 * index + (*p - '0');
+  }
+
+  return (begin != end && index != 0);
+}
+
+//! Parse the line [begin, end) into the block, returning a description of the
+//! error if it is malformed.
+std::string ParseLine(const char* begin,
+                      const char* end,
+                      LibSVMBlock& block,
+                      std::vector<std::pair<arma::uword, double>>& entries)
+{
+  // Ignore comments.
+  end = std::find(begin, end, '#');
+
+  const char* p = begin;
+  while (p != end && IsSpace(*p))
+    ++p;
+  if (p == end)
+    return std::string(); // Nothing but whitespace.
+
+  const char* tokenEnd = p;
+  while (tokenEnd != end && !IsSpace(*tokenEnd))
+    ++tokenEnd;
+
+  double label;
+  if (!ParseDouble(p, tokenEnd, label))
+    return "invalid label '" + std::string(p, tokenEnd) + "'";
+
+  entries.clear();
+  p = tokenEnd;
+  while (true)
+  {
+    while (p != end && IsSpace(*p))
+      ++p;
+    if (p == end)
+      break;
+
+    tokenEnd = p;
+    while (tokenEnd != end && !IsSpace(*tokenEnd))
+      ++tokenEnd;
+
+    const char* colon = std::find(p, tokenEnd, ':');
+    if (colon == tokenEnd)
+      return "invalid feature '" + std::string(p, tokenEnd) + "'";
+
+    // svmlight query ids don't matter to us.
+    if (colon - p == 3 && std::strncmp(p, "qid", 3) == 0)
+    {
+      p = tokenEnd;
+      continue;
+    }
+
+    size_t index;
+    double value;
+    if (!ParseIndex(p, colon, index))
+      return "invalid feature index '" + std::string(p, colon) + "'";
+    if (!ParseDouble(colon + 1, tokenEnd, value))
+      return "invalid feature value '" + std::string(colon + 1, tokenEnd) + "'";
+
+    if (value != 0.0)
+      entries.emplace_back(index - 1, value);
+    block.maxIndex = std::max(block.maxIndex, index);
+    p = tokenEnd;
+  }
+
+  // The format asks for increasing indices, but not every writer obeys.
+  if (!std::is_sorted(entries.begin(), entries.end()))
+    std::sort(entries.begin(), entries.end());
+  for (size_t i = 1; i < entries.size(); ++i)
+  {
+    if (entries[i].first == entries[i - 1].first)
+    {
+      std::ostringstream oss;
+      oss << "feature index " << (entries[i].first + 1) << " given twice";
+      return oss.str();
+    }
+  }
+
+  block.labels.push_back(label);
+  block.counts.push_back(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    block.rowIndices.push_back(entries[i].first);
+    block.values.push_back(entries[i].second);
+  }
+
+  return std::string();
+}
+
+//! Parse the lines in [begin, end) into the block, stopping at the first error.
+void ParseBlock(const char* begin, const char* end, LibSVMBlock& block)
+{
+  std::vector<std::pair<arma::uword, double>> entries;
+  const char* p = begin;
+  while (p != end)
+  {
+    const char* lineEnd = std::find(p, end, '\n');
+    ++block.lines;
+
+    block.error = ParseLine(p, lineEnd, block, entries);
+    if (!block.error.empty())
+    {
+      block.errorLine = block.lines;
+      return;
+    }
+
+    p = (lineEnd == end) ? end : lineEnd + 1;
+  }
+}
+
+} // anonymous namespace
+
+size_t ParseLibSVM(const char* data,
+                   const size_t size,
+                   const std::string& filename,
+                   arma::uvec& rowIndices,
+                   arma::uvec& colPointers,
+                   arma::vec& values,
+                   arma::vec& labels)
+{
+  const char* end = data + size;
+
+  // Split the data into blocks of whole lines; small files aren't worth the
+  // threads.
+  const size_t minBlockSize = 1 << 20;
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    numBlocks = std::max(std::min(size / minBlockSize,
+        (size_t) (4 * omp_get_max_threads())), (size_t) 1);
+  #endif
+
+  std::vector<const char*> starts(numBlocks + 1);
+  starts[0] = data;
+  starts[numBlocks] = end;
+  for (size_t b = 1; b < numBlocks; ++b)
+  {
+    const char* start = std::max(data + b * (size / numBlocks), starts[b - 1]);
+    start = std::find(start, end, '\n');
+    starts[b] = (start == end) ? end : start + 1;
+  }
+
+  std::vector<LibSVMBlock> blocks(numBlocks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    ParseBlock(starts[b], starts[b + 1], blocks[b]);
+
+  // Report the first error, and find where the points of each block go.
+  std::vector<size_t> pointOffsets(numBlocks), valueOffsets(numBlocks);
+  size_t numPoints = 0, numValues = 0, maxIndex = 0, lines = 0;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    if (!blocks[b].error.empty())
+    {
+      std::ostringstream oss;
+      oss << "ParseLibSVM(): '" << filename << "', line "
+          << (lines + blocks[b].errorLine) << ": " << blocks[b].error << ".";
+      throw std::runtime_error(oss.str());
+    }
+
+    pointOffsets[b] = numPoints;
+    valueOffsets[b] = numValues;
+    numPoints += blocks[b].labels.size();
+    numValues += blocks[b].values.size();
+    maxIndex = std::max(maxIndex, blocks[b].maxIndex);
+    lines += blocks[b].lines;
+  }
+
+  // Assemble the compressed representation.
+  rowIndices.set_size(numValues);
+  values.set_size(numValues);
+  labels.set_size(numPoints);
+  colPointers.set_size(numPoints + 1);
+  colPointers[numPoints] = numValues;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const LibSVMBlock& block = blocks[b];
+    std::copy(block.rowIndices.begin(), block.rowIndices.end(),
+        rowIndices.begin() + valueOffsets[b]);
+    std::copy(block.values.begin(), block.values.end(),
+        values.begin() + valueOffsets[b]);
+    std::copy(block.labels.begin(), block.labels.end(),
+        labels.begin() + pointOffsets[b]);
+
+    size_t offset = valueOffsets[b];
+    for (size_t i = 0; i < block.counts.size(); ++i)
+    {
+      colPointers[pointOffsets[b] + i] = offset;
+      offset += block.counts[i];
+    }
+  }
+
+  return maxIndex;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,95 @@
+/**
+ * @file libsvm.hpp
+ *
+ * Loading and saving of sparse labeled data in the libsvm (or svmlight) text
+ * format, where each line holds the label of a point followed by its nonzero
+ * features, as in
+ *
+ *   1 3:0.5 10:1.2 42:-0.75
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LIBSVM_HPP
+#define MLPACK_CORE_DATA_LIBSVM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <string>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Parse the given libsvm data (of the given size, in bytes) into the
+ * compressed sparse column representation of its points and their labels.
+ * Feature indices start at 1 in the file and at 0 in the matrix, so feature i
+ * is stored in row i - 1; the features of each line need not be sorted.  Blank
+ * lines and everything after a '#' are ignored, as are svmlight 'qid:' tokens.
+ * Explicit zeros are not stored.
+ *
+ * Large files are split into blocks of lines that are parsed in parallel with
+ * OpenMP.  A std::runtime_error giving the offending line is thrown if the data
+ * is malformed.
+ *
+ * @param data Contents of the file.
+ * @param size Size of the contents, in bytes.
+ * @param filename Name of the file (for error messages).
+ * @param rowIndices Row index of each nonzero value, column by column.
+ * @param colPointers Offsets of the values of each column in rowIndices and
+ *     values; it has one element more than there are points.
+ * @param values The nonzero values.
+ * @param labels Label of each point.
+ * @return Largest feature index in the data (that is, its dimensionality).
+ */
+size_t ParseLibSVM(const char* data,
+                   const size_t size,
+                   const std::string& filename,
+                   arma::uvec& rowIndices,
+                   arma::uvec& colPointers,
+                   arma::vec& values,
+                   arma::vec& labels);
+
+/**
+ * Load a libsvm/svmlight file into a sparse matrix, with one point per column,
+ * and the labels of its points.  The file is mapped into memory and parsed in
+ * parallel, and the matrix is built directly in its compressed representation,
+ * so there is never a dense copy of the data.  A std::runtime_error is thrown
+ * on failure, including when a label can't be represented by LabelType (for
+ * instance, a label of -1 with unsigned labels).
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the points into.
+ * @param labels Row to load the labels into.
+ * @param dimensionality Number of rows of the matrix; if 0, it is the largest
+ *     feature index in the file.  Set this when loading test data that may not
+ *     use the last features of the training data.
+ */
+template<typename eT, typename LabelType>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const size_t dimensionality = 0);
+
+/**
+ * Save a sparse matrix, with one point per column, and the labels of its
+ * points to a libsvm/svmlight file.  A std::runtime_error is thrown on failure.
+ *
+ * @param filename Name of the file to write.
+ * @param matrix Points to save.
+ * @param labels Labels of the points.
+ */
+template<typename eT, typename LabelType>
+void SaveLibSVM(const std::string& filename,
+                const arma::SpMat<eT>& matrix,
+                const arma::Row<LabelType>& labels);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "libsvm_impl.hpp"
+
+#endif
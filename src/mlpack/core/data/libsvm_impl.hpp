@@ -0,0 +1,128 @@
+/**
+ * @file libsvm_impl.hpp
+ *
+ * Implementation of loading and saving libsvm/svmlight files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LIBSVM_IMPL_HPP
+#define MLPACK_CORE_DATA_LIBSVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "libsvm.hpp"
+#include "mapped_matrix.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT, typename LabelType>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::Row<LabelType>& labels,
+                const size_t dimensionality)
+{
+  arma::uvec rowIndices, colPointers;
+  arma::vec values, labelValues;
+  size_t maxIndex;
+
+  size_t size;
+  const char* mapping = MapFile(filename, size);
+  try
+  {
+    maxIndex = ParseLibSVM(mapping, size, filename, rowIndices, colPointers,
+        values, labelValues);
+  }
+  catch (std::exception&)
+  {
+    UnmapFile(mapping, size);
+    throw;
+  }
+  UnmapFile(mapping, size);
+
+  if (dimensionality != 0 && maxIndex > dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "LoadLibSVM(): '" << filename << "' has features up to index "
+        << maxIndex << ", but the requested dimensionality is "
+        << dimensionality << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Make sure the labels can be represented.
+  if (std::is_integral<LabelType>::value)
+  {
+    for (size_t i = 0; i < labelValues.n_elem; ++i)
+    {
+      const double label = labelValues[i];
+      if (label != std::floor(label) ||
+          label < (double) std::numeric_limits<LabelType>::min() ||
+          label > (double) std::numeric_limits<LabelType>::max())
+      {
+        std::ostringstream oss;
+        oss << "LoadLibSVM(): label " << label << " of point " << i << " in '"
+            << filename << "' can't be represented by the label type.";
+        throw std::runtime_error(oss.str());
+      }
+    }
+  }
+
+  labels = arma::conv_to<arma::Row<LabelType>>::from(labelValues.t());
+  matrix = arma::SpMat<eT>(rowIndices, colPointers,
+      arma::conv_to<arma::Col<eT>>::from(values),
+      (dimensionality == 0) ? maxIndex : dimensionality, labelValues.n_elem);
+}
+
+template<typename eT, typename LabelType>
+void SaveLibSVM(const std::string& filename,
+                const arma::SpMat<eT>& matrix,
+                const arma::Row<LabelType>& labels)
+{
+  if (labels.n_elem != matrix.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SaveLibSVM(): there are " << labels.n_elem << " labels, but "
+        << matrix.n_cols << " points.";
+    throw std::invalid_argument(oss.str());
+  }
+
+  std::ofstream stream(filename.c_str());
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "' for writing.";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Write enough digits for the values to be read back exactly.
+  stream.precision(std::numeric_limits<double>::max_digits10);
+
+  // Walk the compressed representation directly.
+  matrix.sync();
+  for (size_t j = 0; j < matrix.n_cols; ++j)
+  {
+    stream << labels[j];
+    for (size_t k = matrix.col_ptrs[j]; k < matrix.col_ptrs[j + 1]; ++k)
+      stream << ' ' << (matrix.row_indices[k] + 1) << ':' << matrix.values[k];
+    stream << '\n';
+  }
+
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "Error writing to '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -40,6 +40,8 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack mapped matrix (see MappedMatrix), denoted by .mmat; this format
+ *    stores matrices column-major, so it is never transposed
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -120,6 +122,8 @@ extern template bool Load<double>(const std::string&,
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack mapped matrix (see MappedMatrix), denoted by .mmat; this format
+ *    stores matrices column-major, so it is never transposed
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -152,6 +156,8 @@ bool Load(const std::string& filename,
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
+ *  - mlpack mapped matrix (see MappedMatrix), denoted by .mmat; this format
+ *    stores matrices column-major, so it is never transposed
  *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
@@ -255,6 +261,30 @@ extern template bool Load<double, IncrementPolicy>(
  * @endcond
  */
 
+/**
+ * Load a sparse matrix and the labels of its points from a libsvm (or
+ * svmlight) file, denoted by .svm, .libsvm or .svmlight.  Each line of the file
+ * holds the label of a point followed by its nonzero features, as in
+ * "1 3:0.5 10:1.2"; each point is loaded into a column of the matrix, and the
+ * largest feature index gives the number of rows.  The file is parsed in
+ * parallel and the matrix is built directly in its compressed form (see
+ * LoadLibSVM()), so no dense copy of the data is ever made.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row to load the labels of the points into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT, typename LabelType>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          arma::Row<LabelType>& labels,
+          const bool fatal = false);
+
 /**
  * Load a model from a file, guessing the filetype from the extension, or,
  * optionally, loading the specified format.  If automatic extension detection
@@ -266,9 +296,14 @@ extern template bool Load<double, IncrementPolicy>(
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - mlpack blob (see BlobOArchive), denoted by .blob; this binary format
+ *    writes matrices as raw blocks and trees as flat arrays of nodes, and is
+ *    read from a mapping of the file, so it is the fastest for large models
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary',
+ * 'format::blob' and 'format::compact_blob' (which reads the same files as
+ * 'format::blob').
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -294,5 +329,7 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of Load() for sparse matrices.
+#include "load_sparse_impl.hpp"
 
 #endif
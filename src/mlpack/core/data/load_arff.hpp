@@ -39,6 +39,12 @@ void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix);
  * constructor or otherwise, so that info.Dimensionality() is 0), it will be set
  * to the right dimensionality.
  *
+ * Numeric (numeric, integer, real), string and nominal ({value, ...})
+ * attributes are supported; the values of a nominal attribute are mapped in the
+ * order of the header, and the values of a string attribute in the order of the
+ * file.  The file is memory-mapped, and the lines of the @data section are
+ * parsed in parallel with OpenMP.
+ *
  * This ability to pass in pre-existing DatasetInfo objects is very necessary
  * when, e.g., loading a test set after training.  If the same DatasetInfo from
  * loading the training set is not used, then the test set may be loaded with
@@ -16,33 +16,194 @@
 #include "load_arff.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
 #include "is_naninf.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data {
+namespace details {
 
+//! How the values of each attribute of an ARFF file are parsed.
+enum ARFFAttributeType
+{
+  //! numeric, integer or real: converted to a number.
+  ARFF_NUMERIC,
+  //! {value, ...}: looked up in the table built from the header.
+  ARFF_NOMINAL,
+  //! string: mapped with the DatasetMapper, in the order of the file.
+  ARFF_STRING
+};
+
+/**
+ * Split the given line of the @data section of an ARFF file (or the list of
+ * values of a nominal attribute) on commas, and call tokenFunction(index,
+ * token) on each token, with whitespace removed from either side.  Tokens may
+ * be quoted with single or double quotes, and inside quotes a backslash
+ * escapes the next character; a '%' outside quotes starts a comment, which
+ * ends the line.  The token is built in the given string, so that nothing is
+ * allocated for most tokens.  The number of tokens is returned.
+ */
+template<typename TokenFunction>
+size_t TokenizeARFFLine(const char* begin,
+                        const char* end,
+                        std::string& token,
+                        TokenFunction tokenFunction)
+{
+  size_t count = 0;
+  const char* p = begin;
+  while (true)
+  {
+    token.clear();
+    while (p < end && std::isspace((unsigned char) *p))
+      ++p;
+
+    if (p < end && (*p == '"' || *p == '\''))
+    {
+      const char quote = *(p++);
+      while (p < end && *p != quote)
+      {
+        if (*p == '\\' && p + 1 < end)
+          ++p;
+        token.push_back(*(p++));
+      }
+
+      // Skip the closing quote, and anything up to the next delimiter.
+      while (p < end && *p != ',' && *p != '%')
+        ++p;
+    }
+    else
+    {
+      const char* tokenBegin = p;
+      while (p < end && *p != ',' && *p != '%')
+        ++p;
+
+      const char* tokenEnd = p;
+      while (tokenEnd > tokenBegin &&
+             std::isspace((unsigned char) *(tokenEnd - 1)))
+        --tokenEnd;
+      token.assign(tokenBegin, tokenEnd);
+    }
+
+    tokenFunction(count++, token);
+
+    if (p == end || *p == '%')
+      break;
+    ++p; // Skip the comma.
+  }
+
+  return count;
+}
+
+//! Convert with strtod(), if the type allows it.
+inline bool ConvertARFFNumber(const char* str, char** end, double& value)
+{
+  value = std::strtod(str, end);
+  return true;
+}
+
+//! Convert with strtof(), if the type allows it.
+inline bool ConvertARFFNumber(const char* str, char** end, float& value)
+{
+  value = std::strtof(str, end);
+  return true;
+}
+
+//! Other types are always converted with a stringstream.
+template<typename eT>
+inline bool ConvertARFFNumber(const char* /* str */,
+                              char** /* end */,
+                              eT& /* value */)
+{
+  return false;
+}
+
+/**
+ * Convert the given token to a number, returning false if it is not one.
+ * Tokens that strtod() converts entirely are converted with it; the others go
+ * through a stringstream (and IsNaNInf()), which accepts the same tokens the
+ * stringstream extraction always did.
+ */
+template<typename eT>
+bool ParseARFFNumber(const std::string& token, eT& value)
+{
+  if (!token.empty())
+  {
+    errno = 0;
+    char* parseEnd;
+    eT result;
+    if (ConvertARFFNumber(token.c_str(), &parseEnd, result) && errno == 0 &&
+        parseEnd == token.c_str() + token.size())
+    {
+      value = result;
+      return true;
+    }
+  }
+
+  std::stringstream stream(token);
+  value = eT(0);
+  stream >> value;
+  return !stream.fail() || IsNaNInf(value, token);
+}
+
+/**
+ * Build the error message for a token of the @data section that can't be
+ * parsed.
+ */
+inline std::string ARFFParseError(const std::string& token,
+                                  const size_t line,
+                                  const size_t col)
+{
+  std::ostringstream error;
+  if (token == "?")
+    error << "Missing values ('?') not supported, ";
+  else
+    error << "Parse error ";
+  error << "at line " << line << " token " << col << ": \"" << token << "\".";
+  return error.str();
+}
+
+/**
+ * Load an ARFF dataset from the given contents of an ARFF file; see
+ * LoadARFF().  The header is read line by line, and gives the parser of each
+ * attribute: nominal attributes have their values mapped in the order of the
+ * header, into a lookup table.  The lines of the @data section are then
+ * parsed in parallel, a chunk of lines at a time; only the tokens of string
+ * attributes are kept, to be mapped afterwards by the DatasetMapper in the
+ * order of the file, so that the mappings are those a serial parse gives.
+ */
 template<typename eT, typename PolicyType>
-void LoadARFF(const std::string& filename,
-              arma::Mat<eT>& matrix,
-              DatasetMapper<PolicyType>& info)
+void ParseARFF(const char* data,
+               const size_t size,
+               arma::Mat<eT>& matrix,
+               DatasetMapper<PolicyType>& info)
 {
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename, std::ios::in | std::ios::binary);
+  const char* end = data + size;
+  const char* p = data;
 
   std::string line;
   size_t dimensionality = 0;
-  std::vector<bool> types;
+  std::vector<ARFFAttributeType> types;
+  std::vector<std::vector<std::string>> nominalValues;
   size_t headerLines = 0;
-  while (!ifs.eof())
+  bool foundData = false;
+  while (p < end)
   {
     // Read the next line, then strip whitespace from either side.
-    std::getline(ifs, line, '\n');
+    const char* lineEnd = (const char*) std::memchr(p, '\n', end - p);
+    if (lineEnd == NULL)
+      lineEnd = end;
+    line.assign(p, lineEnd);
+    p = (lineEnd == end) ? end : lineEnd + 1;
     boost::trim(line);
     ++headerLines;
 
-    // Is the first character a comment, or is the line empty?
-    if (line[0] == '%' || line.empty())
+    // Is the line empty, or is the first character a comment?
+    if (line.empty() || line[0] == '%')
       continue; // Ignore this line.
 
     // If the first character is @, we are looking at @relation, @attribute, or
@@ -51,7 +212,7 @@ void LoadARFF(const std::string& filename,
     {
       typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
       std::string separators = " \t%"; // Split on comments too.
-      boost::escaped_list_separator<char> sep("\\", separators, "{\"");
+      boost::escaped_list_separator<char> sep("\\", separators, "\"");
       Tokenizer tok(line, sep);
       Tokenizer::iterator it = tok.begin();
 
@@ -68,28 +229,54 @@ void LoadARFF(const std::string& filename,
       else if (annotation == "@attribute")
       {
         ++dimensionality;
+        nominalValues.push_back(std::vector<std::string>());
+
+        // A nominal attribute lists its values between braces.
+        const size_t open = line.find('{');
+        const size_t close = line.rfind('}');
+        if (open != std::string::npos && close != std::string::npos &&
+            open < close)
+        {
+          std::string token;
+          std::vector<std::string>& values = nominalValues.back();
+          TokenizeARFFLine(line.data() + open + 1, line.data() + close, token,
+              [&](const size_t, const std::string& value)
+              {
+                values.push_back(value);
+              });
+          types.push_back(ARFF_NOMINAL);
+          continue;
+        }
+
         // We need to mark this dimension with its according type.
         ++it; // Ignore the dimension name.
-        std::string dimType = *(++it);
+        if (it == tok.end() || ++it == tok.end())
+        {
+          throw std::runtime_error("no type given for ARFF attribute on line "
+              + std::to_string(headerLines));
+        }
+        std::string dimType = *it;
         std::transform(dimType.begin(), dimType.end(), dimType.begin(),
             ::tolower);
 
         if (dimType == "numeric" || dimType == "integer" || dimType == "real")
         {
-          types.push_back(false); // The feature is numeric.
+          types.push_back(ARFF_NUMERIC); // The feature is numeric.
         }
         else if (dimType == "string")
         {
-          types.push_back(true); // The feature is categorical.
+          types.push_back(ARFF_STRING); // The feature is categorical.
         }
-        else if (dimType[0] == '{')
+        else
         {
-          throw std::logic_error("list of ARFF values not yet supported");
+          throw std::runtime_error("unsupported ARFF attribute type '" +
+              dimType + "'");
         }
       }
       else if (annotation == "@data")
       {
         // We are in the data section.  So we can move out of this loop.
+        foundData = true;
         break;
       }
       else
@@ -100,7 +287,7 @@ void LoadARFF(const std::string& filename,
     }
   }
 
-  if (ifs.eof())
+  if (!foundData)
     throw std::runtime_error("no @data section found");
 
   // Reset the DatasetInfo object, if needed.
@@ -117,114 +304,199 @@ void LoadARFF(const std::string& filename,
     throw std::invalid_argument(oss.str());
   }
 
+  // Precompute the parser of each attribute.  The values of nominal
+  // attributes are mapped in the order of the header, so their mappings don't
+  // depend on the data, and the lookup tables can be used by all the threads.
+  std::vector<size_t> stringDims;
+  std::vector<size_t> stringIndex(dimensionality, 0);
+  std::vector<std::unordered_map<std::string, eT>> lookup(dimensionality);
   for (size_t i = 0; i < types.size(); ++i)
   {
-    if (types[i])
-      info.Type(i) = Datatype::categorical;
-    else
+    if (types[i] == ARFF_NUMERIC)
+    {
       info.Type(i) = Datatype::numeric;
-  }
+      continue;
+    }
 
-  // We need to find out how many lines of data are in the file.
-  std::streampos pos = ifs.tellg();
-  size_t row = 0;
-  while (!ifs.eof())
-  {
-    std::getline(ifs, line, '\n');
-    ++row;
+    info.Type(i) = Datatype::categorical;
+    if (types[i] == ARFF_NOMINAL)
+    {
+      for (size_t j = 0; j < nominalValues[i].size(); ++j)
+      {
+        lookup[i][nominalValues[i][j]] =
+            info.template MapString<eT>(nominalValues[i][j], i);
+      }
+    }
+    else
+    {
+      stringIndex[i] = stringDims.size();
+      stringDims.push_back(i);
+    }
   }
-  // Uncount the EOF row.
-  --row;
 
-  // Since we've hit the EOF, we have to call clear() so we can seek again.
-  ifs.clear();
-  ifs.seekg(pos);
+  // Find the lines of the @data section, skipping empty lines and comments;
+  // dataLines holds the line number of each of them, for error messages.
+  std::vector<std::pair<const char*, const char*>> lines;
+  std::vector<size_t> dataLines;
+  size_t lineNumber = headerLines;
+  while (p < end)
+  {
+    const char* lineEnd = (const char*) std::memchr(p, '\n', end - p);
+    if (lineEnd == NULL)
+      lineEnd = end;
+    ++lineNumber;
 
-  // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+    const char* lineBegin = p;
+    p = (lineEnd == end) ? end : lineEnd + 1;
+    while (lineBegin < lineEnd && std::isspace((unsigned char) *lineBegin))
+      ++lineBegin;
+    while (lineEnd > lineBegin && std::isspace((unsigned char) *(lineEnd - 1)))
+      --lineEnd;
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (!ifs.eof())
-  {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
+    if (lineBegin == lineEnd || *lineBegin == '%')
+      continue;
 
     // If the first character is {, it is sparse data, and we can just say this
     // is not handled for now...
-    if (line[0] == '{')
+    if (*lineBegin == '{')
       throw std::runtime_error("cannot yet parse sparse ARFF data");
 
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
+    lines.push_back(std::make_pair(lineBegin, lineEnd));
+    dataLines.push_back(lineNumber);
+  }
+
+  // Now, set the size of the matrix.
+  matrix.set_size(dimensionality, lines.size());
+
+  // Each line of the @data section must be a CSV (except sparse data, which we
+  // will handle later).  The '?' representing a missing value is not allowed,
+  // so if that occurs we throw an exception.  We also throw an exception if
+  // any piece of data does not match its type.  The first error in the file is
+  // the one reported, no matter how the lines are split between threads.
+  const size_t chunkSize = 1 << 16;
+  std::vector<std::string> stringTokens;
+  for (size_t first = 0; first < lines.size(); first += chunkSize)
+  {
+    const size_t count = std::min(chunkSize, lines.size() - first);
+    stringTokens.resize(count * stringDims.size());
+
+    size_t errorLine = lines.size();
+    std::string errorMessage;
 
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+    #pragma omp parallel
     {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
-      {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
-      }
+      std::string token;
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
-      {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        // We load transposed.
-        matrix(col, row) = info.template MapString<eT>(token, col);
-      }
-      else if (info.Type(col) == Datatype::numeric)
+      #pragma omp for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
       {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
+        const size_t row = first + i;
+        std::string error;
+        const size_t tokens = TokenizeARFFLine(lines[row].first,
+            lines[row].second, token,
+            [&](const size_t col, const std::string& value)
+            {
+              if (!error.empty() || col >= dimensionality)
+                return;
 
-        eT val = eT(0);
-        token >> val;
+              // We load transposed.
+              if (types[col] == ARFF_NUMERIC)
+              {
+                eT val;
+                if (ParseARFFNumber(value, val))
+                  matrix(col, row) = val;
+                else
+                  error = ARFFParseError(value, dataLines[row], col);
+              }
+              else if (types[col] == ARFF_NOMINAL)
+              {
+                typename std::unordered_map<std::string, eT>::const_iterator
+                    v = lookup[col].find(value);
+                if (v != lookup[col].end())
+                {
+                  matrix(col, row) = v->second;
+                }
+                else if (value == "?")
+                {
+                  error = ARFFParseError(value, dataLines[row], col);
+                }
+                else
+                {
+                  std::ostringstream oss;
+                  oss << "Value \"" << value << "\" at line "
+                      << dataLines[row] << " token " << col << " is not one "
+                      << "of the values of its nominal attribute.";
+                  error = oss.str();
+                }
+              }
+              else
+              {
+                stringTokens[i * stringDims.size() + stringIndex[col]] =
+                    value;
+              }
+            });
+
+        if (error.empty() && tokens != dimensionality)
+        {
+          std::ostringstream oss;
+          oss << "Too " << ((tokens > dimensionality) ? "many" : "few")
+              << " columns in line " << dataLines[row] << ".";
+          error = oss.str();
+        }
 
-        if (token.fail())
+        if (!error.empty())
         {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
+          #pragma omp critical(loadARFFError)
           {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
+            if (row < errorLine)
+            {
+              errorLine = row;
+              errorMessage = error;
+            }
           }
         }
-
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
       }
+    }
+
+    if (errorLine != lines.size())
+      throw std::runtime_error(errorMessage);
 
-      ++col;
+    // Map the tokens of the string attributes in the order of the file.
+    for (size_t i = 0; i < count; ++i)
+    {
+      for (size_t s = 0; s < stringDims.size(); ++s)
+      {
+        matrix(stringDims[s], first + i) = info.template MapString<eT>(
+            stringTokens[i * stringDims.size() + s], stringDims[s]);
+      }
     }
-    ++row;
   }
 }
 
+} // namespace details
+
+template<typename eT, typename PolicyType>
+void LoadARFF(const std::string& filename,
+              arma::Mat<eT>& matrix,
+              DatasetMapper<PolicyType>& info)
+{
+  // The whole file is mapped, so that the lines of the @data section can be
+  // parsed in place by several threads.
+  size_t size = 0;
+  const char* data = MapFile(filename, size);
+  try
+  {
+    details::ParseARFF(data, size, matrix, info);
+  }
+  catch (...)
+  {
+    UnmapFile(data, size);
+    throw;
+  }
+
+  UnmapFile(data, size);
+}
+
 } // namespace data
 } // namespace mlpack
 
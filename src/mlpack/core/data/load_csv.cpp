@@ -17,6 +17,8 @@ namespace mlpack {
 namespace data {
 
 LoadCSV::LoadCSV(const std::string& file) :
+  tokenStopChars(NULL),
+  delimiter(','),
   extension(Extension(file)),
   filename(file),
   inFile(file)
@@ -29,11 +31,13 @@ LoadCSV::LoadCSV(const std::string& file) :
   {
     // Match all characters that are not ',', '\r', or '\n'.
     stringRule = qi::raw[*~qi::char_(" ,\r\n")];
+    tokenStopChars = " ,\r\n";
   }
   else
   {
     // Match all characters that are not '\t', '\r', or '\n'.
     stringRule = qi::raw[*~qi::char_(" \t\r\n")];
+    tokenStopChars = " \t\r\n";
   }
 
   if (extension == "csv")
@@ -48,12 +52,14 @@ LoadCSV::LoadCSV(const std::string& file) :
     // This one is a little more difficult, we need to catch any number of
     // spaces more than one.
     delimiterRule = qi::raw[+qi::char_(" ")];
+    delimiter = ' ';
   }
   else // TSV.
   {
     // Catch a tab character, possibly with whitespace on either side.
     delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
         *qi::char_(" "))];
+    delimiter = '\t';
   }
 }
 
@@ -69,5 +75,53 @@ void LoadCSV::CheckOpen()
   inFile.unsetf(std::ios::skipws);
 }
 
+bool LoadCSV::IsDecimal(const std::string& token)
+{
+  // The accepted form is [+-]?[0-9]*(.[0-9]*)?([eE][+-]?[0-9]+)?, with at
+  // least one digit in the mantissa.
+  size_t i = 0;
+  if (i < token.size() && (token[i] == '+' || token[i] == '-'))
+    ++i;
+
+  size_t digits = 0;
+  while (i < token.size() && std::isdigit((unsigned char) token[i]))
+  {
+    ++i;
+    ++digits;
+  }
+
+  if (i < token.size() && token[i] == '.')
+  {
+    ++i;
+    while (i < token.size() && std::isdigit((unsigned char) token[i]))
+    {
+      ++i;
+      ++digits;
+    }
+  }
+
+  if (digits == 0)
+    return false;
+
+  if (i < token.size() && (token[i] == 'e' || token[i] == 'E'))
+  {
+    ++i;
+    if (i < token.size() && (token[i] == '+' || token[i] == '-'))
+      ++i;
+
+    size_t exponentDigits = 0;
+    while (i < token.size() && std::isdigit((unsigned char) token[i]))
+    {
+      ++i;
+      ++exponentDigits;
+    }
+
+    if (exponentDigits == 0)
+      return false;
+  }
+
+  return (i == token.size());
+}
+
 } // namespace data
 } // namespace mlpack
@@ -18,8 +18,14 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
 
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
 #include <set>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "extension.hpp"
 #include "format.hpp"
@@ -357,11 +363,411 @@ class LoadCSV
     }
   }
 
+  /**
+   * Parse a transposed matrix into a DatasetInfo (that is, with the
+   * IncrementPolicy), using all available threads.  This is the common case,
+   * so instead of going through boost::spirit one line at a time, the file is
+   * read in large chunks of whole lines, and the lines of each chunk are
+   * tokenized and parsed in parallel directly into their columns of the
+   * matrix.  Only the tokens of categorical dimensions are passed to the
+   * DatasetMapper, in the order they appear in the file, so the mappings are
+   * exactly the ones the serial parser would give; the categorical dimensions
+   * are mapped in parallel with each other, and their tokens are kept as
+   * ranges of the chunk rather than as copies.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to load with.
+   */
+  template<typename T>
+  void TransposeParse(arma::Mat<T>& inout,
+                      DatasetMapper<IncrementPolicy>& infoSet)
+  {
+    // The first pass finds the size of the matrix and the type of each
+    // dimension.  Each thread collects the first non-numeric token it sees in
+    // each dimension; this is enough for MapFirstPass() of IncrementPolicy,
+    // whose result does not depend on the order of the tokens.
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<std::string> badTokens, sampleTokens;
+    std::vector<char> categorical;
+    size_t badLine = std::numeric_limits<size_t>::max();
+    size_t badLineDims = 0;
+
+    ForEachChunk([&](const std::vector<LineType>& lines, const size_t firstLine)
+    {
+      if (lines.empty())
+        return;
+
+      if (firstLine == 0)
+      {
+        // Extract the number of dimensions from the first line.
+        TokenizeLine(lines[0].first, lines[0].second,
+            [&](const size_t, const char* begin, const char* end)
+            {
+              sampleTokens.emplace_back(begin, end);
+            });
+        rows = sampleTokens.size();
+        badTokens.resize(rows);
+        categorical.resize(rows, 0);
+      }
+
+      #pragma omp parallel
+      {
+        std::vector<std::string> threadBadTokens(rows);
+        std::vector<char> threadCategorical(rows, 0);
+
+        #pragma omp for schedule(static)
+        for (omp_size_t i = 0; i < (omp_size_t) lines.size(); ++i)
+        {
+          const size_t dims = TokenizeLine(lines[i].first, lines[i].second,
+              [&](const size_t dim, const char* begin, const char* end)
+              {
+                T value;
+                if (dim < rows && !threadCategorical[dim] &&
+                    !ParseToken(begin, end, value))
+                {
+                  threadCategorical[dim] = 1;
+                  threadBadTokens[dim].assign(begin, end);
+                }
+              });
+
+          if (dims != rows)
+          {
+            #pragma omp critical(loadCSVBadLine)
+            {
+              if (firstLine + i < badLine)
+              {
+                badLine = firstLine + i;
+                badLineDims = dims;
+              }
+            }
+          }
+        }
+
+        #pragma omp critical(loadCSVMergeTypes)
+        {
+          for (size_t d = 0; d < rows; ++d)
+          {
+            if (threadCategorical[d] && !categorical[d])
+            {
+              categorical[d] = 1;
+              badTokens[d] = std::move(threadBadTokens[d]);
+            }
+          }
+        }
+      }
+
+      cols += lines.size();
+    });
+
+    if (badLine != std::numeric_limits<size_t>::max())
+    {
+      std::ostringstream oss;
+      oss << "LoadCSV::TransposeParse(): wrong number of dimensions ("
+          << badLineDims << ") on line " << badLine << "; should be " << rows
+          << " dimensions.";
+      throw std::runtime_error(oss.str());
+    }
+
+    // Now initialize the DatasetMapper, exactly as the serial first pass would.
+    infoSet.SetDimensionality(rows);
+    for (size_t d = 0; d < rows; ++d)
+    {
+      infoSet.template MapFirstPass<T>(categorical[d] ? badTokens[d] :
+          sampleTokens[d], d);
+    }
+
+    // Find which dimensions will go through the DatasetMapper.
+    std::vector<size_t> categoricalDims;
+    std::vector<size_t> categoricalIndex(rows,
+        std::numeric_limits<size_t>::max());
+    for (size_t d = 0; d < rows; ++d)
+    {
+      if (infoSet.Type(d) == Datatype::categorical)
+      {
+        categoricalIndex[d] = categoricalDims.size();
+        categoricalDims.push_back(d);
+      }
+    }
+
+    inout.set_size(rows, cols);
+
+    // The second pass parses the numeric values in parallel, and keeps where
+    // the categorical tokens are to map them afterwards in order.
+    std::vector<LineType> categoricalTokens;
+    ForEachChunk([&](const std::vector<LineType>& lines, const size_t firstLine)
+    {
+      categoricalTokens.resize(lines.size() * categoricalDims.size());
+
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t i = 0; i < (omp_size_t) lines.size(); ++i)
+      {
+        const size_t col = firstLine + i;
+        TokenizeLine(lines[i].first, lines[i].second,
+            [&](const size_t dim, const char* begin, const char* end)
+            {
+              if (categoricalIndex[dim] != std::numeric_limits<size_t>::max())
+              {
+                categoricalTokens[i * categoricalDims.size() +
+                    categoricalIndex[dim]] = LineType(begin, end);
+              }
+              else
+              {
+                // The first pass made sure that this can be parsed.
+                ParseToken(begin, end, inout(dim, col));
+              }
+            });
+      }
+
+      // The first line gives every categorical dimension a mapping, so that
+      // the dimensions can then be mapped in parallel (see
+      // IncrementPolicy::MapString()); each of them is still mapped in the
+      // order of the lines.
+      size_t start = 0;
+      if (firstLine == 0 && !lines.empty())
+      {
+        MapTokens(inout, infoSet, categoricalDims, categoricalTokens, 0, 1, 0);
+        start = 1;
+      }
+
+      #pragma omp parallel for schedule(dynamic) \
+          if (categoricalDims.size() > 1)
+      for (omp_size_t c = 0; c < (omp_size_t) categoricalDims.size(); ++c)
+      {
+        MapTokens(inout, infoSet, categoricalDims, categoricalTokens, start,
+            lines.size(), firstLine, c);
+      }
+    });
+  }
+
+  //! A line of the file, as pointers to its first and one-past-last character.
+  using LineType = std::pair<const char*, const char*>;
+
+  /**
+   * Map the categorical tokens of the given lines of a chunk (from
+   * TransposeParse()), in order, into their columns of the matrix.  If dim is
+   * given, only the tokens of the dim'th categorical dimension are mapped.
+   */
+  template<typename T>
+  static void MapTokens(arma::Mat<T>& inout,
+                        DatasetMapper<IncrementPolicy>& infoSet,
+                        const std::vector<size_t>& categoricalDims,
+                        const std::vector<LineType>& categoricalTokens,
+                        const size_t begin,
+                        const size_t end,
+                        const size_t firstLine,
+                        const size_t dim = std::numeric_limits<size_t>::max())
+  {
+    const size_t dimBegin = (dim == std::numeric_limits<size_t>::max()) ? 0 :
+        dim;
+    const size_t dimEnd = (dim == std::numeric_limits<size_t>::max()) ?
+        categoricalDims.size() : dim + 1;
+
+    // The token is copied to a reused string, so nothing is allocated for the
+    // tokens that are already mapped.
+    std::string token;
+    for (size_t i = begin; i < end; ++i)
+    {
+      for (size_t c = dimBegin; c < dimEnd; ++c)
+      {
+        const LineType& range =
+            categoricalTokens[i * categoricalDims.size() + c];
+        token.assign(range.first, range.second);
+        inout(categoricalDims[c], firstLine + i) =
+            infoSet.template MapString<T>(token, categoricalDims[c]);
+      }
+    }
+  }
+
+  /**
+   * Read the whole file in chunks of whole lines, and call the given function
+   * on the lines of each chunk (with whitespace removed from either side of
+   * each line), along with the index of the first line of the chunk.  Lines
+   * are split the same way std::getline() splits them.
+   */
+  template<typename ChunkFunction>
+  void ForEachChunk(ChunkFunction chunkFunction)
+  {
+    // Reset to the start of the file.
+    inFile.clear();
+    inFile.seekg(0, std::ios::beg);
+
+    const size_t chunkSize = 1 << 24;
+    std::vector<char> buffer;
+    std::vector<LineType> lines;
+    size_t carry = 0; // Characters kept from the last chunk.
+    size_t firstLine = 0;
+    bool done = false;
+    while (!done)
+    {
+      buffer.resize(carry + chunkSize);
+      inFile.read(buffer.data() + carry, chunkSize);
+      const size_t readSize = (size_t) inFile.gcount();
+      const size_t bytes = carry + readSize;
+      done = (readSize < chunkSize);
+
+      // Only whole lines are parsed; the rest is kept for the next chunk.  If
+      // the chunk holds no full line at all, we have to read more.
+      size_t parseEnd = bytes;
+      if (!done)
+      {
+        while (parseEnd > 0 && buffer[parseEnd - 1] != '\n')
+          --parseEnd;
+
+        if (parseEnd == 0)
+        {
+          carry = bytes;
+          continue;
+        }
+      }
+
+      lines.clear();
+      const char* p = buffer.data();
+      const char* end = buffer.data() + parseEnd;
+      while (p < end)
+      {
+        const char* newline = (const char*) std::memchr(p, '\n', end - p);
+        const char* lineEnd = (newline == NULL) ? end : newline;
+
+        // Remove whitespace from either side.
+        const char* lineBegin = p;
+        while (lineBegin < lineEnd && std::isspace((unsigned char) *lineBegin))
+          ++lineBegin;
+        while (lineEnd > lineBegin &&
+               std::isspace((unsigned char) *(lineEnd - 1)))
+          --lineEnd;
+
+        lines.push_back(LineType(lineBegin, lineEnd));
+        p = (newline == NULL) ? end : newline + 1;
+      }
+
+      chunkFunction(lines, firstLine);
+      firstLine += lines.size();
+
+      carry = bytes - parseEnd;
+      std::memmove(buffer.data(), buffer.data() + parseEnd, carry);
+    }
+  }
+
+  /**
+   * Split a line into tokens following the same rules as stringRule and
+   * delimiterRule, and call tokenFunction(dimension, begin, end) on each token
+   * (with whitespace removed from either side).  This is safe to call from
+   * several threads at once.
+   *
+   * @return The number of tokens in the line.
+   */
+  template<typename TokenFunction>
+  size_t TokenizeLine(const char* begin,
+                      const char* end,
+                      TokenFunction tokenFunction) const
+  {
+    size_t dims = 0;
+    const char* p = begin;
+    while (true)
+    {
+      const char* tokenBegin = p;
+      while (p < end && std::strchr(tokenStopChars, *p) == NULL)
+        ++p;
+
+      const char* tokenEnd = p;
+      while (tokenBegin < tokenEnd &&
+             std::isspace((unsigned char) *tokenBegin))
+        ++tokenBegin;
+      while (tokenEnd > tokenBegin &&
+             std::isspace((unsigned char) *(tokenEnd - 1)))
+        --tokenEnd;
+      tokenFunction(dims++, tokenBegin, tokenEnd);
+
+      // Now find the delimiter; if there is none, the line is done.
+      const char* q = p;
+      while (q < end && *q == ' ')
+        ++q;
+      if (delimiter != ' ')
+      {
+        if (q == end || *q != delimiter)
+          break;
+        ++q;
+        while (q < end && *q == ' ')
+          ++q;
+      }
+      else if (q == p)
+      {
+        break;
+      }
+      p = q;
+    }
+
+    return dims;
+  }
+
+  /**
+   * Convert a token to a number, returning false if a stringstream extraction
+   * would not consume the whole token (this is how IncrementPolicy decides
+   * that a token must be mapped).  Plain decimal numbers are converted with
+   * strtod(), which gives the same result much faster; anything else falls
+   * back to the stringstream.
+   */
+  template<typename T>
+  static bool ParseToken(const char* begin, const char* end, T& value)
+  {
+    const std::string token(begin, end);
+    if (IsDecimal(token))
+    {
+      errno = 0;
+      char* parseEnd;
+      T result;
+      // If strtod() reports a range error, let the stringstream decide.
+      if (ConvertDecimal(token.c_str(), &parseEnd, result) && errno == 0 &&
+          parseEnd == token.c_str() + token.size())
+      {
+        value = result;
+        return true;
+      }
+    }
+
+    std::stringstream stream(token);
+    stream >> value;
+    return !stream.fail() && stream.eof();
+  }
+
+  //! Convert with strtod(); this is what a stringstream extraction does too.
+  static bool ConvertDecimal(const char* str, char** end, double& value)
+  {
+    value = std::strtod(str, end);
+    return true;
+  }
+
+  //! Convert with strtof(); this is what a stringstream extraction does too.
+  static bool ConvertDecimal(const char* str, char** end, float& value)
+  {
+    value = std::strtof(str, end);
+    return true;
+  }
+
+  //! Other types are always converted with a stringstream.
+  template<typename T>
+  static bool ConvertDecimal(const char* /* str */, char** /* end */,
+                             T& /* value */)
+  {
+    return false;
+  }
+
+  /**
+   * Return whether the token is a plain decimal number, like "-1.5e3".
+   */
+  static bool IsDecimal(const std::string& token);
+
   //! Spirit rule for parsing.
   boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
   //! Spirit rule for delimiters (i.e. ',' for CSVs).
   boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
 
+  //! Characters that end a token (the same ones as in stringRule).
+  const char* tokenStopChars;
+  //! Delimiter character between tokens (the same one as in delimiterRule).
+  char delimiter;
+
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
@@ -27,6 +27,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "load_arff.hpp"
+#include "mapped_matrix.hpp"
 
 namespace mlpack {
 namespace data {
@@ -107,6 +108,32 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // mlpack's own format is already column-major, so it is never transposed.
+  if (extension == "mmat")
+  {
+    Log::Info << "Loading '" << filename << "' as mlpack mapped matrix data.  "
+        << std::flush;
+    try
+    {
+      LoadMappedMatrix(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_cols << " x " << matrix.n_rows << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
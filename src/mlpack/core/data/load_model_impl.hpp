@@ -19,6 +19,8 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "blob_archive.hpp"
+#include "mapped_matrix.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -49,6 +51,8 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "blob")
+      f = format::blob;
     else
     {
       if (fatal)
@@ -62,6 +66,35 @@ bool Load(const std::string& filename,
     }
   }
 
+  // Blob models are read from a mapping of the file.
+  if (f == format::blob || f == format::compact_blob)
+  {
+    const char* mapping = NULL;
+    size_t size = 0;
+    try
+    {
+      mapping = MapFile(filename, size);
+      MemoryStreambuf buffer(mapping, size);
+      BlobIArchive ar(buffer);
+      ar >> boost::serialization::make_nvp(name.c_str(), t);
+      UnmapFile(mapping, size);
+
+      return true;
+    }
+    catch (std::exception& e)
+    {
+      UnmapFile(mapping, size);
+      if (fatal)
+        Log::Fatal << "Unable to load object '" << name << "' from '"
+            << filename << "': " << e.what() << std::endl;
+      else
+        Log::Warn << "Unable to load object '" << name << "' from '"
+            << filename << "': " << e.what() << std::endl;
+
+      return false;
+    }
+  }
+
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
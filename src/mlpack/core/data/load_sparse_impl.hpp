@@ -0,0 +1,73 @@
+/**
+ * @file load_sparse_impl.hpp
+ *
+ * Implementation of the Load() overload for sparse matrices, defined in
+ * load.hpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "load.hpp"
+#include "extension.hpp"
+#include "libsvm.hpp"
+
+namespace mlpack {
+namespace data {
+
+template<typename eT, typename LabelType>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          arma::Row<LabelType>& labels,
+          const bool fatal)
+{
+  Timer::Start("loading_data");
+
+  const std::string extension = Extension(filename);
+  if (extension != "svm" && extension != "libsvm" && extension != "svmlight")
+  {
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Sparse matrices can only be loaded from libsvm files "
+          << "(.svm, .libsvm or .svmlight), not from '" << filename << "'."
+          << std::endl;
+    else
+      Log::Warn << "Sparse matrices can only be loaded from libsvm files "
+          << "(.svm, .libsvm or .svmlight), not from '" << filename << "'; "
+          << "load failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Loading '" << filename << "' as libsvm data.  " << std::flush;
+  try
+  {
+    LoadLibSVM(filename, matrix, labels);
+  }
+  catch (std::exception& e)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << " with "
+      << matrix.n_nonzero << " nonzero values.\n";
+  Timer::Stop("loading_data");
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
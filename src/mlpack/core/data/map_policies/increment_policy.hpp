@@ -80,6 +80,10 @@ class IncrementPolicy
    * the given dimension. This function is used as a helper function for
    * DatasetMapper class.
    *
+   * Once a dimension has a mapping, this only modifies the maps of that
+   * dimension, so it may be called at once from several threads for distinct
+   * dimensions that all have a mapping already.
+   *
    * @tparam MapType Type of unordered_map that contains mapped value pairs
    * @param input Input to find/create mapping for.
    * @param dimension Index of the dimension of the input.
@@ -109,37 +113,36 @@ class IncrementPolicy
       // Otherwise, we must map.
     }
 
-    // If this condition is true, either we have no mapping for the given input
-    // or we have no mappings for the given dimension at all.  In either case,
-    // we create a mapping.
-    if (maps.count(dimension) == 0 ||
-        maps[dimension].first.count(input) == 0)
+    // Each map is only looked up once, since this is called for every token of
+    // the categorical dimensions.
+    typename MapType::iterator mapIt = maps.find(dimension);
+    if (mapIt == maps.end())
     {
-      // This input does not exist yet.
-      size_t numMappings = maps[dimension].first.size();
-
-      // Change type of the feature to categorical.
-      if (numMappings == 0)
-        types[dimension] = Datatype::categorical;
-
-      typedef typename std::pair<InputType, MappedType> PairType;
-      maps[dimension].first.insert(PairType(input, numMappings));
-
-      // Do we need to create the second map?
-      if (maps[dimension].second.count(numMappings) == 0)
-      {
-        maps[dimension].second.insert(std::make_pair(numMappings,
-            std::vector<InputType>()));
-      }
-      maps[dimension].second[numMappings].push_back(input);
-
-      return T(numMappings);
+      mapIt = maps.insert(std::make_pair(dimension,
+          typename MapType::mapped_type())).first;
     }
-    else
+
+    typename MapType::mapped_type::first_type& forward = mapIt->second.first;
+    typename MapType::mapped_type::first_type::const_iterator it =
+        forward.find(input);
+    if (it != forward.end())
     {
       // This input already exists in the mapping.
-      return maps[dimension].first.at(input);
+      return it->second;
     }
+
+    // This input does not exist yet, so we create a mapping.
+    const size_t numMappings = forward.size();
+
+    // Change type of the feature to categorical.
+    if (numMappings == 0)
+      types[dimension] = Datatype::categorical;
+
+    typedef typename std::pair<InputType, MappedType> PairType;
+    forward.insert(PairType(input, numMappings));
+    mapIt->second.second[numMappings].push_back(input);
+
+    return T(numMappings);
   }
 
  private:
@@ -0,0 +1,182 @@
+/**
+ * @file mapped_matrix.cpp
+ *
+ * Platform-specific mapping of files, and checks of .mmat headers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_matrix.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+#ifndef _WIN32
+
+const char* MapFile(const std::string& filename, size_t& size)
+{
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0)
+  {
+    close(fd);
+    std::ostringstream oss;
+    oss << "Cannot determine the size of '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  size = (size_t) fileStat.st_size;
+  if (size == 0)
+  {
+    // mmap() can't map empty files; CheckMappedMatrix() will reject it anyway.
+    close(fd);
+    return NULL;
+  }
+
+  void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (mapping == MAP_FAILED)
+  {
+    std::ostringstream oss;
+    oss << "Cannot map file '" << filename << "': " << std::strerror(errno)
+        << ".";
+    throw std::runtime_error(oss.str());
+  }
+
+  return (const char*) mapping;
+}
+
+void UnmapFile(const char* mapping, const size_t size)
+{
+  if (mapping != NULL)
+    munmap((void*) mapping, size);
+}
+
+#else
+
+// Without mmap(), just read the whole file into memory.
+const char* MapFile(const std::string& filename, size_t& size)
+{
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary |
+      std::ios::ate);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  size = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  // Memory from new[] is suitably aligned for any element type.
+  char* data = new char[size];
+  if (!stream.read(data, std::streamsize(size)))
+  {
+    delete[] data;
+    std::ostringstream oss;
+    oss << "Cannot read file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return data;
+}
+
+void UnmapFile(const char* mapping, const size_t /* size */)
+{
+  delete[] mapping;
+}
+
+#endif
+
+MappedMatrixHeader CheckMappedMatrix(const char* data,
+                                     const size_t size,
+                                     const std::string& filename)
+{
+  MappedMatrixHeader header;
+  if (size < sizeof(header))
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' is too small to be a mapped matrix file.";
+    throw std::runtime_error(oss.str());
+  }
+  std::memcpy(&header, data, sizeof(header));
+
+  if (std::memcmp(header.magic, "MLPACKMM", 8) != 0)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' is not a mapped matrix file.";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (header.byteOrder != 0x01020304)
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' was written on a machine with a different "
+        << "byte order.";
+    throw std::runtime_error(oss.str());
+  }
+
+  // Make sure the data is all there, without overflowing.
+  const uint64_t available = (size - sizeof(header));
+  if (header.elemSize == 0 || (header.nRows != 0 && header.nCols >
+      available / header.elemSize / header.nRows) ||
+      (header.nRows * header.nCols * header.elemSize > available))
+  {
+    std::ostringstream oss;
+    oss << "'" << filename << "' is truncated: a " << header.nRows << "x"
+        << header.nCols << " matrix does not fit in it.";
+    throw std::runtime_error(oss.str());
+  }
+
+  return header;
+}
+
+MappedMatrixHeader ReadMappedMatrixHeader(const std::string& filename)
+{
+  std::ifstream stream(filename.c_str(), std::ios::in | std::ios::binary |
+      std::ios::ate);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "Cannot open file '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+
+  const size_t size = (size_t) stream.tellg();
+  stream.seekg(0, std::ios::beg);
+
+  char data[sizeof(MappedMatrixHeader)];
+  const size_t headerSize = std::min(size, sizeof(MappedMatrixHeader));
+  stream.read(data, std::streamsize(headerSize));
+
+  // Only the header is read, but it is checked against the full size.
+  if (headerSize < sizeof(MappedMatrixHeader))
+    return CheckMappedMatrix(data, headerSize, filename);
+  else
+    return CheckMappedMatrix(data, size, filename);
+}
+
+} // namespace data
+} // namespace mlpack
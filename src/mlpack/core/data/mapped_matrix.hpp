@@ -0,0 +1,168 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * A simple binary matrix format that stores a matrix in the same column-major
+ * layout mlpack uses in memory, so that it can be memory-mapped and used
+ * directly without any copy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header at the start of a mapped matrix (.mmat) file.  It is 64 bytes
+ * long, so the elements that follow it are aligned for any element type when
+ * the file is mapped.  The elements are stored column-major (that is, one
+ * point after another for mlpack datasets), in the byte order of the machine
+ * that wrote the file.
+ */
+struct MappedMatrixHeader
+{
+  //! Always "MLPACKMM".
+  char magic[8];
+  //! Always 0x01020304; used to detect files written with another byte order.
+  uint32_t byteOrder;
+  //! Kind of the elements: 'f' (floating point), 'i' (signed), 'u' (unsigned).
+  uint32_t elemKind;
+  //! Size of each element, in bytes.
+  uint64_t elemSize;
+  //! Number of rows of the matrix.
+  uint64_t nRows;
+  //! Number of columns of the matrix.
+  uint64_t nCols;
+  //! Padding to 64 bytes; always zeros.
+  char padding[24];
+};
+
+static_assert(sizeof(MappedMatrixHeader) == 64,
+    "MappedMatrixHeader must be 64 bytes long.");
+
+//! The kind of element stored for the given element type.
+template<typename eT>
+struct MappedElementKind
+{
+  static const uint32_t value = std::is_floating_point<eT>::value ? 'f' :
+      (std::is_signed<eT>::value ? 'i' : 'u');
+};
+
+/**
+ * A read-only matrix backed by a memory-mapped .mmat file.  The matrix given by
+ * Matrix() uses the mapped pages directly, so constructing a MappedMatrix takes
+ * constant time no matter how large the file is, and the pages are shared by
+ * all the processes that map the same file.  The file must not be modified
+ * while it is mapped.  On platforms without mmap() (i.e. Windows), the file is
+ * read into memory instead.
+ *
+ * A MappedMatrix can't be copied or moved, since the matrix refers to the
+ * mapping; a std::unique_ptr can be used to pass it around.
+ *
+ * @code
+ * data::MappedMatrix<double> references("references.mmat");
+ * const arma::mat& dataset = references.Matrix();
+ * @endcode
+ *
+ * Files can be written with data::Save() (or SaveMappedMatrix()).  The element
+ * type of the file must be the eT given here; use data::Load() to convert
+ * between types.
+ *
+ * @tparam eT Element type of the matrix.
+ */
+template<typename eT>
+class MappedMatrix
+{
+ public:
+  /**
+   * Map the given file.  A std::runtime_error is thrown if the file can't be
+   * mapped, is not a valid .mmat file, or holds another element type.
+   *
+   * @param filename Name of the .mmat file to map.
+   */
+  MappedMatrix(const std::string& filename);
+
+  //! Unmap the file.
+  ~MappedMatrix();
+
+  MappedMatrix(const MappedMatrix&) = delete;
+  MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+  //! Get the matrix, which refers to the mapped file.
+  const arma::Mat<eT>& Matrix() const { return matrix; }
+
+ private:
+  //! Map the file and check its header, throwing on errors.
+  static const char* Map(const std::string& filename, size_t& mappingSize);
+
+  //! Size of the mapping, in bytes.
+  size_t mappingSize;
+  //! The mapped file.
+  const char* mapping;
+  //! The matrix, using the mapped memory.
+  arma::Mat<eT> matrix;
+};
+
+/**
+ * Map the given file read-only, returning a pointer to its contents and setting
+ * size to its size in bytes.  A std::runtime_error is thrown on failure.
+ */
+const char* MapFile(const std::string& filename, size_t& size);
+
+//! Release a mapping returned by MapFile().
+void UnmapFile(const char* mapping, const size_t size);
+
+/**
+ * Check that the given data (of the given size, in bytes) starts with a valid
+ * .mmat header, and that it is big enough for the matrix it describes.  A
+ * std::runtime_error is thrown otherwise.  The header is returned.
+ */
+MappedMatrixHeader CheckMappedMatrix(const char* data,
+                                     const size_t size,
+                                     const std::string& filename);
+
+/**
+ * Read the header of the given .mmat file without mapping it, throwing a
+ * std::runtime_error if it is not valid.
+ */
+MappedMatrixHeader ReadMappedMatrixHeader(const std::string& filename);
+
+/**
+ * Write the given matrix to a .mmat file.  A std::runtime_error is thrown on
+ * failure.
+ *
+ * @param filename Name of the file to write.
+ * @param matrix Matrix to save.
+ */
+template<typename eT>
+void SaveMappedMatrix(const std::string& filename,
+                      const arma::Mat<eT>& matrix);
+
+/**
+ * Load a .mmat file into the given matrix, converting the elements to eT if the
+ * file holds another type.  The file is mapped, so this costs a single copy.  A
+ * std::runtime_error is thrown on failure.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load into.
+ */
+template<typename eT>
+void LoadMappedMatrix(const std::string& filename, arma::Mat<eT>& matrix);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,155 @@
+/**
+ * @file mapped_matrix_impl.hpp
+ *
+ * Implementation of MappedMatrix and of loading and saving .mmat files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mapped_matrix.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace mlpack {
+namespace data {
+
+template<typename eT>
+MappedMatrix<eT>::MappedMatrix(const std::string& filename) :
+    mappingSize(0),
+    mapping(Map(filename, mappingSize)),
+    matrix(const_cast<eT*>(reinterpret_cast<const eT*>(mapping +
+        sizeof(MappedMatrixHeader))),
+        reinterpret_cast<const MappedMatrixHeader*>(mapping)->nRows,
+        reinterpret_cast<const MappedMatrixHeader*>(mapping)->nCols,
+        false /* Don't copy. */, true /* Never reallocate. */)
+{ /* Nothing to do. */ }
+
+template<typename eT>
+MappedMatrix<eT>::~MappedMatrix()
+{
+  UnmapFile(mapping, mappingSize);
+}
+
+template<typename eT>
+const char* MappedMatrix<eT>::Map(const std::string& filename,
+                                  size_t& mappingSize)
+{
+  const char* mapping = MapFile(filename, mappingSize);
+
+  try
+  {
+    const MappedMatrixHeader header = CheckMappedMatrix(mapping, mappingSize,
+        filename);
+    if (header.elemKind != MappedElementKind<eT>::value ||
+        header.elemSize != sizeof(eT))
+    {
+      std::ostringstream oss;
+      oss << "MappedMatrix::MappedMatrix(): '" << filename << "' holds "
+          << header.elemSize << "-byte elements of kind '"
+          << (char) header.elemKind << "', not the requested type; use "
+          << "data::Load() to convert it.";
+      throw std::runtime_error(oss.str());
+    }
+  }
+  catch (std::exception&)
+  {
+    UnmapFile(mapping, mappingSize);
+    throw;
+  }
+
+  return mapping;
+}
+
+template<typename eT>
+void SaveMappedMatrix(const std::string& filename,
+                      const arma::Mat<eT>& matrix)
+{
+  std::ofstream stream(filename.c_str(), std::ios::out | std::ios::binary |
+      std::ios::trunc);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "SaveMappedMatrix(): cannot open '" << filename << "' for writing.";
+    throw std::runtime_error(oss.str());
+  }
+
+  MappedMatrixHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, "MLPACKMM", 8);
+  header.byteOrder = 0x01020304;
+  header.elemKind = MappedElementKind<eT>::value;
+  header.elemSize = sizeof(eT);
+  header.nRows = matrix.n_rows;
+  header.nCols = matrix.n_cols;
+
+  stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  stream.write(reinterpret_cast<const char*>(matrix.memptr()),
+      std::streamsize(matrix.n_elem * sizeof(eT)));
+
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "SaveMappedMatrix(): error while writing '" << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+namespace details {
+
+/**
+ * Map the file as a matrix of the type it holds, and convert it to the type of
+ * the given matrix.
+ */
+template<typename FileType, typename eT>
+void ConvertMappedMatrix(const std::string& filename, arma::Mat<eT>& matrix)
+{
+  MappedMatrix<FileType> mapped(filename);
+  matrix = arma::conv_to<arma::Mat<eT>>::from(mapped.Matrix());
+}
+
+} // namespace details
+
+template<typename eT>
+void LoadMappedMatrix(const std::string& filename, arma::Mat<eT>& matrix)
+{
+  const MappedMatrixHeader header = ReadMappedMatrixHeader(filename);
+
+  if (header.elemKind == MappedElementKind<eT>::value &&
+      header.elemSize == sizeof(eT))
+  {
+    MappedMatrix<eT> mapped(filename);
+    matrix = mapped.Matrix();
+  }
+  else if (header.elemKind == 'f' && header.elemSize == 4)
+    details::ConvertMappedMatrix<float>(filename, matrix);
+  else if (header.elemKind == 'f' && header.elemSize == 8)
+    details::ConvertMappedMatrix<double>(filename, matrix);
+  else if (header.elemKind == 'i' && header.elemSize == 4)
+    details::ConvertMappedMatrix<int32_t>(filename, matrix);
+  else if (header.elemKind == 'i' && header.elemSize == 8)
+    details::ConvertMappedMatrix<int64_t>(filename, matrix);
+  else if (header.elemKind == 'u' && header.elemSize == 4)
+    details::ConvertMappedMatrix<uint32_t>(filename, matrix);
+  else if (header.elemKind == 'u' && header.elemSize == 8)
+    details::ConvertMappedMatrix<uint64_t>(filename, matrix);
+  else
+  {
+    std::ostringstream oss;
+    oss << "LoadMappedMatrix(): cannot convert the " << header.elemSize
+        << "-byte elements of kind '" << (char) header.elemKind << "' in '"
+        << filename << "'.";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -38,6 +38,8 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Raw binary (raw_binary), denoted by .bin
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
+ *  - mlpack mapped matrix (see MappedMatrix), denoted by .mmat; this format
+ *    stores matrices column-major, so it is never transposed
  *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
@@ -58,6 +60,27 @@ bool Save(const std::string& filename,
           const bool fatal = false,
           bool transpose = true);
 
+/**
+ * Save a sparse matrix and the labels of its points to a libsvm (or svmlight)
+ * file, denoted by .svm, .libsvm or .svmlight; each point (column of the
+ * matrix) is written on its own line, as its label followed by its nonzero
+ * features.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown upon failure.
+ *
+ * @param filename Name of file to save to.
+ * @param matrix Sparse matrix to save into file.
+ * @param labels Labels of the points.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of save.
+ */
+template<typename eT, typename LabelType>
+bool Save(const std::string& filename,
+          const arma::SpMat<eT>& matrix,
+          const arma::Row<LabelType>& labels,
+          const bool fatal = false);
+
 /**
  * Saves a model to file, guessing the filetype from the extension, or,
  * optionally, saving the specified format.  If automatic extension detection is
@@ -69,9 +92,16 @@ bool Save(const std::string& filename,
  *  - text, denoted by .txt
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
+ *  - mlpack blob (see BlobOArchive), denoted by .blob; this binary format
+ *    writes matrices as raw blocks and trees as flat arrays of nodes, and is
+ *    read from a mapping of the file, so it is the fastest for large models
  *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary',
+ * 'format::blob' and 'format::compact_blob'.  'format::compact_blob' writes a
+ * blob file in which trees only hold their structure and their permuted
+ * dataset, and are rebuilt when the file is loaded (see
+ * BlobOArchive::CompactTrees()); it is never autodetected.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
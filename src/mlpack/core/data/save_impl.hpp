@@ -15,6 +15,9 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "blob_archive.hpp"
+#include "mapped_matrix.hpp"
+#include "libsvm.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -64,6 +67,30 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // mlpack's own format stores the matrix as it is, so it is never transposed.
+  if (extension == "mmat")
+  {
+    Log::Info << "Saving mlpack mapped matrix data to '" << filename << "'."
+        << std::endl;
+    try
+    {
+      SaveMappedMatrix(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   // Catch errors opening the file.
   std::fstream stream;
 #ifdef  _WIN32 // Always open in binary mode on Windows.
@@ -197,6 +224,50 @@ bool Save(const std::string& filename,
   return true;
 }
 
+template<typename eT, typename LabelType>
+bool Save(const std::string& filename,
+          const arma::SpMat<eT>& matrix,
+          const arma::Row<LabelType>& labels,
+          const bool fatal)
+{
+  Timer::Start("saving_data");
+
+  const std::string extension = Extension(filename);
+  if (extension != "svm" && extension != "libsvm" && extension != "svmlight")
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << "Sparse matrices can only be saved in libsvm format "
+          << "(.svm, .libsvm or .svmlight), not to '" << filename << "'.  Save "
+          << "failed." << std::endl;
+    else
+      Log::Warn << "Sparse matrices can only be saved in libsvm format "
+          << "(.svm, .libsvm or .svmlight), not to '" << filename << "'.  Save "
+          << "failed." << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Saving libsvm data to '" << filename << "'." << std::endl;
+  try
+  {
+    SaveLibSVM(filename, matrix, labels);
+  }
+  catch (std::exception& e)
+  {
+    Timer::Stop("saving_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Timer::Stop("saving_data");
+  return true;
+}
+
 //! Save a model to file.
 template<typename T>
 bool Save(const std::string& filename,
@@ -215,14 +286,16 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "blob")
+      f = format::blob;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/txt/blob)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/txt/blob)"
             << std::endl;
 
       return false;
@@ -232,7 +305,8 @@ bool Save(const std::string& filename,
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  // Open non-text types in binary mode on Windows.
+  if (f == format::binary || f == format::blob || f == format::compact_blob)
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
   else
     ofs.open(filename, std::ofstream::out);
@@ -269,6 +343,12 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::blob || f == format::compact_blob)
+    {
+      BlobOArchive ar(ofs);
+      ar.CompactTrees() = (f == format::compact_blob);
+      ar << boost::serialization::make_nvp(name.c_str(), t);
+    }
 
     return true;
   }
@@ -17,6 +17,125 @@
 
 namespace mlpack {
 namespace data {
+
+/**
+ * Get a random order of the points of a dataset of the given size for a split:
+ * the first trainSize points of the order go to the training set, and the
+ * others to the test set.
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param trainSize Set to the number of points of the training set.
+ */
+inline arma::Col<size_t> SplitOrder(const size_t numPoints,
+                                    const double testRatio,
+                                    size_t& trainSize)
+{
+  trainSize = numPoints - static_cast<size_t>(numPoints * testRatio);
+  if (numPoints == 0)
+    return arma::Col<size_t>();
+
+  return arma::shuffle(arma::linspace<arma::Col<size_t>>(0, numPoints - 1,
+      numPoints));
+}
+
+/**
+ * Get a random order of the points of a labeled dataset for a stratified split
+ * (see SplitOrder()): each label gets the same share of its points in the test
+ * set, so that the proportions of the labels are kept in both sets.  Within
+ * each set, the points are in a random order.
+ *
+ * @param labels Labels of the points of the dataset.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param trainSize Set to the number of points of the training set.
+ */
+template<typename U>
+arma::Col<size_t> StratifiedSplitOrder(const arma::Row<U>& labels,
+                                       const double testRatio,
+                                       size_t& trainSize)
+{
+  const arma::Col<size_t> shuffled = SplitOrder(labels.n_elem, testRatio,
+      trainSize);
+
+  // Find how many points of each label go to the test set.
+  std::map<U, size_t> testCounts;
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    ++testCounts[labels[i]];
+  size_t testSize = 0;
+  for (typename std::map<U, size_t>::iterator it = testCounts.begin();
+       it != testCounts.end(); ++it)
+  {
+    it->second = static_cast<size_t>(it->second * testRatio);
+    testSize += it->second;
+  }
+  trainSize = labels.n_elem - testSize;
+
+  arma::Col<size_t> order(labels.n_elem);
+  size_t trainIndex = 0;
+  size_t testIndex = trainSize;
+  for (size_t i = 0; i < shuffled.n_elem; ++i)
+  {
+    size_t& remaining = testCounts[labels[shuffled[i]]];
+    if (remaining > 0)
+    {
+      order[testIndex++] = shuffled[i];
+      --remaining;
+    }
+    else
+    {
+      order[trainIndex++] = shuffled[i];
+    }
+  }
+
+  return order;
+}
+
+/**
+ * Copy the columns order[begin], ..., order[begin + output.n_cols - 1] of the
+ * input into the columns of the output, in parallel.
+ */
+template<typename T>
+void GatherColumns(const arma::Mat<T>& input,
+                   const arma::Col<size_t>& order,
+                   const size_t begin,
+                   arma::Mat<T>& output)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) output.n_cols; ++i)
+    output.col(i) = input.col(order[begin + i]);
+}
+
+/**
+ * Reorder the columns of the given matrix in place, so that column i becomes
+ * the former column order[i].  The columns are moved along the cycles of the
+ * permutation, so only one column is held aside at a time.
+ */
+template<typename T>
+void PermuteColumns(arma::Mat<T>& data, const arma::Col<size_t>& order)
+{
+  std::vector<bool> visited(data.n_cols, false);
+  arma::Col<T> start(data.n_rows);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (visited[i])
+      continue;
+
+    start = data.col(i);
+    size_t j = i;
+    while (true)
+    {
+      visited[j] = true;
+      const size_t next = order[j];
+      if (next == i)
+        break;
+
+      data.col(j) = data.col(next);
+      j = next;
+    }
+    data.col(j) = start;
+  }
+}
+
 /**
  * Given an input dataset and labels, split into a training set and test set.
  * Example usage below.  This overload places the split dataset into the four
@@ -44,6 +163,8 @@ namespace data {
  * @param trainLabel Vector to store training labels into.
  * @param testLabel Vector to store test labels into.
  * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, each label gets the same share of its points in
+ *     the test set (see StratifiedSplitOrder()).
  */
 template<typename T, typename U>
 void Split(const arma::Mat<T>& input,
@@ -52,30 +173,26 @@ void Split(const arma::Mat<T>& input,
            arma::Mat<T>& testData,
            arma::Row<U>& trainLabel,
            arma::Row<U>& testLabel,
-           const double testRatio)
+           const double testRatio,
+           const bool stratifyData = false)
 {
-  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
-  const size_t trainSize = input.n_cols - testSize;
+  size_t trainSize;
+  const arma::Col<size_t> order = stratifyData ?
+      StratifiedSplitOrder(inputLabel, testRatio, trainSize) :
+      SplitOrder(input.n_cols, testRatio, trainSize);
+  const size_t testSize = input.n_cols - trainSize;
+
   trainData.set_size(input.n_rows, trainSize);
   testData.set_size(input.n_rows, testSize);
   trainLabel.set_size(trainSize);
   testLabel.set_size(testSize);
 
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
-                                                      input.n_cols));
-
+  GatherColumns(input, order, 0, trainData);
+  GatherColumns(input, order, trainSize, testData);
   for (size_t i = 0; i != trainSize; ++i)
-  {
-    trainData.col(i) = input.col(order[i]);
     trainLabel(i) = inputLabel(order[i]);
-  }
-
   for (size_t i = 0; i != testSize; ++i)
-  {
-    testData.col(i) = input.col(order[i + trainSize]);
     testLabel(i) = inputLabel(order[i + trainSize]);
-  }
 }
 
 /**
@@ -105,23 +222,14 @@ void Split(const arma::Mat<T>& input,
            arma::Mat<T>& testData,
            const double testRatio)
 {
-  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
-  const size_t trainSize = input.n_cols - testSize;
+  size_t trainSize;
+  const arma::Col<size_t> order = SplitOrder(input.n_cols, testRatio,
+      trainSize);
   trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-
-  const arma::Col<size_t> order =
-      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols -1,
-                                                      input.n_cols));
+  testData.set_size(input.n_rows, input.n_cols - trainSize);
 
-  for (size_t i = 0; i != trainSize; ++i)
-  {
-    trainData.col(i) = input.col(order[i]);
-  }
-  for (size_t i = 0; i != testSize; ++i)
-  {
-    testData.col(i) = input.col(order[i + trainSize]);
-  }
+  GatherColumns(input, order, 0, trainData);
+  GatherColumns(input, order, trainSize, testData);
 }
 
 /**
@@ -140,6 +248,8 @@ void Split(const arma::Mat<T>& input,
  * @param input Input dataset to split.
  * @param label Input labels to split.
  * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, each label gets the same share of its points in
+ *     the test set (see StratifiedSplitOrder()).
  * @return std::tuple containing trainData (arma::Mat<T>), testData
  *      (arma::Mat<T>), trainLabel (arma::Row<U>), and testLabel (arma::Row<U>).
  */
@@ -147,7 +257,8 @@ template<typename T, typename U>
 std::tuple<arma::Mat<T>, arma::Mat<T>, arma::Row<U>, arma::Row<U>>
 Split(const arma::Mat<T>& input,
       const arma::Row<U>& inputLabel,
-      const double testRatio)
+      const double testRatio,
+      const bool stratifyData = false)
 {
   arma::Mat<T> trainData;
   arma::Mat<T> testData;
@@ -155,7 +266,7 @@ Split(const arma::Mat<T>& input,
   arma::Row<U> testLabel;
 
   Split(input, inputLabel, trainData, testData, trainLabel, testLabel,
-      testRatio);
+      testRatio, stratifyData);
 
   return std::make_tuple(std::move(trainData),
                          std::move(testData),
@@ -192,6 +303,88 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Given an input dataset and labels, split them into a training set and test
+ * set without copying them.  The points (and labels) of the input are shuffled
+ * in place, so that the training set is the first columns of the input and the
+ * test set the last ones, and the returned matrices are aliases of these
+ * columns (which are moved, not copied, by std::tie()); the input must
+ * therefore outlive them, and must not be resized while they are used.  This is meant for datasets too large to hold twice in
+ * memory.
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * arma::mat trainData, testData;
+ * arma::Row<size_t> trainLabel, testLabel;
+ * std::tie(trainData, testData, trainLabel, testLabel) =
+ *     SplitInPlace(input, label, 0.2);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param inputLabel Input labels to split; they are reordered with the points.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param stratifyData If true, each label gets the same share of its points in
+ *     the test set (see StratifiedSplitOrder()).
+ * @return std::tuple containing aliases of the training data (arma::Mat<T>),
+ *     the test data (arma::Mat<T>), the training labels (arma::Row<U>), and the
+ *     test labels (arma::Row<U>).
+ */
+template<typename T, typename U>
+std::tuple<arma::Mat<T>, arma::Mat<T>, arma::Row<U>, arma::Row<U>>
+SplitInPlace(arma::Mat<T>& input,
+             arma::Row<U>& inputLabel,
+             const double testRatio,
+             const bool stratifyData = false)
+{
+  size_t trainSize;
+  const arma::Col<size_t> order = stratifyData ?
+      StratifiedSplitOrder(inputLabel, testRatio, trainSize) :
+      SplitOrder(input.n_cols, testRatio, trainSize);
+  const size_t testSize = input.n_cols - trainSize;
+
+  PermuteColumns(input, order);
+  PermuteColumns(inputLabel, order);
+
+  return std::make_tuple(
+      arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false, false),
+      arma::Mat<T>(input.memptr() + trainSize * input.n_rows, input.n_rows,
+          testSize, false, false),
+      arma::Row<U>(inputLabel.memptr(), trainSize, false, false),
+      arma::Row<U>(inputLabel.memptr() + trainSize, testSize, false, false));
+}
+
+/**
+ * Given an input dataset, split it into a training set and test set without
+ * copying it (see the labeled overload of SplitInPlace()).
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::mat trainData, testData;
+ * std::tie(trainData, testData) = SplitInPlace(input, 0.2);
+ * @endcode
+ *
+ * @param input Input dataset to split; its columns are reordered.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @return std::tuple containing aliases of the training data (arma::Mat<T>)
+ *     and the test data (arma::Mat<T>).
+ */
+template<typename T>
+std::tuple<arma::Mat<T>, arma::Mat<T>>
+SplitInPlace(arma::Mat<T>& input, const double testRatio)
+{
+  size_t trainSize;
+  const arma::Col<size_t> order = SplitOrder(input.n_cols, testRatio,
+      trainSize);
+
+  PermuteColumns(input, order);
+
+  return std::make_tuple(
+      arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false, false),
+      arma::Mat<T>(input.memptr() + trainSize * input.n_rows, input.n_rows,
+          input.n_cols - trainSize, false, false));
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -63,14 +63,38 @@ void GaussianDistribution::FactorCovariance()
   double sign = 0.;
   arma::log_det(logDetCov, sign, covLower);
   logDetCov *= 2;
+
+  diagonal = IsDiagonal(covariance);
+}
+
+bool GaussianDistribution::IsDiagonal(const arma::mat& matrix)
+{
+  for (size_t j = 0; j < matrix.n_cols; ++j)
+    for (size_t i = 0; i < matrix.n_rows; ++i)
+      if (i != j && matrix(i, j) != 0.0)
+        return false;
+
+  return true;
 }
 
 double GaussianDistribution::LogProbability(const arma::vec& observation) const
 {
   const size_t k = observation.n_elem;
   const arma::vec diff = mean - observation;
-  const arma::vec v = (diff.t() * invCov * diff);
-  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
+
+  // The Mahalanobis distance is the squared norm of L^-1 * diff.
+  double v;
+  if (diagonal)
+  {
+    v = arma::accu(arma::square(diff) % invCov.diag());
+  }
+  else
+  {
+    const arma::vec solved = arma::solve(arma::trimatl(covLower), diff);
+    v = arma::dot(solved, solved);
+  }
+
+  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v;
 }
 
 arma::vec GaussianDistribution::Random() const
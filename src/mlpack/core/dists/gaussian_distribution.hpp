@@ -34,6 +34,9 @@ class GaussianDistribution
   arma::mat invCov;
   //! Cached logdet(cov).
   double logDetCov;
+  //! Whether the covariance is diagonal; if so, the log probabilities are
+  //! computed elementwise.
+  bool diagonal;
 
   //! log(2pi)
   static const constexpr double log2pi = 1.83787706640934533908193770912475883;
@@ -42,7 +45,8 @@ class GaussianDistribution
   /**
    * Default constructor, which creates a Gaussian with zero dimension.
    */
-  GaussianDistribution() : logDetCov(0.0) { /* nothing to do */ }
+  GaussianDistribution() : logDetCov(0.0), diagonal(true)
+  { /* nothing to do */ }
 
   /**
    * Create a Gaussian distribution with zero mean and identity covariance with
@@ -53,7 +57,8 @@ class GaussianDistribution
       covariance(arma::eye<arma::mat>(dimension, dimension)),
       covLower(arma::eye<arma::mat>(dimension, dimension)),
       invCov(arma::eye<arma::mat>(dimension, dimension)),
-      logDetCov(0)
+      logDetCov(0),
+      diagonal(true)
   { /* Nothing to do. */ }
 
   /**
@@ -95,6 +100,17 @@ class GaussianDistribution
     probabilities = arma::exp(logProbabilities);
   }
 
+  /**
+   * Calculates the multivariate Gaussian log probability density function for
+   * each data point (column) in the given matrix.  The points are processed in
+   * blocks, and the Mahalanobis distances are computed with a triangular solve
+   * against the Cholesky factor of the covariance (or elementwise, if the
+   * covariance is diagonal).
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   */
   void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
@@ -142,6 +158,23 @@ class GaussianDistribution
 
   void Covariance(arma::mat&& covariance);
 
+  /**
+   * Return the lower triangular Cholesky factor L of the covariance (so that
+   * the covariance is L * L^T).
+   */
+  const arma::mat& CovLower() const { return covLower; }
+
+  /**
+   * Return the log-determinant of the covariance.
+   */
+  double LogDetCov() const { return logDetCov; }
+
+  /**
+   * Return whether the covariance is diagonal (for instance, when trained with
+   * gmm::DiagonalConstraint).
+   */
+  bool IsDiagonal() const { return diagonal; }
+
   /**
    * Serialize the distribution.
    */
@@ -154,6 +187,9 @@ class GaussianDistribution
     ar & BOOST_SERIALIZATION_NVP(covLower);
     ar & BOOST_SERIALIZATION_NVP(invCov);
     ar & BOOST_SERIALIZATION_NVP(logDetCov);
+
+    if (Archive::is_loading::value)
+      diagonal = IsDiagonal(covariance);
   }
 
  private:
@@ -163,37 +199,53 @@ class GaussianDistribution
    * std::runtime_error will be thrown.
    */
   void FactorCovariance();
+
+  //! Return whether the given matrix is diagonal.
+  static bool IsDiagonal(const arma::mat& matrix);
 };
 
-/**
-* Calculates the multivariate Gaussian log probability density function for each
-* data point (column) in the given matrix
-*
-* @param x List of observations.
-* @param probabilities Output log probabilities for each input observation.
-*/
 inline void GaussianDistribution::LogProbability(
     const arma::mat& x,
     arma::vec& logProbabilities) const
 {
-  // Column i of 'diffs' is the difference between x.col(i) and the mean.
-  arma::mat diffs = x - (mean * arma::ones<arma::rowvec>(x.n_cols));
-
-  // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1 *
-  // diffs).  We just don't need any of the other elements.  We can calculate
-  // the right hand part of the equation (instead of the left side) so that
-  // later we are referencing columns, not rows -- that is faster.
-  const arma::mat rhs = -0.5 * invCov * diffs;
-  arma::vec logExponents(diffs.n_cols); // We will now fill this.
-  for (size_t i = 0; i < diffs.n_cols; i++)
-    logExponents(i) = accu(diffs.unsafe_col(i) % rhs.unsafe_col(i));
-
   const size_t k = x.n_rows;
-
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  const double logNormalizer = -0.5 * k * log2pi - 0.5 * logDetCov;
+  const arma::vec invVariances = diagonal ? arma::vec(invCov.diag()) :
+      arma::vec();
+
+  // The points are processed in blocks, so that the differences with the mean
+  // stay in cache.
+  const size_t blockSize = 1024;
+  logProbabilities.set_size(x.n_cols);
+  arma::mat diffs, solved;
+  for (size_t begin = 0; begin < x.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min((size_t) x.n_cols, begin + blockSize);
+
+    // Column i of 'diffs' is the difference between x.col(begin + i) and the
+    // mean.
+    diffs = x.cols(begin, end - 1);
+    diffs.each_col() -= mean;
+
+    // We only want the diagonal of (diffs' * cov^-1 * diffs).  Since
+    // cov^-1 = L^-T * L^-1, each element is the squared norm of a column of
+    // L^-1 * diffs, which a triangular solve gives without forming cov^-1 * x.
+    if (diagonal)
+    {
+      diffs %= diffs;
+      diffs.each_col() %= invVariances;
+    }
+    else
+    {
+      solved = arma::solve(arma::trimatl(covLower), diffs);
+      diffs = solved % solved;
+    }
+
+    logProbabilities.subvec(begin, end - 1) = logNormalizer -
+        0.5 * arma::trans(arma::sum(diffs, 0));
+  }
 }
 
-
 } // namespace distribution
 } // namespace mlpack
 
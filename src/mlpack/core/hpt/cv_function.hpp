@@ -73,6 +73,33 @@ class CVFunction
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters, and store the
+   * trained model in the given pointer.  Unlike the other overload, this does
+   * not keep track of the best model, and it calls EvaluateModel() of the
+   * CVType object, so it may be called from several threads at once.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   * @param model Pointer to store the trained model in.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  std::unique_ptr<MLAlgorithm>& model);
+
+  /**
+   * Like Evaluate(parameters, model), but train the models on the given
+   * fraction of their training points only, by calling EvaluateSubset() of the
+   * CVType object.
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the Evaluate method of the CVType object.
+   * @param model Pointer to store the trained model in.
+   * @param fraction Fraction of the training points to train on, in (0, 1].
+   */
+  double EvaluateSubset(const arma::mat& parameters,
+                        std::unique_ptr<MLAlgorithm>& model,
+                        const double fraction);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -104,6 +131,47 @@ class CVFunction
            bool BoundArgsIndexInRange = (BoundArgIndex < BoundArgsAmount)>
   struct UseBoundArg;
 
+  /**
+   * Run cross-validation with the collected arguments, and keep the trained
+   * model if it is the best so far.
+   */
+  struct KeepBestModel
+  {
+    CVFunction& function;
+
+    template<typename... Args>
+    double operator()(const Args&... args);
+  };
+
+  /**
+   * Run cross-validation with the collected arguments, and store the trained
+   * model in the given pointer.
+   */
+  struct StoreModel
+  {
+    CVType& cv;
+    std::unique_ptr<MLAlgorithm>& model;
+
+    template<typename... Args>
+    double operator()(const Args&... args)
+    { return cv.EvaluateModel(model, args...); }
+  };
+
+  /**
+   * Run cross-validation with the collected arguments on a fraction of the
+   * training points, and store the trained model in the given pointer.
+   */
+  struct StoreSubsetModel
+  {
+    CVType& cv;
+    std::unique_ptr<MLAlgorithm>& model;
+    double fraction;
+
+    template<typename... Args>
+    double operator()(const Args&... args)
+    { return cv.EvaluateSubset(model, fraction, args...); }
+  };
+
   //! A reference to the cross-validation object.
   CVType& cv;
 
@@ -130,31 +198,41 @@ class CVFunction
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename RunType,
            typename... Args,
            typename = typename
                std::enable_if<(BoundArgIndex + ParamIndex < TotalArgs)>::type>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(const arma::mat& parameters,
+                         RunType& run,
+                         const Args&... args);
 
   /**
-   * Run cross-validation with the collected arguments.
+   * Run cross-validation with the collected arguments, with the given RunType
+   * object (KeepBestModel, StoreModel or StoreSubsetModel).
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename RunType,
            typename... Args,
            typename = typename
                std::enable_if<BoundArgIndex + ParamIndex == TotalArgs>::type,
            typename = void>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Evaluate(const arma::mat& parameters,
+                         RunType& run,
+                         const Args&... args);
 
   /**
    * Put the bound argument (at the BoundArgIndex position) as the next one.
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename RunType,
            typename... Args,
            typename = typename std::enable_if<
                UseBoundArg<BoundArgIndex, ParamIndex>::value>::type>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           RunType& run,
+                           const Args&... args);
 
   /**
    * Put the element (at the ParamIndex position) of the parameters as the next
@@ -162,11 +240,14 @@ class CVFunction
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename RunType,
            typename... Args,
            typename = typename std::enable_if<
                !UseBoundArg<BoundArgIndex, ParamIndex>::value>::type,
            typename = void>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           RunType& run,
+                           const Args&... args);
 };
 
 
@@ -65,7 +65,56 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  KeepBestModel run{*this};
+  return Evaluate<0, 0>(parameters, run);
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+    const arma::mat& parameters,
+    std::unique_ptr<MLAlgorithm>& model)
+{
+  StoreModel run{cv, model};
+  return Evaluate<0, 0>(parameters, run);
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+EvaluateSubset(
+    const arma::mat& parameters,
+    std::unique_ptr<MLAlgorithm>& model,
+    const double fraction)
+{
+  StoreSubsetModel run{cv, model, fraction};
+  return Evaluate<0, 0>(parameters, run);
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+template<typename... Args>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+KeepBestModel::operator()(const Args&... args)
+{
+  double objective = function.cv.Evaluate(args...);
+
+  // Change the best model if we have got a better score, or if we probably
+  // have not assigned any valid (trained) model yet.
+  if (function.bestObjective > objective ||
+      function.bestObjective == std::numeric_limits<double>::max())
+  {
+    function.bestObjective = objective;
+    function.bestModel = std::move(function.cv.Model());
+  }
+
+  return objective;
 }
 
 template<typename CVType,
@@ -95,13 +144,15 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename RunType,
          typename... Args,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters,
+    RunType& run,
     const Args&... args)
 {
-  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, args...);
+  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, run, args...);
 }
 
 template<typename CVType,
@@ -110,25 +161,16 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename RunType,
          typename... Args,
          typename,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& /* parameters */,
+    RunType& run,
     const Args&... args)
 {
-  double objective = cv.Evaluate(args...);
-
-  // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
-  {
-    bestObjective = objective;
-    bestModel = std::move(cv.Model());
-  }
-
-  return objective;
+  return run(args...);
 }
 
 template<typename CVType,
@@ -137,14 +179,16 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename RunType,
          typename... Args,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    RunType& run,
     const Args&... args)
 {
   return Evaluate<BoundArgIndex + 1, ParamIndex>(
-      parameters, args..., std::get<BoundArgIndex>(boundArgs).value);
+      parameters, run, args..., std::get<BoundArgIndex>(boundArgs).value);
 }
 
 template<typename CVType,
@@ -153,21 +197,23 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename RunType,
          typename... Args,
          typename,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    RunType& run,
     const Args&... args)
 {
   if (datasetInfo.Type(ParamIndex) == data::Datatype::categorical)
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
+    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, run, args...,
         datasetInfo.UnmapString(size_t(parameters(ParamIndex, 0)), ParamIndex));
   }
   else
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
+    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, run, args...,
         parameters(ParamIndex, 0));
   }
 }
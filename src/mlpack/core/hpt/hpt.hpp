@@ -14,6 +14,7 @@
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/hpt/deduce_hp_types.hpp>
+#include <mlpack/core/hpt/successive_halving.hpp>
 #include <ensmallen.hpp>
 
 namespace mlpack {
@@ -67,12 +68,26 @@ namespace hpt {
  *     Fixed(useCholesky), lambda1Set, lambda2Set);
  * @endcode
  *
+ * With GridSearch, the candidates of the grid can be assessed in parallel with
+ * OpenMP by setting Parallel() to true.  The cross-validation of each candidate
+ * then trains its models on one thread, with the random number generator of
+ * the thread seeded with a seed drawn for the candidate beforehand, so the
+ * result does not depend on the number of threads.  The CV class must then
+ * provide EvaluateModel(), as SimpleCV and KFoldCV do.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, KFoldCV> hpt3(5, data, responses);
+ * hpt3.Parallel() = true;
+ * std::tie(bestLambda1, bestLambda2) = hpt3.Optimize(Fixed(transposeData),
+ *     Fixed(useCholesky), lambda1Set, lambda2Set);
+ * @endcode
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
  *     hyper-parameters.
- * @tparam OptimizerType An optimization strategy (GridSearch and
- *     GradientDescent are supported).
+ * @tparam OptimizerType An optimization strategy (GridSearch, SuccessiveHalving
+ *     and GradientDescent are supported).
  * @tparam MatType The type of data.
  * @tparam PredictionsType The type of predictions (should be passed when the
  *     predictions type is a template parameter in Train methods of the given
@@ -151,6 +166,13 @@ class HyperParameterTuner
    */
   double& MinDelta() { return minDelta; }
 
+  //! Get whether the candidates of GridSearch or of each round of
+  //! SuccessiveHalving are assessed in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the candidates of GridSearch or of each round of
+  //! SuccessiveHalving are assessed in parallel.
+  bool& Parallel() { return parallel; }
+
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
@@ -230,6 +252,10 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! Whether the candidates of GridSearch or SuccessiveHalving are assessed
+  //! in parallel.
+  bool parallel;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
@@ -324,6 +350,60 @@ class HyperParameterTuner
       data::DatasetMapper<data::IncrementPolicy, double>& datasetInfo,
       FixedArgs... fixedArgs);
 
+  /**
+   * Run the given optimizer on the given CVFunction, and store the best model.
+   * This overload is called for optimizers other than GridSearch and
+   * SuccessiveHalving.
+   */
+  template<typename CVFunctionType, typename AnyOptimizerType>
+  double RunOptimizer(CVFunctionType& cvFunction,
+                      arma::mat& bestParams,
+                      const std::vector<bool>& categoricalDimensions,
+                      const arma::Row<size_t>& numCategories,
+                      AnyOptimizerType& optimizer);
+
+  /**
+   * Run GridSearch on the given CVFunction, and store the best model.  The
+   * candidates are assessed in parallel if Parallel() is true.
+   */
+  template<typename CVFunctionType>
+  double RunOptimizer(CVFunctionType& cvFunction,
+                      arma::mat& bestParams,
+                      const std::vector<bool>& categoricalDimensions,
+                      const arma::Row<size_t>& numCategories,
+                      ens::GridSearch& optimizer);
+
+  /**
+   * Run successive halving on the given CVFunction, and store the best model.
+   * The candidates of each round are assessed in parallel if Parallel() is
+   * true.
+   */
+  template<typename CVFunctionType>
+  double RunOptimizer(CVFunctionType& cvFunction,
+                      arma::mat& bestParams,
+                      const std::vector<bool>& categoricalDimensions,
+                      const arma::Row<size_t>& numCategories,
+                      SuccessiveHalving& optimizer);
+
+  /**
+   * Get the parameters of the given candidate of the grid, in the order
+   * GridSearch visits them (the last dimension varying the fastest).
+   */
+  static arma::mat GridCandidate(const size_t candidate,
+                                 const arma::Row<size_t>& numCategories);
+
+  /**
+   * Assess all the candidates of the grid in parallel, and return the best
+   * objective.  The best candidate is the first one in the order GridSearch
+   * visits them (the last dimension varying the fastest) among those with the
+   * best objective, so the result is the same as that of GridSearch for
+   * algorithms that don't use random numbers.
+   */
+  template<typename CVFunctionType>
+  double ParallelGridSearch(CVFunctionType& cvFunction,
+                            arma::mat& bestParams,
+                            const arma::Row<size_t>& numCategories);
+
   /**
    * Gather all elements of vector in an argument list and use them to create a
    * tuple.
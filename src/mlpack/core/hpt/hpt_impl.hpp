@@ -32,7 +32,7 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...), relativeDelta(0.01), minDelta(1e-10), parallel(false) {}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -104,11 +104,268 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
-  bestObjective = Metric::NeedsMinimization ? optimizer.Optimize(cvFunction,
-      bestParams, categoricalDimensions, numCategories) :
-      -optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
-      numCategories);
-      bestModel = std::move(cvFunction.BestModel());
+  const double objective = RunOptimizer(cvFunction, bestParams,
+      categoricalDimensions, numCategories, optimizer);
+  bestObjective = Metric::NeedsMinimization ? objective : -objective;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType, typename AnyOptimizerType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    AnyOptimizerType& optimizer)
+{
+  const double objective = optimizer.Optimize(cvFunction, bestParams,
+      categoricalDimensions, numCategories);
+  bestModel = std::move(cvFunction.BestModel());
+
+  return objective;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    ens::GridSearch& optimizer)
+{
+  // GridSearch only handles categorical dimensions; leave it to report any
+  // other one.
+  if (!parallel || std::find(categoricalDimensions.begin(),
+      categoricalDimensions.end(), false) != categoricalDimensions.end())
+  {
+    const double objective = optimizer.Optimize(cvFunction, bestParams,
+        categoricalDimensions, numCategories);
+    bestModel = std::move(cvFunction.BestModel());
+
+    return objective;
+  }
+
+  return ParallelGridSearch(cvFunction, bestParams, numCategories);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::RunOptimizer(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    SuccessiveHalving& optimizer)
+{
+  if (std::find(categoricalDimensions.begin(), categoricalDimensions.end(),
+      false) != categoricalDimensions.end())
+  {
+    throw std::invalid_argument("HyperParameterTuner::Optimize(): "
+        "SuccessiveHalving needs a set of values for each hyper-parameter that "
+        "is not fixed");
+  }
+
+  size_t candidates = 1;
+  for (size_t d = 0; d < numCategories.n_elem; ++d)
+    candidates *= numCategories[d];
+
+  // The candidates that are left, in the order of the grid.
+  arma::uvec survivors = arma::regspace<arma::uvec>(0, 1, candidates - 1);
+  double fraction = optimizer.MinFraction();
+  optimizer.Rounds() = 0;
+  optimizer.Cost() = 0.0;
+
+  double bestCandidateObjective = std::numeric_limits<double>::max();
+  size_t bestCandidate = candidates;
+  std::unique_ptr<MLAlgorithm> bestCandidateModel;
+  while (true)
+  {
+    // The last round trains on all the training points, and keeps the model
+    // of the best candidate.
+    const bool last = (fraction >= 1.0 - 1e-10 || survivors.n_elem == 1);
+    if (last)
+      fraction = 1.0;
+
+    // The last seed reseeds the calling thread once the round is done, since
+    // the state of its generator depends on which candidates it assessed.
+    const std::vector<size_t> seeds = math::RandomSeeds(survivors.n_elem + 1);
+    arma::vec objectives(survivors.n_elem);
+
+    #pragma omp parallel for schedule(dynamic) if (parallel)
+    for (omp_size_t s = 0; s < (omp_size_t) survivors.n_elem; ++s)
+    {
+      math::RandomSeed(seeds[s]);
+      std::unique_ptr<MLAlgorithm> model;
+      objectives[s] = cvFunction.EvaluateSubset(
+          GridCandidate(survivors[s], numCategories), model, fraction);
+
+      if (last)
+      {
+        #pragma omp critical(hptSuccessiveHalving)
+        {
+          // Keep the first best candidate in the order of the grid, as
+          // GridSearch does.
+          if (bestCandidate == candidates ||
+              objectives[s] < bestCandidateObjective ||
+              (objectives[s] == bestCandidateObjective &&
+               survivors[s] < bestCandidate))
+          {
+            bestCandidateObjective = objectives[s];
+            bestCandidate = survivors[s];
+            bestCandidateModel = std::move(model);
+          }
+        }
+      }
+    }
+
+    math::RandomSeed(seeds[survivors.n_elem]);
+    ++optimizer.Rounds();
+    optimizer.Cost() += fraction * survivors.n_elem;
+    if (last)
+      break;
+
+    // Keep the best 1 / eta of the candidates (the first ones in the order of
+    // the grid, among equal objectives), in the order of the grid.
+    objectives.replace(arma::datum::nan, arma::datum::inf);
+    const size_t kept = std::max((size_t) 1,
+        (size_t) survivors.n_elem / optimizer.Eta());
+    const arma::uvec order = arma::stable_sort_index(objectives);
+    survivors = arma::sort(survivors.elem(order.head(kept)));
+    fraction = std::min(1.0, fraction * optimizer.Eta());
+  }
+
+  bestParams = GridCandidate(bestCandidate, numCategories);
+  if (bestCandidateModel)
+    bestModel = std::move(*bestCandidateModel);
+
+  return bestCandidateObjective;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+arma::mat HyperParameterTuner<MLAlgorithm,
+                              Metric,
+                              CV,
+                              Optimizer,
+                              MatType,
+                              PredictionsType,
+                              WeightsType>::GridCandidate(
+    const size_t candidate,
+    const arma::Row<size_t>& numCategories)
+{
+  arma::mat parameters(numCategories.n_elem, 1);
+  size_t rest = candidate;
+  for (size_t d = numCategories.n_elem; d > 0; --d)
+  {
+    parameters(d - 1) = rest % numCategories[d - 1];
+    rest /= numCategories[d - 1];
+  }
+
+  return parameters;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         template<typename, typename, typename, typename, typename> class CV,
+         typename Optimizer,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename CVFunctionType>
+double HyperParameterTuner<MLAlgorithm,
+                           Metric,
+                           CV,
+                           Optimizer,
+                           MatType,
+                           PredictionsType,
+                           WeightsType>::ParallelGridSearch(
+    CVFunctionType& cvFunction,
+    arma::mat& bestParams,
+    const arma::Row<size_t>& numCategories)
+{
+  const size_t dimensions = numCategories.n_elem;
+  size_t candidates = 1;
+  for (size_t d = 0; d < dimensions; ++d)
+    candidates *= numCategories[d];
+
+  // The last seed reseeds the calling thread once the grid is done, since the
+  // state of its generator depends on which candidates it assessed.
+  const std::vector<size_t> seeds = math::RandomSeeds(candidates + 1);
+
+  double bestCandidateObjective = std::numeric_limits<double>::max();
+  size_t bestCandidate = candidates;
+  std::unique_ptr<MLAlgorithm> bestCandidateModel;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t c = 0; c < (omp_size_t) candidates; ++c)
+  {
+    const arma::mat parameters = GridCandidate((size_t) c, numCategories);
+
+    math::RandomSeed(seeds[c]);
+    std::unique_ptr<MLAlgorithm> model;
+    const double objective = cvFunction.Evaluate(parameters, model);
+
+    #pragma omp critical(hptParallelGridSearch)
+    {
+      if (bestCandidate == candidates || objective < bestCandidateObjective ||
+          (objective == bestCandidateObjective && (size_t) c < bestCandidate))
+      {
+        bestCandidateObjective = objective;
+        bestCandidate = (size_t) c;
+        bestCandidateModel = std::move(model);
+        bestParams = parameters;
+      }
+    }
+  }
+
+  math::RandomSeed(seeds[candidates]);
+
+  if (bestCandidateModel)
+    bestModel = std::move(*bestCandidateModel);
+
+  return bestCandidateObjective;
 }
 
 template<typename MLAlgorithm,
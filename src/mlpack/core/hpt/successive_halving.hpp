@@ -0,0 +1,122 @@
+/**
+ * @file successive_halving.hpp
+ *
+ * The SuccessiveHalving search strategy for HyperParameterTuner.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace hpt {
+
+/**
+ * Successive halving is a search strategy for HyperParameterTuner that, like
+ * GridSearch, chooses among all the combinations of the given sets of values
+ * of the hyper-parameters (the candidates), but that assesses most candidates
+ * cheaply.  All the candidates are first cross-validated with their models
+ * trained on a small fraction (MinFraction()) of the training points.  Only
+ * the best 1 / Eta() of them are kept, and assessed again with Eta() times as
+ * many training points, and so on, until the training points are all used.
+ * The last candidates are then cross-validated on all the training points, and
+ * the best of them is the result.
+ *
+ * With the default MinFraction() of 1 / 27 and Eta() of 3, the strategy costs
+ * about as much as 1 / 27 + 1 / 27 + 1 / 27 + 1 / 27 of a full cross-validation
+ * of every candidate, that is about 7 times less than GridSearch.  The search
+ * relies on small training sets ranking the candidates about as well as the
+ * full training set does, so the data should be shuffled (KFoldCV shuffles them
+ * by default), and MinFraction() should leave enough points for the models to
+ * be meaningful.
+ *
+ * The CV class used with HyperParameterTuner must provide EvaluateSubset() and
+ * EvaluateModel(), as SimpleCV and KFoldCV do.  If HyperParameterTuner::
+ * Parallel() is true, the candidates of each round are assessed in parallel.
+ *
+ * @code
+ * HyperParameterTuner<LARS, MSE, KFoldCV, SuccessiveHalving> hpt(5, data,
+ *     responses);
+ * hpt.Optimizer().MinFraction() = 0.1;
+ * double bestLambda1, bestLambda2;
+ * std::tie(bestLambda1, bestLambda2) = hpt.Optimize(Fixed(true), Fixed(false),
+ *     lambda1Set, lambda2Set);
+ * @endcode
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Create the SuccessiveHalving object with the given settings.
+   *
+   * @param minFraction Fraction of the training points the first round trains
+   *     on, in (0, 1].
+   * @param eta Ratio between the numbers of candidates of two rounds, and
+   *     between their numbers of training points (at least 2).
+   */
+  SuccessiveHalving(const double minFraction = 1.0 / 27,
+                    const size_t eta = 3) :
+      minFraction(minFraction),
+      eta(eta),
+      rounds(0),
+      cost(0.0)
+  {
+    if (minFraction <= 0.0 || minFraction > 1.0)
+    {
+      std::ostringstream oss;
+      oss << "SuccessiveHalving::SuccessiveHalving(): minFraction ("
+          << minFraction << ") should be in (0, 1]";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (eta < 2)
+    {
+      std::ostringstream oss;
+      oss << "SuccessiveHalving::SuccessiveHalving(): eta (" << eta
+          << ") should be at least 2";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Get the fraction of the training points of the first round.
+  double MinFraction() const { return minFraction; }
+  //! Modify the fraction of the training points of the first round.
+  double& MinFraction() { return minFraction; }
+
+  //! Get the ratio between the numbers of candidates of two rounds.
+  size_t Eta() const { return eta; }
+  //! Modify the ratio between the numbers of candidates of two rounds.
+  size_t& Eta() { return eta; }
+
+  //! Get the number of rounds of the last search.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of rounds of the last search.
+  size_t& Rounds() { return rounds; }
+
+  //! Get the cost of the last search, as the sum of the fractions of the
+  //! training points of all the assessments (so a GridSearch would cost the
+  //! number of candidates).
+  double Cost() const { return cost; }
+  //! Modify the cost of the last search.
+  double& Cost() { return cost; }
+
+ private:
+  //! The fraction of the training points of the first round.
+  double minFraction;
+  //! The ratio between the numbers of candidates of two rounds.
+  size_t eta;
+  //! The number of rounds of the last search.
+  size_t rounds;
+  //! The cost of the last search.
+  double cost;
+};
+
+} // namespace hpt
+} // namespace mlpack
+
+#endif
@@ -68,6 +68,47 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Evaluate the Cauchy kernel between the given point and each of the given
+   * points (one per column), in one vectorized pass over their squared
+   * distances.
+   *
+   * @param point The point.
+   * @param points The points to evaluate the kernel with, one per column.
+   * @param values Vector to store the kernel value of each point in.
+   */
+  template<typename VecType, typename MatType>
+  void Evaluate(const VecType& point,
+                const MatType& points,
+                arma::vec& values) const
+  {
+    values.set_size(points.n_cols);
+    for (size_t j = 0; j < points.n_cols; ++j)
+    {
+      values[j] = metric::SquaredEuclideanDistance::Evaluate(point,
+          points.col(j));
+    }
+
+    EvaluateSquaredDistances(values);
+  }
+
+  /**
+   * Replace each of the given squared distances by the value of the Cauchy
+   * kernel.
+   *
+   * @param values Squared distances, replaced by the kernel values.
+   */
+  template<typename MatType>
+  void EvaluateSquaredDistances(MatType& values) const
+  {
+    values = 1.0 / (1.0 + values / (bandwidth * bandwidth));
+  }
+
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth of the kernel.
+  double& Bandwidth() { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
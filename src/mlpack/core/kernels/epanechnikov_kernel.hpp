@@ -57,6 +57,29 @@ class EpanechnikovKernel
    */
   double Evaluate(const double distance) const;
 
+  /**
+   * Evaluate the Epanechnikov kernel between the given point and each of the
+   * given points (one per column), in one vectorized pass over their squared
+   * distances.
+   *
+   * @param point The point.
+   * @param points The points to evaluate the kernel with, one per column.
+   * @param values Vector to store the kernel value of each point in.
+   */
+  template<typename VecType, typename MatType>
+  void Evaluate(const VecType& point,
+                const MatType& points,
+                arma::vec& values) const;
+
+  /**
+   * Replace each of the given squared distances by the value of the
+   * Epanechnikov kernel.
+   *
+   * @param values Squared distances, replaced by the kernel values.
+   */
+  template<typename MatType>
+  void EvaluateSquaredDistances(MatType& values) const;
+
   /**
    * Evaluate the Gradient of Epanechnikov kernel
    * given that the distance between the two
@@ -89,6 +112,9 @@ class EpanechnikovKernel
    */
   double Normalizer(const size_t dimension);
 
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
@@ -29,6 +29,29 @@ inline double EpanechnikovKernel::Evaluate(const VecTypeA& a, const VecTypeB& b)
       * inverseBandwidthSquared);
 }
 
+template<typename VecType, typename MatType>
+inline void EpanechnikovKernel::Evaluate(const VecType& point,
+                                         const MatType& points,
+                                         arma::vec& values) const
+{
+  values.set_size(points.n_cols);
+  for (size_t j = 0; j < points.n_cols; ++j)
+  {
+    values[j] = metric::SquaredEuclideanDistance::Evaluate(point,
+        points.col(j));
+  }
+
+  EvaluateSquaredDistances(values);
+}
+
+template<typename MatType>
+inline void EpanechnikovKernel::EvaluateSquaredDistances(MatType& values)
+    const
+{
+  for (size_t i = 0; i < values.n_elem; ++i)
+    values[i] = std::max(0.0, 1.0 - values[i] * inverseBandwidthSquared);
+}
+
 /**
  * Obtains the convolution integral [integral of K(||x-a||) K(||b-x||) dx]
  * for the two vectors.
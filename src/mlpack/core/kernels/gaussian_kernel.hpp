@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/math/fast_exp.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -81,6 +82,43 @@ class GaussianKernel
     return exp(gamma * std::pow(t, 2.0));
   }
 
+  /**
+   * Evaluate the Gaussian kernel between the given point and each of the given
+   * points (one per column), in one vectorized pass over their squared
+   * distances.
+   *
+   * @param point The point.
+   * @param points The points to evaluate the kernel with, one per column.
+   * @param values Vector to store the kernel value of each point in.
+   */
+  template<typename VecType, typename MatType>
+  void Evaluate(const VecType& point,
+                const MatType& points,
+                arma::vec& values) const
+  {
+    values.set_size(points.n_cols);
+    for (size_t j = 0; j < points.n_cols; ++j)
+    {
+      values[j] = metric::SquaredEuclideanDistance::Evaluate(point,
+          points.col(j));
+    }
+
+    EvaluateSquaredDistances(values);
+  }
+
+  /**
+   * Replace each of the given squared distances by the value of the Gaussian
+   * kernel, with the vectorized math::FastExp().
+   *
+   * @param values Squared distances, replaced by the kernel values.
+   */
+  template<typename MatType>
+  void EvaluateSquaredDistances(MatType& values) const
+  {
+    values *= gamma;
+    math::FastExp(values);
+  }
+
   /**
    * Evaluation of the gradient of Gaussian kernel
    * given the distance between two points.
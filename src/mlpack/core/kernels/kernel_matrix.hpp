@@ -0,0 +1,199 @@
+/**
+ * @file kernel_matrix.hpp
+ *
+ * Construction of kernel matrices, in tiles computed with matrix products for
+ * the kernels that are functions of inner products or squared distances.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/epanechnikov_kernel.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/hyperbolic_tangent_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+//! The ways a tile of a kernel matrix can be computed.
+enum KernelMatrixTileType
+{
+  //! Evaluate the kernel on each pair of points.
+  EVALUATE_TILES,
+  //! Compute the inner products of the points with a matrix product, then
+  //! transform them into kernel values.
+  INNER_PRODUCT_TILES,
+  //! Compute the squared distances between the points with a matrix product,
+  //! then transform them into kernel values.
+  SQUARED_DISTANCE_TILES
+};
+
+/**
+ * This template class tells KernelMatrix() how tiles of the kernel matrix can be
+ * computed for the given kernel.  By default, the kernel is evaluated on each
+ * pair of points.  A kernel that is a function f(<x, y>) of the inner product
+ * of the points, or a function f(||x - y||^2) of their squared distance, can
+ * specialize this class to have the inner products or squared distances of a
+ * whole tile computed with one matrix product (GEMM):
+ *
+ * @code
+ * template<>
+ * class KernelMatrixRule<MyKernel>
+ * {
+ *  public:
+ *   static const KernelMatrixTileType TileType = INNER_PRODUCT_TILES;
+ *
+ *   // Replace each inner product x in the tile by f(x).
+ *   static void Transform(const MyKernel& kernel, arma::mat& tile);
+ * };
+ * @endcode
+ */
+template<typename KernelType>
+class KernelMatrixRule
+{
+ public:
+  static const KernelMatrixTileType TileType = EVALUATE_TILES;
+};
+
+//! The linear kernel is the inner product itself.
+template<>
+class KernelMatrixRule<LinearKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = INNER_PRODUCT_TILES;
+
+  static void Transform(const LinearKernel& /* kernel */,
+                        arma::mat& /* tile */) { }
+};
+
+//! The polynomial kernel is (<x, y> + offset)^degree.
+template<>
+class KernelMatrixRule<PolynomialKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = INNER_PRODUCT_TILES;
+
+  static void Transform(const PolynomialKernel& kernel, arma::mat& tile)
+  {
+    tile = arma::pow(tile + kernel.Offset(), kernel.Degree());
+  }
+};
+
+//! The hyperbolic tangent kernel is tanh(scale * <x, y> + offset).
+template<>
+class KernelMatrixRule<HyperbolicTangentKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = INNER_PRODUCT_TILES;
+
+  static void Transform(const HyperbolicTangentKernel& kernel, arma::mat& tile)
+  {
+    tile = arma::tanh(kernel.Scale() * tile + kernel.Offset());
+  }
+};
+
+//! The Gaussian kernel is exp(gamma * ||x - y||^2).
+template<>
+class KernelMatrixRule<GaussianKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = SQUARED_DISTANCE_TILES;
+
+  static void Transform(const GaussianKernel& kernel, arma::mat& tile)
+  {
+    kernel.EvaluateSquaredDistances(tile);
+  }
+};
+
+//! The Laplacian kernel is exp(-||x - y|| / bandwidth).
+template<>
+class KernelMatrixRule<LaplacianKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = SQUARED_DISTANCE_TILES;
+
+  static void Transform(const LaplacianKernel& kernel, arma::mat& tile)
+  {
+    kernel.EvaluateSquaredDistances(tile);
+  }
+};
+
+//! The Epanechnikov kernel is max(0, 1 - ||x - y||^2 / bandwidth^2).
+template<>
+class KernelMatrixRule<EpanechnikovKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = SQUARED_DISTANCE_TILES;
+
+  static void Transform(const EpanechnikovKernel& kernel, arma::mat& tile)
+  {
+    kernel.EvaluateSquaredDistances(tile);
+  }
+};
+
+//! The Cauchy kernel is 1 / (1 + ||x - y||^2 / bandwidth^2).
+template<>
+class KernelMatrixRule<CauchyKernel>
+{
+ public:
+  static const KernelMatrixTileType TileType = SQUARED_DISTANCE_TILES;
+
+  static void Transform(const CauchyKernel& kernel, arma::mat& tile)
+  {
+    kernel.EvaluateSquaredDistances(tile);
+  }
+};
+
+/**
+ * Compute the kernel matrix K(i, j) = k(x_i, x_j) of the given points.  The
+ * matrix is computed in square tiles in parallel with OpenMP; since it is
+ * symmetric, only the tiles on and above the diagonal are computed, and each is
+ * copied to its mirror below the diagonal.  For kernels with a KernelMatrixRule
+ * specialization, each tile costs one matrix product and an elementwise
+ * transform instead of one kernel evaluation per entry.
+ *
+ * @param data Points (one per column).
+ * @param kernel Kernel to evaluate.
+ * @param kernelMatrix Matrix to store the kernel matrix in.
+ * @param tileSize Number of rows and columns of each tile.
+ */
+template<typename KernelType>
+void KernelMatrix(const arma::mat& data,
+                  KernelType& kernel,
+                  arma::mat& kernelMatrix,
+                  const size_t tileSize = 256);
+
+/**
+ * Compute the kernel matrix K(i, j) = k(a_i, b_j) between two sets of points.
+ * The matrix is computed in tiles in parallel with OpenMP, as in the symmetric
+ * overload.
+ *
+ * @param a Points for the rows of the matrix (one per column).
+ * @param b Points for the columns of the matrix (one per column).
+ * @param kernel Kernel to evaluate.
+ * @param kernelMatrix Matrix to store the kernel matrix in.
+ * @param tileSize Number of rows and columns of each tile.
+ */
+template<typename KernelType>
+void KernelMatrix(const arma::mat& a,
+                  const arma::mat& b,
+                  KernelType& kernel,
+                  arma::mat& kernelMatrix,
+                  const size_t tileSize = 256);
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_matrix_impl.hpp"
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file kernel_matrix_impl.hpp
+ *
+ * Implementation of the tiled construction of kernel matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_MATRIX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_matrix.hpp"
+
+namespace mlpack {
+namespace kernel {
+namespace details {
+
+/**
+ * Computation of one tile of a kernel matrix, for each KernelMatrixTileType.
+ * The tile holds the kernel values between the points [aBegin, aEnd] of a (its
+ * rows) and the points [bBegin, bEnd] of b (its columns).  If diagonal is true,
+ * a and b are the same points, and only the upper triangle of the tile has to
+ * be right.
+ */
+template<KernelMatrixTileType TileType>
+struct KernelMatrixTile;
+
+template<>
+struct KernelMatrixTile<EVALUATE_TILES>
+{
+  //! Nothing has to be precomputed.
+  static void Norms(const arma::mat& /* points */, arma::vec& /* norms */) { }
+
+  template<typename KernelType>
+  static void Compute(const arma::mat& a,
+                      const arma::mat& b,
+                      const arma::vec& /* aNorms */,
+                      const arma::vec& /* bNorms */,
+                      const size_t aBegin,
+                      const size_t aEnd,
+                      const size_t bBegin,
+                      const size_t bEnd,
+                      const bool diagonal,
+                      KernelType& kernel,
+                      arma::mat& tile)
+  {
+    tile.set_size(aEnd - aBegin + 1, bEnd - bBegin + 1);
+    for (size_t j = 0; j < tile.n_cols; ++j)
+    {
+      const size_t rows = diagonal ? (j + 1) : tile.n_rows;
+      for (size_t i = 0; i < rows; ++i)
+      {
+        tile(i, j) = kernel.Evaluate(a.unsafe_col(aBegin + i),
+                                     b.unsafe_col(bBegin + j));
+      }
+    }
+  }
+};
+
+template<>
+struct KernelMatrixTile<INNER_PRODUCT_TILES>
+{
+  //! Nothing has to be precomputed.
+  static void Norms(const arma::mat& /* points */, arma::vec& /* norms */) { }
+
+  template<typename KernelType>
+  static void Compute(const arma::mat& a,
+                      const arma::mat& b,
+                      const arma::vec& /* aNorms */,
+                      const arma::vec& /* bNorms */,
+                      const size_t aBegin,
+                      const size_t aEnd,
+                      const size_t bBegin,
+                      const size_t bEnd,
+                      const bool /* diagonal */,
+                      KernelType& kernel,
+                      arma::mat& tile)
+  {
+    tile = a.cols(aBegin, aEnd).t() * b.cols(bBegin, bEnd);
+    KernelMatrixRule<KernelType>::Transform(kernel, tile);
+  }
+};
+
+template<>
+struct KernelMatrixTile<SQUARED_DISTANCE_TILES>
+{
+  //! The squared norms of the points are needed for the squared distances.
+  static void Norms(const arma::mat& points, arma::vec& norms)
+  {
+    norms = arma::trans(arma::sum(arma::square(points), 0));
+  }
+
+  template<typename KernelType>
+  static void Compute(const arma::mat& a,
+                      const arma::mat& b,
+                      const arma::vec& aNorms,
+                      const arma::vec& bNorms,
+                      const size_t aBegin,
+                      const size_t aEnd,
+                      const size_t bBegin,
+                      const size_t bEnd,
+                      const bool diagonal,
+                      KernelType& kernel,
+                      arma::mat& tile)
+  {
+    // ||x - y||^2 = ||x||^2 + ||y||^2 - 2 <x, y>.
+    tile = -2.0 * a.cols(aBegin, aEnd).t() * b.cols(bBegin, bEnd);
+    tile.each_col() += aNorms.subvec(aBegin, aEnd);
+    tile.each_row() += bNorms.subvec(bBegin, bEnd).t();
+
+    // Cancellation can make the distances of close points slightly negative.
+    tile.transform([](double x) { return std::max(x, 0.0); });
+    if (diagonal)
+      tile.diag().zeros();
+
+    KernelMatrixRule<KernelType>::Transform(kernel, tile);
+  }
+};
+
+} // namespace details
+
+template<typename KernelType>
+void KernelMatrix(const arma::mat& data,
+                  KernelType& kernel,
+                  arma::mat& kernelMatrix,
+                  const size_t tileSize)
+{
+  typedef details::KernelMatrixTile<KernelMatrixRule<KernelType>::TileType>
+      TileRule;
+
+  const size_t n = data.n_cols;
+  const size_t step = std::max(tileSize, (size_t) 1);
+  const size_t numTiles = (n + step - 1) / step;
+
+  kernelMatrix.set_size(n, n);
+  arma::vec norms;
+  TileRule::Norms(data, norms);
+
+  // Only the tiles on and above the diagonal are computed.
+  std::vector<std::pair<size_t, size_t>> tiles;
+  tiles.reserve(numTiles * (numTiles + 1) / 2);
+  for (size_t i = 0; i < numTiles; ++i)
+    for (size_t j = i; j < numTiles; ++j)
+      tiles.push_back(std::make_pair(i, j));
+
+  #pragma omp parallel
+  {
+    arma::mat tile;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) tiles.size(); ++t)
+    {
+      const size_t rowBegin = tiles[t].first * step;
+      const size_t rowEnd = std::min(rowBegin + step, n) - 1;
+      const size_t colBegin = tiles[t].second * step;
+      const size_t colEnd = std::min(colBegin + step, n) - 1;
+      const bool diagonal = (rowBegin == colBegin);
+
+      TileRule::Compute(data, data, norms, norms, rowBegin, rowEnd, colBegin,
+          colEnd, diagonal, kernel, tile);
+
+      if (diagonal)
+      {
+        // Make the tile exactly symmetric.
+        kernelMatrix.submat(rowBegin, colBegin, rowEnd, colEnd) =
+            arma::symmatu(tile);
+      }
+      else
+      {
+        kernelMatrix.submat(rowBegin, colBegin, rowEnd, colEnd) = tile;
+        kernelMatrix.submat(colBegin, rowBegin, colEnd, rowEnd) = tile.t();
+      }
+    }
+  }
+}
+
+template<typename KernelType>
+void KernelMatrix(const arma::mat& a,
+                  const arma::mat& b,
+                  KernelType& kernel,
+                  arma::mat& kernelMatrix,
+                  const size_t tileSize)
+{
+  typedef details::KernelMatrixTile<KernelMatrixRule<KernelType>::TileType>
+      TileRule;
+
+  if (a.n_rows != b.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KernelMatrix(): the points have dimensionalities " << a.n_rows
+        << " and " << b.n_rows << ", which must be equal.";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t step = std::max(tileSize, (size_t) 1);
+  const size_t rowTiles = (a.n_cols + step - 1) / step;
+  const size_t colTiles = (b.n_cols + step - 1) / step;
+
+  kernelMatrix.set_size(a.n_cols, b.n_cols);
+  arma::vec aNorms, bNorms;
+  TileRule::Norms(a, aNorms);
+  TileRule::Norms(b, bNorms);
+
+  #pragma omp parallel
+  {
+    arma::mat tile;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t t = 0; t < (omp_size_t) (rowTiles * colTiles); ++t)
+    {
+      const size_t rowBegin = (t % rowTiles) * step;
+      const size_t rowEnd = std::min(rowBegin + step, (size_t) a.n_cols) - 1;
+      const size_t colBegin = (t / rowTiles) * step;
+      const size_t colEnd = std::min(colBegin + step, (size_t) b.n_cols) - 1;
+
+      TileRule::Compute(a, b, aNorms, bNorms, rowBegin, rowEnd, colBegin,
+          colEnd, false, kernel, tile);
+      kernelMatrix.submat(rowBegin, colBegin, rowEnd, colEnd) = tile;
+    }
+  }
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,8 @@
 #define MLPACK_CORE_KERNELS_LAPLACIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/math/fast_exp.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -78,6 +80,43 @@ class LaplacianKernel
     return exp(-t / bandwidth);
   }
 
+  /**
+   * Evaluate the Laplacian kernel between the given point and each of the given
+   * points (one per column), in one vectorized pass over their squared
+   * distances.
+   *
+   * @param point The point.
+   * @param points The points to evaluate the kernel with, one per column.
+   * @param values Vector to store the kernel value of each point in.
+   */
+  template<typename VecType, typename MatType>
+  void Evaluate(const VecType& point,
+                const MatType& points,
+                arma::vec& values) const
+  {
+    values.set_size(points.n_cols);
+    for (size_t j = 0; j < points.n_cols; ++j)
+    {
+      values[j] = metric::SquaredEuclideanDistance::Evaluate(point,
+          points.col(j));
+    }
+
+    EvaluateSquaredDistances(values);
+  }
+
+  /**
+   * Replace each of the given squared distances by the value of the Laplacian
+   * kernel, with the vectorized math::FastExp().
+   *
+   * @param values Squared distances, replaced by the kernel values.
+   */
+  template<typename MatType>
+  void EvaluateSquaredDistances(MatType& values) const
+  {
+    values = arma::sqrt(values) / -bandwidth;
+    math::FastExp(values);
+  }
+
   /**
    * Evaluation of the gradient of the Laplacian kernel
    * given the distance between two points.
@@ -19,6 +19,12 @@ using namespace std;
 using namespace mlpack;
 using namespace mlpack::kernel;
 
+//! Get the code of a lowercase alphanumeric character, in [0, 36).
+static inline uint64_t SymbolCode(const char c)
+{
+  return isdigit(c) ? uint64_t(c - '0') : uint64_t(tolower(c) - 'a') + 10;
+}
+
 /**
  * Initialize the PSpectrumStringKernel with the given string datasets.  For
  * more information on this, see the general class documentation.
@@ -38,6 +44,7 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
 
   // Resize for number of datasets.
   counts.resize(datasets.size());
+  spectra.resize(datasets.size());
 
   for (size_t dataset = 0; dataset < datasets.size(); ++dataset)
   {
@@ -45,9 +52,11 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
 
     // Resize for number of strings in dataset.
     counts[dataset].resize(set.size());
+    spectra[dataset].resize(set.size());
 
     // Inspect each string in the dataset.
-    for (size_t index = 0; index < set.size(); ++index)
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t index = 0; index < (omp_size_t) set.size(); ++index)
     {
       // Convenience references.
       const std::string& str = set[index];
@@ -80,8 +89,65 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
           ++mapping[sub];
         }
       }
+
+      BuildSpectrum(str, spectra[dataset][index]);
     }
   }
 
   Log::Info << "Substring extraction complete." << std::endl;
 }
+
+void PSpectrumStringKernel::BuildSpectrum(const std::string& str,
+                                          Spectrum& spectrum) const
+{
+  // Up to 12 characters, the base 36 code of a substring fits in 64 bits, so
+  // no two substrings share a code.  Above that, a polynomial hash modulo 2^64
+  // with an odd base is used.
+  const uint64_t base = (p <= 12) ? 36 : 1099511628211ULL;
+  uint64_t top = 1; // base^(p - 1), to remove the oldest character.
+  for (size_t j = 1; j < p; ++j)
+    top *= base;
+
+  std::vector<uint64_t> codes;
+  if (p == 0)
+  {
+    // Every position holds the empty substring.
+    codes.assign(str.length() + 1, 0);
+  }
+  else if (str.length() >= p)
+  {
+    codes.reserve(str.length() - p + 1);
+
+    // Roll the code of the last p characters along the string; the window is
+    // started again after each character that is not alphanumeric.
+    uint64_t code = 0;
+    size_t run = 0;
+    for (size_t i = 0; i < str.length(); ++i)
+    {
+      if (!isalnum(str[i]))
+      {
+        code = 0;
+        run = 0;
+        continue;
+      }
+
+      if (run >= p)
+        code -= SymbolCode(str[i - p]) * top;
+      code = code * base + SymbolCode(str[i]);
+
+      if (++run >= p)
+        codes.push_back(code);
+    }
+  }
+
+  // Sort the codes, and count the runs of equal codes.
+  std::sort(codes.begin(), codes.end());
+  spectrum.clear();
+  for (size_t i = 0; i < codes.size(); ++i)
+  {
+    if (!spectrum.empty() && spectrum.back().first == codes[i])
+      ++spectrum.back().second;
+    else
+      spectrum.push_back(std::make_pair(codes[i], (size_t) 1));
+  }
+}
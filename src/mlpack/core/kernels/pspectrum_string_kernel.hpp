@@ -19,6 +19,7 @@
 #include <map>
 #include <string>
 #include <vector>
+#include <cstdint>
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/log.hpp>
@@ -61,6 +62,15 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * At construction time, each substring of length p is also encoded as a 64-bit
+ * integer with a rolling hash, and each string is stored as a sorted array of
+ * (code, count) pairs, its spectrum.  Evaluate() merges two spectra, which only
+ * compares integers; EvaluateRow() computes a whole row of the kernel matrix at
+ * once, in parallel.  For p <= 12 the code of a substring is exact (a base-36
+ * number over the lowercase alphanumerics); for longer substrings it is a
+ * polynomial hash, and two different substrings are counted as the same one
+ * with a probability of about 2^-64.
  */
 class PSpectrumStringKernel
 {
@@ -89,13 +99,41 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
-  //! Access the lists of substrings.
+  /**
+   * Evaluate the kernel between one string and each string of a fake data
+   * matrix, that is, one row of the kernel matrix.  The columns are split
+   * between the OpenMP threads.
+   *
+   * @param a Index of dataset and string for the first string.
+   * @param b Fake data matrix, with the indices of dataset and string of one
+   *     string in each column.
+   * @param results Kernel values of a with each column of b.
+   */
+  template<typename VecType, typename MatType>
+  void EvaluateRow(const VecType& a,
+                   const MatType& b,
+                   arma::rowvec& results) const;
+
+  //! A spectrum: the sorted codes of the substrings of a string, with counts.
+  typedef std::vector<std::pair<uint64_t, size_t> > Spectrum;
+
+  /**
+   * Merge two spectra, and return the sum of the products of the counts of the
+   * codes they share.
+   */
+  static double Merge(const Spectrum& a, const Spectrum& b);
+
+  //! Access the lists of substrings.  Evaluate() uses Spectra() instead.
   const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
   { return counts; }
-  //! Modify the lists of substrings.
+  //! Modify the lists of substrings.  Evaluate() uses Spectra() instead.
   std::vector<std::vector<std::map<std::string, int> > >& Counts()
   { return counts; }
 
+  //! Access the spectra of the strings.
+  const std::vector<std::vector<Spectrum> >& Spectra() const
+  { return spectra; }
+
   //! Access the value of p.
   size_t P() const { return p; }
   //! Modify the value of p.
@@ -106,8 +144,14 @@ class PSpectrumStringKernel
   //! is not wonderful...
   std::vector<std::vector<std::map<std::string, int> > > counts;
 
+  //! The spectra of the strings of the datasets.
+  std::vector<std::vector<Spectrum> > spectra;
+
   //! The value of p to use in calculation.
   size_t p;
+
+  //! Find the spectrum of the given string.
+  void BuildSpectrum(const std::string& str, Spectrum& spectrum) const;
 };
 
 } // namespace kernel
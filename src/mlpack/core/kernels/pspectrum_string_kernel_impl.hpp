@@ -36,44 +36,55 @@ template<typename VecType>
 double PSpectrumStringKernel::Evaluate(const VecType& a,
                                        const VecType& b) const
 {
-  // Get the map of substrings for the two strings we are interested in.
-  const std::map<std::string, int>& aMap = counts[a[0]][a[1]];
-  const std::map<std::string, int>& bMap = counts[b[0]][b[1]];
-
-  double eval = 0;
+  return Merge(spectra[a[0]][a[1]], spectra[b[0]][b[1]]);
+}
 
-  // Loop through the two maps (which, when iterated through, are sorted
-  // alphabetically).
-  std::map<std::string, int>::const_iterator aIt = aMap.begin();
-  std::map<std::string, int>::const_iterator bIt = bMap.begin();
+template<typename VecType, typename MatType>
+void PSpectrumStringKernel::EvaluateRow(const VecType& a,
+                                        const MatType& b,
+                                        arma::rowvec& results) const
+{
+  const Spectrum& aSpectrum = spectra[a[0]][a[1]];
+  results.set_size(b.n_cols);
 
-  while ((aIt != aMap.end()) && (bIt != bMap.end()))
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) b.n_cols; ++i)
   {
-    // Compare alphabetically (this is how std::map is ordered).
-    int result = (*aIt).first.compare((*bIt).first);
+    results[i] = Merge(aSpectrum,
+        spectra[(size_t) b(0, i)][(size_t) b(1, i)]);
+  }
+}
 
-    if (result == 0) // The same substring.
-    {
-      eval += ((*aIt).second * (*bIt).second);
+inline double PSpectrumStringKernel::Merge(const Spectrum& a,
+                                           const Spectrum& b)
+{
+  double eval = 0;
 
-      // Now increment both.
+  // Both spectra are sorted by code, so one pass through each finds all the
+  // shared substrings.
+  Spectrum::const_iterator aIt = a.begin();
+  Spectrum::const_iterator bIt = b.begin();
+  while ((aIt != a.end()) && (bIt != b.end()))
+  {
+    if (aIt->first == bIt->first) // The same substring.
+    {
+      eval += double(aIt->second * bIt->second);
       ++aIt;
       ++bIt;
     }
-    else if (result > 0)
+    else if (aIt->first > bIt->first)
     {
-      // aIt is "ahead" of bIt (alphabetically); so increment bIt to "catch up".
       ++bIt;
     }
     else
     {
-      // bIt is "ahead" of aIt (alphabetically); so increment aIt to "catch up".
       ++aIt;
     }
   }
 
   return eval;
 }
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -42,10 +42,30 @@ void mlpack::math::VectorPower(arma::vec& vec, const double power)
  */
 void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
 {
+  if (&x == &xCentered)
+  {
+    Center(xCentered);
+    return;
+  }
+
   // Get the mean of the elements in each row.
   arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
 
-  xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
+  xCentered = x.each_col() - rowMean;
+}
+
+/**
+ * Centers the given matrix in place, by subtracting the mean of the columns
+ * from each column of the matrix.
+ *
+ * @param x Matrix to center.
+ */
+void mlpack::math::Center(arma::mat& x)
+{
+  // Get the mean of the elements in each row.
+  const arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+
+  x.each_col() -= rowMean;
 }
 
 /**
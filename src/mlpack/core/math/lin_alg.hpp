@@ -36,6 +36,15 @@ void VectorPower(arma::vec& vec, const double power);
  */
 void Center(const arma::mat& x, arma::mat& xCentered);
 
+/**
+ * Centers the given matrix in place, by subtracting the mean of the columns (a
+ * column vector) from each column of the matrix.  No copy of the matrix is
+ * made.
+ *
+ * @param x Matrix to center.
+ */
+void Center(arma::mat& x);
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
@@ -8,18 +8,42 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
-#include <random>
-#include <mlpack/mlpack_export.hpp>
+#include "random.hpp"
+
+#include <mutex>
 
 namespace mlpack {
 namespace math {
 
+#ifndef _MSC_VER
+/**
+ * Get the initial random number generator of the next thread to use one: the
+ * first thread gets a generator with the default seed, and each other thread
+ * gets the generator of the previous thread advanced by 2^128 numbers.
+ */
+static RandomEngine NextThreadEngine()
+{
+  static std::mutex mutex;
+  static RandomEngine next;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  RandomEngine engine = next;
+  next.Jump();
+  return engine;
+}
+
+// Global random object.
+MLPACK_EXPORT thread_local RandomEngine randGen(NextThreadEngine());
+#else
 // Global random object.
-MLPACK_EXPORT std::mt19937 randGen;
+MLPACK_EXPORT RandomEngine randGen;
+#endif
 // Global uniform distribution.
-MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
+MLPACK_EXPORT MLPACK_RANDOM_THREAD_LOCAL
+    std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
-MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+MLPACK_EXPORT MLPACK_RANDOM_THREAD_LOCAL
+    std::normal_distribution<> randNormalDist(0.0, 1.0);
 
 } // namespace math
 } // namespace mlpack
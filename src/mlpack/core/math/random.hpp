@@ -13,6 +13,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/mlpack_export.hpp>
+#include <mlpack/core/math/xoshiro256.hpp>
 #include <random>
 
 namespace mlpack {
@@ -21,26 +22,44 @@ namespace math /** Miscellaneous math routines. */ {
 /**
  * MLPACK_EXPORT is required for global variables; it exports the symbols
  * correctly on Windows.
+ *
+ * Each thread has its own random number generator (and distributions), so that
+ * tasks running in parallel can draw random numbers, and seed the generator of
+ * their thread with RandomSeed(), without a data race.  The generator of the
+ * first thread that uses it has the default seed; the generator of each other
+ * thread starts 2^128 numbers after the one of the previous thread (see
+ * Xoshiro256StarStar::Jump()), so the threads draw independent streams.  MSVC
+ * can't export thread-local variables from a DLL, so there the generator is
+ * shared by all the threads.
  */
+#ifdef _MSC_VER
+  #define MLPACK_RANDOM_THREAD_LOCAL
+#else
+  #define MLPACK_RANDOM_THREAD_LOCAL thread_local
+#endif
+
+//! The type of the random number generators.
+typedef Xoshiro256StarStar RandomEngine;
 
 // Global random object.
-extern MLPACK_EXPORT std::mt19937 randGen;
+extern MLPACK_EXPORT MLPACK_RANDOM_THREAD_LOCAL RandomEngine randGen;
 // Global uniform distribution.
-extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
+extern MLPACK_EXPORT MLPACK_RANDOM_THREAD_LOCAL
+    std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
-extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+extern MLPACK_EXPORT MLPACK_RANDOM_THREAD_LOCAL
+    std::normal_distribution<> randNormalDist;
 
 /**
- * Set the random seed used by the random functions (Random() and RandInt()).
- * The seed is casted to a 32-bit integer before being given to the random
- * number generator, but a size_t is taken as a parameter for API consistency.
+ * Set the random seed used by the random functions (Random() and RandInt()) of
+ * the calling thread, and the seeds of rand() and of Armadillo.
  *
  * @param seed Seed for the random number generator.
  */
 inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
-    randGen.seed((uint32_t) seed);
+    randGen.seed((uint64_t) seed);
     srand((unsigned int) seed);
     arma::arma_rng::set_seed(seed);
   #else
@@ -59,18 +78,84 @@ inline void RandomSeed(const size_t seed)
 inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
-  randGen.seed((uint32_t) seed);
+  randGen.seed((uint64_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
 }
 #endif
 
+/**
+ * Draw the given number of seeds from the random number generator of the
+ * calling thread.  Tasks that run in parallel can each call RandomSeed() with
+ * their own seed, so that their results don't depend on the number of threads
+ * or on the order the tasks are run in.
+ *
+ * @param n Number of seeds to draw.
+ */
+inline std::vector<size_t> RandomSeeds(const size_t n)
+{
+  std::vector<size_t> seeds(n);
+  for (size_t i = 0; i < n; ++i)
+    seeds[i] = (size_t) randGen();
+
+  return seeds;
+}
+
+/**
+ * Give the given number of independent random number generators, for tasks
+ * that run in parallel: each task can assign its generator to randGen (or use
+ * it directly), so that its results don't depend on the number of threads or
+ * on the order the tasks are run in.  Unlike RandomSeeds(), the streams of the
+ * generators provably don't overlap: the first generator is seeded from the
+ * generator of the calling thread, and each other one starts 2^128 numbers
+ * after the previous one.  This doesn't seed rand() or Armadillo.  The calling
+ * thread runs some of the tasks, so it should restore its own generator
+ * afterwards.
+ *
+ * @code
+ * std::vector<math::RandomEngine> streams = math::RandomStreams(n);
+ * const math::RandomEngine engine = math::randGen;
+ * #pragma omp parallel for
+ * for (omp_size_t i = 0; i < n; ++i)
+ * {
+ *   math::randGen = streams[i];
+ *   // ... math::Random(), math::RandomFill() ...
+ * }
+ * math::randGen = engine;
+ * @endcode
+ *
+ * @param n Number of generators.
+ */
+inline std::vector<RandomEngine> RandomStreams(const size_t n)
+{
+  std::vector<RandomEngine> streams;
+  streams.reserve(n);
+
+  RandomEngine stream(randGen());
+  for (size_t i = 0; i < n; ++i)
+  {
+    streams.push_back(stream);
+    stream.Jump();
+  }
+
+  return streams;
+}
+
+/**
+ * Convert the given random 64-bit number to a uniform random number in [0, 1),
+ * from its 53 high bits.
+ */
+inline double UniformFromBits(const uint64_t bits)
+{
+  return (bits >> 11) * (1.0 / 9007199254740992.0);
+}
+
 /**
  * Generates a uniform random number between 0 and 1.
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  return UniformFromBits(randGen());
 }
 
 /**
@@ -78,7 +163,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * UniformFromBits(randGen());
 }
 
 /**
@@ -97,7 +182,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * UniformFromBits(randGen()));
 }
 
 /**
@@ -106,7 +191,7 @@ inline int RandInt(const int hiExclusive)
 inline int RandInt(const int lo, const int hiExclusive)
 {
   return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+                               * UniformFromBits(randGen()));
 }
 
 /**
@@ -129,6 +214,65 @@ inline double RandNormal(const double mean, const double variance)
   return variance * randNormalDist(randGen) + mean;
 }
 
+/**
+ * Fill the given matrix (or vector) with uniform random numbers in the
+ * specified range.  This draws the same numbers as calls to Random(lo, hi)
+ * would, but looks up the generator of the thread only once.
+ *
+ * @param x Matrix to fill.
+ * @param lo Lower bound of the numbers (inclusive).
+ * @param hi Upper bound of the numbers (exclusive).
+ */
+template<typename eT>
+inline void RandomFill(arma::Mat<eT>& x,
+                       const double lo = 0.0,
+                       const double hi = 1.0)
+{
+  RandomEngine& engine = randGen;
+  eT* memory = x.memptr();
+  for (size_t i = 0; i < x.n_elem; ++i)
+    memory[i] = (eT) (lo + (hi - lo) * UniformFromBits(engine()));
+}
+
+/**
+ * Fill the given matrix (or vector) with uniform random integers in the
+ * specified range, as calls to RandInt(lo, hiExclusive) would.
+ *
+ * @param x Matrix to fill.
+ * @param lo Lower bound of the integers (inclusive).
+ * @param hiExclusive Upper bound of the integers (exclusive).
+ */
+template<typename eT>
+inline void RandIntFill(arma::Mat<eT>& x, const int lo, const int hiExclusive)
+{
+  RandomEngine& engine = randGen;
+  const double range = (double) (hiExclusive - lo);
+  eT* memory = x.memptr();
+  for (size_t i = 0; i < x.n_elem; ++i)
+    memory[i] = (eT) (lo + (int) std::floor(range * UniformFromBits(engine())));
+}
+
+/**
+ * Fill the given matrix (or vector) with normally distributed random numbers
+ * with the specified mean and variance, as calls to RandNormal(mean, variance)
+ * would.
+ *
+ * @param x Matrix to fill.
+ * @param mean Mean of distribution.
+ * @param variance Variance of distribution.
+ */
+template<typename eT>
+inline void RandNormalFill(arma::Mat<eT>& x,
+                           const double mean = 0.0,
+                           const double variance = 1.0)
+{
+  RandomEngine& engine = randGen;
+  std::normal_distribution<>& dist = randNormalDist;
+  eT* memory = x.memptr();
+  for (size_t i = 0; i < x.n_elem; ++i)
+    memory[i] = (eT) (variance * dist(engine) + mean);
+}
+
 /**
  * Obtains no more than maxNumSamples distinct samples. Each sample belongs to
  * [loInclusive, hiExclusive).
@@ -17,12 +17,107 @@
 namespace mlpack {
 namespace math {
 
+/**
+ * Return a random ordering of the given number of points, for consumers that
+ * visit the points in a shuffled order instead of moving them.  Point i of the
+ * shuffled order is point ordering[i], as in PermuteColumns() and
+ * GatherColumns().
+ *
+ * @param n Number of points.
+ */
+inline arma::uvec ShuffledOrdering(const size_t n)
+{
+  if (n == 0)
+    return arma::uvec();
+
+  return arma::shuffle(arma::linspace<arma::uvec>(0, n - 1, n));
+}
+
+/**
+ * Reorder the columns of the given dense matrix in place, so that column i
+ * becomes the former column ordering[i].  Each cycle of the permutation is
+ * followed with a buffer of one column, so no copy of the matrix is made.
+ *
+ * @param data Matrix to reorder.
+ * @param ordering Permutation of the columns.
+ */
+template<typename MatType>
+void PermuteColumns(MatType& data, const arma::uvec& ordering)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t n = data.n_cols;
+  const size_t rows = data.n_rows;
+  std::vector<bool> visited(n, false);
+  arma::Col<ElemType> buffer(rows);
+
+  for (size_t start = 0; start < n; ++start)
+  {
+    if (visited[start] || ordering[start] == start)
+      continue;
+
+    std::copy(data.colptr(start), data.colptr(start) + rows, buffer.memptr());
+    size_t i = start;
+    while (ordering[i] != start)
+    {
+      const size_t j = ordering[i];
+      std::copy(data.colptr(j), data.colptr(j) + rows, data.colptr(i));
+      visited[i] = true;
+      i = j;
+    }
+    std::copy(buffer.memptr(), buffer.memptr() + rows, data.colptr(i));
+    visited[i] = true;
+  }
+}
+
+/**
+ * Copy the columns of the given dense matrix in the given order, so that
+ * column i of the output is column ordering[i] of the input.  The columns are
+ * copied in parallel.  The input and the output must be different objects.
+ *
+ * @param input Matrix to copy.
+ * @param ordering Permutation of the columns.
+ * @param output Matrix to store the reordered columns in.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& ordering,
+                   MatType& output)
+{
+  const size_t rows = input.n_rows;
+  output.set_size(rows, input.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+  {
+    std::copy(input.colptr(ordering[i]), input.colptr(ordering[i]) + rows,
+        output.colptr(i));
+  }
+}
+
+/**
+ * Reorder the columns of the given dense matrix into the output: in place when
+ * the input and the output are the same object, with a parallel copy
+ * otherwise.
+ */
+template<typename MatType>
+void ReorderColumns(const MatType& input,
+                    const arma::uvec& ordering,
+                    MatType& output)
+{
+  if (&input == &output)
+    PermuteColumns(output, ordering);
+  else
+    GatherColumns(input, ordering, output);
+}
+
 /**
  * Shuffle a dataset and associated labels (or responses).  It is expected that
  * inputPoints and inputLabels have the same number of columns (so, be sure that
  * inputLabels, if it is a vector, is a row vector).
  *
- * Shuffled data will be output into outputPoints and outputLabels.
+ * Shuffled data will be output into outputPoints and outputLabels.  When the
+ * input and the output are the same object, the columns are permuted in place.
  */
 template<typename MatType, typename LabelsType>
 void ShuffleData(const MatType& inputPoints,
@@ -33,11 +128,10 @@ void ShuffleData(const MatType& inputPoints,
                  const std::enable_if_t<!arma::is_Cube<MatType>::value>* = 0)
 {
   // Generate ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      inputPoints.n_cols - 1, inputPoints.n_cols));
+  const arma::uvec ordering = ShuffledOrdering(inputPoints.n_cols);
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
+  ReorderColumns(inputPoints, ordering, outputPoints);
+  ReorderColumns(inputLabels, ordering, outputLabels);
 }
 
 /**
@@ -154,7 +248,8 @@ void ShuffleData(const MatType& inputPoints,
  * vector).
  *
  * Shuffled data will be output into outputPoints and outputLabels and
- * outputWeights.
+ * outputWeights.  When the input and the output are the same object, the
+ * columns are permuted in place.
  */
 template<typename MatType, typename LabelsType, typename WeightsType>
 void ShuffleData(const MatType& inputPoints,
@@ -167,12 +262,11 @@ void ShuffleData(const MatType& inputPoints,
                  const std::enable_if_t<!arma::is_Cube<MatType>::value>* = 0)
 {
   // Generate ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      inputPoints.n_cols - 1, inputPoints.n_cols));
+  const arma::uvec ordering = ShuffledOrdering(inputPoints.n_cols);
 
-  outputPoints = inputPoints.cols(ordering);
-  outputLabels = inputLabels.cols(ordering);
-  outputWeights = inputWeights.cols(ordering);
+  ReorderColumns(inputPoints, ordering, outputPoints);
+  ReorderColumns(inputLabels, ordering, outputLabels);
+  ReorderColumns(inputWeights, ordering, outputWeights);
 }
 
 /**
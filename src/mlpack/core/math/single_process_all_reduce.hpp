@@ -0,0 +1,56 @@
+/**
+ * @file single_process_all_reduce.hpp
+ *
+ * The default all-reduce policy of the distributed algorithms, for a single
+ * process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_SINGLE_PROCESS_ALL_REDUCE_HPP
+#define MLPACK_CORE_MATH_SINGLE_PROCESS_ALL_REDUCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * An all-reduce policy combines the statistics that each process (or rank)
+ * computes on its partition of the data.  The distributed algorithms, such as
+ * kmeans::DistributedKMeans and gmm::DistributedEMFit, call
+ *
+ * @code
+ * void Sum(arma::vec& values);
+ * @endcode
+ *
+ * at the same points on every process, with vectors of the same size; Sum()
+ * must replace the values with their elementwise sum over all the processes.
+ * This policy is for a single process holding all of the data, so it does
+ * nothing.  mlpack doesn't depend on MPI, but an MPI policy is just
+ *
+ * @code
+ * class MPIAllReduce
+ * {
+ *  public:
+ *   void Sum(arma::vec& values)
+ *   {
+ *     MPI_Allreduce(MPI_IN_PLACE, values.memptr(), (int) values.n_elem,
+ *         MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+ *   }
+ * };
+ * @endcode
+ */
+class SingleProcessAllReduce
+{
+ public:
+  //! Sum the values over all the processes; there is only this one.
+  void Sum(arma::vec& /* values */) { }
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file xoshiro256.hpp
+ *
+ * The xoshiro256** random number generator, which is used as the random number
+ * generator of each thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_XOSHIRO256_HPP
+#define MLPACK_CORE_MATH_XOSHIRO256_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The xoshiro256** generator of Blackman and Vigna, a small and fast generator
+ * of 64-bit numbers with a period of 2^256 - 1.  It satisfies the requirements
+ * of a UniformRandomBitGenerator, so it can be used with std::shuffle() and
+ * the distributions of <random>.
+ *
+ * Jump() advances the generator by 2^128 numbers, so that the generators given
+ * by 0, 1, 2, ... jumps from the same state draw non-overlapping sequences of
+ * numbers; this is how independent streams are given to threads and to tasks
+ * that run in parallel (see RandomStreams()).
+ *
+ * @code
+ * @article{blackman2021scrambled,
+ *   title = {Scrambled Linear Pseudorandom Number Generators},
+ *   author = {Blackman, David and Vigna, Sebastiano},
+ *   journal = {ACM Transactions on Mathematical Software},
+ *   volume = {47},
+ *   number = {4},
+ *   pages = {1--32},
+ *   year = {2021}
+ * }
+ * @endcode
+ */
+class Xoshiro256StarStar
+{
+ public:
+  //! The type of the generated numbers.
+  typedef uint64_t result_type;
+
+  //! The seed of default-constructed generators.
+  static constexpr result_type default_seed = 5489u;
+
+  /**
+   * Create the generator with the given seed.
+   *
+   * @param seed Seed of the generator.
+   */
+  explicit Xoshiro256StarStar(const result_type seed = default_seed)
+  {
+    this->seed(seed);
+  }
+
+  /**
+   * Set the state of the generator from the given seed.  The four words of
+   * the state are drawn from a splitmix64 generator with the seed, so that
+   * close seeds give unrelated states (and the state is never all zeros).
+   *
+   * @param seed Seed of the generator.
+   */
+  void seed(result_type seed)
+  {
+    for (size_t i = 0; i < 4; ++i)
+    {
+      seed += 0x9e3779b97f4a7c15ULL;
+      uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+      state[i] = z ^ (z >> 31);
+    }
+  }
+
+  //! Get the next random number.
+  result_type operator()()
+  {
+    const uint64_t result = Rotate(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = Rotate(state[3], 45);
+
+    return result;
+  }
+
+  //! Skip the given number of random numbers.
+  void discard(unsigned long long n)
+  {
+    for (; n != 0; --n)
+      (*this)();
+  }
+
+  /**
+   * Advance the generator by 2^128 random numbers, which is as if operator()
+   * had been called 2^128 times.
+   */
+  void Jump()
+  {
+    static const uint64_t jump[] = { 0x180ec6d33cfd0abaULL,
+        0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < 4; ++i)
+    {
+      for (size_t b = 0; b < 64; ++b)
+      {
+        if (jump[i] & (uint64_t(1) << b))
+        {
+          s[0] ^= state[0];
+          s[1] ^= state[1];
+          s[2] ^= state[2];
+          s[3] ^= state[3];
+        }
+        (*this)();
+      }
+    }
+
+    for (size_t i = 0; i < 4; ++i)
+      state[i] = s[i];
+  }
+
+  //! Get the smallest number the generator returns.
+  static constexpr result_type min() { return 0; }
+  //! Get the largest number the generator returns.
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  //! Get whether two generators will draw the same numbers.
+  bool operator==(const Xoshiro256StarStar& other) const
+  {
+    return state[0] == other.state[0] && state[1] == other.state[1] &&
+        state[2] == other.state[2] && state[3] == other.state[3];
+  }
+
+  //! Get whether two generators will draw different numbers.
+  bool operator!=(const Xoshiro256StarStar& other) const
+  {
+    return !(*this == other);
+  }
+
+ private:
+  //! Rotate the given word left by k bits.
+  static uint64_t Rotate(const uint64_t x, const int k)
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  //! The state of the generator.
+  uint64_t state[4];
+};
+
+} // namespace math
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @file block_distances.hpp
+ *
+ * Computation of all the distances between two sets of points at once, such as
+ * the points held in two leaves of trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_BLOCK_DISTANCES_HPP
+#define MLPACK_CORE_METRICS_BLOCK_DISTANCES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The BlockDistances class computes the distances between each of a set of
+ * query points and each of a set of reference points at once.  Dual-tree
+ * algorithms can use it to evaluate all the base cases between two leaves.
+ *
+ * By default there is no faster way to compute a block than to compute its
+ * distances one at a time, so Worthwhile() always returns false; the
+ * specialization for the Euclidean distances computes the block with a matrix
+ * multiplication.
+ *
+ * @tparam MetricType The metric to use for computation.
+ */
+template<typename MetricType>
+class BlockDistances
+{
+ public:
+  /**
+   * Return whether computing a block of distances between the given numbers of
+   * points is faster than computing them one at a time.
+   *
+   * @tparam MatType Type of the data matrix.
+   */
+  template<typename MatType>
+  static bool Worthwhile(const size_t /* numQueries */,
+                         const size_t /* numReferences */)
+  {
+    return false;
+  }
+
+  /**
+   * Compute the distances between the query points and the reference points
+   * with the given indices; distances(i, j) will be the distance between the
+   * i'th query point and the j'th reference point.  The computed distances may
+   * not be exact: distances(i, j) is within errors[i] of the true distance.
+   *
+   * @param metric Instantiated metric.
+   * @param querySet Set of query points.
+   * @param queryIndices Indices of the query points of the block.
+   * @param referenceSet Set of reference points.
+   * @param referenceIndices Indices of the reference points of the block.
+   * @param distances Matrix to store the distances in.
+   * @param errors Vector to store the error bound of each query point in.
+   */
+  template<typename MatType>
+  static void Evaluate(MetricType& metric,
+                       const MatType& querySet,
+                       const std::vector<size_t>& queryIndices,
+                       const MatType& referenceSet,
+                       const std::vector<size_t>& referenceIndices,
+                       arma::mat& distances,
+                       arma::vec& errors)
+  {
+    distances.set_size(queryIndices.size(), referenceIndices.size());
+    for (size_t j = 0; j < referenceIndices.size(); ++j)
+      for (size_t i = 0; i < queryIndices.size(); ++i)
+        distances(i, j) = metric.Evaluate(querySet.col(queryIndices[i]),
+            referenceSet.col(referenceIndices[j]));
+
+    errors.zeros(queryIndices.size());
+  }
+};
+
+/**
+ * Specialization for the Euclidean and squared Euclidean distances.  Since
+ *
+ * @f[
+ * || q - r ||^2 = || q ||^2 + || r ||^2 - 2 q^T r,
+ * @f]
+ *
+ * the whole block of squared distances is computed with one matrix
+ * multiplication (a single GEMM call to the BLAS), which is much faster than
+ * computing the distances one at a time when the blocks are large.  The points
+ * are centered on the mean of the reference points first, so that the
+ * cancellation error is on the scale of the distances between the points, not
+ * of their distances to the origin.  That error is still not zero, so the
+ * distances come with error bounds; rules that need exact distances can use
+ * them to decide which base cases to compute exactly.
+ */
+template<bool TakeRoot>
+class BlockDistances<LMetric<2, TakeRoot>>
+{
+ public:
+  //! The smallest number of points on each side of a block for the matrix
+  //! multiplication to be faster than computing the distances one at a time.
+  static const size_t MinBlockSize = 16;
+
+  /**
+   * Return whether computing a block of distances between the given numbers of
+   * points is faster than computing them one at a time.  This is only the case
+   * for large enough blocks of dense points.
+   *
+   * @tparam MatType Type of the data matrix.
+   */
+  template<typename MatType>
+  static bool Worthwhile(const size_t numQueries, const size_t numReferences)
+  {
+    return !arma::is_arma_sparse_type<MatType>::value &&
+        (numQueries >= MinBlockSize) && (numReferences >= MinBlockSize);
+  }
+
+  /**
+   * Compute the distances between the query points and the reference points
+   * with the given indices; distances(i, j) will be the distance between the
+   * i'th query point and the j'th reference point, and is within errors[i] of
+   * the true distance.
+   *
+   * @param metric Instantiated metric.
+   * @param querySet Set of query points.
+   * @param queryIndices Indices of the query points of the block.
+   * @param referenceSet Set of reference points.
+   * @param referenceIndices Indices of the reference points of the block.
+   * @param distances Matrix to store the distances in.
+   * @param errors Vector to store the error bound of each query point in.
+   */
+  template<typename MatType>
+  static void Evaluate(
+      LMetric<2, TakeRoot>& metric,
+      const MatType& querySet,
+      const std::vector<size_t>& queryIndices,
+      const MatType& referenceSet,
+      const std::vector<size_t>& referenceIndices,
+      arma::mat& distances,
+      arma::vec& errors,
+      typename std::enable_if<!arma::is_arma_sparse_type<MatType>::value>::type*
+          = 0);
+
+  /**
+   * Compute the distances between sparse query and reference points; this
+   * computes the distances one at a time, so they are exact.
+   */
+  template<typename MatType>
+  static void Evaluate(
+      LMetric<2, TakeRoot>& metric,
+      const MatType& querySet,
+      const std::vector<size_t>& queryIndices,
+      const MatType& referenceSet,
+      const std::vector<size_t>& referenceIndices,
+      arma::mat& distances,
+      arma::vec& errors,
+      typename std::enable_if<arma::is_arma_sparse_type<MatType>::value>::type*
+          = 0)
+  {
+    distances.set_size(queryIndices.size(), referenceIndices.size());
+    for (size_t j = 0; j < referenceIndices.size(); ++j)
+      for (size_t i = 0; i < queryIndices.size(); ++i)
+        distances(i, j) = metric.Evaluate(querySet.col(queryIndices[i]),
+            referenceSet.col(referenceIndices[j]));
+
+    errors.zeros(queryIndices.size());
+  }
+};
+
+template<bool TakeRoot>
+template<typename MatType>
+void BlockDistances<LMetric<2, TakeRoot>>::Evaluate(
+    LMetric<2, TakeRoot>& /* metric */,
+    const MatType& querySet,
+    const std::vector<size_t>& queryIndices,
+    const MatType& referenceSet,
+    const std::vector<size_t>& referenceIndices,
+    arma::mat& distances,
+    arma::vec& errors,
+    typename std::enable_if<!arma::is_arma_sparse_type<MatType>::value>::type*)
+{
+  const size_t numQueries = queryIndices.size();
+  const size_t numReferences = referenceIndices.size();
+
+  // Gather the (centered) points of the block.
+  arma::mat references(referenceSet.n_rows, numReferences);
+  for (size_t j = 0; j < numReferences; ++j)
+  {
+    references.col(j) = arma::conv_to<arma::vec>::from(
+        referenceSet.col(referenceIndices[j]));
+  }
+
+  const arma::vec center = arma::mean(references, 1);
+  references.each_col() -= center;
+
+  arma::mat queries(querySet.n_rows, numQueries);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    queries.col(i) = arma::conv_to<arma::vec>::from(
+        querySet.col(queryIndices[i])) - center;
+  }
+
+  const arma::rowvec queryNorms = arma::sum(arma::square(queries), 0);
+  const arma::rowvec referenceNorms = arma::sum(arma::square(references), 0);
+
+  distances = -2.0 * queries.t() * references;
+  distances.each_col() += queryNorms.t();
+  distances.each_row() += referenceNorms;
+  distances.transform([](const double d) { return std::max(d, 0.0); });
+
+  // The rounding error of each squared distance is bounded by a small multiple
+  // of the machine epsilon times the sum of the squared norms.  If the root is
+  // taken, the error of the root is at most the root of that error.
+  const double errorScale = 4.0 * (querySet.n_rows + 2) *
+      std::numeric_limits<double>::epsilon();
+  errors = errorScale * (queryNorms.t() + arma::max(referenceNorms));
+
+  if (TakeRoot)
+  {
+    distances = arma::sqrt(distances);
+    errors = arma::sqrt(errors);
+  }
+}
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
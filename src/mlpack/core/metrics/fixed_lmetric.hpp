@@ -0,0 +1,166 @@
+/**
+ * @file fixed_lmetric.hpp
+ *
+ * An L-metric for points of a dimensionality that is known at compile time.
+ * The loops over the dimensions have a constant trip count, so the compiler can
+ * unroll and vectorize them; this is much faster than the generic LMetric for
+ * low-dimensional data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_FIXED_LMETRIC_HPP
+#define MLPACK_CORE_METRICS_FIXED_LMETRIC_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * The L_p metric for points of the given dimensionality.  This computes exactly
+ * the same distances as LMetric<TPower, TTakeRoot>, but the dimensionality of
+ * the points is a template parameter, so the distance computations are fully
+ * unrolled (and vectorized, with the right compiler flags such as -march=native)
+ * and need no temporaries.  This is useful for low-dimensional data, such as
+ * geospatial data, where the overhead of the generic Armadillo expressions
+ * dominates the cost of each distance computation.
+ *
+ * Points of any other dimensionality (and sparse points) are still handled
+ * correctly, with LMetric<TPower, TTakeRoot>.
+ *
+ * Because this metric exposes the same Power and TakeRoot constants as LMetric,
+ * it can be used with any tree type that requires an LMetric, such as the
+ * KDTree; for instance,
+ *
+ * @code
+ * NeighborSearch<NearestNeighborSort, FixedEuclideanDistance<3>> knn(data);
+ * @endcode
+ *
+ * A few convenience typedefs are given:
+ *
+ *  - FixedManhattanDistance<Dimensionality>
+ *  - FixedSquaredEuclideanDistance<Dimensionality>
+ *  - FixedEuclideanDistance<Dimensionality>
+ *  - FixedChebyshevDistance<Dimensionality>
+ *
+ * @tparam Dimensionality Dimensionality of the points.
+ * @tparam TPower Power of metric; i.e. Power = 1 gives the L1-norm (Manhattan
+ *    distance), and INT_MAX gives the L-infinity norm.
+ * @tparam TTakeRoot If true, the Power'th root of the result is taken before
+ *    it is returned.
+ */
+template<size_t Dimensionality, int TPower, bool TTakeRoot = true>
+class FixedLMetric
+{
+  static_assert(Dimensionality > 0, "Dimensionality must be positive.");
+
+ public:
+  /**
+   * Default constructor does nothing, but is required to satisfy the Metric
+   * policy.
+   */
+  FixedLMetric() { }
+
+  /**
+   * Computes the distance between two points.
+   *
+   * @tparam VecTypeA Type of first vector (generally arma::vec or
+   *      arma::sp_vec).
+   * @tparam VecTypeB Type of second vector.
+   * @param a First vector.
+   * @param b Second vector.
+   * @return Distance between vectors a and b.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(
+      const VecTypeA& a,
+      const VecTypeB& b,
+      typename std::enable_if<!arma::is_arma_sparse_type<VecTypeA>::value &&
+          !arma::is_arma_sparse_type<VecTypeB>::value>::type* = 0);
+
+  /**
+   * Computes the distance between two points, when one of them is sparse; this
+   * uses LMetric<TPower, TTakeRoot>.
+   */
+  template<typename VecTypeA, typename VecTypeB>
+  static typename VecTypeA::elem_type Evaluate(
+      const VecTypeA& a,
+      const VecTypeB& b,
+      typename std::enable_if<arma::is_arma_sparse_type<VecTypeA>::value ||
+          arma::is_arma_sparse_type<VecTypeB>::value>::type* = 0)
+  {
+    return LMetric<TPower, TTakeRoot>::Evaluate(a, b);
+  }
+
+  /**
+   * Computes the distances between a point and each column of a dense matrix,
+   * such as the points held in a leaf of a tree.  The point is loaded only
+   * once, so this is faster than calling Evaluate() for each column.
+   *
+   * @tparam VecType Type of the point.
+   * @tparam MatType Type of the matrix (arma::Mat<> or a subview of it).
+   * @param a Point.
+   * @param b Matrix of points, one in each column.
+   * @param distances Vector to store the distance to each column of b in.
+   */
+  template<typename VecType, typename MatType>
+  static void Evaluate(const VecType& a,
+                       const MatType& b,
+                       arma::Col<typename MatType::elem_type>& distances);
+
+  //! Serialize the metric (nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+  //! The dimensionality of the points.
+  static const size_t Dimensions = Dimensionality;
+  //! The power of the metric.
+  static const int Power = TPower;
+  //! Whether or not the root is taken.
+  static const bool TakeRoot = TTakeRoot;
+
+ private:
+  //! Compute the distance between points given by pointers to their
+  //! Dimensionality elements.
+  template<typename ElemType>
+  static ElemType Distance(const ElemType* a, const ElemType* b);
+};
+
+// Convenience typedefs.
+
+/**
+ * The Manhattan (L1) distance for points of the given dimensionality.
+ */
+template<size_t Dimensionality>
+using FixedManhattanDistance = FixedLMetric<Dimensionality, 1, false>;
+
+/**
+ * The squared Euclidean (L2) distance for points of the given dimensionality.
+ * Note that this is not technically a metric!
+ */
+template<size_t Dimensionality>
+using FixedSquaredEuclideanDistance = FixedLMetric<Dimensionality, 2, false>;
+
+/**
+ * The Euclidean (L2) distance for points of the given dimensionality.
+ */
+template<size_t Dimensionality>
+using FixedEuclideanDistance = FixedLMetric<Dimensionality, 2, true>;
+
+/**
+ * The L-infinity distance for points of the given dimensionality.
+ */
+template<size_t Dimensionality>
+using FixedChebyshevDistance = FixedLMetric<Dimensionality, INT_MAX, false>;
+
+} // namespace metric
+} // namespace mlpack
+
+// Include implementation.
+#include "fixed_lmetric_impl.hpp"
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * @file fixed_lmetric_impl.hpp
+ *
+ * Implementation of the FixedLMetric class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_METRICS_FIXED_LMETRIC_IMPL_HPP
+#define MLPACK_CORE_METRICS_FIXED_LMETRIC_IMPL_HPP
+
+// In case it hasn't been included.
+#include "fixed_lmetric.hpp"
+
+namespace mlpack {
+namespace metric {
+
+/**
+ * Accumulate the term of one dimension into the distance of an L_p metric, and
+ * take the root of the accumulated distance.  The given differences are
+ * non-negative.
+ */
+template<int Power>
+struct LMetricTerm
+{
+  template<typename ElemType>
+  static ElemType Accumulate(const ElemType sum, const ElemType diff)
+  {
+    return sum + std::pow(diff, Power);
+  }
+
+  template<typename ElemType>
+  static ElemType Root(const ElemType sum)
+  {
+    return std::pow(sum, (1.0 / Power));
+  }
+};
+
+// L1: the root doesn't matter.
+template<>
+struct LMetricTerm<1>
+{
+  template<typename ElemType>
+  static ElemType Accumulate(const ElemType sum, const ElemType diff)
+  {
+    return sum + diff;
+  }
+
+  template<typename ElemType>
+  static ElemType Root(const ElemType sum) { return sum; }
+};
+
+// L2.
+template<>
+struct LMetricTerm<2>
+{
+  template<typename ElemType>
+  static ElemType Accumulate(const ElemType sum, const ElemType diff)
+  {
+    return sum + diff * diff;
+  }
+
+  template<typename ElemType>
+  static ElemType Root(const ElemType sum) { return std::sqrt(sum); }
+};
+
+// L-infinity: the largest difference.
+template<>
+struct LMetricTerm<INT_MAX>
+{
+  template<typename ElemType>
+  static ElemType Accumulate(const ElemType sum, const ElemType diff)
+  {
+    return std::max(sum, diff);
+  }
+
+  template<typename ElemType>
+  static ElemType Root(const ElemType sum) { return sum; }
+};
+
+template<size_t Dimensionality, int TPower, bool TTakeRoot>
+template<typename VecTypeA, typename VecTypeB>
+typename VecTypeA::elem_type
+FixedLMetric<Dimensionality, TPower, TTakeRoot>::Evaluate(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    typename std::enable_if<!arma::is_arma_sparse_type<VecTypeA>::value &&
+        !arma::is_arma_sparse_type<VecTypeB>::value>::type*)
+{
+  typedef typename VecTypeA::elem_type ElemType;
+
+  if (a.n_elem != Dimensionality || b.n_elem != Dimensionality)
+    return LMetric<TPower, TTakeRoot>::Evaluate(a, b);
+
+  // Loading the points into arrays of constant size lets the compiler keep them
+  // in registers.
+  ElemType pointA[Dimensionality];
+  ElemType pointB[Dimensionality];
+  for (size_t i = 0; i < Dimensionality; ++i)
+  {
+    pointA[i] = a[i];
+    pointB[i] = b[i];
+  }
+
+  return Distance(pointA, pointB);
+}
+
+template<size_t Dimensionality, int TPower, bool TTakeRoot>
+template<typename VecType, typename MatType>
+void FixedLMetric<Dimensionality, TPower, TTakeRoot>::Evaluate(
+    const VecType& a,
+    const MatType& b,
+    arma::Col<typename MatType::elem_type>& distances)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  distances.set_size(b.n_cols);
+  if (a.n_elem != Dimensionality || b.n_rows != Dimensionality)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+      distances[j] = LMetric<TPower, TTakeRoot>::Evaluate(a, b.col(j));
+    return;
+  }
+
+  ElemType point[Dimensionality];
+  for (size_t i = 0; i < Dimensionality; ++i)
+    point[i] = a[i];
+
+  for (size_t j = 0; j < b.n_cols; ++j)
+    distances[j] = Distance(point, b.colptr(j));
+}
+
+template<size_t Dimensionality, int TPower, bool TTakeRoot>
+template<typename ElemType>
+inline ElemType FixedLMetric<Dimensionality, TPower, TTakeRoot>::Distance(
+    const ElemType* a,
+    const ElemType* b)
+{
+  // The trip count is constant, so this loop is unrolled.  The differences are
+  // taken so that they are non-negative even for unsigned types.
+  ElemType sum = 0;
+  for (size_t i = 0; i < Dimensionality; ++i)
+  {
+    const ElemType diff = (a[i] > b[i]) ? (a[i] - b[i]) : (b[i] - a[i]);
+    sum = LMetricTerm<TPower>::Accumulate(sum, diff);
+  }
+
+  if (!TTakeRoot) // The compiler should optimize this correctly at compile-time.
+    return sum;
+
+  return LMetricTerm<TPower>::Root(sum);
+}
+
+} // namespace metric
+} // namespace mlpack
+
+#endif
@@ -37,10 +37,24 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L (see Decompose()), and then multiply the data by L (see
+ * Transform()).  The Euclidean distance between the transformed points is the
+ * Mahalanobis distance between the original points, so the fast LMetric and
+ * the default KDTree can be used:
+ *
+ * @code
+ * MahalanobisDistance<> distance(q);
+ * arma::mat transformedReferences, transformedQueries;
+ * distance.Transform(references, transformedReferences);
+ * distance.Transform(queries, transformedQueries);
+ *
+ * KNN knn(std::move(transformedReferences));
+ * knn.Search(transformedQueries, k, neighbors, distances);
+ * @endcode
+ *
+ * If you still wish to use the KNN class with a custom distance anyway, you
+ * will need to use a different tree type than the default KDTree, which only
+ * works with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -96,6 +110,29 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Decompose the covariance matrix as Q = L^T L.  This is the Cholesky
+   * decomposition when Q is positive definite; otherwise, L is computed from
+   * the eigendecomposition of Q, with the negative eigenvalues (which can only
+   * come from rounding errors if Q is positive semidefinite) set to zero.  A
+   * std::invalid_argument is thrown if the covariance matrix has not been set,
+   * and a std::runtime_error if the decomposition fails.
+   *
+   * @param transformation Matrix to store L in.
+   */
+  void Decompose(arma::mat& transformation) const;
+
+  /**
+   * Multiply the given points by the matrix L of Decompose(), so that the
+   * Euclidean distance between two transformed points is the Mahalanobis
+   * distance between the original points.
+   *
+   * @param data Points to transform, one per column.
+   * @param transformed Matrix to store the transformed points in.
+   */
+  template<typename MatType>
+  void Transform(const MatType& data, arma::mat& transformed) const;
+
   /**
    * Access the covariance matrix.
    *
@@ -47,6 +47,44 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Decompose(arma::mat& transformation) const
+{
+  if (covariance.n_rows == 0)
+  {
+    throw std::invalid_argument("MahalanobisDistance::Decompose(): the "
+        "covariance matrix has not been set!");
+  }
+
+  // Q = R^T R, with R upper triangular, when Q is positive definite.
+  if (arma::chol(transformation, covariance))
+    return;
+
+  // Otherwise Q = V D V^T, so L = D^(1/2) V^T.
+  arma::vec eigenvalues;
+  arma::mat eigenvectors;
+  if (!arma::eig_sym(eigenvalues, eigenvectors, covariance))
+  {
+    throw std::runtime_error("MahalanobisDistance::Decompose(): the "
+        "eigendecomposition of the covariance matrix failed!");
+  }
+
+  for (size_t i = 0; i < eigenvalues.n_elem; ++i)
+    eigenvalues[i] = (eigenvalues[i] > 0) ? std::sqrt(eigenvalues[i]) : 0;
+
+  transformation = arma::diagmat(eigenvalues) * eigenvectors.t();
+}
+
+template<bool TakeRoot>
+template<typename MatType>
+void MahalanobisDistance<TakeRoot>::Transform(const MatType& data,
+                                              arma::mat& transformed) const
+{
+  arma::mat transformation;
+  Decompose(transformation);
+  transformed = transformation * data;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
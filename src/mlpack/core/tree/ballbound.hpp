@@ -196,6 +196,8 @@ struct BoundTraits<BallBound<MetricType, VecType>>
 {
   //! These bounds are potentially loose in some dimensions.
   const static bool HasTightBounds = false;
+  //! These bounds only depend on the points they hold.
+  const static bool RebuildableFromPoints = true;
 };
 
 } // namespace bound
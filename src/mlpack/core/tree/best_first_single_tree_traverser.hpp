@@ -0,0 +1,124 @@
+/**
+ * @file best_first_single_tree_traverser.hpp
+ *
+ * A single-tree traverser which visits the nodes in the order of their scores
+ * (best first), and can stop when a budget of base cases or time is spent, so
+ * that it can be used for anytime searches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A single-tree traverser that keeps a frontier of the scored nodes that have
+ * not been visited yet, and always visits the node with the best (lowest)
+ * score next.  Leaves are visited by calling BaseCase() with each of their
+ * points, and other nodes by scoring their children.  The traversal stops when
+ * the frontier is empty, or when the budget of base cases or time for the
+ * query point has been spent; the nodes left in the frontier (and their
+ * scores, which bound how good the points that were not visited can be) are
+ * then available with Remaining() and BestRemainingScore().
+ *
+ * Since only the points of leaves are visited, this can't be used with trees
+ * that hold points in their inner nodes (like the cover tree).
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+ public:
+  //! A node of the frontier with its score.
+  typedef std::pair<double, TreeType*> NodeAndScore;
+
+  /**
+   * Instantiate the best-first single tree traverser with the given rule set
+   * and budget.
+   *
+   * @param rule Rules to traverse the tree with.
+   * @param maxBaseCases Largest number of base cases for each query point (0
+   *     for no limit).
+   * @param maxTime Largest wall clock time in seconds for each query point (0
+   *     for no limit).
+   */
+  BestFirstSingleTreeTraverser(RuleType& rule,
+                               const size_t maxBaseCases = 0,
+                               const double maxTime = 0.0);
+
+  /**
+   * Traverse the tree with the given point, until the tree is exhausted or the
+   * budget is spent.  The budget is checked before each node is visited, so
+   * the whole leaf that is being visited is always finished.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   * @return Whether the traversal finished (so that no node was left in the
+   *     frontier).
+   */
+  bool Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the nodes (with their scores) that the last traversal did not visit,
+  //! in no particular order.
+  const std::vector<NodeAndScore>& Remaining() const { return frontier; }
+
+  //! Get the best score of the nodes that the last traversal did not visit
+  //! (DBL_MAX if it finished).
+  double BestRemainingScore() const;
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+
+  //! Get the largest number of base cases for each query point.
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the largest number of base cases for each query point.
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Get the largest wall clock time in seconds for each query point.
+  double MaxTime() const { return maxTime; }
+  //! Modify the largest wall clock time in seconds for each query point.
+  double& MaxTime() { return maxTime; }
+
+ private:
+  static_assert(!TreeTraits<TreeType>::HasSelfChildren, "The best-first "
+      "single tree traverser can't be used with trees that have self children "
+      "(like the cover tree).");
+
+  //! Order of the frontier heap, so that the node with the lowest score is on
+  //! top.
+  static bool WorseScore(const NodeAndScore& a, const NodeAndScore& b);
+
+  //! Push a scored node onto the frontier.
+  void Push(const double score, TreeType* node);
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The largest number of base cases for each query point (0 for no limit).
+  size_t maxBaseCases;
+
+  //! The largest time in seconds for each query point (0 for no limit).
+  double maxTime;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The frontier of the last traversal, as a heap with the best score first.
+  std::vector<NodeAndScore> frontier;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first single tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule,
+    const size_t maxBaseCases,
+    const double maxTime) :
+    rule(rule),
+    maxBaseCases(maxBaseCases),
+    maxTime(maxTime),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+bool BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  typedef std::chrono::steady_clock Clock;
+  const Clock::time_point start = Clock::now();
+
+  frontier.clear();
+  size_t baseCases = 0;
+
+  const double rootScore = rule.Score(queryIndex, referenceNode);
+  if (rootScore == DBL_MAX)
+    ++numPrunes;
+  else
+    Push(rootScore, &referenceNode);
+
+  while (!frontier.empty())
+  {
+    // Stop if the budget is spent.
+    if (maxBaseCases > 0 && baseCases >= maxBaseCases)
+      return false;
+    if (maxTime > 0.0 && std::chrono::duration<double>(Clock::now() -
+        start).count() >= maxTime)
+      return false;
+
+    std::pop_heap(frontier.begin(), frontier.end(), WorseScore);
+    const NodeAndScore best = frontier.back();
+    frontier.pop_back();
+
+    // The bound may have improved since the node was scored.
+    TreeType& node = *best.second;
+    if (rule.Rescore(queryIndex, node, best.first) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    if (node.NumChildren() == 0)
+    {
+      for (size_t i = 0; i < node.NumPoints(); ++i)
+        rule.BaseCase(queryIndex, node.Point(i));
+      baseCases += node.NumPoints();
+    }
+    else
+    {
+      for (size_t i = 0; i < node.NumChildren(); ++i)
+      {
+        const double score = rule.Score(queryIndex, node.Child(i));
+        if (score == DBL_MAX)
+          ++numPrunes;
+        else
+          Push(score, &node.Child(i));
+      }
+    }
+  }
+
+  return true;
+}
+
+template<typename TreeType, typename RuleType>
+double BestFirstSingleTreeTraverser<TreeType, RuleType>::BestRemainingScore()
+    const
+{
+  // The best node is the top of the heap.
+  return frontier.empty() ? DBL_MAX : frontier.front().first;
+}
+
+template<typename TreeType, typename RuleType>
+bool BestFirstSingleTreeTraverser<TreeType, RuleType>::WorseScore(
+    const NodeAndScore& a,
+    const NodeAndScore& b)
+{
+  return a.first > b.first;
+}
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Push(
+    const double score,
+    TreeType* node)
+{
+  frontier.push_back(NodeAndScore(score, node));
+  std::push_heap(frontier.begin(), frontier.end(), WorseScore);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
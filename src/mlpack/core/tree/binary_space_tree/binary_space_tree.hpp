@@ -15,10 +15,20 @@
 
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "split_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+//! The memory layouts that BinarySpaceTree::PackNodes() can arrange nodes in.
+enum NodeLayout
+{
+  //! Nodes are stored level by level, starting at the root.
+  BREADTH_FIRST_LAYOUT,
+  //! Nodes are stored in the recursive, cache-oblivious van Emde Boas order.
+  VAN_EMDE_BOAS_LAYOUT
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -88,6 +98,9 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! Contiguous storage for all descendant nodes, if PackNodes() has been
+  //! called on this (root) node.  Otherwise, NULL.
+  std::vector<BinarySpaceTree>* nodeArena;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -102,6 +115,12 @@ class BinarySpaceTree
   template<typename RuleType>
   class BreadthFirstDualTreeTraverser;
 
+  //! A breadth-first dual-tree traverser that processes the query nodes of
+  //! each level in parallel; see
+  //! parallel_breadth_first_dual_tree_traverser.hpp.
+  template<typename RuleType>
+  class ParallelBreadthFirstDualTreeTraverser;
+
   /**
    * Construct this as the root node of a binary space tree using the given
    * dataset.  This will copy the input matrix; if you don't want this, consider
@@ -492,6 +511,24 @@ class BinarySpaceTree
   //! Store the center of the bounding region in the given vector.
   void Center(arma::vec& center) const { bound.Center(center); }
 
+  /**
+   * Move every descendant of this node into a single contiguous block of
+   * memory, in the given order, so that traversals touch fewer cache lines and
+   * pages.  The structure of the tree is unchanged, and pointers to the root
+   * remain valid, but pointers and references to any other node of the tree
+   * are invalidated.  This may only be called on the root of the tree, and
+   * should be called before any statistics that hold pointers to nodes are
+   * built.  A tree that is copied, or loaded from any archive but a
+   * data::BlobIArchive, is not packed; a tree loaded from a blob archive is
+   * packed in depth-first order.
+   *
+   * @param layout Order to store the nodes in.
+   */
+  void PackNodes(const NodeLayout layout = VAN_EMDE_BOAS_LAYOUT);
+
+  //! Return whether or not the nodes of this tree are stored contiguously.
+  bool IsPacked() const { return nodeArena != NULL; }
+
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -514,6 +551,39 @@ class BinarySpaceTree
                  const size_t maxLeafSize,
                  SplitType<BoundType<MetricType>, MatType>& splitter);
 
+  /**
+   * Create the children of this node, once its points have been split at the
+   * given column.  If SplitTraits allows it, large subtrees are built in
+   * parallel with OpenMP tasks.
+   *
+   * @param splitCol Index of the first point of the right child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     are not tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  void BuildChildren(const size_t splitCol,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize,
+                     SplitType<BoundType<MetricType>, MatType>& splitter);
+
+  /**
+   * Create a child of this node holding the given points.
+   *
+   * @param childBegin Index of the first point of the child.
+   * @param childCount Number of points of the child.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the indices
+   *     are not tracked.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   */
+  BinarySpaceTree* BuildChild(
+      const size_t childBegin,
+      const size_t childCount,
+      std::vector<size_t>* oldFromNew,
+      const size_t maxLeafSize,
+      SplitType<BoundType<MetricType>, MatType>& splitter);
+
   /**
    * Update the bound of the current node. This method does not take into
    * account bound-specific properties.
@@ -523,6 +593,24 @@ class BinarySpaceTree
   template<typename BoundType2>
   void UpdateBound(BoundType2& boundToUpdate);
 
+  /**
+   * Free the children of this node, taking into account whether they are held
+   * in a node arena.  The children are set to NULL.
+   */
+  void FreeChildren();
+
+  /**
+   * Append the nodes of the subtree rooted at the given node, down to (but not
+   * including) the given relative depth, to the list in van Emde Boas order.
+   *
+   * @param node Root of the subtree to lay out.
+   * @param height Number of levels of the subtree to lay out.
+   * @param order List of nodes to append to.
+   */
+  static void VanEmdeBoasOrder(BinarySpaceTree* node,
+                               const size_t height,
+                               std::vector<BinarySpaceTree*>& order);
+
   /**
    * Update the bound of the current node. This method is designed for
    * HollowBallBound only.
@@ -543,6 +631,23 @@ class BinarySpaceTree
   //! Friend access is given for the default constructor.
   friend class boost::serialization::access;
 
+  /**
+   * Serialize the nodes of this (root) tree as a flat array in depth-first
+   * order, with the dataset written once.  This is used for the blob archives;
+   * the loaded descendants are stored in a node arena, as with PackNodes().
+   * If the archive asks for compact trees (and the bounds can be rebuilt from
+   * the points), only the range of points of each node is written.
+   */
+  template<typename Archive>
+  void SerializeFlat(Archive& ar);
+
+  /**
+   * Rebuild the bounds, the distances and the statistics of all the nodes of
+   * this (root) tree from the points they hold, after a compact tree was
+   * loaded.  The bounds are computed in parallel.
+   */
+  void RebuildNodes();
+
  public:
   /**
    * Serialize the tree.
@@ -14,10 +14,15 @@
 // In case it wasn't included already for some reason.
 #include "binary_space_tree.hpp"
 
+#include <mlpack/core/data/blob_archive.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -40,7 +45,8 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeArena(NULL)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -68,7 +74,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeArena(NULL)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -102,7 +109,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodeArena(NULL)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -137,7 +145,8 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeArena(NULL)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<MetricType>, MatType> splitter;
@@ -165,7 +174,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeArena(NULL)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -199,7 +209,8 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodeArena(NULL)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -238,7 +249,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    nodeArena(NULL)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -267,7 +279,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodeArena(NULL)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -301,7 +314,8 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodeArena(NULL)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -342,7 +356,8 @@ BinarySpaceTree(
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    nodeArena(NULL)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -400,7 +415,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodeArena(other.nodeArena)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -412,6 +428,7 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodeArena = NULL;
 
   // Set new parent.
   if (left)
@@ -455,8 +472,7 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  FreeChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -783,10 +799,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  BuildChildren(splitCol, NULL, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -851,10 +864,7 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  BuildChildren(splitCol, &oldFromNew, maxLeafSize, splitter);
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -871,6 +881,92 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              std::vector<size_t>* oldFromNew,
+              const size_t maxLeafSize,
+              SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  #ifdef HAS_OPENMP
+  // The children hold disjoint ranges of points (and of oldFromNew), so they
+  // can be built at the same time if the splitter can be shared.  Each subtree
+  // is built in the same way as it would be serially, so the tree does not
+  // depend on the number of threads.
+  if (SplitTraits<Split>::ParallelChildren &&
+      count >= split::ParallelTaskMinSize)
+  {
+    if (omp_in_parallel())
+    {
+      // Build the left subtree in a task while this thread builds the right
+      // subtree.
+      SplitType<BoundType<MetricType>, MatType>* splitterPtr = &splitter;
+      #pragma omp task
+      left = BuildChild(begin, splitCol - begin, oldFromNew, maxLeafSize,
+          *splitterPtr);
+      right = BuildChild(splitCol, begin + count - splitCol, oldFromNew,
+          maxLeafSize, splitter);
+      #pragma omp taskwait
+      return;
+    }
+    else if (count < split::ParallelPartitionMinSize &&
+        omp_get_max_threads() > 1)
+    {
+      // The nodes above this one were partitioned in parallel; from here on,
+      // we build subtrees in parallel instead.
+      SplitType<BoundType<MetricType>, MatType>* splitterPtr = &splitter;
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          #pragma omp task
+          left = BuildChild(begin, splitCol - begin, oldFromNew, maxLeafSize,
+              *splitterPtr);
+          right = BuildChild(splitCol, begin + count - splitCol, oldFromNew,
+              maxLeafSize, *splitterPtr);
+          #pragma omp taskwait
+        }
+      }
+      return;
+    }
+  }
+  #endif
+
+  left = BuildChild(begin, splitCol - begin, oldFromNew, maxLeafSize,
+      splitter);
+  right = BuildChild(splitCol, begin + count - splitCol, oldFromNew,
+      maxLeafSize, splitter);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChild(const size_t childBegin,
+           const size_t childCount,
+           std::vector<size_t>* oldFromNew,
+           const size_t maxLeafSize,
+           SplitType<BoundType<MetricType>, MatType>& splitter)
+{
+  if (oldFromNew == NULL)
+  {
+    return new BinarySpaceTree(this, childBegin, childCount, splitter,
+        maxLeafSize);
+  }
+
+  return new BinarySpaceTree(this, childBegin, childCount, *oldFromNew,
+      splitter, maxLeafSize);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -928,11 +1024,172 @@ BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    nodeArena(NULL)
 {
   // Nothing to do.
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    PackNodes(const NodeLayout layout)
+{
+  if (parent != NULL)
+    throw std::invalid_argument("BinarySpaceTree::PackNodes(): can only be "
+        "called on the root of the tree");
+
+  // Collect the descendants of this node in the order they will be stored.
+  // The root is not part of the arena, since it is owned by the user.
+  std::vector<BinarySpaceTree*> order;
+  if (layout == BREADTH_FIRST_LAYOUT)
+  {
+    std::queue<BinarySpaceTree*> queue;
+    queue.push(this);
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front();
+      queue.pop();
+
+      order.push_back(node);
+      if (node->left)
+        queue.push(node->left);
+      if (node->right)
+        queue.push(node->right);
+    }
+  }
+  else
+  {
+    // Find the height of the tree.
+    size_t height = 0;
+    std::queue<std::pair<BinarySpaceTree*, size_t>> queue;
+    queue.push(std::make_pair(this, 1));
+    while (!queue.empty())
+    {
+      BinarySpaceTree* node = queue.front().first;
+      const size_t depth = queue.front().second;
+      queue.pop();
+
+      height = std::max(height, depth);
+      if (node->left)
+        queue.push(std::make_pair(node->left, depth + 1));
+      if (node->right)
+        queue.push(std::make_pair(node->right, depth + 1));
+    }
+
+    VanEmdeBoasOrder(this, height, order);
+  }
+
+  // Both orders place every parent before its children.  So, we can move each
+  // node into the arena and then point its (already moved) parent at the new
+  // location.  The arena is never resized, so the new locations are stable.
+  std::vector<BinarySpaceTree>* arena = new std::vector<BinarySpaceTree>();
+  arena->reserve(order.size() - 1);
+  for (size_t i = 1; i < order.size(); ++i)
+  {
+    BinarySpaceTree* oldNode = order[i];
+    arena->push_back(std::move(*oldNode));
+    BinarySpaceTree* newNode = &arena->back();
+
+    if (newNode->parent->left == oldNode)
+      newNode->parent->left = newNode;
+    else
+      newNode->parent->right = newNode;
+
+    // The moved-from node has no children and no dataset, so this only frees
+    // the node itself.  If this node was already part of an arena, the arena
+    // is freed below instead.
+    if (!nodeArena)
+      delete oldNode;
+  }
+
+  if (nodeArena)
+  {
+    // The old nodes have been moved from, so they do not own anything.
+    delete nodeArena;
+  }
+
+  nodeArena = arena;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    FreeChildren()
+{
+  if (nodeArena)
+  {
+    // Nodes in the arena don't own their children; the arena owns all of them.
+    for (size_t i = 0; i < nodeArena->size(); ++i)
+    {
+      (*nodeArena)[i].left = NULL;
+      (*nodeArena)[i].right = NULL;
+    }
+
+    delete nodeArena;
+    nodeArena = NULL;
+  }
+  else
+  {
+    delete left;
+    delete right;
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    VanEmdeBoasOrder(BinarySpaceTree* node,
+                     const size_t height,
+                     std::vector<BinarySpaceTree*>& order)
+{
+  if (node == NULL || height == 0)
+    return;
+
+  if (height == 1)
+  {
+    order.push_back(node);
+    return;
+  }
+
+  // Lay out the top half of the levels, then each subtree hanging off of the
+  // bottom of the top half.
+  const size_t topHeight = height / 2;
+  VanEmdeBoasOrder(node, topHeight, order);
+
+  std::vector<BinarySpaceTree*> level(1, node);
+  for (size_t d = 0; d < topHeight; ++d)
+  {
+    std::vector<BinarySpaceTree*> nextLevel;
+    for (size_t i = 0; i < level.size(); ++i)
+    {
+      if (level[i]->left)
+        nextLevel.push_back(level[i]->left);
+      if (level[i]->right)
+        nextLevel.push_back(level[i]->right);
+    }
+    level.swap(nextLevel);
+  }
+
+  for (size_t i = 0; i < level.size(); ++i)
+    VanEmdeBoasOrder(level[i], height - topHeight, order);
+}
+
 /**
  * Serialize the tree.
  */
@@ -949,10 +1206,7 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    FreeChildren();
     if (!parent)
       delete dataset;
 
@@ -961,6 +1215,14 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     right = NULL;
   }
 
+  // The blob archives store the nodes as a flat array instead of a chain of
+  // tracked pointers.
+  if (data::IsBlobArchive<Archive>::value)
+  {
+    SerializeFlat(ar);
+    return;
+  }
+
   ar & BOOST_SERIALIZATION_NVP(begin);
   ar & BOOST_SERIALIZATION_NVP(count);
   ar & BOOST_SERIALIZATION_NVP(bound);
@@ -990,6 +1252,183 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   }
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename Archive>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    SerializeFlat(Archive& ar)
+{
+  ar & BOOST_SERIALIZATION_NVP(dataset);
+
+  size_t nodes = 0;
+  if (!Archive::is_loading::value)
+  {
+    // Count the nodes.
+    std::vector<BinarySpaceTree*> stack(1, this);
+    while (!stack.empty())
+    {
+      BinarySpaceTree* node = stack.back();
+      stack.pop_back();
+      ++nodes;
+
+      if (node->right)
+        stack.push_back(node->right);
+      if (node->left)
+        stack.push_back(node->left);
+    }
+  }
+  ar & BOOST_SERIALIZATION_NVP(nodes);
+
+  // Compact trees (from version 2 of the blob layout on) only hold the range
+  // of points of each node; everything else is rebuilt from the points.
+  bool compact = data::CompactTrees(ar) &&
+      bound::BoundTraits<BoundType<MetricType>>::RebuildableFromPoints;
+  if (data::BlobVersion(ar) >= 2)
+    ar & BOOST_SERIALIZATION_NVP(compact);
+
+  if (Archive::is_loading::value && nodes > 1)
+  {
+    // The arena is never resized, so the nodes keep their locations.  It is
+    // owned by this node as soon as it exists, so that a failed load doesn't
+    // leak it.
+    nodeArena = new std::vector<BinarySpaceTree>();
+    nodeArena->reserve(nodes - 1);
+  }
+
+  // When saving, the stack holds the nodes still to be written; when loading,
+  // it holds the parents whose left (true) or right (false) child is still to
+  // be read.  The left child is always on top, so nodes are visited in
+  // depth-first order.
+  std::vector<BinarySpaceTree*> stack(1, this);
+  std::vector<std::pair<BinarySpaceTree*, bool>> slots;
+  for (size_t i = 0; i < nodes; ++i)
+  {
+    BinarySpaceTree* node = this;
+    if (!Archive::is_loading::value)
+    {
+      node = stack.back();
+      stack.pop_back();
+    }
+    else if (i > 0)
+    {
+      if (slots.empty())
+      {
+        throw std::runtime_error("BinarySpaceTree::serialize(): the archive "
+            "holds more nodes than the tree has");
+      }
+
+      nodeArena->push_back(BinarySpaceTree());
+      node = &nodeArena->back();
+      node->parent = slots.back().first;
+      node->dataset = dataset;
+      if (slots.back().second)
+        node->parent->left = node;
+      else
+        node->parent->right = node;
+      slots.pop_back();
+    }
+
+    ar & boost::serialization::make_nvp("begin", node->begin);
+    ar & boost::serialization::make_nvp("count", node->count);
+    if (!compact)
+    {
+      ar & boost::serialization::make_nvp("bound", node->bound);
+      ar & boost::serialization::make_nvp("stat", node->stat);
+      ar & boost::serialization::make_nvp("parentDistance",
+          node->parentDistance);
+      ar & boost::serialization::make_nvp("furthestDescendantDistance",
+          node->furthestDescendantDistance);
+    }
+
+    bool hasLeft = (node->left != NULL);
+    bool hasRight = (node->right != NULL);
+    ar & BOOST_SERIALIZATION_NVP(hasLeft);
+    ar & BOOST_SERIALIZATION_NVP(hasRight);
+
+    if (!Archive::is_loading::value)
+    {
+      if (hasRight)
+        stack.push_back(node->right);
+      if (hasLeft)
+        stack.push_back(node->left);
+    }
+    else
+    {
+      if (hasRight)
+        slots.push_back(std::make_pair(node, false));
+      if (hasLeft)
+        slots.push_back(std::make_pair(node, true));
+    }
+  }
+
+  if (Archive::is_loading::value && !slots.empty())
+  {
+    throw std::runtime_error("BinarySpaceTree::serialize(): the archive holds "
+        "fewer nodes than the tree has");
+  }
+
+  if (Archive::is_loading::value && compact)
+    RebuildNodes();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RebuildNodes()
+{
+  // The nodes are this one followed by the arena, in depth-first order.
+  std::vector<BinarySpaceTree*> order(1, this);
+  if (nodeArena)
+  {
+    order.reserve(nodeArena->size() + 1);
+    for (size_t i = 0; i < nodeArena->size(); ++i)
+      order.push_back(&(*nodeArena)[i]);
+  }
+
+  // The bound of a right child may depend on that of its left sibling (see
+  // UpdateBound() for HollowBallBound), so right children are done last.
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (omp_size_t i = 0; i < (omp_size_t) order.size(); ++i)
+    {
+      BinarySpaceTree* node = order[i];
+      const bool rightChild = (node->parent && node->parent->left != node);
+      if (rightChild != (pass == 1))
+        continue;
+
+      node->bound = BoundType<MetricType>(dataset->n_rows);
+      node->UpdateBound(node->bound);
+      node->furthestDescendantDistance = 0.5 * node->bound.Diameter();
+    }
+  }
+
+  parentDistance = 0;
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 1; i < (omp_size_t) order.size(); ++i)
+  {
+    BinarySpaceTree* node = order[i];
+    arma::vec center, parentCenter;
+    node->Center(center);
+    node->parent->Center(parentCenter);
+    node->parentDistance = node->parent->bound.Metric().Evaluate(parentCenter,
+        center);
+  }
+
+  // Statistics are built after those of their descendants, as when the tree
+  // is built.
+  for (size_t i = order.size(); i > 0; --i)
+    order[i - 1]->stat = StatisticType(*order[i - 1]);
+}
+
 } // namespace tree
 } // namespace mlpack
 
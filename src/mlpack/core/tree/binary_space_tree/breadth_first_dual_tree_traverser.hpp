@@ -64,6 +64,21 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   void Traverse(BinarySpaceTree& queryNode,
                 std::priority_queue<QueueFrameType>& referenceQueue);
 
+  /**
+   * Process the queue of node combinations of one query node, without
+   * recursing into the query children: the combinations of the left and right
+   * query children are pushed into the given queues instead.  Traverse() calls
+   * this for each query node, and ParallelBreadthFirstDualTreeTraverser calls
+   * it for each query node of a level of the query tree.
+   *
+   * @param referenceQueue Combinations of the query node; this is emptied.
+   * @param leftChildQueue Queue of the left query child.
+   * @param rightChildQueue Queue of the right query child.
+   */
+  void Expand(std::priority_queue<QueueFrameType>& referenceQueue,
+              std::priority_queue<QueueFrameType>& leftChildQueue,
+              std::priority_queue<QueueFrameType>& rightChildQueue);
+
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
   //! Modify the number of prunes.
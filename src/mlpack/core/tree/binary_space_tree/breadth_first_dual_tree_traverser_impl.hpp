@@ -106,6 +106,29 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
   std::priority_queue<QueueFrameType> leftChildQueue;
   std::priority_queue<QueueFrameType> rightChildQueue;
 
+  Expand(referenceQueue, leftChildQueue, rightChildQueue);
+
+  // Now, recurse into the left and right children queues.  The order doesn't
+  // matter.
+  if (leftChildQueue.size() > 0)
+    Traverse(*queryNode.Left(), leftChildQueue);
+  if (rightChildQueue.size() > 0)
+    Traverse(*queryNode.Right(), rightChildQueue);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BreadthFirstDualTreeTraverser<RuleType>::Expand(
+    std::priority_queue<QueueFrameType>& referenceQueue,
+    std::priority_queue<QueueFrameType>& leftChildQueue,
+    std::priority_queue<QueueFrameType>& rightChildQueue)
+{
   while (!referenceQueue.empty())
   {
     QueueFrameType currentFrame = referenceQueue.top();
@@ -195,13 +218,6 @@ BreadthFirstDualTreeTraverser<RuleType>::Traverse(
       rightChildQueue.push(frr);
     }
   }
-
-  // Now, recurse into the left and right children queues.  The order doesn't
-  // matter.
-  if (leftChildQueue.size() > 0)
-    Traverse(*queryNode.Left(), leftChildQueue);
-  if (rightChildQueue.size() > 0)
-    Traverse(*queryNode.Right(), rightChildQueue);
 }
 
 } // namespace tree
@@ -59,6 +59,11 @@ DualTreeTraverser<RuleType>::Traverse(
   // If both are leaves, we must evaluate the base case.
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    // If the rules can evaluate the whole block of base cases at once, let
+    // them.
+    if (CallBaseCaseBlock(rule, queryNode, referenceNode, numBaseCases))
+      return;
+
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
@@ -0,0 +1,131 @@
+/**
+ * @file parallel_breadth_first_dual_tree_traverser.hpp
+ *
+ * Defines the ParallelBreadthFirstDualTreeTraverser for the BinarySpaceTree
+ * tree type.  This is a nested class of BinarySpaceTree which traverses two
+ * trees breadth-first like the BreadthFirstDualTreeTraverser, but processes
+ * the query nodes of each level of the query tree in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <queue>
+
+#include "../binary_space_tree.hpp"
+#include "breadth_first_dual_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The breadth-first traversal keeps the node combinations to visit in one
+ * queue per query node.  This traverser processes the queues of all the query
+ * nodes of a level of the query tree (the frontier) at the same time, one
+ * query node per thread, and then gathers the queues of their children into
+ * the next frontier.  Once the frontier holds enough query nodes to keep all
+ * the threads busy, each of them is finished by a
+ * BreadthFirstDualTreeTraverser.
+ *
+ * Since all the combinations of a query node are processed by the same
+ * thread, the updates of the rules to the statistics of a query node (like its
+ * bound in NeighborSearchRules) and to the results of its points never race.
+ * Each thread works with its own copy of the rules, so the rules must be
+ * copyable, and the copies must share the results with the original rules
+ * (this is the case of NeighborSearchRules, RangeSearchRules and KDERules);
+ * the numbers of base cases and scores of the copies are added to the
+ * original rules at the end.  The query nodes of a frontier may be in a
+ * different order than in the BreadthFirstDualTreeTraverser, so the pruning
+ * (but not the results of exact searches) may differ.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::ParallelBreadthFirstDualTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the dual-tree traverser with the given rule set.
+   *
+   * @param rule Rules to traverse the trees with.
+   * @param groupsPerThread Number of query nodes per thread in the frontier
+   *     at which each query node is finished depth-first.
+   */
+  ParallelBreadthFirstDualTreeTraverser(RuleType& rule,
+                                        const size_t groupsPerThread = 4);
+
+  //! Convenience typedef for the traverser used by each thread.
+  typedef typename BinarySpaceTree::template
+      BreadthFirstDualTreeTraverser<RuleType> TraverserType;
+
+  /**
+   * Traverse the two trees.  This does not reset the number of prunes.
+   *
+   * @param queryNode The query node to be traversed.
+   * @param referenceNode The reference node to be traversed.
+   */
+  void Traverse(BinarySpaceTree& queryNode,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the number of query nodes per thread of the last frontier.
+  size_t GroupsPerThread() const { return groupsPerThread; }
+  //! Modify the number of query nodes per thread of the last frontier.
+  size_t& GroupsPerThread() { return groupsPerThread; }
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! Reference to the rules with which the trees will be traversed.
+  RuleType& rule;
+
+  //! The number of query nodes per thread of the last frontier.
+  size_t groupsPerThread;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_breadth_first_dual_tree_traverser_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_DUAL_TREE_TRAVERSER_HPP
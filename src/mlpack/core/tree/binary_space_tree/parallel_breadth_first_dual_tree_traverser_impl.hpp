@@ -0,0 +1,170 @@
+/**
+ * @file parallel_breadth_first_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the ParallelBreadthFirstDualTreeTraverser for
+ * BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_breadth_first_dual_tree_traverser.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::
+ParallelBreadthFirstDualTreeTraverser(RuleType& rule,
+                                      const size_t groupsPerThread) :
+    rule(rule),
+    groupsPerThread(groupsPerThread),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+ParallelBreadthFirstDualTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        queryRoot,
+    BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>&
+        referenceRoot)
+{
+  typedef typename TraverserType::QueueFrameType QueueFrameType;
+  typedef std::priority_queue<QueueFrameType> QueueType;
+
+  // Increment the visit counter.
+  ++numVisited;
+
+  // Must score the root combination.
+  const double rootScore = rule.Score(queryRoot, referenceRoot);
+  if (rootScore == DBL_MAX)
+    return; // This probably means something is wrong.
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Each thread has its own copy of the rules, so that the base case cache and
+  // the traversal information are not shared.
+  std::vector<RuleType> rules(numThreads, rule);
+  const size_t baseCases = rule.BaseCases();
+  const size_t scores = rule.Scores();
+
+  // The frontier: the query nodes of a level of the query tree and their
+  // queues.
+  std::vector<BinarySpaceTree*> nodes(1, &queryRoot);
+  std::vector<QueueType> queues(1);
+
+  QueueFrameType rootFrame;
+  rootFrame.queryNode = &queryRoot;
+  rootFrame.referenceNode = &referenceRoot;
+  rootFrame.queryDepth = 0;
+  rootFrame.score = 0.0;
+  rootFrame.traversalInfo = rule.TraversalInfo();
+  queues[0].push(rootFrame);
+
+  size_t prunes = 0, visitedScores = 0, visitedBaseCases = 0;
+  while (!nodes.empty() && nodes.size() < groupsPerThread * numThreads)
+  {
+    std::vector<QueueType> childQueues(2 * nodes.size());
+
+    #pragma omp parallel for schedule(dynamic) \
+        reduction(+:prunes, visitedScores, visitedBaseCases)
+    for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+    {
+      size_t threadId = 0;
+      #ifdef HAS_OPENMP
+        threadId = omp_get_thread_num();
+      #endif
+
+      TraverserType traverser(rules[threadId]);
+      traverser.Expand(queues[i], childQueues[2 * i], childQueues[2 * i + 1]);
+
+      prunes += traverser.NumPrunes();
+      visitedScores += traverser.NumScores();
+      visitedBaseCases += traverser.NumBaseCases();
+    }
+
+    // Gather the query children with combinations left into the next
+    // frontier.
+    std::vector<BinarySpaceTree*> nextNodes;
+    std::vector<QueueType> nextQueues;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      if (!childQueues[2 * i].empty())
+      {
+        nextNodes.push_back(nodes[i]->Left());
+        nextQueues.push_back(std::move(childQueues[2 * i]));
+      }
+      if (!childQueues[2 * i + 1].empty())
+      {
+        nextNodes.push_back(nodes[i]->Right());
+        nextQueues.push_back(std::move(childQueues[2 * i + 1]));
+      }
+    }
+
+    nodes.swap(nextNodes);
+    queues.swap(nextQueues);
+  }
+
+  // The subtrees of the frontier are disjoint, so each of them can be finished
+  // independently.
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:prunes, visitedScores, visitedBaseCases)
+  for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    TraverserType traverser(rules[threadId]);
+    traverser.Traverse(*nodes[i], queues[i]);
+
+    prunes += traverser.NumPrunes();
+    visitedScores += traverser.NumScores();
+    visitedBaseCases += traverser.NumBaseCases();
+  }
+
+  numPrunes += prunes;
+  numScores += visitedScores;
+  numBaseCases += visitedBaseCases;
+
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    rule.BaseCases() += rules[t].BaseCases() - baseCases;
+    rule.Scores() += rules[t].Scores() - scores;
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_BINARY_SPACE_TREE_PARALLEL_BF_TRAVERSER_IMPL_HPP
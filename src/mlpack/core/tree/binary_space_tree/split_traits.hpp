@@ -0,0 +1,64 @@
+/**
+ * @file split_traits.hpp
+ *
+ * The SplitTraits class, which describes a split type of the BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_SPLIT_TRAITS_HPP
+
+#include "midpoint_split.hpp"
+#include "mean_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The SplitTraits class describes a split type of the BinarySpaceTree, in the
+ * same way as TreeTraits describes a tree type.  By default nothing is assumed
+ * about the split type; specialize this class for a split type to give it other
+ * characteristics.
+ *
+ * @tparam SplitType The split type in question.
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if the children of a node can be split in parallel with the
+   * same (shared) splitter object.  This requires the splitter to hold no state
+   * and to be deterministic (random splits would draw from the shared random
+   * number generator in an order that depends on the threads).
+   */
+  static const bool ParallelChildren = false;
+};
+
+/**
+ * The midpoint split is deterministic and only has static methods.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MidpointSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelChildren = true;
+};
+
+/**
+ * The mean split is deterministic and only has static methods.
+ */
+template<typename BoundType, typename MatType>
+class SplitTraits<MeanSplit<BoundType, MatType>>
+{
+ public:
+  static const bool ParallelChildren = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
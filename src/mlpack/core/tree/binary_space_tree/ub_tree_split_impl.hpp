@@ -147,8 +147,9 @@ void UBTreeSplit<BoundType, MatType>::InitializeAddresses(const MatType& data)
 {
   addresses.resize(data.n_cols);
 
-  // Calculate all addresses.
-  for (size_t i = 0; i < data.n_cols; i++)
+  // Calculate all addresses; each of them is independent.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; i++)
   {
     addresses[i].first.zeros(data.n_rows);
     bound::addr::PointToAddress(addresses[i].first, data.col(i));
@@ -29,6 +29,11 @@ struct BoundTraits
   //! bounds for each dimension may be looser than the range of all points held
   //! in the bound.  This defaults to false.
   static const bool HasTightBounds = false;
+
+  //! If true, then the bound of a tree node can be rebuilt from the points the
+  //! node holds (as the tree built it), so that trees can be saved without
+  //! their bounds.  This defaults to false.
+  static const bool RebuildableFromPoints = false;
 };
 
 } // namespace bound
@@ -312,6 +312,9 @@ struct BoundTraits<CellBound<MetricType, ElemType>>
 {
   //! These bounds are always tight for each dimension.
   const static bool HasTightBounds = true;
+
+  //! The addresses of these bounds are chosen when the tree is split.
+  const static bool RebuildableFromPoints = false;
 };
 
 } // namespace bound
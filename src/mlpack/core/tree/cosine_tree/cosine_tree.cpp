@@ -29,11 +29,12 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
+    l2NormsSquared(i) = arma::dot(dataset.unsafe_col(i),
+        dataset.unsafe_col(i));
   }
 
   // Frobenius norm of columns in the node.
@@ -94,6 +95,10 @@ CosineTree::CosineTree(const arma::mat& dataset,
   // Initialize Monte Carlo error estimate for comparison.
   double monteCarloError = root.FrobNormSquared();
 
+  // The basis vectors of the nodes in the queue, as the columns of a matrix,
+  // so that projections onto the current basis are matrix products.
+  arma::mat queueBasis;
+
   while (treeQueue.size() > 0 &&
          (monteCarloError > epsilon * root.FrobNormSquared()))
   {
@@ -126,24 +131,30 @@ CosineTree::CosineTree(const arma::mat& dataset,
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
+    QueueBasis(treeQueue, queueBasis);
+    ModifiedGramSchmidt(queueBasis, currentLeft->Centroid(), lBasisVector);
+    ModifiedGramSchmidt(queueBasis, currentRight->Centroid(), rBasisVector,
                         &lBasisVector);
 
     // Add basis vectors to their respective nodes.
     currentLeft->BasisVector(lBasisVector);
     currentRight->BasisVector(rBasisVector);
 
+    // Once the children are pushed, the basis of the queue is the current one
+    // with the two new basis vectors.
+    queueBasis.insert_cols(queueBasis.n_cols, lBasisVector);
+    queueBasis.insert_cols(queueBasis.n_cols, rBasisVector);
+
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, queueBasis);
+    MonteCarloError(currentRight, queueBasis);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
     // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    monteCarloError = MonteCarloError(&root, queueBasis);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -162,40 +173,64 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& centroid,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
+{
+  arma::mat queueBasis;
+  QueueBasis(treeQueue, queueBasis);
+  ModifiedGramSchmidt(queueBasis, centroid, newBasisVector, addBasisVector);
+}
+
+void CosineTree::ModifiedGramSchmidt(const arma::mat& basis,
+                                     const arma::vec& centroid,
+                                     arma::vec& newBasisVector,
+                                     const arma::vec* addBasisVector)
 {
   // Set new basis vector to centroid.
   newBasisVector = centroid;
 
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); i++)
+  // Remove the projection onto the current basis, and onto the additional
+  // basis vector if it is passed.  A single pass loses orthogonality when the
+  // centroid is nearly in the span of the basis, so the projections are
+  // removed a second time.
+  for (size_t pass = 0; pass < 2; ++pass)
   {
-    currentNode = *i;
-
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+    if (basis.n_cols > 0)
+    {
+      const arma::vec projections = basis.t() * newBasisVector;
+      newBasisVector -= basis * projections;
+    }
 
-  // If additional basis vector is passed, take it into account.
-  if (addBasisVector)
-  {
-    double projection = arma::dot(*addBasisVector, centroid);
-    newBasisVector -= *addBasisVector * projection;
+    if (addBasisVector)
+    {
+      const double projection = arma::dot(*addBasisVector, newBasisVector);
+      newBasisVector -= *addBasisVector * projection;
+    }
   }
 
   // Normalize the modified centroid vector.
-  if (arma::norm(newBasisVector, 2))
-    newBasisVector /= arma::norm(newBasisVector, 2);
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
 }
 
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  arma::mat queueBasis;
+  QueueBasis(treeQueue, queueBasis);
+
+  // If two additional vectors are passed, take their projections.
+  if (addBasisVector1 && addBasisVector2)
+  {
+    queueBasis.insert_cols(queueBasis.n_cols, *addBasisVector1);
+    queueBasis.insert_cols(queueBasis.n_cols, *addBasisVector2);
+  }
+
+  return MonteCarloError(node, queueBasis);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node, const arma::mat& basis)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -205,55 +240,27 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
-
-  // Initialize weighted projection magnitudes as zeros.
-  arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
+  // Gather the sampled columns of the original dataset.
+  const arma::mat& dataset = node->GetDataset();
+  arma::mat samples(dataset.n_rows, numSamples);
+  for (size_t i = 0; i < numSamples; i++)
+    samples.col(i) = dataset.col(sampledIndices[i]);
 
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
+  // Compute the projections of all the samples onto the existing subspace at
+  // once.
+  arma::mat projections;
+  if (basis.n_cols > 0)
+    projections = basis.t() * samples;
   else
-    projectionSize = treeQueue.size();
+    projections.zeros(1, numSamples);
 
-  // For each sample, calculate the weighted projection onto the current basis.
+  // For each sample, calculate the weighted projection magnitude; that is, the
+  // squared Frobenius norm of the projected vector over its probability.
+  arma::vec weightedMagnitudes(numSamples);
   for (size_t i = 0; i < numSamples; i++)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); j++, k++)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
+    weightedMagnitudes(i) = arma::dot(projections.col(i),
+        projections.col(i)) / probabilities(i);
   }
 
   // Compute mean and standard deviation of the weighted samples.
@@ -277,22 +284,26 @@ double CosineTree::MonteCarloError(CosineTree* node,
   return (node->FrobNormSquared() - lowerBound);
 }
 
-void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
+void CosineTree::QueueBasis(const CosineNodeQueue& treeQueue,
+                            arma::mat& basis)
 {
-  // Initialize basis as matrix of zeros.
-  basis.zeros(dataset.n_rows, treeQueue.size());
-
-  // Variables for iterating through the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
+  // The rows of the basis are those of the basis vectors; an empty queue
+  // gives an empty basis.
+  const size_t rows = (treeQueue.size() > 0) ?
+      (*treeQueue.begin())->BasisVector().n_elem : 0;
+  basis.set_size(rows, treeQueue.size());
 
   // Transfer basis vectors from the queue to the basis matrix.
   size_t j = 0;
+  CosineNodeQueue::const_iterator i = treeQueue.begin();
   for ( ; i != treeQueue.end(); i++, j++)
-  {
-    currentNode = *i;
-    basis.col(j) = currentNode->BasisVector();
-  }
+    basis.col(j) = (*i)->BasisVector();
+}
+
+void CosineTree::ConstructBasis(CosineNodeQueue& treeQueue)
+{
+  // Transfer basis vectors from the queue to the basis matrix.
+  QueueBasis(treeQueue, basis);
 }
 
 void CosineTree::CosineNodeSplit()
@@ -424,19 +435,24 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The norm of the splitting point is the same for every cosine.
+  const arma::vec splitPoint = dataset.col(indices[splitPointIndex]);
+  const double splitNorm = std::sqrt(l2NormsSquared(splitPointIndex));
+  if (splitNorm == 0)
+    return;
+
+  // This is the product of the transposed columns of the node with the
+  // splitting point, but without gathering the columns.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
-    {
-      cosines(i) = 0;
-    }
-    else
+    if (l2NormsSquared(i) != 0)
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i])));
+      cosines(i) = std::abs(arma::dot(splitPoint,
+          dataset.unsafe_col(indices[i]))) /
+          (splitNorm * std::sqrt(l2NormsSquared(i)));
     }
   }
 }
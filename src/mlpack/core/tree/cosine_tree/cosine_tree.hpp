@@ -87,6 +87,24 @@ class CosineTree
                            arma::vec& newBasisVector,
                            arma::vec* addBasisVector = NULL);
 
+  /**
+   * Calculates the orthonormalization of the passed centroid, with respect to
+   * the subspace spanned by the columns of the given orthonormal basis and the
+   * additional basis vector, if given.  The projections are removed with two
+   * passes of block Gram-Schmidt, each of which is a pair of matrix-vector
+   * products with the whole basis; the second pass restores the orthogonality
+   * lost to rounding errors.
+   *
+   * @param basis Matrix whose columns are the current basis vectors.
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   * @param addBasisVector Address to additional basis vector.
+   */
+  void ModifiedGramSchmidt(const arma::mat& basis,
+                           const arma::vec& centroid,
+                           arma::vec& newBasisVector,
+                           const arma::vec* addBasisVector = NULL);
+
   /**
    * Estimates the squared error of the projection of the input node's matrix
    * onto the current vector subspace. A normal distribution is fit using
@@ -104,6 +122,26 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the columns of the given orthonormal basis,
+   * as above.  The projections of all the samples are computed with one
+   * matrix product.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param basis Matrix whose columns are the current basis vectors.
+   */
+  double MonteCarloError(CosineTree* node, const arma::mat& basis);
+
+  /**
+   * Store the basis vectors of the nodes of the queue in the columns of the
+   * given matrix.
+   *
+   * @param treeQueue Priority queue of cosine nodes.
+   * @param basis Matrix to store the basis vectors in.
+   */
+  static void QueueBasis(const CosineNodeQueue& treeQueue, arma::mat& basis);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
@@ -153,7 +191,9 @@ class CosineTree
   /**
    * Calculate cosines of the columns present in the node, with respect to the
    * sampled splitting point. The calculated cosine values are useful for
-   * splitting the node into its children.
+   * splitting the node into its children.  The dot products of the columns
+   * with the splitting point are computed in parallel with OpenMP, and divided
+   * by the norms of the columns, which are already known.
    *
    * @param cosines Vector to store the cosine values in.
    */
@@ -15,6 +15,7 @@
 // In case it hasn't already been included.
 #include "cover_tree.hpp"
 
+#include <algorithm>
 #include <queue>
 #include <string>
 
@@ -1076,7 +1077,21 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
   // Now for each point in the near set, we need to make children.  To save
   // computation later, we'll create an array holding the points in the near
   // set, and then after each run we'll check which of those (if any) were used
-  // and we will remove them.  ...if that's faster.  I think it is.
+  // and we will remove them.  ...if that's faster.  I think it is.  The arrays
+  // are only needed while each child is built, so they are allocated once (the
+  // near and far sets only shrink) and reused for every child.
+  arma::Col<size_t> childIndices;
+  arma::vec childDistances;
+  if (nearSetSize > 0)
+  {
+    childIndices.set_size(nearSetSize + farSetSize);
+    childDistances.set_size(nearSetSize + farSetSize);
+  }
+
+  // A point further than this from a new child's point is pruned from the far
+  // set of the child.
+  const ElemType farBound = base * bound;
+
   while (nearSetSize > 0)
   {
     size_t newPointIndex = nearSetSize - 1;
@@ -1117,22 +1132,35 @@ CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::CreateChildren(
       break;
     }
 
-    // Create the near and far set indices and distance vectors.  We don't fill
-    // in the self-point, yet.
-    arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+    // Fill the near and far set indices.  We don't fill in the self-point, yet.
     childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
         nearSetSize + farSetSize - 1);
-    arma::vec childDistances(nearSetSize + farSetSize);
 
-    // Build distances for the child.
-    ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
-        + farSetSize - 1);
+    // Build distances for the child.  Our distances are to our own point, so
+    // by the triangle inequality the distance between the child's point and
+    // another point is at least the difference of their distances to our
+    // point.  If that is more than the far set bound, the point will be pruned
+    // anyway, and the lower bound is stored instead of computing the distance.
+    for (size_t i = 0; i < nearSetSize + farSetSize - 1; ++i)
+    {
+      const ElemType lowerBound = std::abs(distances[i + 1] - distances[0]);
+      if (lowerBound > farBound)
+      {
+        childDistances[i] = lowerBound;
+      }
+      else
+      {
+        childDistances[i] = metric->Evaluate(dataset->col(indices[0]),
+            dataset->col(childIndices[i]));
+        ++distanceComps;
+      }
+    }
 
     // Split into near and far sets for this point.
     childNearSetSize = SplitNearFar(childIndices, childDistances, bound,
         nearSetSize + farSetSize - 1);
     childFarSetSize = PruneFarSet(childIndices, childDistances,
-        base * bound, childNearSetSize,
+        farBound, childNearSetSize,
         (nearSetSize + farSetSize - 1));
 
     // Now that we know the near and far set sizes, we can put the used point
@@ -1263,53 +1291,19 @@ size_t CoverTree<MetricType, StatisticType, MatType, RootPointPolicy>::
                  const size_t childUsedSetSize,
                  const size_t farSetSize)
 {
-  // We'll use low-level memcpy calls ourselves, just to ensure it's done
-  // quickly and the way we want it to be.  Unfortunately this takes up more
-  // memory than one-element swaps, but there's not a great way around that.
-  const size_t bufferSize = std::min(farSetSize, childUsedSetSize);
-  const size_t bigCopySize = std::max(farSetSize, childUsedSetSize);
-
-  // Sanity check: there is no need to sort if the buffer size is going to be
-  // zero.
-  if (bufferSize == 0)
+  // Sanity check: there is no need to sort if either set to swap is empty.
+  if ((farSetSize == 0) || (childUsedSetSize == 0))
     return (childFarSetSize + farSetSize);
 
-  size_t* indicesBuffer = new size_t[bufferSize];
-  ElemType* distancesBuffer = new ElemType[bufferSize];
-
-  // The start of the memory region to copy to the buffer.
-  const size_t bufferFromLocation = ((bufferSize == farSetSize) ?
-      (childFarSetSize + childUsedSetSize) : childFarSetSize);
-  // The start of the memory region to move directly to the new place.
-  const size_t directFromLocation = ((bufferSize == farSetSize) ?
-      childFarSetSize : (childFarSetSize + childUsedSetSize));
-  // The destination to copy the buffer back to.
-  const size_t bufferToLocation = ((bufferSize == farSetSize) ?
-      childFarSetSize : (childFarSetSize + farSetSize));
-  // The destination of the directly moved memory region.
-  const size_t directToLocation = ((bufferSize == farSetSize) ?
-      (childFarSetSize + farSetSize) : childFarSetSize);
-
-  // Copy the smaller piece to the buffer.
-  memcpy(indicesBuffer, indices.memptr() + bufferFromLocation,
-      sizeof(size_t) * bufferSize);
-  memcpy(distancesBuffer, distances.memptr() + bufferFromLocation,
-      sizeof(ElemType) * bufferSize);
-
-  // Now move the other memory.
-  memmove(indices.memptr() + directToLocation,
-      indices.memptr() + directFromLocation, sizeof(size_t) * bigCopySize);
-  memmove(distances.memptr() + directToLocation,
-      distances.memptr() + directFromLocation, sizeof(ElemType) * bigCopySize);
-
-  // Now copy the temporary memory to the right place.
-  memcpy(indices.memptr() + bufferToLocation, indicesBuffer,
-      sizeof(size_t) * bufferSize);
-  memcpy(distances.memptr() + bufferToLocation, distancesBuffer,
-      sizeof(ElemType) * bufferSize);
-
-  delete[] indicesBuffer;
-  delete[] distancesBuffer;
+  // Swapping the two blocks is a rotation, which can be done in place (so no
+  // buffer has to be allocated) and keeps the order inside each block.
+  const size_t first = childFarSetSize;
+  const size_t middle = childFarSetSize + childUsedSetSize;
+  const size_t last = childFarSetSize + childUsedSetSize + farSetSize;
+  std::rotate(indices.memptr() + first, indices.memptr() + middle,
+      indices.memptr() + last);
+  std::rotate(distances.memptr() + first, distances.memptr() + middle,
+      distances.memptr() + last);
 
   // This returns the complete size of the far set.
   return (childFarSetSize + farSetSize);
@@ -15,6 +15,8 @@
 #define MLPACK_CORE_TREE_GREEDY_SINGLE_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include <mlpack/core/tree/tree_traits.hpp>
 
 namespace mlpack {
 namespace tree {
@@ -37,6 +39,21 @@ class GreedySingleTreeTraverser
    */
   void Traverse(const size_t queryIndex, TreeType& referenceNode);
 
+  /**
+   * Traverse the tree with a block of query points at once.  Each query point
+   * descends into the same child as with the other overload, but the block is
+   * partitioned at each node by the chosen child, so that each node is visited
+   * once per block, and the base cases of the query points that reach a leaf
+   * are performed together (with one matrix multiplication, if the rules
+   * provide BaseCaseBatch() and the block is large enough).
+   *
+   * @param queryIndices The indices of the points in the query set which are
+   *     being used as query points.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const std::vector<size_t>& queryIndices,
+                TreeType& referenceNode);
+
   //! Get the number of prunes.
   size_t NumPrunes() const { return numPrunes; }
 
@@ -56,6 +73,16 @@ class GreedySingleTreeTraverser
   //! The number of base cases required. For example the number of nearest
   //! neighbours(k) in case of knn.
   size_t minBaseCases;
+
+  /**
+   * Traverse the tree with the query points queries[begin, end), which are
+   * reordered by the child they descend into.
+   */
+  void TraverseBlock(std::vector<size_t>& queries,
+                     std::vector<size_t>& bestChildren,
+                     const size_t begin,
+                     const size_t end,
+                     TreeType& referenceNode);
 };
 
 } // namespace tree
@@ -68,6 +68,90 @@ void GreedySingleTreeTraverser<TreeType, RuleType>::Traverse(
   }
 }
 
+template<typename TreeType, typename RuleType>
+void GreedySingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const std::vector<size_t>& queryIndices,
+    TreeType& referenceNode)
+{
+  std::vector<size_t> queries(queryIndices);
+  std::vector<size_t> bestChildren(queries.size());
+  TraverseBlock(queries, bestChildren, 0, queries.size(), referenceNode);
+}
+
+template<typename TreeType, typename RuleType>
+void GreedySingleTreeTraverser<TreeType, RuleType>::TraverseBlock(
+    std::vector<size_t>& queries,
+    std::vector<size_t>& bestChildren,
+    const size_t begin,
+    const size_t end,
+    TreeType& referenceNode)
+{
+  if (referenceNode.IsLeaf())
+  {
+    // If the children of the tree may hold the points of their parents, the
+    // rules skip the repeated base cases only if they are consecutive, so they
+    // must be performed one query point at a time.
+    size_t numBaseCases = 0;
+    if (TreeTraits<TreeType>::HasSelfChildren ||
+        !CallBaseCaseBatch(rule, std::vector<size_t>(queries.begin() + begin,
+        queries.begin() + end), referenceNode, numBaseCases))
+    {
+      for (size_t q = begin; q < end; ++q)
+        for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
+          rule.BaseCase(queries[q], referenceNode.Point(i));
+    }
+
+    return;
+  }
+
+  // Find the best child of each query point; the query points whose best child
+  // has too few descendants run the base cases over the first minBaseCases
+  // descendants instead, and are marked with an invalid child.
+  const size_t numChildren = referenceNode.NumChildren();
+  for (size_t q = begin; q < end; ++q)
+  {
+    const size_t queryIndex = queries[q];
+    for (size_t i = 0; i < referenceNode.NumPoints(); ++i)
+      rule.BaseCase(queryIndex, referenceNode.Point(i));
+
+    bestChildren[q] = rule.GetBestChild(queryIndex, referenceNode);
+    if (referenceNode.Child(bestChildren[q]).NumDescendants() > minBaseCases)
+    {
+      // We are prunning all but one child.
+      numPrunes += numChildren - 1;
+    }
+    else
+    {
+      for (size_t i = 0; i <= minBaseCases; ++i)
+        rule.BaseCase(queryIndex, referenceNode.Descendant(i));
+      bestChildren[q] = numChildren;
+    }
+  }
+
+  // Sort the query points by their best child with a counting sort.
+  std::vector<size_t> offsets(numChildren + 2, 0);
+  for (size_t q = begin; q < end; ++q)
+    ++offsets[bestChildren[q] + 1];
+  for (size_t c = 1; c < offsets.size(); ++c)
+    offsets[c] += offsets[c - 1];
+
+  std::vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  std::vector<size_t> sorted(end - begin);
+  for (size_t q = begin; q < end; ++q)
+    sorted[next[bestChildren[q]]++] = queries[q];
+  std::copy(sorted.begin(), sorted.end(), queries.begin() + begin);
+
+  // Recurse into each child with the query points that chose it.
+  for (size_t c = 0; c < numChildren; ++c)
+  {
+    if (offsets[c + 1] > offsets[c])
+    {
+      TraverseBlock(queries, bestChildren, begin + offsets[c],
+          begin + offsets[c + 1], referenceNode.Child(c));
+    }
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -223,6 +223,8 @@ struct BoundTraits<HollowBallBound<MetricType, ElemType>>
 {
   //! These bounds are potentially loose in some dimensions.
   const static bool HasTightBounds = false;
+  //! These bounds only depend on the points they hold.
+  const static bool RebuildableFromPoints = true;
 };
 
 } // namespace bound
@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/range.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/fixed_lmetric.hpp>
 #include "bound_traits.hpp"
 
 namespace mlpack {
@@ -39,6 +40,13 @@ struct IsLMetric<metric::LMetric<Power, TakeRoot>>
   static const bool Value = true;
 };
 
+//! Specialization for IsLMetric when the argument is of type FixedLMetric.
+template<size_t Dimensionality, int Power, bool TakeRoot>
+struct IsLMetric<metric::FixedLMetric<Dimensionality, Power, TakeRoot>>
+{
+  static const bool Value = true;
+};
+
 } // namespace meta
 
 /**
@@ -162,6 +170,18 @@ class HRectBound
    */
   math::RangeType<ElemType> RangeDistance(const HRectBound& other) const;
 
+  /**
+   * Calculates minimum and maximum bound-to-bound distances to each of the
+   * given bounds, such as the children of a node, in one pass over the
+   * dimensions of this bound.
+   *
+   * @param others Bounds to which the distances are requested.
+   * @param ranges Vector to store the minimum and maximum distance to each of
+   *     the bounds in.
+   */
+  void RangeDistance(const std::vector<const HRectBound*>& others,
+                     std::vector<math::RangeType<ElemType>>& ranges) const;
+
   /**
    * Calculates minimum and maximum bound-to-point distance.
    *
@@ -226,6 +246,12 @@ class HRectBound
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! Raise the distance in one dimension to the power of the metric.
+  static ElemType Power(const ElemType v);
+
+  //! Take the root of a sum of powers, if the metric takes it.
+  static ElemType Root(const ElemType sum);
+
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
@@ -242,6 +268,8 @@ struct BoundTraits<HRectBound<MetricType, ElemType>>
 {
   //! These bounds are always tight for each dimension.
   const static bool HasTightBounds = true;
+  //! These bounds only depend on the points they hold.
+  const static bool RebuildableFromPoints = true;
 };
 
 } // namespace bound
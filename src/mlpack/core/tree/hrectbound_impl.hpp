@@ -170,51 +170,18 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
   Log::Assert(point.n_elem == dim);
 
   ElemType sum = 0;
-
-  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
-    lower = bounds[d].Lo() - point[d];
-    higher = point[d] - bounds[d].Hi();
-
-    // Since only one of 'lower' or 'higher' is negative, if we add each's
-    // absolute value to itself and then sum those two, our result is the
-    // nonnegative half of the equation times two; then we raise to power Power.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
+    // At most one of the gaps below and above the bound is positive, so the
+    // distance in this dimension is the sum of their positive parts.  This has
+    // no branches, so the compiler can vectorize the loop.
+    const ElemType lower = bounds[d].Lo() - point[d];
+    const ElemType higher = point[d] - bounds[d].Hi();
+    sum += Power(std::max(lower, (ElemType) 0) +
+        std::max(higher, (ElemType) 0));
   }
 
-  // Now take the Power'th root (but make sure our result is squared if it needs
-  // to be); then cancel out the constant of 2 (which may have been squared now)
-  // that was introduced earlier.  The compiler should optimize out the if
-  // statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  return Root(sum);
 }
 
 /**
@@ -229,53 +196,16 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
   ElemType sum = 0;
   const math::RangeType<ElemType>* mbound = bounds;
   const math::RangeType<ElemType>* obound = other.bounds;
-
-  ElemType lower, higher;
   for (size_t d = 0; d < dim; d++)
   {
-    lower = obound->Lo() - mbound->Hi();
-    higher = mbound->Lo() - obound->Hi();
-    // We invoke the following:
-    //   x + fabs(x) = max(x * 2, 0)
-    //   (x * 2)^2 / 4 = x^2
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-    else if (MetricType::Power == 2)
-    {
-      ElemType dist = (lower + std::fabs(lower)) + (higher + std::fabs(higher));
-      sum += dist * dist;
-    }
-    else
-    {
-      sum += pow((lower + fabs(lower)) + (higher + fabs(higher)),
-          (ElemType) MetricType::Power);
-    }
-
-    // Move bound pointers.
-    mbound++;
-    obound++;
+    // At most one of the gaps between the bounds is positive.
+    const ElemType lower = obound[d].Lo() - mbound[d].Hi();
+    const ElemType higher = mbound[d].Lo() - obound[d].Hi();
+    sum += Power(std::max(lower, (ElemType) 0) +
+        std::max(higher, (ElemType) 0));
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::Power == 1)
-    return sum * 0.5;
-  else if (MetricType::Power == 2)
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) std::sqrt(sum) * 0.5;
-    else
-      return sum * 0.25;
-  }
-  else
-  {
-    if (MetricType::TakeRoot)
-      return (ElemType) pow((double) sum,
-          1.0 / (double) MetricType::Power) / 2.0;
-    else
-      return sum / pow(2.0, MetricType::Power);
-  }
+  return Root(sum);
 }
 
 /**
@@ -287,36 +217,17 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType sum = 0;
-
   Log::Assert(point.n_elem == dim);
 
+  ElemType sum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - point[d]));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    const ElemType v = std::max(std::fabs(point[d] - bounds[d].Lo()),
+        std::fabs(bounds[d].Hi() - point[d]));
+    sum += Power(v);
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Root(sum);
 }
 
 /**
@@ -327,37 +238,17 @@ inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
 {
-  ElemType sum = 0;
-
   Log::Assert(dim == other.dim);
 
-  ElemType v;
+  ElemType sum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
-        fabs(bounds[d].Hi() - other.bounds[d].Lo()));
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-      sum += v; // v is non-negative.
-    else if (MetricType::Power == 2)
-      sum += v * v;
-    else
-      sum += std::pow(v, (ElemType) MetricType::Power);
+    const ElemType v = std::max(std::fabs(other.bounds[d].Hi() -
+        bounds[d].Lo()), std::fabs(bounds[d].Hi() - other.bounds[d].Lo()));
+    sum += Power(v);
   }
 
-  // The compiler should optimize out this if statement entirely.
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return sum;
-    else if (MetricType::Power == 2)
-      return (ElemType) std::sqrt(sum);
-    else
-      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
-  }
-  else
-    return sum;
+  return Root(sum);
 }
 
 /**
@@ -368,62 +259,56 @@ inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const HRectBound& other) const
 {
+  Log::Assert(dim == other.dim);
+
   ElemType loSum = 0;
   ElemType hiSum = 0;
+  for (size_t d = 0; d < dim; d++)
+  {
+    // One of v1 or v2 is negative; the larger one, if it is positive, is the
+    // gap between the bounds, and the negation of the smaller one is the
+    // largest distance between them.
+    const ElemType v1 = other.bounds[d].Lo() - bounds[d].Hi();
+    const ElemType v2 = bounds[d].Lo() - other.bounds[d].Hi();
+    loSum += Power(std::max(std::max(v1, v2), (ElemType) 0));
+    hiSum += Power(-std::min(v1, v2));
+  }
 
-  Log::Assert(dim == other.dim);
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
+}
 
-  ElemType v1, v2, vLo, vHi;
+/**
+ * Calculates minimum and maximum bound-to-bound distances to several bounds.
+ */
+template<typename MetricType, typename ElemType>
+inline void HRectBound<MetricType, ElemType>::RangeDistance(
+    const std::vector<const HRectBound*>& others,
+    std::vector<math::RangeType<ElemType>>& ranges) const
+{
+  const size_t n = others.size();
+
+  // Accumulate the sums of all the bounds together, so that each dimension of
+  // this bound is only read once.
+  std::vector<ElemType> sums(2 * n, 0);
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = other.bounds[d].Lo() - bounds[d].Hi();
-    v2 = bounds[d].Lo() - other.bounds[d].Hi();
-    // One of v1 or v2 is negative.
-    if (v1 >= v2)
-    {
-      vHi = -v2; // Make it nonnegative.
-      vLo = (v1 > 0) ? v1 : 0; // Force to be 0 if negative.
-    }
-    else
+    const ElemType lo = bounds[d].Lo();
+    const ElemType hi = bounds[d].Hi();
+    for (size_t i = 0; i < n; i++)
     {
-      vHi = -v1; // Make it nonnegative.
-      vLo = (v2 > 0) ? v2 : 0; // Force to be 0 if negative.
-    }
+      Log::Assert(dim == others[i]->dim);
 
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
+      const ElemType v1 = others[i]->bounds[d].Lo() - hi;
+      const ElemType v2 = lo - others[i]->bounds[d].Hi();
+      sums[2 * i] += Power(std::max(std::max(v1, v2), (ElemType) 0));
+      sums[2 * i + 1] += Power(-std::min(v1, v2));
     }
   }
 
-  if (MetricType::TakeRoot)
-  {
-    if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
-    else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
-    else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
-  }
-  else
-    return math::RangeType<ElemType>(loSum, hiSum);
+  ranges.resize(n);
+  for (size_t i = 0; i < n; i++)
+    ranges[i] = math::RangeType<ElemType>(Root(sums[2 * i]),
+        Root(sums[2 * i + 1]));
 }
 
 /**
@@ -436,70 +321,56 @@ HRectBound<MetricType, ElemType>::RangeDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  ElemType loSum = 0;
-  ElemType hiSum = 0;
-
   Log::Assert(point.n_elem == dim);
 
-  ElemType v1, v2, vLo, vHi;
+  ElemType loSum = 0;
+  ElemType hiSum = 0;
   for (size_t d = 0; d < dim; d++)
   {
-    v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
-    v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
-    // One of v1 or v2 (or both) is negative.
-    if (v1 >= 0) // point[d] <= bounds_[d].Lo().
-    {
-      vHi = -v2; // v2 will be larger but must be negated.
-      vLo = v1;
-    }
-    else // point[d] is between lo and hi, or greater than hi.
-    {
-      if (v2 >= 0)
-      {
-        vHi = -v1; // v1 will be larger, but must be negated.
-        vLo = v2;
-      }
-      else
-      {
-        vHi = -std::min(v1, v2); // Both are negative, but we need the larger.
-        vLo = 0;
-      }
-    }
-
-    // The compiler should optimize out this if statement entirely.
-    if (MetricType::Power == 1)
-    {
-      loSum += vLo; // vLo is non-negative.
-      hiSum += vHi; // vHi is non-negative.
-    }
-    else if (MetricType::Power == 2)
-    {
-      loSum += vLo * vLo;
-      hiSum += vHi * vHi;
-    }
-    else
-    {
-      loSum += std::pow(vLo, (ElemType) MetricType::Power);
-      hiSum += std::pow(vHi, (ElemType) MetricType::Power);
-    }
+    // One of v1 or v2 (or both) is negative; as for two bounds, the larger one
+    // gives the smallest distance and the smaller one the largest.
+    const ElemType v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
+    const ElemType v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
+    loSum += Power(std::max(std::max(v1, v2), (ElemType) 0));
+    hiSum += Power(-std::min(v1, v2));
   }
 
+  return math::RangeType<ElemType>(Root(loSum), Root(hiSum));
+}
+
+/**
+ * Raise the distance in one dimension to the power of the metric.
+ */
+template<typename MetricType, typename ElemType>
+inline ElemType HRectBound<MetricType, ElemType>::Power(const ElemType v)
+{
+  // The compiler should optimize out this if statement entirely.
+  if (MetricType::Power == 1)
+    return v; // v is non-negative.
+  else if (MetricType::Power == 2)
+    return v * v;
+  else
+    return std::pow(v, (ElemType) MetricType::Power);
+}
+
+/**
+ * Take the root of a sum of powers, if the metric takes it.
+ */
+template<typename MetricType, typename ElemType>
+inline ElemType HRectBound<MetricType, ElemType>::Root(const ElemType sum)
+{
+  // The compiler should optimize out this if statement entirely.
   if (MetricType::TakeRoot)
   {
     if (MetricType::Power == 1)
-      return math::RangeType<ElemType>(loSum, hiSum);
+      return sum;
     else if (MetricType::Power == 2)
-      return math::RangeType<ElemType>((ElemType) std::sqrt(loSum),
-                                       (ElemType) std::sqrt(hiSum));
+      return (ElemType) std::sqrt(sum);
     else
-    {
-      return math::RangeType<ElemType>(
-          (ElemType) pow((double) loSum, 1.0 / (double) MetricType::Power),
-          (ElemType) pow((double) hiSum, 1.0 / (double) MetricType::Power));
-    }
+      return (ElemType) pow((double) sum, 1.0 / (double) MetricType::Power);
   }
   else
-    return math::RangeType<ElemType>(loSum, hiSum);
+    return sum;
 }
 
 /**
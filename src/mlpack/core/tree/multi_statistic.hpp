@@ -0,0 +1,161 @@
+/**
+ * @file multi_statistic.hpp
+ *
+ * Definition of MultiStatistic, a tree statistic that holds the statistics of
+ * several methods, so that one tree can be used by all of them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_MULTI_STATISTIC_HPP
+#define MLPACK_CORE_TREE_MULTI_STATISTIC_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A statistic made of the statistics of several methods.  A tree built with a
+ * MultiStatistic holds, in each node, one statistic of each of the given types,
+ * and each method gets its own statistic of a node with GetStatistic().  So a
+ * tree (and its rearranged dataset) can be built once and then be given to
+ * each of the methods, instead of building one tree for each of them:
+ *
+ * @code
+ * typedef MultiStatistic<NeighborSearchStat<NearestNeighborSort>,
+ *     RangeSearchStat> StatisticType;
+ * @endcode
+ *
+ * The statistic types must all be different.  Each one is constructed with the
+ * node when the node is finished, as usual.
+ *
+ * @tparam StatisticTypes Types of the statistics to hold.
+ */
+template<typename... StatisticTypes>
+class MultiStatistic;
+
+/**
+ * The end of the list of statistics, which holds nothing.
+ */
+template<>
+class MultiStatistic<>
+{
+ public:
+  //! Nothing to do for the default constructor.
+  MultiStatistic() { }
+
+  //! Nothing to do when the node is finished.
+  template<typename TreeType>
+  MultiStatistic(TreeType& /* node */) { }
+
+  //! There's nothing to serialize.
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ protected:
+  //! Tag type to find the statistic of a given type.
+  template<typename StatisticType>
+  struct Tag { };
+
+  //! The end of the overloads of Component() (it is never called).
+  void Component() { }
+};
+
+/**
+ * The first statistic of the list, followed by the others.
+ */
+template<typename StatisticType, typename... OtherStatisticTypes>
+class MultiStatistic<StatisticType, OtherStatisticTypes...> :
+    public MultiStatistic<OtherStatisticTypes...>
+{
+ public:
+  //! Default-construct each of the statistics.
+  MultiStatistic() { }
+
+  /**
+   * Construct each of the statistics for the given finished node.
+   *
+   * @param node Node which this corresponds to.
+   */
+  template<typename TreeType>
+  MultiStatistic(TreeType& node) :
+      MultiStatistic<OtherStatisticTypes...>(node),
+      statistic(node)
+  { }
+
+  //! Get the statistic of the given type.
+  template<typename T>
+  const T& Get() const { return this->Component(Tag<T>()); }
+  //! Modify the statistic of the given type.
+  template<typename T>
+  T& Get() { return this->Component(Tag<T>()); }
+
+  //! Serialize each of the statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version)
+  {
+    ar & BOOST_SERIALIZATION_NVP(statistic);
+    MultiStatistic<OtherStatisticTypes...>::serialize(ar, version);
+  }
+
+ protected:
+  template<typename T>
+  using Tag = typename MultiStatistic<>::template Tag<T>;
+
+  using MultiStatistic<OtherStatisticTypes...>::Component;
+
+  //! Get the statistic of this level of the list.
+  const StatisticType& Component(Tag<StatisticType>) const { return statistic; }
+  //! Modify the statistic of this level of the list.
+  StatisticType& Component(Tag<StatisticType>) { return statistic; }
+
+ private:
+  //! The statistic of this type.
+  StatisticType statistic;
+};
+
+/**
+ * Get the statistic of the given type from the statistic of a node.  This is
+ * the statistic itself (or its base class of the given type), unless the node
+ * holds a MultiStatistic, in which case it is the statistic of the given type
+ * held by the MultiStatistic.  Methods that may run on trees shared with other
+ * methods access the statistics of the nodes with this, as in
+ * GetStatistic<RangeSearchStat>(node.Stat()).
+ *
+ * @param statistic Statistic of a node.
+ */
+template<typename StatisticType, typename NodeStatisticType>
+inline StatisticType& GetStatistic(NodeStatisticType& statistic)
+{
+  return statistic;
+}
+
+//! Get the statistic of the given type from the statistic of a node (const).
+template<typename StatisticType, typename NodeStatisticType>
+inline const StatisticType& GetStatistic(const NodeStatisticType& statistic)
+{
+  return statistic;
+}
+
+//! Get the statistic of the given type held by a MultiStatistic.
+template<typename StatisticType, typename... StatisticTypes>
+inline StatisticType& GetStatistic(MultiStatistic<StatisticTypes...>& statistic)
+{
+  return statistic.template Get<StatisticType>();
+}
+
+//! Get the statistic of the given type held by a MultiStatistic (const).
+template<typename StatisticType, typename... StatisticTypes>
+inline const StatisticType& GetStatistic(
+    const MultiStatistic<StatisticTypes...>& statistic)
+{
+  return statistic.template Get<StatisticType>();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
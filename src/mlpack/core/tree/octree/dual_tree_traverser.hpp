@@ -13,6 +13,7 @@
 #define MLPACK_CORE_TREE_OCTREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
 #include "octree.hpp"
 
 namespace mlpack {
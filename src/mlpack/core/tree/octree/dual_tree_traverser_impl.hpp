@@ -44,6 +44,11 @@ void Octree<MetricType, StatisticType, MatType>::DualTreeTraverser<RuleType>::
 
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    // If the rules can evaluate the whole block of base cases at once, let
+    // them.
+    if (CallBaseCaseBlock(rule, queryNode, referenceNode, numBaseCases))
+      return;
+
     const size_t begin = queryNode.Point(0);
     const size_t end = begin + queryNode.NumPoints();
     for (size_t q = begin; q < end; ++q)
@@ -425,6 +425,42 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Sort the points of the root node by their Morton (Z-order) code: the
+   * sequence of the children that the point falls in at each of the first
+   * levels of the tree, computed with the same centers as SplitNode().  The
+   * codes are computed in parallel and the points are sorted once, with a
+   * radix sort, so the splits of those levels find the points already in
+   * order and do not swap any column; the leaves also end up in Z-order in
+   * the dataset.  The tree is the same as without the sort.
+   *
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new, or NULL if the mappings are not
+   *     tracked.
+   */
+  void MortonSort(const arma::vec& center,
+                  const double width,
+                  std::vector<size_t>* oldFromNew);
+
+  /**
+   * Create the children of this node, once its points have been sorted into
+   * the children.  Large subtrees are built in parallel with OpenMP tasks.
+   *
+   * @param childBegins Index of the first point of each child, followed by the
+   *     index after the last point of the node.
+   * @param center Center of the node.
+   * @param width Width of the current node.
+   * @param oldFromNew Mappings from old to new, or NULL if the mappings are not
+   *     tracked.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void BuildChildren(const arma::Col<size_t>& childBegins,
+                     const arma::vec& center,
+                     const double width,
+                     std::vector<size_t>* oldFromNew,
+                     const size_t maxLeafSize);
+
   /**
    * This is used for sorting points while splitting.
    */
@@ -16,6 +16,10 @@
 #include <mlpack/core/tree/perform_split.hpp>
 #include <stack>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -676,6 +680,11 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   if (count <= maxLeafSize)
     return;
 
+  // The root sorts all the points at once, so that the splits below it are
+  // cheap.
+  if (parent == NULL)
+    MortonSort(center, width, NULL);
+
   // This will hold the index of the first point in each child.
   arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
   childBegins[0] = begin;
@@ -741,28 +750,7 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
-  const double childWidth = width / 2.0;
-  for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
-  {
-    // If the child has no points, don't create it.
-    if (childBegins[i + 1] - childBegins[i] == 0)
-      continue;
-
-    // Create the correct center.
-    for (size_t d = 0; d < center.n_elem; ++d)
-    {
-      // Is the dimension "right" (1) or "left" (0)?
-      if (((i >> d) & 1) == 0)
-        childCenter[d] = center[d] - childWidth;
-      else
-        childCenter[d] = center[d] + childWidth;
-    }
-
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], childCenter, childWidth,
-        maxLeafSize));
-  }
+  BuildChildren(childBegins, center, width, NULL, maxLeafSize);
 }
 
 //! Split the node, and store mappings.
@@ -778,6 +766,11 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   if (count <= maxLeafSize)
     return;
 
+  // The root sorts all the points at once, so that the splits below it are
+  // cheap.
+  if (parent == NULL)
+    MortonSort(center, width, &oldFromNew);
+
   // This will hold the index of the first point in each child.
   arma::Col<size_t> childBegins(((size_t) 1 << dataset->n_rows) + 1);
   childBegins[0] = begin;
@@ -843,15 +836,117 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 
   // Now that the dataset is reordered, we can create the children.
-  arma::vec childCenter(center.n_elem);
+  BuildChildren(childBegins, center, width, &oldFromNew, maxLeafSize);
+}
+
+//! Sort the points of the node in Z-order.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonSort(
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew)
+{
+  // Each level takes one bit per dimension of the 64-bit codes.  With too many
+  // dimensions, the codes would not even hold two levels.
+  const size_t dims = dataset->n_rows;
+  const size_t levels = (dims == 0) ? 0 : 64 / dims;
+  if (levels < 2)
+    return;
+
+  // The code of a point is found by descending the levels of the tree, with
+  // the same arithmetic as SplitNode() and BuildChildren(), so that the codes
+  // agree exactly with the splits.
+  std::vector<uint64_t> codes(count);
+  #pragma omp parallel
+  {
+    arma::vec nodeCenter;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+    {
+      nodeCenter = center;
+      double nodeWidth = width;
+      uint64_t code = 0;
+      for (size_t l = 0; l < levels; ++l)
+      {
+        const double childWidth = nodeWidth / 2.0;
+        uint64_t child = 0;
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if ((*dataset)(d, begin + i) < nodeCenter[d])
+          {
+            nodeCenter[d] -= childWidth;
+          }
+          else
+          {
+            child |= ((uint64_t) 1 << d);
+            nodeCenter[d] += childWidth;
+          }
+        }
+
+        code = (code << dims) | child;
+        nodeWidth = childWidth;
+      }
+
+      codes[i] = code;
+    }
+  }
+
+  // Sort the points by code with a (stable) LSD radix sort, one byte at a
+  // time.
+  std::vector<size_t> order(count), buffer(count);
+  for (size_t i = 0; i < count; ++i)
+    order[i] = i;
+
+  for (size_t shift = 0; shift < levels * dims; shift += 8)
+  {
+    std::vector<size_t> offsets(257, 0);
+    for (size_t i = 0; i < count; ++i)
+      ++offsets[((codes[order[i]] >> shift) & 255) + 1];
+    for (size_t b = 1; b < offsets.size(); ++b)
+      offsets[b] += offsets[b - 1];
+
+    for (size_t i = 0; i < count; ++i)
+      buffer[offsets[(codes[order[i]] >> shift) & 255]++] = order[i];
+    order.swap(buffer);
+  }
+
+  // Now move each column once.
+  arma::uvec columns(count);
+  for (size_t i = 0; i < count; ++i)
+    columns[i] = begin + order[i];
+  MatType sorted = dataset->cols(columns);
+  dataset->cols(begin, begin + count - 1) = sorted;
+
+  if (oldFromNew)
+  {
+    for (size_t i = 0; i < count; ++i)
+      buffer[i] = (*oldFromNew)[begin + order[i]];
+    std::copy(buffer.begin(), buffer.end(), oldFromNew->begin() + begin);
+  }
+}
+
+//! Create the children of the node.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::BuildChildren(
+    const arma::Col<size_t>& childBegins,
+    const arma::vec& center,
+    const double width,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  // Collect the children that hold points, with their centers.  Children with
+  // no points are not created.
+  std::vector<size_t> begins, counts;
+  std::vector<arma::vec> centers;
   const double childWidth = width / 2.0;
   for (size_t i = 0; i < childBegins.n_elem - 1; ++i)
   {
-    // If the child has no points, don't create it.
     if (childBegins[i + 1] - childBegins[i] == 0)
       continue;
 
     // Create the correct center.
+    arma::vec childCenter(center.n_elem);
     for (size_t d = 0; d < center.n_elem; ++d)
     {
       // Is the dimension "right" (1) or "left" (0)?
@@ -861,10 +956,72 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
-        childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
-        childWidth, maxLeafSize));
+    begins.push_back(childBegins[i]);
+    counts.push_back(childBegins[i + 1] - childBegins[i]);
+    centers.push_back(childCenter);
   }
+
+  // The children hold disjoint ranges of points (and of oldFromNew), so they
+  // can be built at the same time.  Each subtree is built in the same way as it
+  // would be serially, so the tree does not depend on the number of threads.
+  std::vector<Octree*> newChildren(begins.size(), NULL);
+  bool built = false;
+  #ifdef HAS_OPENMP
+  if (count >= split::ParallelTaskMinSize)
+  {
+    if (omp_in_parallel())
+    {
+      for (size_t c = 0; c < begins.size(); ++c)
+      {
+        #pragma omp task shared(newChildren, begins, counts, centers)
+        newChildren[c] = (oldFromNew == NULL) ?
+            new Octree(this, begins[c], counts[c], centers[c], childWidth,
+                maxLeafSize) :
+            new Octree(this, begins[c], counts[c], *oldFromNew, centers[c],
+                childWidth, maxLeafSize);
+      }
+      #pragma omp taskwait
+      built = true;
+    }
+    else if (count < split::ParallelPartitionMinSize &&
+        omp_get_max_threads() > 1)
+    {
+      // The nodes above this one were partitioned in parallel; from here on,
+      // we build subtrees in parallel instead.
+      #pragma omp parallel shared(newChildren, begins, counts, centers)
+      {
+        #pragma omp single
+        {
+          for (size_t c = 0; c < begins.size(); ++c)
+          {
+            #pragma omp task shared(newChildren, begins, counts, centers)
+            newChildren[c] = (oldFromNew == NULL) ?
+                new Octree(this, begins[c], counts[c], centers[c], childWidth,
+                    maxLeafSize) :
+                new Octree(this, begins[c], counts[c], *oldFromNew,
+                    centers[c], childWidth, maxLeafSize);
+          }
+          #pragma omp taskwait
+        }
+      }
+      built = true;
+    }
+  }
+  #endif
+
+  if (!built)
+  {
+    for (size_t c = 0; c < begins.size(); ++c)
+    {
+      newChildren[c] = (oldFromNew == NULL) ?
+          new Octree(this, begins[c], counts[c], centers[c], childWidth,
+              maxLeafSize) :
+          new Octree(this, begins[c], counts[c], *oldFromNew, centers[c],
+              childWidth, maxLeafSize);
+    }
+  }
+
+  children.insert(children.end(), newChildren.begin(), newChildren.end());
 }
 
 } // namespace tree
@@ -6,7 +6,7 @@
  * behavior. The functions perform the actual splitting. This will order
  * the dataset such that points that belong to the left subtree are on the left
  * of the split column, and points from the right subtree are on the right side
- * of the split column.
+ * of the split column.  Large nodes are partitioned with the help of OpenMP.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -16,10 +16,90 @@
 #ifndef MLPACK_CORE_TREE_PERFORM_SPLIT_HPP
 #define MLPACK_CORE_TREE_PERFORM_SPLIT_HPP
 
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 namespace split {
 
+/**
+ * Nodes with at least this many points are partitioned by first computing the
+ * side of every point in parallel (see ParallelPerformSplit()).  Trees that
+ * build their children in parallel also use this as the size below which a
+ * subtree is built by parallel tasks, instead of by parallel partitions.
+ */
+const size_t ParallelPartitionMinSize = 65536;
+
+/**
+ * Trees that build their children in parallel don't create tasks for subtrees
+ * with fewer points than this.
+ */
+const size_t ParallelTaskMinSize = 1024;
+
+/**
+ * Rearrange the points like PerformSplit() does, but compute the side of each
+ * point (with SplitType::AssignToLeftNode()) in parallel first.  The swaps are
+ * the same as the ones of PerformSplit(), so the result (and the oldFromNew
+ * mapping) does not depend on the number of threads.
+ *
+ * @param data The dataset used by the binary space tree.
+ * @param begin Index of the starting point in the dataset that belongs to
+ *    this node.
+ * @param count Number of points in this node.
+ * @param splitInfo The information about the split.
+ * @param oldFromNew If not NULL, this vector of old positions for each new
+ *    point is updated.
+ */
+template<typename MatType, typename SplitType>
+size_t ParallelPerformSplit(MatType& data,
+                            const size_t begin,
+                            const size_t count,
+                            const typename SplitType::SplitInfo& splitInfo,
+                            std::vector<size_t>* oldFromNew)
+{
+  std::vector<char> toLeft(count);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+  {
+    toLeft[i] = SplitType::AssignToLeftNode(data.col(begin + i), splitInfo) ?
+        1 : 0;
+  }
+
+  // This is the loop of PerformSplit(), using the precomputed sides.
+  size_t left = begin;
+  size_t right = begin + count - 1;
+
+  while ((left <= right) && toLeft[left - begin])
+    left++;
+  while ((left <= right) && (right > 0) && !toLeft[right - begin])
+    right--;
+
+  // Shortcut for when all points are on the right.
+  if (left == right && right == 0)
+    return left;
+
+  while (left <= right)
+  {
+    data.swap_cols(left, right);
+    std::swap(toLeft[left - begin], toLeft[right - begin]);
+    if (oldFromNew)
+      std::swap((*oldFromNew)[left], (*oldFromNew)[right]);
+
+    while ((left <= right) && toLeft[left - begin])
+      left++;
+    while ((left <= right) && !toLeft[right - begin])
+      right--;
+  }
+
+  Log::Assert(left == right + 1);
+  return left;
+}
+
 /**
  * This function implements the default split behavior i.e. it rearranges
  * points according to the split information. The SplitType::AssignToLeftNode()
@@ -38,6 +118,14 @@ size_t PerformSplit(MatType& data,
                     const size_t count,
                     const typename SplitType::SplitInfo& splitInfo)
 {
+  #ifdef HAS_OPENMP
+  if (count >= ParallelPartitionMinSize && !omp_in_parallel())
+  {
+    return ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+        splitInfo, NULL);
+  }
+  #endif
+
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
   size_t left = begin;
@@ -104,6 +192,14 @@ size_t PerformSplit(MatType& data,
                     const typename SplitType::SplitInfo& splitInfo,
                     std::vector<size_t>& oldFromNew)
 {
+  #ifdef HAS_OPENMP
+  if (count >= ParallelPartitionMinSize && !omp_in_parallel())
+  {
+    return ParallelPerformSplit<MatType, SplitType>(data, begin, count,
+        splitInfo, &oldFromNew);
+  }
+  #endif
+
   // This method modifies the input dataset.  We loop both from the left and
   // right sides of the points contained in this node.
   size_t left = begin;
@@ -0,0 +1,123 @@
+/**
+ * @file bulk_load.hpp
+ *
+ * Definition of the BulkLoad class, which computes the order in which points
+ * (or nodes) are packed into the nodes of a RectangleTree when the tree is
+ * bulk-loaded, instead of being built by inserting the points one by one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "discrete_hilbert_value.hpp"
+
+namespace mlpack {
+namespace tree /** Trees and tree-building procedures. */ {
+
+/**
+ * The packing strategies available to bulk-load a RectangleTree.
+ */
+enum BulkLoadType
+{
+  //! Sort-Tile-Recursive packing: the points are sorted along the first
+  //! dimension and cut into slabs, each slab is sorted along the next dimension
+  //! and cut again, and so on.
+  STR_BULK_LOAD,
+  //! The points are sorted by their Hilbert values (see DiscreteHilbertValue)
+  //! and packed in that order.
+  HILBERT_BULK_LOAD
+};
+
+// Forward declarations of the auxiliary information types that support bulk
+// loading.
+template<typename TreeType>
+class NoAuxiliaryInformation;
+template<typename TreeType>
+class XTreeAuxiliaryInformation;
+
+/**
+ * A bulk-loaded tree is built bottom-up, without going through the insertion
+ * procedure, so only auxiliary information types that do not need to see the
+ * insertions can be used with it.  This is the case of NoAuxiliaryInformation
+ * (the R tree, the R* tree and the R+ tree) and XTreeAuxiliaryInformation (the
+ * X tree), but not of the Hilbert R tree or the R++ tree, whose auxiliary
+ * information is only kept up to date by the insertion procedure.
+ *
+ * @tparam AuxiliaryInformationType The auxiliary information of the tree.
+ */
+template<typename AuxiliaryInformationType>
+struct BulkLoadTraits
+{
+  //! Whether or not a tree with this auxiliary information may be bulk-loaded.
+  static const bool SupportsBulkLoad = false;
+};
+
+template<typename TreeType>
+struct BulkLoadTraits<NoAuxiliaryInformation<TreeType>>
+{
+  static const bool SupportsBulkLoad = true;
+};
+
+template<typename TreeType>
+struct BulkLoadTraits<XTreeAuxiliaryInformation<TreeType>>
+{
+  static const bool SupportsBulkLoad = true;
+};
+
+/**
+ * The BulkLoad class orders a set of points so that consecutive runs of
+ * nodeSize points are spatially close to each other.  RectangleTree packs the
+ * points into its leaves in this order, and then orders the centers of the
+ * leaves in the same way to pack them into the nodes of the next level, and so
+ * on up to the root.  Each ordering takes O(n log n) time.
+ */
+class BulkLoad
+{
+ public:
+  /**
+   * Compute the packing order of the columns of the given matrix.  After the
+   * call, order holds a permutation of [0, data.n_cols), and the points
+   * data.col(order[0]), ..., data.col(order[nodeSize - 1]) should be packed
+   * into the first node, and so on.
+   *
+   * @param data Points (or node centers) to order.
+   * @param bulkLoadType Packing strategy to use.
+   * @param nodeSize Number of points that will be packed into each node.
+   * @param order Vector to store the packing order into.
+   */
+  template<typename MatType>
+  static void Order(const MatType& data,
+                    const BulkLoadType bulkLoadType,
+                    const size_t nodeSize,
+                    std::vector<size_t>& order);
+
+ private:
+  /**
+   * Sort order[begin, begin + count) along the given dimension, cut it into
+   * slabs, and recurse into each slab with the next dimension.
+   */
+  template<typename MatType>
+  static void STROrder(const MatType& data,
+                       const size_t begin,
+                       const size_t count,
+                       const size_t dim,
+                       const size_t nodeSize,
+                       std::vector<size_t>& order);
+
+  //! Sort the points by their Hilbert values.
+  template<typename MatType>
+  static void HilbertOrder(const MatType& data, std::vector<size_t>& order);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "bulk_load_impl.hpp"
+
+#endif // MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_HPP
@@ -0,0 +1,98 @@
+/**
+ * @file bulk_load_impl.hpp
+ *
+ * Implementation of the BulkLoad class, which computes the packing order of
+ * bulk-loaded RectangleTrees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_IMPL_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_IMPL_HPP
+
+#include "bulk_load.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MatType>
+void BulkLoad::Order(const MatType& data,
+                     const BulkLoadType bulkLoadType,
+                     const size_t nodeSize,
+                     std::vector<size_t>& order)
+{
+  order.resize(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    order[i] = i;
+
+  if (bulkLoadType == HILBERT_BULK_LOAD)
+    HilbertOrder(data, order);
+  else
+    STROrder(data, 0, data.n_cols, 0, std::max(nodeSize, (size_t) 1), order);
+}
+
+template<typename MatType>
+void BulkLoad::STROrder(const MatType& data,
+                        const size_t begin,
+                        const size_t count,
+                        const size_t dim,
+                        const size_t nodeSize,
+                        std::vector<size_t>& order)
+{
+  // Ties are broken by the index, so that the order does not depend on the
+  // implementation of std::sort().
+  std::sort(order.begin() + begin, order.begin() + begin + count,
+      [&data, dim](const size_t a, const size_t b)
+      {
+        return (data(dim, a) < data(dim, b)) ||
+            (data(dim, a) == data(dim, b) && a < b);
+      });
+
+  if (dim + 1 == data.n_rows || count <= nodeSize)
+    return;
+
+  // If the remaining d dimensions have to hold P nodes, each of them is cut
+  // into P^(1 / d) slabs.
+  const size_t numNodes = (count + nodeSize - 1) / nodeSize;
+  const size_t numSlabs = (size_t) std::ceil(std::pow((double) numNodes,
+      1.0 / (data.n_rows - dim)));
+  const size_t slabSize = nodeSize * ((numNodes + numSlabs - 1) / numSlabs);
+
+  for (size_t slabBegin = begin; slabBegin < begin + count;
+       slabBegin += slabSize)
+  {
+    STROrder(data, slabBegin, std::min(slabSize, begin + count - slabBegin),
+        dim + 1, nodeSize, order);
+  }
+}
+
+template<typename MatType>
+void BulkLoad::HilbertOrder(const MatType& data, std::vector<size_t>& order)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef DiscreteHilbertValue<ElemType> HilbertValueType;
+  typedef typename HilbertValueType::HilbertElemType HilbertElemType;
+
+  // Calculate the Hilbert values once, instead of at each comparison.
+  std::vector<arma::Col<HilbertElemType>> values(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const arma::Col<ElemType> point(data.col(i));
+    values[i] = HilbertValueType::CalculateValue(point);
+  }
+
+  std::sort(order.begin(), order.end(),
+      [&values](const size_t a, const size_t b)
+      {
+        const int comparison = HilbertValueType::CompareValues(values[a],
+            values[b]);
+        return (comparison < 0) || (comparison == 0 && a < b);
+      });
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif // MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_IMPL_HPP
@@ -15,6 +15,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_DUAL_TREE_TRAVERSER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
 
 #include "rectangle_tree.hpp"
 
@@ -66,6 +66,11 @@ DualTreeTraverser<RuleType>::Traverse(RectangleTree& queryNode,
 
   if (queryNode.IsLeaf() && referenceNode.IsLeaf())
   {
+    // If the rules can evaluate the whole block of base cases at once, let
+    // them.
+    if (CallBaseCaseBlock(rule, queryNode, referenceNode, numBaseCases))
+      return;
+
     // Evaluate the base case.  Do the query points on the outside so we can
     // possibly prune the reference node for that particular point.
     for (size_t query = 0; query < queryNode.Count(); ++query)
@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -156,6 +157,56 @@ class RectangleTree
                 const size_t minNumChildren = 2,
                 const size_t firstDataIndex = 0);
 
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, bulk-loading the tree instead of inserting the points one by one.
+   * The points are sorted with the given packing strategy (see BulkLoad) and
+   * packed into leaves that are as full as possible, and the leaves are packed
+   * into the nodes of the next level in the same way, up to the root.  This
+   * takes O(n log n) time and gives trees with less overlap than incremental
+   * insertion.  Points may still be inserted and deleted afterwards.
+   *
+   * Only the trees whose auxiliary information supports it may be bulk-loaded
+   * (see BulkLoadTraits).  Note that a bulk-loaded R+ tree may have
+   * overlapping nodes.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoadType Packing strategy (STR_BULK_LOAD or HILBERT_BULK_LOAD).
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(const MatType& data,
+                const BulkLoadType bulkLoadType,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
+  /**
+   * Construct this as the root node of a rectangle type tree using the given
+   * dataset, taking ownership of the given dataset and bulk-loading the tree
+   * instead of inserting the points one by one.
+   *
+   * @param data Dataset from which to create the tree.
+   * @param bulkLoadType Packing strategy (STR_BULK_LOAD or HILBERT_BULK_LOAD).
+   * @param maxLeafSize Maximum size of each leaf in the tree.
+   * @param minLeafSize Minimum size of each leaf in the tree.
+   * @param maxNumChildren The maximum number of child nodes a non-leaf node may
+   *      have.
+   * @param minNumChildren The minimum number of child nodes a non-leaf node may
+   *      have.
+   */
+  RectangleTree(MatType&& data,
+                const BulkLoadType bulkLoadType,
+                const size_t maxLeafSize = 20,
+                const size_t minLeafSize = 8,
+                const size_t maxNumChildren = 5,
+                const size_t minNumChildren = 2);
+
   /**
    * Construct this as an empty node with the specified parent.  Copying the
    * parameters (maxLeafSize, minLeafSize, maxNumChildren, minNumChildren,
@@ -542,6 +593,13 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Bulk-load the dataset into this (empty) root node.
+   *
+   * @param bulkLoadType Packing strategy to use.
+   */
+  void BulkLoadPoints(const BulkLoadType bulkLoadType);
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
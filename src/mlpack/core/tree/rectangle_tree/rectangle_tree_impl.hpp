@@ -101,6 +101,74 @@ RectangleTree(MatType&& data,
     root->InsertPoint(i);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const BulkLoadType bulkLoadType,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoadPoints(bulkLoadType);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const BulkLoadType bulkLoadType,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    begin(0),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoadPoints(bulkLoadType);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -893,6 +961,113 @@ void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
   }
 }
 
+/**
+ * Bulk-load the dataset into this root node, building the tree bottom-up.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoadPoints(const BulkLoadType bulkLoadType)
+{
+  static_assert(BulkLoadTraits<AuxiliaryInformationType<RectangleTree>>::
+      SupportsBulkLoad, "RectangleTree: this tree type does not support bulk "
+      "loading; use the other constructors instead.");
+
+  const size_t numPoints = dataset->n_cols;
+
+  // If all of the points fit into one leaf, the root is that leaf, and the
+  // points can simply be inserted.
+  if (numPoints <= maxLeafSize)
+  {
+    stat = StatisticType(*this);
+    for (size_t i = 0; i < numPoints; ++i)
+      InsertPoint(i);
+    return;
+  }
+
+  // Attach a packed node to its parent, in the same way InsertNode() would.
+  auto addChild = [](RectangleTree* node, RectangleTree* child)
+  {
+    node->bound |= child->bound;
+    node->numDescendants += child->numDescendants;
+    if (!node->auxiliaryInfo.HandleNodeInsertion(node, child, true))
+    {
+      node->children[node->numChildren++] = child;
+      child->Parent() = node;
+    }
+  };
+
+  // Use as few leaves as possible, and spread the points evenly among them so
+  // that none is underfull.
+  const size_t numLeaves = (numPoints + maxLeafSize - 1) / maxLeafSize;
+
+  std::vector<size_t> order;
+  BulkLoad::Order(*dataset, bulkLoadType,
+      (numPoints + numLeaves - 1) / numLeaves, order);
+
+  std::vector<RectangleTree*> nodes(numLeaves);
+  for (size_t i = 0, j = 0; i < numLeaves; ++i)
+  {
+    const size_t leafSize = numPoints / numLeaves +
+        ((i < numPoints % numLeaves) ? 1 : 0);
+
+    RectangleTree* leaf = new RectangleTree(this);
+    for (const size_t end = j + leafSize; j < end; ++j)
+    {
+      leaf->bound |= dataset->col(order[j]);
+      if (!leaf->auxiliaryInfo.HandlePointInsertion(leaf, order[j]))
+        leaf->points[leaf->count++] = order[j];
+    }
+    leaf->numDescendants = leaf->count;
+    leaf->stat = StatisticType(*leaf);
+
+    nodes[i] = leaf;
+  }
+
+  // Now pack each level into the next one, ordering the nodes by the centers
+  // of their bounds, until the nodes fit into the root.
+  arma::Col<ElemType> center;
+  while (nodes.size() > maxNumChildren)
+  {
+    arma::Mat<ElemType> centers(dataset->n_rows, nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+      nodes[i]->bound.Center(center);
+      centers.col(i) = center;
+    }
+
+    const size_t numParents = (nodes.size() + maxNumChildren - 1) /
+        maxNumChildren;
+    BulkLoad::Order(centers, bulkLoadType,
+        (nodes.size() + numParents - 1) / numParents, order);
+
+    std::vector<RectangleTree*> parents(numParents);
+    for (size_t i = 0, j = 0; i < numParents; ++i)
+    {
+      const size_t numNodeChildren = nodes.size() / numParents +
+          ((i < nodes.size() % numParents) ? 1 : 0);
+
+      RectangleTree* node = new RectangleTree(this);
+      for (const size_t end = j + numNodeChildren; j < end; ++j)
+        addChild(node, nodes[order[j]]);
+      node->stat = StatisticType(*node);
+
+      parents[i] = node;
+    }
+
+    nodes.swap(parents);
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+    addChild(this, nodes[i]);
+  stat = StatisticType(*this);
+}
+
 //! Default constructor for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -0,0 +1,134 @@
+/**
+ * @file rule_traits.hpp
+ *
+ * This file contains the RuleTraits class, which describes the optional hooks
+ * that the rules of a traversal (the RuleType classes) may provide to the
+ * traversers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RULE_TRAITS_HPP
+#define MLPACK_CORE_TREE_RULE_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The RuleTraits class provides compile-time information about the rules used
+ * by a tree traversal.  By default, the rules only provide the required
+ * BaseCase(), Score() and Rescore() methods; specialize this class to tell the
+ * traversers that some rules provide more, like this:
+ *
+ * @code
+ * template<typename MetricType, typename TreeType>
+ * class RuleTraits<MyRules<MetricType, TreeType>>
+ * {
+ *  public:
+ *   static const bool HasBaseCaseBlock = true;
+ * };
+ * @endcode
+ *
+ * @tparam RuleType The rules of the traversal.
+ */
+template<typename RuleType>
+class RuleTraits
+{
+ public:
+  /**
+   * If true, the rules provide a method
+   *
+   * @code
+   * size_t BaseCaseBlock(TreeType& queryNode, TreeType& referenceNode);
+   * @endcode
+   *
+   * which the dual-tree traversers call when both nodes are leaves, in place of
+   * calling Score(queryIndex, referenceNode) and then BaseCase(queryIndex,
+   * referenceIndex) for every pair of points.  It must do the equivalent of
+   * these calls (restoring the traversal info before each Score() call, as the
+   * traversers do), possibly computing the distances of the whole block at
+   * once; it returns the number of base cases that were performed.
+   */
+  static const bool HasBaseCaseBlock = false;
+
+  /**
+   * If true, the rules provide a method
+   *
+   * @code
+   * size_t BaseCaseBatch(const std::vector<size_t>& queries,
+   *                      TreeType& referenceNode);
+   * @endcode
+   *
+   * which the single-tree traversers that route several query points together
+   * (like GreedySingleTreeTraverser) call in place of calling
+   * BaseCase(queryIndex, referenceIndex) for each of the given query points
+   * and each point held by the reference node.  It returns the number of base
+   * cases that were performed.
+   */
+  static const bool HasBaseCaseBatch = false;
+};
+
+/**
+ * Call rule.BaseCaseBlock(queryNode, referenceNode) if the rules provide it,
+ * and add its number of base cases to numBaseCases.  It returns whether
+ * BaseCaseBlock() was called; if it wasn't, the traverser must perform the base
+ * cases itself.
+ */
+template<typename RuleType, typename TreeType>
+typename std::enable_if<RuleTraits<RuleType>::HasBaseCaseBlock, bool>::type
+CallBaseCaseBlock(RuleType& rule,
+                  TreeType& queryNode,
+                  TreeType& referenceNode,
+                  size_t& numBaseCases)
+{
+  numBaseCases += rule.BaseCaseBlock(queryNode, referenceNode);
+  return true;
+}
+
+//! The rules do not provide BaseCaseBlock(), so do nothing.
+template<typename RuleType, typename TreeType>
+typename std::enable_if<!RuleTraits<RuleType>::HasBaseCaseBlock, bool>::type
+CallBaseCaseBlock(RuleType& /* rule */,
+                  TreeType& /* queryNode */,
+                  TreeType& /* referenceNode */,
+                  size_t& /* numBaseCases */)
+{
+  return false;
+}
+
+/**
+ * Call rule.BaseCaseBatch(queries, referenceNode) if the rules provide it, and
+ * add its number of base cases to numBaseCases.  It returns whether
+ * BaseCaseBatch() was called; if it wasn't, the traverser must perform the base
+ * cases itself.
+ */
+template<typename RuleType, typename TreeType>
+typename std::enable_if<RuleTraits<RuleType>::HasBaseCaseBatch, bool>::type
+CallBaseCaseBatch(RuleType& rule,
+                  const std::vector<size_t>& queries,
+                  TreeType& referenceNode,
+                  size_t& numBaseCases)
+{
+  numBaseCases += rule.BaseCaseBatch(queries, referenceNode);
+  return true;
+}
+
+//! The rules do not provide BaseCaseBatch(), so do nothing.
+template<typename RuleType, typename TreeType>
+typename std::enable_if<!RuleTraits<RuleType>::HasBaseCaseBatch, bool>::type
+CallBaseCaseBatch(RuleType& /* rule */,
+                  const std::vector<size_t>& /* queries */,
+                  TreeType& /* referenceNode */,
+                  size_t& /* numBaseCases */)
+{
+  return false;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #include <mlpack/prereqs.hpp>
 #include "../space_split/midpoint_space_split.hpp"
 #include "../statistic.hpp"
+#include "../perform_split.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -36,6 +37,13 @@ namespace tree /** Trees and tree-building procedures. */ {
  * from it.  If you need to add or delete a node, the better procedure is to
  * rebuild the tree entirely.
  *
+ * The indices of the points of all the leaves are held in a single array that
+ * is shared by all the nodes (and owned by the root), in preorder, so that the
+ * descendants of each node are contiguous.  During construction, the points of
+ * each node are rearranged in place, and only the right child of an overlapping
+ * node gets a copy of its points.  If OpenMP is enabled, the subtrees of trees
+ * with axis-orthogonal hyperplanes are built in parallel.
+ *
  * Three runtime parameters are required in the constructor:
  *  - maxLeafSize: Max leaf size to be used.
  *  - tau: Overlapping size.
@@ -90,9 +98,11 @@ class SpillTree
   //! The number of points of the dataset contained in this node (and its
   //! children).
   size_t count;
-  //! The list of indexes of points contained in this node (non-null for
-  //! leaf nodes).
+  //! The indices of the points of all the leaves of the tree, in preorder.
+  //! It is shared by all the nodes, and owned by the root.
   arma::Col<size_t>* pointsIndex;
+  //! The position of the first descendant point of this node in pointsIndex.
+  size_t pointsBegin;
   //! Flag to distinguish overlapping nodes from non-overlapping nodes.
   bool overlappingNode;
   //! Splitting hyperplane represented by this node.
@@ -176,23 +186,6 @@ class SpillTree
             const size_t maxLeafSize = 20,
             const double rho = 0.7);
 
-  /**
-   * Construct this node as a child of the given parent, including the given
-   * list of points.  This is used for recursive tree-building by the other
-   * constructors which don't specify point indices.
-   *
-   * @param parent Parent of this node.
-   * @param points Vector of indexes of points to be included in this node.
-   * @param tau Overlapping size.
-   * @param maxLeafSize Size of each leaf in the tree.
-   * @param rho Balance threshold.
-   */
-  SpillTree(SpillTree* parent,
-            arma::Col<size_t>& points,
-            const double tau = 0,
-            const size_t maxLeafSize = 20,
-            const double rho = 0.7);
-
   /**
    * Create a hybrid spill tree by copying the other tree.  Be careful!  This
    * can take a long time and use a lot of memory.
@@ -424,34 +417,103 @@ class SpillTree
   void Center(arma::vec& center) { bound.Center(center); }
 
  private:
+  /**
+   * Construct this node as a child of the given parent, with the given range of
+   * points of the given buffer.  This is used for recursive tree-building by
+   * the other constructors; the statistic of the node is not built, and the
+   * points are gathered in the array of the root afterwards.
+   *
+   * @param parent Parent of this node.
+   * @param points Buffer of indices of points that holds the points of this
+   *     node.
+   * @param begin Position of the first point of this node in the buffer.
+   * @param count Number of points of this node.
+   * @param tau Overlapping size.
+   * @param maxLeafSize Size of each leaf in the tree.
+   * @param rho Balance threshold.
+   */
+  SpillTree(SpillTree* parent,
+            arma::Col<size_t>* points,
+            const size_t begin,
+            const size_t count,
+            const double tau,
+            const size_t maxLeafSize,
+            const double rho);
+
+  /**
+   * Build the tree rooted at this node on the indices of all the points of the
+   * dataset, then gather the points of the leaves and build the statistics.
+   *
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param tau Overlapping size.
+   * @param rho Balance threshold.
+   */
+  void BuildTree(const size_t maxLeafSize, const double tau, const double rho);
+
   /**
    * Splits the current node, assigning its left and right children recursively.
+   * The points of the node are rearranged in place in the buffer.
    *
-   * @param points Vector of indexes of points to be included in this node.
+   * @param points Buffer of indices of points that holds the points of this
+   *     node.
+   * @param begin Position of the first point of this node in the buffer.
+   * @param count Number of points of this node.
    * @param maxLeafSize Maximum number of points held in a leaf.
    * @param tau Overlapping size.
    * @param rho Balance threshold.
    */
-  void SplitNode(arma::Col<size_t>& points,
+  void SplitNode(arma::Col<size_t>* points,
+                 const size_t begin,
+                 const size_t count,
                  const size_t maxLeafSize,
                  const double tau,
                  const double rho);
 
   /**
-   * Split the list of points.
+   * Split the given range of points, by rearranging them in place: the points
+   * that only belong to the left child come first, followed by the points of
+   * the overlapping buffer (if the overlapping buffer is used), which belong to
+   * both children, and then the points that only belong to the right child.
+   * So the left child holds the first leftCount points of the range, and the
+   * right child holds the last rightCount points.
    *
    * @param tau Overlapping size.
    * @param rho Balance threshold.
-   * @param points Vector of indexes of points to be included.
-   * @param leftPoints Indexes of points to be included in left child.
-   * @param rightPoints Indexes of points to be included in right child.
+   * @param points Buffer of indices of points.
+   * @param begin Position of the first point of the range.
+   * @param count Number of points of the range.
+   * @param leftCount Number of points to be included in left child.
+   * @param rightCount Number of points to be included in right child.
    * @return Flag to know if the overlapping buffer was included.
    */
   bool SplitPoints(const double tau,
                    const double rho,
-                   const arma::Col<size_t>& points,
-                   arma::Col<size_t>& leftPoints,
-                   arma::Col<size_t>& rightPoints);
+                   arma::Col<size_t>& points,
+                   const size_t begin,
+                   const size_t count,
+                   size_t& leftCount,
+                   size_t& rightCount);
+
+  //! Build the left and right children of this node, in parallel if possible.
+  void BuildChildren(arma::Col<size_t>* points,
+                     const size_t leftBegin,
+                     const size_t leftCount,
+                     arma::Col<size_t>* rightPoints,
+                     const size_t rightBegin,
+                     const size_t rightCount,
+                     const size_t maxLeafSize,
+                     const double tau,
+                     const double rho);
+
+  /**
+   * Copy the points of the leaves of this (root) tree into a single array, in
+   * preorder, and free the buffers they were built in.  This is also used to
+   * load trees of older versions, whose leaves each held their own points.
+   */
+  void GatherPoints();
+
+  //! Build the statistics of all the nodes of this tree, children first.
+  void BuildStatistics();
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -475,6 +537,28 @@ class SpillTree
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the SpillTree class.  This is written out
+//! because BOOST_TEMPLATE_CLASS_VERSION() can't take a signature with commas.
+namespace boost {
+namespace serialization {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+struct version<mlpack::tree::SpillTree<MetricType, StatisticType, MatType,
+    HyperplaneType, SplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "spill_tree_impl.hpp"
 
@@ -15,6 +15,12 @@
 #include "spill_tree.hpp"
 
 #include <queue>
+#include <stack>
+#include <unordered_set>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace tree {
@@ -36,6 +42,7 @@ SpillTree(
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsBegin(0),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -43,17 +50,7 @@ SpillTree(
     dataset(&data),
     localDataset(false)
 {
-  arma::Col<size_t> points;
-  if (dataset->n_cols > 0)
-    // Fill points with all possible indexes: 0 .. (dataset->n_cols - 1).
-    points = arma::linspace<arma::Col<size_t>>(0, dataset->n_cols - 1,
-        dataset->n_cols);
-
-  // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
-
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  BuildTree(maxLeafSize, tau, rho);
 }
 
 template<typename MetricType,
@@ -73,6 +70,7 @@ SpillTree(
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsBegin(0),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -80,17 +78,7 @@ SpillTree(
     dataset(new MatType(std::move(data))),
     localDataset(true)
 {
-  arma::Col<size_t> points;
-  if (dataset->n_cols > 0)
-    // Fill points with all possible indexes: 0 .. (dataset->n_cols - 1).
-    points = arma::linspace<arma::Col<size_t>>(0, dataset->n_cols - 1,
-        dataset->n_cols);
-
-  // Do the actual splitting of this node.
-  SplitNode(points, maxLeafSize, tau, rho);
-
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  BuildTree(maxLeafSize, tau, rho);
 }
 
 template<typename MetricType,
@@ -102,7 +90,9 @@ template<typename MetricType,
 SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 SpillTree(
     SpillTree* parent,
-    arma::Col<size_t>& points,
+    arma::Col<size_t>* points,
+    const size_t begin,
+    const size_t count,
     const double tau,
     const size_t maxLeafSize,
     const double rho) :
@@ -111,6 +101,7 @@ SpillTree(
     parent(parent),
     count(0),
     pointsIndex(NULL),
+    pointsBegin(0),
     overlappingNode(false),
     hyperplane(),
     bound(parent->Dataset().n_rows),
@@ -118,10 +109,7 @@ SpillTree(
     localDataset(false)
 {
   // Perform the actual splitting.
-  SplitNode(points, maxLeafSize, tau, rho);
-
-  // Create the statistic depending on if we are a leaf or not.
-  stat = StatisticType(*this);
+  SplitNode(points, begin, count, maxLeafSize, tau, rho);
 }
 
 /**
@@ -140,7 +128,8 @@ SpillTree(const SpillTree& other) :
     right(NULL),
     parent(other.parent),
     count(other.count),
-    pointsIndex(NULL),
+    pointsIndex(other.pointsIndex),
+    pointsBegin(other.pointsBegin),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(other.bound),
@@ -166,10 +155,31 @@ SpillTree(const SpillTree& other) :
     right->Parent() = this; // Set parent to this, not other tree.
   }
 
-  // If vector of indexes, copy it.
-  if (other.pointsIndex)
+  // Copy the indices of the points, and give them to all the nodes, but only
+  // if we are the root; otherwise the indices belong to the root of the other
+  // tree.
+  if (parent == NULL && other.pointsIndex)
+  {
     pointsIndex = new arma::Col<size_t>(*other.pointsIndex);
 
+    std::queue<SpillTree*> queue;
+    if (left)
+      queue.push(left);
+    if (right)
+      queue.push(right);
+    while (!queue.empty())
+    {
+      SpillTree* node = queue.front();
+      queue.pop();
+
+      node->pointsIndex = pointsIndex;
+      if (node->left)
+        queue.push(node->left);
+      if (node->right)
+        queue.push(node->right);
+    }
+  }
+
   // Propagate matrix, but only if we are the root.
   if (parent == NULL && localDataset)
   {
@@ -208,6 +218,7 @@ SpillTree(SpillTree&& other) :
     parent(other.parent),
     count(other.count),
     pointsIndex(other.pointsIndex),
+    pointsBegin(other.pointsBegin),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(std::move(other.bound)),
@@ -224,6 +235,7 @@ SpillTree(SpillTree&& other) :
   other.right = NULL;
   other.count = 0;
   other.pointsIndex = NULL;
+  other.pointsBegin = 0;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
@@ -274,7 +286,10 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 {
   delete left;
   delete right;
-  delete pointsIndex;
+
+  // The indices of the points belong to the root.
+  if (!parent)
+    delete pointsIndex;
 
   // If we're the root and we own the dataset, delete it.
   if (!parent && localDataset)
@@ -538,15 +553,8 @@ template<typename MetricType,
 inline size_t SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
     SplitType>::Descendant(const size_t index) const
 {
-  if (IsLeaf())
-    return (*pointsIndex)[index];
-  size_t num = left->NumDescendants();
-  if (index < num)
-    return left->Descendant(index);
-  if (right)
-    return right->Descendant(index - num);
-  // This should never happen.
-  return (size_t() - 1);
+  // The descendants of each node are contiguous.
+  return (*pointsIndex)[pointsBegin + index];
 }
 
 /**
@@ -562,7 +570,7 @@ inline size_t SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
     SplitType>::Point(const size_t index) const
 {
   if (IsLeaf())
-    return (*pointsIndex)[index];
+    return (*pointsIndex)[pointsBegin + index];
   // This should never happen.
   return (size_t() - 1);
 }
@@ -574,53 +582,88 @@ template<typename MetricType,
          template<typename SplitMetricType, typename SplitMatType>
              class SplitType>
 void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
-    SplitNode(arma::Col<size_t>& points,
+    BuildTree(const size_t maxLeafSize, const double tau, const double rho)
+{
+  // Build the tree on a buffer with all possible indexes: 0 ..
+  // (dataset->n_cols - 1).
+  arma::Col<size_t>* points = new arma::Col<size_t>(dataset->n_cols);
+  for (size_t i = 0; i < dataset->n_cols; ++i)
+    (*points)[i] = i;
+
+  // Do the actual splitting of this node.
+  SplitNode(points, 0, dataset->n_cols, maxLeafSize, tau, rho);
+
+  // Now collect the points of the leaves from the buffers the tree was built
+  // in, and create the statistics (which may look at the points).
+  GatherPoints();
+  BuildStatistics();
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    SplitNode(arma::Col<size_t>* points,
+              const size_t begin,
+              const size_t count,
               const size_t maxLeafSize,
               const double tau,
               const double rho)
 {
+  // Until the points are gathered, the node refers to its range of the buffer.
+  pointsIndex = points;
+  pointsBegin = begin;
+  this->count = count;
+
   // We need to expand the bounds of this node properly.
-  for (size_t i = 0; i < points.n_elem; i++)
-    bound |= dataset->col(points[i]);
+  for (size_t i = begin; i < begin + count; i++)
+    bound |= dataset->col((*points)[i]);
 
   // Calculate the furthest descendant distance.
   furthestDescendantDistance = 0.5 * bound.Diameter();
 
   // Now, check if we need to split at all.
-  if (points.n_elem <= maxLeafSize)
-  {
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
-    count = pointsIndex->n_elem;
+  if (count <= maxLeafSize)
     return; // We can't split this.
-  }
 
+  // The split looks at the points of the node without copying them.
+  const arma::Col<size_t> nodePoints(points->memptr() + begin, count, false,
+      true);
   const bool split = SplitType<MetricType, MatType>::SplitSpace(bound,
-      *dataset, points, hyperplane);
+      *dataset, nodePoints, hyperplane);
   // The node may not be always split. For instance, if all the points are the
   // same, we can't split them.
   if (!split)
-  {
-    pointsIndex = new arma::Col<size_t>();
-    pointsIndex->swap(points);
-    count = pointsIndex->n_elem;
     return; // We can't split this.
-  }
 
-  arma::Col<size_t> leftPoints, rightPoints;
   // Split the node.
-  overlappingNode = SplitPoints(tau, rho, points, leftPoints, rightPoints);
-
-  // We don't need the information in points, so lets clean it.
-  arma::Col<size_t>().swap(points);
+  size_t leftCount, rightCount;
+  overlappingNode = SplitPoints(tau, rho, *points, begin, count, leftCount,
+      rightCount);
+
+  // The children of a non-overlapping node hold disjoint parts of the range of
+  // this node.  The children of an overlapping node share the points of the
+  // overlapping buffer, which the left child will rearrange, so the right child
+  // gets a copy of its points.
+  arma::Col<size_t>* rightPoints = points;
+  size_t rightBegin = begin + count - rightCount;
+  if (overlappingNode)
+  {
+    rightPoints = new arma::Col<size_t>(points->memptr() + rightBegin,
+        rightCount);
+    rightBegin = 0;
+  }
 
   // Now we will recursively split the children by calling their constructors
   // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  BuildChildren(points, begin, leftCount, rightPoints, rightBegin, rightCount,
+      maxLeafSize, tau, rho);
 
   // Update count number, to represent the number of descendant points.
-  count = left->NumDescendants() + right->NumDescendants();
+  this->count = left->NumDescendants() + right->NumDescendants();
 
   // Calculate parent distances for those two nodes.
   arma::vec center, leftCenter, rightCenter;
@@ -636,6 +679,70 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildChildren(arma::Col<size_t>* points,
+                  const size_t leftBegin,
+                  const size_t leftCount,
+                  arma::Col<size_t>* rightPoints,
+                  const size_t rightBegin,
+                  const size_t rightCount,
+                  const size_t maxLeafSize,
+                  const double tau,
+                  const double rho)
+{
+  #ifdef HAS_OPENMP
+  // The children are built on disjoint ranges of points, so they can be built
+  // at the same time.  Other hyperplanes than axis-orthogonal ones pick random
+  // points (with rand()) to split, so their trees would depend on the order
+  // the threads run in; they are built serially.
+  const bool parallelChildren = std::is_same<HyperplaneType<MetricType>,
+      AxisOrthogonalHyperplane<MetricType>>::value;
+  if (parallelChildren &&
+      leftCount + rightCount >= split::ParallelTaskMinSize)
+  {
+    if (omp_in_parallel())
+    {
+      // Build the left subtree in a task while this thread builds the right
+      // subtree.
+      #pragma omp task
+      left = new SpillTree(this, points, leftBegin, leftCount, tau,
+          maxLeafSize, rho);
+      right = new SpillTree(this, rightPoints, rightBegin, rightCount, tau,
+          maxLeafSize, rho);
+      #pragma omp taskwait
+      return;
+    }
+    else if (omp_get_max_threads() > 1)
+    {
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          #pragma omp task
+          left = new SpillTree(this, points, leftBegin, leftCount, tau,
+              maxLeafSize, rho);
+          right = new SpillTree(this, rightPoints, rightBegin, rightCount, tau,
+              maxLeafSize, rho);
+          #pragma omp taskwait
+        }
+      }
+      return;
+    }
+  }
+  #endif
+
+  left = new SpillTree(this, points, leftBegin, leftCount, tau, maxLeafSize,
+      rho);
+  right = new SpillTree(this, rightPoints, rightBegin, rightCount, tau,
+      maxLeafSize, rho);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -645,18 +752,20 @@ template<typename MetricType,
 bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     SplitPoints(const double tau,
                 const double rho,
-                const arma::Col<size_t>& points,
-                arma::Col<size_t>& leftPoints,
-                arma::Col<size_t>& rightPoints)
+                arma::Col<size_t>& points,
+                const size_t begin,
+                const size_t count,
+                size_t& leftCount,
+                size_t& rightCount)
 {
-  arma::vec projections(points.n_elem);
+  arma::vec projections(count);
   size_t left = 0, right = 0, leftFrontier = 0, rightFrontier = 0;
 
   // Count the number of points to the left/right of the splitting hyperplane.
-  for (size_t i = 0; i < points.n_elem; i++)
+  for (size_t i = 0; i < count; i++)
   {
     // Store projection value for future use.
-    projections[i] = hyperplane.Project(dataset->col(points[i]));
+    projections[i] = hyperplane.Project(dataset->col(points[begin + i]));
     if (projections[i] <= 0)
     {
       left++;
@@ -671,43 +780,101 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     }
   }
 
-  const double p1 = (double) (left + rightFrontier) / points.n_elem;
-  const double p2 = (double) (right + leftFrontier) / points.n_elem;
-
-  if ((p1 <= rho || rightFrontier == 0) &&
-      (p2 <= rho || leftFrontier == 0))
+  const double p1 = (double) (left + rightFrontier) / count;
+  const double p2 = (double) (right + leftFrontier) / count;
+
+  // If the overlapping buffer is included, points with projection value in the
+  // range (-tau, tau) are included in both children.  Otherwise, points with
+  // projection value less than or equal to zero are included in the left child
+  // and points with projection value greater than zero are included in the
+  // right child.
+  const bool overlapping = (p1 <= rho || rightFrontier == 0) &&
+      (p2 <= rho || leftFrontier == 0);
+  const size_t overlap = overlapping ? leftFrontier + rightFrontier : 0;
+  const size_t leftOnly = left - (overlapping ? leftFrontier : 0);
+  leftCount = leftOnly + overlap;
+  rightCount = count - leftOnly;
+
+  // Rearrange the points, keeping their order within each part.
+  const std::vector<size_t> nodePoints(points.memptr() + begin,
+      points.memptr() + begin + count);
+  size_t lc = begin, oc = begin + leftOnly, rc = begin + leftCount;
+  for (size_t i = 0; i < count; i++)
   {
-    // Perform the actual splitting considering the overlapping buffer.  Points
-    // with projection value in the range (-tau, tau) are included in both,
-    // leftPoints and rightPoints.
-    leftPoints.resize(left + rightFrontier);
-    rightPoints.resize(right + leftFrontier);
-    for (size_t i = 0, rc = 0, lc = 0; i < points.n_elem; i++)
-    {
-      if (projections[i] < tau || projections[i] <= 0)
-        leftPoints[lc++] = points[i];
-      if (projections[i] > -tau)
-        rightPoints[rc++] = points[i];
-    }
-    // Return true, because it is a overlapping node.
-    return true;
+    if (overlapping && projections[i] > -tau && projections[i] < tau)
+      points[oc++] = nodePoints[i];
+    else if (projections[i] <= 0)
+      points[lc++] = nodePoints[i];
+    else
+      points[rc++] = nodePoints[i];
   }
 
-  // Perform the actual splitting ignoring the overlapping buffer.  Points
-  // with projection value less than or equal to zero are included in leftPoints
-  // and points with projection value greater than zero are included in
-  // rightPoints.
-  leftPoints.resize(left);
-  rightPoints.resize(right);
-  for (size_t i = 0, rc = 0, lc = 0; i < points.n_elem; i++)
+  return overlapping;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    GatherPoints()
+{
+  // The leaves are visited in preorder, so the descendant points of each node
+  // end up contiguous.
+  arma::Col<size_t>* gathered = new arma::Col<size_t>(count);
+  std::unordered_set<arma::Col<size_t>*> buffers;
+  size_t position = 0;
+
+  std::stack<SpillTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
   {
-    if (projections[i] <= 0)
-      leftPoints[lc++] = points[i];
+    SpillTree* node = stack.top();
+    stack.pop();
+
+    buffers.insert(node->pointsIndex);
+    if (node->IsLeaf())
+    {
+      for (size_t i = 0; i < node->count; ++i)
+      {
+        (*gathered)[position + i] =
+            (*node->pointsIndex)[node->pointsBegin + i];
+      }
+    }
     else
-      rightPoints[rc++] = points[i];
+    {
+      stack.push(node->right);
+      stack.push(node->left);
+    }
+
+    node->pointsIndex = gathered;
+    node->pointsBegin = position;
+    if (node->IsLeaf())
+      position += node->count;
   }
-  // Return false, because it isn't a overlapping node.
-  return false;
+
+  for (arma::Col<size_t>* buffer : buffers)
+    delete buffer;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    BuildStatistics()
+{
+  if (left)
+    left->BuildStatistics();
+  if (right)
+    right->BuildStatistics();
+
+  // Create the statistic depending on if we are a leaf or not.
+  stat = StatisticType(*this);
 }
 
 // Default constructor (private), for boost::serialization.
@@ -724,6 +891,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    pointsBegin(0),
     overlappingNode(false),
     stat(*this),
     parentDistance(0),
@@ -745,7 +913,7 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
-    serialize(Archive& ar, const unsigned int /* version */)
+    serialize(Archive& ar, const unsigned int version)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
@@ -756,14 +924,23 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       delete right;
     if (!parent && localDataset)
       delete dataset;
+    if (!parent)
+      delete pointsIndex;
 
     parent = NULL;
     left = NULL;
     right = NULL;
+    pointsIndex = NULL;
+    pointsBegin = 0;
   }
 
+  // The array of the indices of the points is shared by all the nodes, so it
+  // is only written once.  Older versions of SpillTree stored the points of
+  // each leaf in their own vector instead.
   ar & BOOST_SERIALIZATION_NVP(count);
   ar & BOOST_SERIALIZATION_NVP(pointsIndex);
+  if (version >= 1)
+    ar & BOOST_SERIALIZATION_NVP(pointsBegin);
   ar & BOOST_SERIALIZATION_NVP(overlappingNode);
   ar & BOOST_SERIALIZATION_NVP(hyperplane);
   ar & BOOST_SERIALIZATION_NVP(bound);
@@ -800,6 +977,9 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       right->parent = this;
       right->localDataset = false;
     }
+
+    if (version == 0 && !parent)
+      GatherPoints();
   }
 }
 
@@ -0,0 +1,132 @@
+/**
+ * @file async_log.cpp
+ *
+ * Implementation of the AsyncLog class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "async_log.hpp"
+
+#include <stdexcept>
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+AsyncLogBuffer::AsyncLogBuffer(std::streambuf* destination,
+                               const size_t capacity) :
+    destination(destination),
+    ring(capacity + 1),
+    head(0),
+    tail(0),
+    stop(false)
+{
+  if (capacity == 0)
+    throw std::invalid_argument("AsyncLog: capacity must be positive");
+
+  consumer = std::thread(&AsyncLogBuffer::Consume, this);
+}
+
+AsyncLogBuffer::~AsyncLogBuffer()
+{
+  sync();
+  stop.store(true, std::memory_order_release);
+  consumer.join();
+}
+
+AsyncLogBuffer::int_type AsyncLogBuffer::overflow(int_type c)
+{
+  if (traits_type::eq_int_type(c, traits_type::eof()))
+    return traits_type::not_eof(c);
+
+  line += traits_type::to_char_type(c);
+  if (traits_type::to_char_type(c) == '\n')
+    Push();
+
+  return c;
+}
+
+std::streamsize AsyncLogBuffer::xsputn(const char* s, std::streamsize n)
+{
+  for (std::streamsize i = 0; i < n; ++i)
+  {
+    line += s[i];
+    if (s[i] == '\n')
+      Push();
+  }
+
+  return n;
+}
+
+int AsyncLogBuffer::sync()
+{
+  if (!line.empty())
+    Push();
+
+  // Wait for the background thread to write everything.
+  while (tail.load(std::memory_order_acquire) !=
+      head.load(std::memory_order_relaxed))
+    std::this_thread::yield();
+
+  return 0;
+}
+
+void AsyncLogBuffer::Push()
+{
+  const size_t h = head.load(std::memory_order_relaxed);
+  const size_t next = (h + 1) % ring.size();
+
+  // Wait for a free slot.
+  while (next == tail.load(std::memory_order_acquire))
+    std::this_thread::yield();
+
+  ring[h].swap(line);
+  line.clear();
+  head.store(next, std::memory_order_release);
+}
+
+void AsyncLogBuffer::Consume()
+{
+  while (true)
+  {
+    const size_t h = head.load(std::memory_order_acquire);
+    size_t t = tail.load(std::memory_order_relaxed);
+    if (t == h)
+    {
+      // The producer only sets stop once the ring buffer is empty.
+      if (stop.load(std::memory_order_acquire))
+        return;
+
+      std::this_thread::yield();
+      continue;
+    }
+
+    // Write all the available lines, then make them visible as written.
+    for (; t != h; t = (t + 1) % ring.size())
+      destination->sputn(ring[t].data(), ring[t].size());
+    destination->pubsync();
+
+    tail.store(h, std::memory_order_release);
+  }
+}
+
+AsyncLog::AsyncLog(std::ostream& stream, const size_t capacity) :
+    stream(stream),
+    original(stream.rdbuf()),
+    buffer(original, capacity)
+{
+  stream.rdbuf(&buffer);
+}
+
+AsyncLog::~AsyncLog()
+{
+  stream.flush();
+  stream.rdbuf(original);
+}
+
+void AsyncLog::Flush()
+{
+  stream.flush();
+}
@@ -0,0 +1,142 @@
+/**
+ * @file async_log.hpp
+ *
+ * Definition of the AsyncLog class, which moves the writes of a stream (such as
+ * the destination of Log::Info) to a background thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_ASYNC_LOG_HPP
+#define MLPACK_CORE_UTIL_ASYNC_LOG_HPP
+
+#include <atomic>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The stream buffer used by AsyncLog.  Characters are gathered into lines, and
+ * each complete line is handed to a background thread through a
+ * single-producer single-consumer ring buffer; the background thread writes it
+ * to the original stream buffer.  Only one thread may write to the buffer at a
+ * time (like the Log streams themselves).
+ */
+class AsyncLogBuffer : public std::streambuf
+{
+ public:
+  /**
+   * Start the background thread that writes to the given stream buffer.
+   *
+   * @param destination Stream buffer to write the lines to.
+   * @param capacity Number of lines that can wait to be written.
+   */
+  AsyncLogBuffer(std::streambuf* destination, const size_t capacity);
+
+  //! Write the remaining lines and stop the background thread.
+  ~AsyncLogBuffer();
+
+  //! Copying would share the background thread, so it is not allowed.
+  AsyncLogBuffer(const AsyncLogBuffer&) = delete;
+  //! Copying would share the background thread, so it is not allowed.
+  AsyncLogBuffer& operator=(const AsyncLogBuffer&) = delete;
+
+ protected:
+  //! Add a character to the current line.
+  int_type overflow(int_type c);
+
+  //! Add characters to the current line.
+  std::streamsize xsputn(const char* s, std::streamsize n);
+
+  //! Wait until everything given so far is written to the destination.
+  int sync();
+
+ private:
+  //! Hand the current line to the background thread.
+  void Push();
+
+  //! Write the lines of the ring buffer, until stopped.
+  void Consume();
+
+  //! The stream buffer the lines are written to.
+  std::streambuf* destination;
+  //! The line that is being written.
+  std::string line;
+  //! The ring buffer of lines; one slot is always empty.
+  std::vector<std::string> ring;
+  //! The index of the next slot to fill (only modified by the producer).
+  std::atomic<size_t> head;
+  //! The index of the next slot to write (only modified by the consumer).
+  std::atomic<size_t> tail;
+  //! Whether the background thread should stop once the ring buffer is empty.
+  std::atomic<bool> stop;
+  //! The background thread.
+  std::thread consumer;
+};
+
+/**
+ * Redirect a stream to a background thread while an AsyncLog object exists, so
+ * that writing a line to the stream only costs a copy into memory; this is
+ * useful when a slow destination (such as a terminal or a network file system)
+ * would stall a computation that logs often.  When the AsyncLog object is
+ * destroyed, the remaining lines are written and the stream is restored.
+ *
+ * The Log streams write to std::cout, so their output can be made asynchronous
+ * like this:
+ *
+ * @code
+ * {
+ *   util::AsyncLog asyncLog(std::cout);
+ *   // Anything written to Log::Info here is written by a background thread.
+ *   Log::Info << "Iteration " << i << std::endl;
+ * }
+ * // Everything is written here.
+ * @endcode
+ *
+ * The lines are written in order, and Flush() (or std::flush on the stream)
+ * waits until everything given so far is written.  If the ring buffer is full,
+ * a write waits for the background thread.  Only one thread may write to the
+ * stream at a time.
+ */
+class AsyncLog
+{
+ public:
+  /**
+   * Redirect the given stream to a background thread.
+   *
+   * @param stream Stream to redirect.
+   * @param capacity Number of lines that can wait to be written.
+   */
+  AsyncLog(std::ostream& stream, const size_t capacity = 1024);
+
+  //! Write the remaining lines and restore the stream.
+  ~AsyncLog();
+
+  //! Copying would restore the stream twice, so it is not allowed.
+  AsyncLog(const AsyncLog&) = delete;
+  //! Copying would restore the stream twice, so it is not allowed.
+  AsyncLog& operator=(const AsyncLog&) = delete;
+
+  //! Wait until everything written to the stream so far is written.
+  void Flush();
+
+ private:
+  //! The redirected stream.
+  std::ostream& stream;
+  //! The original stream buffer of the stream.
+  std::streambuf* original;
+  //! The stream buffer that hands the lines to the background thread.
+  AsyncLogBuffer buffer;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -88,6 +88,9 @@ void CLI::Add(ParamData&& data)
     GetSingleton().aliases[data.alias] = data.name;
 
   GetSingleton().parameters[data.name] = std::move(data);
+
+  // The parameters no longer match any stored settings.
+  GetSingleton().restoredSettings.clear();
 }
 
 /**
@@ -198,9 +201,40 @@ void CLI::RestoreSettings(const std::string& name, const bool fatal)
   }
   else
   {
-    GetSingleton().parameters = std::get<0>(GetSingleton().storageMap[name]);
-    GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
-    GetSingleton().functionMap = std::get<2>(GetSingleton().storageMap[name]);
+    std::map<std::string, util::ParamData>& stored =
+        std::get<0>(GetSingleton().storageMap[name]);
+    std::map<std::string, util::ParamData>& parameters =
+        GetSingleton().parameters;
+
+    // If these settings were the last ones restored, the aliases and function
+    // mappings are still in place, so only the values of the parameters have
+    // to be reset.  This makes repeated calls of the same binding cheap.
+    bool reset = (GetSingleton().restoredSettings == name &&
+        parameters.size() == stored.size());
+    std::map<std::string, util::ParamData>::iterator it = parameters.begin();
+    std::map<std::string, util::ParamData>::const_iterator it2 =
+        stored.begin();
+    for (; reset && it != parameters.end(); ++it, ++it2)
+      reset = (it->first == it2->first);
+
+    if (reset)
+    {
+      for (it = parameters.begin(), it2 = stored.begin();
+           it != parameters.end(); ++it, ++it2)
+      {
+        it->second.value = it2->second.value;
+        it->second.wasPassed = it2->second.wasPassed;
+        it->second.loaded = it2->second.loaded;
+      }
+    }
+    else
+    {
+      parameters = stored;
+      GetSingleton().aliases = std::get<1>(GetSingleton().storageMap[name]);
+      GetSingleton().functionMap =
+          std::get<2>(GetSingleton().storageMap[name]);
+      GetSingleton().restoredSettings = name;
+    }
   }
 }
 
@@ -256,4 +290,5 @@ void CLI::ClearSettings()
   GetSingleton().parameters = persistent;
   GetSingleton().aliases = persistentAliases;
   GetSingleton().functionMap = persistentFunctions;
+  GetSingleton().restoredSettings.clear();
 }
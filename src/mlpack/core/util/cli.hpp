@@ -266,6 +266,12 @@ class CLI
    * true and no settings with the given name have been stored (with
    * StoreSettings()).
    *
+   * If the given settings are the last ones that were restored, and they were
+   * not cleared since, only the values of the parameters are reset (the
+   * aliases and function mappings are left as they are), so that a binding
+   * that is called many times doesn't copy all of its settings again for each
+   * call.
+   *
    * @param name Name of settings to restore.
    * @param fatal Whether to throw an exception on an unknown name.
    */
@@ -293,6 +299,9 @@ class CLI
   //! Storage map for parameters.
   std::map<std::string, std::tuple<std::map<std::string, util::ParamData>,
       std::map<char, std::string>, FunctionMapType>> storageMap;
+  //! The name of the settings currently restored, if the parameters have not
+  //! been changed since they were restored (empty otherwise).
+  std::string restoredSettings;
 
  public:
   //! True, if CLI was used to parse command line options.
@@ -0,0 +1,81 @@
+/**
+ * @file count_allocations.hpp
+ *
+ * Replacements of the global operator new and operator delete that count the
+ * bytes allocated, so that Timer can report the bytes allocated in each timed
+ * phase.  This must be included in exactly one translation unit of a program;
+ * the command-line programs include it when mlpack is configured with
+ * -DCOUNT_ALLOCATIONS=ON.
+ *
+ * Armadillo allocates the memory of matrices itself, without operator new, so
+ * those allocations are only reflected in the peak resident set size.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_COUNT_ALLOCATIONS_HPP
+#define MLPACK_CORE_UTIL_COUNT_ALLOCATIONS_HPP
+
+#include "memory_usage.hpp"
+
+#include <cstdlib>
+#include <new>
+
+void* operator new(std::size_t size)
+{
+  mlpack::util::CountAllocation(size);
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == NULL)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  mlpack::util::CountAllocation(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+  return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+#endif
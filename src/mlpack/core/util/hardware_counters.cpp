@@ -0,0 +1,113 @@
+/**
+ * @file hardware_counters.cpp
+ *
+ * Implementation of the hardware performance counters with perf_event_open()
+ * on Linux.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "hardware_counters.hpp"
+
+#if defined(__linux__)
+  #include <cstring>
+  #include <linux/perf_event.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+#if defined(__linux__)
+
+namespace {
+
+/**
+ * The group of counters of a thread; the first counter leads the group, so
+ * that they are all read at once.
+ */
+class CounterGroup
+{
+ public:
+  CounterGroup() : opened(false)
+  {
+    const uint64_t configs[4] = { PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES };
+
+    for (size_t i = 0; i < 4; ++i)
+      fds[i] = -1;
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[i];
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      // Count the calling thread, on any CPU.
+      fds[i] = (int) syscall(__NR_perf_event_open, &attr, 0, -1,
+          (i == 0) ? -1 : fds[0], 0);
+      if (fds[i] == -1)
+        return;
+    }
+
+    opened = true;
+  }
+
+  ~CounterGroup()
+  {
+    for (size_t i = 0; i < 4; ++i)
+      if (fds[i] != -1)
+        close(fds[i]);
+  }
+
+  bool Read(HardwareCounterValues& values)
+  {
+    if (!opened)
+      return false;
+
+    // The group format is the number of counters, then their values.
+    uint64_t buffer[5];
+    if (read(fds[0], buffer, sizeof(buffer)) != (ssize_t) sizeof(buffer) ||
+        buffer[0] != 4)
+      return false;
+
+    values.cycles = buffer[1];
+    values.instructions = buffer[2];
+    values.cacheMisses = buffer[3];
+    values.branchMisses = buffer[4];
+    return true;
+  }
+
+ private:
+  //! The file descriptors of the counters.
+  int fds[4];
+  //! Whether all the counters could be opened.
+  bool opened;
+};
+
+} // namespace
+
+bool mlpack::util::ReadHardwareCounters(HardwareCounterValues& values)
+{
+  // Counters only count the thread that opened them.
+  thread_local CounterGroup group;
+  return group.Read(values);
+}
+
+#else
+
+bool mlpack::util::ReadHardwareCounters(HardwareCounterValues& /* values */)
+{
+  return false;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/**
+ * @file hardware_counters.hpp
+ *
+ * Functions to read the hardware performance counters of the calling thread,
+ * used by Timer to report the counters of each timed phase.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_HARDWARE_COUNTERS_HPP
+#define MLPACK_CORE_UTIL_HARDWARE_COUNTERS_HPP
+
+#include <cstdint>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Values of the hardware performance counters.
+ */
+struct HardwareCounterValues
+{
+  //! CPU cycles.
+  uint64_t cycles;
+  //! Retired instructions.
+  uint64_t instructions;
+  //! Last-level cache misses.
+  uint64_t cacheMisses;
+  //! Mispredicted branches.
+  uint64_t branchMisses;
+};
+
+/**
+ * Read the hardware performance counters of the calling thread (user space
+ * only).  The counters of a thread are opened the first time they are read,
+ * with perf_event_open(), and count from then on.  This is only supported on
+ * Linux; it fails if the counters can't be opened (for instance if
+ * /proc/sys/kernel/perf_event_paranoid forbids it, or in some virtual
+ * machines).
+ *
+ * @param values Values of the counters.
+ * @return Whether the counters could be read.
+ */
+bool ReadHardwareCounters(HardwareCounterValues& values);
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -95,4 +95,48 @@ class Log
 
 }; // namespace mlpack
 
+/**
+ * The MLPACK_LOG_DEBUG, MLPACK_LOG_INFO, and MLPACK_LOG_WARN macros can be used
+ * in place of Log::Debug, Log::Info, and Log::Warn in code that logs often,
+ * such as the iterations of an optimization.  Their operands are only
+ * evaluated if the stream is shown, so a disabled stream costs one test; and
+ * the levels below MLPACK_LOG_LEVEL (if it is defined before mlpack is
+ * included) are removed at compile time.
+ *
+ * @code
+ * MLPACK_LOG_INFO << "Objective: " << ComputeObjective() << std::endl;
+ * @endcode
+ *
+ * Since the macros expand to an if/else statement, they can be used as the
+ * body of an unbraced if.
+ */
+#define MLPACK_LOG_LEVEL_DEBUG 0
+#define MLPACK_LOG_LEVEL_INFO 1
+#define MLPACK_LOG_LEVEL_WARN 2
+
+#ifndef MLPACK_LOG_LEVEL
+  #define MLPACK_LOG_LEVEL MLPACK_LOG_LEVEL_DEBUG
+#endif
+
+#if defined(DEBUG) && (MLPACK_LOG_LEVEL <= MLPACK_LOG_LEVEL_DEBUG)
+  #define MLPACK_LOG_DEBUG \
+      if (mlpack::Log::Debug.ignoreInput) { } else mlpack::Log::Debug
+#else
+  #define MLPACK_LOG_DEBUG if (true) { } else mlpack::Log::Debug
+#endif
+
+#if (MLPACK_LOG_LEVEL <= MLPACK_LOG_LEVEL_INFO)
+  #define MLPACK_LOG_INFO \
+      if (mlpack::Log::Info.ignoreInput) { } else mlpack::Log::Info
+#else
+  #define MLPACK_LOG_INFO if (true) { } else mlpack::Log::Info
+#endif
+
+#if (MLPACK_LOG_LEVEL <= MLPACK_LOG_LEVEL_WARN)
+  #define MLPACK_LOG_WARN \
+      if (mlpack::Log::Warn.ignoreInput) { } else mlpack::Log::Warn
+#else
+  #define MLPACK_LOG_WARN if (true) { } else mlpack::Log::Warn
+#endif
+
 #endif
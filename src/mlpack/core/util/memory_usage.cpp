@@ -0,0 +1,57 @@
+/**
+ * @file memory_usage.cpp
+ *
+ * Implementation of the memory usage functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "memory_usage.hpp"
+
+#include <atomic>
+
+#if !defined(_WIN32)
+  #include <sys/resource.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::util;
+
+// The number of bytes counted by CountAllocation().  This is a function-local
+// static, so that it can be used by allocations during static initialization.
+static std::atomic<uint64_t>& AllocationCounter()
+{
+  static std::atomic<uint64_t> counter(0);
+  return counter;
+}
+
+size_t mlpack::util::PeakRSS()
+{
+#if defined(_WIN32)
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  #if defined(__APPLE__)
+    // Bytes on OS X.
+    return (size_t) usage.ru_maxrss;
+  #else
+    // Kilobytes on Linux and the BSDs.
+    return (size_t) usage.ru_maxrss * 1024;
+  #endif
+#endif
+}
+
+uint64_t mlpack::util::AllocatedBytes()
+{
+  return AllocationCounter().load(std::memory_order_relaxed);
+}
+
+void mlpack::util::CountAllocation(const size_t bytes)
+{
+  AllocationCounter().fetch_add(bytes, std::memory_order_relaxed);
+}
@@ -0,0 +1,45 @@
+/**
+ * @file memory_usage.hpp
+ *
+ * Functions to get the memory usage of the process, used by Timer to report
+ * the memory used by each timed phase.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+#define MLPACK_CORE_UTIL_MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Get the peak resident set size of the process so far, in bytes.  This is 0
+ * if the platform doesn't report it.
+ */
+size_t PeakRSS();
+
+/**
+ * Get the number of bytes allocated so far by the process, as counted by
+ * CountAllocation().  Memory that is freed is not subtracted.
+ */
+uint64_t AllocatedBytes();
+
+/**
+ * Count an allocation of the given number of bytes.  This is called by the
+ * replacements of operator new in count_allocations.hpp, and can be called by
+ * custom allocators.  It is safe to call from any thread.
+ *
+ * @param bytes Number of bytes allocated.
+ */
+void CountAllocation(const size_t bytes);
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -56,6 +56,12 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
+
+// Count the bytes allocated by each timed phase, if requested.
+#ifdef MLPACK_COUNT_ALLOCATIONS
+  #include <mlpack/core/util/count_allocations.hpp>
+#endif
 
 static void mlpackMain(); // This is typically defined after this include.
 
@@ -63,13 +69,29 @@ int main(int argc, char** argv)
 {
   // Parse the command-line options; put them into CLI.
   mlpack::bindings::cli::ParseCommandLine(argc, argv);
-  // Enable timing.
+  // Enable timing, and record the memory used by each timer.
   mlpack::Timer::EnableTiming();
+  mlpack::Timer::EnableMemoryProfiling();
+  if (mlpack::CLI::HasParam("hardware_counters"))
+    mlpack::Timer::EnableHardwareCounters();
+
+  // Set the number of threads used by the parallel parts of the program.
+  if (mlpack::CLI::GetParam<int>("threads") < 0)
+  {
+    mlpack::Log::Fatal << "Invalid value of --threads ("
+        << mlpack::CLI::GetParam<int>("threads") << "); must be 0 or greater."
+        << std::endl;
+  }
+  mlpack::SetThreads((size_t) mlpack::CLI::GetParam<int>("threads"));
 
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
 
-  mlpackMain();
+  // In server mode, the program is run once for each request on stdin.
+  if (mlpack::CLI::HasParam("server"))
+    mlpack::bindings::cli::Serve(mlpackMain, std::cin, std::cout);
+  else
+    mlpackMain();
 
   // Print output options, print verbose information, save model parameters,
   // clean up, and so forth.
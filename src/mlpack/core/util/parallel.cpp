@@ -0,0 +1,80 @@
+/**
+ * @file parallel.cpp
+ *
+ * Implementation of the functions that control the number of threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "parallel.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+#ifdef HAS_OPENMP
+//! Get OpenMP's default number of threads, before SetThreads() changes it.
+static size_t DefaultThreads()
+{
+  static const size_t defaultThreads = (size_t) omp_get_max_threads();
+  return defaultThreads;
+}
+#endif
+
+size_t Threads()
+{
+  #ifdef HAS_OPENMP
+    return (size_t) omp_get_max_threads();
+  #else
+    return 1;
+  #endif
+}
+
+void SetThreads(const size_t threads)
+{
+  #ifdef HAS_OPENMP
+    // Make sure the default is known before it is overwritten.
+    const size_t defaultThreads = DefaultThreads();
+    omp_set_num_threads((int) (threads == 0 ? defaultThreads : threads));
+  #else
+    (void) threads;
+  #endif
+}
+
+size_t ParallelForThreads(const size_t threads)
+{
+  #ifdef HAS_OPENMP
+    if (omp_in_parallel())
+      return (size_t) omp_get_num_threads();
+    return (threads == 0) ? Threads() : threads;
+  #else
+    (void) threads;
+    return 1;
+  #endif
+}
+
+size_t ThreadId()
+{
+  #ifdef HAS_OPENMP
+    return (size_t) omp_get_thread_num();
+  #else
+    return 0;
+  #endif
+}
+
+ScopedThreads::ScopedThreads(const size_t threads) : oldThreads(Threads())
+{
+  if (threads != 0)
+    SetThreads(threads);
+}
+
+ScopedThreads::~ScopedThreads()
+{
+  SetThreads(oldThreads);
+}
+
+} // namespace mlpack
@@ -0,0 +1,137 @@
+/**
+ * @file parallel.hpp
+ *
+ * Common parallel loop and task functions for the methods in mlpack, and the
+ * global number of threads they use.  These are built on OpenMP (which mlpack
+ * uses everywhere else, so that the work of nested loops is given to the
+ * threads already running instead of starting new ones), and run serially when
+ * mlpack is compiled without OpenMP.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PARALLEL_HPP
+#define MLPACK_CORE_UTIL_PARALLEL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Get the number of threads that parallel loops use by default.  This is the
+ * number of threads given to SetThreads(), or else OpenMP's default (set by the
+ * OMP_NUM_THREADS environment variable, or the number of cores).  Without
+ * OpenMP, this is 1.
+ */
+size_t Threads();
+
+/**
+ * Set the number of threads that parallel loops use by default (both the loops
+ * of ParallelFor() and the OpenMP loops elsewhere).  0 restores OpenMP's
+ * default.  This is what the --threads option of the command-line programs
+ * sets.
+ *
+ * @param threads Number of threads to use.
+ */
+void SetThreads(const size_t threads);
+
+/**
+ * Get the number of threads a ParallelFor() called from here with the given
+ * number of threads may run its function on: inside of a parallel region this
+ * is the size of the team of threads running it, since the team runs the loop.
+ * ThreadId() is always less than this, so it can be used to size per-thread
+ * buffers.
+ *
+ * @param threads Number of threads given to ParallelFor() (0 for Threads()).
+ */
+size_t ParallelForThreads(const size_t threads = 0);
+
+/**
+ * Get the index of the calling thread in the team of threads running the
+ * current parallel region (0 outside of parallel regions).
+ */
+size_t ThreadId();
+
+/**
+ * Set the default number of threads for the lifetime of this object, and then
+ * restore the previous number.  This is the way to give the number of threads
+ * for a single call:
+ *
+ * @code
+ * {
+ *   ScopedThreads threads(4);
+ *   kmeans.Cluster(dataset, clusters, assignments);
+ * }
+ * @endcode
+ */
+class ScopedThreads
+{
+ public:
+  /**
+   * Use the given number of threads until this object is destroyed.  0 leaves
+   * the number of threads unchanged.
+   *
+   * @param threads Number of threads to use.
+   */
+  ScopedThreads(const size_t threads);
+
+  //! Restore the previous number of threads.
+  ~ScopedThreads();
+
+ private:
+  //! The number of threads before this object was created.
+  size_t oldThreads;
+};
+
+/**
+ * Call function(i) for each i in [begin, end), in parallel.  The indices are
+ * split into chunks of the given grain size, which are handed out to the
+ * threads as they finish their previous chunks, so uneven work is balanced.
+ *
+ * Outside of a parallel region, a team of threads is started for the loop.
+ * Inside of one (for instance, when the function of another ParallelFor() calls
+ * ParallelFor() again, or inside of ParallelInvoke()), the chunks become OpenMP
+ * tasks, which the threads of the existing team pick up when they are idle, so
+ * nested loops never use more threads than the outer one.
+ *
+ * The function may be called at the same time from different threads, and must
+ * not throw exceptions (an exception can't leave an OpenMP thread); use
+ * ThreadId() to index per-thread state.  Since tasks may run one after
+ * another, an index must never wait for another index to make progress.
+ *
+ * @param begin First index.
+ * @param end One past the last index.
+ * @param function Function to call with each index.
+ * @param grain Number of consecutive indices each thread handles at a time.
+ * @param threads Number of threads to use (0 for Threads(); 1 runs the loop
+ *     serially).
+ */
+template<typename FunctionType>
+void ParallelFor(const size_t begin,
+                 const size_t end,
+                 const FunctionType& function,
+                 const size_t grain = 1,
+                 const size_t threads = 0);
+
+/**
+ * Call first() and second(), possibly at the same time.  This is meant for
+ * recursive divide and conquer algorithms (such as the construction of the
+ * children of a tree node): inside of a parallel region, first() becomes a
+ * task that an idle thread can pick up, and outside of one, a parallel region
+ * is started for both calls and everything they call.  Neither function may
+ * throw exceptions.
+ *
+ * @param first First function to call.
+ * @param second Second function to call.
+ */
+template<typename FirstType, typename SecondType>
+void ParallelInvoke(const FirstType& first, const SecondType& second);
+
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_impl.hpp"
+
+#endif
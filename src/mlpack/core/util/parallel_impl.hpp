@@ -0,0 +1,117 @@
+/**
+ * @file parallel_impl.hpp
+ *
+ * Implementation of ParallelFor() and ParallelInvoke().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_PARALLEL_IMPL_HPP
+#define MLPACK_CORE_UTIL_PARALLEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel.hpp"
+
+#include <algorithm>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+template<typename FunctionType>
+void ParallelFor(const size_t begin,
+                 const size_t end,
+                 const FunctionType& function,
+                 const size_t grain,
+                 const size_t threads)
+{
+  if (end <= begin)
+    return;
+
+  #ifdef HAS_OPENMP
+  const size_t chunk = std::max(grain, (size_t) 1);
+  const size_t numChunks = (end - begin + chunk - 1) / chunk;
+  const size_t numThreads = (threads == 0) ? Threads() : threads;
+  if (numChunks > 1 && numThreads > 1)
+  {
+    // Tasks take their variables by value, so the function is passed through a
+    // pointer.
+    const FunctionType* f = &function;
+    if (omp_in_parallel())
+    {
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        #pragma omp task
+        {
+          const size_t chunkEnd = std::min(end, begin + (c + 1) * chunk);
+          for (size_t i = begin + c * chunk; i < chunkEnd; ++i)
+            (*f)(i);
+        }
+      }
+      #pragma omp taskwait
+    }
+    else
+    {
+      #pragma omp parallel for schedule(dynamic) num_threads((int) numThreads)
+      for (omp_size_t c = 0; c < (omp_size_t) numChunks; ++c)
+      {
+        const size_t chunkEnd = std::min(end, begin + (c + 1) * chunk);
+        for (size_t i = begin + c * chunk; i < chunkEnd; ++i)
+          (*f)(i);
+      }
+    }
+
+    return;
+  }
+  #else
+  (void) grain;
+  (void) threads;
+  #endif
+
+  for (size_t i = begin; i < end; ++i)
+    function(i);
+}
+
+template<typename FirstType, typename SecondType>
+void ParallelInvoke(const FirstType& first, const SecondType& second)
+{
+  #ifdef HAS_OPENMP
+  const FirstType* f = &first;
+  const SecondType* s = &second;
+  if (omp_in_parallel())
+  {
+    #pragma omp task
+    (*f)();
+    (*s)();
+    #pragma omp taskwait
+    return;
+  }
+  else if (Threads() > 1)
+  {
+    // Everything called by the two functions runs in this region, so further
+    // calls of ParallelInvoke() and ParallelFor() make tasks too.
+    #pragma omp parallel num_threads((int) Threads())
+    {
+      #pragma omp single
+      {
+        #pragma omp task
+        (*f)();
+        (*s)();
+        #pragma omp taskwait
+      }
+    }
+    return;
+  }
+  #endif
+
+  first();
+  second();
+}
+
+} // namespace mlpack
+
+#endif
@@ -38,6 +38,11 @@ template<typename T>
 typename std::enable_if<!arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Nothing is shown, so there is no need to format the value, unless we may
+  // have to terminate at the end of a line.
+  if (ignoreInput && !fatal)
+    return;
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
@@ -146,6 +151,11 @@ template<typename T>
 typename std::enable_if<arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Nothing is shown, so there is no need to format the value, unless we may
+  // have to terminate at the end of a line.
+  if (ignoreInput && !fatal)
+    return;
+
   // Extract printable object from the input.
   const arma::Mat<typename T::elem_type>& printVal(val);
 
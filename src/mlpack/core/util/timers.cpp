@@ -14,9 +14,13 @@
 #include "timers.hpp"
 #include "cli.hpp"
 #include "log.hpp"
+#include "memory_usage.hpp"
 
 #include <map>
 #include <string>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 using namespace mlpack;
 using namespace std;
@@ -64,12 +68,304 @@ void Timer::ResetAll()
   CLI::GetSingleton().timer.Reset();
 }
 
+// Add to a counter.
+void Timer::Count(const string& name, const uint64_t value)
+{
+  CLI::GetSingleton().timer.AddCount(name, value);
+}
+
+// Get a counter.
+uint64_t Timer::GetCount(const string& name)
+{
+  return CLI::GetSingleton().timer.GetCount(name);
+}
+
+// Enable tracing.
+void Timer::EnableTracing()
+{
+  CLI::GetSingleton().timer.Tracing() = true;
+}
+
+// Disable tracing.
+void Timer::DisableTracing()
+{
+  CLI::GetSingleton().timer.Tracing() = false;
+}
+
+// Enable memory profiling.
+void Timer::EnableMemoryProfiling()
+{
+  CLI::GetSingleton().timer.MemoryProfiling() = true;
+}
+
+// Disable memory profiling.
+void Timer::DisableMemoryProfiling()
+{
+  CLI::GetSingleton().timer.MemoryProfiling() = false;
+}
+
+// Get the memory used by a timer.
+TimerMemory Timer::GetMemory(const string& name)
+{
+  return CLI::GetSingleton().timer.GetMemory(name);
+}
+
+// Enable hardware counters.
+void Timer::EnableHardwareCounters()
+{
+  CLI::GetSingleton().timer.HardwareCounters() = true;
+}
+
+// Disable hardware counters.
+void Timer::DisableHardwareCounters()
+{
+  CLI::GetSingleton().timer.HardwareCounters() = false;
+}
+
+// Get the hardware counters of a timer.
+util::HardwareCounterValues Timer::GetHardwareCounters(const string& name)
+{
+  return CLI::GetSingleton().timer.GetHardwareCounters(name);
+}
+
+// Export all timers and counters as JSON.
+void Timer::ExportJSON(ostream& stream)
+{
+  CLI::GetSingleton().timer.WriteJSON(stream);
+}
+
+// Export the recorded runs of all timers.
+void Timer::ExportTrace(ostream& stream)
+{
+  CLI::GetSingleton().timer.WriteTrace(stream);
+}
+
 // Reset a Timers object.
 void Timers::Reset()
 {
   lock_guard<mutex> lock(timersMutex);
   timers.clear();
   timerStartTime.clear();
+  counters.clear();
+  memory.clear();
+  timerStartMemory.clear();
+  hardware.clear();
+  timerStartHardware.clear();
+  traceEvents.clear();
+  traceThreads.clear();
+  traceOrigin = high_resolution_clock::now();
+}
+
+void Timers::AddCount(const string& counterName, const uint64_t value)
+{
+  // Don't do anything if we aren't timing.
+  if (!enabled)
+    return;
+
+  lock_guard<mutex> lock(timersMutex);
+  counters[counterName] += value;
+}
+
+uint64_t Timers::GetCount(const string& counterName)
+{
+  lock_guard<mutex> lock(timersMutex);
+  map<string, uint64_t>::const_iterator it = counters.find(counterName);
+  return (it == counters.end()) ? 0 : it->second;
+}
+
+TimerMemory Timers::GetMemory(const string& timerName)
+{
+  lock_guard<mutex> lock(timersMutex);
+  map<string, TimerMemory>::const_iterator it = memory.find(timerName);
+  if (it == memory.end())
+  {
+    TimerMemory empty;
+    empty.peakRSS = 0;
+    empty.allocated = 0;
+    return empty;
+  }
+
+  return it->second;
+}
+
+map<string, TimerMemory> Timers::GetAllMemory()
+{
+  lock_guard<mutex> lock(timersMutex);
+  return memory;
+}
+
+void Timers::RecordMemory(const string& timerName, const thread::id& threadId)
+{
+  // The timer may have been started before memory profiling was enabled.
+  map<thread::id, map<string, uint64_t>>::iterator it =
+      timerStartMemory.find(threadId);
+  if (it == timerStartMemory.end() || it->second.count(timerName) == 0)
+    return;
+
+  TimerMemory& m = memory[timerName];
+  m.peakRSS = std::max(m.peakRSS, util::PeakRSS());
+  m.allocated += util::AllocatedBytes() - it->second[timerName];
+
+  it->second.erase(timerName);
+  if (it->second.empty())
+    timerStartMemory.erase(it);
+}
+
+util::HardwareCounterValues Timers::GetHardwareCounters(
+    const string& timerName)
+{
+  lock_guard<mutex> lock(timersMutex);
+  map<string, util::HardwareCounterValues>::const_iterator it =
+      hardware.find(timerName);
+  if (it == hardware.end())
+  {
+    util::HardwareCounterValues empty;
+    empty.cycles = 0;
+    empty.instructions = 0;
+    empty.cacheMisses = 0;
+    empty.branchMisses = 0;
+    return empty;
+  }
+
+  return it->second;
+}
+
+map<string, util::HardwareCounterValues> Timers::GetAllHardwareCounters()
+{
+  lock_guard<mutex> lock(timersMutex);
+  return hardware;
+}
+
+void Timers::RecordHardwareCounters(const string& timerName,
+                                    const thread::id& threadId,
+                                    const util::HardwareCounterValues* values)
+{
+  // The timer may have been started before the counters were enabled, or
+  // they may not be readable.
+  map<thread::id, map<string, util::HardwareCounterValues>>::iterator it =
+      timerStartHardware.find(threadId);
+  if (it == timerStartHardware.end() || it->second.count(timerName) == 0)
+    return;
+
+  if (values != NULL)
+  {
+    const util::HardwareCounterValues& start = it->second[timerName];
+    util::HardwareCounterValues& h = hardware[timerName];
+    h.cycles += values->cycles - start.cycles;
+    h.instructions += values->instructions - start.instructions;
+    h.cacheMisses += values->cacheMisses - start.cacheMisses;
+    h.branchMisses += values->branchMisses - start.branchMisses;
+  }
+
+  it->second.erase(timerName);
+  if (it->second.empty())
+    timerStartHardware.erase(it);
+}
+
+map<string, uint64_t> Timers::GetAllCounters()
+{
+  // Make a copy of the counters.
+  lock_guard<mutex> lock(timersMutex);
+  return counters;
+}
+
+// Write the given string as a quoted JSON string.
+static void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    const char c = str[i];
+    if (c == '"' || c == '\\')
+    {
+      stream << '\\' << c;
+    }
+    else if ((unsigned char) c < 0x20)
+    {
+      ostringstream code;
+      code << "\\u" << hex << setw(4) << setfill('0') << (int) c;
+      stream << code.str();
+    }
+    else
+    {
+      stream << c;
+    }
+  }
+  stream << '"';
+}
+
+void Timers::WriteJSON(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  stream << "{\n  \"timers\": {";
+  for (map<string, microseconds>::const_iterator it = timers.begin();
+       it != timers.end(); ++it)
+  {
+    stream << (it == timers.begin() ? "\n    " : ",\n    ");
+    WriteJSONString(stream, it->first);
+    stream << ": " << it->second.count();
+  }
+  stream << "\n  },\n  \"counters\": {";
+  for (map<string, uint64_t>::const_iterator it = counters.begin();
+       it != counters.end(); ++it)
+  {
+    stream << (it == counters.begin() ? "\n    " : ",\n    ");
+    WriteJSONString(stream, it->first);
+    stream << ": " << it->second;
+  }
+  stream << "\n  },\n  \"memory\": {";
+  for (map<string, TimerMemory>::const_iterator it = memory.begin();
+       it != memory.end(); ++it)
+  {
+    stream << (it == memory.begin() ? "\n    " : ",\n    ");
+    WriteJSONString(stream, it->first);
+    stream << ": {\"peak_rss\": " << it->second.peakRSS
+        << ", \"allocated\": " << it->second.allocated << "}";
+  }
+  stream << "\n  },\n  \"hardware_counters\": {";
+  for (map<string, util::HardwareCounterValues>::const_iterator it =
+       hardware.begin(); it != hardware.end(); ++it)
+  {
+    stream << (it == hardware.begin() ? "\n    " : ",\n    ");
+    WriteJSONString(stream, it->first);
+    stream << ": {\"cycles\": " << it->second.cycles
+        << ", \"instructions\": " << it->second.instructions
+        << ", \"cache_misses\": " << it->second.cacheMisses
+        << ", \"branch_misses\": " << it->second.branchMisses << "}";
+  }
+  stream << "\n  }\n}\n";
+}
+
+void Timers::WriteTrace(ostream& stream)
+{
+  lock_guard<mutex> lock(timersMutex);
+
+  // Each run is a complete ("X") event; times are in microseconds.
+  stream << "{\"traceEvents\": [";
+  for (size_t i = 0; i < traceEvents.size(); ++i)
+  {
+    const TraceEvent& e = traceEvents[i];
+    stream << (i == 0 ? "\n  " : ",\n  ") << "{\"name\": ";
+    WriteJSONString(stream, e.name);
+    stream << ", \"cat\": \"mlpack\", \"ph\": \"X\", \"ts\": "
+        << e.start.count() << ", \"dur\": " << e.duration.count()
+        << ", \"pid\": 0, \"tid\": " << e.thread << "}";
+  }
+
+  // Counters are shown as a single sample at the end of the trace.
+  const microseconds end = duration_cast<microseconds>(
+      high_resolution_clock::now() - traceOrigin);
+  for (map<string, uint64_t>::const_iterator it = counters.begin();
+       it != counters.end(); ++it)
+  {
+    stream << ((traceEvents.empty() && it == counters.begin()) ? "\n  " :
+        ",\n  ") << "{\"name\": ";
+    WriteJSONString(stream, it->first);
+    stream << ", \"ph\": \"C\", \"ts\": " << end.count()
+        << ", \"pid\": 0, \"args\": {\"value\": " << it->second << "}}";
+  }
+  stream << "\n], \"displayTimeUnit\": \"ms\"}\n";
 }
 
 map<string, microseconds> Timers::GetAllTimers()
@@ -163,10 +459,25 @@ void Timers::StopAllTimers()
   // the map and would invalidate our iterators.
   lock_guard<mutex> lock(timersMutex);
 
+  // Only the counters of the calling thread can be read.
+  util::HardwareCounterValues values;
+  const bool readCounters = !timerStartHardware.empty() &&
+      util::ReadHardwareCounters(values);
+
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
   for (auto it : timerStartTime)
+  {
     for (auto it2 : it.second)
+    {
       timers[it2.first] += duration_cast<microseconds>(currTime - it2.second);
+      RecordMemory(it2.first, it.first);
+      if (readCounters && it.first == this_thread::get_id())
+        RecordHardwareCounters(it2.first, it.first, &values);
+    }
+  }
+
+  timerStartMemory.clear();
+  timerStartHardware.clear();
 
   // If all timers are stopped, we can clear the maps.
   timerStartTime.clear();
@@ -199,6 +510,13 @@ void Timers::StartTimer(const string& timerName,
   }
 
   timerStartTime[threadId][timerName] = currTime;
+  if (memoryProfiling)
+    timerStartMemory[threadId][timerName] = util::AllocatedBytes();
+
+  // Read the counters last, so that the timer itself is not counted.
+  util::HardwareCounterValues values;
+  if (hardwareCounters && util::ReadHardwareCounters(values))
+    timerStartHardware[threadId][timerName] = values;
 }
 
 void Timers::StopTimer(const string& timerName,
@@ -208,6 +526,11 @@ void Timers::StopTimer(const string& timerName,
   if (!enabled)
     return;
 
+  // Read the counters first, so that the timer itself is not counted.
+  util::HardwareCounterValues values;
+  const bool readCounters = hardwareCounters &&
+      util::ReadHardwareCounters(values);
+
   lock_guard<mutex> lock(timersMutex);
 
   if ((timerStartTime.count(threadId) == 0) ||
@@ -222,8 +545,27 @@ void Timers::StopTimer(const string& timerName,
   high_resolution_clock::time_point currTime = high_resolution_clock::now();
 
   // Calculate the delta time.
-  timers[timerName] += duration_cast<microseconds>(currTime -
-      timerStartTime[threadId][timerName]);
+  const high_resolution_clock::time_point startTime =
+      timerStartTime[threadId][timerName];
+  const microseconds delta = duration_cast<microseconds>(currTime - startTime);
+  timers[timerName] += delta;
+  RecordMemory(timerName, threadId);
+  RecordHardwareCounters(timerName, threadId, readCounters ? &values : NULL);
+
+  // Record the run, if requested.
+  if (tracing)
+  {
+    const size_t newIndex = traceThreads.size();
+    const size_t threadIndex =
+        traceThreads.insert(make_pair(threadId, newIndex)).first->second;
+
+    TraceEvent e;
+    e.name = timerName;
+    e.thread = threadIndex;
+    e.start = duration_cast<microseconds>(startTime - traceOrigin);
+    e.duration = delta;
+    traceEvents.push_back(e);
+  }
 
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
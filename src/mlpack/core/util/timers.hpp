@@ -20,7 +20,12 @@
 #include <thread> // std::thread is used for thread safety.
 #include <mutex>
 #include <list>
+#include <vector>
 #include <atomic>
+#include <ostream>
+#include <stdexcept>
+
+#include "hardware_counters.hpp"
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -35,12 +40,36 @@
 
 namespace mlpack {
 
+/**
+ * The memory used by the runs of a timer, if memory profiling is enabled.
+ */
+struct TimerMemory
+{
+  //! The peak resident set size of the process at the end of a run, in bytes.
+  size_t peakRSS;
+  //! The number of bytes allocated during the runs.
+  uint64_t allocated;
+};
+
 /**
  * The timer class provides a way for mlpack methods to be timed.  The three
  * methods contained in this class allow a named timer to be started and
  * stopped, and its value to be obtained.  A named timer is specific to the
  * thread it is running on, so if you start a timer in one thread, it cannot be
  * stopped from a different thread.
+ *
+ * Named counters (for instance the number of base cases or scores of a tree
+ * traversal) can be accumulated with Count().  If tracing is enabled with
+ * EnableTracing(), every run of every timer is also recorded with its start
+ * time and thread, so that nested timers can be inspected as a timeline with
+ * ExportTrace() (Chrome trace event format, for chrome://tracing or Perfetto).
+ * If memory profiling is enabled with EnableMemoryProfiling(), the peak
+ * resident set size and the bytes allocated are also recorded for each timer
+ * (see GetMemory()).  On Linux, EnableHardwareCounters() records the
+ * hardware performance counters (cycles, instructions, cache misses, and
+ * branch misses) of each timer (see GetHardwareCounters()).  ExportJSON()
+ * writes the totals of all timers and counters, and the memory and hardware
+ * counters of the timers.
  */
 class Timer
 {
@@ -92,13 +121,149 @@ class Timer
    * existing timers.
    */
   static void ResetAll();
+
+  /**
+   * Add the given value to the named counter.  Counters are only kept while
+   * timing is enabled.  Since this takes a lock, hot loops should accumulate
+   * locally and call this once with the total.
+   *
+   * @param name Name of the counter.
+   * @param value Value to add to the counter.
+   */
+  static void Count(const std::string& name, const uint64_t value = 1);
+
+  /**
+   * Get the value of the given counter.
+   *
+   * @param name Name of counter to return value of.
+   */
+  static uint64_t GetCount(const std::string& name);
+
+  /**
+   * Record every run of every timer, so that it can be exported with
+   * ExportTrace().  Timing must also be enabled.
+   */
+  static void EnableTracing();
+
+  //! Stop recording runs of timers.  Recorded runs are kept until ResetAll().
+  static void DisableTracing();
+
+  /**
+   * Record the memory used by each timer.  Timing must also be enabled.  The
+   * bytes allocated are those counted by util::CountAllocation() (which is
+   * called for every operator new if count_allocations.hpp is included in the
+   * program); they include the allocations of other threads running at the
+   * same time.
+   */
+  static void EnableMemoryProfiling();
+
+  //! Stop recording the memory used by each timer.
+  static void DisableMemoryProfiling();
+
+  /**
+   * Get the memory used by the given timer.  Both values are 0 if memory
+   * profiling was not enabled while the timer ran.
+   *
+   * @param name Name of timer to return the memory of.
+   */
+  static TimerMemory GetMemory(const std::string& name);
+
+  /**
+   * Record the hardware performance counters of the thread that runs each
+   * timer, with perf_event_open() (Linux only; see
+   * util::ReadHardwareCounters()).  Timing must also be enabled.  When this is
+   * disabled, the counters are never opened.
+   */
+  static void EnableHardwareCounters();
+
+  //! Stop recording the hardware performance counters of each timer.
+  static void DisableHardwareCounters();
+
+  /**
+   * Get the hardware performance counters of the given timer.  All are 0 if
+   * hardware counters were not enabled while the timer ran, or if they could
+   * not be read.
+   *
+   * @param name Name of timer to return the counters of.
+   */
+  static util::HardwareCounterValues GetHardwareCounters(
+      const std::string& name);
+
+  /**
+   * Write the totals of all timers (in microseconds) and counters as a JSON
+   * object to the given stream.
+   *
+   * @param stream Stream to write to.
+   */
+  static void ExportJSON(std::ostream& stream);
+
+  /**
+   * Write all of the recorded runs of timers to the given stream, in the Chrome
+   * trace event format.  Nested timers on the same thread show up nested.
+   *
+   * @param stream Stream to write to.
+   */
+  static void ExportTrace(std::ostream& stream);
+};
+
+/**
+ * A timer that is started on construction and stopped when it goes out of
+ * scope, so that it is stopped even if an exception is thrown.  Scoped timers
+ * can be nested; with tracing enabled the inner runs show up inside the outer
+ * ones.
+ *
+ * @code
+ * {
+ *   ScopedTimer t("tree_building");
+ *   tree = new TreeType(dataset);
+ * }
+ * @endcode
+ */
+class ScopedTimer
+{
+ public:
+  /**
+   * Start the given timer.
+   *
+   * @param name Name of timer to run until this object is destroyed.
+   */
+  explicit ScopedTimer(const std::string& name) : name(name)
+  {
+    Timer::Start(name);
+  }
+
+  //! Stop the timer, if it is still running.
+  ~ScopedTimer()
+  {
+    // The timer may have been stopped already by Timer::ResetAll(); a
+    // destructor must not throw.
+    try
+    {
+      Timer::Stop(name);
+    }
+    catch (std::exception&) { }
+  }
+
+ private:
+  //! Name of the timer.
+  std::string name;
+
+  // Scoped timers cannot be copied.
+  ScopedTimer(const ScopedTimer& other);
+  ScopedTimer& operator=(const ScopedTimer& other);
 };
 
 class Timers
 {
  public:
   //! Default to disabled.
-  Timers() : enabled(false) { }
+  Timers() :
+      enabled(false),
+      tracing(false),
+      memoryProfiling(false),
+      hardwareCounters(false),
+      traceOrigin(std::chrono::high_resolution_clock::now())
+  { }
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -162,12 +327,106 @@ class Timers
    */
   void StopAllTimers();
 
+  /**
+   * Add the given value to the named counter.  Nothing is done if timing is
+   * not enabled.
+   *
+   * @param counterName The name of the counter in question.
+   * @param value Value to add to the counter.
+   */
+  void AddCount(const std::string& counterName, const uint64_t value);
+
+  /**
+   * Returns the value of the counter specified.
+   *
+   * @param counterName The name of the counter in question.
+   */
+  uint64_t GetCount(const std::string& counterName);
+
+  /**
+   * Returns a copy of all the counters used via this interface.
+   */
+  std::map<std::string, uint64_t> GetAllCounters();
+
+  /**
+   * Returns the memory used by the timer specified.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  TimerMemory GetMemory(const std::string& timerName);
+
+  /**
+   * Returns a copy of the memory used by all the timers, if memory profiling
+   * is enabled.
+   */
+  std::map<std::string, TimerMemory> GetAllMemory();
+
+  /**
+   * Returns the hardware performance counters of the timer specified.
+   *
+   * @param timerName The name of the timer in question.
+   */
+  util::HardwareCounterValues GetHardwareCounters(
+      const std::string& timerName);
+
+  /**
+   * Returns a copy of the hardware performance counters of all the timers, if
+   * they are enabled.
+   */
+  std::map<std::string, util::HardwareCounterValues> GetAllHardwareCounters();
+
+  /**
+   * Write the totals of all timers (in microseconds) and counters, and the
+   * memory and hardware counters of the timers, as a JSON object.
+   *
+   * @param stream Stream to write to.
+   */
+  void WriteJSON(std::ostream& stream);
+
+  /**
+   * Write the recorded runs of the timers in the Chrome trace event format.
+   *
+   * @param stream Stream to write to.
+   */
+  void WriteTrace(std::ostream& stream);
+
+  //! Modify whether or not runs of timers are recorded.
+  std::atomic<bool>& Tracing() { return tracing; }
+  //! Get whether or not runs of timers are recorded.
+  bool Tracing() const { return tracing; }
+
+  //! Modify whether or not the memory of timers is recorded.
+  std::atomic<bool>& MemoryProfiling() { return memoryProfiling; }
+  //! Get whether or not the memory of timers is recorded.
+  bool MemoryProfiling() const { return memoryProfiling; }
+
+  //! Modify whether or not the hardware counters of timers are recorded.
+  std::atomic<bool>& HardwareCounters() { return hardwareCounters; }
+  //! Get whether or not the hardware counters of timers are recorded.
+  bool HardwareCounters() const { return hardwareCounters; }
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
   bool Enabled() const { return enabled; }
 
  private:
+  /**
+   * Record the memory used by a run of the given timer that ends now.  The
+   * lock on the timers must be held.
+   */
+  void RecordMemory(const std::string& timerName,
+                    const std::thread::id& threadId);
+
+  /**
+   * Record the hardware counters of a run of the given timer that ends now,
+   * given the current values of the counters of its thread (or NULL if they
+   * could not be read).  The lock on the timers must be held.
+   */
+  void RecordHardwareCounters(const std::string& timerName,
+                              const std::thread::id& threadId,
+                              const util::HardwareCounterValues* values);
+
   //! A map of all the timers that are being tracked.
   std::map<std::string, std::chrono::microseconds> timers;
   //! A mutex for modifying the timers.
@@ -175,9 +434,46 @@ class Timers
   //! A map for the starting values of the timers.
   std::map<std::thread::id, std::map<std::string,
       std::chrono::high_resolution_clock::time_point>> timerStartTime;
+  //! A map of all the counters that are being tracked.
+  std::map<std::string, uint64_t> counters;
+  //! The memory used by the timers, if memory profiling is enabled.
+  std::map<std::string, TimerMemory> memory;
+  //! The bytes allocated when each running timer was started.
+  std::map<std::thread::id, std::map<std::string, uint64_t>> timerStartMemory;
+  //! The hardware counters of the timers, if they are enabled.
+  std::map<std::string, util::HardwareCounterValues> hardware;
+  //! The hardware counters of the thread when each running timer was started.
+  std::map<std::thread::id, std::map<std::string, util::HardwareCounterValues>>
+      timerStartHardware;
+
+  //! A single recorded run of a timer.
+  struct TraceEvent
+  {
+    //! Name of the timer.
+    std::string name;
+    //! Index of the thread the timer ran on.
+    size_t thread;
+    //! Start of the run, relative to traceOrigin.
+    std::chrono::microseconds start;
+    //! Length of the run.
+    std::chrono::microseconds duration;
+  };
+
+  //! The recorded runs of timers, if tracing is enabled.
+  std::vector<TraceEvent> traceEvents;
+  //! Small indices for the threads that appear in the trace.
+  std::map<std::thread::id, size_t> traceThreads;
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
+  //! Whether or not runs of timers are recorded.
+  std::atomic<bool> tracing;
+  //! Whether or not the memory of timers is recorded.
+  std::atomic<bool> memoryProfiling;
+  //! Whether or not the hardware counters of timers are recorded.
+  std::atomic<bool> hardwareCounters;
+  //! The time that trace events are relative to.
+  std::chrono::high_resolution_clock::time_point traceOrigin;
 };
 
 } // namespace mlpack
@@ -92,13 +92,16 @@ class AdaBoost
    * @param iterations Number of boosting rounds.
    * @param tol The tolerance for change in values of rt.
    * @param other Weak learner that has already been initialized.
+   * @param subsampleRatio Fraction of the points, drawn at random in each
+   *     round, that each weak learner is trained on (Default: all of them).
    */
   AdaBoost(const MatType& data,
            const arma::Row<size_t>& labels,
            const size_t numClasses,
            const WeakLearnerType& other,
            const size_t iterations = 100,
-           const double tolerance = 1e-6);
+           const double tolerance = 1e-6,
+           const double subsampleRatio = 1.0);
 
   /**
    * Create the AdaBoost object without training.  Be sure to call Train()
@@ -140,16 +143,24 @@ class AdaBoost
    * @param data Dataset to train on.
    * @param labels Labels for each point in the dataset.
    * @param learner Learner to use for training.
+   * @param iterations Number of boosting rounds.
+   * @param tolerance The tolerance for change in values of rt.
+   * @param subsampleRatio Fraction of the points, drawn at random in each
+   *     round, that each weak learner is trained on; the weak learner still
+   *     classifies all of the points to find the weights of the next round.
    */
   void Train(const MatType& data,
              const arma::Row<size_t>& labels,
              const size_t numClasses,
              const WeakLearnerType& learner,
              const size_t iterations = 100,
-             const double tolerance = 1e-6);
+             const double tolerance = 1e-6,
+             const double subsampleRatio = 1.0);
 
   /**
-   * Classify the given test points.
+   * Classify the given test points.  Each weak learner classifies all of the
+   * points at once, and the weighted votes are accumulated for all the points
+   * together.
    *
    * @param test Testing data.
    * @param predictedLabels Vector in which to the predicted labels of the test
@@ -164,6 +175,15 @@ class AdaBoost
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Draw the given number of distinct indices of points at random, in
+   * increasing order.
+   *
+   * @param n Number of points.
+   * @param size Number of indices to draw.
+   */
+  static arma::uvec Subsample(const size_t n, const size_t size);
+
   //! The number of classes in the model.
   size_t numClasses;
   // The tolerance for change in rt and when to stop.
@@ -47,9 +47,10 @@ AdaBoost<WeakLearnerType, MatType>::AdaBoost(
     const size_t numClasses,
     const WeakLearnerType& other,
     const size_t iterations,
-    const double tol)
+    const double tol,
+    const double subsampleRatio)
 {
-  Train(data, labels, numClasses, other, iterations, tol);
+  Train(data, labels, numClasses, other, iterations, tol, subsampleRatio);
 }
 
 // Empty constructor.
@@ -68,8 +69,17 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     const size_t numClasses,
     const WeakLearnerType& other,
     const size_t iterations,
-    const double tolerance)
+    const double tolerance,
+    const double subsampleRatio)
 {
+  if (subsampleRatio <= 0.0 || subsampleRatio > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "AdaBoost::Train(): the subsample ratio must be in (0, 1], but "
+        << subsampleRatio << " was given.";
+    throw std::invalid_argument(oss.str());
+  }
+
   // Clear information from previous runs.
   wl.clear();
   alpha.clear();
@@ -78,7 +88,7 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   this->numClasses = numClasses;
 
   // crt is the cumulative rt value for terminating the optimization when rt is
-  // changing by less than the tolerance.
+  // changing by less than the tolerance.  zt is used for weight normalization.
   double rt, crt = 0.0, alphat = 0.0, zt;
 
   ztProduct = 1.0;
@@ -86,13 +96,6 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
@@ -101,48 +104,55 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   // Weights are stored in this row vector.
   arma::rowvec weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
+  // The number of points each weak learner is trained on.
+  const size_t subsampleSize = std::max((size_t) 1,
+      (size_t) std::ceil(subsampleRatio * data.n_cols));
 
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; i++)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
-    // rt = (sum) D(i) y(i) ht(xi)
-    rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = arma::sum(D);
 
-    // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
-
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
+    // Use the existing weak learner to train a new one with new weights, on
+    // all the points or on a random subset of them.  Then classify all of the
+    // points with it.
+    if (subsampleSize < data.n_cols)
+    {
+      const arma::uvec indices = Subsample(data.n_cols, subsampleSize);
+      MatType subsampleData(data.n_rows, subsampleSize);
+      for (size_t j = 0; j < subsampleSize; ++j)
+        subsampleData.col(j) = data.col(indices[j]);
 
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
+      WeakLearnerType w(other, subsampleData, labels.cols(indices), numClasses,
+          weights.cols(indices));
+      wl.push_back(w);
+    }
+    else
     {
-      if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
-      else
-        rt -= arma::accu(D.col(j));
+      WeakLearnerType w(other, data, labels, numClasses, weights);
+      wl.push_back(w);
     }
+    wl.back().Classify(data, predictedLabels);
+
+    // Now, calculate alpha(t) using ht.  Initialized to zero in every round,
+    // rt is used for calculation of alphat; it is the weighted error.
+    // rt = (sum) D(i) y(i) ht(xi)
+    const arma::rowvec correct = arma::conv_to<arma::rowvec>::from(
+        predictedLabels == labels);
+    rt = arma::accu(weights % (2.0 * correct - 1.0));
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
+    {
+      wl.pop_back();
       break;
+    }
 
     // Check if model has converged.
     if (rt >= 1.0)
     {
       // Save the weak learner and terminate.
       alpha.push_back(1.0);
-      wl.push_back(w);
       break;
     }
 
@@ -153,46 +163,20 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
     alphat = 0.5 * log((1 + rt) / (1 - rt));
 
     alpha.push_back(alphat);
-    wl.push_back(w);
 
-    // Now start modifying the weights.
+    // Now start modifying the weights: the weights of the points that were
+    // classified correctly are lowered, and the others are raised.
+    const double expo = exp(alphat);
     for (size_t j = 0; j < D.n_cols; j++)
     {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
+      if (correct[j] == 1.0)
+        D.col(j) /= expo;
       else
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
+        D.col(j) *= expo;
     }
 
-    // Normalize D.
+    // We calculate zt, the normalization constant, and normalize D.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -200,6 +184,21 @@ void AdaBoost<WeakLearnerType, MatType>::Train(
   }
 }
 
+/**
+ * Draw the given number of distinct indices of points, in increasing order.
+ */
+template<typename WeakLearnerType, typename MatType>
+arma::uvec AdaBoost<WeakLearnerType, MatType>::Subsample(const size_t n,
+                                                         const size_t size)
+{
+  // Only the first size steps of a Fisher-Yates shuffle are needed.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, n - 1, n);
+  for (size_t i = 0; i < size; ++i)
+    std::swap(indices[i], indices[math::RandInt(i, n)]);
+
+  return arma::sort(indices.head(size));
+}
+
 /**
  * Classify the given test points.
  */
@@ -208,27 +207,35 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
+  if (test.n_cols == 0)
+  {
+    predictedLabels.set_size(0);
+    return;
+  }
+
   arma::Row<size_t> tempPredictedLabels(test.n_cols);
   arma::mat cMatrix(numClasses, test.n_cols);
 
   cMatrix.zeros();
-  predictedLabels.set_size(test.n_cols);
 
+  // The offset of each column in cMatrix, so that the vote of a weak learner
+  // for each point can be added to the matrix in one operation.
+  const arma::uvec offsets = arma::linspace<arma::uvec>(0,
+      (test.n_cols - 1) * numClasses, test.n_cols);
+
+  // Each weak learner classifies all the points at once.
   for (size_t i = 0; i < wl.size(); i++)
   {
     wl[i].Classify(test, tempPredictedLabels);
-
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
+    cMatrix.elem(offsets + arma::conv_to<arma::uvec>::from(
+        tempPredictedLabels.t())) += alpha[i];
   }
 
-  arma::colvec cMRow;
-  arma::uword maxIndex = 0;
-
+  predictedLabels.set_size(test.n_cols);
   for (size_t i = 0; i < predictedLabels.n_cols; i++)
   {
-    cMRow = cMatrix.unsafe_col(i);
-    cMRow.max(maxIndex);
+    arma::uword maxIndex = 0;
+    cMatrix.unsafe_col(i).max(maxIndex);
     predictedLabels(i) = maxIndex;
   }
 }
@@ -25,6 +25,7 @@
 #include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/init_rules/random_acol_init.hpp>
@@ -183,6 +184,19 @@ using SVDCompleteIncrementalFactorizer = amf::AMF<
     amf::SimpleResidueTermination,
     amf::RandomAcolInitialization<>,
     amf::SVDCompleteIncrementalLearning<MatType>>;
+
+/**
+ * SVDParallelIncrementalFactorizer factorizes given matrix V into two matrices
+ * W and H by complete incremental gradient descent, updating for many elements
+ * of V in parallel.
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+using SVDParallelIncrementalFactorizer = amf::AMF<
+    amf::SimpleResidueTermination,
+    amf::RandomAcolInitialization<>,
+    amf::SVDParallelIncrementalLearning>;
+
 } // namespace amf
 } // namespace mlpack
 
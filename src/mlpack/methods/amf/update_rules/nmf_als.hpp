@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_ALS_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "sparse_products.hpp"
 
 namespace mlpack {
 namespace amf {
@@ -123,6 +124,55 @@ class NMFALSUpdate
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 }; // class NMFALSUpdate
 
+/**
+ * WUpdate function specialization for sparse matrices: V * H^T is computed in
+ * parallel, as the transpose of H * V^T.
+ */
+template<>
+inline void NMFALSUpdate::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                arma::mat& W,
+                                                const arma::mat& H)
+{
+  arma::mat HVt;
+  DenseSparseProduct(H, arma::sp_mat(V.t()), HVt);
+
+  // pinv(H * H.t()) is symmetric, so this is V * H.t() * pinv(H * H.t()).
+  W = trans(pinv(H * H.t()) * HVt);
+
+  // Set all negative numbers to 0.
+  for (size_t i = 0; i < W.n_elem; i++)
+  {
+    if (W(i) < 0.0)
+    {
+      W(i) = 0.0;
+    }
+  }
+}
+
+/**
+ * HUpdate function specialization for sparse matrices: W^T * V is computed in
+ * parallel.
+ */
+template<>
+inline void NMFALSUpdate::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                const arma::mat& W,
+                                                arma::mat& H)
+{
+  arma::mat WtV;
+  DenseSparseProduct(arma::mat(W.t()), V, WtV);
+
+  H = pinv(W.t() * W) * WtV;
+
+  // Set all negative numbers to 0.
+  for (size_t i = 0; i < H.n_elem; i++)
+  {
+    if (H(i) < 0.0)
+    {
+      H(i) = 0.0;
+    }
+  }
+}
+
 } // namespace amf
 } // namespace mlpack
 
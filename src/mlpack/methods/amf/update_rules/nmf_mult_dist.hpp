@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_LMF_UPDATE_RULES_NMF_MULT_DIST_UPDATE_RULES_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "sparse_products.hpp"
 
 namespace mlpack {
 namespace amf {
@@ -101,6 +102,38 @@ class NMFMultiplicativeDistanceUpdate
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
+/**
+ * WUpdate function specialization for sparse matrices: V * H^T is computed in
+ * parallel, as the transpose of H * V^T.
+ */
+template<>
+inline void NMFMultiplicativeDistanceUpdate::WUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    arma::mat& W,
+    const arma::mat& H)
+{
+  arma::mat HVt;
+  DenseSparseProduct(H, arma::sp_mat(V.t()), HVt);
+
+  W = (W % trans(HVt)) / (W * (H * H.t()));
+}
+
+/**
+ * HUpdate function specialization for sparse matrices: W^T * V is computed in
+ * parallel.
+ */
+template<>
+inline void NMFMultiplicativeDistanceUpdate::HUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    const arma::mat& W,
+    arma::mat& H)
+{
+  arma::mat WtV;
+  DenseSparseProduct(arma::mat(W.t()), V, WtV);
+
+  H = (H % WtV) / ((W.t() * W) * H);
+}
+
 } // namespace amf
 } // namespace mlpack
 
@@ -0,0 +1,83 @@
+/**
+ * @file sparse_products.hpp
+ *
+ * Parallel products of sparse data matrices with the factors W and H, used by
+ * the update rules when the matrix to be factorized is sparse.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_SPARSE_PRODUCTS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_SPARSE_PRODUCTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * Compute A * B for a dense matrix A and a sparse matrix B.  Each column of the
+ * product only depends on the same column of B, so the columns are computed in
+ * parallel with OpenMP, walking the compressed representation of B directly.
+ * To compute a product A * V^T, pass the transpose of V (which Armadillo forms
+ * in time linear in the number of nonzero elements).
+ *
+ * @param a Dense matrix.
+ * @param b Sparse matrix.
+ * @param output Matrix to store the product in.
+ */
+template<typename eT>
+void DenseSparseProduct(const arma::Mat<eT>& a,
+                        const arma::SpMat<eT>& b,
+                        arma::Mat<eT>& output)
+{
+  b.sync();
+  output.zeros(a.n_rows, b.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    for (size_t k = b.col_ptrs[j]; k < b.col_ptrs[j + 1]; ++k)
+      output.col(j) += b.values[k] * a.col(b.row_indices[k]);
+  }
+}
+
+/**
+ * Compute the residuals of the factorization W * H at the nonzero elements of
+ * V, in parallel over the columns of V.  The residuals are stored as a sparse
+ * matrix with the nonzero elements of V (except the residuals that are exactly
+ * zero).
+ *
+ * @param v Sparse matrix being factorized.
+ * @param wt Transpose of the basis matrix W, so that its rows are contiguous.
+ * @param h Encoding matrix.
+ * @param residuals Matrix to store the residuals in.
+ */
+template<typename eT>
+void SparseResiduals(const arma::SpMat<eT>& v,
+                     const arma::Mat<eT>& wt,
+                     const arma::Mat<eT>& h,
+                     arma::SpMat<eT>& residuals)
+{
+  v.sync();
+  arma::Col<eT> values(v.n_nonzero);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) v.n_cols; ++j)
+  {
+    for (size_t k = v.col_ptrs[j]; k < v.col_ptrs[j + 1]; ++k)
+      values[k] = v.values[k] - arma::dot(wt.col(v.row_indices[k]), h.col(j));
+  }
+
+  const arma::uvec rowIndices(v.row_indices, v.n_nonzero);
+  const arma::uvec colPointers(v.col_ptrs, v.n_cols + 1);
+  residuals = arma::SpMat<eT>(rowIndices, colPointers, values, v.n_rows,
+      v.n_cols);
+}
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
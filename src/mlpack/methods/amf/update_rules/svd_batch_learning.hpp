@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_AMF_UPDATE_RULES_SVD_BATCH_LEARNING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "sparse_products.hpp"
 
 namespace mlpack {
 namespace amf {
@@ -196,29 +197,24 @@ class SVDBatchLearning
 //!        common row_col_iterator
 
 /**
- * WUpdate function specialization for sparse matrix
+ * WUpdate function specialization for sparse matrix.  The residuals at the
+ * nonzero elements and their product with H are computed in parallel.
  */
 template<>
 inline void SVDBatchLearning::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
                                                     arma::mat& W,
                                                     const arma::mat& H)
 {
-  const size_t n = V.n_rows;
-  const size_t r = W.n_cols;
-
   mW = momentum * mW;
 
-  arma::mat deltaW;
-  deltaW.zeros(n, r);
+  arma::sp_mat residuals;
+  SparseResiduals(V, arma::mat(W.t()), H, residuals);
 
-  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
-  {
-    const size_t row = it.row();
-    const size_t col = it.col();
-    deltaW.row(it.row()) += (*it - arma::dot(W.row(row), H.col(col))) *
-                                             arma::trans(H.col(col));
-  }
+  // The step is residuals * H^T, the transpose of H * residuals^T.
+  arma::mat deltaWt;
+  DenseSparseProduct(H, arma::sp_mat(residuals.t()), deltaWt);
 
+  arma::mat deltaW = trans(deltaWt);
   if (kw != 0)
     deltaW -= kw * W;
 
@@ -226,26 +222,23 @@ inline void SVDBatchLearning::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
   W += mW;
 }
 
+/**
+ * HUpdate function specialization for sparse matrix.  The residuals at the
+ * nonzero elements and their product with W^T are computed in parallel.
+ */
 template<>
 inline void SVDBatchLearning::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
                                                     const arma::mat& W,
                                                     arma::mat& H)
 {
-  const size_t m = V.n_cols;
-  const size_t r = W.n_cols;
-
   mH = momentum * mH;
 
-  arma::mat deltaH;
-  deltaH.zeros(r, m);
+  const arma::mat Wt = W.t();
+  arma::sp_mat residuals;
+  SparseResiduals(V, Wt, H, residuals);
 
-  for (arma::sp_mat::const_iterator it = V.begin(); it != V.end(); ++it)
-  {
-    const size_t row = it.row();
-    const size_t col = it.col();
-    deltaH.col(col) += (*it - arma::dot(W.row(row), H.col(col))) *
-        W.row(row).t();
-  }
+  arma::mat deltaH;
+  DenseSparseProduct(Wt, residuals, deltaH);
 
   if (kh != 0)
     deltaH -= kh * H;
@@ -162,42 +162,42 @@ class SVDIncompleteIncrementalLearning
 //!        common row_col_iterator
 
 //! template specialiazed functions for sparse matrices
+
+/**
+ * WUpdate function specialization for sparse matrices.  Only the rows of the
+ * items rated by the current user change, and the step of each only depends on
+ * the row itself, so they are updated in place; the cost is linear in the
+ * number of ratings of the user, not in the number of items.
+ */
 template<>
 inline void SVDIncompleteIncrementalLearning::WUpdate<arma::sp_mat>(
     const arma::sp_mat& V, arma::mat& W, const arma::mat& H)
 {
-  arma::mat deltaW(V.n_rows, W.n_cols);
-  deltaW.zeros();
   for (arma::sp_mat::const_iterator it = V.begin_col(currentUserIndex);
       it != V.end_col(currentUserIndex); ++it)
   {
-    double val = *it;
-    size_t i = it.row();
-    deltaW.row(i) += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
-        arma::trans(H.col(currentUserIndex));
-    if (kw != 0) deltaW.row(i) -= kw * W.row(i);
-  }
+    const size_t i = it.row();
+    arma::rowvec deltaW = (*it - arma::dot(W.row(i),
+        H.col(currentUserIndex))) * arma::trans(H.col(currentUserIndex));
+    if (kw != 0) deltaW -= kw * W.row(i);
 
-  W += u*deltaW;
+    W.row(i) += u * deltaW;
+  }
 }
 
 template<>
 inline void SVDIncompleteIncrementalLearning::HUpdate<arma::sp_mat>(
     const arma::sp_mat& V, const arma::mat& W, arma::mat& H)
 {
-  arma::mat deltaH(H.n_rows, 1);
-  deltaH.zeros();
+  arma::vec deltaH;
+  deltaH.zeros(H.n_rows);
 
   for (arma::sp_mat::const_iterator it = V.begin_col(currentUserIndex);
       it != V.end_col(currentUserIndex); ++it)
   {
-    double val = *it;
-    size_t i = it.row();
-    if ((val = V(i, currentUserIndex)) != 0)
-    {
-      deltaH += (val - arma::dot(W.row(i), H.col(currentUserIndex))) *
-          arma::trans(W.row(i));
-    }
+    const size_t i = it.row();
+    deltaH += (*it - arma::dot(W.row(i), H.col(currentUserIndex))) *
+        arma::trans(W.row(i));
   }
   if (kh != 0) deltaH -= kh * H.col(currentUserIndex);
 
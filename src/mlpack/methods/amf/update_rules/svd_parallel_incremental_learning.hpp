@@ -0,0 +1,186 @@
+/**
+ * @file svd_parallel_incremental_learning.hpp
+ *
+ * SVD factorizer used in AMF (Alternating Matrix Factorization), which runs
+ * complete incremental learning in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class computes SVD with complete incremental learning (stochastic
+ * gradient descent over the individual nonzero elements of V, as in
+ * SVDCompleteIncrementalLearning), but runs the updates of many elements at
+ * once, without locking, in the style of Hogwild!:
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title={Hogwild!: A Lock-Free Approach to Parallelizing Stochastic Gradient
+ *       Descent},
+ *   author={Recht, B. and Re, C. and Wright, S. and Niu, F.},
+ *   booktitle={Advances in Neural Information Processing Systems 24
+ *       (NIPS 2011)},
+ *   pages={693--701},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * Each call to WUpdate() is one pass over all the nonzero elements of V.  The
+ * users (the columns of V) are split among the OpenMP threads, so each column
+ * of H is only changed by one thread; the rows of W are shared, and the threads
+ * may overwrite each other's updates of a row.  Since every element only
+ * touches one row of W, this happens rarely for sparse data and doesn't keep
+ * the factorization from converging.  HUpdate() does nothing, since H is
+ * updated along with W.
+ *
+ * Because each update is a full pass, this rule is used with the usual
+ * termination policies (like SimpleResidueTermination), not with
+ * CompleteIncrementalTermination.  With a single thread, it does the same
+ * updates as SVDCompleteIncrementalLearning.
+ *
+ * @see SVDCompleteIncrementalLearning
+ */
+class SVDParallelIncrementalLearning
+{
+ public:
+  /**
+   * Initialize the parameters of SVDParallelIncrementalLearning.
+   *
+   * @param u Step value used in incremental learning.
+   * @param kw Regularization constant for W matrix.
+   * @param kh Regularization constant for H matrix.
+   */
+  SVDParallelIncrementalLearning(double u = 0.001,
+                                 double kw = 0,
+                                 double kh = 0) :
+      u(u), kw(kw), kh(kh)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Initialize parameters before factorization.  There is nothing to
+   * initialize, so the input matrix and rank are not used.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank rank of factorization
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Run one pass of incremental learning over all the nonzero elements of V,
+   * updating both W and H.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      arma::mat& H)
+  {
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+    {
+      for (size_t i = 0; i < V.n_rows; ++i)
+      {
+        const double val = V(i, j);
+        if (val != 0)
+          Update(val, i, j, W, H);
+      }
+    }
+  }
+
+  /**
+   * The update of H is done by WUpdate(), so this does nothing.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& /* W */,
+                      arma::mat& /* H */)
+  {
+    // Nothing to do.
+  }
+
+  //! Serialize the SVDParallelIncrementalLearning object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(u);
+    ar & BOOST_SERIALIZATION_NVP(kw);
+    ar & BOOST_SERIALIZATION_NVP(kh);
+  }
+
+ private:
+  //! Update row i of W and column j of H for the element V(i, j) = val, as
+  //! SVDCompleteIncrementalLearning does.
+  inline void Update(const double val,
+                     const size_t i,
+                     const size_t j,
+                     arma::mat& W,
+                     arma::mat& H) const
+  {
+    arma::rowvec deltaW = (val - arma::dot(W.row(i), H.col(j))) *
+        arma::trans(H.col(j));
+    if (kw != 0)
+      deltaW -= kw * W.row(i);
+    W.row(i) += u * deltaW;
+
+    arma::vec deltaH = (val - arma::dot(W.row(i), H.col(j))) *
+        arma::trans(W.row(i));
+    if (kh != 0)
+      deltaH -= kh * H.col(j);
+    H.col(j) += u * deltaH;
+  }
+
+  //! Step size of the algorithm.
+  double u;
+  //! Regularization parameter for matrix W.
+  double kw;
+  //! Regularization parameter for matrix H.
+  double kh;
+}; // class SVDParallelIncrementalLearning
+
+/**
+ * WUpdate function specialization for sparse matrices, which visits only the
+ * nonzero elements of each column.
+ */
+template<>
+inline void SVDParallelIncrementalLearning::WUpdate<arma::sp_mat>(
+    const arma::sp_mat& V,
+    arma::mat& W,
+    arma::mat& H)
+{
+  V.sync();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) V.n_cols; ++j)
+  {
+    for (size_t k = V.col_ptrs[j]; k < V.col_ptrs[j + 1]; ++k)
+      Update(V.values[k], V.row_indices[k], j, W, H);
+  }
+}
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,299 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through im2col and matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by unrolling every patch of the
+ * input that the filter is applied to into a row of a matrix (im2col), so that
+ * the convolution becomes a single matrix multiplication.  When an input is
+ * convolved with several filters at once (the overload with a dense matrix as
+ * input and a 3rd order tensor as filter), the patches are extracted only once
+ * and all filters are applied by the same matrix multiplication, so the work
+ * is done by BLAS.  The results are the same as the ones of NaiveConvolution.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution with a dense matrix as input, filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Mat<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> patches;
+    size_t outputRows, outputCols;
+    Patches(input, filter.n_rows, filter.n_cols, patches, outputRows,
+        outputCols, dW, dH, dilationW, dilationH);
+
+    output.set_size(outputRows, outputCols);
+    arma::Col<eT> outputVec(output.memptr(), output.n_elem, false, true);
+    outputVec = patches * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.  The patches of the input are extracted once, and
+   * all the filters are applied with a single matrix multiplication.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> patches;
+    size_t outputRows, outputCols;
+    Patches(input, filter.n_rows, filter.n_cols, patches, outputRows,
+        outputCols, dW, dH, dilationW, dilationH);
+
+    // Each slice of the filter is a column of this matrix, and each slice of
+    // the output is a column of the product.
+    const arma::Mat<eT> filters(const_cast<eT*>(filter.memptr()),
+        filter.n_rows * filter.n_cols, filter.n_slices, false, true);
+
+    output.set_size(outputRows, outputCols, filter.n_slices);
+    arma::Mat<eT> outputMat(output.memptr(), outputRows * outputCols,
+        filter.n_slices, false, true);
+    outputMat = patches * filters;
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          convOutput, dW, dH, dilationW, dilationH);
+      output.slice(i) = convOutput;
+    }
+  }
+
+ private:
+  /*
+   * Extract the patches of the input (valid mode) into the rows of the given
+   * matrix.  Row i + j * outputRows holds the patch for the output element
+   * (i, j), in the same column-major order as the elements of the filter.  The
+   * patches are indexed exactly as in NaiveConvolution.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param patches Matrix to store the patches into.
+   * @param outputRows Set to the number of rows of the output.
+   * @param outputCols Set to the number of columns of the output.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Patches(const arma::Mat<eT>& input,
+          const size_t filterRows,
+          const size_t filterCols,
+          arma::Mat<eT>& patches,
+          size_t& outputRows,
+          size_t& outputCols,
+          const size_t dW,
+          const size_t dH,
+          const size_t dilationW,
+          const size_t dilationH)
+  {
+    outputRows = (input.n_rows - (filterRows - 1) * dilationW - 1) / dW + 1;
+    outputCols = (input.n_cols - (filterCols - 1) * dilationH - 1) / dH + 1;
+
+    patches.set_size(outputRows * outputCols, filterRows * filterCols);
+
+    // Each column of the patches matrix corresponds to one filter element, so
+    // it can be filled contiguously.
+    for (size_t kj = 0; kj < filterCols; ++kj)
+    {
+      for (size_t ki = 0; ki < filterRows; ++ki)
+      {
+        eT* patchPtr = patches.colptr(ki + kj * filterRows);
+        for (size_t j = 0; j < outputCols; ++j)
+        {
+          const eT* inputPtr = input.colptr(kj * dilationW + j * dW) +
+              ki * dilationH;
+          for (size_t i = 0; i < outputRows; ++i, ++patchPtr)
+            *patchPtr = inputPtr[i * dH];
+        }
+      }
+    }
+  }
+
+  /*
+   * Extract the patches of the input (full mode).  The input is padded to the
+   * working output shape as in NaiveConvolution, and the patches of the padded
+   * input are extracted with unit stride.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Patches(const arma::Mat<eT>& input,
+          const size_t filterRows,
+          const size_t filterCols,
+          arma::Mat<eT>& patches,
+          size_t& outputRows,
+          size_t& outputCols,
+          const size_t dW,
+          const size_t dH,
+          const size_t dilationW,
+          const size_t dilationH)
+  {
+    size_t paddedRows = (input.n_rows - 1) * dW + 2 * (filterRows - 1)
+        * dilationW + 1;
+    size_t paddedCols = (input.n_cols - 1) * dH + 2 * (filterCols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + paddedRows - 2 * (filterRows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        paddedRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + paddedCols - 2 * (filterCols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        paddedCols += i;
+        break;
+      }
+    }
+
+    // Pad the input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(paddedRows,
+        paddedCols);
+    inputPadded.submat((filterRows - 1) * dilationW, (filterCols - 1)
+        * dilationH, (filterRows - 1) * dilationW + input.n_rows - 1,
+        (filterCols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Patches(inputPadded, filterRows,
+        filterCols, patches, outputRows, outputCols, 1, 1, dilationW,
+        dilationH);
+  }
+
+  // The full mode uses the valid mode patches.
+  template<typename OtherBorderMode>
+  friend class Im2ColConvolution;
+};  // class Im2ColConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
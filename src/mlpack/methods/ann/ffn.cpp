@@ -0,0 +1,23 @@
+/**
+ * @file ffn.cpp
+ *
+ * Force instantiation of the default FFN, and of its training with the default
+ * optimizer, to reduce compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ffn.hpp"
+
+namespace mlpack {
+namespace ann {
+
+template class FFN<NegativeLogLikelihood<>, RandomInitialization>;
+
+template void FFN<NegativeLogLikelihood<>, RandomInitialization>::
+    Train<ens::RMSProp>(arma::mat, arma::mat);
+
+} // namespace ann
+} // namespace mlpack
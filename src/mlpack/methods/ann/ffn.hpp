@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_FFN_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/batch_loader.hpp>
 
 #include "visitor/delete_visitor.hpp"
 #include "visitor/delta_visitor.hpp"
@@ -26,6 +27,8 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "layer_profiler.hpp"
+#include "memory_planner.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -35,6 +38,43 @@
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
+/**
+ * The buffers used by FFN::Predict() for inference-only prediction.  The
+ * workspace holds one activation buffer per layer, sized for batches of up to
+ * MaxBatchSize() points, so after the first call no memory is allocated while
+ * predicting.  Each thread that predicts with a shared network needs its own
+ * workspace.  A workspace must only be used with one network.
+ */
+class FFNWorkspace
+{
+ public:
+  /**
+   * Create the workspace.
+   *
+   * @param maxBatchSize Number of points that are passed through the network
+   *     at once.
+   */
+  FFNWorkspace(const size_t maxBatchSize = 32) :
+      maxBatchSize(std::max(maxBatchSize, (size_t) 1)) { }
+
+  //! Get the number of points passed through the network at once.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+
+ private:
+  template<typename OutputLayerType,
+           typename InitializationRuleType,
+           typename... CustomLayers>
+  friend class FFN;
+
+  //! The number of points passed through the network at once.
+  size_t maxBatchSize;
+  //! The output buffer of each layer.
+  std::vector<arma::mat> activations;
+  //! The input and the outputs of each layer for the current batch, as aliases
+  //! of the predictors, of the activations, and of the results.
+  std::vector<arma::mat> views;
+};
+
 /**
  * Implementation of a standard feed forward network.
  *
@@ -122,6 +162,30 @@ class FFN
   template<typename OptimizerType = ens::RMSProp>
   void Train(arma::mat predictors, arma::mat responses);
 
+  /**
+   * Train the feedforward network on a dataset streamed from disk by the given
+   * loader, for the given number of epochs.  Each batch of the loader is
+   * trained on with one call to the optimizer, while the loader reads the next
+   * batch in the background, so only about two batches are held in memory.
+   * The batches of the loader should be much larger than the mini-batches of
+   * the optimizer, and the optimizer should be set to take one pass over each
+   * batch (for instance, with its maximum number of iterations set to the
+   * batch size of the loader) and, where the optimizer supports it, not to
+   * reset its state between calls.
+   *
+   * The first epoch starts from the current position of the loader; the other
+   * epochs rewind it, which also shuffles the points again.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param loader Loader of the batches of points and responses.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param epochs Number of passes over the dataset.
+   */
+  template<typename OptimizerType>
+  void Train(data::BatchLoader& loader,
+             OptimizerType& optimizer,
+             const size_t epochs = 1);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -135,6 +199,37 @@ class FFN
    */
   void Predict(arma::mat predictors, arma::mat& results);
 
+  /**
+   * Prepare the network for inference-only prediction with a workspace: the
+   * parameters are initialized if necessary and the network is set to
+   * deterministic (testing) mode.  This must be called again if the network is
+   * trained or modified afterwards.
+   */
+  void Freeze();
+
+  /**
+   * Predict the responses to the given predictors, using the given workspace
+   * for all the intermediate activations.  The predictors are not copied: the
+   * network is evaluated on batches of workspace.MaxBatchSize() points that
+   * refer to the predictors directly, every layer writes into its buffer in
+   * the workspace, and the last layer writes into the results.  Once the
+   * workspace has been used, no memory is allocated (as long as the results
+   * already have the right size).  Freeze() must be called first.
+   *
+   * The network itself is not modified, so with one workspace per thread this
+   * can be called from several threads at once on a shared network, as long as
+   * none of its layers change their own state in Forward() during testing.
+   * This is true for Linear, LinearNoBias, the activation layers and Dropout,
+   * for instance, but not for the convolution or the recurrent layers.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Buffers for the activations of this thread.
+   */
+  void Predict(const arma::mat& predictors,
+               arma::mat& results,
+               FFNWorkspace& workspace) const;
+
   /**
    * Evaluate the feedforward network with the given ppredictors and responses.
    * This functions is usually used to monitor progress while training.
@@ -236,7 +331,8 @@ class FFN
 
   /**
    * Shuffle the order of function visitation. This may be called by the
-   * optimizer.
+   * optimizer.  The points are permuted in place, so no copy of the dataset is
+   * made.
    */
   void Shuffle();
 
@@ -263,6 +359,15 @@ class FFN
   //! Modify the initial point for the optimization.
   arma::mat& Parameters() { return parameter; }
 
+  //! Get the layers of the network.
+  const std::vector<LayerTypes<CustomLayers...> >& Model() const
+  {
+    return network;
+  }
+  //! Modify the layers of the network.  The parameters have to be reset after
+  //! layers are added or removed.
+  std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
+
   //! Get the matrix of responses to the input data points.
   const arma::mat& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
@@ -273,11 +378,108 @@ class FFN
   //! Modify the matrix of data points (predictors).
   arma::mat& Predictors() { return predictors; }
 
+  /**
+   * Get the number of worker replicas that each mini-batch of
+   * EvaluateWithGradient() is split across.  With more than one worker, each
+   * worker evaluates its shard of the mini-batch with its own copy of the
+   * layers (the replicas share the parameters of this network, but have their
+   * own activations and gradients), and the gradients of the workers are
+   * summed.  The output layer is evaluated on the whole mini-batch, so the
+   * objective and the gradient are the same as with one worker, except for
+   * layers that couple the points of a batch (such as BatchNorm), which only
+   * see the points of their shard.  The default is 1 (no replicas).
+   */
+  size_t Workers() const { return workers; }
+  //! Modify the number of worker replicas used by EvaluateWithGradient().
+  size_t& Workers() { return workers; }
+
+  /**
+   * Get whether the outputs and deltas of the layers are planned.  If true, the
+   * serial EvaluateWithGradient(), Evaluate(), and the Forward() / Backward()
+   * pair give the outputs and deltas of the layers memory in a shared arena,
+   * instead of letting each layer own its buffers: the lifetimes of the
+   * buffers over the pass are found by a NetworkMemoryPlan, and buffers that
+   * are never live at the same time share memory.  In a training pass the
+   * backward step and the gradient of each layer are computed one after the
+   * other, so only two deltas are live at once; in an inference pass, only two
+   * outputs are.  The plans are made from the sizes of the buffers in the
+   * previous pass, so the first pass is never planned.  If a layer gives its
+   * output or delta another size than planned, that buffer gets its own memory
+   * and the plan is made again.  The default is false.
+   */
+  bool PlanMemory() const { return planMemory; }
+  //! Modify whether the outputs and deltas of the layers are planned.
+  bool& PlanMemory() { return planMemory; }
+
+  /**
+   * Get the interval between the outputs that are kept during planned training
+   * passes.  With an interval k > 0, only the output of every k-th layer is
+   * kept until the backward steps; the outputs of the other layers are
+   * computed again from the last kept output just before they are needed.
+   * This trades about one more forward pass for the memory of most outputs,
+   * so it is best suited to deep networks.  Since the Forward() of the
+   * recomputed layers is called twice, layers that are random or update their
+   * state in training mode (such as Dropout or BatchNorm) must not be used
+   * with checkpointing.  The default is 0 (all outputs are kept).
+   */
+  size_t CheckpointInterval() const { return checkpointInterval; }
+  //! Modify the interval between the outputs that are kept during planned
+  //! training passes.
+  size_t& CheckpointInterval() { return checkpointInterval; }
+
+  /**
+   * Get whether the passes through each layer are profiled.  If true, the
+   * Forward(), Backward() and Gradient() calls of each layer are timed with
+   * the Timer subsystem, the floating point operations and bytes of the
+   * Linear and Convolution layers are counted, and Train() and Predict() log
+   * a table of the totals of each layer to Log::Info (see LayerProfiler; the
+   * timers are named "ffn_layer_<i>_forward" and so on).  Timing must be
+   * enabled (see Timer::EnableTiming()).  The default is false.
+   */
+  bool Profile() const { return profiler.Enabled(); }
+  //! Modify whether the passes through each layer are profiled.
+  bool& Profile() { return profiler.Enabled(); }
+
+  /**
+   * Write the table of the time and cost of each layer, accumulated since
+   * profiling was enabled (or since the timers were reset), to the given
+   * stream.
+   *
+   * @param stream Stream to write the table to.
+   */
+  void ProfileReport(std::ostream& stream) const
+  {
+    profiler.Report(network, stream);
+  }
+
+  //! Get the plan of the buffers of the training passes.
+  const NetworkMemoryPlan& TrainingPlan() const { return trainingPlan; }
+  //! Get the plan of the buffers of the inference passes.
+  const NetworkMemoryPlan& InferencePlan() const { return inferencePlan; }
+
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Optimize the network for inference, keeping its deterministic output.  A
+   * BatchNorm layer that directly follows a Linear layer is folded into the
+   * weights and bias of the Linear layer, using the statistics of the
+   * training data; then a ReLULayer, SigmoidLayer, TanHLayer or LeakyReLU
+   * (with a non-negative slope) that directly follows a Linear layer is fused
+   * into it (see Linear::FuseActivation()), so that the bias and the
+   * activation are applied in a single pass over the output of the matrix
+   * product.  The removed layers are deleted, and the parameters are compacted.
+   *
+   * Fused activations can still be trained, but folded BatchNorm layers are
+   * gone, so the network should not be trained further unless its behaviour
+   * without them is desired.
+   *
+   * @return The number of layers removed from the network.
+   */
+  size_t FuseLayers();
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -365,6 +567,88 @@ class FFN
    */
   void ResetGradients(arma::mat& gradient);
 
+  /**
+   * Evaluate the objective and the gradient of the given mini-batch by
+   * splitting it across the worker replicas.
+   *
+   * @param begin Index of the first point of the mini-batch.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points in the mini-batch.
+   */
+  template<typename GradType>
+  double ParallelEvaluateWithGradient(const size_t begin,
+                                      GradType& gradient,
+                                      const size_t batchSize);
+
+  /**
+   * Build the worker replicas, if they don't match the current workers,
+   * layers or parameters.  The replicas are copies of the layers whose weights
+   * refer to the parameters of this network.
+   */
+  void ResetReplicas();
+
+  //! Delete the worker replicas.
+  void DeleteReplicas();
+
+  /**
+   * Make sure the given plan matches the network, making it again if needed,
+   * and return whether planned passes can be used.
+   *
+   * @param plan The plan to check.
+   * @param training Whether the plan is for training passes.
+   */
+  bool ReadyPlan(NetworkMemoryPlan& plan, const bool training);
+
+  /**
+   * Run the forward phase of a planned pass on the given input; the outputs of
+   * the layers refer to the arena afterwards.
+   *
+   * @param input The input of the first layer.
+   * @param training Whether to use the plan of the training passes.
+   */
+  void PlannedForward(arma::mat& input, const bool training);
+
+  /**
+   * Run the backward phase of the planned training pass that PlannedForward()
+   * started, computing the deltas and the gradients of the layers.  The error
+   * of the output layer has to be computed before.
+   *
+   * @param input The input of the first layer.
+   */
+  void PlannedBackward(arma::mat& input);
+
+  /**
+   * Run the steps [begin, end) of the given plan.
+   *
+   * @param input The input of the first layer.
+   * @param plan The plan to run.
+   * @param begin The first step to run.
+   * @param end One past the last step to run.
+   */
+  void PlannedSteps(arma::mat& input,
+                    const NetworkMemoryPlan& plan,
+                    const size_t begin,
+                    const size_t end);
+
+  //! Make the given matrix refer to the memory of the given buffer.
+  void BindBuffer(const MemoryPlanner& planner,
+                  const size_t buffer,
+                  arma::mat& matrix);
+
+  //! Note whether the given matrix no longer refers to the memory of the given
+  //! buffer, because the layer gave it another size.
+  void CheckBuffer(const MemoryPlanner& planner,
+                   const size_t buffer,
+                   const arma::mat& matrix);
+
+  //! Give the outputs and deltas that refer to the arena their own memory
+  //! again, before an unplanned pass.
+  void ReleaseBuffers();
+
+  //! Log the table of the time and cost of each layer, if the layers are
+  //! profiled.
+  void LogProfile() const;
+
   /**
    * Swap the content of this network with given network.
    *
@@ -451,6 +735,46 @@ class FFN
   //! Locally-stored copy visitor
   CopyVisitor<CustomLayers...> copyVisitor;
 
+  //! The number of worker replicas used by EvaluateWithGradient().
+  size_t workers;
+
+  //! The worker replicas, which share the parameters of this network.
+  std::vector<FFN*> replicas;
+
+  //! The gradients computed by the worker replicas.
+  std::vector<arma::mat> replicaGradients;
+
+  //! The memory of the parameters the replicas refer to.
+  const double* replicaParameter;
+
+  //! Whether the outputs and deltas of the layers are planned.
+  bool planMemory;
+
+  //! The interval between the outputs kept during planned training passes.
+  size_t checkpointInterval;
+
+  //! The plan of the buffers of the training passes.
+  NetworkMemoryPlan trainingPlan;
+
+  //! The plan of the buffers of the inference passes.
+  NetworkMemoryPlan inferencePlan;
+
+  //! The memory of the planned buffers.
+  std::vector<double> arena;
+
+  //! The number of points of the last planned pass, or 0 if no buffer refers
+  //! to the arena.
+  size_t plannedBatchSize;
+
+  //! Whether the last planned pass is a training pass.
+  bool plannedTraining;
+
+  //! Whether a buffer of the current planned pass did not match the plan.
+  bool planMismatch;
+
+  //! The profiler of the passes through each layer.
+  LayerProfiler profiler;
+
   // The GAN class should have access to internal members.
   template<
     typename Model,
@@ -484,4 +808,28 @@ struct version<
 // Include implementation.
 #include "ffn_impl.hpp"
 
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.  The default FFN (with any of the layers of LayerTypes), and its
+ * training with the default optimizer, are compiled once in the mlpack library
+ * (see ffn.cpp), instead of in each program that uses them.
+ *
+ * @cond
+ */
+
+namespace mlpack {
+namespace ann {
+
+extern template class FFN<NegativeLogLikelihood<>, RandomInitialization>;
+
+extern template void FFN<NegativeLogLikelihood<>, RandomInitialization>::
+    Train<ens::RMSProp>(arma::mat, arma::mat);
+
+} // namespace ann
+} // namespace mlpack
+
+/**
+ * @endcond
+ */
+
 #endif
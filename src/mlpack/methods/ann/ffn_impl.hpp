@@ -39,7 +39,15 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    workers(1),
+    replicaParameter(NULL),
+    planMemory(false),
+    checkpointInterval(0),
+    plannedBatchSize(0),
+    plannedTraining(false),
+    planMismatch(false),
+    profiler("ffn")
 {
   /* Nothing to do here */
 }
@@ -48,6 +56,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
+  DeleteReplicas();
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -84,6 +93,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
+  LogProfile();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -103,6 +113,40 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
       << "." << std::endl;
+  LogProfile();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    data::BatchLoader& loader,
+    OptimizerType& optimizer,
+    const size_t epochs)
+{
+  arma::mat batchPredictors, batchResponses;
+  double out = 0.0;
+  size_t batches = 0;
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    if (epoch > 0)
+      loader.Rewind();
+
+    while (loader.Next(batchPredictors, batchResponses))
+    {
+      ResetData(std::move(batchPredictors), std::move(batchResponses));
+      out = optimizer.Optimize(*this, parameter);
+      ++batches;
+    }
+  }
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::Train(): final objective of trained model is " << out
+      << " (after " << batches << " batches)." << std::endl;
+  LogProfile();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -120,7 +164,10 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
   }
 
   currentInput = std::move(inputs);
-  Forward(std::move(currentInput));
+  if (currentInput.n_cols > 0 && ReadyPlan(trainingPlan, true))
+    PlannedForward(currentInput, true);
+  else
+    Forward(std::move(currentInput));
   results = boost::apply_visitor(outputParameterVisitor, network.back());
 }
 
@@ -129,6 +176,8 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
     arma::mat inputs, arma::mat& results, const size_t begin, const size_t end)
 {
+  ReleaseBuffers();
+
   boost::apply_visitor(ForwardVisitor(std::move(inputs), std::move(
       boost::apply_visitor(outputParameterVisitor, network[begin]))),
       network[begin]);
@@ -162,9 +211,18 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 
   gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
 
-  Backward();
-  ResetGradients(gradients);
-  Gradient(std::move(currentInput));
+  if (plannedBatchSize != 0 && plannedTraining &&
+      trainingPlan.Layers() == network.size())
+  {
+    ResetGradients(gradients);
+    PlannedBackward(currentInput);
+  }
+  else
+  {
+    Backward();
+    ResetGradients(gradients);
+    Gradient(std::move(currentInput));
+  }
 
   return res;
 }
@@ -201,6 +259,99 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
         network.back());
     results.col(i) = resultsTemp.col(0);
   }
+
+  LogProfile();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Freeze()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  deterministic = true;
+  ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
+    const arma::mat& predictors,
+    arma::mat& results,
+    FFNWorkspace& workspace) const
+{
+  if (parameter.is_empty() || !deterministic)
+  {
+    Log::Fatal << "FFN::Predict(): Freeze() must be called before predicting "
+        << "with a workspace!" << std::endl;
+  }
+
+  if (network.empty() || predictors.n_cols == 0)
+  {
+    results.set_size(workspace.activations.empty() ? 0 :
+        workspace.activations.back().n_rows, 0);
+    return;
+  }
+
+  // The layers don't modify their input, so the predictors can be used
+  // directly.
+  double* predictorsMem = const_cast<double*>(predictors.memptr());
+
+  // The first time the workspace is used, take a pass with a single point to
+  // find the size of each activation, and then allocate the buffers.
+  if (workspace.activations.size() != network.size())
+  {
+    workspace.activations.clear();
+    workspace.activations.resize(network.size());
+
+    arma::mat input(predictorsMem, predictors.n_rows, 1, false, true);
+    boost::apply_visitor(ForwardVisitor(std::move(input),
+        std::move(workspace.activations[0])), network[0]);
+    for (size_t i = 1; i < network.size(); ++i)
+    {
+      boost::apply_visitor(ForwardVisitor(
+          std::move(workspace.activations[i - 1]),
+          std::move(workspace.activations[i])), network[i]);
+    }
+
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      workspace.activations[i].set_size(workspace.activations[i].n_rows,
+          workspace.maxBatchSize);
+    }
+
+    // The views must never be reallocated, since they refer to other memory.
+    workspace.views.reserve(network.size() + 1);
+  }
+
+  results.set_size(workspace.activations.back().n_rows, predictors.n_cols);
+
+  for (size_t begin = 0; begin < predictors.n_cols;
+      begin += workspace.maxBatchSize)
+  {
+    const size_t batchSize = std::min(workspace.maxBatchSize,
+        (size_t) predictors.n_cols - begin);
+
+    // Each layer reads the output of the previous layer and writes into its own
+    // buffer; the last one writes straight into the results.
+    workspace.views.clear();
+    workspace.views.emplace_back(predictorsMem + begin * predictors.n_rows,
+        predictors.n_rows, batchSize, false, true);
+    for (size_t i = 0; i + 1 < network.size(); ++i)
+    {
+      workspace.views.emplace_back(workspace.activations[i].memptr(),
+          workspace.activations[i].n_rows, batchSize, false, true);
+    }
+    workspace.views.emplace_back(results.colptr(begin), results.n_rows,
+        batchSize, false, true);
+
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      boost::apply_visitor(ForwardVisitor(std::move(workspace.views[i]),
+          std::move(workspace.views[i + 1])), network[i]);
+    }
+  }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -217,7 +368,10 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors));
+  if (predictors.n_cols > 0 && ReadyPlan(inferencePlan, false))
+    PlannedForward(predictors, false);
+  else
+    Forward(std::move(predictors));
 
   double res = outputLayer.Forward(std::move(boost::apply_visitor(
       outputParameterVisitor, network.back())), std::move(responses));
@@ -259,7 +413,17 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  if (batchSize > 0 && ReadyPlan(inferencePlan, false))
+  {
+    arma::mat input(predictors.colptr(begin), predictors.n_rows, batchSize,
+        false, true);
+    PlannedForward(input, false);
+  }
+  else
+  {
+    Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  }
+
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
       std::move(responses.cols(begin, begin + batchSize - 1)));
@@ -320,7 +484,18 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  if (workers > 1 && batchSize > 1)
+    return ParallelEvaluateWithGradient(begin, gradient, batchSize);
+
+  // A planned pass reads the predictors in place.
+  arma::mat input(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true);
+  const bool planned = (batchSize > 0 && ReadyPlan(trainingPlan, true));
+  if (planned)
+    PlannedForward(input, true);
+  else
+    Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
       std::move(responses.cols(begin, begin + batchSize - 1)));
@@ -335,13 +510,159 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       std::move(responses.cols(begin, begin + batchSize - 1)),
       std::move(error));
 
-  Backward();
-  ResetGradients(gradient);
-  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  if (planned)
+  {
+    ResetGradients(gradient);
+    PlannedBackward(input);
+  }
+  else
+  {
+    Backward();
+    ResetGradients(gradient);
+    Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  }
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename GradType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ParallelEvaluateWithGradient(const size_t begin,
+                             GradType& gradient,
+                             const size_t batchSize)
+{
+  ResetReplicas();
+
+  // Split the mini-batch into (almost) equally sized shards.
+  const size_t shards = std::min(workers, batchSize);
+  arma::uvec shardBegin(shards + 1);
+  for (size_t w = 0; w <= shards; ++w)
+    shardBegin[w] = begin + (w * batchSize) / shards;
+
+  // Every replica passes its shard forward through the network.
+  #pragma omp parallel for
+  for (omp_size_t w = 0; w < (omp_size_t) shards; ++w)
+  {
+    FFN& replica = *replicas[w];
+    if (replica.deterministic)
+    {
+      replica.deterministic = false;
+      replica.ResetDeterministic();
+    }
+
+    replica.currentInput = predictors.cols(shardBegin[w],
+        shardBegin[w + 1] - 1);
+    replica.Forward(std::move(replica.currentInput));
+  }
+
+  // The output layer is evaluated on the whole mini-batch, so that losses that
+  // are averaged over the points of the batch are the same as in the serial
+  // evaluation.
+  arma::mat output(boost::apply_visitor(outputParameterVisitor,
+      replicas[0]->network.back()).n_rows, batchSize);
+  double res = 0;
+  for (size_t w = 0; w < shards; ++w)
+  {
+    output.cols(shardBegin[w] - begin, shardBegin[w + 1] - begin - 1) =
+        boost::apply_visitor(outputParameterVisitor,
+        replicas[w]->network.back());
+
+    for (size_t i = 0; i < network.size(); ++i)
+      res += boost::apply_visitor(lossVisitor, replicas[w]->network[i]);
+  }
+
+  res += outputLayer.Forward(std::move(output),
+      std::move(responses.cols(begin, begin + batchSize - 1)));
+  outputLayer.Backward(std::move(output),
+      std::move(responses.cols(begin, begin + batchSize - 1)),
+      std::move(error));
+
+  // Every replica passes its part of the error backward and computes the
+  // gradient of its shard.
+  #pragma omp parallel for
+  for (omp_size_t w = 0; w < (omp_size_t) shards; ++w)
+  {
+    FFN& replica = *replicas[w];
+    replica.error = error.cols(shardBegin[w] - begin,
+        shardBegin[w + 1] - begin - 1);
+
+    replicaGradients[w].zeros(parameter.n_rows, parameter.n_cols);
+    replica.Backward();
+    replica.ResetGradients(replicaGradients[w]);
+    replica.Gradient(std::move(replica.currentInput));
+  }
+
+  // Sum the gradients of the shards, in parallel over the parameters.
+  gradient.set_size(parameter.n_rows, parameter.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) gradient.n_elem; ++i)
+  {
+    double sum = replicaGradients[0][i];
+    for (size_t w = 1; w < shards; ++w)
+      sum += replicaGradients[w][i];
+    gradient[i] = sum;
+  }
 
   return res;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas()
+{
+  if (replicas.size() == workers && replicaParameter == parameter.memptr() &&
+      replicas[0]->network.size() == network.size())
+  {
+    return;
+  }
+
+  DeleteReplicas();
+  for (size_t w = 0; w < workers; ++w)
+  {
+    FFN* replica = new FFN(outputLayer, initializeRule);
+    replica->width = width;
+    replica->height = height;
+    replica->reset = reset;
+    for (size_t i = 0; i < network.size(); ++i)
+      replica->network.push_back(boost::apply_visitor(copyVisitor, network[i]));
+
+    // The weights of the replica refer to the parameters of this network, so
+    // the updates of the optimizer are seen by all replicas.
+    size_t offset = 0;
+    for (size_t i = 0; i < replica->network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+          offset), replica->network[i]);
+
+      boost::apply_visitor(resetVisitor, replica->network[i]);
+    }
+
+    replica->deterministic = deterministic;
+    replica->ResetDeterministic();
+    replica->profiler = profiler;
+    replicas.push_back(replica);
+  }
+
+  replicaGradients.resize(workers);
+  replicaParameter = parameter.memptr();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::DeleteReplicas()
+{
+  for (size_t w = 0; w < replicas.size(); ++w)
+    delete replicas[w];
+
+  replicas.clear();
+  replicaGradients.clear();
+  replicaParameter = NULL;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
@@ -357,7 +678,16 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  // A Fisher-Yates shuffle of the columns, which makes no copy of the data.
+  for (size_t i = predictors.n_cols; i > 1; --i)
+  {
+    const size_t j = math::RandInt(i);
+    if (j != i - 1)
+    {
+      predictors.swap_cols(j, i - 1);
+      responses.swap_cols(j, i - 1);
+    }
+  }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -373,6 +703,125 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::FuseLayers()
+{
+  if (!reset)
+    ResetParameters();
+
+  // The offset of the parameters of each layer, before anything is removed.
+  std::vector<size_t> offsets(network.size() + 1, 0);
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + boost::apply_visitor(weightSizeVisitor,
+        network[i]);
+  }
+
+  std::vector<LayerTypes<CustomLayers...> > fused;
+  std::vector<size_t> kept;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    fused.push_back(network[i]);
+    kept.push_back(i);
+
+    Linear<>** linear = boost::get<Linear<>*>(&network[i]);
+    if (!linear || (*linear)->Activation() != NO_ACTIVATION)
+      continue;
+
+    // The Linear layer refers to the parameters, so folding changes them in
+    // place.
+    if (i + 1 < network.size())
+    {
+      BatchNorm<>** batchNorm = boost::get<BatchNorm<>*>(&network[i + 1]);
+      if (batchNorm && (*batchNorm)->InputSize() == (*linear)->OutputSize())
+      {
+        arma::mat scale, shift;
+        (*batchNorm)->DeterministicTransform(scale, shift);
+        (*linear)->Fold(scale, shift);
+        boost::apply_visitor(deleteVisitor, network[++i]);
+      }
+    }
+
+    if (i + 1 < network.size())
+    {
+      FusedActivation activation = NO_ACTIVATION;
+      double alpha = 0.0;
+      if (boost::get<ReLULayer<>*>(&network[i + 1]))
+      {
+        activation = RELU_ACTIVATION;
+      }
+      else if (boost::get<SigmoidLayer<>*>(&network[i + 1]))
+      {
+        activation = SIGMOID_ACTIVATION;
+      }
+      else if (boost::get<TanHLayer<>*>(&network[i + 1]))
+      {
+        activation = TANH_ACTIVATION;
+      }
+      else if (LeakyReLU<>** leakyReLU = boost::get<LeakyReLU<>*>(
+          &network[i + 1]))
+      {
+        if ((*leakyReLU)->Alpha() >= 0)
+        {
+          activation = LEAKY_RELU_ACTIVATION;
+          alpha = (*leakyReLU)->Alpha();
+        }
+      }
+
+      if (activation != NO_ACTIVATION)
+      {
+        (*linear)->FuseActivation(activation, alpha);
+        boost::apply_visitor(deleteVisitor, network[++i]);
+      }
+    }
+  }
+
+  const size_t removed = network.size() - fused.size();
+  if (removed == 0)
+    return 0;
+
+  // Gather the parameters of the remaining layers.  Resetting the layers sets
+  // some of their parameters (such as those of BatchNorm), so the values are
+  // restored afterwards.
+  size_t size = 0;
+  for (size_t i = 0; i < kept.size(); ++i)
+    size += offsets[kept[i] + 1] - offsets[kept[i]];
+
+  arma::mat values(size, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < kept.size(); ++i)
+  {
+    const size_t layerSize = offsets[kept[i] + 1] - offsets[kept[i]];
+    if (layerSize > 0)
+    {
+      values.rows(offset, offset + layerSize - 1) = parameter.rows(
+          offsets[kept[i]], offsets[kept[i]] + layerSize - 1);
+    }
+    offset += layerSize;
+  }
+
+  DeleteReplicas();
+  trainingPlan.Clear();
+  inferencePlan.Clear();
+  plannedBatchSize = 0;
+  network = std::move(fused);
+
+  parameter.set_size(size, 1);
+  offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
+        offset), network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  parameter = values;
+  ResetDeterministic();
+
+  return removed;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -401,9 +850,13 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(arma::mat&& input)
 {
+  ReleaseBuffers();
+
+  profiler.Start(0, FORWARD_PASS);
   boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
       boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
+  profiler.Stop(0, FORWARD_PASS, network.front());
 
   if (!reset)
   {
@@ -429,9 +882,11 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
+    profiler.Start(i, FORWARD_PASS);
     boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
         outputParameterVisitor, network[i - 1])), std::move(
         boost::apply_visitor(outputParameterVisitor, network[i]))), network[i]);
+    profiler.Stop(i, FORWARD_PASS, network[i]);
 
     if (!reset)
     {
@@ -457,17 +912,22 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  profiler.Start(network.size() - 1, BACKWARD_PASS);
   boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
       outputParameterVisitor, network.back())), std::move(error), std::move(
       boost::apply_visitor(deltaVisitor, network.back()))), network.back());
+  profiler.Stop(network.size() - 1, BACKWARD_PASS, network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
+    profiler.Start(network.size() - i, BACKWARD_PASS);
     boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
         outputParameterVisitor, network[network.size() - i])), std::move(
         boost::apply_visitor(deltaVisitor, network[network.size() - i + 1])),
         std::move(boost::apply_visitor(deltaVisitor,
         network[network.size() - i]))), network[network.size() - i]);
+    profiler.Stop(network.size() - i, BACKWARD_PASS,
+        network[network.size() - i]);
   }
 }
 
@@ -476,19 +936,214 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(arma::mat&& input)
 {
+  profiler.Start(0, GRADIENT_PASS);
   boost::apply_visitor(GradientVisitor(std::move(input), std::move(
       boost::apply_visitor(deltaVisitor, network[1]))), network.front());
+  profiler.Stop(0, GRADIENT_PASS, network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    profiler.Start(i, GRADIENT_PASS);
     boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
         outputParameterVisitor, network[i - 1])), std::move(
         boost::apply_visitor(deltaVisitor, network[i + 1]))), network[i]);
+    profiler.Stop(i, GRADIENT_PASS, network[i]);
   }
 
+  profiler.Start(network.size() - 1, GRADIENT_PASS);
   boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2])), std::move(error)),
       network[network.size() - 1]);
+  profiler.Stop(network.size() - 1, GRADIENT_PASS, network.back());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ReadyPlan(
+    NetworkMemoryPlan& plan, const bool training)
+{
+  // The output sizes are only known once the network has been passed forward.
+  if (!planMemory || !reset || network.size() < (training ? 2 : 1))
+    return false;
+
+  if (plan.Layers() == network.size() &&
+      (!training || plan.CheckpointInterval() == checkpointInterval))
+    return true;
+
+  // Plan with the sizes of the outputs of the previous pass.
+  std::vector<size_t> outputRows(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    outputRows[i] = boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows;
+    if (outputRows[i] == 0)
+      return false;
+  }
+
+  plan.Plan(outputRows, training, checkpointInterval);
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlannedForward(arma::mat& input, const bool training)
+{
+  NetworkMemoryPlan& plan = training ? trainingPlan : inferencePlan;
+
+  // Growing the arena moves it, but every buffer that is read in the pass is
+  // bound again before it is written.
+  const size_t arenaSize = plan.Planner().ArenaSize() * input.n_cols;
+  if (arena.size() < arenaSize)
+    arena.resize(arenaSize);
+
+  plannedBatchSize = input.n_cols;
+  plannedTraining = training;
+  planMismatch = false;
+  PlannedSteps(input, plan, 0, plan.ForwardSteps());
+
+  if (!training && planMismatch)
+    plan.Clear();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlannedBackward(arma::mat& input)
+{
+  PlannedSteps(input, trainingPlan, trainingPlan.ForwardSteps(),
+      trainingPlan.Steps().size());
+
+  if (planMismatch)
+    trainingPlan.Clear();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlannedSteps(arma::mat& input,
+                                        const NetworkMemoryPlan& plan,
+                                        const size_t begin,
+                                        const size_t end)
+{
+  const MemoryPlanner& planner = plan.Planner();
+  for (size_t s = begin; s < end; ++s)
+  {
+    const NetworkMemoryPlan::Step& step = plan.Steps()[s];
+    const size_t i = step.layer;
+    arma::mat& layerInput = (i == 0) ? input :
+        boost::apply_visitor(outputParameterVisitor, network[i - 1]);
+
+    if (step.forward)
+    {
+      arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+          network[i]);
+      BindBuffer(planner, step.buffer, output);
+      profiler.Start(i, FORWARD_PASS);
+      boost::apply_visitor(ForwardVisitor(std::move(layerInput),
+          std::move(output)), network[i]);
+      profiler.Stop(i, FORWARD_PASS, network[i]);
+      CheckBuffer(planner, step.buffer, output);
+      continue;
+    }
+
+    // The backward step of the layer is directly followed by its gradient, so
+    // that the delta of the next layer can be reused by the next step.
+    arma::mat& layerError = (i + 1 == network.size()) ? error :
+        boost::apply_visitor(deltaVisitor, network[i + 1]);
+    if (i > 0)
+    {
+      arma::mat& layerDelta = boost::apply_visitor(deltaVisitor, network[i]);
+      BindBuffer(planner, step.buffer, layerDelta);
+      profiler.Start(i, BACKWARD_PASS);
+      boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
+          outputParameterVisitor, network[i])), std::move(layerError),
+          std::move(layerDelta)), network[i]);
+      profiler.Stop(i, BACKWARD_PASS, network[i]);
+      CheckBuffer(planner, step.buffer, layerDelta);
+    }
+
+    profiler.Start(i, GRADIENT_PASS);
+    boost::apply_visitor(GradientVisitor(std::move(layerInput),
+        std::move(layerError)), network[i]);
+    profiler.Stop(i, GRADIENT_PASS, network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BindBuffer(const MemoryPlanner& planner,
+                                      const size_t buffer,
+                                      arma::mat& matrix)
+{
+  // The matrix is not strict, so a layer that gives it another size gets new
+  // memory instead of writing outside of the buffer.
+  matrix = arma::mat(arena.data() + planner.Offset(buffer) * plannedBatchSize,
+      planner.Size(buffer), plannedBatchSize, false, false);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CheckBuffer(const MemoryPlanner& planner,
+                                       const size_t buffer,
+                                       const arma::mat& matrix)
+{
+  if (matrix.memptr() != arena.data() + planner.Offset(buffer) *
+      plannedBatchSize || matrix.n_elem != planner.Size(buffer) *
+      plannedBatchSize)
+  {
+    planMismatch = true;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ReleaseBuffers()
+{
+  if (plannedBatchSize == 0)
+    return;
+
+  // The sizes are kept, since the next plans are made from them.
+  std::less<const double*> less;
+  const double* arenaBegin = arena.data();
+  const double* arenaEnd = arena.data() + arena.size();
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    arma::mat* buffers[2] = {
+        &boost::apply_visitor(outputParameterVisitor, network[i]),
+        &boost::apply_visitor(deltaVisitor, network[i]) };
+    for (size_t b = 0; b < 2; ++b)
+    {
+      if (!less(buffers[b]->memptr(), arenaBegin) &&
+          less(buffers[b]->memptr(), arenaEnd))
+      {
+        const size_t rows = buffers[b]->n_rows;
+        const size_t cols = buffers[b]->n_cols;
+        buffers[b]->reset();
+        buffers[b]->set_size(rows, cols);
+      }
+    }
+  }
+
+  plannedBatchSize = 0;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::LogProfile() const
+{
+  if (!profiler.Enabled())
+    return;
+
+  // The table is formatted first, since Log::Info formats each item alone.
+  std::ostringstream oss;
+  profiler.Report(network, oss);
+  Log::Info << "FFN: time (in seconds) and cost of each layer:" << std::endl
+      << oss.str();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -512,6 +1167,10 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   // Be sure to clear other layers before loading.
   if (Archive::is_loading::value)
   {
+    DeleteReplicas();
+    trainingPlan.Clear();
+    inferencePlan.Clear();
+    plannedBatchSize = 0;
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -563,6 +1222,19 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(inputParameter, network.inputParameter);
   std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(workers, network.workers);
+  std::swap(replicas, network.replicas);
+  std::swap(replicaGradients, network.replicaGradients);
+  std::swap(replicaParameter, network.replicaParameter);
+  std::swap(planMemory, network.planMemory);
+  std::swap(checkpointInterval, network.checkpointInterval);
+  std::swap(trainingPlan, network.trainingPlan);
+  std::swap(inferencePlan, network.inferencePlan);
+  std::swap(arena, network.arena);
+  std::swap(plannedBatchSize, network.plannedBatchSize);
+  std::swap(plannedTraining, network.plannedTraining);
+  std::swap(planMismatch, network.planMismatch);
+  std::swap(profiler, network.profiler);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -584,7 +1256,17 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(network.delta),
     inputParameter(network.inputParameter),
     outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    workers(network.workers),
+    replicaParameter(NULL),
+    planMemory(network.planMemory),
+    checkpointInterval(network.checkpointInterval),
+    trainingPlan(network.trainingPlan),
+    inferencePlan(network.inferencePlan),
+    plannedBatchSize(0),
+    plannedTraining(false),
+    planMismatch(false),
+    profiler(network.profiler)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -613,9 +1295,21 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     delta(std::move(network.delta)),
     inputParameter(std::move(network.inputParameter)),
     outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    workers(network.workers),
+    replicaParameter(NULL),
+    planMemory(network.planMemory),
+    checkpointInterval(network.checkpointInterval),
+    trainingPlan(std::move(network.trainingPlan)),
+    inferencePlan(std::move(network.inferencePlan)),
+    arena(std::move(network.arena)),
+    plannedBatchSize(network.plannedBatchSize),
+    plannedTraining(network.plannedTraining),
+    planMismatch(network.planMismatch),
+    profiler(network.profiler)
 {
   this->network = std::move(network.network);
+  network.plannedBatchSize = 0;
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -277,6 +277,17 @@ class GAN
   void Predict(arma::mat&& input,
                arma::mat& output);
 
+  /**
+   * Generate the given number of samples, by passing batches of noise drawn
+   * from the noise function through the Generator network.  The noise is
+   * processed in batches of the training batch size, so that the memory used
+   * does not grow with the number of samples.
+   *
+   * @param numSamples Number of samples to generate.
+   * @param samples Matrix to store the samples in (one per column).
+   */
+  void Generate(const size_t numSamples, arma::mat& samples);
+
   //! Return the parameters of the network.
   const arma::mat& Parameters() const { return parameter; }
   //! Modify the parameters of the network.
@@ -294,11 +305,33 @@ class GAN
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
+  /**
+   * Get whether the training steps are pipelined: the Generator computes the
+   * next fake batch while the Discriminator is evaluated on the real batch, on
+   * two OpenMP threads.  The noise is still drawn on the calling thread, since
+   * the noise function may not be thread-safe.
+   */
+  bool Pipelined() const { return pipelined; }
+  //! Modify whether the training steps are pipelined.
+  bool& Pipelined() { return pipelined; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Run the given evaluation of the Discriminator on the real batch, and pass
+   * a new batch of noise through the Generator.  If Pipelined() is true, both
+   * run at the same time; they use disjoint networks, and the fake batch is
+   * only given to the Discriminator afterwards.
+   *
+   * @param realStep Function evaluating the Discriminator on the real batch;
+   *     it returns the performance.
+   */
+  template<typename RealStepType>
+  double RealStepAndGenerate(RealStepType&& realStep);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -333,6 +366,8 @@ class GAN
   double lambda;
   //! Locally stored reset parameter.
   bool reset;
+  //! Locally stored pipelining parameter.
+  bool pipelined;
   //! Locally stored delta visitor.
   DeltaVisitor deltaVisitor;
   //! Locally stored responses.
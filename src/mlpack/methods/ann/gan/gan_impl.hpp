@@ -54,7 +54,8 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     multiplier(multiplier),
     clippingParameter(clippingParameter),
     lambda(lambda),
-    reset(false)
+    reset(false),
+    pipelined(false)
 {
   // Insert IdentityLayer for joining the Generator and Discriminator.
   this->discriminator.network.insert(
@@ -108,6 +109,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(network.clippingParameter),
     lambda(network.lambda),
     reset(network.reset),
+    pipelined(network.pipelined),
     counter(network.counter),
     currentBatch(network.currentBatch),
     parameter(network.parameter),
@@ -139,6 +141,7 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::GAN(
     clippingParameter(network.clippingParameter),
     lambda(network.lambda),
     reset(network.reset),
+    pipelined(network.pipelined),
     counter(network.counter),
     currentBatch(network.currentBatch),
     parameter(std::move(network.parameter)),
@@ -223,14 +226,14 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   currentTarget = arma::mat(responses.memptr() + i, 1, batchSize, false,
       false);
 
-  discriminator.Forward(std::move(currentInput));
-  double res = discriminator.outputLayer.Forward(
-      std::move(boost::apply_visitor(
-      outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  double res = RealStepAndGenerate([&]()
+  {
+    discriminator.Forward(std::move(currentInput));
+    return discriminator.outputLayer.Forward(
+        std::move(boost::apply_visitor(
+        outputParameterVisitor,
+        discriminator.network.back())), std::move(currentTarget));
+  });
 
   discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       boost::apply_visitor(outputParameterVisitor, generator.network.back());
@@ -293,12 +296,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
-  // Get the gradients of the Discriminator.
-  double res = discriminator.EvaluateWithGradient(discriminator.parameter,
-      i, gradientDiscriminator, batchSize);
-
-  noise.imbue( [&]() { return noiseFunction();} );
-  generator.Forward(std::move(noise));
+  // Get the gradients of the Discriminator, while the fake batch is generated.
+  double res = RealStepAndGenerate([&]()
+  {
+    return discriminator.EvaluateWithGradient(discriminator.parameter, i,
+        gradientDiscriminator, batchSize);
+  });
   discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
       boost::apply_visitor(outputParameterVisitor, generator.network.back());
   discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
@@ -411,6 +414,75 @@ Predict(arma::mat&& input, arma::mat& output)
       discriminator.network.back());
 }
 
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+void GAN<Model, InitializationRuleType, Noise, PolicyType>::
+Generate(const size_t numSamples, arma::mat& samples)
+{
+  if (!reset)
+    Reset();
+
+  samples.reset();
+  const size_t step = std::max(batchSize, (size_t) 1);
+  arma::mat batchNoise;
+  for (size_t begin = 0; begin < numSamples; begin += step)
+  {
+    const size_t end = std::min(begin + step, numSamples) - 1;
+    batchNoise.set_size(noiseDim, end - begin + 1);
+    batchNoise.imbue( [&]() { return noiseFunction();} );
+
+    generator.Forward(std::move(batchNoise));
+    const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+        generator.network.back());
+
+    if (begin == 0)
+      samples.set_size(output.n_rows, numSamples);
+    samples.cols(begin, end) = output;
+  }
+}
+
+template<
+  typename Model,
+  typename InitializationRuleType,
+  typename Noise,
+  typename PolicyType
+>
+template<typename RealStepType>
+double GAN<Model, InitializationRuleType, Noise, PolicyType>::
+RealStepAndGenerate(RealStepType&& realStep)
+{
+  if (!pipelined)
+  {
+    const double res = realStep();
+    noise.imbue( [&]() { return noiseFunction();} );
+    generator.Forward(std::move(noise));
+    return res;
+  }
+
+  // The noise function may use the global random number generator, so the
+  // noise is drawn before the two networks run.
+  noise.imbue( [&]() { return noiseFunction();} );
+
+  double res = 0.0;
+  #pragma omp parallel sections num_threads(2)
+  {
+    #pragma omp section
+    {
+      res = realStep();
+    }
+    #pragma omp section
+    {
+      generator.Forward(std::move(noise));
+    }
+  }
+
+  return res;
+}
+
 template<
   typename Model,
   typename InitializationRuleType,
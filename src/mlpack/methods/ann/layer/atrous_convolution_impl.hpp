@@ -135,36 +135,46 @@ void AtrousConvolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // Group the filters by input map, so that each input map can be convolved
+  // with all of its filters at once (with Im2ColConvolution, this is a single
+  // matrix multiplication).
+  arma::Cube<eT> inMapWeights(weight.n_rows, weight.n_cols, weight.n_slices);
+  for (size_t outMap = 0; outMap < outSize; outMap++)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      batchCount++;
-      outMapIdx = 0;
+      inMapWeights.slice(inMap * outSize + outMap) =
+          weight.slice(outMap * inSize + inMap);
     }
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+  for (size_t batchCount = 0; batchCount < batchSize; batchCount++)
+  {
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      arma::Mat<eT> convOutput;
+      arma::Cube<eT> filters(inMapWeights.slice_memptr(inMap * outSize),
+          weight.n_rows, weight.n_cols, outSize, false, true);
+      arma::Cube<eT> convOutput;
 
       if (padW != 0 || padH != 0)
       {
         ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+            batchCount * inSize), filters, convOutput, dW, dH,
             dilationW, dilationH);
       }
       else
       {
         ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+            batchCount * inSize), filters, convOutput, dW, dH,
             dilationW, dilationH);
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slices(batchCount * outSize, (batchCount + 1) * outSize - 1)
+          += convOutput;
     }
 
-    outputTemp.slice(outMap) += bias(outMap % outSize);
+    for (size_t outMap = 0; outMap < outSize; outMap++)
+      outputTemp.slice(batchCount * outSize + outMap) += bias(outMap);
   }
 
   outputWidth = outputTemp.n_rows;
@@ -132,12 +132,26 @@ class BatchNorm
   //! Modify the value of deterministic parameter.
   bool& Deterministic() { return deterministic; }
 
+  //! Get the number of input units.
+  size_t InputSize() const { return size; }
+
   //! Get the mean over the training data.
   OutputDataType TrainingMean() { return runningMean; }
 
   //! Get the variance over the training data.
   OutputDataType TrainingVariance() { return runningVariance / count; }
 
+  /**
+   * Get the element-wise affine transformation y = scale % x + shift that the
+   * layer computes in deterministic mode, from the statistics of the training
+   * data.
+   *
+   * @param scale The scale of each unit.
+   * @param shift The shift of each unit.
+   */
+  void DeterministicTransform(OutputDataType& scale,
+                              OutputDataType& shift) const;
+
   /**
    * Serialize the layer
    */
@@ -46,8 +46,9 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
 template<typename InputDataType, typename OutputDataType>
 void BatchNorm<InputDataType, OutputDataType>::Reset()
 {
-  gamma = arma::mat(weights.memptr(), size, 1, false, false);
-  beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, size, 1, false,
+      false);
 
   if (!loading)
   {
@@ -64,40 +65,69 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
+  output.set_size(input.n_rows, input.n_cols);
+
   // Mean and variance over the entire training set will be used to compute
   // the forward pass when deterministic is set to true.
   if (deterministic)
   {
-    // Normalize the input and scale and shift the output.
-    output = input.each_col() - runningMean;
-    output.each_col() %= gamma / arma::sqrt(runningVariance / count + eps);
-    output.each_col() += beta;
+    // Normalize the input and scale and shift the output in one pass.
+    OutputDataType scale, shift;
+    DeterministicTransform(scale, shift);
+
+    for (size_t j = 0; j < input.n_cols; ++j)
+    {
+      const eT* x = input.colptr(j);
+      eT* y = output.colptr(j);
+      for (size_t r = 0; r < input.n_rows; ++r)
+        y[r] = scale[r] * x[r] + shift[r];
+    }
   }
   else
   {
-    mean = arma::mean(input, 1);
-    variance = arma::var(input, 1, 1);
-
-    // Normalize the input.
-    output = input.each_col() - mean;
-    output.each_col() /= arma::sqrt(variance + eps);
-
-    // Use Welford method to compute the sample variance and mean.
-    for (size_t i = 0; i < input.n_cols; i++)
+    // Use Welford method to compute the mean and variance of the batch in a
+    // single pass.
+    const size_t n = input.n_cols;
+    mean.zeros(input.n_rows, 1);
+    variance.zeros(input.n_rows, 1);
+    for (size_t j = 0; j < n; ++j)
     {
-      count += 1;
-
-      OutputDataType delta = input.col(i) - runningMean;
-      runningMean = runningMean + delta / count;
-      runningVariance += delta % (input.col(i) - runningMean);
+      const eT* x = input.colptr(j);
+      for (size_t r = 0; r < input.n_rows; ++r)
+      {
+        const double delta = x[r] - mean[r];
+        mean[r] += delta / (j + 1);
+        variance[r] += delta * (x[r] - mean[r]);
+      }
     }
 
-    // Reused in the backward and gradient step.
-    normalized = output;
-
-    // Scale and shift the output.
-    output.each_col() %= gamma;
-    output.each_col() += beta;
+    // Merge the statistics of the batch into the statistics of the training
+    // data, which gives the same result as a Welford update with each point.
+    const double total = (double) count + n;
+    for (size_t r = 0; r < input.n_rows; ++r)
+    {
+      const double delta = mean[r] - runningMean[r];
+      runningMean[r] += delta * n / total;
+      runningVariance[r] += variance[r] + delta * delta * count * n / total;
+    }
+    count += n;
+    variance /= n;
+
+    // Normalize the input and scale and shift the output in one pass.  The
+    // normalized input is reused in the backward and gradient step.
+    const OutputDataType stdInv = 1.0 / arma::sqrt(variance + eps);
+    normalized.set_size(input.n_rows, input.n_cols);
+    for (size_t j = 0; j < n; ++j)
+    {
+      const eT* x = input.colptr(j);
+      auto* xhat = normalized.colptr(j);
+      eT* y = output.colptr(j);
+      for (size_t r = 0; r < input.n_rows; ++r)
+      {
+        xhat[r] = (x[r] - mean[r]) * stdInv[r];
+        y[r] = gamma[r] * xhat[r] + beta[r];
+      }
+    }
   }
 }
 
@@ -106,25 +136,35 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_col() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // Step 1: dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
-      arma::pow(stdInv, 3.0) * -0.5;
+  const size_t n = input.n_cols;
 
-  // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_col() % stdInv) + (inputMean.each_col() %
-      var * 2 / input.n_cols);
+  // Step 1: sum dl / dy and sum dl / dy * xhat over the batch.
+  OutputDataType sumGy = arma::zeros<OutputDataType>(gy.n_rows, 1);
+  OutputDataType sumGyNorm = arma::zeros<OutputDataType>(gy.n_rows, 1);
+  for (size_t j = 0; j < n; ++j)
+  {
+    const eT* dy = gy.colptr(j);
+    const auto* xhat = normalized.colptr(j);
+    for (size_t r = 0; r < gy.n_rows; ++r)
+    {
+      sumGy[r] += dy[r];
+      sumGyNorm[r] += dy[r] * xhat[r];
+    }
+  }
 
-  // Step 3: sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_col() += (arma::sum(norm.each_col() % -stdInv, 1) + (var %
-      arma::mean(-2 * inputMean, 1))) / input.n_cols;
+  // Step 2: with dl / dxhat = dl / dy * gamma,
+  // dl / dx = stdInv / m * (m * dl / dxhat - sum dl / dxhat -
+  // xhat * sum dl / dxhat * xhat).
+  const OutputDataType scale = gamma / arma::sqrt(variance + eps) / n;
+  g.set_size(gy.n_rows, gy.n_cols);
+  for (size_t j = 0; j < n; ++j)
+  {
+    const eT* dy = gy.colptr(j);
+    const auto* xhat = normalized.colptr(j);
+    eT* dx = g.colptr(j);
+    for (size_t r = 0; r < gy.n_rows; ++r)
+      dx[r] = scale[r] * (n * dy[r] - sumGy[r] - xhat[r] * sumGyNorm[r]);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -134,14 +174,30 @@ void BatchNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
+  gradient.zeros(size + size, 1);
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
+  // dl / dgamma = sum dl / dy * xhat and dl / dbeta = sum dl / dy, in one
+  // pass.
+  eT* gammaGrad = gradient.memptr();
+  eT* betaGrad = gradient.memptr() + size;
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    const eT* dy = error.colptr(j);
+    const auto* xhat = normalized.colptr(j);
+    for (size_t r = 0; r < size; ++r)
+    {
+      gammaGrad[r] += dy[r] * xhat[r];
+      betaGrad[r] += dy[r];
+    }
+  }
+}
 
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+template<typename InputDataType, typename OutputDataType>
+void BatchNorm<InputDataType, OutputDataType>::DeterministicTransform(
+    OutputDataType& scale, OutputDataType& shift) const
+{
+  scale = gamma / arma::sqrt(runningVariance / count + eps);
+  shift = beta - scale % runningMean;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -30,6 +30,12 @@ namespace ann /** Artificial Neural Network. */ {
  * feed-forward fully connected network container which plugs various layers
  * together.
  *
+ * The output of each module is column i of the output (zero-padded to the
+ * largest output).  The output parameter of each module is an alias of its
+ * column, so the modules write their outputs in place once their shapes are
+ * known (after the first pass), and the backward pass reads the error of each
+ * module in place from its part of the error.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -158,6 +164,30 @@ class Concat
   void serialize(Archive& /* ar */, const unsigned int /* version */);
 
  private:
+  /**
+   * Make the given matrix (output parameter or delta) of each module an alias
+   * of its column of the given matrix, with the shape it had in the last
+   * pass.  Nothing is done before the first pass.
+   */
+  template<typename VisitorType>
+  void BindColumns(arma::mat& matrix,
+                   VisitorType& visitor,
+                   const std::vector<size_t>& rows,
+                   const std::vector<size_t>& cols);
+
+  /**
+   * Make sure that the given matrix (output parameter or delta) of each module
+   * is in its column of the given matrix, padded with zeros: if a module
+   * didn't write in place (in the first pass, or if its shape changed), the
+   * matrices are copied, and bound again to the columns.  The shapes are kept
+   * for the next pass.
+   */
+  template<typename VisitorType>
+  void GatherColumns(arma::mat& matrix,
+                     VisitorType& visitor,
+                     std::vector<size_t>& rows,
+                     std::vector<size_t>& cols);
+
   //! Parameter which indicates if the modules should be exposed.
   bool model;
 
@@ -193,6 +223,18 @@ class Concat
 
   //! Locally-stored gradient object.
   arma::mat gradient;
+
+  //! The number of rows of the output of each module in the last pass.
+  std::vector<size_t> outputRows;
+
+  //! The number of columns of the output of each module in the last pass.
+  std::vector<size_t> outputCols;
+
+  //! The number of rows of the delta of each module in the last pass.
+  std::vector<size_t> deltaRows;
+
+  //! The number of columns of the delta of each module in the last pass.
+  std::vector<size_t> deltaCols;
 }; // class Concat
 
 } // namespace ann
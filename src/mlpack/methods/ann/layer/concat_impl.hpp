@@ -45,39 +45,16 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
     arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  size_t outSize = 0;
+  BindColumns(output, outputParameterVisitor, outputRows, outputCols);
 
   for (size_t i = 0; i < network.size(); ++i)
   {
     boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
         boost::apply_visitor(outputParameterVisitor, network[i]))),
         network[i]);
-
-    if (boost::apply_visitor(
-        outputParameterVisitor, network[i]).n_elem > outSize)
-    {
-      outSize = boost::apply_visitor(outputParameterVisitor,
-          network[i]).n_elem;
-    }
   }
 
-  output = arma::zeros(outSize, network.size());
-  for (size_t i = 0; i < network.size(); ++i)
-  {
-    size_t elements = boost::apply_visitor(outputParameterVisitor,
-        network[i]).n_elem;
-
-    if (elements < outSize)
-    {
-      output.submat(0, i, elements - 1, i) = arma::vectorise(
-          boost::apply_visitor(outputParameterVisitor, network[i]));
-    }
-    else
-    {
-      output.col(i) = arma::vectorise(boost::apply_visitor(
-        outputParameterVisitor, network[i]));
-    }
-  }
+  GatherColumns(output, outputParameterVisitor, outputRows, outputCols);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -86,33 +63,24 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  size_t outSize = 0;
-  size_t elements = 0;
+  if (!same)
+    BindColumns(g, deltaVisitor, deltaRows, deltaCols);
 
+  size_t elements = 0;
   for (size_t i = 0, j = 0; i < network.size(); ++i, j += elements)
   {
     elements = boost::apply_visitor(outputParameterVisitor,
         network[i]).n_elem;
 
-    arma::mat delta;
-    if (gy.n_cols == 1)
-    {
-      delta = gy.submat(j, 0, j + elements - 1, 0);
-    }
-    else
-    {
-      delta = gy.submat(0, i, elements - 1, i);
-    }
+    // The error of the module is contiguous in the error, so it is read in
+    // place.
+    eT* error = (gy.n_cols == 1) ? gy.memptr() + j : gy.colptr(i);
+    arma::mat delta(error, elements, 1, false, true);
 
     boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
         outputParameterVisitor, network[i])), std::move(delta), std::move(
         boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
 
-    if (boost::apply_visitor(deltaVisitor, network[i]).n_elem > outSize)
-    {
-      outSize = boost::apply_visitor(deltaVisitor, network[i]).n_elem;
-    }
-
     if (same)
     {
       if (i == 0)
@@ -127,23 +95,7 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
   }
 
   if (!same)
-  {
-    g = arma::zeros(outSize, network.size());
-    for (size_t i = 0; i < network.size(); ++i)
-    {
-      size_t elements = boost::apply_visitor(deltaVisitor, network[i]).n_elem;
-      if (elements < outSize)
-      {
-        g.submat(0, i, elements - 1, i) = arma::vectorise(
-            boost::apply_visitor(deltaVisitor, network[i]));
-      }
-      else
-      {
-        g.col(i) = arma::vectorise(
-            boost::apply_visitor(deltaVisitor, network[i]));
-      }
-    }
-  }
+    GatherColumns(g, deltaVisitor, deltaRows, deltaCols);
 }
 
 template<typename InputDataType, typename OutputDataType,
@@ -161,6 +113,94 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   }
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename VisitorType>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::BindColumns(
+    arma::mat& matrix,
+    VisitorType& visitor,
+    const std::vector<size_t>& rows,
+    const std::vector<size_t>& cols)
+{
+  if (rows.size() != network.size())
+    return;
+
+  size_t size = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    size = std::max(size, rows[i] * cols[i]);
+
+  if (matrix.n_rows != size || matrix.n_cols != network.size())
+    matrix.set_size(size, network.size());
+
+  // The aliases are not strict, so a module whose output has another shape
+  // gets new memory instead of writing outside of its column.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    boost::apply_visitor(visitor, network[i]) = arma::mat(matrix.colptr(i),
+        rows[i], cols[i], false, false);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+template<typename VisitorType>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::GatherColumns(
+    arma::mat& matrix,
+    VisitorType& visitor,
+    std::vector<size_t>& rows,
+    std::vector<size_t>& cols)
+{
+  size_t size = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    size = std::max(size, (size_t) boost::apply_visitor(visitor,
+        network[i]).n_elem);
+  }
+
+  bool inPlace = (rows.size() == network.size() && matrix.n_rows == size &&
+      matrix.n_cols == network.size());
+  for (size_t i = 0; i < network.size() && inPlace; ++i)
+  {
+    const arma::mat& m = boost::apply_visitor(visitor, network[i]);
+    inPlace = (m.memptr() == matrix.colptr(i) && m.n_rows == rows[i] &&
+        m.n_cols == cols[i]);
+  }
+
+  if (!inPlace)
+  {
+    // The matrices are copied before the matrix is replaced, since some of
+    // them may still be in it.
+    arma::mat gathered = arma::zeros(size, network.size());
+    rows.resize(network.size());
+    cols.resize(network.size());
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      const arma::mat& m = boost::apply_visitor(visitor, network[i]);
+      rows[i] = m.n_rows;
+      cols[i] = m.n_cols;
+      if (m.n_elem > 0)
+        gathered.submat(0, i, m.n_elem - 1, i) = arma::vectorise(m);
+    }
+
+    matrix = std::move(gathered);
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      boost::apply_visitor(visitor, network[i]) = arma::mat(matrix.colptr(i),
+          rows[i], cols[i], false, false);
+    }
+
+    return;
+  }
+
+  // Zero the padding of the smaller matrices.
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t elements = rows[i] * cols[i];
+    if (elements < size)
+      matrix.submat(elements, i, size - 1, i).zeros();
+  }
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
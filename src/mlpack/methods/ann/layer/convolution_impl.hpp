@@ -91,9 +91,9 @@ void Convolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kW, kH,
-        outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    weight = arma::Cube<typename OutputDataType::elem_type>(weights.memptr(),
+        kW, kH, outSize * inSize, false, false);
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -114,7 +114,7 @@ void Convolution<
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   batchSize = input.n_cols;
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
   if (padW != 0 || padH != 0)
@@ -130,34 +130,44 @@ void Convolution<
       outSize * batchSize, false, false);
   outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  // Group the filters by input map, so that each input map can be convolved
+  // with all of its filters at once (with Im2ColConvolution, this is a single
+  // matrix multiplication).
+  arma::Cube<eT> inMapWeights(weight.n_rows, weight.n_cols, weight.n_slices);
+  for (size_t outMap = 0; outMap < outSize; outMap++)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      batchCount++;
-      outMapIdx = 0;
+      inMapWeights.slice(inMap * outSize + outMap) =
+          weight.slice(outMap * inSize + inMap);
     }
+  }
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+  for (size_t batchCount = 0; batchCount < batchSize; batchCount++)
+  {
+    for (size_t inMap = 0; inMap < inSize; inMap++)
     {
-      arma::Mat<eT> convOutput;
+      arma::Cube<eT> filters(inMapWeights.slice_memptr(inMap * outSize),
+          weight.n_rows, weight.n_cols, outSize, false, true);
+      arma::Cube<eT> convOutput;
 
       if (padW != 0 || padH != 0)
       {
         ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
+            batchCount * inSize), filters, convOutput, dW, dH);
       }
       else
       {
         ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH);
+            batchCount * inSize), filters, convOutput, dW, dH);
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slices(batchCount * outSize, (batchCount + 1) * outSize - 1)
+          += convOutput;
     }
 
-    outputTemp.slice(outMap) += bias(outMap % outSize);
+    for (size_t outMap = 0; outMap < outSize; outMap++)
+      outputTemp.slice(batchCount * outSize + outMap) += bias(outMap);
   }
 
   outputWidth = outputTemp.n_rows;
@@ -181,7 +191,7 @@ void Convolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
 
   g.set_size(inputTemp.n_rows * inputTemp.n_cols * inSize, batchSize);
@@ -239,7 +249,7 @@ void Convolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError(error.memptr(), outputWidth,
+  arma::Cube<eT> mappedError(error.memptr(), outputWidth,
       outputHeight, outSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
@@ -36,6 +36,11 @@ namespace ann /** Artificial Neural Network. */ {
  * Note that FastLSTM network layer does not use peephole connections between
  * the cell and gates.
  *
+ * Each step costs one GEMM for the input and one for the previous output, both
+ * written directly into the preallocated gate buffer, followed by a single
+ * elementwise pass that applies the activations and updates the cell; the
+ * backward pass computes the errors of all the gates in one pass as well.
+ *
  * For more information, see the following.
  *
  * @code
@@ -116,6 +121,15 @@ class FastLSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Resets the cell to accept the continuation of the previous input: like
+   * ResetCell(), this starts a new BPTT chain, but the first step starts from
+   * the last output and cell state of the previous steps instead of zeros.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -276,6 +290,9 @@ class FastLSTM
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
+  //! Locally-stored cell state the first step starts from.
+  OutputDataType initialCell;
+
   //! Locally-stored foget gate error.
   OutputDataType forgetGateError;
 
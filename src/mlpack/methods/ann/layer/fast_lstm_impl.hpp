@@ -107,6 +107,33 @@ void FastLSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // The first step starts from the zero state.
+  outParameter.cols(0, batchStep).zeros();
+  initialCell.zeros(outSize, batchSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void FastLSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (batchSize == 0 || bpttSteps == 0 || cell.is_empty())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // Find the last step of the previous sequence; forwardStep wraps around to 0
+  // after bpttSteps steps.
+  const size_t steps = (forwardStep == 0) ? bpttSteps : forwardStep / batchSize;
+  const OutputDataType lastOutput = outParameter.cols(steps * batchSize,
+      steps * batchSize + batchStep);
+  const OutputDataType lastCell = cell.cols((steps - 1) * batchSize,
+      (steps - 1) * batchSize + batchStep);
+
+  ResetCell(size);
+
+  outParameter.cols(0, batchStep) = lastOutput;
+  initialCell = lastCell;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -123,48 +150,49 @@ void FastLSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
-  gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
-      output2GateWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  gate.cols(forwardStep, forwardStep + batchStep).each_col() += input2GateBias;
-
-  FastSigmoid(std::move(
-      gate.submat(0, forwardStep, 3 * outSize - 1, forwardStep + batchStep)),
-      std::move(gateActivation.cols(forwardStep, forwardStep + batchStep)));
-
-  stateActivation.cols(forwardStep, forwardStep + batchStep) = arma::tanh(
-      gate.submat(3 * outSize, forwardStep, 4 * outSize - 1,
-      forwardStep + batchStep));
-
-  // Update the cell: cmul1 + cmul2
-  // where cmul1 is input gate * hidden state and
-  // cmul2 is forget gate * cell (prevCell).
-  if (forwardStep == 0)
-  {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep);
-  }
-  else
+  // The layer may be used without a call to ResetCell().
+  if (forwardStep == 0 && initialCell.n_cols != batchSize)
+    initialCell.zeros(outSize, batchSize);
+
+  // Compute all the gate pre-activations of the step directly in the gate
+  // buffer: one GEMM for the input, and one GEMM for the previous output that
+  // is accumulated in place.
+  OutputDataType stepGate(gate.colptr(forwardStep), 4 * outSize, batchSize,
+      false, true);
+  const OutputDataType previousOutput(outParameter.colptr(forwardStep),
+      outSize, batchSize, false, true);
+  stepGate = input2GateWeight * input;
+  stepGate += output2GateWeight * previousOutput;
+  stepGate.each_col() += input2GateBias;
+
+  // Apply the activations, update the cell (input gate * hidden state +
+  // forget gate * previous cell) and compute the output in a single pass over
+  // the step.  The gate rows hold the input gate, the output gate, the forget
+  // gate and the hidden state, in that order.
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    cell.cols(forwardStep, forwardStep + batchStep) =
-        gateActivation.submat(0, forwardStep, outSize - 1,
-        forwardStep + batchStep) %
-        stateActivation.cols(forwardStep, forwardStep + batchStep) +
-        gateActivation.submat(2 * outSize, forwardStep, 3 * outSize - 1,
-        forwardStep + batchStep) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
+    const size_t col = forwardStep + j;
+    const ElemType* g = gate.colptr(col);
+    ElemType* a = gateActivation.colptr(col);
+    ElemType* s = stateActivation.colptr(col);
+    ElemType* c = cell.colptr(col);
+    const ElemType* prevCell = (forwardStep == 0) ? initialCell.colptr(j) :
+        cell.colptr(col - batchSize);
+    ElemType* ca = cellActivation.colptr(col);
+    ElemType* h = outParameter.colptr(col + batchSize);
+
+    for (size_t i = 0; i < 3 * outSize; ++i)
+      a[i] = FastSigmoid(g[i]);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      s[i] = std::tanh(g[3 * outSize + i]);
+      c[i] = a[i] * s[i] + a[2 * outSize + i] * prevCell[i];
+      ca[i] = std::tanh(c[i]);
+      h[i] = ca[i] * a[outSize + i];
+    }
   }
 
-  cellActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
-
-  outParameter.cols(forwardStep + batchSize,
-      forwardStep + batchSize + batchStep) = cellActivation.cols(
-      forwardStep, forwardStep + batchStep) % gateActivation.submat(
-      outSize, forwardStep, 2 * outSize - 1, forwardStep + batchStep);
-
   output = OutputType(outParameter.memptr() +
       (forwardStep + batchSize) * outSize, outSize, batchSize, false, false);
 
@@ -185,51 +213,47 @@ void FastLSTM<InputDataType, OutputDataType>::Backward(
     gy += output2GateWeight.t() * prevError;
   }
 
-  cellActivationError = gy % gateActivation.submat(outSize,
-      backwardStep - batchStep, 2 * outSize - 1, backwardStep) %
-      (1 - arma::pow(cellActivation.cols(backwardStep - batchStep,
-      backwardStep), 2));
-
-  if (gradientStepIdx > 0)
-    cellActivationError += forgetGateError;
+  // Compute the errors of the cell and of all the gates in a single pass over
+  // the step.
+  cellActivationError.set_size(outSize, batchSize);
+  prevError.set_size(4 * outSize, batchSize);
+  if (gradientStepIdx == 0)
+    forgetGateError.set_size(outSize, batchSize);
 
-  forgetGateError = gateActivation.submat(2 * outSize,
-      backwardStep - batchStep, 3 * outSize - 1, backwardStep) %
-      cellActivationError;
-
-  if (backwardStep > batchStep)
-  {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) =
-        cell.cols((backwardStep - batchSize) - batchStep,
-        (backwardStep - batchSize)) % cellActivationError %
-        gateActivation.submat(2 * outSize, backwardStep - batchStep,
-        3 * outSize - 1, backwardStep) % (1.0 - gateActivation.submat(
-        2 * outSize, backwardStep - batchStep, 3 * outSize - 1, backwardStep));
-  }
-  else
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    prevError.submat(2 * outSize, 0, 3 * outSize - 1, batchStep).zeros();
+    const size_t col = backwardStep - batchStep + j;
+    const ElemType* a = gateActivation.colptr(col);
+    const ElemType* s = stateActivation.colptr(col);
+    const ElemType* ca = cellActivation.colptr(col);
+    const ElemType* prevCell = (backwardStep > batchStep) ?
+        cell.colptr(col - batchSize) : initialCell.colptr(j);
+    const ElemType* dy = gy.colptr(j);
+    ElemType* dc = cellActivationError.colptr(j);
+    ElemType* df = forgetGateError.colptr(j);
+    ElemType* e = prevError.colptr(j);
+
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const ElemType inputGate = a[i];
+      const ElemType outputGate = a[outSize + i];
+      const ElemType forgetGate = a[2 * outSize + i];
+
+      dc[i] = dy[i] * outputGate * (1 - ca[i] * ca[i]);
+      if (gradientStepIdx > 0)
+        dc[i] += df[i];
+
+      // The error carried to the cell of the previous step.
+      df[i] = forgetGate * dc[i];
+
+      e[i] = s[i] * dc[i] * inputGate * (1.0 - inputGate);
+      e[outSize + i] = ca[i] * dy[i] * outputGate * (1.0 - outputGate);
+      e[2 * outSize + i] = prevCell[i] * dc[i] * forgetGate *
+          (1.0 - forgetGate);
+      e[3 * outSize + i] = inputGate * dc[i] * (1 - s[i] * s[i]);
+    }
   }
 
-  prevError.submat(0, 0, outSize - 1, batchStep) =
-      stateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellActivationError % gateActivation.submat(
-      0, backwardStep - batchStep, outSize - 1, backwardStep) %
-      (1.0 - gateActivation.submat(
-      0, backwardStep - batchStep, outSize - 1, backwardStep));
-
-  prevError.submat(3 * outSize, 0, 4 * outSize - 1, batchStep) =
-      gateActivation.submat(0, backwardStep - batchStep,
-      outSize - 1, backwardStep) % cellActivationError % (1 - arma::pow(
-      stateActivation.cols(backwardStep - batchStep, backwardStep), 2));
-
-  prevError.submat(outSize, 0, 2 * outSize - 1, batchStep) =
-      cellActivation.cols(backwardStep - batchStep,
-      backwardStep) % gy % gateActivation.submat(
-       outSize, backwardStep - batchStep, 2 * outSize - 1, backwardStep) %
-      (1.0 - gateActivation.submat(
-      outSize, backwardStep - batchStep, 2 * outSize - 1, backwardStep));
-
   g = input2GateWeight.t() * prevError;
 
   backwardStep -= batchSize;
@@ -246,17 +270,21 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void FastLSTM<InputDataType, OutputDataType>::Gradient(
     InputType&& input, ErrorType&& /* error */, GradientType&& gradient)
 {
-  // Gradient of the input to gate layer.
-  gradient.submat(0, 0, input2GateWeight.n_elem - 1, 0) =
-      arma::vectorise(prevError * input.t());
+  // Gradient of the input to gate layer, computed directly into the gradient.
+  OutputDataType inputGradient(gradient.memptr(), input2GateWeight.n_rows,
+      input2GateWeight.n_cols, false, true);
+  inputGradient = prevError * input.t();
 
   gradient.submat(input2GateWeight.n_elem, 0, input2GateWeight.n_elem +
       input2GateBias.n_elem - 1, 0) = arma::sum(prevError, 1);
 
   // Gradient of the output to gate layer.
-  gradient.submat(input2GateWeight.n_elem + input2GateBias.n_elem, 0,
-      gradient.n_elem - 1, 0) = arma::vectorise(prevError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
+  OutputDataType outputGradient(gradient.memptr() + input2GateWeight.n_elem +
+      input2GateBias.n_elem, output2GateWeight.n_rows, output2GateWeight.n_cols,
+      false, true);
+  const OutputDataType previousOutput(outParameter.colptr(gradientStep -
+      batchStep), outSize, batchSize, false, true);
+  outputGradient = prevError * previousOutput.t();
 
   if (gradientStep > batchStep)
   {
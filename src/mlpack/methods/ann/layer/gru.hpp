@@ -120,6 +120,15 @@ class GRU
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Resets the cell to accept the continuation of the previous input: like
+   * ResetCell(), this starts a new BPTT chain, but the first step starts from
+   * the last output of the previous steps instead of zeros.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
   //! Modify the value of the deterministic parameter.
@@ -220,6 +229,12 @@ class GRU
   //! Matrix of all zeroes to initialize the output
   arma::mat allZeros;
 
+  //! The last output produced by the cell.
+  arma::mat lastOutput;
+
+  //! Locally-stored pre-activations of the update and reset gates.
+  arma::mat gates;
+
   //! Iterator pointed to the last output produced by the cell
   std::list<arma::mat>::iterator prevOutput;
 
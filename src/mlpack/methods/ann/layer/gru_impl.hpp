@@ -123,18 +123,20 @@ void GRU<InputDataType, OutputDataType>::Forward(
       boost::apply_visitor(outputParameterVisitor, output2GateModule))),
       output2GateModule);
 
-  // Merge the outputs(zt and rt).
-  output = (boost::apply_visitor(outputParameterVisitor,
+  // Merge the outputs(zt and rt).  The merged gates are kept in a buffer of
+  // their own, so that the output (which has fewer rows) is not reallocated
+  // at each step.
+  gates = (boost::apply_visitor(outputParameterVisitor,
       input2GateModule).submat(0, 0, 2 * outSize - 1, batchSize - 1) +
       boost::apply_visitor(outputParameterVisitor, output2GateModule));
 
   // Pass the first outSize through inputGate(it).
-  boost::apply_visitor(ForwardVisitor(std::move(output.submat(
+  boost::apply_visitor(ForwardVisitor(std::move(gates.submat(
       0, 0, 1 * outSize - 1, batchSize - 1)), std::move(boost::apply_visitor(
       outputParameterVisitor, inputGateModule))), inputGateModule);
 
   // Pass the second through forgetGate.
-  boost::apply_visitor(ForwardVisitor(std::move(output.submat(
+  boost::apply_visitor(ForwardVisitor(std::move(gates.submat(
       1 * outSize, 0, 2 * outSize - 1, batchSize - 1)), std::move(
       boost::apply_visitor(outputParameterVisitor, forgetGateModule))),
       forgetGateModule);
@@ -165,6 +167,8 @@ void GRU<InputDataType, OutputDataType>::Forward(
       hiddenStateModule))) + boost::apply_visitor(outputParameterVisitor,
       hiddenStateModule);
 
+  lastOutput = output;
+
   forwardStep++;
   if (forwardStep == rho)
   {
@@ -244,7 +248,7 @@ void GRU<InputDataType, OutputDataType>::Backward(
       hiddenStateModule));
 
   // Delta ot.
-  arma::mat dOt = gy % (arma::ones<arma::mat>(outSize, batchSize) -
+  arma::mat dOt = gy % (1.0 -
       boost::apply_visitor(outputParameterVisitor, inputGateModule));
 
   // Delta of input gate.
@@ -295,13 +299,10 @@ void GRU<InputDataType, OutputDataType>::Backward(
       std::move(boost::apply_visitor(deltaVisitor, output2GateModule))),
       output2GateModule);
 
-  // Add delta ht - 1 from hidden state.
+  // Add delta ht - 1 from hidden state and from ht, in a single pass.
   boost::apply_visitor(deltaVisitor, output2GateModule) +=
       boost::apply_visitor(deltaVisitor, outputHidden2GateModule) %
-      boost::apply_visitor(outputParameterVisitor, forgetGateModule);
-
-  // Add delta ht - 1 from ht.
-  boost::apply_visitor(deltaVisitor, output2GateModule) += gy %
+      boost::apply_visitor(outputParameterVisitor, forgetGateModule) + gy %
       boost::apply_visitor(outputParameterVisitor, inputGateModule);
 
   // Get delta input.
@@ -381,6 +382,27 @@ void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
   backwardStep = 0;
 }
 
+template<typename InputDataType, typename OutputDataType>
+void GRU<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (lastOutput.n_rows != outSize || lastOutput.n_cols != batchSize)
+  {
+    ResetCell(size);
+    return;
+  }
+
+  ResetCell(size);
+
+  // Start from a copy of the last output; the all-zeros matrix must not be
+  // modified.
+  outParameter.clear();
+  outParameter.push_back(lastOutput);
+
+  prevOutput = outParameter.begin();
+  backIterator = outParameter.end();
+  gradIterator = outParameter.end();
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void GRU<InputDataType, OutputDataType>::serialize(
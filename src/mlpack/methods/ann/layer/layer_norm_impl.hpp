@@ -58,20 +58,38 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  mean = arma::mean(input, 0);
-  variance = arma::var(input, 1, 0);
+  mean.set_size(1, input.n_cols);
+  variance.set_size(1, input.n_cols);
+  normalized.set_size(input.n_rows, input.n_cols);
+  output.set_size(input.n_rows, input.n_cols);
 
-  // Normalize the input.
-  output = input.each_row() - mean;
-
-  output.each_row() /= arma::sqrt(variance + eps);
-
-  // Reused in the backward and gradient step.
-  normalized = output;
-
-  // Scale and shift the output.
-  output.each_col() %= gamma;
-  output.each_col() += beta;
+  for (size_t j = 0; j < input.n_cols; ++j)
+  {
+    const eT* x = input.colptr(j);
+
+    // Use Welford method to compute the mean and variance of the point in a
+    // single pass.
+    double pointMean = 0, pointVariance = 0;
+    for (size_t r = 0; r < input.n_rows; ++r)
+    {
+      const double delta = x[r] - pointMean;
+      pointMean += delta / (r + 1);
+      pointVariance += delta * (x[r] - pointMean);
+    }
+    mean[j] = pointMean;
+    variance[j] = pointVariance / input.n_rows;
+
+    // Normalize the input and scale and shift the output in one pass.  The
+    // normalized input is reused in the backward and gradient step.
+    const double stdInv = 1.0 / std::sqrt(variance[j] + eps);
+    auto* xhat = normalized.colptr(j);
+    eT* y = output.colptr(j);
+    for (size_t r = 0; r < input.n_rows; ++r)
+    {
+      xhat[r] = (x[r] - pointMean) * stdInv;
+      y[r] = gamma[r] * xhat[r] + beta[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -79,25 +97,34 @@ template<typename eT>
 void LayerNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_row() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
-
-  // dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
-
-  // sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 0) %
-      arma::pow(stdInv, 3.0) * -0.5;
+  const size_t m = input.n_rows;
+  g.set_size(gy.n_rows, gy.n_cols);
 
-  // dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
-  // dl / dmu * 1 / m.
-  g = (norm.each_row() % stdInv) + (inputMean.each_row() %
-      var * 2 / input.n_rows);
-
-  // sum (dl / dxhat * -1 / stdInv) + variance *
-  // (sum -2 * (x - mu)) / m.
-  g.each_row() += (arma::sum(norm.each_row() % -stdInv, 0) + (var %
-      arma::mean(-2 * inputMean, 0))) / input.n_rows;
+  for (size_t j = 0; j < gy.n_cols; ++j)
+  {
+    const eT* dy = gy.colptr(j);
+    const auto* xhat = normalized.colptr(j);
+    eT* dx = g.colptr(j);
+
+    // sum dl / dxhat and sum dl / dxhat * xhat, with dl / dxhat =
+    // dl / dy * gamma.
+    double sumNorm = 0, sumNormXhat = 0;
+    for (size_t r = 0; r < m; ++r)
+    {
+      const double norm = dy[r] * gamma[r];
+      sumNorm += norm;
+      sumNormXhat += norm * xhat[r];
+    }
+
+    // dl / dx = stdInv / m * (m * dl / dxhat - sum dl / dxhat -
+    // xhat * sum dl / dxhat * xhat).
+    const double scale = 1.0 / (std::sqrt(variance[j] + eps) * m);
+    for (size_t r = 0; r < m; ++r)
+    {
+      dx[r] = scale * (m * dy[r] * gamma[r] - sumNorm - xhat[r] *
+          sumNormXhat);
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -107,14 +134,22 @@ void LayerNorm<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient.set_size(size + size, 1);
+  gradient.zeros(size + size, 1);
 
-  // Step 5: dl / dy * xhat.
-  gradient.submat(0, 0, gamma.n_elem - 1, 0) = arma::sum(normalized % error, 1);
-
-  // Step 6: dl / dy.
-  gradient.submat(gamma.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+  // dl / dgamma = sum dl / dy * xhat and dl / dbeta = sum dl / dy, in one
+  // pass.
+  eT* gammaGrad = gradient.memptr();
+  eT* betaGrad = gradient.memptr() + size;
+  for (size_t j = 0; j < error.n_cols; ++j)
+  {
+    const eT* dy = error.colptr(j);
+    const auto* xhat = normalized.colptr(j);
+    for (size_t r = 0; r < size; ++r)
+    {
+      gammaGrad[r] += dy[r] * xhat[r];
+      betaGrad[r] += dy[r];
+    }
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
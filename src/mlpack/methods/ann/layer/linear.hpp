@@ -20,10 +20,26 @@
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
+//! The element-wise activations that can be fused into a Linear layer.
+enum FusedActivation
+{
+  NO_ACTIVATION,
+  RELU_ACTIVATION,
+  SIGMOID_ACTIVATION,
+  TANH_ACTIVATION,
+  LEAKY_RELU_ACTIVATION
+};
+
 /**
  * Implementation of the Linear layer class. The Linear class represents a
  * single layer of a neural network.
  *
+ * An element-wise activation can be fused into the layer with
+ * FuseActivation(), so that the layer computes f(Wx + b) without a separate
+ * activation layer: the bias and the activation are applied in the same pass
+ * over the output.  The derivative of the activation is computed from the
+ * output, so the fused layer can still be trained.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -88,6 +104,38 @@ class Linear
                 arma::Mat<eT>&& error,
                 arma::Mat<eT>&& gradient);
 
+  /**
+   * Fuse the given element-wise activation into the layer, which then computes
+   * f(Wx + b).
+   *
+   * @param activation The activation to apply to the output.
+   * @param alpha The slope of the negative part of a leaky ReLU, which must not
+   *     be negative.
+   */
+  void FuseActivation(const FusedActivation activation,
+                      const double alpha = 0.0);
+
+  /**
+   * Fold the given element-wise affine transformation of the output into the
+   * weights, so that the layer computes scale % (Wx + b) + shift.  This is
+   * only possible if no activation is fused.  The parameters must have been
+   * set (with Reset()).
+   *
+   * @param scale The scale of each output unit.
+   * @param shift The shift of each output unit.
+   */
+  void Fold(const OutputDataType& scale, const OutputDataType& shift);
+
+  //! Get the fused activation.
+  FusedActivation Activation() const { return activation; }
+  //! Get the slope of the negative part of a fused leaky ReLU.
+  double Alpha() const { return alpha; }
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -117,9 +165,21 @@ class Linear
    * Serialize the layer
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
+  /**
+   * Add the bias to the output and apply the fused activation, in a single
+   * pass.
+   */
+  template<typename eT, typename ActivationType>
+  void AddBias(arma::Mat<eT>& output, const ActivationType& function) const;
+
+  //! Compute the derivative of the fused activation from the output.
+  template<typename eT>
+  void Derivative(const arma::Mat<eT>& output,
+                  arma::Mat<eT>& derivative) const;
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -146,11 +206,30 @@ class Linear
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! Locally-stored fused activation.
+  FusedActivation activation;
+
+  //! Locally-stored slope of the negative part of a fused leaky ReLU.
+  double alpha;
 }; // class Linear
 
 } // namespace ann
 } // namespace mlpack
 
+//! Set the serialization version of the Linear class.
+namespace boost {
+namespace serialization {
+
+template<typename InputDataType, typename OutputDataType>
+struct version<mlpack::ann::Linear<InputDataType, OutputDataType>>
+{
+  BOOST_STATIC_CONSTANT(int, value = 1);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "linear_impl.hpp"
 
@@ -20,7 +20,9 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-Linear<InputDataType, OutputDataType>::Linear()
+Linear<InputDataType, OutputDataType>::Linear() :
+    activation(NO_ACTIVATION),
+    alpha(0.0)
 {
   // Nothing to do here.
 }
@@ -30,7 +32,9 @@ Linear<InputDataType, OutputDataType>::Linear(
     const size_t inSize,
     const size_t outSize) :
     inSize(inSize),
-    outSize(outSize)
+    outSize(outSize),
+    activation(NO_ACTIVATION),
+    alpha(0.0)
 {
   weights.set_size(outSize * inSize + outSize, 1);
 }
@@ -38,8 +42,8 @@ Linear<InputDataType, OutputDataType>::Linear(
 template<typename InputDataType, typename OutputDataType>
 void Linear<InputDataType, OutputDataType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
       outSize, 1, false, false);
 }
 
@@ -49,7 +53,27 @@ void Linear<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   output = weight * input;
-  output.each_col() += bias;
+
+  switch (activation)
+  {
+    case RELU_ACTIVATION:
+      AddBias(output, [](const eT x) { return std::max(x, eT(0)); });
+      break;
+    case SIGMOID_ACTIVATION:
+      AddBias(output, [](const eT x) { return 1.0 / (1.0 + std::exp(-x)); });
+      break;
+    case TANH_ACTIVATION:
+      AddBias(output, [](const eT x) { return std::tanh(x); });
+      break;
+    case LEAKY_RELU_ACTIVATION:
+    {
+      const eT slope = alpha;
+      AddBias(output, [slope](const eT x) { return std::max(x, slope * x); });
+      break;
+    }
+    default:
+      output.each_col() += bias;
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -57,7 +81,15 @@ template<typename eT>
 void Linear<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  g = weight.t() * gy;
+  if (activation == NO_ACTIVATION)
+  {
+    g = weight.t() * gy;
+    return;
+  }
+
+  arma::Mat<eT> derivative;
+  Derivative(outputParameter, derivative);
+  g = weight.t() * (gy % derivative);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -67,20 +99,127 @@ void Linear<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
+  if (activation == NO_ACTIVATION)
+  {
+    gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
+        error * input.t());
+    gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
+        arma::sum(error, 1);
+    return;
+  }
+
+  // The error is backpropagated through the fused activation first.
+  arma::Mat<eT> derivative;
+  Derivative(outputParameter, derivative);
+  derivative %= error;
+
   gradient.submat(0, 0, weight.n_elem - 1, 0) = arma::vectorise(
-      error * input.t());
+      derivative * input.t());
   gradient.submat(weight.n_elem, 0, gradient.n_elem - 1, 0) =
-      arma::sum(error, 1);
+      arma::sum(derivative, 1);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void Linear<InputDataType, OutputDataType>::FuseActivation(
+    const FusedActivation activation, const double alpha)
+{
+  if (alpha < 0.0)
+  {
+    Log::Fatal << "Linear::FuseActivation(): the slope of a fused leaky ReLU "
+        << "must not be negative!" << std::endl;
+  }
+
+  this->activation = activation;
+  this->alpha = alpha;
+}
+
+template<typename InputDataType, typename OutputDataType>
+void Linear<InputDataType, OutputDataType>::Fold(
+    const OutputDataType& scale, const OutputDataType& shift)
+{
+  if (activation != NO_ACTIVATION)
+  {
+    Log::Fatal << "Linear::Fold(): the output cannot be transformed after a "
+        << "fused activation!" << std::endl;
+  }
+
+  if (scale.n_elem != outSize || shift.n_elem != outSize)
+  {
+    Log::Fatal << "Linear::Fold(): the transformation has " << scale.n_elem
+        << " units, but the layer has " << outSize << " output units!"
+        << std::endl;
+  }
+
+  // weight and bias refer to the parameters, which are updated in place.
+  weight.each_col() %= arma::vectorise(scale);
+  bias %= arma::vectorise(scale);
+  bias += arma::vectorise(shift);
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT, typename ActivationType>
+void Linear<InputDataType, OutputDataType>::AddBias(
+    arma::Mat<eT>& output, const ActivationType& function) const
+{
+  const eT* b = bias.memptr();
+  for (size_t j = 0; j < output.n_cols; ++j)
+  {
+    eT* y = output.colptr(j);
+    for (size_t i = 0; i < output.n_rows; ++i)
+      y[i] = function(y[i] + b[i]);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void Linear<InputDataType, OutputDataType>::Derivative(
+    const arma::Mat<eT>& output, arma::Mat<eT>& derivative) const
+{
+  switch (activation)
+  {
+    case RELU_ACTIVATION:
+      derivative = arma::sign(output);
+      break;
+    case SIGMOID_ACTIVATION:
+      derivative = output % (1.0 - output);
+      break;
+    case TANH_ACTIVATION:
+      derivative = 1.0 - arma::square(output);
+      break;
+    case LEAKY_RELU_ACTIVATION:
+    {
+      // With a non-negative slope, the output is positive exactly when the
+      // input is.
+      const eT slope = alpha;
+      derivative = output;
+      derivative.transform([slope](const eT y) { return (y > 0) ? 1 : slope; });
+      break;
+    }
+    default:
+      derivative.ones(output.n_rows, output.n_cols);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType>
 template<typename Archive>
 void Linear<InputDataType, OutputDataType>::serialize(
-    Archive& ar, const unsigned int /* version */)
+    Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(inSize);
   ar & BOOST_SERIALIZATION_NVP(outSize);
 
+  // Earlier versions of the Linear layer had no fused activation.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(activation);
+    ar & BOOST_SERIALIZATION_NVP(alpha);
+  }
+  else if (Archive::is_loading::value)
+  {
+    activation = NO_ACTIVATION;
+    alpha = 0.0;
+  }
+
   // This is inefficient, but we have to allocate this memory so that
   // WeightSetVisitor gets the right size.
   if (Archive::is_loading::value)
@@ -87,6 +87,11 @@ class LinearNoBias
                 arma::Mat<eT>&& error,
                 arma::Mat<eT>&& gradient);
 
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
   //! Get the parameters.
   OutputDataType const& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -16,6 +16,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/ann/layer/layer_traits.hpp>
 
+#include "sparse_row_update.hpp"
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -23,6 +25,17 @@ namespace ann /** Artificial Neural Network. */ {
  * Implementation of the Lookup class. The Lookup class is a particular
  * convolution, where the width of the convolution is 1.
  *
+ * The gradient of the weights is only nonzero on the looked-up columns, which
+ * are kept (without duplicates) with their gradient by Gradient(), see
+ * SparseColumns() and SparseGradient().  For large tables, the layer can also
+ * be given a SparseRowUpdate: the looked-up columns are then updated by
+ * Gradient() itself, and the dense gradient is left zero, so that the
+ * optimizer of the network doesn't change the table (SGD and Adam leave
+ * parameters with zero gradient unchanged).  In that case the network must not
+ * be trained with more than one worker, since the workers would update the
+ * table concurrently, and gradient checks of the network don't apply to the
+ * table.
+ *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
@@ -44,6 +57,19 @@ class Lookup
    */
   Lookup(const size_t inSize = 0, const size_t outSize = 0);
 
+  /**
+   * Create the Lookup object using the specified number of input and output
+   * units, whose looked-up columns are updated with the given update during
+   * the gradient computation.
+   *
+   * @param inSize The number of input units.
+   * @param outSize The number of output units.
+   * @param update The update of the looked-up columns.
+   */
+  Lookup(const size_t inSize,
+         const size_t outSize,
+         const SparseRowUpdate<OutputDataType>& update);
+
   /**
    * Ordinary feed forward pass of a neural network, evaluating the function
    * f(x) by propagating the activity forward through f.
@@ -70,6 +96,9 @@ class Lookup
 
   /*
    * Calculate the gradient using the output delta and the input activation.
+   * Only the looked-up columns of the gradient are written; if a sparse update
+   * is used, they are applied to the weights instead, and the gradient is left
+   * zero.
    *
    * @param input The input parameter used for calculating the gradient.
    * @param error The calculated error.
@@ -100,6 +129,20 @@ class Lookup
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  //! Get the looked-up columns of the last gradient computation.
+  arma::uvec const& SparseColumns() const { return sparseColumns; }
+  //! Get the gradient of each of the looked-up columns.
+  OutputDataType const& SparseGradient() const { return sparseGradient; }
+
+  //! Get whether the looked-up columns are updated by Gradient().
+  bool SparseUpdate() const { return sparseUpdate; }
+  //! Modify whether the looked-up columns are updated by Gradient().
+  bool& SparseUpdate() { return sparseUpdate; }
+  //! Get the update of the looked-up columns.
+  SparseRowUpdate<OutputDataType> const& Update() const { return update; }
+  //! Modify the update of the looked-up columns.
+  SparseRowUpdate<OutputDataType>& Update() { return update; }
+
   /**
    * Serialize the layer
    */
@@ -124,6 +167,18 @@ class Lookup
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! The looked-up columns of the last gradient computation.
+  arma::uvec sparseColumns;
+
+  //! The gradient of each of the looked-up columns.
+  OutputDataType sparseGradient;
+
+  //! Whether the looked-up columns are updated by Gradient().
+  bool sparseUpdate;
+
+  //! The update of the looked-up columns.
+  SparseRowUpdate<OutputDataType> update;
 }; // class Lookup
 
 // Alias for using as embedding layer.
@@ -24,7 +24,21 @@ Lookup<InputDataType, OutputDataType>::Lookup(
     const size_t inSize,
     const size_t outSize) :
     inSize(inSize),
-    outSize(outSize)
+    outSize(outSize),
+    sparseUpdate(false)
+{
+  weights.set_size(outSize, inSize);
+}
+
+template <typename InputDataType, typename OutputDataType>
+Lookup<InputDataType, OutputDataType>::Lookup(
+    const size_t inSize,
+    const size_t outSize,
+    const SparseRowUpdate<OutputDataType>& update) :
+    inSize(inSize),
+    outSize(outSize),
+    sparseUpdate(true),
+    update(update)
 {
   weights.set_size(outSize, inSize);
 }
@@ -54,8 +68,34 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient = arma::zeros<arma::Mat<eT> >(weights.n_rows, weights.n_cols);
-  gradient.cols(arma::conv_to<arma::uvec>::from(input) - 1) = error;
+  // Sum the error of each looked-up column, which may be looked up several
+  // times.
+  const arma::uvec indices = arma::conv_to<arma::uvec>::from(input) - 1;
+  sparseColumns = arma::unique(indices);
+  sparseGradient.zeros(weights.n_rows, sparseColumns.n_elem);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t j = std::lower_bound(sparseColumns.begin(),
+        sparseColumns.end(), indices[i]) - sparseColumns.begin();
+    sparseGradient.col(j) += error.col(i);
+  }
+
+  // The network zeroes its gradient (which the gradient is an alias of) before
+  // each pass, so a sparse update only has to make sure it has the right size.
+  if (sparseUpdate)
+  {
+    if (gradient.n_rows != weights.n_rows ||
+        gradient.n_cols != weights.n_cols)
+      gradient.zeros(weights.n_rows, weights.n_cols);
+
+    update.Update(weights, sparseColumns, sparseGradient);
+    return;
+  }
+
+  // This zeroes the alias in place, without a temporary dense matrix.
+  gradient.zeros(weights.n_rows, weights.n_cols);
+  for (size_t j = 0; j < sparseColumns.n_elem; ++j)
+    gradient.col(sparseColumns[j]) = sparseGradient.col(j);
 }
 
 template<typename InputDataType, typename OutputDataType>
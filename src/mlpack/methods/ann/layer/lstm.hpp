@@ -114,6 +114,15 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Resets the cell to accept the continuation of the previous input: like
+   * ResetCell(), this starts a new BPTT chain, but the first step starts from
+   * the last output and cell state of the previous steps instead of zeros.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void CarryCell(const size_t size);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -279,6 +288,9 @@ class LSTM
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
+  //! Locally-stored cell state the first step starts from.
+  OutputDataType initialCell;
+
   //! Locally-stored forget gate error.
   OutputDataType forgetGateError;
 
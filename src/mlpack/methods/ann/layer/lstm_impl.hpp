@@ -91,6 +91,33 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // The first step starts from the zero state.
+  outParameter.cols(0, batchStep).zeros();
+  initialCell.zeros(outSize, batchSize);
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::CarryCell(const size_t size)
+{
+  if (batchSize == 0 || bpttSteps == 0 || cell.is_empty())
+  {
+    ResetCell(size);
+    return;
+  }
+
+  // Find the last step of the previous sequence; forwardStep wraps around to 0
+  // after bpttSteps steps.
+  const size_t steps = (forwardStep == 0) ? bpttSteps : forwardStep / batchSize;
+  const OutputDataType lastOutput = outParameter.cols(steps * batchSize,
+      steps * batchSize + batchStep);
+  const OutputDataType lastCell = cell.cols((steps - 1) * batchSize,
+      (steps - 1) * batchSize + batchStep);
+
+  ResetCell(size);
+
+  outParameter.cols(0, batchStep) = lastOutput;
+  initialCell = lastCell;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -173,6 +200,10 @@ void LSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
+  // The layer may be used without a call to ResetCell().
+  if (forwardStep == 0 && initialCell.n_cols != batchSize)
+    initialCell.zeros(outSize, batchSize);
+
   inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
       input + output2GateInputWeight * outParameter.cols(forwardStep,
       forwardStep + batchStep);
@@ -195,6 +226,14 @@ void LSTM<InputDataType, OutputDataType>::Forward(
         arma::repmat(cell2GateForgetWeight, 1, batchSize) %
         cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
   }
+  else
+  {
+    inputGate.cols(forwardStep, forwardStep + batchStep) +=
+        arma::repmat(cell2GateInputWeight, 1, batchSize) % initialCell;
+
+    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
+        arma::repmat(cell2GateForgetWeight, 1, batchSize) % initialCell;
+  }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
       (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
@@ -215,8 +254,10 @@ void LSTM<InputDataType, OutputDataType>::Forward(
   if (forwardStep == 0)
   {
     cell.cols(forwardStep, forwardStep + batchStep) =
-        inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
-        hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
+        forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
+        initialCell + inputGateActivation.cols(forwardStep, forwardStep +
+        batchStep) % hiddenLayerActivation.cols(forwardStep, forwardStep +
+        batchStep);
   }
   else
   {
@@ -292,7 +333,9 @@ void LSTM<InputDataType, OutputDataType>::Backward(
   }
   else
   {
-    forgetGateError.zeros();
+    forgetGateError = initialCell % cellError % (forgetGateActivation.cols(
+        backwardStep - batchStep, backwardStep) % (1.0 -
+        forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
   }
 
   inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
@@ -409,11 +452,11 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
   }
   else
   {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
+    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(forgetGateError % initialCell, 1);
     gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
+        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(inputGateError % initialCell, 1);
   }
 
   if (gradientStep == 0)
@@ -20,7 +20,8 @@ namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 template<typename InputDataType, typename OutputDataType>
-MaxPooling<InputDataType, OutputDataType>::MaxPooling()
+MaxPooling<InputDataType, OutputDataType>::MaxPooling() :
+    numPooled(0)
 {
   // Nothing to do here.
 }
@@ -39,14 +40,14 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
     outputHeight(0),
     deterministic(false),
     offset(0),
-    batchSize(0)
+    batchSize(0),
+    numPooled(0)
 {
   // Nothing to do here.
 }
@@ -58,8 +59,6 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -74,45 +73,55 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  // The input and output have the layout of the Convolution layer: each
+  // column of the batch holds inSize slices of width x height elements.
+  const size_t slices = batchSize * inSize;
+  const size_t inputElements = inputWidth * inputHeight;
+  const size_t outputElements = outputWidth * outputHeight;
+  output.set_size(outputElements * inSize, batchSize);
 
+  size_t* pooled = NULL;
   if (!deterministic)
   {
-    poolingIndices.push_back(outputTemp);
+    if (numPooled == poolingIndices.size())
+      poolingIndices.push_back(arma::Col<size_t>());
+    poolingIndices[numPooled].set_size(output.n_elem);
+    pooled = poolingIndices[numPooled].memptr();
+    ++numPooled;
   }
 
-  if (!reset)
-  {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
-
-    reset = true;
-  }
+  const eT* in = input.memptr();
+  eT* out = output.memptr();
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
   {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
+    const eT* sliceIn = in + s * inputElements;
+    for (size_t j = 0; j < outputHeight; ++j)
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
+      const size_t colBegin = std::min(j * dW, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + kH - offset, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const size_t rowBegin = std::min(i * dH, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + kW - offset, inputWidth);
+
+        // The first maximum in column-major order wins.
+        size_t best = rowBegin + colBegin * inputWidth;
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            if (sliceIn[r + c * inputWidth] > sliceIn[best])
+              best = r + c * inputWidth;
+
+        const size_t o = s * outputElements + i + j * outputWidth;
+        out[o] = sliceIn[best];
+        if (pooled)
+          pooled[o] = s * inputElements + best;
+      }
     }
   }
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
-
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
-  outSize = batchSize * inSize;
+  outSize = slices;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -120,21 +129,26 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize, false, false);
-
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
-
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  if (numPooled == 0)
+    throw std::logic_error("MaxPooling::Backward(): no pooling indices; was "
+        "the forward pass deterministic?");
+
+  const size_t inputElements = inputWidth * inputHeight;
+  const size_t outputElements = outputWidth * outputHeight;
+  g.zeros(inputElements * (outSize / batchSize), batchSize);
+
+  const size_t* pooled = poolingIndices[--numPooled].memptr();
+  const eT* error = gy.memptr();
+  eT* delta = g.memptr();
+
+  // The indices of each slice are in the slice, so the slices are
+  // independent.
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) outSize; ++s)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    for (size_t k = s * outputElements; k < (s + 1) * outputElements; ++k)
+      delta[pooled[k]] += error[k];
   }
-
-  poolingIndices.pop_back();
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
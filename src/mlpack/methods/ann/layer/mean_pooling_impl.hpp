@@ -58,8 +58,6 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
-      inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
   {
@@ -76,18 +74,41 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  // The input and output have the layout of the Convolution layer: each
+  // column of the batch holds inSize slices of width x height elements.
+  const size_t slices = batchSize * inSize;
+  const size_t inputElements = inputWidth * inputHeight;
+  const size_t outputElements = outputWidth * outputHeight;
+  output.set_size(outputElements * inSize, batchSize);
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  const eT* in = input.memptr();
+  eT* out = output.memptr();
 
-  output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
-      batchSize);
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) slices; ++s)
+  {
+    const eT* sliceIn = in + s * inputElements;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = std::min(j * dH, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + kH - offset, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const size_t rowBegin = std::min(i * dW, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + kW - offset, inputWidth);
+
+        eT sum = 0;
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            sum += sliceIn[r + c * inputWidth];
+
+        out[s * outputElements + i + j * outputWidth] = sum /
+            eT((colEnd - colBegin) * (rowEnd - rowBegin));
+      }
+    }
+  }
 
-  outputWidth = outputTemp.n_rows;
-  outputHeight = outputTemp.n_cols;
-  outSize = batchSize * inSize;
+  outSize = slices;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -97,18 +118,36 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
   arma::Mat<eT>&& gy,
   arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
-      outputHeight, outSize, false, false);
+  const size_t inputElements = inputWidth * inputHeight;
+  const size_t outputElements = outputWidth * outputHeight;
+  g.zeros(inputElements * (outSize / batchSize), batchSize);
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
-      inputTemp.n_cols, inputTemp.n_slices);
+  const eT* error = gy.memptr();
+  eT* delta = g.memptr();
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  // Each element of a window gets an equal share of the error of the window;
+  // the windows of a slice only overlap in that slice.
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) outSize; ++s)
   {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
+    eT* sliceDelta = delta + s * inputElements;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = std::min(j * dH, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + kH - offset, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const size_t rowBegin = std::min(i * dW, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + kW - offset, inputWidth);
+
+        const eT share = error[s * outputElements + i + j * outputWidth] /
+            eT((colEnd - colBegin) * (rowEnd - rowBegin));
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            sliceDelta[r + c * inputWidth] += share;
+      }
+    }
   }
-
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
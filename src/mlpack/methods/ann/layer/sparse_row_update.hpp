@@ -0,0 +1,142 @@
+/**
+ * @file sparse_row_update.hpp
+ *
+ * Definition of the SparseRowUpdate class, which updates only the columns of a
+ * weight matrix that have a gradient, for large embedding tables.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_ROW_UPDATE_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_ROW_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The SparseRowUpdate applies a gradient that is only nonzero on some columns
+ * of a weight matrix (each column is a row of the embedding table) to those
+ * columns only, with either plain SGD or a lazy form of Adam: the moment
+ * estimates of a column are only decayed and updated when it has a gradient,
+ * and the bias correction uses the number of updates so far.  So an update
+ * takes time proportional to the number of looked-up columns, not to the size
+ * of the table.
+ *
+ * @tparam MatType Type of the weight matrix.
+ */
+template<typename MatType = arma::mat>
+class SparseRowUpdate
+{
+ public:
+  /**
+   * Create the update with the given parameters.
+   *
+   * @param stepSize Step size of each update.
+   * @param adam If true, use lazy Adam; otherwise, use SGD.
+   * @param beta1 Exponential decay rate of the first moment estimates.
+   * @param beta2 Exponential decay rate of the second moment estimates.
+   * @param epsilon Value used to initialize the mean squared gradient
+   *     parameter.
+   */
+  SparseRowUpdate(const double stepSize = 0.01,
+                  const bool adam = false,
+                  const double beta1 = 0.9,
+                  const double beta2 = 0.999,
+                  const double epsilon = 1e-8) :
+      stepSize(stepSize),
+      adam(adam),
+      beta1(beta1),
+      beta2(beta2),
+      epsilon(epsilon),
+      iteration(0)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Update the given columns of the weights.
+   *
+   * @param weights Weights to update.
+   * @param columns Indices of the columns to update (without duplicates).
+   * @param gradient Gradient of each of the columns to update.
+   */
+  void Update(MatType& weights,
+              const arma::uvec& columns,
+              const MatType& gradient)
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    if (!adam)
+    {
+      #pragma omp parallel for
+      for (omp_size_t j = 0; j < (omp_size_t) columns.n_elem; ++j)
+        weights.col(columns[j]) -= ElemType(stepSize) * gradient.col(j);
+      return;
+    }
+
+    if (m.n_rows != weights.n_rows || m.n_cols != weights.n_cols)
+    {
+      m.zeros(weights.n_rows, weights.n_cols);
+      v.zeros(weights.n_rows, weights.n_cols);
+      iteration = 0;
+    }
+
+    ++iteration;
+    const double biasCorrection1 = 1.0 - std::pow(beta1, (double) iteration);
+    const double biasCorrection2 = 1.0 - std::pow(beta2, (double) iteration);
+    const ElemType step = ElemType(stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1);
+
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) columns.n_elem; ++j)
+    {
+      const size_t c = columns[j];
+      m.col(c) *= ElemType(beta1);
+      m.col(c) += ElemType(1.0 - beta1) * gradient.col(j);
+      v.col(c) *= ElemType(beta2);
+      v.col(c) += ElemType(1.0 - beta2) * arma::square(gradient.col(j));
+      weights.col(c) -= step * m.col(c) /
+          (arma::sqrt(v.col(c)) + ElemType(epsilon));
+    }
+  }
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get whether lazy Adam is used.
+  bool Adam() const { return adam; }
+  //! Modify whether lazy Adam is used.
+  bool& Adam() { return adam; }
+
+  //! Get the number of updates so far (only counted for Adam).
+  size_t Iteration() const { return iteration; }
+
+ private:
+  //! The step size of each update.
+  double stepSize;
+  //! Whether to use lazy Adam.
+  bool adam;
+  //! The decay rate of the first moment estimates.
+  double beta1;
+  //! The decay rate of the second moment estimates.
+  double beta2;
+  //! The value added to the denominator of the Adam step.
+  double epsilon;
+  //! The number of Adam updates so far.
+  size_t iteration;
+  //! The first moment estimates of each column.
+  MatType m;
+  //! The second moment estimates of each column.
+  MatType v;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,164 @@
+/**
+ * @file layer_profiler.hpp
+ *
+ * Definition of the LayerProfiler class, which times the passes through each
+ * layer of a network with the Timer subsystem.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+#define MLPACK_METHODS_ANN_LAYER_PROFILER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/layer_cost_visitor.hpp"
+#include "visitor/layer_name_visitor.hpp"
+
+#include <iomanip>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+//! The passes through a layer that are timed by the LayerProfiler.
+enum LayerPass
+{
+  FORWARD_PASS,
+  BACKWARD_PASS,
+  GRADIENT_PASS
+};
+
+/**
+ * The LayerProfiler times the Forward(), Backward() and Gradient() calls of
+ * each layer of a network, with one Timer per layer and pass (for instance
+ * "ffn_layer_2_forward"), and counts the floating point operations and the
+ * bytes of the dense products of the Linear and Convolution layers (see
+ * LayerCostVisitor) with the counters "ffn_layer_2_flops" and
+ * "ffn_layer_2_bytes".  The timers and counters are accumulated over all the
+ * passes, and Report() writes them as a table, one row per layer.
+ *
+ * Like every timer, these are only recorded while timing is enabled (see
+ * Timer::EnableTiming()).  Timers are specific to the thread they run on, so
+ * the layers of replicas run by other threads are timed separately.
+ */
+class LayerProfiler
+{
+ public:
+  /**
+   * Create the profiler, with the given prefix for the names of the timers
+   * and counters.  The profiler is disabled.
+   *
+   * @param prefix Prefix of the names of the timers (such as "ffn").
+   */
+  LayerProfiler(const std::string& prefix = "ffn") :
+      prefix(prefix), enabled(false) { }
+
+  //! Get whether the layers are profiled.
+  bool Enabled() const { return enabled; }
+  //! Modify whether the layers are profiled.
+  bool& Enabled() { return enabled; }
+
+  //! Get the prefix of the names of the timers and counters.
+  const std::string& Prefix() const { return prefix; }
+
+  /**
+   * Start the timer of the given pass through the given layer, if the
+   * profiler is enabled.
+   *
+   * @param layer Index of the layer in the network.
+   * @param pass The pass through the layer.
+   */
+  void Start(const size_t layer, const LayerPass pass) const
+  {
+    if (enabled)
+      Timer::Start(TimerName(layer, pass));
+  }
+
+  /**
+   * Stop the timer of the given pass through the given layer, and count the
+   * cost of the pass, if the profiler is enabled.
+   *
+   * @param layer Index of the layer in the network.
+   * @param pass The pass through the layer.
+   * @param module The layer (a LayerTypes variant).
+   */
+  template<typename ModuleType>
+  void Stop(const size_t layer,
+            const LayerPass pass,
+            const ModuleType& module) const
+  {
+    if (!enabled)
+      return;
+
+    Timer::Stop(TimerName(layer, pass));
+    const LayerCost cost = boost::apply_visitor(LayerCostVisitor(), module);
+    if (cost.flops > 0)
+    {
+      Timer::Count(CounterName(layer, "flops"), cost.flops);
+      Timer::Count(CounterName(layer, "bytes"), cost.bytes);
+    }
+  }
+
+  /**
+   * Write the timers and counters of each layer of the given network as a
+   * table: the type of the layer, the total time (in seconds) of each pass,
+   * and the floating point operations and bytes counted for the layer.
+   *
+   * @param network The layers of the network.
+   * @param stream Stream to write the table to.
+   */
+  template<typename ModuleType>
+  void Report(const std::vector<ModuleType>& network,
+              std::ostream& stream) const
+  {
+    stream << std::left << std::setw(6) << "layer" << std::setw(24) << "type"
+        << std::right << std::setw(12) << "forward" << std::setw(12)
+        << "backward" << std::setw(12) << "gradient" << std::setw(16)
+        << "flops" << std::setw(16) << "bytes" << std::endl;
+
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      stream << std::left << std::setw(6) << i << std::setw(24)
+          << boost::apply_visitor(LayerNameVisitor(), network[i])
+          << std::right << std::fixed << std::setprecision(6);
+      for (size_t p = 0; p < 3; ++p)
+      {
+        stream << std::setw(12) << Timer::Get(TimerName(i,
+            (LayerPass) p)).count() / 1e6;
+      }
+      stream << std::setw(16) << Timer::GetCount(CounterName(i, "flops"))
+          << std::setw(16) << Timer::GetCount(CounterName(i, "bytes"))
+          << std::endl;
+    }
+  }
+
+  //! Return the name of the timer of the given pass through the given layer.
+  std::string TimerName(const size_t layer, const LayerPass pass) const
+  {
+    static const char* passNames[] = { "forward", "backward", "gradient" };
+    std::ostringstream oss;
+    oss << prefix << "_layer_" << layer << "_" << passNames[pass];
+    return oss.str();
+  }
+
+  //! Return the name of the given counter of the given layer.
+  std::string CounterName(const size_t layer, const std::string& name) const
+  {
+    std::ostringstream oss;
+    oss << prefix << "_layer_" << layer << "_" << name;
+    return oss.str();
+  }
+
+ private:
+  //! The prefix of the names of the timers and counters.
+  std::string prefix;
+  //! Whether the layers are profiled.
+  bool enabled;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,189 @@
+/**
+ * @file memory_planner.hpp
+ *
+ * Definition of the MemoryPlanner class, which assigns buffers with known
+ * lifetimes to a shared arena, and of the NetworkMemoryPlan class, which plans
+ * the activations and deltas of a sequential network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MEMORY_PLANNER_HPP
+#define MLPACK_METHODS_ANN_MEMORY_PLANNER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The MemoryPlanner assigns buffers to offsets in a shared arena, so that two
+ * buffers share memory only if they are never live at the same time.  Each
+ * buffer is given with its size and the first and last steps (inclusive) at
+ * which it is used; the buffers are then placed greedily in order of first use,
+ * in the free slot that fits best.  Since the lifetimes are intervals, this
+ * uses the minimum number of slots.
+ *
+ * The sizes are counted per point of the batch: a buffer of size s holds
+ * s * batchSize elements at offset Offset() * batchSize, so one plan serves
+ * every batch size.
+ *
+ * @code
+ * MemoryPlanner planner;
+ * const size_t a = planner.Add(10, 0, 1);
+ * const size_t b = planner.Add(20, 1, 2);
+ * const size_t c = planner.Add(10, 2, 3); // c can reuse the memory of a.
+ * planner.Plan();
+ * @endcode
+ */
+class MemoryPlanner
+{
+ public:
+  //! Create an empty plan.
+  MemoryPlanner() : arenaSize(0), totalSize(0) { }
+
+  /**
+   * Add a buffer to the plan.  Plan() has to be called before the offsets can
+   * be used.
+   *
+   * @param size Number of elements of the buffer for each point.
+   * @param first First step at which the buffer is used.
+   * @param last Last step at which the buffer is used.
+   * @return The index of the buffer.
+   */
+  size_t Add(const size_t size, const size_t first, const size_t last);
+
+  //! Extend the lifetime of the given buffer to the given step.
+  void Use(const size_t buffer, const size_t step);
+
+  //! Assign the buffers to offsets in the arena.
+  void Plan();
+
+  //! Forget all the buffers.
+  void Clear();
+
+  //! Get the number of buffers.
+  size_t Buffers() const { return sizes.size(); }
+  //! Get the size of the given buffer, per point.
+  size_t Size(const size_t buffer) const { return sizes[buffer]; }
+  //! Get the offset of the given buffer in the arena, per point.
+  size_t Offset(const size_t buffer) const { return offsets[buffer]; }
+  //! Get the first step of the given buffer.
+  size_t First(const size_t buffer) const { return first[buffer]; }
+  //! Get the last step of the given buffer.
+  size_t Last(const size_t buffer) const { return last[buffer]; }
+
+  //! Get the size of the arena, per point.
+  size_t ArenaSize() const { return arenaSize; }
+  //! Get the total size of the buffers without any sharing, per point.
+  size_t TotalSize() const { return totalSize; }
+
+ private:
+  //! The size of each buffer.
+  std::vector<size_t> sizes;
+  //! The first step of each buffer.
+  std::vector<size_t> first;
+  //! The last step of each buffer.
+  std::vector<size_t> last;
+  //! The offset of each buffer.
+  std::vector<size_t> offsets;
+  //! The size of the arena.
+  size_t arenaSize;
+  //! The total size of the buffers.
+  size_t totalSize;
+};
+
+/**
+ * The plan of the buffers of a sequential network for one kind of pass.  The
+ * pass is a list of steps: a forward step computes the output of a layer, and
+ * a backward step computes the delta of a layer (except the first one) and
+ * then its gradient, so the delta of the next layer is no longer needed
+ * afterwards.  The liveness of each output and delta over the steps is used to
+ * plan them in a MemoryPlanner.
+ *
+ * For an inference pass, only two outputs are live at the same time.  For a
+ * training pass, all the outputs are needed by the backward steps, but only two
+ * deltas are live at the same time.  With a checkpoint interval k > 0, only the
+ * outputs of every k-th layer (and those of the last segment) are kept during
+ * the training pass; the outputs of each other segment are computed again from
+ * its checkpoint just before the segment is passed backward.  This reduces the
+ * memory of the outputs from n to about n / k + k buffers, at the cost of up to
+ * one more forward pass.
+ */
+class NetworkMemoryPlan
+{
+ public:
+  //! A step of the pass.
+  struct Step
+  {
+    //! Whether this is a forward step (or a backward step).
+    bool forward;
+    //! The layer of the step.
+    size_t layer;
+    //! The buffer written by the step (the output of the layer for a forward
+    //! step, its delta for a backward step), or NoBuffer().
+    size_t buffer;
+  };
+
+  //! Create an empty plan.
+  NetworkMemoryPlan() : layers(0), training(false), checkpointInterval(0),
+      forwardSteps(0) { }
+
+  /**
+   * Plan a pass through a network with layers of the given output sizes.  The
+   * delta of each layer is assumed to have the size of its input.
+   *
+   * @param outputRows Number of rows of the output of each layer.
+   * @param training Whether the pass has backward steps.
+   * @param checkpointInterval Interval between the kept outputs in a training
+   *     pass, or 0 to keep all of them.
+   */
+  void Plan(const std::vector<size_t>& outputRows,
+            const bool training,
+            const size_t checkpointInterval);
+
+  //! Forget the plan.
+  void Clear();
+
+  //! Get the steps of the pass.
+  const std::vector<Step>& Steps() const { return steps; }
+  //! Get the number of steps of the forward phase, before the output layer.
+  size_t ForwardSteps() const { return forwardSteps; }
+  //! Get the plan of the buffers.
+  const MemoryPlanner& Planner() const { return planner; }
+
+  //! Get the number of layers of the planned network (0 if nothing is
+  //! planned).
+  size_t Layers() const { return layers; }
+  //! Get whether the pass has backward steps.
+  bool Training() const { return training; }
+  //! Get the checkpoint interval of the plan.
+  size_t CheckpointInterval() const { return checkpointInterval; }
+
+  //! The buffer index of the steps that write no buffer.
+  static size_t NoBuffer() { return size_t(-1); }
+
+ private:
+  //! The steps of the pass.
+  std::vector<Step> steps;
+  //! The plan of the buffers.
+  MemoryPlanner planner;
+  //! The number of layers.
+  size_t layers;
+  //! Whether the pass has backward steps.
+  bool training;
+  //! The checkpoint interval.
+  size_t checkpointInterval;
+  //! The number of steps of the forward phase.
+  size_t forwardSteps;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "memory_planner_impl.hpp"
+
+#endif
@@ -0,0 +1,213 @@
+/**
+ * @file memory_planner_impl.hpp
+ *
+ * Implementation of the MemoryPlanner and NetworkMemoryPlan classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_MEMORY_PLANNER_IMPL_HPP
+#define MLPACK_METHODS_ANN_MEMORY_PLANNER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "memory_planner.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+inline size_t MemoryPlanner::Add(const size_t size,
+                                 const size_t first,
+                                 const size_t last)
+{
+  sizes.push_back(size);
+  this->first.push_back(first);
+  this->last.push_back(std::max(first, last));
+  offsets.push_back(0);
+  totalSize += size;
+
+  return sizes.size() - 1;
+}
+
+inline void MemoryPlanner::Use(const size_t buffer, const size_t step)
+{
+  last[buffer] = std::max(last[buffer], step);
+}
+
+inline void MemoryPlanner::Plan()
+{
+  std::vector<size_t> order(sizes.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+      [this](const size_t a, const size_t b) { return first[a] < first[b]; });
+
+  // Each slot holds one live buffer at a time; a slot is free for a buffer if
+  // the last buffer in it died before the buffer is first used.
+  std::vector<size_t> slotSizes, slotLast, slots(sizes.size());
+  for (size_t j = 0; j < order.size(); ++j)
+  {
+    const size_t b = order[j];
+    size_t best = slotSizes.size();
+    for (size_t s = 0; s < slotSizes.size(); ++s)
+    {
+      if (slotLast[s] >= first[b])
+        continue;
+
+      if (best == slotSizes.size())
+      {
+        best = s;
+        continue;
+      }
+
+      // Take the smallest free slot that is large enough, or else the largest
+      // free slot, which has to grow the least.
+      const bool fits = (slotSizes[s] >= sizes[b]);
+      const bool bestFits = (slotSizes[best] >= sizes[b]);
+      if ((fits && (!bestFits || slotSizes[s] < slotSizes[best])) ||
+          (!fits && !bestFits && slotSizes[s] > slotSizes[best]))
+        best = s;
+    }
+
+    if (best == slotSizes.size())
+    {
+      slotSizes.push_back(0);
+      slotLast.push_back(0);
+    }
+
+    slotSizes[best] = std::max(slotSizes[best], sizes[b]);
+    slotLast[best] = last[b];
+    slots[b] = best;
+  }
+
+  std::vector<size_t> slotOffsets(slotSizes.size());
+  arenaSize = 0;
+  for (size_t s = 0; s < slotSizes.size(); ++s)
+  {
+    slotOffsets[s] = arenaSize;
+    arenaSize += slotSizes[s];
+  }
+
+  for (size_t b = 0; b < sizes.size(); ++b)
+    offsets[b] = slotOffsets[slots[b]];
+}
+
+inline void MemoryPlanner::Clear()
+{
+  sizes.clear();
+  first.clear();
+  last.clear();
+  offsets.clear();
+  arenaSize = 0;
+  totalSize = 0;
+}
+
+inline void NetworkMemoryPlan::Plan(const std::vector<size_t>& outputRows,
+                                    const bool training,
+                                    const size_t checkpointInterval)
+{
+  Clear();
+  const size_t n = outputRows.size();
+  if (n == 0)
+    return;
+
+  layers = n;
+  this->training = training;
+  this->checkpointInterval = checkpointInterval;
+
+  Step step;
+  step.buffer = NoBuffer();
+  step.forward = true;
+  for (size_t i = 0; i < n; ++i)
+  {
+    step.layer = i;
+    steps.push_back(step);
+  }
+  forwardSteps = n;
+
+  if (training)
+  {
+    const size_t interval = (checkpointInterval == 0) ? n : checkpointInterval;
+    const size_t segments = (n + interval - 1) / interval;
+    for (size_t s = segments; s > 0; --s)
+    {
+      const size_t begin = (s - 1) * interval;
+      const size_t end = std::min(s * interval, n) - 1;
+
+      // The outputs of the last segment are still there from the forward
+      // phase; those of the other segments are computed again from the
+      // previous checkpoint.  The last output of a segment is its checkpoint.
+      step.forward = true;
+      if (s < segments)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          step.layer = i;
+          steps.push_back(step);
+        }
+      }
+
+      step.forward = false;
+      for (size_t i = end + 1; i > begin; --i)
+      {
+        step.layer = i - 1;
+        steps.push_back(step);
+      }
+    }
+  }
+
+  // Find the lifetime of each version of the outputs and deltas.
+  std::vector<size_t> output(n, NoBuffer()), delta(n, NoBuffer());
+  for (size_t t = 0; t < steps.size(); ++t)
+  {
+    const size_t i = steps[t].layer;
+    if (steps[t].forward)
+    {
+      if (i > 0)
+        planner.Use(output[i - 1], t);
+
+      output[i] = planner.Add(outputRows[i], t, t);
+      steps[t].buffer = output[i];
+    }
+    else
+    {
+      // The backward step of the layer reads its output and the delta of the
+      // next layer, and its gradient reads its input.
+      planner.Use(output[i], t);
+      if (i > 0)
+        planner.Use(output[i - 1], t);
+      if (i + 1 < n)
+        planner.Use(delta[i + 1], t);
+
+      if (i > 0)
+      {
+        delta[i] = planner.Add(outputRows[i - 1], t, t);
+        steps[t].buffer = delta[i];
+      }
+    }
+  }
+
+  // The output of the last layer is read by the output layer, and the delta of
+  // the second layer may be read once the pass is over.
+  planner.Use(output[n - 1], steps.size());
+  if (n > 1 && delta[1] != NoBuffer())
+    planner.Use(delta[1], steps.size());
+
+  planner.Plan();
+}
+
+inline void NetworkMemoryPlan::Clear()
+{
+  steps.clear();
+  planner.Clear();
+  layers = 0;
+  training = false;
+  checkpointInterval = 0;
+  forwardSteps = 0;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
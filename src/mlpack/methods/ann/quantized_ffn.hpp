@@ -0,0 +1,253 @@
+/**
+ * @file quantized_ffn.hpp
+ *
+ * Definition of the QuantizedFFN class, which runs the inference of a trained
+ * feed forward network with int8 weights and activations for the Linear,
+ * LinearNoBias and Convolution layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_FFN_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The accuracy of a quantized network compared with the float network it was
+ * made from, as given by QuantizedFFN::Report().
+ */
+struct QuantizationReport
+{
+  //! The largest absolute difference between the quantized and float outputs.
+  double maxError;
+  //! The mean absolute difference between the quantized and float outputs.
+  double meanError;
+  //! The Frobenius norm of the difference of the outputs, relative to that of
+  //! the float outputs.
+  double relativeError;
+  //! The fraction of points whose largest output has the same index in the
+  //! quantized and float outputs (for classifiers, the fraction of points
+  //! given the same class).
+  double agreement;
+  //! The Frobenius norm of the error of the quantized weights of each
+  //! quantized layer, relative to that of the float weights.
+  arma::vec weightErrors;
+};
+
+/**
+ * Post-training int8 quantization of a feed forward network.  The network is
+ * copied, and a calibration set is passed forward through it in float to find
+ * the largest magnitude of the input of each Linear, LinearNoBias and
+ * Convolution layer.  The weights of these layers are then quantized
+ * symmetrically to int8, with one scale per layer or one per output unit (or
+ * output map), and their inputs are quantized with the calibrated scale of the
+ * layer.  At inference time each of these layers computes its matrix product
+ * (or the product of its filters with the im2col patches of its input) in
+ * int8 with int32 accumulation, and then dequantizes the result and adds the
+ * bias (and the fused activation of the Linear layer, if any).  All the other
+ * layers are computed in float on the dequantized outputs.
+ *
+ * The quantized layers read one byte per weight instead of eight, which is
+ * what bounds the inference of large layers.  The float network is kept, both
+ * for the layers that are not quantized and for Report(), which compares the
+ * quantized outputs with the float ones.
+ *
+ * @code
+ * FFN<> model;
+ * // ... build and train the model ...
+ *
+ * QuantizedFFN<> quantized(model, calibrationData);
+ * arma::mat predictions;
+ * quantized.Predict(testData, predictions);
+ * QuantizationReport report = quantized.Report(testData);
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type of the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam CustomLayers Any set of custom layers that could be a part of the
+ *         network.
+ */
+template<
+  typename OutputLayerType = NegativeLogLikelihood<>,
+  typename InitializationRuleType = RandomInitialization,
+  typename... CustomLayers
+>
+class QuantizedFFN
+{
+ public:
+  //! The type of the float network.
+  typedef FFN<OutputLayerType, InitializationRuleType, CustomLayers...>
+      NetworkType;
+
+  //! Create an empty quantized network; Quantize() must be called before it
+  //! can be used.
+  QuantizedFFN();
+
+  /**
+   * Quantize the given network, calibrating the scales of the inputs of the
+   * quantized layers on the given data.
+   *
+   * @param network The trained float network.
+   * @param calibrationData Representative input points (one per column).
+   * @param perChannel Whether each output unit (or map) of a layer has its own
+   *     weight scale, rather than one scale for the whole layer.
+   */
+  QuantizedFFN(const NetworkType& network,
+               const arma::mat& calibrationData,
+               const bool perChannel = true);
+
+  /**
+   * Quantize the given network, calibrating the scales of the inputs of the
+   * quantized layers on the given data.  Any earlier quantized network is
+   * replaced.
+   *
+   * @param network The trained float network.
+   * @param calibrationData Representative input points (one per column).
+   * @param perChannel Whether each output unit (or map) of a layer has its own
+   *     weight scale, rather than one scale for the whole layer.
+   */
+  void Quantize(const NetworkType& network,
+                const arma::mat& calibrationData,
+                const bool perChannel = true);
+
+  /**
+   * Predict the responses to the given points with the quantized network.
+   *
+   * @param predictors Input points (one per column).
+   * @param results Matrix to store the outputs of the network in.
+   */
+  void Predict(const arma::mat& predictors, arma::mat& results);
+
+  /**
+   * Compare the outputs of the quantized network on the given points with
+   * those of the float network.
+   *
+   * @param predictors Input points (one per column).
+   * @return The accuracy of the quantized network.
+   */
+  QuantizationReport Report(const arma::mat& predictors);
+
+  //! Get the float network.
+  const NetworkType& Network() const { return network; }
+
+  //! Get whether the weights have one scale per output unit.
+  bool PerChannel() const { return perChannel; }
+
+  //! Get the number of quantized layers.
+  size_t QuantizedLayers() const { return layers.size(); }
+
+  //! Get the number of bytes of the int8 weights of the quantized layers.
+  size_t WeightBytes() const;
+
+  //! Serialize the quantized network.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The int8 weights and the scales of a quantized layer.
+  struct QuantizedLayer
+  {
+    //! The index of the layer in the network.
+    size_t layer;
+    //! Whether the layer is a Convolution (or else a Linear or LinearNoBias).
+    bool convolution;
+    //! The length of the dot product of each output: the number of inputs of
+    //! a linear layer, or the size of the filters of all the input maps.
+    size_t inRows;
+    //! The number of output units (or maps).
+    size_t outRows;
+    //! The weights of each output unit (or map), one after the other.
+    std::vector<int8_t> weights;
+    //! The scale of the weights of each output unit (or map).
+    arma::vec weightScales;
+    //! The bias of each output unit (or map); empty for LinearNoBias.
+    arma::vec bias;
+    //! The scale of the input.
+    double inputScale;
+    //! The activation fused into a Linear layer.
+    FusedActivation activation;
+    //! The slope of the negative part of a fused leaky ReLU.
+    double alpha;
+    //! The relative error of the quantized weights.
+    double weightError;
+
+    //! The shape of a Convolution: the number of input maps, the kernel size,
+    //! the strides, the padding and the input and output sizes of each map.
+    size_t inMaps, kW, kH, dW, dH, padW, padH;
+    size_t inputWidth, inputHeight, outputWidth, outputHeight;
+
+    //! Serialize the layer.
+    template<typename Archive>
+    void serialize(Archive& ar, const unsigned int /* version */);
+  };
+
+  /**
+   * Pass the given points through the network, with the quantized layers in
+   * int8 or all the layers in float.  If maxInputs is given, the largest
+   * magnitude of the input of each layer is stored in it.
+   */
+  void Forward(const arma::mat& predictors,
+               arma::mat& results,
+               const bool quantized,
+               std::vector<double>* maxInputs = NULL);
+
+  /**
+   * Quantize the given layer of the network, if it is a Linear, LinearNoBias
+   * or Convolution layer.
+   *
+   * @return Whether the layer was quantized.
+   */
+  bool QuantizeLayer(const size_t index,
+                     const double maxInput,
+                     QuantizedLayer& layer);
+
+  //! Quantize the given float weights of each output unit (stored one unit
+  //! after the other) into the given layer.
+  void QuantizeWeights(const arma::mat& weights, QuantizedLayer& layer) const;
+
+  //! Compute the output of a quantized layer.
+  void QuantizedForward(const QuantizedLayer& layer,
+                        const arma::mat& input,
+                        arma::mat& output) const;
+
+  //! Quantize the given values with the given scale.
+  static void QuantizeValues(const double* values,
+                             const size_t n,
+                             const double scale,
+                             int8_t* quantized);
+
+  /**
+   * Compute the int8 matrix product c = a^T b with int32 accumulation, where
+   * each of the m columns of a and the n columns of b holds k contiguous
+   * values, and c is m x n (column-major).
+   */
+  static void Int8Gemm(const int8_t* a,
+                       const int8_t* b,
+                       const size_t k,
+                       const size_t m,
+                       const size_t n,
+                       int32_t* c);
+
+  //! The float network.
+  NetworkType network;
+  //! Whether the weights have one scale per output unit.
+  bool perChannel;
+  //! The quantized layers, in the order of the network.
+  std::vector<QuantizedLayer> layers;
+}; // class QuantizedFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_ffn_impl.hpp"
+
+#endif
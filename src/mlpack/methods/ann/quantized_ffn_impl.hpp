@@ -0,0 +1,527 @@
+/**
+ * @file quantized_ffn_impl.hpp
+ *
+ * Implementation of the QuantizedFFN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZED_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_QUANTIZED_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantized_ffn.hpp"
+
+#include "visitor/forward_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+QuantizedFFN<OutputLayerType, InitializationRuleType,
+             CustomLayers...>::QuantizedFFN() :
+    perChannel(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+QuantizedFFN<OutputLayerType, InitializationRuleType,
+             CustomLayers...>::QuantizedFFN(const NetworkType& network,
+                                            const arma::mat& calibrationData,
+                                            const bool perChannel) :
+    perChannel(perChannel)
+{
+  Quantize(network, calibrationData, perChannel);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::Quantize(const NetworkType& network,
+                                             const arma::mat& calibrationData,
+                                             const bool perChannel)
+{
+  if (calibrationData.n_cols == 0)
+  {
+    Log::Fatal << "QuantizedFFN::Quantize(): the calibration set must not be "
+        << "empty!" << std::endl;
+  }
+
+  this->network = network;
+  this->perChannel = perChannel;
+  layers.clear();
+
+  // Predicting one point puts the layers in deterministic mode and sets the
+  // input sizes of the convolutional layers.
+  arma::mat results;
+  this->network.Predict(calibrationData.col(0), results);
+
+  std::vector<double> maxInputs;
+  Forward(calibrationData, results, false, &maxInputs);
+
+  for (size_t i = 0; i < maxInputs.size(); ++i)
+  {
+    QuantizedLayer layer;
+    if (QuantizeLayer(i, maxInputs[i], layer))
+      layers.push_back(std::move(layer));
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::Predict(const arma::mat& predictors,
+                                            arma::mat& results)
+{
+  Forward(predictors, results, true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+QuantizationReport QuantizedFFN<OutputLayerType, InitializationRuleType,
+                                CustomLayers...>::Report(
+    const arma::mat& predictors)
+{
+  if (predictors.n_cols == 0)
+  {
+    Log::Fatal << "QuantizedFFN::Report(): there are no points to compare!"
+        << std::endl;
+  }
+
+  arma::mat floatResults, quantizedResults;
+  Forward(predictors, floatResults, false);
+  Forward(predictors, quantizedResults, true);
+
+  QuantizationReport report;
+  const arma::mat difference = quantizedResults - floatResults;
+  report.maxError = arma::abs(difference).max();
+  report.meanError = arma::mean(arma::abs(arma::vectorise(difference)));
+
+  const double norm = arma::norm(floatResults, "fro");
+  report.relativeError = (norm > 0.0) ?
+      (arma::norm(difference, "fro") / norm) : 0.0;
+
+  size_t agreeing = 0;
+  for (size_t j = 0; j < floatResults.n_cols; ++j)
+  {
+    if (floatResults.col(j).index_max() == quantizedResults.col(j).index_max())
+      ++agreeing;
+  }
+  report.agreement = (double) agreeing / floatResults.n_cols;
+
+  report.weightErrors.set_size(layers.size());
+  for (size_t i = 0; i < layers.size(); ++i)
+    report.weightErrors[i] = layers[i].weightError;
+
+  return report;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t QuantizedFFN<OutputLayerType, InitializationRuleType,
+                    CustomLayers...>::WeightBytes() const
+{
+  size_t bytes = 0;
+  for (size_t i = 0; i < layers.size(); ++i)
+    bytes += layers[i].weights.size();
+
+  return bytes;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::Forward(const arma::mat& predictors,
+                                            arma::mat& results,
+                                            const bool quantized,
+                                            std::vector<double>* maxInputs)
+{
+  std::vector<LayerTypes<CustomLayers...> >& model = network.Model();
+  if (model.empty())
+  {
+    Log::Fatal << "QuantizedFFN::Predict(): the network has not been "
+        << "quantized!" << std::endl;
+  }
+
+  if (maxInputs)
+    maxInputs->assign(model.size(), 0.0);
+
+  // The layers don't modify their input, so the predictors can be used
+  // directly; the outputs of the layers alternate between two buffers.
+  arma::mat input(const_cast<double*>(predictors.memptr()), predictors.n_rows,
+      predictors.n_cols, false, true);
+  arma::mat buffers[2];
+  size_t next = 0;
+  for (size_t i = 0; i < model.size(); ++i)
+  {
+    arma::mat& layerInput = (i == 0) ? input : buffers[(i + 1) % 2];
+    arma::mat& layerOutput = buffers[i % 2];
+
+    if (maxInputs && !layerInput.is_empty())
+      (*maxInputs)[i] = arma::abs(layerInput).max();
+
+    if (quantized && next < layers.size() && layers[next].layer == i)
+    {
+      QuantizedForward(layers[next], layerInput, layerOutput);
+      ++next;
+    }
+    else
+    {
+      boost::apply_visitor(ForwardVisitor(std::move(layerInput),
+          std::move(layerOutput)), model[i]);
+    }
+  }
+
+  results = std::move(buffers[(model.size() - 1) % 2]);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::QuantizeLayer(const size_t index,
+                                                  const double maxInput,
+                                                  QuantizedLayer& layer)
+{
+  LayerTypes<CustomLayers...>& model = network.Model()[index];
+
+  layer.layer = index;
+  layer.convolution = false;
+  layer.inputScale = (maxInput > 0.0) ? (maxInput / 127.0) : 1.0;
+  layer.activation = NO_ACTIVATION;
+  layer.alpha = 0.0;
+  layer.inMaps = layer.kW = layer.kH = layer.dW = layer.dH = 0;
+  layer.padW = layer.padH = 0;
+  layer.inputWidth = layer.inputHeight = 0;
+  layer.outputWidth = layer.outputHeight = 0;
+
+  // The weights of a linear layer are stored by column, so they have to be
+  // transposed to have the weights of each output unit next to each other.
+  if (Linear<>** linear = boost::get<Linear<>*>(&model))
+  {
+    const arma::mat& parameters = (*linear)->Parameters();
+    const size_t inSize = (*linear)->InputSize();
+    const size_t outSize = (*linear)->OutputSize();
+
+    layer.inRows = inSize;
+    layer.outRows = outSize;
+    QuantizeWeights(arma::trans(arma::reshape(
+        parameters.rows(0, inSize * outSize - 1), outSize, inSize)), layer);
+    layer.bias = parameters.rows(inSize * outSize,
+        inSize * outSize + outSize - 1);
+    layer.activation = (*linear)->Activation();
+    layer.alpha = (*linear)->Alpha();
+    return true;
+  }
+
+  if (LinearNoBias<>** linear = boost::get<LinearNoBias<>*>(&model))
+  {
+    const arma::mat& parameters = (*linear)->Parameters();
+    const size_t inSize = (*linear)->InputSize();
+    const size_t outSize = (*linear)->OutputSize();
+
+    layer.inRows = inSize;
+    layer.outRows = outSize;
+    QuantizeWeights(arma::trans(arma::reshape(
+        parameters.rows(0, inSize * outSize - 1), outSize, inSize)), layer);
+    layer.bias.clear();
+    return true;
+  }
+
+  // The filters of each output map are stored one input map after the other,
+  // so they already are next to each other.
+  if (Convolution<>** convolution = boost::get<Convolution<>*>(&model))
+  {
+    const arma::mat& parameters = (*convolution)->Parameters();
+    layer.convolution = true;
+    layer.inMaps = (*convolution)->InputSize();
+    layer.kW = (*convolution)->KernelWidth();
+    layer.kH = (*convolution)->KernelHeight();
+    layer.dW = (*convolution)->StrideWidth();
+    layer.dH = (*convolution)->StrideHeight();
+    layer.padW = (*convolution)->PadWidth();
+    layer.padH = (*convolution)->PadHeight();
+    layer.inputWidth = (*convolution)->InputWidth();
+    layer.inputHeight = (*convolution)->InputHeight();
+    layer.outputWidth = (*convolution)->OutputWidth();
+    layer.outputHeight = (*convolution)->OutputHeight();
+
+    layer.inRows = layer.inMaps * layer.kW * layer.kH;
+    layer.outRows = (*convolution)->OutputSize();
+    const size_t filters = layer.inRows * layer.outRows;
+    QuantizeWeights(arma::reshape(parameters.rows(0, filters - 1),
+        layer.inRows, layer.outRows), layer);
+    layer.bias = parameters.rows(filters, filters + layer.outRows - 1);
+    return true;
+  }
+
+  return false;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::QuantizeWeights(const arma::mat& weights,
+                                                    QuantizedLayer& layer) const
+{
+  layer.weightScales.set_size(weights.n_cols);
+  if (perChannel)
+  {
+    for (size_t i = 0; i < weights.n_cols; ++i)
+      layer.weightScales[i] = arma::abs(weights.col(i)).max() / 127.0;
+  }
+  else
+  {
+    layer.weightScales.fill(arma::abs(weights).max() / 127.0);
+  }
+
+  // A unit with all its weights zero can have any scale.
+  layer.weightScales.transform([](double s) { return (s > 0.0) ? s : 1.0; });
+
+  layer.weights.resize(weights.n_elem);
+  for (size_t i = 0; i < weights.n_cols; ++i)
+  {
+    QuantizeValues(weights.colptr(i), weights.n_rows, layer.weightScales[i],
+        layer.weights.data() + i * weights.n_rows);
+  }
+
+  // Measure the error of the quantized weights.
+  arma::mat error(weights.n_rows, weights.n_cols);
+  for (size_t i = 0; i < weights.n_cols; ++i)
+  {
+    for (size_t k = 0; k < weights.n_rows; ++k)
+    {
+      error(k, i) = layer.weights[k + i * weights.n_rows] *
+          layer.weightScales[i] - weights(k, i);
+    }
+  }
+
+  const double norm = arma::norm(weights, "fro");
+  layer.weightError = (norm > 0.0) ? (arma::norm(error, "fro") / norm) : 0.0;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::QuantizedForward(
+    const QuantizedLayer& layer,
+    const arma::mat& input,
+    arma::mat& output) const
+{
+  const size_t inputRows = layer.convolution ?
+      (layer.inputWidth * layer.inputHeight * layer.inMaps) : layer.inRows;
+  if (input.n_rows != inputRows)
+  {
+    Log::Fatal << "QuantizedFFN::Predict(): layer " << layer.layer << " has "
+        << inputRows << " inputs, but was given " << input.n_rows << "!"
+        << std::endl;
+  }
+
+  if (!layer.convolution)
+  {
+    output.set_size(layer.outRows, input.n_cols);
+
+    #pragma omp parallel
+    {
+      std::vector<int8_t> quantizedInput(layer.inRows);
+      std::vector<int32_t> accumulator(layer.outRows);
+
+      #pragma omp for
+      for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+      {
+        QuantizeValues(input.colptr(j), layer.inRows, layer.inputScale,
+            quantizedInput.data());
+        Int8Gemm(layer.weights.data(), quantizedInput.data(), layer.inRows,
+            layer.outRows, 1, accumulator.data());
+
+        double* y = output.colptr(j);
+        for (size_t i = 0; i < layer.outRows; ++i)
+        {
+          y[i] = accumulator[i] * (layer.inputScale * layer.weightScales[i]) +
+              (layer.bias.is_empty() ? 0.0 : layer.bias[i]);
+        }
+      }
+    }
+  }
+  else
+  {
+    const size_t positions = layer.outputWidth * layer.outputHeight;
+    const size_t mapSize = layer.inputWidth * layer.inputHeight;
+    output.set_size(positions * layer.outRows, input.n_cols);
+
+    #pragma omp parallel
+    {
+      std::vector<int8_t> quantizedInput(inputRows);
+      std::vector<int8_t> patches(positions * layer.inRows);
+      std::vector<int32_t> accumulator(positions * layer.outRows);
+
+      #pragma omp for
+      for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+      {
+        QuantizeValues(input.colptr(j), inputRows, layer.inputScale,
+            quantizedInput.data());
+
+        // Gather the (zero-padded) patch of each output position, in the
+        // order of the weights of the filters.  Zero is exact in symmetric
+        // quantization, so the padding needs no correction.
+        int8_t* patch = patches.data();
+        for (size_t y = 0; y < layer.outputHeight; ++y)
+        {
+          for (size_t x = 0; x < layer.outputWidth; ++x)
+          {
+            for (size_t c = 0; c < layer.inMaps; ++c)
+            {
+              const int8_t* map = quantizedInput.data() + c * mapSize;
+              for (size_t kj = 0; kj < layer.kH; ++kj)
+              {
+                const size_t iy = y * layer.dH + kj;
+                const bool rowInside = (iy >= layer.padH) &&
+                    (iy < layer.padH + layer.inputHeight);
+                for (size_t ki = 0; ki < layer.kW; ++ki, ++patch)
+                {
+                  const size_t ix = x * layer.dW + ki;
+                  *patch = (rowInside && ix >= layer.padW &&
+                      ix < layer.padW + layer.inputWidth) ?
+                      map[(ix - layer.padW) + (iy - layer.padH) *
+                      layer.inputWidth] : 0;
+                }
+              }
+            }
+          }
+        }
+
+        Int8Gemm(patches.data(), layer.weights.data(), layer.inRows,
+            positions, layer.outRows, accumulator.data());
+
+        double* out = output.colptr(j);
+        for (size_t o = 0; o < layer.outRows; ++o)
+        {
+          const double scale = layer.inputScale * layer.weightScales[o];
+          for (size_t p = 0; p < positions; ++p)
+          {
+            out[p + o * positions] = accumulator[p + o * positions] * scale +
+                layer.bias[o];
+          }
+        }
+      }
+    }
+  }
+
+  switch (layer.activation)
+  {
+    case RELU_ACTIVATION:
+      output.transform([](const double x) { return std::max(x, 0.0); });
+      break;
+    case SIGMOID_ACTIVATION:
+      output.transform([](const double x)
+          { return 1.0 / (1.0 + std::exp(-x)); });
+      break;
+    case TANH_ACTIVATION:
+      output.transform([](const double x) { return std::tanh(x); });
+      break;
+    case LEAKY_RELU_ACTIVATION:
+    {
+      const double slope = layer.alpha;
+      output.transform([slope](const double x)
+          { return std::max(x, slope * x); });
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::QuantizeValues(const double* values,
+                                                   const size_t n,
+                                                   const double scale,
+                                                   int8_t* quantized)
+{
+  const double inverseScale = 1.0 / scale;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const double q = std::round(values[i] * inverseScale);
+    quantized[i] = (int8_t) std::min(std::max(q, -127.0), 127.0);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::Int8Gemm(const int8_t* a,
+                                             const int8_t* b,
+                                             const size_t k,
+                                             const size_t m,
+                                             const size_t n,
+                                             int32_t* c)
+{
+  // Each product is at most 127^2 in magnitude, so the int32 accumulator
+  // cannot overflow for dot products of fewer than 2^17 values.
+  for (size_t j = 0; j < n; ++j)
+  {
+    const int8_t* bj = b + j * k;
+    for (size_t i = 0; i < m; ++i)
+    {
+      const int8_t* ai = a + i * k;
+      int32_t sum = 0;
+      for (size_t l = 0; l < k; ++l)
+        sum += (int32_t) ai[l] * (int32_t) bj[l];
+
+      c[i + j * m] = sum;
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename Archive>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::serialize(Archive& ar,
+                                              const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(network);
+  ar & BOOST_SERIALIZATION_NVP(perChannel);
+  ar & BOOST_SERIALIZATION_NVP(layers);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename Archive>
+void QuantizedFFN<OutputLayerType, InitializationRuleType,
+                  CustomLayers...>::QuantizedLayer::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(layer);
+  ar & BOOST_SERIALIZATION_NVP(convolution);
+  ar & BOOST_SERIALIZATION_NVP(inRows);
+  ar & BOOST_SERIALIZATION_NVP(outRows);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(weightScales);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+  ar & BOOST_SERIALIZATION_NVP(activation);
+  ar & BOOST_SERIALIZATION_NVP(alpha);
+  ar & BOOST_SERIALIZATION_NVP(weightError);
+  ar & BOOST_SERIALIZATION_NVP(inMaps);
+  ar & BOOST_SERIALIZATION_NVP(kW);
+  ar & BOOST_SERIALIZATION_NVP(kH);
+  ar & BOOST_SERIALIZATION_NVP(dW);
+  ar & BOOST_SERIALIZATION_NVP(dH);
+  ar & BOOST_SERIALIZATION_NVP(padW);
+  ar & BOOST_SERIALIZATION_NVP(padH);
+  ar & BOOST_SERIALIZATION_NVP(inputWidth);
+  ar & BOOST_SERIALIZATION_NVP(inputHeight);
+  ar & BOOST_SERIALIZATION_NVP(outputWidth);
+  ar & BOOST_SERIALIZATION_NVP(outputHeight);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -114,6 +114,17 @@ class RBM
   typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, double>::type
   FreeEnergy(arma::Mat<ElemType>&& input);
 
+  /**
+   * This function calculates the free energy of each point of the given batch
+   * for the BinaryRBM, in parallel over the points.
+   *
+   * @param input The visible neurons, one point per column.
+   * @param energies The free energy of each point.
+   */
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+  FreeEnergy(const arma::Mat<ElemType>& input, arma::Row<ElemType>& energies);
+
   /**
    * This function calculates the free energy of the SpikeSlabRBM.
    * The free energy is given by:
@@ -294,7 +305,9 @@ class RBM
   SampleSlab(DataType&& slabMean, DataType&& slab);
 
   /**
-   * This function does the k-step Gibbs Sampling.
+   * This function does the k-step Gibbs Sampling.  With persistent CD the
+   * chains continue from the samples of the previous call.  The chains of the
+   * BinaryRBM (one per column) are updated in parallel.
    *
    * @param input Input to the Gibbs function.
    * @param output Used for storing the negative sample.
@@ -374,6 +387,28 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Run the Gibbs chains of the BinaryRBM, starting from the columns of the
+   * given input, for the current number of steps.
+   *
+   * @param input Starting points of the chains.
+   * @param output Used for storing the last samples of the chains.
+   */
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+  GibbsChains(arma::Mat<ElemType>&& input, arma::Mat<ElemType>&& output);
+
+  /**
+   * Run the Gibbs chain of the SpikeSlabRBM, starting from the given input,
+   * for the current number of steps.
+   *
+   * @param input Starting point of the chain.
+   * @param output Used for storing the last sample of the chain.
+   */
+  template<typename Policy = PolicyType>
+  typename std::enable_if<std::is_same<Policy, SpikeSlabRBM>::value, void>::type
+  GibbsChains(arma::Mat<ElemType>&& input, arma::Mat<ElemType>&& output);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
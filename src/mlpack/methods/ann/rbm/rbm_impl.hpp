@@ -15,6 +15,7 @@
 #include "rbm.hpp"
 
 #include <mlpack/methods/ann/activation_functions/logistic_function.hpp>
+#include <mlpack/core/math/random.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial neural networks. */ {
@@ -112,10 +113,40 @@ typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, double>::type
 RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
     arma::Mat<ElemType>&& input)
 {
-  preActivation = (weight.slice(0) * input);
-  preActivation.each_col() += hiddenBias;
-  return -(arma::accu(arma::log(1 + arma::trunc_exp(preActivation))) +
-      arma::dot(input, arma::repmat(visibleBias, 1, input.n_cols)));
+  arma::Row<ElemType> energies;
+  FreeEnergy(input, energies);
+  return arma::accu(energies);
+}
+
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::FreeEnergy(
+    const arma::Mat<ElemType>& input,
+    arma::Row<ElemType>& energies)
+{
+  preActivation = weight.slice(0) * input;
+  energies = -(visibleBias.t() * input);
+
+  // The hidden bias and the softplus function are applied in one pass over
+  // each point.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+  {
+    const ElemType* column = preActivation.colptr(j);
+    ElemType softplus = 0;
+    for (size_t r = 0; r < hiddenSize; ++r)
+    {
+      const ElemType x = column[r] + hiddenBias(r);
+      softplus += (x > 0) ? x + std::log1p(std::exp(-x)) :
+          std::log1p(std::exp(x));
+    }
+    energies[j] -= softplus;
+  }
 }
 
 template<
@@ -170,11 +201,16 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
     arma::Mat<ElemType>&& input,
     arma::Mat<ElemType>&& output)
 {
-  HiddenMean(std::move(input), std::move(output));
+  output = weight.slice(0) * input;
 
-  for (size_t i = 0; i < output.n_elem; i++)
+  // The bias, the logistic function and the Bernoulli draw are applied in one
+  // pass.
+  for (size_t j = 0; j < output.n_cols; ++j)
   {
-    output(i) = math::RandBernoulli(output(i));
+    ElemType* column = output.colptr(j);
+    for (size_t r = 0; r < output.n_rows; ++r)
+      column[r] = math::RandBernoulli(LogisticFunction::Fn(column[r] +
+          hiddenBias(r)));
   }
 }
 
@@ -189,11 +225,16 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
     arma::Mat<ElemType>&& input,
     arma::Mat<ElemType>&& output)
 {
-  VisibleMean(std::move(input), std::move(output));
+  output = weight.slice(0).t() * input;
 
-  for (size_t i = 0; i < output.n_elem; i++)
+  // The bias, the logistic function and the Bernoulli draw are applied in one
+  // pass.
+  for (size_t j = 0; j < output.n_cols; ++j)
   {
-    output(i) = math::RandBernoulli(output(i));
+    ElemType* column = output.colptr(j);
+    for (size_t r = 0; r < output.n_rows; ++r)
+      column[r] = math::RandBernoulli(LogisticFunction::Fn(column[r] +
+          visibleBias(r)));
   }
 }
 
@@ -240,25 +281,83 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gibbs(
   this->steps = (steps == SIZE_MAX) ? this->numSteps : steps;
 
   if (persistence && !state.is_empty())
+    GibbsChains(std::move(state), std::move(output));
+  else
+    GibbsChains(std::move(input), std::move(output));
+
+  if (persistence)
   {
-    SampleHidden(std::move(state), std::move(gibbsTemporary));
-    SampleVisible(std::move(gibbsTemporary), std::move(output));
+    state = output;
   }
-  else
+}
+
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, BinaryRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::GibbsChains(
+    arma::Mat<ElemType>&& input,
+    arma::Mat<ElemType>&& output)
+{
+  output.set_size(visibleSize, input.n_cols);
+
+  // Each column is an independent chain, so blocks of chains take their steps
+  // in parallel.  Each block draws from its own random stream, so the samples
+  // don't depend on the number of threads.
+  const size_t blockSize = 16;
+  const size_t numBlocks = (input.n_cols + blockSize - 1) / blockSize;
+  std::vector<math::RandomEngine> streams = math::RandomStreams(numBlocks);
+  const math::RandomEngine engine = math::randGen;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    SampleHidden(std::move(input), std::move(gibbsTemporary));
-    SampleVisible(std::move(gibbsTemporary), std::move(output));
+    math::randGen = streams[b];
+
+    const size_t begin = b * blockSize;
+    const size_t cols = std::min(blockSize, (size_t) input.n_cols - begin);
+    arma::Mat<ElemType> chains(output.colptr(begin), visibleSize, cols, false,
+        true);
+    arma::Mat<ElemType> hidden;
+
+    SampleHidden(arma::Mat<ElemType>(input.colptr(begin), input.n_rows, cols,
+        false, true), std::move(hidden));
+    SampleVisible(std::move(hidden), std::move(chains));
+
+    for (size_t j = 1; j < this->steps; j++)
+    {
+      SampleHidden(std::move(chains), std::move(hidden));
+      SampleVisible(std::move(hidden), std::move(chains));
+    }
   }
 
+  math::randGen = engine;
+}
+
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename Policy>
+typename std::enable_if<std::is_same<Policy, SpikeSlabRBM>::value, void>::type
+RBM<InitializationRuleType, DataType, PolicyType>::GibbsChains(
+    arma::Mat<ElemType>&& input,
+    arma::Mat<ElemType>&& output)
+{
+  // The spike and slab samples are drawn from the means over the whole batch,
+  // so there is a single chain.
+  SampleHidden(std::move(input), std::move(gibbsTemporary));
+  SampleVisible(std::move(gibbsTemporary), std::move(output));
+
   for (size_t j = 1; j < this->steps; j++)
   {
     SampleHidden(std::move(output), std::move(gibbsTemporary));
     SampleVisible(std::move(gibbsTemporary), std::move(output));
   }
-  if (persistence)
-  {
-    state = output;
-  }
 }
 
 template<
@@ -278,7 +377,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(positiveGradient));
 
-  for (size_t i = 0; i < negSteps; i++)
+  for (size_t j = 0; j < negSteps; j++)
   {
     Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
         std::move(negativeSamples));
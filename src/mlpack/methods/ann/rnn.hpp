@@ -20,6 +20,7 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "layer_profiler.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -33,6 +34,13 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * Sequences longer than rho time steps are processed with truncated
+ * backpropagation through time: the steps are taken in consecutive windows of
+ * (at most) rho steps, the state of the recurrent layers is carried from each
+ * window to the next, and the gradient is only propagated back to the start of
+ * its window.  The memory needed for training is thus proportional to rho
+ * instead of to the length of the sequences.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -58,7 +66,8 @@ class RNN
    * If you want to pass in a parameter and discard the original parameter
    * object, be sure to use std::move to avoid unnecessary copy.
    *
-   * @param rho Maximum number of steps to backpropagate through time (BPTT).
+   * @param rho Maximum number of steps to backpropagate through time (BPTT),
+   *     and length of the windows the sequences are processed in.
    * @param single Predict only the last element of the input sequence.
    * @param outputLayer Output layer used to evaluate the network.
    * @param initializeRule Optional instantiated InitializationRule object
@@ -126,6 +135,49 @@ class RNN
   template<typename OptimizerType = ens::StandardSGD>
   void Train(arma::cube predictors, arma::cube responses);
 
+  /**
+   * Train the recurrent neural network on sequences of different lengths using
+   * the given optimizer.  The sequences are padded to the number of slices of
+   * the predictors; the padding values are never used.  Sequence j only counts
+   * in the objective for its first sequenceLengths[j] time steps (or, if only
+   * the last element is predicted, at time step sequenceLengths[j] - 1 against
+   * the first slice of the responses), and the steps past the longest sequence
+   * of a batch are skipped entirely.
+   *
+   * The sequences are packed: they are sorted by decreasing length before the
+   * optimization, so that each batch holds sequences of similar lengths.  To
+   * keep the packing, use an optimizer that does not shuffle the data.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Number of time steps of each sequence.
+   * @param optimizer Instantiated optimizer used to train the model.
+   */
+  template<typename OptimizerType>
+  void Train(arma::cube predictors,
+             arma::cube responses,
+             arma::Row<size_t> sequenceLengths,
+             OptimizerType& optimizer);
+
+  /**
+   * Train the recurrent neural network on sequences of different lengths.  By
+   * default, the SGD optimization algorithm is used.  See the other overload
+   * for the meaning of the sequence lengths.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths Number of time steps of each sequence.
+   */
+  template<typename OptimizerType = ens::StandardSGD>
+  void Train(arma::cube predictors,
+             arma::cube responses,
+             arma::Row<size_t> sequenceLengths);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -139,7 +191,10 @@ class RNN
    *  - each column should correspond to a data point
    *  - each row should correspond to a dimension
    * So, e.g., predictors(i, j, k) is the i'th dimension of the j'th data point
-   * at time slice k.  The responses will be in the same format.
+   * at time slice k.  The responses will be in the same format, with one
+   * slice for each slice of the predictors.
+   *
+   * Each sequence starts from the zero state.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
@@ -149,6 +204,28 @@ class RNN
                arma::cube& results,
                const size_t batchSize = 256);
 
+  /**
+   * Predict the responses to the next time steps of the sequences given to the
+   * last call to PredictStateful(): the recurrent layers start from the state
+   * they were left in by that call, so a long (or streamed) sequence can be
+   * predicted one chunk of time steps at a time, with the same results as if
+   * it was predicted at once.  All the sequences are processed as one batch,
+   * and their number must not change until ResetState() is called.
+   *
+   * The first call (and the first call after ResetState() or any other use of
+   * the network) starts from the zero state.
+   *
+   * @param predictors Input predictors for the next time steps.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void PredictStateful(arma::cube predictors, arma::cube& results);
+
+  /**
+   * Forget the state held for PredictStateful(), so that its next call starts
+   * new sequences.
+   */
+  void ResetState() { statePoints = 0; }
+
   /**
    * Evaluate the recurrent neural network with the given parameters. This
    * function is usually called by the optimizer to train the model.
@@ -260,6 +337,12 @@ class RNN
   //! Modify the matrix of data points (predictors).
   arma::cube& Predictors() { return predictors; }
 
+  //! Get the number of time steps of each sequence (empty if all the sequences
+  //! have as many time steps as the predictors have slices).
+  const arma::Row<size_t>& SequenceLengths() const { return sequenceLengths; }
+  //! Modify the number of time steps of each sequence.
+  arma::Row<size_t>& SequenceLengths() { return sequenceLengths; }
+
   /**
    * Reset the state of the network.  This ensures that all internally-held
    * gradients are set to 0, all memory cells are reset, and the parameters
@@ -272,6 +355,32 @@ class RNN
    */
   void ResetParameters();
 
+  /**
+   * Get whether the passes through each layer are profiled.  If true, the
+   * Forward(), Backward() and Gradient() calls of each layer are timed (over
+   * all the time steps) with the Timer subsystem, the floating point
+   * operations and bytes of the Linear and Convolution layers are counted, and
+   * Train() and Predict() log a table of the totals of each layer to Log::Info
+   * (see LayerProfiler; the timers are named "rnn_layer_<i>_forward" and so
+   * on).  Timing must be enabled (see Timer::EnableTiming()).  The default is
+   * false.
+   */
+  bool Profile() const { return profiler.Enabled(); }
+  //! Modify whether the passes through each layer are profiled.
+  bool& Profile() { return profiler.Enabled(); }
+
+  /**
+   * Write the table of the time and cost of each layer, accumulated since
+   * profiling was enabled (or since the timers were reset), to the given
+   * stream.
+   *
+   * @param stream Stream to write the table to.
+   */
+  void ProfileReport(std::ostream& stream) const
+  {
+    profiler.Report(network, stream);
+  }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -287,9 +396,58 @@ class RNN
   void Forward(arma::mat&& input);
 
   /**
-   * Reset the state of RNN cells in the network for new input sequence.
+   * Reset the state of RNN cells in the network for new input sequence, or for
+   * the continuation of the last one.
+   *
+   * @param steps Number of steps the cells will be run for.
+   * @param carryState If true, start from the last state of the cells instead
+   *     of the zero state.
+   */
+  void ResetCells(const size_t steps, const bool carryState = false);
+
+  /**
+   * Get the number of time steps to process for the given batch: the number of
+   * slices of the predictors, or the length of the longest sequence of the
+   * batch.
+   */
+  size_t NumSteps(const size_t begin, const size_t batchSize) const;
+
+  /**
+   * Find the columns of the batch whose loss counts at the given time step,
+   * when the sequences have different lengths.
+   */
+  arma::uvec ActiveColumns(const size_t step,
+                           const size_t begin,
+                           const size_t batchSize) const;
+
+  /**
+   * Compute the loss of the output of the network at the given time step.
+   */
+  double StepPerformance(const size_t step,
+                         const size_t begin,
+                         const size_t batchSize);
+
+  /**
+   * Compute the error of the output of the network at the given time step for
+   * the backward pass.
    */
-  void ResetCells();
+  void StepError(const size_t step,
+                 const size_t begin,
+                 const size_t batchSize,
+                 const size_t numSteps);
+
+  /**
+   * Predict the responses of the given batch of sequences, in windows of rho
+   * time steps.
+   *
+   * @param carryState If true, the first window starts from the last state of
+   *     the cells instead of the zero state.
+   */
+  void PredictSequences(arma::cube& predictors,
+                        arma::cube& results,
+                        const size_t begin,
+                        const size_t batchSize,
+                        const bool carryState);
 
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
@@ -315,6 +473,10 @@ class RNN
    */
   void ResetGradients(arma::mat& gradient);
 
+  //! Log the table of the time and cost of each layer, if the layers are
+  //! profiled.
+  void LogProfile() const;
+
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
@@ -349,6 +511,14 @@ class RNN
   //! The matrix of responses to the input data points.
   arma::cube responses;
 
+  //! The number of time steps of each sequence (empty if all the sequences
+  //! have as many time steps as the predictors have slices).
+  arma::Row<size_t> sequenceLengths;
+
+  //! The number of sequences whose state is held by the recurrent layers for
+  //! PredictStateful() (0 if there is no such state).
+  size_t statePoints;
+
   //! Matrix of (trained) parameters.
   arma::mat parameter;
 
@@ -381,6 +551,9 @@ class RNN
 
   //! The current gradient for the gradient pass.
   arma::mat currentGradient;
+
+  //! The profiler of the passes through each layer.
+  LayerProfiler profiler;
 }; // class RNN
 
 } // namespace ann
@@ -20,6 +20,7 @@
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
+#include "visitor/carry_cell_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
 #include "visitor/gradient_visitor.hpp"
@@ -45,8 +46,10 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     targetSize(0),
     reset(false),
     single(single),
+    statePoints(0),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    profiler("rnn")
 {
   /* Nothing to do here */
 }
@@ -73,6 +76,7 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  this->sequenceLengths.clear();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -89,16 +93,188 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   Log::Info << "RNN::RNN(): final objective of trained model is " << out
       << "." << std::endl;
+  LogProfile();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::cube predictors,
+    arma::cube responses,
+    arma::Row<size_t> sequenceLengths,
+    OptimizerType& optimizer)
+{
+  if (sequenceLengths.n_elem != predictors.n_cols)
+  {
+    Log::Fatal << "RNN::Train(): " << sequenceLengths.n_elem << " sequence "
+        << "lengths were given for " << predictors.n_cols << " sequences!"
+        << std::endl;
+  }
+
+  for (size_t i = 0; i < sequenceLengths.n_elem; ++i)
+  {
+    if (sequenceLengths[i] == 0 || sequenceLengths[i] > predictors.n_slices)
+    {
+      Log::Fatal << "RNN::Train(): sequence " << i << " has length "
+          << sequenceLengths[i] << ", but lengths must be between 1 and the "
+          << "number of time steps (" << predictors.n_slices << ")!"
+          << std::endl;
+    }
+  }
+
+  // Pack the sequences: sort them by decreasing length, so that the batches
+  // hold sequences of similar lengths and few padding steps are processed.
+  const arma::uvec ordering = arma::stable_sort_index(sequenceLengths,
+      "descend");
+  this->predictors.set_size(predictors.n_rows, predictors.n_cols,
+      predictors.n_slices);
+  for (size_t i = 0; i < predictors.n_slices; ++i)
+    this->predictors.slice(i) = predictors.slice(i).cols(ordering);
+  this->responses.set_size(responses.n_rows, responses.n_cols,
+      responses.n_slices);
+  for (size_t i = 0; i < responses.n_slices; ++i)
+    this->responses.slice(i) = responses.slice(i).cols(ordering);
+  this->sequenceLengths = sequenceLengths.cols(ordering);
+
+  numFunctions = this->responses.n_cols;
+
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+  {
+    ResetParameters();
+  }
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  LogProfile();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType>
+void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    arma::cube predictors,
+    arma::cube responses,
+    arma::Row<size_t> sequenceLengths)
+{
+  OptimizerType optimizer;
+  Train(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths), optimizer);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::ResetCells()
+         CustomLayers...>::ResetCells(const size_t steps, const bool carryState)
 {
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ResetCellVisitor(rho), network[i]);
+    if (carryState)
+      boost::apply_visitor(CarryCellVisitor(steps), network[i]);
+    else
+      boost::apply_visitor(ResetCellVisitor(steps), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::NumSteps(
+    const size_t begin, const size_t batchSize) const
+{
+  if (sequenceLengths.is_empty())
+    return predictors.n_slices;
+
+  return arma::max(sequenceLengths.subvec(begin, begin + batchSize - 1));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+arma::uvec RNN<OutputLayerType, InitializationRuleType,
+               CustomLayers...>::ActiveColumns(const size_t step,
+                                               const size_t begin,
+                                               const size_t batchSize) const
+{
+  arma::uvec active(batchSize);
+  size_t numActive = 0;
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const size_t length = sequenceLengths[begin + j];
+    if (single ? (step + 1 == length) : (step < length))
+      active[numActive++] = j;
+  }
+
+  active.resize(numActive);
+  return active;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double RNN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::StepPerformance(const size_t step,
+                                             const size_t begin,
+                                             const size_t batchSize)
+{
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  // Wrap a matrix around our data to avoid a copy.
+  arma::mat target(responses.slice(single ? 0 : step).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+
+  if (sequenceLengths.is_empty())
+    return outputLayer.Forward(std::move(output), std::move(target));
+
+  const arma::uvec active = ActiveColumns(step, begin, batchSize);
+  if (active.n_elem == batchSize)
+    return outputLayer.Forward(std::move(output), std::move(target));
+  else if (active.n_elem == 0)
+    return 0;
+
+  return outputLayer.Forward(arma::mat(output.cols(active)),
+      arma::mat(target.cols(active)));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StepError(const size_t step,
+                                     const size_t begin,
+                                     const size_t batchSize,
+                                     const size_t numSteps)
+{
+  arma::mat& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  // Wrap a matrix around our data to avoid a copy.
+  arma::mat target(responses.slice(single ? 0 : step).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+
+  arma::uvec active;
+  if (!sequenceLengths.is_empty())
+    active = ActiveColumns(step, begin, batchSize);
+
+  if (sequenceLengths.is_empty() ? (!single || step + 1 == numSteps) :
+      (active.n_elem == batchSize))
+  {
+    outputLayer.Backward(std::move(output), std::move(target),
+        std::move(error));
+    return;
+  }
+
+  // Only the sequences whose loss counts at this step have an error.
+  error.zeros(output.n_rows, output.n_cols);
+  if (active.n_elem > 0)
+  {
+    arma::mat activeError;
+    outputLayer.Backward(arma::mat(output.cols(active)),
+        arma::mat(target.cols(active)), std::move(activeError));
+    error.cols(active) = activeError;
   }
 }
 
@@ -113,6 +289,7 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  this->sequenceLengths.clear();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -131,6 +308,7 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 
   Log::Info << "RNN::RNN(): final objective of trained model is " << out
       << "." << std::endl;
+  LogProfile();
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -138,8 +316,6 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     arma::cube predictors, arma::cube& results, const size_t batchSize)
 {
-  ResetCells();
-
   if (parameter.is_empty())
   {
     ResetParameters();
@@ -151,20 +327,89 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
+  // The state of the cells is overwritten.
+  statePoints = 0;
+
+  results.reset();
   // Process in accordance with the given batch size.
   for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    PredictSequences(predictors, results, begin, effectiveBatchSize, false);
+  }
+
+  LogProfile();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PredictStateful(arma::cube predictors,
+                                           arma::cube& results)
+{
+  if (statePoints > 0 && predictors.n_cols != statePoints)
+  {
+    Log::Fatal << "RNN::PredictStateful(): the state of " << statePoints
+        << " sequences is held, but " << predictors.n_cols << " sequences "
+        << "were given; call ResetState() to start new sequences!"
+        << std::endl;
+  }
+
+  if (parameter.is_empty())
+  {
+    ResetParameters();
+  }
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  results.reset();
+  if (predictors.n_cols == 0 || predictors.n_slices == 0)
+    return;
+
+  PredictSequences(predictors, results, 0, predictors.n_cols,
+      statePoints > 0);
+  statePoints = predictors.n_cols;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PredictSequences(arma::cube& predictors,
+                                            arma::cube& results,
+                                            const size_t begin,
+                                            const size_t batchSize,
+                                            const bool carryState)
+{
+  for (size_t windowBegin = 0; windowBegin < predictors.n_slices;
+      windowBegin += rho)
+  {
+    const size_t windowEnd = std::min(windowBegin + rho,
+        (size_t) predictors.n_slices);
+    ResetCells(windowEnd - windowBegin, carryState || windowBegin > 0);
+
+    for (size_t seqNum = windowBegin; seqNum < windowEnd; ++seqNum)
     {
       Forward(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
+          predictors.n_rows, batchSize, false, true)));
 
-      results.slice(seqNum).submat(0, begin, results.n_rows - 1, begin +
-          effectiveBatchSize - 1) = boost::apply_visitor(outputParameterVisitor,
+      const arma::mat& output = boost::apply_visitor(outputParameterVisitor,
           network.back());
+      if (results.is_empty())
+      {
+        if (outputSize == 0)
+          outputSize = output.n_elem / batchSize;
+
+        results = arma::zeros<arma::cube>(outputSize, predictors.n_cols,
+            predictors.n_slices);
+      }
+
+      results.slice(seqNum).submat(0, begin, results.n_rows - 1, begin +
+          batchSize - 1) = output;
     }
   }
 }
@@ -198,21 +443,22 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  // The state of the cells is overwritten.
+  statePoints = 0;
 
   double performance = 0;
-  size_t responseSeq = 0;
+  const size_t numSteps = NumSteps(begin, batchSize);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t seqNum = 0; seqNum < numSteps; ++seqNum)
   {
+    // Each window of rho steps continues from the state of the previous one.
+    if (seqNum % rho == 0)
+      ResetCells(std::min(rho, numSteps - seqNum), seqNum > 0);
+
     // Wrap a matrix around our data to avoid a copy.
     arma::mat stepData(predictors.slice(seqNum).colptr(begin),
         predictors.n_rows, batchSize, false, true);
     Forward(std::move(stepData));
-    if (!single)
-    {
-      responseSeq = seqNum;
-    }
 
     if (!deterministic)
     {
@@ -223,10 +469,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
       }
     }
 
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
+    performance += StepPerformance(seqNum, begin, batchSize);
   }
 
   if (outputSize == 0)
@@ -288,39 +531,8 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
-
-  double performance = 0;
-  size_t responseSeq = 0;
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true);
-    Forward(std::move(stepData));
-    if (!single)
-    {
-      responseSeq = seqNum;
-    }
-
-    for (size_t l = 0; l < network.size(); ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          std::move(moduleOutputParameter)), network[l]);
-    }
-
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
-  }
-
-  if (outputSize == 0)
-  {
-    outputSize = boost::apply_visitor(outputParameterVisitor,
-        network.back()).n_elem / batchSize;
-  }
+  // The state of the cells is overwritten.
+  statePoints = 0;
 
   // Initialize current/working gradient.
   if (currentGradient.is_empty())
@@ -331,40 +543,55 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   ResetGradients(currentGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  double performance = 0;
+  const size_t numSteps = NumSteps(begin, batchSize);
+
+  // Truncated BPTT: each window of rho steps continues from the state of the
+  // previous one, but the gradient stops at the start of the window.
+  for (size_t windowBegin = 0; windowBegin < numSteps; windowBegin += rho)
   {
-    currentGradient.zeros();
+    const size_t windowEnd = std::min(windowBegin + rho, numSteps);
+    ResetCells(windowEnd - windowBegin, windowBegin > 0);
 
-    for (size_t l = 0; l < network.size(); ++l)
+    for (size_t seqNum = windowBegin; seqNum < windowEnd; ++seqNum)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
-    }
+      // Wrap a matrix around our data to avoid a copy.
+      arma::mat stepData(predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true);
+      Forward(std::move(stepData));
 
-    if (single && seqNum > 0)
-    {
-      error.zeros();
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[l]);
+      }
+
+      performance += StepPerformance(seqNum, begin, batchSize);
     }
-    else if (single && seqNum == 0)
+
+    if (outputSize == 0)
     {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(0).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
+      outputSize = boost::apply_visitor(outputParameterVisitor,
+          network.back()).n_elem / batchSize;
     }
-    else
+
+    for (size_t seqNum = windowEnd; seqNum-- > windowBegin; )
     {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(rho - seqNum - 1).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
-    }
+      currentGradient.zeros();
 
-    Backward();
-    Gradient(std::move(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    gradient += currentGradient;
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor(
+            std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
+      }
+
+      StepError(seqNum, begin, batchSize, numSteps);
+
+      Backward();
+      Gradient(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      gradient += currentGradient;
+    }
   }
 
   return performance;
@@ -385,11 +612,33 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
+  if (sequenceLengths.is_empty())
+  {
+    arma::cube newPredictors, newResponses;
+    math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+    predictors = std::move(newPredictors);
+    responses = std::move(newResponses);
+    return;
+  }
+
+  // The lengths of the sequences have to be shuffled with them.  Each time
+  // step is permuted in place with the same ordering.
+  const arma::uvec ordering = math::ShuffledOrdering(predictors.n_cols);
+
+  for (size_t i = 0; i < predictors.n_slices; ++i)
+  {
+    arma::mat step(predictors.slice_memptr(i), predictors.n_rows,
+        predictors.n_cols, false, true);
+    math::PermuteColumns(step, ordering);
+  }
+  for (size_t i = 0; i < responses.n_slices; ++i)
+  {
+    arma::mat step(responses.slice_memptr(i), responses.n_rows,
+        responses.n_cols, false, true);
+    math::PermuteColumns(step, ordering);
+  }
+  math::PermuteColumns(sequenceLengths, ordering);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -412,7 +661,8 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Reset()
 {
   ResetParameters();
-  ResetCells();
+  ResetCells(rho);
+  statePoints = 0;
   currentGradient.zeros();
   ResetGradients(currentGradient);
 }
@@ -446,16 +696,20 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Forward(arma::mat&& input)
 {
+  profiler.Start(0, FORWARD_PASS);
   boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
       boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
+  profiler.Stop(0, FORWARD_PASS, network.front());
 
   for (size_t i = 1; i < network.size(); ++i)
   {
+    profiler.Start(i, FORWARD_PASS);
     boost::apply_visitor(ForwardVisitor(
         std::move(boost::apply_visitor(outputParameterVisitor, network[i - 1])),
         std::move(boost::apply_visitor(outputParameterVisitor, network[i]))),
         network[i]);
+    profiler.Stop(i, FORWARD_PASS, network[i]);
   }
 }
 
@@ -463,19 +717,24 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
+  profiler.Start(network.size() - 1, BACKWARD_PASS);
   boost::apply_visitor(BackwardVisitor(
         std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
         std::move(error), std::move(boost::apply_visitor(deltaVisitor,
         network.back()))), network.back());
+  profiler.Stop(network.size() - 1, BACKWARD_PASS, network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
+    profiler.Start(network.size() - i, BACKWARD_PASS);
     boost::apply_visitor(BackwardVisitor(
         std::move(boost::apply_visitor(outputParameterVisitor,
         network[network.size() - i])), std::move(boost::apply_visitor(
         deltaVisitor, network[network.size() - i + 1])), std::move(
         boost::apply_visitor(deltaVisitor, network[network.size() - i]))),
         network[network.size() - i]);
+    profiler.Stop(network.size() - i, BACKWARD_PASS,
+        network[network.size() - i]);
   }
 }
 
@@ -485,18 +744,37 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(InputType&& input)
 {
+  profiler.Start(0, GRADIENT_PASS);
   boost::apply_visitor(GradientVisitor(std::move(input), std::move(
       boost::apply_visitor(deltaVisitor, network[1]))), network.front());
+  profiler.Stop(0, GRADIENT_PASS, network.front());
 
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
+    profiler.Start(i, GRADIENT_PASS);
     boost::apply_visitor(GradientVisitor(
         std::move(boost::apply_visitor(outputParameterVisitor, network[i - 1])),
         std::move(boost::apply_visitor(deltaVisitor, network[i + 1]))),
         network[i]);
+    profiler.Stop(i, GRADIENT_PASS, network[i]);
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::LogProfile() const
+{
+  if (!profiler.Enabled())
+    return;
+
+  // The table is formatted first, since Log::Info formats each item alone.
+  std::ostringstream oss;
+  profiler.Report(network, oss);
+  Log::Info << "RNN: time (in seconds) and cost of each layer:" << std::endl
+      << oss.str();
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename Archive>
@@ -544,6 +822,8 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
 
     deterministic = true;
     ResetDeterministic();
+
+    statePoints = 0;
   }
 }
 
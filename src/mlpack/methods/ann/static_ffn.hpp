@@ -0,0 +1,511 @@
+/**
+ * @file static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward network whose layers are
+ * fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/backward_visitor.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/forward_visitor.hpp"
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/gradient_visitor.hpp"
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+#include "init_rules/init_rules_traits.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <ensmallen.hpp>
+
+#include <tuple>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network whose layers are given as template
+ * parameters.  The layers are held by value in a tuple instead of in a vector
+ * of boost::variant, so every call to a layer is resolved at compile time:
+ * there is no visitor dispatch, and the calls of small layers can be inlined.
+ * This suits small networks that are evaluated very often, such as the
+ * networks of reinforcement learning agents or online scoring.
+ *
+ * StaticFFN has the same training API as FFN (Train(), Predict(), Evaluate(),
+ * EvaluateWithGradient() and so on), and the same parameter layout: a
+ * StaticFFN and an FFN with the same layers give the same results with the
+ * same parameters.  Predict() passes all the points forward at once.
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, RandomInitialization,
+ *     Linear<>, ReLULayer<>, Linear<>, LogSoftMax<> > model(
+ *     Linear<>(10, 20), ReLULayer<>(), Linear<>(20, 3), LogSoftMax<>());
+ * model.Train(trainData, trainLabels);
+ * @endcode
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers The types of the layers of the network, in order (at least
+ *         two).
+ */
+template<
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename... Layers
+>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) >= 2,
+      "StaticFFN needs at least two layers.");
+
+ public:
+  /**
+   * Create the StaticFFN object with the given layers, using the default
+   * output layer and initialization rule.
+   *
+   * @param layers The layers of the network.
+   */
+  StaticFFN(Layers... layers);
+
+  /**
+   * Create the StaticFFN object with the given output layer, initialization
+   * rule and layers.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Instantiated InitializationRule object for
+   *        initializing the network parameter.
+   * @param layers The layers of the network.
+   */
+  StaticFFN(OutputLayerType outputLayer,
+            InitializationRuleType initializeRule,
+            Layers... layers);
+
+  //! Copy constructor.  The layers of the copy use the copied parameters.
+  StaticFFN(const StaticFFN& other);
+
+  //! Copy assignment operator.
+  StaticFFN& operator=(const StaticFFN& other);
+
+  /**
+   * Train the network on the given input data using the given optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   */
+  template<typename OptimizerType>
+  void Train(arma::mat predictors,
+             arma::mat responses,
+             OptimizerType& optimizer);
+
+  /**
+   * Train the network on the given input data. By default, the RMSProp
+   * optimization algorithm is used, but others can be specified (such as
+   * ens::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   */
+  template<typename OptimizerType = ens::RMSProp>
+  void Train(arma::mat predictors, arma::mat responses);
+
+  /**
+   * Predict the responses to a given set of predictors. The responses will
+   * reflect the output of the last layer.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   */
+  void Predict(arma::mat predictors, arma::mat& results);
+
+  /**
+   * Evaluate the network with the given predictors and responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  double Evaluate(arma::mat predictors, arma::mat responses);
+
+  /**
+   * Evaluate the network with the given parameters on all the points.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const arma::mat& parameters);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a number
+   * of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic = true);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters, on all
+   * the points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters, GradType& gradient);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters, but
+   * using only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the network with the given parameters, and with
+   * respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.  The points are permuted in place.
+   */
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const arma::mat& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  arma::mat& Parameters() { return parameter; }
+
+  //! Get the layers of the network.
+  const std::tuple<Layers...>& Model() const { return layers; }
+  //! Modify the layers of the network.
+  std::tuple<Layers...>& Model() { return layers; }
+
+  //! Get the matrix of responses to the input data points.
+  const arma::mat& Responses() const { return responses; }
+  //! Modify the matrix of responses to the input data points.
+  arma::mat& Responses() { return responses; }
+
+  //! Get the matrix of data points (predictors).
+  const arma::mat& Predictors() const { return predictors; }
+  //! Modify the matrix of data points (predictors).
+  arma::mat& Predictors() { return predictors; }
+
+  /**
+   * Reset the module information (weights/parameters), with the
+   * initialization rule.
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The number of layers.
+  static const size_t NumLayers = sizeof...(Layers);
+
+  //! The type of the layer with the given index.
+  template<size_t I>
+  using LayerType = typename std::tuple_element<I, std::tuple<Layers...>>::type;
+
+  /**
+   * Prepare the network for training on the given data, initializing the
+   * parameters if necessary.
+   */
+  void ResetData(arma::mat predictors, arma::mat responses);
+
+  //! Set the deterministic parameter of all the layers.
+  void ResetDeterministic();
+
+  //! Make the gradients of the layers refer to the given matrix.
+  void ResetGradients(arma::mat& gradient);
+
+  //! Make the weights of the layers refer to the parameters, and reset them.
+  void ResetWeights();
+
+  //! Pass the input forward through the network.
+  void Forward(arma::mat&& input);
+
+  //! Pass the error backward through the network.
+  void Backward();
+
+  //! Compute the gradients of the layers for the given input.
+  void Gradient(arma::mat&& input);
+
+  //! Return the output of the last layer.
+  arma::mat& Output()
+  {
+    return std::get<NumLayers - 1>(layers).OutputParameter();
+  }
+
+  //! Apply the given visitor to each layer, from the I-th one.
+  template<size_t I = 0, typename VisitorType>
+  typename std::enable_if<(I < NumLayers)>::type
+  VisitLayers(const VisitorType& visitor)
+  {
+    visitor(&std::get<I>(layers));
+    VisitLayers<I + 1>(visitor);
+  }
+
+  template<size_t I = 0, typename VisitorType>
+  typename std::enable_if<(I == NumLayers)>::type
+  VisitLayers(const VisitorType& /* visitor */) { }
+
+  //! Return the sum of the number of weights of the layers from the I-th one.
+  template<size_t I = 0>
+  typename std::enable_if<(I < NumLayers), size_t>::type WeightSize()
+  {
+    return WeightSizeVisitor()(&std::get<I>(layers)) + WeightSize<I + 1>();
+  }
+
+  template<size_t I = 0>
+  typename std::enable_if<(I == NumLayers), size_t>::type WeightSize()
+  {
+    return 0;
+  }
+
+  //! Return the sum of the losses of the layers from the I-th one.
+  template<size_t I = 0>
+  typename std::enable_if<(I < NumLayers), double>::type Loss()
+  {
+    return LossVisitor()(&std::get<I>(layers)) + Loss<I + 1>();
+  }
+
+  template<size_t I = 0>
+  typename std::enable_if<(I == NumLayers), double>::type Loss() { return 0; }
+
+  //! Initialize the parameters of each layer from the I-th one, whose
+  //! parameters start at the given offset.
+  template<size_t I = 0>
+  typename std::enable_if<(I < NumLayers)>::type
+  InitializeLayers(const size_t offset)
+  {
+    const size_t weight = WeightSizeVisitor()(&std::get<I>(layers));
+    arma::mat tmp = arma::mat(parameter.memptr() + offset, weight, 1, false,
+        false);
+    initializeRule.Initialize(tmp, tmp.n_elem, 1);
+    InitializeLayers<I + 1>(offset + weight);
+  }
+
+  template<size_t I = 0>
+  typename std::enable_if<(I == NumLayers)>::type
+  InitializeLayers(const size_t /* offset */) { }
+
+  //! Make the weights of the layers from the I-th one refer to the
+  //! parameters, from the given offset, and reset the layers.
+  template<size_t I = 0>
+  typename std::enable_if<(I < NumLayers)>::type
+  SetWeights(const size_t offset)
+  {
+    const size_t weight = WeightSetVisitor(std::move(parameter), offset)(
+        &std::get<I>(layers));
+    ResetVisitor()(&std::get<I>(layers));
+    SetWeights<I + 1>(offset + weight);
+  }
+
+  template<size_t I = 0>
+  typename std::enable_if<(I == NumLayers)>::type
+  SetWeights(const size_t /* offset */) { }
+
+  //! Make the gradients of the layers from the I-th one refer to the given
+  //! matrix, from the given offset.
+  template<size_t I = 0>
+  typename std::enable_if<(I < NumLayers)>::type
+  SetGradients(arma::mat& gradient, const size_t offset)
+  {
+    const size_t weight = GradientSetVisitor(std::move(gradient), offset)(
+        &std::get<I>(layers));
+    SetGradients<I + 1>(gradient, offset + weight);
+  }
+
+  template<size_t I = 0>
+  typename std::enable_if<(I == NumLayers)>::type
+  SetGradients(arma::mat& /* gradient */, const size_t /* offset */) { }
+
+  //! Pass the output of the previous layer forward through the layers from
+  //! the I-th one (I > 0).
+  template<size_t I>
+  typename std::enable_if<(I < NumLayers)>::type ForwardLayers()
+  {
+    LayerType<I>& layer = std::get<I>(layers);
+    if (!reset)
+    {
+      SetInputWidthVisitor(width)(&layer);
+      SetInputHeightVisitor(height)(&layer);
+    }
+
+    ForwardVisitor(std::move(std::get<I - 1>(layers).OutputParameter()),
+        std::move(layer.OutputParameter()))(&layer);
+
+    if (!reset)
+      UpdateSize(layer);
+
+    ForwardLayers<I + 1>();
+  }
+
+  template<size_t I>
+  typename std::enable_if<(I == NumLayers)>::type ForwardLayers() { }
+
+  //! Pass the error backward through the I-th layer and the ones before it,
+  //! down to the second layer.
+  template<size_t I>
+  typename std::enable_if<(I > 0)>::type BackwardLayers()
+  {
+    LayerType<I>& layer = std::get<I>(layers);
+    BackwardVisitor(std::move(layer.OutputParameter()),
+        std::move(NextDelta<I>()), std::move(layer.Delta()))(&layer);
+    BackwardLayers<I - 1>();
+  }
+
+  template<size_t I>
+  typename std::enable_if<(I == 0)>::type BackwardLayers() { }
+
+  //! Compute the gradients of the layers from the I-th one (I > 0).
+  template<size_t I>
+  typename std::enable_if<(I < NumLayers)>::type GradientLayers()
+  {
+    GradientVisitor(std::move(std::get<I - 1>(layers).OutputParameter()),
+        std::move(NextDelta<I>()))(&std::get<I>(layers));
+    GradientLayers<I + 1>();
+  }
+
+  template<size_t I>
+  typename std::enable_if<(I == NumLayers)>::type GradientLayers() { }
+
+  //! Return the error that reaches the I-th layer: the delta of the next
+  //! layer, or the error of the output layer.
+  template<size_t I>
+  typename std::enable_if<(I + 1 < NumLayers), arma::mat&>::type NextDelta()
+  {
+    return std::get<I + 1>(layers).Delta();
+  }
+
+  template<size_t I>
+  typename std::enable_if<(I + 1 == NumLayers), arma::mat&>::type NextDelta()
+  {
+    return error;
+  }
+
+  //! Take the output width and height of the given layer, if it has any.
+  template<typename ModuleType>
+  void UpdateSize(ModuleType& layer)
+  {
+    const size_t outputWidth = OutputWidthVisitor()(&layer);
+    if (outputWidth != 0)
+      width = outputWidth;
+
+    const size_t outputHeight = OutputHeightVisitor()(&layer);
+    if (outputHeight != 0)
+      height = outputHeight;
+  }
+
+  //! Serialize the layers from the I-th one.
+  template<size_t I = 0, typename Archive>
+  typename std::enable_if<(I < NumLayers)>::type SerializeLayers(Archive& ar)
+  {
+    ar & boost::serialization::make_nvp("layer", std::get<I>(layers));
+    SerializeLayers<I + 1>(ar);
+  }
+
+  template<size_t I = 0, typename Archive>
+  typename std::enable_if<(I == NumLayers)>::type
+  SerializeLayers(Archive& /* ar */) { }
+
+  //! Instantiated output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the network.
+  std::tuple<Layers...> layers;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already trained the model.
+  bool reset;
+
+  //! The matrix of data points (predictors).
+  arma::mat predictors;
+
+  //! The matrix of responses to the input data points.
+  arma::mat responses;
+
+  //! Matrix of (trained) parameters.
+  arma::mat parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  arma::mat error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
@@ -0,0 +1,412 @@
+/**
+ * @file static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, a feed forward network whose layers
+ * are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    Layers... layers) :
+    layers(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule,
+    Layers... layers) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    layers(std::move(layers)...),
+    width(0),
+    height(0),
+    reset(false),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& other) :
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    layers(other.layers),
+    width(other.width),
+    height(other.height),
+    reset(other.reset),
+    predictors(other.predictors),
+    responses(other.responses),
+    parameter(other.parameter),
+    numFunctions(other.numFunctions),
+    deterministic(other.deterministic)
+{
+  ResetWeights();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    const StaticFFN& other)
+{
+  if (this != &other)
+  {
+    outputLayer = other.outputLayer;
+    initializeRule = other.initializeRule;
+    layers = other.layers;
+    width = other.width;
+    height = other.height;
+    reset = other.reset;
+    predictors = other.predictors;
+    responses = other.responses;
+    parameter = other.parameter;
+    numFunctions = other.numFunctions;
+    deterministic = other.deterministic;
+    ResetWeights();
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetData(
+    arma::mat predictors, arma::mat responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+      arma::mat predictors,
+      arma::mat responses,
+      OptimizerType& optimizer)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("static_ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("static_ffn_optimization");
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    arma::mat predictors, arma::mat responses)
+{
+  OptimizerType optimizer;
+  Train(std::move(predictors), std::move(responses), optimizer);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Predict(
+    arma::mat predictors, arma::mat& results)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(predictors));
+  results = Output();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    arma::mat predictors, arma::mat responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(predictors));
+  return outputLayer.Forward(std::move(Output()), std::move(responses)) +
+      Loss();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const arma::mat& parameters)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const arma::mat& /* parameters */,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  // The points are read in place.
+  Forward(arma::mat(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true));
+
+  return outputLayer.Forward(std::move(Output()), arma::mat(
+      responses.colptr(begin), responses.n_rows, batchSize, false, true)) +
+      Loss();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const arma::mat& parameters, GradType& gradient)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += EvaluateWithGradient(parameters, i, gradient, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const arma::mat& /* parameters */,
+                     const size_t begin,
+                     GradType& gradient,
+                     const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  // The points and their responses are read in place.
+  arma::mat input(predictors.colptr(begin), predictors.n_rows, batchSize,
+      false, true);
+  arma::mat target(responses.colptr(begin), responses.n_rows, batchSize,
+      false, true);
+
+  Forward(std::move(input));
+
+  double res = outputLayer.Forward(std::move(Output()), std::move(target)) +
+      Loss();
+  outputLayer.Backward(std::move(Output()), std::move(target),
+      std::move(error));
+
+  Backward();
+  ResetGradients(gradient);
+  Gradient(std::move(input));
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Shuffle()
+{
+  // A Fisher-Yates shuffle of the columns, which makes no copy of the data.
+  for (size_t i = predictors.n_cols; i > 1; --i)
+  {
+    const size_t j = math::RandInt(i);
+    if (j != i - 1)
+    {
+      predictors.swap_cols(j, i - 1);
+      responses.swap_cols(j, i - 1);
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetParameters()
+{
+  ResetDeterministic();
+
+  // Reset the network parameter with the given initialization rule, layer by
+  // layer or all at once, as NetworkInitialization does for FFN.
+  if (parameter.is_empty())
+    parameter.set_size(WeightSize(), 1);
+
+  if (ann::InitTraits<InitializationRuleType>::UseLayer)
+    InitializeLayers(0);
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  SetWeights(0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetDeterministic()
+{
+  VisitLayers(DeterministicSetVisitor(deterministic));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetGradients(arma::mat& gradient)
+{
+  SetGradients(gradient, 0);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetWeights()
+{
+  // Copied layers still refer to the parameters they were copied from.
+  if (!parameter.is_empty() && parameter.n_elem == WeightSize())
+    SetWeights(0);
+
+  ResetDeterministic();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    arma::mat&& input)
+{
+  LayerType<0>& first = std::get<0>(layers);
+  ForwardVisitor(std::move(input), std::move(first.OutputParameter()))(
+      &first);
+
+  if (!reset)
+    UpdateSize(first);
+
+  ForwardLayers<1>();
+
+  if (!reset)
+    reset = true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward()
+{
+  // The first layer has no delta to compute.
+  BackwardLayers<NumLayers - 1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    arma::mat&& input)
+{
+  GradientVisitor(std::move(input), std::move(NextDelta<0>()))(
+      &std::get<0>(layers));
+  GradientLayers<1>();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(reset);
+
+  SerializeLayers(ar);
+
+  // If we are loading, the weights of the layers have to refer to the loaded
+  // parameters.
+  if (Archive::is_loading::value)
+  {
+    deterministic = true;
+    ResetWeights();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file carry_cell_visitor.hpp
+ *
+ * Boost static visitor abstraction for calling CarryCell function on RNN cells.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CARRY_CELL_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CARRY_CELL_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * CarryCellVisitor executes the CarryCell() function, which starts a new BPTT
+ * chain from the last state of the cell.  Modules without a CarryCell()
+ * function but with a ResetCell() function are reset instead.
+ */
+class CarryCellVisitor : public boost::static_visitor<void>
+{
+ public:
+  //! Carry the state of the cell using the given size.
+  CarryCellVisitor(const size_t size);
+
+  //! Execute the CarryCell() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  size_t size;
+
+  //! Execute the CarryCell() function for a module which implements the
+  //! CarryCell() function.
+  template<typename T>
+  typename std::enable_if<
+      HasCarryCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryCell(T* layer) const;
+
+  //! Execute the ResetCell() function for a module which implements the
+  //! ResetCell() function but not the CarryCell() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasCarryCellCheck<T, void(T::*)(const size_t)>::value &&
+      HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryCell(T* layer) const;
+
+  //! Do nothing for a module which implements neither function.
+  template<typename T>
+  typename std::enable_if<
+      !HasCarryCellCheck<T, void(T::*)(const size_t)>::value &&
+      !HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryCell(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "carry_cell_visitor_impl.hpp"
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file layer_cost_visitor.hpp
+ *
+ * This file provides an estimate of the floating point operations and the
+ * memory traffic of a pass through the given layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_COST_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_COST_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * The cost of one pass (forward, backward or gradient) through a layer, for
+ * the batch of its last output.
+ */
+struct LayerCost
+{
+  LayerCost(const uint64_t flops = 0, const uint64_t bytes = 0) :
+      flops(flops), bytes(bytes) { }
+
+  //! The number of floating point operations.
+  uint64_t flops;
+  //! The number of bytes read or written by the dense products.
+  uint64_t bytes;
+};
+
+/**
+ * LayerCostVisitor estimates the cost of one pass through the given module.
+ * The forward pass, the backward pass and the gradient of the Linear and
+ * Convolution layers are each one dense product of about the same size, so
+ * the same cost is given for every pass; the cost of a module that holds
+ * other layers is the sum of their costs.  The cost of every other layer is
+ * not counted (it is 0).
+ */
+class LayerCostVisitor : public boost::static_visitor<LayerCost>
+{
+ public:
+  //! Return the cost of a Linear layer.
+  template<typename InputDataType, typename OutputDataType>
+  LayerCost operator()(Linear<InputDataType, OutputDataType>* layer) const;
+
+  //! Return the cost of a Convolution layer.
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule,
+           typename InputDataType,
+           typename OutputDataType>
+  LayerCost operator()(Convolution<ForwardConvolutionRule,
+                                   BackwardConvolutionRule,
+                                   GradientConvolutionRule,
+                                   InputDataType,
+                                   OutputDataType>* layer) const;
+
+  //! Return the cost of any other module.
+  template<typename LayerType>
+  LayerCost operator()(LayerType* layer) const;
+
+ private:
+  //! Return 0 if the module doesn't implement the Model() function.
+  template<typename T>
+  typename std::enable_if<!HasModelCheck<T>::value, LayerCost>::type
+  ModelCost(T* layer) const;
+
+  //! Return the sum of the costs of the layers of the module if it implements
+  //! the Model() function.
+  template<typename T>
+  typename std::enable_if<HasModelCheck<T>::value, LayerCost>::type
+  ModelCost(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_cost_visitor_impl.hpp"
+
+#endif
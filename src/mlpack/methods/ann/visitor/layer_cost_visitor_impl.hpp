@@ -0,0 +1,93 @@
+/**
+ * @file layer_cost_visitor_impl.hpp
+ *
+ * Implementation of the cost estimate of a pass through a layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_COST_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_COST_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_cost_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! LayerCostVisitor visitor class.
+template<typename InputDataType, typename OutputDataType>
+inline LayerCost LayerCostVisitor::operator()(
+    Linear<InputDataType, OutputDataType>* layer) const
+{
+  const uint64_t in = layer->InputSize();
+  const uint64_t out = layer->OutputSize();
+  const uint64_t batch = layer->OutputParameter().n_cols;
+
+  // The weights and the bias, the input, and the output of the product.
+  return LayerCost(2 * in * out * batch,
+      sizeof(double) * (in * out + out + (in + out) * batch));
+}
+
+template<typename ForwardConvolutionRule,
+         typename BackwardConvolutionRule,
+         typename GradientConvolutionRule,
+         typename InputDataType,
+         typename OutputDataType>
+inline LayerCost LayerCostVisitor::operator()(
+    Convolution<ForwardConvolutionRule,
+                BackwardConvolutionRule,
+                GradientConvolutionRule,
+                InputDataType,
+                OutputDataType>* layer) const
+{
+  const uint64_t maps = layer->OutputSize();
+  const uint64_t filterSize = (uint64_t) layer->KernelWidth() *
+      layer->KernelHeight() * layer->InputSize();
+  const uint64_t inputSize = (uint64_t) layer->InputWidth() *
+      layer->InputHeight() * layer->InputSize();
+  const uint64_t outputSize = (uint64_t) layer->OutputWidth() *
+      layer->OutputHeight() * maps;
+  const uint64_t batch = layer->OutputParameter().n_cols;
+
+  // Each output is the dot product of a filter with a patch of the input.
+  return LayerCost(2 * filterSize * outputSize * batch,
+      sizeof(double) * (filterSize * maps + maps +
+      (inputSize + outputSize) * batch));
+}
+
+template<typename LayerType>
+inline LayerCost LayerCostVisitor::operator()(LayerType* layer) const
+{
+  return ModelCost(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<!HasModelCheck<T>::value, LayerCost>::type
+LayerCostVisitor::ModelCost(T* /* layer */) const
+{
+  return LayerCost();
+}
+
+template<typename T>
+inline typename std::enable_if<HasModelCheck<T>::value, LayerCost>::type
+LayerCostVisitor::ModelCost(T* layer) const
+{
+  LayerCost cost;
+  for (size_t i = 0; i < layer->Model().size(); ++i)
+  {
+    const LayerCost layerCost = boost::apply_visitor(LayerCostVisitor(),
+        layer->Model()[i]);
+    cost.flops += layerCost.flops;
+    cost.bytes += layerCost.bytes;
+  }
+
+  return cost;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file layer_name_visitor.hpp
+ *
+ * This file provides the name of the type of the given layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_NAME_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_NAME_VISITOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <boost/core/demangle.hpp>
+#include <boost/variant.hpp>
+
+#include <typeinfo>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * LayerNameVisitor returns the name of the class of the given module, without
+ * its namespace and template arguments (for instance "Linear").  For the
+ * layers that are instances of BaseLayer (such as ReLULayer), the name of the
+ * activation function is returned instead (for instance "RectifierFunction").
+ */
+class LayerNameVisitor : public boost::static_visitor<std::string>
+{
+ public:
+  //! Return the name of the class of the module.
+  template<typename LayerType>
+  std::string operator()(LayerType* layer) const;
+
+ private:
+  //! Remove the namespace from the given name of a class.
+  static std::string Unqualified(const std::string& name);
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "layer_name_visitor_impl.hpp"
+
+#endif
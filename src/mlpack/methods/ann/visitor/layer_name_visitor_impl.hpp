@@ -0,0 +1,48 @@
+/**
+ * @file layer_name_visitor_impl.hpp
+ *
+ * Implementation of the name of the type of a layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_NAME_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_NAME_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_name_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! LayerNameVisitor visitor class.
+template<typename LayerType>
+inline std::string LayerNameVisitor::operator()(LayerType* /* layer */) const
+{
+  const std::string name = boost::core::demangle(typeid(LayerType).name());
+  const size_t arguments = name.find('<');
+  if (arguments == std::string::npos)
+    return Unqualified(name);
+
+  const std::string className = Unqualified(name.substr(0, arguments));
+  if (className != "BaseLayer")
+    return className;
+
+  // The first template argument of a BaseLayer is its activation function.
+  const size_t end = name.find_first_of(",<>", arguments + 1);
+  return Unqualified(name.substr(arguments + 1, end - arguments - 1));
+}
+
+inline std::string LayerNameVisitor::Unqualified(const std::string& name)
+{
+  const size_t separator = name.rfind("::");
+  return (separator == std::string::npos) ? name :
+      name.substr(separator + 2);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
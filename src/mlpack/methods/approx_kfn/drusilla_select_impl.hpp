@@ -16,10 +16,9 @@
 #include "drusilla_select.hpp"
 
 #include <queue>
-#include <mlpack/methods/neighbor_search/neighbor_search_rules.hpp>
-#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
-#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 #include <algorithm>
+#include <functional>
 
 namespace mlpack {
 namespace neighbor {
@@ -179,23 +178,47 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
-      tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+  // Perform a brute-force search of the candidate set, with the queries split
+  // between the threads.
+  typedef std::pair<double, size_t> Candidate;
+  #pragma omp parallel
+  {
+    // The k furthest candidates seen so far, with the closest of them on top;
+    // the heap is reused for all the queries of a thread.
+    std::vector<Candidate> results;
+    results.reserve(k);
 
-  rules.GetResults(neighbors, distances);
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      results.assign(k, Candidate(-1.0, size_t(-1)));
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+      {
+        const double dist = metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet.col(r));
+        if (dist > results.front().first)
+        {
+          std::pop_heap(results.begin(), results.end(),
+              std::greater<Candidate>());
+          results.back() = Candidate(dist, r);
+          std::push_heap(results.begin(), results.end(),
+              std::greater<Candidate>());
+        }
+      }
 
-  // Map the neighbors back to their original indices in the reference set.
-  for (size_t i = 0; i < neighbors.n_elem; ++i)
-    neighbors[i] = candidateIndices[neighbors[i]];
+      // Extract the results, furthest first, and map the neighbors back to
+      // their original indices in the reference set.
+      std::sort_heap(results.begin(), results.end(), std::greater<Candidate>());
+      for (size_t j = 0; j < k; ++j)
+      {
+        neighbors(j, q) = candidateIndices[results[j].second];
+        distances(j, q) = results[j].first;
+      }
+    }
+  }
 }
 
 //! Serialize the model.
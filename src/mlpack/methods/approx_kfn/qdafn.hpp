@@ -72,7 +72,9 @@ class QDAFN
    * Search for the k furthest neighbors of the given query set.  (The query set
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
-   * mlpack NeighborSearch and LSHSearch classes.
+   * mlpack NeighborSearch and LSHSearch classes.  The queries are projected
+   * onto the lines all at once, and then searched in parallel (if OpenMP is
+   * enabled).
    */
   void Search(const MatType& querySet,
               const size_t k,
@@ -84,12 +86,19 @@ class QDAFN
   void serialize(Archive& ar, const unsigned int /* version */);
 
   //! Get the number of projections.
-  size_t NumProjections() const { return candidateSet.size(); }
+  size_t NumProjections() const { return candidateSet.n_cols / m; }
 
-  //! Get the candidate set for the given projection table.
-  const MatType& CandidateSet(const size_t t) const { return candidateSet[t]; }
-  //! Modify the candidate set for the given projection table.  Careful!
-  MatType& CandidateSet(const size_t t) { return candidateSet[t]; }
+  //! Get a copy of the candidate set for the given projection table.
+  MatType CandidateSet(const size_t t) const
+  {
+    return candidateSet.cols(t * m, (t + 1) * m - 1);
+  }
+
+  //! Get the candidate sets of all the tables; the m columns of table t start
+  //! at column t * m.
+  const MatType& CandidateSet() const { return candidateSet; }
+  //! Modify the candidate sets of all the tables.  Careful!
+  MatType& CandidateSet() { return candidateSet; }
 
  private:
   //! The number of projections.
@@ -106,13 +115,18 @@ class QDAFN
   //! Values of a_i * x for each point in S.
   arma::mat sValues;
 
-  // Candidate sets; one element in the vector for each table.
-  std::vector<MatType> candidateSet;
+  //! Candidate sets of all the tables, packed in one matrix so that a search
+  //! reads them from contiguous memory; has l * m columns.
+  MatType candidateSet;
 };
 
 } // namespace neighbor
 } // namespace mlpack
 
+//! Set the serialization version of the QDAFN class.
+BOOST_TEMPLATE_CLASS_VERSION(template<typename MatType>,
+    mlpack::neighbor::QDAFN<MatType>, 1);
+
 // Include implementation.
 #include "qdafn_impl.hpp"
 
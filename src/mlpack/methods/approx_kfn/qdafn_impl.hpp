@@ -15,8 +15,9 @@
 // In case it hasn't been included yet.
 #include "qdafn.hpp"
 
-#include <queue>
-#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
+#include <algorithm>
+#include <functional>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -73,10 +74,9 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   // Loop over each projection and find the top m elements.
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
-  candidateSet.resize(l);
+  candidateSet.set_size(referenceSet.n_rows, l * m);
   for (size_t i = 0; i < l; ++i)
   {
-    candidateSet[i].set_size(referenceSet.n_rows, m);
     arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
 
     // Grab the top m elements.
@@ -84,7 +84,7 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
     {
       sIndices(j, i) = sortedIndices[j];
       sValues(j, i) = projections(sortedIndices[j], i);
-      candidateSet[i].col(j) = referenceSet.col(sortedIndices[j]);
+      candidateSet.col(i * m + j) = referenceSet.col(sortedIndices[j]);
     }
   }
 }
@@ -101,77 +101,91 @@ void QDAFN<MatType>::Search(const MatType& querySet,
         "value of m!");
 
   neighbors.set_size(k, querySet.n_cols);
-  neighbors.fill(size_t() - 1);
-  distances.zeros(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
 
-  // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  // Project all of the queries onto all of the lines at once.
+  const arma::mat queryProjections = lines.t() * querySet;
+
+  typedef std::pair<double, size_t> Candidate;
+
+  #pragma omp parallel
   {
-    // Initialize a priority queue.
-    // The size_t represents the index of the table, and the double represents
-    // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
-    std::priority_queue<std::pair<double, size_t>> queue;
-    for (size_t i = 0; i < l; ++i)
-    {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
-      queue.push(std::make_pair(val, i));
-    }
+    // The heaps are reused for all the queries of a thread.  The table queue
+    // holds, for each table, the value of l_i * S_i - l_i * query (see line 6
+    // of Algorithm 1) and the index of the table; the results heap holds the
+    // k furthest points seen so far, with the closest of them on top.
+    std::vector<Candidate> queue;
+    queue.reserve(l);
+    std::vector<Candidate> results;
+    results.reserve(k);
 
     // To track where we are in each S table, we keep the next index to look at
-    // in each table (they start at 0).
-    arma::Col<size_t> tableLocations = arma::zeros<arma::Col<size_t>>(l);
-
-    // Now that the queue is initialized, iterate over m elements.
-    std::vector<std::pair<double, size_t>> v(k, std::make_pair(-1.0,
-        size_t(-1)));
-    std::priority_queue<std::pair<double, size_t>>
-        resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
-    for (size_t i = 0; i < m; ++i)
-    {
-      std::pair<size_t, double> p = queue.top();
-      queue.pop();
+    // in each table.
+    std::vector<size_t> tableLocations(l);
 
-      // Get index of reference point to look at.
-      const size_t tableIndex = tableLocations[p.second];
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+    {
+      queue.clear();
+      for (size_t i = 0; i < l; ++i)
+        queue.push_back(Candidate(sValues(0, i) - queryProjections(i, q), i));
+      std::make_heap(queue.begin(), queue.end());
 
-      // Calculate distance from query point.
-      const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
+      std::fill(tableLocations.begin(), tableLocations.end(), 0);
+      results.assign(k, Candidate(-1.0, size_t(-1)));
 
-      // Is this neighbor good enough to insert into the results?
-      if (dist > resultsQueue.top().first)
+      // Now that the queue is initialized, iterate over m elements.
+      for (size_t i = 0; i < m; ++i)
       {
-        resultsQueue.pop();
-        resultsQueue.push(std::make_pair(dist, sIndices(tableIndex, p.second)));
+        std::pop_heap(queue.begin(), queue.end());
+        const Candidate p = queue.back();
+        queue.pop_back();
+
+        // Get index of reference point to look at.
+        const size_t tableIndex = tableLocations[p.second];
+
+        // Calculate distance from query point.
+        const double dist = mlpack::metric::EuclideanDistance::Evaluate(
+            querySet.col(q), candidateSet.col(p.second * m + tableIndex));
+
+        // Is this neighbor good enough to insert into the results?
+        if (dist > results.front().first)
+        {
+          std::pop_heap(results.begin(), results.end(),
+              std::greater<Candidate>());
+          results.back() = Candidate(dist, sIndices(tableIndex, p.second));
+          std::push_heap(results.begin(), results.end(),
+              std::greater<Candidate>());
+        }
+
+        // Now (line 14) get the next element and insert into the queue.  Do
+        // this by adjusting the previous value.  Don't insert anything if we
+        // are at the end of the search, though.
+        if (i < m - 1)
+        {
+          tableLocations[p.second]++;
+          const double val = p.first - sValues(tableIndex, p.second) +
+              sValues(tableIndex + 1, p.second);
+
+          queue.push_back(Candidate(val, p.second));
+          std::push_heap(queue.begin(), queue.end());
+        }
       }
 
-      // Now (line 14) get the next element and insert into the queue.  Do this
-      // by adjusting the previous value.  Don't insert anything if we are at
-      // the end of the search, though.
-      if (i < m - 1)
+      // Extract the results, furthest first.
+      std::sort_heap(results.begin(), results.end(), std::greater<Candidate>());
+      for (size_t j = 0; j < k; ++j)
       {
-        tableLocations[p.second]++;
-        const double val = p.first - sValues(tableIndex, p.second) +
-            sValues(tableIndex + 1, p.second);
-
-        queue.push(std::make_pair(val, p.second));
+        neighbors(j, q) = results[j].second;
+        distances(j, q) = results[j].first;
       }
     }
-
-    // Extract the results.
-    for (size_t j = 1; j <= k; ++j)
-    {
-      neighbors(k - j, q) = resultsQueue.top().second;
-      distances(k - j, q) = resultsQueue.top().first;
-      resultsQueue.pop();
-    }
   }
 }
 
 template<typename MatType>
 template<typename Archive>
-void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+void QDAFN<MatType>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(l);
   ar & BOOST_SERIALIZATION_NVP(m);
@@ -179,9 +193,22 @@ void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(projections);
   ar & BOOST_SERIALIZATION_NVP(sIndices);
   ar & BOOST_SERIALIZATION_NVP(sValues);
-  if (Archive::is_loading::value)
-    candidateSet.clear();
-  ar & BOOST_SERIALIZATION_NVP(candidateSet);
+
+  // Backward compatibility: older versions of QDAFN stored the candidate set
+  // of each table in a std::vector<MatType>.
+  if (version == 0)
+  {
+    std::vector<MatType> tmpCandidateSet;
+    ar & BOOST_SERIALIZATION_NVP(tmpCandidateSet);
+
+    candidateSet.set_size(lines.n_rows, tmpCandidateSet.size() * m);
+    for (size_t i = 0; i < tmpCandidateSet.size(); ++i)
+      candidateSet.cols(i * m, (i + 1) * m - 1) = tmpCandidateSet[i];
+  }
+  else
+  {
+    ar & BOOST_SERIALIZATION_NVP(candidateSet);
+  }
 }
 
 } // namespace neighbor
@@ -104,6 +104,38 @@ class RandomizedBlockKrylovSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply the randomized block krylov SVD to a dataset that is read a batch of
+   * columns at a time from the given source, so that the whole dataset never
+   * has to be in memory; only the Krylov subspace, of size
+   * n_rows x (blockSize * (maxIterations + 1)), and the projection of the data
+   * onto it are held.  Each product of the method with the data is one pass
+   * over the source, so maxIterations + 2 passes are made, and the next batch
+   * is read on a background thread while the current one is multiplied.  The
+   * source can be a data::BatchReader, or any other class with the same
+   * Next() and Rewind() methods.
+   *
+   * If SketchElemType is float, the batches and the subspace are held and
+   * multiplied in single precision; the results are given in double
+   * precision.
+   *
+   * @tparam SketchElemType Type of the elements of the subspace.
+   * @tparam SourceType Type of the source of the batches.
+   * @param source Source of the batches of columns of the data.
+   * @param u First unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param v Second unitary matrix.
+   * @param rank Rank of the approximation.
+   * @param batchSize Largest number of columns read at a time.
+   */
+  template<typename SketchElemType = double, typename SourceType>
+  void ApplyBlocks(SourceType& source,
+                   arma::mat& u,
+                   arma::vec& s,
+                   arma::mat& v,
+                   const size_t rank,
+                   const size_t batchSize = 10000);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -115,6 +147,18 @@ class RandomizedBlockKrylovSVD
   size_t& BlockSize() { return blockSize; }
 
  private:
+  //! Convert the given batch to the element type of the subspace.
+  template<typename eT>
+  static const arma::Mat<eT>& ConvertBlock(const arma::mat& block,
+                                           arma::Mat<eT>& converted);
+
+  //! Give the given batch as it is, if the subspace is in double precision.
+  static const arma::mat& ConvertBlock(const arma::mat& block,
+                                       arma::mat& /* converted */)
+  {
+    return block;
+  }
+
   //! Locally stored number of iterations for the power method.
   size_t maxIterations;
 
@@ -125,4 +169,7 @@ class RandomizedBlockKrylovSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_block_krylov_svd_impl.hpp"
+
 #endif
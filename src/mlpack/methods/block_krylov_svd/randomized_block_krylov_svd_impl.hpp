@@ -0,0 +1,124 @@
+/**
+ * @file randomized_block_krylov_svd_impl.hpp
+ *
+ * Implementation of the randomized block krylov SVD method on a dataset that
+ * is read a batch of columns at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_IMPL_HPP
+#define MLPACK_METHODS_BLOCK_KRYLOV_SVD_RANDOMIZED_BLOCK_KRYLOV_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_block_krylov_svd.hpp"
+
+#include <mlpack/core/data/for_each_batch.hpp>
+
+namespace mlpack {
+namespace svd {
+
+template<typename SketchElemType, typename SourceType>
+void RandomizedBlockKrylovSVD::ApplyBlocks(SourceType& source,
+                                           arma::mat& u,
+                                           arma::vec& s,
+                                           arma::mat& v,
+                                           const size_t rank,
+                                           const size_t batchSize)
+{
+  typedef arma::Mat<SketchElemType> SketchType;
+
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("RandomizedBlockKrylovSVD::ApplyBlocks(): the "
+        "batch size must be positive!");
+  }
+
+  if (blockSize == 0)
+  {
+    blockSize = rank + 10;
+  }
+
+  SketchType converted, y, r, block;
+
+  // Apply the data matrix to a random block, which is drawn a batch at a time.
+  const size_t n = data::ForEachBatch(source, batchSize,
+      [&](const arma::mat& batch, const size_t /* offset */)
+      {
+        if (y.is_empty())
+          y.zeros(batch.n_rows, blockSize);
+
+        y += ConvertBlock(batch, converted) *
+            arma::randn<SketchType>(batch.n_cols, blockSize);
+      });
+
+  if (n == 0)
+  {
+    throw std::invalid_argument("RandomizedBlockKrylovSVD::ApplyBlocks(): the "
+        "source has no points!");
+  }
+
+  // Construct and orthonormalize Krylov subspace; each block after the first
+  // is A (A^T block), which is formed with one pass.
+  SketchType k(y.n_rows, blockSize * (maxIterations + 1));
+  arma::qr_econ(block, r, y);
+  k.cols(0, blockSize - 1) = block;
+
+  for (size_t i = 1; i <= maxIterations; ++i)
+  {
+    y.zeros(block.n_rows, block.n_cols);
+    data::ForEachBatch(source, batchSize,
+        [&](const arma::mat& batch, const size_t /* offset */)
+        {
+          const SketchType& b = ConvertBlock(batch, converted);
+          y += b * (b.t() * block);
+        });
+
+    arma::qr_econ(block, r, y);
+    k.cols(i * blockSize, (i + 1) * blockSize - 1) = block;
+  }
+
+  SketchType q;
+  arma::qr_econ(q, r, k);
+
+  // Approximate eigenvalues and eigenvectors using Rayleigh–Ritz method, with
+  // the transpose of Q^T A, which is formed a batch of rows at a time.
+  SketchType bt(n, q.n_cols);
+  data::ForEachBatch(source, batchSize,
+      [&](const arma::mat& batch, const size_t offset)
+      {
+        if (offset + batch.n_cols > n)
+        {
+          throw std::runtime_error("RandomizedBlockKrylovSVD::ApplyBlocks(): "
+              "the source gave more points than in the first pass!");
+        }
+
+        bt.rows(offset, offset + batch.n_cols - 1) =
+            ConvertBlock(batch, converted).t() * q;
+      });
+
+  // With A^T Q = U2 S V2^T, A ~ (Q V2) S U2^T.
+  SketchType u2, v2;
+  arma::Col<SketchElemType> s2;
+  arma::svd_econ(u2, s2, v2, bt);
+
+  u = arma::conv_to<arma::mat>::from(q * v2);
+  s = arma::conv_to<arma::vec>::from(s2);
+  v = arma::conv_to<arma::mat>::from(u2);
+}
+
+template<typename eT>
+const arma::Mat<eT>& RandomizedBlockKrylovSVD::ConvertBlock(
+    const arma::mat& block,
+    arma::Mat<eT>& converted)
+{
+  converted = arma::conv_to<arma::Mat<eT>>::from(block);
+  return converted;
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
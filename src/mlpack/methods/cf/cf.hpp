@@ -59,6 +59,11 @@ namespace cf /** Collaborative filtering. **/ {
  * are in a matrix that holds doubles, should hold integer (or size_t) values.
  * The user and item indices are assumed to start at 0.
  *
+ * The interpolation policies given to GetRecommendations() and Predict()
+ * compute the weights of the neighbors of the users; they have a GetWeights()
+ * for one user and one for a batch of users (with one column of weights for
+ * each user), which is what CFType calls.  See AverageInterpolation.
+ *
  * @tparam DecompositionPolicy The policy used to decompose the rating matrix.
  *     It also provides methods to compute prediction and neighborhood.
  * @tparam NormalizationType The type of normalization performed on raw data.
@@ -143,6 +148,34 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Add the ratings of new users to a trained model without training it again:
+   * the factors of the users are found by regularized least squares with the
+   * item factors fixed (see FoldInFactors()).  Users of the data that are
+   * already in the model get new factors from their ratings in the data alone.
+   * The neighborhoods used by GetRecommendations() and Predict() are computed
+   * from the user factors on each call, so they include the new users.  The
+   * decomposition policy must provide FoldInUsers().
+   *
+   * @param data Ratings of the new users, in coordinate list form; all the
+   *     items must already be in the model.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::mat& data, const double lambda = 0.01);
+
+  /**
+   * Add the ratings of new items to a trained model without training it again:
+   * the factors of the items are found by regularized least squares with the
+   * user factors fixed.  An ItemSearchPolicy index built before this call does
+   * not hold the new items, and must be built again.  The decomposition policy
+   * must provide FoldInItems().
+   *
+   * @param data Ratings of the new items, in coordinate list form; all the
+   *     users must already be in the model.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::mat& data, const double lambda = 0.01);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -192,15 +225,25 @@ class CFType
    *
    * @param numRecs Number of Recommendations.
    * @param recommendations Matrix to save recommendations into.
+   * @param excludeRated If true, items that a user already rated are not
+   *     recommended to that user.
    */
   template<typename NeighborSearchPolicy = EuclideanSearch,
            typename InterpolationPolicy = AverageInterpolation>
   void GetRecommendations(const size_t numRecs,
-                          arma::Mat<size_t>& recommendations);
+                          arma::Mat<size_t>& recommendations,
+                          const bool excludeRated = true);
 
   /**
    * Generates the given number of recommendations for the specified users.
    *
+   * The users are processed in blocks: the predicted ratings of all the items
+   * for a block of users are computed at once with the decomposition policy's
+   * GetWeightedRatings() (a matrix multiplication with the item matrix), and
+   * then the best items of each user of the block are selected in parallel.
+   * If fewer than numRecs items can be recommended to a user, the remaining
+   * recommendations of that user are set to the number of items.
+   *
    * @tparam NeighborSearchPolicy The policy used to search neighbors of
    *     query set in referece set.
    * @tparam InterpolationPolicy The policy used to calculate interpolation
@@ -209,12 +252,51 @@ class CFType
    * @param numRecs Number of Recommendations.
    * @param recommendations Matrix to save recommendations.
    * @param users Users for which recommendations are to be generated.
+   * @param excludeRated If true, items that a user already rated are not
+   *     recommended to that user.
    */
   template<typename NeighborSearchPolicy = EuclideanSearch,
            typename InterpolationPolicy = AverageInterpolation>
   void GetRecommendations(const size_t numRecs,
                           arma::Mat<size_t>& recommendations,
-                          const arma::Col<size_t>& users);
+                          const arma::Col<size_t>& users,
+                          const bool excludeRated = true);
+
+  /**
+   * Generates the given number of recommendations for the specified users,
+   * using the given item search policy (e.g. FastMKSItemSearch or
+   * LSHItemSearch) to find the best items of each user instead of rating all
+   * of the items.  The item search policy builds its index on the item
+   * vectors of the decomposition policy (see GetItemVectors()) the first time
+   * it is used, and keeps it for later calls; it must be reset (or a new one
+   * used) when the model is trained again.
+   *
+   * The items are ranked by their normalized ratings, so the ranking is the
+   * same as the one of the other overloads unless the normalization depends on
+   * the item (such as ItemMeanNormalization or CombinedNormalization with item
+   * means).
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   * @tparam ItemSearchPolicy The policy used to search the best items.
+   *
+   * @param itemSearch Item search object; its index is built if needed.
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   * @param excludeRated If true, items that a user already rated are not
+   *     recommended to that user.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation,
+           typename ItemSearchPolicy>
+  void GetRecommendations(ItemSearchPolicy& itemSearch,
+                          const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users,
+                          const bool excludeRated = true);
 
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
@@ -243,6 +325,10 @@ class CFType
    * have length equal to combinations.n_cols, and predictions[i] will be equal
    * to the prediction for the user/item combination in combinations.col(i).
    *
+   * The interpolation weights of all of the users are computed with one call
+   * of the interpolation policy's batch GetWeights(), and the predictions are
+   * computed in parallel.
+   *
    * @tparam NeighborSearchPolicy The policy used to search neighbors of
    *     query set in referece set.
    * @tparam InterpolationPolicy The policy used to calculate interpolation
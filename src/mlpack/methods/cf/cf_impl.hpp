@@ -19,6 +19,8 @@
 // In case it hasn't been included yet.
 #include "cf.hpp"
 
+#include <mlpack/core/util/parallel.hpp>
+
 namespace mlpack {
 namespace cf {
 
@@ -154,6 +156,100 @@ Train(const arma::sp_mat& data,
   Timer::Stop("cf_factorization");
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInUsers(const arma::mat& data, const double lambda)
+{
+  if (data.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInUsers(): the data must have 3 rows (user, item, "
+        << "rating), but it has " << data.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(data.row(1)) >= cleanedData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInUsers(): item " << (size_t) arma::max(data.row(1))
+        << " is not in the model, which has " << cleanedData.n_rows
+        << " items!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+
+  const arma::Col<size_t> users = arma::unique(
+      arma::conv_to<arma::Col<size_t>>::from(data.row(0).t()));
+  const size_t numUsers = std::max((size_t) cleanedData.n_cols,
+      (size_t) users.max() + 1);
+  cleanedData.resize(cleanedData.n_rows, numUsers);
+
+  // The old ratings of the given users are replaced by the new ones.
+  for (size_t i = 0; i < users.n_elem; ++i)
+    cleanedData.col(users[i]).zeros();
+  for (size_t i = 0; i < normalizedData.n_cols; ++i)
+  {
+    cleanedData((size_t) normalizedData(1, i),
+        (size_t) normalizedData(0, i)) = normalizedData(2, i);
+  }
+
+  decomposition.FoldInUsers(cleanedData, users, lambda);
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInItems(const arma::mat& data, const double lambda)
+{
+  if (data.n_rows != 3)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInItems(): the data must have 3 rows (user, item, "
+        << "rating), but it has " << data.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    return;
+
+  if ((size_t) arma::max(data.row(0)) >= cleanedData.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInItems(): user " << (size_t) arma::max(data.row(0))
+        << " is not in the model, which has " << cleanedData.n_cols
+        << " users!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat normalizedData(data);
+  normalization.FoldIn(normalizedData);
+
+  const arma::Col<size_t> items = arma::unique(
+      arma::conv_to<arma::Col<size_t>>::from(data.row(1).t()));
+  const size_t numItems = std::max((size_t) cleanedData.n_rows,
+      (size_t) items.max() + 1);
+  cleanedData.resize(numItems, cleanedData.n_cols);
+
+  // The old ratings of the given items are replaced by the new ones.
+  for (size_t i = 0; i < items.n_elem; ++i)
+    cleanedData.row(items[i]).zeros();
+  for (size_t i = 0; i < normalizedData.n_cols; ++i)
+  {
+    cleanedData((size_t) normalizedData(1, i),
+        (size_t) normalizedData(0, i)) = normalizedData(2, i);
+  }
+
+  decomposition.FoldInItems(cleanedData, items, lambda);
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -161,7 +257,8 @@ template<typename NeighborSearchPolicy,
 void CFType<DecompositionPolicy,
             NormalizationType>::
 GetRecommendations(const size_t numRecs,
-                   arma::Mat<size_t>& recommendations)
+                   arma::Mat<size_t>& recommendations,
+                   const bool excludeRated)
 {
   // Generate list of users.  Maybe it would be more efficient to pass an empty
   // users list, and then have the other overload of GetRecommendations() assume
@@ -172,7 +269,8 @@ GetRecommendations(const size_t numRecs,
 
   // Call the main overload for recommendations.
   GetRecommendations<NeighborSearchPolicy,
-                     InterpolationPolicy>(numRecs, recommendations, users);
+                     InterpolationPolicy>(numRecs, recommendations, users,
+                                          excludeRated);
 }
 
 template<typename DecompositionPolicy,
@@ -183,7 +281,8 @@ void CFType<DecompositionPolicy,
             NormalizationType>::
 GetRecommendations(const size_t numRecs,
                    arma::Mat<size_t>& recommendations,
-                   const arma::Col<size_t>& users)
+                   const arma::Col<size_t>& users,
+                   const bool excludeRated)
 {
   // Temporary storage for neighborhood of the queried users.
   arma::Mat<size_t> neighborhood;
@@ -198,75 +297,178 @@ GetRecommendations(const size_t numRecs,
   decomposition.template GetNeighborhood<NeighborSearchPolicy>(
       users, numUsersForSimilarity, neighborhood, similarities);
 
-  // Generate recommendations for each query user by finding the maximum numRecs
-  // elements in the ratings vector.
+  // Unused recommendations are set to an invalid item number.
+  const size_t numItems = cleanedData.n_rows;
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
-  recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
+  recommendations.fill(numItems);
 
-  // Initialization of an InterpolationPolicy object should be put ahead of the
-  // following loop, because the initialization may takes a relatively long
-  // time and we don't want to repeat the initialization process in each loop.
+  // Calculate the interpolation weights of all of the users at once, so that
+  // the interpolation policy can share its preprocessing between them and
+  // compute them in parallel.
   InterpolationPolicy interpolation(cleanedData);
-
-  for (size_t i = 0; i < users.n_elem; i++)
+  arma::mat weights;
+  interpolation.GetWeights(weights, decomposition, users, neighborhood,
+      similarities, cleanedData);
+
+  // The users are processed in blocks, so that the ratings of a block (one
+  // column of numItems ratings for each user) take at most about 32MB.
+  const size_t blockSize = std::max((size_t) 1, std::min((size_t) users.n_elem,
+      ((size_t) 1 << 22) / std::max(numItems, (size_t) 1)));
+
+  arma::mat ratings;
+  for (size_t blockBegin = 0; blockBegin < users.n_elem;
+       blockBegin += blockSize)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
+    const size_t blockEnd = std::min(blockBegin + blockSize,
+        (size_t) users.n_elem);
+
+    // The ratings of each user are the weighted sum of the ratings of its
+    // neighborhood.
+    decomposition.GetWeightedRatings(neighborhood.cols(blockBegin,
+        blockEnd - 1), weights.cols(blockBegin, blockEnd - 1), ratings);
+
+    // Select the best items of each user.
+    #pragma omp parallel for
+    for (omp_size_t i = (omp_size_t) blockBegin; i < (omp_size_t) blockEnd;
+         ++i)
+    {
+      const size_t user = users(i);
+      const double* userRatings = ratings.colptr(i - blockBegin);
 
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
-        neighborhood.col(i), similarities.col(i), cleanedData);
+      // Let's build the list of candidate recommendations for the given user.
+      // The algorithm omits rating of zero. Thus, when normalizing original
+      // ratings in Normalize(), if normalized rating equals zero, it is set
+      // to the smallest positive double value, and the items that the user
+      // already rated are the nonzero elements of its column.
+      std::vector<Candidate> candidates;
+      candidates.reserve(numItems);
+      arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+      arma::sp_mat::const_iterator itEnd = cleanedData.end_col(user);
+      for (size_t j = 0; j < numItems; ++j)
+      {
+        if (excludeRated && it != itEnd && it.row() == j)
+        {
+          ++it;
+          continue; // The user already rated the item.
+        }
+
+        // Denormalize rating before comparison.
+        candidates.push_back(std::make_pair(normalization.Denormalize(user, j,
+            userRatings[j]), j));
+      }
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      // Only the best numRecs candidates need to be sorted.
+      const size_t userRecs = std::min((size_t) numRecs, candidates.size());
+      if (userRecs == 0)
+        continue;
+
+      std::nth_element(candidates.begin(), candidates.begin() + userRecs - 1,
+          candidates.end(), CandidateCmp());
+      std::sort(candidates.begin(), candidates.begin() + userRecs,
+          CandidateCmp());
+
+      for (size_t p = 0; p < userRecs; ++p)
+        recommendations(p, i) = candidates[p].second;
+    }
+
+    // If we were not able to come up with enough recommendations, issue a
+    // warning.
+    for (size_t i = blockBegin; i < blockEnd; ++i)
     {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
+      if (numRecs > 0 && recommendations(numRecs - 1, i) == numItems)
+        Log::Warn << "Could not provide " << numRecs << " recommendations "
+            << "for user " << users(i) << " (not enough un-rated items)!"
+            << std::endl;
     }
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy,
+         typename ItemSearchPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendations(ItemSearchPolicy& itemSearch,
+                   const size_t numRecs,
+                   arma::Mat<size_t>& recommendations,
+                   const arma::Col<size_t>& users,
+                   const bool excludeRated)
+{
+  // Temporary storage for neighborhood of the queried users.
+  arma::Mat<size_t> neighborhood;
+  // Resulting similarities.
+  arma::mat similarities;
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+  // Calculate the neighborhood of the queried users.
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
-    {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
+  // Build the index on the items, if it hasn't been built yet.
+  const size_t numItems = cleanedData.n_rows;
+  if (!itemSearch.Trained())
+  {
+    arma::mat items;
+    decomposition.GetItemVectors(items);
+    itemSearch.Train(std::move(items));
+  }
 
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
-      {
-        Candidate c = std::make_pair(realRating, j);
-        pqueue.pop();
-        pqueue.push(c);
-      }
+  // Unused recommendations are set to an invalid item number.
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(numItems);
+
+  // Calculate interpolation weights.
+  InterpolationPolicy interpolation(cleanedData);
+  arma::mat weights;
+  interpolation.GetWeights(weights, decomposition, users, neighborhood,
+      similarities, cleanedData);
+
+  arma::mat userVecs;
+  decomposition.GetWeightedUserVectors(neighborhood, weights, userVecs);
+
+  // The items a user already rated may be found too, so search for enough
+  // items to be left with numRecs of them.
+  size_t k = numRecs;
+  if (excludeRated)
+  {
+    size_t maxRated = 0;
+    for (size_t i = 0; i < users.n_elem; ++i)
+    {
+      maxRated = std::max(maxRated, (size_t) (cleanedData.col_ptrs[users(i) +
+          1] - cleanedData.col_ptrs[users(i)]));
     }
+    k += maxRated;
+  }
+  k = std::min(k, numItems);
+
+  arma::Mat<size_t> candidates;
+  if (k > 0)
+    itemSearch.Search(userVecs, k, candidates);
 
-    for (size_t p = 1; p <= numRecs; p++)
+  // The candidates are sorted by decreasing inner product, so keep the first
+  // ones that the user did not rate.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; ++i)
+  {
+    size_t p = 0;
+    for (size_t j = 0; j < k && p < numRecs; ++j)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      const size_t item = candidates(j, i);
+      if (item >= numItems)
+        continue; // Fewer than k items were found.
+      if (excludeRated && cleanedData(item, users(i)) != 0.0)
+        continue; // The user already rated the item.
+
+      recommendations(p++, i) = item;
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (numRecs > 0 && recommendations(numRecs - 1, i) == numItems)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
@@ -327,14 +529,6 @@ void CFType<DecompositionPolicy,
 Predict(const arma::Mat<size_t>& combinations,
         arma::vec& predictions) const
 {
-  // Now, we must determine those query indices we need to find the nearest
-  // neighbors for.  This is easiest if we just sort the combinations matrix.
-  arma::Mat<size_t> sortedCombinations(combinations.n_rows,
-                                       combinations.n_cols);
-  arma::uvec ordering = arma::sort_index(combinations.row(0).t());
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    sortedCombinations.col(i) = combinations.col(ordering[i]);
-
   // Now, we have to get the list of unique users we will be searching for.
   arma::Col<size_t> users = arma::unique(combinations.row(0).t());
 
@@ -351,38 +545,30 @@ Predict(const arma::Mat<size_t>& combinations,
   decomposition.template GetNeighborhood<NeighborSearchPolicy>(
       users, numUsersForSimilarity, neighborhood, similarities);
 
-  arma::mat weights(numUsersForSimilarity, users.n_elem);
-
   // Calculate interpolation weights.
   InterpolationPolicy interpolation(cleanedData);
-  for (size_t i = 0; i < users.n_elem; i++)
-  {
-    interpolation.GetWeights(weights.col(i), decomposition, users[i],
-        neighborhood.col(i), similarities.col(i), cleanedData);
-  }
+  arma::mat weights;
+  interpolation.GetWeights(weights, decomposition, users, neighborhood,
+      similarities, cleanedData);
 
   // Now that we have the neighborhoods we need, calculate the predictions.
+  // The users are sorted, so the neighborhood of the user of a combination is
+  // found by binary search.
   predictions.set_size(combinations.n_cols);
-
-  size_t user = 0; // Cumulative user count, because we are doing it in order.
-  for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
+  ParallelFor(0, combinations.n_cols, [&](const size_t i)
   {
-    // Could this be made faster by calculating dot products for multiple items
-    // at once?
-    double rating = 0.0;
-
-    // Map the combination's user to the user ID used for kNN.
-    while (users[user] < sortedCombinations(0, i))
-      ++user;
+    const size_t user = std::lower_bound(users.begin(), users.end(),
+        combinations(0, i)) - users.begin();
 
+    double rating = 0.0;
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
       rating += weights(j, user) * decomposition.GetRating(
-          neighborhood(j, user), sortedCombinations(1, i));
+          neighborhood(j, user), combinations(1, i));
     }
 
-    predictions(ordering[i]) = rating;
-  }
+    predictions(i) = rating;
+  }, 256);
 
   // Denormalize ratings.
   normalization.Denormalize(combinations, predictions);
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/methods/bias_svd/bias_svd.hpp>
+#include "fold_in.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -106,6 +107,71 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get the weighted sums of the predicted ratings of sets of users: column i
+   * of ratings is the sum of the predicted ratings of the users in column i of
+   * neighborhood, weighted by column i of weights.  The user
+   * vectors and biases are combined first, so all of the sets are rated with
+   * one matrix multiplication.
+   *
+   * @param neighborhood Users whose ratings are summed, one set per column.
+   * @param weights Weights of the users in neighborhood.
+   * @param ratings Resulting rating matrix, with one column per set of users.
+   */
+  void GetWeightedRatings(const arma::Mat<size_t>& neighborhood,
+                          const arma::mat& weights,
+                          arma::mat& ratings) const
+  {
+    arma::mat userVecs;
+    GetWeightedUserVectors(neighborhood, weights, userVecs);
+    ratings = arma::join_rows(w, p) * userVecs;
+
+    // Add the weighted user biases.
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        ratings.col(i) += weights(j, i) * q(neighborhood(j, i));
+  }
+
+  /**
+   * Get the item vectors, one column per item; the item bias is the last
+   * element of each vector.  The weighted ratings of a set of users (see
+   * GetWeightedRatings()) are the inner products of the item vectors with the
+   * weighted user vector of the set, up to a constant for each set (the
+   * weighted user biases), so the best items can be found with maximum inner
+   * product search.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the weighted user vectors of sets of users, for maximum inner product
+   * search with the item vectors (see GetItemVectors()).  The last element of
+   * each vector is the sum of the weights, which multiplies the item biases.
+   *
+   * @param neighborhood Users whose vectors are summed, one set per column.
+   * @param weights Weights of the users in neighborhood.
+   * @param userVecs Resulting user vectors, one column per set of users.
+   */
+  void GetWeightedUserVectors(const arma::Mat<size_t>& neighborhood,
+                              const arma::mat& weights,
+                              arma::mat& userVecs) const
+  {
+    userVecs.zeros(h.n_rows + 1, neighborhood.n_cols);
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        userVecs.col(i).head(h.n_rows) += weights(j, i) *
+            h.col(neighborhood(j, i));
+        userVecs(h.n_rows, i) += weights(j, i);
+      }
+    }
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -136,6 +202,40 @@ class BiasSVDPolicy
         query, numUsersForSimilarity, neighborhood, similarities);
   }
 
+  /**
+   * Find the factors and the biases of the given users with the item matrix
+   * and the item biases fixed, by regularized least squares (see
+   * FoldInFactors()), without training the model again.  The user matrix
+   * grows to hold all the users of the data.
+   *
+   * @param cleanedData Item user table, with the ratings of the users.
+   * @param users Users to find the factors of.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    FoldInBiasedUserFactors(w, p, cleanedData, users, lambda, h, q);
+  }
+
+  /**
+   * Find the factors and the biases of the given items with the user matrix
+   * and the user biases fixed, by regularized least squares (see
+   * FoldInFactors()), without training the model again.  The item matrix
+   * grows to hold all the items of the data.
+   *
+   * @param cleanedData Item user table, with the ratings of the items.
+   * @param items Items to find the factors of.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    FoldInBiasedItemFactors(h, q, cleanedData, items, lambda, w, p);
+  }
+
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
   //! Get the User Matrix.
@@ -0,0 +1,209 @@
+/**
+ * @file fold_in.hpp
+ *
+ * Functions that find the factors of new users or items of a trained
+ * decomposition, with the factors of the other side fixed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Find the factors of the given columns of a sparse rating matrix, with the
+ * factors of its rows fixed, by regularized least squares.  The factors x of
+ * column j minimize
+ *
+ *   sum_i (r_ij - o_i - f_i^T x)^2 + lambda n_j ||x||^2
+ *
+ * over the rows i rated in column j, where f_i is the fixed factor of row i,
+ * o_i its offset and n_j the number of ratings of column j (the scaling of
+ * ALS-WR).  This is a small (rank x rank) linear system for each column.  A
+ * column without ratings gets zero factors.
+ *
+ * @param fixed Fixed factors, with one column per row of the ratings.
+ * @param offsets Offset of each row of the ratings; if empty, no offsets are
+ *     used.
+ * @param ratings Sparse rating matrix.
+ * @param columns Columns of the ratings to find the factors of.
+ * @param lambda Regularization parameter.
+ * @param factors Resulting factors, one column per given column.
+ */
+inline void FoldInFactors(const arma::mat& fixed,
+                          const arma::vec& offsets,
+                          const arma::sp_mat& ratings,
+                          const arma::uvec& columns,
+                          const double lambda,
+                          arma::mat& factors)
+{
+  // The ratings of each column are gathered first, so that the sparse matrix
+  // is only read by one thread.
+  std::vector<arma::uvec> rows(columns.n_elem);
+  std::vector<arma::vec> values(columns.n_elem);
+  for (size_t j = 0; j < columns.n_elem; ++j)
+  {
+    const size_t count = std::distance(ratings.begin_col(columns[j]),
+        ratings.end_col(columns[j]));
+    rows[j].set_size(count);
+    values[j].set_size(count);
+
+    arma::sp_mat::const_iterator it = ratings.begin_col(columns[j]);
+    for (size_t k = 0; k < count; ++k, ++it)
+    {
+      rows[j][k] = it.row();
+      values[j][k] = *it;
+    }
+  }
+
+  factors.zeros(fixed.n_rows, columns.n_elem);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) columns.n_elem; ++j)
+  {
+    if (rows[j].n_elem == 0)
+      continue;
+
+    const arma::mat f = fixed.cols(rows[j]);
+    const arma::vec r = offsets.is_empty() ? values[j] :
+        arma::vec(values[j] - offsets.elem(rows[j]));
+
+    arma::mat gram = f * f.t();
+    gram.diag() += lambda * rows[j].n_elem;
+
+    arma::vec x;
+    if (arma::solve(x, gram, f * r))
+      factors.col(j) = x;
+  }
+}
+
+/**
+ * Find the factors of the given users, with the item matrix fixed, and store
+ * them in the user matrix, which grows to hold all the users of the ratings.
+ *
+ * @param w Item matrix, with one row per item.
+ * @param cleanedData Item user table, with the ratings of the users.
+ * @param users Users to find the factors of.
+ * @param lambda Regularization parameter.
+ * @param h User matrix, with one column per user.
+ */
+inline void FoldInUserFactors(const arma::mat& w,
+                              const arma::sp_mat& cleanedData,
+                              const arma::Col<size_t>& users,
+                              const double lambda,
+                              arma::mat& h)
+{
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(users);
+  arma::mat factors;
+  FoldInFactors(w.t(), arma::vec(), cleanedData, columns, lambda, factors);
+
+  if (cleanedData.n_cols > h.n_cols)
+    h.resize(w.n_cols, cleanedData.n_cols);
+  h.cols(columns) = factors;
+}
+
+/**
+ * Find the factors of the given items, with the user matrix fixed, and store
+ * them in the item matrix, which grows to hold all the items of the ratings.
+ *
+ * @param h User matrix, with one column per user.
+ * @param cleanedData Item user table, with the ratings of the items.
+ * @param items Items to find the factors of.
+ * @param lambda Regularization parameter.
+ * @param w Item matrix, with one row per item.
+ */
+inline void FoldInItemFactors(const arma::mat& h,
+                              const arma::sp_mat& cleanedData,
+                              const arma::Col<size_t>& items,
+                              const double lambda,
+                              arma::mat& w)
+{
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(items);
+  arma::mat factors;
+  FoldInFactors(h, arma::vec(), cleanedData.t(), columns, lambda, factors);
+
+  if (cleanedData.n_rows > w.n_rows)
+    w.resize(cleanedData.n_rows, h.n_rows);
+  w.rows(columns) = factors.t();
+}
+
+/**
+ * Find the factors and the biases of the given users, with the item matrix
+ * and the item biases fixed: a rating is w_i^T h_u + p_i + q_u, so the user
+ * bias is one more factor whose item factor is 1.
+ *
+ * @param w Item matrix, with one row per item.
+ * @param p Item biases.
+ * @param cleanedData Item user table, with the ratings of the users.
+ * @param users Users to find the factors of.
+ * @param lambda Regularization parameter.
+ * @param h User matrix, with one column per user.
+ * @param q User biases.
+ */
+inline void FoldInBiasedUserFactors(const arma::mat& w,
+                                    const arma::vec& p,
+                                    const arma::sp_mat& cleanedData,
+                                    const arma::Col<size_t>& users,
+                                    const double lambda,
+                                    arma::mat& h,
+                                    arma::vec& q)
+{
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(users);
+  arma::mat factors;
+  FoldInFactors(arma::join_cols(w.t(), arma::ones<arma::rowvec>(w.n_rows)),
+      p, cleanedData, columns, lambda, factors);
+
+  if (cleanedData.n_cols > h.n_cols)
+  {
+    h.resize(w.n_cols, cleanedData.n_cols);
+    q.resize(cleanedData.n_cols);
+  }
+  h.cols(columns) = factors.head_rows(w.n_cols);
+  q.elem(columns) = factors.row(w.n_cols).t();
+}
+
+/**
+ * Find the factors and the biases of the given items, with the user matrix
+ * and the user biases fixed.
+ *
+ * @param h User matrix, with one column per user.
+ * @param q User biases.
+ * @param cleanedData Item user table, with the ratings of the items.
+ * @param items Items to find the factors of.
+ * @param lambda Regularization parameter.
+ * @param w Item matrix, with one row per item.
+ * @param p Item biases.
+ */
+inline void FoldInBiasedItemFactors(const arma::mat& h,
+                                    const arma::vec& q,
+                                    const arma::sp_mat& cleanedData,
+                                    const arma::Col<size_t>& items,
+                                    const double lambda,
+                                    arma::mat& w,
+                                    arma::vec& p)
+{
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(items);
+  arma::mat factors;
+  FoldInFactors(arma::join_cols(h, arma::ones<arma::rowvec>(h.n_cols)), q,
+      cleanedData.t(), columns, lambda, factors);
+
+  if (cleanedData.n_rows > w.n_rows)
+  {
+    w.resize(cleanedData.n_rows, h.n_rows);
+    p.resize(cleanedData.n_rows);
+  }
+  w.rows(columns) = factors.head_rows(h.n_rows).t();
+  p.elem(columns) = factors.row(h.n_rows).t();
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
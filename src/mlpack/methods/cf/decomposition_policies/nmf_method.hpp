@@ -18,6 +18,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
+#include "fold_in.hpp"
 
 namespace mlpack {
 namespace cf {
@@ -104,6 +105,55 @@ class NMFPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get the weighted sums of the predicted ratings of sets of users: column i
+   * of ratings is the sum of the predicted ratings of the users in column i of
+   * neighborhood, weighted by column i of weights.  Since the ratings
+   * are linear in the user matrix, all of the sets are rated with one matrix
+   * multiplication.
+   *
+   * @param neighborhood Users whose ratings are summed, one set per column.
+   * @param weights Weights of the users in neighborhood.
+   * @param ratings Resulting rating matrix, with one column per set of users.
+   */
+  void GetWeightedRatings(const arma::Mat<size_t>& neighborhood,
+                          const arma::mat& weights,
+                          arma::mat& ratings) const
+  {
+    arma::mat userVecs;
+    GetWeightedUserVectors(neighborhood, weights, userVecs);
+    ratings = w * userVecs;
+  }
+
+  /**
+   * Get the item vectors, one column per item.  The weighted ratings of a set
+   * of users (see GetWeightedRatings()) are the inner products of the item
+   * vectors with the weighted user vector of the set, up to a constant for
+   * each set, so the best items can be found with maximum inner product
+   * search.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const { items = w.t(); }
+
+  /**
+   * Get the weighted user vectors of sets of users, for maximum inner product
+   * search with the item vectors (see GetItemVectors()).
+   *
+   * @param neighborhood Users whose vectors are summed, one set per column.
+   * @param weights Weights of the users in neighborhood.
+   * @param userVecs Resulting user vectors, one column per set of users.
+   */
+  void GetWeightedUserVectors(const arma::Mat<size_t>& neighborhood,
+                              const arma::mat& weights,
+                              arma::mat& userVecs) const
+  {
+    userVecs.zeros(h.n_rows, neighborhood.n_cols);
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        userVecs.col(i) += weights(j, i) * h.col(neighborhood(j, i));
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -143,6 +193,44 @@ class NMFPolicy
         query, numUsersForSimilarity, neighborhood, similarities);
   }
 
+  /**
+   * Find the factors of the given users with the item matrix fixed, by
+   * regularized least squares (see FoldInFactors()), without training the
+   * model again.  The user matrix grows to hold all the users of the data.
+   *
+   * @param cleanedData Item user table, with the ratings of the users.
+   * @param users Users to find the factors of.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& users,
+                   const double lambda)
+  {
+    FoldInUserFactors(w, cleanedData, users, lambda, h);
+
+    // The factors of NMF are nonnegative.
+    h.elem(arma::find(h < 0)).zeros();
+  }
+
+  /**
+   * Find the factors of the given items with the user matrix fixed, by
+   * regularized least squares (see FoldInFactors()), without training the
+   * model again.  The item matrix grows to hold all the items of the data.
+   *
+   * @param cleanedData Item user table, with the ratings of the items.
+   * @param items Items to find the factors of.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& cleanedData,
+                   const arma::Col<size_t>& items,
+                   const double lambda)
+  {
+    FoldInItemFactors(h, cleanedData, items, lambda, w);
+
+    // The factors of NMF are nonnegative.
+    w.elem(arma::find(w < 0)).zeros();
+  }
+
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
   //! Get the User Matrix.
@@ -95,20 +95,8 @@ class SVDPlusPlusPolicy
    */
   double GetRating(const size_t user, const size_t item) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    GetUserVector(user, userVec);
 
     double rating =
         arma::as_scalar(w.row(item) * userVec) + p(item) + q(user);
@@ -123,24 +111,79 @@ class SVDPlusPlusPolicy
    */
   void GetRatingOfUser(const size_t user, arma::vec& rating) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows, arma::fill::zeros);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    GetUserVector(user, userVec);
 
     rating = w * userVec + p + q(user);
   }
 
+  /**
+   * Get the weighted sums of the predicted ratings of sets of users: column i
+   * of ratings is the sum of the predicted ratings of the users in column i of
+   * neighborhood, weighted by column i of weights.  The user vectors and biases
+   * are combined first, so all of the sets are rated with one matrix
+   * multiplication.
+   *
+   * @param neighborhood Users whose ratings are summed, one set per column.
+   * @param weights Weights of the users in neighborhood.
+   * @param ratings Resulting rating matrix, with one column per set of users.
+   */
+  void GetWeightedRatings(const arma::Mat<size_t>& neighborhood,
+                          const arma::mat& weights,
+                          arma::mat& ratings) const
+  {
+    arma::mat userVecs;
+    GetWeightedUserVectors(neighborhood, weights, userVecs);
+    ratings = arma::join_rows(w, p) * userVecs;
+
+    // Add the weighted user biases.
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        ratings.col(i) += weights(j, i) * q(neighborhood(j, i));
+  }
+
+  /**
+   * Get the item vectors, one column per item; the item bias is the last
+   * element of each vector.  The weighted ratings of a set of users (see
+   * GetWeightedRatings()) are the inner products of the item vectors with the
+   * weighted user vector of the set, up to a constant for each set (the
+   * weighted user biases), so the best items can be found with maximum inner
+   * product search.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the weighted user vectors (including the implicit feedback) of sets of
+   * users, for maximum inner product search with the item vectors (see
+   * GetItemVectors()).  The last element of each vector is the sum of the
+   * weights, which multiplies the item biases.
+   *
+   * @param neighborhood Users whose vectors are summed, one set per column.
+   * @param weights Weights of the users in neighborhood.
+   * @param userVecs Resulting user vectors, one column per set of users.
+   */
+  void GetWeightedUserVectors(const arma::Mat<size_t>& neighborhood,
+                              const arma::mat& weights,
+                              arma::mat& userVecs) const
+  {
+    userVecs.zeros(h.n_rows + 1, neighborhood.n_cols);
+    arma::vec userVec;
+    for (size_t i = 0; i < neighborhood.n_cols; ++i)
+    {
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        GetUserVector(neighborhood(j, i), userVec);
+        userVecs.col(i).head(h.n_rows) += weights(j, i) * userVec;
+        userVecs(h.n_rows, i) += weights(j, i);
+      }
+    }
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -217,6 +260,31 @@ class SVDPlusPlusPolicy
   }
 
  private:
+  /**
+   * Get the vector of the given user, including the implicit feedback of the
+   * items the user interacted with.
+   *
+   * @param user User ID.
+   * @param userVec Resulting user vector.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVec) const
+  {
+    // Iterate through each item which the user interacted with to calculate
+    // user vector.
+    userVec.zeros(h.n_rows);
+    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+    size_t implicitCount = 0;
+    for (; it != it_end; ++it)
+    {
+      userVec += y.col(it.row());
+      implicitCount += 1;
+    }
+    if (implicitCount != 0)
+      userVec /= std::sqrt(implicitCount);
+    userVec += h.col(user);
+  }
+
   //! Locally stored number of iterations.
   size_t maxIterations;
   //! Learning rate for optimization.
@@ -84,6 +84,35 @@ class AverageInterpolation
 
     weights.fill(1.0 / neighbors.n_elem);
   }
+
+  /**
+   * Compute the interpolation weights of each of the given users.
+   *
+   * @param weights Resulting interpolation weights, one column for each user.
+   * @param decomposition Decomposition object.
+   * @param users Queried users.
+   * @param neighborhood Neighbors of each queried user, one column each.
+   * @param similarities Similarites between each query user and its
+   *     neighbors.
+   * @param cleanedData Sparse rating matrix.
+   */
+  template <typename DecompositionPolicy>
+  void GetWeights(arma::mat& weights,
+                  const DecompositionPolicy& /* decomposition */,
+                  const arma::Col<size_t>& users,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& /* similarities */,
+                  const arma::sp_mat& /* cleanedData */)
+  {
+    if (users.n_elem > 0 && neighborhood.n_rows == 0)
+    {
+      Log::Fatal << "Require: neighborhood.n_rows > 0. There should be at "
+          << "least one neighbor!" << std::endl;
+    }
+
+    weights.set_size(neighborhood.n_rows, users.n_elem);
+    weights.fill(1.0 / neighborhood.n_rows);
+  }
 };
 
 } // namespace cf
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_CF_REGRESSION_INTERPOLATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -62,16 +63,12 @@ class RegressionInterpolation
   RegressionInterpolation() { }
 
   /**
-   * Use cleanedData to perform necessary preprocessing.
+   * This constructor is needed for interface consistency; the coefficients of
+   * the linear systems are computed by the first call of GetWeights().
    *
    * @param cleanedData Sparse rating matrix.
    */
-  RegressionInterpolation(const arma::sp_mat& cleanedData)
-  {
-    const size_t userNum = cleanedData.n_cols;
-    a.set_size(userNum, userNum);
-    b.set_size(userNum, userNum);
-  }
+  RegressionInterpolation(const arma::sp_mat& /* cleanedData */) { }
 
   /**
    * The regression-based interpolation problem can be solved by a linear
@@ -82,6 +79,12 @@ class RegressionInterpolation
    * multiplies each neighbor's rating by its corresponding weight and sums
    * them to get predicted rating.
    *
+   * The coefficient of neighbors v and w is the inner product of their
+   * predicted ratings divided by the number of items, h_v^T (W^T W) h_w /
+   * itemNum, so W^T W / itemNum is computed once, on the first call, and
+   * reused by all the later calls of this object; the decomposition must not
+   * change between calls.
+   *
    * @param weights Resulting interpolation weights. The size of weights should
    *     be set to the number of neighbors before calling GetWeights().
    * @param decomposition Decomposition object.
@@ -106,80 +109,115 @@ class RegressionInterpolation
           << std::endl;
     }
 
-    const arma::mat& w = decomposition.W();
-    const arma::mat& h = decomposition.H();
-    const size_t itemNum = cleanedData.n_rows;
-    const size_t neighborNum = neighbors.size();
+    CacheCoefficients(decomposition.W(), cleanedData);
 
-    // Coeffcients of the linear equations used to compute weights.
-    arma::mat coeff(neighborNum, neighborNum);
-    // Constant terms of the linear equations used to compute weights.
-    arma::vec constant(neighborNum);
+    arma::vec userWeights;
+    ComputeWeights(userWeights, decomposition.W(), decomposition.H(),
+        queryUser, neighbors, cleanedData);
+    weights = userWeights;
+  }
+
+  /**
+   * Compute the interpolation weights of each of the given users, in
+   * parallel.  The systems of all of the users share the coefficients cached
+   * by this object (see the other overload of GetWeights()).
+   *
+   * @param weights Resulting interpolation weights, one column for each user.
+   * @param decomposition Decomposition object.
+   * @param users Queried users.
+   * @param neighborhood Neighbors of each queried user, one column each.
+   * @param similarities Similarites between each query user and its
+   *     neighbors.
+   * @param cleanedData Sparse rating matrix.
+   */
+  template <typename DecompositionPolicy>
+  void GetWeights(arma::mat& weights,
+                  const DecompositionPolicy& decomposition,
+                  const arma::Col<size_t>& users,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& /* similarities */,
+                  const arma::sp_mat& cleanedData)
+  {
+    if (neighborhood.n_cols != users.n_elem)
+    {
+      Log::Fatal << "The neighborhood should have one column for each of the "
+          << "users passed to GetWeights()." << std::endl;
+    }
+
+    CacheCoefficients(decomposition.W(), cleanedData);
 
-    arma::vec userRating(cleanedData.col(queryUser));
-    const size_t support = arma::accu(userRating != 0);
+    // Each thread solves the small systems of its users.
+    weights.set_size(neighborhood.n_rows, users.n_elem);
+    ParallelFor(0, users.n_elem, [&](const size_t i)
+    {
+      arma::vec userWeights;
+      ComputeWeights(userWeights, decomposition.W(), decomposition.H(),
+          users(i), neighborhood.col(i), cleanedData);
+      weights.col(i) = userWeights;
+    }, 16);
+  }
+
+ private:
+  /**
+   * Compute W^T W / itemNum, the coefficients of the linear systems before
+   * they are projected onto the neighbors, if it hasn't been computed yet.
+   */
+  void CacheCoefficients(const arma::mat& w, const arma::sp_mat& cleanedData)
+  {
+    if (gram.n_elem == 0)
+      gram = w.t() * w / cleanedData.n_rows;
+  }
+
+  /**
+   * Solve the linear system of the given user.  If the user has no ratings,
+   * or the system can't be solved, average interpolation is used.
+   */
+  template<typename NeighborsType>
+  void ComputeWeights(arma::vec& weights,
+                      const arma::mat& w,
+                      const arma::mat& h,
+                      const size_t queryUser,
+                      const NeighborsType& neighbors,
+                      const arma::sp_mat& cleanedData) const
+  {
+    const size_t neighborNum = neighbors.n_elem;
+
+    // The constant terms are the inner products of the predicted ratings of
+    // the neighbors with the ratings of the user, so W^T times the ratings of
+    // the user is needed; only the rated items contribute.
+    arma::vec userProjection(w.n_cols, arma::fill::zeros);
+    size_t support = 0;
+    arma::sp_mat::const_iterator it = cleanedData.begin_col(queryUser);
+    for (; it != cleanedData.end_col(queryUser); ++it, ++support)
+      userProjection += (*it) * w.row(it.row()).t();
 
     // If user has no rating at all, average interpolation is used.
     if (support == 0)
     {
-      weights.fill(1.0 / neighbors.n_elem);
+      weights.set_size(neighborNum);
+      weights.fill(1.0 / neighborNum);
       return;
     }
 
-    for (size_t i = 0; i < neighborNum; i++)
+    arma::mat neighborVectors(h.n_rows, neighborNum);
+    for (size_t i = 0; i < neighborNum; ++i)
+      neighborVectors.col(i) = h.col(neighbors(i));
+
+    // Coeffcients of the linear equations used to compute weights.
+    const arma::mat coeff = neighborVectors.t() * gram * neighborVectors;
+    // Constant terms of the linear equations used to compute weights.
+    const arma::vec constant = neighborVectors.t() * userProjection / support;
+
+    if (!arma::solve(weights, coeff, constant))
     {
-      // Calculate coefficient.
-      arma::vec iPrediction;
-      for (size_t j = i; j < neighborNum; j++)
-      {
-        if (a(neighbors(i), neighbors(j)) != 0)
-        {
-          // The coefficient has already been cached.
-          coeff(i, j) = a(neighbors(i), neighbors(j));
-          coeff(j, i) = coeff(i, j);
-        }
-        else
-        {
-          // Calculate the coefficient.
-          if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-          arma::vec jPrediction = w * h.col(neighbors(j));
-          coeff(i, j) = arma::dot(iPrediction, jPrediction) / itemNum;
-          if (coeff(i, j) == 0)
-            coeff(i, j) = std::numeric_limits<double>::min();
-          coeff(j, i) = coeff(i, j);
-          // Cache calcualted coefficient.
-          a(neighbors(i), neighbors(j)) = coeff(i, j);
-          a(neighbors(j), neighbors(i)) = coeff(i, j);
-        }
-      }
-
-      // Calculate constant terms.
-      if (b(neighbors(i), queryUser) != 0)
-        // The constant term has already been cached.
-        constant(i) = b(neighbors(i), queryUser);
-      else
-      {
-        // Calcuate the constant term.
-        if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-        constant(i) = arma::dot(iPrediction, userRating) / support;
-        if (constant(i) == 0)
-          constant(i) = std::numeric_limits<double>::min();
-        // Cache calculated constant term.
-        b(neighbors(i), queryUser) = constant(i);
-      }
+      weights.set_size(neighborNum);
+      weights.fill(1.0 / neighborNum);
     }
-    weights = arma::solve(coeff, constant);
   }
 
- private:
-  //! Cached coefficients used in linear equations to compute weights.
-  arma::sp_mat a;
-  //! Cached constant terms used in linear equations to compute weights.
-  arma::sp_mat b;
+  //! W^T W divided by the number of items, cached by the first call of
+  //! GetWeights().
+  arma::mat gram;
 };
 
 } // namespace cf
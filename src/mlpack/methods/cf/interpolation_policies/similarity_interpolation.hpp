@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_CF_SIMILARITY_INTERPOLATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
 
 namespace mlpack {
 namespace cf {
@@ -94,6 +95,51 @@ class SimilarityInterpolation
       weights = similarities / similaritiesSum;
     }
   }
+
+  /**
+   * Compute the interpolation weights of each of the given users, in
+   * parallel.
+   *
+   * @param weights Resulting interpolation weights, one column for each user.
+   * @param decomposition Decomposition object.
+   * @param users Queried users.
+   * @param neighborhood Neighbors of each queried user, one column each.
+   * @param similarities Similarites between each query user and its
+   *     neighbors.
+   * @param cleanedData Sparse rating matrix.
+   */
+  template <typename DecompositionPolicy>
+  void GetWeights(arma::mat& weights,
+                  const DecompositionPolicy& /* decomposition */,
+                  const arma::Col<size_t>& users,
+                  const arma::Mat<size_t>& neighborhood,
+                  const arma::mat& similarities,
+                  const arma::sp_mat& /* cleanedData */)
+  {
+    if (users.n_elem > 0 && similarities.n_rows == 0)
+    {
+      Log::Fatal << "Require: similarities.n_rows > 0. There should be at "
+          << "least one neighbor!" << std::endl;
+    }
+
+    if (similarities.n_rows != neighborhood.n_rows ||
+        similarities.n_cols != users.n_elem)
+    {
+      Log::Fatal << "The similarities should have one column for each of the "
+          << "users passed to GetWeights(), with one similarity for each "
+          << "neighbor." << std::endl;
+    }
+
+    weights.set_size(similarities.n_rows, users.n_elem);
+    ParallelFor(0, users.n_elem, [&](const size_t i)
+    {
+      const double similaritiesSum = arma::accu(similarities.col(i));
+      if (std::fabs(similaritiesSum) < 1e-14)
+        weights.col(i).fill(1.0 / similarities.n_rows);
+      else
+        weights.col(i) = similarities.col(i) / similaritiesSum;
+    }, 256);
+  }
 };
 
 } // namespace cf
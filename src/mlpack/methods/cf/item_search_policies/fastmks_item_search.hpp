@@ -0,0 +1,103 @@
+/**
+ * @file fastmks_item_search.hpp
+ *
+ * Exact search for the best items of a set of users with FastMKS.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_FASTMKS_ITEM_SEARCH_HPP
+#define MLPACK_METHODS_CF_FASTMKS_ITEM_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Search for the items with the largest inner products with the user vectors,
+ * with a cover tree built on the item vectors (FastMKS with the linear
+ * kernel).  The tree is built the first time the object is used and reused
+ * for all later searches, so one FastMKSItemSearch object should be kept
+ * for as long as the CF model does not change.
+ *
+ * An example of how to use FastMKSItemSearch in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<> cf(data);
+ *
+ * // Generate 10 recommendations for the users; the index is built once.
+ * FastMKSItemSearch itemSearch;
+ * cf.GetRecommendations(itemSearch, 10, recommendations, users);
+ * @endcode
+ */
+class FastMKSItemSearch
+{
+ public:
+  //! The FastMKS type used for the search.
+  typedef fastmks::FastMKS<kernel::LinearKernel> FastMKSType;
+
+  /**
+   * Create the FastMKSItemSearch object.  The index is built by Train().
+   *
+   * @param singleMode Whether or not to run single-tree search.
+   */
+  FastMKSItemSearch(const bool singleMode = false) :
+      fastmks(singleMode),
+      trained(false)
+  { }
+
+  /**
+   * Build the index on the given item vectors.  The item vectors are stored in
+   * this object, because the tree refers to them.
+   *
+   * @param items Item vectors, one column per item.
+   */
+  void Train(arma::mat items)
+  {
+    itemVecs = std::move(items);
+    fastmks.Train(itemVecs);
+    trained = true;
+  }
+
+  //! Return whether the index has been built.
+  bool Trained() const { return trained; }
+
+  /**
+   * Find the k items with the largest inner product with each of the user
+   * vectors, in decreasing order of inner product.
+   *
+   * @param userVecs User vectors, one column per user.
+   * @param k Number of items to search for.
+   * @param items Resulting items, one column per user.
+   */
+  void Search(const arma::mat& userVecs,
+              const size_t k,
+              arma::Mat<size_t>& items)
+  {
+    arma::mat products;
+    fastmks.Search(userVecs, k, items, products);
+  }
+
+ private:
+  //! The item vectors the index is built on.
+  arma::mat itemVecs;
+  //! The FastMKS object.
+  FastMKSType fastmks;
+  //! Whether the index has been built.
+  bool trained;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
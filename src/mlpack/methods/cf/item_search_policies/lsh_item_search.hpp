@@ -0,0 +1,140 @@
+/**
+ * @file lsh_item_search.hpp
+ *
+ * Approximate search for the best items of a set of users with LSH.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_LSH_ITEM_SEARCH_HPP
+#define MLPACK_METHODS_CF_LSH_ITEM_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/lsh/lsh_search.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Approximate search for the items with the largest inner products with the
+ * user vectors, with locality-sensitive hashing.  LSH searches for nearest
+ * neighbors in the Euclidean distance, so the maximum inner product search is
+ * reduced to a nearest neighbor search as in the paper below: every item
+ * vector x gets the extra dimension sqrt(M^2 - ||x||^2) (where M is the largest
+ * norm of the item vectors), and every user vector q gets the extra dimension
+ * 0.  Then ||q - x||^2 = ||q||^2 + M^2 - 2 q^T x, so the nearest items are the
+ * ones with the largest inner product.
+ *
+ * @code
+ * @inproceedings{bachrach2014speeding,
+ *   title={Speeding up the Xbox recommender system using a Euclidean
+ *       transformation for inner-product spaces},
+ *   author={Bachrach, Yoram and Finkelstein, Yehuda and Gilad-Bachrach, Ran
+ *       and Katzir, Liran and Koenigstein, Noam and Nice, Nir and Paquet,
+ *       Ulrich},
+ *   booktitle={Proceedings of the 8th ACM Conference on Recommender Systems},
+ *   pages={257--264},
+ *   year={2014}
+ * }
+ * @endcode
+ *
+ * The hash tables are built the first time the object is used and reused for
+ * all later searches, so one LSHItemSearch object should be kept for as long
+ * as the CF model does not change.  See FastMKSItemSearch for an example.
+ */
+class LSHItemSearch
+{
+ public:
+  /**
+   * Create the LSHItemSearch object with the given LSH parameters.  The hash
+   * tables are built by Train().  See LSHSearch for the meaning of the
+   * parameters.
+   *
+   * @param numProj Number of projections in each hash table.
+   * @param numTables Total number of hash tables.
+   * @param hashWidth Width of the hash bucket (0 to compute it from the data).
+   * @param secondHashSize Size of the second level hash table.
+   * @param bucketSize Maximum size of a bucket in the second level hash table.
+   */
+  LSHItemSearch(const size_t numProj = 10,
+                const size_t numTables = 30,
+                const double hashWidth = 0.0,
+                const size_t secondHashSize = 99901,
+                const size_t bucketSize = 500) :
+      numProj(numProj),
+      numTables(numTables),
+      hashWidth(hashWidth),
+      secondHashSize(secondHashSize),
+      bucketSize(bucketSize),
+      trained(false)
+  { }
+
+  /**
+   * Build the hash tables on the given item vectors.
+   *
+   * @param items Item vectors, one column per item.
+   */
+  void Train(arma::mat items)
+  {
+    // Add the extra dimension that makes all the item vectors have the same
+    // norm.
+    const arma::rowvec squaredNorms = arma::sum(arma::square(items));
+    const double maxSquaredNorm = squaredNorms.is_empty() ? 0.0 :
+        squaredNorms.max();
+    items.resize(items.n_rows + 1, items.n_cols);
+    items.row(items.n_rows - 1) = arma::sqrt(arma::clamp(maxSquaredNorm -
+        squaredNorms, 0.0, maxSquaredNorm));
+
+    lsh.Train(std::move(items), numProj, numTables, hashWidth, secondHashSize,
+        bucketSize);
+    trained = true;
+  }
+
+  //! Return whether the hash tables have been built.
+  bool Trained() const { return trained; }
+
+  /**
+   * Find (approximately) the k items with the largest inner product with each
+   * of the user vectors, in decreasing order of inner product.  If fewer than
+   * k items are found for a user, the remaining items are set to the number of
+   * items.
+   *
+   * @param userVecs User vectors, one column per user.
+   * @param k Number of items to search for.
+   * @param items Resulting items, one column per user.
+   */
+  void Search(const arma::mat& userVecs,
+              const size_t k,
+              arma::Mat<size_t>& items)
+  {
+    arma::mat queries(userVecs.n_rows + 1, userVecs.n_cols);
+    queries.head_rows(userVecs.n_rows) = userVecs;
+    queries.row(userVecs.n_rows).zeros();
+
+    arma::mat distances;
+    lsh.Search(queries, k, items, distances);
+  }
+
+ private:
+  //! Number of projections in each hash table.
+  size_t numProj;
+  //! Total number of hash tables.
+  size_t numTables;
+  //! Width of the hash bucket.
+  double hashWidth;
+  //! Size of the second level hash table.
+  size_t secondHashSize;
+  //! Maximum size of a bucket in the second level hash table.
+  size_t bucketSize;
+  //! The LSH object.
+  neighbor::LSHSearch<> lsh;
+  //! Whether the hash tables have been built.
+  bool trained;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -117,6 +117,49 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize ratings that are folded into a trained model.  The items the
+   * model was trained on keep their means, and the means of the other items
+   * are computed from the given ratings.
+   *
+   * @param data Ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t knownNum = itemMean.n_elem;
+    const size_t itemNum = std::max(knownNum,
+        (size_t) arma::max(data.row(1)) + 1);
+    itemMean.resize(itemNum);
+    arma::Row<size_t> ratingNum(itemNum, arma::fill::zeros);
+
+    // Sum the ratings of each new item.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item >= knownNum)
+      {
+        itemMean(item) += datapoint(2);
+        ratingNum(item) += 1;
+      }
+    });
+
+    for (size_t i = knownNum; i < itemNum; i++)
+    {
+      if (ratingNum(i) != 0)
+        itemMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      datapoint(2) -= itemMean(item);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
@@ -36,6 +36,13 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param data Ratings that are folded into a trained model.
+   */
+  inline void FoldIn(const arma::mat& /* data */) const { }
+
   /**
    * Do nothing.
    *
@@ -90,6 +90,24 @@ class OverallMeanNormalization
     }
   }
 
+  /**
+   * Normalize ratings that are folded into a trained model by subtracting the
+   * mean of the ratings the model was trained on.
+   *
+   * @param data Ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) -= mean;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive double value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean.
    *
@@ -117,6 +117,49 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize ratings that are folded into a trained model.  The users the
+   * model was trained on keep their means, and the means of the other users
+   * are computed from the given ratings.
+   *
+   * @param data Ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t knownNum = userMean.n_elem;
+    const size_t userNum = std::max(knownNum,
+        (size_t) arma::max(data.row(0)) + 1);
+    userMean.resize(userNum);
+    arma::Row<size_t> ratingNum(userNum, arma::fill::zeros);
+
+    // Sum the ratings of each new user.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user >= knownNum)
+      {
+        userMean(user) += datapoint(2);
+        ratingNum(user) += 1;
+      }
+    });
+
+    for (size_t i = knownNum; i < userNum; i++)
+    {
+      if (ratingNum(i) != 0)
+        userMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      datapoint(2) -= userMean(user);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
@@ -100,6 +100,24 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize ratings that are folded into a trained model with the mean and
+   * the standard deviation of the ratings the model was trained on.
+   *
+   * @param data Ratings in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data) const
+  {
+    data.row(2) = (data.row(2) - mean) / stddev;
+    // The algorithm omits rating of zero. If normalized rating equals zero,
+    // it is set to the smallest positive double value.
+    data.row(2).for_each([](double& x)
+    {
+      if (x == 0)
+        x = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
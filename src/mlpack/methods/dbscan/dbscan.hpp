@@ -16,6 +16,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
+#include "dbscan_rules.hpp"
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -44,6 +46,15 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * If DualTreeMode() is set, the clusters are instead found with one dual-tree
+ * traversal of a tree built on the dataset (of type RangeSearchType::Tree),
+ * which unites the points within epsilon of each other as it finds them (see
+ * DBSCANRules), so that no neighbors are stored; this takes memory linear in
+ * the number of points.  Subtrees of the query tree are traversed in parallel
+ * with OpenMP, and the points are united in an emst::ConcurrentUnionFind.  The
+ * RangeSearchType object and the PointSelectionPolicy are not used in this
+ * mode, and the assignments do not depend on the number of threads.
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -112,6 +123,11 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  arma::mat& centroids);
 
+  //! Get whether the clusters are found with the parallel dual-tree mode.
+  bool DualTreeMode() const { return dualTreeMode; }
+  //! Modify whether the clusters are found with the parallel dual-tree mode.
+  bool& DualTreeMode() { return dualTreeMode; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   double epsilon;
@@ -123,12 +139,41 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! Whether or not to find the clusters with the parallel dual-tree mode.
+  bool dualTreeMode;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  /**
+   * A range search callback that unites the given point with each neighbor it
+   * is given, so that the neighbors don't have to be stored.
+   */
+  class UnionCallback
+  {
+   public:
+    //! Create the callback for the given point.
+    UnionCallback(emst::UnionFind& uf, const size_t point) :
+        uf(uf), point(point) { }
+
+    //! Unite the point with the given neighbor.
+    void operator()(const size_t /* queryIndex */,
+                    const size_t referenceIndex,
+                    const double /* distance */)
+    {
+      uf.Union(point, referenceIndex);
+    }
+
+   private:
+    //! The UnionFind structure to modify.
+    emst::UnionFind& uf;
+    //! The point to unite with its neighbors.
+    size_t point;
+  };
+
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
    * also the list of cluster assignments.  This searches each point iteratively,
@@ -155,6 +200,18 @@ class DBSCAN
   template<typename MatType>
   void BatchCluster(const MatType& data,
                     emst::UnionFind& uf);
+
+  /**
+   * Finds the components of the points within epsilon of each other with one
+   * parallel dual-tree traversal that unites the points directly, and stores
+   * the root of the component of each point in the given assignments.
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store the component of each point in.
+   */
+  template<typename MatType>
+  void DualTreeCluster(const MatType& data,
+                       arma::Row<size_t>& assignments);
 };
 
 } // namespace dbscan
@@ -14,6 +14,10 @@
 
 #include "dbscan.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace dbscan {
 
@@ -30,6 +34,7 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    dualTreeMode(false),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -100,19 +105,26 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
-  rangeSearch.Train(data);
-
-  if (batchMode)
-    BatchCluster(data, uf);
+  if (dualTreeMode)
+  {
+    DualTreeCluster(data, assignments);
+  }
   else
-    PointwiseCluster(data, uf);
+  {
+    // Initialize the UnionFind object.
+    emst::UnionFind uf(data.n_cols);
+    rangeSearch.Train(data);
 
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+    if (batchMode)
+      BatchCluster(data, uf);
+    else
+      PointwiseCluster(data, uf);
+
+    // Now set assignments.
+    assignments.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
 
   // Get a count of all clusters.
   const size_t numClusters = arma::max(assignments) + 1;
@@ -152,21 +164,15 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
     emst::UnionFind& uf)
 {
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
-
   for (size_t i = 0; i < data.n_cols; ++i)
   {
     if (i % 10000 == 0 && i > 0)
       Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
-        distances);
-
-    // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    // Do the range search for only this point, and union to all neighbors as
+    // they are found.
+    UnionCallback callback(uf, i);
+    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), callback);
   }
 }
 
@@ -182,11 +188,12 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     emst::UnionFind& uf)
 {
   // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  // The results are stored in the compact format, which takes a constant
+  // number of allocations.
+  range::RangeSearchResult result;
   Log::Info << "Performing range search." << std::endl;
   rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
+  rangeSearch.Search(data, math::Range(0.0, epsilon), result);
   Log::Info << "Range search complete." << std::endl;
 
   // Now loop over all points.
@@ -194,11 +201,101 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   {
     // Get the next index.
     const size_t index = pointSelector.Select(i, data);
-    for (size_t j = 0; j < neighbors[index].size(); ++j)
-      uf.Union(index, neighbors[index][j]);
+    for (size_t j = 0; j < result.NumNeighbors(index); ++j)
+      uf.Union(index, result.Neighbor(index, j));
   }
 }
 
+/**
+ * Finds the components of the points within epsilon of each other with one
+ * dual-tree traversal, in parallel over subtrees of the query tree.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+template<typename MatType>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::DualTreeCluster(
+    const MatType& data,
+    arma::Row<size_t>& assignments)
+{
+  typedef typename RangeSearchType::Tree Tree;
+  typedef typename std::remove_reference<decltype(
+      std::declval<Tree&>().Metric())>::type MetricType;
+
+  // The points are united in the order of the tree, and mapped back at the end.
+  Log::Info << "Building tree." << std::endl;
+  std::vector<size_t> oldFromNew;
+  Tree* tree = range::BuildTree<Tree>(data, oldFromNew);
+
+  // Use a few subtrees per thread so that the dynamic schedule can balance
+  // subtrees that are more expensive to traverse than others.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t targetSubtrees = 4 * numThreads;
+
+  // Expand the query tree level by level until there are enough subtrees.  The
+  // descendants of the children of a node partition the descendants of the
+  // node, so every query point belongs to exactly one subtree.
+  std::vector<Tree*> subtrees(1, tree);
+  bool expanded = true;
+  while (subtrees.size() < targetSubtrees && expanded)
+  {
+    expanded = false;
+    std::vector<Tree*> nextSubtrees;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() == 0)
+      {
+        nextSubtrees.push_back(subtrees[i]);
+        continue;
+      }
+
+      for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        nextSubtrees.push_back(&subtrees[i]->Child(j));
+      expanded = true;
+    }
+    subtrees.swap(nextSubtrees);
+  }
+
+  Log::Info << "Performing dual-tree range search." << std::endl;
+  emst::ConcurrentUnionFind uf(data.n_cols);
+  typedef DBSCANRules<MetricType, Tree, emst::ConcurrentUnionFind> RuleType;
+  size_t totalBaseCases = 0;
+  size_t totalCollapsed = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalBaseCases, totalCollapsed)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    // Each thread gets its own copy of the metric, in case it holds state.
+    MetricType metric(tree->Metric());
+    RuleType rules(tree->Dataset(), epsilon, metric, uf);
+
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*subtrees[i], *tree);
+
+    totalBaseCases += rules.BaseCases();
+    totalCollapsed += rules.Collapsed();
+  }
+
+  Log::Info << "Range search complete (" << totalBaseCases << " base cases, "
+      << totalCollapsed << " node combinations united at once)." << std::endl;
+
+  // Map the points back to their original indices.  If the tree doesn't
+  // rearrange the dataset, oldFromNew is empty.
+  assignments.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const size_t root = uf.Find(i);
+    if (oldFromNew.empty())
+      assignments[i] = root;
+    else
+      assignments[oldFromNew[i]] = oldFromNew[root];
+  }
+
+  delete tree;
+}
+
 } // namespace dbscan
 } // namespace mlpack
 
@@ -60,6 +60,15 @@ PROGRAM_INFO("DBSCAN clustering",
     "search (as opposed to the default dual-tree search), and '" +
     PRINT_PARAM_STRING("naive") + " will force brute-force range search."
     "\n\n"
+    "If " + PRINT_PARAM_STRING("dual_tree_union") + " is specified, the "
+    "clusters are instead found with one parallel dual-tree traversal that "
+    "unites neighboring points as they are found, without storing the "
+    "neighbors of each point; this uses memory linear in the number of points "
+    "and can use multiple cores.  In that case the " +
+    PRINT_PARAM_STRING("single_mode") + ", " + PRINT_PARAM_STRING("naive") +
+    ", and " + PRINT_PARAM_STRING("selection_type") + " parameters are "
+    "ignored."
+    "\n\n"
     "An example usage to run DBSCAN on the dataset in " +
     PRINT_DATASET("input") + " with a radius of 0.5 and a minimum cluster size"
     " of 5 is given below:"
@@ -89,6 +98,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_FLAG("dual_tree_union", "If set, the clusters are found with a parallel "
+    "dual-tree traversal that unites neighboring points directly.", "D");
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
@@ -106,6 +117,7 @@ void RunDBSCAN(RangeSearchType rs,
 
   DBSCAN<RangeSearchType, PointSelectionPolicy> d(epsilon, minSize,
       !CLI::HasParam("single_mode"), rs, pointSelector);
+  d.DualTreeMode() = CLI::HasParam("dual_tree_union");
 
   // If possible, avoid the overhead of calculating centroids.
   if (CLI::HasParam("centroids"))
@@ -143,6 +155,9 @@ static void mlpackMain()
       "no output will be saved");
 
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
+  ReportIgnoredParam({{ "dual_tree_union", true }}, "single_mode");
+  ReportIgnoredParam({{ "dual_tree_union", true }}, "naive");
+  ReportIgnoredParam({{ "dual_tree_union", true }}, "selection_type");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
       "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
@@ -0,0 +1,147 @@
+/**
+ * @file dbscan_rules.hpp
+ *
+ * Rules for the dual-tree mode of DBSCAN, which unites points that are within
+ * the search radius of each other during the traversal, instead of returning
+ * the neighbors of each point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_DBSCAN_RULES_HPP
+#define MLPACK_METHODS_DBSCAN_DBSCAN_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+
+namespace mlpack {
+namespace dbscan {
+
+/**
+ * The DBSCANRules class is used by DBSCAN in dual-tree mode.  It performs a
+ * range search with radius epsilon of a dataset against itself, but each pair
+ * of points found in range is united in the given union-find structure right
+ * away, so no neighbors are stored.  If every pair of points of a query node
+ * and a reference node is within epsilon, all the points of both nodes are
+ * united without computing any distance, and the pair is pruned.
+ *
+ * One object may be used for each subtree of the query tree, by different
+ * threads, if the union-find structure supports concurrent modification (like
+ * emst::ConcurrentUnionFind).  The tree is not modified.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam UnionFindType The union-find structure to unite the points in.
+ */
+template<typename MetricType, typename TreeType, typename UnionFindType>
+class DBSCANRules
+{
+ public:
+  /**
+   * Construct the DBSCANRules object.
+   *
+   * @param dataset The dataset (both the query set and the reference set).
+   * @param epsilon The radius of the range search.
+   * @param metric Instantiated metric.
+   * @param uf The union-find structure to unite the points in (indexed like
+   *      the dataset).
+   */
+  DBSCANRules(const arma::mat& dataset,
+              const double epsilon,
+              MetricType& metric,
+              UnionFindType& uf);
+
+  /**
+   * Compute the base case between the given query point and reference point,
+   * uniting them if they are within epsilon.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceIndex Index of reference point.
+   */
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node should
+   * be pruned: either it is out of range, or all of its points were united
+   * with the query point.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   */
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order; the score does not change.
+   *
+   * @param queryIndex Index of query point.
+   * @param referenceNode Candidate node to be recursed into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Get the score for recursion order.  DBL_MAX indicates that the node
+   * combination should be pruned: either it is out of range, or all of the
+   * points of both nodes were united.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   */
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Re-evaluate the score for recursion order; the score does not change.
+   *
+   * @param queryNode Candidate query node to recurse into.
+   * @param referenceNode Candidate reference node to recurse into.
+   * @param oldScore Old score produced by Score() (or Rescore()).
+   */
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of scores (that is, calls to RangeDistance()).
+  size_t Scores() const { return scores; }
+  //! Get the number of node combinations that were united at once.
+  size_t Collapsed() const { return collapsed; }
+
+ private:
+  //! Unite the given point with all the points of the given node.
+  void UnionNode(const size_t point, const TreeType& node);
+
+  //! The dataset.
+  const arma::mat& dataset;
+  //! The radius of the range search.
+  double epsilon;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The union-find structure.
+  UnionFindType& uf;
+
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of scores.
+  size_t scores;
+  //! The number of node combinations united at once.
+  size_t collapsed;
+};
+
+} // namespace dbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "dbscan_rules_impl.hpp"
+
+#endif
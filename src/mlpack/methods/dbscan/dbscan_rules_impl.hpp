@@ -0,0 +1,147 @@
+/**
+ * @file dbscan_rules_impl.hpp
+ *
+ * Implementation of the rules for the dual-tree mode of DBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DBSCAN_DBSCAN_RULES_IMPL_HPP
+#define MLPACK_METHODS_DBSCAN_DBSCAN_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dbscan_rules.hpp"
+
+namespace mlpack {
+namespace dbscan {
+
+template<typename MetricType, typename TreeType, typename UnionFindType>
+DBSCANRules<MetricType, TreeType, UnionFindType>::DBSCANRules(
+    const arma::mat& dataset,
+    const double epsilon,
+    MetricType& metric,
+    UnionFindType& uf) :
+    dataset(dataset),
+    epsilon(epsilon),
+    metric(metric),
+    uf(uf),
+    baseCases(0),
+    scores(0),
+    collapsed(0)
+{
+  // Nothing to do.
+}
+
+//! The base case.  Evaluate the distance between the two points and unite them
+//! if they are within epsilon.
+template<typename MetricType, typename TreeType, typename UnionFindType>
+inline force_inline
+double DBSCANRules<MetricType, TreeType, UnionFindType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // A point is always in its own component.
+  if (queryIndex == referenceIndex)
+    return 0.0;
+
+  const double distance = metric.Evaluate(dataset.unsafe_col(queryIndex),
+      dataset.unsafe_col(referenceIndex));
+  ++baseCases;
+
+  if (distance <= epsilon)
+    uf.Union(queryIndex, referenceIndex);
+
+  return distance;
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename TreeType, typename UnionFindType>
+double DBSCANRules<MetricType, TreeType, UnionFindType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const math::Range distances =
+      referenceNode.RangeDistance(dataset.unsafe_col(queryIndex));
+  ++scores;
+
+  // If no point of the node is in range, prune it.
+  if (distances.Lo() > epsilon)
+    return DBL_MAX;
+
+  // If every point of the node is in range, they are all united with the query
+  // point and we don't need to go any deeper.
+  if (distances.Hi() <= epsilon)
+  {
+    UnionNode(queryIndex, referenceNode);
+    ++collapsed;
+    return DBL_MAX;
+  }
+
+  return distances.Lo();
+}
+
+//! Single-tree rescoring function.
+template<typename MetricType, typename TreeType, typename UnionFindType>
+double DBSCANRules<MetricType, TreeType, UnionFindType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+//! Dual-tree scoring function.
+template<typename MetricType, typename TreeType, typename UnionFindType>
+double DBSCANRules<MetricType, TreeType, UnionFindType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  const math::Range distances = referenceNode.RangeDistance(queryNode);
+  ++scores;
+
+  // If no pair of points of the nodes is in range, prune the combination.
+  if (distances.Lo() > epsilon)
+    return DBL_MAX;
+
+  // If every pair of points of the nodes is in range, all the points of both
+  // nodes are in one component; unite them without computing any distance.
+  if (distances.Hi() <= epsilon)
+  {
+    const size_t point = queryNode.Descendant(0);
+    UnionNode(point, queryNode);
+    UnionNode(point, referenceNode);
+    ++collapsed;
+    return DBL_MAX;
+  }
+
+  // Otherwise the score doesn't matter much; visit closer nodes first.
+  return distances.Lo();
+}
+
+//! Dual-tree rescoring function.
+template<typename MetricType, typename TreeType, typename UnionFindType>
+double DBSCANRules<MetricType, TreeType, UnionFindType>::Rescore(
+    TreeType& /* queryNode */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it wasn't pruned before, it isn't pruned now.
+  return oldScore;
+}
+
+template<typename MetricType, typename TreeType, typename UnionFindType>
+void DBSCANRules<MetricType, TreeType, UnionFindType>::UnionNode(
+    const size_t point,
+    const TreeType& node)
+{
+  for (size_t i = 0; i < node.NumDescendants(); ++i)
+    uf.Union(point, node.Descendant(i));
+}
+
+} // namespace dbscan
+} // namespace mlpack
+
+#endif
@@ -104,30 +104,38 @@ void DecisionStump<MatType>::Train(const MatType& data,
 {
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
-  double entropy;
   const double rootEntropy = CalculateEntropy<UseWeights>(labels, weights);
 
-  double gain, bestGain = 0.0;
-  for (size_t i = 0; i < data.n_rows; i++)
+  // Go through each dimension of the data.  The dimensions are independent, so
+  // they are searched in parallel; the gain of dimensions with identical
+  // values is left at zero, so that they are never chosen.
+  arma::vec gains(data.n_rows, arma::fill::zeros);
+  #pragma omp parallel for schedule(dynamic) \
+      if (data.n_rows > 1 && data.n_cols >= 1024)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_rows; i++)
   {
-    // Go through each dimension of the data.
     if (IsDistinct(data.row(i)))
     {
       // For each dimension with non-identical values, treat it as a potential
       // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
+      const double entropy = SetupSplitDimension<UseWeights>(data.row(i),
+          labels, weights);
 
-      gain = rootEntropy - entropy;
-      // Find the dimension with the best entropy so that the gain is
-      // maximized.
+      gains[i] = rootEntropy - entropy;
+    }
+  }
 
-      // We are maximizing gain, which is what is returned from
-      // SetupSplitDimension().
-      if (gain < bestGain)
-      {
-        bestDim = i;
-        bestGain = gain;
-      }
+  // Find the dimension with the best entropy so that the gain is maximized;
+  // the first dimension wins ties, as when the dimensions are searched in
+  // order.  We are maximizing gain, which is what is returned from
+  // SetupSplitDimension().
+  double bestGain = 0.0;
+  for (size_t i = 0; i < data.n_rows; i++)
+  {
+    if (gains[i] < bestGain)
+    {
+      bestDim = i;
+      bestGain = gains[i];
     }
   }
   splitDimension = bestDim;
@@ -149,7 +157,8 @@ void DecisionStump<MatType>::Classify(const MatType& test,
                                       arma::Row<size_t>& predictedLabels)
 {
   predictedLabels.set_size(test.n_cols);
-  for (size_t i = 0; i < test.n_cols; i++)
+  #pragma omp parallel for if (test.n_cols >= 4096)
+  for (omp_size_t i = 0; i < (omp_size_t) test.n_cols; i++)
   {
     // Determine which bin the test point falls into.
     // Assume first that it falls into the first bin, then proceed through the
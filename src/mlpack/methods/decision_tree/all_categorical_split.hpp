@@ -20,7 +20,12 @@ namespace tree {
 
 /**
  * The AllCategoricalSplit is a splitting function that will split categorical
- * features into many children: one child for each category.
+ * features into many children: one child for each category.  The gain of the
+ * split is calculated from a table of the (weighted) number of points of each
+ * class in each category, which is built in one pass over the points, so the
+ * FitnessFunction must provide a static EvaluateCounts(counts, total) function
+ * (like GiniGain and InformationGain).  For features with very many categories,
+ * consider BinaryCategoricalSplit, which splits into only two children.
  *
  * @tparam FitnessFunction Fitness function to evaluate gain with.
  */
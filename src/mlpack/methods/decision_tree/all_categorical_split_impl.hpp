@@ -29,25 +29,18 @@ double AllCategoricalSplit<FitnessFunction>::SplitIfBetter(
     arma::Col<typename VecType::elem_type>& classProbabilities,
     AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
 {
-  // Count the number of elements in each potential child.
+  // Count the number of elements in each potential child, and the (weighted)
+  // number of points of each class in each child, in one pass.  The gain of
+  // the split can then be calculated from the counts alone, so no labels have
+  // to be copied for each child.
   const double epsilon = 1e-7; // Tolerance for floating-point errors.
   arma::Col<size_t> counts(numCategories, arma::fill::zeros);
-
-  // If we are using weighted training, learn the weights for each child too.
-  arma::vec childWeightSums;
-  double sumWeight = 0.0;
-  if (UseWeights)
-    childWeightSums.zeros(numCategories);
-
+  arma::mat classCounts(numClasses, numCategories, arma::fill::zeros);
   for (size_t i = 0; i < data.n_elem; ++i)
   {
-    counts[(size_t) data[i]]++;
-
-    if (UseWeights)
-    {
-      childWeightSums[(size_t) data[i]] += weights[i];
-      sumWeight += weights[i];
-    }
+    const size_t category = (size_t) data[i];
+    counts[category]++;
+    classCounts(labels[i], category) += UseWeights ? (double) weights[i] : 1.0;
   }
 
   // If each child will have the minimum number of points in it, we can split.
@@ -55,44 +48,16 @@ double AllCategoricalSplit<FitnessFunction>::SplitIfBetter(
   if (arma::min(counts) < minimumLeafSize)
     return bestGain;
 
-  // Calculate the gain of the split.  First we have to calculate the labels
-  // that would be assigned to each child.
-  arma::uvec childPositions(numCategories, arma::fill::zeros);
-  std::vector<arma::Row<size_t>> childLabels(numCategories);
-  std::vector<arma::Row<double>> childWeights(numCategories);
-  for (size_t i = 0; i < numCategories; ++i)
-  {
-    // Labels and weights should have same length.
-    childLabels[i].zeros(counts[i]);
-    if (UseWeights)
-      childWeights[i].zeros(counts[i]);
-  }
-
-  // Extract labels for each child.
-  for (size_t i = 0; i < data.n_elem; ++i)
-  {
-    const size_t category = (size_t) data[i];
-
-    if (UseWeights)
-    {
-      childLabels[category][childPositions[category]] = labels[i];
-      childWeights[category][childPositions[category]++] = weights[i];
-    }
-    else
-    {
-      childLabels[category][childPositions[category]++] = labels[i];
-    }
-  }
-
+  // Calculate the gain of the split.
+  const arma::rowvec childTotals = arma::sum(classCounts, 0);
+  const double total = arma::accu(childTotals);
   double overallGain = 0.0;
-  for (size_t i = 0; i < counts.n_elem; ++i)
+  for (size_t i = 0; i < numCategories; ++i)
   {
     // Calculate the gain of this child.
-    const double childPct = UseWeights ?
-        double(childWeightSums[i]) / sumWeight :
-        double(counts[i]) / double(data.n_elem);
-    const double childGain = FitnessFunction::template Evaluate<UseWeights>(
-        childLabels[i], numClasses, childWeights[i]);
+    const double childPct = childTotals[i] / total;
+    const double childGain = FitnessFunction::EvaluateCounts(
+        classCounts.unsafe_col(i), childTotals[i]);
 
     overallGain += childPct * childGain;
   }
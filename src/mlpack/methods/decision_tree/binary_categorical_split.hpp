@@ -0,0 +1,121 @@
+/**
+ * @file binary_categorical_split.hpp
+ *
+ * A tree splitter that splits the categories of a categorical feature into two
+ * groups.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinaryCategoricalSplit is a splitting function for decision trees that
+ * splits a categorical feature into two children, each holding a group of the
+ * categories, instead of one child for each category like AllCategoricalSplit.
+ * This keeps the number of children of a node small when a feature has
+ * hundreds or thousands of categories.
+ *
+ * The (weighted) number of points of each class in each category is counted
+ * in one pass over the points.  The categories seen in the node are then
+ * sorted by the fraction of their points that are in class 1, and every split
+ * between two consecutive categories of that order is evaluated.  For two
+ * classes, the best of these splits is the best of all the possible groupings
+ * of the categories (Breiman et al., 1984).  For more classes, the categories
+ * are sorted by the fraction of points in the most common class of the node,
+ * so the split found is a good grouping but may not be the best one.
+ *
+ * Categories with no points in the node go to the child with more weight.
+ *
+ * The FitnessFunction must provide, in addition to Evaluate(), a static
+ * EvaluateCounts(counts, total) function that calculates the gain from the
+ * number of points of each class (like GiniGain and InformationGain).
+ *
+ * @tparam FitnessFunction Fitness function to evaluate gain with.
+ */
+template<typename FitnessFunction>
+class BinaryCategoricalSplit
+{
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.  For this particular split type, aux will be empty
+   * and classProbabilities will hold the child (0 or 1) of each category.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Return the number of children in the split (always 2).
+   *
+   * @param classProbabilities (Unused) auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Calculate the direction a point should percolate to.  Categories that are
+   * not known to the split go to the first child.
+   *
+   * @param point The category of the point.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "binary_categorical_split_impl.hpp"
+
+#endif
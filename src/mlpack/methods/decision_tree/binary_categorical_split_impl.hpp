@@ -0,0 +1,153 @@
+/**
+ * @file binary_categorical_split_impl.hpp
+ *
+ * Implementation of the BinaryCategoricalSplit categorical split class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binary_categorical_split.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  const double epsilon = 1e-7; // Tolerance for floating-point errors.
+
+  // Count the number of points in each category, and the (weighted) number of
+  // points of each class in each category.
+  arma::Col<size_t> counts(numCategories, arma::fill::zeros);
+  arma::mat classCounts(numClasses, numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t category = (size_t) data[i];
+    counts[category]++;
+    classCounts(labels[i], category) += UseWeights ? (double) weights[i] : 1.0;
+  }
+
+  const arma::rowvec categoryTotals = arma::sum(classCounts, 0);
+  const arma::vec classTotals = arma::sum(classCounts, 1);
+  const double total = arma::accu(classTotals);
+
+  // The class whose fraction of points orders the categories.
+  size_t sortClass = 1;
+  if (numClasses != 2)
+  {
+    arma::uword majorityClass;
+    classTotals.max(majorityClass);
+    sortClass = (size_t) majorityClass;
+  }
+
+  // Sort the categories that have points by that fraction.
+  std::vector<std::pair<double, size_t>> order;
+  for (size_t c = 0; c < numCategories; ++c)
+  {
+    if (counts[c] > 0)
+    {
+      const double fraction = (categoryTotals[c] > 0.0) ?
+          classCounts(sortClass, c) / categoryTotals[c] : 0.0;
+      order.push_back(std::make_pair(fraction, c));
+    }
+  }
+
+  // With only one category, there is nothing to split.
+  if (order.size() < 2)
+    return bestGain;
+
+  std::stable_sort(order.begin(), order.end(),
+      [](const std::pair<double, size_t>& a, const std::pair<double, size_t>& b)
+      {
+        return a.first < b.first;
+      });
+
+  // Move the categories into the left child one at a time, and evaluate each
+  // split.
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(classTotals);
+  size_t leftPoints = 0;
+  double bestFoundGain = -DBL_MAX;
+  size_t bestIndex = 0;
+  for (size_t i = 0; i < order.size() - 1; ++i)
+  {
+    const size_t category = order[i].second;
+    leftCounts += classCounts.unsafe_col(category);
+    rightCounts -= classCounts.unsafe_col(category);
+    leftPoints += counts[category];
+
+    // Make sure that each child will have the minimum number of points.
+    if (leftPoints < minimumLeafSize ||
+        data.n_elem - leftPoints < minimumLeafSize)
+      continue;
+
+    const double leftWeight = arma::accu(leftCounts);
+    const double rightWeight = total - leftWeight;
+    const double gain = (leftWeight / total) *
+        FitnessFunction::EvaluateCounts(leftCounts, leftWeight) +
+        (rightWeight / total) *
+        FitnessFunction::EvaluateCounts(rightCounts, rightWeight);
+
+    if (gain > bestFoundGain)
+    {
+      bestFoundGain = gain;
+      bestIndex = i;
+    }
+  }
+
+  if (bestFoundGain > bestGain + minimumGainSplit + epsilon)
+  {
+    // Categories without points go with the heavier child.
+    double leftWeight = 0.0;
+    for (size_t i = 0; i <= bestIndex; ++i)
+      leftWeight += categoryTotals[order[i].second];
+
+    classProbabilities.set_size(numCategories);
+    classProbabilities.fill((leftWeight >= total - leftWeight) ? 0 : 1);
+    for (size_t i = 0; i < order.size(); ++i)
+      classProbabilities[order[i].second] = (i <= bestIndex) ? 0 : 1;
+
+    return bestFoundGain;
+  }
+
+  // Otherwise there was no improvement.
+  return bestGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t BinaryCategoricalSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  const size_t category = (size_t) point;
+  if (category >= classProbabilities.n_elem)
+    return 0;
+
+  return (size_t) classProbabilities[category];
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
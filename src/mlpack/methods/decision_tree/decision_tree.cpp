@@ -0,0 +1,40 @@
+/**
+ * @file decision_tree.cpp
+ *
+ * Force instantiation of the default DecisionTree, and of its training and
+ * batch classification on arma::mat, to reduce compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "decision_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template class DecisionTree<>;
+
+template void DecisionTree<>::Train(arma::mat,
+                                    const data::DatasetInfo&,
+                                    arma::Row<size_t>,
+                                    const size_t,
+                                    const size_t,
+                                    const double);
+
+template void DecisionTree<>::Train(arma::mat,
+                                    arma::Row<size_t>,
+                                    const size_t,
+                                    const size_t,
+                                    const double);
+
+template void DecisionTree<>::Classify(const arma::mat&,
+                                       arma::Row<size_t>&) const;
+
+template void DecisionTree<>::Classify(const arma::mat&,
+                                       arma::Row<size_t>&,
+                                       arma::mat&) const;
+
+} // namespace tree
+} // namespace mlpack
@@ -23,6 +23,14 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * Nodes of a DecisionTree with at least this many points evaluate the
+ * dimensions and train their children in parallel, when OpenMP is available.
+ * Inside of an existing parallel region (such as the one of
+ * RandomForest::Train()), this is done with OpenMP tasks.
+ */
+const size_t DecisionTreeParallelMinSize = 1024;
+
 /**
  * This class implements a generic decision tree learner.  Its behavior can be
  * controlled via its template arguments.
@@ -359,6 +367,17 @@ class DecisionTree :
   //! Modify the child of the given index (be careful!).
   DecisionTree& Child(const size_t i) { return *children[i]; }
 
+  //! Get the dimension this node splits on (only meaningful if the node is not
+  //! a leaf).
+  size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the split dimension if the node is not a leaf, or the
+  //! majority class if it is.
+  size_t DimensionTypeOrMajorityClass() const
+  { return dimensionTypeOrMajorityClass; }
+  //! Get the class probabilities if the node is a leaf, or the split
+  //! information if it is not.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -407,6 +426,41 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  /**
+   * Find the best split of the node among the given dimensions, and store its
+   * split information in classProbabilities and the auxiliary split
+   * information.  For large nodes, the dimensions are evaluated in parallel;
+   * the split found is the same as the serial one.
+   *
+   * @param dimensions Dimensions to evaluate, in order.
+   * @param count Number of points in this node.
+   * @param noSplit Value to return if no split improves on bestGain.
+   * @param bestGain Gain of the unsplit node; set to the gain of the split.
+   * @param splitIfBetter Function that calls SplitIfBetter() of the
+   *      appropriate split type for the given dimension, with the given gain,
+   *      class probabilities and auxiliary split information.
+   * @return The dimension to split on, or noSplit.
+   */
+  template<typename SplitFunctionType>
+  size_t FindBestSplit(const std::vector<size_t>& dimensions,
+                       const size_t count,
+                       const size_t noSplit,
+                       double& bestGain,
+                       SplitFunctionType& splitIfBetter);
+
+  /**
+   * Create the children of this node and train them, in parallel for large
+   * nodes.
+   *
+   * @param childBegins The first point of each child, followed by the end of
+   *      the points of the last child.
+   * @param trainChild Function that trains the given child on the given range
+   *      of points.
+   */
+  template<typename TrainFunctionType>
+  void TrainChildren(const std::vector<size_t>& childBegins,
+                     TrainFunctionType& trainChild);
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
@@ -479,4 +533,45 @@ using DecisionStump = DecisionTree<FitnessFunction,
 // Include implementation.
 #include "decision_tree_impl.hpp"
 
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.  The default DecisionTree, and its training and batch classification
+ * on arma::mat, are compiled once in the mlpack library (see
+ * decision_tree.cpp), instead of in each program that uses them.
+ *
+ * @cond
+ */
+
+namespace mlpack {
+namespace tree {
+
+extern template class DecisionTree<>;
+
+extern template void DecisionTree<>::Train(arma::mat,
+                                           const data::DatasetInfo&,
+                                           arma::Row<size_t>,
+                                           const size_t,
+                                           const size_t,
+                                           const double);
+
+extern template void DecisionTree<>::Train(arma::mat,
+                                           arma::Row<size_t>,
+                                           const size_t,
+                                           const size_t,
+                                           const double);
+
+extern template void DecisionTree<>::Classify(const arma::mat&,
+                                              arma::Row<size_t>&) const;
+
+extern template void DecisionTree<>::Classify(const arma::mat&,
+                                              arma::Row<size_t>&,
+                                              arma::mat&) const;
+
+} // namespace tree
+} // namespace mlpack
+
+/**
+ * @endcond
+ */
+
 #endif
@@ -12,6 +12,10 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace tree {
 
@@ -549,15 +553,22 @@ void DecisionTree<FitnessFunction,
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
-  DimensionSelectionType dimensions(datasetInfo.Dimensionality());
-  for (size_t i = dimensions.Begin(); i != dimensions.End();
-       i = dimensions.Next())
+  std::vector<size_t> dimensions;
+  DimensionSelectionType dimensionSelector(datasetInfo.Dimensionality());
+  for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+       i = dimensionSelector.Next())
+    dimensions.push_back(i);
+
+  auto splitIfBetter = [&](const size_t i,
+                           const double gain,
+                           arma::vec& probabilities,
+                           NumericAuxiliarySplitInfo& numericAux,
+                           CategoricalAuxiliarySplitInfo& categoricalAux)
   {
     double dimGain = -DBL_MAX;
     if (datasetInfo.Type(i) == data::Datatype::categorical)
     {
-      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
+      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
           data.cols(begin, begin + count - 1).row(i),
           datasetInfo.NumMappings(i),
           labels.subvec(begin, begin + count - 1),
@@ -565,33 +576,28 @@ void DecisionTree<FitnessFunction,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
           minimumLeafSize,
           minimumGainSplit,
-          classProbabilities,
-          *this);
+          probabilities,
+          categoricalAux);
     }
     else if (datasetInfo.Type(i) == data::Datatype::numeric)
     {
-      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(gain,
           data.cols(begin, begin + count - 1).row(i),
           labels.subvec(begin, begin + count - 1),
           numClasses,
           UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
           minimumLeafSize,
           minimumGainSplit,
-          classProbabilities,
-          *this);
+          probabilities,
+          numericAux);
     }
 
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+    return dimGain;
+  };
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
-  }
+  // If no split is found, bestDim is datasetInfo.Dimensionality().
+  const size_t bestDim = FindBestSplit(dimensions, count,
+      datasetInfo.Dimensionality(), bestGain, splitIfBetter);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != datasetInfo.Dimensionality())
@@ -629,11 +635,12 @@ void DecisionTree<FitnessFunction,
       childCounts[childAssignments[i - begin]]++;
 
     // Split into children.
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -645,23 +652,19 @@ void DecisionTree<FitnessFunction,
           ++currentCol;
         }
       }
-
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit);
-      }
-      children.push_back(child);
     }
+    childBegins[numChildren] = currentCol;
+
+    // Now build the children recursively.
+    auto trainChild = [&](DecisionTree& child,
+                          const size_t childBegin,
+                          const size_t childCount)
+    {
+      child.Train<UseWeights>(data, childBegin, childCount, datasetInfo,
+          labels, numClasses, weights, NoRecursion ? childCount : minimumLeafSize,
+          minimumGainSplit);
+    };
+    TrainChildren(childBegins, trainChild);
   }
   else
   {
@@ -716,11 +719,18 @@ void DecisionTree<FitnessFunction,
       labels.subvec(begin, begin + count - 1),
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
-  size_t bestDim = data.n_rows; // This means "no split".
+  std::vector<size_t> dimensions(data.n_rows);
   for (size_t i = 0; i < data.n_rows; ++i)
+    dimensions[i] = i;
+
+  auto splitIfBetter = [&](const size_t i,
+                           const double gain,
+                           arma::vec& probabilities,
+                           NumericAuxiliarySplitInfo& numericAux,
+                           CategoricalAuxiliarySplitInfo& /* categoricalAux */)
   {
-    const double dimGain = NumericSplitType<FitnessFunction>::template
-        SplitIfBetter<UseWeights>(bestGain,
+    return NumericSplitType<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(gain,
                                   data.cols(begin, begin + count - 1).row(i),
                                   labels.cols(begin, begin + count - 1),
                                   numClasses,
@@ -729,19 +739,13 @@ void DecisionTree<FitnessFunction,
                                       weights,
                                   minimumLeafSize,
                                   minimumGainSplit,
-                                  classProbabilities,
-                                  *this);
+                                  probabilities,
+                                  numericAux);
+  };
 
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
-
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
-  }
+  // If no split is found, bestDim is data.n_rows.
+  const size_t bestDim = FindBestSplit(dimensions, count, data.n_rows,
+      bestGain, splitIfBetter);
 
   // Did we split or not?  If so, then split the data and create the children.
   if (bestDim != data.n_rows)
@@ -766,11 +770,13 @@ void DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
+    // Split into children.
+    std::vector<size_t> childBegins(numChildren + 1);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
@@ -782,23 +788,19 @@ void DecisionTree<FitnessFunction,
           ++currentCol;
         }
       }
-
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit);
-      }
-      children.push_back(child);
     }
+    childBegins[numChildren] = currentCol;
+
+    // Now build the children recursively.
+    auto trainChild = [&](DecisionTree& child,
+                          const size_t childBegin,
+                          const size_t childCount)
+    {
+      child.Train<UseWeights>(data, childBegin, childCount, labels,
+          numClasses, weights, NoRecursion ? childCount : minimumLeafSize,
+          minimumGainSplit);
+    };
+    TrainChildren(childBegins, trainChild);
   }
   else
   {
@@ -813,6 +815,195 @@ void DecisionTree<FitnessFunction,
   }
 }
 
+//! Find the best split of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename SplitFunctionType>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::FindBestSplit(
+    const std::vector<size_t>& dimensions,
+    const size_t count,
+    const size_t noSplit,
+    double& bestGain,
+    SplitFunctionType& splitIfBetter)
+{
+  size_t bestDim = noSplit;
+
+  #ifdef HAS_OPENMP
+  if (dimensions.size() > 1 && count >= DecisionTreeParallelMinSize &&
+      omp_get_max_threads() > 1)
+  {
+    // Evaluate all of the dimensions at the same time, each against the gain
+    // of the unsplit node.
+    const size_t numDims = dimensions.size();
+    const double initialGain = bestGain;
+    std::vector<double> dimGains(numDims);
+    std::vector<arma::vec> probabilities(numDims);
+    std::vector<NumericAuxiliarySplitInfo> numericAux(numDims);
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(numDims);
+
+    if (omp_in_parallel())
+    {
+      // We are already inside of a parallel region (for instance, another node
+      // of this tree, or another tree of a RandomForest), so use tasks.
+      SplitFunctionType* splitPtr = &splitIfBetter;
+      double* gainsPtr = dimGains.data();
+      arma::vec* probabilitiesPtr = probabilities.data();
+      NumericAuxiliarySplitInfo* numericAuxPtr = numericAux.data();
+      CategoricalAuxiliarySplitInfo* categoricalAuxPtr = categoricalAux.data();
+      for (size_t d = 0; d < numDims; ++d)
+      {
+        const size_t dim = dimensions[d];
+        #pragma omp task
+        gainsPtr[d] = (*splitPtr)(dim, initialGain, probabilitiesPtr[d],
+            numericAuxPtr[d], categoricalAuxPtr[d]);
+      }
+      #pragma omp taskwait
+    }
+    else
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t d = 0; d < (omp_size_t) numDims; ++d)
+      {
+        dimGains[d] = splitIfBetter(dimensions[d], initialGain,
+            probabilities[d], numericAux[d], categoricalAux[d]);
+      }
+    }
+
+    // Now pick the dimension that the serial search below would pick.  That
+    // search evaluates each dimension against the best gain found so far, not
+    // against the gain of the unsplit node; but a dimension can only improve on
+    // the best gain if it did so here too, and in that case we evaluate it
+    // again against the best gain.  So the tree is the same as a serial one.
+    size_t bestIndex = numDims;
+    for (size_t d = 0; d < numDims; ++d)
+    {
+      double dimGain = dimGains[d];
+      if (bestGain != initialGain && dimGain > bestGain)
+      {
+        dimGain = splitIfBetter(dimensions[d], bestGain, probabilities[d],
+            numericAux[d], categoricalAux[d]);
+      }
+
+      if (dimGain > bestGain)
+      {
+        bestDim = dimensions[d];
+        bestGain = dimGain;
+        bestIndex = d;
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+
+    if (bestIndex != numDims)
+    {
+      classProbabilities = std::move(probabilities[bestIndex]);
+      NumericAuxiliarySplitInfo::operator=(numericAux[bestIndex]);
+      CategoricalAuxiliarySplitInfo::operator=(categoricalAux[bestIndex]);
+    }
+
+    return bestDim;
+  }
+  #endif
+
+  for (size_t d = 0; d < dimensions.size(); ++d)
+  {
+    const double dimGain = splitIfBetter(dimensions[d], bestGain,
+        classProbabilities, *this, *this);
+
+    // Was there an improvement?  If so mark that it's the new best dimension.
+    if (dimGain > bestGain)
+    {
+      bestDim = dimensions[d];
+      bestGain = dimGain;
+    }
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  return bestDim;
+}
+
+//! Create and train the children of the node.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<typename TrainFunctionType>
+void DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::TrainChildren(
+    const std::vector<size_t>& childBegins,
+    TrainFunctionType& trainChild)
+{
+  const size_t numChildren = childBegins.size() - 1;
+  children.resize(numChildren);
+  for (size_t i = 0; i < numChildren; ++i)
+    children[i] = new DecisionTree();
+
+  #ifdef HAS_OPENMP
+  // The children hold disjoint ranges of the points, so they can be trained at
+  // the same time.
+  const size_t count = childBegins[numChildren] - childBegins[0];
+  if (numChildren > 1 && count >= DecisionTreeParallelMinSize)
+  {
+    auto trainInTasks = [&]()
+    {
+      TrainFunctionType* trainPtr = &trainChild;
+      for (size_t i = 0; i < numChildren; ++i)
+      {
+        DecisionTree* child = children[i];
+        const size_t childBegin = childBegins[i];
+        const size_t childCount = childBegins[i + 1] - childBegins[i];
+        #pragma omp task
+        (*trainPtr)(*child, childBegin, childCount);
+      }
+      #pragma omp taskwait
+    };
+
+    if (omp_in_parallel())
+    {
+      trainInTasks();
+      return;
+    }
+    else if (omp_get_max_threads() > 1)
+    {
+      // Open a parallel region for the whole subtree; the nodes below this one
+      // will then create tasks too.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        trainInTasks();
+      }
+      return;
+    }
+  }
+  #endif
+
+  for (size_t i = 0; i < numChildren; ++i)
+  {
+    trainChild(*children[i], childBegins[i],
+        childBegins[i + 1] - childBegins[i]);
+  }
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
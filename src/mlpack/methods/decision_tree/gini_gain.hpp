@@ -175,6 +175,31 @@ class GiniGain
     return -impurity;
   }
 
+  /**
+   * Evaluate the Gini impurity from the (possibly weighted) number of points
+   * of each class, instead of from the labels.  This gives the same result as
+   * Evaluate() on the labels that these counts were taken from.
+   *
+   * @param counts Number (or total weight) of points of each class.
+   * @param total Total number (or total weight) of points.
+   */
+  template<typename CountsType>
+  static double EvaluateCounts(const CountsType& counts, const double total)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (total == 0.0)
+      return 0.0;
+
+    double impurity = 0.0;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      const double f = ((double) counts[i] / total);
+      impurity += f * (1.0 - f);
+    }
+
+    return -impurity;
+  }
+
   /**
    * Return the range of the Gini impurity for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
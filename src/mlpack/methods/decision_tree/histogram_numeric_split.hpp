@@ -0,0 +1,122 @@
+/**
+ * @file histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split between the bins of
+ * a histogram of the dimension.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinnedNumericSplit is a splitting function for decision trees that
+ * quantizes a numeric dimension into NumBins equal-width bins between the
+ * minimum and maximum value of the points of the node, accumulates the
+ * (weighted) number of points of each class in each bin, and then evaluates
+ * only the binary splits between the bins.  Unlike BestBinaryNumericSplit, it
+ * does not sort the points, so each dimension of each node takes O(n + NumBins
+ * * numClasses) time instead of O(n log n + n * numClasses).  The split found
+ * may be slightly worse than the best split, since splits inside a bin are not
+ * considered; if each distinct value falls into its own bin, the split is the
+ * same as the one BestBinaryNumericSplit would find.
+ *
+ * The FitnessFunction must provide, in addition to Evaluate(), a static
+ * EvaluateCounts(counts, total) function that calculates the gain from the
+ * number of points of each class (like GiniGain and InformationGain).
+ *
+ * Since the DecisionTree expects a NumericSplitType with only one template
+ * parameter, use the HistogramNumericSplit alias (with 256 bins), or define a
+ * similar alias for a different number of bins.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ * @tparam NumBins Number of bins of the histogram.
+ */
+template<typename FitnessFunction, size_t NumBins>
+class BinnedNumericSplit
+{
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point (only used if UseWeights is true).
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain improvement for a split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+};
+
+/**
+ * The HistogramNumericSplit is a BinnedNumericSplit with 256 bins, which can
+ * be used as the NumericSplitType of a DecisionTree or a RandomForest.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+using HistogramNumericSplit = BinnedNumericSplit<FitnessFunction, 256>;
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split between
+ * the bins of a histogram.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, size_t NumBins>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BinnedNumericSplit<FitnessFunction, NumBins>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2) || data.n_elem < 2)
+    return bestGain;
+
+  // Find the range of the bins.
+  ElemType minValue = data[0];
+  ElemType maxValue = data[0];
+  for (size_t i = 1; i < data.n_elem; ++i)
+  {
+    if (data[i] < minValue)
+      minValue = data[i];
+    else if (data[i] > maxValue)
+      maxValue = data[i];
+  }
+
+  // If all the values are the same, there is nothing to split.
+  if (minValue == maxValue)
+    return bestGain;
+
+  // Build the histogram: the (weighted) number of points of each class in
+  // each bin, the number of points in each bin, and the smallest and largest
+  // value in each bin, so that the split value can be placed between the
+  // points as BestBinaryNumericSplit does.
+  const size_t numBins = std::min((size_t) NumBins, (size_t) data.n_elem);
+  const double scale = double(numBins) / (double(maxValue) - double(minValue));
+
+  arma::mat classCounts(numClasses, numBins, arma::fill::zeros);
+  arma::Col<size_t> binCounts(numBins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(numBins);
+  arma::Col<ElemType> binMax(numBins);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t bin = std::min((size_t) ((double(data[i]) -
+        double(minValue)) * scale), numBins - 1);
+
+    classCounts(labels[i], bin) += UseWeights ? (double) weights[i] : 1.0;
+    if (binCounts[bin] == 0 || data[i] < binMin[bin])
+      binMin[bin] = data[i];
+    if (binCounts[bin] == 0 || data[i] > binMax[bin])
+      binMax[bin] = data[i];
+    ++binCounts[bin];
+  }
+
+  const arma::vec totalCounts = arma::sum(classCounts, 1);
+  const double totalWeight = arma::accu(totalCounts);
+
+  // Loop through the splits between the non-empty bins, choosing the best one.
+  // Also, force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  size_t leftPoints = 0;
+  size_t bin = 0;
+  while (binCounts[bin] == 0)
+    ++bin;
+  while (true)
+  {
+    leftCounts += classCounts.col(bin);
+    leftPoints += binCounts[bin];
+
+    // Find the first non-empty bin on the right of the split.
+    size_t nextBin = bin + 1;
+    while (nextBin < numBins && binCounts[nextBin] == 0)
+      ++nextBin;
+    if (nextBin == numBins)
+      break;
+
+    const size_t currentBin = bin;
+    bin = nextBin;
+    if (leftPoints < minimum || data.n_elem - leftPoints < minimum)
+      continue;
+
+    const arma::vec rightCounts = totalCounts - leftCounts;
+    const double leftWeight = UseWeights ? arma::accu(leftCounts) :
+        (double) leftPoints;
+    const double rightWeight = UseWeights ? totalWeight - leftWeight :
+        (double) (data.n_elem - leftPoints);
+    const double fullWeight = leftWeight + rightWeight;
+
+    const double leftGain = FitnessFunction::EvaluateCounts(leftCounts,
+        leftWeight);
+    const double rightGain = FitnessFunction::EvaluateCounts(rightCounts,
+        rightWeight);
+
+    const double gain = (leftWeight / fullWeight) * leftGain +
+        (rightWeight / fullWeight) * rightGain;
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.  The actual split value will be halfway between the largest
+      // value on the left and the smallest value on the right.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[currentBin] + binMin[nextBin]) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[currentBin] + binMin[nextBin]) / 2.0;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction, size_t NumBins>
+template<typename ElemType>
+size_t BinnedNumericSplit<FitnessFunction, NumBins>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -172,6 +172,32 @@ class InformationGain
     return gain;
   }
 
+  /**
+   * Calculate the information gain from the (possibly weighted) number of
+   * points of each class, instead of from the labels.  This gives the same
+   * result as Evaluate() on the labels that these counts were taken from.
+   *
+   * @param counts Number (or total weight) of points of each class.
+   * @param total Total number (or total weight) of points.
+   */
+  template<typename CountsType>
+  static double EvaluateCounts(const CountsType& counts, const double total)
+  {
+    // Edge case: if there are no elements, the gain is zero.
+    if (total == 0.0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < counts.n_elem; ++i)
+    {
+      const double f = ((double) counts[i] / total);
+      if (f > 0.0)
+        gain += f * std::log2(f);
+    }
+
+    return gain;
+  }
+
   /**
    * Return the range of the information gain for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
@@ -0,0 +1,81 @@
+/**
+ * @file mse_gain.hpp
+ *
+ * The MSEGain class, which is a fitness function (FitnessFunction) for
+ * regression trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_MSE_GAIN_HPP
+#define MLPACK_METHODS_DECISION_TREE_MSE_GAIN_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The mean squared error gain, a fitness function for regression trees.  This
+ * is the (weighted) variance of the responses of a node around their mean, the
+ * mean squared error of predicting the mean, but negated---since the tree will
+ * be trying to maximize gain.  The gain of a split is then the reduction of the
+ * total squared error.
+ */
+class MSEGain
+{
+ public:
+  /**
+   * Evaluate the mean squared error gain on the given set of responses.
+   *
+   * @param responses Set of responses to evaluate the gain on.
+   * @param weights Weights of the responses (only used if UseWeights is true).
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double Evaluate(const VecType& responses,
+                         const WeightVecType& weights)
+  {
+    // Corner case: if there are no elements, the error is zero.
+    if (responses.n_elem == 0)
+      return 0.0;
+
+    double sum = 0.0, sumSquares = 0.0, total = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      const double weight = UseWeights ? (double) weights[i] : 1.0;
+      sum += weight * responses[i];
+      sumSquares += weight * responses[i] * responses[i];
+      total += weight;
+    }
+
+    return EvaluateSums(sum, sumSquares, total);
+  }
+
+  /**
+   * Evaluate the mean squared error gain from the (weighted) sum of the
+   * responses, the sum of their squares, and the total weight.  This allows
+   * the gain of histogram bins to be computed without the responses.
+   *
+   * @param sum Sum of the responses.
+   * @param sumSquares Sum of the squares of the responses.
+   * @param total Total weight of the responses.
+   */
+  static double EvaluateSums(const double sum,
+                             const double sumSquares,
+                             const double total)
+  {
+    if (total <= 0.0)
+      return 0.0;
+
+    // Rounding can make the variance very slightly negative.
+    const double mean = sum / total;
+    return -std::max(sumSquares / total - mean * mean, 0.0);
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
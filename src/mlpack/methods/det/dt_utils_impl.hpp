@@ -138,6 +138,11 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   if (skipPruning)
     return dtree;
 
+  // Keep the unpruned tree, so that it does not have to be grown again once the
+  // optimal alpha is known.
+  DTree<MatType, TagType>* unprunedTree = new DTree<MatType, TagType>(*dtree);
+  const double unprunedAlpha = alpha;
+
   if (folds == dataset.n_cols)
     Log::Info << "Performing leave-one-out cross validation." << std::endl;
   else
@@ -173,7 +178,8 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   Log::Info << prunedSequence.size() << " trees in the sequence; maximum alpha:"
       << " " << oldAlpha << "." << std::endl;
 
-  const MatType cvData(dataset);
+  // The dataset itself is not modified (the trees are grown on copies).
+  const MatType& cvData = dataset;
   const size_t testSize = dataset.n_cols / folds;
 
   arma::vec regularizationConstants(prunedSequence.size());
@@ -183,9 +189,9 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   // Go through each fold.  On the Visual Studio compiler, we have to use
   // intmax_t because size_t is not yet supported by their OpenMP
   // implementation. omp_size_t is the appropriate type according to the
-  // platform.
-  #pragma omp parallel for default(none) \
-      shared(prunedSequence, regularizationConstants)
+  // platform.  Growing each tree also uses the threads left idle when there
+  // are fewer folds than threads (with OpenMP tasks).
+  #pragma omp parallel for shared(prunedSequence, regularizationConstants)
   for (omp_size_t fold = 0; fold < (omp_size_t) folds; fold++)
   {
     // Break up data into train and test sets.
@@ -283,30 +289,18 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
   Log::Info << "Optimal alpha: " << optimalAlpha << "." << std::endl;
 
-  // Re-Initialize the tree.
+  // Go back to the unpruned tree.
   delete dtree;
-  dtree = new DTree<MatType, TagType>(dataset);
-
-  // Getting ready to grow the tree...
-  for (size_t i = 0; i < oldFromNew.n_elem; i++)
-    oldFromNew[i] = i;
+  dtree = unprunedTree;
 
-  // Save the dataset since it would be modified while growing the tree.
-  newDataset = dataset;
-
-  // Grow the tree.
   oldAlpha = -DBL_MAX;
-  alpha = dtree->Grow(newDataset,
-                         oldFromNew,
-                         useVolumeReg,
-                         maxLeafSize,
-                         minLeafSize);
+  alpha = unprunedAlpha;
 
   // Prune with optimal alpha.
   while ((oldAlpha < optimalAlpha) && (dtree->SubtreeLeaves() > 1))
   {
     oldAlpha = alpha;
-    alpha = dtree->PruneAndUpdate(oldAlpha, newDataset.n_cols, useVolumeReg);
+    alpha = dtree->PruneAndUpdate(oldAlpha, dataset.n_cols, useVolumeReg);
 
     // Some sanity checks.
     Log::Assert((alpha < std::numeric_limits<double>::max()) ||
@@ -14,10 +14,35 @@
 #define MLPACK_METHODS_DET_DTREE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
 
 namespace mlpack {
 namespace det /** Density Estimation Trees */ {
 
+/**
+ * Nodes of a DTree with at least this many points search the dimensions for a
+ * split and grow their children in parallel, when OpenMP is available.  Inside
+ * of an existing parallel region (such as the cross-validation in Trainer()),
+ * this is done with OpenMP tasks.
+ */
+const size_t DTreeParallelMinSize = 1024;
+
+/**
+ * The points of a dense dataset sorted in each dimension, which DTree::Grow()
+ * keeps up to date as the points are split, so that no node has to sort its
+ * points to find its split.
+ */
+struct DTreeSortedPoints
+{
+  //! Column d holds the indices of the points in increasing order of dimension
+  //! d; the points of each node occupy rows [start, end).
+  arma::Mat<size_t> indices;
+  //! For each point index, the point index it had before the last split.
+  arma::Col<size_t> origins;
+  //! For each point index, the point index it has after the last split.
+  arma::Col<size_t> positions;
+};
+
 /**
  * A density estimation tree is similar to both a decision tree and a space
  * partitioning tree (like a kd-tree).  Each leaf represents a constant-density
@@ -148,7 +173,11 @@ class DTree
 
   /**
    * Greedily expand the tree.  The points in the dataset will be reordered
-   * during tree growth.
+   * during tree growth.  For dense data, the points are sorted in each
+   * dimension once (taking as much extra memory as the data, in size_t) and
+   * these orders are kept through the splits, so finding the split of a node
+   * takes linear time in its number of points.  Large nodes search their
+   * dimensions and grow their children in parallel with OpenMP.
    *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
@@ -342,15 +371,42 @@ class DTree
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const DTreeSortedPoints* sortedPoints = NULL) const;
 
   /**
-   * Split the data, returning the number of points left of the split.
+   * Split the data, returning the number of points left of the split.  If
+   * sortedPoints is given, its orders are updated for the children.
    */
   size_t SplitData(MatType& data,
                    const size_t splitDim,
                    const ElemType splitValue,
-                   arma::Col<size_t>& oldFromNew) const;
+                   arma::Col<size_t>& oldFromNew,
+                   DTreeSortedPoints* sortedPoints = NULL) const;
+
+  /**
+   * Greedily expand the subtree of this node, as Grow(), using (if it is not
+   * NULL) the given sorted points of the node.
+   */
+  double GrowSubtree(MatType& data,
+                     arma::Col<size_t>& oldFromNew,
+                     const bool useVolReg,
+                     const size_t maxLeafSize,
+                     const size_t minLeafSize,
+                     DTreeSortedPoints* sortedPoints);
+
+  /**
+   * Grow the subtrees of both children, in parallel if the node is large
+   * enough, and store the values they return in leftG and rightG.
+   */
+  void GrowChildren(MatType& data,
+                    arma::Col<size_t>& oldFromNew,
+                    const bool useVolReg,
+                    const size_t maxLeafSize,
+                    const size_t minLeafSize,
+                    DTreeSortedPoints* sortedPoints,
+                    double& leftG,
+                    double& rightG);
 
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
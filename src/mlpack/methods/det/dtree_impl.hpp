@@ -147,6 +147,85 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+/**
+ * Extract the splits of the given dimension as ExtractSplits() does, from the
+ * points of the node already sorted in that dimension, in linear time.
+ */
+template<typename ElemType, typename MatType>
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const MatType& data,
+                         const arma::Mat<size_t>& sortedIndices,
+                         size_t dim,
+                         const size_t start,
+                         const size_t end,
+                         const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+  const size_t* indices = sortedIndices.colptr(dim);
+
+  for (size_t i = start + minLeafSize - 1; i < end - minLeafSize; ++i)
+  {
+    const ElemType value = data(dim, indices[i]);
+    const ElemType split = (value + data(dim, indices[i + 1])) / 2.0;
+
+    // Check if we can split here (two points are different)
+    if (split != value)
+      splitVec.push_back(SplitItem(split, i - start + 1));
+  }
+}
+
+/**
+ * Call f(dim) for each dimension, in parallel if there are enough points.
+ * Inside of an existing parallel region, the dimensions become tasks.
+ */
+template<typename FunctionType>
+void ForEachDimension(const size_t numDims,
+                      const size_t points,
+                      FunctionType& f)
+{
+  ParallelFor(0, numDims, f, 1, (points >= DTreeParallelMinSize) ? 0 : 1);
+}
+
+/**
+ * Sort the points [start, end) of the given data in each dimension.  Sparse
+ * data is not sorted ahead of time, since ExtractSplits() only sorts its
+ * nonzero values; false is returned in that case.
+ */
+template<typename MatType>
+bool SortPoints(const MatType& /* data */,
+                const size_t /* start */,
+                const size_t /* end */,
+                DTreeSortedPoints& /* sortedPoints */)
+{
+  return false;
+}
+
+// The dense implementation.
+template<typename ElemType>
+bool SortPoints(const arma::Mat<ElemType>& data,
+                const size_t start,
+                const size_t end,
+                DTreeSortedPoints& sortedPoints)
+{
+  sortedPoints.indices.set_size(data.n_cols, data.n_rows);
+  sortedPoints.origins.set_size(data.n_cols);
+  sortedPoints.positions.set_size(data.n_cols);
+  if (end == start)
+    return true;
+
+  auto sortDimension = [&](const size_t dim)
+  {
+    const arma::uvec order = arma::sort_index(data(dim,
+        arma::span(start, end - 1)));
+    size_t* indices = sortedPoints.indices.colptr(dim);
+    for (size_t i = 0; i < order.n_elem; ++i)
+      indices[start + i] = start + order[i];
+  };
+  ForEachDimension(data.n_rows, end - start, sortDimension);
+
+  return true;
+}
+
 } // namespace details
 
 template<typename MatType, typename TagType>
@@ -439,7 +518,9 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const DTreeSortedPoints* sortedPoints)
+    const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -449,47 +530,49 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
   Log::Assert(data.n_rows == minVals.n_elem);
 
   const size_t points = end - start;
+  const size_t numDims = maxVals.n_elem;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension.
+  std::vector<char> dimSplitFound(numDims, false);
+  std::vector<double> dimMinErrors(numDims);
+  std::vector<double> dimLeftErrors(numDims);
+  std::vector<double> dimRightErrors(numDims);
+  std::vector<ElemType> dimSplitValues(numDims);
 
-  // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
-  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
+  auto searchDimension = [&](const size_t dim)
   {
     const ElemType min = minVals[dim];
     const ElemType max = maxVals[dim];
 
     // If there is nothing to split in this dimension, move on.
     if (max - min == 0.0)
-      continue; // Skip to next dimension.
-
-    // Find the log volume of all the other dimensions.
-    const double volumeWithoutDim = logVolume - std::log(max - min);
+      return; // Skip to next dimension.
 
-    // Initializing all other stuff for this dimension.
-    bool dimSplitFound = false;
     // Take an error estimate for this dimension.
     double minDimError = std::pow(points, 2.0) / (max - min);
     double dimLeftError = 0.0; // For -Wuninitialized.  These variables will
     double dimRightError = 0.0; // always be set to something else before use.
     ElemType dimSplitValue = 0.0;
+    bool found = false;
 
     // Get the values for splitting. The old implementation:
     //   dimVec = data.row(dim).subvec(start, end - 1);
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
     // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
-
+    // sparse matrices.  When the points are already sorted, no sorting is
+    // needed at all.
     std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
+    if (sortedPoints)
+    {
+      details::ExtractSortedSplits<ElemType>(splitVec, data,
+          sortedPoints->indices, dim, start, end, minLeafSize);
+    }
+    else
+    {
+      details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+          minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -523,27 +606,48 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
           dimLeftError = negLeftError;
           dimRightError = negRightError;
           dimSplitValue = split;
-          dimSplitFound = true;
+          found = true;
         }
       }
     }
 
-    const double actualMinDimError = std::log(minDimError)
+    dimSplitFound[dim] = found;
+    dimMinErrors[dim] = minDimError;
+    dimLeftErrors[dim] = dimLeftError;
+    dimRightErrors[dim] = dimRightError;
+    dimSplitValues[dim] = dimSplitValue;
+  };
+
+  // Loop through each dimension.
+  details::ForEachDimension(numDims, points, searchDimension);
+
+  // Take the best dimension, the first one in case of ties.
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < numDims; ++dim)
+  {
+    if (!dimSplitFound[dim])
+      continue;
+
+    // Find the log volume of all the other dimensions.
+    const double volumeWithoutDim = logVolume -
+        std::log(maxVals[dim] - minVals[dim]);
+
+    const double actualMinDimError = std::log(dimMinErrors[dim])
       - 2 * std::log((double) data.n_cols)
       - volumeWithoutDim;
 
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+    if (actualMinDimError > minError)
     {
       // Calculate actual error (in logspace) by adding terms back to our
       // estimate.
       minError = actualMinDimError;
       splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
+      splitValue = dimSplitValues[dim];
+      leftError = std::log(dimLeftErrors[dim]) - 2 * std::log((double)
+          data.n_cols) - volumeWithoutDim;
+      rightError = std::log(dimRightErrors[dim]) - 2 * std::log((double)
+          data.n_cols) - volumeWithoutDim;
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -555,8 +659,17 @@ template<typename MatType, typename TagType>
 size_t DTree<MatType, TagType>::SplitData(MatType& data,
                                           const size_t splitDim,
                                           const ElemType splitValue,
-                                          arma::Col<size_t>& oldFromNew) const
+                                          arma::Col<size_t>& oldFromNew,
+                                          DTreeSortedPoints* sortedPoints)
+    const
 {
+  // Track where each point goes, to update the sorted orders.
+  if (sortedPoints)
+  {
+    for (size_t i = start; i < end; ++i)
+      sortedPoints->origins[i] = i;
+  }
+
   // Swap all columns such that any columns with value in dimension splitDim
   // less than or equal to splitValue are on the left side, and all others are
   // on the right side.  A similar sort to this is also performed in
@@ -579,10 +692,47 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
     const size_t tmp = oldFromNew[left];
     oldFromNew[left] = oldFromNew[right];
     oldFromNew[right] = tmp;
+
+    if (sortedPoints)
+    {
+      const size_t origin = sortedPoints->origins[left];
+      sortedPoints->origins[left] = sortedPoints->origins[right];
+      sortedPoints->origins[right] = origin;
+    }
   }
 
   // This now refers to the first index of the "right" side.
-  return left;
+  const size_t splitIndex = left;
+
+  if (sortedPoints)
+  {
+    for (size_t i = start; i < end; ++i)
+      sortedPoints->positions[sortedPoints->origins[i]] = i;
+
+    // Stably partition the order of each dimension between the children, so
+    // that the points of each child stay sorted.
+    auto partitionDimension = [&](const size_t dim)
+    {
+      size_t* indices = sortedPoints->indices.colptr(dim);
+      std::vector<size_t> rightIndices;
+      rightIndices.reserve(end - splitIndex);
+
+      size_t leftEnd = start;
+      for (size_t i = start; i < end; ++i)
+      {
+        const size_t position = sortedPoints->positions[indices[i]];
+        if (position < splitIndex)
+          indices[leftEnd++] = position;
+        else
+          rightIndices.push_back(position);
+      }
+
+      std::copy(rightIndices.begin(), rightIndices.end(), indices + leftEnd);
+    };
+    details::ForEachDimension(data.n_rows, end - start, partitionDimension);
+  }
+
+  return splitIndex;
 }
 
 // Greedily expand the tree.
@@ -596,6 +746,61 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
+  // Sort the points once; the sorted orders are then split with the points.
+  DTreeSortedPoints sortedPoints;
+  const bool sorted = details::SortPoints(data, start, end, sortedPoints);
+
+  return GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+      sorted ? &sortedPoints : NULL);
+}
+
+// Grow the subtrees of both children.
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::GrowChildren(MatType& data,
+                                           arma::Col<size_t>& oldFromNew,
+                                           const bool useVolReg,
+                                           const size_t maxLeafSize,
+                                           const size_t minLeafSize,
+                                           DTreeSortedPoints* sortedPoints,
+                                           double& leftG,
+                                           double& rightG)
+{
+  // The children hold disjoint ranges of the points (and of the sorted
+  // orders), so they can be grown at the same time.  Inside of the parallel
+  // region that ParallelInvoke() opens, the nodes below this one will create
+  // tasks too.
+  if (end - start >= DTreeParallelMinSize)
+  {
+    ParallelInvoke([&]()
+    {
+      leftG = left->GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize,
+          minLeafSize, sortedPoints);
+    }, [&]()
+    {
+      rightG = right->GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize,
+          minLeafSize, sortedPoints);
+    });
+    return;
+  }
+
+  leftG = left->GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize,
+      minLeafSize, sortedPoints);
+  rightG = right->GrowSubtree(data, oldFromNew, useVolReg, maxLeafSize,
+      minLeafSize, sortedPoints);
+}
+
+// Greedily expand the subtree of this node.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::GrowSubtree(MatType& data,
+                                            arma::Col<size_t>& oldFromNew,
+                                            const bool useVolReg,
+                                            const size_t maxLeafSize,
+                                            const size_t minLeafSize,
+                                            DTreeSortedPoints* sortedPoints)
+{
+  Log::Assert(data.n_rows == maxVals.n_elem);
+  Log::Assert(data.n_rows == minVals.n_elem);
+
   double leftG, rightG;
 
   // Compute points ratio.
@@ -614,11 +819,13 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        sortedPoints))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
-      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew,
+          sortedPoints);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -637,10 +844,8 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      GrowChildren(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+          sortedPoints, leftG, rightG);
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
@@ -0,0 +1,110 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * A lock-free union-find structure, which can be modified by several threads
+ * at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A union-find structure whose Union() and Find() can be called by several
+ * threads at once without locks.  It has the same interface as UnionFind.
+ *
+ * The parent of each element is an atomic index.  Find() does path halving
+ * with compare-and-swap, and Union() links the root with the larger index
+ * below the root with the smaller index with compare-and-swap, retrying if
+ * another thread modified the root in the meantime.  Because roots are always
+ * linked by index, the root of each component is its smallest element, so the
+ * result does not depend on the order of the unions (or the number of
+ * threads).
+ */
+class ConcurrentUnionFind
+{
+ public:
+  /**
+   * Construct the object with the given size; each element is in its own
+   * component.
+   *
+   * @param size Number of elements.
+   */
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Return the root of the component containing the given element.
+   *
+   * @param x Element to find.
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load(std::memory_order_acquire);
+      if (p == x)
+        return x;
+
+      // Point x to its grandparent; if another thread changed the parent of x
+      // in the meantime, that is fine too.
+      const size_t gp = parent[p].load(std::memory_order_acquire);
+      if (gp != p)
+        parent[x].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+
+      x = gp;
+    }
+  }
+
+  /**
+   * Unite the components containing the two given elements.
+   *
+   * @param x First element.
+   * @param y Second element.
+   */
+  void Union(const size_t x, const size_t y)
+  {
+    size_t xRoot = x;
+    size_t yRoot = y;
+    while (true)
+    {
+      xRoot = Find(xRoot);
+      yRoot = Find(yRoot);
+      if (xRoot == yRoot)
+        return;
+
+      // Link the root with the larger index below the other one.
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot,
+          std::memory_order_acq_rel))
+        return;
+    }
+  }
+
+  //! Get the number of elements.
+  size_t Size() const { return parent.size(); }
+
+ private:
+  //! The parent of each element; roots are their own parent.
+  std::vector<std::atomic<size_t>> parent;
+};
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
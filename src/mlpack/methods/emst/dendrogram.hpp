@@ -0,0 +1,167 @@
+/**
+ * @file dendrogram.hpp
+ *
+ * Computation of the single-linkage dendrogram of a dataset from its minimum
+ * spanning tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_DENDROGRAM_HPP
+#define MLPACK_METHODS_EMST_DENDROGRAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "union_find.hpp"
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * The Dendrogram class holds the hierarchy of single-linkage clustering of a
+ * dataset, which is computed from the minimum spanning tree of the dataset
+ * (such as the one given by DualTreeBoruvka::ComputeMST()): the edges are taken
+ * by increasing length, and the two clusters joined by each edge are merged
+ * with a union-find structure.  This takes O(n log n) time for the sort of the
+ * edges and nearly linear time for the merges.
+ *
+ * The hierarchy is stored as a 4 x (n - 1) linkage matrix, in the same format
+ * as the linkage matrices of SciPy: column i is the i'th merge, and holds the
+ * two clusters merged (the lesser index first), the length of the edge, and the
+ * number of points in the new cluster.  The clusters 0 to (n - 1) are the
+ * points, and the cluster (n + i) is the one created by the i'th merge.
+ *
+ * @code
+ * extern arma::mat data;
+ * DualTreeBoruvka<> dtb(data);
+ * arma::mat mst;
+ * dtb.ComputeMST(mst);
+ *
+ * Dendrogram dendrogram(mst);
+ *
+ * // Get the clusters of points that are linked by edges of length at most 0.5.
+ * arma::Row<size_t> assignments;
+ * const size_t clusters = dendrogram.Cut(0.5, assignments);
+ * @endcode
+ */
+class Dendrogram
+{
+ public:
+  /**
+   * Compute the dendrogram from the given minimum spanning tree.  The edges may
+   * be in any order.  This throws std::invalid_argument if the edges do not
+   * form a spanning tree of the points.
+   *
+   * @param mst The minimum spanning tree, as a 3 x (n - 1) matrix with the two
+   *      points and the length of each edge, as given by
+   *      DualTreeBoruvka::ComputeMST().
+   */
+  Dendrogram(const arma::mat& mst) :
+      numPoints(mst.n_cols + 1),
+      linkage(4, mst.n_cols),
+      edges(2, mst.n_cols)
+  {
+    if (mst.n_rows != 3)
+    {
+      std::ostringstream oss;
+      oss << "Dendrogram::Dendrogram(): the minimum spanning tree must have 3 "
+          << "rows, but it has " << mst.n_rows << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // The cluster that holds each root of the union-find structure, and its
+    // size.
+    arma::Col<size_t> clusters(numPoints);
+    arma::Col<size_t> sizes(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      clusters[i] = i;
+      sizes[i] = 1;
+    }
+
+    // The output of DualTreeBoruvka is already sorted, but the edges may come
+    // from anywhere.
+    const arma::uvec order = arma::stable_sort_index(mst.row(2));
+
+    UnionFind connections(numPoints);
+    for (size_t i = 0; i < order.n_elem; ++i)
+    {
+      const size_t a = (size_t) mst(0, order[i]);
+      const size_t b = (size_t) mst(1, order[i]);
+      const size_t rootA = (a < numPoints) ? connections.Find(a) : 0;
+      const size_t rootB = (b < numPoints) ? connections.Find(b) : 0;
+      if (a >= numPoints || b >= numPoints || rootA == rootB)
+      {
+        std::ostringstream oss;
+        oss << "Dendrogram::Dendrogram(): edge (" << a << ", " << b << ") "
+            << "of the minimum spanning tree is invalid or forms a cycle!";
+        throw std::invalid_argument(oss.str());
+      }
+
+      linkage(0, i) = std::min(clusters[rootA], clusters[rootB]);
+      linkage(1, i) = std::max(clusters[rootA], clusters[rootB]);
+      linkage(2, i) = mst(2, order[i]);
+      linkage(3, i) = sizes[rootA] + sizes[rootB];
+      edges(0, i) = a;
+      edges(1, i) = b;
+
+      connections.Union(rootA, rootB);
+      const size_t root = connections.Find(rootA);
+      clusters[root] = numPoints + i;
+      sizes[root] = (size_t) linkage(3, i);
+    }
+  }
+
+  /**
+   * Cut the dendrogram at the given distance: the points linked by edges no
+   * longer than the distance are put in the same cluster.  The clusters are
+   * numbered in the order of their first point.
+   *
+   * @param distance The largest length of the edges inside a cluster.
+   * @param assignments The cluster of each point.
+   * @return The number of clusters.
+   */
+  size_t Cut(const double distance, arma::Row<size_t>& assignments) const
+  {
+    UnionFind connections(numPoints);
+    for (size_t i = 0; i < linkage.n_cols && linkage(2, i) <= distance; ++i)
+      connections.Union(edges(0, i), edges(1, i));
+
+    // Number the clusters in the order of their first point.
+    arma::Col<size_t> labels(numPoints);
+    labels.fill(SIZE_MAX);
+    assignments.set_size(numPoints);
+    size_t numClusters = 0;
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      const size_t root = connections.Find(i);
+      if (labels[root] == SIZE_MAX)
+        labels[root] = numClusters++;
+      assignments[i] = labels[root];
+    }
+
+    return numClusters;
+  }
+
+  //! Get the number of points.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the linkage matrix.
+  const arma::mat& Linkage() const { return linkage; }
+
+ private:
+  //! The number of points.
+  size_t numPoints;
+
+  //! The linkage matrix.
+  arma::mat linkage;
+
+  //! The points of the edge of each merge.
+  arma::Mat<size_t> edges;
+};
+
+} // namespace emst
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
@@ -54,6 +55,13 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * }
  * @endcode
  *
+ * Each round of the algorithm is parallelized with OpenMP: the query tree is
+ * split into subtrees that are traversed in parallel, each thread finds
+ * candidate edges for the components with its own arrays, and these are then
+ * merged by component.  The candidate edges are added to the tree in the order
+ * of the components, so the result does not depend on the number of threads
+ * (except possibly which of several edges of equal length is chosen).
+ *
  * General usage of this class might be like this:
  *
  * @code
@@ -103,7 +111,9 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
+  ConcurrentUnionFind connections;
+  //! The component of each point (updated after each round).
+  arma::Col<size_t> components;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -176,7 +186,26 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  /**
+   * Compute the minimum spanning tree of the points under the mutual
+   * reachability distance max(core(a), core(b), d(a, b)) with the given core
+   * distances, as used by HDBSCAN.  The results have the same format as for
+   * ComputeMST(results), but the third row holds the mutual reachability
+   * distances.  If the tree was given to the constructor, the core distances
+   * must be in the order of the points of the tree.
+   *
+   * @param results Matrix which results will be stored in.
+   * @param coreDistances The core distance of each point.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec& coreDistances);
+
  private:
+  /**
+   * Compute the MST, with the mutual reachability distance if core distances
+   * (in the order of the points of the tree) are given.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec* coreDistances);
+
   /**
    * Adds a single edge to the edge list
    */
@@ -187,6 +216,11 @@ class DualTreeBoruvka
    */
   void AddAllEdges();
 
+  /**
+   * Set the component of each point from the connections.
+   */
+  void UpdateComponents();
+
   /**
    * Unpermute the edge list and output it to results.
    */
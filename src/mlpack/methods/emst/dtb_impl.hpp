@@ -14,6 +14,10 @@
 
 #include "dtb_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace emst {
 
@@ -67,6 +71,11 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
   neighborsOutComponent.set_size(data.n_cols);
   neighborsDistances.set_size(data.n_cols);
   neighborsDistances.fill(DBL_MAX);
+
+  // Each point starts in its own component.
+  components.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    components[i] = i;
 }
 
 template<
@@ -92,6 +101,11 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
   neighborsOutComponent.set_size(data.n_cols);
   neighborsDistances.set_size(data.n_cols);
   neighborsDistances.fill(DBL_MAX);
+
+  // Each point starts in its own component.
+  components.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    components[i] = i;
 }
 
 template<
@@ -118,38 +132,197 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     arma::mat& results)
+{
+  ComputeMST(results, (const arma::vec*) NULL);
+}
+
+/**
+ * Compute the MST under the mutual reachability distance with the given core
+ * distances.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec& coreDistances)
+{
+  if (coreDistances.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DualTreeBoruvka::ComputeMST(): the number of core distances ("
+        << coreDistances.n_elem << ") does not match the number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The core distances must follow the points of the tree.
+  if (!naive && ownTree && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    arma::vec permutedCoreDistances(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      permutedCoreDistances[i] = coreDistances[oldFromNew[i]];
+
+    ComputeMST(results, &permutedCoreDistances);
+  }
+  else
+  {
+    ComputeMST(results, &coreDistances);
+  }
+}
+
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec* coreDistances)
 {
   Timer::Start("emst/mst_computation");
 
   totalDist = 0; // Reset distance.
 
+  // Each thread finds candidate edges with its own arrays (the first thread
+  // uses the arrays of this object), and they are merged after each round.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  std::vector<arma::vec> threadDistances(numThreads - 1,
+      arma::vec(data.n_cols));
+  std::vector<arma::Col<size_t>> threadInComponent(numThreads - 1,
+      arma::Col<size_t>(data.n_cols));
+  std::vector<arma::Col<size_t>> threadOutComponent(numThreads - 1,
+      arma::Col<size_t>(data.n_cols));
+  for (size_t t = 0; t < threadDistances.size(); ++t)
+    threadDistances[t].fill(DBL_MAX);
+
+  // Use a few subtrees per thread so that the dynamic schedule can balance
+  // subtrees that are more expensive to traverse than others.  The descendants
+  // of the children of a node partition the descendants of the node, so every
+  // query point belongs to exactly one subtree; since the subtrees are
+  // disjoint, the statistics that the rules update in the query nodes are only
+  // modified by one thread at a time.
+  std::vector<Tree*> subtrees;
+  if (!naive)
+  {
+    const size_t targetSubtrees = (numThreads == 1) ? 1 : 4 * numThreads;
+    subtrees.push_back(tree);
+    bool expanded = true;
+    while (subtrees.size() < targetSubtrees && expanded)
+    {
+      expanded = false;
+      std::vector<Tree*> nextSubtrees;
+      for (size_t i = 0; i < subtrees.size(); ++i)
+      {
+        if (subtrees[i]->NumChildren() == 0)
+        {
+          nextSubtrees.push_back(subtrees[i]);
+          continue;
+        }
+
+        for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+          nextSubtrees.push_back(&subtrees[i]->Child(j));
+        expanded = true;
+      }
+      subtrees.swap(nextSubtrees);
+    }
+  }
+
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
   while (edges.size() < (data.n_cols - 1))
   {
-    if (naive)
+    size_t roundBaseCases = 0;
+    size_t roundScores = 0;
+
+    #pragma omp parallel reduction(+:roundBaseCases, roundScores)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      size_t threadId = 0;
+      #ifdef HAS_OPENMP
+        threadId = omp_get_thread_num();
+      #endif
+
+      arma::vec& distances = (threadId == 0) ? neighborsDistances :
+          threadDistances[threadId - 1];
+      arma::Col<size_t>& inComponent = (threadId == 0) ?
+          neighborsInComponent : threadInComponent[threadId - 1];
+      arma::Col<size_t>& outComponent = (threadId == 0) ?
+          neighborsOutComponent : threadOutComponent[threadId - 1];
+
+      // Each thread gets its own copy of the metric, in case it holds state.
+      MetricType threadMetric(metric);
+      RuleType rules(data, components, distances, inComponent, outComponent,
+          threadMetric, coreDistances);
+
+      if (naive)
+      {
+        // Full O(N^2) traversal.
+        #pragma omp for schedule(static)
+        for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+          for (size_t j = 0; j < data.n_cols; ++j)
+            rules.BaseCase(i, j);
+      }
+      else
+      {
+        #pragma omp for schedule(dynamic)
+        for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+        {
+          typename Tree::template DualTreeTraverser<RuleType>
+              traverser(rules);
+          traverser.Traverse(*subtrees[i], *tree);
+        }
+      }
+
+      roundBaseCases += rules.BaseCases();
+      roundScores += rules.Scores();
     }
-    else
+
+    totalBaseCases += roundBaseCases;
+    totalScores += roundScores;
+
+    // Merge the candidate edges of the threads.  Only the roots of the
+    // components have candidate edges.
+    if (numThreads > 1)
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      #pragma omp parallel for schedule(static)
+      for (omp_size_t c = 0; c < (omp_size_t) data.n_cols; ++c)
+      {
+        if (components[c] != (size_t) c)
+          continue;
+
+        for (size_t t = 0; t < threadDistances.size(); ++t)
+        {
+          if (threadDistances[t][c] < neighborsDistances[c])
+          {
+            neighborsDistances[c] = threadDistances[t][c];
+            neighborsInComponent[c] = threadInComponent[t][c];
+            neighborsOutComponent[c] = threadOutComponent[t][c];
+          }
+        }
+      }
     }
 
     AddAllEdges();
 
+    UpdateComponents();
+
     Cleanup();
+    for (size_t t = 0; t < threadDistances.size(); ++t)
+      threadDistances[t].fill(DBL_MAX);
 
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << totalBaseCases << " cumulative base cases." << std::endl;
+      Log::Info << totalScores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -195,9 +368,14 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
+  // The candidate edges are stored at the roots of the components; they are
+  // added in the order of the roots.
+  for (size_t component = 0; component < data.n_cols; component++)
   {
-    size_t component = connections.Find(i);
+    if (components[component] != component ||
+        neighborsDistances[component] == DBL_MAX)
+      continue;
+
     size_t inEdge = neighborsInComponent[component];
     size_t outEdge = neighborsOutComponent[component];
     if (connections.Find(inEdge) != connections.Find(outEdge))
@@ -211,6 +389,23 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
   }
 }
 
+/**
+ * Set the component of each point from the connections.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::UpdateComponents()
+{
+  // Find() may be called by several threads at once.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    components[i] = connections.Find(i);
+}
+
 /**
  * Unpermute the edge list (if necessary) and output it to results.
  */
@@ -291,7 +486,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
   // if all other components of children and points are the same.
   const int component = (tree->NumChildren() != 0) ?
       tree->Child(0).Stat().ComponentMembership() :
-      connections.Find(tree->Point(0));
+      components[tree->Point(0)];
 
   // Check components of children.
   for (size_t i = 0; i < tree->NumChildren(); ++i)
@@ -300,7 +495,7 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::CleanupHelper(Tree* tree)
 
   // Check components of points.
   for (size_t i = 0; i < tree->NumPoints(); ++i)
-    if (connections.Find(tree->Point(i)) != size_t(component))
+    if (components[tree->Point(i)] != size_t(component))
       return;
 
   // If we made it this far, all components are the same.
@@ -318,8 +513,7 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
-    neighborsDistances[i] = DBL_MAX;
+  neighborsDistances.fill(DBL_MAX);
 
   if (!naive)
     CleanupHelper(tree);
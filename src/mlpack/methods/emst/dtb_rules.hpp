@@ -19,16 +19,48 @@
 namespace mlpack {
 namespace emst {
 
+/**
+ * The rules for one round of the DualTreeBoruvka algorithm: find the nearest
+ * neighbor outside of its component of each component.  The components of the
+ * points are read from an array that is not modified during the round, so
+ * several DTBRules objects can be used by different threads at once, each with
+ * its own candidate edges, as long as they traverse disjoint query subtrees.
+ *
+ * If core distances are given, the length of an edge is the mutual
+ * reachability distance max(core(a), core(b), d(a, b)) used by HDBSCAN instead
+ * of the distance d(a, b).  Since it is never smaller than the distance, the
+ * lower bounds of the tree stay valid.
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the DTBRules object.
+   *
+   * @param dataSet The data points.
+   * @param components The component of each point (the root of its set in the
+   *      union-find structure).
+   * @param neighborsDistances The distance of the candidate edge of each
+   *      component.
+   * @param neighborsInComponent The endpoint in the component of the candidate
+   *      edge of each component.
+   * @param neighborsOutComponent The endpoint out of the component of the
+   *      candidate edge of each component.
+   * @param metric Instantiated metric.
+   * @param coreDistances The core distance of each point, to use the mutual
+   *      reachability distance, or NULL to use the distance of the metric.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           const arma::Col<size_t>& components,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
-           MetricType& metric);
+           MetricType& metric,
+           const arma::vec* coreDistances = NULL);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -101,8 +133,8 @@ class DTBRules
   //! The data points.
   const arma::mat& dataSet;
 
-  //! Stores the tree structure so far
-  UnionFind& connections;
+  //! The component of each point, for the tree structure so far.
+  const arma::Col<size_t>& components;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
@@ -118,6 +150,9 @@ class DTBRules
   //! The instantiated metric.
   MetricType& metric;
 
+  //! The core distance of each point (may be NULL).
+  const arma::vec* coreDistances;
+
   /**
    * Update the bound for the given query node.
    */
@@ -18,18 +18,20 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
+         const arma::Col<size_t>& components,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
-         MetricType& metric)
+         MetricType& metric,
+         const arma::vec* coreDistances)
 :
   dataSet(dataSet),
-  connections(connections),
+  components(components),
   neighborsDistances(neighborsDistances),
   neighborsInComponent(neighborsInComponent),
   neighborsOutComponent(neighborsOutComponent),
   metric(metric),
+  coreDistances(coreDistances),
   baseCases(0),
   scores(0)
 {
@@ -47,15 +49,21 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   double newUpperBound = -1.0;
 
   // Find the index of the component the query is in.
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  const size_t queryComponentIndex = components[queryIndex];
 
-  size_t referenceComponentIndex = connections.Find(referenceIndex);
+  const size_t referenceComponentIndex = components[referenceIndex];
 
   if (queryComponentIndex != referenceComponentIndex)
   {
     ++baseCases;
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
+    if (coreDistances)
+    {
+      // Use the mutual reachability distance.
+      distance = std::max(distance, std::max((*coreDistances)[queryIndex],
+          (*coreDistances)[referenceIndex]));
+    }
 
     if (distance < neighborsDistances[queryComponentIndex])
     {
@@ -79,7 +87,7 @@ template<typename MetricType, typename TreeType>
 double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
                                              TreeType& referenceNode)
 {
-  size_t queryComponentIndex = connections.Find(queryIndex);
+  const size_t queryComponentIndex = components[queryIndex];
 
   // If the query belongs to the same component as all of the references,
   // then prune.  The cast is to stop a warning about comparing unsigned to
@@ -104,7 +112,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > neighborsDistances[components[queryIndex]])
       ? DBL_MAX : oldScore;
 }
 
@@ -152,7 +160,7 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   // Now, find the best and worst point bounds.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const size_t pointComponent = connections.Find(queryNode.Point(i));
+    const size_t pointComponent = components[queryNode.Point(i)];
     const double bound = neighborsDistances[pointComponent];
 
     if (bound > worstPointBound)
@@ -177,8 +185,10 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   const double worstBound = std::max(worstPointBound, worstChildBound);
   const double bestBound = std::min(bestPointBound, bestChildBound);
   // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.
-  const double bestAdjustedBound = (bestBound == DBL_MAX) ? DBL_MAX :
-      bestBound + 2 * queryNode.FurthestDescendantDistance();
+  // This adjustment relies on the triangle inequality, which the mutual
+  // reachability distance does not satisfy, so it is skipped in that case.
+  const double bestAdjustedBound = (bestBound == DBL_MAX || coreDistances) ?
+      DBL_MAX : bestBound + 2 * queryNode.FurthestDescendantDistance();
 
   // Update the relevant quantities in the node.
   queryNode.Stat().MaxNeighborDistance() = worstBound;
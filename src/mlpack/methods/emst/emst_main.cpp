@@ -29,6 +29,7 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "dtb.hpp"
+#include "dendrogram.hpp"
 
 PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     // Short description.
@@ -60,7 +61,16 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
     "The output matrix is a three-dimensional matrix, where each row indicates "
     "an edge.  The first dimension corresponds to the lesser index of the edge;"
     " the second dimension corresponds to the greater index of the edge; and "
-    "the third column corresponds to the distance between the two points.",
+    "the third column corresponds to the distance between the two points."
+    "\n\n"
+    "The single-linkage clustering hierarchy of the points, computed from the "
+    "minimum spanning tree, may be saved with the " +
+    PRINT_PARAM_STRING("dendrogram") + " output parameter.  It has one row for"
+    " each merge of two clusters, in order of increasing distance; the first "
+    "two dimensions are the merged clusters (clusters 0 to n - 1 are the "
+    "points, and cluster n + i is the one created by the i'th merge), the "
+    "third is the distance, and the fourth is the number of points of the new "
+    "cluster.",
     SEE_ALSO("EMST Tutorial", "@doxygen/emst_tutorial.html"),
     SEE_ALSO("Minimum spanning tree on Wikipedia",
         "https://en.wikipedia.org/wiki/Minimum_spanning_tree"),
@@ -71,6 +81,8 @@ PROGRAM_INFO("Fast Euclidean Minimum Spanning Tree",
 
 PARAM_MATRIX_IN_REQ("input", "Input data matrix.", "i");
 PARAM_MATRIX_OUT("output", "Output data.  Stored as an edge list.", "o");
+PARAM_MATRIX_OUT("dendrogram", "Single-linkage dendrogram of the points, as a "
+    "list of merges.", "d");
 PARAM_FLAG("naive", "Compute the MST using O(n^2) naive algorithm.", "n");
 PARAM_INT_IN("leaf_size", "Leaf size in the kd-tree.  One-element leaves give "
     "the empirically best performance, but at the cost of greater memory "
@@ -85,9 +97,11 @@ using namespace std;
 
 static void mlpackMain()
 {
-  RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+  RequireAtLeastOnePassed({ "output", "dendrogram" }, false,
+      "no output will be saved");
 
   arma::mat dataPoints = std::move(CLI::GetParam<arma::mat>("input"));
+  arma::mat mst;
 
   // Do naive computation if necessary.
   if (CLI::GetParam<bool>("naive"))
@@ -96,11 +110,7 @@ static void mlpackMain()
 
     DualTreeBoruvka<> naive(dataPoints, true);
 
-    arma::mat naiveResults;
-    naive.ComputeMST(naiveResults);
-
-    if (CLI::HasParam("output"))
-      CLI::GetParam<arma::mat>("output") = std::move(naiveResults);
+    naive.ComputeMST(mst);
   }
   else
   {
@@ -129,7 +139,7 @@ static void mlpackMain()
     dtb.ComputeMST(results);
 
     // Unmap the results.
-    arma::mat unmappedResults(results.n_rows, results.n_cols);
+    mst.set_size(results.n_rows, results.n_cols);
     for (size_t i = 0; i < results.n_cols; ++i)
     {
       const size_t indexA = oldFromNew[size_t(results(0, i))];
@@ -137,19 +147,26 @@ static void mlpackMain()
 
       if (indexA < indexB)
       {
-        unmappedResults(0, i) = indexA;
-        unmappedResults(1, i) = indexB;
+        mst(0, i) = indexA;
+        mst(1, i) = indexB;
       }
       else
       {
-        unmappedResults(0, i) = indexB;
-        unmappedResults(1, i) = indexA;
+        mst(0, i) = indexB;
+        mst(1, i) = indexA;
       }
 
-      unmappedResults(2, i) = results(2, i);
+      mst(2, i) = results(2, i);
     }
+  }
 
-    if (CLI::HasParam("output"))
-      CLI::GetParam<arma::mat>("output") = std::move(unmappedResults);
+  if (CLI::HasParam("dendrogram"))
+  {
+    Log::Info << "Computing single-linkage dendrogram." << endl;
+    Dendrogram dendrogram(mst);
+    CLI::GetParam<arma::mat>("dendrogram") = dendrogram.Linkage();
   }
+
+  if (CLI::HasParam("output"))
+    CLI::GetParam<arma::mat>("output") = std::move(mst);
 }
@@ -48,6 +48,22 @@ namespace fastmks /** Fast max-kernel search. */ {
  * on points in the dataset (and not centroids of regions or anything like
  * that).
  *
+ * The tree searches can be made approximate with Epsilon(): a node is then
+ * pruned when its maximum kernel value is less than (1 + epsilon) times the
+ * current k'th best kernel value of the query (for a positive value; it is
+ * increased by epsilon times its absolute value in general), so each returned
+ * kernel value is at least the true one divided by (1 + epsilon) when the
+ * kernel values are positive.  Single-tree search can also stop recursing for
+ * a query point after MaxBaseCases() base cases, which bounds the work per
+ * query at the cost of any guarantee.
+ *
+ * If OpenMP is available, each type of search is run in parallel: naive and
+ * single-tree search split the query points among the threads, and dual-tree
+ * search splits the query tree into subtrees.  Searches with a query set may
+ * also be run at the same time from several threads on a const FastMKS object
+ * (for instance, a model loaded once and used to serve queries); these never
+ * modify the reference tree.
+ *
  * @tparam KernelType Type of kernel to run FastMKS with.
  * @tparam MatType Type of data matrix (usually arma::mat).
  * @tparam TreeType Type of tree to run FastMKS with; it must satisfy the
@@ -188,6 +204,25 @@ class FastMKS
               arma::Mat<size_t>& indices,
               arma::mat& kernels);
 
+  /**
+   * Search for the points in the reference set with maximum kernel evaluation
+   * to each point in the given query set, without modifying the model; the
+   * results are stored as with the non-const overload.  This may be called
+   * from several threads at once on the same object.  In single-tree mode,
+   * the kernel evaluations are not cached in the reference tree, so
+   * parent-child prunes are not possible and the search may be a little
+   * slower than the non-const overload.
+   *
+   * @param querySet Set of query points (can be a single point).
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& indices,
+              arma::mat& kernels) const;
+
   /**
    * Search for the points in the reference set with maximum kernel evaluation
    * to each point in the query set corresponding to the given pre-built query
@@ -205,6 +240,9 @@ class FastMKS
    * here are with respect to the modified input matrix (that is,
    * queryTree->Dataset()).
    *
+   * Only the statistics of the query tree are modified, so this may be called
+   * from several threads at once with different query trees.
+   *
    * @param queryTree Tree built on query points.
    * @param k The number of maximum kernels to find.
    * @param indices Matrix to store resulting indices of max-kernel search in.
@@ -213,7 +251,7 @@ class FastMKS
   void Search(Tree* querySet,
               const size_t k,
               arma::Mat<size_t>& indices,
-              arma::mat& kernels);
+              arma::mat& kernels) const;
 
   /**
    * Search for the maximum inner products of the query set (or if no query set
@@ -248,6 +286,19 @@ class FastMKS
   //! Modify whether or not brute-force (naive) search is used.
   bool& Naive() { return naive; }
 
+  //! Get the relative error of approximate tree search (0 for exact search).
+  double Epsilon() const { return epsilon; }
+  //! Modify the relative error of approximate tree search (0 for exact
+  //! search).
+  double& Epsilon() { return epsilon; }
+
+  //! Get the maximum number of base cases of each query point in single-tree
+  //! search (0 for no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases of each query point in
+  //! single-tree search (0 for no limit).
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -268,9 +319,42 @@ class FastMKS
   //! If true, naive (brute-force) search is used.
   bool naive;
 
+  //! The relative error of approximate tree search.
+  double epsilon;
+  //! The maximum number of base cases of each query point in single-tree
+  //! search (0 for no limit).
+  size_t maxBaseCases;
+
   //! The instantiated inner-product metric induced by the given kernel.
   metric::IPMetric<KernelType> metric;
 
+  /**
+   * Search with the given query set; if cacheKernels is false, the reference
+   * tree is not modified.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& indices,
+              arma::mat& kernels,
+              const bool cacheKernels) const;
+
+  //! Run brute-force search with the given query set, in parallel.
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels) const;
+
+  /**
+   * Run single-tree search with the given query set, in parallel.  The kernel
+   * evaluations are only cached in the reference tree if cacheKernels is true
+   * and only one thread is used.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& indices,
+                        arma::mat& kernels,
+                        const bool cacheKernels) const;
+
   //! Candidate represents a possible candidate point (value, index).
   typedef std::pair<double, size_t> Candidate;
 
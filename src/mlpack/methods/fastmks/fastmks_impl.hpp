@@ -19,6 +19,10 @@
 
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace fastmks {
 
@@ -35,7 +39,9 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const bool singleMode,
     treeOwner(true),
     setOwner(true),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    epsilon(0.0),
+    maxBaseCases(0)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -58,7 +64,9 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(
     treeOwner(true),
     setOwner(false),
     singleMode(singleMode),
-    naive(naive)
+    naive(naive),
+    epsilon(0.0),
+    maxBaseCases(0)
 {
   Timer::Start("tree_building");
   if (!naive)
@@ -82,6 +90,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const MatType& referenceSet,
     setOwner(false),
     singleMode(singleMode),
     naive(naive),
+    epsilon(0.0),
+    maxBaseCases(0),
     metric(kernel)
 {
   Timer::Start("tree_building");
@@ -107,6 +117,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(Tree* referenceTree,
     setOwner(false),
     singleMode(singleMode),
     naive(false),
+    epsilon(0.0),
+    maxBaseCases(0),
     metric(referenceTree->Metric())
 {
   // Nothing to do.
@@ -124,6 +136,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(const FastMKS& other) :
     setOwner(other.referenceTree == NULL),
     singleMode(other.singleMode),
     naive(other.naive),
+    epsilon(other.epsilon),
+    maxBaseCases(other.maxBaseCases),
     metric(other.metric)
 {
   // Set reference set correctly.
@@ -145,6 +159,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
     setOwner(other.setOwner),
     singleMode(other.singleMode),
     naive(other.naive),
+    epsilon(other.epsilon),
+    maxBaseCases(other.maxBaseCases),
     metric(std::move(other.metric))
 {
   // Clear information from the other.
@@ -154,6 +170,8 @@ FastMKS<KernelType, MatType, TreeType>::FastMKS(FastMKS&& other) :
   other.setOwner = false;
   other.singleMode = false;
   other.naive = false;
+  other.epsilon = 0.0;
+  other.maxBaseCases = 0;
 }
 
 template<typename KernelType,
@@ -189,6 +207,10 @@ FastMKS<KernelType, MatType, TreeType>::operator=(const FastMKS& other)
 
   singleMode = other.singleMode;
   naive = other.naive;
+  epsilon = other.epsilon;
+  maxBaseCases = other.maxBaseCases;
+
+  return *this;
 }
 
 template<typename KernelType,
@@ -286,6 +308,38 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     const size_t k,
     arma::Mat<size_t>& indices,
     arma::mat& kernels)
+{
+  // The reference tree is only used by this object, so single-tree search may
+  // cache kernel evaluations in it.
+  Search(querySet, k, indices, kernels, true);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels) const
+{
+  // Other searches may use the reference tree at the same time.
+  Search(querySet, k, indices, kernels, false);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool cacheKernels) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -295,66 +349,23 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
-  Timer::Start("computing_products");
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
 
-  // No remapping will be necessary because we are using the cover tree.
-  indices.set_size(k, querySet.n_cols);
-  kernels.set_size(k, querySet.n_cols);
+  Timer::Start("computing_products");
 
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
-
+    NaiveSearch(querySet, k, indices, kernels);
     Timer::Stop("computing_products");
-
     return;
   }
 
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
-
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
-
+    SingleTreeSearch(querySet, k, indices, kernels, cacheKernels);
     Timer::Stop("computing_products");
     return;
   }
@@ -378,7 +389,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     Tree* queryTree,
     const size_t k,
     arma::Mat<size_t>& indices,
-    arma::mat& kernels)
+    arma::mat& kernels) const
 {
   if (k > referenceSet->n_cols)
   {
@@ -388,6 +399,9 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+
   // If either naive mode or single mode is specified, this must fail.
   if (naive || singleMode)
   {
@@ -401,16 +415,71 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 
   Timer::Start("computing_products");
   typedef FastMKSRules<KernelType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), k, metric.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  // Use a few subtrees per thread so that the dynamic schedule can balance
+  // subtrees that are more expensive to traverse than others.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t targetSubtrees = (numThreads == 1) ? 1 : 4 * numThreads;
+
+  // Expand the query tree level by level until there are enough subtrees.  The
+  // descendants of the children of a node partition the descendants of the
+  // node, so every query point belongs to exactly one subtree.  The bounds of
+  // the expanded nodes are reset, since the subtrees use them as the bounds of
+  // their parents and they are not traversed.
+  std::vector<Tree*> subtrees(1, queryTree);
+  bool expanded = true;
+  while (subtrees.size() < targetSubtrees && expanded)
+  {
+    expanded = false;
+    std::vector<Tree*> nextSubtrees;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() == 0)
+      {
+        nextSubtrees.push_back(subtrees[i]);
+        continue;
+      }
+
+      subtrees[i]->Stat().Bound() = -DBL_MAX;
+      for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        nextSubtrees.push_back(&subtrees[i]->Child(j));
+      expanded = true;
+    }
+    subtrees.swap(nextSubtrees);
+  }
+
+  size_t baseCases = 0;
+  size_t scores = 0;
+
+  #pragma omp parallel reduction(+:baseCases, scores)
+  {
+    // Each thread gets its own copy of the kernel, in case it holds state, and
+    // its own rules, which hold the candidates of the points of its subtrees.
+    KernelType kernel(metric.Kernel());
+    RuleType rules(*referenceSet, queryTree->Dataset(), k, kernel, true,
+        epsilon);
+
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+    {
+      traverser.Traverse(*subtrees[i], *referenceTree);
 
-  traverser.Traverse(*queryTree, *referenceTree);
+      // No other subtree has candidates for these points.
+      for (size_t j = 0; j < subtrees[i]->NumDescendants(); ++j)
+        rules.GetResults(subtrees[i]->Descendant(j), indices, kernels);
+    }
 
-  Log::Info << rules.BaseCases() << " base cases." << std::endl;
-  Log::Info << rules.Scores() << " scores." << std::endl;
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
 
-  rules.GetResults(indices, kernels);
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
 
   Timer::Stop("computing_products");
 }
@@ -425,16 +494,61 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     arma::Mat<size_t>& indices,
     arma::mat& kernels)
 {
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+
   // No remapping will be necessary because we are using the cover tree.
   Timer::Start("computing_products");
-  indices.set_size(k, referenceSet->n_cols);
-  kernels.set_size(k, referenceSet->n_cols);
 
-  // Naive implementation.
+  // Naive implementation.  Using the reference set as the query set keeps each
+  // point from being returned as its own candidate.
   if (naive)
   {
+    NaiveSearch(*referenceSet, k, indices, kernels);
+    Timer::Stop("computing_products");
+    return;
+  }
+
+  // Single-tree implementation.
+  if (singleMode)
+  {
+    SingleTreeSearch(*referenceSet, k, indices, kernels, true);
+    Timer::Stop("computing_products");
+    return;
+  }
+
+  // Dual-tree implementation.
+  Timer::Stop("computing_products");
+
+  Search(referenceTree, k, indices, kernels);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels) const
+{
+  indices.set_size(k, querySet.n_cols);
+  kernels.set_size(k, querySet.n_cols);
+
+  // If the query set is the reference set, don't return a point as its own
+  // candidate.
+  const bool sameSet = (&querySet == referenceSet);
+
+  #pragma omp parallel
+  {
+    // Each thread gets its own copy of the kernel, in case it holds state.
+    KernelType kernel(metric.Kernel());
+
     // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
+    #pragma omp for schedule(static)
+    for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
     {
       const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
       std::vector<Candidate> cList(k, def);
@@ -442,11 +556,11 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
 
       for (size_t r = 0; r < referenceSet->n_cols; ++r)
       {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+        if (sameSet && ((size_t) q == r))
+          continue;
 
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
+        const double eval = kernel.Evaluate(querySet.col(q),
+                                            referenceSet->col(r));
 
         if (eval > pqueue.top().first)
         {
@@ -463,43 +577,65 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
         pqueue.pop();
       }
     }
-
-    Timer::Stop("computing_products");
-
-    return;
   }
+}
 
-  // Single-tree implementation.
-  if (singleMode)
-  {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool cacheKernels) const
+{
+  typedef FastMKSRules<KernelType, Tree> RuleType;
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  indices.set_size(k, querySet.n_cols);
+  kernels.set_size(k, querySet.n_cols);
 
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
+  // The kernel evaluations stored in the reference nodes would be overwritten
+  // by the other threads.
+  const bool useCache = cacheKernels && (numThreads == 1);
 
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  size_t baseCases = 0;
+  size_t scores = 0;
+  size_t numPrunes = 0;
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+  #pragma omp parallel reduction(+:baseCases, scores, numPrunes)
+  {
+    // Each thread gets its own copy of the kernel, in case it holds state, and
+    // its own rules object, which stores the results.  The constructor
+    // precalculates each query self-kernel value.
+    KernelType kernel(metric.Kernel());
+    RuleType rules(*referenceSet, querySet, k, kernel, useCache, epsilon,
+        maxBaseCases);
 
-    rules.GetResults(indices, kernels);
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    Timer::Stop("computing_products");
-    return;
-  }
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      traverser.Traverse(i, *referenceTree);
+      rules.GetResults(i, indices, kernels);
+    }
 
-  // Dual-tree implementation.
-  Timer::Stop("computing_products");
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    numPrunes += traverser.NumPrunes();
+  }
 
-  Search(referenceTree, k, indices, kernels);
+  Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
 }
 
 //! Serialize the model.
@@ -57,7 +57,14 @@ PROGRAM_INFO("FastMKS (Fast Max-Kernel Search)",
     "\n\n"
     "This program performs FastMKS using a cover tree.  The base used to build "
     "the cover tree can be specified with the " + PRINT_PARAM_STRING("base") +
-    " parameter.",
+    " parameter."
+    "\n\n"
+    "The tree searches can be made approximate with the " +
+    PRINT_PARAM_STRING("epsilon") + " parameter: then each returned positive "
+    "kernel value is at least the true one divided by (1 + epsilon), and "
+    "large parts of the reference set may be skipped.  For single-tree search, "
+    "the " + PRINT_PARAM_STRING("max_base_cases") + " parameter also limits the"
+    " number of kernel evaluations of each query point.",
     SEE_ALSO("Fast max-kernel search tutorial (fastmks)",
         "@doxygen/fmkstutorial.html"),
     SEE_ALSO("k-nearest-neighbor search", "#knn"),
@@ -92,6 +99,10 @@ PARAM_INT_IN("k", "Number of maximum kernels to find.", "k", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single", "If true, single-tree search is used (as opposed to "
     "dual-tree search.", "S");
+PARAM_DOUBLE_IN("epsilon", "Relative error of approximate tree search; if 0, "
+    "the search is exact.", "e", 0.0);
+PARAM_INT_IN("max_base_cases", "If positive, the maximum number of base cases "
+    "of each query point in single-tree search.", "B", 0);
 
 PARAM_MATRIX_OUT("kernels", "Output matrix of kernels.", "p");
 PARAM_UMATRIX_OUT("indices", "Output matrix of indices.", "i");
@@ -124,6 +135,14 @@ static void mlpackMain()
   // Naive mode overrides single mode.
   ReportIgnoredParam({{ "naive", true }}, "single");
 
+  // Check the approximation parameters.
+  RequireParamValue<double>("epsilon", [](double x) { return x >= 0.0; }, true,
+      "epsilon must be non-negative");
+  RequireParamValue<int>("max_base_cases", [](int x) { return x >= 0; }, true,
+      "maximum number of base cases must not be negative");
+  ReportIgnoredParam({{ "naive", true }}, "epsilon");
+  ReportIgnoredParam({{ "single", false }}, "max_base_cases");
+
   FastMKSModel* model;
   arma::mat referenceData;
   if (CLI::HasParam("reference"))
@@ -200,6 +219,8 @@ static void mlpackMain()
   // Set search preferences.
   model->Naive() = CLI::HasParam("naive");
   model->SingleMode() = CLI::HasParam("single");
+  model->Epsilon() = CLI::GetParam<double>("epsilon");
+  model->MaxBaseCases() = (size_t) CLI::GetParam<int>("max_base_cases");
 
   // Should we do search?
   if (CLI::HasParam("k"))
@@ -219,6 +219,98 @@ bool& FastMKSModel::SingleMode()
   throw std::runtime_error("invalid model type");
 }
 
+double FastMKSModel::Epsilon() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->Epsilon();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->Epsilon();
+    case COSINE_DISTANCE:
+      return cosine->Epsilon();
+    case GAUSSIAN_KERNEL:
+      return gaussian->Epsilon();
+    case EPANECHNIKOV_KERNEL:
+      return epan->Epsilon();
+    case TRIANGULAR_KERNEL:
+      return triangular->Epsilon();
+    case HYPTAN_KERNEL:
+      return hyptan->Epsilon();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+double& FastMKSModel::Epsilon()
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->Epsilon();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->Epsilon();
+    case COSINE_DISTANCE:
+      return cosine->Epsilon();
+    case GAUSSIAN_KERNEL:
+      return gaussian->Epsilon();
+    case EPANECHNIKOV_KERNEL:
+      return epan->Epsilon();
+    case TRIANGULAR_KERNEL:
+      return triangular->Epsilon();
+    case HYPTAN_KERNEL:
+      return hyptan->Epsilon();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+size_t FastMKSModel::MaxBaseCases() const
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->MaxBaseCases();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->MaxBaseCases();
+    case COSINE_DISTANCE:
+      return cosine->MaxBaseCases();
+    case GAUSSIAN_KERNEL:
+      return gaussian->MaxBaseCases();
+    case EPANECHNIKOV_KERNEL:
+      return epan->MaxBaseCases();
+    case TRIANGULAR_KERNEL:
+      return triangular->MaxBaseCases();
+    case HYPTAN_KERNEL:
+      return hyptan->MaxBaseCases();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
+size_t& FastMKSModel::MaxBaseCases()
+{
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      return linear->MaxBaseCases();
+    case POLYNOMIAL_KERNEL:
+      return polynomial->MaxBaseCases();
+    case COSINE_DISTANCE:
+      return cosine->MaxBaseCases();
+    case GAUSSIAN_KERNEL:
+      return gaussian->MaxBaseCases();
+    case EPANECHNIKOV_KERNEL:
+      return epan->MaxBaseCases();
+    case TRIANGULAR_KERNEL:
+      return triangular->MaxBaseCases();
+    case HYPTAN_KERNEL:
+      return hyptan->MaxBaseCases();
+  }
+
+  throw std::runtime_error("invalid model type");
+}
+
 void FastMKSModel::Search(const arma::mat& querySet,
                           const size_t k,
                           arma::Mat<size_t>& indices,
@@ -253,6 +345,48 @@ void FastMKSModel::Search(const arma::mat& querySet,
   }
 }
 
+void FastMKSModel::Search(const arma::mat& querySet,
+                          const size_t k,
+                          arma::Mat<size_t>& indices,
+                          arma::mat& kernels,
+                          const double base) const
+{
+  // Use the const FastMKS models, which do not modify their reference trees.
+  switch (kernelType)
+  {
+    case LINEAR_KERNEL:
+      Search(static_cast<const FastMKS<kernel::LinearKernel>&>(*linear),
+          querySet, k, indices, kernels, base);
+      break;
+    case POLYNOMIAL_KERNEL:
+      Search(static_cast<const FastMKS<kernel::PolynomialKernel>&>(*polynomial),
+          querySet, k, indices, kernels, base);
+      break;
+    case COSINE_DISTANCE:
+      Search(static_cast<const FastMKS<kernel::CosineDistance>&>(*cosine),
+          querySet, k, indices, kernels, base);
+      break;
+    case GAUSSIAN_KERNEL:
+      Search(static_cast<const FastMKS<kernel::GaussianKernel>&>(*gaussian),
+          querySet, k, indices, kernels, base);
+      break;
+    case EPANECHNIKOV_KERNEL:
+      Search(static_cast<const FastMKS<kernel::EpanechnikovKernel>&>(*epan),
+          querySet, k, indices, kernels, base);
+      break;
+    case TRIANGULAR_KERNEL:
+      Search(static_cast<const FastMKS<kernel::TriangularKernel>&>(*triangular),
+          querySet, k, indices, kernels, base);
+      break;
+    case HYPTAN_KERNEL:
+      Search(static_cast<const FastMKS<kernel::HyperbolicTangentKernel>&>(*hyptan),
+          querySet, k, indices, kernels, base);
+      break;
+    default:
+      throw std::runtime_error("invalid model type");
+  }
+}
+
 void FastMKSModel::Search(const size_t k,
                           arma::Mat<size_t>& indices,
                           arma::mat& kernels)
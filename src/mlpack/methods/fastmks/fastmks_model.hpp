@@ -86,6 +86,18 @@ class FastMKSModel
   //! Set whether or not single-tree search is used.
   bool& SingleMode();
 
+  //! Get the relative error of approximate tree search.
+  double Epsilon() const;
+  //! Set the relative error of approximate tree search (0 for exact search).
+  double& Epsilon();
+
+  //! Get the maximum number of base cases of each query point in single-tree
+  //! search.
+  size_t MaxBaseCases() const;
+  //! Set the maximum number of base cases of each query point in single-tree
+  //! search (0 for no limit).
+  size_t& MaxBaseCases();
+
   //! Get the kernel type.
   int KernelType() const { return kernelType; }
   //! Modify the kernel type.
@@ -109,6 +121,26 @@ class FastMKSModel
               arma::mat& kernels,
               const double base);
 
+  /**
+   * Search with a different query set, without modifying the model.  This may
+   * be called from several threads at once, so that one model can be shared
+   * to serve queries.
+   *
+   * @param querySet Set to search with.
+   * @param k Number of max-kernel candidates to search for.
+   * @param indices A matrix in which to store the indices of max-kernel
+   *      candidates.
+   * @param kernels A matrix in which to store the max-kernel candidate kernel
+   *      values.
+   * @param base Base to use for cover tree building (if in dual-tree search
+   *      mode).
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& indices,
+              arma::mat& kernels,
+              const double base) const;
+
   /**
    * Search with the reference set as the query set.
    *
@@ -147,14 +179,14 @@ class FastMKSModel
   //! This will only be non-NULL if this is the type of kernel we are using.
   FastMKS<kernel::HyperbolicTangentKernel>* hyptan;
 
-  //! Build a query tree and execute the search.
+  //! Build a query tree and execute the search.  FastMKSType may be const.
   template<typename FastMKSType>
   void Search(FastMKSType& f,
               const arma::mat& querySet,
               const size_t k,
               arma::Mat<size_t>& indices,
               arma::mat& kernels,
-              const double base);
+              const double base) const;
 };
 
 } // namespace fastmks
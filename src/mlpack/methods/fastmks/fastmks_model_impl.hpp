@@ -196,7 +196,7 @@ void FastMKSModel::Search(FastMKSType& f,
                           const size_t k,
                           arma::Mat<size_t>& indices,
                           arma::mat& kernels,
-                          const double base)
+                          const double base) const
 {
   if (f.Naive() || f.SingleMode())
   {
@@ -23,8 +23,9 @@ namespace fastmks {
 
 /**
  * The FastMKSRules class is a template helper class used by FastMKS class when
- * performing exact max-kernel search. For each point in the query dataset, it
- * keeps track of the k best candidates in the reference dataset.
+ * performing exact or approximate max-kernel search. For each point in the
+ * query dataset, it keeps track of the k best candidates in the reference
+ * dataset.
  *
  * @tparam KernelType Type of kernel to run FastMKS with.
  * @tparam TreeType Type of tree to run FastMKS with; it must satisfy the
@@ -42,11 +43,24 @@ class FastMKSRules
    * @param querySet Set of query data.
    * @param k Number of candidates to search for.
    * @param kernel Kernel to run FastMKS with.
+   * @param cacheKernels If false, single-tree search does not store kernel
+   *     evaluations in the statistics of the reference nodes (and so cannot
+   *     use parent-child prunes); then several searches can share the same
+   *     reference tree at once.
+   * @param epsilon Relative error of the approximate search: nodes are pruned
+   *     when their maximum kernel value is less than the k'th best kernel
+   *     value so far, increased by epsilon times its absolute value.  If 0,
+   *     the search is exact.
+   * @param maxBaseCases If not 0, single-tree search stops recursing for a
+   *     query point once that many base cases have been computed for it.
    */
   FastMKSRules(const typename TreeType::Mat& referenceSet,
                const typename TreeType::Mat& querySet,
                const size_t k,
-               KernelType& kernel);
+               KernelType& kernel,
+               const bool cacheKernels = true,
+               const double epsilon = 0.0,
+               const size_t maxBaseCases = 0);
 
   /**
    * Store the list of candidates for each query point in the given matrices.
@@ -56,6 +70,19 @@ class FastMKSRules
    */
   void GetResults(arma::Mat<size_t>& indices, arma::mat& products);
 
+  /**
+   * Store the list of candidates for the given query point in its column of
+   * the given matrices, which must already have k rows and one column for each
+   * query point.  The list of candidates of the point is emptied.
+   *
+   * @param queryIndex Index of the query point.
+   * @param indices Matrix storing lists of candidate for each query point.
+   * @param products Matrix storing kernel value for each candidate.
+   */
+  void GetResults(const size_t queryIndex,
+                  arma::Mat<size_t>& indices,
+                  arma::mat& products);
+
   //! Compute the base case (kernel value) between two points.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
@@ -156,7 +183,9 @@ class FastMKSRules
 
   //! Cached query set self-kernels (|| q || for each q).
   arma::vec queryKernels;
-  //! Cached reference set self-kernels (|| r || for each r).
+  //! Cached reference set self-kernels (|| r || for each r); these are only
+  //! needed by dual-tree search, so they are computed at the first dual-tree
+  //! Score() call.
   arma::vec referenceKernels;
 
   //! The instantiated kernel.
@@ -169,6 +198,30 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! If true, kernel evaluations are stored in the reference node statistics.
+  bool cacheKernels;
+
+  //! Relative error of the approximate search.
+  double epsilon;
+  //! The maximum number of base cases of each query point (0 for no limit).
+  size_t maxBaseCases;
+  //! The number of base cases of each query point, if maxBaseCases is not 0.
+  std::vector<size_t> queryBaseCases;
+
+  //! Relax the given k'th best kernel value by the relative error epsilon, so
+  //! that nodes which can only improve it by less than that are pruned.
+  double Relax(const double bestKernel) const
+  {
+    return (bestKernel == -DBL_MAX) ? bestKernel :
+        bestKernel + epsilon * std::abs(bestKernel);
+  }
+
+  //! Return whether the given query point has used its budget of base cases.
+  bool BudgetExhausted(const size_t queryIndex) const
+  {
+    return (maxBaseCases != 0) && (queryBaseCases[queryIndex] >= maxBaseCases);
+  }
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
@@ -23,7 +23,10 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     const typename TreeType::Mat& referenceSet,
     const typename TreeType::Mat& querySet,
     const size_t k,
-    KernelType& kernel) :
+    KernelType& kernel,
+    const bool cacheKernels,
+    const double epsilon,
+    const size_t maxBaseCases) :
     referenceSet(referenceSet),
     querySet(querySet),
     k(k),
@@ -31,6 +34,9 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
+    cacheKernels(cacheKernels),
+    epsilon(epsilon),
+    maxBaseCases(maxBaseCases),
     baseCases(0),
     scores(0)
 {
@@ -40,11 +46,6 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
                                            querySet.col(i)));
 
-  referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
-                                               referenceSet.col(i)));
-
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
@@ -62,6 +63,9 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     pqueue.push(def);
   std::vector<CandidateList> tmp(querySet.n_cols, pqueue);
   candidates.swap(tmp);
+
+  if (maxBaseCases != 0)
+    queryBaseCases.resize(querySet.n_cols, 0);
 }
 
 template<typename KernelType, typename TreeType>
@@ -73,14 +77,21 @@ void FastMKSRules<KernelType, TreeType>::GetResults(
   products.set_size(k, querySet.n_cols);
 
   for (size_t i = 0; i < querySet.n_cols; i++)
+    GetResults(i, indices, products);
+}
+
+template<typename KernelType, typename TreeType>
+void FastMKSRules<KernelType, TreeType>::GetResults(
+    const size_t queryIndex,
+    arma::Mat<size_t>& indices,
+    arma::mat& products)
+{
+  CandidateList& pqueue = candidates[queryIndex];
+  for (size_t j = 1; j <= k; j++)
   {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
-    {
-      indices(k - j, i) = pqueue.top().second;
-      products(k - j, i) = pqueue.top().first;
-      pqueue.pop();
-    }
+    indices(k - j, queryIndex) = pqueue.top().second;
+    products(k - j, queryIndex) = pqueue.top().first;
+    pqueue.pop();
   }
 }
 
@@ -106,6 +117,8 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
   }
 
   ++baseCases;
+  if (maxBaseCases != 0)
+    ++queryBaseCases[queryIndex];
   double kernelEval = kernel.Evaluate(querySet.col(queryIndex),
                                       referenceSet.col(referenceIndex));
 
@@ -128,12 +141,17 @@ template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
 {
-  // Compare with the current best.
-  const double bestKernel = candidates[queryIndex].top().first;
+  // Stop recursing once the budget of base cases of the point is used.
+  if (BudgetExhausted(queryIndex))
+    return DBL_MAX;
 
-  // See if we can perform a parent-child prune.
+  // Compare with the current best, relaxed for approximate search.
+  const double bestKernel = Relax(candidates[queryIndex].top().first);
+
+  // See if we can perform a parent-child prune.  This needs the kernel
+  // evaluation of the parent, which is only stored if cacheKernels is true.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
-  if (referenceNode.Parent() != NULL)
+  if (cacheKernels && referenceNode.Parent() != NULL)
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
@@ -175,7 +193,17 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      // The point was already added as a candidate when the parent was
+      // scored, so it must not be given to BaseCase() again.
+      if (cacheKernels)
+      {
+        kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      }
+      else
+      {
+        kernelEval = kernel.Evaluate(querySet.col(queryIndex),
+            referenceSet.col(referenceNode.Point(0)));
+      }
     }
     else
     {
@@ -190,7 +218,8 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  if (cacheKernels)
+    referenceNode.Stat().LastKernel() = kernelEval;
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -222,9 +251,18 @@ template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
                                                  TreeType& referenceNode)
 {
+  // Precompute each reference self-kernel, if it has not been done yet.
+  if (referenceKernels.n_elem != referenceSet.n_cols)
+  {
+    referenceKernels.set_size(referenceSet.n_cols);
+    for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
+                                                 referenceSet.col(i)));
+  }
+
   // Update and get the query node's bound.
   queryNode.Stat().Bound() = CalculateBound(queryNode);
-  const double bestKernel = queryNode.Stat().Bound();
+  const double bestKernel = Relax(queryNode.Stat().Bound());
 
   // First, see if we can make a parent-child or parent-parent prune.  These
   // four bounds on the maximum kernel value are looser than the bound normally
@@ -412,7 +450,10 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
                                                    TreeType& /*referenceNode*/,
                                                    const double oldScore) const
 {
-  const double bestKernel = candidates[queryIndex].top().first;
+  if (BudgetExhausted(queryIndex))
+    return DBL_MAX;
+
+  const double bestKernel = Relax(candidates[queryIndex].top().first);
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
@@ -423,7 +464,7 @@ double FastMKSRules<KernelType, TreeType>::Rescore(TreeType& queryNode,
                                                    const double oldScore) const
 {
   queryNode.Stat().Bound() = CalculateBound(queryNode);
-  const double bestKernel = queryNode.Stat().Bound();
+  const double bestKernel = Relax(queryNode.Stat().Bound());
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
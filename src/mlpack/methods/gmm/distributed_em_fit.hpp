@@ -0,0 +1,182 @@
+/**
+ * @file distributed_em_fit.hpp
+ *
+ * The EM algorithm for Gaussian mixture models over a dataset that is
+ * partitioned between processes, which combine their statistics with
+ * all-reduces at each iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/math/single_process_all_reduce.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+// Default E-step.
+#include "naive_e_step.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * DistributedEMFit fits a Gaussian mixture model with the EM algorithm, like
+ * EMFit, to a dataset that is partitioned between processes (or ranks): each
+ * process calls Estimate() with its own partition and the same initial model.
+ * At each iteration, each process runs the E-step policy on its partition,
+ * which gives the responsibility-weighted count, mean and covariance of each
+ * Gaussian on the partition; two all-reduces combine them into those of the
+ * whole dataset.  The first sums the counts, the weighted sums of the points
+ * and the log-likelihood; the second sums the weighted scatter matrices around
+ * the global means, which is more accurate than combining raw second moments.
+ * Every process then runs the same M-step, with the covariance constraint
+ * policy, and gets the same model.
+ *
+ * The initial model is not computed here, since it must be the same on every
+ * process; it can, for instance, be fit by EMFit on a sample of the data by
+ * one process, and sent to the others.
+ *
+ * @tparam AllReduceType Policy which sums vectors over the processes (see
+ *     math::SingleProcessAllReduce).
+ * @tparam CovarianceConstraintPolicy Constraint on the covariances.
+ * @tparam EStepType Policy which computes the statistics of each E-step on the
+ *     partition (see NaiveEStep).
+ */
+template<typename AllReduceType = math::SingleProcessAllReduce,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename EStepType = NaiveEStep>
+class DistributedEMFit
+{
+ public:
+  /**
+   * Construct the DistributedEMFit object.  Setting the maximum number of
+   * iterations to 0 means that the EM algorithm will iterate until convergence
+   * (with the given tolerance).
+   *
+   * @param maxIterations Maximum number of iterations for EM.
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param allReduce Instantiated all-reduce policy.
+   * @param constraint Object which applies constraints to the covariances.
+   * @param eStep Object which will perform the E-steps.
+   */
+  DistributedEMFit(const size_t maxIterations = 300,
+                   const double tolerance = 1e-10,
+                   AllReduceType allReduce = AllReduceType(),
+                   CovarianceConstraintPolicy constraint =
+                       CovarianceConstraintPolicy(),
+                   EStepType eStep = EStepType());
+
+  /**
+   * Fit the model to the partition of the observations of this process,
+   * starting from the given model, which must be the same on every process.
+   * Every process must call Estimate() at the same time, and every process
+   * gets the same model.
+   *
+   * @param localObservations Partition of the observations of this process.
+   * @param dists Initial distributions, which are replaced by the final ones.
+   * @param weights Initial a priori weights, which are replaced by the final
+   *      ones.
+   */
+  void Estimate(const arma::mat& localObservations,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  /**
+   * Fit the model to the partition of the observations of this process, as
+   * above, taking into account the probability of each observation being from
+   * this mixture.
+   *
+   * @param localObservations Partition of the observations of this process.
+   * @param localProbabilities Probability of each observation of the
+   *      partition being from this model.
+   * @param dists Initial distributions, which are replaced by the final ones.
+   * @param weights Initial a priori weights, which are replaced by the final
+   *      ones.
+   */
+  void Estimate(const arma::mat& localObservations,
+                const arma::vec& localProbabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  //! Get the all-reduce policy.
+  const AllReduceType& AllReduce() const { return allReduce; }
+  //! Modify the all-reduce policy.
+  AllReduceType& AllReduce() { return allReduce; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the E-step policy class.
+  const EStepType& EStep() const { return eStep; }
+  //! Modify the E-step policy class.
+  EStepType& EStep() { return eStep; }
+
+  //! Get the maximum number of iterations of the EM algorithm.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of the EM algorithm.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of the EM algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of the EM algorithm.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  /**
+   * Run the EM iterations, starting from the given model, using the E-step
+   * object that has already been initialized with the local observations.
+   *
+   * @param dists Vector of distributions to update.
+   * @param weights Vector of a priori weights to update.
+   * @param localWeight Sum of the probabilities of the local observations.
+   */
+  void Iterate(std::vector<distribution::GaussianDistribution>& dists,
+               arma::vec& weights,
+               const double localWeight);
+
+  /**
+   * Compute the statistics of the E-step on the whole dataset: the count,
+   * weighted mean and weighted covariance of each Gaussian, and return the
+   * log-likelihood of the whole dataset.
+   *
+   * @param dists Current distributions.
+   * @param weights Current a priori weights.
+   * @param counts Vector to store the count of each Gaussian in.
+   * @param means Vector to store the mean of each Gaussian in (only set if its
+   *      count is not zero).
+   * @param covariances Vector to store the covariance of each Gaussian in
+   *      (only set if its count is not zero).
+   */
+  double Statistics(
+      const std::vector<distribution::GaussianDistribution>& dists,
+      const arma::vec& weights,
+      arma::vec& counts,
+      std::vector<arma::vec>& means,
+      std::vector<arma::mat>& covariances);
+
+  //! Maximum iterations of EM algorithm.
+  size_t maxIterations;
+  //! Tolerance for convergence of EM.
+  double tolerance;
+  //! Object which sums the statistics over the processes.
+  AllReduceType allReduce;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+  //! Object which performs the E-steps.
+  EStepType eStep;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_em_fit_impl.hpp"
+
+#endif
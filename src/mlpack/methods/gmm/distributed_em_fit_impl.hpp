@@ -0,0 +1,198 @@
+/**
+ * @file distributed_em_fit_impl.hpp
+ *
+ * Implementation of the EM algorithm for Gaussian mixture models over a
+ * dataset that is partitioned between processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_DISTRIBUTED_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+template<typename AllReduceType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+DistributedEMFit<AllReduceType, CovarianceConstraintPolicy, EStepType>::
+DistributedEMFit(const size_t maxIterations,
+                 const double tolerance,
+                 AllReduceType allReduce,
+                 CovarianceConstraintPolicy constraint,
+                 EStepType eStep) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    allReduce(allReduce),
+    constraint(constraint),
+    eStep(eStep)
+{ /* Nothing to do. */ }
+
+template<typename AllReduceType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void DistributedEMFit<AllReduceType, CovarianceConstraintPolicy, EStepType>::
+Estimate(const arma::mat& localObservations,
+         std::vector<distribution::GaussianDistribution>& dists,
+         arma::vec& weights)
+{
+  eStep.Initialize(localObservations);
+  Iterate(dists, weights, localObservations.n_cols);
+}
+
+template<typename AllReduceType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void DistributedEMFit<AllReduceType, CovarianceConstraintPolicy, EStepType>::
+Estimate(const arma::mat& localObservations,
+         const arma::vec& localProbabilities,
+         std::vector<distribution::GaussianDistribution>& dists,
+         arma::vec& weights)
+{
+  eStep.Initialize(localObservations, localProbabilities);
+  Iterate(dists, weights, arma::accu(localProbabilities));
+}
+
+template<typename AllReduceType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void DistributedEMFit<AllReduceType, CovarianceConstraintPolicy, EStepType>::
+Iterate(std::vector<distribution::GaussianDistribution>& dists,
+        arma::vec& weights,
+        const double localWeight)
+{
+  if (dists.size() == 0 || weights.n_elem != dists.size())
+  {
+    std::ostringstream oss;
+    oss << "DistributedEMFit::Estimate(): " << dists.size() << " Gaussians "
+        << "and " << weights.n_elem << " weights given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::vec totalWeight(1);
+  totalWeight[0] = localWeight;
+  allReduce.Sum(totalWeight);
+
+  arma::vec counts;
+  std::vector<arma::vec> means;
+  std::vector<arma::mat> covariances;
+  double l = Statistics(dists, weights, counts, means, covariances);
+
+  MLPACK_LOG_DEBUG << "DistributedEMFit::Estimate(): initial log-likelihood: "
+      << l << std::endl;
+
+  double lOld = -DBL_MAX;
+
+  // Every process computes the same log-likelihood, so all the processes run
+  // the same number of iterations.
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
+  {
+    MLPACK_LOG_INFO << "DistributedEMFit::Estimate(): iteration " << iteration
+        << ", log-likelihood " << l << "." << std::endl;
+
+    // The M-step, as in EMFit.  Don't update a Gaussian if there's no
+    // probability of it having points.
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      if (counts[i] == 0.0)
+        continue;
+
+      dists[i].Mean() = std::move(means[i]);
+      constraint.ApplyConstraint(covariances[i]);
+      dists[i].Covariance(std::move(covariances[i]));
+    }
+
+    weights = counts / totalWeight[0];
+
+    lOld = l;
+    l = Statistics(dists, weights, counts, means, covariances);
+
+    iteration++;
+  }
+}
+
+template<typename AllReduceType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+double DistributedEMFit<AllReduceType, CovarianceConstraintPolicy, EStepType>::
+Statistics(const std::vector<distribution::GaussianDistribution>& dists,
+           const arma::vec& weights,
+           arma::vec& counts,
+           std::vector<arma::vec>& means,
+           std::vector<arma::mat>& covariances)
+{
+  arma::vec localCounts;
+  std::vector<arma::vec> localMeans;
+  std::vector<arma::mat> localCovariances;
+  const double localLogLikelihood = eStep.Statistics(dists, weights,
+      localCounts, localMeans, localCovariances);
+
+  const size_t gaussians = dists.size();
+  const size_t dims = dists[0].Mean().n_elem;
+
+  // First, sum the counts, the weighted sums of the points and the
+  // log-likelihoods.
+  arma::vec sums(gaussians * (dims + 1) + 1, arma::fill::zeros);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    sums[i] = localCounts[i];
+    if (localCounts[i] != 0.0)
+    {
+      sums.subvec(gaussians + i * dims, gaussians + (i + 1) * dims - 1) =
+          localCounts[i] * localMeans[i];
+    }
+  }
+  sums[gaussians * (dims + 1)] = localLogLikelihood;
+  allReduce.Sum(sums);
+
+  counts = sums.subvec(0, gaussians - 1);
+  means.resize(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    if (counts[i] != 0.0)
+    {
+      means[i] = sums.subvec(gaussians + i * dims,
+          gaussians + (i + 1) * dims - 1) / counts[i];
+    }
+  }
+
+  // Then sum the weighted scatter matrices around the global means; the
+  // scatter of a partition around the global mean is its covariance around its
+  // own mean, plus the shift between the two means.
+  arma::vec scatters(gaussians * dims * dims, arma::fill::zeros);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    if (localCounts[i] == 0.0)
+      continue;
+
+    arma::mat scatter(scatters.memptr() + i * dims * dims, dims, dims, false,
+        true);
+    const arma::vec shift = localMeans[i] - means[i];
+    scatter = localCounts[i] * (localCovariances[i] + shift * shift.t());
+  }
+  allReduce.Sum(scatters);
+
+  covariances.resize(gaussians);
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    if (counts[i] != 0.0)
+    {
+      covariances[i] = arma::mat(scatters.memptr() + i * dims * dims, dims,
+          dims) / counts[i];
+    }
+  }
+
+  return sums[gaussians * (dims + 1)];
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
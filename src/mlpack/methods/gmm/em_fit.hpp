@@ -21,6 +21,8 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 // Default covariance matrix constraint.
 #include "positive_definite_constraint.hpp"
+// Default E-step.
+#include "naive_e_step.hpp"
 
 namespace mlpack {
 namespace gmm {
@@ -37,9 +39,32 @@ namespace gmm {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The E-step of each iteration is performed by the EStepType class, which by
+ * default (NaiveEStep) evaluates every point against every Gaussian.
+ * KDTreeEStep is a faster, approximate alternative for diagonal covariances.
+ * The EStepType class must implement the following methods:
+ *
+ *  - void Initialize(const arma::mat& observations);
+ *  - void Initialize(const arma::mat& observations,
+ *                    const arma::vec& probabilities);
+ *  - double Statistics(
+ *        const std::vector<distribution::GaussianDistribution>& dists,
+ *        const arma::vec& weights,
+ *        arma::vec& counts,
+ *        std::vector<arma::vec>& means,
+ *        std::vector<arma::mat>& covariances);
+ *
+ * Initialize() is called once before the iterations, with the observations
+ * (and their probabilities, if given) that will be used by every call to
+ * Statistics().  Statistics() returns the log-likelihood of the given model,
+ * and computes for each Gaussian the sum of the (weighted) conditional
+ * probabilities of the observations, and the mean and covariance of the
+ * observations weighted by those probabilities.
  */
 template<typename InitialClusteringType = kmeans::KMeans<>,
-         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename EStepType = NaiveEStep>
 class EMFit
 {
  public:
@@ -59,11 +84,14 @@ class EMFit
    * @param forcePositive Check for positive-definiteness of each covariance
    *     matrix at each iteration.
    * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Object which applies constraints to the covariances.
+   * @param eStep Object which will perform the E-steps.
    */
   EMFit(const size_t maxIterations = 300,
         const double tolerance = 1e-10,
         InitialClusteringType clusterer = InitialClusteringType(),
-        CovarianceConstraintPolicy constraint = CovarianceConstraintPolicy());
+        CovarianceConstraintPolicy constraint = CovarianceConstraintPolicy(),
+        EStepType eStep = EStepType());
 
   /**
    * Fit the observations to a Gaussian mixture model (GMM) using the EM
@@ -118,6 +146,11 @@ class EMFit
   //! Modify the covariance constraint policy class.
   CovarianceConstraintPolicy& Constraint() { return constraint; }
 
+  //! Get the E-step policy class.
+  const EStepType& EStep() const { return eStep; }
+  //! Modify the E-step policy class.
+  EStepType& EStep() { return eStep; }
+
   //! Get the maximum number of iterations of the EM algorithm.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the maximum number of iterations of the EM algorithm.
@@ -148,19 +181,32 @@ class EMFit
                          arma::vec& weights);
 
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
-   * to determine if the EM algorithm has converged.
+   * Run the EM iterations, starting from the given model, using the E-step
+   * object that has already been initialized with the observations.  This is a
+   * helper function for both overloads of Estimate().
+   *
+   * @param dists Vector of distributions to update.
+   * @param weights Vector of a priori weights to update.
+   * @param totalWeight Sum of the probabilities of the observations.
+   */
+  void Iterate(std::vector<distribution::GaussianDistribution>& dists,
+               arma::vec& weights,
+               const double totalWeight);
+
+  /**
+   * Set the new means and covariances of the Gaussians (the M-step), applying
+   * the covariance constraint, in parallel over the Gaussians.  Gaussians with
+   * no probability of having points are not updated.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param covariances Vector of covariance matrices.
-   * @param weights Vector of a priori weights.
+   * @param counts Sum of the conditional probabilities of each Gaussian.
+   * @param means New mean of each Gaussian.
+   * @param covariances New covariance of each Gaussian.
+   * @param dists Vector of distributions to update.
    */
-  double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
-                       const arma::vec& weights) const;
+  void MaximizationStep(const arma::vec& counts,
+                        std::vector<arma::vec>& means,
+                        std::vector<arma::mat>& covariances,
+                        std::vector<distribution::GaussianDistribution>& dists);
 
   // Armadillo uses uword internally as an OpenMP index type, which crashes
   // Visual Studio.
@@ -190,6 +236,8 @@ class EMFit
   InitialClusteringType clusterer;
   //! Object which applies constraints to the covariance matrix.
   CovarianceConstraintPolicy constraint;
+  //! Object which performs the E-steps.
+  EStepType eStep;
 };
 
 } // namespace gmm
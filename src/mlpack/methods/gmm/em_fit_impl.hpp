@@ -21,30 +21,37 @@ namespace mlpack {
 namespace gmm {
 
 //! Constructor.
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::EMFit(
     const size_t maxIterations,
     const double tolerance,
     InitialClusteringType clusterer,
-    CovarianceConstraintPolicy constraint) :
+    CovarianceConstraintPolicy constraint,
+    EStepType eStep) :
     maxIterations(maxIterations),
     tolerance(tolerance),
     clusterer(clusterer),
-    constraint(constraint)
+    constraint(constraint),
+    eStep(eStep)
 { /* Nothing to do. */ }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
-    const arma::mat& observations,
-    std::vector<distribution::GaussianDistribution>& dists,
-    arma::vec& weights,
-    const bool useInitialModel)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
+Estimate(const arma::mat& observations,
+         std::vector<distribution::GaussianDistribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
 {
   // Shortcut: if the user is using the DiagonalConstraint, then we will call
   // out to Armadillo.  But Armadillo uses uword internally as an OpenMP index
   // type, which crashes Visual Studio, so don't do this on Windows.
   #ifndef _WIN32
-  if (std::is_same<CovarianceConstraintPolicy, DiagonalConstraint>::value)
+  if (std::is_same<CovarianceConstraintPolicy, DiagonalConstraint>::value &&
+      std::is_same<EStepType, NaiveEStep>::value)
   {
     ArmadilloGMMWrapper(observations, dists, weights, useInitialModel);
     return;
@@ -55,172 +62,74 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
-
-  Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
-      << l << std::endl;
-
-  double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
-
-  // Iterate to update the model until no more improvement is found.
-  size_t iteration = 1;
-  while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
-  {
-    Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
-        << "log-likelihood " << l << "." << std::endl;
-
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = probRowSums / observations.n_cols;
-
-    // Update values of l; calculate new log-likelihood.
-    lOld = l;
-    l = LogLikelihood(observations, dists, weights);
-
-    iteration++;
-  }
+  eStep.Initialize(observations);
+  Iterate(dists, weights, observations.n_cols);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
-    const arma::mat& observations,
-    const arma::vec& probabilities,
-    std::vector<distribution::GaussianDistribution>& dists,
-    arma::vec& weights,
-    const bool useInitialModel)
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
+Estimate(const arma::mat& observations,
+         const arma::vec& probabilities,
+         std::vector<distribution::GaussianDistribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
 {
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  eStep.Initialize(observations, probabilities);
+  Iterate(dists, weights, accu(probabilities));
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
+Iterate(std::vector<distribution::GaussianDistribution>& dists,
+        arma::vec& weights,
+        const double totalWeight)
+{
+  arma::vec counts;
+  std::vector<arma::vec> means;
+  std::vector<arma::mat> covariances;
+  double l = eStep.Statistics(dists, weights, counts, means, covariances);
 
-  Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
+  MLPACK_LOG_DEBUG << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
-
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
+    MLPACK_LOG_INFO << "EMFit::Estimate(): iteration " << iteration << ", "
+        << "log-likelihood " << l << "." << std::endl;
 
-      dists[i].Covariance(std::move(cov));
-    }
+    // Calculate the new values of the means and covariances using the
+    // statistics of the conditional probabilities of choosing a particular
+    // Gaussian given the observations and the present theta value.
+    MaximizationStep(counts, means, covariances, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
-    weights = probRowSums / accu(probabilities);
+    weights = counts / totalWeight;
 
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the statistics for
+    // the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = eStep.Statistics(dists, weights, counts, means, covariances);
 
     iteration++;
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
 InitialClustering(const arma::mat& observations,
                   std::vector<distribution::GaussianDistribution>& dists,
                   arma::vec& weights)
@@ -286,51 +195,65 @@ InitialClustering(const arma::mat& observations,
   weights /= accu(weights);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
-    const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
+MaximizationStep(const arma::vec& counts,
+                 std::vector<arma::vec>& means,
+                 std::vector<arma::mat>& covariances,
+                 std::vector<distribution::GaussianDistribution>& dists)
 {
-  double logLikelihood = 0;
+  // Exceptions can't leave an OpenMP region, so keep them until the end.
+  std::vector<std::exception_ptr> exceptions(dists.size());
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
-
-  for (size_t i = 0; i < dists.size(); ++i)
-  {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
-  }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    // Don't update if there's no probability of the Gaussian having points.
+    if (counts[i] == 0.0)
+      continue;
+
+    try
+    {
+      dists[i].Mean() = std::move(means[i]);
+
+      // Apply covariance constraint.
+      constraint.ApplyConstraint(covariances[i]);
+      dists[i].Covariance(std::move(covariances[i]));
+    }
+    catch (...)
+    {
+      exceptions[i] = std::current_exception();
+    }
   }
 
-  return logLikelihood;
+  for (size_t i = 0; i < exceptions.size(); ++i)
+    if (exceptions[i])
+      std::rethrow_exception(exceptions[i]);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
 template<typename Archive>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
-    Archive& ar,
-    const unsigned int /* version */)
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
+serialize(Archive& ar, const unsigned int /* version */)
 {
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
   ar & BOOST_SERIALIZATION_NVP(tolerance);
   ar & BOOST_SERIALIZATION_NVP(clusterer);
   ar & BOOST_SERIALIZATION_NVP(constraint);
+  ar & BOOST_SERIALIZATION_NVP(eStep);
 }
 
 // Armadillo uses uword internally as an OpenMP index type, which crashes Visual
 // Studio.
 #ifndef _WIN32
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
 ArmadilloGMMWrapper(const arma::mat& observations,
                     std::vector<distribution::GaussianDistribution>& dists,
                     arma::vec& weights,
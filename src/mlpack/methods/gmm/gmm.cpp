@@ -39,7 +39,8 @@ GMM::GMM(const GMM& other) :
     gaussians(other.Gaussians()),
     dimensionality(other.dimensionality),
     dists(other.dists),
-    weights(other.weights) { /* Nothing to do. */ }
+    weights(other.weights),
+    updater(other.updater) { /* Nothing to do. */ }
 
 GMM& GMM::operator=(const GMM& other)
 {
@@ -47,6 +48,7 @@ GMM& GMM::operator=(const GMM& other)
   dimensionality = other.dimensionality;
   dists = other.dists;
   weights = other.weights;
+  updater = other.updater;
 
   return *this;
 }
@@ -66,6 +68,79 @@ double GMM::LogProbability(const arma::vec& observation) const
   return sum;
 }
 
+/**
+ * Return the log probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  // Calculate log(w_i) + log(p_i(x)) for each Gaussian, all observations at
+  // once.
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, logProbs);
+
+  // Sum over the Gaussians with the log-sum-exp trick.
+  logProbabilities.set_size(observations.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) observations.n_cols; j++)
+  {
+    const double maxLogProb = logProbs.col(j).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+      logProbabilities[j] = maxLogProb;
+    else
+      logProbabilities[j] = maxLogProb +
+          std::log(arma::accu(arma::exp(logProbs.col(j) - maxLogProb)));
+  }
+}
+
+/**
+ * Return the probability of each of the given observations being from this
+ * GMM.
+ */
+void GMM::Probability(const arma::mat& observations,
+                      arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Return the log probability of each of the given observations being from each
+ * component of this GMM.
+ */
+void GMM::ComponentLogProbabilities(const arma::mat& observations,
+                                    arma::mat& logProbabilities) const
+{
+  logProbabilities.set_size(gaussians, observations.n_cols);
+  const arma::vec logWeights = arma::log(weights);
+
+  // Each block of observations is evaluated for every component while it is in
+  // cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) observations.n_cols,
+        begin + blockSize);
+
+    // Alias the block, instead of copying it.
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, end - begin, false, true);
+
+    arma::vec componentLogProbs;
+    for (size_t i = 0; i < gaussians; i++)
+    {
+      dists[i].LogProbability(block, componentLogProbs);
+      logProbabilities.submat(i, begin, i, end - 1) = logWeights[i] +
+          componentLogProbs.t();
+    }
+  }
+}
+
 /**
  * Return the probability of the given observation being from this GMM.
  */
@@ -121,6 +196,48 @@ arma::vec GMM::Random() const
       arma::randn<arma::vec>(dimensionality) + dists[gaussian].Mean();
 }
 
+/**
+ * Update the model with a batch of observations, with one step of stochastic
+ * EM.
+ */
+double GMM::Update(const arma::mat& batch, const bool useExistingModel)
+{
+  if (batch.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "GMM::Update(): the dimensionality of the batch (" << batch.n_rows
+        << ") does not match the model (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (updater.Steps() == 0 && !useExistingModel)
+    updater.Initialize(batch, dists, weights);
+
+  return updater.Update(batch, dists, weights);
+}
+
+/**
+ * Update the model with a batch of observations, each of which has a certain
+ * probability of being from this distribution.
+ */
+double GMM::Update(const arma::mat& batch,
+                   const arma::vec& probabilities,
+                   const bool useExistingModel)
+{
+  if (batch.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "GMM::Update(): the dimensionality of the batch (" << batch.n_rows
+        << ") does not match the model (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (updater.Steps() == 0 && !useExistingModel)
+    updater.Initialize(batch, dists, weights);
+
+  return updater.Update(batch, probabilities, dists, weights);
+}
+
 /**
  * Classify the given observations as being from an individual component in this
  * GMM.
@@ -128,21 +245,22 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
+  arma::mat logProbs;
+  ComponentLogProbabilities(observations, logProbs);
 
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
+  // Find the maximum probability component of each observation; ties go to the
+  // last component.
   labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) observations.n_cols; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
+    double logProbability = -std::numeric_limits<double>::infinity();
+    labels[i] = gaussians - 1;
     for (size_t j = 0; j < gaussians; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs(j, i) >= logProbability)
       {
-        probability = newProb;
+        logProbability = logProbs(j, i);
         labels[i] = j;
       }
     }
@@ -17,6 +17,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// This is the fitting method of Update().
+#include "stochastic_em_fit.hpp"
 
 namespace mlpack {
 namespace gmm /** Gaussian Mixture Models. */ {
@@ -51,7 +53,8 @@ namespace gmm /** Gaussian Mixture Models. */ {
  *
  * For a sample implementation, see the EMFit class; this class uses the EM
  * algorithm to train a GMM, and is the default fitting type for the Train()
- * method.
+ * method.  StochasticEMFit trains in mini-batches, which is faster on large
+ * datasets, and is also used by Update() to fit the GMM one batch at a time.
  *
  * The GMM, once trained, can be used to generate random points from the
  * distribution and estimate the probability of points being from the
@@ -89,6 +92,9 @@ class GMM
   //! Vector of a priori weights for each Gaussian.
   arma::vec weights;
 
+  //! The stochastic EM fitter used by Update(), with its running statistics.
+  StochasticEMFit<> updater;
+
  public:
   /**
    * Create an empty Gaussian Mixture Model, with zero gaussians.
@@ -172,6 +178,40 @@ class GMM
    */
   double LogProbability(const arma::vec& observation) const;
 
+  /**
+   * Calculate the log probability of each of the given observations being from
+   * this distribution.
+   *
+   * @param observations List of observations (one per column).
+   * @param logProbabilities Output log probabilities for each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
+  /**
+   * Calculate the probability of each of the given observations being from
+   * this distribution.
+   *
+   * @param observations List of observations (one per column).
+   * @param probabilities Output probabilities for each observation.
+   */
+  void Probability(const arma::mat& observations,
+                   arma::vec& probabilities) const;
+
+  /**
+   * Calculate the log probability of each of the given observations being from
+   * each Gaussian component, including the weight of the component; that is,
+   * element (i, j) of the result is log(w_i) + log(p_i(x_j)).  All the
+   * components are evaluated on a block of observations before moving to the
+   * next block, so that the data is read from memory once.
+   *
+   * @param observations List of observations (one per column).
+   * @param logProbabilities Output log probabilities, with one row for each
+   *     component and one column for each observation.
+   */
+  void ComponentLogProbabilities(const arma::mat& observations,
+                                 arma::mat& logProbabilities) const;
+
   /**
    * Return the probability that the given observation came from the given
    * Gaussian component in this distribution.
@@ -258,6 +298,51 @@ class GMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with a batch of observations, with one step of stochastic
+   * EM (see StochasticEMFit), so that the model can be fit to a stream of
+   * observations, or to a dataset too large to be held in memory, one batch at
+   * a time.  The running statistics of the stochastic EM are kept between
+   * calls, and are forgotten by Train().
+   *
+   * On the first update since the GMM was created or trained, the initial
+   * model is given by k-means on the batch, unless useExistingModel is true;
+   * set it to refine a model given by Train() or set by hand.
+   *
+   * @code
+   * GMM g(5, 4);
+   * while (stream.Next(batch))
+   *   g.Update(batch);
+   * @endcode
+   *
+   * @param batch Batch of observations.
+   * @param useExistingModel If true, the first update starts from the existing
+   *     model.
+   * @return The log-likelihood of the batch before the update.
+   */
+  double Update(const arma::mat& batch, const bool useExistingModel = false);
+
+  /**
+   * Update the model with a batch of observations, as above, taking into
+   * account the probability of each observation being from this distribution.
+   *
+   * @param batch Batch of observations.
+   * @param probabilities Probability of each observation of the batch being
+   *     from this distribution.
+   * @param useExistingModel If true, the first update starts from the existing
+   *     model.
+   * @return The log-likelihood of the batch before the update.
+   */
+  double Update(const arma::mat& batch,
+                const arma::vec& probabilities,
+                const bool useExistingModel = false);
+
+  //! Get the stochastic EM fitter used by Update().
+  const StochasticEMFit<>& Updater() const { return updater; }
+  //! Modify the stochastic EM fitter used by Update() (for instance, to set
+  //! its step size).
+  StochasticEMFit<>& Updater() { return updater; }
+
   /**
    * Classify the given observations as being from an individual component in
    * this GMM.  The resultant classifications are stored in the 'labels' object,
@@ -281,7 +366,7 @@ class GMM
    * Serialize the GMM.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   /**
@@ -302,6 +387,9 @@ class GMM
 } // namespace gmm
 } // namespace mlpack
 
+//! Set the serialization version of the GMM class.
+BOOST_CLASS_VERSION(mlpack::gmm::GMM, 1);
+
 // Include implementation.
 #include "gmm_impl.hpp"
 
@@ -31,6 +31,9 @@ double GMM::Train(const arma::mat& observations,
 {
   double bestLikelihood; // This will be reported later.
 
+  // The running statistics of Update() don't belong to the new model.
+  updater.Reset();
+
   // We don't need to store temporary models if we are only doing one trial.
   if (trials == 1)
   {
@@ -114,6 +117,9 @@ double GMM::Train(const arma::mat& observations,
 {
   double bestLikelihood; // This will be reported later.
 
+  // The running statistics of Update() don't belong to the new model.
+  updater.Reset();
+
   // We don't need to store temporary models if we are only doing one trial.
   if (trials == 1)
   {
@@ -191,7 +197,7 @@ double GMM::Train(const arma::mat& observations,
  * Serialize the object.
  */
 template<typename Archive>
-void GMM::serialize(Archive& ar, const unsigned int /* version */)
+void GMM::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(gaussians);
   ar & BOOST_SERIALIZATION_NVP(dimensionality);
@@ -205,6 +211,12 @@ void GMM::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(dists);
 
   ar & BOOST_SERIALIZATION_NVP(weights);
+
+  // Models saved before Update() existed have no stochastic EM fitter.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(updater);
+  else if (Archive::is_loading::value)
+    updater = StochasticEMFit<>();
 }
 
 } // namespace gmm
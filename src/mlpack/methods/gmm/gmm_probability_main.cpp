@@ -12,6 +12,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
+#include <mlpack/core/data/for_each_batch.hpp>
 #include "gmm.hpp"
 
 using namespace std;
@@ -38,7 +40,14 @@ PROGRAM_INFO("GMM Probability Calculator",
     PRINT_DATASET("probs") + ", the following command could be used:"
     "\n\n" +
     PRINT_CALL("gmm_probability", "input_model", "gmm", "input", "points",
-        "output", "probs"),
+        "output", "probs") +
+    "\n\n"
+    "Datasets too large to be held in memory can be given with " +
+    PRINT_PARAM_STRING("input_file") + " instead; the file (.mmat, .csv, .txt, "
+    "or .tsv) is then read " + PRINT_PARAM_STRING("batch_size") + " points at "
+    "a time, and the probabilities of each batch are written to the file given "
+    "with " + PRINT_PARAM_STRING("output_file") + " before the next batch is "
+    "read.",
     SEE_ALSO("@gmm_train", "#gmm_train"),
     SEE_ALSO("@gmm_generate", "#gmm_generate"),
     SEE_ALSO("Gaussian Mixture Models on Wikipedia",
@@ -47,25 +56,73 @@ PROGRAM_INFO("GMM Probability Calculator",
         "@doxygen/classmlpack_1_1gmm_1_1GMM.html"));
 
 PARAM_MODEL_IN_REQ(GMM, "input_model", "Input GMM to use as model.", "m");
-PARAM_MATRIX_IN_REQ("input", "Input matrix to calculate probabilities of.",
-    "i");
+PARAM_MATRIX_IN("input", "Input matrix to calculate probabilities of.", "i");
 
 PARAM_MATRIX_OUT("output", "Matrix to store calculated probabilities in.", "o");
 
+// Instead, the points may be read from a file a batch at a time, and the
+// probabilities of each batch written before the next batch is read.
+PARAM_STRING_IN("input_file", "File holding points to calculate the "
+    "probabilities of in batches, without loading them into memory (instead "
+    "of --input).", "I", "");
+PARAM_STRING_IN("output_file", "File to write the probabilities of the points "
+    "of --input_file to, a batch at a time.", "O", "");
+PARAM_INT_IN("batch_size", "Number of points read from --input_file at a "
+    "time.", "b", 100000);
+
 static void mlpackMain()
 {
-  RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
+  // The points can be given either way.
+  RequireOnlyOnePassed({ "input", "input_file" }, true);
+  ReportIgnoredParam({{ "input_file", false }}, "output_file");
+  ReportIgnoredParam({{ "input_file", false }}, "batch_size");
+  ReportIgnoredParam({{ "input_file", true }}, "output");
+  RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+      "batch size must be positive");
 
-  // Get the GMM and the points.
+  // Get the GMM.
   GMM* gmm = CLI::GetParam<GMM*>("input_model");
 
+  if (CLI::HasParam("input_file"))
+  {
+    RequireAtLeastOnePassed({ "output_file" }, false,
+        "no results will be saved");
+
+    // Calculate the probabilities a batch at a time, and write the
+    // probabilities of each batch before the next one is read.
+    const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+    data::BatchReader reader(CLI::GetParam<string>("input_file"));
+
+    std::unique_ptr<data::BatchWriter> writer;
+    if (CLI::HasParam("output_file"))
+    {
+      writer.reset(new data::BatchWriter(
+          CLI::GetParam<string>("output_file"), 1));
+    }
+
+    arma::vec probabilities;
+    data::ForEachBatch(reader, batchSize,
+        [&](const arma::mat& batch, const size_t /* offset */)
+        {
+          gmm->Probability(batch, probabilities);
+          if (writer)
+            writer->Write(arma::mat(probabilities.t()));
+        });
+
+    if (writer)
+      writer->Close();
+
+    return;
+  }
+
+  RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
+
   arma::mat dataset = std::move(CLI::GetParam<arma::mat>("input"));
 
-  // Now calculate the probabilities.
-  arma::rowvec probabilities(dataset.n_cols);
-  for (size_t i = 0; i < dataset.n_cols; ++i)
-    probabilities[i] = gmm->Probability(dataset.unsafe_col(i));
+  // Now calculate the probabilities, all components at once.
+  arma::vec probabilities;
+  gmm->Probability(dataset, probabilities);
 
   // And save the result.
-  CLI::GetParam<arma::mat>("output") = std::move(probabilities);
+  CLI::GetParam<arma::mat>("output") = arma::mat(probabilities.t());
 }
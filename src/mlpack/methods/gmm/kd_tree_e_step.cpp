@@ -0,0 +1,338 @@
+/**
+ * @file kd_tree_e_step.cpp
+ *
+ * Implementation of the KDTreeEStep class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "kd_tree_e_step.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+KDTreeEStep::KDTreeEStep(const double tau, const size_t leafSize) :
+    tau(tau),
+    leafSize(leafSize),
+    tree(NULL),
+    logLikelihood(0.0),
+    summarized(0),
+    evaluated(0)
+{ /* Nothing to do. */ }
+
+KDTreeEStep::KDTreeEStep(const KDTreeEStep& other) :
+    tau(other.tau),
+    leafSize(other.leafSize),
+    tree(NULL),
+    logLikelihood(0.0),
+    summarized(0),
+    evaluated(0)
+{ /* Nothing to do. */ }
+
+KDTreeEStep& KDTreeEStep::operator=(const KDTreeEStep& other)
+{
+  if (this != &other)
+  {
+    tau = other.tau;
+    leafSize = other.leafSize;
+  }
+
+  return *this;
+}
+
+KDTreeEStep::~KDTreeEStep()
+{
+  delete tree;
+}
+
+void KDTreeEStep::Initialize(const arma::mat& observations)
+{
+  BuildTree(observations, NULL);
+}
+
+void KDTreeEStep::Initialize(const arma::mat& observations,
+                             const arma::vec& probabilities)
+{
+  BuildTree(observations, &probabilities);
+}
+
+void KDTreeEStep::BuildTree(const arma::mat& observations,
+                            const arma::vec* probabilities)
+{
+  delete tree;
+
+  std::vector<size_t> oldFromNew;
+  tree = new TreeType(observations, oldFromNew, leafSize);
+
+  // The points are reordered by the tree, so reorder the weights too.
+  pointWeights.set_size(observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    pointWeights[i] = probabilities ? (*probabilities)[oldFromNew[i]] : 1.0;
+
+  FillStatistics(*tree);
+}
+
+void KDTreeEStep::FillStatistics(TreeType& node)
+{
+  KDTreeEStepStat& stat = node.Stat();
+  stat.Weight() = 0.0;
+  stat.Sum().zeros(node.Dataset().n_rows);
+  stat.SumSquares().zeros(node.Dataset().n_rows);
+
+  if (node.NumChildren() == 0)
+  {
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+    {
+      const size_t index = node.Point(i);
+      const double w = pointWeights[index];
+      stat.Weight() += w;
+      stat.Sum() += w * node.Dataset().col(index);
+      stat.SumSquares() += w * arma::square(node.Dataset().col(index));
+    }
+  }
+  else
+  {
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      FillStatistics(node.Child(i));
+
+      const KDTreeEStepStat& childStat = node.Child(i).Stat();
+      stat.Weight() += childStat.Weight();
+      stat.Sum() += childStat.Sum();
+      stat.SumSquares() += childStat.SumSquares();
+    }
+  }
+}
+
+double KDTreeEStep::Statistics(
+    const std::vector<distribution::GaussianDistribution>& dists,
+    const arma::vec& weights,
+    arma::vec& counts,
+    std::vector<arma::vec>& means,
+    std::vector<arma::mat>& covariances)
+{
+  if (!tree)
+  {
+    throw std::invalid_argument("KDTreeEStep::Statistics(): Initialize() has "
+        "not been called!");
+  }
+
+  const size_t numGaussians = dists.size();
+  const size_t dimensionality = tree->Dataset().n_rows;
+  const double log2pi = 1.83787706640934533908193770912475883;
+
+  // Only the diagonal of the covariances is used.
+  logConstants.set_size(numGaussians);
+  gaussianMeans.set_size(dimensionality, numGaussians);
+  invVariances.set_size(dimensionality, numGaussians);
+  for (size_t i = 0; i < numGaussians; ++i)
+  {
+    const arma::vec variances = dists[i].Covariance().diag();
+    gaussianMeans.col(i) = dists[i].Mean();
+    invVariances.col(i) = 1.0 / variances;
+    logConstants[i] = std::log(weights[i]) - 0.5 * (dimensionality * log2pi +
+        arma::accu(arma::log(variances)));
+  }
+
+  accCounts.zeros(numGaussians);
+  accSums.zeros(dimensionality, numGaussians);
+  accSumSquares.zeros(dimensionality, numGaussians);
+  logLikelihood = 0.0;
+  summarized = 0;
+  evaluated = 0;
+
+  std::vector<size_t> candidates(numGaussians);
+  for (size_t i = 0; i < numGaussians; ++i)
+    candidates[i] = i;
+
+  Traverse(*tree, candidates);
+
+  Log::Debug << "KDTreeEStep::Statistics(): summarized " << summarized
+      << " nodes and evaluated " << evaluated << " points." << std::endl;
+
+  // Turn the accumulated statistics into means and diagonal covariances.
+  counts = accCounts;
+  means.resize(numGaussians);
+  covariances.resize(numGaussians);
+  for (size_t i = 0; i < numGaussians; ++i)
+  {
+    if (counts[i] == 0.0)
+      continue;
+
+    means[i] = accSums.col(i) / counts[i];
+
+    // The approximation may make tiny variances slightly negative.
+    const arma::vec variances = accSumSquares.col(i) / counts[i] -
+        arma::square(means[i]);
+    covariances[i] = arma::diagmat(arma::clamp(variances, 0.0, DBL_MAX));
+  }
+
+  return logLikelihood;
+}
+
+void KDTreeEStep::Traverse(const TreeType& node,
+                           const std::vector<size_t>& candidates)
+{
+  const KDTreeEStepStat& stat = node.Stat();
+  if (stat.Weight() == 0.0)
+    return;
+
+  // Bound log(w_i p_i(x)) for every point x of the node with the smallest and
+  // largest Mahalanobis distance from the bounding box to each Gaussian.
+  const size_t numCandidates = candidates.size();
+  arma::vec logMin(numCandidates), logMax(numCandidates);
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    const size_t g = candidates[c];
+    double minDistance = 0.0;
+    double maxDistance = 0.0;
+    for (size_t d = 0; d < gaussianMeans.n_rows; ++d)
+    {
+      const double lo = node.Bound()[d].Lo();
+      const double hi = node.Bound()[d].Hi();
+      const double mu = gaussianMeans(d, g);
+
+      double dMin, dMax;
+      if (mu < lo)
+      {
+        dMin = lo - mu;
+        dMax = hi - mu;
+      }
+      else if (mu > hi)
+      {
+        dMin = mu - hi;
+        dMax = mu - lo;
+      }
+      else
+      {
+        dMin = 0.0;
+        dMax = std::max(mu - lo, hi - mu);
+      }
+
+      minDistance += invVariances(d, g) * dMin * dMin;
+      maxDistance += invVariances(d, g) * dMax * dMax;
+    }
+
+    logMax[c] = logConstants[g] - 0.5 * minDistance;
+    logMin[c] = logConstants[g] - 0.5 * maxDistance;
+  }
+
+  // If the probability of everything is 0, the points don't contribute.
+  const double shift = logMax.max();
+  if (shift == -std::numeric_limits<double>::infinity())
+    return;
+
+  // Bound the conditional probability of each Gaussian.
+  const arma::vec aMax = arma::exp(logMax - shift);
+  const arma::vec aMin = arma::exp(logMin - shift);
+  const double sumMax = arma::accu(aMax);
+  const double sumMin = arma::accu(aMin);
+
+  bool summarize = true;
+  std::vector<size_t> newCandidates;
+  for (size_t c = 0; c < numCandidates; ++c)
+  {
+    const double othersMax = std::max(sumMax - aMax[c], 0.0);
+    const double othersMin = std::max(sumMin - aMin[c], 0.0);
+    const double rMin = (aMin[c] == 0.0) ? 0.0 :
+        aMin[c] / (aMin[c] + othersMax);
+    const double rMax = (aMax[c] == 0.0) ? 0.0 :
+        aMax[c] / (aMax[c] + othersMin);
+
+    if (rMax - rMin >= tau)
+      summarize = false;
+    if (rMax >= tau / numCandidates)
+      newCandidates.push_back(candidates[c]);
+  }
+
+  const double w = stat.Weight();
+  if (summarize)
+  {
+    // Give all the points the conditional probabilities of the centroid.
+    const arma::vec centroid = stat.Sum() / w;
+    arma::vec logA(numCandidates);
+    for (size_t c = 0; c < numCandidates; ++c)
+    {
+      const size_t g = candidates[c];
+      logA[c] = logConstants[g] - 0.5 * arma::accu(arma::square(centroid -
+          gaussianMeans.col(g)) % invVariances.col(g));
+    }
+
+    const double maxLogA = logA.max();
+    const double logSum = maxLogA +
+        std::log(arma::accu(arma::exp(logA - maxLogA)));
+    for (size_t c = 0; c < numCandidates; ++c)
+    {
+      const double r = std::exp(logA[c] - logSum);
+      if (r == 0.0)
+        continue;
+
+      const size_t g = candidates[c];
+      accCounts[g] += r * w;
+      accSums.col(g) += r * stat.Sum();
+      accSumSquares.col(g) += r * stat.SumSquares();
+
+      // The sum of log(w_g p_g(x)) over the points of the node can be
+      // calculated exactly from the cached statistics.
+      const arma::vec mu = gaussianMeans.col(g);
+      const double sumLogA = w * logConstants[g] - 0.5 * arma::accu(
+          invVariances.col(g) % (stat.SumSquares() - 2 * mu % stat.Sum() +
+          w * arma::square(mu)));
+      logLikelihood += r * (sumLogA - w * std::log(r));
+    }
+
+    ++summarized;
+    return;
+  }
+
+  if (newCandidates.empty())
+    newCandidates = candidates;
+
+  if (node.NumChildren() != 0)
+  {
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      Traverse(node.Child(i), newCandidates);
+    return;
+  }
+
+  // Evaluate each point of the leaf against the remaining Gaussians.
+  arma::vec logA(newCandidates.size());
+  for (size_t i = 0; i < node.NumPoints(); ++i)
+  {
+    const size_t index = node.Point(i);
+    const double pointWeight = pointWeights[index];
+    if (pointWeight == 0.0)
+      continue;
+
+    const arma::vec x = node.Dataset().col(index);
+    for (size_t c = 0; c < newCandidates.size(); ++c)
+    {
+      const size_t g = newCandidates[c];
+      logA[c] = logConstants[g] - 0.5 * arma::accu(arma::square(x -
+          gaussianMeans.col(g)) % invVariances.col(g));
+    }
+
+    const double maxLogA = logA.max();
+    if (maxLogA == -std::numeric_limits<double>::infinity())
+      continue;
+
+    const double logSum = maxLogA +
+        std::log(arma::accu(arma::exp(logA - maxLogA)));
+    for (size_t c = 0; c < newCandidates.size(); ++c)
+    {
+      const double r = pointWeight * std::exp(logA[c] - logSum);
+      const size_t g = newCandidates[c];
+      accCounts[g] += r;
+      accSums.col(g) += r * x;
+      accSumSquares.col(g) += r * arma::square(x);
+    }
+
+    logLikelihood += pointWeight * logSum;
+    ++evaluated;
+  }
+}
+
+} // namespace gmm
+} // namespace mlpack
@@ -0,0 +1,231 @@
+/**
+ * @file kd_tree_e_step.hpp
+ *
+ * An approximate, kd-tree based implementation of the E-step of the EM
+ * algorithm for GMMs with diagonal covariances.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_KD_TREE_E_STEP_HPP
+#define MLPACK_METHODS_GMM_KD_TREE_E_STEP_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * The statistic of each node of the tree used by KDTreeEStep: the sufficient
+ * statistics of the (weighted) points held by the node and its descendants.
+ */
+class KDTreeEStepStat
+{
+ public:
+  //! Create the statistic.
+  KDTreeEStepStat() : weight(0.0) { }
+
+  //! Create the statistic for the given node; it is filled by KDTreeEStep.
+  template<typename TreeType>
+  KDTreeEStepStat(TreeType& /* node */) : weight(0.0) { }
+
+  //! Get the sum of the weights of the points.
+  double Weight() const { return weight; }
+  //! Modify the sum of the weights of the points.
+  double& Weight() { return weight; }
+
+  //! Get the weighted sum of the points.
+  const arma::vec& Sum() const { return sum; }
+  //! Modify the weighted sum of the points.
+  arma::vec& Sum() { return sum; }
+
+  //! Get the weighted sum of the squares of the points.
+  const arma::vec& SumSquares() const { return sumSquares; }
+  //! Modify the weighted sum of the squares of the points.
+  arma::vec& SumSquares() { return sumSquares; }
+
+  //! Serialize the statistic.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(weight);
+    ar & BOOST_SERIALIZATION_NVP(sum);
+    ar & BOOST_SERIALIZATION_NVP(sumSquares);
+  }
+
+ private:
+  //! The sum of the weights of the points.
+  double weight;
+  //! The weighted sum of the points.
+  arma::vec sum;
+  //! The weighted sum of the squares of the points.
+  arma::vec sumSquares;
+};
+
+/**
+ * The KDTreeEStep class is an E-step for EMFit that follows the idea of
+ * Moore's "very fast EM" (mrkd-trees).  A kd-tree is built once on the
+ * observations, and each node caches the (weighted) number of points, sum and
+ * sum of squares of its points.  At each E-step the tree is traversed with the
+ * list of Gaussians, and for each node the distance from the bounding box of
+ * the node to each Gaussian gives bounds on the conditional probability of
+ * each Gaussian for every point of the node:
+ *
+ *  - If, for every Gaussian, the bounds are closer than tau, all the points of
+ *    the node are given the conditional probabilities of the centroid of the
+ *    node, and the cached statistics are added at once.
+ *  - Gaussians whose conditional probability is at most tau / k (for k
+ *    candidate Gaussians) for every point of the node are pruned from the
+ *    traversal of its descendants.
+ *  - Otherwise the children are visited; in the leaves, each point is
+ *    evaluated against the remaining Gaussians.
+ *
+ * Only the diagonal of the covariances is used and estimated, so this should
+ * be used with DiagonalConstraint:
+ *
+ * @code
+ * EMFit<kmeans::KMeans<>, DiagonalConstraint, KDTreeEStep> fitter;
+ * gmm.Train(data, 1, false, fitter);
+ * @endcode
+ *
+ * The log-likelihood returned by Statistics() is approximated the same way,
+ * and weighted by the probabilities of the observations, if they are given.
+ * The traversal is single-threaded.
+ */
+class KDTreeEStep
+{
+ public:
+  //! The type of tree used.
+  typedef tree::KDTree<metric::EuclideanDistance, KDTreeEStepStat, arma::mat>
+      TreeType;
+
+  /**
+   * Create the E-step object with the given parameters.
+   *
+   * @param tau Maximum difference between the bounds of the conditional
+   *      probability of a Gaussian for the points of a node to summarize it.
+   * @param leafSize Maximum number of points in each leaf of the tree.
+   */
+  KDTreeEStep(const double tau = 1e-3, const size_t leafSize = 20);
+
+  //! Copy the parameters of the given object; the tree is not copied.
+  KDTreeEStep(const KDTreeEStep& other);
+
+  //! Copy the parameters of the given object; the tree is not copied.
+  KDTreeEStep& operator=(const KDTreeEStep& other);
+
+  //! Destroy the object and the tree.
+  ~KDTreeEStep();
+
+  /**
+   * Build the tree on the given observations.
+   *
+   * @param observations List of observations.
+   */
+  void Initialize(const arma::mat& observations);
+
+  /**
+   * Build the tree on the given observations, taking into account the
+   * probability of each observation being from this mixture.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation.
+   */
+  void Initialize(const arma::mat& observations,
+                  const arma::vec& probabilities);
+
+  /**
+   * Calculate the (approximate) statistics of the conditional probabilities
+   * of each Gaussian given the observations, and return the (approximate)
+   * log-likelihood of the model.
+   *
+   * @param dists Vector of distributions.
+   * @param weights Vector of a priori weights.
+   * @param counts Vector to store the sum of the (weighted) conditional
+   *      probabilities of each Gaussian in.
+   * @param means Vector to store the weighted mean of each Gaussian in (only
+   *      set if its count is not zero).
+   * @param covariances Vector to store the weighted diagonal covariance of
+   *      each Gaussian in (only set if its count is not zero).
+   */
+  double Statistics(
+      const std::vector<distribution::GaussianDistribution>& dists,
+      const arma::vec& weights,
+      arma::vec& counts,
+      std::vector<arma::vec>& means,
+      std::vector<arma::mat>& covariances);
+
+  //! Get the tolerance for summarizing a node.
+  double Tau() const { return tau; }
+  //! Modify the tolerance for summarizing a node.
+  double& Tau() { return tau; }
+
+  //! Get the maximum leaf size of the tree.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the maximum leaf size of the tree (used by the next Initialize()).
+  size_t& LeafSize() { return leafSize; }
+
+  //! Get the number of nodes that were summarized in the last E-step.
+  size_t Summarized() const { return summarized; }
+  //! Get the number of points that were evaluated in the last E-step.
+  size_t Evaluated() const { return evaluated; }
+
+  //! Serialize the parameters.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(tau);
+    ar & BOOST_SERIALIZATION_NVP(leafSize);
+  }
+
+ private:
+  //! Build the tree and fill the statistics.
+  void BuildTree(const arma::mat& observations, const arma::vec* probabilities);
+
+  //! Fill the statistics of the given node and its descendants.
+  void FillStatistics(TreeType& node);
+
+  /**
+   * Traverse the given node with the given candidate Gaussians, adding to the
+   * accumulators.
+   */
+  void Traverse(const TreeType& node, const std::vector<size_t>& candidates);
+
+  //! Tolerance for summarizing a node.
+  double tau;
+  //! Maximum leaf size of the tree.
+  size_t leafSize;
+  //! The tree built on the observations.
+  TreeType* tree;
+  //! The weight of each point of the tree (in the order of the tree).
+  arma::vec pointWeights;
+
+  //! The constant part of log(w_i p_i(x)) of each Gaussian.
+  arma::vec logConstants;
+  //! The mean of each Gaussian (one column per Gaussian).
+  arma::mat gaussianMeans;
+  //! The inverse of the variances of each Gaussian (one column per Gaussian).
+  arma::mat invVariances;
+
+  //! The sum of the weighted conditional probabilities of each Gaussian.
+  arma::vec accCounts;
+  //! The weighted sum of the points of each Gaussian.
+  arma::mat accSums;
+  //! The weighted sum of the squares of the points of each Gaussian.
+  arma::mat accSumSquares;
+  //! The log-likelihood.
+  double logLikelihood;
+  //! The number of nodes summarized in the last E-step.
+  size_t summarized;
+  //! The number of points evaluated in the last E-step.
+  size_t evaluated;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
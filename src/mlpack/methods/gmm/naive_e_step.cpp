@@ -0,0 +1,112 @@
+/**
+ * @file naive_e_step.cpp
+ *
+ * Implementation of the NaiveEStep class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "naive_e_step.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+double NaiveEStep::Statistics(
+    const std::vector<distribution::GaussianDistribution>& dists,
+    const arma::vec& weights,
+    arma::vec& counts,
+    std::vector<arma::vec>& means,
+    std::vector<arma::mat>& covariances)
+{
+  const arma::mat& observations = *this->observations;
+  condProb.set_size(observations.n_cols, dists.size());
+  arma::vec logLikelihoods(observations.n_cols);
+  const arma::vec logWeights = arma::log(weights);
+  const double log2pi = 1.83787706640934533908193770912475883;
+
+  // The observations are split into fixed-size blocks, so that the result does
+  // not depend on the number of threads.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t count = std::min(blockSize,
+        (size_t) observations.n_cols - begin);
+    const arma::mat block(const_cast<double*>(observations.colptr(begin)),
+        observations.n_rows, count, false, true);
+
+    // Calculate log(w_i) + log(p_i(x)) for each Gaussian.  If the covariance
+    // is L * L^T, the Mahalanobis distance of x is ||L^-1 (x - mu)||^2, which
+    // only needs a triangular solve.
+    arma::mat logProbs(count, dists.size());
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      const arma::mat diffs = block.each_col() - dists[i].Mean();
+      const arma::mat z = arma::solve(arma::trimatl(dists[i].CovLower()),
+          diffs);
+      logProbs.col(i) = logWeights[i] - 0.5 * (observations.n_rows * log2pi +
+          dists[i].LogDetCov()) - 0.5 * trans(arma::sum(arma::square(z), 0));
+    }
+
+    // Normalize each row with the log-sum-exp trick.
+    for (size_t j = 0; j < count; ++j)
+    {
+      const double maxLogProb = logProbs.row(j).max();
+
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      if (maxLogProb == -std::numeric_limits<double>::infinity())
+      {
+        condProb.row(begin + j).zeros();
+        logLikelihoods[begin + j] = maxLogProb;
+        continue;
+      }
+
+      const double logProbSum = maxLogProb +
+          std::log(arma::accu(arma::exp(logProbs.row(j) - maxLogProb)));
+      condProb.row(begin + j) = arma::exp(logProbs.row(j) - logProbSum);
+      logLikelihoods[begin + j] = logProbSum;
+    }
+  }
+
+  if (logLikelihoods.has_inf())
+    Log::Info << "Likelihood of some points is 0!  They are probably outliers."
+        << std::endl;
+
+  // Weight the conditional probabilities by the probabilities of the points
+  // being from this mixture model.
+  if (probabilities)
+    condProb.each_col() %= *probabilities;
+
+  // Store the sum of the probability of each state over all the observations.
+  counts = trans(arma::sum(condProb, 0 /* columnwise */));
+
+  // Calculate the new value of the means and covariances using the updated
+  // conditional probabilities.
+  means.resize(dists.size());
+  covariances.resize(dists.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (counts[i] == 0.0)
+      continue;
+
+    means[i] = (observations * condProb.col(i)) / counts[i];
+
+    const arma::mat tmp = observations.each_col() - means[i];
+    const arma::mat tmpB = tmp.each_row() % trans(condProb.col(i));
+    covariances[i] = (tmp * trans(tmpB)) / counts[i];
+  }
+
+  return arma::accu(logLikelihoods);
+}
+
+} // namespace gmm
+} // namespace mlpack
@@ -0,0 +1,107 @@
+/**
+ * @file naive_e_step.hpp
+ *
+ * An implementation of the E-step of the EM algorithm for GMMs that evaluates
+ * every observation against every Gaussian.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_NAIVE_E_STEP_HPP
+#define MLPACK_METHODS_GMM_NAIVE_E_STEP_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * The NaiveEStep class is the default E-step of EMFit.  It computes the
+ * conditional probability of each Gaussian given each observation exactly, and
+ * then the weighted means and covariances of the observations for each
+ * Gaussian.  This takes O(n k d^2) time per iteration for n observations, k
+ * Gaussians, and d dimensions.
+ *
+ * The probabilities are calculated in the log domain, in parallel over blocks
+ * of observations, using the Cholesky factor of each covariance.  The means
+ * and covariances are calculated in parallel over the Gaussians.  The result
+ * does not depend on the number of threads.
+ */
+class NaiveEStep
+{
+ public:
+  //! Create the E-step object.
+  NaiveEStep() : observations(NULL), probabilities(NULL) { }
+
+  /**
+   * Prepare the E-steps for the given observations.  The observations must not
+   * be modified or destroyed until the E-steps are finished.
+   *
+   * @param observations List of observations.
+   */
+  void Initialize(const arma::mat& observations)
+  {
+    this->observations = &observations;
+    this->probabilities = NULL;
+  }
+
+  /**
+   * Prepare the E-steps for the given observations, taking into account the
+   * probability of each observation being from this mixture.  The observations
+   * and probabilities must not be modified or destroyed until the E-steps are
+   * finished.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation.
+   */
+  void Initialize(const arma::mat& observations,
+                  const arma::vec& probabilities)
+  {
+    this->observations = &observations;
+    this->probabilities = &probabilities;
+  }
+
+  /**
+   * Calculate the statistics of the conditional probabilities of each Gaussian
+   * given the observations, and return the log-likelihood of the model.  Yes,
+   * the log-likelihood is reimplemented in the GMM code.  Intuition suggests
+   * that the log-likelihood is not the best way to determine if the EM
+   * algorithm has converged.
+   *
+   * @param dists Vector of distributions.
+   * @param weights Vector of a priori weights.
+   * @param counts Vector to store the sum of the (weighted) conditional
+   *      probabilities of each Gaussian in.
+   * @param means Vector to store the weighted mean of each Gaussian in (only
+   *      set if its count is not zero).
+   * @param covariances Vector to store the weighted covariance of each
+   *      Gaussian in (only set if its count is not zero).
+   */
+  double Statistics(
+      const std::vector<distribution::GaussianDistribution>& dists,
+      const arma::vec& weights,
+      arma::vec& counts,
+      std::vector<arma::vec>& means,
+      std::vector<arma::mat>& covariances);
+
+  //! Serialize the object (there are no parameters to save).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  //! The observations.
+  const arma::mat* observations;
+  //! The probability of each observation, or NULL if there are none.
+  const arma::vec* probabilities;
+  //! The conditional probabilities (one row per observation, one column per
+  //! Gaussian).
+  arma::mat condProb;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,308 @@
+/**
+ * @file stochastic_em_fit.hpp
+ *
+ * The stochastic (online) EM algorithm for Gaussian mixture models, which fits
+ * the model to mini-batches of observations, so that it can be trained on
+ * datasets that are too large to be held in memory, or on streams.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// EMFit gives the initial model.
+#include "em_fit.hpp"
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+// Default E-step.
+#include "naive_e_step.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * StochasticEMFit fits a Gaussian mixture model with the stochastic (online)
+ * EM algorithm of Cappé and Moulines.  Each step runs the E-step policy on a
+ * mini-batch of the observations, which gives the responsibility-weighted
+ * count, mean and covariance of each Gaussian on the batch, and blends them
+ * into running statistics of the whole stream:
+ *
+ * s_t = (1 - eta_t) s_{t - 1} + eta_t s(batch_t),
+ *
+ * with the step size eta_t = (t + t_0)^(-kappa).  The counts are normalized by
+ * the weight of each batch, so that the running counts are the weights of the
+ * Gaussians; the means and covariances are blended in centered form, as in
+ * DistributedEMFit.  The M-step, with the covariance constraint policy, then
+ * gives the model from the running statistics.  With 0.5 < kappa <= 1 the
+ * algorithm converges, and a single pass over a large dataset usually gives a
+ * model close to that of batch EM.
+ *
+ * Estimate() makes passes over an in-memory dataset, in (by default shuffled)
+ * mini-batches, and Update() takes one step with a given batch, for data that
+ * arrives in pieces.  The running statistics are kept between calls to
+ * Update(), and Reset() forgets them (which must be done if the model is
+ * changed in some other way).
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title = {On-line expectation-maximization algorithm for latent data
+ *       models},
+ *   author = {Capp{\'e}, Olivier and Moulines, Eric},
+ *   journal = {Journal of the Royal Statistical Society: Series B},
+ *   volume = {71},
+ *   number = {3},
+ *   pages = {593--613},
+ *   year = {2009}
+ * }
+ * @endcode
+ *
+ * @tparam InitialClusteringType The clusterer used to give the initial model
+ *     from the first batch (see EMFit).
+ * @tparam CovarianceConstraintPolicy Constraint on the covariances.
+ * @tparam EStepType Policy which computes the statistics of each E-step on a
+ *     batch (see NaiveEStep).
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename EStepType = NaiveEStep>
+class StochasticEMFit
+{
+ public:
+  /**
+   * Construct the StochasticEMFit object.  Setting the maximum number of passes
+   * to 0 means that Estimate() will make passes over the dataset until the
+   * average log-likelihood of the batches of a pass changes by less than the
+   * tolerance.
+   *
+   * @param batchSize Number of observations in each mini-batch of Estimate().
+   * @param maxPasses Maximum number of passes over the dataset in Estimate().
+   * @param tolerance Tolerance on the average log-likelihood of a point for
+   *      convergence.
+   * @param stepSizeDecay Decay kappa of the step size; it should be in
+   *      (0.5, 1].
+   * @param stepSizeOffset Offset t_0 of the step size; it must be at least 1.
+   * @param shuffle If true, the dataset is shuffled before each pass of
+   *      Estimate().
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Object which applies constraints to the covariances.
+   * @param eStep Object which will perform the E-steps.
+   */
+  StochasticEMFit(const size_t batchSize = 1000,
+                  const size_t maxPasses = 5,
+                  const double tolerance = 1e-5,
+                  const double stepSizeDecay = 0.6,
+                  const double stepSizeOffset = 2.0,
+                  const bool shuffle = true,
+                  InitialClusteringType clusterer = InitialClusteringType(),
+                  CovarianceConstraintPolicy constraint =
+                      CovarianceConstraintPolicy(),
+                  EStepType eStep = EStepType());
+
+  /**
+   * Fit the model to the given observations, in mini-batches.  If
+   * useInitialModel is false, the initial model is given by the clusterer on
+   * the first batch.  This forgets the running statistics of earlier calls.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store the model in (and to start from, if
+   *      useInitialModel is true).
+   * @param weights A priori weights to store the model in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *      model.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the model to the given observations, as above, taking into account the
+   * probability of each observation being from this mixture.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each observation being from this
+   *      model.
+   * @param dists Distributions to store the model in (and to start from, if
+   *      useInitialModel is true).
+   * @param weights A priori weights to store the model in.
+   * @param useInitialModel If true, the given model is used as the initial
+   *      model.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Take one step of stochastic EM with the given batch of observations.  If
+   * there are no running statistics yet (this is the first step since
+   * construction or Reset()), they start from the given model.
+   *
+   * @param batch Batch of observations.
+   * @param dists Distributions of the model, which are updated.
+   * @param weights A priori weights of the model, which are updated.
+   * @return Log-likelihood of the batch under the model before the step.
+   */
+  double Update(const arma::mat& batch,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  /**
+   * Take one step of stochastic EM with the given batch of observations, as
+   * above, taking into account the probability of each observation being from
+   * this mixture.
+   *
+   * @param batch Batch of observations.
+   * @param probabilities Probability of each observation of the batch being
+   *      from this model.
+   * @param dists Distributions of the model, which are updated.
+   * @param weights A priori weights of the model, which are updated.
+   * @return Log-likelihood of the batch under the model before the step.
+   */
+  double Update(const arma::mat& batch,
+                const arma::vec& probabilities,
+                std::vector<distribution::GaussianDistribution>& dists,
+                arma::vec& weights);
+
+  /**
+   * Give the initial model with the clusterer on the given batch of
+   * observations (as EMFit does), and forget the running statistics.
+   *
+   * @param batch Batch of observations.
+   * @param dists Distributions to store the initial model in.
+   * @param weights A priori weights to store the initial model in.
+   */
+  void Initialize(const arma::mat& batch,
+                  std::vector<distribution::GaussianDistribution>& dists,
+                  arma::vec& weights);
+
+  //! Forget the running statistics, so that the next step starts from the
+  //! given model.
+  void Reset();
+
+  //! Get the number of steps taken since construction or Reset().
+  size_t Steps() const { return steps; }
+
+  //! Get the number of observations in each mini-batch of Estimate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each mini-batch of Estimate().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of passes over the dataset.
+  size_t MaxPasses() const { return maxPasses; }
+  //! Modify the maximum number of passes over the dataset.
+  size_t& MaxPasses() { return maxPasses; }
+
+  //! Get the tolerance for convergence.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for convergence.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the decay of the step size.
+  double StepSizeDecay() const { return stepSizeDecay; }
+  //! Modify the decay of the step size.
+  double& StepSizeDecay() { return stepSizeDecay; }
+
+  //! Get the offset of the step size.
+  double StepSizeOffset() const { return stepSizeOffset; }
+  //! Modify the offset of the step size.
+  double& StepSizeOffset() { return stepSizeOffset; }
+
+  //! Get whether the dataset is shuffled before each pass.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether the dataset is shuffled before each pass.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the E-step policy class.
+  const EStepType& EStep() const { return eStep; }
+  //! Modify the E-step policy class.
+  EStepType& EStep() { return eStep; }
+
+  //! Serialize the fitter, with its running statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  /**
+   * Make passes over the observations in mini-batches, with or without the
+   * probabilities of the observations.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each observation being from this
+   *      model, or NULL.
+   * @param dists Distributions of the model, which are updated.
+   * @param weights A priori weights of the model, which are updated.
+   * @param useInitialModel If true, the given model is used as the initial
+   *      model.
+   */
+  void Passes(const arma::mat& observations,
+              const arma::vec* probabilities,
+              std::vector<distribution::GaussianDistribution>& dists,
+              arma::vec& weights,
+              const bool useInitialModel);
+
+  /**
+   * Blend the statistics of a batch, computed by the E-step object that has
+   * already been initialized with it, into the running statistics, and run the
+   * M-step.
+   *
+   * @param dists Distributions of the model, which are updated.
+   * @param weights A priori weights of the model, which are updated.
+   * @return Log-likelihood of the batch under the model before the step.
+   */
+  double Step(std::vector<distribution::GaussianDistribution>& dists,
+              arma::vec& weights);
+
+  //! Number of observations in each mini-batch of Estimate().
+  size_t batchSize;
+  //! Maximum number of passes over the dataset.
+  size_t maxPasses;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Decay of the step size.
+  double stepSizeDecay;
+  //! Offset of the step size.
+  double stepSizeOffset;
+  //! Whether to shuffle the dataset before each pass.
+  bool shuffle;
+  //! Object which will perform the initial clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+  //! Object which performs the E-steps.
+  EStepType eStep;
+
+  //! Number of steps taken since construction or Reset().
+  size_t steps;
+  //! The running (normalized) count of each Gaussian.
+  arma::vec counts;
+  //! The running mean of each Gaussian.
+  std::vector<arma::vec> means;
+  //! The running (unconstrained) covariance of each Gaussian.
+  std::vector<arma::mat> covariances;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "stochastic_em_fit_impl.hpp"
+
+#endif
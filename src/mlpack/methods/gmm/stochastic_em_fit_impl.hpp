@@ -0,0 +1,323 @@
+/**
+ * @file stochastic_em_fit_impl.hpp
+ *
+ * Implementation of the stochastic (online) EM algorithm for Gaussian mixture
+ * models.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_STOCHASTIC_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stochastic_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>::
+StochasticEMFit(const size_t batchSize,
+                const size_t maxPasses,
+                const double tolerance,
+                const double stepSizeDecay,
+                const double stepSizeOffset,
+                const bool shuffle,
+                InitialClusteringType clusterer,
+                CovarianceConstraintPolicy constraint,
+                EStepType eStep) :
+    batchSize(batchSize),
+    maxPasses(maxPasses),
+    tolerance(tolerance),
+    stepSizeDecay(stepSizeDecay),
+    stepSizeOffset(stepSizeOffset),
+    shuffle(shuffle),
+    clusterer(clusterer),
+    constraint(constraint),
+    eStep(eStep),
+    steps(0)
+{ /* Nothing to do. */ }
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Estimate(const arma::mat& observations,
+         std::vector<distribution::GaussianDistribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
+{
+  Passes(observations, NULL, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Estimate(const arma::mat& observations,
+         const arma::vec& probabilities,
+         std::vector<distribution::GaussianDistribution>& dists,
+         arma::vec& weights,
+         const bool useInitialModel)
+{
+  Passes(observations, &probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+double StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Update(const arma::mat& batch,
+       std::vector<distribution::GaussianDistribution>& dists,
+       arma::vec& weights)
+{
+  if (batch.n_cols == 0)
+    throw std::invalid_argument("StochasticEMFit::Update(): empty batch!");
+
+  eStep.Initialize(batch);
+  return Step(dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+double StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Update(const arma::mat& batch,
+       const arma::vec& probabilities,
+       std::vector<distribution::GaussianDistribution>& dists,
+       arma::vec& weights)
+{
+  if (batch.n_cols == 0)
+    throw std::invalid_argument("StochasticEMFit::Update(): empty batch!");
+
+  eStep.Initialize(batch, probabilities);
+  return Step(dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Initialize(const arma::mat& batch,
+           std::vector<distribution::GaussianDistribution>& dists,
+           arma::vec& weights)
+{
+  Reset();
+
+  // An EMFit object with a single iteration does only the initial clustering.
+  typedef EMFit<InitialClusteringType, CovarianceConstraintPolicy, EStepType>
+      InitialFitType;
+  InitialFitType initialFit(1, InitialFitType().Tolerance(), clusterer,
+      constraint, eStep);
+  initialFit.Estimate(batch, dists, weights, false);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::Reset()
+{
+  steps = 0;
+  counts.clear();
+  means.clear();
+  covariances.clear();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+template<typename Archive>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(maxPasses);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(stepSizeDecay);
+  ar & BOOST_SERIALIZATION_NVP(stepSizeOffset);
+  ar & BOOST_SERIALIZATION_NVP(shuffle);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+  ar & BOOST_SERIALIZATION_NVP(eStep);
+  ar & BOOST_SERIALIZATION_NVP(steps);
+  ar & BOOST_SERIALIZATION_NVP(counts);
+  ar & BOOST_SERIALIZATION_NVP(means);
+  ar & BOOST_SERIALIZATION_NVP(covariances);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+void StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Passes(const arma::mat& observations,
+       const arma::vec* probabilities,
+       std::vector<distribution::GaussianDistribution>& dists,
+       arma::vec& weights,
+       const bool useInitialModel)
+{
+  if (observations.n_cols == 0 || batchSize == 0)
+  {
+    std::ostringstream oss;
+    oss << "StochasticEMFit::Estimate(): cannot train on "
+        << observations.n_cols << " observations with a batch size of "
+        << batchSize << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Reset();
+
+  const size_t n = observations.n_cols;
+  const double totalWeight = (probabilities == NULL) ? (double) n :
+      arma::accu(*probabilities);
+  arma::uvec ordering = arma::linspace<arma::uvec>(0, n - 1, n);
+  if (shuffle)
+    ordering = arma::shuffle(ordering);
+
+  // The initial model is given by the clusterer on the first batch.
+  if (!useInitialModel)
+  {
+    const arma::mat firstBatch = observations.cols(
+        ordering.subvec(0, std::min(batchSize, n) - 1));
+    Initialize(firstBatch, dists, weights);
+  }
+
+  double lOld = -DBL_MAX;
+  size_t pass = 0;
+  while (pass != maxPasses)
+  {
+    if (shuffle && pass > 0)
+      ordering = arma::shuffle(ordering);
+
+    double l = 0.0;
+    for (size_t begin = 0; begin < n; begin += batchSize)
+    {
+      const arma::uvec batchIndices = ordering.subvec(begin,
+          std::min(begin + batchSize, n) - 1);
+      const arma::mat batch = observations.cols(batchIndices);
+      if (probabilities == NULL)
+      {
+        l += Update(batch, dists, weights);
+      }
+      else
+      {
+        const arma::vec batchProbabilities =
+            probabilities->elem(batchIndices);
+        l += Update(batch, batchProbabilities, dists, weights);
+      }
+    }
+
+    // The average log-likelihood of a point over the pass.
+    l /= totalWeight;
+    ++pass;
+
+    MLPACK_LOG_INFO << "StochasticEMFit::Estimate(): pass " << pass << ", "
+        << "average log-likelihood " << l << "." << std::endl;
+
+    if (std::abs(l - lOld) <= tolerance)
+      break;
+    lOld = l;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename EStepType>
+double StochasticEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    EStepType>::
+Step(std::vector<distribution::GaussianDistribution>& dists,
+     arma::vec& weights)
+{
+  if (dists.size() == 0 || weights.n_elem != dists.size())
+  {
+    std::ostringstream oss;
+    oss << "StochasticEMFit::Update(): " << dists.size() << " Gaussians "
+        << "and " << weights.n_elem << " weights given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::vec batchCounts;
+  std::vector<arma::vec> batchMeans;
+  std::vector<arma::mat> batchCovariances;
+  const double l = eStep.Statistics(dists, weights, batchCounts, batchMeans,
+      batchCovariances);
+
+  // If no observation of the batch can be from this model, there's nothing to
+  // learn from it.
+  const double batchWeight = arma::accu(batchCounts);
+  if (batchWeight == 0.0)
+    return l;
+
+  // The first step starts from the given model.
+  if (steps == 0)
+  {
+    counts = weights;
+    means.resize(dists.size());
+    covariances.resize(dists.size());
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      means[i] = dists[i].Mean();
+      covariances[i] = dists[i].Covariance();
+    }
+  }
+
+  const double stepSize = std::pow(stepSizeOffset + (double) steps,
+      -stepSizeDecay);
+  ++steps;
+
+  // Blend the statistics of the batch into the running statistics.  Both
+  // covariances are shifted to the blended mean, as in DistributedEMFit.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const double oldCount = (1.0 - stepSize) * counts[i];
+    const double newCount = stepSize * batchCounts[i] / batchWeight;
+    counts[i] = oldCount + newCount;
+
+    // The mean and covariance of a Gaussian that has no probability of having
+    // points of the batch are unchanged.
+    if (newCount == 0.0)
+      continue;
+
+    const arma::vec mean = (oldCount * means[i] + newCount * batchMeans[i]) /
+        counts[i];
+    const arma::vec oldShift = means[i] - mean;
+    const arma::vec newShift = batchMeans[i] - mean;
+    covariances[i] = (oldCount * (covariances[i] + oldShift * oldShift.t()) +
+        newCount * (batchCovariances[i] + newShift * newShift.t())) /
+        counts[i];
+    means[i] = mean;
+  }
+
+  // The M-step.  The running covariances are kept unconstrained, and don't
+  // update a Gaussian if there's no probability of it having points.
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    if (counts[i] == 0.0)
+      continue;
+
+    dists[i].Mean() = means[i];
+    arma::mat covariance = covariances[i];
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = counts / arma::accu(counts);
+
+  return l;
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
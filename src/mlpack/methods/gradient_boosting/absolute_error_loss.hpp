@@ -0,0 +1,59 @@
+/**
+ * @file absolute_error_loss.hpp
+ *
+ * The absolute error loss for gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_ABSOLUTE_ERROR_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_ABSOLUTE_ERROR_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The absolute error loss, |y - f|, which is less sensitive to outliers than
+ * the squared error loss.  Its negative gradient is the sign of the residual
+ * y - f; the trees are fit to the signs, and the value of each leaf is then the
+ * median of the residuals of its points, which minimizes the loss in the leaf.
+ */
+class AbsoluteErrorLoss
+{
+ public:
+  //! Get the constant that minimizes the loss: the median of the responses.
+  static double InitialValue(const arma::rowvec& responses)
+  {
+    return arma::median(responses);
+  }
+
+  //! Compute the negative gradient of the loss: the signs of the residuals.
+  static void NegativeGradient(const arma::rowvec& responses,
+                               const arma::rowvec& predictions,
+                               arma::rowvec& gradient)
+  {
+    gradient = arma::sign(responses - predictions);
+  }
+
+  //! Get the best value of a leaf from the residuals of its points.
+  static double LeafValue(const arma::rowvec& residuals)
+  {
+    return arma::median(residuals);
+  }
+
+  //! Evaluate the mean loss of the given predictions.
+  static double Evaluate(const arma::rowvec& responses,
+                         const arma::rowvec& predictions)
+  {
+    return arma::mean(arma::abs(responses - predictions));
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * @file feature_binner.cpp
+ *
+ * Implementation of the FeatureBinner class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "feature_binner.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+void FeatureBinner::Train(const arma::mat& data, const size_t maxBins)
+{
+  if (maxBins < 2 || maxBins > 256)
+  {
+    std::ostringstream oss;
+    oss << "FeatureBinner::Train(): the number of bins must be between 2 and "
+        << "256 (given " << maxBins << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  edges.clear();
+  edges.resize(data.n_rows);
+
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+  {
+    const arma::rowvec sorted = arma::sort(data.row(d));
+    const arma::rowvec values = arma::unique(sorted);
+    if (values.n_elem <= 1)
+      continue;
+
+    std::vector<double> featureEdges;
+    if (values.n_elem <= maxBins)
+    {
+      // One bin per distinct value; the edge is halfway to the next value.
+      for (size_t i = 0; i + 1 < values.n_elem; ++i)
+        featureEdges.push_back((values[i] + values[i + 1]) / 2.0);
+    }
+    else
+    {
+      // The edges are quantiles; a value that holds many points may span
+      // several quantiles, so duplicates are removed.  The largest value can't
+      // be an edge, since the last bin would then be empty.
+      for (size_t b = 1; b < maxBins; ++b)
+      {
+        const double edge = sorted[b * sorted.n_elem / maxBins];
+        if (edge < values[values.n_elem - 1] &&
+            (featureEdges.empty() || edge > featureEdges.back()))
+          featureEdges.push_back(edge);
+      }
+    }
+
+    edges[d] = arma::vec(featureEdges);
+  }
+}
+
+void FeatureBinner::Bin(const arma::mat& data,
+                        arma::Mat<unsigned char>& bins) const
+{
+  if (data.n_rows != edges.size())
+  {
+    std::ostringstream oss;
+    oss << "FeatureBinner::Bin(): dimensionality of data (" << data.n_rows
+        << ") is not equal to the dimensionality of the binner ("
+        << edges.size() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  bins.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for
+  for (omp_size_t d = 0; d < (omp_size_t) data.n_rows; ++d)
+    for (size_t i = 0; i < data.n_cols; ++i)
+      bins(i, d) = (unsigned char) Bin(d, data(d, i));
+}
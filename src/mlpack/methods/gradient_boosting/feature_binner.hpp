@@ -0,0 +1,101 @@
+/**
+ * @file feature_binner.hpp
+ *
+ * Definition of the FeatureBinner class, which quantizes each feature of a
+ * dataset into a small number of bins for histogram-based tree learning.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_FEATURE_BINNER_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_FEATURE_BINNER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The FeatureBinner computes, for each feature of a dataset, the edges of at
+ * most 256 bins that hold about the same number of points (the quantiles of the
+ * feature), and maps each value to the index of its bin, so that a binned
+ * dataset takes one byte per value.  A value x falls into the first bin b whose
+ * upper edge is not smaller than x, so the split "bin <= b" of a binned dataset
+ * is the split "x <= UpperEdge(d, b)" of the original data.  The last bin has
+ * no upper edge and holds all the larger values.
+ *
+ * If a feature has at most as many distinct values as bins, each distinct
+ * value gets its own bin.  Missing (NaN) values are not supported.
+ */
+class FeatureBinner
+{
+ public:
+  //! Create an empty binner.
+  FeatureBinner() { }
+
+  /**
+   * Compute the edges of the bins of each feature of the given dataset.
+   *
+   * @param data Dataset (one column per point).
+   * @param maxBins Maximum number of bins of each feature (2 to 256).
+   */
+  FeatureBinner(const arma::mat& data, const size_t maxBins = 256)
+  {
+    Train(data, maxBins);
+  }
+
+  /**
+   * Compute the edges of the bins of each feature of the given dataset.
+   *
+   * @param data Dataset (one column per point).
+   * @param maxBins Maximum number of bins of each feature (2 to 256).
+   */
+  void Train(const arma::mat& data, const size_t maxBins = 256);
+
+  /**
+   * Bin the given dataset.  The binned dataset has one row per point and one
+   * column per feature, so that the bins of a feature are contiguous.
+   *
+   * @param data Dataset to bin (one column per point).
+   * @param bins Matrix to store the bin of each value in.
+   */
+  void Bin(const arma::mat& data, arma::Mat<unsigned char>& bins) const;
+
+  //! Get the bin of the given value of the given feature.
+  size_t Bin(const size_t feature, const double value) const
+  {
+    const arma::vec& e = edges[feature];
+    return std::lower_bound(e.begin(), e.end(), value) - e.begin();
+  }
+
+  //! Get the number of features.
+  size_t Dimensionality() const { return edges.size(); }
+  //! Get the number of bins of the given feature.
+  size_t NumBins(const size_t feature) const
+  {
+    return edges[feature].n_elem + 1;
+  }
+  //! Get the upper edge of the given bin (not the last) of the given feature.
+  double UpperEdge(const size_t feature, const size_t bin) const
+  {
+    return edges[feature][bin];
+  }
+
+  //! Serialize the binner.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(edges);
+  }
+
+ private:
+  //! The upper edges of the bins of each feature (but the last), sorted.
+  std::vector<arma::vec> edges;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file gradient_boosting.cpp
+ *
+ * Implementation of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gradient_boosting.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+GradientBoosting::GradientBoosting() :
+    initialValue(0.0)
+{
+  // Nothing to do.
+}
+
+void GradientBoosting::Predict(const arma::mat& data,
+                               arma::rowvec& predictions) const
+{
+  if (!trees.empty() && data.n_rows != binner.Dimensionality())
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Predict(): dimensionality of data ("
+        << data.n_rows << ") is not equal to the dimensionality of the model ("
+        << binner.Dimensionality() << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    double prediction = initialValue;
+    for (size_t t = 0; t < trees.size(); ++t)
+      prediction += trees[t].Predict(data.col(i));
+    predictions[i] = prediction;
+  }
+}
@@ -0,0 +1,117 @@
+/**
+ * @file gradient_boosting.hpp
+ *
+ * Definition of the GradientBoosting class, which learns an ensemble of
+ * histogram-based regression trees by gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "feature_binner.hpp"
+#include "regression_tree.hpp"
+#include "squared_error_loss.hpp"
+#include "absolute_error_loss.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Gradient boosted regression trees.  The model starts from the constant that
+ * minimizes the loss, and each tree is fit (with the MSE gain) to the negative
+ * gradient of the loss at the current predictions; the value of each leaf is
+ * then set by the loss, and shrunk by the learning rate.  The features are
+ * binned once into at most 256 quantile bins, so the splits are found with
+ * histograms, in parallel over the features.
+ *
+ * Each tree can be learned on a random subset of the points (stochastic
+ * gradient boosting) and of the features.  The random subsets are drawn with
+ * math::randGen, so math::RandomSeed() makes the training reproducible.
+ *
+ * @code
+ * GradientBoosting gb;
+ * gb.Train<SquaredErrorLoss>(data, responses, 100, 0.1);
+ *
+ * arma::rowvec predictions;
+ * gb.Predict(testData, predictions);
+ * @endcode
+ */
+class GradientBoosting
+{
+ public:
+  //! Create an empty model, which predicts 0.
+  GradientBoosting();
+
+  /**
+   * Learn the model on the given data and responses.
+   *
+   * @tparam LossType Loss to minimize, such as SquaredErrorLoss or
+   *     AbsoluteErrorLoss.
+   * @param data Dataset to learn on (one column per point).
+   * @param responses Response of each point.
+   * @param numTrees Number of trees to learn.
+   * @param learningRate Shrinkage of the values of the leaves.
+   * @param maxDepth Maximum depth of each tree.
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param subsample Fraction of the points that each tree is learned on.
+   * @param featureSubsample Fraction of the features that each tree can use.
+   * @param numBins Maximum number of bins of each feature (2 to 256).
+   */
+  template<typename LossType = SquaredErrorLoss>
+  void Train(const arma::mat& data,
+             const arma::rowvec& responses,
+             const size_t numTrees = 100,
+             const double learningRate = 0.1,
+             const size_t maxDepth = 6,
+             const size_t minimumLeafSize = 20,
+             const double subsample = 1.0,
+             const double featureSubsample = 1.0,
+             const size_t numBins = 256);
+
+  /**
+   * Predict the responses of the given points.
+   *
+   * @param data Points to predict (one column per point).
+   * @param predictions Vector to store the predictions in.
+   */
+  void Predict(const arma::mat& data, arma::rowvec& predictions) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return trees.size(); }
+  //! Get the given tree.
+  const RegressionTree<>& Tree(const size_t i) const { return trees[i]; }
+  //! Get the initial value of the predictions.
+  double InitialValue() const { return initialValue; }
+  //! Get the dimensionality of the model.
+  size_t Dimensionality() const { return binner.Dimensionality(); }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(binner);
+    ar & BOOST_SERIALIZATION_NVP(initialValue);
+    ar & BOOST_SERIALIZATION_NVP(trees);
+  }
+
+ private:
+  //! The binner of the features.
+  FeatureBinner binner;
+  //! The initial value of the predictions.
+  double initialValue;
+  //! The trees; the values of their leaves are already shrunk.
+  std::vector<RegressionTree<>> trees;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "gradient_boosting_impl.hpp"
+
+#endif
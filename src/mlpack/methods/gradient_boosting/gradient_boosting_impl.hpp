@@ -0,0 +1,139 @@
+/**
+ * @file gradient_boosting_impl.hpp
+ *
+ * Implementation of the templated training of the GradientBoosting class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_GRADIENT_BOOSTING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "gradient_boosting.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace tree {
+
+template<typename LossType>
+void GradientBoosting::Train(const arma::mat& data,
+                             const arma::rowvec& responses,
+                             const size_t numTrees,
+                             const double learningRate,
+                             const size_t maxDepth,
+                             const size_t minimumLeafSize,
+                             const double subsample,
+                             const double featureSubsample,
+                             const size_t numBins)
+{
+  if (responses.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): number of responses ("
+        << responses.n_elem << ") does not match number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (data.n_cols == 0)
+    throw std::invalid_argument("GradientBoosting::Train(): no points given");
+  if (learningRate <= 0.0)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): learning rate must be positive (given "
+        << learningRate << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  if (subsample <= 0.0 || subsample > 1.0 || featureSubsample <= 0.0 ||
+      featureSubsample > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "GradientBoosting::Train(): subsample fractions must be in (0, 1] "
+        << "(given " << subsample << " and " << featureSubsample << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  binner.Train(data, numBins);
+  arma::Mat<unsigned char> bins;
+  binner.Bin(data, bins);
+
+  initialValue = LossType::InitialValue(responses);
+  trees.clear();
+  trees.resize(numTrees);
+
+  arma::rowvec predictions(data.n_cols);
+  predictions.fill(initialValue);
+  arma::rowvec gradient;
+
+  std::vector<size_t> allPoints(data.n_cols), allFeatures(data.n_rows);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    allPoints[i] = i;
+  for (size_t d = 0; d < data.n_rows; ++d)
+    allFeatures[d] = d;
+
+  const size_t numPoints = std::max((size_t) 1,
+      (size_t) (subsample * data.n_cols));
+  const size_t numFeatures = std::max((size_t) 1,
+      (size_t) (featureSubsample * data.n_rows));
+
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    LossType::NegativeGradient(responses, predictions, gradient);
+
+    // Draw the points and features of this tree.  The points are sorted again
+    // so that the histograms are accumulated in order.
+    std::vector<size_t> points(allPoints), features(allFeatures);
+    if (numPoints < data.n_cols)
+    {
+      std::shuffle(points.begin(), points.end(), math::randGen);
+      points.resize(numPoints);
+      std::sort(points.begin(), points.end());
+    }
+    if (numFeatures < data.n_rows)
+    {
+      std::shuffle(features.begin(), features.end(), math::randGen);
+      features.resize(numFeatures);
+      std::sort(features.begin(), features.end());
+    }
+
+    RegressionTree<>& tree = trees[t];
+    tree.Train(bins, binner, gradient, points, features, maxDepth,
+        minimumLeafSize);
+
+    // Set the value of each leaf from the residuals of its points.
+    std::vector<std::vector<double>> residuals(tree.NumNodes());
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const size_t p = points[i];
+      residuals[tree.Leaf(bins, p)].push_back(responses[p] - predictions[p]);
+    }
+
+    for (size_t n = 0; n < tree.NumNodes(); ++n)
+    {
+      if (tree.IsLeaf(n) && !residuals[n].empty())
+      {
+        tree.Value(n) = learningRate *
+            LossType::LeafValue(arma::rowvec(residuals[n]));
+      }
+    }
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+      predictions[i] += tree.Value(tree.Leaf(bins, i));
+
+    Log::Debug << "GradientBoosting::Train(): tree " << t << ", training loss "
+        << LossType::Evaluate(responses, predictions) << "." << std::endl;
+  }
+
+  Log::Info << "GradientBoosting::Train(): trained " << numTrees << " trees; "
+      << "training loss " << LossType::Evaluate(responses, predictions) << "."
+      << std::endl;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
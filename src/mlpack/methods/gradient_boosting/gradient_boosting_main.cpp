@@ -0,0 +1,208 @@
+/**
+ * @file gradient_boosting_main.cpp
+ *
+ * A program to train gradient boosted regression trees and predict with them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "gradient_boosting.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("Gradient Boosted Regression Trees",
+    // Short description.
+    "An implementation of gradient boosting with histogram-based regression "
+    "trees.  Given a dataset and responses, a model can be trained and saved "
+    "for later use, or a pre-trained model can be used to predict the "
+    "responses of a test set.",
+    // Long description.
+    "This program trains an ensemble of regression trees by gradient boosting:"
+    " each tree is fit to the negative gradient of the loss at the "
+    "predictions of the previous trees, and its leaf values are shrunk by the "
+    "learning rate (" + PRINT_PARAM_STRING("learning_rate") + ").  The loss "
+    "can be 'squared' (squared error) or 'absolute' (absolute error, which is "
+    "less sensitive to outliers), and is specified with the " +
+    PRINT_PARAM_STRING("loss") + " parameter."
+    "\n\n"
+    "Each feature is binned into at most " + PRINT_PARAM_STRING("bins") +
+    " quantile bins, so that the splits of the trees are found with "
+    "histograms, in parallel over the features.  Each tree can be trained on "
+    "a random fraction of the points (" + PRINT_PARAM_STRING("subsample") +
+    ") and of the features (" + PRINT_PARAM_STRING("feature_subsample") + ")."
+    "\n\n"
+    "The training set and responses are given with the " +
+    PRINT_PARAM_STRING("training") + " and " +
+    PRINT_PARAM_STRING("training_responses") + " parameters, and the model "
+    "may be saved with " + PRINT_PARAM_STRING("output_model") + ".  The "
+    "responses of a test set (" + PRINT_PARAM_STRING("test") + ") are saved "
+    "with " + PRINT_PARAM_STRING("output_predictions") + "."
+    "\n\n"
+    "For example, to train 200 trees of depth 4 on the dataset " +
+    PRINT_DATASET("X") + " with responses " + PRINT_DATASET("y") + ", saving "
+    "the model to " + PRINT_MODEL("gb_model") + ", the following command "
+    "could be used:"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "training", "X", "training_responses", "y",
+        "num_trees", 200, "max_depth", 4, "output_model", "gb_model") +
+    "\n\n"
+    "Then, to predict the responses of the points in " +
+    PRINT_DATASET("X_test") + " with that model, saving them to " +
+    PRINT_DATASET("y_test") + ", the following command could be used:"
+    "\n\n" +
+    PRINT_CALL("gradient_boosting", "input_model", "gb_model", "test",
+        "X_test", "output_predictions", "y_test"),
+    SEE_ALSO("@decision_tree", "#decision_tree"),
+    SEE_ALSO("@random_forest", "#random_forest"),
+    SEE_ALSO("Gradient boosting on Wikipedia",
+        "https://en.wikipedia.org/wiki/Gradient_boosting"),
+    SEE_ALSO("mlpack::tree::GradientBoosting C++ class documentation",
+        "@doxygen/classmlpack_1_1tree_1_1GradientBoosting.html"));
+
+PARAM_MATRIX_IN("training", "Matrix containing the training set.", "t");
+PARAM_ROW_IN("training_responses", "Responses of the training set.", "r");
+
+PARAM_MODEL_IN(GradientBoosting, "input_model", "Pre-trained gradient boosting "
+    "model.", "m");
+PARAM_MODEL_OUT(GradientBoosting, "output_model", "Output gradient boosting "
+    "model.", "M");
+
+PARAM_MATRIX_IN("test", "Matrix containing the test set.", "T");
+PARAM_ROW_OUT("output_predictions", "Predicted responses of the test set.",
+    "o");
+
+PARAM_STRING_IN("loss", "Loss to minimize: 'squared' or 'absolute'.", "l",
+    "squared");
+PARAM_INT_IN("num_trees", "Number of trees.", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Learning rate (shrinkage of each tree).",
+    "a", 0.1);
+PARAM_INT_IN("max_depth", "Maximum depth of each tree.", "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf.",
+    "n", 20);
+PARAM_DOUBLE_IN("subsample", "Fraction of the points that each tree is "
+    "trained on.", "s", 1.0);
+PARAM_DOUBLE_IN("feature_subsample", "Fraction of the features that each tree"
+    " can use.", "f", 1.0);
+PARAM_INT_IN("bins", "Maximum number of bins of each feature (2 to 256).", "b",
+    256);
+PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "S", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") == 0)
+    math::RandomSeed(std::time(NULL));
+  else
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+
+  RequireOnlyOnePassed({ "training", "input_model" }, true);
+
+  if (CLI::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "training_responses" }, true, "must pass "
+        "responses when a training set is given");
+  }
+
+  RequireAtLeastOnePassed({ "output_model", "output_predictions" }, false,
+      "no output will be saved");
+  ReportIgnoredParam({{ "test", false }}, "output_predictions");
+
+  const vector<string> trainingParams = { "loss", "num_trees", "learning_rate",
+      "max_depth", "minimum_leaf_size", "subsample", "feature_subsample",
+      "bins" };
+  for (size_t i = 0; i < trainingParams.size(); ++i)
+    ReportIgnoredParam({{ "training", false }}, trainingParams[i]);
+
+  RequireParamInSet<string>("loss", { "squared", "absolute" }, true,
+      "unknown loss");
+  RequireParamValue<int>("num_trees", [](int x) { return x > 0; }, true,
+      "number of trees must be positive");
+  RequireParamValue<double>("learning_rate", [](double x) { return x > 0.0; },
+      true, "learning rate must be positive");
+  RequireParamValue<int>("max_depth", [](int x) { return x >= 0; }, true,
+      "maximum depth must be non-negative");
+  RequireParamValue<int>("minimum_leaf_size", [](int x) { return x > 0; },
+      true, "minimum leaf size must be positive");
+  RequireParamValue<double>("subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "subsample must be in (0, 1]");
+  RequireParamValue<double>("feature_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "feature subsample must be in (0, 1]");
+  RequireParamValue<int>("bins", [](int x) { return x >= 2 && x <= 256; },
+      true, "number of bins must be between 2 and 256");
+
+  GradientBoosting* model;
+  if (CLI::HasParam("training"))
+  {
+    arma::mat data = std::move(CLI::GetParam<arma::mat>("training"));
+    arma::rowvec responses =
+        std::move(CLI::GetParam<arma::rowvec>("training_responses"));
+
+    if (responses.n_elem != data.n_cols)
+    {
+      Log::Fatal << "The number of responses (" << responses.n_elem << ") must"
+          << " match the number of training points (" << data.n_cols << ")!"
+          << endl;
+    }
+
+    const size_t numTrees = (size_t) CLI::GetParam<int>("num_trees");
+    const double learningRate = CLI::GetParam<double>("learning_rate");
+    const size_t maxDepth = (size_t) CLI::GetParam<int>("max_depth");
+    const size_t minimumLeafSize =
+        (size_t) CLI::GetParam<int>("minimum_leaf_size");
+    const double subsample = CLI::GetParam<double>("subsample");
+    const double featureSubsample = CLI::GetParam<double>("feature_subsample");
+    const size_t numBins = (size_t) CLI::GetParam<int>("bins");
+
+    model = new GradientBoosting();
+
+    Timer::Start("training");
+    if (CLI::GetParam<string>("loss") == "squared")
+    {
+      model->Train<SquaredErrorLoss>(data, responses, numTrees, learningRate,
+          maxDepth, minimumLeafSize, subsample, featureSubsample, numBins);
+    }
+    else
+    {
+      model->Train<AbsoluteErrorLoss>(data, responses, numTrees, learningRate,
+          maxDepth, minimumLeafSize, subsample, featureSubsample, numBins);
+    }
+    Timer::Stop("training");
+  }
+  else
+  {
+    model = CLI::GetParam<GradientBoosting*>("input_model");
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    arma::mat testData = std::move(CLI::GetParam<arma::mat>("test"));
+    if (testData.n_rows != model->Dimensionality())
+    {
+      const size_t dimensionality = model->Dimensionality();
+      if (CLI::HasParam("training"))
+        delete model;
+
+      Log::Fatal << "The model was trained on " << dimensionality
+          << "-dimensional data, but the test points are " << testData.n_rows
+          << "-dimensional!" << endl;
+    }
+
+    arma::rowvec predictions;
+    Timer::Start("prediction");
+    model->Predict(testData, predictions);
+    Timer::Stop("prediction");
+
+    CLI::GetParam<arma::rowvec>("output_predictions") = std::move(predictions);
+  }
+
+  CLI::GetParam<GradientBoosting*>("output_model") = model;
+}
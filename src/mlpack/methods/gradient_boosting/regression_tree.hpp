@@ -0,0 +1,148 @@
+/**
+ * @file regression_tree.hpp
+ *
+ * Definition of the RegressionTree class, a histogram-based regression tree
+ * used as the weak learner of gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_REGRESSION_TREE_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_REGRESSION_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/mse_gain.hpp>
+#include "feature_binner.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A binary regression tree that is learned on a dataset binned by a
+ * FeatureBinner.  The split of each node is found by accumulating, in parallel
+ * over the features, the sums of the targets of each bin, and evaluating only
+ * the splits between bins, so a node takes O(n + bins) time per feature
+ * without any sorting.  The value of each leaf is the mean target of its
+ * points, but it can be changed with Value() (gradient boosting sets it from
+ * the loss).
+ *
+ * Once learned, the tree predicts from unbinned points: the split of bin b of
+ * feature d is the split value <= binner.UpperEdge(d, b).
+ *
+ * @tparam FitnessFunction Fitness function with a static EvaluateSums(sum,
+ *     sumSquares, total) function, like MSEGain.
+ */
+template<typename FitnessFunction = MSEGain>
+class RegressionTree
+{
+ public:
+  //! Create an empty tree, which predicts 0.
+  RegressionTree();
+
+  /**
+   * Learn the tree on the given points of a binned dataset.
+   *
+   * @param bins Binned dataset (one row per point, one column per feature).
+   * @param binner Binner that binned the dataset.
+   * @param targets Target of each point of the dataset.
+   * @param points Indices of the points to learn on.
+   * @param features Features that the splits can use.
+   * @param maxDepth Maximum depth of the tree (0 means a single leaf).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum gain of a split.
+   */
+  void Train(const arma::Mat<unsigned char>& bins,
+             const FeatureBinner& binner,
+             const arma::rowvec& targets,
+             std::vector<size_t> points,
+             const std::vector<size_t>& features,
+             const size_t maxDepth = 6,
+             const size_t minimumLeafSize = 20,
+             const double minimumGainSplit = 1e-7);
+
+  //! Predict the response of the given (unbinned) point.
+  template<typename VecType>
+  double Predict(const VecType& point) const
+  {
+    return value[Leaf(point)];
+  }
+
+  //! Get the index of the leaf of the given (unbinned) point.
+  template<typename VecType>
+  size_t Leaf(const VecType& point) const
+  {
+    size_t node = 0;
+    while (feature[node] != size_t(-1))
+      node = (point[feature[node]] <= threshold[node]) ? left[node] :
+          right[node];
+    return node;
+  }
+
+  //! Get the index of the leaf of the given point of a binned dataset.
+  size_t Leaf(const arma::Mat<unsigned char>& bins, const size_t point) const
+  {
+    size_t node = 0;
+    while (feature[node] != size_t(-1))
+      node = (bins(point, feature[node]) <= splitBin[node]) ? left[node] :
+          right[node];
+    return node;
+  }
+
+  //! Get the number of nodes.
+  size_t NumNodes() const { return feature.size(); }
+  //! Get whether the given node is a leaf.
+  bool IsLeaf(const size_t node) const
+  {
+    return feature[node] == size_t(-1);
+  }
+  //! Get the feature that the given node splits on.
+  size_t SplitFeature(const size_t node) const { return feature[node]; }
+  //! Get the value of the given node.
+  double Value(const size_t node) const { return value[node]; }
+  //! Modify the value of the given node.
+  double& Value(const size_t node) { return value[node]; }
+
+  //! Serialize the tree.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Build the node for points[begin, end), and its children, and return its
+   * index.
+   */
+  size_t Build(const arma::Mat<unsigned char>& bins,
+               const FeatureBinner& binner,
+               const arma::rowvec& targets,
+               std::vector<size_t>& points,
+               const size_t begin,
+               const size_t end,
+               const std::vector<size_t>& features,
+               const size_t depth,
+               const size_t maxDepth,
+               const size_t minimumLeafSize,
+               const double minimumGainSplit);
+
+  //! The feature of the split of each node (size_t(-1) for leaves).
+  std::vector<size_t> feature;
+  //! The bin of the split of each node; smaller or equal bins go left.
+  std::vector<unsigned char> splitBin;
+  //! The value of the split of each node; smaller or equal values go left.
+  std::vector<double> threshold;
+  //! The left child of each node.
+  std::vector<size_t> left;
+  //! The right child of each node.
+  std::vector<size_t> right;
+  //! The value of each node.
+  std::vector<double> value;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "regression_tree_impl.hpp"
+
+#endif
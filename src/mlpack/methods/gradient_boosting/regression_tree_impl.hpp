@@ -0,0 +1,195 @@
+/**
+ * @file regression_tree_impl.hpp
+ *
+ * Implementation of the RegressionTree class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_REGRESSION_TREE_IMPL_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_REGRESSION_TREE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "regression_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+RegressionTree<FitnessFunction>::RegressionTree() :
+    feature(1, size_t(-1)),
+    splitBin(1, 0),
+    threshold(1, 0.0),
+    left(1, 0),
+    right(1, 0),
+    value(1, 0.0)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction>
+void RegressionTree<FitnessFunction>::Train(
+    const arma::Mat<unsigned char>& bins,
+    const FeatureBinner& binner,
+    const arma::rowvec& targets,
+    std::vector<size_t> points,
+    const std::vector<size_t>& features,
+    const size_t maxDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  if (points.empty())
+    throw std::invalid_argument("RegressionTree::Train(): no points given");
+
+  feature.clear();
+  splitBin.clear();
+  threshold.clear();
+  left.clear();
+  right.clear();
+  value.clear();
+
+  Build(bins, binner, targets, points, 0, points.size(), features, 0,
+      maxDepth, std::max(minimumLeafSize, (size_t) 1), minimumGainSplit);
+}
+
+template<typename FitnessFunction>
+size_t RegressionTree<FitnessFunction>::Build(
+    const arma::Mat<unsigned char>& bins,
+    const FeatureBinner& binner,
+    const arma::rowvec& targets,
+    std::vector<size_t>& points,
+    const size_t begin,
+    const size_t end,
+    const std::vector<size_t>& features,
+    const size_t depth,
+    const size_t maxDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit)
+{
+  const size_t count = end - begin;
+  double sum = 0.0, sumSquares = 0.0;
+  for (size_t i = begin; i < end; ++i)
+  {
+    sum += targets[points[i]];
+    sumSquares += targets[points[i]] * targets[points[i]];
+  }
+
+  // Start as a leaf.
+  const size_t node = feature.size();
+  feature.push_back(size_t(-1));
+  splitBin.push_back(0);
+  threshold.push_back(0.0);
+  left.push_back(0);
+  right.push_back(0);
+  value.push_back(sum / count);
+
+  if (depth >= maxDepth || count < 2 * minimumLeafSize)
+    return node;
+
+  // The gain of a split is the decrease of the total error of the node.
+  const double parentGain = count *
+      FitnessFunction::EvaluateSums(sum, sumSquares, count);
+
+  // Find the best split of each feature; small nodes are not worth the
+  // threads.
+  std::vector<double> bestGains(features.size(), minimumGainSplit);
+  std::vector<size_t> bestBins(features.size(), size_t(-1));
+
+  #pragma omp parallel for schedule(dynamic) \
+      if (count * features.size() > 16384)
+  for (omp_size_t f = 0; f < (omp_size_t) features.size(); ++f)
+  {
+    const size_t d = features[f];
+    const size_t numBins = binner.NumBins(d);
+    if (numBins < 2)
+      continue;
+
+    std::vector<double> binSums(numBins, 0.0), binSquares(numBins, 0.0);
+    std::vector<size_t> binCounts(numBins, 0);
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t b = bins(points[i], d);
+      const double t = targets[points[i]];
+      binSums[b] += t;
+      binSquares[b] += t * t;
+      ++binCounts[b];
+    }
+
+    double leftSum = 0.0, leftSquares = 0.0;
+    size_t leftCount = 0;
+    for (size_t b = 0; b + 1 < numBins; ++b)
+    {
+      leftSum += binSums[b];
+      leftSquares += binSquares[b];
+      leftCount += binCounts[b];
+
+      if (leftCount < minimumLeafSize)
+        continue;
+      const size_t rightCount = count - leftCount;
+      if (rightCount < minimumLeafSize)
+        break;
+
+      const double gain = leftCount * FitnessFunction::EvaluateSums(leftSum,
+          leftSquares, leftCount) + rightCount * FitnessFunction::EvaluateSums(
+          sum - leftSum, sumSquares - leftSquares, rightCount) - parentGain;
+      if (gain > bestGains[f])
+      {
+        bestGains[f] = gain;
+        bestBins[f] = b;
+      }
+    }
+  }
+
+  // Ties are broken by the order of the features, so the tree doesn't depend
+  // on the number of threads.
+  size_t best = features.size();
+  for (size_t f = 0; f < features.size(); ++f)
+  {
+    if (bestBins[f] != size_t(-1) &&
+        (best == features.size() || bestGains[f] > bestGains[best]))
+      best = f;
+  }
+
+  if (best == features.size())
+    return node;
+
+  const size_t d = features[best];
+  const size_t b = bestBins[best];
+  const size_t middle = std::partition(points.begin() + begin,
+      points.begin() + end, [&](const size_t p) { return bins(p, d) <= b; }) -
+      points.begin();
+
+  const size_t leftChild = Build(bins, binner, targets, points, begin, middle,
+      features, depth + 1, maxDepth, minimumLeafSize, minimumGainSplit);
+  const size_t rightChild = Build(bins, binner, targets, points, middle, end,
+      features, depth + 1, maxDepth, minimumLeafSize, minimumGainSplit);
+
+  feature[node] = d;
+  splitBin[node] = (unsigned char) b;
+  threshold[node] = binner.UpperEdge(d, b);
+  left[node] = leftChild;
+  right[node] = rightChild;
+
+  return node;
+}
+
+template<typename FitnessFunction>
+template<typename Archive>
+void RegressionTree<FitnessFunction>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(feature);
+  ar & BOOST_SERIALIZATION_NVP(splitBin);
+  ar & BOOST_SERIALIZATION_NVP(threshold);
+  ar & BOOST_SERIALIZATION_NVP(left);
+  ar & BOOST_SERIALIZATION_NVP(right);
+  ar & BOOST_SERIALIZATION_NVP(value);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
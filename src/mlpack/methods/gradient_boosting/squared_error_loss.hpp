@@ -0,0 +1,58 @@
+/**
+ * @file squared_error_loss.hpp
+ *
+ * The squared error loss for gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GRADIENT_BOOSTING_SQUARED_ERROR_LOSS_HPP
+#define MLPACK_METHODS_GRADIENT_BOOSTING_SQUARED_ERROR_LOSS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The squared error loss, (y - f)^2 / 2.  Its negative gradient is the
+ * residual y - f, and the best value of a leaf is the mean of the residuals of
+ * its points, so boosting with this loss fits each tree to the residuals.
+ */
+class SquaredErrorLoss
+{
+ public:
+  //! Get the constant that minimizes the loss: the mean of the responses.
+  static double InitialValue(const arma::rowvec& responses)
+  {
+    return arma::mean(responses);
+  }
+
+  //! Compute the negative gradient of the loss: the residuals.
+  static void NegativeGradient(const arma::rowvec& responses,
+                               const arma::rowvec& predictions,
+                               arma::rowvec& gradient)
+  {
+    gradient = responses - predictions;
+  }
+
+  //! Get the best value of a leaf from the residuals of its points.
+  static double LeafValue(const arma::rowvec& residuals)
+  {
+    return arma::mean(residuals);
+  }
+
+  //! Evaluate the mean loss of the given predictions.
+  static double Evaluate(const arma::rowvec& responses,
+                         const arma::rowvec& predictions)
+  {
+    return 0.5 * arma::mean(arma::square(responses - predictions));
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,300 @@
+/**
+ * @file condensed_tree.hpp
+ *
+ * The condensed cluster tree of HDBSCAN, computed from a single-linkage
+ * dendrogram, and the extraction of the most stable clusters from it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_CONDENSED_TREE_HPP
+#define MLPACK_METHODS_HDBSCAN_CONDENSED_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace hdbscan {
+
+/**
+ * The CondensedTree class simplifies a single-linkage dendrogram (given as a
+ * linkage matrix, like the one of emst::Dendrogram) by only keeping the splits
+ * of a cluster into two clusters of at least minClusterSize points each; when
+ * a smaller part splits off a cluster, its points are said to fall out of the
+ * cluster, and the cluster keeps going on as the same cluster.
+ *
+ * The tree is stored as a 4 x m matrix, in the same format as the condensed
+ * trees of the Python hdbscan package: each column holds a parent cluster, a
+ * child (a point if it is less than the number of points n, otherwise a
+ * cluster), the value of lambda = 1 / distance at which the child split off the
+ * parent, and the number of points of the child.  The root cluster is n, and
+ * the other clusters are numbered n + 1, n + 2, ... so that children follow
+ * their parents.
+ *
+ * The clusters are then selected by their stability, the sum over their points
+ * of the range of lambda in which a point belongs to the cluster: a cluster is
+ * selected if it is more stable than the selected clusters below it together
+ * (the excess of mass method).  The root is never selected.  For more
+ * information, see the following paper.
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data Mining},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ */
+class CondensedTree
+{
+ public:
+  /**
+   * Condense the given single-linkage dendrogram.
+   *
+   * @param linkage The linkage matrix of the dendrogram (4 x (n - 1), with the
+   *      merges by increasing distance), as given by emst::Dendrogram.
+   * @param minClusterSize The smallest number of points in a cluster.
+   */
+  CondensedTree(const arma::mat& linkage, const size_t minClusterSize) :
+      numPoints(linkage.n_cols + 1),
+      minClusterSize(minClusterSize)
+  {
+    if (minClusterSize < 2)
+    {
+      std::ostringstream oss;
+      oss << "CondensedTree::CondensedTree(): minClusterSize must be at least "
+          << "2 (" << minClusterSize << " given)!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    Condense(linkage);
+    ComputeStabilities();
+  }
+
+  /**
+   * Select the most stable clusters, and assign each point to the selected
+   * cluster it belongs to.  Points that are in no selected cluster are noise,
+   * and are assigned SIZE_MAX.  The clusters are numbered from 0 in the order
+   * of the condensed tree.
+   *
+   * @param assignments The cluster of each point.
+   * @return The number of clusters.
+   */
+  size_t ExtractClusters(arma::Row<size_t>& assignments) const
+  {
+    const size_t numClusters = stabilities.n_elem;
+
+    // Go from the leaves to the root (children have larger indices than their
+    // parents), comparing each cluster with the best selection below it.
+    arma::vec bestStabilities = stabilities;
+    arma::vec childStabilities(numClusters, arma::fill::zeros);
+    std::vector<bool> selected(numClusters, false);
+    for (size_t c = numClusters - 1; c > 0; --c)
+    {
+      if (childStabilities[c] > stabilities[c])
+        bestStabilities[c] = childStabilities[c];
+      else
+        selected[c] = true;
+
+      childStabilities[parents[c]] += bestStabilities[c];
+    }
+
+    // A cluster is only kept if no cluster above it is selected; go from the
+    // root to the leaves to find the selected cluster that holds each one.
+    std::vector<size_t> labels(numClusters, SIZE_MAX);
+    size_t numSelected = 0;
+    for (size_t c = 1; c < numClusters; ++c)
+    {
+      if (labels[parents[c]] != SIZE_MAX)
+        labels[c] = labels[parents[c]];
+      else if (selected[c])
+        labels[c] = numSelected++;
+    }
+
+    assignments.set_size(numPoints);
+    for (size_t i = 0; i < numPoints; ++i)
+      assignments[i] = labels[pointClusters[i]];
+
+    return numSelected;
+  }
+
+  //! Get the condensed tree, as a 4 x m matrix (see the class documentation).
+  const arma::mat& Tree() const { return tree; }
+
+  //! Get the stability of each cluster (the root is cluster 0 here).
+  const arma::vec& Stabilities() const { return stabilities; }
+
+  //! Get the number of clusters of the condensed tree, including the root.
+  size_t NumClusters() const { return stabilities.n_elem; }
+
+  //! Get the number of points.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the smallest number of points in a cluster.
+  size_t MinClusterSize() const { return minClusterSize; }
+
+ private:
+  //! Get the lambda value of the given distance.
+  static double Lambda(const double distance)
+  {
+    return (distance > 0.0) ? 1.0 / distance : DBL_MAX;
+  }
+
+  //! Get the number of points of the given cluster of the linkage matrix.
+  size_t Size(const arma::mat& linkage, const size_t node) const
+  {
+    return (node < numPoints) ? 1 : (size_t) linkage(3, node - numPoints);
+  }
+
+  //! Add a column to the tree.
+  void AddEntry(const size_t parent,
+                const size_t child,
+                const double lambda,
+                const size_t size)
+  {
+    entries.push_back(parent);
+    entries.push_back(child);
+    entries.push_back(lambda);
+    entries.push_back(size);
+  }
+
+  //! Let all the points below the given node of the linkage matrix fall out of
+  //! the given cluster at the given lambda.
+  void FallOut(const arma::mat& linkage,
+               const size_t node,
+               const size_t cluster,
+               const double lambda,
+               std::vector<bool>& ignored)
+  {
+    std::vector<size_t> stack(1, node);
+    while (!stack.empty())
+    {
+      const size_t n = stack.back();
+      stack.pop_back();
+      if (n < numPoints)
+      {
+        AddEntry(cluster, n, lambda, 1);
+        pointClusters[n] = cluster - numPoints;
+        continue;
+      }
+
+      ignored[n - numPoints] = true;
+      stack.push_back((size_t) linkage(0, n - numPoints));
+      stack.push_back((size_t) linkage(1, n - numPoints));
+    }
+  }
+
+  //! Compute the condensed tree from the linkage matrix.
+  void Condense(const arma::mat& linkage)
+  {
+    pointClusters.set_size(numPoints);
+    parents.clear();
+    birthLambdas.clear();
+
+    // The root cluster.
+    parents.push_back(0);
+    birthLambdas.push_back(0.0);
+    if (numPoints == 1)
+    {
+      pointClusters[0] = 0;
+      tree.set_size(4, 0);
+      return;
+    }
+
+    // The condensed cluster of each node of the linkage matrix, and whether
+    // the points of the node already fell out of a cluster.
+    std::vector<size_t> nodeClusters(numPoints - 1, 0);
+    std::vector<bool> ignored(numPoints - 1, false);
+
+    // The parents of the merges follow them in the linkage matrix, so going
+    // backwards visits each node after its parent.
+    for (size_t i = numPoints - 1; i > 0; --i)
+    {
+      const size_t node = i - 1;
+      if (ignored[node])
+        continue;
+
+      const size_t cluster = numPoints + nodeClusters[node];
+      const size_t left = (size_t) linkage(0, node);
+      const size_t right = (size_t) linkage(1, node);
+      const double lambda = Lambda(linkage(2, node));
+      const size_t leftSize = Size(linkage, left);
+      const size_t rightSize = Size(linkage, right);
+
+      const bool leftIsCluster = (leftSize >= minClusterSize);
+      const bool rightIsCluster = (rightSize >= minClusterSize);
+      if (leftIsCluster && rightIsCluster)
+      {
+        // A real split: both children are new clusters.
+        const size_t children[2] = { left, right };
+        for (size_t j = 0; j < 2; ++j)
+        {
+          const size_t child = parents.size();
+          parents.push_back(cluster - numPoints);
+          birthLambdas.push_back(lambda);
+          AddEntry(cluster, numPoints + child, lambda,
+              Size(linkage, children[j]));
+
+          // Since minClusterSize is at least 2, the children are merges.
+          nodeClusters[children[j] - numPoints] = child;
+        }
+      }
+      else
+      {
+        // The small children fall out of the cluster, and a large child (if
+        // any) continues as the same cluster.
+        if (!leftIsCluster)
+          FallOut(linkage, left, cluster, lambda, ignored);
+        else if (left >= numPoints)
+          nodeClusters[left - numPoints] = nodeClusters[node];
+
+        if (!rightIsCluster)
+          FallOut(linkage, right, cluster, lambda, ignored);
+        else if (right >= numPoints)
+          nodeClusters[right - numPoints] = nodeClusters[node];
+      }
+    }
+
+    tree = arma::mat(entries.data(), 4, entries.size() / 4);
+    std::vector<double>().swap(entries);
+  }
+
+  //! Compute the stability of each cluster from the condensed tree.
+  void ComputeStabilities()
+  {
+    stabilities.zeros(parents.size());
+    for (size_t i = 0; i < tree.n_cols; ++i)
+    {
+      const size_t parent = (size_t) tree(0, i) - numPoints;
+      stabilities[parent] += (tree(2, i) - birthLambdas[parent]) * tree(3, i);
+    }
+  }
+
+  //! The number of points.
+  size_t numPoints;
+  //! The smallest number of points in a cluster.
+  size_t minClusterSize;
+
+  //! The condensed tree.
+  arma::mat tree;
+  //! The columns of the tree while it is being built.
+  std::vector<double> entries;
+
+  //! The parent of each cluster (numbered from 0 here).
+  std::vector<size_t> parents;
+  //! The lambda at which each cluster was created.
+  std::vector<double> birthLambdas;
+  //! The stability of each cluster.
+  arma::vec stabilities;
+
+  //! The cluster that each point falls out of.
+  arma::Col<size_t> pointClusters;
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
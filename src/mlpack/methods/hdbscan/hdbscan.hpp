@@ -0,0 +1,143 @@
+/**
+ * @file hdbscan.hpp
+ *
+ * An implementation of the HDBSCAN clustering method, which uses the
+ * Dual-Tree Boruvka algorithm to find the minimum spanning tree of the mutual
+ * reachability graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/dendrogram.hpp>
+#include "condensed_tree.hpp"
+
+namespace mlpack {
+namespace hdbscan /** Hierarchical density-based clustering. */ {
+
+/**
+ * HDBSCAN (Hierarchical DBSCAN) is a clustering technique described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data Mining},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * The core distance of each point is the distance to its minPoints'th nearest
+ * neighbor (counting the point itself), and the mutual reachability distance
+ * of two points is the largest of their distance and their core distances.
+ * The clustering is done in one pass:
+ *
+ *  - the core distances are found with a NeighborSearch;
+ *  - the minimum spanning tree under the mutual reachability distance is found
+ *    with emst::DualTreeBoruvka;
+ *  - the single-linkage dendrogram of the tree is computed (emst::Dendrogram),
+ *    and condensed with the minimum cluster size (CondensedTree);
+ *  - the most stable clusters of the condensed tree are extracted.
+ *
+ * Unlike DBSCAN, no radius has to be chosen; clusters of different densities
+ * can be found.
+ *
+ * @tparam MetricType The metric to use.
+ * @tparam MatType The type of data matrix to use.
+ * @tparam TreeType Type of tree to use for the neighbor search and the minimum
+ *      spanning tree.
+ */
+template<
+    typename MetricType = metric::EuclideanDistance,
+    typename MatType = arma::mat,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType = tree::KDTree
+>
+class HDBSCAN
+{
+ public:
+  /**
+   * Construct the HDBSCAN object with the given parameters.
+   *
+   * @param minClusterSize Minimum number of points for each cluster (at least
+   *      2).
+   * @param minPoints Number of neighbors (counting the point itself) that
+   *      define the core distance of each point; if 0, minClusterSize is used.
+   * @param metric An optional instantiated metric to use.
+   */
+  HDBSCAN(const size_t minClusterSize = 5,
+          const size_t minPoints = 0,
+          const MetricType metric = MetricType());
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters
+   * and also the list of cluster assignments.  If assignments[i] == SIZE_MAX,
+   * then the point is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   */
+  size_t Cluster(const MatType& data, arma::Row<size_t>& assignments);
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters,
+   * the list of cluster assignments, and the condensed tree of the clustering
+   * (see CondensedTree for its format).  If assignments[i] == SIZE_MAX, then
+   * the point is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   * @param condensedTree Matrix to store the condensed tree.
+   */
+  size_t Cluster(const MatType& data,
+                 arma::Row<size_t>& assignments,
+                 arma::mat& condensedTree);
+
+  /**
+   * Compute the core distance of each point of the given dataset.
+   *
+   * @param data Dataset to compute the core distances of.
+   * @param coreDistances Vector to store the core distances.
+   */
+  void CoreDistances(const MatType& data, arma::vec& coreDistances) const;
+
+  //! Get the minimum number of points in a cluster.
+  size_t MinClusterSize() const { return minClusterSize; }
+  //! Modify the minimum number of points in a cluster.
+  size_t& MinClusterSize() { return minClusterSize; }
+
+  //! Get the number of neighbors that define the core distances (0 means
+  //! MinClusterSize()).
+  size_t MinPoints() const { return minPoints; }
+  //! Modify the number of neighbors that define the core distances (0 means
+  //! MinClusterSize()).
+  size_t& MinPoints() { return minPoints; }
+
+ private:
+  //! Minimum number of points in a cluster.
+  size_t minClusterSize;
+
+  //! Number of neighbors that define the core distances.
+  size_t minPoints;
+
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace hdbscan
+} // namespace mlpack
+
+// Include implementation.
+#include "hdbscan_impl.hpp"
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file hdbscan_impl.hpp
+ *
+ * Implementation of HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+
+#include "hdbscan.hpp"
+
+namespace mlpack {
+namespace hdbscan {
+
+/**
+ * Construct the HDBSCAN object with the given parameters.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+HDBSCAN<MetricType, MatType, TreeType>::HDBSCAN(const size_t minClusterSize,
+                                                const size_t minPoints,
+                                                const MetricType metric) :
+    minClusterSize(minClusterSize),
+    minPoints(minPoints),
+    metric(metric)
+{
+  // Nothing to do.
+}
+
+/**
+ * Compute the core distance of each point.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void HDBSCAN<MetricType, MatType, TreeType>::CoreDistances(
+    const MatType& data,
+    arma::vec& coreDistances) const
+{
+  // The point itself is its first neighbor, but the neighbor search does not
+  // return it.
+  const size_t k = ((minPoints == 0) ? minClusterSize : minPoints) - 1;
+  if (k >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::CoreDistances(): the core distances need " << k
+        << " neighbors of each point, but the dataset has only " << data.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k == 0)
+  {
+    coreDistances.zeros(data.n_cols);
+    return;
+  }
+
+  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
+      TreeType> knn(data, neighbor::DUAL_TREE_MODE, 0.0, metric);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(k, neighbors, distances);
+
+  coreDistances = distances.row(k - 1).t();
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters
+ * and also the list of cluster assignments.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, MatType, TreeType>::Cluster(
+    const MatType& data,
+    arma::Row<size_t>& assignments)
+{
+  arma::mat condensedTree;
+  return Cluster(data, assignments, condensedTree);
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters,
+ * the list of cluster assignments, and the condensed tree.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<MetricType, MatType, TreeType>::Cluster(
+    const MatType& data,
+    arma::Row<size_t>& assignments,
+    arma::mat& condensedTree)
+{
+  if (minClusterSize < 2)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::Cluster(): minClusterSize must be at least 2 ("
+        << minClusterSize << " given)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::vec coreDistances;
+  CoreDistances(data, coreDistances);
+
+  // The minimum spanning tree of the mutual reachability graph.
+  arma::mat mst;
+  {
+    emst::DualTreeBoruvka<MetricType, MatType, TreeType> dtb(data, false,
+        metric);
+    dtb.ComputeMST(mst, coreDistances);
+  }
+
+  const emst::Dendrogram dendrogram(mst);
+  const CondensedTree tree(dendrogram.Linkage(), minClusterSize);
+  condensedTree = tree.Tree();
+
+  const size_t numClusters = tree.ExtractClusters(assignments);
+  Log::Info << numClusters << " clusters found." << std::endl;
+
+  return numClusters;
+}
+
+} // namespace hdbscan
+} // namespace mlpack
+
+#endif
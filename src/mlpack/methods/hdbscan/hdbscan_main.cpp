@@ -0,0 +1,124 @@
+/**
+ * @file hdbscan_main.cpp
+ *
+ * Implementation of program to run HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include "hdbscan.hpp"
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("HDBSCAN clustering",
+    // Short description.
+    "An implementation of HDBSCAN clustering, a hierarchical version of DBSCAN "
+    "that does not need a search radius.  Given a dataset, this can compute "
+    "and return a clustering of that dataset.",
+    // Long description.
+    "This program implements the HDBSCAN algorithm for clustering.  The core "
+    "distance of each point (the distance to its k'th nearest neighbor) is "
+    "found with a tree-based neighbor search, then the minimum spanning tree of"
+    " the points under the mutual reachability distance is found with the "
+    "dual-tree Boruvka algorithm, and the most stable clusters of the "
+    "resulting hierarchy are extracted."
+    "\n\n"
+    "The input dataset to be clustered may be specified with the " +
+    PRINT_PARAM_STRING("input") + " parameter; the minimum number of points in"
+    " a cluster may be specified with the " +
+    PRINT_PARAM_STRING("min_cluster_size") + " parameter, and the number of "
+    "neighbors (counting the point itself) that define the core distances may "
+    "be specified with the " + PRINT_PARAM_STRING("min_points") + " parameter;"
+    " if it is 0, the minimum cluster size is used."
+    "\n\n"
+    "The " + PRINT_PARAM_STRING("assignments") + " output parameter contains "
+    "the cluster assignments of each point; noise points are assigned the "
+    "largest representable index.  The " +
+    PRINT_PARAM_STRING("condensed_tree") + " output parameter contains the "
+    "condensed cluster tree, with one column for each parent cluster, child "
+    "(point or cluster), lambda value (inverse distance) of the split, and "
+    "number of points of the child."
+    "\n\n"
+    "The type of tree may be chosen with the " +
+    PRINT_PARAM_STRING("tree_type") + " parameter: 'kd', 'cover', or 'ball'."
+    "\n\n"
+    "An example usage to run HDBSCAN on the dataset in " +
+    PRINT_DATASET("input") + " with a minimum cluster size of 10 is given "
+    "below:"
+    "\n\n" +
+    PRINT_CALL("hdbscan", "input", "input", "min_cluster_size", 10,
+        "assignments", "assignments"),
+    SEE_ALSO("@dbscan", "#dbscan"),
+    SEE_ALSO("@emst", "#emst"),
+    SEE_ALSO("Density-based clustering based on hierarchical density estimates",
+        "https://doi.org/10.1007/978-3-642-37456-2_14"),
+    SEE_ALSO("mlpack::hdbscan::HDBSCAN class documentation",
+        "@doxygen/classmlpack_1_1hdbscan_1_1HDBSCAN.html"));
+
+PARAM_MATRIX_IN_REQ("input", "Input dataset to cluster.", "i");
+PARAM_UROW_OUT("assignments", "Output matrix for assignments of each "
+    "point.", "a");
+PARAM_MATRIX_OUT("condensed_tree", "Matrix to save the condensed cluster tree "
+    "to.", "c");
+
+PARAM_INT_IN("min_cluster_size", "Minimum number of points for a cluster.", "m",
+    5);
+PARAM_INT_IN("min_points", "Number of neighbors (counting the point itself) "
+    "that define the core distance of each point; 0 means the minimum cluster "
+    "size.", "k", 0);
+PARAM_STRING_IN("tree_type", "The type of tree to use ('kd', 'cover', "
+    "'ball').", "t", "kd");
+
+// Actually run the clustering, and process the output.
+template<typename HDBSCANType>
+void RunHDBSCAN()
+{
+  arma::mat dataset = std::move(CLI::GetParam<arma::mat>("input"));
+  const size_t minClusterSize = (size_t) CLI::GetParam<int>("min_cluster_size");
+  const size_t minPoints = (size_t) CLI::GetParam<int>("min_points");
+
+  HDBSCANType h(minClusterSize, minPoints);
+
+  arma::Row<size_t> assignments;
+  arma::mat condensedTree;
+  h.Cluster(dataset, assignments, condensedTree);
+
+  if (CLI::HasParam("assignments"))
+    CLI::GetParam<arma::Row<size_t>>("assignments") = std::move(assignments);
+  if (CLI::HasParam("condensed_tree"))
+    CLI::GetParam<arma::mat>("condensed_tree") = std::move(condensedTree);
+}
+
+static void mlpackMain()
+{
+  RequireAtLeastOnePassed({ "assignments", "condensed_tree" }, false,
+      "no output will be saved");
+
+  RequireParamInSet<string>("tree_type", { "kd", "cover", "ball" }, true,
+      "unknown tree type");
+
+  RequireParamValue<int>("min_cluster_size", [](int x) { return x >= 2; },
+      true, "minimum cluster size must be at least 2");
+  RequireParamValue<int>("min_points", [](int x) { return x >= 0; },
+      true, "number of points must be non-negative");
+
+  const string treeType = CLI::GetParam<string>("tree_type");
+  if (treeType == "kd")
+    RunHDBSCAN<HDBSCAN<>>();
+  else if (treeType == "cover")
+    RunHDBSCAN<HDBSCAN<EuclideanDistance, arma::mat, StandardCoverTree>>();
+  else if (treeType == "ball")
+    RunHDBSCAN<HDBSCAN<EuclideanDistance, arma::mat, BallTree>>();
+}
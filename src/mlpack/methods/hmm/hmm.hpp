@@ -20,6 +20,30 @@
 namespace mlpack {
 namespace hmm /** Hidden Markov Models. */ {
 
+// This gives us a HasLogProbabilityCheck<T, U> type (where U is a function
+// pointer) we can use with SFINAE to find out whether a distribution has a
+// given LogProbability() function.
+HAS_EXACT_METHOD_FORM(LogProbability, HasLogProbabilityCheck);
+
+/**
+ * HasBatchLogProbability::value is true if the distribution type can compute
+ * the log probabilities of all the columns of a matrix in one call, with
+ * void LogProbability(const arma::mat&, arma::vec&) const.
+ */
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  template<typename C>
+  using BatchLogProbability = void(C::*)(const arma::mat&, arma::vec&) const;
+
+  static const bool value =
+      HasLogProbabilityCheck<Distribution, BatchLogProbability>::value;
+};
+
+// Forward declaration of the online filter, which uses the internals of HMM.
+template<typename Distribution>
+class HMMOnlineFilter;
+
 /**
  * A class that represents a Hidden Markov Model with an arbitrary type of
  * emission distribution.  This HMM class supports training (supervised and
@@ -79,6 +103,13 @@ namespace hmm /** Hidden Markov Models. */ {
  * (with Predict()), generate a sequence (with Generate()), or estimate the
  * probabilities of each state for a sequence of observations (with Train()).
  *
+ * When at most a tenth of the transitions are possible (for instance, in
+ * left-to-right models), the forward-backward algorithm and the Viterbi
+ * algorithm use a sparse copy of the transition matrix, so that each step of
+ * a sequence takes time proportional to the number of possible transitions
+ * instead of the square of the number of states.  For large models, Predict()
+ * can also prune the Viterbi search to a beam of the most probable states.
+ *
  * @tparam Distribution Type of emission distribution for this HMM.
  */
 template<typename Distribution = distribution::DiscreteDistribution>
@@ -283,6 +314,54 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute a probable hidden state sequence for the given data sequence,
+   * using the Viterbi algorithm with beam pruning: at each time step, only the
+   * paths ending in the beamWidth most probable states are extended.  Each
+   * step then takes time proportional to beamWidth times the number of
+   * transitions out of a state, but the returned sequence may not be the most
+   * probable one, if its path left the beam at some step.  A beam width of 0
+   * (or at least the number of states) gives the exact Viterbi algorithm.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the state sequence will be stored.
+   * @param beamWidth Number of states to keep at each time step.
+   * @return Log-likelihood of the returned state sequence.
+   */
+  double Predict(const arma::mat& dataSeq,
+                 arma::Row<size_t>& stateSeq,
+                 const size_t beamWidth) const;
+
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel if OpenMP is available.
+   *
+   * @param dataSeq Set of data sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @param logLikelihoods Vector in which the log-likelihood of the most
+   *    probable state sequence of each data sequence will be stored.
+   * @param beamWidth Number of states to keep at each time step of the
+   *    Viterbi algorithm (0 for the exact algorithm).
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq,
+               arma::vec& logLikelihoods,
+               const size_t beamWidth = 0) const;
+
+  /**
+   * Compute the most probable hidden state sequence for each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are processed in
+   * parallel if OpenMP is available.
+   *
+   * @param dataSeq Set of data sequences.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   */
+  void Predict(const std::vector<arma::mat>& dataSeq,
+               std::vector<arma::Row<size_t>>& stateSeq) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -383,9 +462,111 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * Compute the log probability of each observation of the given data sequence
+   * for each emission distribution.  The returned matrix has rows equal to the
+   * number of hidden states and columns equal to the number of observations.
+   * If the distribution has a batch LogProbability() (see
+   * HasBatchLogProbability), every row is computed with a single call.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionLogProb Matrix in which the log probabilities will be saved.
+   */
+  template<typename DistType = Distribution>
+  void EmissionLogProbability(
+      const arma::mat& dataSeq,
+      arma::mat& emissionLogProb,
+      const typename std::enable_if<
+          HasBatchLogProbability<DistType>::value>::type* = 0) const;
+
+  /**
+   * Compute the log probability of each observation of the given data sequence
+   * for each emission distribution, one observation at a time.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param emissionLogProb Matrix in which the log probabilities will be saved.
+   */
+  template<typename DistType = Distribution>
+  void EmissionLogProbability(
+      const arma::mat& dataSeq,
+      arma::mat& emissionLogProb,
+      const typename std::enable_if<
+          !HasBatchLogProbability<DistType>::value>::type* = 0) const;
+
+  /**
+   * The Forward algorithm, given the emission log probabilities computed by
+   * EmissionLogProbability().  The recursion is computed on scaled
+   * probabilities, so that each step is a matrix-vector product.
+   *
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   * @param logScales Vector in which the log of the scaling factors will be
+   *     saved.
+   * @param forwardLogProb Matrix in which forward log probabilities will be
+   *     saved.
+   */
+  void ForwardFromEmission(const arma::mat& emissionLogProb,
+                           arma::vec& logScales,
+                           arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, given the emission log probabilities computed by
+   * EmissionLogProbability() and the scaling factors computed by
+   * ForwardFromEmission().
+   *
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   * @param logScales Vector of the log of the scaling factors.
+   * @param backwardLogProb Matrix in which backward log probabilities will be
+   *     saved.
+   */
+  void BackwardFromEmission(const arma::mat& emissionLogProb,
+                            const arma::vec& logScales,
+                            arma::mat& backwardLogProb) const;
+
+  /**
+   * Estimate the log probabilities of each hidden state at each time step,
+   * given the emission log probabilities computed by EmissionLogProbability().
+   * This is LogEstimate() without the computation of the emission log
+   * probabilities.
+   */
+  double LogEstimateFromEmission(const arma::mat& emissionLogProb,
+                                 arma::mat& stateLogProb,
+                                 arma::mat& forwardLogProb,
+                                 arma::mat& backwardLogProb,
+                                 arma::vec& logScales) const;
+
+  /**
+   * Store a sparse copy of the transition matrix in sparseTransition, if at
+   * most a tenth of its elements are non-zero, and return whether it was
+   * stored.  This takes as long as one step of the dense algorithms.
+   *
+   * @param sparseTransition Matrix to store the sparse transitions in.
+   */
+  bool SparseTransition(arma::sp_mat& sparseTransition) const;
+
+  /**
+   * The Viterbi algorithm with optional beam pruning, given the emission log
+   * probabilities computed by EmissionLogProbability().  Paths are extended
+   * from each kept state to the states it can transition to, so with a sparse
+   * transition matrix only the possible transitions are visited.
+   *
+   * @param emissionLogProb Emission log probabilities of the data sequence.
+   * @param sparseTransition Sparse copy of the transition matrix from
+   *     SparseTransition(), or an empty matrix to use the dense one.
+   * @param beamWidth Number of states to keep at each time step (0 for all).
+   * @param stateSeq Vector in which the state sequence will be stored.
+   * @return Log-likelihood of the state sequence.
+   */
+  double ViterbiFromEmission(const arma::mat& emissionLogProb,
+                             const arma::sp_mat& sparseTransition,
+                             const size_t beamWidth,
+                             arma::Row<size_t>& stateSeq) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
+  // The online filter uses the emission and transition helper functions.
+  friend class HMMOnlineFilter<Distribution>;
+
   //! Transition probability matrix.
   arma::mat transition;
 
@@ -18,6 +18,8 @@
 #include "hmm.hpp"
 #include <mlpack/core/math/log_add.hpp>
 
+#include <algorithm>
+
 namespace mlpack {
 namespace hmm {
 
@@ -93,9 +95,13 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   size_t iterations = 1000;
 
   // Find length of all sequences and ensure they are the correct size.
+  // We also store the offset of each sequence in the list of emission
+  // observations, so that the sequences can be processed independently.
   size_t totalLength = 0;
+  std::vector<size_t> offsets(dataSeq.size());
   for (size_t seq = 0; seq < dataSeq.size(); seq++)
   {
+    offsets[seq] = totalLength;
     totalLength += dataSeq[seq].n_cols;
 
     if (dataSeq[seq].n_rows != dimensionality)
@@ -115,63 +121,113 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   // Markov Models: Estimation and Control", pp. 36-40.
   for (size_t iter = 0; iter < iterations; iter++)
   {
-    // Clear new transition matrix and emission probabilities.
-    arma::vec newLogInitial(transition.n_rows);
-    newLogInitial.fill(-std::numeric_limits<double>::infinity());
-    arma::mat newLogTransition(transition.n_rows, transition.n_cols);
-    newLogTransition.fill(-std::numeric_limits<double>::infinity());
-
-    // Reset log likelihood.
-    loglik = 0;
+    size_t numThreads = 1;
+    #ifdef HAS_OPENMP
+      numThreads = omp_get_max_threads();
+    #endif
+
+    // Each thread accumulates the sequences it sees into its own new initial
+    // and transition estimates, so there is no need to synchronize the threads
+    // until the partial results are combined.  The emission observations of
+    // each sequence are stored at its own offset.
+    arma::mat threadLogInitial(transition.n_rows, numThreads);
+    threadLogInitial.fill(-std::numeric_limits<double>::infinity());
+    arma::cube threadLogTransition(transition.n_rows, transition.n_cols,
+        numThreads);
+    threadLogTransition.fill(-std::numeric_limits<double>::infinity());
+    arma::vec threadLoglik(numThreads, arma::fill::zeros);
+
+    #pragma omp parallel
+    {
+      size_t threadId = 0;
+      #ifdef HAS_OPENMP
+        threadId = omp_get_thread_num();
+      #endif
 
-    // Sum over time.
-    size_t sumTime = 0;
+      arma::mat& newLogTransition = threadLogTransition.slice(threadId);
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
-    {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      // Loop over each sequence.
+      #pragma omp for schedule(static)
+      for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); seq++)
       {
+        arma::mat stateLogProb;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // The emission log probabilities are needed both by the
+        // forward-backward algorithm and the estimate of the transitions.
+        arma::mat emissionLogProb;
+        EmissionLogProbability(dataSeq[seq], emissionLogProb);
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        threadLoglik[threadId] += LogEstimateFromEmission(emissionLogProb,
+            stateLogProb, forwardLog, backwardLog, logScales);
+
+        // Add to estimate of initial probability for state j.
         for (size_t j = 0; j < transition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          threadLogInitial(j, threadId) = math::LogAdd(
+              threadLogInitial(j, threadId), stateLogProb(j, 0));
+        }
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+        {
+          const size_t sumTime = offsets[seq] + t;
+          for (size_t j = 0; j < transition.n_cols; ++j)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
+            if (t < dataSeq[seq].n_cols - 1)
             {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
+              // Estimate of T_ij (probability of transition from state j to
+              // state i).  We postpone multiplication of the old T_ij until
+              // later.
+              for (size_t i = 0; i < transition.n_rows; i++)
+              {
+                // Impossible transitions stay impossible, so their estimates
+                // aren't needed.
+                if (transition(i, j) == 0.0)
+                  continue;
+
+                newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
+                    forwardLog(j, t) + backwardLog(i, t + 1) +
+                    emissionLogProb(i, t + 1) - logScales[t + 1]);
+              }
             }
+
+            // Add to list of emission observations, for Distribution::Train().
+            emissionList.col(sumTime) = dataSeq[seq].col(t);
+            emissionProb[j][sumTime] = exp(stateLogProb(j, t));
           }
+        }
+      }
+    }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+    // Combine the partial results of each thread, in order.
+    arma::vec newLogInitial(transition.n_rows);
+    newLogInitial.fill(-std::numeric_limits<double>::infinity());
+    arma::mat newLogTransition(transition.n_rows, transition.n_cols);
+    newLogTransition.fill(-std::numeric_limits<double>::infinity());
+    loglik = 0;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+      for (size_t j = 0; j < transition.n_rows; ++j)
+      {
+        newLogInitial[j] = math::LogAdd(newLogInitial[j],
+            threadLogInitial(j, t));
+        for (size_t i = 0; i < transition.n_rows; ++i)
+        {
+          newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
+              threadLogTransition(i, j, t));
         }
-        sumTime++;
       }
+      loglik += threadLoglik[t];
     }
 
     if (std::abs(oldLoglik - loglik) < tolerance)
@@ -318,10 +374,29 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::mat& forwardLogProb,
                                       arma::mat& backwardLogProb,
                                       arma::vec& logScales) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+
+  return LogEstimateFromEmission(emissionLogProb, stateLogProb, forwardLogProb,
+      backwardLogProb, logScales);
+}
+
+/**
+ * Estimate the probabilities of each hidden state at each time step, given the
+ * emission log probabilities of each observation.
+ */
+template<typename Distribution>
+double HMM<Distribution>::LogEstimateFromEmission(
+    const arma::mat& emissionLogProb,
+    arma::mat& stateLogProb,
+    arma::mat& forwardLogProb,
+    arma::mat& backwardLogProb,
+    arma::vec& logScales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  ForwardFromEmission(emissionLogProb, logScales, forwardLogProb);
+  BackwardFromEmission(emissionLogProb, logScales, backwardLogProb);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -438,55 +513,69 @@ template<typename Distribution>
 double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
-  // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
+  return Predict(dataSeq, stateSeq, 0);
+}
 
-  // Store the logs of the transposed transition matrix.  This is because we
-  // will be using the rows of the transition matrix.
-  arma::mat logTrans(log(trans(transition)));
+/**
+ * Compute a probable hidden state sequence for the given observation using the
+ * Viterbi algorithm with beam pruning.  Returns the log-likelihood of the
+ * sequence.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Predict(const arma::mat& dataSeq,
+                                  arma::Row<size_t>& stateSeq,
+                                  const size_t beamWidth) const
+{
+  // Compute the emission log probabilities of every observation at once.
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
 
-  // The calculation of the first state is slightly different; the probability
-  // of the first state being state j is the maximum probability that the state
-  // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < transition.n_rows; state++)
-  {
-    logStateProb(state, 0) = log(initial[state]) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-    stateSeqBack(state, 0) = state;
-  }
+  arma::sp_mat sparseTransition;
+  SparseTransition(sparseTransition);
 
-  // Store the best first state.
-  arma::uword index;
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
-  {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < transition.n_rows; j++)
-    {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-      stateSeqBack(j, t) = index;
-    }
-  }
+  return ViterbiFromEmission(emissionLogProb, sparseTransition, beamWidth,
+      stateSeq);
+}
 
-  // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observations, using the Viterbi algorithm.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq,
+                                arma::vec& logLikelihoods,
+                                const size_t beamWidth) const
+{
+  stateSeq.resize(dataSeq.size());
+  logLikelihoods.set_size(dataSeq.size());
+
+  // The sparse transitions are shared by all sequences.
+  arma::sp_mat sparseTransition;
+  SparseTransition(sparseTransition);
+
+  // Every sequence is independent.  The lengths of the sequences may be very
+  // different, so they are handed out dynamically.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t seq = 0; seq < (omp_size_t) dataSeq.size(); ++seq)
   {
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
+    arma::mat emissionLogProb;
+    EmissionLogProbability(dataSeq[seq], emissionLogProb);
+    logLikelihoods[seq] = ViterbiFromEmission(emissionLogProb,
+        sparseTransition, beamWidth, stateSeq[seq]);
   }
+}
 
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+/**
+ * Compute the most probable hidden state sequence for each of the given
+ * observations, using the Viterbi algorithm.
+ */
+template<typename Distribution>
+void HMM<Distribution>::Predict(const std::vector<arma::mat>& dataSeq,
+                                std::vector<arma::Row<size_t>>& stateSeq) const
+{
+  arma::vec logLikelihoods;
+  Predict(dataSeq, stateSeq, logLikelihoods);
 }
 
 /**
@@ -559,87 +648,350 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  ForwardFromEmission(emissionLogProb, logScales, forwardLogProb);
+}
+
+/**
+ * The Backward procedure (part of the Forward-Backward algorithm).
+ */
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb) const
+{
+  arma::mat emissionLogProb;
+  EmissionLogProbability(dataSeq, emissionLogProb);
+  BackwardFromEmission(emissionLogProb, logScales, backwardLogProb);
+}
+
+/**
+ * Compute the emission log probabilities with one call per state.
+ */
+template<typename Distribution>
+template<typename DistType>
+void HMM<Distribution>::EmissionLogProbability(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb,
+    const typename std::enable_if<
+        HasBatchLogProbability<DistType>::value>::type*) const
+{
+  emissionLogProb.set_size(transition.n_rows, dataSeq.n_cols);
+  arma::vec logProbs;
+  for (size_t state = 0; state < transition.n_rows; state++)
+  {
+    emission[state].LogProbability(dataSeq, logProbs);
+    emissionLogProb.row(state) = trans(logProbs);
+  }
+}
+
+/**
+ * Compute the emission log probabilities one observation at a time.
+ */
+template<typename Distribution>
+template<typename DistType>
+void HMM<Distribution>::EmissionLogProbability(
+    const arma::mat& dataSeq,
+    arma::mat& emissionLogProb,
+    const typename std::enable_if<
+        !HasBatchLogProbability<DistType>::value>::type*) const
+{
+  emissionLogProb.set_size(transition.n_rows, dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    for (size_t state = 0; state < transition.n_rows; state++)
+    {
+      emissionLogProb(state, t) =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+    }
+  }
+}
+
+/**
+ * The Forward procedure, given the emission log probabilities.
+ */
+template<typename Distribution>
+void HMM<Distribution>::ForwardFromEmission(const arma::mat& emissionLogProb,
+                                            arma::vec& logScales,
+                                            arma::mat& forwardLogProb) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
-  forwardLogProb.resize(transition.n_rows, dataSeq.n_cols);
-  forwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  logScales.resize(dataSeq.n_cols);
-  logScales.fill(-std::numeric_limits<double>::infinity());
-
-  arma::mat logTrans = trans(log(transition));
+  const size_t numStates = transition.n_rows;
+  forwardLogProb.set_size(numStates, emissionLogProb.n_cols);
+  logScales.set_size(emissionLogProb.n_cols);
+
+  // Instead of summing in the log domain, we keep the forward probabilities of
+  // the current time step scaled to sum to 1, and the emission probabilities
+  // are divided by their largest value before they are exponentiated.  Then
+  // each step of the recursion is a matrix-vector product, and nothing
+  // overflows or underflows.  These buffers are reused at each time step.
+  arma::vec forward(numStates);
+  arma::vec predicted(numStates);
+
+  // If most transitions are impossible, the products are sparse.
+  arma::sp_mat sparseTransition;
+  const bool sparse = SparseTransition(sparseTransition);
 
   // The first entry in the forward algorithm uses the initial state
   // probabilities.  Note that MATLAB assumes that the starting state (at
   // t = -1) is state 0; this is not our assumption here.  To force that
   // behavior, you could append a single starting state to every single data
   // sequence and that should produce results in line with MATLAB.
-  for (size_t state = 0; state < transition.n_rows; state++)
+  for (size_t t = 0; t < emissionLogProb.n_cols; t++)
   {
-    forwardLogProb(state, 0) = log(initial(state)) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-  }
+    // The probability of being in each state at time t, before the
+    // observation.  transition(i, j) is the probability of going from state j
+    // to state i.
+    if (t == 0)
+      predicted = initial;
+    else if (sparse)
+      predicted = sparseTransition * forward;
+    else
+      predicted = transition * forward;
 
-  // Then normalize the column.
-  logScales[0] = math::AccuLog(forwardLogProb.col(0));
-  if (std::isfinite(logScales[0]))
-    forwardLogProb.col(0) -= logScales[0];
+    double sum = 0.0;
+    const double maxLogProb = emissionLogProb.col(t).max();
+    if (maxLogProb != -std::numeric_limits<double>::infinity())
+    {
+      forward = predicted % exp(emissionLogProb.col(t) - maxLogProb);
+      sum = accu(forward);
+    }
 
-  // Now compute the probabilities for each successive observation.
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
-  {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    // Normalize probability.  If the observation is impossible, everything
+    // that follows is too.
+    if (sum > 0.0)
     {
-      // The forward probability of state j at time t is the sum over all states
-      // of the probability of the previous state transitioning to the current
-      // state and emitting the given observation.
-      arma::vec tmp = forwardLogProb.col(t - 1) + logTrans.col(j);
-      forwardLogProb(j, t) = math::AccuLog(tmp) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      forward /= sum;
+      logScales[t] = std::log(sum) + maxLogProb;
+    }
+    else
+    {
+      forward.zeros();
+      logScales[t] = -std::numeric_limits<double>::infinity();
     }
 
-    // Normalize probability.
-    logScales[t] = math::AccuLog(forwardLogProb.col(t));
-    if (std::isfinite(logScales[t]))
-        forwardLogProb.col(t) -= logScales[t];
+    forwardLogProb.col(t) = log(forward);
   }
 }
 
+/**
+ * The Backward procedure, given the emission log probabilities.
+ */
 template<typename Distribution>
-void HMM<Distribution>::Backward(const arma::mat& dataSeq,
-                                 const arma::vec& logScales,
-                                 arma::mat& backwardLogProb) const
+void HMM<Distribution>::BackwardFromEmission(const arma::mat& emissionLogProb,
+                                             const arma::vec& logScales,
+                                             arma::mat& backwardLogProb) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
-  backwardLogProb.resize(transition.n_rows, dataSeq.n_cols);
-  backwardLogProb.fill(-std::numeric_limits<double>::infinity());
-  arma::mat logTrans = log(transition);
+  const size_t numStates = transition.n_rows;
+  backwardLogProb.set_size(numStates, emissionLogProb.n_cols);
+  if (emissionLogProb.n_cols == 0)
+    return;
+
+  // As in ForwardFromEmission(), the recursion is computed on scaled
+  // probabilities with matrix-vector products, using reused buffers.
+  arma::vec backward(numStates);
+  arma::vec weighted(numStates);
+
+  // The transposed transitions are used, so the sparse copy (if any) is
+  // transposed once.
+  arma::sp_mat sparseTransition, transposedTransition;
+  const bool sparse = SparseTransition(sparseTransition);
+  if (sparse)
+    transposedTransition = sparseTransition.t();
 
   // The last element probability is 1.
-  backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
+  backward.ones();
+  backwardLogProb.col(emissionLogProb.n_cols - 1).zeros();
 
   // Now step backwards through all other observations.
-  for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
+  for (size_t t = emissionLogProb.n_cols - 2; t + 1 > 0; t--)
   {
-    for (size_t j = 0; j < transition.n_rows; j++)
+    // The backward probability of state j at time t is the sum over all state
+    // of the probability of the next state having been a transition from the
+    // current state multiplied by the probability of each of those states
+    // emitting the given observation.
+    const double maxLogProb = emissionLogProb.col(t + 1).max();
+    if (maxLogProb == -std::numeric_limits<double>::infinity())
+    {
+      backward.zeros();
+    }
+    else
     {
-      // The backward probability of state j at time t is the sum over all state
-      // of the probability of the next state having been a transition from the
-      // current state multiplied by the probability of each of those states
-      // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
+      weighted = backward % exp(emissionLogProb.col(t + 1) - maxLogProb);
+      if (sparse)
+        backward = transposedTransition * weighted;
+      else
+        backward = trans(transition) * weighted;
+
+      // Normalize by the weights from the forward algorithm.  The emission
+      // probabilities were already divided by exp(maxLogProb).
+      if (std::isfinite(logScales[t + 1]))
+        backward *= std::exp(maxLogProb - logScales[t + 1]);
+      else
+        backward *= std::exp(maxLogProb);
+    }
+
+    backwardLogProb.col(t) = log(backward);
+  }
+}
+
+/**
+ * Store a sparse copy of the transition matrix, if it is sparse enough.
+ */
+template<typename Distribution>
+bool HMM<Distribution>::SparseTransition(arma::sp_mat& sparseTransition) const
+{
+  // Count the zeros without building a temporary matrix.
+  const size_t nonzeros = transition.n_elem - (size_t) std::count(
+      transition.begin(), transition.end(), 0.0);
+  if (nonzeros > transition.n_elem / 10)
+  {
+    sparseTransition.set_size(0, 0);
+    return false;
+  }
+
+  sparseTransition = arma::sp_mat(transition);
+  return true;
+}
+
+/**
+ * The Viterbi algorithm with beam pruning, given the emission log
+ * probabilities.
+ */
+template<typename Distribution>
+double HMM<Distribution>::ViterbiFromEmission(
+    const arma::mat& emissionLogProb,
+    const arma::sp_mat& sparseTransition,
+    const size_t beamWidth,
+    arma::Row<size_t>& stateSeq) const
+{
+  // This is an implementation of the Viterbi algorithm for finding the most
+  // probable sequence of states to produce the observed data sequence.
+  // logStateProb(j, t) is the log-likelihood of the most probable path that
+  // ends in state j at time t, and stateSeqBack(j, t) is the state before j on
+  // that path.
+  const size_t numStates = transition.n_rows;
+  const size_t length = emissionLogProb.n_cols;
+  const double negInf = -std::numeric_limits<double>::infinity();
+  stateSeq.set_size(length);
+  if (length == 0)
+    return 0.0;
+
+  arma::mat logStateProb(numStates, length);
+  arma::Mat<size_t> stateSeqBack(numStates, length);
+
+  // The calculation of the first state is slightly different; the probability
+  // of the first state being state j is given by the initial probabilities.
+  logStateProb.col(0) = log(initial) + emissionLogProb.col(0);
+  for (size_t state = 0; state < numStates; state++)
+    stateSeqBack(state, 0) = state;
+
+  // The log probabilities of the transitions out of each state.  For a sparse
+  // transition matrix, only the possible transitions are stored (in the order
+  // of the columns), since log(1) = 0 can't be stored in a sparse matrix.
+  const bool sparse = (sparseTransition.n_elem != 0);
+  arma::mat logTransition;
+  std::vector<size_t> successorStart, successors;
+  std::vector<double> successorLogProb;
+  if (sparse)
+  {
+    successorStart.resize(numStates + 1);
+    successors.reserve(sparseTransition.n_nonzero);
+    successorLogProb.reserve(sparseTransition.n_nonzero);
+    for (size_t i = 0; i < numStates; ++i)
+    {
+      successorStart[i] = successors.size();
+      for (arma::sp_mat::const_iterator it = sparseTransition.begin_col(i);
+           it != sparseTransition.end_col(i); ++it)
       {
-        backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTrans(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
+        successors.push_back(it.row());
+        successorLogProb.push_back(std::log(*it));
       }
+    }
+    successorStart[numStates] = successors.size();
+  }
+  else
+  {
+    logTransition = log(transition);
+  }
 
-      // Normalize by the weights from the forward algorithm.
-      if (std::isfinite(logScales[t + 1]))
-        backwardLogProb(j, t) -= logScales[t + 1];
+  std::vector<size_t> beam;
+  beam.reserve(numStates);
+  for (size_t t = 1; t < length; t++)
+  {
+    // Collect the states that paths can be extended from.  When there are
+    // more than beamWidth of them, only the most probable ones are kept.
+    const double* previous = logStateProb.colptr(t - 1);
+    beam.clear();
+    for (size_t i = 0; i < numStates; ++i)
+      if (previous[i] != negInf)
+        beam.push_back(i);
+
+    if (beamWidth > 0 && beam.size() > beamWidth)
+    {
+      std::nth_element(beam.begin(), beam.begin() + beamWidth, beam.end(),
+          [previous](const size_t a, const size_t b)
+          {
+            return previous[a] > previous[b];
+          });
+      beam.resize(beamWidth);
+      // Keep the states in order, so that ties are broken as without pruning.
+      std::sort(beam.begin(), beam.end());
+    }
+
+    // Extend the path ending in each kept state to every state it can
+    // transition to.  Given that we are in state j, the previous state is the
+    // one with the most probable path to j (the first one, in case of ties).
+    double* current = logStateProb.colptr(t);
+    size_t* back = stateSeqBack.colptr(t);
+    std::fill(current, current + numStates, negInf);
+    std::fill(back, back + numStates, 0);
+    for (size_t b = 0; b < beam.size(); ++b)
+    {
+      const size_t i = beam[b];
+      if (sparse)
+      {
+        for (size_t k = successorStart[i]; k < successorStart[i + 1]; ++k)
+        {
+          const double logProb = previous[i] + successorLogProb[k];
+          if (logProb > current[successors[k]])
+          {
+            current[successors[k]] = logProb;
+            back[successors[k]] = i;
+          }
+        }
+      }
+      else
+      {
+        const double* logTrans = logTransition.colptr(i);
+        for (size_t j = 0; j < numStates; ++j)
+        {
+          const double logProb = previous[i] + logTrans[j];
+          if (logProb > current[j])
+          {
+            current[j] = logProb;
+            back[j] = i;
+          }
+        }
+      }
     }
+
+    logStateProb.col(t) += emissionLogProb.col(t);
   }
+
+  // Backtrack to find the most probable state sequence.
+  arma::uword index;
+  logStateProb.unsafe_col(length - 1).max(index);
+  stateSeq[length - 1] = index;
+  for (size_t t = length - 1; t > 0; t--)
+    stateSeq[t - 1] = stateSeqBack(stateSeq[t], t);
+
+  return logStateProb(stateSeq[length - 1], length - 1);
 }
 
 //! Serialize the HMM.
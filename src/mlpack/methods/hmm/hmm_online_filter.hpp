@@ -0,0 +1,164 @@
+/**
+ * @file hmm_online_filter.hpp
+ *
+ * Definition of HMMOnlineFilter, which computes the probabilities of the
+ * hidden states of an HMM as the observations arrive.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_HMM_ONLINE_FILTER_HPP
+#define MLPACK_METHODS_HMM_HMM_ONLINE_FILTER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hmm.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * The HMMOnlineFilter runs the forward algorithm of an HMM one observation at
+ * a time, for applications where the observations arrive one by one and the
+ * probabilities of the hidden states are needed after each of them.  Only the
+ * scaled forward probabilities of the last observation are kept, so each
+ * observation takes O(N^2) time (or less, with sparse transitions; see HMM)
+ * no matter how many observations came before it.  After a sequence of
+ * observations, StateProbabilities() and LogLikelihood() are the same as the
+ * forward probabilities of the last observation and the log-likelihood that
+ * HMM::Estimate() and HMM::LogLikelihood() would calculate for the whole
+ * sequence.
+ *
+ * Optionally, the filter can also be a fixed-lag smoother: with a lag of L,
+ * the forward probabilities and emission probabilities of the last L
+ * observations are kept, and after each observation the probabilities of the
+ * hidden state of the observation L steps before are calculated given all of
+ * the observations so far (that is, P(X_{t - L} | o_{1:t})).  This takes
+ * O(L N^2) time per observation.
+ *
+ * @code
+ * extern HMM<GaussianDistribution> hmm;
+ * HMMOnlineFilter<GaussianDistribution> filter(hmm, 5);
+ * while (...)
+ * {
+ *   arma::vec observation = ...;
+ *   filter.Update(observation);
+ *   const arma::vec& current = filter.StateProbabilities();
+ *   const arma::vec& smoothed = filter.SmoothedProbabilities();
+ * }
+ * @endcode
+ *
+ * The HMM is held by reference, so it must outlive the filter, and it should
+ * not be modified while the filter is used (call Reset() after changing it).
+ *
+ * @tparam Distribution Type of emission distribution of the HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class HMMOnlineFilter
+{
+ public:
+  /**
+   * Create a filter for the given HMM, with the given lag for smoothing (0
+   * for no smoothing).
+   *
+   * @param hmm HMM to compute the state probabilities of.
+   * @param lag Number of observations to delay the smoothed probabilities by.
+   */
+  HMMOnlineFilter(const HMM<Distribution>& hmm, const size_t lag = 0);
+
+  /**
+   * Forget all observations, to start a new sequence.
+   */
+  void Reset();
+
+  /**
+   * Add the given observations (one in each column) to the end of the
+   * sequence, and update the state probabilities.  Giving several
+   * observations at once is faster for distributions that compute the
+   * probabilities of many observations in one call.
+   *
+   * @param observations Observations to add.
+   * @return Log-likelihood of the observations, given the ones before them.
+   */
+  double Update(const arma::mat& observations);
+
+  /**
+   * Get the probability of each state given the observations so far.  Before
+   * the first observation, this is the initial state probabilities.
+   */
+  const arma::vec& StateProbabilities() const { return forward; }
+
+  /**
+   * Get the probability of each state at time SmoothedTime() given the
+   * observations so far.  Until there have been more than Lag() observations,
+   * this is the probabilities of the hidden state of the first observation.
+   */
+  const arma::vec& SmoothedProbabilities() const { return smoothed; }
+
+  //! Get the time of the smoothed probabilities.
+  size_t SmoothedTime() const { return (time > lag) ? time - 1 - lag : 0; }
+
+  //! Get the log-likelihood of all the observations so far.
+  double LogLikelihood() const { return logLikelihood; }
+
+  //! Get the number of observations so far.
+  size_t Time() const { return time; }
+
+  //! Get the lag of the smoothed probabilities.
+  size_t Lag() const { return lag; }
+
+ private:
+  //! Add one observation, given its emission log probabilities.
+  double UpdateFromEmission(const arma::vec& emissionLogProb);
+
+  //! Calculate the smoothed probabilities from the kept window.
+  void Smooth();
+
+  //! The HMM.
+  const HMM<Distribution>& hmm;
+
+  //! Sparse copy of the transition matrix of the HMM (if it is sparse).
+  arma::sp_mat sparseTransition;
+
+  //! Transpose of the sparse copy, for smoothing.
+  arma::sp_mat transposedTransition;
+
+  //! Whether the sparse copy is used.
+  bool sparse;
+
+  //! The lag of the smoother.
+  size_t lag;
+
+  //! The number of observations so far.
+  size_t time;
+
+  //! The log-likelihood of the observations so far.
+  double logLikelihood;
+
+  //! The forward probabilities of the last observation, scaled to sum to 1.
+  arma::vec forward;
+
+  //! The smoothed probabilities.
+  arma::vec smoothed;
+
+  /**
+   * The forward probabilities of the last lag + 1 observations, indexed by
+   * time modulo lag + 1.
+   */
+  arma::mat forwardWindow;
+
+  /**
+   * The emission probabilities (divided by their largest value) of the last
+   * lag + 1 observations, indexed by time modulo lag + 1.
+   */
+  arma::mat emissionWindow;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "hmm_online_filter_impl.hpp"
+
+#endif
@@ -0,0 +1,157 @@
+/**
+ * @file hmm_online_filter_impl.hpp
+ *
+ * Implementation of HMMOnlineFilter.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_HMM_ONLINE_FILTER_IMPL_HPP
+#define MLPACK_METHODS_HMM_HMM_ONLINE_FILTER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hmm_online_filter.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+HMMOnlineFilter<Distribution>::HMMOnlineFilter(const HMM<Distribution>& hmm,
+                                               const size_t lag) :
+    hmm(hmm),
+    sparse(hmm.SparseTransition(sparseTransition)),
+    lag(lag),
+    time(0),
+    logLikelihood(0.0)
+{
+  if (sparse && lag > 0)
+    transposedTransition = sparseTransition.t();
+
+  Reset();
+}
+
+template<typename Distribution>
+void HMMOnlineFilter<Distribution>::Reset()
+{
+  time = 0;
+  logLikelihood = 0.0;
+  forward = hmm.Initial();
+  smoothed = forward;
+
+  const size_t numStates = hmm.Transition().n_rows;
+  forwardWindow.set_size(numStates, lag + 1);
+  emissionWindow.set_size(numStates, lag + 1);
+}
+
+template<typename Distribution>
+double HMMOnlineFilter<Distribution>::Update(const arma::mat& observations)
+{
+  // Compute the emission log probabilities of all the observations at once.
+  arma::mat emissionLogProb;
+  hmm.EmissionLogProbability(observations, emissionLogProb);
+
+  double logProb = 0.0;
+  for (size_t t = 0; t < observations.n_cols; ++t)
+    logProb += UpdateFromEmission(emissionLogProb.unsafe_col(t));
+
+  // The smoothed probabilities are only needed for the last observation.
+  if (lag > 0)
+    Smooth();
+  else
+    smoothed = forward;
+
+  return logProb;
+}
+
+template<typename Distribution>
+double HMMOnlineFilter<Distribution>::UpdateFromEmission(
+    const arma::vec& emissionLogProb)
+{
+  // This is one step of HMM::ForwardFromEmission(): the probability of being
+  // in each state before the observation is the transition matrix times the
+  // forward probabilities of the last observation, and the emission
+  // probabilities are divided by their largest value before they are
+  // exponentiated.
+  arma::vec predicted;
+  if (time == 0)
+    predicted = hmm.Initial();
+  else if (sparse)
+    predicted = sparseTransition * forward;
+  else
+    predicted = hmm.Transition() * forward;
+
+  const size_t slot = time % (lag + 1);
+  double sum = 0.0;
+  const double maxLogProb = emissionLogProb.max();
+  if (maxLogProb != -std::numeric_limits<double>::infinity())
+  {
+    emissionWindow.col(slot) = exp(emissionLogProb - maxLogProb);
+    forward = predicted % emissionWindow.col(slot);
+    sum = accu(forward);
+  }
+  else
+  {
+    emissionWindow.col(slot).zeros();
+  }
+
+  // Normalize probability.  If the observation is impossible, everything that
+  // follows is too.
+  double logScale;
+  if (sum > 0.0)
+  {
+    forward /= sum;
+    logScale = std::log(sum) + maxLogProb;
+  }
+  else
+  {
+    forward.zeros(predicted.n_elem);
+    logScale = -std::numeric_limits<double>::infinity();
+  }
+
+  forwardWindow.col(slot) = forward;
+  logLikelihood += logScale;
+  ++time;
+
+  return logScale;
+}
+
+template<typename Distribution>
+void HMMOnlineFilter<Distribution>::Smooth()
+{
+  if (time == 0)
+  {
+    smoothed = forward;
+    return;
+  }
+
+  // Run the backward algorithm from the last observation to the smoothed
+  // one.  Only the proportions of the backward probabilities matter, so they
+  // are normalized at each step instead of using the scaling factors.
+  const size_t smoothedTime = SmoothedTime();
+  arma::vec backward(forward.n_elem, arma::fill::ones);
+  arma::vec weighted;
+  for (size_t t = time - 1; t > smoothedTime; --t)
+  {
+    weighted = backward % emissionWindow.col(t % (lag + 1));
+    if (sparse)
+      backward = transposedTransition * weighted;
+    else
+      backward = trans(hmm.Transition()) * weighted;
+
+    const double sum = accu(backward);
+    if (sum > 0.0)
+      backward /= sum;
+  }
+
+  smoothed = forwardWindow.col(smoothedTime % (lag + 1)) % backward;
+  const double sum = accu(smoothed);
+  if (sum > 0.0)
+    smoothed /= sum;
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
@@ -47,7 +47,22 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction",
     ", the following command could be used:"
     "\n\n" +
     PRINT_CALL("hmm_viterbi", "input", "obs", "input_model", "hmm", "output",
-        "states"),
+        "states") +
+    "\n\n"
+    "Many observation sequences may be processed at once by concatenating them "
+    "in " + PRINT_PARAM_STRING("input") + " and specifying the length of each "
+    "sequence with the " + PRINT_PARAM_STRING("lengths") + " parameter.  The "
+    "sequences are then processed in parallel (if mlpack was built with "
+    "OpenMP), and the predicted state sequences are concatenated in the same "
+    "way in " + PRINT_PARAM_STRING("output") + ".  The log-likelihood of the "
+    "most probable state sequence of each observation sequence may be saved "
+    "with the " + PRINT_PARAM_STRING("log_likelihoods") + " output parameter."
+    "\n\n"
+    "For HMMs with many states, the search can be pruned with the " +
+    PRINT_PARAM_STRING("beam_width") + " parameter, so that only the paths "
+    "ending in that many of the most probable states are extended at each "
+    "step; this is much faster, but the predicted state sequence may not be "
+    "the most probable one.",
     SEE_ALSO("@hmm_train", "#hmm_train"),
     SEE_ALSO("@hmm_generate", "#hmm_generate"),
     SEE_ALSO("@hmm_loglik", "#hmm_loglik"),
@@ -59,6 +74,12 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Viterbi State Prediction",
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
+PARAM_UROW_IN("lengths", "Lengths of the observation sequences concatenated "
+    "in the input matrix (if not given, the input is a single sequence).", "l");
+PARAM_INT_IN("beam_width", "Number of states to keep at each step of the "
+    "Viterbi algorithm (0 keeps all states).", "b", 0);
+PARAM_COL_OUT("log_likelihoods", "Log-likelihood of the most probable state "
+    "sequence of each observation sequence.", "L");
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -86,17 +107,57 @@ struct Viterbi
           << hmm.Emission()[0].Dimensionality() << ")!" << endl;
     }
 
-    arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    // Split the observations into the individual sequences, if necessary.
+    arma::Row<size_t> lengths;
+    if (CLI::HasParam("lengths"))
+      lengths = std::move(CLI::GetParam<arma::Row<size_t>>("lengths"));
+    else
+      lengths = { (size_t) dataSeq.n_cols };
+
+    if (accu(lengths) != dataSeq.n_cols)
+    {
+      Log::Fatal << "Sum of sequence lengths (" << accu(lengths) << ") does "
+          << "not match the number of observations (" << dataSeq.n_cols
+          << ")!" << endl;
+    }
+
+    vector<mat> dataSeqs(lengths.n_elem);
+    size_t begin = 0;
+    for (size_t i = 0; i < lengths.n_elem; ++i)
+    {
+      if (lengths[i] == 0)
+        Log::Fatal << "Sequence " << i << " has length 0!" << endl;
+
+      dataSeqs[i] = dataSeq.cols(begin, begin + lengths[i] - 1);
+      begin += lengths[i];
+    }
+
+    vector<arma::Row<size_t>> sequences;
+    arma::vec logLikelihoods;
+    hmm.Predict(dataSeqs, sequences, logLikelihoods,
+        (size_t) CLI::GetParam<int>("beam_width"));
+
+    // Concatenate the predicted state sequences.
+    arma::Row<size_t> sequence(dataSeq.n_cols);
+    begin = 0;
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+      sequence.cols(begin, begin + lengths[i] - 1) = sequences[i];
+      begin += lengths[i];
+    }
 
     // Save output.
     CLI::GetParam<arma::Mat<size_t>>("output") = std::move(sequence);
+    CLI::GetParam<arma::vec>("log_likelihoods") = std::move(logLikelihoods);
   }
 };
 
 static void mlpackMain()
 {
-  RequireAtLeastOnePassed({ "output" }, false, "no results will be saved");
+  RequireAtLeastOnePassed({ "output", "log_likelihoods" }, false,
+      "no results will be saved");
+  RequireParamValue<int>("beam_width", [](int x) { return x >= 0; }, true,
+      "beam width must be non-negative");
 
   CLI::GetParam<HMMModel*>("input_model")->PerformAction<Viterbi>((void*) NULL);
 }
@@ -0,0 +1,249 @@
+/**
+ * @file hnsw.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph built on the
+ * reference set.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, D. A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_HPP
+#define MLPACK_METHODS_HNSW_HNSW_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW)
+ * graph on a reference set, and uses it to find the approximate nearest
+ * neighbors of query points.  Each reference point is a node of the graph on
+ * a random number of layers (exponentially fewer points on each layer), and is
+ * linked on each of its layers to up to M() close points (2 * M() on the
+ * lowest layer).  A search descends greedily from the single point of the top
+ * layer to the lowest layer, where a beam search keeps the Ef() best points
+ * found so far; a larger Ef() gives a better recall for a slower search.
+ *
+ * The graph is built in batches of points: the candidate neighbors of all the
+ * points of a batch are found in parallel on the graph built so far, and the
+ * points are then linked in order.  The batches are at most a twentieth of the
+ * size of the graph, so the graph is as good as one built one point at a time,
+ * and for a given random seed it does not depend on the number of threads.
+ *
+ * Any metric with an Evaluate() method may be used, such as metric::LMetric or
+ * metric::IPMetric; the search is only meaningful if the metric satisfies the
+ * triangle inequality, at least approximately.
+ *
+ * @code
+ * HNSWSearch<> hnsw(referenceSet);
+ * hnsw.Ef() = 100;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * hnsw.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for the search.
+ * @tparam MatType The type of the dataset.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Build the graph on the given reference set.  In order to avoid copying
+   * the reference set, it is suggested to pass it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of links of each point on each layer above the lowest one
+   *     (the lowest layer has 2 * m links).
+   * @param efConstruction Number of candidate neighbors considered when a
+   *     point is linked.
+   * @param ef Number of candidate neighbors considered by searches.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Create an HNSWSearch object without a reference set.  Train() must be
+   * called before Search().
+   *
+   * @param m Number of links of each point on each layer above the lowest one.
+   * @param efConstruction Number of candidate neighbors considered when a
+   *     point is linked.
+   * @param ef Number of candidate neighbors considered by searches.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t ef = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Build the graph on the given reference set, with the current M() and
+   * EfConstruction().  In order to avoid copying the reference set, it is
+   * suggested to pass it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the query
+   * set, in parallel over the query points.  If the graph reaches fewer than k
+   * points for a query, the remaining neighbors are SIZE_MAX and the remaining
+   * distances DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the list of neighbors for each point
+   *     (one column per query point).
+   * @param distances Matrix to store the distances to the neighbors.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the reference
+   * set, other than the point itself.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the list of neighbors for each point.
+   * @param distances Matrix to store the distances to the neighbors.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * Search() and a "ground truth" set of neighbors.  The recall returned will
+   * be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links of each point on the upper layers.
+  size_t M() const { return m; }
+  //! Get the number of candidate neighbors considered when a point is linked.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the number of candidate neighbors considered when a point is
+  //! linked (only used by the next Train()).
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the number of candidate neighbors considered by searches.
+  size_t Ef() const { return ef; }
+  //! Modify the number of candidate neighbors considered by searches.
+  size_t& Ef() { return ef; }
+
+  //! Get the number of layers of the graph.
+  size_t Layers() const { return referenceSet.n_cols == 0 ? 0 : maxLevel + 1; }
+  //! Get the neighbors of the given point on the given layer.
+  const std::vector<size_t>& Links(const size_t point, const size_t layer) const
+  { return links[point][layer]; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+  //! Serialize the HNSW model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! A point of the graph and its distance to the point being searched for.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * Starting from the given entry points, find the efSearch points of the
+   * given layer closest to the query, and store them in the entry points,
+   * sorted by distance.  The visited vector and stamp are the scratch space of
+   * the calling thread, so that visited points are not cleared at each call.
+   */
+  template<typename VecType>
+  void SearchLayer(const VecType& query,
+                   std::vector<Candidate>& entries,
+                   const size_t efSearch,
+                   const size_t layer,
+                   std::vector<size_t>& visited,
+                   size_t& stamp);
+
+  /**
+   * Select up to maxLinks neighbors among the given candidates, sorted by
+   * distance, with the heuristic of the paper: a candidate is kept only if it
+   * is closer to the point than to every neighbor selected before it, so that
+   * the links go in diverse directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxLinks,
+                       std::vector<size_t>& selected);
+
+  //! Link the given point to the selected candidates of each layer, and prune
+  //! the links of its new neighbors.
+  void Link(const size_t point,
+            const std::vector<std::vector<Candidate>>& candidates);
+
+  //! Get the maximum number of links of a point on the given layer.
+  size_t MaxLinks(const size_t layer) const { return layer == 0 ? 2 * m : m; }
+
+  //! Reference dataset.
+  MatType referenceSet;
+  //! Number of links of each point on the upper layers.
+  size_t m;
+  //! Number of candidate neighbors considered when a point is linked.
+  size_t efConstruction;
+  //! Number of candidate neighbors considered by searches.
+  size_t ef;
+  //! The highest layer of each point.
+  std::vector<size_t> levels;
+  //! The links of each point, on each of its layers.
+  std::vector<std::vector<std::vector<size_t>>> links;
+  //! The point where searches start (the point of the top layer).
+  size_t entryPoint;
+  //! The top layer.
+  size_t maxLevel;
+  //! The instantiated metric.
+  MetricType metric;
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_impl.hpp"
+
+#endif
@@ -0,0 +1,403 @@
+/**
+ * @file hnsw_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSetIn,
+                                            const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    ef(ef),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric)
+{
+  Train(std::move(referenceSetIn));
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t ef,
+                                            const MetricType metric) :
+    m(m),
+    efConstruction(efConstruction),
+    ef(ef),
+    entryPoint(0),
+    maxLevel(0),
+    metric(metric)
+{
+  if (m < 2)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::HNSWSearch(): m (" << m << ") must be at least 2";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  if (m < 2)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Train(): m (" << m << ") must be at least 2";
+    throw std::invalid_argument(oss.str());
+  }
+
+  referenceSet = std::move(referenceSetIn);
+  const size_t n = referenceSet.n_cols;
+
+  // The layers of the points are drawn first (and sequentially), so that the
+  // graph only depends on the random seed.
+  const double levelScale = 1.0 / std::log((double) m);
+  levels.resize(n);
+  links.clear();
+  links.resize(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    levels[i] = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelScale);
+    links[i].resize(levels[i] + 1);
+  }
+
+  entryPoint = 0;
+  maxLevel = (n == 0) ? 0 : levels[0];
+
+  std::vector<std::vector<std::vector<Candidate>>> candidates;
+  size_t inserted = std::min(n, (size_t) 1);
+  while (inserted < n)
+  {
+    const size_t batch = std::min(std::max((size_t) 1, inserted / 20),
+        n - inserted);
+    candidates.clear();
+    candidates.resize(batch);
+
+    // Find the candidate neighbors of the points of the batch on the graph of
+    // the points inserted before the batch, which is not modified here.
+    #pragma omp parallel
+    {
+      std::vector<size_t> visited;
+      size_t stamp = 0;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) batch; ++b)
+      {
+        const size_t point = inserted + b;
+        const size_t top = std::min(levels[point], maxLevel);
+
+        std::vector<Candidate> entries(1, Candidate(metric.Evaluate(
+            referenceSet.col(point), referenceSet.col(entryPoint)),
+            entryPoint));
+        for (size_t layer = maxLevel; layer > top; --layer)
+        {
+          SearchLayer(referenceSet.col(point), entries, 1, layer, visited,
+              stamp);
+        }
+
+        candidates[b].resize(top + 1);
+        for (size_t layer = top + 1; layer-- > 0; )
+        {
+          SearchLayer(referenceSet.col(point), entries, efConstruction, layer,
+              visited, stamp);
+          candidates[b][layer] = entries;
+        }
+      }
+    }
+
+    // Now link the points, in order.
+    for (size_t b = 0; b < batch; ++b)
+    {
+      const size_t point = inserted + b;
+      Link(point, candidates[b]);
+      if (levels[point] > maxLevel)
+      {
+        maxLevel = levels[point];
+        entryPoint = point;
+      }
+    }
+
+    inserted += batch;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    std::vector<size_t> visited;
+    size_t stamp = 0;
+    std::vector<Candidate> entries;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      entries.assign(1, Candidate(metric.Evaluate(querySet.col(i),
+          referenceSet.col(entryPoint)), entryPoint));
+      for (size_t layer = maxLevel; layer > 0; --layer)
+        SearchLayer(querySet.col(i), entries, 1, layer, visited, stamp);
+      SearchLayer(querySet.col(i), entries, std::max(ef, k), 0, visited,
+          stamp);
+
+      const size_t found = std::min(k, entries.size());
+      for (size_t j = 0; j < found; ++j)
+      {
+        neighbors(j, i) = entries[j].second;
+        distances(j, i) = entries[j].first;
+      }
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points (so at most " << (referenceSet.n_cols == 0 ? 0 :
+        referenceSet.n_cols - 1) << " neighbors can be found)!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Search for one more neighbor, and then remove each point from its own
+  // results (or the last result, if the point itself was not found).
+  arma::Mat<size_t> selfNeighbors;
+  arma::mat selfDistances;
+  Search(referenceSet, k + 1, selfNeighbors, selfDistances);
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    size_t out = 0;
+    for (size_t j = 0; j <= k && out < k; ++j)
+    {
+      if (selfNeighbors(j, i) == i)
+        continue;
+
+      neighbors(out, i) = selfNeighbors(j, i);
+      distances(out, i) = selfDistances(j, i);
+      ++out;
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+double HNSWSearch<MetricType, MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+    throw std::invalid_argument("HNSWSearch::ComputeRecall(): matrices "
+        "provided must have equal size");
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < foundNeighbors.n_cols; ++col)
+    for (size_t row = 0; row < realNeighbors.n_rows; ++row)
+      for (size_t nei = 0; nei < foundNeighbors.n_rows; ++nei)
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+void HNSWSearch<MetricType, MatType>::SearchLayer(
+    const VecType& query,
+    std::vector<Candidate>& entries,
+    const size_t efSearch,
+    const size_t layer,
+    std::vector<size_t>& visited,
+    size_t& stamp)
+{
+  if (visited.size() < referenceSet.n_cols)
+    visited.assign(referenceSet.n_cols, 0);
+  ++stamp;
+
+  // The candidates to expand, closest first, and the best points found so
+  // far, furthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> frontier;
+  std::priority_queue<Candidate> results;
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    visited[entries[i].second] = stamp;
+    frontier.push(entries[i]);
+    results.push(entries[i]);
+  }
+  while (results.size() > efSearch)
+    results.pop();
+
+  while (!frontier.empty())
+  {
+    const Candidate current = frontier.top();
+    if (results.size() >= efSearch && current.first > results.top().first)
+      break;
+    frontier.pop();
+
+    const std::vector<size_t>& neighbors = links[current.second][layer];
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      const size_t neighbor = neighbors[i];
+      if (visited[neighbor] == stamp)
+        continue;
+      visited[neighbor] = stamp;
+
+      const double distance = metric.Evaluate(query,
+          referenceSet.col(neighbor));
+      if (results.size() < efSearch || distance < results.top().first)
+      {
+        frontier.push(Candidate(distance, neighbor));
+        results.push(Candidate(distance, neighbor));
+        if (results.size() > efSearch)
+          results.pop();
+      }
+    }
+  }
+
+  entries.resize(results.size());
+  for (size_t i = results.size(); i > 0; --i)
+  {
+    entries[i - 1] = results.top();
+    results.pop();
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxLinks,
+    std::vector<size_t>& selected)
+{
+  selected.clear();
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxLinks; ++i)
+  {
+    bool diverse = true;
+    for (size_t j = 0; j < selected.size(); ++j)
+    {
+      if (metric.Evaluate(referenceSet.col(candidates[i].second),
+          referenceSet.col(selected[j])) < candidates[i].first)
+      {
+        diverse = false;
+        break;
+      }
+    }
+
+    if (diverse)
+      selected.push_back(candidates[i].second);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Link(
+    const size_t point,
+    const std::vector<std::vector<Candidate>>& candidates)
+{
+  std::vector<Candidate> neighborCandidates;
+  for (size_t layer = 0; layer < candidates.size(); ++layer)
+  {
+    SelectNeighbors(candidates[layer], m, links[point][layer]);
+
+    const std::vector<size_t>& selected = links[point][layer];
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+      std::vector<size_t>& neighborLinks = links[selected[i]][layer];
+      neighborLinks.push_back(point);
+      if (neighborLinks.size() <= MaxLinks(layer))
+        continue;
+
+      // Too many links: select them again among the current ones.
+      neighborCandidates.clear();
+      for (size_t j = 0; j < neighborLinks.size(); ++j)
+      {
+        neighborCandidates.push_back(Candidate(metric.Evaluate(
+            referenceSet.col(selected[i]), referenceSet.col(neighborLinks[j])),
+            neighborLinks[j]));
+      }
+      std::sort(neighborCandidates.begin(), neighborCandidates.end());
+      SelectNeighbors(neighborCandidates, MaxLinks(layer), neighborLinks);
+    }
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(m);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(ef);
+  ar & BOOST_SERIALIZATION_NVP(levels);
+  ar & BOOST_SERIALIZATION_NVP(links);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
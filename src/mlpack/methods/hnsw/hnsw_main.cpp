@@ -0,0 +1,215 @@
+/**
+ * @file hnsw_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors with a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "hnsw.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with HNSW",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search with a "
+    "hierarchical navigable small world (HNSW) graph.  Given a set of reference "
+    "points and a set of query points, this will compute the k approximate "
+    "nearest neighbors of each query point in the reference set; models can be "
+    "saved for future use.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points with a hierarchical navigable small world (HNSW) graph built on "
+    "the reference points.  You may specify a separate set of reference points "
+    "and query points, or just a reference set which will be used as both the "
+    "reference and query set (each point is then not its own neighbor)."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "Each point is linked to up to " + PRINT_PARAM_STRING("links") + " other "
+    "points on each layer of the graph (twice as many on the lowest layer), "
+    "chosen among the " + PRINT_PARAM_STRING("ef_construction") + " closest "
+    "points found when it is inserted; larger values give a better graph that "
+    "takes longer to build.  Searches keep the " + PRINT_PARAM_STRING("ef") +
+    " best points found so far, so a larger " + PRINT_PARAM_STRING("ef") +
+    " gives a better recall for a slower search; it can be changed when a "
+    "model is loaded.  The graph is built in parallel if mlpack was compiled "
+    "with OpenMP, and it only depends on the " + PRINT_PARAM_STRING("seed") +
+    " parameter.",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("Efficient and robust approximate nearest neighbor search using "
+        "Hierarchical Navigable Small World graphs (pdf)",
+        "https://arxiv.org/pdf/1603.09320.pdf"),
+    SEE_ALSO("mlpack::neighbor::HNSWSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1HNSWSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("links", "The number of links of each point on each layer of the "
+    "graph above the lowest one.", "L", 16);
+PARAM_INT_IN("ef_construction", "The number of candidate neighbors considered "
+    "when a point is inserted in the graph.", "E", 200);
+PARAM_INT_IN("ef", "The number of candidate neighbors considered by searches.",
+    "e", 50);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("links", [](int x) { return x >= 2; }, true,
+      "number of links must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef", [](int x) { return x > 0; }, true,
+      "ef must be greater than 0");
+
+  const size_t k = CLI::GetParam<int>("k");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "query");
+  ReportIgnoredParam({{ "k", false }}, "true_neighbors");
+
+  ReportIgnoredParam({{ "reference", false }}, "links");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  HNSWSearch<>* hnsw;
+  if (CLI::HasParam("reference"))
+  {
+    arma::mat referenceData = std::move(CLI::GetParam<arma::mat>("reference"));
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    hnsw = new HNSWSearch<>((size_t) CLI::GetParam<int>("links"),
+        (size_t) CLI::GetParam<int>("ef_construction"));
+
+    Timer::Start("graph_building");
+    hnsw->Train(std::move(referenceData));
+    Timer::Stop("graph_building");
+
+    Log::Info << "Built a graph with " << hnsw->Layers() << " layers." << endl;
+  }
+  else // We must have an input model.
+  {
+    hnsw = CLI::GetParam<HNSWSearch<>*>("input_model");
+  }
+
+  // The search parameter of the model is the given one, or the default one for
+  // a new model.
+  if (CLI::HasParam("ef") || CLI::HasParam("reference"))
+    hnsw->Ef() = (size_t) CLI::GetParam<int>("ef");
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  if (CLI::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " approximate nearest neighbors with ef "
+        << hnsw->Ef() << "." << endl;
+
+    Timer::Start("computing_neighbors");
+    if (CLI::HasParam("query"))
+    {
+      const arma::mat& queryData = CLI::GetParam<arma::mat>("query");
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
+
+      hnsw->Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      hnsw->Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed." << endl;
+
+    // Compute recall, if desired.
+    if (CLI::HasParam("true_neighbors"))
+    {
+      const arma::Mat<size_t>& trueNeighbors =
+          CLI::GetParam<arma::Mat<size_t>>("true_neighbors");
+
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+      }
+
+      Log::Info << "Using true neighbor indices from '"
+          << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors")
+          << "'." << endl;
+
+      const double recallPercentage = 100 * HNSWSearch<>::ComputeRecall(
+          neighbors, trueNeighbors);
+      Log::Info << "Recall: " << recallPercentage << endl;
+    }
+
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  CLI::GetParam<HNSWSearch<>*>("output_model") = hnsw;
+}
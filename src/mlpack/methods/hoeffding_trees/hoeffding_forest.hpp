@@ -0,0 +1,241 @@
+/**
+ * @file hoeffding_forest.hpp
+ *
+ * An online bagging ensemble of Hoeffding trees, as described by Oza and
+ * Russell in ``Online Bagging and Boosting''.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hoeffding_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The HoeffdingForest class is an ensemble of Hoeffding trees trained with
+ * online bagging, which is the streaming version of bagging:
+ *
+ * @code
+ * @inproceedings{oza2001online,
+ *     title={{Online Bagging and Boosting}},
+ *     author={Oza, N.C. and Russell, S.},
+ *     booktitle={Proceedings of the Eighth International Workshop on
+ *         Artificial Intelligence and Statistics (AISTATS '01)},
+ *     pages={105--112},
+ *     year={2001}
+ * }
+ * @endcode
+ *
+ * In batch bagging, each tree is trained on a bootstrap sample of the dataset,
+ * in which each point appears a binomially distributed number of times; as the
+ * dataset grows, this tends to a Poisson distribution.  So in online bagging,
+ * each tree trains on each point of the stream as many times as a draw of a
+ * Poisson distribution (of mean lambda, which is 1 for bagging).
+ *
+ * Each mini-batch given to Train() is dispatched to all the trees, and the
+ * trees are trained in parallel with OpenMP.  Each tree draws its Poisson
+ * weights from its own random number generator, so that the forest does not
+ * depend on the number of threads.  Predictions are majority votes of the
+ * trees.
+ *
+ * @tparam TreeType Type of Hoeffding tree in the forest.
+ */
+template<typename TreeType = HoeffdingTree<>>
+class HoeffdingForest
+{
+ public:
+  /**
+   * Construct an empty forest.  Train() or the other constructors must be
+   * used before the forest can classify points.
+   */
+  HoeffdingForest();
+
+  /**
+   * Construct a forest of untrained trees with the given parameters; each tree
+   * is constructed with the given parameters of HoeffdingTree.  The forest can
+   * then be trained on a stream with Train().
+   *
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param lambda Mean of the Poisson distribution of the number of times each
+   *      tree trains on each point.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split check.
+   * @param minSamples If a node has seen this many points or fewer, no split
+   *      will be allowed.
+   */
+  HoeffdingForest(const data::DatasetInfo& datasetInfo,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double lambda = 1.0,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100);
+
+  /**
+   * Construct a forest with the given parameters, and train it on the given
+   * points as one mini-batch of the stream.
+   *
+   * @param data Data points to train on.
+   * @param datasetInfo Information on the dataset (types of each feature).
+   * @param labels Labels of the data points.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of trees in the forest.
+   * @param lambda Mean of the Poisson distribution of the number of times each
+   *      tree trains on each point.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bounds before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced (0
+   *      never forces a split).
+   * @param checkInterval Number of samples required before each split check.
+   * @param minSamples If a node has seen this many points or fewer, no split
+   *      will be allowed.
+   */
+  template<typename MatType>
+  HoeffdingForest(const MatType& data,
+                  const data::DatasetInfo& datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const size_t numTrees = 10,
+                  const double lambda = 1.0,
+                  const double successProbability = 0.95,
+                  const size_t maxSamples = 0,
+                  const size_t checkInterval = 100,
+                  const size_t minSamples = 100);
+
+  /**
+   * Copy another forest (this copies every tree, which may use a lot of
+   * memory).
+   *
+   * @param other Forest to copy.
+   */
+  HoeffdingForest(const HoeffdingForest& other);
+
+  /**
+   * Copy another forest.
+   *
+   * @param other Forest to copy.
+   */
+  HoeffdingForest& operator=(const HoeffdingForest& other);
+
+  /**
+   * Clean up memory.
+   */
+  ~HoeffdingForest();
+
+  /**
+   * Train the forest on the given mini-batch of the stream.  Each tree trains
+   * in streaming mode on the points of the batch, in order, each repeated as
+   * many times as a draw of the Poisson distribution of mean Lambda(); the
+   * trees are trained in parallel.
+   *
+   * @param data Data points to train on.
+   * @param labels Labels of the data points.
+   */
+  template<typename MatType>
+  void Train(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Classify the given point with a majority vote of the trees.  Ties go to
+   * the smallest label.
+   *
+   * @param point Point to classify.
+   * @return Predicted label of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given point with a majority vote of the trees, and also
+   * return the fraction of the trees that voted for the prediction.
+   *
+   * @param point Point to classify.
+   * @param prediction Predicted label of the point.
+   * @param probability Fraction of the trees that predicted the label.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point, size_t& prediction, double& probability)
+      const;
+
+  /**
+   * Classify the given points with a majority vote of the trees.  Each tree
+   * classifies all the points, and the trees do so in parallel.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels of the points.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points with a majority vote of the trees, and also
+   * return for each point the fraction of the trees that voted for its
+   * prediction.
+   *
+   * @param data Points to classify.
+   * @param predictions Predicted labels of the points.
+   * @param probabilities Fraction of the trees that predicted each label.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::rowvec& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get a tree of the forest.
+  const TreeType& Tree(const size_t i) const { return *trees[i]; }
+  //! Modify a tree of the forest.
+  TreeType& Tree(const size_t i) { return *trees[i]; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the mean of the Poisson distribution of the weights of the points.
+  double Lambda() const { return lambda; }
+  //! Modify the mean of the Poisson distribution of the weights of the points.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the forest.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Count the votes of the trees of the given predictions (one row per tree,
+   * one column per point), and store the majority votes and the fractions of
+   * the trees that voted for them.
+   */
+  void Vote(const arma::Mat<size_t>& treePredictions,
+            arma::Row<size_t>& predictions,
+            arma::rowvec& probabilities) const;
+
+  //! The trees of the forest.
+  std::vector<TreeType*> trees;
+  //! The number of classes.
+  size_t numClasses;
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The mean of the Poisson distribution of the weights of the points.
+  double lambda;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#include "hoeffding_forest_impl.hpp"
+
+#endif
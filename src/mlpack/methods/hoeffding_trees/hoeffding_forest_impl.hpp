@@ -0,0 +1,315 @@
+/**
+ * @file hoeffding_forest_impl.hpp
+ *
+ * Implementation of the online bagging ensemble of Hoeffding trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_HOEFFDING_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hoeffding_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest() :
+    numClasses(0),
+    dimensionality(0),
+    lambda(1.0)
+{
+  // Nothing to do.
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest(
+    const data::DatasetInfo& datasetInfo,
+    const size_t numClasses,
+    const size_t numTrees,
+    const double lambda,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples) :
+    numClasses(numClasses),
+    dimensionality(datasetInfo.Dimensionality()),
+    lambda(lambda)
+{
+  if (numTrees == 0)
+  {
+    throw std::invalid_argument("HoeffdingForest::HoeffdingForest(): the "
+        "number of trees must be positive!");
+  }
+
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("HoeffdingForest::HoeffdingForest(): the "
+        "number of classes must be positive!");
+  }
+
+  if (lambda <= 0.0)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingForest::HoeffdingForest(): lambda (" << lambda << ") must "
+        << "be positive!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  trees.reserve(numTrees);
+  for (size_t i = 0; i < numTrees; ++i)
+  {
+    trees.push_back(new TreeType(datasetInfo, numClasses, successProbability,
+        maxSamples, checkInterval, minSamples));
+  }
+}
+
+template<typename TreeType>
+template<typename MatType>
+HoeffdingForest<TreeType>::HoeffdingForest(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t numTrees,
+    const double lambda,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples) :
+    HoeffdingForest(datasetInfo, numClasses, numTrees, lambda,
+        successProbability, maxSamples, checkInterval, minSamples)
+{
+  Train(data, labels);
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::HoeffdingForest(const HoeffdingForest& other) :
+    numClasses(other.numClasses),
+    dimensionality(other.dimensionality),
+    lambda(other.lambda)
+{
+  trees.reserve(other.trees.size());
+  for (size_t i = 0; i < other.trees.size(); ++i)
+    trees.push_back(new TreeType(*other.trees[i]));
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>& HoeffdingForest<TreeType>::operator=(
+    const HoeffdingForest& other)
+{
+  if (this != &other)
+  {
+    for (size_t i = 0; i < trees.size(); ++i)
+      delete trees[i];
+    trees.clear();
+
+    numClasses = other.numClasses;
+    dimensionality = other.dimensionality;
+    lambda = other.lambda;
+
+    trees.reserve(other.trees.size());
+    for (size_t i = 0; i < other.trees.size(); ++i)
+      trees.push_back(new TreeType(*other.trees[i]));
+  }
+
+  return *this;
+}
+
+template<typename TreeType>
+HoeffdingForest<TreeType>::~HoeffdingForest()
+{
+  for (size_t i = 0; i < trees.size(); ++i)
+    delete trees[i];
+}
+
+template<typename TreeType>
+template<typename MatType>
+void HoeffdingForest<TreeType>::Train(const MatType& data,
+                                      const arma::Row<size_t>& labels)
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("HoeffdingForest::Train(): the forest has no "
+        "trees!");
+  }
+
+  if (data.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingForest::Train(): dimensionality of the data ("
+        << data.n_rows << ") is not equal to the dimensionality of the forest ("
+        << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (labels.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingForest::Train(): number of labels (" << labels.n_elem
+        << ") is not equal to the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (lambda <= 0.0)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingForest::Train(): lambda (" << lambda << ") must be "
+        << "positive!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Each tree draws the weights of the points from its own generator, so the
+  // trees don't depend on the number of threads.  A tree trains on the points
+  // with positive weights, in order, each repeated as many times as its
+  // weight; that is all online bagging does.
+  const std::vector<math::RandomEngine> streams =
+      math::RandomStreams(trees.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    math::RandomEngine engine = streams[t];
+    std::poisson_distribution<size_t> poisson(lambda);
+
+    std::vector<arma::uword> points;
+    points.reserve(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t weight = poisson(engine);
+      for (size_t j = 0; j < weight; ++j)
+        points.push_back(i);
+    }
+
+    if (points.empty())
+      continue;
+
+    const arma::uvec indices(points);
+    const MatType batch = data.cols(indices);
+    const arma::Row<size_t> batchLabels = labels.cols(indices);
+    trees[t]->Train(batch, batchLabels, false);
+  }
+}
+
+template<typename TreeType>
+template<typename VecType>
+size_t HoeffdingForest<TreeType>::Classify(const VecType& point) const
+{
+  size_t prediction;
+  double probability;
+  Classify(point, prediction, probability);
+  return prediction;
+}
+
+template<typename TreeType>
+template<typename VecType>
+void HoeffdingForest<TreeType>::Classify(const VecType& point,
+                                         size_t& prediction,
+                                         double& probability) const
+{
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("HoeffdingForest::Classify(): no forest "
+        "trained!");
+  }
+
+  arma::Mat<size_t> treePredictions(trees.size(), 1);
+  for (size_t t = 0; t < trees.size(); ++t)
+    treePredictions(t, 0) = trees[t]->Classify(point);
+
+  arma::Row<size_t> predictions;
+  arma::rowvec probabilities;
+  Vote(treePredictions, predictions, probabilities);
+  prediction = predictions[0];
+  probability = probabilities[0];
+}
+
+template<typename TreeType>
+template<typename MatType>
+void HoeffdingForest<TreeType>::Classify(const MatType& data,
+                                         arma::Row<size_t>& predictions) const
+{
+  arma::rowvec probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename TreeType>
+template<typename MatType>
+void HoeffdingForest<TreeType>::Classify(const MatType& data,
+                                         arma::Row<size_t>& predictions,
+                                         arma::rowvec& probabilities) const
+{
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("HoeffdingForest::Classify(): no forest "
+        "trained!");
+  }
+
+  // Each tree classifies the whole batch; the trees do so in parallel.
+  arma::Mat<size_t> treePredictions(trees.size(), data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) trees.size(); ++t)
+  {
+    arma::Row<size_t> treePrediction;
+    trees[t]->Classify(data, treePrediction);
+    treePredictions.row(t) = treePrediction;
+  }
+
+  Vote(treePredictions, predictions, probabilities);
+}
+
+template<typename TreeType>
+void HoeffdingForest<TreeType>::Vote(const arma::Mat<size_t>& treePredictions,
+                                     arma::Row<size_t>& predictions,
+                                     arma::rowvec& probabilities) const
+{
+  predictions.set_size(treePredictions.n_cols);
+  probabilities.set_size(treePredictions.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) treePredictions.n_cols; ++i)
+  {
+    std::vector<size_t> votes(numClasses, 0);
+    for (size_t t = 0; t < treePredictions.n_rows; ++t)
+      ++votes[treePredictions(t, i)];
+
+    // The first class with the most votes wins.
+    size_t prediction = 0;
+    for (size_t c = 1; c < numClasses; ++c)
+      if (votes[c] > votes[prediction])
+        prediction = c;
+
+    predictions[i] = prediction;
+    probabilities[i] = (double) votes[prediction] / treePredictions.n_rows;
+  }
+}
+
+template<typename TreeType>
+template<typename Archive>
+void HoeffdingForest<TreeType>::serialize(Archive& ar,
+                                          const unsigned int /* version */)
+{
+  // Clear memory if needed.
+  if (Archive::is_loading::value)
+  {
+    for (size_t i = 0; i < trees.size(); ++i)
+      delete trees[i];
+    trees.clear();
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(trees);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(lambda);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -156,7 +156,10 @@ class HoeffdingTree
 
   /**
    * Train on a set of points, either in streaming mode or in batch mode, with
-   * the given labels.
+   * the given labels.  In streaming mode, the result is the same as training on
+   * each point in turn, but the points are first routed to the leaves they
+   * fall into, and the leaves are then trained in parallel (with OpenMP), each
+   * on all of its points up to its next split check at once.
    *
    * @param data Data points to train on.
    * @param label Labels of data points.
@@ -308,6 +311,21 @@ class HoeffdingTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Train the subtree rooted at this node on the given points of the dataset,
+   * in the given order.  The result is the same as calling Train(point, label)
+   * on each point in turn, but each leaf trains its splits on all the points up
+   * to its next split check at once.
+   *
+   * @param data Dataset the points belong to.
+   * @param labels Labels of the points of the dataset.
+   * @param points Indices of the points to train on.
+   */
+  template<typename MatType>
+  void TrainPoints(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const std::vector<size_t>& points);
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -245,8 +245,10 @@ void HoeffdingTree<
     // Don't split if there are fewer than five points.
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
+    std::vector<size_t> points(data.n_cols);
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+      points[i] = i;
+    TrainPoints(data, labels, points);
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -297,9 +299,123 @@ void HoeffdingTree<
   }
   else
   {
-    // We aren't training in batch mode; loop through the points.
+    // We aren't training in batch mode.  First find the leaf each point falls
+    // into; the leaves are disjoint subtrees, so then each can be trained on
+    // its points in parallel.
+    std::vector<HoeffdingTree*> leaves;
+    std::vector<std::vector<size_t>> leafPoints;
+    std::unordered_map<HoeffdingTree*, size_t> leafIndices;
     for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    {
+      HoeffdingTree* node = this;
+      while (node->splitDimension != size_t(-1))
+        node = node->children[node->CalculateDirection(data.col(i))];
+
+      std::unordered_map<HoeffdingTree*, size_t>::const_iterator it =
+          leafIndices.find(node);
+      if (it == leafIndices.end())
+      {
+        leafIndices[node] = leaves.size();
+        leaves.push_back(node);
+        leafPoints.push_back(std::vector<size_t>(1, i));
+      }
+      else
+      {
+        leafPoints[it->second].push_back(i);
+      }
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) leaves.size(); ++i)
+      leaves[i]->TrainPoints(data, labels, leafPoints[i]);
+  }
+}
+
+//! Train on the given points of a dataset.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoints(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const std::vector<size_t>& points)
+{
+  if (splitDimension != size_t(-1))
+  {
+    // Already split.  Pass each point to the relevant child, keeping the order
+    // of the points.
+    std::vector<std::vector<size_t>> childPoints(children.size());
+    for (size_t i = 0; i < points.size(); ++i)
+      childPoints[CalculateDirection(data.col(points[i]))].push_back(points[i]);
+
+    for (size_t i = 0; i < children.size(); ++i)
+      if (childPoints[i].size() > 0)
+        children[i]->TrainPoints(data, labels, childPoints[i]);
+
+    return;
+  }
+
+  size_t begin = 0;
+  while (begin < points.size())
+  {
+    // Nothing can change until the next split check, so train the splits on
+    // all the points up to there at once, one dimension at a time.
+    const size_t end = std::min(points.size(),
+        begin + checkInterval - (numSamples % checkInterval));
+
+    size_t numericIndex = 0;
+    size_t categoricalIndex = 0;
+    for (size_t d = 0; d < data.n_rows; ++d)
+    {
+      if (datasetInfo->Type(d) == data::Datatype::categorical)
+      {
+        CategoricalSplitType<FitnessFunction>& split =
+            categoricalSplits[categoricalIndex++];
+        for (size_t i = begin; i < end; ++i)
+          split.Train(data(d, points[i]), labels[points[i]]);
+      }
+      else if (datasetInfo->Type(d) == data::Datatype::numeric)
+      {
+        NumericSplitType<FitnessFunction>& split =
+            numericSplits[numericIndex++];
+        for (size_t i = begin; i < end; ++i)
+          split.Train(data(d, points[i]), labels[points[i]]);
+      }
+    }
+
+    numSamples += (end - begin);
+    begin = end;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0 && SplitCheck() > 0)
+    {
+      // The rest of the points go to the new children.
+      children.clear();
+      CreateChildren();
+      if (begin < points.size())
+      {
+        TrainPoints(data, labels,
+            std::vector<size_t>(points.begin() + begin, points.end()));
+      }
+
+      return;
+    }
   }
 }
 
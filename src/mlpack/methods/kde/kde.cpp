@@ -0,0 +1,34 @@
+/**
+ * @file kde.cpp
+ *
+ * Force instantiation of KDE with the Gaussian kernel and the default kd-tree,
+ * and of that tree, to reduce compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include "kde.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template class BinarySpaceTree<metric::EuclideanDistance,
+    kde::KDEStat,
+    arma::mat,
+    bound::HRectBound,
+    MidpointSplit>;
+
+} // namespace tree
+
+namespace kde {
+
+template class KDE<kernel::GaussianKernel,
+                   metric::EuclideanDistance,
+                   arma::mat,
+                   tree::KDTree>;
+
+} // namespace kde
+} // namespace mlpack
@@ -25,7 +25,8 @@ namespace kde /** Kernel Density Estimation. */ {
 enum KDEMode
 {
   DUAL_TREE_MODE,
-  SINGLE_TREE_MODE
+  SINGLE_TREE_MODE,
+  PARALLEL_DUAL_TREE_MODE
 };
 
 /**
@@ -70,12 +71,28 @@ class KDE
    * @param kernel Instantiated kernel object.
    * @param mode Mode for the algorithm.
    * @param metric Instantiated metric object.
+   * @param monteCarlo Whether to use Monte Carlo estimations when the kernel
+   *                   bounds are too loose to prune.
+   * @param mcProb Probability of each Monte Carlo estimation being within the
+   *               relative error tolerance (0 < mcProb < 1).
+   * @param initialSampleSize Number of samples taken at first for each Monte
+   *                          Carlo estimation (at least 2).
+   * @param mcEntryCoef Only reference nodes with at least mcEntryCoef *
+   *                    initialSampleSize descendants are sampled (>= 1).
+   * @param mcBreakCoef Monte Carlo estimations that need more than
+   *                    mcBreakCoef times the descendants of the reference node
+   *                    are abandoned (0 < mcBreakCoef <= 1).
    */
   KDE(const double relError = 0.05,
       const double absError = 0,
       KernelType kernel = KernelType(),
       const KDEMode mode = DUAL_TREE_MODE,
-      MetricType metric = MetricType());
+      MetricType metric = MetricType(),
+      const bool monteCarlo = false,
+      const double mcProb = 0.95,
+      const size_t initialSampleSize = 100,
+      const double mcEntryCoef = 3,
+      const double mcBreakCoef = 0.4);
 
   /**
    * Construct KDE object as a copy of the given model. This may be
@@ -154,7 +171,8 @@ class KDE
    *
    * - Use std::move if the query tree is no longer needed.
    *
-   * @pre The model has to be previously trained and mode has to be dual-tree.
+   * @pre The model has to be previously trained and mode has to be dual-tree
+   *      or parallel dual-tree.
    * @param queryTree Tree of query points to get the density of.
    * @param oldFromNewQueries Mappings of query points to the tree dataset.
    * @param estimations Object which will hold the density of each query point.
@@ -175,6 +193,70 @@ class KDE
    */
   void Evaluate(arma::vec& estimations);
 
+  /**
+   * Estimate density of each point in the query set given the data of the
+   * reference set, for each of the given bandwidths at once, in a single
+   * traversal (see KDEMultiRules).  The kernel of each bandwidth is
+   * KernelType(bandwidth), and row b of the estimations is the result of
+   * Evaluate() with the kernel of bandwidth b, within the same error
+   * tolerances.  Monte Carlo estimations are not used.  In parallel dual-tree
+   * mode, the serial dual-tree traversal is used.
+   *
+   * @pre The model has to be previously trained.
+   * @param querySet Set of query points to get the density of.
+   * @param bandwidths Bandwidths to evaluate the densities with.
+   * @param estimations Matrix which will hold the density of each query point
+   *                    (one column) for each bandwidth (one row).
+   */
+  void Evaluate(MatType querySet,
+                const arma::vec& bandwidths,
+                arma::mat& estimations);
+
+  /**
+   * Estimate density of each point in the reference set given the data of the
+   * reference set, for each of the given bandwidths at once, in a single
+   * traversal.  It does not compute the estimation of a point with itself, so
+   * these are the leave-one-out estimations used by likelihood
+   * cross-validation of the bandwidth.
+   *
+   * @pre The model has to be previously trained.
+   * @param bandwidths Bandwidths to evaluate the densities with.
+   * @param estimations Matrix which will hold the density of each reference
+   *                    point (one column) for each bandwidth (one row).
+   */
+  void Evaluate(const arma::vec& bandwidths, arma::mat& estimations);
+
+  /**
+   * Estimate density of each point in the query set within a budget, so that
+   * the time of each query is bounded.  Regardless of the mode, each query
+   * point traverses the reference tree best first (see
+   * tree::BestFirstSingleTreeTraverser), so that the closest nodes are visited
+   * first, until the tree is exhausted or the budget of base cases or time of
+   * the query point is spent.  The contributions of the nodes that were not
+   * visited are then estimated with their centroids.
+   *
+   * For each query point, errors holds the largest error that these last
+   * estimations can add, on top of the error tolerances of the model (and of
+   * the Monte Carlo estimations, if they are used); it is 0 if the traversal
+   * finished.  This can't be used with trees that hold points in their inner
+   * nodes (like the cover tree).
+   *
+   * @pre The model has to be previously trained.
+   * @param querySet Set of query points to get the density of.
+   * @param maxBaseCases Largest number of base cases for each query point (0
+   *                     for no limit).
+   * @param maxTime Largest wall clock time in seconds for each query point (0
+   *                for no limit).
+   * @param estimations Object which will hold the density of each query point.
+   * @param errors Object which will hold the largest error added to the
+   *               estimation of each query point by the budget.
+   */
+  void AnytimeEvaluate(const MatType& querySet,
+                       const size_t maxBaseCases,
+                       const double maxTime,
+                       arma::vec& estimations,
+                       arma::vec& errors);
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
 
@@ -214,6 +296,36 @@ class KDE
   //! Modify the mode of KDE.
   KDEMode& Mode() { return mode; }
 
+  //! Get whether Monte Carlo estimations are used.
+  bool MonteCarlo() const { return monteCarlo; }
+
+  //! Modify whether Monte Carlo estimations are used.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability of Monte Carlo estimations being within bounds.
+  double MCProb() const { return mcProb; }
+
+  //! Modify the probability of Monte Carlo estimations (0 < newProb < 1).
+  void MCProb(const double newProb);
+
+  //! Get the initial sample size of Monte Carlo estimations.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+
+  //! Modify the initial sample size of Monte Carlo estimations (>= 2).
+  void MCInitialSampleSize(const size_t newSize);
+
+  //! Get the Monte Carlo entry coefficient.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+
+  //! Modify the Monte Carlo entry coefficient (newCoef >= 1).
+  void MCEntryCoefficient(const double newCoef);
+
+  //! Get the Monte Carlo break coefficient.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+
+  //! Modify the Monte Carlo break coefficient (0 < newCoef <= 1).
+  void MCBreakCoefficient(const double newCoef);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -246,12 +358,53 @@ class KDE
   //! Mode of the KDE algorithm.
   KDEMode mode;
 
+  //! If true, Monte Carlo estimations are used when bounds are loose.
+  bool monteCarlo;
+
+  //! Probability of each Monte Carlo estimation being within bounds.
+  double mcProb;
+
+  //! Initial sample size of Monte Carlo estimations.
+  size_t initialSampleSize;
+
+  //! Minimum reference node size, in initial samples, to try sampling.
+  double mcEntryCoef;
+
+  //! Fraction of a reference node above which sampling is abandoned.
+  double mcBreakCoef;
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
+  //! Check whether Monte Carlo parameters are valid.
+  static void CheckMonteCarloValues(const double mcProb,
+                                    const size_t initialSampleSize,
+                                    const double mcEntryCoef,
+                                    const double mcBreakCoef);
+
+  /**
+   * Split the query tree into disjoint subtrees and traverse each of them
+   * against the reference tree in parallel.  Each subtree owns a disjoint set
+   * of entries of the estimations vector, so no synchronization is needed, and
+   * the error bounds of KDERules hold for each query point as in the serial
+   * dual-tree traversal.
+   */
+  void ParallelDualTreeTraversal(Tree* queryTree,
+                                 const bool sameSet,
+                                 arma::vec& estimations,
+                                 size_t& baseCases,
+                                 size_t& scores);
+
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
+
+  //! Rearrange the columns of the estimations matrix if required.
+  static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
+                                   arma::mat& estimations);
+
+  //! Build the kernels of the given bandwidths, after checking them.
+  static std::vector<KernelType> BandwidthKernels(const arma::vec& bandwidths);
 };
 
 } // namespace kde
@@ -260,4 +413,38 @@ class KDE
 // Include implementation.
 #include "kde_impl.hpp"
 
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.  KDE with the Gaussian kernel and the default kd-tree, and that
+ * kd-tree, are compiled once in the mlpack library (see kde.cpp), instead of
+ * in each program that uses them.
+ *
+ * @cond
+ */
+
+namespace mlpack {
+namespace tree {
+
+extern template class BinarySpaceTree<metric::EuclideanDistance,
+    kde::KDEStat,
+    arma::mat,
+    bound::HRectBound,
+    MidpointSplit>;
+
+} // namespace tree
+
+namespace kde {
+
+extern template class KDE<kernel::GaussianKernel,
+                          metric::EuclideanDistance,
+                          arma::mat,
+                          tree::KDTree>;
+
+} // namespace kde
+} // namespace mlpack
+
+/**
+ * @endcond
+ */
+
 #endif // MLPACK_METHODS_KDE_KDE_HPP
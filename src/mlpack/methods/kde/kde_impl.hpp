@@ -12,6 +12,12 @@
 
 #include "kde.hpp"
 #include "kde_rules.hpp"
+#include "kde_multi_rules.hpp"
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace kde {
@@ -56,7 +62,12 @@ KDE(const double relError,
     const double absError,
     KernelType kernel,
     const KDEMode mode,
-    MetricType metric) :
+    MetricType metric,
+    const bool monteCarlo,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef) :
     kernel(kernel),
     metric(metric),
     referenceTree(nullptr),
@@ -65,9 +76,15 @@ KDE(const double relError,
     absError(absError),
     ownsReferenceTree(false),
     trained(false),
-    mode(mode)
+    mode(mode),
+    monteCarlo(monteCarlo),
+    mcProb(mcProb),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef)
 {
   CheckErrorValues(relError, absError);
+  CheckMonteCarloValues(mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef);
 }
 
 template<typename KernelType,
@@ -91,7 +108,12 @@ KDE(const KDE& other) :
     absError(other.absError),
     ownsReferenceTree(other.ownsReferenceTree),
     trained(other.trained),
-    mode(other.mode)
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef)
 {
   if (trained)
   {
@@ -132,7 +154,12 @@ KDE(KDE&& other) :
     absError(other.absError),
     ownsReferenceTree(other.ownsReferenceTree),
     trained(other.trained),
-    mode(other.mode)
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef)
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -181,6 +208,11 @@ operator=(KDE other)
   this->ownsReferenceTree = other.ownsReferenceTree;
   this->trained = other.trained;
   this->mode = other.mode;
+  this->monteCarlo = other.monteCarlo;
+  this->mcProb = other.mcProb;
+  this->initialSampleSize = other.initialSampleSize;
+  this->mcEntryCoef = other.mcEntryCoef;
+  this->mcBreakCoef = other.mcBreakCoef;
 
   return *this;
 }
@@ -297,7 +329,7 @@ void KDE<KernelType,
          SingleTreeTraversalType>::
 Evaluate(MatType querySet, arma::vec& estimations)
 {
-  if (mode == DUAL_TREE_MODE)
+  if (mode == DUAL_TREE_MODE || mode == PARALLEL_DUAL_TREE_MODE)
   {
     Timer::Start("building_query_tree");
     std::vector<size_t> oldFromNewQueries;
@@ -346,7 +378,12 @@ Evaluate(MatType querySet, arma::vec& estimations)
                               absError,
                               metric,
                               kernel,
-                              false);
+                              false,
+                              monteCarlo,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef);
 
     // Create traverser.
     SingleTreeTraversalType<RuleType> traverser(rules);
@@ -365,6 +402,97 @@ Evaluate(MatType querySet, arma::vec& estimations)
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+AnytimeEvaluate(const MatType& querySet,
+                const size_t maxBaseCases,
+                const double maxTime,
+                arma::vec& estimations,
+                arma::vec& errors)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  // Check whether dimensions match.
+  if (querySet.n_cols > 0 &&
+      querySet.n_rows != referenceTree->Dataset().n_rows)
+  {
+    throw std::invalid_argument("cannot evaluate KDE model: querySet and "
+                                "referenceSet dimensions don't match");
+  }
+
+  if (maxTime < 0.0)
+  {
+    std::ostringstream oss;
+    oss << "KDE::AnytimeEvaluate(): maxTime must be non-negative (given "
+        << maxTime << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  estimations.zeros(querySet.n_cols);
+  errors.zeros(querySet.n_cols);
+
+  Timer::Start("computing_kde");
+
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+  RuleType rules = RuleType(referenceTree->Dataset(),
+                            querySet,
+                            estimations,
+                            relError,
+                            absError,
+                            metric,
+                            kernel,
+                            false,
+                            monteCarlo,
+                            mcProb,
+                            initialSampleSize,
+                            mcEntryCoef,
+                            mcBreakCoef);
+
+  typedef tree::BestFirstSingleTreeTraverser<Tree, RuleType> TraverserType;
+  TraverserType traverser(rules, maxBaseCases, maxTime);
+
+  size_t unfinished = 0;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (traverser.Traverse(i, *referenceTree))
+      continue;
+
+    // Estimate what is left with the centroids.
+    const std::vector<typename TraverserType::NodeAndScore>& remaining =
+        traverser.Remaining();
+    for (size_t j = 0; j < remaining.size(); ++j)
+      errors[i] += rules.Approximate(i, *remaining[j].second);
+    ++unfinished;
+  }
+
+  estimations /= referenceTree->Dataset().n_cols;
+  errors /= referenceTree->Dataset().n_cols;
+  Timer::Stop("computing_kde");
+
+  Log::Info << rules.Scores() << " node combinations were scored."
+            << std::endl;
+  Log::Info << rules.BaseCases() << " base cases were calculated."
+            << std::endl;
+  Log::Info << unfinished << " query points ran out of budget." << std::endl;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -411,7 +539,7 @@ Evaluate(Tree* queryTree,
   }
 
   // Check the mode is correct.
-  if (mode != DUAL_TREE_MODE)
+  if (mode != DUAL_TREE_MODE && mode != PARALLEL_DUAL_TREE_MODE)
   {
     throw std::invalid_argument("cannot evaluate KDE model: cannot use "
                                 "a query tree when mode is different from "
@@ -421,27 +549,43 @@ Evaluate(Tree* queryTree,
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            metric,
-                            kernel,
-                            false);
+  size_t baseCases, scores;
+  if (mode == PARALLEL_DUAL_TREE_MODE)
+  {
+    ParallelDualTreeTraversal(queryTree, false, estimations, baseCases,
+        scores);
+  }
+  else
+  {
+    typedef KDERules<MetricType, KernelType, Tree> RuleType;
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              queryTree->Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              metric,
+                              kernel,
+                              false,
+                              monteCarlo,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef);
 
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+    // Create traverser.
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*queryTree, *referenceTree);
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
   estimations /= referenceTree->Dataset().n_cols;
   Timer::Stop("computing_kde");
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -475,27 +619,44 @@ Evaluate(arma::vec& estimations)
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            metric,
-                            kernel,
-                            true);
-
-  if (mode == DUAL_TREE_MODE)
+  size_t baseCases = 0, scores = 0;
+  if (mode == PARALLEL_DUAL_TREE_MODE)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    ParallelDualTreeTraversal(referenceTree, true, estimations, baseCases,
+        scores);
   }
-  else if (mode == SINGLE_TREE_MODE)
+  else
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    typedef KDERules<MetricType, KernelType, Tree> RuleType;
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              referenceTree->Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              metric,
+                              kernel,
+                              true,
+                              monteCarlo,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef);
+
+    if (mode == DUAL_TREE_MODE)
+    {
+      // Create traverser.
+      DualTreeTraversalType<RuleType> traverser(rules);
+      traverser.Traverse(*referenceTree, *referenceTree);
+    }
+    else if (mode == SINGLE_TREE_MODE)
+    {
+      SingleTreeTraversalType<RuleType> traverser(rules);
+      for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
+    }
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
   }
 
   estimations /= referenceTree->Dataset().n_cols;
@@ -503,8 +664,8 @@ Evaluate(arma::vec& estimations)
   RearrangeEstimations(*oldFromNewReferences, estimations);
   Timer::Stop("computing_kde");
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -547,6 +708,86 @@ AbsoluteError(const double newError)
   absError = newError;
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCProb(const double newProb)
+{
+  CheckMonteCarloValues(newProb, initialSampleSize, mcEntryCoef, mcBreakCoef);
+  mcProb = newProb;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCInitialSampleSize(const size_t newSize)
+{
+  CheckMonteCarloValues(mcProb, newSize, mcEntryCoef, mcBreakCoef);
+  initialSampleSize = newSize;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCEntryCoefficient(const double newCoef)
+{
+  CheckMonteCarloValues(mcProb, initialSampleSize, newCoef, mcBreakCoef);
+  mcEntryCoef = newCoef;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCBreakCoefficient(const double newCoef)
+{
+  CheckMonteCarloValues(mcProb, initialSampleSize, mcEntryCoef, newCoef);
+  mcBreakCoef = newCoef;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -569,6 +810,11 @@ serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(absError);
   ar & BOOST_SERIALIZATION_NVP(trained);
   ar & BOOST_SERIALIZATION_NVP(mode);
+  ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+  ar & BOOST_SERIALIZATION_NVP(mcProb);
+  ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+  ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+  ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
 
   // If we are loading, clean up memory if necessary.
   if (Archive::is_loading::value)
@@ -617,6 +863,283 @@ CheckErrorValues(const double relError, const double absError)
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+CheckMonteCarloValues(const double mcProb,
+                      const size_t initialSampleSize,
+                      const double mcEntryCoef,
+                      const double mcBreakCoef)
+{
+  if (mcProb <= 0 || mcProb >= 1)
+  {
+    throw std::invalid_argument("Monte Carlo probability must be a value "
+                                "between 0 and 1 (exclusive)");
+  }
+  if (initialSampleSize < 2)
+  {
+    throw std::invalid_argument("Monte Carlo initial sample size must be at "
+                                "least 2");
+  }
+  if (mcEntryCoef < 1)
+  {
+    throw std::invalid_argument("Monte Carlo entry coefficient must be a "
+                                "value greater or equal to 1");
+  }
+  if (mcBreakCoef <= 0 || mcBreakCoef > 1)
+  {
+    throw std::invalid_argument("Monte Carlo break coefficient must be a "
+                                "value between 0 (exclusive) and 1");
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ParallelDualTreeTraversal(Tree* queryTree,
+                          const bool sameSet,
+                          arma::vec& estimations,
+                          size_t& baseCases,
+                          size_t& scores)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+
+  // Use a few subtrees per thread so that the dynamic schedule can balance
+  // subtrees that are more expensive to traverse than others.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t targetSubtrees = 4 * numThreads;
+
+  // Expand the query tree level by level until there are enough subtrees.  The
+  // descendants of the children of a node partition the descendants of the
+  // node, so every query point belongs to exactly one subtree.
+  std::vector<Tree*> subtrees(1, queryTree);
+  bool expanded = true;
+  while (subtrees.size() < targetSubtrees && expanded)
+  {
+    expanded = false;
+    std::vector<Tree*> nextSubtrees;
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (subtrees[i]->NumChildren() == 0)
+      {
+        nextSubtrees.push_back(subtrees[i]);
+        continue;
+      }
+
+      for (size_t j = 0; j < subtrees[i]->NumChildren(); ++j)
+        nextSubtrees.push_back(&subtrees[i]->Child(j));
+      expanded = true;
+    }
+    subtrees.swap(nextSubtrees);
+  }
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalBaseCases, totalScores)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    // Each thread gets its own copy of the metric and the kernel, in case they
+    // hold state.
+    MetricType subtreeMetric(metric);
+    KernelType subtreeKernel(kernel);
+    RuleType rules(referenceTree->Dataset(),
+                   queryTree->Dataset(),
+                   estimations,
+                   relError,
+                   absError,
+                   subtreeMetric,
+                   subtreeKernel,
+                   sameSet,
+                   monteCarlo,
+                   mcProb,
+                   initialSampleSize,
+                   mcEntryCoef,
+                   mcBreakCoef);
+
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*subtrees[i], *referenceTree);
+
+    totalBaseCases += rules.BaseCases();
+    totalScores += rules.Scores();
+  }
+
+  baseCases = totalBaseCases;
+  scores = totalScores;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Evaluate(MatType querySet,
+         const arma::vec& bandwidths,
+         arma::mat& estimations)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  const std::vector<KernelType> kernels = BandwidthKernels(bandwidths);
+  estimations.zeros(bandwidths.n_elem, querySet.n_cols);
+
+  // Check querySet has at least 1 element to evaluate.
+  if (querySet.n_cols == 0)
+  {
+    Log::Warn << "KDE::Evaluate(): querySet is empty, no predictions will "
+              << "be returned" << std::endl;
+    return;
+  }
+
+  // Check whether dimensions match.
+  if (querySet.n_rows != referenceTree->Dataset().n_rows)
+  {
+    throw std::invalid_argument("cannot evaluate KDE model: querySet and "
+                                "referenceSet dimensions don't match");
+  }
+
+  typedef KDEMultiRules<MetricType, KernelType, Tree> RuleType;
+  size_t baseCases, scores;
+  if (mode == SINGLE_TREE_MODE)
+  {
+    Timer::Start("computing_kde");
+    RuleType rules(referenceTree->Dataset(), querySet, estimations, relError,
+        absError, metric, kernels, false);
+
+    // Traverse for each point.
+    SingleTreeTraversalType<RuleType> traverser(rules);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    estimations /= referenceTree->Dataset().n_cols;
+    Timer::Stop("computing_kde");
+  }
+  else
+  {
+    Timer::Start("building_query_tree");
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(std::move(querySet), oldFromNewQueries);
+    Timer::Stop("building_query_tree");
+
+    Timer::Start("computing_kde");
+    RuleType rules(referenceTree->Dataset(), queryTree->Dataset(), estimations,
+        relError, absError, metric, kernels, false);
+
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*queryTree, *referenceTree);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+    estimations /= referenceTree->Dataset().n_cols;
+    Timer::Stop("computing_kde");
+
+    // Rearrange if necessary.
+    RearrangeEstimations(oldFromNewQueries, estimations);
+    delete queryTree;
+  }
+
+  Log::Info << scores << " node combinations were scored for "
+            << bandwidths.n_elem << " bandwidths." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Evaluate(const arma::vec& bandwidths, arma::mat& estimations)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  const std::vector<KernelType> kernels = BandwidthKernels(bandwidths);
+  estimations.zeros(bandwidths.n_elem, referenceTree->Dataset().n_cols);
+
+  Timer::Start("computing_kde");
+
+  // Evaluate.
+  typedef KDEMultiRules<MetricType, KernelType, Tree> RuleType;
+  RuleType rules(referenceTree->Dataset(), referenceTree->Dataset(),
+      estimations, relError, absError, metric, kernels, true);
+
+  if (mode == SINGLE_TREE_MODE)
+  {
+    SingleTreeTraversalType<RuleType> traverser(rules);
+    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
+      traverser.Traverse(i, *referenceTree);
+  }
+  else
+  {
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*referenceTree, *referenceTree);
+  }
+
+  estimations /= referenceTree->Dataset().n_cols;
+  // Rearrange if necessary.
+  RearrangeEstimations(*oldFromNewReferences, estimations);
+  Timer::Stop("computing_kde");
+
+  Log::Info << rules.Scores() << " node combinations were scored for "
+            << bandwidths.n_elem << " bandwidths." << std::endl;
+  Log::Info << rules.BaseCases() << " base cases were calculated."
+            << std::endl;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -647,5 +1170,72 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+RearrangeEstimations(const std::vector<size_t>& oldFromNew,
+                     arma::mat& estimations)
+{
+  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    const size_t nQueries = oldFromNew.size();
+    arma::mat rearrangedEstimations(estimations.n_rows, nQueries);
+
+    // Remap columns.
+    for (size_t i = 0; i < nQueries; ++i)
+      rearrangedEstimations.col(oldFromNew.at(i)) = estimations.col(i);
+
+    estimations = std::move(rearrangedEstimations);
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+std::vector<KernelType> KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+BandwidthKernels(const arma::vec& bandwidths)
+{
+  if (bandwidths.n_elem == 0)
+    throw std::invalid_argument("KDE::Evaluate(): no bandwidths given");
+
+  std::vector<KernelType> kernels;
+  kernels.reserve(bandwidths.n_elem);
+  for (size_t b = 0; b < bandwidths.n_elem; ++b)
+  {
+    if (!(bandwidths[b] > 0.0))
+    {
+      std::ostringstream oss;
+      oss << "KDE::Evaluate(): bandwidth " << bandwidths[b] << " must be "
+          << "positive";
+      throw std::invalid_argument(oss.str());
+    }
+
+    kernels.push_back(KernelType(bandwidths[b]));
+  }
+
+  return kernels;
+}
+
 } // namespace kde
 } // namespace mlpack
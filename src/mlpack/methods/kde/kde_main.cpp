@@ -11,6 +11,8 @@
  */
 
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
+#include <mlpack/core/data/for_each_batch.hpp>
 
 #include "kde.hpp"
 #include "kde_model.hpp"
@@ -48,7 +50,9 @@ PROGRAM_INFO("Kernel Density Estimation",
     "type of tree to use for the dual-tree algorithm with " +
     PRINT_PARAM_STRING("tree") + ". It is also possible to select whether to "
     "use dual-tree algorithm or single-tree algorithm using the " +
-    PRINT_PARAM_STRING("algorithm") + " option."
+    PRINT_PARAM_STRING("algorithm") + " option.  The 'parallel-dual-tree' "
+    "algorithm splits the dual-tree computation across " +
+    PRINT_PARAM_STRING("threads") + " threads."
     "\n\n"
     "For example, the following will run KDE using the data in " +
     PRINT_DATASET("ref_data") + " for training and the data in " +
@@ -68,7 +72,14 @@ PROGRAM_INFO("Kernel Density Estimation",
     "computed on the " + PRINT_PARAM_STRING("reference") + " dataset."
     "\n"
     "It is possible to select either a reference dataset or an input model "
-    "but not both at the same time.",
+    "but not both at the same time."
+    "\n\n"
+    "Query sets too large to be held in memory can be given with " +
+    PRINT_PARAM_STRING("query_file") + " instead; the file (.mmat, .csv, .txt, "
+    "or .tsv) is then read " + PRINT_PARAM_STRING("query_batch_size") + " "
+    "points at a time, and the estimations of each batch are written to the "
+    "file given with " + PRINT_PARAM_STRING("predictions_file") + " before the "
+    "next batch is read.",
     SEE_ALSO("@knn", "#knn"),
     SEE_ALSO("Kernel density estimation on Wikipedia",
         "https://en.wikipedia.org/wiki/Kernel_density_estimation"),
@@ -98,8 +109,10 @@ PARAM_STRING_IN("tree", "Tree to use for the prediction."
     "('kd-tree', 'ball-tree', 'cover-tree', 'octree', 'r-tree').",
     "t", "kd-tree");
 PARAM_STRING_IN("algorithm", "Algorithm to use for the prediction."
-    "('dual-tree', 'single-tree').",
+    "('dual-tree', 'single-tree', 'parallel-dual-tree').",
     "a", "dual-tree");
+PARAM_INT_IN("threads", "Number of threads to use for the 'parallel-dual-tree' "
+    "algorithm (if 0, the OpenMP default is used).", "j", 0);
 PARAM_DOUBLE_IN("rel_error",
                 "Relative error tolerance for the prediction.",
                 "e",
@@ -109,10 +122,36 @@ PARAM_DOUBLE_IN("abs_error",
                 "E",
                 0.0);
 
+// Monte Carlo options.
+PARAM_FLAG("monte_carlo", "Whether to estimate the contributions of large "
+    "reference nodes by sampling when the kernel bounds are too loose to prune."
+    "  Estimations are then only within the relative error tolerance with "
+    "the probability given by mc_probability.", "S");
+PARAM_DOUBLE_IN("mc_probability", "Probability of each Monte Carlo estimation "
+    "being within the relative error tolerance.", "P", 0.95);
+PARAM_INT_IN("initial_sample_size", "Initial number of samples of each Monte "
+    "Carlo estimation.", "n", 100);
+PARAM_DOUBLE_IN("mc_entry_coef", "Only reference nodes with at least "
+    "mc_entry_coef times the initial sample size points are sampled.", "C",
+    3.0);
+PARAM_DOUBLE_IN("mc_break_coef", "Monte Carlo estimations that need more "
+    "than mc_break_coef times the points of the reference node are "
+    "abandoned.", "N", 0.4);
+
 // Output predictions options.
 PARAM_COL_OUT("predictions", "Vector to store density predictions.",
     "p");
 
+// Instead, the query points may be read from a file a batch at a time, and the
+// estimations of each batch written before the next batch is read.
+PARAM_STRING_IN("query_file", "File holding query points to estimate the "
+    "density of in batches, without loading them into memory (instead of "
+    "--query).", "Q", "");
+PARAM_STRING_IN("predictions_file", "File to write the density predictions of "
+    "the points of --query_file to, a batch at a time.", "O", "");
+PARAM_INT_IN("query_batch_size", "Number of points read from --query_file at "
+    "a time.", "B", 100000);
+
 // Maybe, in the future, it could be interesting to implement different metrics.
 
 static void mlpackMain()
@@ -135,18 +174,62 @@ static void mlpackMain()
   ReportIgnoredParam({{ "input_model", true }}, "rel_error");
   ReportIgnoredParam({{ "input_model", true }}, "abs_error");
 
+  // The query points can't be given both ways.
+  if (CLI::HasParam("query") && CLI::HasParam("query_file"))
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("query")
+        << " or " << PRINT_PARAM_STRING("query_file") << "!" << endl;
+  }
+  ReportIgnoredParam({{ "query_file", false }}, "predictions_file");
+  ReportIgnoredParam({{ "query_file", false }}, "query_batch_size");
+  ReportIgnoredParam({{ "query_file", true }}, "predictions");
+  RequireParamValue<int>("query_batch_size", [](int x) { return x > 0; },
+      true, "query batch size must be positive");
+
   // Requirements for parameter values.
   RequireParamInSet<string>("kernel", { "gaussian", "epanechnikov",
       "laplacian", "spherical", "triangular" }, true, "unknown kernel type");
   RequireParamInSet<string>("tree", { "kd-tree", "ball-tree", "cover-tree",
       "octree", "r-tree"}, true, "unknown tree type");
-  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree"},
-      true, "unknown algorithm");
+  RequireParamInSet<string>("algorithm", { "dual-tree", "single-tree",
+      "parallel-dual-tree" }, true, "unknown algorithm");
   RequireParamValue<double>("rel_error", [](double x){return x >= 0 && x <= 1;},
       true, "relative error must be between 0 and 1");
   RequireParamValue<double>("abs_error", [](double x){return x >= 0;},
       true, "absolute error must be equal or greater than 0");
 
+  RequireParamValue<double>("mc_probability",
+      [](double x){return x > 0 && x < 1;}, true,
+      "Monte Carlo probability must be between 0 and 1 (exclusive)");
+  RequireParamValue<int>("initial_sample_size", [](int x){return x >= 2;},
+      true, "initial sample size must be at least 2");
+  RequireParamValue<double>("mc_entry_coef", [](double x){return x >= 1;},
+      true, "Monte Carlo entry coefficient must be at least 1");
+  RequireParamValue<double>("mc_break_coef",
+      [](double x){return x > 0 && x <= 1;}, true,
+      "Monte Carlo break coefficient must be between 0 (exclusive) and 1");
+  if (!CLI::HasParam("monte_carlo"))
+  {
+    ReportIgnoredParam("mc_probability", "Monte Carlo is not being used");
+    ReportIgnoredParam("initial_sample_size", "Monte Carlo is not being used");
+    ReportIgnoredParam("mc_entry_coef", "Monte Carlo is not being used");
+    ReportIgnoredParam("mc_break_coef", "Monte Carlo is not being used");
+  }
+
+  // Sanity check on the number of threads.
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be non-negative");
+  if (modeStr != "parallel-dual-tree")
+    ReportIgnoredParam("threads", "parallel dual-tree KDE is not being used");
+  #ifdef HAS_OPENMP
+  if (CLI::GetParam<int>("threads") > 0)
+    omp_set_num_threads(CLI::GetParam<int>("threads"));
+  #else
+  if (CLI::GetParam<int>("threads") > 1)
+    Log::Warn << "mlpack was not compiled with OpenMP support, so only one "
+        << "thread will be used." << endl;
+  #endif
+
   KDEModel* kde;
 
   if (CLI::HasParam("reference"))
@@ -191,6 +274,8 @@ static void mlpackMain()
       kde->Mode() = KDEMode::DUAL_TREE_MODE;
     else if (modeStr == "single-tree")
       kde->Mode() = KDEMode::SINGLE_TREE_MODE;
+    else if (modeStr == "parallel-dual-tree")
+      kde->Mode() = KDEMode::PARALLEL_DUAL_TREE_MODE;
   }
   else
   {
@@ -198,8 +283,45 @@ static void mlpackMain()
     kde = CLI::GetParam<KDEModel*>("input_model");
   }
 
+  // Monte Carlo settings don't depend on the tree, so they can also be
+  // changed for a loaded model.
+  if (CLI::HasParam("reference") || CLI::HasParam("monte_carlo"))
+  {
+    kde->MonteCarlo() = CLI::HasParam("monte_carlo");
+    kde->MCProb() = CLI::GetParam<double>("mc_probability");
+    kde->MCInitialSampleSize() =
+        (size_t) CLI::GetParam<int>("initial_sample_size");
+    kde->MCEntryCoefficient() = CLI::GetParam<double>("mc_entry_coef");
+    kde->MCBreakCoefficient() = CLI::GetParam<double>("mc_break_coef");
+  }
+
   // Evaluation.
-  if (CLI::HasParam("query"))
+  if (CLI::HasParam("query_file"))
+  {
+    // Evaluate the query points a batch at a time, and write the estimations
+    // of each batch before the next one is read.
+    const size_t batchSize = (size_t) CLI::GetParam<int>("query_batch_size");
+    data::BatchReader reader(CLI::GetParam<string>("query_file"));
+
+    std::unique_ptr<data::BatchWriter> writer;
+    if (CLI::HasParam("predictions_file"))
+    {
+      writer.reset(new data::BatchWriter(
+          CLI::GetParam<string>("predictions_file"), 1));
+    }
+
+    data::ForEachBatch(reader, batchSize,
+        [&](const arma::mat& batch, const size_t /* offset */)
+        {
+          kde->Evaluate(arma::mat(batch), estimations);
+          if (writer)
+            writer->Write(arma::mat(estimations.t()));
+        });
+
+    if (writer)
+      writer->Close();
+  }
+  else if (CLI::HasParam("query"))
   {
     arma::mat query = std::move(CLI::GetParam<arma::mat>("query"));
     kde->Evaluate(std::move(query), estimations);
@@ -182,6 +182,40 @@ class ModeVisitor : public boost::static_visitor<KDEMode&>
   KDEMode& operator()(KDEType* kde) const;
 };
 
+/**
+ * MonteCarloVisitor sets the Monte Carlo parameters of the KDEType.
+ */
+class MonteCarloVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Whether to use Monte Carlo estimations.
+  const bool monteCarlo;
+
+  //! Probability of each estimation being within bounds.
+  const double mcProb;
+
+  //! Initial sample size.
+  const size_t initialSampleSize;
+
+  //! Entry coefficient.
+  const double mcEntryCoef;
+
+  //! Break coefficient.
+  const double mcBreakCoef;
+
+ public:
+  //! Set the Monte Carlo parameters of the KDEType instance.
+  template<typename KDEType>
+  void operator()(KDEType* kde) const;
+
+  //! MonteCarloVisitor constructor.
+  MonteCarloVisitor(const bool monteCarlo,
+                    const double mcProb,
+                    const size_t initialSampleSize,
+                    const double mcEntryCoef,
+                    const double mcBreakCoef);
+};
+
 class DeleteVisitor : public boost::static_visitor<void>
 {
  public:
@@ -227,6 +261,21 @@ class KDEModel
   //! Type of tree.
   TreeTypes treeType;
 
+  //! Whether to use Monte Carlo estimations.
+  bool monteCarlo;
+
+  //! Probability of each Monte Carlo estimation being within bounds.
+  double mcProb;
+
+  //! Initial sample size of Monte Carlo estimations.
+  size_t initialSampleSize;
+
+  //! Monte Carlo entry coefficient.
+  double mcEntryCoef;
+
+  //! Monte Carlo break coefficient.
+  double mcBreakCoef;
+
   /**
    * kdeModel holds an instance of each possible combination of KernelType and
    * TreeType. It is initialized using BuildModel.
@@ -270,12 +319,24 @@ class KDEModel
    *                 value can have a maximum error of 0.1 units.
    * @param kernelType Type of kernel to use.
    * @param treeType Type of tree to use.
+   * @param monteCarlo Whether to use Monte Carlo estimations when the kernel
+   *                   bounds are too loose to prune.
+   * @param mcProb Probability of each Monte Carlo estimation being within the
+   *               relative error tolerance.
+   * @param initialSampleSize Initial sample size of Monte Carlo estimations.
+   * @param mcEntryCoef Monte Carlo entry coefficient; see KDE.
+   * @param mcBreakCoef Monte Carlo break coefficient; see KDE.
    */
   KDEModel(const double bandwidth = 1.0,
            const double relError = 0.05,
            const double absError = 0,
            const KernelTypes kernelType = KernelTypes::GAUSSIAN_KERNEL,
-           const TreeTypes treeType = TreeTypes::KD_TREE);
+           const TreeTypes treeType = TreeTypes::KD_TREE,
+           const bool monteCarlo = false,
+           const double mcProb = 0.95,
+           const size_t initialSampleSize = 100,
+           const double mcEntryCoef = 3,
+           const double mcBreakCoef = 0.4);
 
   //! Copy constructor of the given model.
   KDEModel(const KDEModel& other);
@@ -329,6 +390,36 @@ class KDEModel
   //! Modify the kernel type of the model.
   KernelTypes& KernelType() { return kernelType; }
 
+  //! Get whether Monte Carlo estimations are used.
+  bool MonteCarlo() const { return monteCarlo; }
+
+  //! Modify whether Monte Carlo estimations are used.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the Monte Carlo probability.
+  double MCProb() const { return mcProb; }
+
+  //! Modify the Monte Carlo probability.
+  double& MCProb() { return mcProb; }
+
+  //! Get the Monte Carlo initial sample size.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+
+  //! Modify the Monte Carlo initial sample size.
+  size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Get the Monte Carlo entry coefficient.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+
+  //! Modify the Monte Carlo entry coefficient.
+  double& MCEntryCoefficient() { return mcEntryCoef; }
+
+  //! Get the Monte Carlo break coefficient.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+
+  //! Modify the Monte Carlo break coefficient.
+  double& MCBreakCoefficient() { return mcBreakCoef; }
+
   //! Get the mode of the model.
   KDEMode Mode() const;
 
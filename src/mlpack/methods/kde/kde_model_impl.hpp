@@ -25,12 +25,22 @@ inline KDEModel::KDEModel(const double bandwidth,
                           const double relError,
                           const double absError,
                           const KernelTypes kernelType,
-                          const TreeTypes treeType) :
+                          const TreeTypes treeType,
+                          const bool monteCarlo,
+                          const double mcProb,
+                          const size_t initialSampleSize,
+                          const double mcEntryCoef,
+                          const double mcBreakCoef) :
   bandwidth(bandwidth),
   relError(relError),
   absError(absError),
   kernelType(kernelType),
-  treeType(treeType)
+  treeType(treeType),
+  monteCarlo(monteCarlo),
+  mcProb(mcProb),
+  initialSampleSize(initialSampleSize),
+  mcEntryCoef(mcEntryCoef),
+  mcBreakCoef(mcBreakCoef)
 {
   // Nothing to do.
 }
@@ -41,7 +51,12 @@ inline KDEModel::KDEModel(const KDEModel& other) :
   relError(other.relError),
   absError(other.absError),
   kernelType(other.kernelType),
-  treeType(other.treeType)
+  treeType(other.treeType),
+  monteCarlo(other.monteCarlo),
+  mcProb(other.mcProb),
+  initialSampleSize(other.initialSampleSize),
+  mcEntryCoef(other.mcEntryCoef),
+  mcBreakCoef(other.mcBreakCoef)
 {
   // Nothing to do.
 }
@@ -53,6 +68,11 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   absError(other.absError),
   kernelType(other.kernelType),
   treeType(other.treeType),
+  monteCarlo(other.monteCarlo),
+  mcProb(other.mcProb),
+  initialSampleSize(other.initialSampleSize),
+  mcEntryCoef(other.mcEntryCoef),
+  mcBreakCoef(other.mcBreakCoef),
   kdeModel(std::move(other.kdeModel))
 {
   // Reset other model.
@@ -61,6 +81,11 @@ inline KDEModel::KDEModel(KDEModel&& other) :
   other.absError = 0;
   other.kernelType = KernelTypes::GAUSSIAN_KERNEL;
   other.treeType = TreeTypes::KD_TREE;
+  other.monteCarlo = false;
+  other.mcProb = 0.95;
+  other.initialSampleSize = 100;
+  other.mcEntryCoef = 3;
+  other.mcBreakCoef = 0.4;
   other.kdeModel = decltype(other.kdeModel)();
 }
 
@@ -72,6 +97,11 @@ inline KDEModel& KDEModel::operator=(KDEModel other)
   absError = other.absError;
   kernelType = other.kernelType;
   treeType = other.treeType;
+  monteCarlo = other.monteCarlo;
+  mcProb = other.mcProb;
+  initialSampleSize = other.initialSampleSize;
+  mcEntryCoef = other.mcEntryCoef;
+  mcBreakCoef = other.mcBreakCoef;
   kdeModel = std::move(other.kdeModel);
   return *this;
 }
@@ -223,6 +253,9 @@ inline void KDEModel::BuildModel(arma::mat&& referenceSet)
 inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
 {
   Log::Info << "Evaluating KDE..." << std::endl;
+  MonteCarloVisitor mc(monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+      mcBreakCoef);
+  boost::apply_visitor(mc, kdeModel);
   DualBiKDE eval(std::move(querySet), estimations);
   boost::apply_visitor(eval, kdeModel);
 }
@@ -231,6 +264,9 @@ inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
 inline void KDEModel::Evaluate(arma::vec& estimations)
 {
   Log::Info << "Evaluating KDE..." << std::endl;
+  MonteCarloVisitor mc(monteCarlo, mcProb, initialSampleSize, mcEntryCoef,
+      mcBreakCoef);
+  boost::apply_visitor(mc, kdeModel);
   DualMonoKDE eval(estimations);
   boost::apply_visitor(eval, kdeModel);
 }
@@ -313,6 +349,37 @@ void TrainVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
     throw std::runtime_error("no KDE model initialized");
 }
 
+// Parameters for Monte Carlo estimations.
+inline MonteCarloVisitor::MonteCarloVisitor(const bool monteCarlo,
+                                            const double mcProb,
+                                            const size_t initialSampleSize,
+                                            const double mcEntryCoef,
+                                            const double mcBreakCoef) :
+    monteCarlo(monteCarlo),
+    mcProb(mcProb),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef)
+{}
+
+// Set Monte Carlo parameters of model.
+template<typename KDEType>
+void MonteCarloVisitor::operator()(KDEType* kde) const
+{
+  if (kde)
+  {
+    kde->MonteCarlo() = monteCarlo;
+    kde->MCProb(mcProb);
+    kde->MCInitialSampleSize(initialSampleSize);
+    kde->MCEntryCoefficient(mcEntryCoef);
+    kde->MCBreakCoefficient(mcBreakCoef);
+  }
+  else
+  {
+    throw std::runtime_error("no KDE model initialized");
+  }
+}
+
 // Delete model.
 template<typename KDEType>
 void DeleteVisitor::operator()(KDEType* kde) const
@@ -352,6 +419,11 @@ void KDEModel::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(absError);
   ar & BOOST_SERIALIZATION_NVP(kernelType);
   ar & BOOST_SERIALIZATION_NVP(treeType);
+  ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+  ar & BOOST_SERIALIZATION_NVP(mcProb);
+  ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+  ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+  ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
 
   if (Archive::is_loading::value)
     boost::apply_visitor(DeleteVisitor(), kdeModel);
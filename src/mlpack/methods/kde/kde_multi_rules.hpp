@@ -0,0 +1,207 @@
+/**
+ * @file kde_multi_rules.hpp
+ *
+ * Rules for Kernel Density Estimation with several bandwidths in a single
+ * traversal, so that it can be done with arbitrary tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_MULTI_RULES_HPP
+#define MLPACK_METHODS_KDE_MULTI_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include <mlpack/core/tree/multi_statistic.hpp>
+#include <mlpack/core/metrics/block_distances.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * A dual-tree (or single-tree) traversal Rules class for kernel density
+ * estimation with several kernels at once, usually the same kernel with
+ * different bandwidths.  Each distance, and each distance bound between two
+ * nodes, is computed once and used by all the kernels; each kernel has its
+ * own error tolerance and its own row of densities.
+ *
+ * A node combination is only pruned when the error tolerances of all the
+ * kernels allow it, so that the estimation of each kernel is within the same
+ * bounds as with KDERules.  The traversal thus costs about as much as the
+ * traversal of the kernel which prunes the least, and every base case
+ * evaluates each kernel on a distance that is computed only once.
+ */
+template<typename MetricType, typename KernelType, typename TreeType>
+class KDEMultiRules
+{
+ public:
+  /**
+   * Construct KDEMultiRules.
+   *
+   * @param referenceSet Reference set data.
+   * @param querySet Query set data.
+   * @param densities Matrix where estimations will be written; row b holds the
+   *                  estimations of kernel b, and column i those of query
+   *                  point i.  It must already have the right size.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param metric Instantiated metric.
+   * @param kernels Instantiated kernels.
+   * @param sameSet True if query and reference sets are the same
+   *                (monochromatic evaluation).
+   */
+  KDEMultiRules(const arma::mat& referenceSet,
+                const arma::mat& querySet,
+                arma::mat& densities,
+                const double relError,
+                const double absError,
+                MetricType& metric,
+                const std::vector<KernelType>& kernels,
+                const bool sameSet);
+
+  //! Base Case.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  //! SingleTree Score.
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  //! SingleTree Rescore.
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  //! DoubleTree Score.
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  //! DoubleTree Rescore.
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore) const;
+
+  /**
+   * Base cases between the points of two leaves, for each query point that
+   * Score() does not prune the reference node for.  If the block is large
+   * enough, its distances are computed at once (see metric::BlockDistances),
+   * and each kernel is evaluated on the whole block.  Returns the number of
+   * base cases that were performed.
+   */
+  size_t BaseCaseBlock(TreeType& queryNode, TreeType& referenceNode);
+
+  typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
+
+  //! Get traversal information.
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+
+  //! Modify traversal information.
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+ private:
+  /**
+   * Return whether the error tolerances of all the kernels allow to prune a
+   * node combination with the given bounds on the distances between their
+   * points.
+   */
+  bool CanPrune(const double minDistance, const double maxDistance) const;
+
+  //! Add the given number of times the kernel values of the given distance to
+  //! the densities of the query point.
+  void AddKernels(const size_t queryIndex,
+                  const double distance,
+                  const size_t count);
+
+  //! Whether the kernels are functions of the squared distance, so that each
+  //! block of distances is squared once before the kernels are evaluated.
+  static const bool SquaredDistances =
+      (kernel::KernelMatrixRule<KernelType>::TileType ==
+       kernel::SQUARED_DISTANCE_TILES);
+
+  /**
+   * Replace each of the given squared distances by its kernel value, with the
+   * vectorized transform of kernel::KernelMatrixRule.
+   */
+  template<typename K = KernelType>
+  static typename std::enable_if<kernel::KernelMatrixRule<K>::TileType ==
+      kernel::SQUARED_DISTANCE_TILES>::type
+  KernelValues(const KernelType& kernel, arma::mat& distances);
+
+  //! Replace each of the given distances by its kernel value, one by one.
+  template<typename K = KernelType>
+  static typename std::enable_if<kernel::KernelMatrixRule<K>::TileType !=
+      kernel::SQUARED_DISTANCE_TILES>::type
+  KernelValues(const KernelType& kernel, arma::mat& distances);
+
+  //! The reference set.
+  const arma::mat& referenceSet;
+
+  //! The query set.
+  const arma::mat& querySet;
+
+  //! Density values, one row per kernel.
+  arma::mat& densities;
+
+  //! Absolute error tolerance.
+  const double absError;
+
+  //! Relatve error tolerance.
+  const double relError;
+
+  //! Instantiated metric.
+  MetricType& metric;
+
+  //! Instantiated kernels.
+  const std::vector<KernelType>& kernels;
+
+  //! Whether reference and query sets are the same.
+  const bool sameSet;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  //! Traversal information.
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+
+  //! The number of scores.
+  size_t scores;
+};
+
+} // namespace kde
+
+namespace tree {
+
+//! KDEMultiRules can evaluate the base cases between two leaves at once.
+template<typename MetricType, typename KernelType, typename TreeType>
+class RuleTraits<kde::KDEMultiRules<MetricType, KernelType, TreeType>>
+{
+ public:
+  static const bool HasBaseCaseBlock = true;
+  static const bool HasBaseCaseBatch = false;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_multi_rules_impl.hpp"
+
+#endif
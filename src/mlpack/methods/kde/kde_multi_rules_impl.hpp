@@ -0,0 +1,329 @@
+/**
+ * @file kde_multi_rules_impl.hpp
+ *
+ * Implementation of rules for Kernel Density Estimation with several bandwidths
+ * in a single traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_MULTI_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_MULTI_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_multi_rules.hpp"
+
+namespace mlpack {
+namespace kde {
+
+template<typename MetricType, typename KernelType, typename TreeType>
+KDEMultiRules<MetricType, KernelType, TreeType>::KDEMultiRules(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    arma::mat& densities,
+    const double relError,
+    const double absError,
+    MetricType& metric,
+    const std::vector<KernelType>& kernels,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    absError(absError),
+    relError(relError),
+    metric(metric),
+    kernels(kernels),
+    sameSet(sameSet),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0)
+{
+  // Nothing to do.
+}
+
+//! The base case.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline
+double KDEMultiRules<MetricType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If reference and query sets are the same we don't want to compute the
+  // estimation of a point with itself.
+  if (sameSet && (queryIndex == referenceIndex))
+    return 0.0;
+
+  // Avoid duplicated calculations.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  // The distance is computed once for all the kernels.
+  const double distance = metric.Evaluate(querySet.col(queryIndex),
+                                          referenceSet.col(referenceIndex));
+  AddKernels(queryIndex, distance, 1);
+
+  ++baseCases;
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+  return distance;
+}
+
+//! Single-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline double KDEMultiRules<MetricType, KernelType, TreeType>::
+Score(const size_t queryIndex, TreeType& referenceNode)
+{
+  double score;
+  const arma::vec& queryPoint = querySet.unsafe_col(queryIndex);
+  const double minDistance = referenceNode.MinDistance(queryPoint);
+  bool newCalculations = true;
+
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+      lastQueryIndex == queryIndex &&
+      traversalInfo.LastReferenceNode() != NULL &&
+      traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0))
+  {
+    // Don't duplicate calculations.
+    newCalculations = false;
+    lastQueryIndex = queryIndex;
+    lastReferenceIndex = referenceNode.Point(0);
+  }
+
+  if (newCalculations &&
+      CanPrune(minDistance, referenceNode.MaxDistance(queryPoint)))
+  {
+    // Estimate values with the distance to the reference node centroid.
+    double distance;
+    if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+    {
+      distance = metric.Evaluate(queryPoint,
+          referenceSet.unsafe_col(referenceNode.Point(0)));
+    }
+    else
+    {
+      distance = metric.Evaluate(queryPoint,
+          tree::GetStatistic<KDEStat>(referenceNode.Stat()).Centroid());
+    }
+
+    AddKernels(queryIndex, distance, referenceNode.NumDescendants());
+
+    // Don't explore this tree branch.
+    score = DBL_MAX;
+  }
+  else
+  {
+    score = minDistance;
+  }
+
+  ++scores;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  traversalInfo.LastScore() = score;
+  return score;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline double KDEMultiRules<MetricType, KernelType, TreeType>::Rescore(
+    const size_t /* queryIndex */,
+    TreeType& /* referenceNode */,
+    const double oldScore) const
+{
+  // If it's pruned it continues to be pruned.
+  return oldScore;
+}
+
+//! Double-tree scoring function.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline double KDEMultiRules<MetricType, KernelType, TreeType>::
+Score(TreeType& queryNode, TreeType& referenceNode)
+{
+  double score;
+  const double minDistance = queryNode.MinDistance(referenceNode);
+  // Calculations are not duplicated.
+  bool newCalculations = true;
+
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
+      (traversalInfo.LastQueryNode() != NULL) &&
+      (traversalInfo.LastReferenceNode() != NULL) &&
+      (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+      (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+  {
+    // Don't duplicate calculations.
+    newCalculations = false;
+    lastQueryIndex = queryNode.Point(0);
+    lastReferenceIndex = referenceNode.Point(0);
+  }
+
+  // If possible, avoid some calculations because of the error tolerances.
+  if (newCalculations &&
+      CanPrune(minDistance, queryNode.MaxDistance(referenceNode)))
+  {
+    // Estimate values with the distance between the centroids.
+    double distance;
+    if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+    {
+      distance = metric.Evaluate(querySet.unsafe_col(queryNode.Point(0)),
+          referenceSet.unsafe_col(referenceNode.Point(0)));
+    }
+    else
+    {
+      distance = metric.Evaluate(
+          tree::GetStatistic<KDEStat>(queryNode.Stat()).Centroid(),
+          tree::GetStatistic<KDEStat>(referenceNode.Stat()).Centroid());
+    }
+
+    // Sum up estimations.
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    {
+      AddKernels(queryNode.Descendant(i), distance,
+          referenceNode.NumDescendants());
+    }
+    score = DBL_MAX;
+  }
+  else
+  {
+    score = minDistance;
+  }
+
+  ++scores;
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  traversalInfo.LastScore() = score;
+  return score;
+}
+
+//! Double-tree rescore.
+template<typename MetricType, typename KernelType, typename TreeType>
+inline double KDEMultiRules<MetricType, KernelType, TreeType>::
+Rescore(TreeType& /*queryNode*/,
+        TreeType& /*referenceNode*/,
+        const double oldScore) const
+{
+  // If a branch is pruned then it continues to be pruned.
+  return oldScore;
+}
+
+//! Base cases between two leaves.
+template<typename MetricType, typename KernelType, typename TreeType>
+size_t KDEMultiRules<MetricType, KernelType, TreeType>::BaseCaseBlock(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  // Find the query points that the reference node can't be pruned for.  The
+  // traversal info is restored before each score, as the traversers do.
+  const TraversalInfoType info = traversalInfo;
+  std::vector<size_t> queries;
+  queries.reserve(queryNode.NumPoints());
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    traversalInfo = info;
+    if (Score(queryNode.Point(i), referenceNode) != DBL_MAX)
+      queries.push_back(queryNode.Point(i));
+  }
+
+  const size_t numReferences = referenceNode.NumPoints();
+  if (!metric::BlockDistances<MetricType>::template Worthwhile<arma::mat>(
+      queries.size(), numReferences))
+  {
+    for (size_t i = 0; i < queries.size(); ++i)
+      for (size_t j = 0; j < numReferences; ++j)
+        BaseCase(queries[i], referenceNode.Point(j));
+
+    return queries.size() * numReferences;
+  }
+
+  std::vector<size_t> references(numReferences);
+  for (size_t j = 0; j < numReferences; ++j)
+    references[j] = referenceNode.Point(j);
+
+  arma::mat distances;
+  arma::vec errors;
+  metric::BlockDistances<MetricType>::Evaluate(metric, querySet, queries,
+      referenceSet, references, distances, errors);
+  if (SquaredDistances)
+    distances = arma::square(distances);
+
+  // Each kernel is evaluated on a copy of the block of distances.
+  arma::mat values;
+  for (size_t b = 0; b < kernels.size(); ++b)
+  {
+    values = distances;
+    KernelValues(kernels[b], values);
+
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      const size_t queryIndex = queries[i];
+      double density = 0.0;
+      for (size_t j = 0; j < numReferences; ++j)
+        if (!sameSet || (queryIndex != references[j]))
+          density += values(i, j);
+
+      densities(b, queryIndex) += density;
+    }
+  }
+
+  for (size_t i = 0; i < queries.size(); ++i)
+    for (size_t j = 0; j < numReferences; ++j)
+      if (!sameSet || (queries[i] != references[j]))
+        ++baseCases;
+
+  lastQueryIndex = queries.back();
+  lastReferenceIndex = references.back();
+  return queries.size() * numReferences;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline bool KDEMultiRules<MetricType, KernelType, TreeType>::CanPrune(
+    const double minDistance,
+    const double maxDistance) const
+{
+  for (size_t b = 0; b < kernels.size(); ++b)
+  {
+    const double maxKernel = kernels[b].Evaluate(minDistance);
+    const double minKernel = kernels[b].Evaluate(maxDistance);
+    if (maxKernel - minKernel >
+        (absError + relError * minKernel) / referenceSet.n_cols)
+      return false;
+  }
+
+  return true;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline force_inline void KDEMultiRules<MetricType, KernelType, TreeType>::
+AddKernels(const size_t queryIndex, const double distance, const size_t count)
+{
+  double* queryDensities = densities.colptr(queryIndex);
+  for (size_t b = 0; b < kernels.size(); ++b)
+    queryDensities[b] += count * kernels[b].Evaluate(distance);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+template<typename K>
+inline typename std::enable_if<kernel::KernelMatrixRule<K>::TileType ==
+    kernel::SQUARED_DISTANCE_TILES>::type
+KDEMultiRules<MetricType, KernelType, TreeType>::KernelValues(
+    const KernelType& kernel,
+    arma::mat& distances)
+{
+  kernel::KernelMatrixRule<KernelType>::Transform(kernel, distances);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+template<typename K>
+inline typename std::enable_if<kernel::KernelMatrixRule<K>::TileType !=
+    kernel::SQUARED_DISTANCE_TILES>::type
+KDEMultiRules<MetricType, KernelType, TreeType>::KernelValues(
+    const KernelType& kernel,
+    arma::mat& distances)
+{
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    distances[i] = kernel.Evaluate(distances[i]);
+}
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
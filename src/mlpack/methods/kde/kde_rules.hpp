@@ -14,6 +14,10 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include <mlpack/core/tree/multi_statistic.hpp>
+#include <mlpack/core/metrics/block_distances.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kde {
@@ -38,6 +42,17 @@ class KDERules
    * @param kernel Instantiated kernel.
    * @param sameSet True if query and reference sets are the same
    *                (monochromatic evaluation).
+   * @param monteCarlo Whether to estimate contributions by sampling when the
+   *                   deterministic kernel bounds are too loose to prune.
+   * @param mcProb Probability of each Monte Carlo estimation being within the
+   *               relative error tolerance.
+   * @param initialSampleSize Number of reference points sampled in the first
+   *                          round of each Monte Carlo estimation.
+   * @param mcEntryCoef A reference node is only sampled if it has at least
+   *                    mcEntryCoef * initialSampleSize descendants.
+   * @param mcBreakCoef A Monte Carlo estimation is abandoned when it needs
+   *                    more than mcBreakCoef times the number of descendants
+   *                    of the reference node.
    */
   KDERules(const arma::mat& referenceSet,
            const arma::mat& querySet,
@@ -46,7 +61,12 @@ class KDERules
            const double absError,
            MetricType& metric,
            KernelType& kernel,
-           const bool sameSet);
+           const bool sameSet,
+           const bool monteCarlo = false,
+           const double mcProb = 0.95,
+           const size_t initialSampleSize = 100,
+           const double mcEntryCoef = 3,
+           const double mcBreakCoef = 0.4);
 
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -67,6 +87,24 @@ class KDERules
                  TreeType& referenceNode,
                  const double oldScore) const;
 
+  /**
+   * Base cases between the points of two leaves, for each query point that
+   * Score() does not prune the reference node for.  If the block is large
+   * enough, its distances are computed at once (see metric::BlockDistances);
+   * their rounding errors are far below the error tolerances of the
+   * estimations.  Returns the number of base cases that were performed.
+   */
+  size_t BaseCaseBlock(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Add the estimation of the contribution of the descendants of the reference
+   * node with its centroid, regardless of the error tolerances, and return the
+   * largest possible error of it (the number of descendants times the
+   * difference between the largest and smallest kernel values of the node).
+   * This is used for the nodes that a budgeted traversal could not visit.
+   */
+  double Approximate(const size_t queryIndex, TreeType& referenceNode);
+
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
   //! Get traversal information.
@@ -78,10 +116,48 @@ class KDERules
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
 
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
+
   //! Get the number of scores.
   size_t Scores() const { return scores; }
 
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
+
+  //! Get the number of kernel evaluations used by Monte Carlo estimations.
+  size_t Samples() const { return samples; }
+
  private:
+  /**
+   * Estimate the mean kernel value between the query point and the
+   * descendants of the reference node by sampling descendants uniformly, until
+   * the normal confidence interval of the estimation is within the relative
+   * error tolerance.  Returns false if that would take too many samples.
+   */
+  bool MonteCarloEstimate(const arma::vec& queryPoint,
+                          TreeType& referenceNode,
+                          double& meanKernel);
+
+  //! Whether Monte Carlo estimation can be tried for the reference node.
+  bool CanSample(TreeType& referenceNode) const;
+
+  /**
+   * Replace each of the given distances by its kernel value.  For the kernels
+   * that are functions of the squared distance (see kernel::KernelMatrixRule),
+   * the whole block is transformed at once, with a vectorized loop.
+   */
+  template<typename K = KernelType>
+  typename std::enable_if<kernel::KernelMatrixRule<K>::TileType ==
+      kernel::SQUARED_DISTANCE_TILES>::type
+  KernelValues(arma::mat& distances) const;
+
+  //! Replace each of the given distances by its kernel value, one by one.
+  template<typename K = KernelType>
+  typename std::enable_if<kernel::KernelMatrixRule<K>::TileType !=
+      kernel::SQUARED_DISTANCE_TILES>::type
+  KernelValues(arma::mat& distances) const;
+
   //! Evaluate kernel value of 2 points given their indexes.
   double EvaluateKernel(const size_t queryIndex,
                         const size_t referenceIndex) const;
@@ -128,9 +204,43 @@ class KDERules
 
   //! The number of scores.
   size_t scores;
+
+  //! Whether Monte Carlo estimations are used.
+  const bool monteCarlo;
+
+  //! Quantile of the standard normal for the Monte Carlo probability.
+  double mcZ;
+
+  //! Size of the first sample of each Monte Carlo estimation.
+  const size_t initialSampleSize;
+
+  //! Minimum reference node size (in initial samples) to try sampling.
+  const double mcEntryCoef;
+
+  //! Fraction of a reference node above which sampling is abandoned.
+  const double mcBreakCoef;
+
+  //! Random number generator used to draw samples.
+  std::mt19937 generator;
+
+  //! The number of kernel evaluations used by Monte Carlo estimations.
+  size_t samples;
 };
 
 } // namespace kde
+
+namespace tree {
+
+//! KDERules can evaluate the base cases between two leaves at once.
+template<typename MetricType, typename KernelType, typename TreeType>
+class RuleTraits<kde::KDERules<MetricType, KernelType, TreeType>>
+{
+ public:
+  static const bool HasBaseCaseBlock = true;
+  static const bool HasBaseCaseBatch = false;
+};
+
+} // namespace tree
 } // namespace mlpack
 
 // Include implementation.
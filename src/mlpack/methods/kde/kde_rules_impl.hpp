@@ -16,6 +16,8 @@
 // In case it hasn't been included yet.
 #include "kde_rules.hpp"
 
+#include <boost/math/distributions/normal.hpp>
+
 namespace mlpack {
 namespace kde {
 
@@ -28,7 +30,12 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     const double absError,
     MetricType& metric,
     KernelType& kernel,
-    const bool sameSet) :
+    const bool sameSet,
+    const bool monteCarlo,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef) :
     referenceSet(referenceSet),
     querySet(querySet),
     densities(densities),
@@ -40,9 +47,28 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    monteCarlo(monteCarlo),
+    mcZ(0),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef),
+    samples(0)
 {
-  // Nothing to do.
+  if (monteCarlo)
+  {
+    // Two-sided quantile, so that the estimation is within the interval with
+    // probability mcProb.
+    boost::math::normal normalDistribution;
+    mcZ = boost::math::quantile(normalDistribution, 0.5 + mcProb / 2);
+
+    // The global generator is not thread-safe, and rules may be built by
+    // several threads at once.
+    uint32_t seed;
+    #pragma omp critical(kdeRulesSeed)
+    seed = (uint32_t) math::RandInt(std::numeric_limits<int>::max());
+    generator.seed(seed);
+  }
 }
 
 //! The base case.
@@ -113,7 +139,8 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     }
     else
     {
-      kde::KDEStat& referenceStat = referenceNode.Stat();
+      kde::KDEStat& referenceStat =
+          tree::GetStatistic<KDEStat>(referenceNode.Stat());
       kernelValue = EvaluateKernel(queryPoint, referenceStat.Centroid());
     }
 
@@ -122,6 +149,21 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     // Don't explore this tree branch.
     score = DBL_MAX;
   }
+  else if (newCalculations && CanSample(referenceNode))
+  {
+    // The bounds are too loose, so try to estimate the contribution of the
+    // reference node by sampling.
+    double meanKernel;
+    if (MonteCarloEstimate(queryPoint, referenceNode, meanKernel))
+    {
+      densities(queryIndex) += referenceNode.NumDescendants() * meanKernel;
+      score = DBL_MAX;
+    }
+    else
+    {
+      score = minDistance;
+    }
+  }
   else
   {
     score = minDistance;
@@ -143,6 +185,114 @@ inline double KDERules<MetricType, KernelType, TreeType>::Rescore(
   return oldScore;
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+double KDERules<MetricType, KernelType, TreeType>::Approximate(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  const arma::vec& queryPoint = querySet.unsafe_col(queryIndex);
+  const double maxKernel = kernel.Evaluate(referenceNode.MinDistance(
+      queryPoint));
+  const double minKernel = kernel.Evaluate(referenceNode.MaxDistance(
+      queryPoint));
+
+  double kernelValue;
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
+    kernelValue = EvaluateKernel(queryIndex, referenceNode.Point(0));
+  }
+  else
+  {
+    kde::KDEStat& referenceStat =
+        tree::GetStatistic<KDEStat>(referenceNode.Stat());
+    kernelValue = EvaluateKernel(queryPoint, referenceStat.Centroid());
+  }
+
+  densities(queryIndex) += referenceNode.NumDescendants() * kernelValue;
+  return referenceNode.NumDescendants() * (maxKernel - minKernel);
+}
+
+//! Base cases between two leaves.
+template<typename MetricType, typename KernelType, typename TreeType>
+size_t KDERules<MetricType, KernelType, TreeType>::BaseCaseBlock(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  // Find the query points that the reference node can't be pruned for.  The
+  // traversal info is restored before each score, as the traversers do.
+  const TraversalInfoType info = traversalInfo;
+  std::vector<size_t> queries;
+  queries.reserve(queryNode.NumPoints());
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    traversalInfo = info;
+    if (Score(queryNode.Point(i), referenceNode) != DBL_MAX)
+      queries.push_back(queryNode.Point(i));
+  }
+
+  const size_t numReferences = referenceNode.NumPoints();
+  if (!metric::BlockDistances<MetricType>::template Worthwhile<arma::mat>(
+      queries.size(), numReferences))
+  {
+    for (size_t i = 0; i < queries.size(); ++i)
+      for (size_t j = 0; j < numReferences; ++j)
+        BaseCase(queries[i], referenceNode.Point(j));
+
+    return queries.size() * numReferences;
+  }
+
+  std::vector<size_t> references(numReferences);
+  for (size_t j = 0; j < numReferences; ++j)
+    references[j] = referenceNode.Point(j);
+
+  arma::mat distances;
+  arma::vec errors;
+  metric::BlockDistances<MetricType>::Evaluate(metric, querySet, queries,
+      referenceSet, references, distances, errors);
+
+  // The distances are replaced by their kernel values.
+  KernelValues(distances);
+
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t queryIndex = queries[i];
+    for (size_t j = 0; j < numReferences; ++j)
+    {
+      if (sameSet && (queryIndex == references[j]))
+        continue;
+
+      densities(queryIndex) += distances(i, j);
+      ++baseCases;
+    }
+  }
+
+  lastQueryIndex = queries.back();
+  lastReferenceIndex = references.back();
+  return queries.size() * numReferences;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+template<typename K>
+inline typename std::enable_if<kernel::KernelMatrixRule<K>::TileType ==
+    kernel::SQUARED_DISTANCE_TILES>::type
+KDERules<MetricType, KernelType, TreeType>::KernelValues(
+    arma::mat& distances) const
+{
+  distances = arma::square(distances);
+  kernel::KernelMatrixRule<KernelType>::Transform(kernel, distances);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+template<typename K>
+inline typename std::enable_if<kernel::KernelMatrixRule<K>::TileType !=
+    kernel::SQUARED_DISTANCE_TILES>::type
+KDERules<MetricType, KernelType, TreeType>::KernelValues(
+    arma::mat& distances) const
+{
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    distances[i] = kernel.Evaluate(distances[i]);
+}
+
 //! Double-tree scoring function.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline double KDERules<MetricType, KernelType, TreeType>::
@@ -178,8 +328,10 @@ Score(TreeType& queryNode, TreeType& referenceNode)
   {
     // Auxiliary variables.
     double kernelValue;
-    kde::KDEStat& referenceStat = referenceNode.Stat();
-    kde::KDEStat& queryStat = queryNode.Stat();
+    kde::KDEStat& referenceStat =
+        tree::GetStatistic<KDEStat>(referenceNode.Stat());
+    kde::KDEStat& queryStat =
+        tree::GetStatistic<KDEStat>(queryNode.Stat());
 
     // If calculating a center is not required.
     if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -201,6 +353,33 @@ Score(TreeType& queryNode, TreeType& referenceNode)
     }
     score = DBL_MAX;
   }
+  else if (newCalculations && CanSample(referenceNode))
+  {
+    // Every query descendant needs its own estimation; the node combination
+    // is only pruned if all of them succeed.
+    arma::vec meanKernels(queryNode.NumDescendants());
+    bool success = true;
+    for (size_t i = 0; i < queryNode.NumDescendants() && success; ++i)
+    {
+      success = MonteCarloEstimate(
+          querySet.unsafe_col(queryNode.Descendant(i)), referenceNode,
+          meanKernels[i]);
+    }
+
+    if (success)
+    {
+      for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+      {
+        densities(queryNode.Descendant(i)) +=
+            referenceNode.NumDescendants() * meanKernels[i];
+      }
+      score = DBL_MAX;
+    }
+    else
+    {
+      score = minDistance;
+    }
+  }
   else
   {
     score = minDistance;
@@ -224,6 +403,76 @@ Rescore(TreeType& /*queryNode*/,
   return oldScore;
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+inline bool KDERules<MetricType, KernelType, TreeType>::
+CanSample(TreeType& referenceNode) const
+{
+  // With no relative error tolerance the number of samples is unbounded.
+  return monteCarlo && relError > 0 &&
+      referenceNode.NumDescendants() >= mcEntryCoef * initialSampleSize;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::
+MonteCarloEstimate(const arma::vec& queryPoint,
+                   TreeType& referenceNode,
+                   double& meanKernel)
+{
+  const size_t numDescendants = referenceNode.NumDescendants();
+  std::uniform_int_distribution<size_t> randomDescendant(0,
+      numDescendants - 1);
+
+  double sum = 0.0;
+  double sumSquares = 0.0;
+  size_t numSamples = 0;
+  size_t targetSamples = initialSampleSize;
+  while (numSamples < targetSamples)
+  {
+    // Don't bother if this takes almost as long as the exact computation.
+    if (targetSamples >= mcBreakCoef * numDescendants)
+    {
+      samples += numSamples;
+      return false;
+    }
+
+    for (; numSamples < targetSamples; ++numSamples)
+    {
+      const size_t referenceIndex =
+          referenceNode.Descendant(randomDescendant(generator));
+      const double value = EvaluateKernel(queryPoint,
+          referenceSet.unsafe_col(referenceIndex));
+      sum += value;
+      sumSquares += value * value;
+    }
+
+    meanKernel = sum / numSamples;
+    if (meanKernel <= 0.0)
+    {
+      // The relative error of a zero estimation can't be bounded.
+      samples += numSamples;
+      return false;
+    }
+
+    // Number of samples needed for the confidence interval of the mean to be
+    // within the relative error tolerance.
+    const double variance = std::max(0.0, (sumSquares - numSamples *
+        meanKernel * meanKernel) / (numSamples - 1));
+    const double root = mcZ * std::sqrt(variance) * (1 + relError) /
+        (relError * meanKernel);
+    const double neededSamples = std::ceil(root * root);
+    if (neededSamples >= mcBreakCoef * numDescendants)
+    {
+      samples += numSamples;
+      return false;
+    }
+
+    targetSamples = std::max(numSamples, (size_t) neededSamples);
+  }
+
+  samples += numSamples;
+  return true;
+}
+
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline double KDERules<MetricType, KernelType, TreeType>::
 EvaluateKernel(const size_t queryIndex,
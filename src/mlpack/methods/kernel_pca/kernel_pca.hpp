@@ -44,13 +44,16 @@ class KernelPCA
    * Construct the KernelPCA object, optionally passing a kernel.  Optionally,
    * the transformed data can be centered about the origin; to do this, pass
    * 'true' for centerTransformedData.  This will take slightly longer (but not
-   * much).
+   * much).  Kernel rules that hold parameters (like RandomFourierFeaturesRule)
+   * can be passed too.
    *
    * @param kernel Kernel to be used for computation.
    * @param centerTransformedData Center transformed data.
+   * @param kernelRule Instantiated kernel rule.
    */
   KernelPCA(const KernelType kernel = KernelType(),
-            const bool centerTransformedData = false);
+            const bool centerTransformedData = false,
+            const KernelRule& kernelRule = KernelRule());
 
   /**
    * Apply Kernel Principal Components Analysis to the provided data set.
@@ -106,6 +109,34 @@ class KernelPCA
    */
   void Apply(arma::mat& data, const size_t newDimension);
 
+  /**
+   * Fit Kernel Principal Components Analysis to the given data set, and keep
+   * the model, so that Transform() can embed new points without recomputing
+   * the kernel matrix of the training data.  The kernel rule keeps what it
+   * needs: NaiveKernelRule keeps the training points, NystroemKernelRule only
+   * its landmark points, and RandomFourierFeaturesRule its random features.
+   *
+   * @param data Data matrix.
+   * @param newDimension Number of components to keep (0 keeps all of them).
+   */
+  void Train(const arma::mat& data, const size_t newDimension = 0);
+
+  /**
+   * Embed the given points into the components found by the last call to
+   * Train().  Embedding the training points gives the same result as Apply().
+   * Since the kernel is only evaluated against the points kept by the kernel
+   * rule, new batches can be embedded one at a time, and with
+   * NystroemKernelRule each point costs O(m) kernel evaluations for m
+   * landmarks.
+   *
+   * @param points Points to embed (one per column).
+   * @param transformedPoints Matrix to store the embedded points in.
+   */
+  void Transform(const arma::mat& points, arma::mat& transformedPoints) const;
+
+  //! Get the eigenvalues found by the last call to Train().
+  const arma::vec& EigenValues() const { return eigenValues; }
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
   //! Modify the kernel.
@@ -116,12 +147,25 @@ class KernelPCA
   //! Return whether or not the transformed data is centered.
   bool& CenterTransformedData() { return centerTransformedData; }
 
+  //! Get the kernel rule.
+  const KernelRule& Rule() const { return kernelRule; }
+  //! Modify the kernel rule.
+  KernelRule& Rule() { return kernelRule; }
+
  private:
   //! The instantiated kernel.
   KernelType kernel;
   //! If true, the data will be scaled (by standard deviation) when Apply() is
   //! run.
   bool centerTransformedData;
+  //! The instantiated kernel rule.
+  KernelRule kernelRule;
+  //! The number of components kept by Train().
+  size_t dimension;
+  //! The mean of the transformed training data, if it is centered.
+  arma::vec transformedMean;
+  //! The eigenvalues found by Train().
+  arma::vec eigenValues;
 }; // class KernelPCA
 
 } // namespace kpca
@@ -22,9 +22,12 @@ namespace kpca {
 
 template <typename KernelType, typename KernelRule>
 KernelPCA<KernelType, KernelRule>::KernelPCA(const KernelType kernel,
-                                 const bool centerTransformedData) :
+                                 const bool centerTransformedData,
+                                 const KernelRule& kernelRule) :
       kernel(kernel),
-      centerTransformedData(centerTransformedData)
+      centerTransformedData(centerTransformedData),
+      kernelRule(kernelRule),
+      dimension(0)
 { }
 
 //! Apply Kernel Principal Component Analysis to the provided data set.
@@ -35,8 +38,8 @@ void KernelPCA<KernelType, KernelRule>::Apply(const arma::mat& data,
                                   arma::mat& eigvec,
                                   const size_t newDimension)
 {
-  KernelRule::ApplyKernelMatrix(data, transformedData, eigval,
-                                eigvec, newDimension, kernel);
+  kernelRule.ApplyKernelMatrix(data, transformedData, eigval, eigvec,
+      newDimension, kernel);
 
   // Center the transformed data, if the user asked for it.
   if (centerTransformedData)
@@ -77,10 +80,53 @@ void KernelPCA<KernelType, KernelRule>::Apply(arma::mat& data,
 
   Apply(data, data, eigVal, coeffs, newDimension);
 
-  if (newDimension < coeffs.n_rows && newDimension > 0)
+  // Some kernel rules only compute the leading components.
+  if (newDimension < data.n_rows && newDimension > 0)
     data.shed_rows(newDimension, data.n_rows - 1);
 }
 
+//! Fit Kernel Principal Component Analysis to the provided data set.
+template <typename KernelType, typename KernelRule>
+void KernelPCA<KernelType, KernelRule>::Train(const arma::mat& data,
+                                  const size_t newDimension)
+{
+  arma::mat transformedData, eigvec;
+  kernelRule.Train(data, transformedData, eigenValues, eigvec,
+      (newDimension == 0) ? data.n_cols : newDimension, kernel);
+
+  dimension = transformedData.n_rows;
+  if (newDimension > 0 && newDimension < dimension)
+    dimension = newDimension;
+
+  // Centering needs the mean of the transformed training data.
+  if (centerTransformedData)
+    transformedMean = arma::mean(transformedData.rows(0, dimension - 1), 1);
+  else
+    transformedMean.reset();
+}
+
+//! Embed new points with the model of the last call to Train().
+template <typename KernelType, typename KernelRule>
+void KernelPCA<KernelType, KernelRule>::Transform(
+    const arma::mat& points,
+    arma::mat& transformedPoints) const
+{
+  if (dimension == 0)
+  {
+    throw std::invalid_argument("KernelPCA::Transform(): the model has not "
+        "been trained!");
+  }
+
+  kernelRule.Transform(points, transformedPoints, kernel);
+
+  // Some kernel rules keep more components than were asked for.
+  if (dimension < transformedPoints.n_rows)
+    transformedPoints.shed_rows(dimension, transformedPoints.n_rows - 1);
+
+  if (!transformedMean.is_empty())
+    transformedPoints.each_col() -= transformedMean;
+}
+
 } // namespace kpca
 } // namespace mlpack
 
@@ -30,6 +30,7 @@
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_features_method.hpp>
 
 #include "kernel_pca.hpp"
 
@@ -98,7 +99,18 @@ PROGRAM_INFO("Kernel Principal Components Analysis",
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystr\u00F6m method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.",
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "For the 'gaussian' and 'laplacian' kernels, random Fourier features "
+    "(\"Random Features for Large-Scale Kernel Machines\", 2008) can be used "
+    "instead by specifying the " +
+    PRINT_PARAM_STRING("random_fourier_features") + " parameter.  Each point "
+    "is mapped to " + PRINT_PARAM_STRING("num_features") + " explicit features "
+    "whose inner products approximate the kernel, and linear PCA is performed "
+    "on them, so that the kernel matrix is never formed.  If the " +
+    PRINT_PARAM_STRING("orthogonal") + " parameter is given, orthogonal random "
+    "features are used, which give a better approximation for the same number "
+    "of features.",
     SEE_ALSO("Kernel principal component analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Kernel_principal_component_analysis"),
     SEE_ALSO("Kernel Principal Component Analysis (pdf)",
@@ -123,6 +135,12 @@ PARAM_FLAG("nystroem_method", "If set, the Nystroem method will be used.", "n");
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the Nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
 
+PARAM_FLAG("random_fourier_features", "If set, random Fourier features will be "
+    "used (for 'gaussian' and 'laplacian' kernels).", "R");
+PARAM_INT_IN("num_features", "Number of random Fourier features.", "F", 1000);
+PARAM_FLAG("orthogonal", "If set, orthogonal random Fourier features will be "
+    "used.", "T");
+
 PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
 PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
     0.0);
@@ -131,6 +149,56 @@ PARAM_DOUBLE_IN("bandwidth", "Bandwidth, for 'gaussian' and 'laplacian' "
 PARAM_DOUBLE_IN("degree", "Degree of polynomial, for 'polynomial' kernel.", "D",
     1.0);
 
+//! Run KPCA with random Fourier features on the specified dataset, for a
+//! shift-invariant kernel.
+template<typename KernelType>
+void RunRandomFeaturesKPCA(arma::mat& dataset,
+                           const bool centerTransformedData,
+                           const size_t newDim,
+                           KernelType& kernel)
+{
+  const size_t numFeatures = (size_t) CLI::GetParam<int>("num_features");
+  RandomFourierFeaturesRule<KernelType> rule(numFeatures,
+      CLI::HasParam("orthogonal"));
+
+  KernelPCA<KernelType, RandomFourierFeaturesRule<KernelType> > kpca(kernel,
+      centerTransformedData, rule);
+  kpca.Apply(dataset, newDim);
+}
+
+//! Random Fourier features are only available for the 'gaussian' and
+//! 'laplacian' kernels.
+template<typename KernelType>
+void RunRandomFeaturesKPCA(arma::mat& /* dataset */,
+                           const bool /* centerTransformedData */,
+                           const size_t /* newDim */,
+                           KernelType& /* kernel */,
+                           const string& kernelName)
+{
+  Log::Fatal << "Random Fourier features cannot be used with the '"
+      << kernelName << "' kernel; use the 'gaussian' or 'laplacian' kernel."
+      << endl;
+}
+
+//! Use the random features overload for the kernels that support them.
+void RunRandomFeaturesKPCA(arma::mat& dataset,
+                           const bool centerTransformedData,
+                           const size_t newDim,
+                           GaussianKernel& kernel,
+                           const string& /* kernelName */)
+{
+  RunRandomFeaturesKPCA(dataset, centerTransformedData, newDim, kernel);
+}
+
+void RunRandomFeaturesKPCA(arma::mat& dataset,
+                           const bool centerTransformedData,
+                           const size_t newDim,
+                           LaplacianKernel& kernel,
+                           const string& /* kernelName */)
+{
+  RunRandomFeaturesKPCA(dataset, centerTransformedData, newDim, kernel);
+}
+
 //! Run RunKPCA on the specified dataset for the given kernel type.
 template<typename KernelType>
 void RunKPCA(arma::mat& dataset,
@@ -140,7 +208,12 @@ void RunKPCA(arma::mat& dataset,
              const string& sampling,
              KernelType& kernel)
 {
-  if (nystroem)
+  if (CLI::HasParam("random_fourier_features"))
+  {
+    RunRandomFeaturesKPCA(dataset, centerTransformedData, newDim, kernel,
+        CLI::GetParam<string>("kernel"));
+  }
+  else if (nystroem)
   {
     // Make sure the sampling scheme is valid.
     if (sampling == "kmeans")
@@ -202,6 +275,12 @@ static void mlpackMain()
       "unknown kernel type");
   const string kernelType = CLI::GetParam<string>("kernel");
 
+  RequireParamValue<int>("num_features", [](int x) { return x > 0; }, true,
+      "number of random features must be positive");
+  RequireOnlyOnePassed({ "nystroem_method", "random_fourier_features" }, true);
+  ReportIgnoredParam({{ "random_fourier_features", false }}, "num_features");
+  ReportIgnoredParam({{ "random_fourier_features", false }}, "orthogonal");
+
   const bool centerTransformedData = CLI::HasParam("center");
   const bool nystroem = CLI::HasParam("nystroem_method");
   const string sampling = CLI::GetParam<string>("sampling");
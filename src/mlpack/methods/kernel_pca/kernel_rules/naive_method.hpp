@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KERNEL_PCA_NAIVE_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 
 namespace mlpack {
 namespace kpca {
@@ -22,6 +23,9 @@ template<typename KernelType>
 class NaiveKernelRule
 {
  public:
+  //! Create the rule; Train() must be called before Transform().
+  NaiveKernelRule() : totalMean(0.0) { }
+
   /**
    * Construct the exact kernel matrix.
    *
@@ -38,54 +42,122 @@ class NaiveKernelRule
                                 arma::mat& eigvec,
                                 const size_t /* unused */,
                                 KernelType kernel = KernelType())
-{
-  // Construct the kernel matrix.
-  arma::mat kernelMatrix;
-  // Resize the kernel matrix to the right size.
-  kernelMatrix.set_size(data.n_cols, data.n_cols);
-
-  // Note that we only need to calculate the upper triangular part of the
-  // kernel matrix, since it is symmetric. This helps minimize the number of
-  // kernel evaluations.
-  for (size_t i = 0; i < data.n_cols; ++i)
   {
-    for (size_t j = i; j < data.n_cols; ++j)
-    {
-      // Evaluate the kernel on these two points.
-      kernelMatrix(i, j) = kernel.Evaluate(data.unsafe_col(i),
-                                           data.unsafe_col(j));
-    }
+    arma::vec rowMean;
+    double totalMean;
+    Decompose(data, transformedData, eigval, eigvec, kernel, rowMean,
+        totalMean);
+  }
+
+  /**
+   * Perform kernel PCA as ApplyKernelMatrix() does, and keep what Transform()
+   * needs to embed new points: the training points, the centering of the
+   * kernel matrix, and the leading 'rank' eigenvectors (all of them if rank is
+   * 0).
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of components kept for Transform().
+   * @param kernel Kernel to be used for computation.
+   */
+  void Train(const arma::mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigval,
+             arma::mat& eigvec,
+             const size_t rank,
+             KernelType kernel = KernelType())
+  {
+    Decompose(data, transformedData, eigval, eigvec, kernel, rowMean,
+        totalMean);
+
+    const size_t dimension = (rank == 0 || rank > eigvec.n_cols) ?
+        eigvec.n_cols : rank;
+    projection = eigvec.cols(0, dimension - 1);
+    projection.each_row() /= arma::sqrt(eigval.subvec(0, dimension - 1)).t();
+    referencePoints = data;
+  }
+
+  /**
+   * Embed the given points with the model of the last call to Train().  The
+   * kernel is evaluated between the points and the training points, so this
+   * costs O(n) kernel evaluations per point for n training points.
+   *
+   * @param points Points to embed (one per column).
+   * @param transformedPoints Matrix to store the embedded points in.
+   * @param kernel Kernel to be used for computation.
+   */
+  void Transform(const arma::mat& points,
+                 arma::mat& transformedPoints,
+                 KernelType kernel = KernelType()) const
+  {
+    // Center the kernel evaluations as the kernel matrix was centered.
+    arma::mat kernelMatrix;
+    kernel::KernelMatrix(referencePoints, points, kernel, kernelMatrix);
+    kernelMatrix.each_col() -= rowMean;
+    kernelMatrix.each_row() -= arma::sum(kernelMatrix, 0) /
+        kernelMatrix.n_rows;
+    kernelMatrix += totalMean;
+
+    transformedPoints = projection.t() * kernelMatrix;
+  }
+
+ private:
+  /**
+   * Compute, center and eigendecompose the kernel matrix, and return the means
+   * used for centering it.
+   */
+  static void Decompose(const arma::mat& data,
+                        arma::mat& transformedData,
+                        arma::vec& eigval,
+                        arma::mat& eigvec,
+                        KernelType& kernel,
+                        arma::vec& rowMean,
+                        double& totalMean)
+  {
+    // Construct the kernel matrix.  Only its upper triangular part is
+    // evaluated, since it is symmetric, and for the common kernels it is
+    // computed with matrix products.
+    arma::mat kernelMatrix;
+    kernel::KernelMatrix(data, kernel, kernelMatrix);
+
+    // For PCA the data has to be centered, even if the data is centered. But
+    // it is not guaranteed that the data, when mapped to the kernel space, is
+    // also centered. Since we actually never work in the feature space we
+    // cannot center the data. So, we perform a "psuedo-centering" using the
+    // kernel matrix.  The kernel matrix is symmetric, so the means of its rows
+    // and columns are the same.
+    rowMean = arma::sum(kernelMatrix, 1) / kernelMatrix.n_cols;
+    totalMean = arma::accu(rowMean) / kernelMatrix.n_cols;
+    kernelMatrix.each_col() -= rowMean;
+    kernelMatrix.each_row() -= rowMean.t();
+    kernelMatrix += totalMean;
+
+    // Eigendecompose the centered kernel matrix.
+    arma::eig_sym(eigval, eigvec, kernelMatrix);
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    transformedData = eigvec.t() * kernelMatrix;
+    transformedData.each_col() /= arma::sqrt(eigval);
   }
 
-  // Copy to the lower triangular part of the matrix.
-  for (size_t i = 1; i < data.n_cols; ++i)
-    for (size_t j = 0; j < i; ++j)
-      kernelMatrix(i, j) = kernelMatrix(j, i);
-
-  // For PCA the data has to be centered, even if the data is centered. But it
-  // is not guaranteed that the data, when mapped to the kernel space, is also
-  // centered. Since we actually never work in the feature space we cannot
-  // center the data. So, we perform a "psuedo-centering" using the kernel
-  // matrix.
-  arma::rowvec rowMean = arma::sum(kernelMatrix, 0) / kernelMatrix.n_cols;
-  kernelMatrix.each_col() -= arma::sum(kernelMatrix, 1) / kernelMatrix.n_cols;
-  kernelMatrix.each_row() -= rowMean;
-  kernelMatrix += arma::sum(rowMean) / kernelMatrix.n_cols;
-
-  // Eigendecompose the centered kernel matrix.
-  arma::eig_sym(eigval, eigvec, kernelMatrix);
-
-  // Swap the eigenvalues since they are ordered backwards (we need largest to
-  // smallest).
-  for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
-    eigval.swap_rows(i, (eigval.n_elem - 1) - i);
-
-  // Flip the coefficients to produce the same effect.
-  eigvec = arma::fliplr(eigvec);
-
-  transformedData = eigvec.t() * kernelMatrix;
-  transformedData.each_col() /= arma::sqrt(eigval);
-}
+  //! The training points.
+  arma::mat referencePoints;
+  //! The means of the rows of the training kernel matrix.
+  arma::vec rowMean;
+  //! The mean of the training kernel matrix.
+  double totalMean;
+  //! The eigenvectors kept by Train(), divided by the square roots of their
+  //! eigenvalues.
+  arma::mat projection;
 };
 
 } // namespace kpca
@@ -27,6 +27,9 @@ template<
 class NystroemKernelRule
 {
  public:
+  //! Create the rule; Train() must be called before Transform().
+  NystroemKernelRule() : numPoints(0), offset(0.0) { }
+
   /**
    * Construct the kernel matrix approximation using the nystroem method.
    *
@@ -43,25 +46,53 @@ class NystroemKernelRule
                                 arma::mat& eigvec,
                                 const size_t rank,
                                 KernelType kernel = KernelType())
+  {
+    NystroemKernelRule rule;
+    rule.Train(data, transformedData, eigval, eigvec, rank, kernel);
+  }
+
+  /**
+   * Perform kernel PCA as ApplyKernelMatrix() does, and keep what Transform()
+   * needs to embed new points: the landmark points selected by the Nystroem
+   * method, the map from kernel evaluations against the landmarks to features,
+   * the centering of the features, and the eigenvectors.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Rank to be used for matrix approximation (the number of
+   *     landmarks).
+   * @param kernel Kernel to be used for computation.
+   */
+  void Train(const arma::mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigval,
+             arma::mat& eigvec,
+             const size_t rank,
+             KernelType kernel = KernelType())
   {
     arma::mat G, v;
     kernel::NystroemMethod<KernelType, PointSelectionPolicy> nm(data, kernel,
         rank);
-    nm.Apply(G);
+    nm.Apply(G, landmarks, landmarkProjection);
     transformedData = G.t() * G;
 
     // Center the reconstructed approximation.
-    math::Center(transformedData, transformedData);
+    math::Center(transformedData);
 
     // For PCA the data has to be centered, even if the data is centered. But
     // it is not guaranteed that the data, when mapped to the kernel space, is
     // also centered. Since we actually never work in the feature space we
     // cannot center the data. So, we perform a "psuedo-centering" using the
     // kernel matrix.
+    numPoints = G.n_rows;
     arma::colvec colMean = arma::sum(G, 1) / G.n_rows;
-    G.each_row() -= arma::sum(G, 0) / G.n_rows;
+    featureMean = arma::sum(G, 0) / G.n_rows;
+    offset = arma::sum(colMean) / G.n_rows;
+    G.each_row() -= featureMean;
     G.each_col() -= colMean;
-    G += arma::sum(colMean) / G.n_rows;
+    G += offset;
 
     // Eigendecompose the centered kernel matrix.
     arma::eig_sym(eigval, eigvec, transformedData);
@@ -73,9 +104,54 @@ class NystroemKernelRule
 
     // Flip the coefficients to produce the same effect.
     eigvec = arma::fliplr(eigvec);
+    projection = eigvec;
 
     transformedData = eigvec.t() * G.t();
   }
+
+  /**
+   * Embed the given points with the model of the last call to Train().  The
+   * kernel is only evaluated between the points and the landmarks (in tiles,
+   * with kernel::KernelMatrix()), so this costs O(m) kernel evaluations per
+   * point for m landmarks, regardless of the number of training points.
+   *
+   * @param points Points to embed (one per column).
+   * @param transformedPoints Matrix to store the embedded points in.
+   * @param kernel Kernel to be used for computation.
+   */
+  void Transform(const arma::mat& points,
+                 arma::mat& transformedPoints,
+                 KernelType kernel = KernelType()) const
+  {
+    arma::mat semiKernel;
+    kernel::KernelMatrix(points, landmarks, kernel, semiKernel);
+    arma::mat G = semiKernel * landmarkProjection;
+
+    // Center the features as the training features were centered.
+    const arma::colvec pointMean = arma::sum(G, 1) / numPoints;
+    G.each_row() -= featureMean;
+    G.each_col() -= pointMean;
+    G += offset;
+
+    transformedPoints = projection.t() * G.t();
+  }
+
+  //! Get the landmark points selected by the last call to Train().
+  const arma::mat& Landmarks() const { return landmarks; }
+
+ private:
+  //! The landmark points.
+  arma::mat landmarks;
+  //! The map from the kernel evaluations against the landmarks to features.
+  arma::mat landmarkProjection;
+  //! The number of training points.
+  size_t numPoints;
+  //! The mean of the features of the training points.
+  arma::rowvec featureMean;
+  //! The constant added back when centering the features.
+  double offset;
+  //! The eigenvectors.
+  arma::mat projection;
 };
 
 } // namespace kpca
@@ -0,0 +1,331 @@
+/**
+ * @file random_fourier_features_method.hpp
+ *
+ * Use random Fourier features to approximate the kernel matrix for kernel PCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_FEATURES_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_FEATURES_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_pca_method.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * The distribution of the frequencies of the random Fourier features of a
+ * shift-invariant kernel k(x, y) = g(x - y): by Bochner's theorem, g is the
+ * Fourier transform of a probability distribution p, and
+ * k(x, y) = E_{w ~ p}[cos(w^T (x - y))].  Only the kernels with a
+ * specialization of this class can be used with RandomFourierFeaturesRule.  A
+ * specialization provides
+ *
+ * @code
+ * // Fill each row of frequencies with an independent sample of p.
+ * static void Sample(const KernelType& kernel, arma::mat& frequencies);
+ * @endcode
+ */
+template<typename KernelType>
+class FourierFeatureDistribution;
+
+//! The frequencies of the Gaussian kernel exp(-||x - y||^2 / (2 h^2)) are
+//! Gaussian, with covariance I / h^2.
+template<>
+class FourierFeatureDistribution<kernel::GaussianKernel>
+{
+ public:
+  static void Sample(const kernel::GaussianKernel& kernel,
+                     arma::mat& frequencies)
+  {
+    frequencies.randn();
+    frequencies /= kernel.Bandwidth();
+  }
+};
+
+//! The frequencies of the Laplacian kernel exp(-||x - y|| / h) follow a
+//! multivariate Cauchy distribution with scale 1 / h.
+template<>
+class FourierFeatureDistribution<kernel::LaplacianKernel>
+{
+ public:
+  static void Sample(const kernel::LaplacianKernel& kernel,
+                     arma::mat& frequencies)
+  {
+    // A multivariate Cauchy sample is a Gaussian sample divided by the absolute
+    // value of an independent standard normal sample.
+    frequencies.randn();
+    const arma::vec scales = arma::abs(arma::randn<arma::vec>(
+        frequencies.n_rows)) * kernel.Bandwidth();
+    frequencies.each_col() /= scales;
+  }
+};
+
+/**
+ * Approximate kernel PCA with random Fourier features, as in
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random Features for Large-Scale Kernel Machines},
+ *   author={Rahimi, A. and Recht, B.},
+ *   booktitle={Advances in Neural Information Processing Systems 20
+ *       (NIPS 2007)},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Each point x is mapped to the explicit features
+ * z(x) = sqrt(2 / D) cos(W x + b), with the D rows of W drawn from the
+ * FourierFeatureDistribution of the kernel and b uniform in [0, 2 pi], so that
+ * z(x)^T z(y) approximates k(x, y).  Kernel PCA is then linear PCA of the
+ * features, which is computed with pca::IncrementalPCAPolicy one batch of
+ * points at a time: the memory used is O(D^2 + D * batchSize) plus the output,
+ * instead of the O(n^2) of the exact kernel matrix.
+ *
+ * The eigenvalues are those of the (centered) approximate kernel matrix, as for
+ * the other kernel rules, but the eigenvectors are the principal axes in the
+ * feature space (a D x rank matrix), and the transformed data holds only the
+ * rank leading components.
+ *
+ * If orthogonal is true, the frequencies are drawn as orthogonal random
+ * features (Yu et al., "Orthogonal Random Features", NIPS 2016): in each block
+ * of d frequencies the directions are made orthogonal while their norms keep
+ * their distribution, which reduces the variance of the approximation.
+ *
+ * Unlike the other kernel rules, this rule holds parameters; pass an instance
+ * of it to the KernelPCA constructor to set them.
+ */
+template<typename KernelType>
+class RandomFourierFeaturesRule
+{
+ public:
+  /**
+   * Create the rule with the given parameters.
+   *
+   * @param numFeatures Number of random features D.
+   * @param orthogonal Whether to use orthogonal random features.
+   * @param batchSize Number of points mapped to features at a time.
+   */
+  RandomFourierFeaturesRule(const size_t numFeatures = 1000,
+                            const bool orthogonal = false,
+                            const size_t batchSize = 10000) :
+      numFeatures(numFeatures),
+      orthogonal(orthogonal),
+      batchSize(batchSize)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Perform approximate kernel PCA with random Fourier features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec Principal axes in the feature space will be written to this
+   *     matrix.
+   * @param rank Number of components to compute.
+   * @param kernel Kernel to be used for computation.
+   */
+  void ApplyKernelMatrix(const arma::mat& data,
+                         arma::mat& transformedData,
+                         arma::vec& eigval,
+                         arma::mat& eigvec,
+                         const size_t rank,
+                         KernelType kernel = KernelType())
+  {
+    if (numFeatures == 0)
+    {
+      throw std::invalid_argument("RandomFourierFeaturesRule::"
+          "ApplyKernelMatrix(): the number of features must be positive.");
+    }
+
+    SampleFeatures(data.n_rows, kernel);
+
+    // The first pass finds the principal axes of the features.
+    const size_t step = std::max(batchSize, (size_t) 1);
+    ipca.Reset(numFeatures);
+    arma::mat features;
+    for (size_t begin = 0; begin < data.n_cols; begin += step)
+    {
+      const size_t end = std::min(begin + step, (size_t) data.n_cols) - 1;
+      Features(data.cols(begin, end), features);
+      ipca.Update(features);
+    }
+
+    ipca.Components(eigval, eigvec);
+
+    // Eigenvalues of the centered kernel matrix are those of the scatter
+    // matrix of the features, not of their covariance.
+    eigval *= (double) (data.n_cols - 1);
+
+    const size_t dimension = std::max(std::min(rank, numFeatures), (size_t) 1);
+    if (dimension < eigvec.n_cols)
+      eigvec.shed_cols(dimension, eigvec.n_cols - 1);
+
+    // The second pass projects the features; data and transformedData may be
+    // the same matrix, so the result is only stored at the end.
+    arma::mat transformed(dimension, data.n_cols);
+    arma::mat transformedBatch;
+    for (size_t begin = 0; begin < data.n_cols; begin += step)
+    {
+      const size_t end = std::min(begin + step, (size_t) data.n_cols) - 1;
+      Features(data.cols(begin, end), features);
+      ipca.Transform(features, eigvec, transformedBatch);
+      transformed.cols(begin, end) = transformedBatch;
+    }
+
+    transformedData = std::move(transformed);
+  }
+
+  /**
+   * Perform approximate kernel PCA as ApplyKernelMatrix() does, and keep the
+   * principal axes, so that Transform() can embed new points.  The random
+   * features and their mean are kept by ApplyKernelMatrix() already.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec Principal axes in the feature space will be written to this
+   *     matrix.
+   * @param rank Number of components to compute.
+   * @param kernel Kernel to be used for computation.
+   */
+  void Train(const arma::mat& data,
+             arma::mat& transformedData,
+             arma::vec& eigval,
+             arma::mat& eigvec,
+             const size_t rank,
+             KernelType kernel = KernelType())
+  {
+    ApplyKernelMatrix(data, transformedData, eigval, eigvec, rank, kernel);
+    axes = eigvec;
+  }
+
+  /**
+   * Embed the given points with the model of the last call to Train(): the
+   * points are mapped to the random features and projected on the principal
+   * axes, one batch at a time, which costs O(D) per point for D features.
+   *
+   * @param points Points to embed (one per column).
+   * @param transformedPoints Matrix to store the embedded points in.
+   */
+  void Transform(const arma::mat& points,
+                 arma::mat& transformedPoints,
+                 const KernelType& /* kernel */ = KernelType()) const
+  {
+    const size_t step = std::max(batchSize, (size_t) 1);
+    arma::mat transformed(axes.n_cols, points.n_cols);
+    arma::mat features, transformedBatch;
+    for (size_t begin = 0; begin < points.n_cols; begin += step)
+    {
+      const size_t end = std::min(begin + step, (size_t) points.n_cols) - 1;
+      Features(points.cols(begin, end), features);
+      ipca.Transform(features, axes, transformedBatch);
+      transformed.cols(begin, end) = transformedBatch;
+    }
+
+    transformedPoints = std::move(transformed);
+  }
+
+  /**
+   * Map the given points to the random features drawn by the last call to
+   * ApplyKernelMatrix().
+   *
+   * @param points Points to map (one per column).
+   * @param features Matrix to store the features in (one column per point).
+   */
+  void Features(const arma::mat& points, arma::mat& features) const
+  {
+    const double scale = std::sqrt(2.0 / frequencies.n_rows);
+    features = frequencies * points;
+
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) features.n_cols; ++j)
+    {
+      for (size_t i = 0; i < features.n_rows; ++i)
+        features(i, j) = scale * std::cos(features(i, j) + phases[i]);
+    }
+  }
+
+  //! Get the number of random features.
+  size_t NumFeatures() const { return numFeatures; }
+  //! Modify the number of random features.
+  size_t& NumFeatures() { return numFeatures; }
+
+  //! Get whether orthogonal random features are used.
+  bool Orthogonal() const { return orthogonal; }
+  //! Modify whether orthogonal random features are used.
+  bool& Orthogonal() { return orthogonal; }
+
+  //! Get the number of points mapped to features at a time.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points mapped to features at a time.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the frequencies of the features (one per row).
+  const arma::mat& Frequencies() const { return frequencies; }
+  //! Get the phases of the features.
+  const arma::vec& Phases() const { return phases; }
+
+ private:
+  //! Draw the frequencies and phases of the features for points of the given
+  //! dimensionality.
+  void SampleFeatures(const size_t dimensionality, const KernelType& kernel)
+  {
+    frequencies.set_size(numFeatures, dimensionality);
+    FourierFeatureDistribution<KernelType>::Sample(kernel, frequencies);
+
+    if (orthogonal && dimensionality > 0)
+    {
+      // Replace the directions of each block of d frequencies with a uniformly
+      // random orthogonal basis, keeping the norms.
+      for (size_t begin = 0; begin < numFeatures; begin += dimensionality)
+      {
+        const size_t end = std::min(begin + dimensionality, numFeatures) - 1;
+
+        arma::mat q, r;
+        arma::qr(q, r, arma::randn<arma::mat>(dimensionality,
+            dimensionality));
+        // Fixing the signs makes the distribution of q uniform.
+        q.each_row() %= arma::sign(r.diag()).t();
+
+        for (size_t i = begin; i <= end; ++i)
+        {
+          frequencies.row(i) = arma::norm(frequencies.row(i)) *
+              q.row(i - begin);
+        }
+      }
+    }
+
+    phases = 2 * M_PI * arma::randu<arma::vec>(numFeatures);
+  }
+
+  //! Number of random features.
+  size_t numFeatures;
+  //! Whether orthogonal random features are used.
+  bool orthogonal;
+  //! Number of points mapped to features at a time.
+  size_t batchSize;
+
+  //! Frequencies of the features (one per row).
+  arma::mat frequencies;
+  //! Phases of the features.
+  arma::vec phases;
+  //! The statistics of the features of the training points.
+  pca::IncrementalPCAPolicy ipca;
+  //! The principal axes kept by Train().
+  arma::mat axes;
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
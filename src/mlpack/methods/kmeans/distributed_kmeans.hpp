@@ -0,0 +1,152 @@
+/**
+ * @file distributed_kmeans.hpp
+ *
+ * Lloyd's k-means over a dataset that is partitioned between processes, which
+ * combine their statistics with an all-reduce at each iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/math/single_process_all_reduce.hpp>
+#include "naive_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * DistributedKMeans runs Lloyd iterations on a dataset that is partitioned
+ * between processes (or ranks): each process calls Cluster() with its own
+ * partition and the same initial centroids.  At each iteration, each process
+ * runs the Lloyd step on its partition, which gives the sum of the points
+ * assigned to each centroid and their number; the all-reduce policy sums these
+ * statistics over the processes, so each process then computes the same new
+ * centroids.  The result is the same as k-means on the whole dataset (up to
+ * the order of floating-point sums), with one all-reduce of
+ * (dimensionality + 1) * clusters values per iteration.
+ *
+ * A cluster with no points in any partition keeps its centroid, as with
+ * AllowEmptyClusters; the other empty cluster policies need the whole dataset.
+ * The initial centroids are not computed here, since they must be the same on
+ * every process; they can, for instance, be found by KMeans on a sample of the
+ * data by one process, and sent to the others.
+ *
+ * @tparam AllReduceType Policy which sums vectors over the processes (see
+ *     math::SingleProcessAllReduce).
+ * @tparam MetricType The distance metric to use for this KMeans.
+ * @tparam LloydStepType Step of the Lloyd algorithm run on each partition.  It
+ *     must not keep state between iterations, since the centroids it is given
+ *     are not those it computed; NaiveKMeans is such a step.
+ * @tparam MatType Type of the data.
+ */
+template<typename AllReduceType = math::SingleProcessAllReduce,
+         typename MetricType = metric::EuclideanDistance,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the DistributedKMeans object.
+   *
+   * @param maxIterations Maximum number of iterations allowed before giving up
+   *     (0 is valid, but the algorithm may never terminate).
+   * @param allReduce Instantiated all-reduce policy.
+   * @param metric Optional MetricType object; for when the metric has state it
+   *     needs to store.
+   */
+  DistributedKMeans(const size_t maxIterations = 1000,
+                    const AllReduceType allReduce = AllReduceType(),
+                    const MetricType metric = MetricType());
+
+  /**
+   * Run k-means on the partition of the dataset of this process, starting
+   * from the given centroids, which must be the same on every process.  Every
+   * process must call Cluster() at the same time, and every process gets the
+   * same final centroids.
+   *
+   * @param localData Partition of the dataset held by this process.
+   * @param centroids Initial centroids, which are replaced by the final ones.
+   */
+  void Cluster(const MatType& localData, arma::mat& centroids);
+
+  /**
+   * Run k-means on the partition of the dataset of this process, as above,
+   * and also return the cluster of each point of the partition.
+   *
+   * @param localData Partition of the dataset held by this process.
+   * @param centroids Initial centroids, which are replaced by the final ones.
+   * @param localAssignments Cluster of each point of the partition.
+   */
+  void Cluster(const MatType& localData,
+               arma::mat& centroids,
+               arma::Row<size_t>& localAssignments);
+
+  /**
+   * Compute the statistics of one Lloyd iteration on a partition of the data:
+   * the sum of the points closest to each centroid, one centroid after the
+   * other, and then the number of points closest to each centroid.  The sum
+   * of the statistics of all the partitions gives the next centroids with
+   * Update().
+   *
+   * @param localData Partition of the dataset.
+   * @param centroids Current centroids.
+   * @param statistics Vector to store the statistics in.
+   */
+  void LocalStatistics(const MatType& localData,
+                       const arma::mat& centroids,
+                       arma::vec& statistics);
+
+  /**
+   * Replace the centroids by the means given by the statistics of the whole
+   * dataset (the sum of the LocalStatistics() of all the partitions), and
+   * return the norm of the change of the centroids.  Centroids with no points
+   * are not changed.
+   *
+   * @param statistics Statistics of the whole dataset.
+   * @param centroids Centroids to update.
+   */
+  double Update(const arma::vec& statistics, arma::mat& centroids);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the all-reduce policy.
+  const AllReduceType& AllReduce() const { return allReduce; }
+  //! Modify the all-reduce policy.
+  AllReduceType& AllReduce() { return allReduce; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! Compute the local statistics with the given Lloyd step object.
+  void LocalStatistics(LloydStepType<MetricType, MatType>& step,
+                       const arma::mat& centroids,
+                       arma::vec& statistics);
+
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! Instantiated all-reduce policy.
+  AllReduceType allReduce;
+  //! Instantiated distance metric.
+  MetricType metric;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file distributed_kmeans_impl.hpp
+ *
+ * Implementation of Lloyd's k-means over a dataset that is partitioned between
+ * processes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+DistributedKMeans(const size_t maxIterations,
+                  const AllReduceType allReduce,
+                  const MetricType metric) :
+    maxIterations(maxIterations),
+    allReduce(allReduce),
+    metric(metric)
+{
+  // Nothing to do.
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+Cluster(const MatType& localData, arma::mat& centroids)
+{
+  if (centroids.n_cols == 0)
+  {
+    throw std::invalid_argument("DistributedKMeans::Cluster(): no initial "
+        "centroids given!");
+  }
+
+  if (localData.n_cols > 0 && centroids.n_rows != localData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "DistributedKMeans::Cluster(): initial centroids have "
+        << "dimensionality " << centroids.n_rows << ", but the data has "
+        << "dimensionality " << localData.n_rows << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  LloydStepType<MetricType, MatType> lloydStep(localData, metric);
+  arma::vec statistics;
+
+  // Every process computes the same residual from the same statistics, so all
+  // the processes run the same number of iterations.
+  size_t iteration = 0;
+  double cNorm;
+  do
+  {
+    LocalStatistics(lloydStep, centroids, statistics);
+    allReduce.Sum(statistics);
+    cNorm = Update(statistics, centroids);
+
+    iteration++;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iteration
+        << ", residual " << cNorm << ".\n";
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  if (iteration != maxIterations)
+  {
+    Log::Info << "DistributedKMeans::Cluster(): converged after " << iteration
+        << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "DistributedKMeans::Cluster(): terminated after limit of "
+        << iteration << " iterations." << std::endl;
+  }
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+Cluster(const MatType& localData,
+        arma::mat& centroids,
+        arma::Row<size_t>& localAssignments)
+{
+  Cluster(localData, centroids);
+
+  // Assign each point of the partition to its closest centroid.
+  localAssignments.set_size(localData.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) localData.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = 0;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(localData.col(i),
+          centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    localAssignments[i] = closestCluster;
+  }
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+LocalStatistics(const MatType& localData,
+                const arma::mat& centroids,
+                arma::vec& statistics)
+{
+  LloydStepType<MetricType, MatType> lloydStep(localData, metric);
+  LocalStatistics(lloydStep, centroids, statistics);
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+LocalStatistics(LloydStepType<MetricType, MatType>& lloydStep,
+                const arma::mat& centroids,
+                arma::vec& statistics)
+{
+  // The Lloyd step gives the mean and the number of the points closest to each
+  // centroid; the means are turned back into sums, which can be added.
+  arma::mat means;
+  arma::Col<size_t> counts;
+  lloydStep.Iterate(centroids, means, counts);
+
+  const size_t dims = centroids.n_rows;
+  const size_t clusters = centroids.n_cols;
+  statistics.zeros((dims + 1) * clusters);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    if (counts[c] == 0)
+      continue;
+
+    statistics.subvec(c * dims, (c + 1) * dims - 1) = counts[c] * means.col(c);
+    statistics[dims * clusters + c] = counts[c];
+  }
+}
+
+template<typename AllReduceType,
+         typename MetricType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+double DistributedKMeans<AllReduceType, MetricType, LloydStepType, MatType>::
+Update(const arma::vec& statistics, arma::mat& centroids)
+{
+  const size_t dims = centroids.n_rows;
+  const size_t clusters = centroids.n_cols;
+  if (statistics.n_elem != (dims + 1) * clusters)
+  {
+    std::ostringstream oss;
+    oss << "DistributedKMeans::Update(): " << statistics.n_elem << " statistics"
+        << " given, but there should be " << (dims + 1) * clusters << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Calculate the change of the centroids at the same time.
+  double cNorm = 0.0;
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    const double count = statistics[dims * clusters + c];
+    if (count == 0.0)
+      continue;
+
+    const arma::vec newCentroid = statistics.subvec(c * dims,
+        (c + 1) * dims - 1) / count;
+    cNorm += std::pow(metric.Evaluate(centroids.col(c), newCentroid), 2.0);
+    centroids.col(c) = newCentroid;
+  }
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -119,12 +119,19 @@ class DualTreeKMeans
                   const double parentLowerBound = DBL_MAX,
                   const double adjustedParentLowerBound = 0.0);
 
-  //! Extract the centroids of the clusters.
+  //! Extract the centroids of the clusters.  The nodes are summed in
+  //! parallel.
   void ExtractCentroids(Tree& node,
                         arma::mat& newCentroids,
                         arma::Col<size_t>& newCounts,
                         const arma::mat& centroids);
 
+  //! Collect the nodes owned by a cluster and the leaves that are not, which
+  //! together hold every point once.
+  void CollectCentroidNodes(Tree& node,
+                            const size_t clusters,
+                            std::vector<Tree*>& nodes);
+
   void CoalesceTree(Tree& node, const size_t child = 0);
   void DecoalesceTree(Tree& node);
 };
@@ -20,6 +20,10 @@
 
 #include "dual_tree_kmeans_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace kmeans {
 
@@ -480,88 +484,94 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::ExtractCentroids(
     Tree& node,
     arma::mat& newCentroids,
     arma::Col<size_t>& newCounts,
-    const arma::mat& centroids)
+    const arma::mat& /* centroids */)
 {
-  // Does this node own points?
-  if ((node.Stat().Pruned() == newCentroids.n_cols) ||
-      (node.Stat().StaticPruned() && node.Stat().Owner() < newCentroids.n_cols))
+  // Find the nodes that hold the points, then add them up in parallel.
+  std::vector<Tree*> nodes;
+  CollectCentroidNodes(node, newCentroids.n_cols, nodes);
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Each thread accumulates the nodes it sees into its own slice.
+  arma::cube threadCentroids(newCentroids.n_rows, newCentroids.n_cols,
+      numThreads, arma::fill::zeros);
+  arma::Mat<size_t> threadCounts(newCentroids.n_cols, numThreads,
+      arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t n = 0; n < (omp_size_t) nodes.size(); ++n)
   {
-    const size_t owner = node.Stat().Owner();
-    newCentroids.col(owner) += node.Stat().Centroid() * node.NumDescendants();
-    newCounts[owner] += node.NumDescendants();
-
-    // Perform the sanity check here.
-/*
-    for (size_t i = 0; i < node.NumDescendants(); ++i)
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    const Tree& current = *nodes[n];
+    arma::mat& localCentroids = threadCentroids.slice(threadId);
+
+    // Does this node own points?
+    if ((current.Stat().Pruned() == newCentroids.n_cols) ||
+        (current.Stat().StaticPruned() &&
+         current.Stat().Owner() < newCentroids.n_cols))
     {
-      const size_t index = node.Descendant(i);
-      arma::vec trueDistances(centroids.n_cols);
-      for (size_t j = 0; j < centroids.n_cols; ++j)
-      {
-        const double dist = metric.Evaluate(dataset.col(index),
-                                            centroids.col(j));
-        trueDistances[j] = dist;
-      }
-
-      arma::uword minIndex;
-      const double minDist = trueDistances.min(minIndex);
-      if (size_t(minIndex) != owner)
+      const size_t owner = current.Stat().Owner();
+      localCentroids.unsafe_col(owner) += current.Stat().Centroid() *
+          current.NumDescendants();
+      threadCounts(owner, threadId) += current.NumDescendants();
+    }
+    else
+    {
+      // Check each point held in the leaf.
+      for (size_t i = 0; i < current.NumPoints(); ++i)
       {
-        Log::Warn << node;
-        Log::Warn << trueDistances.t();
-        Log::Fatal << "Point " << index << " of node " << node.Point(0) << "c"
-<< node.NumDescendants() << " has true minimum cluster " << minIndex << " with "
-      << "distance " << minDist << " but node is pruned with upper bound " <<
-node.Stat().UpperBound() << " and owner " << node.Stat().Owner() << ".\n";
+        const size_t owner = assignments[current.Point(i)];
+        localCentroids.unsafe_col(owner) +=
+            arma::vec(dataset.col(current.Point(i)));
+        ++threadCounts(owner, threadId);
       }
     }
-*/
   }
-  else
+
+  // Combine the partial results of each thread.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) newCentroids.n_cols; ++c)
   {
-    // Check each point held in the node.
-    // Only check at leaves.
-    if (node.NumChildren() == 0)
+    for (size_t t = 0; t < numThreads; ++t)
     {
-      for (size_t i = 0; i < node.NumPoints(); ++i)
-      {
-        const size_t owner = assignments[node.Point(i)];
-        newCentroids.col(owner) += dataset.col(node.Point(i));
-        ++newCounts[owner];
-
-/*
-        const size_t index = node.Point(i);
-        arma::vec trueDistances(centroids.n_cols);
-        for (size_t j = 0; j < centroids.n_cols; ++j)
-        {
-          const double dist = metric.Evaluate(dataset.col(index),
-                                              centroids.col(j));
-          trueDistances[j] = dist;
-        }
-
-        arma::uword minIndex;
-        const double minDist = trueDistances.min(minIndex);
-        if (size_t(minIndex) != owner)
-        {
-          Log::Warn << node;
-          Log::Warn << trueDistances.t();
-          Log::Fatal << "Point " << index << " of node " << node.Point(0) << "c"
-  << node.NumDescendants() << " has true minimum cluster " << minIndex << " with "
-        << "distance " << minDist << " but was assigned to cluster " <<
-assignments[node.Point(i)] << " with ub " << upperBounds[node.Point(i)] <<
-" and lb " << lowerBounds[node.Point(i)] << "; pp " <<
-(prunedPoints[node.Point(i)] ? "true" : "false") << ", visited " <<
-(visited[node.Point(i)] ? "true"
-: "false") << ".\n";
-        }
-*/
-      }
+      newCentroids.unsafe_col(c) += threadCentroids.slice(t).unsafe_col(c);
+      newCounts(c) += threadCounts(c, t);
     }
+  }
+}
 
-    // The node is not entirely owned by a cluster.  Recurse.
-    for (size_t i = 0; i < node.NumChildren(); ++i)
-      ExtractCentroids(node.Child(i), newCentroids, newCounts, centroids);
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DualTreeKMeans<MetricType, MatType, TreeType>::CollectCentroidNodes(
+    Tree& node,
+    const size_t clusters,
+    std::vector<Tree*>& nodes)
+{
+  // A node that is owned by a cluster holds all of its descendants.
+  if ((node.Stat().Pruned() == clusters) ||
+      (node.Stat().StaticPruned() && node.Stat().Owner() < clusters))
+  {
+    nodes.push_back(&node);
+    return;
   }
+
+  // The node is not entirely owned by a cluster.  Only check the points at
+  // the leaves, and recurse.
+  if (node.NumChildren() == 0)
+    nodes.push_back(&node);
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CollectCentroidNodes(node.Child(i), clusters, nodes);
 }
 
 template<typename MetricType,
@@ -15,6 +15,10 @@
 // In case it hasn't been included yet.
 #include "elkan_kmeans.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace kmeans {
 
@@ -46,8 +50,9 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
+  // Initially set r(x) to true.  This is not a std::vector<bool>, because
+  // the threads write the flags of neighboring points.
+  std::vector<char> mustRecalculate(dataset.n_cols, 1);
 
   // If this is the first iteration, we must reset all the bounds.
   if (lowerBounds.n_rows != centroids.n_cols)
@@ -79,15 +84,40 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // The bounds of each point are independent of the other points, so the
+  // points are processed in parallel.  Each thread accumulates the points it
+  // sees into its own slice, and uses its own copy of the metric.
+  arma::cube threadCentroids(centroids.n_rows, centroids.n_cols, numThreads,
+      arma::fill::zeros);
+  arma::Mat<size_t> threadCounts(centroids.n_cols, numThreads,
+      arma::fill::zeros);
+  std::vector<MetricType> metrics(numThreads, metric);
+
   // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel for schedule(dynamic, 256) \
+      reduction(+:pointDistanceCalculations)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    arma::mat& localCentroids = threadCentroids.slice(threadId);
+    MetricType& localMetric = metrics[threadId];
+
     // Step 2: identify all points such that u(x) <= s(c(x)).
     if (upperBounds(i) <= minClusterDistances(assignments[i]))
     {
       // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      threadCounts(assignments[i], threadId)++;
+      localCentroids.unsafe_col(assignments[i]) += arma::vec(dataset.col(i));
       continue;
     }
     else
@@ -110,11 +140,12 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         double dist;
         if (mustRecalculate[i])
         {
-          mustRecalculate[i] = false;
-          dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
+          mustRecalculate[i] = 0;
+          dist = localMetric.Evaluate(dataset.col(i),
+              centroids.col(assignments[i]));
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -133,10 +164,10 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
             dist > 0.5 * clusterDistances(assignments[i], c))
         {
           // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
-          const double pointDist = metric.Evaluate(dataset.col(i),
-                                                   centroids.col(c));
+          const double pointDist = localMetric.Evaluate(dataset.col(i),
+              centroids.col(c));
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          pointDistanceCalculations++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -149,8 +180,20 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     // At this point, we know the new cluster assignment.
     // Step 4: for each center c, let m(c) be the mean of the points assigned to
     // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+    localCentroids.unsafe_col(assignments[i]) += arma::vec(dataset.col(i));
+    threadCounts(assignments[i], threadId)++;
+  }
+  distanceCalculations += pointDistanceCalculations;
+
+  // Combine the partial results of each thread.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+      newCentroids.unsafe_col(c) += threadCentroids.slice(t).unsafe_col(c);
+      counts(c) += threadCounts(c, t);
+    }
   }
 
   // Now, normalize and calculate the distance each cluster has moved.
@@ -166,7 +209,8 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
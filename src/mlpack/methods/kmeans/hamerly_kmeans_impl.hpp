@@ -15,6 +15,10 @@
 // In case it hasn't been included yet.
 #include "hamerly_kmeans.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace kmeans {
 
@@ -67,8 +71,33 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // The bounds of each point are independent of the other points, so the
+  // points are processed in parallel.  Each thread accumulates the points it
+  // sees into its own slice, and uses its own copy of the metric.
+  arma::cube threadCentroids(centroids.n_rows, centroids.n_cols, numThreads,
+      arma::fill::zeros);
+  arma::Mat<size_t> threadCounts(centroids.n_cols, numThreads,
+      arma::fill::zeros);
+  std::vector<MetricType> metrics(numThreads, metric);
+
+  size_t pointDistanceCalculations = 0;
+  #pragma omp parallel for schedule(dynamic, 256) \
+      reduction(+:hamerlyPruned, pointDistanceCalculations)
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    arma::mat& localCentroids = threadCentroids.slice(threadId);
+    MetricType& localMetric = metrics[threadId];
+
     const double m = std::max(minClusterDistances(assignments[i]),
                               lowerBounds(i));
 
@@ -76,21 +105,21 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     if (upperBounds(i) <= m)
     {
       ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
+      localCentroids.unsafe_col(assignments[i]) += arma::vec(dataset.col(i));
+      ++threadCounts(assignments[i], threadId);
       continue;
     }
 
     // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
+    upperBounds(i) = localMetric.Evaluate(dataset.col(i),
+                                          centroids.col(assignments[i]));
+    ++pointDistanceCalculations;
 
     // Second bound test.
     if (upperBounds(i) <= m)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
+      localCentroids.unsafe_col(assignments[i]) += arma::vec(dataset.col(i));
+      ++threadCounts(assignments[i], threadId);
       continue;
     }
 
@@ -103,7 +132,8 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
       if (c == assignments[i])
         continue;
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+      const double dist = localMetric.Evaluate(dataset.col(i),
+          centroids.col(c));
 
       // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
       if (dist < upperBounds(i))
@@ -119,11 +149,23 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         lowerBounds(i) = dist;
       }
     }
-    distanceCalculations += centroids.n_cols - 1;
+    pointDistanceCalculations += centroids.n_cols - 1;
 
     // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+    localCentroids.unsafe_col(assignments[i]) += arma::vec(dataset.col(i));
+    ++threadCounts(assignments[i], threadId);
+  }
+  distanceCalculations += pointDistanceCalculations;
+
+  // Combine the partial results of each thread.
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+      newCentroids.unsafe_col(c) += threadCentroids.slice(t).unsafe_col(c);
+      counts(c) += threadCounts(c, t);
+    }
   }
 
   // Normalize centroids and calculate cluster movement (contains parts of
@@ -158,7 +200,8 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     upperBounds(i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
@@ -18,6 +18,7 @@
 #include "sample_initialization.hpp"
 #include "max_variance_new_cluster.hpp"
 #include "naive_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
@@ -63,7 +64,7 @@ namespace kmeans /** K-Means clustering. */ {
  * @tparam LloydStepType Implementation of single Lloyd step to use.
  *
  * @see RandomPartition, SampleInitialization, RefinedStart, AllowEmptyClusters,
- *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans
+ *      MaxVarianceNewCluster, NaiveKMeans, ElkanKMeans, MiniBatchKMeans
  */
 template<typename MetricType = metric::EuclideanDistance,
          typename InitialPartitionPolicy = SampleInitialization,
@@ -155,6 +156,29 @@ class KMeans
                const bool initialAssignmentGuess = false,
                const bool initialCentroidGuess = false);
 
+  /**
+   * Update the given centroids with a batch of points, using the mini-batch
+   * k-means update of MiniBatchKMeans.  This can be called repeatedly with
+   * consecutive batches of a dataset that is too large to hold in memory, or
+   * with the batches of a stream of points.  Each centroid is moved towards the
+   * points of the batch assigned to it, with a learning rate of 1 / (number of
+   * points the centroid has seen so far).
+   *
+   * If centroids is empty, it is initialized from the first batch with the
+   * InitialPartitionPolicy, and counts is set to zero.  The batch must then
+   * have at least as many points as there are clusters.
+   *
+   * @param batch Points to update the centroids with.
+   * @param clusters Number of clusters.
+   * @param centroids Current centroids, to be updated.
+   * @param counts Number of points seen by each centroid so far, to be updated.
+   * @return Norm of the change of the centroids.
+   */
+  double Update(const MatType& batch,
+                const size_t clusters,
+                arma::mat& centroids,
+                arma::Col<size_t>& counts);
+
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Set the maximum number of iterations.
@@ -337,6 +337,83 @@ Cluster(const MatType& data,
   }
 }
 
+/**
+ * Update the centroids with one batch of points.
+ */
+template<typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+double KMeans<
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Update(const MatType& batch,
+       const size_t clusters,
+       arma::mat& centroids,
+       arma::Col<size_t>& counts)
+{
+  if (batch.n_cols == 0)
+    return 0.0;
+
+  // Initialize the centroids from the first batch.
+  if (centroids.n_cols == 0)
+  {
+    if (clusters > batch.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "KMeans::Update(): the first batch has " << batch.n_cols
+          << " points, but " << clusters << " clusters were requested";
+      throw std::invalid_argument(oss.str());
+    }
+
+    arma::Row<size_t> assignments;
+    bool gotAssignments = GetInitialAssignmentsOrCentroids(partitioner, batch,
+        clusters, assignments, centroids);
+    if (gotAssignments)
+    {
+      arma::Row<size_t> initialCounts;
+      initialCounts.zeros(clusters);
+      centroids.zeros(batch.n_rows, clusters);
+      for (size_t i = 0; i < batch.n_cols; ++i)
+      {
+        centroids.col(assignments[i]) += arma::vec(batch.col(i));
+        initialCounts[assignments[i]]++;
+      }
+
+      for (size_t i = 0; i < clusters; ++i)
+        if (initialCounts[i] != 0)
+          centroids.col(i) /= initialCounts[i];
+    }
+
+    counts.zeros(clusters);
+  }
+
+  if (centroids.n_cols != clusters || centroids.n_rows != batch.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "KMeans::Update(): centroids have size " << centroids.n_rows << "x"
+        << centroids.n_cols << ", but the batch has dimensionality "
+        << batch.n_rows << " and " << clusters << " clusters were requested";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (counts.n_elem != clusters)
+    counts.zeros(clusters);
+
+  MiniBatchKMeans<MetricType, MatType> step(batch, metric);
+  arma::mat newCentroids;
+  const double cNorm = step.Update(
+      arma::regspace<arma::uvec>(0, batch.n_cols - 1), centroids,
+      newCentroids, counts);
+  centroids = std::move(newCentroids);
+
+  return cNorm;
+}
+
 template<typename MetricType,
          typename InitialPartitionPolicy,
          typename EmptyClusterPolicy,
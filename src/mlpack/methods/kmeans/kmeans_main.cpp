@@ -17,10 +17,14 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
+#include "spherical_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -49,14 +53,27 @@ PROGRAM_INFO("K-Means Clustering",
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Instead, the k-means++ initialization (\"k-means++: the advantages of "
+    "careful seeding\", 2007) can be used by specifying the " +
+    PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter, or its scalable "
+    "variant k-means|| (\"Scalable k-means++\", 2012) by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter; k-means|| samples "
+    "about " + PRINT_PARAM_STRING("oversampling") + " times k candidate "
+    "centroids in each of " + PRINT_PARAM_STRING("rounds") + " passes over the "
+    "data, so it is much faster than k-means++ for large k."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), Sculley's mini-batch k-means "
+    "('mini-batch'), which only uses a random batch of 1000 points in each "
+    "iteration and so is approximate, and spherical k-means ('spherical'), "
+    "which clusters the points by cosine similarity and gives centroids with "
+    "unit norm."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -140,9 +157,19 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means++ and k-means|| initialization.
+PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ initialization strategy to "
+    "choose initial points.", "K");
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| initialization strategy to "
+    "choose initial points.", "");
+PARAM_DOUBLE_IN("oversampling", "Oversampling factor of k-means|| (use when "
+    "--kmeans_parallel is specified).", "", 2.0);
+PARAM_INT_IN("rounds", "Number of sampling rounds of k-means|| (use when "
+    "--kmeans_parallel is specified).", "", 5);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', 'mini-batch', or 'spherical').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -171,6 +198,19 @@ static void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  if ((int) CLI::HasParam("refined_start") +
+      (int) CLI::HasParam("kmeans_plus_plus") +
+      (int) CLI::HasParam("kmeans_parallel") > 1)
+  {
+    Log::Fatal << "Can only specify one of "
+        << PRINT_PARAM_STRING("refined_start") << ", "
+        << PRINT_PARAM_STRING("kmeans_plus_plus") << ", or "
+        << PRINT_PARAM_STRING("kmeans_parallel") << "!" << endl;
+  }
+
+  ReportIgnoredParam({{ "kmeans_parallel", false }}, "oversampling");
+  ReportIgnoredParam({{ "kmeans_parallel", false }}, "rounds");
+
   if (CLI::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -183,6 +223,23 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (CLI::HasParam("kmeans_plus_plus"))
+  {
+    FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(
+        KMeansPlusPlusInitialization());
+  }
+  else if (CLI::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<double>("oversampling", [](double x) { return x > 0.0; },
+        true, "oversampling factor must be positive");
+    RequireParamValue<int>("rounds", [](int x) { return x > 0; }, true,
+        "number of rounds must be positive");
+    const double oversampling = CLI::GetParam<double>("oversampling");
+    const size_t rounds = (size_t) CLI::GetParam<int>("rounds");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(oversampling, rounds));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -213,8 +270,9 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "mini-batch", "spherical" },
+      true,
+      "unknown k-means algorithm");
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -232,6 +290,12 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "mini-batch")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
+  else if (algorithm == "spherical")
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        SphericalKMeans>(ipp);
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -278,8 +342,12 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_plus_plus", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!CLI::HasParam("refined_start"))
+    if (!CLI::HasParam("refined_start") &&
+        !CLI::HasParam("kmeans_plus_plus") &&
+        !CLI::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
@@ -0,0 +1,111 @@
+/**
+ * @file kmeans_parallel_initialization.hpp
+ *
+ * The k-means|| strategy to choose initial centroids, a scalable version of
+ * k-means++ that samples many candidates in each of a few passes over the
+ * dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means|| initialization.  Like k-means++, it favors points that are far
+ * from the centroids chosen so far; but instead of one centroid per pass over
+ * the dataset, each pass samples about oversampling * k candidates at once.
+ * After a few rounds, the candidates are weighted by the number of points
+ * closest to them, and k centroids are chosen among them with a weighted
+ * k-means++.  So only a few passes over the dataset are needed even for a
+ * large k, and the distances of each pass are computed in parallel.  It is an
+ * implementation of the following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * oversampling factor (the expected number of candidates sampled in each
+   * round is oversampling * k) and the number of rounds.
+   */
+  KMeansParallelInitialization(const double oversampling = 2.0,
+                               const size_t rounds = 5) :
+      oversampling(oversampling), rounds(rounds) { }
+
+  /**
+   * Initialize the centroids matrix with the k-means|| strategy.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids) const;
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of rounds of sampling.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of rounds of sampling.
+  size_t& Rounds() { return rounds; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+  }
+
+ private:
+  /**
+   * Update the squared distance of each point to its closest candidate, and
+   * the index of that candidate, with the candidates from the given one on.
+   */
+  template<typename MatType>
+  static void UpdateDistances(const MatType& data,
+                              const std::vector<size_t>& candidates,
+                              const size_t first,
+                              arma::vec& distances,
+                              arma::Col<size_t>& closest);
+
+  //! The oversampling factor.
+  double oversampling;
+  //! The number of rounds of sampling.
+  size_t rounds;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
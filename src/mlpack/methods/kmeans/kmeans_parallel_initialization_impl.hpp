@@ -0,0 +1,109 @@
+/**
+ * @file kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  const size_t n = data.n_cols;
+
+  // Start with one random candidate.
+  std::vector<size_t> candidates;
+  candidates.push_back((size_t) math::RandInt(n));
+
+  arma::vec distances(n);
+  distances.fill(DBL_MAX);
+  arma::Col<size_t> closest(n);
+  UpdateDistances(data, candidates, 0, distances, closest);
+
+  const double expected = oversampling * clusters;
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    // If the cost is 0, every point is a candidate already.
+    const double cost = arma::accu(distances);
+    if (!(cost > 0.0))
+      break;
+
+    // Sample each point independently.  The random numbers are drawn here, so
+    // that the result doesn't depend on the number of threads.
+    const size_t first = candidates.size();
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (math::Random() * cost < expected * distances[i])
+        candidates.push_back(i);
+    }
+
+    UpdateDistances(data, candidates, first, distances, closest);
+  }
+
+  // Weight each candidate by the number of points closest to it.
+  arma::mat candidatePoints(data.n_rows, candidates.size());
+  for (size_t c = 0; c < candidates.size(); ++c)
+    candidatePoints.col(c) = data.col(candidates[c]);
+
+  arma::vec weights(candidates.size(), arma::fill::zeros);
+  for (size_t i = 0; i < n; ++i)
+    weights[closest[i]] += 1.0;
+
+  if (candidates.size() > clusters)
+  {
+    // Recluster the weighted candidates.
+    KMeansPlusPlusInitialization::Seed(candidatePoints, weights, clusters,
+        centroids);
+  }
+  else
+  {
+    // There are too few candidates (for instance if the dataset has few
+    // distinct points); the other centroids are random points.
+    centroids.set_size(data.n_rows, clusters);
+    centroids.cols(0, candidates.size() - 1) = candidatePoints;
+    for (size_t c = candidates.size(); c < clusters; ++c)
+      centroids.col(c) = data.col((size_t) math::RandInt(n));
+  }
+}
+
+template<typename MatType>
+void KMeansParallelInitialization::UpdateDistances(
+    const MatType& data,
+    const std::vector<size_t>& candidates,
+    const size_t first,
+    arma::vec& distances,
+    arma::Col<size_t>& closest)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    for (size_t c = first; c < candidates.size(); ++c)
+    {
+      const double distance = metric::SquaredEuclideanDistance::Evaluate(
+          data.col(i), data.col(candidates[c]));
+      if (distance < distances[i])
+      {
+        distances[i] = distance;
+        closest[i] = c;
+      }
+    }
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * @file kmeans_plus_plus_initialization.hpp
+ *
+ * The k-means++ strategy to choose initial centroids: each centroid is sampled
+ * from the dataset with probability proportional to its squared distance to
+ * the closest centroid chosen so far.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PLUS_PLUS_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The k-means++ initialization, which chooses initial centroids that are
+ * spread out over the dataset, so that k-means often needs fewer iterations
+ * and finds a better clustering than with randomly sampled centroids.  It is
+ * an implementation of the following paper:
+ *
+ * @code
+ * @inproceedings{arthur2007kmeans,
+ *   title={k-means++: The advantages of careful seeding},
+ *   author={Arthur, David and Vassilvitskii, Sergei},
+ *   booktitle={Proceedings of the Eighteenth Annual ACM-SIAM Symposium on
+ *       Discrete Algorithms (SODA 2007)},
+ *   pages={1027--1035},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * Choosing k centroids takes k passes over the dataset; the distances of each
+ * pass are computed in parallel.
+ */
+class KMeansPlusPlusInitialization
+{
+ public:
+  //! Empty constructor, required by the InitialPartitionPolicy type definition.
+  KMeansPlusPlusInitialization() { }
+
+  /**
+   * Initialize the centroids matrix with the k-means++ strategy.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids) const
+  {
+    Seed(data, arma::vec(), clusters, centroids);
+  }
+
+  /**
+   * Choose the given number of centroids among the points of the given
+   * dataset with the k-means++ strategy, where each point is counted with the
+   * given weight (for instance, the number of points it stands for).
+   *
+   * @param data Dataset.
+   * @param weights Weight of each point, or an empty vector for equal weights.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  static void Seed(const MatType& data,
+                   const arma::vec& weights,
+                   const size_t clusters,
+                   arma::mat& centroids)
+  {
+    const size_t n = data.n_cols;
+    centroids.set_size(data.n_rows, clusters);
+
+    // The squared distance of each point to the closest centroid so far.
+    arma::vec distances(n);
+    distances.fill(DBL_MAX);
+    arma::vec scores;
+
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      size_t index;
+      if (c == 0)
+      {
+        index = (weights.n_elem == 0) ? (size_t) math::RandInt(n) :
+            Sample(weights);
+      }
+      else
+      {
+        scores = (weights.n_elem == 0) ? distances : distances % weights;
+        index = Sample(scores);
+      }
+
+      centroids.col(c) = data.col(index);
+
+      #pragma omp parallel for
+      for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+      {
+        const double distance = metric::SquaredEuclideanDistance::Evaluate(
+            data.col(i), centroids.col(c));
+        if (distance < distances[i])
+          distances[i] = distance;
+      }
+    }
+  }
+
+  //! Serialize the object (which holds nothing, so, nothing to do).
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */) { }
+
+ private:
+  /**
+   * Return a random index, with probability proportional to its score.  If
+   * all the scores are 0, the index is uniformly random.
+   */
+  static size_t Sample(const arma::vec& scores)
+  {
+    const double total = arma::accu(scores);
+    if (!(total > 0.0))
+      return (size_t) math::RandInt(scores.n_elem);
+
+    const double threshold = math::Random() * total;
+    double sum = 0.0;
+    size_t last = 0;
+    for (size_t i = 0; i < scores.n_elem; ++i)
+    {
+      if (scores[i] <= 0.0)
+        continue;
+
+      sum += scores[i];
+      last = i;
+      if (sum > threshold)
+        return i;
+    }
+
+    // Only reached because of rounding.
+    return last;
+  }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
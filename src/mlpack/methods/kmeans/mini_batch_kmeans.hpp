@@ -0,0 +1,120 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of the mini-batch k-means step by Sculley, which updates
+ * the centroids with a small random batch of points in each iteration, instead
+ * of the whole dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An implementation of the mini-batch k-means step of Sculley:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, David},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Each call to Iterate() samples a batch of points from the dataset, assigns
+ * them to their closest centroids, and moves each centroid towards its points
+ * with a per-centroid learning rate of 1 / (number of points the centroid has
+ * seen so far).  Because each iteration only looks at a batch, the residual
+ * does not drop to zero as it does for the exact Lloyd steps, so KMeans will
+ * usually run until the maximum number of iterations.  This is also used by
+ * KMeans::Update() to cluster streams of batches.
+ *
+ * The counts returned by Iterate() are the total number of points each
+ * centroid has seen in all of the iterations so far, so that a cluster is only
+ * considered empty if no point was ever assigned to it.
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   * @param batchSize Number of points sampled in each iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  MetricType& metric,
+                  const size_t batchSize = 1000);
+
+  /**
+   * Run a single mini-batch iteration, updating the given centroids into the
+   * newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points seen by each cluster so far.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Update the centroids with the given batch of points of the dataset.  The
+   * counts are the number of points each centroid has seen before this batch,
+   * and they are updated with the points of this batch.
+   *
+   * @param batch Indices of the points of the dataset to use.
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points seen by each cluster so far.
+   * @return Norm of the change of the centroids.
+   */
+  double Update(const arma::uvec& batch,
+                const arma::mat& centroids,
+                arma::mat& newCentroids,
+                arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! Number of points sampled in each iteration.
+  size_t batchSize;
+  //! Number of points seen by each cluster over all iterations.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the mini-batch k-means step.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric,
+                                                      const size_t batchSize) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(batchSize),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  // If the batch would cover the whole dataset, just use all of the points.
+  arma::uvec batch;
+  if (batchSize == 0 || batchSize >= dataset.n_cols)
+  {
+    batch = arma::regspace<arma::uvec>(0, dataset.n_cols - 1);
+  }
+  else
+  {
+    batch.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      batch[i] = math::RandInt(dataset.n_cols);
+  }
+
+  const double cNorm = Update(batch, centroids, newCentroids, clusterCounts);
+  counts = clusterCounts;
+  return cNorm;
+}
+
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Update(
+    const arma::uvec& batch,
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // First find the closest centroid to each point of the batch.  All the
+  // assignments use the centroids from before the batch, so this can be done
+  // in parallel.
+  arma::Col<size_t> closest(batch.n_elem);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) batch.n_elem; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = metric.Evaluate(dataset.col(batch[i]),
+          centroids.unsafe_col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    closest[i] = closestCluster;
+  }
+  distanceCalculations += centroids.n_cols * batch.n_elem;
+
+  // Now move each centroid towards its points.  With a learning rate of
+  // 1 / count, each centroid is the mean of all the points it has seen.
+  newCentroids = centroids;
+  for (size_t i = 0; i < batch.n_elem; ++i)
+  {
+    const size_t cluster = closest[i];
+    ++counts[cluster];
+    const double eta = 1.0 / counts[cluster];
+
+    newCentroids.unsafe_col(cluster) *= (1.0 - eta);
+    newCentroids.unsafe_col(cluster) += eta * dataset.col(batch[i]);
+  }
+
+  // Calculate how much the centroids moved.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
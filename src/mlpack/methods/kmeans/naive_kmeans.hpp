@@ -15,16 +15,63 @@
 #ifndef MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_NAIVE_KMEANS_HPP
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
 
 namespace mlpack {
 namespace kmeans {
 
+/**
+ * Add the given point of a dense dataset, multiplied by the given weight, to
+ * the given centroid.
+ *
+ * @param dataset Dataset.
+ * @param point Index of the point to add.
+ * @param weight Weight of the point.
+ * @param centroid Memory of the centroid (dataset.n_rows elements).
+ */
+inline void AddPointToCentroid(const arma::mat& dataset,
+                               const size_t point,
+                               const double weight,
+                               double* centroid)
+{
+  arma::vec centroidAlias(centroid, dataset.n_rows, false, true);
+  centroidAlias += weight * dataset.col(point);
+}
+
+/**
+ * Add the given point of a sparse dataset, multiplied by the given weight, to
+ * the given centroid.  Only the nonzero elements of the point are visited.
+ *
+ * @param dataset Dataset.
+ * @param point Index of the point to add.
+ * @param weight Weight of the point.
+ * @param centroid Memory of the centroid (dataset.n_rows elements).
+ */
+inline void AddPointToCentroid(const arma::sp_mat& dataset,
+                               const size_t point,
+                               const double weight,
+                               double* centroid)
+{
+  arma::sp_mat::const_iterator it = dataset.begin_col(point);
+  for ( ; it != dataset.end_col(point); ++it)
+    centroid[it.row()] += weight * (*it);
+}
+
 /**
  * This is an implementation of a single iteration of Lloyd's algorithm for
  * k-means.  If your intention is to run the full k-means algorithm, you are
  * looking for the mlpack::kmeans::KMeans class instead of this one.  This class
  * is used by KMeans as the actual implementation of the Lloyd iteration.
  *
+ * For dense or sparse data with the Euclidean or squared Euclidean distance,
+ * the closest centroids of a block of points are found with a single matrix
+ * multiplication, since the closest centroid c to a point x minimizes
+ * ||c||^2 - 2 c^T x.  Each thread accumulates its points into its own partial
+ * centroids (only the nonzero elements of sparse points are visited), and the
+ * partial results are summed in parallel over the centroids at the end of the
+ * iteration.
+ *
  * @param MetricType Type of metric used with this implementation.
  * @param MatType Matrix type (arma::mat or arma::sp_mat).
  */
@@ -57,6 +104,22 @@ class NaiveKMeans
   size_t DistanceCalculations() const { return distanceCalculations; }
 
  private:
+  /**
+   * Find the closest centroid to each of the points [begin, end) of the
+   * dataset.
+   *
+   * @param centroids Current cluster centroids.
+   * @param centroidNorms Squared norms of the centroids.
+   * @param begin First point of the block.
+   * @param end One past the last point of the block.
+   * @param closest Will hold the closest centroid of each point in the block.
+   */
+  void FindClosest(const arma::mat& centroids,
+                   const arma::vec& centroidNorms,
+                   const size_t begin,
+                   const size_t end,
+                   arma::Col<size_t>& closest);
+
   //! The dataset.
   const MatType& dataset;
   //! The instantiated metric.
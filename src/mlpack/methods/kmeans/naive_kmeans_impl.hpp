@@ -39,46 +39,54 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
 
-  // Find the closest centroid to each point and update the new centroids.
-  // Computed in parallel over the complete dataset
-  #pragma omp parallel
-  {
-    // The current state of the K-means is private for each thread
-    arma::mat localCentroids(centroids.n_rows, centroids.n_cols,
-        arma::fill::zeros);
-    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+  const size_t numThreads = ParallelForThreads();
 
-    #pragma omp for
-    for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
-    {
-      // Find the closest centroid to this point.
-      double minDistance = std::numeric_limits<double>::infinity();
-      size_t closestCluster = centroids.n_cols; // Invalid value.
+  // Each thread accumulates the points it sees into its own slice, so there is
+  // no need to synchronize the threads until the partial results are summed.
+  arma::cube threadCentroids(centroids.n_rows, centroids.n_cols, numThreads,
+      arma::fill::zeros);
+  arma::Mat<size_t> threadCounts(centroids.n_cols, numThreads,
+      arma::fill::zeros);
 
-      for (size_t j = 0; j < centroids.n_cols; j++)
-      {
-        const double distance = metric.Evaluate(dataset.col(i),
-            centroids.unsafe_col(j));
-        if (distance < minDistance)
-        {
-          minDistance = distance;
-          closestCluster = j;
-        }
-      }
+  // The squared norms of the centroids are only needed for the matrix
+  // multiplication-based search, but they are cheap to compute.
+  const arma::vec centroidNorms = arma::trans(arma::sum(arma::square(centroids),
+      0));
 
-      Log::Assert(closestCluster != centroids.n_cols);
+  // Find the closest centroid to each point and update the partial centroids.
+  // Computed in parallel over blocks of the dataset.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+  ParallelFor(0, numBlocks, [&](const size_t b)
+  {
+    const size_t threadId = ThreadId();
+    arma::mat& localCentroids = threadCentroids.slice(threadId);
+    arma::Col<size_t> closest;
 
-      // We now have the minimum distance centroid index.  Update that centroid.
-      localCentroids.unsafe_col(closestCluster) += dataset.col(i);
-      localCounts(closestCluster)++;
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) dataset.n_cols, begin + blockSize);
+    FindClosest(centroids, centroidNorms, begin, end, closest);
+
+    // We now have the minimum distance centroid indices.  Update those
+    // centroids.
+    for (size_t i = begin; i < end; ++i)
+    {
+      AddPointToCentroid(dataset, i, 1.0,
+          localCentroids.colptr(closest[i - begin]));
+      threadCounts(closest[i - begin], threadId)++;
     }
-    // Combine calculated state from each thread
-    #pragma omp critical
+  });
+
+  // Combine the partial results of each thread.  Every centroid is summed
+  // independently, so this is also parallel.
+  ParallelFor(0, centroids.n_cols, [&](const size_t j)
+  {
+    for (size_t t = 0; t < numThreads; ++t)
     {
-      newCentroids += localCentroids;
-      counts += localCounts;
+      newCentroids.unsafe_col(j) += threadCentroids.slice(t).unsafe_col(j);
+      counts(j) += threadCounts(j, t);
     }
-  }
+  });
 
   // Now normalize the centroid.
   for (size_t i = 0; i < centroids.n_cols; ++i)
@@ -99,6 +107,61 @@ double NaiveKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   return std::sqrt(cNorm);
 }
 
+template<typename MetricType, typename MatType>
+void NaiveKMeans<MetricType, MatType>::FindClosest(
+    const arma::mat& centroids,
+    const arma::vec& centroidNorms,
+    const size_t begin,
+    const size_t end,
+    arma::Col<size_t>& closest)
+{
+  closest.set_size(end - begin);
+
+  const bool useGEMM = (std::is_same<MatType, arma::mat>::value ||
+      std::is_same<MatType, arma::sp_mat>::value) &&
+      (std::is_same<MetricType, metric::EuclideanDistance>::value ||
+       std::is_same<MetricType, metric::SquaredEuclideanDistance>::value);
+  if (useGEMM)
+  {
+    // ||x - c||^2 = ||x||^2 - 2 c^T x + ||c||^2, and ||x||^2 doesn't change
+    // which centroid is the closest.  For sparse data, this is a dense-sparse
+    // product, which only visits the nonzero elements of the points.
+    arma::mat scores = centroids.t() * dataset.cols(begin, end - 1);
+    scores *= -2.0;
+    scores.each_col() += centroidNorms;
+
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      arma::uword closestCluster;
+      scores.col(i).min(closestCluster);
+      closest[i] = closestCluster;
+    }
+  }
+  else
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      // Find the closest centroid to this point.
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; j++)
+      {
+        const double distance = metric.Evaluate(dataset.col(i),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+      closest[i - begin] = closestCluster;
+    }
+  }
+}
+
 } // namespace kmeans
 } // namespace mlpack
 
@@ -0,0 +1,93 @@
+/**
+ * @file spherical_kmeans.hpp
+ *
+ * An implementation of a Lloyd iteration for spherical k-means, which clusters
+ * points by their cosine similarity to the centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "naive_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A single iteration of spherical k-means, for data such as TF-IDF vectors of
+ * documents, where the direction of a point matters but not its norm.  Each
+ * point is assigned to the centroid with the largest cosine similarity (see
+ * kernel::CosineDistance), and each new centroid is the normalized mean of the
+ * normalized points assigned to it, so the centroids have unit norm.
+ *
+ * The similarities of a block of points are computed with a single matrix
+ * multiplication, which for sparse data only visits the nonzero elements of
+ * the points, and the data is not copied or normalized.
+ *
+ * Since the centroids have unit norm, the closest centroid of a point in
+ * Euclidean distance is also the one with the largest cosine similarity, so
+ * this can be used with metric::EuclideanDistance as the MetricType of KMeans:
+ *
+ * @code
+ * KMeans<metric::EuclideanDistance, SampleInitialization,
+ *     MaxVarianceNewCluster, SphericalKMeans, arma::sp_mat> k;
+ * k.Cluster(documents, 100, assignments, centroids);
+ * @endcode
+ *
+ * @tparam MetricType Type of metric of KMeans (not used by the iteration).
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class SphericalKMeans
+{
+ public:
+  /**
+   * Construct the SphericalKMeans object with the given dataset and metric.
+   * The norms of the points are computed here.
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  SphericalKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of spherical k-means, updating the given centroids
+   * into the newCentroids matrix.  The centroids don't need to have unit norm.
+   * If any cluster is empty, its new centroid is zero.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids (with unit norm).
+   * @param counts Number of points in each cluster at the end of the iteration.
+   * @return Euclidean norm of the change of the normalized centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  //! Get the number of similarity calculations.
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+  //! The norm of each point.
+  arma::vec pointNorms;
+
+  //! Number of similarity calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "spherical_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file spherical_kmeans_impl.hpp
+ *
+ * Implementation of the SphericalKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spherical_kmeans.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+SphericalKMeans<MetricType, MatType>::SphericalKMeans(const MatType& dataset,
+                                                      MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    pointNorms(dataset.n_cols),
+    distanceCalculations(0)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    pointNorms[i] = arma::norm(dataset.col(i), 2);
+}
+
+template<typename MetricType, typename MatType>
+double SphericalKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // Normalize the current centroids, so that the similarity of a point to a
+  // centroid is proportional to their cosine similarity (the norm of the point
+  // doesn't change which centroid is the most similar).  Zero centroids stay
+  // zero.
+  arma::mat unitCentroids(centroids);
+  for (size_t j = 0; j < unitCentroids.n_cols; ++j)
+  {
+    const double norm = arma::norm(unitCentroids.col(j), 2);
+    if (norm > 0.0)
+      unitCentroids.col(j) /= norm;
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
+  // Each thread accumulates the points it sees into its own slice.
+  arma::cube threadCentroids(centroids.n_rows, centroids.n_cols, numThreads,
+      arma::fill::zeros);
+  arma::Mat<size_t> threadCounts(centroids.n_cols, numThreads,
+      arma::fill::zeros);
+
+  const size_t blockSize = 256;
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel
+  {
+    size_t threadId = 0;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+    #endif
+
+    arma::mat& localCentroids = threadCentroids.slice(threadId);
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min((size_t) dataset.n_cols, begin + blockSize);
+      const arma::mat similarities = unitCentroids.t() *
+          dataset.cols(begin, end - 1);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        arma::uword closest;
+        similarities.col(i - begin).max(closest);
+
+        // Points with zero norm have no direction, so they are counted but
+        // don't move the centroid.
+        if (pointNorms[i] > 0.0)
+        {
+          AddPointToCentroid(dataset, i, 1.0 / pointNorms[i],
+              localCentroids.colptr(closest));
+        }
+        threadCounts(closest, threadId)++;
+      }
+    }
+  }
+
+  // Combine the partial results of each thread.
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) centroids.n_cols; ++j)
+  {
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+      newCentroids.unsafe_col(j) += threadCentroids.slice(t).unsafe_col(j);
+      counts(j) += threadCounts(j, t);
+    }
+  }
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // The new centroids are the normalized means, which have the same direction
+  // as the sums.
+  double cNorm = 0.0;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    const double norm = arma::norm(newCentroids.col(j), 2);
+    if (norm > 0.0)
+      newCentroids.col(j) /= norm;
+
+    cNorm += std::pow(arma::norm(newCentroids.col(j) - unitCentroids.col(j),
+        2), 2.0);
+  }
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -75,6 +75,32 @@ void LARS::Train(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
+  // Compute X' * y.  Neither this nor the Gram matrix need the data to be
+  // transposed, so we never form its transpose.
+  arma::vec vecXTy;
+  if (transposeData)
+    vecXTy = matX * trans(y);
+  else
+    vecXTy = trans(y * matX);
+
+  // Compute the Gram matrix, unless LARS will stop right away.  Only a Gram
+  // matrix that was passed in is kept between calls; our own is recomputed,
+  // since it belongs to the data of the previous call.
+  const size_t dims = vecXTy.n_elem;
+  if ((matGram == &matGramInternal || matGram->n_elem != dims * dims) &&
+      arma::any(arma::abs(vecXTy) >= lambda1))
+  {
+    ComputeGram(matX, transposeData, matGramInternal);
+    matGram = &matGramInternal;
+  }
+
+  TrainCovariance(vecXTy, beta);
+
+  Timer::Stop("lars_regression");
+}
+
+void LARS::TrainCovariance(const arma::vec& vecXTy, arma::vec& beta)
+{
   // Clear any previous solution information.
   betaPath.clear();
   lambdaPath.clear();
@@ -84,27 +110,18 @@ void LARS::Train(const arma::mat& matX,
   isIgnored.clear();
   matUtriCholFactor.reset();
 
-  // This matrix may end up holding the transpose -- if necessary.
-  arma::mat dataTrans;
-  // dataRef is row-major.
-  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
-  if (transposeData)
-    dataTrans = trans(matX);
-
-  // Compute X' * y.
-  arma::vec vecXTy = trans(y * dataRef);
+  const size_t dims = vecXTy.n_elem;
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
-  isActive.resize(dataRef.n_cols, false);
+  isActive.resize(dims, false);
 
   // Set up ignores set variables. Initialized empty.
-  isIgnored.resize(dataRef.n_cols, false);
+  isIgnored.resize(dims, false);
 
-  // Initialize yHat and beta.
-  beta = arma::zeros(dataRef.n_cols);
-  arma::vec yHat = arma::zeros(dataRef.n_rows);
-  arma::vec yHatDirection(dataRef.n_rows);
+  // Initialize beta.
+  beta = arma::zeros(dims);
+  arma::vec dirCorrs(dims);
 
   bool lassocond = false;
 
@@ -128,28 +145,25 @@ void LARS::Train(const arma::mat& matX,
   if (maxCorr < lambda1)
   {
     lambdaPath[0] = lambda1;
-    Timer::Stop("lars_regression");
     return;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+  if (matGram->n_rows != dims || matGram->n_cols != dims)
   {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
+    std::ostringstream oss;
+    oss << "LARS::TrainCovariance(): the Gram matrix is " << matGram->n_rows
+        << "x" << matGram->n_cols << ", but there are " << dims
+        << " dimensions.";
+    throw std::invalid_argument(oss.str());
   }
 
   // Main loop.
-  while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
+  while (((activeSet.size() + ignoreSet.size()) < dims) &&
          (maxCorr > tolerance))
   {
     // Compute the maximum correlation among inactive dimensions.
     maxCorr = 0;
-    for (size_t i = 0; i < dataRef.n_cols; i++)
+    for (size_t i = 0; i < dims; i++)
     {
       if ((!isActive[i]) && (!isIgnored[i]) && (fabs(corr(i)) > maxCorr))
       {
@@ -168,7 +182,7 @@ void LARS::Train(const arma::mat& matX,
         //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
         // }
         // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
+        arma::vec newGramCol = matGram->elem(changeInd * dims +
             arma::conv_to<arma::uvec>::from(activeSet));
 
         CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
@@ -258,21 +272,23 @@ void LARS::Train(const arma::mat& matX,
       }
     }
 
-    // compute "equiangular" direction in output space
-    ComputeYHatDirection(dataRef, betaDirection, yHatDirection);
+    // Compute the correlations X' * (X * betaDirection) of the "equiangular"
+    // direction in output space with each dimension; the Gram matrix gives
+    // them without touching the data.
+    ComputeDirCorrs(betaDirection, dirCorrs);
 
     double gamma = maxCorr / normalization;
 
     // If not all variables are active.
-    if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
+    if ((activeSet.size() + ignoreSet.size()) < dims)
     {
       // Compute correlations with direction.
-      for (size_t ind = 0; ind < dataRef.n_cols; ind++)
+      for (size_t ind = 0; ind < dims; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        double dirCorr = dirCorrs(ind);
         double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0) && (val1 < gamma))
@@ -307,9 +323,6 @@ void LARS::Train(const arma::mat& matX,
       }
     }
 
-    // Update the prediction.
-    yHat += gamma * yHatDirection;
-
     // Update the estimator.
     for (size_t i = 0; i < activeSet.size(); i++)
     {
@@ -334,8 +347,16 @@ void LARS::Train(const arma::mat& matX,
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
-    if (elasticNet)
+    // Recompute the correlations from the estimator.  It is nonzero only on
+    // the active set, so this takes only those columns of the Gram matrix, and
+    // unlike updating the correlations step by step it accumulates no error.
+    corr = vecXTy;
+    for (size_t i = 0; i < activeSet.size(); i++)
+      corr -= beta(activeSet[i]) * matGram->col(activeSet[i]);
+
+    // Without the Cholesky factorization, lambda2 * I is already part of the
+    // Gram matrix.
+    if (elasticNet && useCholesky)
       corr -= lambda2 * beta;
 
     double curLambda = 0;
@@ -359,8 +380,6 @@ void LARS::Train(const arma::mat& matX,
 
   // Unfortunate copy...
   beta = betaPath.back();
-
-  Timer::Stop("lars_regression");
 }
 
 void LARS::Train(const arma::mat& data,
@@ -371,6 +390,59 @@ void LARS::Train(const arma::mat& data,
   Train(data, responses, beta, transposeData);
 }
 
+void LARS::Solve(const arma::mat& data,
+                 const arma::mat& responses,
+                 arma::mat& betas,
+                 const bool transposeData) const
+{
+  const size_t numPoints = transposeData ? data.n_cols : data.n_rows;
+  if (responses.n_cols != numPoints)
+  {
+    std::ostringstream oss;
+    oss << "LARS::Solve(): there are " << numPoints << " points, but the "
+        << "responses have " << responses.n_cols << " columns.";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("lars_regression");
+
+  // Compute X' * y for every response at once; each column holds the
+  // correlations of one response.
+  arma::mat correlations;
+  if (transposeData)
+    correlations = data * trans(responses);
+  else
+    correlations = trans(responses * data);
+
+  // The Gram matrix is shared by all the responses.
+  const size_t dims = correlations.n_rows;
+  arma::mat gramInternal;
+  const arma::mat* gram = matGram;
+  if (matGram == &matGramInternal || matGram->n_elem != dims * dims)
+  {
+    ComputeGram(data, transposeData, gramInternal);
+    gram = &gramInternal;
+  }
+
+  betas.set_size(dims, responses.n_rows);
+  #pragma omp parallel
+  {
+    // Each thread solves its responses with its own model.
+    LARS lars(useCholesky, *gram, lambda1, lambda2, tolerance);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) responses.n_rows; ++i)
+    {
+      // Create an alias of the solution (using the same memory), so that LARS
+      // places the result directly into betas.
+      arma::vec beta = betas.unsafe_col(i);
+      lars.TrainCovariance(correlations.unsafe_col(i), beta);
+    }
+  }
+
+  Timer::Stop("lars_regression");
+}
+
 void LARS::Predict(const arma::mat& points,
                    arma::rowvec& predictions,
                    const bool rowMajor) const
@@ -401,13 +473,29 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
-                                const arma::vec& betaDirection,
-                                arma::vec& yHatDirection)
+void LARS::ComputeDirCorrs(const arma::vec& betaDirection,
+                           arma::vec& dirCorrs)
 {
-  yHatDirection.fill(0);
+  dirCorrs.zeros(matGram->n_rows);
   for (size_t i = 0; i < activeSet.size(); i++)
-    yHatDirection += betaDirection(i) * matX.col(activeSet[i]);
+    dirCorrs += betaDirection(i) * matGram->col(activeSet[i]);
+}
+
+void LARS::ComputeGram(const arma::mat& data,
+                       const bool transposeData,
+                       arma::mat& gram) const
+{
+  // Armadillo evaluates both products with a symmetric rank-k update, which a
+  // multithreaded BLAS runs in parallel.
+  if (transposeData)
+    gram = data * trans(data);
+  else
+    gram = trans(data) * data;
+
+  // If this is the elastic net problem, we will add lambda2 * I_n to the
+  // matrix.
+  if (elasticNet && !useCholesky)
+    gram.diag() += lambda2;
 }
 
 void LARS::InterpolateBeta()
@@ -173,10 +173,10 @@ class LARS
   /**
    * Run LARS.  The input matrix (like all mlpack matrices) should be
    * column-major -- each column is an observation and each row is a dimension.
-   * However, because LARS is more efficient on a row-major matrix, this method
-   * will (internally) transpose the matrix.  If this transposition is not
-   * necessary (i.e., you want to pass in a row-major matrix), pass 'false' for
-   * the transposeData parameter.
+   * However, LARS can also take a row-major matrix; in that case, pass 'false'
+   * for the transposeData parameter.  Either way, the data is only used to
+   * compute X' * y and the Gram matrix X' * X (unless a Gram matrix was passed
+   * to the constructor), and each step of LARS then works with those alone.
    *
    * @param data Column-major input data (or row-major input data if rowMajor =
    *     true).
@@ -192,10 +192,10 @@ class LARS
   /**
    * Run LARS.  The input matrix (like all mlpack matrices) should be
    * column-major -- each column is an observation and each row is a dimension.
-   * However, because LARS is more efficient on a row-major matrix, this method
-   * will (internally) transpose the matrix.  If this transposition is not
-   * necessary (i.e., you want to pass in a row-major matrix), pass 'false' for
-   * the transposeData parameter.
+   * However, LARS can also take a row-major matrix; in that case, pass 'false'
+   * for the transposeData parameter.  Either way, the data is only used to
+   * compute X' * y and the Gram matrix X' * X (unless a Gram matrix was passed
+   * to the constructor), and each step of LARS then works with those alone.
    *
    * @param data Input data.
    * @param responses A vector of targets.
@@ -206,6 +206,39 @@ class LARS
              const arma::rowvec& responses,
              const bool transposeData = true);
 
+  /**
+   * Run LARS given only the correlations X' * y of each dimension with the
+   * responses, and the Gram matrix X' * X that was passed to the constructor
+   * (plus lambda2 * I if this is the elastic net problem and useCholesky is
+   * false); the data itself is not needed.  Each step of LARS then costs
+   * O(d * |active set|) for d dimensions, no matter how many points there are.
+   * A std::invalid_argument is thrown if the Gram matrix doesn't match the
+   * number of dimensions.
+   *
+   * @param vecXTy Correlations of each dimension with the responses.
+   * @param beta Vector to store the solution (the coefficients) in.
+   */
+  void TrainCovariance(const arma::vec& vecXTy, arma::vec& beta);
+
+  /**
+   * Solve the problem for many vectors of responses against the same data,
+   * computing the Gram matrix (unless one was passed to the constructor) and
+   * the correlations of all the responses only once.  The responses are solved
+   * in parallel with OpenMP, each thread with its own copy of this LARS
+   * object, so the model itself (BetaPath(), ActiveSet(), and so on) is not
+   * changed.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param responses Responses to solve for, one vector of targets per row.
+   * @param betas Matrix to store the solutions in, one per column.
+   * @param transposeData Set to false if the data is row-major.
+   */
+  void Solve(const arma::mat& data,
+             const arma::mat& responses,
+             arma::mat& betas,
+             const bool transposeData = true) const;
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -309,10 +342,14 @@ class LARS
    */
   void Ignore(const size_t varInd);
 
-  // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
-                            const arma::vec& betaDirection,
-                            arma::vec& yHatDirection);
+  // compute correlations of "equiangular" direction in output space with each
+  // dimension
+  void ComputeDirCorrs(const arma::vec& betaDirection, arma::vec& dirCorrs);
+
+  // compute Gram matrix of data (plus lambda2 * I, if needed)
+  void ComputeGram(const arma::mat& data,
+                   const bool transposeData,
+                   arma::mat& gram) const;
 
   // interpolate to compute last solution vector
   void InterpolateBeta();
@@ -13,6 +13,10 @@
 #include "linear_regression.hpp"
 #include <mlpack/core/util/log.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::regression;
 
@@ -52,39 +56,141 @@ void LinearRegression::Train(const arma::mat& predictors,
    * We want to calculate the a_i coefficients of:
    * \sum_{i=0}^n (a_i * x_i^i)
    * In order to get the intercept value, we will add a row of ones.
+   * The intercept is not penalized. Add an "all ones" row to design and set
+   * intercept = false to get a penalized intercept.
    */
+  const size_t dims = predictors.n_rows + (intercept ? 1 : 0);
+  gram.zeros(dims, dims);
+  moment.zeros(dims);
+  Accumulate(predictors, responses, weights);
 
-  // We store the number of rows and columns of the predictors.
-  // Reminder: Armadillo stores the data transposed from how we think of it,
-  //           that is, columns are actually rows (see: column major order).
-  const size_t nCols = predictors.n_cols;
+  // Convert to this form:
+  // a * (X X^T) = y X^T.
+  // Then we'll use Armadillo to solve it.
+  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
+  // (assuming the SVD is used to solve it)
+  arma::mat cov = gram + lambda * arma::eye<arma::mat>(dims, dims);
 
-  arma::mat p = predictors;
-  arma::rowvec r = responses;
+  parameters = arma::solve(cov, moment);
+}
 
-  // Here we add the row of ones to the predictors.
-  // The intercept is not penalized. Add an "all ones" row to design and set
-  // intercept = false to get a penalized intercept.
-  if (intercept)
+void LinearRegression::Update(const arma::mat& predictors,
+                              const arma::rowvec& responses,
+                              const double forgetting)
+{
+  Update(predictors, responses, arma::rowvec(), forgetting);
+}
+
+void LinearRegression::Update(const arma::mat& predictors,
+                              const arma::rowvec& responses,
+                              const arma::rowvec& weights,
+                              const double forgetting)
+{
+  const size_t dims = predictors.n_rows + (intercept ? 1 : 0);
+  if (gram.is_empty())
   {
-    p.insert_rows(0, arma::ones<arma::mat>(1, nCols));
+    gram.zeros(dims, dims);
+    moment.zeros(dims);
+  }
+  else if (gram.n_rows != dims)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression::Update(): the data has " << predictors.n_rows
+        << " dimensions, but the model has " << (gram.n_rows -
+        (intercept ? 1 : 0)) << "!";
+    throw std::invalid_argument(oss.str());
   }
 
-  if (weights.n_elem > 0)
+  if (responses.n_elem != predictors.n_cols ||
+      (weights.n_elem > 0 && weights.n_elem != predictors.n_cols))
   {
-    p = p * diagmat(sqrt(weights));
-    r = sqrt(weights) % responses;
+    throw std::invalid_argument("LinearRegression::Update(): there must be one "
+        "response (and one weight, if given) for each data point!");
   }
 
-  // Convert to this form:
-  // a * (X X^T) = y X^T.
-  // Then we'll use Armadillo to solve it.
-  // The total runtime of this should be O(d^2 N) + O(d^3) + O(dN).
-  // (assuming the SVD is used to solve it)
-  arma::mat cov = p * p.t() +
-      lambda * arma::eye<arma::mat>(p.n_rows, p.n_rows);
+  if (forgetting <= 0.0 || forgetting > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression::Update(): the forgetting factor must be in "
+        << "(0, 1], but it is " << forgetting << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (forgetting != 1.0)
+  {
+    gram *= forgetting;
+    moment *= forgetting;
+  }
+  Accumulate(predictors, responses, weights);
+
+  // The regularized sums are symmetric positive definite when lambda is
+  // positive or enough data has been seen, so the Cholesky factor solves them
+  // in O(d^3), with no pass over the data.
+  const arma::mat cov = gram + lambda * arma::eye<arma::mat>(dims, dims);
+  arma::mat factor;
+  if (arma::chol(factor, cov))
+  {
+    parameters = arma::solve(arma::trimatu(factor),
+        arma::solve(arma::trimatl(factor.t()), moment));
+  }
+  else
+  {
+    parameters = arma::solve(cov, moment);
+  }
+}
 
-  parameters = arma::solve(cov, p * r.t());
+void LinearRegression::Accumulate(const arma::mat& predictors,
+                                  const arma::rowvec& responses,
+                                  const arma::rowvec& weights)
+{
+  const size_t n = predictors.n_cols;
+  const size_t offset = intercept ? 1 : 0;
+
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    numBlocks = omp_get_max_threads();
+  #endif
+  numBlocks = std::max(std::min(numBlocks, n), (size_t) 1);
+
+  // The sums of the blocks are added in order at the end, so that the results
+  // don't depend on the scheduling of the threads.
+  std::vector<arma::mat> blockGrams(numBlocks);
+  std::vector<arma::vec> blockMoments(numBlocks);
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * n / numBlocks;
+    const size_t end = (b + 1) * n / numBlocks;
+    if (begin == end)
+      continue;
+
+    // Here we add the row of ones to the predictors.
+    arma::mat p(predictors.n_rows + offset, end - begin);
+    if (intercept)
+      p.row(0).ones();
+    p.rows(offset, p.n_rows - 1) = predictors.cols(begin, end - 1);
+    arma::rowvec r = responses.subvec(begin, end - 1);
+
+    if (weights.n_elem > 0)
+    {
+      const arma::rowvec s = arma::sqrt(weights.subvec(begin, end - 1));
+      p.each_row() %= s;
+      r %= s;
+    }
+
+    blockGrams[b] = p * p.t();
+    blockMoments[b] = p * r.t();
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    if (blockGrams[b].is_empty())
+      continue;
+
+    gram += blockGrams[b];
+    moment += blockMoments[b];
+  }
 }
 
 void LinearRegression::Predict(const arma::mat& points,
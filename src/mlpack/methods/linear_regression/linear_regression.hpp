@@ -63,10 +63,9 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data. Careful! This will
-   * completely ignore and overwrite the existing model. This particular
-   * implementation does not have an incremental training algorithm.  To set the
-   * regularization parameter lambda, call Lambda() or set a different value in
-   * the constructor.
+   * completely ignore and overwrite the existing model.  To add more data to a
+   * trained model, use Update() instead.  To set the regularization parameter
+   * lambda, call Lambda() or set a different value in the constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -78,10 +77,10 @@ class LinearRegression
 
   /**
    * Train the LinearRegression model on the given data and weights. Careful!
-   * This will completely ignore and overwrite the existing model. This
-   * particular implementation does not have an incremental training algorithm.
-   * To set the regularization parameter lambda, call Lambda() or set a
-   * different value in the constructor.
+   * This will completely ignore and overwrite the existing model.  To add more
+   * data to a trained model, use Update() instead.  To set the regularization
+   * parameter lambda, call Lambda() or set a different value in the
+   * constructor.
    *
    * @param predictors X, the matrix of data points to train the model on.
    * @param responses y, the responses to the data points.
@@ -93,6 +92,40 @@ class LinearRegression
              const arma::rowvec& weights,
              const bool intercept = true);
 
+  /**
+   * Add a batch of data to the model, without the data the model was trained on
+   * before.  The model keeps the sums X X^T and X y over all the data it has
+   * seen (Train() sets them too), so an update takes O(d^2 n) time for a batch
+   * of n points and O(d^3) time for the Cholesky solve, whatever the number of
+   * points seen before.  The batch is split between the OpenMP threads.
+   *
+   * The sums of the older data are first scaled by the forgetting factor, so
+   * with a factor below 1 the older data counts less at each update and the
+   * model follows data that drifts over time.  The intercept setting of the
+   * model is kept; if the model has no data yet, an empty model is started.
+   *
+   * @param predictors X, the matrix of new data points.
+   * @param responses y, the responses to the new data points.
+   * @param forgetting Factor in (0, 1] to scale the older data by.
+   */
+  void Update(const arma::mat& predictors,
+              const arma::rowvec& responses,
+              const double forgetting = 1.0);
+
+  /**
+   * Add a batch of weighted data to the model; see the other overload of
+   * Update().
+   *
+   * @param predictors X, the matrix of new data points.
+   * @param responses y, the responses to the new data points.
+   * @param weights Observation weights of the new data points.
+   * @param forgetting Factor in (0, 1] to scale the older data by.
+   */
+  void Update(const arma::mat& predictors,
+              const arma::rowvec& responses,
+              const arma::rowvec& weights,
+              const double forgetting = 1.0);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -134,18 +167,44 @@ class LinearRegression
   //! Return whether or not an intercept term is used in the model.
   bool Intercept() const { return intercept; }
 
+  //! Return the weighted sum of x x^T over the data seen (without lambda).
+  const arma::mat& Gram() const { return gram; }
+  //! Return the weighted sum of x y over the data seen.
+  const arma::vec& Moment() const { return moment; }
+
   /**
    * Serialize the model.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
+  void serialize(Archive& ar, const unsigned int version)
   {
     ar & BOOST_SERIALIZATION_NVP(parameters);
     ar & BOOST_SERIALIZATION_NVP(lambda);
     ar & BOOST_SERIALIZATION_NVP(intercept);
+
+    // Older models have no sums, so they can't be updated.
+    if (version > 0)
+    {
+      ar & BOOST_SERIALIZATION_NVP(gram);
+      ar & BOOST_SERIALIZATION_NVP(moment);
+    }
+    else if (Archive::is_loading::value)
+    {
+      gram.clear();
+      moment.clear();
+    }
   }
 
  private:
+  /**
+   * Add the weighted sums x x^T and x y of the given data to the sums of the
+   * model, in parallel over blocks of points.
+   */
+  void Accumulate(const arma::mat& predictors,
+                  const arma::rowvec& responses,
+                  const arma::rowvec& weights);
+
+
   /**
    * The calculated B.
    * Initialized and filled by constructor to hold the least squares solution.
@@ -160,9 +219,18 @@ class LinearRegression
 
   //! Indicates whether first parameter is intercept.
   bool intercept;
+
+  //! The weighted sum of x x^T over the data seen, with the intercept row.
+  arma::mat gram;
+
+  //! The weighted sum of x y over the data seen, with the intercept row.
+  arma::vec moment;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+//! Set the serialization version of the LinearRegression class.
+BOOST_CLASS_VERSION(mlpack::regression::LinearRegression, 1);
+
 #endif // MLPACK_METHODS_LINEAR_REGRESSION_HPP
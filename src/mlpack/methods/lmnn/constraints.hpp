@@ -199,6 +199,20 @@ class Constraints
   //! False if nothing has ever been precalculated.
   bool precalculated;
 
+  /**
+   * Get the search mode for the KNN searches: with OpenMP, each search is
+   * split into blocks of query points that are searched in parallel against
+   * the reference tree.
+   */
+  static neighbor::NeighborSearchMode SearchMode()
+  {
+    #ifdef HAS_OPENMP
+      return neighbor::PARALLEL_DUAL_TREE_MODE;
+    #else
+      return neighbor::DUAL_TREE_MODE;
+    #endif
+  }
+
   /**
   * Precalculate the unique labels, and indices of similar
   * and different datapoints on the basis of labels.
@@ -88,7 +88,7 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
   Precalculate(labels);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -130,7 +130,7 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -143,6 +143,10 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
     // Calculate Target Neighbors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
+    // Don't build a tree for a class without points in the batch.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with same class points as both reference
     // set and query set.
     knn.Train(dataset.cols(indexSame[i]));
@@ -172,7 +176,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   Precalculate(labels);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -210,7 +214,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   Precalculate(labels);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -253,7 +257,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -266,6 +270,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
+    // Don't build a tree for a class without points in the batch.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
@@ -302,7 +310,7 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -315,6 +323,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
 
+    // Don't build a tree for a class without points in the batch.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
@@ -345,11 +357,16 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::uvec& points,
                                         const size_t numPoints)
 {
+  // If the impostors of every point are known to be unchanged, there is
+  // nothing to do.
+  if (numPoints == 0)
+    return;
+
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
   // KNN instance.
-  KNN knn;
+  KNN knn(SearchMode());
 
   arma::Mat<size_t> neighbors;
   arma::mat distances;
@@ -363,6 +380,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
     subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
         uniqueLabels[i]);
 
+    // Don't build a tree for a class without points to recompute.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
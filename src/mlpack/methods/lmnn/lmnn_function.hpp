@@ -251,6 +251,34 @@ class LMNNFunction
                         const arma::mat& transformation,
                         const size_t begin,
                         const size_t batchSize);
+
+  //! Number of consecutive points each thread computes the triplets of at a
+  //! time.
+  static const size_t PointGrain = 16;
+  //! Number of points whose differences are multiplied at once by
+  //! OuterProducts().
+  static const size_t BlockSize = 256;
+
+  /**
+   * Compute the weighted sum of the outer products (x_i - x_j)(x_i - x_j)^T of
+   * the differences between each point i of a batch and each of its target
+   * neighbors j, minus that of the differences between the points and their
+   * impostors.  The differences of each block of points are gathered into a
+   * matrix, whose columns are scaled by their weights, so that each block is a
+   * single matrix product; the blocks are split between the threads, which
+   * each sum into their own matrix.
+   *
+   * @param begin Index of the first point of the batch.
+   * @param targetWeights Weight of each target neighbor of each point, with
+   *     one column for each point of the batch.
+   * @param impostorWeights Weight of each impostor of each point, with one
+   *     column for each point of the batch.
+   * @param outerProducts Matrix to store the sum in.
+   */
+  inline void OuterProducts(const size_t begin,
+                            const arma::mat& targetWeights,
+                            const arma::mat& impostorWeights,
+                            arma::mat& outerProducts) const;
 };
 
 } // namespace lmnn
@@ -15,6 +15,7 @@
 #include "lmnn_function.hpp"
 
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/util/parallel.hpp>
 
 namespace mlpack {
 namespace lmnn {
@@ -514,13 +515,14 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
 
   gradient.zeros(transformation.n_rows, transformation.n_cols);
 
-  // Calculate gradient due to target neighbors.
-  arma::mat cij = pCij;
-
-  // Calculate gradient due to impostors.
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // The weight of the difference to each target neighbor and each impostor of
+  // each point in the gradient due to impostors, from the active triplets.
+  arma::mat targetWeights(k, dataset.n_cols, arma::fill::zeros);
+  arma::mat impostorWeights(k, dataset.n_cols, arma::fill::zeros);
 
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  // Each point only updates its own cache entries and weights, so the points
+  // are split between the threads.
+  ParallelFor(0, dataset.n_cols, [&](const size_t i)
   {
     for (int j = k - 1; j >= 0; j--)
     {
@@ -579,18 +581,19 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           maxImpNorm(l, i) = 0;
         }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Weight the differences of the triplet in the gradient due to
+        // impostors.
+        targetWeights(j, i) += regularization;
+        impostorWeights(l, i) += regularization;
       }
     }
-  }
+  }, PointGrain);
+
+  // Calculate gradient due to impostors.
+  arma::mat cil;
+  OuterProducts(0, targetWeights, impostorWeights, cil);
 
-  gradient = 2 * transformation * ((1 - regularization) * cij +
-      regularization * cil);
+  gradient = 2 * transformation * ((1 - regularization) * pCij + cil);
 
   // Update cache transformation matrix.
   transformationOld = transformation;
@@ -646,17 +649,32 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
 
   gradient.zeros(transformation.n_rows, transformation.n_cols);
 
-  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
-
+  // The weight of the difference to each target neighbor and each impostor of
+  // each point in the gradient: the target neighbors have (1 - regularization)
+  // from the gradient due to target neighbors, and the active triplets add to
+  // both.
+  arma::mat targetWeights(k, batchSize);
+  targetWeights.fill(1 - regularization);
+  arma::mat impostorWeights(k, batchSize, arma::fill::zeros);
+
+  // The cached transformation each point stops using; the counts of the cache
+  // are shared between the points, so they are updated after the loop.
+  arma::vec resetIndices(batchSize, arma::fill::zeros);
+
+  // The change in transformation for each point, looked up before the points
+  // are split between the threads.
+  arma::vec pointDiffs(batchSize, arma::fill::zeros);
   for (size_t i = begin; i < begin + batchSize; i++)
   {
-    for (size_t j = 0; j < k ; j++)
-    {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
-    }
+    if (lastTransformationIndices(i))
+      pointDiffs[i - begin] = transformationDiffs[lastTransformationIndices[i]];
+  }
+
+  // Each point only updates its own cache entries and weights, so the points
+  // are split between the threads.
+  ParallelFor(begin, begin + batchSize, [&](const size_t i)
+  {
+    const size_t p = i - begin;
 
     for (int j = k - 1; j >= 0; j--)
     {
@@ -673,8 +691,7 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           // Update cache max impostor norm.
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+          eval = evalOld(l, j, i) + pointDiffs[p] *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -713,22 +730,28 @@ void LMNNFunction<MetricType>::Gradient(const arma::mat& transformation,
           // update bound.
           evalOld(l, j, i) = 0;
           maxImpNorm(l, i) = 0;
-          --oldTransformationCounts[lastTransformationIndices(i)];
+          resetIndices[p] = lastTransformationIndices(i);
           lastTransformationIndices(i) = 0;
         }
 
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
-
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Weight the differences of the triplet in the gradient due to
+        // impostors.
+        targetWeights(j, p) += regularization;
+        impostorWeights(l, p) += regularization;
       }
     }
+  }, PointGrain);
+
+  for (size_t p = 0; p < batchSize; ++p)
+  {
+    if (resetIndices[p])
+      --oldTransformationCounts[(size_t) resetIndices[p]];
   }
 
-  gradient = 2 * transformation * ((1 - regularization) * cij +
-      regularization * cil);
+  arma::mat outerProducts;
+  OuterProducts(begin, targetWeights, impostorWeights, outerProducts);
+
+  gradient = 2 * transformation * outerProducts;
 
   // Update cache.
   UpdateCache(transformation, begin, batchSize);
@@ -789,20 +812,24 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 
   gradient.zeros(transformation.n_rows, transformation.n_cols);
 
-  // Calculate gradient due to target neighbors.
-  arma::mat cij = pCij;
+  // The weight of the difference to each target neighbor and each impostor of
+  // each point in the gradient due to impostors, from the active triplets.
+  arma::mat targetWeights(k, dataset.n_cols, arma::fill::zeros);
+  arma::mat impostorWeights(k, dataset.n_cols, arma::fill::zeros);
 
-  // Calculate gradient due to impostors.
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // The cost of each point.
+  arma::vec costs(dataset.n_cols, arma::fill::zeros);
 
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  // Each point only updates its own cache entries and weights, so the points
+  // are split between the threads.
+  ParallelFor(0, dataset.n_cols, [&](const size_t i)
   {
     for (size_t j = 0; j < k ; j++)
     {
       // Calculate cost due to distance between target neighbors & data point.
       double eval = metric.Evaluate(transformedDataset.col(i),
                         transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
+      costs[i] += (1 - regularization) * eval;
     }
 
     for (int j = k - 1; j >= 0; j--)
@@ -854,20 +881,22 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
           break;
         }
 
-        cost += regularization * (1 + eval);
-
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+        costs[i] += regularization * (1 + eval);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Weight the differences of the triplet in the gradient due to
+        // impostors.
+        targetWeights(j, i) += regularization;
+        impostorWeights(l, i) += regularization;
       }
     }
-  }
+  }, PointGrain);
+  cost = arma::accu(costs);
 
-  gradient = 2 * transformation * ((1 - regularization) * cij +
-      regularization * cil);
+  // Calculate gradient due to impostors.
+  arma::mat cil;
+  OuterProducts(0, targetWeights, impostorWeights, cil);
+
+  gradient = 2 * transformation * ((1 - regularization) * pCij + cil);
 
   // Update cache transformation matrix.
   transformationOld = transformation;
@@ -928,21 +957,38 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 
   gradient.zeros(transformation.n_rows, transformation.n_cols);
 
-  arma::mat cij = arma::zeros(dataset.n_rows, dataset.n_rows);
-  arma::mat cil = arma::zeros(dataset.n_rows, dataset.n_rows);
+  // The weight of the difference to each target neighbor and each impostor of
+  // each point in the gradient: the target neighbors have (1 - regularization)
+  // from the gradient due to target neighbors, and the active triplets add to
+  // both.
+  arma::mat targetWeights(k, batchSize);
+  targetWeights.fill(1 - regularization);
+  arma::mat impostorWeights(k, batchSize, arma::fill::zeros);
 
+  // The cost of each point.
+  arma::vec costs(batchSize, arma::fill::zeros);
+
+  // The change in transformation for each point, looked up before the points
+  // are split between the threads.
+  arma::vec pointDiffs(batchSize, arma::fill::zeros);
   for (size_t i = begin; i < begin + batchSize; i++)
   {
+    if (lastTransformationIndices(i))
+      pointDiffs[i - begin] = transformationDiffs[lastTransformationIndices[i]];
+  }
+
+  // Each point only updates its own cache entries and weights, so the points
+  // are split between the threads.
+  ParallelFor(begin, begin + batchSize, [&](const size_t i)
+  {
+    const size_t p = i - begin;
+
     for (size_t j = 0; j < k ; j++)
     {
       // Calculate cost due to distance between target neighbors & data point.
       double eval = metric.Evaluate(transformedDataset.col(i),
                         transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      cij += diff * arma::trans(diff);
+      costs[p] += (1 - regularization) * eval;
     }
 
     for (int j = k - 1; j >= 0; j--)
@@ -960,8 +1006,7 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
           // Update cache max impostor norm.
           maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
 
-          eval = evalOld(l, j, i) +
-              transformationDiffs[lastTransformationIndices[i]] *
+          eval = evalOld(l, j, i) + pointDiffs[p] *
               (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) + 2 * norm(i));
         }
 
@@ -994,20 +1039,21 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
           break;
         }
 
-        cost += regularization * (1 + eval);
-
-        // Caculate gradient due to impostors.
-        arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * arma::trans(diff);
+        costs[p] += regularization * (1 + eval);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * arma::trans(diff);
+        // Weight the differences of the triplet in the gradient due to
+        // impostors.
+        targetWeights(j, p) += regularization;
+        impostorWeights(l, p) += regularization;
       }
     }
-  }
+  }, PointGrain);
+  cost = arma::accu(costs);
+
+  arma::mat outerProducts;
+  OuterProducts(begin, targetWeights, impostorWeights, outerProducts);
 
-  gradient = 2 * transformation * ((1 - regularization) * cij +
-      regularization * cil);
+  gradient = 2 * transformation * outerProducts;
 
   // Update cache.
   UpdateCache(transformation, begin, batchSize);
@@ -1016,19 +1062,74 @@ double LMNNFunction<MetricType>::EvaluateWithGradient(
 }
 
 template<typename MetricType>
-inline void LMNNFunction<MetricType>::Precalculate()
+inline void LMNNFunction<MetricType>::OuterProducts(
+                                          const size_t begin,
+                                          const arma::mat& targetWeights,
+                                          const arma::mat& impostorWeights,
+                                          arma::mat& outerProducts) const
 {
-  pCij.zeros(dataset.n_rows, dataset.n_rows);
+  const size_t batchSize = targetWeights.n_cols;
+  const size_t numBlocks = (batchSize + BlockSize - 1) / BlockSize;
+  const size_t threads = (numBlocks > 1) ? 0 : 1;
 
-  for (size_t i = 0; i < dataset.n_cols; i++)
+  std::vector<arma::mat> threadProducts(ParallelForThreads(threads));
+  for (size_t t = 0; t < threadProducts.size(); ++t)
+    threadProducts[t].zeros(dataset.n_rows, dataset.n_rows);
+
+  ParallelFor(0, numBlocks, [&](const size_t block)
   {
-    for (size_t j = 0; j < k ; j++)
+    const size_t first = block * BlockSize;
+    const size_t last = std::min(first + BlockSize, batchSize);
+
+    // Gather the differences of the block that have a nonzero weight (most
+    // impostors are usually in no active triplet), and their weights.
+    arma::mat differences(dataset.n_rows, 2 * k * (last - first));
+    arma::rowvec weights(differences.n_cols);
+    size_t columns = 0;
+    for (size_t p = first; p < last; ++p)
     {
-      // Calculate gradient due to target neighbors.
-      arma::vec diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-      pCij += diff * arma::trans(diff);
+      const size_t i = begin + p;
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (targetWeights(j, p) != 0.0)
+        {
+          differences.col(columns) = dataset.col(i) -
+              dataset.col(targetNeighbors(j, i));
+          weights[columns++] = targetWeights(j, p);
+        }
+
+        if (impostorWeights(j, p) != 0.0)
+        {
+          differences.col(columns) = dataset.col(i) -
+              dataset.col(impostors(j, i));
+          weights[columns++] = -impostorWeights(j, p);
+        }
+      }
     }
-  }
+
+    if (columns == 0)
+      return;
+
+    // A single product gives the weighted sum of the outer products of the
+    // differences.
+    arma::mat weightedDifferences = differences.cols(0, columns - 1);
+    weightedDifferences.each_row() %= weights.subvec(0, columns - 1);
+    threadProducts[ThreadId()] += weightedDifferences *
+        differences.cols(0, columns - 1).t();
+  }, 1, threads);
+
+  outerProducts = std::move(threadProducts[0]);
+  for (size_t t = 1; t < threadProducts.size(); ++t)
+    outerProducts += threadProducts[t];
+}
+
+template<typename MetricType>
+inline void LMNNFunction<MetricType>::Precalculate()
+{
+  // Calculate gradient due to target neighbors.
+  const arma::mat targetWeights(k, dataset.n_cols, arma::fill::ones);
+  const arma::mat impostorWeights(k, dataset.n_cols, arma::fill::zeros);
+  OuterProducts(0, targetWeights, impostorWeights, pCij);
 }
 
 } // namespace lmnn
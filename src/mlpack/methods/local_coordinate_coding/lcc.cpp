@@ -30,35 +30,32 @@ LocalCoordinateCoding::LocalCoordinateCoding(
 
 void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
 {
-  arma::mat invSqDists = 1.0 / (repmat(trans(sum(square(dictionary))), 1,
-      data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
-      * data);
-
+  // The data for the LARS problem of point i is dictionary * diagmat(invW),
+  // where invW holds its inverse squared distances to the atoms; its Gram
+  // matrix and correlations with the point are cheap to get from those of the
+  // dictionary, so the data never needs to be formed.
   arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
-
-  codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; i++)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
+  arma::vec dictSqNorms = trans(sum(square(dictionary)));
 
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
+  // Compute the correlations of all the points with the atoms with one
+  // product, directly into the codes; each is replaced by the code of its point.
+  codes = trans(dictionary) * data;
 
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; i++)
+  {
+    // Make an alias of the code of the point, which holds its correlations
+    // with the atoms until LARS places the code there.  The squared distances
+    // of the point to the atoms follow from those correlations.
+    arma::vec beta = codes.unsafe_col(i);
+    arma::vec invW = 1.0 / (dictSqNorms + arma::dot(data.col(i),
+        data.col(i)) - 2 * beta);
+    arma::vec correlations = invW % beta;
+    arma::mat dictGramTD = dictGram % (invW * trans(invW));
 
     bool useCholesky = false;
     regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
-
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
+    lars.TrainCovariance(correlations, beta);
     beta %= invW; // Remember, beta is an alias of codes.col(i).
   }
 }
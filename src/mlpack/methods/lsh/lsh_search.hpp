@@ -44,6 +44,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_LSH_SEARCH_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
 
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
@@ -188,6 +189,30 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Insert the given points into the reference set and the hash tables,
+   * without rebuilding the hash tables.  The new points are given the indices
+   * following the existing points of the reference set, in order.  As in
+   * Train(), a point is not added to a bucket of the second hash table that
+   * already holds bucketSize points.  The contiguous bucket arrays are rebuilt
+   * in time linear in their size, so points are best inserted in batches.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const arma::mat& newPoints);
+
+  /**
+   * Remove the points with the given indices from the reference set and the
+   * hash tables, without rebuilding the hash tables.  The remaining points keep
+   * their relative order but are renumbered to be contiguous, so the point
+   * that had index i now has index i minus the number of removed points with
+   * an index smaller than i.  Removing points does not put points that were
+   * dropped from full buckets back into those buckets.
+   *
+   * @param indices Indices of the points to remove.
+   */
+  void Remove(const arma::uvec& indices);
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -280,9 +305,17 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the number of rows of the second hash table (one per non-empty
+  //! bucket).
+  size_t NumBuckets() const
+  { return bucketOffsets.is_empty() ? 0 : bucketOffsets.n_elem - 1; }
+
+  //! Get the points of the given row of the second hash table.
+  arma::Col<size_t> Bucket(const size_t row) const;
+
+  //! Get the offset of each row of the second hash table in the contiguous
+  //! array of points, and the total number of points as the last element.
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -297,25 +330,130 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Scratch space used by ReturnIndicesFromTable().  Each thread holds its own
+   * scratch space, which is reused for every query the thread processes, so
+   * that no memory needs to be allocated per query.
+   */
+  struct CandidateScratch
+  {
+    CandidateScratch() : stamp(0) { }
+
+    //! For each reference point, the stamp of the last query that found it.
+    arma::Col<size_t> lastSeen;
+    //! The stamp of the current query.
+    size_t stamp;
+    //! The candidates found for the current query.
+    arma::uvec candidates;
+  };
+
+  /**
+   * Compute the (unfloored) projections of a set of queries in each of the
+   * first 'numTablesToSearch' tables, including the offsets.  Column i of the
+   * output holds, for query i, a numProj x numTablesToSearch matrix in
+   * column-major order.  All of the tables are handled by a single matrix
+   * multiplication.
    *
-   * @param queryPoint The query point currently being processed.
-   * @param referenceIndices The list of neighbor candidates obtained from
-   *    hashing the query into all the hash tables and eventually into
-   *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
+   * @param queries Set of query points.
+   * @param numTablesToSearch The number of tables to hash the queries into.
+   * @param codes Output matrix of projections.
+   */
+  void ProjectQueries(const arma::mat& queries,
+                      const size_t numTablesToSearch,
+                      arma::mat& codes) const;
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * to get keys for the query and then the key is hashed to a bucket of the
+   * second hash table and all the points (if any) in those buckets are
+   * collected as the potential neighbor candidates.  The candidates are stored,
+   * sorted, in the first elements of scratch.candidates.
+   *
+   * @param queryCodesNotFloored The projection of the query in each table, as
+   *    computed by ProjectQueries().
+   * @param numTablesToSearch The number of tables to perform the search in.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
+   * @param scratch Scratch space of the calling thread.
+   * @return The number of neighbor candidates found.
+   */
+  size_t ReturnIndicesFromTable(const arma::mat& queryCodesNotFloored,
+                                const size_t numTablesToSearch,
+                                const size_t T,
+                                CandidateScratch& scratch) const;
+
+  /**
+   * Search for the neighbors of each point in the query set, processing the
+   * queries in blocks that are hashed together and spread across threads.
+   *
+   * @param querySet Set of query points.
+   * @param sameSet If true, the query set is the reference set.
+   * @param k Number of neighbors to search for.
+   * @param resultingNeighbors Matrix storing lists of neighbors for each query
+   *     point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param numTablesToSearch The number of tables to perform the search in. If
+   *    0, all tables are searched.
+   * @param T The number of additional probing bins for multiprobe LSH.
+   */
+  void SearchBlocks(const arma::mat& querySet,
+                    const bool sameSet,
+                    const size_t k,
+                    arma::Mat<size_t>& resultingNeighbors,
+                    arma::mat& distances,
+                    size_t numTablesToSearch,
+                    const size_t T);
+
+  /**
+   * Compute the bucket of the second hash table of each of the given points,
+   * in each of the tables.
+   *
+   * @param points Set of points to hash.
+   * @param secondHashVectors Output matrix; element (i, j) holds the bucket of
+   *    point j in table i.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
-                              arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
-                              const size_t T) const;
+  void ComputeSecondHashVectors(const arma::mat& points,
+                                arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * Add the given points (with indices firstIndex, firstIndex + 1, ...) to the
+   * second hash table, given the bucket of each point in each table.  The rows
+   * are counted in a first pass, and the contiguous array of points is then
+   * filled in a second pass, so that each point is stored once.
+   *
+   * @param secondHashVectors Element (i, j) holds the bucket of point j in
+   *    table i (see ComputeSecondHashVectors()).
+   * @param firstIndex Index of the first point.
+   */
+  void AddToBuckets(const arma::Mat<size_t>& secondHashVectors,
+                    const size_t firstIndex);
+
+  /**
+   * Fill the given contiguous array of points with the points of the second
+   * hash table, followed by the given points, in the rows given by the new
+   * offsets.
+   */
+  template<typename IndexType>
+  void FillBuckets(const arma::Col<size_t>& newOffsets,
+                   const arma::Mat<size_t>& secondHashVectors,
+                   const size_t firstIndex,
+                   std::vector<IndexType>& points) const;
+
+  //! Return the point at the given position of the contiguous array of points
+  //! of the second hash table.
+  size_t BucketPoint(const size_t position) const
+  {
+    return wideBucketPoints.empty() ? (size_t) narrowBucketPoints[position] :
+        wideBucketPoints[position];
+  }
+
+  //! Add the given points of a bucket to the candidates of the current query,
+  //! unless they were already found.
+  template<typename IndexType>
+  static void AddCandidates(const IndexType* points,
+                            const size_t count,
+                            CandidateScratch& scratch,
+                            size_t& numCandidates);
 
   /**
    * This is a helper function that computes the distance of the query to the
@@ -440,15 +578,18 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
-
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
-
-  //! For a particular hash value, points to the row in secondHashTable
+  //! The final hash table is stored in compressed sparse row form: the points
+  //! of row r (at most bucketSize of them) are the elements bucketOffsets[r]
+  //! to bucketOffsets[r + 1] - 1 of a single array.  The array holds 32-bit
+  //! indices (narrowBucketPoints) if the reference set allows, and 64-bit
+  //! indices (wideBucketPoints) otherwise; the other array is empty.
+  arma::Col<size_t> bucketOffsets;
+  //! The points of all rows of the second hash table, as 32-bit indices.
+  std::vector<uint32_t> narrowBucketPoints;
+  //! The points of all rows of the second hash table, as 64-bit indices.
+  std::vector<size_t> wideBucketPoints;
+
+  //! For a particular hash value, points to the row in the second hash table
   //! corresponding to this value. Length secondHashSize.
   arma::Col<size_t> bucketRowInHashTable;
 
@@ -476,7 +617,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
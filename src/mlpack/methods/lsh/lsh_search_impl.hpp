@@ -83,8 +83,9 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    narrowBucketPoints(other.narrowBucketPoints),
+    wideBucketPoints(other.wideBucketPoints),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -103,8 +104,9 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    narrowBucketPoints(std::move(other.narrowBucketPoints)),
+    wideBucketPoints(std::move(other.wideBucketPoints)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -130,8 +132,9 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  narrowBucketPoints = other.narrowBucketPoints;
+  wideBucketPoints = other.wideBucketPoints;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -151,8 +154,9 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  narrowBucketPoints = std::move(other.narrowBucketPoints);
+  wideBucketPoints = std::move(other.wideBucketPoints);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -252,9 +256,33 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
   }
 
   // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // vector for table i will be held in row i.
+  arma::Mat<size_t> secondHashVectors;
+  ComputeSecondHashVectors(this->referenceSet, secondHashVectors);
+
+  // Start from an empty second hash table, and put each point in the bucket
+  // of each table.
+  bucketOffsets.zeros(1);
+  narrowBucketPoints.clear();
+  wideBucketPoints.clear();
+  AddToBuckets(secondHashVectors, 0);
+
+  const size_t numRowsInTable = NumBuckets();
+  const size_t maxRowSize = (numRowsInTable == 0) ? 0 : arma::max(
+      bucketOffsets.tail(numRowsInTable) - bucketOffsets.head(numRowsInTable));
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << maxRowSize << ", "
+            << "totaling " << bucketOffsets[numRowsInTable] << " elements."
+            << std::endl;
+}
+
+// Compute the second-level hash codes of a set of points.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::ComputeSecondHashVectors(
+    const arma::mat& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
+  secondHashVectors.set_size(numTables, points.n_cols);
 
   for (size_t i = 0; i < numTables; i++)
   {
@@ -263,15 +291,14 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
+    arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1, points.n_cols);
+    arma::mat hashMat = projections.slice(i).t() * points;
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
@@ -295,56 +322,217 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
       }
     }
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
-
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
-
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+// Add points to the second hash table.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::AddToBuckets(
+    const arma::Mat<size_t>& secondHashVectors,
+    const size_t firstIndex)
+{
+  // First pass: give a row to each bucket that has none yet, and count the
+  // points that each row will hold, up to the maximum bucket size.
+  const size_t maxSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  size_t numRows = NumBuckets();
+  std::vector<size_t> rowSizes(numRows);
+  for (size_t row = 0; row < numRows; ++row)
+    rowSizes[row] = bucketOffsets[row + 1] - bucketOffsets[row];
+
+  for (size_t i = 0; i < secondHashVectors.n_rows; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
+      const size_t hashInd = secondHashVectors(i, j);
       if (bucketRowInHashTable[hashInd] == secondHashSize)
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        bucketRowInHashTable[hashInd] = numRows++;
+        rowSizes.push_back(0);
       }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+      const size_t row = bucketRowInHashTable[hashInd];
+      if (rowSizes[row] < maxSize)
+        ++rowSizes[row];
+    }
+  }
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  arma::Col<size_t> newOffsets(numRows + 1);
+  newOffsets[0] = 0;
+  for (size_t row = 0; row < numRows; ++row)
+    newOffsets[row + 1] = newOffsets[row] + rowSizes[row];
+
+  // Second pass: fill the rows.  The indices are stored with 32 bits unless
+  // the reference set is too large for that.
+  if (referenceSet.n_cols <= (size_t) std::numeric_limits<uint32_t>::max())
+  {
+    FillBuckets(newOffsets, secondHashVectors, firstIndex, narrowBucketPoints);
+  }
+  else
+  {
+    FillBuckets(newOffsets, secondHashVectors, firstIndex, wideBucketPoints);
+    std::vector<uint32_t>().swap(narrowBucketPoints);
+  }
+
+  bucketOffsets = std::move(newOffsets);
+}
+
+template<typename SortPolicy>
+template<typename IndexType>
+void LSHSearch<SortPolicy>::FillBuckets(
+    const arma::Col<size_t>& newOffsets,
+    const arma::Mat<size_t>& secondHashVectors,
+    const size_t firstIndex,
+    std::vector<IndexType>& points) const
+{
+  std::vector<IndexType> newPoints(newOffsets[newOffsets.n_elem - 1]);
+  std::vector<size_t> positions(newOffsets.begin(), newOffsets.end() - 1);
+
+  // The points already in the table come first in each row.
+  const size_t numRows = NumBuckets();
+  for (size_t row = 0; row < numRows; ++row)
+    for (size_t p = bucketOffsets[row]; p < bucketOffsets[row + 1]; ++p)
+      newPoints[positions[row]++] = (IndexType) BucketPoint(p);
+
+  // Points that overflow a full row are dropped.
+  for (size_t i = 0; i < secondHashVectors.n_rows; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (positions[row] < newOffsets[row + 1])
+        newPoints[positions[row]++] = (IndexType) (firstIndex + j);
+    }
+  }
+
+  points.swap(newPoints);
+}
+
+// Insert new points into the hash tables.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Insert(const arma::mat& newPoints)
+{
+  if (newPoints.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t firstIndex = referenceSet.n_cols;
+  referenceSet.insert_cols(firstIndex, newPoints);
+
+  arma::Mat<size_t> secondHashVectors;
+  ComputeSecondHashVectors(newPoints, secondHashVectors);
+
+  // Add the points in the same order that Train() would.
+  AddToBuckets(secondHashVectors, firstIndex);
+}
+
+// Remove points from the hash tables.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Remove(const arma::uvec& indices)
+{
+  // Map the old index of each point to its new index; removed points map to
+  // referenceSet.n_cols.
+  const size_t oldNumPoints = referenceSet.n_cols;
+  arma::Col<size_t> newFromOld(oldNumPoints);
+  newFromOld.zeros();
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= oldNumPoints)
+    {
+      std::ostringstream oss;
+      oss << "LSHSearch::Remove(): index " << indices[i] << " is out of range; "
+          << "the reference set has " << oldNumPoints << " points!"
+          << std::endl;
+      throw std::invalid_argument(oss.str());
+    }
+
+    newFromOld[indices[i]] = oldNumPoints;
+  }
+
+  size_t numKept = 0;
+  for (size_t i = 0; i < oldNumPoints; ++i)
+    if (newFromOld[i] != oldNumPoints)
+      newFromOld[i] = numKept++;
+
+  if (numKept == oldNumPoints)
+    return;
+
+  // Shift the kept points to the front of the reference set, in order.
+  for (size_t i = 0; i < oldNumPoints; ++i)
+    if (newFromOld[i] != oldNumPoints && newFromOld[i] != i)
+      referenceSet.col(newFromOld[i]) = referenceSet.col(i);
+  referenceSet.resize(referenceSet.n_rows, numKept);
+
+  // Compact the rows in place.  Rows that become empty are kept, so that the
+  // mapping from buckets to rows stays valid and the rows can be reused by
+  // Insert().
+  const size_t numRows = NumBuckets();
+  size_t position = 0;
+  for (size_t row = 0; row < numRows; ++row)
+  {
+    const size_t begin = bucketOffsets[row];
+    const size_t end = bucketOffsets[row + 1];
+    bucketOffsets[row] = position;
+    for (size_t p = begin; p < end; ++p)
+    {
+      const size_t newIndex = newFromOld[BucketPoint(p)];
+      if (newIndex == oldNumPoints)
+        continue;
+
+      if (wideBucketPoints.empty())
+        narrowBucketPoints[position++] = (uint32_t) newIndex;
+      else
+        wideBucketPoints[position++] = newIndex;
+    }
+  }
+  bucketOffsets[numRows] = position;
+
+  if (wideBucketPoints.empty())
+    narrowBucketPoints.resize(position);
+  else
+    wideBucketPoints.resize(position);
+}
+
+// Get the points of a row of the second hash table.
+template<typename SortPolicy>
+arma::Col<size_t> LSHSearch<SortPolicy>::Bucket(const size_t row) const
+{
+  if (row >= NumBuckets())
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Bucket(): row " << row << " is out of range; the second "
+        << "hash table has " << NumBuckets() << " rows!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::Col<size_t> points(bucketOffsets[row + 1] - bucketOffsets[row]);
+  for (size_t p = 0; p < points.n_elem; ++p)
+    points[p] = BucketPoint(bucketOffsets[row] + p);
+
+  return points;
+}
+
+// Add the points of a bucket to the candidates of a query.
+template<typename SortPolicy>
+template<typename IndexType>
+inline force_inline
+void LSHSearch<SortPolicy>::AddCandidates(const IndexType* points,
+                                          const size_t count,
+                                          CandidateScratch& scratch,
+                                          size_t& numCandidates)
+{
+  for (size_t j = 0; j < count; ++j)
+  {
+    const size_t index = points[j];
+    if (scratch.lastSeen[index] != scratch.stamp)
+    {
+      scratch.lastSeen[index] = scratch.stamp;
+      scratch.candidates[numCandidates++] = index;
+    }
+  }
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -697,35 +885,37 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
 }
 
 template<typename SortPolicy>
-template<typename VecType>
-void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
-    arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
-    const size_t T) const
+void LSHSearch<SortPolicy>::ProjectQueries(const arma::mat& queries,
+                                           const size_t numTablesToSearch,
+                                           arma::mat& codes) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
+  // The slices of the projections cube are stored contiguously, so the first
+  // 'numTablesToSearch' slices can be viewed as one dims x (numProj *
+  // numTablesToSearch) matrix, and all the tables can be hashed with a single
+  // matrix multiplication.
+  const arma::mat allProjections(const_cast<double*>(projections.memptr()),
+      projections.n_rows, numProj * numTablesToSearch, false, true);
+  codes = allProjections.t() * queries;
+
+  // The offsets are laid out the same way.
+  const arma::vec allOffsets(const_cast<double*>(offsets.memptr()),
+      numProj * numTablesToSearch, false, true);
+  codes.each_col() += allOffsets;
+}
 
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
+template<typename SortPolicy>
+size_t LSHSearch<SortPolicy>::ReturnIndicesFromTable(
+    const arma::mat& queryCodesNotFloored,
+    const size_t numTablesToSearch,
+    const size_t T,
+    CandidateScratch& scratch) const
+{
+  // The projection of the query in each table has already been computed, so
+  // we start by finding the key of the query in each of the
+  // 'numTablesToSearch' tables; each key is a 'numProj' dimensional integer
   // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
-
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
+  const arma::mat allProjInTables = arma::floor(queryCodesNotFloored /
+      hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
@@ -747,8 +937,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     {
       // Construct this table's probing sequence of length T.
       arma::mat additionalProbingBins;
-      GetAdditionalProbingBins(allProjInTables.unsafe_col(i),
-                                queryCodesNotFloored.unsafe_col(i),
+      GetAdditionalProbingBins(allProjInTables.col(i),
+                                queryCodesNotFloored.col(i),
                                 T,
                                 additionalProbingBins);
 
@@ -762,90 +952,135 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     }
   }
 
-  // Count number of points hashed in the same bucket as the query.
-  size_t maxNumPoints = 0;
-  for (size_t i = 0; i < numTablesToSearch; ++i)
+  // Make sure the scratch space is ready for use.  This only allocates memory
+  // the first time a thread uses the scratch space.
+  if (scratch.lastSeen.n_elem != referenceSet.n_cols)
   {
-    for (size_t p = 0; p < T + 1; ++p)
-    {
-      const size_t hashInd = hashMat(p, i); // find query's bucket
-      const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
-    }
+    scratch.lastSeen.zeros(referenceSet.n_cols);
+    scratch.candidates.set_size(referenceSet.n_cols);
+    scratch.stamp = 0;
   }
+  ++scratch.stamp;
 
-  // There are two ways to proceed here:
-  // Either allocate a maxNumPoints-size vector, place all candidates, and run
-  // unique on the vector to discard duplicates.
-  // Or allocate a referenceSet.n_cols size vector (i.e. number of reference
-  // points) of zeros, and mark found indices as 1.
-  // Option 1 runs faster for small maxNumPoints but worse for larger values, so
-  // we choose based on a heuristic.
-  const float cutoff = 0.1;
-  const float selectivity = static_cast<float>(maxNumPoints) /
-      static_cast<float>(referenceSet.n_cols);
-
-  if (selectivity > cutoff)
+  // Collect every reference point found in any of the query's buckets.  A
+  // reference point is only added the first time it is seen for this query;
+  // after that, its entry in lastSeen holds the current stamp.
+  size_t numCandidates = 0;
+  for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables.
   {
-    // Heuristic: larger maxNumPoints means we should use find() because it
-    // should be faster.
-    // Reference points hashed in the same bucket as the query are set to >0.
-    arma::Col<size_t> refPointsConsidered;
-    refPointsConsidered.zeros(referenceSet.n_cols);
-
-    for (size_t i = 0; i < numTablesToSearch; ++i) // for all tables
+    for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
     {
-      for (size_t p = 0; p < T + 1; ++p) // For entire probing sequence.
-      {
-        // get the sequence code
-        size_t hashInd = hashMat(p, i);
-        size_t tableRow = bucketRowInHashTable[hashInd];
+      const size_t hashInd = hashMat(p, i); // Find the query's bucket.
+      const size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+      if (tableRow < secondHashSize)
+      {
+        const size_t begin = bucketOffsets[tableRow];
+        const size_t count = bucketOffsets[tableRow + 1] - begin;
+        if (wideBucketPoints.empty())
+        {
+          AddCandidates(narrowBucketPoints.data() + begin, count, scratch,
+              numCandidates);
+        }
+        else
         {
-          // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          AddCandidates(wideBucketPoints.data() + begin, count, scratch,
+              numCandidates);
         }
       }
     }
-
-    // Only keep reference points found in at least one bucket.
-    referenceIndices = arma::find(refPointsConsidered > 0);
-    return;
   }
-  else
+
+  // Return the candidates in increasing order of index, so that ties between
+  // candidates are resolved the same way regardless of bucket order.
+  std::sort(scratch.candidates.begin(),
+      scratch.candidates.begin() + numCandidates);
+
+  return numCandidates;
+}
+
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::SearchBlocks(const arma::mat& querySet,
+                                         const bool sameSet,
+                                         const size_t k,
+                                         arma::Mat<size_t>& resultingNeighbors,
+                                         arma::mat& distances,
+                                         size_t numTablesToSearch,
+                                         const size_t T)
+{
+  // Decide on the number of tables to look into.
+  if (numTablesToSearch == 0) // If no user input is given, search all.
+    numTablesToSearch = numTables;
+
+  // Sanity check to make sure that the existing number of tables is not
+  // exceeded.
+  if (numTablesToSearch > numTables)
+    numTablesToSearch = numTables;
+
+  // Queries are hashed in blocks, sized so that a block of queries and its
+  // codes fit in roughly 256kB.
+  const size_t blockSize = std::max((size_t) 1, (size_t) 32768 /
+      (querySet.n_rows + numProj * numTablesToSearch));
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  size_t avgIndicesReturned = 0;
+
+  Timer::Start("computing_neighbors");
+
+  // Parallelization to process more than one block of queries at a time.  Each
+  // thread reuses its own candidate buffers and projection codes, and counts
+  // its own candidates.
+  const size_t numThreads = ParallelForThreads();
+  std::vector<CandidateScratch> scratches(numThreads);
+  std::vector<arma::mat> codes(numThreads);
+  std::vector<size_t> indicesReturned(numThreads, 0);
+  ParallelFor(0, numBlocks, [&](const size_t b)
   {
-    // Heuristic: smaller maxNumPoints means we should use unique() because it
-    // should be faster.
-    // Allocate space for the query's potential neighbors.
-    arma::uvec refPointsConsideredSmall;
-    refPointsConsideredSmall.zeros(maxNumPoints);
+    const size_t threadId = ThreadId();
+    CandidateScratch& scratch = scratches[threadId];
+    arma::mat& blockCodes = codes[threadId];
 
-    // Retrieve candidates.
-    size_t start = 0;
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) querySet.n_cols, begin + blockSize);
 
-    for (size_t i = 0; i < numTablesToSearch; ++i) // For all tables
-    {
-      for (size_t p = 0; p < T + 1; ++p)
-      {
-        const size_t hashInd =  hashMat(p, i); // Find the query's bucket.
-        const size_t tableRow = bucketRowInHashTable[hashInd];
+    // Hash every query of the block into every hash table at once.
+    ProjectQueries(querySet.cols(begin, end - 1), numTablesToSearch,
+        blockCodes);
 
-        if (tableRow < secondHashSize)
-        {
-          // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
-       }
-      }
+    for (size_t i = begin; i < end; ++i)
+    {
+      // Hash the query into the 'secondHashTable' to obtain the neighbor
+      // candidates.
+      const arma::mat queryCodes(blockCodes.colptr(i - begin), numProj,
+          numTablesToSearch, false, true);
+      const size_t numCandidates = ReturnIndicesFromTable(queryCodes,
+          numTablesToSearch, T, scratch);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      indicesReturned[threadId] += numCandidates;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      const arma::uvec refIndices(scratch.candidates.memptr(), numCandidates,
+          false, true);
+      if (sameSet)
+        BaseCase(i, refIndices, k, resultingNeighbors, distances);
+      else
+        BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
     }
+  });
 
-    // Keep only one copy of each candidate.
-    referenceIndices = arma::unique(refPointsConsideredSmall);
-    return;
-  }
+  for (size_t t = 0; t < numThreads; ++t)
+    avgIndicesReturned += indicesReturned[t];
+
+  Timer::Stop("computing_neighbors");
+
+  distanceEvaluations += avgIndicesReturned;
+  if (querySet.n_cols > 0)
+    avgIndicesReturned /= querySet.n_cols;
+  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
+      std::endl;
 }
 
 // Search for nearest neighbors in a given query set.
@@ -900,41 +1135,8 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
-  size_t avgIndicesReturned = 0;
-
-  Timer::Start("computing_neighbors");
-
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
-  }
-
-  Timer::Stop("computing_neighbors");
-
-  distanceEvaluations += avgIndicesReturned;
-  avgIndicesReturned /= querySet.n_cols;
-  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
-      std::endl;
+  SearchBlocks(querySet, false, k, resultingNeighbors, distances,
+      numTablesToSearch, Teffective);
 }
 
 // Search for approximate neighbors of the reference set.
@@ -966,41 +1168,8 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
-  size_t avgIndicesReturned = 0;
-
-  Timer::Start("computing_neighbors");
-
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
-  {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
-  }
-
-  Timer::Stop("computing_neighbors");
-
-  distanceEvaluations += avgIndicesReturned;
-  avgIndicesReturned /= referenceSet.n_cols;
-  Log::Info << avgIndicesReturned << " distinct indices returned on average." <<
-      std::endl;
+  SearchBlocks(referenceSet, true, k, resultingNeighbors, distances,
+      numTablesToSearch, Teffective);
 }
 
 template<typename SortPolicy>
@@ -1066,73 +1235,108 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
   // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
+  // Backward compatibility: older versions of LSHSearch stored each row of the
+  // second hash table in its own column, with the number of points of each
+  // row.  These are loaded and then packed into contiguous rows.
+  if (version < 2)
   {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
 
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
-
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+    // Backward compatibility: in older versions of LSHSearch, the
+    // secondHashTable was stored as an arma::Mat<size_t>.  So we need to
+    // properly load that, then prune it down to size.
+    if (version == 0)
     {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet.n_cols is seen.
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
 
-      size_t len = 0;
-      for (; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
-          break;
+      // The old secondHashTable was stored in row-major format, so we transpose
+      // it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      secondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet.n_cols is seen.
+
+        size_t len = 0;
+        for (; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
+            break;
+
+        // Set the size of the new column correctly.
+        secondHashTable[i].set_size(len);
+        for (size_t j = 0; j < len; ++j)
+          secondHashTable[i](j) = tmpSecondHashTable(j, i);
+      }
     }
-  }
-  else
-  {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & BOOST_SERIALIZATION_NVP(tables);
-
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+    else
     {
-      secondHashTable.clear();
+      size_t tables;
+      ar & BOOST_SERIALIZATION_NVP(tables);
       secondHashTable.resize(tables);
+      ar & BOOST_SERIALIZATION_NVP(secondHashTable);
     }
 
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
-  }
+    // Backward compatibility: old versions of LSHSearch held bucketContentSize
+    // for all possible buckets (of size secondHashSize), but now we hold a
+    // compressed representation.
+    if (version == 0)
+    {
+      // The vector was stored in the old uncompressed form.  So we need to
+      // shrink it.  But we can't do that until we have bucketRowInHashTable, so
+      // we also have to load that.
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.set_size(secondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
+    {
+      ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    }
 
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
+    bucketOffsets.set_size(secondHashTable.size() + 1);
+    bucketOffsets[0] = 0;
+    for (size_t row = 0; row < secondHashTable.size(); ++row)
+      bucketOffsets[row + 1] = bucketOffsets[row] + bucketContentSize[row];
+
+    narrowBucketPoints.clear();
+    wideBucketPoints.clear();
+    if (referenceSet.n_cols <= (size_t) std::numeric_limits<uint32_t>::max())
+      narrowBucketPoints.resize(bucketOffsets[secondHashTable.size()]);
+    else
+      wideBucketPoints.resize(bucketOffsets[secondHashTable.size()]);
 
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    for (size_t row = 0; row < secondHashTable.size(); ++row)
+    {
+      for (size_t j = 0; j < bucketContentSize[row]; ++j)
+      {
+        if (wideBucketPoints.empty())
+        {
+          narrowBucketPoints[bucketOffsets[row] + j] =
+              (uint32_t) secondHashTable[row][j];
+        }
+        else
+        {
+          wideBucketPoints[bucketOffsets[row] + j] = secondHashTable[row][j];
+        }
+      }
+    }
   }
   else
   {
-    ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
+    ar & BOOST_SERIALIZATION_NVP(narrowBucketPoints);
+    ar & BOOST_SERIALIZATION_NVP(wideBucketPoints);
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
 
@@ -0,0 +1,228 @@
+/**
+ * @file simhash_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors with the cosine
+ * distance using SimHash locality-sensitive hashing.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "simhash_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with SimHash",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search with the "
+    "cosine distance using SimHash locality-sensitive hashing (sign random "
+    "projections).  Given a set of reference points and a set of query points, "
+    "this will compute the k approximate nearest neighbors of each query point "
+    "in the reference set; models can be saved for future use.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points with the cosine distance (one minus the cosine similarity), "
+    "using locality-sensitive hashing with random hyperplanes.  Each of the " +
+    PRINT_PARAM_STRING("tables") + " hash tables draws " +
+    PRINT_PARAM_STRING("bits") + " random hyperplanes (at most 64), and the "
+    "code of a point in the table is a 64-bit word of the sides of the "
+    "hyperplanes it lies on.  The points that share a bucket with a query in "
+    "any table are its candidate neighbors, and they are ranked by their exact "
+    "cosine distance."
+    "\n\n"
+    "With " + PRINT_PARAM_STRING("num_probes") + ", that many additional "
+    "buckets are searched in each table: those of the codes of the query with "
+    "the bits of the closest hyperplanes flipped.  If " +
+    PRINT_PARAM_STRING("rerank") + " is positive, only that many candidates, "
+    "those whose codes are the closest to the code of the query in Hamming "
+    "distance, are ranked by their cosine distance."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("simhash", "k", 5, "reference", "input", "distances",
+        "distances", "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points.  If " + PRINT_PARAM_STRING("query") +
+    " is not given, the neighbors of each reference point other than itself "
+    "are found.  If fewer than k candidates are found for a query, its "
+    "remaining neighbors are the largest index value and its remaining "
+    "distances the largest double value."
+    "\n\n"
+    "Because this is approximate-nearest-neighbors search, results may be "
+    "different from run to run.  Thus, the " + PRINT_PARAM_STRING("seed") +
+    " parameter can be specified to set the random seed.",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("Similarity estimation techniques from rounding algorithms (pdf)",
+        "https://www.cs.princeton.edu/courses/archive/spr04/cos598B/"
+        "bib/CharikarEstim.pdf"),
+    SEE_ALSO("mlpack::neighbor::SimHashSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1SimHashSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(SimHashSearch, "input_model", "Input SimHash model.", "m");
+PARAM_MODEL_OUT(SimHashSearch, "output_model", "Output for trained SimHash "
+    "model.", "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("bits", "The number of hyperplanes of each table (between 1 and "
+    "64).", "b", 16);
+PARAM_INT_IN("tables", "The number of hash tables to be used.", "L", 10);
+PARAM_INT_IN("num_probes", "Number of additional probes for multiprobe LSH; if "
+    "0, traditional LSH is used.", "T", 0);
+PARAM_INT_IN("rerank", "The number of candidates closest in Hamming distance "
+    "that are ranked by their cosine distance (0 to rank all candidates).",
+    "R", 0);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("bits", [](int x) { return x > 0 && x <= 64; }, true,
+      "number of bits must be between 1 and 64");
+  RequireParamValue<int>("tables", [](int x) { return x > 0; }, true,
+      "number of tables must be greater than 0");
+  RequireParamValue<int>("num_probes", [](int x) { return x >= 0; }, true,
+      "number of probes must not be negative");
+  RequireParamValue<int>("rerank", [](int x) { return x >= 0; }, true,
+      "number of re-ranked candidates must not be negative");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "query");
+  ReportIgnoredParam({{ "k", false }}, "true_neighbors");
+
+  ReportIgnoredParam({{ "reference", false }}, "bits");
+  ReportIgnoredParam({{ "reference", false }}, "tables");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  SimHashSearch* simhash;
+  if (CLI::HasParam("reference"))
+  {
+    arma::mat& referenceData = CLI::GetParam<arma::mat>("reference");
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    simhash = new SimHashSearch((size_t) CLI::GetParam<int>("bits"),
+        (size_t) CLI::GetParam<int>("tables"));
+
+    Timer::Start("hash_building");
+    simhash->Train(std::move(referenceData));
+    Timer::Stop("hash_building");
+
+    Log::Info << "Hashed " << simhash->ReferenceSet().n_cols << " points into "
+        << simhash->Tables() << " tables of " << simhash->Bits() << "-bit "
+        << "codes." << endl;
+  }
+  else // We must have an input model.
+  {
+    simhash = CLI::GetParam<SimHashSearch*>("input_model");
+  }
+
+  // The search parameters of the model are the given ones, or the default ones
+  // for a new model.
+  if (CLI::HasParam("num_probes") || !CLI::HasParam("input_model"))
+    simhash->Probes() = (size_t) CLI::GetParam<int>("num_probes");
+  if (CLI::HasParam("rerank") || !CLI::HasParam("input_model"))
+    simhash->Rerank() = (size_t) CLI::GetParam<int>("rerank");
+
+  if (CLI::HasParam("k"))
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    Log::Info << "Computing " << k << " approximate nearest neighbors with "
+        << simhash->Probes() << " additional probes per table." << endl;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    Timer::Start("computing_neighbors");
+    if (CLI::HasParam("query"))
+    {
+      const arma::mat& queryData = CLI::GetParam<arma::mat>("query");
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
+
+      simhash->Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      simhash->Search(k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed." << endl;
+
+    // Compute recall, if desired.
+    if (CLI::HasParam("true_neighbors"))
+    {
+      arma::Mat<size_t>& trueNeighbors =
+          CLI::GetParam<arma::Mat<size_t>>("true_neighbors");
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+      }
+
+      Log::Info << "Using true neighbor indices from '"
+          << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors")
+          << "'." << endl;
+      Log::Info << "Recall: " << 100 * KNN::Recall(neighbors, trueNeighbors)
+          << endl;
+    }
+
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  CLI::GetParam<SimHashSearch*>("output_model") = simhash;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file simhash_search.cpp
+ *
+ * Implementation of the SimHashSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "simhash_search.hpp"
+
+#include <mlpack/core/kernels/cosine_distance.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+//! The number of points projected on the hyperplanes at once.
+static const size_t simHashBlockSize = 4096;
+
+SimHashSearch::SimHashSearch(const size_t bits,
+                             const size_t tables,
+                             const size_t probes,
+                             const size_t rerank) :
+    bits(bits),
+    tables(tables),
+    probes(probes),
+    rerank(rerank)
+{
+  // Nothing to do.
+}
+
+SimHashSearch::SimHashSearch(arma::mat referenceSet,
+                             const size_t bits,
+                             const size_t tables,
+                             const size_t probes,
+                             const size_t rerank) :
+    bits(bits),
+    tables(tables),
+    probes(probes),
+    rerank(rerank)
+{
+  Train(std::move(referenceSet));
+}
+
+void SimHashSearch::Train(arma::mat referenceSet)
+{
+  if (bits == 0 || bits > 64)
+  {
+    std::ostringstream oss;
+    oss << "SimHashSearch::Train(): the number of bits (" << bits << ") must "
+        << "be between 1 and 64";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (tables == 0)
+  {
+    throw std::invalid_argument("SimHashSearch::Train(): the number of tables "
+        "must be positive");
+  }
+
+  if (referenceSet.n_cols == 0)
+  {
+    throw std::invalid_argument("SimHashSearch::Train(): the reference set is "
+        "empty");
+  }
+
+  this->referenceSet = std::move(referenceSet);
+  projections.randn(tables * bits, this->referenceSet.n_rows);
+
+  Hash(this->referenceSet, codes);
+  BuildTables();
+}
+
+void SimHashSearch::Search(const arma::mat& querySet,
+                           const size_t k,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances) const
+{
+  SearchQueries(querySet, false, k, neighbors, distances);
+}
+
+void SimHashSearch::Search(const size_t k,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances) const
+{
+  SearchQueries(referenceSet, true, k, neighbors, distances);
+}
+
+void SimHashSearch::Hash(const arma::mat& points,
+                         std::vector<uint64_t>& codes) const
+{
+  if (projections.is_empty())
+    throw std::invalid_argument("SimHashSearch::Hash(): the model is not "
+        "trained");
+
+  if (points.n_rows != projections.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SimHashSearch::Hash(): the dimensionality of the points ("
+        << points.n_rows << ") is not the dimensionality of the model ("
+        << projections.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The points are projected in blocks, so that the projections of a large
+  // set are never held at once.
+  codes.resize(points.n_cols * tables);
+  for (size_t begin = 0; begin < points.n_cols; begin += simHashBlockSize)
+  {
+    const size_t end = std::min(begin + simHashBlockSize, (size_t)
+        points.n_cols);
+    const arma::mat projected = projections * points.cols(begin, end - 1);
+    Encode(projected, codes.data() + begin * tables);
+  }
+}
+
+void SimHashSearch::Encode(const arma::mat& projected, uint64_t* codes) const
+{
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) projected.n_cols; ++j)
+  {
+    const double* column = projected.colptr(j);
+    for (size_t t = 0; t < tables; ++t)
+    {
+      uint64_t code = 0;
+      for (size_t b = 0; b < bits; ++b)
+        code |= ((uint64_t) (column[t * bits + b] > 0.0)) << b;
+
+      codes[j * tables + t] = code;
+    }
+  }
+}
+
+void SimHashSearch::BuildTables()
+{
+  const size_t n = referenceSet.n_cols;
+  sortedCodes.resize(tables);
+  sortedIndices.resize(tables);
+
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < (omp_size_t) tables; ++t)
+  {
+    std::vector<size_t>& indices = sortedIndices[t];
+    indices.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      indices[i] = i;
+
+    const uint64_t* tableCodes = codes.data() + t;
+    const size_t stride = tables;
+    std::stable_sort(indices.begin(), indices.end(),
+        [tableCodes, stride](const size_t a, const size_t b)
+        { return tableCodes[a * stride] < tableCodes[b * stride]; });
+
+    sortedCodes[t].resize(n);
+    for (size_t i = 0; i < n; ++i)
+      sortedCodes[t][i] = tableCodes[indices[i] * stride];
+  }
+}
+
+void SimHashSearch::ProbingCodes(const double* projected,
+                                 const uint64_t code,
+                                 std::vector<uint64_t>& probingCodes) const
+{
+  probingCodes.assign(1, code);
+  if (probes == 0)
+    return;
+
+  // The bit of a neighbor is the most likely to differ for the hyperplanes that
+  // are the closest to the query, so the bits are sorted by the margin of the
+  // query.  The sets of bits to flip are enumerated by increasing total margin
+  // with the shift and expand operations of multiprobe LSH; each set holds
+  // increasing positions in the sorted bits.
+  std::vector<size_t> order(bits);
+  for (size_t b = 0; b < bits; ++b)
+    order[b] = b;
+  std::sort(order.begin(), order.end(), [projected](const size_t a,
+      const size_t b) { return std::abs(projected[a]) <
+      std::abs(projected[b]); });
+
+  typedef std::pair<double, std::vector<size_t>> FlipSet;
+  std::priority_queue<FlipSet, std::vector<FlipSet>, std::greater<FlipSet>>
+      flipSets;
+  flipSets.push(FlipSet(std::abs(projected[order[0]]),
+      std::vector<size_t>(1, 0)));
+  while (probingCodes.size() <= probes && !flipSets.empty())
+  {
+    const FlipSet flipSet = flipSets.top();
+    flipSets.pop();
+
+    uint64_t probingCode = code;
+    for (size_t i = 0; i < flipSet.second.size(); ++i)
+      probingCode ^= ((uint64_t) 1) << order[flipSet.second[i]];
+    probingCodes.push_back(probingCode);
+
+    const size_t last = flipSet.second.back();
+    if (last + 1 < bits)
+    {
+      const double next = std::abs(projected[order[last + 1]]);
+
+      FlipSet expanded(flipSet.first + next, flipSet.second);
+      expanded.second.push_back(last + 1);
+      flipSets.push(expanded);
+
+      FlipSet shifted(flipSet.first - std::abs(projected[order[last]]) + next,
+          flipSet.second);
+      shifted.second.back() = last + 1;
+      flipSets.push(shifted);
+    }
+  }
+}
+
+void SimHashSearch::SearchQueries(const arma::mat& querySet,
+                                  const bool sameSet,
+                                  const size_t k,
+                                  arma::Mat<size_t>& neighbors,
+                                  arma::mat& distances) const
+{
+  if (projections.is_empty())
+    throw std::invalid_argument("SimHashSearch::Search(): the model is not "
+        "trained");
+
+  const size_t available = sameSet ? referenceSet.n_cols - 1 :
+      referenceSet.n_cols;
+  if (k > available)
+  {
+    std::ostringstream oss;
+    oss << "SimHashSearch::Search(): requested " << k << " approximate "
+        << "nearest neighbors, but reference set has " << referenceSet.n_cols
+        << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "SimHashSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << referenceSet.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+
+  const size_t kept = std::max(rerank, k);
+  for (size_t begin = 0; begin < querySet.n_cols; begin += simHashBlockSize)
+  {
+    const size_t end = std::min(begin + simHashBlockSize, (size_t)
+        querySet.n_cols);
+    const arma::mat projected = projections * querySet.cols(begin, end - 1);
+    std::vector<uint64_t> queryCodes(projected.n_cols * tables);
+    Encode(projected, queryCodes.data());
+
+    #pragma omp parallel
+    {
+      // For each reference point, one plus the last query that found it.
+      std::vector<size_t> lastSeen(referenceSet.n_cols, 0);
+      std::vector<size_t> found;
+      std::vector<uint64_t> probingCodes;
+      std::vector<std::pair<size_t, size_t>> hammingDistances;
+      std::vector<Candidate> candidates;
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t q = 0; q < (omp_size_t) projected.n_cols; ++q)
+      {
+        const size_t i = begin + q;
+        const uint64_t* queryCode = queryCodes.data() + q * tables;
+
+        // Collect the points of the probed buckets of each table.
+        found.clear();
+        for (size_t t = 0; t < tables; ++t)
+        {
+          ProbingCodes(projected.colptr(q) + t * bits, queryCode[t],
+              probingCodes);
+
+          const std::vector<uint64_t>& tableCodes = sortedCodes[t];
+          for (size_t p = 0; p < probingCodes.size(); ++p)
+          {
+            const size_t first = std::lower_bound(tableCodes.begin(),
+                tableCodes.end(), probingCodes[p]) - tableCodes.begin();
+            for (size_t j = first; j < tableCodes.size() &&
+                tableCodes[j] == probingCodes[p]; ++j)
+            {
+              const size_t index = sortedIndices[t][j];
+              if (lastSeen[index] == i + 1 || (sameSet && index == i))
+                continue;
+
+              lastSeen[index] = i + 1;
+              found.push_back(index);
+            }
+          }
+        }
+
+        // Keep the candidates with the smallest Hamming distances.
+        if (rerank > 0 && found.size() > kept)
+        {
+          hammingDistances.resize(found.size());
+          for (size_t j = 0; j < found.size(); ++j)
+          {
+            hammingDistances[j] = std::make_pair(HammingDistance(queryCode,
+                codes.data() + found[j] * tables, tables), found[j]);
+          }
+
+          std::nth_element(hammingDistances.begin(), hammingDistances.begin() +
+              kept, hammingDistances.end());
+          found.resize(kept);
+          for (size_t j = 0; j < kept; ++j)
+            found[j] = hammingDistances[j].second;
+        }
+
+        // Rank the candidates by their cosine distances.
+        const arma::vec query(const_cast<double*>(querySet.colptr(i)),
+            querySet.n_rows, false, true);
+        candidates.resize(found.size());
+        for (size_t j = 0; j < found.size(); ++j)
+        {
+          candidates[j] = Candidate(1.0 - kernel::CosineDistance::Evaluate(
+              query, referenceSet.col(found[j])), found[j]);
+        }
+
+        const size_t numNeighbors = std::min(k, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() +
+            numNeighbors, candidates.end());
+        for (size_t j = 0; j < numNeighbors; ++j)
+        {
+          neighbors(j, i) = candidates[j].second;
+          distances(j, i) = candidates[j].first;
+        }
+      }
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
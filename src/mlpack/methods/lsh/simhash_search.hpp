@@ -0,0 +1,262 @@
+/**
+ * @file simhash_search.hpp
+ *
+ * Defines the SimHashSearch class, which performs an approximate nearest
+ * neighbor search with the cosine distance using locality-sensitive hashing
+ * with random hyperplanes.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @inproceedings{charikar2002similarity,
+ *   title={Similarity estimation techniques from rounding algorithms},
+ *   author={Charikar, M.S.},
+ *   booktitle={Proceedings of the 34th Annual ACM Symposium on Theory of
+ *       Computing},
+ *   pages={380--388},
+ *   year={2002},
+ *   organization={ACM}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LSH_SIMHASH_SEARCH_HPP
+#define MLPACK_METHODS_LSH_SIMHASH_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The SimHashSearch class computes the approximate nearest neighbors of query
+ * points with the cosine distance (one minus the cosine similarity, see
+ * kernel::CosineDistance), using sign random projections (SimHash).
+ *
+ * Each of the Tables() hash tables draws Bits() random hyperplanes through the
+ * origin, and the code of a point in the table is the word whose bit b tells
+ * on which side of hyperplane b the point is; two points get different bits
+ * with probability angle / pi.  The code of a point is thus one 64-bit word
+ * per table, and the number of differing bits of two codes, their Hamming
+ * distance, is computed with a popcount.
+ *
+ * A search collects the reference points that share a bucket with the query in
+ * any table.  With multiprobe, the Probes() buckets of each table most likely
+ * to hold neighbors are also searched: they are the codes of the query with
+ * bits flipped, the bits whose hyperplanes are closest to the query first.  If
+ * Rerank() is not 0 and more candidates were found, only the Rerank()
+ * candidates with the smallest Hamming distances to the query over all the
+ * tables are kept.  The candidates left are then ranked by their exact cosine
+ * distances.
+ *
+ * @code
+ * SimHashSearch simhash(std::move(embeddings), 16, 10);
+ * simhash.Probes() = 8;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * simhash.Search(queries, 10, neighbors, distances);
+ * @endcode
+ */
+class SimHashSearch
+{
+ public:
+  /**
+   * Create an untrained model with the given settings; Train() must be called
+   * before Search().
+   *
+   * @param bits Number of hyperplanes of each table (between 1 and 64).
+   * @param tables Number of hash tables.
+   * @param probes Number of additional buckets searched in each table.
+   * @param rerank Number of candidates ranked by their cosine distance (0 to
+   *     rank all of them).
+   */
+  SimHashSearch(const size_t bits = 16,
+                const size_t tables = 10,
+                const size_t probes = 0,
+                const size_t rerank = 0);
+
+  /**
+   * Build the hash tables on the given reference set.  In order to avoid
+   * copying the reference set, it is suggested to pass it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param bits Number of hyperplanes of each table (between 1 and 64).
+   * @param tables Number of hash tables.
+   * @param probes Number of additional buckets searched in each table.
+   * @param rerank Number of candidates ranked by their cosine distance (0 to
+   *     rank all of them).
+   */
+  SimHashSearch(arma::mat referenceSet,
+                const size_t bits = 16,
+                const size_t tables = 10,
+                const size_t probes = 0,
+                const size_t rerank = 0);
+
+  /**
+   * Draw new hyperplanes with the current Bits() and Tables(), and build the
+   * hash tables on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(arma::mat referenceSet);
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the query
+   * set, in parallel over the query points.  If fewer than k candidates are
+   * found for a query, the remaining neighbors are SIZE_MAX and the remaining
+   * distances DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the list of neighbors for each point
+   *     (one column per query point).
+   * @param distances Matrix to store the cosine distances to the neighbors.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the reference
+   * set, other than the point itself.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the list of neighbors for each point
+   *     (one column per reference point).
+   * @param distances Matrix to store the cosine distances to the neighbors.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Compute the codes of the given points: word t of the codes of point j,
+   * codes[j * Tables() + t], is its code in table t.
+   *
+   * @param points Points to hash.
+   * @param codes Vector to store the codes in.
+   */
+  void Hash(const arma::mat& points, std::vector<uint64_t>& codes) const;
+
+  /**
+   * Return the Hamming distance between two codes of the given number of
+   * words: the number of bits that differ.
+   */
+  static size_t HammingDistance(const uint64_t* a,
+                                const uint64_t* b,
+                                const size_t words)
+  {
+    size_t distance = 0;
+    for (size_t w = 0; w < words; ++w)
+      distance += PopCount(a[w] ^ b[w]);
+
+    return distance;
+  }
+
+  //! Get the reference set.
+  const arma::mat& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of hyperplanes of each table.
+  size_t Bits() const { return bits; }
+  //! Modify the number of hyperplanes of each table (only used by the next
+  //! Train()).
+  size_t& Bits() { return bits; }
+
+  //! Get the number of hash tables.
+  size_t Tables() const { return tables; }
+  //! Modify the number of hash tables (only used by the next Train()).
+  size_t& Tables() { return tables; }
+
+  //! Get the number of additional buckets searched in each table.
+  size_t Probes() const { return probes; }
+  //! Modify the number of additional buckets searched in each table.
+  size_t& Probes() { return probes; }
+
+  //! Get the number of candidates ranked by their cosine distance.
+  size_t Rerank() const { return rerank; }
+  //! Modify the number of candidates ranked by their cosine distance.
+  size_t& Rerank() { return rerank; }
+
+  //! Get the hyperplanes; row t * Bits() + b is the normal of hyperplane b of
+  //! table t.
+  const arma::mat& Projections() const { return projections; }
+
+  //! Get the codes of the reference points (see Hash()).
+  const std::vector<uint64_t>& Codes() const { return codes; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A candidate neighbor and its distance to the query.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Return the number of set bits of the given word.
+  static size_t PopCount(uint64_t x)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (size_t) ((x * 0x0101010101010101ULL) >> 56);
+#endif
+  }
+
+  //! Compute the codes of points from their projections on the hyperplanes
+  //! (one column per point), and store them from the given word on.
+  void Encode(const arma::mat& projected, uint64_t* codes) const;
+
+  //! Sort the reference points of each table by their codes.
+  void BuildTables();
+
+  /**
+   * Compute the codes of the buckets of the given table to search for the
+   * query with the given projections: its own code, and then the Probes()
+   * codes with the flipped bits of lowest total margin.
+   */
+  void ProbingCodes(const double* projected,
+                    const uint64_t code,
+                    std::vector<uint64_t>& probingCodes) const;
+
+  //! Search for the neighbors of each query point (see Search()).
+  void SearchQueries(const arma::mat& querySet,
+                     const bool sameSet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances) const;
+
+  //! The number of hyperplanes of each table.
+  size_t bits;
+  //! The number of hash tables.
+  size_t tables;
+  //! The number of additional buckets searched in each table.
+  size_t probes;
+  //! The number of candidates ranked by their cosine distance.
+  size_t rerank;
+
+  //! The reference set.
+  arma::mat referenceSet;
+  //! The normals of the hyperplanes of all the tables, one per row.
+  arma::mat projections;
+  //! The codes of the reference points.
+  std::vector<uint64_t> codes;
+
+  //! The codes of the reference points in each table, sorted.
+  std::vector<std::vector<uint64_t>> sortedCodes;
+  //! The reference points of each table, sorted by their codes.
+  std::vector<std::vector<size_t>> sortedIndices;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "simhash_search_impl.hpp"
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file simhash_search_impl.hpp
+ *
+ * Implementation of templated SimHashSearch functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LSH_SIMHASH_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_LSH_SIMHASH_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "simhash_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename Archive>
+void SimHashSearch::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(bits);
+  ar & BOOST_SERIALIZATION_NVP(tables);
+  ar & BOOST_SERIALIZATION_NVP(probes);
+  ar & BOOST_SERIALIZATION_NVP(rerank);
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(projections);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+
+  // The sorted tables are rebuilt from the codes.
+  if (Archive::is_loading::value)
+    BuildTables();
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,166 @@
+/**
+ * @file factored_matrix_completion.cpp
+ *
+ * Implementation of the FactoredMatrixCompletion class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "factored_matrix_completion.hpp"
+
+namespace mlpack {
+namespace matrix_completion {
+
+FactoredMatrixCompletion::FactoredMatrixCompletion(const size_t m,
+                                                   const size_t n,
+                                                   const arma::umat& indices,
+                                                   const arma::vec& values,
+                                                   const size_t r,
+                                                   const double lambda,
+                                                   const size_t maxIterations,
+                                                   const double tolerance) :
+    m(m), n(n), indices(indices), values(values), r(r), lambda(lambda),
+    maxIterations(maxIterations), tolerance(tolerance)
+{
+  CheckValues();
+
+  SortEntries(0, m, rowOrder, rowOffsets);
+  SortEntries(1, n, colOrder, colOffsets);
+}
+
+void FactoredMatrixCompletion::CheckValues()
+{
+  if (indices.n_rows != 2)
+  {
+    Log::Fatal << "FactoredMatrixCompletion::CheckValues(): matrix of "
+        << "constraint indices does not have 2 rows!" << std::endl;
+  }
+
+  if (indices.n_cols != values.n_elem)
+  {
+    Log::Fatal << "FactoredMatrixCompletion::CheckValues(): the number of "
+        << "constraint indices (columns of constraint indices matrix) does not "
+        << "match the number of constraint values (length of constraint value "
+        << "vector)!" << std::endl;
+  }
+
+  for (size_t i = 0; i < values.n_elem; i++)
+  {
+    if (indices(0, i) >= m || indices(1, i) >= n)
+      Log::Fatal << "FactoredMatrixCompletion::CheckValues(): indices ("
+          << indices(0, i) << ", " << indices(1, i)
+          << ") are out of bounds for matrix of size " << m << " x " << n
+          << "!" << std::endl;
+  }
+}
+
+void FactoredMatrixCompletion::SortEntries(const size_t dimension,
+                                           const size_t count,
+                                           arma::Col<size_t>& order,
+                                           arma::Col<size_t>& offsets) const
+{
+  offsets.zeros(count + 1);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    ++offsets[indices(dimension, i) + 1];
+  offsets = arma::cumsum(offsets);
+
+  arma::Col<size_t> next = offsets.head(count);
+  order.set_size(indices.n_cols);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    order[next[indices(dimension, i)]++] = i;
+}
+
+void FactoredMatrixCompletion::SolveFactors(const arma::mat& fixed,
+                                            const size_t otherDimension,
+                                            const arma::Col<size_t>& order,
+                                            const arma::Col<size_t>& offsets,
+                                            arma::mat& factors) const
+{
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) factors.n_cols; ++i)
+  {
+    const size_t begin = offsets[i];
+    const size_t count = offsets[i + 1] - begin;
+
+    // A row or column without known entries is only pulled to zero.
+    if (count == 0)
+    {
+      factors.col(i).zeros();
+      continue;
+    }
+
+    arma::mat f(r, count);
+    arma::vec known(count);
+    for (size_t k = 0; k < count; ++k)
+    {
+      const size_t entry = order[begin + k];
+      f.col(k) = fixed.col(indices(otherDimension, entry));
+      known[k] = values[entry];
+    }
+
+    arma::mat gram = f * f.t();
+    gram.diag() += lambda;
+
+    arma::vec x;
+    if (arma::solve(x, gram, f * known))
+      factors.col(i) = x;
+  }
+}
+
+double FactoredMatrixCompletion::Objective(const arma::mat& wt,
+                                           const arma::mat& h) const
+{
+  double objective = 0.0;
+
+  #pragma omp parallel for reduction(+:objective)
+  for (omp_size_t i = 0; i < (omp_size_t) indices.n_cols; ++i)
+  {
+    const double error = values[i] - arma::dot(wt.col(indices(0, i)),
+        h.col(indices(1, i)));
+    objective += error * error;
+  }
+
+  return objective + lambda * (arma::accu(arma::square(wt)) +
+      arma::accu(arma::square(h)));
+}
+
+double FactoredMatrixCompletion::Recover(arma::mat& w, arma::mat& h)
+{
+  // The factors of the rows are kept as columns, so each thread works on
+  // contiguous memory.
+  arma::mat wt(r, m);
+  if (h.n_rows != r || h.n_cols != n)
+    h.randu(r, n);
+
+  double objective = DBL_MAX;
+  for (size_t i = 0; i != maxIterations; ++i)
+  {
+    SolveFactors(h, 1, rowOrder, rowOffsets, wt);
+    SolveFactors(wt, 0, colOrder, colOffsets, h);
+
+    const double lastObjective = objective;
+    objective = Objective(wt, h);
+
+    Log::Info << "FactoredMatrixCompletion::Recover(): iteration " << i + 1
+        << ", objective " << objective << "." << std::endl;
+
+    if (std::abs(lastObjective - objective) <= tolerance *
+        std::max(objective, 1e-12))
+      break;
+  }
+
+  w = wt.t();
+  return objective;
+}
+
+void FactoredMatrixCompletion::Recover(arma::mat& recovered)
+{
+  arma::mat w, h;
+  Recover(w, h);
+  recovered = w * h;
+}
+
+} // namespace matrix_completion
+} // namespace mlpack
@@ -0,0 +1,170 @@
+/**
+ * @file factored_matrix_completion.hpp
+ *
+ * Low rank matrix completion by alternating least squares on the factors of
+ * the matrix, restricted to the known entries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_FACTORED_MATRIX_COMPLETION_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_FACTORED_MATRIX_COMPLETION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * This class solves the same problem as MatrixCompletion, but without the
+ * semidefinite program: the completed matrix is X = W H, with W of size m x r
+ * and H of size r x n, and the factors minimize
+ *
+ *   sum_{(i, j) known} (M_ij - w_i^T h_j)^2 + lambda (||W||_F^2 + ||H||_F^2).
+ *
+ * Since ||X||_* = min_{W H = X} (||W||_F^2 + ||H||_F^2) / 2, this is the
+ * nuclear norm heuristic of MatrixCompletion with the constraints relaxed and
+ * the rank bounded by r.  The problem is solved by alternating least squares:
+ * with H fixed, each row of W is a small (r x r) ridge regression on the known
+ * entries of its row, and the same holds for the columns of H.  Only the known
+ * entries and the factors are stored, so the memory is O(p + r (m + n)) for p
+ * known entries, and the rows (then the columns) are solved in parallel with
+ * OpenMP.
+ *
+ * @code
+ * size_t m, n;         // size of unknown matrix
+ * arma::umat indices;  // contains the known indices [2 x n_entries]
+ * arma::vec values;    // contains the known values [n_entries]
+ * arma::mat w, h;      // will contain the factors of the completed matrix
+ *
+ * FactoredMatrixCompletion mc(m, n, indices, values, 10);
+ * mc.Recover(w, h);
+ * @endcode
+ *
+ * @see MatrixCompletion
+ */
+class FactoredMatrixCompletion
+{
+ public:
+  /**
+   * Construct a matrix completion problem.
+   *
+   * @param m Number of rows of original matrix.
+   * @param n Number of columns of original matrix.
+   * @param indices Matrix containing the indices of the known entries (must be
+   *    [2 x p]).
+   * @param values Vector containing the values of the known entries (must be
+   *    length p).
+   * @param r Rank of the factors.
+   * @param lambda Regularization parameter.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param tolerance Relative change of the objective to stop at.
+   */
+  FactoredMatrixCompletion(const size_t m,
+                           const size_t n,
+                           const arma::umat& indices,
+                           const arma::vec& values,
+                           const size_t r,
+                           const double lambda = 1e-6,
+                           const size_t maxIterations = 100,
+                           const double tolerance = 1e-8);
+
+  /**
+   * Find the factors of the completed matrix X = W H.  If w and h have the
+   * right sizes, h is used as the starting point; otherwise the starting point
+   * is random.
+   *
+   * @param w Will contain the m x r left factor.
+   * @param h Will contain the r x n right factor.
+   * @return The final objective.
+   */
+  double Recover(arma::mat& w, arma::mat& h);
+
+  /**
+   * Fill in the remaining values.  The completed matrix is dense; for large
+   * matrices, use the other overload of Recover() instead.
+   *
+   * @param recovered Will contain the completed matrix.
+   */
+  void Recover(arma::mat& recovered);
+
+  //! Get the rank of the factors.
+  size_t Rank() const { return r; }
+  //! Modify the rank of the factors.
+  size_t& Rank() { return r; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance.
+  double& Tolerance() { return tolerance; }
+
+ private:
+  //! Number of rows in original matrix.
+  size_t m;
+  //! Number of columns in original matrix.
+  size_t n;
+  //! Matrix containing the indices of the known entries (has two rows).
+  arma::umat indices;
+  //! Vector containing the values of the known entries.
+  arma::vec values;
+
+  //! Rank of the factors.
+  size_t r;
+  //! Regularization parameter.
+  double lambda;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Relative change of the objective to stop at.
+  double tolerance;
+
+  //! The known entries, sorted by row.
+  arma::Col<size_t> rowOrder;
+  //! The first position in rowOrder of each row, and the end.
+  arma::Col<size_t> rowOffsets;
+  //! The known entries, sorted by column.
+  arma::Col<size_t> colOrder;
+  //! The first position in colOrder of each column, and the end.
+  arma::Col<size_t> colOffsets;
+
+  //! Validate the input matrices.
+  void CheckValues();
+
+  /**
+   * Sort the known entries by the given row of the indices (0 for the rows, 1
+   * for the columns), with a counting sort.
+   */
+  void SortEntries(const size_t dimension,
+                   const size_t count,
+                   arma::Col<size_t>& order,
+                   arma::Col<size_t>& offsets) const;
+
+  /**
+   * Solve the factors of one side (one column of factors per row or column of
+   * the matrix) with the factors of the other side fixed.
+   */
+  void SolveFactors(const arma::mat& fixed,
+                    const size_t otherDimension,
+                    const arma::Col<size_t>& order,
+                    const arma::Col<size_t>& offsets,
+                    arma::mat& factors) const;
+
+  //! Compute the objective for the given factors (each r x m and r x n).
+  double Objective(const arma::mat& wt, const arma::mat& h) const;
+};
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,14 @@ namespace meanshift /** Mean shift clustering. */ {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * Unless told otherwise, Cluster() does not start from every point: the points
+ * are binned on a grid with a cell size of the radius, and the corner of each
+ * non-empty cell is used as a seed (like the bin seeding of scikit-learn).  One
+ * tree is built on the dataset for all the range searches, and the seeds are
+ * shifted in parallel with OpenMP; the duplicate centroids are then removed in
+ * the order of the seeds, so the result does not depend on the number of
+ * threads.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
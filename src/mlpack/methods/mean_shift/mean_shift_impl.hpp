@@ -18,8 +18,6 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 
-#include "map"
-
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
 
@@ -71,23 +69,6 @@ EstimateRadius(const MatType& data, double ratio)
   return arma::sum(maxDistances) / (double) data.n_cols;
 }
 
-// Class to compare two vectors.
-template <typename VecType>
-class less
-{
- public:
-  bool operator()(const VecType& first, const VecType& second) const
-  {
-    for (size_t i = 0; i < first.n_rows; ++i)
-    {
-      if (first[i] == second[i])
-        continue;
-      return first(i) < second(i);
-    }
-    return false;
-  }
-};
-
 // Generate seeds from given data set.
 template<bool UseKernel, typename KernelType, typename MatType>
 void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
@@ -96,36 +77,42 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
     const int minFreq,
     MatType& seeds)
 {
-  typedef arma::colvec VecType;
-  std::map<VecType, int, less<VecType> > allSeeds;
+  // Sort the points by the bin they fall in (in lexicographic order), so that
+  // the points of each bin are next to each other; this avoids allocating a
+  // vector for each point.
+  const arma::mat bins = arma::floor(data / binSize);
+  std::vector<size_t> order(data.n_cols);
   for (size_t i = 0; i < data.n_cols; ++i)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(), [&bins](const size_t a, const size_t b)
   {
-    VecType binnedPoint = arma::floor(data.unsafe_col(i) / binSize);
-    if (allSeeds.find(binnedPoint) == allSeeds.end())
-      allSeeds[binnedPoint] = 1;
-    else
-      allSeeds[binnedPoint]++;
-  }
+    for (size_t d = 0; d < bins.n_rows; ++d)
+    {
+      if (bins(d, a) != bins(d, b))
+        return bins(d, a) < bins(d, b);
+    }
+    return false;
+  });
 
-  // Remove seeds with too few points.  First we count the number of seeds we
-  // end up with, then we add them.
-  std::map<VecType, int, less<VecType> >::iterator it;
-  size_t count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
-    if (it->second >= minFreq)
-      ++count;
-
-  seeds.set_size(data.n_rows, count);
-  count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
+  // Find the first point of each bin with enough points.
+  std::vector<size_t> seedPoints;
+  size_t binStart = 0;
+  for (size_t i = 1; i <= order.size(); ++i)
   {
-    if (it->second >= minFreq)
+    if (i == order.size() || arma::any(bins.col(order[i]) !=
+        bins.col(order[binStart])))
     {
-      seeds.col(count) = it->first;
-      ++count;
+      if ((int) (i - binStart) >= minFreq)
+        seedPoints.push_back(order[binStart]);
+      binStart = i;
     }
   }
 
+  seeds.set_size(data.n_rows, seedPoints.size());
+  for (size_t i = 0; i < seedPoints.size(); ++i)
+    seeds.col(i) = bins.col(seedPoints[i]);
+
   seeds *= binSize;
 }
 
@@ -204,61 +191,91 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   // Holds all centroids before removing duplicate ones.
   arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  // Whether the centroid of each seed converged (char instead of bool, so that
+  // the threads can write to it).
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  // The tree is built once, and searched by every thread with its own
+  // RangeSearch object.  Single-tree search is used, since there is only one
+  // query point at a time.
+  typedef range::RangeSearch<metric::EuclideanDistance, MatType>
+      RangeSearchType;
+  typename RangeSearchType::Tree referenceTree(data);
+  const MatType& referenceSet = referenceTree.Dataset();
+  const math::Range validRadius(0, radius);
 
   // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  #pragma omp parallel
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
-    {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+    RangeSearchType rangeSearcher(&referenceTree, true);
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+    // The neighbors of the current centroid; the memory is reused across
+    // iterations.
+    std::vector<std::vector<size_t>> neighbors(1);
+    std::vector<std::vector<double>> distances(1);
+    range::VectorResultCallback callback(neighbors, distances);
 
-      // If the mean shift vector is small enough, it has converged.
-      if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
+    {
+      // Initial centroid is the seed itself.
+      allCentroids.col(i) = pSeeds->col(i);
+      for (size_t completedIterations = 0; completedIterations < maxIterations
+          || forceConvergence; completedIterations++)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        // Store new centroid in this.
+        arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+
+        neighbors[0].clear();
+        distances[0].clear();
+        rangeSearcher.Search(arma::mat(allCentroids.col(i)), validRadius,
+            callback);
+        if (neighbors[0].size() == 0) // There are no points in the cluster.
+          break;
+
+        // Calculate new centroid.
+        if (!CalculateCentroid(referenceSet, neighbors[0], distances[0],
+            newCentroid))
+          newCentroid = allCentroids.col(i);
+
+        // If the mean shift vector is small enough, it has converged.
+        if (metric::EuclideanDistance::Evaluate(newCentroid,
+            allCentroids.col(i)) < 1e-3 * radius)
         {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          converged[i] = 1;
+          break;
         }
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+        // Update the centroid.
+        allCentroids.col(i) = newCentroid;
+      }
+    }
+  }
 
-        // Get out of the loop.
+  // Remove the duplicate centroids, in the order of the seeds so that the
+  // result does not depend on the number of threads.
+  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  {
+    if (!converged[i])
+      continue;
+
+    // Determine if the new centroid is duplicate with old ones.
+    bool isDuplicated = false;
+    for (size_t k = 0; k < centroids.n_cols; ++k)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(
+          allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+      if (distance < radius)
+      {
+        isDuplicated = true;
         break;
       }
-
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
     }
+
+    if (!isDuplicated)
+      centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
   }
 
   // If no centroid has converged due to too little iterations and without
@@ -2,9 +2,7 @@
  * @file mvu.cpp
  * @author Ryan Curtin
  *
- * Implementation of the MVU class and its auxiliary objective function class.
- *
- * Note: this implementation of MVU does not work.  See #189.
+ * Implementation of the MVU class.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -13,13 +11,14 @@
  */
 #include "mvu.hpp"
 
-#include <mlpack/core/optimizers/sdp/lrsdp.hpp>
-
+#include <mlpack/core/math/random.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
+#include <ensmallen.hpp>
+
 using namespace mlpack;
 using namespace mlpack::mvu;
-using namespace mlpack::optimization;
+using namespace mlpack::neighbor;
 
 MVU::MVU(const arma::mat& data) : data(data)
 {
@@ -28,84 +27,200 @@ MVU::MVU(const arma::mat& data) : data(data)
 
 void MVU::Unfold(const size_t newDim,
                  const size_t numNeighbors,
-                 arma::mat& outputData)
+                 arma::mat& outputData,
+                 const size_t numLandmarks,
+                 const double regularization)
 {
-  // First we have to choose the output point.  We'll take a linear projection
-  // of the data for now (this is probably not a good final solution).
-//  outputData = trans(data.rows(0, newDim - 1));
-  // Following Nick's idea.
-  outputData.randu(data.n_cols, newDim);
+  const size_t n = data.n_cols;
+  const size_t m = (numLandmarks == 0 || numLandmarks >= n) ? n :
+      numLandmarks;
 
-  // The number of constraints is the number of nearest neighbors plus one.
-  LRSDP<arma::sp_mat> mvuSolver(numNeighbors * data.n_cols + 1, outputData);
+  if (newDim == 0 || newDim > data.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "MVU::Unfold(): the new dimensionality must be between 1 and the "
+        << "dimensionality of the data (" << data.n_rows << "), but " << newDim
+        << " was given.";
+    throw std::invalid_argument(oss.str());
+  }
 
-  // Set up the objective.  Because we are maximizing the trace of (R R^T),
-  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
-  mvuSolver.C().eye(data.n_cols, data.n_cols);
-  mvuSolver.C() *= -1;
+  if (numNeighbors == 0 || numNeighbors >= m)
+  {
+    std::ostringstream oss;
+    oss << "MVU::Unfold(): the number of neighbors must be between 1 and "
+        << m - 1 << " (one less than the number of landmarks), but "
+        << numNeighbors << " was given.";
+    throw std::invalid_argument(oss.str());
+  }
 
-  // Now set up each of the constraints.
-  // The first constraint is trace(ones * R * R^T) = 0.
-  mvuSolver.B()[0] = 0;
-  mvuSolver.A()[0].ones(data.n_cols, data.n_cols);
+  if (m == n)
+  {
+    landmarks = arma::linspace<arma::uvec>(0, n - 1, n);
+    SolveSDP(data, newDim, numNeighbors, outputData);
+    return;
+  }
 
-  // All of our other constraints will be sparse except the first.  So set that
-  // vector of modes accordingly.
-  mvuSolver.AModes().ones();
-  mvuSolver.AModes()[0] = 0;
+  // Draw the landmarks; only the first m steps of a Fisher-Yates shuffle are
+  // needed.
+  landmarks = arma::linspace<arma::uvec>(0, n - 1, n);
+  for (size_t i = 0; i < m; ++i)
+    std::swap(landmarks[i], landmarks[math::RandInt(i, n)]);
+  landmarks = arma::sort(landmarks.head(m));
 
-  // Now all of the other constraints.  We first have to run KNN to get the
-  // list of nearest neighbors.
+  const arma::mat landmarkData = data.cols(landmarks);
+  arma::mat landmarkCoordinates;
+  SolveSDP(landmarkData, newDim, numNeighbors, landmarkCoordinates);
+
+  // Now each point is placed as the combination of its nearest landmarks that
+  // best reconstructs it in the input space.
   arma::Mat<size_t> neighbors;
   arma::mat distances;
+  KNN knn(landmarkData);
+  knn.Search(data, numNeighbors, neighbors, distances);
 
-  KNN knn(data);
-  knn.Search(numNeighbors, neighbors, distances);
+  arma::mat weights;
+  ReconstructionWeights(landmarkData, data, neighbors, weights,
+      regularization);
 
-  // Add each of the other constraints.  They are sparse constraints:
-  //   Tr(A_ij K) = d_ij;
-  //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
-  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  outputData.zeros(newDim, n);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
   {
-    for (size_t j = 0; j < numNeighbors; ++j)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
     {
-      // This is the index of the constraint.
-      const size_t index = (i * numNeighbors) + j + 1;
+      outputData.col(i) += weights(j, i) *
+          landmarkCoordinates.col(neighbors(j, i));
+    }
+  }
 
-      arma::mat& aRef = mvuSolver.A()[index];
+  // The landmarks keep the coordinates of the program.
+  outputData.cols(landmarks) = landmarkCoordinates;
+}
 
-      aRef.set_size(3, 4);
+void MVU::ReconstructionWeights(const arma::mat& referenceSet,
+                                const arma::mat& querySet,
+                                const arma::Mat<size_t>& neighbors,
+                                arma::mat& weights,
+                                const double regularization)
+{
+  const size_t k = neighbors.n_rows;
+  weights.set_size(k, neighbors.n_cols);
 
-      // A_ij(i, i) = 1.
-      aRef(0, 0) = i;
-      aRef(1, 0) = i;
-      aRef(2, 0) = 1;
+  #pragma omp parallel
+  {
+    arma::mat z(referenceSet.n_rows, k);
+    arma::mat gram;
+    arma::vec w;
 
-      // A_ij(i, j) = -1.
-      aRef(0, 1) = i;
-      aRef(1, 1) = neighbors(j, i);
-      aRef(2, 1) = -1;
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) neighbors.n_cols; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+        z.col(j) = referenceSet.col(neighbors(j, i)) - querySet.col(i);
+
+      // The weights that sum to one and minimize the reconstruction error are
+      // the normalized solution of G w = 1, with G the local Gram matrix; G is
+      // singular when there are more neighbors than dimensions, so it is
+      // regularized.
+      gram = z.t() * z;
+      const double trace = arma::trace(gram);
+      gram.diag() += (trace > 0.0) ? regularization * trace : regularization;
+
+      if (arma::solve(w, gram, arma::ones<arma::vec>(k)) &&
+          arma::accu(w) != 0.0)
+        weights.col(i) = w / arma::accu(w);
+      else
+        weights.col(i).fill(1.0 / k);
+    }
+  }
+}
 
-      // A_ij(j, i) = -1.
-      aRef(0, 2) = neighbors(j, i);
-      aRef(1, 2) = i;
-      aRef(2, 2) = -1;
+void MVU::SolveSDP(const arma::mat& points,
+                   const size_t newDim,
+                   const size_t numNeighbors,
+                   arma::mat& coordinates)
+{
+  const size_t n = points.n_cols;
 
-      // A_ij(j, j) = 1.
-      aRef(0, 3) = neighbors(j, i);
-      aRef(1, 3) = neighbors(j, i);
-      aRef(2, 3) = 1;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  KNN knn(points);
+  knn.Search(numNeighbors, neighbors, distances);
 
-      // The constraint b_ij is the distance between these two points.
-      mvuSolver.B()[index] = distances(j, i);
+  // Each edge of the neighbor graph is constrained once, even when both points
+  // are neighbors of each other.
+  std::vector<std::pair<std::pair<size_t, size_t>, double>> edges;
+  edges.reserve(neighbors.n_elem);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      edges.push_back(std::make_pair(std::make_pair(
+          std::min(i, neighbors(j, i)), std::max(i, neighbors(j, i))),
+          distances(j, i)));
     }
   }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end(),
+      [](const std::pair<std::pair<size_t, size_t>, double>& a,
+         const std::pair<std::pair<size_t, size_t>, double>& b)
+      {
+        return a.first == b.first;
+      }), edges.end());
+
+  // If r = O(sqrt(p)) for p constraints, the low-rank program has the same
+  // solution as the full one (see MatrixCompletion::DefaultRank()).
+  const size_t p = edges.size() + 1;
+  const size_t rank = std::min(n, std::max(newDim,
+      (size_t) std::ceil(0.5 + std::sqrt(0.25 + 2 * p))));
+
+  ens::LRSDP<ens::SDP<arma::sp_mat>> mvuSolver(edges.size(), 1,
+      arma::randu<arma::mat>(n, rank));
+
+  // Set up the objective.  Because we are maximizing the trace of (R R^T),
+  // we'll instead state it as min(-I_n * (R R^T)), meaning C() is -I_n.
+  mvuSolver.SDP().C().eye(n, n);
+  mvuSolver.SDP().C() *= -1;
+
+  // The only dense constraint is trace(ones * R * R^T) = 0, which centers the
+  // embedding.
+  mvuSolver.SDP().DenseA()[0].ones(n, n);
+  mvuSolver.SDP().DenseB()[0] = 0;
+
+  // The distance constraints are sparse:
+  //   Tr(A_ij K) = d_ij^2;
+  //   A_ij = zeros except for 1 at (i, i), (j, j); -1 at (i, j), (j, i).
+  arma::umat locations(2, 4);
+  arma::vec values = { 1, -1, -1, 1 };
+  for (size_t e = 0; e < edges.size(); ++e)
+  {
+    const size_t i = edges[e].first.first;
+    const size_t j = edges[e].first.second;
+
+    locations(0, 0) = i; locations(1, 0) = i;
+    locations(0, 1) = i; locations(1, 1) = j;
+    locations(0, 2) = j; locations(1, 2) = i;
+    locations(0, 3) = j; locations(1, 3) = j;
+
+    mvuSolver.SDP().SparseA()[e] = arma::sp_mat(locations, values, n, n);
+    mvuSolver.SDP().SparseB()[e] = edges[e].second * edges[e].second;
+  }
 
   // Now on with the solving.
-  double objective = mvuSolver.Optimize(outputData);
+  arma::mat r = mvuSolver.Function().GetInitialPoint();
+  const double objective = mvuSolver.Optimize(r);
 
   Log::Info << "Final objective is " << objective << "." << std::endl;
 
-  // Revert to original data format.
-  outputData = trans(outputData);
+  // The embedding is given by the top eigenvectors of K = R R^T, which are the
+  // left singular vectors of R; if there are fewer points than dimensions, the
+  // other dimensions are zero.
+  arma::mat u, v;
+  arma::vec s;
+  arma::svd_econ(u, s, v, r);
+
+  const size_t dims = std::min(newDim, (size_t) s.n_elem);
+  coordinates.zeros(newDim, n);
+  coordinates.rows(0, dims - 1) = arma::trans(u.head_cols(dims) *
+      arma::diagmat(s.head(dims)));
 }
@@ -3,11 +3,11 @@
  * @author Ryan Curtin
  *
  * An implementation of Maximum Variance Unfolding.  This file defines an MVU
- * class as well as a class representing the objective function (a semidefinite
- * program) which MVU seeks to minimize.  Minimization is performed by the
- * Augmented Lagrangian optimizer (which in turn uses the L-BFGS optimizer).
- *
- * Note: this implementation of MVU does not work.  See #189.
+ * class, which sets up the semidefinite program that MVU seeks to solve, and
+ * solves it with the low-rank SDP solver LRSDP.  To embed large datasets, the
+ * program can be solved on a random subset of landmark points only, and the
+ * other points are then placed by local linear reconstruction from their
+ * nearest landmarks.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -28,18 +28,96 @@ namespace mvu {
  *
  * - dataset
  * - new dimensionality
+ * - number of nearest neighbors, whose distances are preserved
+ * - number of landmarks (optional)
+ *
+ * MVU finds the kernel matrix K of the embedded points which maximizes
+ * Tr(K), the variance of the embedding, subject to sum(K) = 0 (the embedding
+ * is centered) and K_ii + K_jj - 2 K_ij = ||x_i - x_j||^2 for each point i and
+ * each of its nearest neighbors j.  Each distance constraint has four nonzero
+ * elements, so they are held as sparse matrices, and K is factored as R R^T
+ * with a low-rank R.
+ *
+ * The program has one variable per pair of points, so for large datasets a
+ * number of landmarks should be given: the program is then solved on that many
+ * points drawn at random, and each other point is embedded as the combination
+ * of its nearest landmarks with the weights that best reconstruct it from them
+ * in the input space, as in locally linear embedding.
+ *
+ * @code
+ * @inproceedings{weinberger2005nonlinear,
+ *   title = {Nonlinear Dimensionality Reduction by Semidefinite Programming and
+ *       Kernel Matrix Factorization},
+ *   author = {Weinberger, Kilian Q. and Packer, Benjamin D. and Saul,
+ *       Lawrence K.},
+ *   booktitle = {Proceedings of the Tenth International Workshop on Artificial
+ *       Intelligence and Statistics (AISTATS 2005)},
+ *   pages = {381--388},
+ *   year = {2005}
+ * }
+ * @endcode
  */
 class MVU
 {
  public:
   MVU(const arma::mat& dataIn);
 
+  /**
+   * Unfold the dataset into the given number of dimensions.
+   *
+   * @param newDim Dimensionality of the unfolded dataset.
+   * @param numNeighbors Number of nearest neighbors of each point (or of each
+   *     landmark) whose distances are preserved.
+   * @param outputCoordinates Matrix to store the unfolded dataset in, with one
+   *     column per point.
+   * @param numLandmarks Number of landmarks to solve the program on; 0 means
+   *     all of the points are used.
+   * @param regularization Regularization of the local Gram matrices used to
+   *     reconstruct the points that are not landmarks, relative to their
+   *     trace.
+   */
   void Unfold(const size_t newDim,
               const size_t numNeighbors,
-              arma::mat& outputCoordinates);
+              arma::mat& outputCoordinates,
+              const size_t numLandmarks = 0,
+              const double regularization = 1e-3);
+
+  /**
+   * Find the weights, which sum to one, that best reconstruct each point of
+   * the query set from the given neighbors of it in the reference set, as in
+   * locally linear embedding.
+   *
+   * @param referenceSet Points that the query points are reconstructed from.
+   * @param querySet Points to reconstruct.
+   * @param neighbors Indices of the neighbors in the reference set of each
+   *     query point, one column per query point.
+   * @param weights Matrix to store the weights in, the same size as neighbors.
+   * @param regularization Regularization of the local Gram matrices, relative
+   *     to their trace.
+   */
+  static void ReconstructionWeights(const arma::mat& referenceSet,
+                                    const arma::mat& querySet,
+                                    const arma::Mat<size_t>& neighbors,
+                                    arma::mat& weights,
+                                    const double regularization = 1e-3);
+
+  //! Get the indices of the landmarks of the last call to Unfold().
+  const arma::uvec& Landmarks() const { return landmarks; }
 
  private:
+  /**
+   * Solve the MVU program on the given points, and store the embedding in
+   * coordinates, with one column per point.
+   */
+  static void SolveSDP(const arma::mat& points,
+                       const size_t newDim,
+                       const size_t numNeighbors,
+                       arma::mat& coordinates);
+
   const arma::mat& data;
+
+  //! The indices of the landmarks.
+  arma::uvec landmarks;
 };
 
 } // namespace mvu
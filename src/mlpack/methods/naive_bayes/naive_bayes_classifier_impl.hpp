@@ -19,6 +19,10 @@
 
 #include <mlpack/prereqs.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 // In case it hasn't been included already.
 #include "naive_bayes_classifier.hpp"
 
@@ -102,66 +106,99 @@ void NaiveBayesClassifier<ModelMatType>::Train(
   }
 
   // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
-  if (incremental)
+  // for each of the features with respect to each of the labels.  The points
+  // are split into contiguous blocks; the statistics of each block are computed
+  // in parallel with the two-pass algorithm, and the statistics of the blocks
+  // are then merged with the parallel algorithm of Chan et al.  If the
+  // incremental algorithm is used, the current model is merged in the same way.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    numBlocks = std::max(std::min((size_t) omp_get_max_threads(),
+        (size_t) data.n_cols / 1000), (size_t) 1);
+  #endif
+
+  arma::Mat<ElemType> blockCounts(numClasses, numBlocks, arma::fill::zeros);
+  arma::Cube<ElemType> blockMeans(data.n_rows, numClasses, numBlocks,
+      arma::fill::zeros);
+  arma::Cube<ElemType> blockSquares(data.n_rows, numClasses, numBlocks,
+      arma::fill::zeros);
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
+    const size_t begin = b * data.n_cols / numBlocks;
+    const size_t end = (b + 1) * data.n_cols / numBlocks;
+    arma::Mat<ElemType>& means = blockMeans.slice(b);
+    arma::Mat<ElemType>& squares = blockSquares.slice(b);
 
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Calculate the means.
+    for (size_t j = begin; j < end; ++j)
     {
       const size_t label = labels[j];
-      ++probabilities[label];
+      ++blockCounts(label, b);
+      means.col(label) += data.col(j);
+    }
+
+    for (size_t i = 0; i < numClasses; ++i)
+      if (blockCounts(i, b) != 0)
+        means.col(i) /= blockCounts(i, b);
 
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+    // Calculate the sums of squared deviations from the means.
+    for (size_t j = begin; j < end; ++j)
+    {
+      const size_t label = labels[j];
+      squares.col(label) += arma::square(data.col(j) - means.col(label));
     }
+  }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
+  // Start from the current model, or from nothing.  The variances are turned
+  // back into sums of squared deviations.
+  arma::Col<ElemType> counts(numClasses, arma::fill::zeros);
+  ModelMatType squares(data.n_rows, numClasses, arma::fill::zeros);
+  if (incremental)
+  {
+    for (size_t i = 0; i < numClasses; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      counts[i] = std::round(probabilities[i] * trainingPoints);
+      if (counts[i] > 1)
+        squares.col(i) = variances.col(i) * (counts[i] - 1);
     }
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
     means.zeros();
-    variances.zeros();
-
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
-
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
-    }
-
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
+    trainingPoints = 0;
+  }
 
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+  // Merge the statistics of each block: with n = n_a + n_b and
+  // delta = mean_b - mean_a, the merged statistics are
+  //   mean = mean_a + delta * n_b / n,
+  //   squares = squares_a + squares_b + delta^2 * n_a * n_b / n.
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    for (size_t i = 0; i < numClasses; ++i)
     {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      const ElemType blockCount = blockCounts(i, b);
+      if (blockCount == 0)
+        continue;
+
+      const ElemType count = counts[i] + blockCount;
+      const arma::Col<ElemType> delta = blockMeans.slice(b).col(i) -
+          means.col(i);
+      means.col(i) += delta * (blockCount / count);
+      squares.col(i) += blockSquares.slice(b).col(i) + arma::square(delta) *
+          (counts[i] * blockCount / count);
+      counts[i] = count;
     }
+  }
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+  // Normalize the variances.
+  for (size_t i = 0; i < numClasses; ++i)
+  {
+    if (counts[i] > 1)
+      variances.col(i) = squares.col(i) / (counts[i] - 1);
+    else
+      variances.col(i) = squares.col(i);
   }
 
   // Ensure that the variances are invertible.
@@ -169,8 +206,8 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     if (variances[i] == 0.0)
       variances[i] = 1e-50;
 
-  probabilities /= data.n_cols;
   trainingPoints += data.n_cols;
+  probabilities = counts / trainingPoints;
 }
 
 template<typename ModelMatType>
@@ -208,23 +245,56 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
+  // The log likelihood of the point x for class c is (up to the normalization
+  // term)
+  //
+  //   log(p_c) - (d / 2) log(2 pi) - (1 / 2) sum_k log(v_kc)
+  //       - (1 / 2) sum_k (x_k - m_kc)^2 / v_kc,
+  //
+  // and the last sum is
+  //
+  //   sum_k x_k^2 / v_kc - 2 sum_k x_k m_kc / v_kc + sum_k m_kc^2 / v_kc,
+  //
+  // so the log likelihoods of all the points for all the classes take only two
+  // matrix multiplications.  That expansion loses too much precision for the
+  // features whose variance is tiny next to their mean (such as the features
+  // that were constant in the training points of the class), so the terms of
+  // these features are computed directly.
+  const ElemType eps = std::numeric_limits<ElemType>::epsilon();
   ModelMatType invVar = 1.0 / variances;
+  std::vector<std::vector<size_t>> exactFeatures(means.n_cols);
+  for (size_t i = 0; i < means.n_cols; ++i)
+  {
+    for (size_t k = 0; k < means.n_rows; ++k)
+    {
+      if (eps * (1 + means(k, i) * means(k, i)) > 1e-4 * variances(k, i))
+      {
+        exactFeatures[i].push_back(k);
+        invVar(k, i) = 0;
+      }
+    }
+  }
+
+  const ModelMatType weightedMeans = means % invVar;
+  logLikelihoods = weightedMeans.t() * data -
+      0.5 * (invVar.t() * arma::square(data));
 
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
+  arma::Col<ElemType> constants(means.n_cols);
+  for (size_t i = 0; i < means.n_cols; ++i)
+  {
+    constants[i] = std::log(probabilities[i]) + data.n_rows / -2.0 *
+        std::log(2 * M_PI) - 0.5 * arma::accu(arma::log(variances.col(i))) -
+        0.5 * arma::dot(weightedMeans.col(i), means.col(i));
+  }
+  logLikelihoods.each_col() += constants;
 
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  for (size_t i = 0; i < means.n_cols; ++i)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        std::log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
+    for (size_t k : exactFeatures[i])
+    {
+      logLikelihoods.row(i) -= (0.5 / variances(k, i)) *
+          arma::square(data.row(k) - means(k, i));
+    }
   }
 }
 
@@ -86,6 +86,13 @@ class NCA
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
 
+  //! Get the softmax error function being optimized.
+  const SoftmaxErrorFunction<MetricType>& ErrorFunction() const
+  { return errorFunction; }
+  //! Modify the softmax error function being optimized (for instance, to
+  //! truncate the neighborhoods).
+  SoftmaxErrorFunction<MetricType>& ErrorFunction() { return errorFunction; }
+
  private:
   //! Dataset reference.
   const arma::mat& dataset;
@@ -88,7 +88,13 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.",
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "For large datasets, the softmax of each point can be restricted to its " +
+    PRINT_PARAM_STRING("neighbors") + " nearest points in the learned space, "
+    "which makes each pass over the dataset take time linear in the number of "
+    "points.  The nearest points are searched for again every " +
+    PRINT_PARAM_STRING("refresh_interval") + " passes over the dataset.",
     SEE_ALSO("@lmnn", "#lmnn"),
     SEE_ALSO("Neighbourhood components analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Neighbourhood_components_analysis"),
@@ -129,6 +135,11 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("neighbors", "Number of nearest points considered in the softmax "
+    "of each point (0 considers all points).", "k", 0);
+PARAM_INT_IN("refresh_interval", "Number of passes over the dataset between "
+    "searches for the nearest points, if --neighbors is given.", "R", 1);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -182,6 +193,14 @@ static void mlpackMain()
   const double maxStep = CLI::GetParam<double>("max_step");
   const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
 
+  RequireParamValue<int>("neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be nonnegative");
+  RequireParamValue<int>("refresh_interval", [](int x) { return x > 0; }, true,
+      "refresh interval must be positive");
+  const size_t neighbors = (size_t) CLI::GetParam<int>("neighbors");
+  const size_t refreshInterval =
+      (size_t) CLI::GetParam<int>("refresh_interval");
+
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
 
@@ -240,6 +259,8 @@ static void mlpackMain()
     nca.Optimizer().Tolerance() = tolerance;
     nca.Optimizer().Shuffle() = shuffle;
     nca.Optimizer().BatchSize() = batchSize;
+    nca.ErrorFunction().Neighbors() = neighbors;
+    nca.ErrorFunction().RefreshInterval() = refreshInterval;
 
     nca.LearnDistance(distance);
   }
@@ -254,6 +275,8 @@ static void mlpackMain()
     nca.Optimizer().MaxLineSearchTrials() = maxLineSearchTrials;
     nca.Optimizer().MinStep() = minStep;
     nca.Optimizer().MaxStep() = maxStep;
+    nca.ErrorFunction().Neighbors() = neighbors;
+    nca.ErrorFunction().RefreshInterval() = refreshInterval;
 
     nca.LearnDistance(distance);
   }
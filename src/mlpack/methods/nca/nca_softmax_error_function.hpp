@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -38,6 +39,14 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * Since exp(-d) vanishes quickly, the softmax of each point is dominated by its
+ * nearest points.  If Neighbors() is set to some k > 0, only the k nearest
+ * points of each point (in the space stretched by the current coordinates) are
+ * considered in its softmax, so that each evaluation over the whole dataset
+ * takes O(n k) time instead of O(n^2).  The neighborhoods are found with
+ * NeighborSearch, and searched for again after RefreshInterval() passes over
+ * the dataset.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -129,6 +138,20 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of nearest points considered in the softmax of each point
+  //! (0 means all points).
+  size_t Neighbors() const { return neighbors; }
+  //! Modify the number of nearest points considered in the softmax of each
+  //! point (0 means all points).
+  size_t& Neighbors() { return neighbors; }
+
+  //! Get the number of passes over the dataset between searches for the
+  //! nearest points.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of passes over the dataset between searches for the
+  //! nearest points.
+  size_t& RefreshInterval() { return refreshInterval; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -152,6 +175,42 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! Number of nearest points considered in the softmax of each point, or 0
+  //! for all the points.
+  size_t neighbors;
+  //! Number of passes over the dataset between neighborhood searches.
+  size_t refreshInterval;
+  //! The nearest points of each point, one column per point.
+  arma::Mat<size_t> neighborhoods;
+  //! Number of points evaluated since the last neighborhood search.
+  size_t pointsSinceSearch;
+
+  /**
+   * Search for the nearest points of each point in the space stretched by the
+   * given coordinates, if there are no neighborhoods yet (or they belong to a
+   * dataset of another size) or RefreshInterval() passes over the dataset have
+   * been made since the last search.  Then count the given number of points as
+   * evaluated.
+   *
+   * @param coordinates Coordinates matrix to stretch the dataset with.
+   * @param numPoints Number of points about to be evaluated.
+   */
+  void UpdateNeighborhoods(const arma::mat& coordinates,
+                           const size_t numPoints);
+
+  /**
+   * Compute exp(-d(A x_i, A x_j)) for each point j in the neighborhood of point
+   * i, stretching only those points.
+   *
+   * @param coordinates Coordinates matrix A.
+   * @param i Index of the point.
+   * @param evals Vector to store the values in, in the order of the
+   *     neighborhood.
+   */
+  void NeighborhoodEvals(const arma::mat& coordinates,
+                         const size_t i,
+                         arma::vec& evals);
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -161,7 +220,7 @@ class SoftmaxErrorFunction
    * This will update last_coordinates_ and stretched_dataset_, and also
    * calculate the p_i and denominators_ which are used in the calculation of
    * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
+   * great, or O(n k) if the neighborhoods are truncated to k points.
    *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
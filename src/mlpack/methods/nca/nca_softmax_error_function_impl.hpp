@@ -27,7 +27,10 @@ SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
-    precalculated(false)
+    precalculated(false),
+    neighbors(0),
+    refreshInterval(1),
+    pointsSinceSearch(0)
 { /* nothing to do */ }
 
 //! Shuffle the dataset.
@@ -44,6 +47,11 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The points have moved, so the neighborhoods and anything precalculated
+  // refer to the wrong points now.
+  neighborhoods.reset();
+  precalculated = false;
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -64,16 +72,47 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
+  double result = 0;
+
+  // With truncated neighborhoods, each evaluation only takes O(k) time, and
+  // only the points in the neighborhood need to be stretched.
+  if (neighbors > 0)
+  {
+    UpdateNeighborhoods(coordinates, 0);
+
+    arma::vec evals;
+    for (size_t i = begin; i < begin + batchSize; i++)
+    {
+      NeighborhoodEvals(coordinates, i, evals);
+
+      double numerator = 0;
+      for (size_t l = 0; l < neighborhoods.n_rows; ++l)
+        if (labels[i] == labels[neighborhoods(l, i)])
+          numerator += evals[l];
+
+      const double denominator = arma::accu(evals);
+      if (denominator == 0.0)
+      {
+        Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+        continue;
+      }
+
+      result += -(numerator / denominator);
+    }
+
+    return result;
+  }
+
   // Unfortunately each evaluation will take O(N) time because it requires a
   // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
-  double result = 0;
 
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
   for (size_t i = begin; i < begin + batchSize; i++)
   {
+    double denominator = 0;
+    double numerator = 0;
+
     for (size_t k = 0; k < dataset.n_cols; ++k)
     {
       // Don't consider the case where the points are the same.
@@ -127,6 +166,32 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
   //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
   arma::mat sum;
   sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
+
+  // With truncated neighborhoods, p_ik is only nonzero for the points k in
+  // the neighborhood of i, so we add those terms one point i at a time.
+  if (neighbors > 0)
+  {
+    for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+    {
+      for (size_t l = 0; l < neighborhoods.n_rows; ++l)
+      {
+        const size_t k = neighborhoods(l, i);
+        const double p_ik = exp(-metric.Evaluate(
+            stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k))) /
+            denominators(i);
+
+        arma::vec x_ik = dataset.col(i) - dataset.col(k);
+        if (labels[i] == labels[k])
+          sum += ((p[i] - 1) * p_ik) * (x_ik * trans(x_ik));
+        else
+          sum += (p[i] * p_ik) * (x_ik * trans(x_ik));
+      }
+    }
+
+    gradient = -2 * coordinates * sum;
+    return;
+  }
+
   for (size_t i = 0; i < stretchedDataset.n_cols; i++)
   {
     for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
@@ -170,6 +235,52 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
 
   gradient.zeros(coordinates.n_rows, coordinates.n_rows);
 
+  // With truncated neighborhoods only the points in the neighborhood of each
+  // point are considered, and only those have to be stretched.
+  if (neighbors > 0)
+  {
+    UpdateNeighborhoods(coordinates, batchSize);
+
+    arma::vec evals;
+    for (size_t i = begin; i < begin + batchSize; i++)
+    {
+      NeighborhoodEvals(coordinates, i, evals);
+
+      numerator = 0;
+      denominator = 0;
+      firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
+      secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
+
+      for (size_t l = 0; l < neighborhoods.n_rows; ++l)
+      {
+        const size_t k = neighborhoods(l, i);
+        GradType x_ik = dataset.col(i) - dataset.col(k);
+        if (labels[i] == labels[k])
+        {
+          numerator += evals[l];
+          secondTerm += evals[l] * x_ik * trans(x_ik);
+        }
+
+        denominator += evals[l];
+        firstTerm += evals[l] * x_ik * trans(x_ik);
+      }
+
+      if (denominator == 0)
+      {
+        Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
+        continue;
+      }
+
+      const double p = numerator / denominator;
+      firstTerm /= denominator;
+      secondTerm /= denominator;
+
+      gradient += -2 * coordinates * (p * firstTerm - secondTerm);
+    }
+
+    return;
+  }
+
   // Compute the stretched dataset.
   stretchedDataset = coordinates * dataset;
   for (size_t i = begin; i < begin + batchSize; i++)
@@ -255,15 +366,37 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   lastCoordinates = coordinates;
   stretchedDataset = coordinates * dataset;
 
+  p.zeros(stretchedDataset.n_cols);
+  denominators.zeros(stretchedDataset.n_cols);
+
+  // With truncated neighborhoods, the softmax of each point only runs over its
+  // neighborhood, which is no longer symmetric; so this takes O(n k) time.
+  if (neighbors > 0)
+  {
+    UpdateNeighborhoods(coordinates, stretchedDataset.n_cols);
+
+    for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+    {
+      for (size_t l = 0; l < neighborhoods.n_rows; ++l)
+      {
+        const size_t j = neighborhoods(l, i);
+        const double eval = exp(-metric.Evaluate(
+            stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(j)));
+
+        denominators[i] += eval;
+        if (labels[i] == labels[j])
+          p[i] += eval;
+      }
+    }
+  }
+
   // For each point i, we must evaluate the softmax function:
   //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
   //   p_i = sum_{j in class of i} p_ij
   // We will do this by keeping track of the denominators for each i as well as
   // the numerators (the sum for all j in class of i).  This will be on the
   // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  for (size_t i = 0; (neighbors == 0) && (i < stretchedDataset.n_cols); i++)
   {
     for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
     {
@@ -304,6 +437,62 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighborhoods(
+    const arma::mat& coordinates,
+    const size_t numPoints)
+{
+  if (neighbors >= dataset.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxErrorFunction: the number of neighbors (" << neighbors
+        << ") must be less than the number of points (" << dataset.n_cols
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (neighborhoods.n_cols != dataset.n_cols ||
+      neighborhoods.n_rows != neighbors ||
+      pointsSinceSearch >= refreshInterval * dataset.n_cols)
+  {
+    // The nearest points under Euclidean distance are the nearest points under
+    // the squared Euclidean distance too; for other metrics they are a
+    // reasonable approximation.
+    #ifdef HAS_OPENMP
+    const neighbor::NeighborSearchMode mode = neighbor::PARALLEL_DUAL_TREE_MODE;
+    #else
+    const neighbor::NeighborSearchMode mode = neighbor::DUAL_TREE_MODE;
+    #endif
+
+    arma::mat stretched = coordinates * dataset;
+    neighbor::KNN knn(std::move(stretched), mode);
+    arma::mat distances;
+    knn.Search(neighbors, neighborhoods, distances);
+
+    // Anything precalculated was computed with the old neighborhoods.
+    pointsSinceSearch = 0;
+    precalculated = false;
+  }
+
+  pointsSinceSearch += numPoints;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::NeighborhoodEvals(
+    const arma::mat& coordinates,
+    const size_t i,
+    arma::vec& evals)
+{
+  const arma::vec point = coordinates * dataset.col(i);
+  arma::mat stretchedNeighbors = coordinates *
+      dataset.cols(arma::conv_to<arma::uvec>::from(neighborhoods.col(i)));
+
+  evals.set_size(neighborhoods.n_rows);
+  for (size_t l = 0; l < neighborhoods.n_rows; ++l)
+    evals[l] = std::exp(-metric.Evaluate(point,
+        stretchedNeighbors.unsafe_col(l)));
+}
+
 } // namespace nca
 } // namespace mlpack
 
@@ -0,0 +1,191 @@
+/**
+ * @file dynamic_neighbor_search.hpp
+ *
+ * Defines the DynamicNeighborSearch class, which performs neighbor searches on
+ * a reference set that points can be inserted into and removed from.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The DynamicNeighborSearch class performs k-nearest-neighbor (or
+ * k-furthest-neighbor) searches on a reference set that changes over time,
+ * without rebuilding a tree on the whole reference set each time points are
+ * inserted.  It uses the logarithmic method of Bentley and Saxe: the points are
+ * held in a forest of static trees (each searched with a NeighborSearch
+ * object), where level i holds at most minLevelSize * 2^i points.  Inserted
+ * points are merged with the levels below the first level that can hold them
+ * all, and a new tree is built for that level; so each point takes part in
+ * O(log n) tree builds over its lifetime.
+ *
+ * Removed points are only marked as removed, and filtered from the results of
+ * the searches; a level is rebuilt once half of its points are removed.
+ *
+ * Each inserted point gets an id, which is the number of points inserted
+ * before it; the searches return these ids as the indices of the neighbors.
+ *
+ * @code
+ * DynamicNeighborSearch<NearestNeighborSort> knn;
+ * const size_t first = knn.Insert(points); // Ids first, first + 1, ...
+ * knn.Remove(first + 3);
+ *
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(queries, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class DynamicNeighborSearch
+{
+ public:
+  //! The type of the searches of each level.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType>
+      NeighborSearchType;
+  //! The type of the trees of each level.
+  typedef typename NeighborSearchType::Tree Tree;
+
+  /**
+   * Create the DynamicNeighborSearch object with no reference points.
+   *
+   * @param mode Neighbor search mode of the search of each level.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param minLevelSize Largest number of points in the smallest level.
+   * @param metric Instantiated metric.
+   */
+  DynamicNeighborSearch(const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const size_t minLevelSize = 64,
+                        const MetricType metric = MetricType());
+
+  //! Copying would share the searches of the levels, so it is not allowed.
+  DynamicNeighborSearch(const DynamicNeighborSearch&) = delete;
+  //! Copying would share the searches of the levels, so it is not allowed.
+  DynamicNeighborSearch& operator=(const DynamicNeighborSearch&) = delete;
+
+  //! Delete the searches of each level.
+  ~DynamicNeighborSearch();
+
+  /**
+   * Insert the given points into the reference set.  The ids of the points
+   * are consecutive, starting from the returned one.
+   *
+   * @param points Points to insert.
+   * @return Id of the first inserted point.
+   */
+  size_t Insert(const MatType& points);
+
+  /**
+   * Remove the point with the given id from the reference set.  An exception
+   * is thrown if there is no such point (or if it was already removed).
+   *
+   * @param id Id of the point to remove.
+   */
+  void Remove(const size_t id);
+
+  /**
+   * For each point in the query set, find the k best neighbors among the
+   * points of the reference set that were not removed.  The ids of the
+   * neighbors are stored in the neighbors matrix, and the distances in the
+   * distances matrix, one column for each query point, from the best neighbor
+   * to the worst.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the ids of the neighbors in.
+   * @param distances Matrix to store the distances of the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get whether the point with the given id is in the reference set.
+  bool Contains(const size_t id) const
+  {
+    return (id < pointLevels.size()) && (pointLevels[id] != size_t(-1));
+  }
+
+  //! Get the number of points in the reference set.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the number of ids given so far (including removed points).
+  size_t NumIds() const { return pointLevels.size(); }
+
+  //! Get the number of levels (some of them may be empty).
+  size_t NumLevels() const { return levels.size(); }
+
+  //! Get the number of points in the given level, including removed points.
+  size_t LevelSize(const size_t level) const
+  {
+    return levels[level].ids.n_elem;
+  }
+
+  //! Get the largest number of points in the smallest level.
+  size_t MinLevelSize() const { return minLevelSize; }
+
+ private:
+  //! A level of the forest.
+  struct Level
+  {
+    Level() : search(NULL), numRemoved(0) { }
+
+    //! The search on the points of the level (NULL if the level is empty).
+    NeighborSearchType* search;
+    //! The id of each point of the level, in the order of the search.
+    arma::Col<size_t> ids;
+    //! The number of removed points of the level.
+    size_t numRemoved;
+  };
+
+  //! Append the points of the given level that were not removed to the given
+  //! points and ids, and empty the level.
+  void Gather(const size_t level, MatType& points, arma::Col<size_t>& ids);
+
+  //! Build the search of the given (empty) level on the given points.
+  void Build(const size_t level, MatType&& points, arma::Col<size_t>&& ids);
+
+  //! The mode of the searches.
+  NeighborSearchMode mode;
+  //! The approximation error of the searches.
+  double epsilon;
+  //! Largest number of points in the smallest level.
+  size_t minLevelSize;
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! The levels of the forest.
+  std::vector<Level> levels;
+  //! The level of each point, by id (size_t(-1) if the point was removed).
+  std::vector<size_t> pointLevels;
+  //! The number of points in the reference set.
+  size_t numPoints;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "dynamic_neighbor_search_impl.hpp"
+
+#endif
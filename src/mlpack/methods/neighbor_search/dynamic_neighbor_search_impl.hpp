@@ -0,0 +1,292 @@
+/**
+ * @file dynamic_neighbor_search_impl.hpp
+ *
+ * Implementation of the DynamicNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dynamic_neighbor_search.hpp"
+
+#include <algorithm>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+DynamicNeighborSearch(const NeighborSearchMode mode,
+                      const double epsilon,
+                      const size_t minLevelSize,
+                      const MetricType metric) :
+    mode(mode),
+    epsilon(epsilon),
+    minLevelSize(minLevelSize),
+    metric(metric),
+    numPoints(0)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+  if (minLevelSize == 0)
+    throw std::invalid_argument("minLevelSize must be positive");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+~DynamicNeighborSearch()
+{
+  for (size_t i = 0; i < levels.size(); ++i)
+    delete levels[i].search;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Insert(const MatType& points)
+{
+  const size_t firstId = pointLevels.size();
+  if (points.n_cols == 0)
+    return firstId;
+
+  for (size_t i = 0; i < levels.size(); ++i)
+  {
+    if (levels[i].search != NULL &&
+        levels[i].search->ReferenceSet().n_rows != points.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "DynamicNeighborSearch::Insert(): dimensionality of points ("
+          << points.n_rows << ") is not equal to the dimensionality of the "
+          << "reference set (" << levels[i].search->ReferenceSet().n_rows
+          << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  MatType newPoints(points);
+  arma::Col<size_t> ids = arma::linspace<arma::Col<size_t>>(firstId,
+      firstId + points.n_cols - 1, points.n_cols);
+  pointLevels.resize(firstId + points.n_cols, size_t(-1));
+  numPoints += points.n_cols;
+
+  // Merge the levels from the bottom up, until the points fit in the level.
+  size_t level = 0;
+  while (true)
+  {
+    if (level == levels.size())
+      levels.push_back(Level());
+
+    if (levels[level].search != NULL)
+      Gather(level, newPoints, ids);
+
+    if (newPoints.n_cols <= (minLevelSize << level))
+      break;
+
+    ++level;
+  }
+
+  Build(level, std::move(newPoints), std::move(ids));
+
+  return firstId;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Remove(const size_t id)
+{
+  if (!Contains(id))
+  {
+    std::ostringstream oss;
+    oss << "DynamicNeighborSearch::Remove(): there is no point with id " << id
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t level = pointLevels[id];
+  pointLevels[id] = size_t(-1);
+  --numPoints;
+
+  // Rebuild the level without its removed points once half of them are
+  // removed, so that the searches do not have to look for too many extra
+  // neighbors.
+  ++levels[level].numRemoved;
+  if (2 * levels[level].numRemoved >= levels[level].ids.n_elem)
+  {
+    MatType points;
+    arma::Col<size_t> ids;
+    Gather(level, points, ids);
+    if (ids.n_elem > 0)
+      Build(level, std::move(points), std::move(ids));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Search(const MatType& querySet,
+       const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances)
+{
+  if (k > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "DynamicNeighborSearch::Search(): requested value of k (" << k
+        << ") is greater than the number of points in the reference set ("
+        << numPoints << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Search each level for enough neighbors that k of them are not removed (or
+  // all of its points), and keep the points that were not removed.
+  typedef std::pair<double, size_t> Candidate;
+  std::vector<std::vector<Candidate>> candidates(querySet.n_cols);
+
+  arma::Mat<size_t> levelNeighbors;
+  arma::mat levelDistances;
+  for (size_t l = 0; l < levels.size(); ++l)
+  {
+    const Level& level = levels[l];
+    if (level.search == NULL)
+      continue;
+
+    const size_t levelK = std::min(k + level.numRemoved, level.ids.n_elem);
+    level.search->Search(querySet, levelK, levelNeighbors, levelDistances);
+
+    for (size_t q = 0; q < querySet.n_cols; ++q)
+    {
+      for (size_t j = 0; j < levelK; ++j)
+      {
+        const size_t index = levelNeighbors(j, q);
+        if (index >= level.ids.n_elem || !Contains(level.ids[index]))
+          continue;
+
+        candidates[q].push_back(Candidate(levelDistances(j, q),
+            level.ids[index]));
+      }
+    }
+  }
+
+  // Keep the k best candidates of each query point.
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  for (size_t q = 0; q < querySet.n_cols; ++q)
+  {
+    std::vector<Candidate>& c = candidates[q];
+    std::partial_sort(c.begin(), c.begin() + k, c.end(),
+        [](const Candidate& a, const Candidate& b)
+        {
+          return SortPolicy::IsBetter(a.first, b.first) ||
+              ((a.first == b.first) && (a.second < b.second));
+        });
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      neighbors(j, q) = c[j].second;
+      distances(j, q) = c[j].first;
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Gather(const size_t level, MatType& points, arma::Col<size_t>& ids)
+{
+  Level& l = levels[level];
+  const MatType& referenceSet = l.search->ReferenceSet();
+
+  size_t j = points.n_cols;
+  const size_t numLive = l.ids.n_elem - l.numRemoved;
+  points.resize(referenceSet.n_rows, points.n_cols + numLive);
+  ids.resize(ids.n_elem + numLive);
+  for (size_t i = 0; i < l.ids.n_elem; ++i)
+  {
+    if (!Contains(l.ids[i]))
+      continue;
+
+    points.col(j) = referenceSet.col(i);
+    ids[j] = l.ids[i];
+    ++j;
+  }
+
+  delete l.search;
+  l.search = NULL;
+  l.ids.reset();
+  l.numRemoved = 0;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Build(const size_t level, MatType&& points, arma::Col<size_t>&& ids)
+{
+  Level& l = levels[level];
+  if (mode == NAIVE_MODE)
+  {
+    // The points are not reordered.
+    l.ids = std::move(ids);
+    l.search = new NeighborSearchType(std::move(points), NAIVE_MODE, epsilon,
+        metric);
+  }
+  else
+  {
+    // Build the tree here, so that the ids can follow the points if the tree
+    // rearranges them; the search then returns the indices of the points in
+    // the tree.
+    std::vector<size_t> oldFromNew;
+    Tree* tree = BuildTree<Tree>(std::move(points), oldFromNew);
+
+    l.ids.set_size(ids.n_elem);
+    for (size_t i = 0; i < ids.n_elem; ++i)
+      l.ids[i] = oldFromNew.empty() ? ids[i] : ids[oldFromNew[i]];
+
+    l.search = new NeighborSearchType(std::move(*tree), mode, epsilon, metric);
+    delete tree;
+  }
+
+  l.numRemoved = 0;
+  for (size_t i = 0; i < l.ids.n_elem; ++i)
+    pointLevels[l.ids[i]] = level;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,8 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
+#include <mlpack/core/data/for_each_batch.hpp>
 
 #include <string>
 #include <fstream>
@@ -31,8 +33,9 @@ using namespace mlpack::tree;
 using namespace mlpack::metric;
 using namespace mlpack::util;
 
-// Convenience typedef.
+// Convenience typedefs.
 typedef NSModel<NearestNeighborSort> KNNModel;
+typedef NSModel<NearestNeighborSort, arma::fmat> KNNFloatModel;
 
 // Information about the program itself.
 PROGRAM_INFO("k-Nearest-Neighbors Search",
@@ -59,7 +62,16 @@ PROGRAM_INFO("k-Nearest-Neighbors Search",
     "output matrix corresponds to the index of the point in the reference set "
     "which is the j'th nearest neighbor from the point in the query set with "
     "index i.  Row j and column i in the distances output matrix corresponds to"
-    " the distance between those two points.",
+    " the distance between those two points."
+    "\n\n"
+    "Query sets too large to be held in memory can be given with " +
+    PRINT_PARAM_STRING("query_file") + " instead; the file (.mmat, .csv, .txt, "
+    "or .tsv) is then read " + PRINT_PARAM_STRING("query_batch_size") + " "
+    "points at a time, and the neighbors and distances of each batch are "
+    "written to the files given with " + PRINT_PARAM_STRING("neighbors_file") +
+    " and " + PRINT_PARAM_STRING("distances_file") + " (one query point per "
+    "line) before the next batch is read.  The reference tree is built once "
+    "and used for every batch.",
     SEE_ALSO("@lsh", "#lsh"),
     SEE_ALSO("@krann", "#krann"),
     SEE_ALSO("@kfn", "#kfn"),
@@ -90,6 +102,17 @@ PARAM_MODEL_OUT(KNNModel, "output_model", "If specified, the kNN model will be "
 PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
 PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 
+// Instead, the query points may be read from a file a batch at a time, and the
+// results of each batch written to files before the next batch is read.
+PARAM_STRING_IN("query_file", "File holding query points to search in "
+    "batches, without loading them into memory (instead of --query).", "Q", "");
+PARAM_STRING_IN("neighbors_file", "File to write the neighbors of the points "
+    "of --query_file to, a batch at a time.", "N", "");
+PARAM_STRING_IN("distances_file", "File to write the distances of the "
+    "neighbors of the points of --query_file to, a batch at a time.", "O", "");
+PARAM_INT_IN("query_batch_size", "Number of points read from --query_file at "
+    "a time.", "B", 100000);
+
 // The user may specify the type of tree to use, and a few parameters for tree
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
@@ -110,10 +133,247 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'parallel_dual_tree'.", "a", "dual_tree");
+PARAM_INT_IN("threads", "Number of threads to use for the 'parallel_dual_tree' "
+    "algorithm (if 0, the OpenMP default is used).", "j", 0);
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
 
+PARAM_FLAG("single_precision", "If true, the reference and query sets are "
+    "converted to single precision, which halves the memory used by the "
+    "search.  Models can't be loaded or saved in this mode.", "f");
+
+//! Take the given matrix parameter.
+static void GetMatrix(const string& name, arma::mat& matrix)
+{
+  matrix = std::move(CLI::GetParam<arma::mat>(name));
+}
+
+//! Take the given matrix parameter, converted to single precision.
+static void GetMatrix(const string& name, arma::fmat& matrix)
+{
+  arma::mat& parameter = CLI::GetParam<arma::mat>(name);
+  matrix = arma::conv_to<arma::fmat>::from(parameter);
+  parameter.reset();
+}
+
+//! Build the given model on the reference set.
+template<typename ModelType, typename MatType>
+static void BuildKNN(ModelType& knn,
+                     const NeighborSearchMode searchMode,
+                     const size_t leafSize,
+                     const double tau,
+                     const double rho,
+                     const double epsilon)
+{
+  // Get all the parameters.
+  const string treeType = CLI::GetParam<string>("tree_type");
+  const bool randomBasis = CLI::HasParam("random_basis");
+
+  typename ModelType::TreeTypes tree = ModelType::KD_TREE;
+  RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
+      "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
+      "max-rp", "ub", "oct" }, true, "unknown tree type");
+  if (treeType == "kd")
+    tree = ModelType::KD_TREE;
+  else if (treeType == "cover")
+    tree = ModelType::COVER_TREE;
+  else if (treeType == "r")
+    tree = ModelType::R_TREE;
+  else if (treeType == "r-star")
+    tree = ModelType::R_STAR_TREE;
+  else if (treeType == "ball")
+    tree = ModelType::BALL_TREE;
+  else if (treeType == "x")
+    tree = ModelType::X_TREE;
+  else if (treeType == "hilbert-r")
+    tree = ModelType::HILBERT_R_TREE;
+  else if (treeType == "r-plus")
+    tree = ModelType::R_PLUS_TREE;
+  else if (treeType == "r-plus-plus")
+    tree = ModelType::R_PLUS_PLUS_TREE;
+  else if (treeType == "spill")
+    tree = ModelType::SPILL_TREE;
+  else if (treeType == "vp")
+    tree = ModelType::VP_TREE;
+  else if (treeType == "rp")
+    tree = ModelType::RP_TREE;
+  else if (treeType == "max-rp")
+    tree = ModelType::MAX_RP_TREE;
+  else if (treeType == "ub")
+    tree = ModelType::UB_TREE;
+  else if (treeType == "oct")
+    tree = ModelType::OCTREE;
+
+  knn.TreeType() = tree;
+  knn.RandomBasis() = randomBasis;
+  knn.LeafSize() = leafSize;
+  knn.Tau() = tau;
+  knn.Rho() = rho;
+
+  MatType referenceSet;
+  GetMatrix("reference", referenceSet);
+
+  Log::Info << "Loaded reference data from '"
+      << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+      << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
+      << endl;
+
+  knn.BuildModel(std::move(referenceSet), leafSize, searchMode, epsilon);
+}
+
+//! Search the points of the query file with the given model a batch at a time,
+//! writing the results of each batch before the next one is read, so that only
+//! one batch of query points and results is held in memory.
+template<typename ModelType, typename MatType>
+static void StreamingSearchKNN(ModelType& knn, const size_t k)
+{
+  const string queryFile = CLI::GetParam<string>("query_file");
+  const size_t batchSize = (size_t) CLI::GetParam<int>("query_batch_size");
+
+  data::BatchReader reader(queryFile);
+  if (reader.Dimensionality() != knn.Dataset().n_rows)
+  {
+    Log::Fatal << "The query points in '" << queryFile << "' have "
+        << reader.Dimensionality() << " dimensions, but the reference points "
+        << "have " << knn.Dataset().n_rows << "!" << endl;
+  }
+
+  std::unique_ptr<data::BatchWriter> neighborsWriter, distancesWriter;
+  if (CLI::HasParam("neighbors_file"))
+  {
+    neighborsWriter.reset(new data::BatchWriter(
+        CLI::GetParam<string>("neighbors_file"), k));
+  }
+  if (CLI::HasParam("distances_file"))
+  {
+    distancesWriter.reset(new data::BatchWriter(
+        CLI::GetParam<string>("distances_file"), k));
+  }
+
+  Log::Info << "Searching query points from '" << queryFile << "' in batches "
+      << "of " << batchSize << " points..." << endl;
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  const size_t numQueries = data::ForEachBatch(reader, batchSize,
+      [&](const arma::mat& batch, const size_t /* offset */)
+      {
+        knn.Search(arma::conv_to<MatType>::from(batch), k, neighbors,
+            distances);
+
+        if (neighborsWriter)
+          neighborsWriter->Write(arma::conv_to<arma::mat>::from(neighbors));
+        if (distancesWriter)
+          distancesWriter->Write(distances);
+      });
+
+  if (neighborsWriter)
+    neighborsWriter->Close();
+  if (distancesWriter)
+    distancesWriter->Close();
+
+  Log::Info << "Search complete (" << numQueries << " query points)." << endl;
+}
+
+//! Perform the search with the given model, if desired, and save the results.
+template<typename ModelType, typename MatType>
+static void SearchKNN(ModelType& knn)
+{
+  if (!CLI::HasParam("k"))
+    return;
+
+  const size_t k = (size_t) CLI::GetParam<int>("k");
+
+  MatType queryData;
+  if (CLI::HasParam("query"))
+  {
+    GetMatrix("query", queryData);
+    Log::Info << "Loaded query data from '"
+        << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+        << queryData.n_rows << "x" << queryData.n_cols << ")." << endl;
+  }
+
+  // Sanity check on k value: must be greater than 0, must be less than or
+  // equal to the number of reference points.  Since it is unsigned,
+  // we only test the upper bound.
+  if (k > knn.Dataset().n_cols)
+  {
+    Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
+        << "than or equal to the number of reference points ("
+        << knn.Dataset().n_cols << ")." << endl;
+  }
+
+  // Sanity check on k value: must not be equal to the number of reference
+  // points when query data has not been provided.
+  if (!CLI::HasParam("query") && !CLI::HasParam("query_file") &&
+      k == knn.Dataset().n_cols)
+  {
+    Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
+        << "reference points (" << knn.Dataset().n_cols << ") "
+        << "if query data has not been provided." << endl;
+  }
+
+  if (CLI::HasParam("query_file"))
+  {
+    StreamingSearchKNN<ModelType, MatType>(knn, k);
+    return;
+  }
+
+  // Now run the search.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  if (CLI::HasParam("query"))
+    knn.Search(std::move(queryData), k, neighbors, distances);
+  else
+    knn.Search(k, neighbors, distances);
+  Log::Info << "Search complete." << endl;
+
+  // Save output.
+  CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  CLI::GetParam<arma::mat>("distances") = std::move(distances);
+
+  // Calculate the effective error, if desired.
+  if (CLI::HasParam("true_distances"))
+  {
+    if (knn.TreeType() != ModelType::SPILL_TREE && knn.Epsilon() == 0)
+      Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
+          << "the search is exact, so there is no need to calculate the "
+          << "error!" << endl;
+
+    arma::mat trueDistances =
+        std::move(CLI::GetParam<arma::mat>("true_distances"));
+
+    if (trueDistances.n_rows != distances.n_rows ||
+        trueDistances.n_cols != distances.n_cols)
+      Log::Fatal << "The true distances file must have the same number of "
+          << "values than the set of distances being queried!" << endl;
+
+    Log::Info << "Effective error: " << KNN::EffectiveError(distances,
+        trueDistances) << endl;
+  }
+
+  // Calculate the recall, if desired.
+  if (CLI::HasParam("true_neighbors"))
+  {
+    if (knn.TreeType() != ModelType::SPILL_TREE && knn.Epsilon() == 0)
+      Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
+          << " the search is exact, so there is no need to calculate the "
+          << "recall!" << endl;
+
+    arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+      Log::Fatal << "The true neighbors file must have the same number of "
+          << "values than the set of neighbors being queried!" << endl;
+
+    Log::Info << "Recall: " << KNN::Recall(neighbors, trueNeighbors) << endl;
+  }
+}
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -124,6 +384,14 @@ static void mlpackMain()
   // A user cannot specify both reference data and a model.
   RequireOnlyOnePassed({ "reference", "input_model" }, true);
 
+  // Models are only stored in double precision.
+  if (CLI::HasParam("single_precision") && CLI::HasParam("input_model"))
+  {
+    Log::Fatal << PRINT_PARAM_STRING("single_precision") << " can't be used "
+        << "with " << PRINT_PARAM_STRING("input_model") << "." << endl;
+  }
+  ReportIgnoredParam({{ "single_precision", true }}, "output_model");
+
   ReportIgnoredParam({{ "input_model", true }}, "tree_type");
   ReportIgnoredParam({{ "input_model", true }}, "random_basis");
   ReportIgnoredParam({{ "input_model", true }}, "tau");
@@ -139,19 +407,45 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "k", "output_model" }, false,
       "no results will be saved");
 
+  // The query points can't be given both ways.
+  if (CLI::HasParam("query") && CLI::HasParam("query_file"))
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("query")
+        << " or " << PRINT_PARAM_STRING("query_file") << "!" << endl;
+  }
+  const bool streaming = CLI::HasParam("query_file");
+
   // If the user specifies k but no output files, they should be warned.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("k") && streaming)
+  {
+    RequireAtLeastOnePassed({ "neighbors_file", "distances_file" }, false,
+        "nearest neighbor search results will not be saved");
+  }
+  else if (CLI::HasParam("k"))
   {
     RequireAtLeastOnePassed({ "neighbors", "distances" }, false,
         "nearest neighbor search results will not be saved");
   }
 
+  // The results of a streaming search are only written to files, and can't be
+  // compared with the true results, which would have to be held in memory.
+  ReportIgnoredParam({{ "query_file", false }}, "neighbors_file");
+  ReportIgnoredParam({{ "query_file", false }}, "distances_file");
+  ReportIgnoredParam({{ "query_file", false }}, "query_batch_size");
+  ReportIgnoredParam({{ "query_file", true }}, "neighbors");
+  ReportIgnoredParam({{ "query_file", true }}, "distances");
+  ReportIgnoredParam({{ "query_file", true }}, "true_neighbors");
+  ReportIgnoredParam({{ "query_file", true }}, "true_distances");
+  RequireParamValue<int>("query_batch_size", [](int x) { return x > 0; },
+      true, "query batch size must be positive");
+
   // If the user specifies output files but no k, they should be warned.
   ReportIgnoredParam({{ "k", false }}, "neighbors");
   ReportIgnoredParam({{ "k", false }}, "distances");
   ReportIgnoredParam({{ "k", false }}, "true_neighbors");
   ReportIgnoredParam({{ "k", false }}, "true_distances");
   ReportIgnoredParam({{ "k", false }}, "query");
+  ReportIgnoredParam({{ "k", false }}, "query_file");
 
   // Sanity check on leaf size.
   RequireParamValue<int>("leaf_size", [](int x) { return x > 0; },
@@ -180,12 +474,10 @@ static void mlpackMain()
   RequireParamValue<double>("epsilon", [](double x) { return x >= 0.0; }, true,
       "epsilon must be positive");
 
-  // We either have to load the reference data, or we have to load the model.
-  KNNModel* knn;
-
   const string algorithm = CLI::GetParam<string>("algorithm");
   RequireParamInSet<string>("algorithm", { "naive", "single_tree", "dual_tree",
-      "greedy" }, true, "unknown neighbor search algorithm");
+      "greedy", "parallel_dual_tree" }, true,
+      "unknown neighbor search algorithm");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -196,64 +488,38 @@ static void mlpackMain()
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "parallel_dual_tree")
+    searchMode = PARALLEL_DUAL_TREE_MODE;
+
+  // Sanity check on the number of threads.
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be non-negative");
+  if (algorithm != "parallel_dual_tree")
+    ReportIgnoredParam("threads", "parallel dual-tree search is not being used");
+  #ifdef HAS_OPENMP
+  if (CLI::GetParam<int>("threads") > 0)
+    omp_set_num_threads(CLI::GetParam<int>("threads"));
+  #else
+  if (CLI::GetParam<int>("threads") > 1)
+    Log::Warn << "mlpack was not compiled with OpenMP support, so only one "
+        << "thread will be used." << endl;
+  #endif
+
+  if (CLI::HasParam("single_precision"))
+  {
+    KNNFloatModel knn;
+    BuildKNN<KNNFloatModel, arma::fmat>(knn, searchMode, size_t(lsInt), tau,
+        rho, epsilon);
+    SearchKNN<KNNFloatModel, arma::fmat>(knn);
+    return;
+  }
 
+  // We either have to load the reference data, or we have to load the model.
+  KNNModel* knn;
   if (CLI::HasParam("reference"))
   {
     knn = new KNNModel();
-
-    // Get all the parameters.
-    const string treeType = CLI::GetParam<string>("tree_type");
-    const bool randomBasis = CLI::HasParam("random_basis");
-
-    KNNModel::TreeTypes tree = KNNModel::KD_TREE;
-    RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star",
-        "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
-    if (treeType == "kd")
-      tree = KNNModel::KD_TREE;
-    else if (treeType == "cover")
-      tree = KNNModel::COVER_TREE;
-    else if (treeType == "r")
-      tree = KNNModel::R_TREE;
-    else if (treeType == "r-star")
-      tree = KNNModel::R_STAR_TREE;
-    else if (treeType == "ball")
-      tree = KNNModel::BALL_TREE;
-    else if (treeType == "x")
-      tree = KNNModel::X_TREE;
-    else if (treeType == "hilbert-r")
-      tree = KNNModel::HILBERT_R_TREE;
-    else if (treeType == "r-plus")
-      tree = KNNModel::R_PLUS_TREE;
-    else if (treeType == "r-plus-plus")
-      tree = KNNModel::R_PLUS_PLUS_TREE;
-    else if (treeType == "spill")
-      tree = KNNModel::SPILL_TREE;
-    else if (treeType == "vp")
-      tree = KNNModel::VP_TREE;
-    else if (treeType == "rp")
-      tree = KNNModel::RP_TREE;
-    else if (treeType == "max-rp")
-      tree = KNNModel::MAX_RP_TREE;
-    else if (treeType == "ub")
-      tree = KNNModel::UB_TREE;
-    else if (treeType == "oct")
-      tree = KNNModel::OCTREE;
-
-    knn->TreeType() = tree;
-    knn->RandomBasis() = randomBasis;
-    knn->LeafSize() = size_t(lsInt);
-    knn->Tau() = tau;
-    knn->Rho() = rho;
-
-    arma::mat referenceSet = std::move(CLI::GetParam<arma::mat>("reference"));
-
-    Log::Info << "Loaded reference data from '"
-        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
-        << referenceSet.n_rows << " x " << referenceSet.n_cols << ")."
-        << endl;
-
-    knn->BuildModel(std::move(referenceSet), size_t(lsInt), searchMode,
+    BuildKNN<KNNModel, arma::mat>(*knn, searchMode, size_t(lsInt), tau, rho,
         epsilon);
   }
   else
@@ -277,92 +543,7 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
-  // Perform search, if desired.
-  if (CLI::HasParam("k"))
-  {
-    const size_t k = (size_t) CLI::GetParam<int>("k");
-
-    arma::mat queryData;
-    if (CLI::HasParam("query"))
-    {
-      queryData = std::move(CLI::GetParam<arma::mat>("query"));
-      Log::Info << "Loaded query data from '"
-          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
-          << queryData.n_rows << "x" << queryData.n_cols << ")." << endl;
-    }
-
-    // Sanity check on k value: must be greater than 0, must be less than or
-    // equal to the number of reference points.  Since it is unsigned,
-    // we only test the upper bound.
-    if (k > knn->Dataset().n_cols)
-    {
-      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
-          << "than or equal to the number of reference points ("
-          << knn->Dataset().n_cols << ")." << endl;
-    }
-
-    // Sanity check on k value: must not be equal to the number of reference
-    // points when query data has not been provided.
-    if (!CLI::HasParam("query") && k == knn->Dataset().n_cols)
-    {
-      Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
-          << "reference points (" << knn->Dataset().n_cols << ") "
-          << "if query data has not been provided." << endl;
-    }
-
-    // Now run the search.
-    arma::Mat<size_t> neighbors;
-    arma::mat distances;
-
-    if (CLI::HasParam("query"))
-      knn->Search(std::move(queryData), k, neighbors, distances);
-    else
-      knn->Search(k, neighbors, distances);
-    Log::Info << "Search complete." << endl;
-
-    // Save output.
-    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
-    CLI::GetParam<arma::mat>("distances") = std::move(distances);
-
-    // Calculate the effective error, if desired.
-    if (CLI::HasParam("true_distances"))
-    {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
-        Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
-            << "the search is exact, so there is no need to calculate the "
-            << "error!" << endl;
-
-      arma::mat trueDistances =
-          std::move(CLI::GetParam<arma::mat>("true_distances"));
-
-      if (trueDistances.n_rows != distances.n_rows ||
-          trueDistances.n_cols != distances.n_cols)
-        Log::Fatal << "The true distances file must have the same number of "
-            << "values than the set of distances being queried!" << endl;
-
-      Log::Info << "Effective error: " << KNN::EffectiveError(distances,
-          trueDistances) << endl;
-    }
-
-    // Calculate the recall, if desired.
-    if (CLI::HasParam("true_neighbors"))
-    {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
-        Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
-            << " the search is exact, so there is no need to calculate the "
-            << "recall!" << endl;
-
-      arma::Mat<size_t> trueNeighbors =
-          std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
-
-      if (trueNeighbors.n_rows != neighbors.n_rows ||
-          trueNeighbors.n_cols != neighbors.n_cols)
-        Log::Fatal << "The true neighbors file must have the same number of "
-            << "values than the set of neighbors being queried!" << endl;
-
-      Log::Info << "Recall: " << KNN::Recall(neighbors, trueNeighbors) << endl;
-    }
-  }
+  SearchKNN<KNNModel, arma::mat>(*knn);
 
   CLI::GetParam<KNNModel*>("output_model") = knn;
 }
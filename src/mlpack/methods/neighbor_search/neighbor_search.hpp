@@ -40,7 +40,10 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  //! Dual-tree search where independent blocks of the query set are traversed
+  //! in parallel against the shared reference tree (requires OpenMP).
+  PARALLEL_DUAL_TREE_MODE
 };
 
 /**
@@ -136,6 +139,29 @@ class NeighborSearch
                  const double epsilon = 0,
                  const MetricType metric = MetricType());
 
+  /**
+   * Initialize the NeighborSearch object with the given pre-constructed
+   * reference tree, without copying it or taking ownership of it; the tree
+   * must live as long as this object uses it.  This allows one tree to be
+   * shared by several objects (for instance, a tree with a
+   * tree::MultiStatistic, which can also be given to RangeSearch and KDE).
+   * Naive mode is not available as an option for this constructor.
+   *
+   * @note
+   * As with the constructor that takes a copy of a tree, the points are not
+   * mapped back to their original indices.
+   * @endnote
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   * @param mode Neighbor search mode.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric Instantiated distance metric.
+   */
+  NeighborSearch(Tree* referenceTree,
+                 const NeighborSearchMode mode = DUAL_TREE_MODE,
+                 const double epsilon = 0,
+                 const MetricType metric = MetricType());
+
   /**
    * Create a NeighborSearch object without any reference data.  If Search() is
    * called before a reference set is set with Train(), an exception will be
@@ -207,6 +233,14 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Set the reference tree to the given tree, without copying it or taking
+   * ownership of it; the tree must live as long as this object uses it.
+   *
+   * @param referenceTree Pre-built tree for reference points.
+   */
+  void Train(Tree* referenceTree);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -273,6 +307,46 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Search for the k nearest neighbors of each query point within a budget, so
+   * that the time of each query is bounded.  Each query point traverses the
+   * reference tree best first (see tree::BestFirstSingleTreeTraverser), so
+   * that the closest nodes are visited first, until the tree is exhausted or
+   * the budget of base cases or time of the query point is spent.  The best
+   * neighbors found so far are returned; if fewer than k points were visited,
+   * the last neighbors are size_t() - 1 with distance
+   * SortPolicy::WorstDistance().
+   *
+   * For each query point, bounds holds the best distance that any of the
+   * reference points that were not visited can have (or
+   * SortPolicy::WorstDistance() if the search finished).  Each neighbor found
+   * whose distance is not worse than this bound is one of the true k nearest
+   * neighbors (within the approximation given by epsilon), so the bound tells
+   * how far the results may be from the exact ones.
+   *
+   * This can't be used in naive mode, with spill trees, or with trees that
+   * hold points in their inner nodes (like the cover tree).
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param maxBaseCases Largest number of base cases for each query point (0
+   *     for no limit).
+   * @param maxTime Largest wall clock time in seconds for each query point (0
+   *     for no limit).
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param bounds Vector storing, for each query point, the best distance of
+   *     the reference points that were not visited.
+   */
+  void AnytimeSearch(const MatType& querySet,
+                     const size_t k,
+                     const size_t maxBaseCases,
+                     const double maxTime,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     arma::vec& bounds);
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -341,6 +415,8 @@ class NeighborSearch
   Tree* referenceTree;
   //! Reference dataset.  In some situations we may be the owner of this.
   const MatType* referenceSet;
+  //! If true, we own the reference tree and must delete it.
+  bool treeOwner;
 
   //! Indicates the neighbor search mode.
   NeighborSearchMode searchMode;
@@ -359,6 +435,28 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  /**
+   * Perform dual-tree search in parallel.  The query set is split into
+   * contiguous blocks, a query tree is built on each block, and each block is
+   * traversed independently against the (read-only) reference tree, so no
+   * synchronization between threads is necessary.  Results are stored in the
+   * given matrices with respect to the (possibly rearranged) reference set;
+   * query indices are not rearranged.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param sameSet If true, the query set is the reference set, and a query
+   *     point will not return itself in the results.
+   */
+  void ParallelDualTreeSearch(const MatType& querySet,
+                              const size_t k,
+                              arma::Mat<size_t>& neighbors,
+                              arma::mat& distances,
+                              const bool sameSet);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
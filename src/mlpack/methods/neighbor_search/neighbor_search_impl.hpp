@@ -14,10 +14,15 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace neighbor {
 
@@ -63,6 +68,7 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
         BuildTree<Tree>(std::move(referenceSetIn), oldFromNewReferences)),
     referenceSet(mode == NAIVE_MODE ?  new MatType(std::move(referenceSetIn)) :
         &referenceTree->Dataset()),
+    treeOwner(true),
     searchMode(mode),
     epsilon(epsilon),
     metric(metric),
@@ -90,6 +96,7 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
                                          const MetricType metric) :
     referenceTree(new Tree(std::move(referenceTree))),
     referenceSet(&this->referenceTree->Dataset()),
+    treeOwner(true),
     searchMode(mode),
     epsilon(epsilon),
     metric(metric),
@@ -101,6 +108,37 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     throw std::invalid_argument("epsilon must be non-negative");
 }
 
+// Construct the object with a reference tree that is not owned.
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+NeighborSearch<SortPolicy, MetricType, MatType, TreeType, DualTreeTraversalType,
+SingleTreeTraversalType>::NeighborSearch(Tree* referenceTree,
+                                         const NeighborSearchMode mode,
+                                         const double epsilon,
+                                         const MetricType metric) :
+    referenceTree(referenceTree),
+    referenceSet(&referenceTree->Dataset()),
+    treeOwner(false),
+    searchMode(mode),
+    epsilon(epsilon),
+    metric(metric),
+    baseCases(0),
+    scores(0),
+    treeNeedsReset(false)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+  if (mode == NAIVE_MODE)
+    throw std::invalid_argument("cannot use a reference tree when naive "
+        "search (without trees) is desired");
+}
+
 // Construct the object without a reference dataset.
 template<typename SortPolicy,
          typename MetricType,
@@ -116,6 +154,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
                                          const MetricType metric) :
     referenceTree(NULL),
     referenceSet(new MatType()), // Empty matrix.
+    treeOwner(true),
     searchMode(mode),
     epsilon(epsilon),
     metric(metric),
@@ -149,6 +188,7 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     referenceTree(other.referenceTree ? new Tree(*other.referenceTree) : NULL),
     referenceSet(other.referenceTree ? &referenceTree->Dataset() :
         new MatType(*other.referenceSet)),
+    treeOwner(true),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
     metric(other.metric),
@@ -173,6 +213,7 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     oldFromNewReferences(std::move(other.oldFromNewReferences)),
     referenceTree(other.referenceTree),
     referenceSet(other.referenceSet),
+    treeOwner(other.treeOwner),
     searchMode(other.searchMode),
     epsilon(other.epsilon),
     metric(std::move(other.metric)),
@@ -185,6 +226,7 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.referenceTree = BuildTree<Tree>(*other.referenceSet,
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
+  other.treeOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
   other.baseCases = 0;
@@ -218,15 +260,16 @@ NeighborSearch<SortPolicy,
     return *this; // Nothing to do.
 
   // Clean memory first.
-  if (referenceTree)
-    delete referenceTree;
-  else
+  if (!referenceTree)
     delete referenceSet;
+  else if (treeOwner)
+    delete referenceTree;
 
   oldFromNewReferences = other.oldFromNewReferences;
   referenceTree = other.referenceTree ? new Tree(*other.referenceTree) : NULL;
   referenceSet = other.referenceTree ? &referenceTree->Dataset() :
       new MatType(*other.referenceSet);
+  treeOwner = true;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
   metric = other.metric;
@@ -261,14 +304,15 @@ NeighborSearch<SortPolicy,
     return *this; // Nothing to do.
 
   // Clean memory first.
-  if (referenceTree)
-    delete referenceTree;
-  else
+  if (!referenceTree)
     delete referenceSet;
+  else if (treeOwner)
+    delete referenceTree;
 
   oldFromNewReferences = std::move(other.oldFromNewReferences);
   referenceTree = other.referenceTree;
   referenceSet = other.referenceSet;
+  treeOwner = other.treeOwner;
   searchMode = other.searchMode;
   epsilon = other.epsilon;
   metric = other.metric;
@@ -280,6 +324,7 @@ NeighborSearch<SortPolicy,
   other.referenceTree = BuildTree<Tree>(*other.referenceSet,
       other.oldFromNewReferences);
   other.referenceSet = &other.referenceTree->Dataset();
+  other.treeOwner = true;
   other.searchMode = DUAL_TREE_MODE,
   other.epsilon = 0.0;
   other.baseCases = 0;
@@ -299,10 +344,10 @@ template<typename SortPolicy,
 NeighborSearch<SortPolicy, MetricType, MatType, TreeType, DualTreeTraversalType,
 SingleTreeTraversalType>::~NeighborSearch()
 {
-  if (referenceTree)
-    delete referenceTree;
-  else
+  if (!referenceTree)
     delete referenceSet;
+  else if (treeOwner)
+    delete referenceTree;
 }
 
 template<typename SortPolicy,
@@ -320,7 +365,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
   if (referenceTree)
   {
     oldFromNewReferences.clear();
-    delete referenceTree;
+    if (treeOwner)
+      delete referenceTree;
     referenceTree = NULL;
   }
   else
@@ -334,6 +380,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(MatType referenceSetIn)
     referenceTree = BuildTree<Tree>(std::move(referenceSetIn),
         oldFromNewReferences);
     referenceSet = &referenceTree->Dataset();
+    treeOwner = true;
   }
   else
   {
@@ -359,7 +406,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
   if (this->referenceTree)
   {
     oldFromNewReferences.clear();
-    delete this->referenceTree;
+    if (treeOwner)
+      delete this->referenceTree;
   }
   else
   {
@@ -368,6 +416,38 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+  treeOwner = true;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree* referenceTree)
+{
+  if (searchMode == NAIVE_MODE)
+    throw std::invalid_argument("cannot train on given reference tree when "
+        "naive search (without trees) is desired");
+
+  if (this->referenceTree)
+  {
+    oldFromNewReferences.clear();
+    if (treeOwner)
+      delete this->referenceTree;
+  }
+  else
+  {
+    delete this->referenceSet;
+  }
+
+  this->referenceTree = referenceTree;
+  this->referenceSet = &this->referenceTree->Dataset();
+  treeOwner = false;
 }
 
 /**
@@ -511,9 +591,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       // Set the value of minBaseCases.
       traverser.MinBaseCases() = k;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now have it traverse with all the points at once, so that each node
+      // is visited once per group of points that descends into it.
+      std::vector<size_t> queries(querySet.n_cols);
+      for (size_t i = 0; i < queries.size(); ++i)
+        queries[i] = i;
+      traverser.Traverse(queries, *referenceTree);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -526,9 +609,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
+    case PARALLEL_DUAL_TREE_MODE:
+    {
+      // Query indices are handled by the parallel search itself; only the
+      // reference indices may need to be mapped.
+      ParallelDualTreeSearch(querySet, k, *neighborPtr, *distancePtr, false);
+      break;
+    }
   }
 
   Timer::Stop("computing_neighbors");
+  Timer::Count("base_cases", baseCases);
+  Timer::Count("scores", scores);
 
   // Map points back to original indices, if necessary.
   if (tree::TreeTraits<Tree>::RearrangesDataset)
@@ -614,8 +706,10 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     throw std::invalid_argument(ss.str());
   }
 
-  // Make sure we are in dual-tree mode.
-  if (searchMode != DUAL_TREE_MODE)
+  // Make sure we are in dual-tree mode.  A given query tree is always
+  // traversed as a whole, so parallel dual-tree mode falls back to a single
+  // traversal here.
+  if (searchMode != DUAL_TREE_MODE && searchMode != PARALLEL_DUAL_TREE_MODE)
     throw std::invalid_argument("cannot call NeighborSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
@@ -657,6 +751,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   Log::Info << rules.BaseCases() << " base cases were calculated.\n";
 
   Timer::Stop("computing_neighbors");
+  Timer::Count("base_cases", baseCases);
+  Timer::Count("scores", scores);
 
   // Do we need to map indices?
   if (!oldFromNewReferences.empty() &&
@@ -727,23 +823,29 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // The naive brute-force solution.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
       baseCases += referenceSet->n_cols * referenceSet->n_cols;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case SINGLE_TREE_MODE:
     {
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // Create the traverser.
       SingleTreeTraversalType<RuleType> traverser(rules);
 
@@ -758,13 +860,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case DUAL_TREE_MODE:
     {
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // The dual-tree monochromatic search case may require resetting the
-      // bounds in the tree.
-      if (treeNeedsReset)
+      // bounds in the tree.  A tree we don't own may have been searched by
+      // another object, so its bounds are always reset.
+      if (treeNeedsReset || !treeOwner)
       {
         std::stack<Tree*> nodes;
         nodes.push(referenceTree);
@@ -774,7 +882,8 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           nodes.pop();
 
           // Reset bounds of this node.
-          node->Stat().Reset();
+          tree::GetStatistic<NeighborSearchStat<SortPolicy>>(
+              node->Stat()).Reset();
 
           // Then add the children.
           for (size_t i = 0; i < node->NumChildren(); ++i)
@@ -809,19 +918,27 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // Create the traverser.
       tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
 
       // Set the value of minBaseCases.
       traverser.MinBaseCases() = k;
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Now have it traverse with all the points at once, so that each node
+      // is visited once per group of points that descends into it.
+      std::vector<size_t> queries(referenceSet->n_cols);
+      for (size_t i = 0; i < queries.size(); ++i)
+        queries[i] = i;
+      traverser.Traverse(queries, *referenceTree);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -830,13 +947,23 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
+      break;
+    }
+    case PARALLEL_DUAL_TREE_MODE:
+    {
+      // The reference tree is never used as a query tree here, so its bounds
+      // do not need to be reset.
+      ParallelDualTreeSearch(*referenceSet, k, *neighborPtr, *distancePtr,
+          true);
       break;
     }
   }
 
-  rules.GetResults(*neighborPtr, *distancePtr);
-
   Timer::Stop("computing_neighbors");
+  Timer::Count("base_cases", baseCases);
+  Timer::Count("scores", scores);
 
   // Do we need to map the reference indices?
   if (!oldFromNewReferences.empty() &&
@@ -862,6 +989,199 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::AnytimeSearch(
+    const MatType& querySet,
+    const size_t k,
+    const size_t maxBaseCases,
+    const double maxTime,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    arma::vec& bounds)
+{
+  if (k > referenceSet->n_cols)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << referenceSet->n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (searchMode == NAIVE_MODE)
+    throw std::invalid_argument("cannot call NeighborSearch::AnytimeSearch() "
+        "in naive mode");
+
+  // The overlapping leaves of spill trees share points, which would be found
+  // more than once.
+  if (tree::IsSpillTree<Tree>::value)
+    throw std::invalid_argument("cannot call NeighborSearch::AnytimeSearch() "
+        "with spill trees");
+
+  if (maxTime < 0.0)
+  {
+    std::ostringstream oss;
+    oss << "NeighborSearch::AnytimeSearch(): maxTime must be non-negative "
+        << "(given " << maxTime << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("computing_neighbors");
+
+  baseCases = 0;
+  scores = 0;
+
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  RuleType rules(*referenceSet, querySet, k, metric, epsilon);
+
+  tree::BestFirstSingleTreeTraverser<Tree, RuleType> traverser(rules,
+      maxBaseCases, maxTime);
+
+  bounds.set_size(querySet.n_cols);
+  size_t unfinished = 0;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (traverser.Traverse(i, *referenceTree))
+    {
+      bounds[i] = SortPolicy::WorstDistance();
+    }
+    else
+    {
+      bounds[i] = SortPolicy::ConvertToDistance(
+          traverser.BestRemainingScore());
+      ++unfinished;
+    }
+  }
+
+  scores += rules.Scores();
+  baseCases += rules.BaseCases();
+
+  Log::Info << rules.Scores() << " node combinations were scored."
+      << std::endl;
+  Log::Info << rules.BaseCases() << " base cases were calculated."
+      << std::endl;
+  Log::Info << unfinished << " query points ran out of budget." << std::endl;
+
+  rules.GetResults(neighbors, distances);
+
+  Timer::Stop("computing_neighbors");
+  Timer::Count("base_cases", baseCases);
+  Timer::Count("scores", scores);
+
+  // Map the reference indices back, leaving the neighbors that were not found.
+  if (tree::TreeTraits<Tree>::RearrangesDataset &&
+      !oldFromNewReferences.empty())
+  {
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+      if (neighbors[i] != size_t() - 1)
+        neighbors[i] = oldFromNewReferences[neighbors[i]];
+  }
+} // AnytimeSearch()
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ParallelDualTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (querySet.n_cols == 0)
+    return;
+
+  // Use a few blocks per thread so that the dynamic schedule can balance
+  // blocks that are more expensive to traverse than others.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+  const size_t numBlocks = std::min((size_t) querySet.n_cols, 4 * numThreads);
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+
+  // When the query set is the reference set, we search for one extra neighbor
+  // and then remove the query point itself from the results.
+  const size_t searchK = sameSet ? k + 1 : k;
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalBaseCases, totalScores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    if (begin >= querySet.n_cols)
+      continue;
+    const size_t end = std::min((size_t) querySet.n_cols, begin + blockSize);
+
+    // Build the query tree for this block.
+    std::vector<size_t> oldFromNewBlock;
+    Tree* blockTree = BuildTree<Tree>(MatType(querySet.cols(begin, end - 1)),
+        oldFromNewBlock);
+
+    // Each thread gets its own copy of the metric, in case it holds state.
+    MetricType blockMetric(metric);
+    RuleType rules(*referenceSet, blockTree->Dataset(), searchK, blockMetric,
+        epsilon);
+
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*blockTree, *referenceTree);
+
+    totalBaseCases += rules.BaseCases();
+    totalScores += rules.Scores();
+
+    arma::Mat<size_t> blockNeighbors;
+    arma::mat blockDistances;
+    rules.GetResults(blockNeighbors, blockDistances);
+
+    // Copy the results into the columns owned by this block.
+    for (size_t i = 0; i < blockNeighbors.n_cols; ++i)
+    {
+      const size_t queryIndex = begin +
+          (oldFromNewBlock.empty() ? i : oldFromNewBlock[i]);
+
+      size_t j = 0;
+      for (size_t l = 0; l < searchK && j < k; ++l)
+      {
+        // Skip the query point itself (only the first time it is seen).
+        if (sameSet && j == l && blockNeighbors(l, i) == queryIndex)
+          continue;
+
+        neighbors(j, queryIndex) = blockNeighbors(l, i);
+        distances(j, queryIndex) = blockDistances(l, i);
+        ++j;
+      }
+    }
+
+    delete blockTree;
+  }
+
+  baseCases += totalBaseCases;
+  scores += totalScores;
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -966,17 +1286,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     // If we are loading, set the tree to NULL and clean up memory if necessary.
     if (Archive::is_loading::value)
     {
-      if (referenceTree)
+      if (referenceTree && treeOwner)
         delete referenceTree;
 
       referenceTree = NULL;
+      treeOwner = true;
       oldFromNewReferences.clear();
     }
   }
   else
   {
     // Delete the current reference tree, if necessary and if we are loading.
-    if (Archive::is_loading::value && referenceTree)
+    if (Archive::is_loading::value && referenceTree && treeOwner)
     {
       delete referenceTree;
     }
@@ -990,6 +1311,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     {
       referenceSet = &referenceTree->Dataset();
       metric = referenceTree->Metric(); // Get the metric from the tree.
+      treeOwner = true;
     }
   }
 
@@ -14,8 +14,12 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include <mlpack/core/tree/multi_statistic.hpp>
+#include "neighbor_search_stat.hpp"
+#include <mlpack/core/metrics/block_distances.hpp>
 
-#include <queue>
+#include <memory>
 
 namespace mlpack {
 namespace neighbor {
@@ -56,6 +60,8 @@ class NeighborSearchRules
 
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * The candidates are sorted in place and moved into the matrices, so this
+   * can only be called once.
    *
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -139,6 +145,33 @@ class NeighborSearchRules
                  TreeType& referenceNode,
                  const double oldScore) const;
 
+  /**
+   * Perform the base cases between the points of two leaves: for each query
+   * point of the query node that Score() does not prune the reference node for,
+   * the base cases with all the points of the reference node.  If the block is
+   * large enough, its distances are computed at once (see
+   * metric::BlockDistances), and only the reference points that may be
+   * inserted into the candidates are evaluated exactly, so the results do not
+   * change.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   * @return The number of base cases that were performed.
+   */
+  size_t BaseCaseBlock(TreeType& queryNode, TreeType& referenceNode);
+
+  /**
+   * Perform the base cases between each of the given query points and each
+   * point held by the reference node, computing the distances of the block at
+   * once if it is large enough, like BaseCaseBlock().
+   *
+   * @param queries Indices of the query points.
+   * @param referenceNode Reference node.
+   * @return The number of base cases that were performed.
+   */
+  size_t BaseCaseBatch(const std::vector<size_t>& queries,
+                       TreeType& referenceNode);
+
   //! Get the number of base cases that have been performed.
   size_t BaseCases() const { return baseCases; }
   //! Modify the number of base cases that have been performed.
@@ -164,23 +197,30 @@ class NeighborSearchRules
   //! The query set.
   const typename TreeType::Mat& querySet;
 
-  //! Candidate represents a possible candidate neighbor (distance, index).
-  typedef std::pair<double, size_t> Candidate;
-
-  //! Compare two candidates based on the distance.
-  struct CandidateCmp {
-    bool operator()(const Candidate& c1, const Candidate& c2)
-    {
-      return !SortPolicy::IsBetter(c2.first, c1.first);
-    };
+  /**
+   * The candidate neighbors of all the query points, in two contiguous k x
+   * nQueries matrices.  Column i of each matrix is a fixed-size binary heap of
+   * the k best candidates of query point i, with the worst candidate at the
+   * root (row 0), so that the current k'th best distance of query point i is
+   * distances(0, i).  GetResults() sorts each column in place.
+   */
+  struct CandidateStorage
+  {
+    //! The distances of the candidates.
+    arma::mat distances;
+    //! The indices of the candidates.
+    arma::Mat<size_t> neighbors;
   };
 
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
+  //! Storage of the candidate neighbors, shared by the copies of the rules
+  //! (see ParallelBreadthFirstDualTreeTraverser).
+  std::shared_ptr<CandidateStorage> candidateStorage;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! The distances of the candidate neighbors of each point (see
+  //! CandidateStorage).
+  arma::mat& candidateDistances;
+  //! The indices of the candidate neighbors of each point.
+  arma::Mat<size_t>& candidateNeighbors;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -210,6 +250,15 @@ class NeighborSearchRules
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
 
+  /**
+   * Get the neighbor search statistic of the given node.  (The tree may hold
+   * the statistics of other methods too; see tree::MultiStatistic.)
+   */
+  static NeighborSearchStat<SortPolicy>& Statistic(TreeType& node)
+  {
+    return tree::GetStatistic<NeighborSearchStat<SortPolicy>>(node.Stat());
+  }
+
   /**
    * Recalculate the bound for a given query node.
    */
@@ -225,9 +274,40 @@ class NeighborSearchRules
   void InsertNeighbor(const size_t queryIndex,
                       const size_t neighbor,
                       const double distance);
+
+  /**
+   * Insert a candidate at the root of the heap of the given size stored in the
+   * given arrays, replacing the root, and restore the heap property.
+   *
+   * @param distances Distances of the candidates of the heap.
+   * @param neighbors Indices of the candidates of the heap.
+   * @param size Number of candidates in the heap.
+   * @param neighbor Index of the candidate to insert.
+   * @param distance Distance of the candidate to insert.
+   */
+  static void SiftDown(double* distances,
+                       size_t* neighbors,
+                       const size_t size,
+                       const size_t neighbor,
+                       const double distance);
 };
 
 } // namespace neighbor
+
+namespace tree {
+
+//! NeighborSearchRules can evaluate the base cases between two leaves, or
+//! between a set of query points and a leaf, at once.
+template<typename SortPolicy, typename MetricType, typename TreeType>
+class RuleTraits<neighbor::NeighborSearchRules<SortPolicy, MetricType,
+    TreeType>>
+{
+ public:
+  static const bool HasBaseCaseBlock = true;
+  static const bool HasBaseCaseBatch = true;
+};
+
+} // namespace tree
 } // namespace mlpack
 
 // Include implementation.
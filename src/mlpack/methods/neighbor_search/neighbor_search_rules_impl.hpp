@@ -29,6 +29,9 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidateStorage(new CandidateStorage()),
+    candidateDistances(candidateStorage->distances),
+    candidateNeighbors(candidateStorage->neighbors),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -47,16 +50,12 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   // Let's build the list of candidate neighbors for each query point.
   // It will be initialized with k candidates: (WorstDistance, size_t() - 1)
   // The list of candidates will be updated when visiting new points with the
-  // BaseCase() method.
-  const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
-      size_t() - 1);
-
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
+  // BaseCase() method.  Since all the candidates are equal, each column is
+  // already a heap.
+  candidateDistances.set_size(k, querySet.n_cols);
+  candidateDistances.fill(SortPolicy::WorstDistance());
+  candidateNeighbors.set_size(k, querySet.n_cols);
+  candidateNeighbors.fill(size_t() - 1);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -64,20 +63,27 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
-  neighbors.set_size(k, querySet.n_cols);
-  distances.set_size(k, querySet.n_cols);
-
+  // Sort each heap in place: the worst candidate at the root is swapped to the
+  // end of the column, and the root is sifted down the rest of the heap.
   for (size_t i = 0; i < querySet.n_cols; i++)
   {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
+    double* columnDistances = candidateDistances.colptr(i);
+    size_t* columnNeighbors = candidateNeighbors.colptr(i);
+    for (size_t end = k; end > 1; --end)
     {
-      neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
-      pqueue.pop();
+      const size_t j = end - 1;
+      const double distance = columnDistances[j];
+      const size_t neighbor = columnNeighbors[j];
+      columnDistances[j] = columnDistances[0];
+      columnNeighbors[j] = columnNeighbors[0];
+      SiftDown(columnDistances, columnNeighbors, j, neighbor, distance);
     }
   }
-};
+
+  // The results are sorted where they are, so there is nothing to copy.
+  neighbors = std::move(candidateNeighbors);
+  distances = std::move(candidateDistances);
+}
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline force_inline // Absolutely MUST be inline so optimizations can happen.
@@ -125,12 +131,12 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
       // base case.
       if ((referenceNode.Parent() != NULL) &&
           (referenceNode.Point(0) == referenceNode.Parent()->Point(0)))
-        baseCase = referenceNode.Parent()->Stat().LastDistance();
+        baseCase = Statistic(*referenceNode.Parent()).LastDistance();
       else
         baseCase = BaseCase(queryIndex, referenceNode.Point(0));
 
       // Save this evaluation.
-      referenceNode.Stat().LastDistance() = baseCase;
+      Statistic(referenceNode).LastDistance() = baseCase;
     }
 
     distance = SortPolicy::CombineBest(baseCase,
@@ -143,7 +149,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidateDistances(0, queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ?
@@ -179,7 +185,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = candidateDistances(0, queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
@@ -363,6 +369,78 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBlock(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  // Find the query points that the reference node can't be pruned for.  The
+  // traversal info is restored before each score, as the traversers do.
+  const TraversalInfoType info = traversalInfo;
+  std::vector<size_t> queries;
+  queries.reserve(queryNode.NumPoints());
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    traversalInfo = info;
+    if (Score(queryNode.Point(i), referenceNode) != DBL_MAX)
+      queries.push_back(queryNode.Point(i));
+  }
+
+  return BaseCaseBatch(queries, referenceNode);
+}
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+size_t NeighborSearchRules<SortPolicy, MetricType, TreeType>::BaseCaseBatch(
+    const std::vector<size_t>& queries,
+    TreeType& referenceNode)
+{
+  const size_t numReferences = referenceNode.NumPoints();
+  if (!metric::BlockDistances<MetricType>::template Worthwhile<
+      typename TreeType::Mat>(queries.size(), numReferences))
+  {
+    for (size_t i = 0; i < queries.size(); ++i)
+      for (size_t j = 0; j < numReferences; ++j)
+        BaseCase(queries[i], referenceNode.Point(j));
+
+    return queries.size() * numReferences;
+  }
+
+  std::vector<size_t> references(numReferences);
+  for (size_t j = 0; j < numReferences; ++j)
+    references[j] = referenceNode.Point(j);
+
+  arma::mat distances;
+  arma::vec errors;
+  metric::BlockDistances<MetricType>::Evaluate(metric, querySet, queries,
+      referenceSet, references, distances, errors);
+  baseCases += queries.size() * numReferences;
+
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t queryIndex = queries[i];
+    for (size_t j = 0; j < numReferences; ++j)
+    {
+      const size_t referenceIndex = references[j];
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Only evaluate the distance exactly if the reference point may be
+      // inserted into the candidates.
+      const double bestDistance = SortPolicy::CombineBest(distances(i, j),
+          errors[i]);
+      if (!SortPolicy::IsBetter(bestDistance,
+          candidateDistances(0, queryIndex)))
+        continue;
+
+      InsertNeighbor(queryIndex, referenceIndex,
+          metric.Evaluate(querySet.col(queryIndex),
+                          referenceSet.col(referenceIndex)));
+    }
+  }
+
+  return queries.size() * numReferences;
+}
+
 // Calculate the bound for a given query node in its current state and update
 // it.
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -404,7 +482,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance = candidateDistances(0, queryNode.Point(i));
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -417,8 +495,8 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // assemble bounds.
   for (size_t i = 0; i < queryNode.NumChildren(); ++i)
   {
-    const double firstBound = queryNode.Child(i).Stat().FirstBound();
-    const double auxBound = queryNode.Child(i).Stat().AuxBound();
+    const double firstBound = Statistic(queryNode.Child(i)).FirstBound();
+    const double auxBound = Statistic(queryNode.Child(i)).AuxBound();
 
     if (SortPolicy::IsBetter(worstDistance, firstBound))
       worstDistance = firstBound;
@@ -450,28 +528,28 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
     // The parent's worst distance bound implies that the bound for this node
     // must be at least as good.  Thus, if the parent worst distance bound is
     // better, then take it.
-    if (SortPolicy::IsBetter(queryNode.Parent()->Stat().FirstBound(),
+    if (SortPolicy::IsBetter(Statistic(*queryNode.Parent()).FirstBound(),
         worstDistance))
-      worstDistance = queryNode.Parent()->Stat().FirstBound();
+      worstDistance = Statistic(*queryNode.Parent()).FirstBound();
 
     // The parent's best distance bound implies that the bound for this node
     // must be at least as good.  Thus, if the parent best distance bound is
     // better, then take it.
-    if (SortPolicy::IsBetter(queryNode.Parent()->Stat().SecondBound(),
+    if (SortPolicy::IsBetter(Statistic(*queryNode.Parent()).SecondBound(),
         bestDistance))
-      bestDistance = queryNode.Parent()->Stat().SecondBound();
+      bestDistance = Statistic(*queryNode.Parent()).SecondBound();
   }
 
   // Could the existing bounds be better?
-  if (SortPolicy::IsBetter(queryNode.Stat().FirstBound(), worstDistance))
-    worstDistance = queryNode.Stat().FirstBound();
-  if (SortPolicy::IsBetter(queryNode.Stat().SecondBound(), bestDistance))
-    bestDistance = queryNode.Stat().SecondBound();
+  if (SortPolicy::IsBetter(Statistic(queryNode).FirstBound(), worstDistance))
+    worstDistance = Statistic(queryNode).FirstBound();
+  if (SortPolicy::IsBetter(Statistic(queryNode).SecondBound(), bestDistance))
+    bestDistance = Statistic(queryNode).SecondBound();
 
   // Cache bounds for later.
-  queryNode.Stat().FirstBound() = worstDistance;
-  queryNode.Stat().SecondBound() = bestDistance;
-  queryNode.Stat().AuxBound() = auxDistance;
+  Statistic(queryNode).FirstBound() = worstDistance;
+  Statistic(queryNode).SecondBound() = bestDistance;
+  Statistic(queryNode).AuxBound() = auxDistance;
 
   worstDistance = SortPolicy::Relax(worstDistance, epsilon);
 
@@ -499,14 +577,44 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
+  // Replace the worst candidate at the root of the heap if the new point is
+  // not worse.
+  double* columnDistances = candidateDistances.colptr(queryIndex);
+  if (!SortPolicy::IsBetter(columnDistances[0], distance))
+  {
+    SiftDown(columnDistances, candidateNeighbors.colptr(queryIndex), k,
+        neighbor, distance);
+  }
+}
 
-  if (CandidateCmp()(c, pqueue.top()))
+template<typename SortPolicy, typename MetricType, typename TreeType>
+inline void NeighborSearchRules<SortPolicy, MetricType, TreeType>::SiftDown(
+    double* distances,
+    size_t* neighbors,
+    const size_t size,
+    const size_t neighbor,
+    const double distance)
+{
+  // Move the worse child up while it is worse than the new candidate.
+  size_t position = 0;
+  size_t child = 1;
+  while (child < size)
   {
-    pqueue.pop();
-    pqueue.push(c);
+    if (child + 1 < size &&
+        SortPolicy::IsBetter(distances[child], distances[child + 1]))
+      ++child;
+
+    if (!SortPolicy::IsBetter(distance, distances[child]))
+      break;
+
+    distances[position] = distances[child];
+    neighbors[position] = neighbors[child];
+    position = child;
+    child = 2 * position + 1;
   }
+
+  distances[position] = distance;
+  neighbors[position] = neighbor;
 }
 
 } // namespace neighbor
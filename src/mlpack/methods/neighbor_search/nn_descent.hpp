@@ -0,0 +1,185 @@
+/**
+ * @file nn_descent.hpp
+ *
+ * Defines the NNDescent class, which builds an approximate k-nearest-neighbor
+ * graph of a dataset.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The NNDescent class computes an approximate k-nearest-neighbor graph of a
+ * dataset (the k nearest neighbors of every point of the dataset, other than
+ * the point itself) with the NN-Descent algorithm:
+ *
+ * @code
+ * @inproceedings{dong2011efficient,
+ *   title={Efficient k-nearest neighbor graph construction for generic
+ *       similarity measures},
+ *   author={Dong, Wei and Charikar, Moses and Li, Kai},
+ *   booktitle={Proceedings of the 20th International Conference on World Wide
+ *       Web},
+ *   pages={577--586},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The graph starts from random neighbors (or from the leaves of a few random
+ * projection trees, if rpTrees is nonzero), and each iteration compares the
+ * neighbors of each point with each other ("a neighbor of a neighbor is likely
+ * to be a neighbor"); only the pairs that involve a neighbor that changed since
+ * the last iteration are compared.  The iterations stop once fewer than
+ * delta * k * n neighbors change in an iteration.  The comparisons are done in
+ * parallel with OpenMP.
+ *
+ * The results have the same format as NeighborSearch::Search(), so the quality
+ * of the graph can be measured with NeighborSearch::Recall().
+ *
+ * @code
+ * NNDescent<> nnd;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * nnd.Compute(dataset, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class NNDescent
+{
+ public:
+  /**
+   * Create the NNDescent object.
+   *
+   * @param maxIterations Maximum number of iterations.
+   * @param sampleRate Fraction of the k neighbors of each point that are
+   *     compared in each iteration (in (0, 1]).
+   * @param delta The iterations stop once fewer than delta * k * n neighbors
+   *     change.
+   * @param rpTrees Number of random projection trees to initialize the graph
+   *     with (if 0, random neighbors are used).
+   * @param leafSize Leaf size of the random projection trees.
+   * @param metric Instantiated metric.
+   */
+  NNDescent(const size_t maxIterations = 20,
+            const double sampleRate = 0.5,
+            const double delta = 0.001,
+            const size_t rpTrees = 0,
+            const size_t leafSize = 20,
+            const MetricType metric = MetricType());
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the dataset.
+   * Each column of neighbors and distances holds the k neighbors of a point,
+   * sorted by distance.  The dataset must have more than k points.
+   *
+   * @param dataset Set of points.
+   * @param k Number of neighbors of each point.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Compute(const MatType& dataset,
+               const size_t k,
+               arma::Mat<size_t>& neighbors,
+               arma::mat& distances);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the sample rate.
+  double SampleRate() const { return sampleRate; }
+  //! Modify the sample rate.
+  double& SampleRate() { return sampleRate; }
+
+  //! Get the termination threshold.
+  double Delta() const { return delta; }
+  //! Modify the termination threshold.
+  double& Delta() { return delta; }
+
+  //! Get the number of random projection trees used for initialization.
+  size_t RPTrees() const { return rpTrees; }
+  //! Modify the number of random projection trees used for initialization.
+  size_t& RPTrees() { return rpTrees; }
+
+  //! Get the leaf size of the random projection trees.
+  size_t LeafSize() const { return leafSize; }
+  //! Modify the leaf size of the random projection trees.
+  size_t& LeafSize() { return leafSize; }
+
+  //! Get the number of iterations of the last call to Compute().
+  size_t Iterations() const { return iterations; }
+  //! Get the number of distance evaluations of the last call to Compute().
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Get the metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! The type of the random projection trees.
+  typedef tree::MaxRPTree<MetricType, tree::EmptyStatistic, MatType> Tree;
+
+  /**
+   * Insert the given candidate into the sorted neighbors of the given point,
+   * if it is closer than the current k'th neighbor and not already there.
+   * Inserted neighbors are marked as new.  Return true if it was inserted.
+   */
+  static bool Insert(const size_t point,
+                     const size_t candidate,
+                     const double distance,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances,
+                     std::vector<char>& isNew);
+
+  //! Collect the leaves of the given tree.
+  static void CollectLeaves(Tree& node, std::vector<Tree*>& leaves);
+
+  //! Initialize the graph with the leaves of random projection trees.
+  void InitializeTrees(const MatType& dataset,
+                       arma::Mat<size_t>& neighbors,
+                       arma::mat& distances,
+                       std::vector<char>& isNew);
+
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Fraction of the neighbors compared in each iteration.
+  double sampleRate;
+  //! Termination threshold.
+  double delta;
+  //! Number of random projection trees used for initialization.
+  size_t rpTrees;
+  //! Leaf size of the random projection trees.
+  size_t leafSize;
+  //! Instantiated metric.
+  MetricType metric;
+
+  //! Number of iterations of the last call to Compute().
+  size_t iterations;
+  //! Number of distance evaluations of the last call to Compute().
+  size_t distanceEvaluations;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "nn_descent_impl.hpp"
+
+#endif
@@ -0,0 +1,367 @@
+/**
+ * @file nn_descent_impl.hpp
+ *
+ * Implementation of the NNDescent class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NN_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "nn_descent.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+NNDescent<MetricType, MatType>::NNDescent(const size_t maxIterations,
+                                          const double sampleRate,
+                                          const double delta,
+                                          const size_t rpTrees,
+                                          const size_t leafSize,
+                                          const MetricType metric) :
+    maxIterations(maxIterations),
+    sampleRate(sampleRate),
+    delta(delta),
+    rpTrees(rpTrees),
+    leafSize(leafSize),
+    metric(metric),
+    iterations(0),
+    distanceEvaluations(0)
+{
+  if (sampleRate <= 0.0 || sampleRate > 1.0)
+  {
+    std::ostringstream oss;
+    oss << "NNDescent::NNDescent(): sample rate must be in (0, 1] (given "
+        << sampleRate << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::Compute(const MatType& dataset,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  const size_t n = dataset.n_cols;
+  if (k == 0 || k >= n)
+  {
+    std::ostringstream oss;
+    oss << "NNDescent::Compute(): k must be between 1 and the number of "
+        << "points minus one (" << n - 1 << "), but is " << k << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, n);
+  neighbors.fill(n);
+  distances.set_size(k, n);
+  distances.fill(DBL_MAX);
+  std::vector<char> isNew(k * n, 0);
+  distanceEvaluations = 0;
+
+  if (rpTrees > 0)
+    InitializeTrees(dataset, neighbors, distances, isNew);
+
+  // Fill the remaining neighbors at random.
+  for (size_t i = 0; i < n; ++i)
+  {
+    while (distances(k - 1, i) == DBL_MAX)
+    {
+      const size_t candidate = (size_t) math::RandInt(n);
+      if (candidate == i)
+        continue;
+
+      const double distance = metric.Evaluate(dataset.col(i),
+          dataset.col(candidate));
+      ++distanceEvaluations;
+      Insert(i, candidate, distance, neighbors, distances, isNew);
+    }
+  }
+
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  numThreads = omp_get_max_threads();
+  #endif
+  std::vector<MetricType> metrics(numThreads, metric);
+
+  // A point in new[i] is a neighbor of i (or i is its neighbor) that changed
+  // since the last iteration; the pairs that only involve points of old[i]
+  // were already compared.
+  const size_t sampleSize = std::max((size_t) 1, (size_t) (sampleRate * k));
+  std::vector<std::vector<size_t>> newCandidates(n), oldCandidates(n);
+  std::vector<std::vector<size_t>> newReverse(n), oldReverse(n);
+
+  // The updates of the graph (point, candidate, distance) are buffered while
+  // the neighbors of a block of points are compared in parallel.
+  typedef std::tuple<size_t, size_t, double> Update;
+  const size_t blockSize = 4096;
+
+  for (iterations = 0; iterations < maxIterations; )
+  {
+    for (size_t i = 0; i < n; ++i)
+    {
+      newCandidates[i].clear();
+      oldCandidates[i].clear();
+      newReverse[i].clear();
+      oldReverse[i].clear();
+    }
+
+    // Sample the new neighbors of each point; they become old.
+    for (size_t i = 0; i < n; ++i)
+    {
+      std::vector<size_t> fresh;
+      for (size_t j = 0; j < k; ++j)
+      {
+        if (isNew[i * k + j])
+          fresh.push_back(j);
+        else
+          oldCandidates[i].push_back(neighbors(j, i));
+      }
+
+      if (fresh.size() > sampleSize)
+      {
+        std::shuffle(fresh.begin(), fresh.end(), math::randGen);
+        fresh.resize(sampleSize);
+      }
+
+      for (size_t j = 0; j < fresh.size(); ++j)
+      {
+        newCandidates[i].push_back(neighbors(fresh[j], i));
+        isNew[i * k + fresh[j]] = 0;
+      }
+    }
+
+    // Add a sample of the reverse neighbors.
+    for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < newCandidates[i].size(); ++j)
+        newReverse[newCandidates[i][j]].push_back(i);
+      for (size_t j = 0; j < oldCandidates[i].size(); ++j)
+        oldReverse[oldCandidates[i][j]].push_back(i);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (newReverse[i].size() > sampleSize)
+      {
+        std::shuffle(newReverse[i].begin(), newReverse[i].end(),
+            math::randGen);
+        newReverse[i].resize(sampleSize);
+      }
+      if (oldReverse[i].size() > sampleSize)
+      {
+        std::shuffle(oldReverse[i].begin(), oldReverse[i].end(),
+            math::randGen);
+        oldReverse[i].resize(sampleSize);
+      }
+
+      newCandidates[i].insert(newCandidates[i].end(), newReverse[i].begin(),
+          newReverse[i].end());
+      std::sort(newCandidates[i].begin(), newCandidates[i].end());
+      newCandidates[i].erase(std::unique(newCandidates[i].begin(),
+          newCandidates[i].end()), newCandidates[i].end());
+
+      oldCandidates[i].insert(oldCandidates[i].end(), oldReverse[i].begin(),
+          oldReverse[i].end());
+      std::sort(oldCandidates[i].begin(), oldCandidates[i].end());
+      oldCandidates[i].erase(std::unique(oldCandidates[i].begin(),
+          oldCandidates[i].end()), oldCandidates[i].end());
+    }
+
+    // Compare the candidates of each point with each other.
+    size_t changes = 0;
+    size_t evaluations = 0;
+    for (size_t begin = 0; begin < n; begin += blockSize)
+    {
+      const size_t end = std::min(n, begin + blockSize);
+      std::vector<std::vector<Update>> threadUpdates(numThreads);
+
+      #pragma omp parallel for schedule(dynamic, 16) reduction(+:evaluations)
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
+      {
+        size_t threadId = 0;
+        #ifdef HAS_OPENMP
+        threadId = omp_get_thread_num();
+        #endif
+
+        const std::vector<size_t>& fresh = newCandidates[i];
+        const std::vector<size_t>& stale = oldCandidates[i];
+        std::vector<Update>& updates = threadUpdates[threadId];
+
+        // The graph is not modified during the comparisons, so it can be read
+        // to discard the candidates that are too far.
+        auto compare = [&](const size_t a, const size_t b)
+        {
+          const double distance = metrics[threadId].Evaluate(dataset.col(a),
+              dataset.col(b));
+          ++evaluations;
+          if (distance < distances(k - 1, a))
+            updates.push_back(Update(a, b, distance));
+          if (distance < distances(k - 1, b))
+            updates.push_back(Update(b, a, distance));
+        };
+
+        for (size_t a = 0; a < fresh.size(); ++a)
+        {
+          for (size_t b = a + 1; b < fresh.size(); ++b)
+            compare(fresh[a], fresh[b]);
+          for (size_t b = 0; b < stale.size(); ++b)
+            if (fresh[a] != stale[b])
+              compare(fresh[a], stale[b]);
+        }
+      }
+
+      // Group the updates by point, so that each point is updated by one
+      // thread.
+      std::vector<Update> updates;
+      for (size_t t = 0; t < numThreads; ++t)
+      {
+        updates.insert(updates.end(), threadUpdates[t].begin(),
+            threadUpdates[t].end());
+      }
+      std::sort(updates.begin(), updates.end());
+
+      std::vector<size_t> groups;
+      for (size_t u = 0; u < updates.size(); ++u)
+        if (u == 0 || std::get<0>(updates[u]) != std::get<0>(updates[u - 1]))
+          groups.push_back(u);
+      groups.push_back(updates.size());
+
+      #pragma omp parallel for schedule(dynamic, 64) reduction(+:changes)
+      for (omp_size_t g = 0; g < (omp_size_t) groups.size() - 1; ++g)
+      {
+        for (size_t u = groups[g]; u < groups[g + 1]; ++u)
+        {
+          if (Insert(std::get<0>(updates[u]), std::get<1>(updates[u]),
+              std::get<2>(updates[u]), neighbors, distances, isNew))
+            ++changes;
+        }
+      }
+    }
+
+    distanceEvaluations += evaluations;
+    ++iterations;
+
+    MLPACK_LOG_INFO << "NNDescent::Compute(): iteration " << iterations << ", "
+        << changes << " neighbors changed." << std::endl;
+
+    if (changes <= delta * k * n)
+      break;
+  }
+}
+
+template<typename MetricType, typename MatType>
+bool NNDescent<MetricType, MatType>::Insert(const size_t point,
+                                            const size_t candidate,
+                                            const double distance,
+                                            arma::Mat<size_t>& neighbors,
+                                            arma::mat& distances,
+                                            std::vector<char>& isNew)
+{
+  const size_t k = neighbors.n_rows;
+  if (distance >= distances(k - 1, point))
+    return false;
+
+  for (size_t j = 0; j < k; ++j)
+    if (neighbors(j, point) == candidate)
+      return false;
+
+  // Shift the farther neighbors down.
+  size_t j = k - 1;
+  while (j > 0 && distances(j - 1, point) > distance)
+  {
+    neighbors(j, point) = neighbors(j - 1, point);
+    distances(j, point) = distances(j - 1, point);
+    isNew[point * k + j] = isNew[point * k + j - 1];
+    --j;
+  }
+
+  neighbors(j, point) = candidate;
+  distances(j, point) = distance;
+  isNew[point * k + j] = 1;
+  return true;
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::CollectLeaves(Tree& node,
+                                                   std::vector<Tree*>& leaves)
+{
+  if (node.IsLeaf())
+  {
+    leaves.push_back(&node);
+    return;
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CollectLeaves(node.Child(i), leaves);
+}
+
+template<typename MetricType, typename MatType>
+void NNDescent<MetricType, MatType>::InitializeTrees(
+    const MatType& dataset,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    std::vector<char>& isNew)
+{
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  numThreads = omp_get_max_threads();
+  #endif
+  std::vector<MetricType> metrics(numThreads, metric);
+
+  size_t evaluations = 0;
+  for (size_t t = 0; t < rpTrees; ++t)
+  {
+    // Each tree splits along different random directions.
+    std::vector<size_t> oldFromNew;
+    Tree tree(dataset, oldFromNew, leafSize);
+
+    std::vector<Tree*> leaves;
+    CollectLeaves(tree, leaves);
+
+    // The leaves hold disjoint sets of points, so each list of neighbors is
+    // only modified by one thread.
+    #pragma omp parallel for schedule(dynamic) reduction(+:evaluations)
+    for (omp_size_t l = 0; l < (omp_size_t) leaves.size(); ++l)
+    {
+      size_t threadId = 0;
+      #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+      #endif
+
+      const size_t begin = leaves[l]->Begin();
+      const size_t end = begin + leaves[l]->Count();
+      for (size_t i = begin; i < end; ++i)
+      {
+        for (size_t j = i + 1; j < end; ++j)
+        {
+          const double distance = metrics[threadId].Evaluate(
+              tree.Dataset().col(i), tree.Dataset().col(j));
+          ++evaluations;
+          Insert(oldFromNew[i], oldFromNew[j], distance, neighbors, distances,
+              isNew);
+          Insert(oldFromNew[j], oldFromNew[i], distance, neighbors, distances,
+              isNew);
+        }
+      }
+    }
+  }
+
+  distanceEvaluations += evaluations;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
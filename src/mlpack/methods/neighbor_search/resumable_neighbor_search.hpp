@@ -0,0 +1,226 @@
+/**
+ * @file resumable_neighbor_search.hpp
+ *
+ * Defines the ResumableNeighborSearch class, which returns the neighbors of
+ * query points a batch at a time, without restarting the search for each
+ * batch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_RESUMABLE_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_RESUMABLE_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
+#include "neighbor_search.hpp"
+
+#include <queue>
+#include <unordered_set>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ResumableNeighborSearch class finds the neighbors of each query point in
+ * order, a batch at a time: after the first k neighbors of a query point are
+ * returned, the next ones can be asked for without searching again for the
+ * first k.  This is useful when the number of neighbors needed is not known in
+ * advance (for instance, when some neighbors may be filtered out afterwards).
+ *
+ * Each query point keeps the frontier of an incremental best-first traversal
+ * of the reference tree (Hjaltason and Samet, 1999): a priority queue of the
+ * tree nodes that have not been visited yet, keyed by the best possible
+ * distance between the query point and the node, and of the reference points
+ * whose distances were calculated but are not returned yet.  A neighbor is
+ * returned when it is at the front of the queue, since nothing left in the
+ * queue can be better; so every node and every base case is visited at most
+ * once over all batches, and the work for the first k neighbors is never
+ * repeated.
+ *
+ * @code
+ * ResumableNeighborSearch<NearestNeighborSort> knn(referenceSet);
+ * knn.Start(querySet);
+ *
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Next(10, neighbors, distances); // Neighbors 1 to 10.
+ * knn.Next(40, neighbors, distances); // Neighbors 11 to 50.
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class ResumableNeighborSearch
+{
+ public:
+  //! The type of the reference tree.
+  typedef TreeType<MetricType, NeighborSearchStat<SortPolicy>, MatType> Tree;
+
+  /**
+   * Build the reference tree on the given reference set.  The matrix is moved
+   * into the tree (and rearranged, for trees that rearrange their dataset);
+   * pass std::move(referenceSet) to avoid a copy.
+   *
+   * @param referenceSet Set of reference points.
+   * @param metric An optional instance of the MetricType class.
+   */
+  ResumableNeighborSearch(MatType referenceSet,
+                          const MetricType metric = MetricType());
+
+  //! Copying would share the reference tree, so it is not allowed.
+  ResumableNeighborSearch(const ResumableNeighborSearch&) = delete;
+  //! Copying would share the reference tree, so it is not allowed.
+  ResumableNeighborSearch& operator=(const ResumableNeighborSearch&) = delete;
+
+  //! Delete the reference tree.
+  ~ResumableNeighborSearch();
+
+  /**
+   * Start new searches for the given query points, forgetting the previous
+   * ones.  No distances are calculated until Next() is called.
+   *
+   * @param querySet Set of query points.
+   */
+  void Start(const MatType& querySet);
+
+  /**
+   * Find the next k neighbors of each query point: the neighbors that follow
+   * the ones returned by the previous calls since Start().  The indices of the
+   * neighbors (in the reference set given to the constructor) are stored in
+   * the neighbors matrix, and the distances in the distances matrix, one
+   * column for each query point, from the best neighbor to the worst.  When
+   * fewer than k reference points are left, the remaining elements are
+   * size_t(-1) and SortPolicy::WorstDistance().  The query points are
+   * processed in parallel.
+   *
+   * @param k Number of neighbors to find for each query point.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances of the neighbors in.
+   */
+  void Next(const size_t k,
+            arma::Mat<size_t>& neighbors,
+            arma::mat& distances);
+
+  /**
+   * Find the next k neighbors of the given query point only.
+   *
+   * @param query Index of the query point (in the query set given to
+   *     Start()).
+   * @param k Number of neighbors to find.
+   * @param neighbors Vector to store the indices of the neighbors in.
+   * @param distances Vector to store the distances of the neighbors in.
+   */
+  void Next(const size_t query,
+            const size_t k,
+            arma::Col<size_t>& neighbors,
+            arma::vec& distances);
+
+  //! Get the number of neighbors returned so far for the given query point.
+  size_t NumReturned(const size_t query) const
+  {
+    return searches[query].numReturned;
+  }
+
+  //! Get the number of query points.
+  size_t NumQueries() const { return querySet.n_cols; }
+
+  //! Get the number of distance calculations since Start().
+  size_t BaseCases() const;
+
+  //! Get the number of node distance bounds calculated since Start().
+  size_t Scores() const;
+
+  //! Access the reference tree.
+  const Tree& ReferenceTree() const { return *referenceTree; }
+
+ private:
+  /**
+   * An element of the frontier of a search: either a node of the reference
+   * tree that was not visited yet, or a reference point that was not returned
+   * yet, with the best possible distance to the query point.
+   */
+  struct Candidate
+  {
+    //! The best possible distance (the distance, for a point).
+    double distance;
+    //! The node, or NULL for a point.
+    const Tree* node;
+    //! The index of the point in the reference tree's dataset.
+    size_t point;
+  };
+
+  //! Order the candidates so that the best one is at the top of the queue.
+  struct CandidateCompare
+  {
+    bool operator()(const Candidate& a, const Candidate& b) const
+    {
+      if (a.distance != b.distance)
+        return SortPolicy::IsBetter(b.distance, a.distance);
+
+      // At equal distances, points are returned before nodes are visited, and
+      // points are in the order of the tree's dataset.
+      if ((a.node == NULL) != (b.node == NULL))
+        return (a.node != NULL);
+      return (a.point > b.point);
+    }
+  };
+
+  //! The state of the search for one query point.
+  struct QueryState
+  {
+    QueryState() : numReturned(0), baseCases(0), scores(0) { }
+
+    //! The frontier of the traversal.
+    std::priority_queue<Candidate, std::vector<Candidate>, CandidateCompare>
+        frontier;
+    //! The reference points returned so far, for trees that have duplicated
+    //! points.
+    std::unordered_set<size_t> returned;
+    //! The number of neighbors returned so far.
+    size_t numReturned;
+    //! The number of distance calculations.
+    size_t baseCases;
+    //! The number of node distance bounds calculated.
+    size_t scores;
+  };
+
+  /**
+   * Find the next k neighbors of the given query point, and store them in the
+   * given arrays (which must hold k elements).
+   */
+  void NextNeighbors(const size_t query,
+                     const size_t k,
+                     size_t* neighbors,
+                     double* distances);
+
+  //! Permutations of reference points during tree building.
+  std::vector<size_t> oldFromNewReferences;
+  //! The reference tree.
+  Tree* referenceTree;
+  //! Instantiation of metric.
+  MetricType metric;
+
+  //! The query points.
+  MatType querySet;
+  //! The state of the search of each query point.
+  std::vector<QueryState> searches;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "resumable_neighbor_search_impl.hpp"
+
+#endif
@@ -0,0 +1,221 @@
+/**
+ * @file resumable_neighbor_search_impl.hpp
+ *
+ * Implementation of the ResumableNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_RESUMABLE_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_RESUMABLE_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "resumable_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ResumableNeighborSearch(MatType referenceSet, const MetricType metric) :
+    referenceTree(BuildTree<Tree>(std::move(referenceSet),
+        oldFromNewReferences)),
+    metric(metric)
+{
+  // Nothing to do.
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+~ResumableNeighborSearch()
+{
+  delete referenceTree;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Start(
+    const MatType& querySetIn)
+{
+  querySet = querySetIn;
+  searches.clear();
+  searches.resize(querySet.n_cols);
+
+  // The root has to be visited first anyway, so its distance is not needed.
+  for (size_t i = 0; i < searches.size(); ++i)
+  {
+    const Candidate root = { SortPolicy::BestDistance(), referenceTree, 0 };
+    searches[i].frontier.push(root);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Next(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // The searches of the query points are independent.
+  ParallelFor(0, querySet.n_cols, [&](const size_t query)
+  {
+    NextNeighbors(query, k, neighbors.colptr(query), distances.colptr(query));
+  });
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Next(
+    const size_t query,
+    const size_t k,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  if (query >= querySet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "ResumableNeighborSearch::Next(): invalid query point " << query
+        << " (there are " << querySet.n_cols << " query points)";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k);
+  distances.set_size(k);
+  NextNeighbors(query, k, neighbors.memptr(), distances.memptr());
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+BaseCases() const
+{
+  size_t baseCases = 0;
+  for (size_t i = 0; i < searches.size(); ++i)
+    baseCases += searches[i].baseCases;
+  return baseCases;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Scores() const
+{
+  size_t scores = 0;
+  for (size_t i = 0; i < searches.size(); ++i)
+    scores += searches[i].scores;
+  return scores;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ResumableNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+NextNeighbors(const size_t query,
+              const size_t k,
+              size_t* neighbors,
+              double* distances)
+{
+  QueryState& state = searches[query];
+  size_t found = 0;
+  while (found < k && !state.frontier.empty())
+  {
+    const Candidate candidate = state.frontier.top();
+    state.frontier.pop();
+
+    // Nothing left in the frontier can be better than a point at its front,
+    // so the point is the next neighbor.
+    if (candidate.node == NULL)
+    {
+      // A point may be in more than one leaf of some trees (like spill trees).
+      if (tree::TreeTraits<Tree>::HasDuplicatedPoints &&
+          !state.returned.insert(candidate.point).second)
+        continue;
+
+      neighbors[found] = oldFromNewReferences.empty() ? candidate.point :
+          oldFromNewReferences[candidate.point];
+      distances[found] = candidate.distance;
+      ++found;
+      continue;
+    }
+
+    const Tree& node = *candidate.node;
+    if (node.NumChildren() == 0)
+    {
+      // Only the points of leaves are used: in trees with self-children, the
+      // points of the other nodes are also held by their descendants.
+      for (size_t i = 0; i < node.NumPoints(); ++i)
+      {
+        const size_t point = node.Point(i);
+        const Candidate pointCandidate = { metric.Evaluate(
+            querySet.col(query), referenceTree->Dataset().col(point)), NULL,
+            point };
+        state.frontier.push(pointCandidate);
+      }
+      state.baseCases += node.NumPoints();
+    }
+    else
+    {
+      for (size_t i = 0; i < node.NumChildren(); ++i)
+      {
+        const Tree* child = &node.Child(i);
+        const Candidate childCandidate = {
+            SortPolicy::BestPointToNodeDistance(querySet.col(query), child),
+            child, 0 };
+        state.frontier.push(childCandidate);
+      }
+      state.scores += node.NumChildren();
+    }
+  }
+
+  state.numReturned += found;
+
+  // Fill the rest if there are no more reference points.
+  for (; found < k; ++found)
+  {
+    neighbors[found] = size_t(-1);
+    distances[found] = SortPolicy::WorstDistance();
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
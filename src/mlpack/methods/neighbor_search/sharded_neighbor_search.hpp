@@ -0,0 +1,211 @@
+/**
+ * @file sharded_neighbor_search.hpp
+ *
+ * Defines the ShardedNeighborSearch class, which performs neighbor searches on
+ * a reference set split into shards, each with its own tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ShardedNeighborSearch class performs k-nearest-neighbor (or
+ * k-furthest-neighbor) searches on a reference set that is split into shards.
+ * Each shard has its own tree and NeighborSearch object, so a shard only needs
+ * its own points to be built; the query points are searched in every shard,
+ * and the k best results of each shard are merged.
+ *
+ * The merge of the results of two sets of shards is done by MergeResults(),
+ * which is associative and commutative: the per-shard results can be reduced
+ * in any order (for instance, by a tree reduction across the processes that
+ * own the shards), and the result is the same as a search on the whole
+ * reference set.
+ *
+ * The index of a reference point is its index in the concatenation of the
+ * shards, in the order they were added.
+ *
+ * @code
+ * ShardedNeighborSearch<NearestNeighborSort> knn;
+ * knn.AddShard(shard0); // Points 0, ..., shard0.n_cols - 1.
+ * knn.AddShard(shard1); // Points shard0.n_cols, ...
+ *
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(queries, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class ShardedNeighborSearch
+{
+ public:
+  //! The type of the search of each shard.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType>
+      NeighborSearchType;
+  //! The type of the tree of each shard.
+  typedef typename NeighborSearchType::Tree Tree;
+
+  /**
+   * Create the ShardedNeighborSearch object with no shards.
+   *
+   * @param mode Neighbor search mode of the search of each shard.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric Instantiated metric.
+   */
+  ShardedNeighborSearch(const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const MetricType metric = MetricType());
+
+  /**
+   * Split the given reference set into the given number of shards of
+   * contiguous points (of about equal sizes), and build the search of each.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numShards Number of shards.
+   * @param mode Neighbor search mode of the search of each shard.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric Instantiated metric.
+   */
+  ShardedNeighborSearch(const MatType& referenceSet,
+                        const size_t numShards,
+                        const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const MetricType metric = MetricType());
+
+  //! Copying would share the searches of the shards, so it is not allowed.
+  ShardedNeighborSearch(const ShardedNeighborSearch&) = delete;
+  //! Copying would share the searches of the shards, so it is not allowed.
+  ShardedNeighborSearch& operator=(const ShardedNeighborSearch&) = delete;
+
+  //! Delete the searches of each shard.
+  ~ShardedNeighborSearch();
+
+  /**
+   * Add a shard with the given points, and build its search.  The indices of
+   * the points are consecutive, starting from the returned one.
+   *
+   * @param shard Points of the shard.
+   * @return Index of the first point of the shard.
+   */
+  size_t AddShard(MatType shard);
+
+  /**
+   * For each point in the query set, find the k best neighbors in the
+   * reference set, by searching every shard and merging the results.  The
+   * results have the same format as NeighborSearch::Search().
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances of the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * For each point in the reference set, find its k best neighbors in the
+   * reference set (other than itself).
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances of the neighbors in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Merge the results of a search in some reference points (other) into the
+   * results of a search in other reference points (neighbors and distances),
+   * keeping the best neighbors of each query point.  Both must have the same
+   * size; missing neighbors have the index size_t(-1) and the distance
+   * SortPolicy::WorstDistance().
+   *
+   * @param neighbors Neighbors to merge into.
+   * @param distances Distances to merge into.
+   * @param otherNeighbors Neighbors to merge.
+   * @param otherDistances Distances to merge.
+   */
+  static void MergeResults(arma::Mat<size_t>& neighbors,
+                           arma::mat& distances,
+                           const arma::Mat<size_t>& otherNeighbors,
+                           const arma::mat& otherDistances);
+
+  //! Get the number of shards.
+  size_t NumShards() const { return shards.size(); }
+  //! Get the number of points in the reference set.
+  size_t NumPoints() const { return numPoints; }
+  //! Get the number of points in the given shard.
+  size_t ShardSize(const size_t shard) const
+  {
+    return shards[shard].indices.n_elem;
+  }
+  //! Get the search of the given shard.
+  const NeighborSearchType& Shard(const size_t shard) const
+  {
+    return *shards[shard].search;
+  }
+
+ private:
+  //! A shard of the reference set.
+  struct ShardInfo
+  {
+    //! The search on the points of the shard.
+    NeighborSearchType* search;
+    //! The index of each point of the shard, in the order of the search.
+    arma::Col<size_t> indices;
+  };
+
+  /**
+   * Convert the results of a search in a shard (the first columns of
+   * shardNeighbors are the results) into results with k rows and reference
+   * set indices, padded with missing neighbors.
+   */
+  void ConvertResults(const ShardInfo& shard,
+                      const size_t k,
+                      const arma::Mat<size_t>& shardNeighbors,
+                      const arma::mat& shardDistances,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) const;
+
+  //! The mode of the searches.
+  NeighborSearchMode mode;
+  //! The approximation error of the searches.
+  double epsilon;
+  //! The instantiated metric.
+  MetricType metric;
+
+  //! The shards of the reference set.
+  std::vector<ShardInfo> shards;
+  //! The number of points in the reference set.
+  size_t numPoints;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_neighbor_search_impl.hpp"
+
+#endif
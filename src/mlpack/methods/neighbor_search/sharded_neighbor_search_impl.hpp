@@ -0,0 +1,343 @@
+/**
+ * @file sharded_neighbor_search_impl.hpp
+ *
+ * Implementation of the ShardedNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ShardedNeighborSearch(const NeighborSearchMode mode,
+                      const double epsilon,
+                      const MetricType metric) :
+    mode(mode),
+    epsilon(epsilon),
+    metric(metric),
+    numPoints(0)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ShardedNeighborSearch(const MatType& referenceSet,
+                      const size_t numShards,
+                      const NeighborSearchMode mode,
+                      const double epsilon,
+                      const MetricType metric) :
+    mode(mode),
+    epsilon(epsilon),
+    metric(metric),
+    numPoints(0)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+  if (numShards == 0)
+    throw std::invalid_argument("the number of shards must be positive");
+
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    const size_t begin = s * referenceSet.n_cols / numShards;
+    const size_t end = (s + 1) * referenceSet.n_cols / numShards;
+    if (end > begin)
+      AddShard(referenceSet.cols(begin, end - 1));
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+~ShardedNeighborSearch()
+{
+  for (size_t s = 0; s < shards.size(); ++s)
+    delete shards[s].search;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+AddShard(MatType shard)
+{
+  if (shard.n_cols == 0)
+    throw std::invalid_argument("ShardedNeighborSearch::AddShard(): the shard "
+        "has no points");
+
+  if (!shards.empty() &&
+      shard.n_rows != shards[0].search->ReferenceSet().n_rows)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::AddShard(): dimensionality of shard ("
+        << shard.n_rows << ") is not equal to the dimensionality of the "
+        << "reference set (" << shards[0].search->ReferenceSet().n_rows
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t first = numPoints;
+  const size_t count = shard.n_cols;
+
+  ShardInfo info;
+  if (mode == NAIVE_MODE)
+  {
+    // The points are not reordered.
+    info.indices = arma::linspace<arma::Col<size_t>>(first,
+        first + count - 1, count);
+    info.search = new NeighborSearchType(std::move(shard), NAIVE_MODE,
+        epsilon, metric);
+  }
+  else
+  {
+    // Build the tree here, so that the indices can follow the points if the
+    // tree rearranges them; the search then returns the indices of the points
+    // in the tree.
+    std::vector<size_t> oldFromNew;
+    Tree* tree = BuildTree<Tree>(std::move(shard), oldFromNew);
+
+    info.indices.set_size(count);
+    for (size_t i = 0; i < count; ++i)
+      info.indices[i] = first + (oldFromNew.empty() ? i : oldFromNew[i]);
+
+    info.search = new NeighborSearchType(std::move(*tree), mode, epsilon,
+        metric);
+    delete tree;
+  }
+
+  shards.push_back(info);
+  numPoints += count;
+
+  return first;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Search(const MatType& querySet,
+       const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances)
+{
+  if (k > numPoints)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::Search(): requested value of k (" << k
+        << ") is greater than the number of points in the reference set ("
+        << numPoints << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(size_t(-1));
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(SortPolicy::WorstDistance());
+
+  arma::Mat<size_t> shardNeighbors, convertedNeighbors;
+  arma::mat shardDistances, convertedDistances;
+  for (size_t s = 0; s < shards.size(); ++s)
+  {
+    const size_t shardK = std::min(k, (size_t) shards[s].indices.n_elem);
+    shards[s].search->Search(querySet, shardK, shardNeighbors,
+        shardDistances);
+
+    ConvertResults(shards[s], k, shardNeighbors, shardDistances,
+        convertedNeighbors, convertedDistances);
+    MergeResults(neighbors, distances, convertedNeighbors, convertedDistances);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Search(const size_t k,
+       arma::Mat<size_t>& neighbors,
+       arma::mat& distances)
+{
+  if (k >= numPoints)
+  {
+    std::ostringstream oss;
+    oss << "ShardedNeighborSearch::Search(): requested value of k (" << k
+        << ") is not less than the number of points in the reference set ("
+        << numPoints << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, numPoints);
+  distances.set_size(k, numPoints);
+
+  arma::Mat<size_t> shardNeighbors, convertedNeighbors, queryNeighbors;
+  arma::mat shardDistances, convertedDistances, queryDistances;
+  for (size_t s = 0; s < shards.size(); ++s)
+  {
+    // The query points are the points of the shard, in the order of its
+    // search.
+    const MatType& queries = shards[s].search->ReferenceSet();
+    const size_t numQueries = shards[s].indices.n_elem;
+
+    queryNeighbors.set_size(k, numQueries);
+    queryNeighbors.fill(size_t(-1));
+    queryDistances.set_size(k, numQueries);
+    queryDistances.fill(SortPolicy::WorstDistance());
+
+    for (size_t t = 0; t < shards.size(); ++t)
+    {
+      if (t == s)
+      {
+        // A point is not its own neighbor.
+        const size_t shardK = std::min(k, numQueries - 1);
+        if (shardK == 0)
+          continue;
+
+        shards[t].search->Search(shardK, shardNeighbors, shardDistances);
+      }
+      else
+      {
+        const size_t shardK = std::min(k, (size_t) shards[t].indices.n_elem);
+        shards[t].search->Search(queries, shardK, shardNeighbors,
+            shardDistances);
+      }
+
+      ConvertResults(shards[t], k, shardNeighbors, shardDistances,
+          convertedNeighbors, convertedDistances);
+      MergeResults(queryNeighbors, queryDistances, convertedNeighbors,
+          convertedDistances);
+    }
+
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+      neighbors.col(shards[s].indices[i]) = queryNeighbors.col(i);
+      distances.col(shards[s].indices[i]) = queryDistances.col(i);
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+MergeResults(arma::Mat<size_t>& neighbors,
+             arma::mat& distances,
+             const arma::Mat<size_t>& otherNeighbors,
+             const arma::mat& otherDistances)
+{
+  if (neighbors.n_rows != otherNeighbors.n_rows ||
+      neighbors.n_cols != otherNeighbors.n_cols ||
+      distances.n_rows != neighbors.n_rows ||
+      distances.n_cols != neighbors.n_cols ||
+      otherDistances.n_rows != otherNeighbors.n_rows ||
+      otherDistances.n_cols != otherNeighbors.n_cols)
+  {
+    throw std::invalid_argument("ShardedNeighborSearch::MergeResults(): the "
+        "results to merge must have the same size");
+  }
+
+  const size_t k = neighbors.n_rows;
+
+  #pragma omp parallel for
+  for (omp_size_t q = 0; q < (omp_size_t) neighbors.n_cols; ++q)
+  {
+    arma::Col<size_t> mergedNeighbors(k);
+    arma::vec mergedDistances(k);
+
+    // Both lists are sorted, so this is the merge step of merge sort.  Ties
+    // are broken by index, so that the order of the merges doesn't matter.
+    size_t a = 0, b = 0;
+    for (size_t j = 0; j < k; ++j)
+    {
+      const bool takeOther = (a == k) || (b < k &&
+          (SortPolicy::IsBetter(otherDistances(b, q), distances(a, q)) ||
+          (otherDistances(b, q) == distances(a, q) &&
+          otherNeighbors(b, q) < neighbors(a, q))));
+
+      if (takeOther)
+      {
+        mergedNeighbors[j] = otherNeighbors(b, q);
+        mergedDistances[j] = otherDistances(b, q);
+        ++b;
+      }
+      else
+      {
+        mergedNeighbors[j] = neighbors(a, q);
+        mergedDistances[j] = distances(a, q);
+        ++a;
+      }
+    }
+
+    neighbors.col(q) = mergedNeighbors;
+    distances.col(q) = mergedDistances;
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ConvertResults(const ShardInfo& shard,
+               const size_t k,
+               const arma::Mat<size_t>& shardNeighbors,
+               const arma::mat& shardDistances,
+               arma::Mat<size_t>& neighbors,
+               arma::mat& distances) const
+{
+  neighbors.set_size(k, shardNeighbors.n_cols);
+  neighbors.fill(size_t(-1));
+  distances.set_size(k, shardNeighbors.n_cols);
+  distances.fill(SortPolicy::WorstDistance());
+
+  for (size_t q = 0; q < shardNeighbors.n_cols; ++q)
+  {
+    for (size_t j = 0; j < shardNeighbors.n_rows; ++j)
+    {
+      neighbors(j, q) = shard.indices[shardNeighbors(j, q)];
+      distances(j, q) = shardDistances(j, q);
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
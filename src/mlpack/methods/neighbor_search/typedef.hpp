@@ -18,6 +18,7 @@
 #include "neighbor_search.hpp"
 
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/fixed_lmetric.hpp>
 
 #include "sort_policies/nearest_neighbor_sort.hpp"
 #include "sort_policies/furthest_neighbor_sort.hpp"
@@ -37,6 +38,24 @@ typedef NeighborSearch<NearestNeighborSort, metric::EuclideanDistance> KNN;
  */
 typedef NeighborSearch<FurthestNeighborSort, metric::EuclideanDistance> KFN;
 
+/**
+ * The FixedKNN class is the k-nearest-neighbors method for points of the given
+ * dimensionality.  It returns the same results as KNN, but the distance
+ * computations are specialized for that dimensionality, which is much faster
+ * for low-dimensional data.
+ */
+template<size_t Dimensionality>
+using FixedKNN = NeighborSearch<NearestNeighborSort,
+                                metric::FixedEuclideanDistance<Dimensionality>>;
+
+/**
+ * The FixedKFN class is the k-furthest-neighbors method for points of the given
+ * dimensionality; see FixedKNN.
+ */
+template<size_t Dimensionality>
+using FixedKFN = NeighborSearch<FurthestNeighborSort,
+                                metric::FixedEuclideanDistance<Dimensionality>>;
+
 /**
  * The DefeatistKNN class is the k-nearest-neighbors method considering
  * defeatist search. It returns L2 distances (Euclidean distances) for each of
@@ -67,6 +86,46 @@ using DefeatistKNN = NeighborSearch<
 typedef DefeatistKNN<tree::SPTree> SpillKNN;
 
 } // namespace neighbor
+
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.  KNN and KFN, and their kd-trees, are compiled once in the mlpack
+ * library (see neighbor_search.cpp), instead of in each program that uses
+ * them.
+ *
+ * @cond
+ */
+
+namespace tree {
+
+extern template class BinarySpaceTree<metric::EuclideanDistance,
+    neighbor::NeighborSearchStat<neighbor::NearestNeighborSort>,
+    arma::mat,
+    bound::HRectBound,
+    MidpointSplit>;
+
+extern template class BinarySpaceTree<metric::EuclideanDistance,
+    neighbor::NeighborSearchStat<neighbor::FurthestNeighborSort>,
+    arma::mat,
+    bound::HRectBound,
+    MidpointSplit>;
+
+} // namespace tree
+
+namespace neighbor {
+
+extern template class NeighborSearch<NearestNeighborSort,
+                                     metric::EuclideanDistance>;
+
+extern template class NeighborSearch<FurthestNeighborSort,
+                                     metric::EuclideanDistance>;
+
+} // namespace neighbor
+
+/**
+ * @endcond
+ */
+
 } // namespace mlpack
 
 #endif
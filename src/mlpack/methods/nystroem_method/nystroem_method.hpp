@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_NYSTROEM_METHOD_NYSTROEM_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
 #include "kmeans_selection.hpp"
 
 namespace mlpack {
@@ -46,6 +47,18 @@ class NystroemMethod
    */
   void Apply(arma::mat& output);
 
+  /**
+   * Apply the low-rank factorization to obtain an output matrix G such that
+   * K' = G * G^T, and also return the selected points and the matrix P with
+   * G = K(data, landmarks) * P.  The approximation then maps any new point x to
+   * the row k(x, landmarks) * P, which costs one kernel evaluation per landmark.
+   *
+   * @param output Matrix to store kernel approximation into.
+   * @param landmarks Matrix to store the selected points into.
+   * @param projection Matrix to store P into.
+   */
+  void Apply(arma::mat& output, arma::mat& landmarks, arma::mat& projection);
+
   /**
    * Construct the kernel matrix with matrix that contains the selected points.
    *
@@ -69,6 +82,14 @@ class NystroemMethod
                        arma::mat& semiKernel);
 
  private:
+  //! Take the selected points returned by the point selection policy.
+  void Landmarks(const arma::mat* selectedData, arma::mat& landmarks);
+
+  //! Gather the points with the indices returned by the point selection
+  //! policy.
+  void Landmarks(const arma::Col<size_t>& selectedPoints,
+                 arma::mat& landmarks);
+
   //! The reference dataset.
   const arma::mat& data;
   //! The locally stored kernel, if it is necessary.
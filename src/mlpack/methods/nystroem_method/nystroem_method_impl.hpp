@@ -36,17 +36,12 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& semiKernel)
 {
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  KernelMatrix(*selectedData, kernel, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
+  KernelMatrix(data, *selectedData, kernel, semiKernel);
+
   // Clean the memory.
   delete selectedData;
 }
@@ -57,32 +52,56 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  // Gather the selected points, so the kernel matrices can be computed in
+  // tiles.
+  const arma::mat selectedData = data.cols(
+      arma::conv_to<arma::uvec>::from(selectedPoints));
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-  {
-    for (size_t j = 0; j < rank; ++j)
-    {
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
-    }
-  }
+  KernelMatrix(selectedData, kernel, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  KernelMatrix(data, selectedData, kernel, semiKernel);
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemMethod<KernelType, PointSelectionPolicy>::Landmarks(
+    const arma::mat* selectedData,
+    arma::mat& landmarks)
+{
+  landmarks = *selectedData;
+  delete selectedData;
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemMethod<KernelType, PointSelectionPolicy>::Landmarks(
+    const arma::Col<size_t>& selectedPoints,
+    arma::mat& landmarks)
+{
+  landmarks = data.cols(arma::conv_to<arma::uvec>::from(selectedPoints));
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
 void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(arma::mat& output)
 {
-  arma::mat miniKernel(rank, rank);
-  arma::mat semiKernel(data.n_cols, rank);
+  arma::mat landmarks, projection;
+  Apply(output, landmarks, projection);
+}
+
+template<typename KernelType, typename PointSelectionPolicy>
+void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(
+    arma::mat& output,
+    arma::mat& landmarks,
+    arma::mat& projection)
+{
+  Landmarks(PointSelectionPolicy::Select(data, rank), landmarks);
 
-  GetKernelMatrix(PointSelectionPolicy::Select(data, rank), miniKernel,
-                  semiKernel);
+  // Assemble the mini-kernel matrix, and the semi-kernel matrix with the
+  // interactions between the selected points and all points.
+  arma::mat miniKernel, semiKernel;
+  KernelMatrix(landmarks, kernel, miniKernel);
+  KernelMatrix(data, landmarks, kernel, semiKernel);
 
   // Singular value decomposition mini-kernel matrix.
   arma::mat U, V;
@@ -96,7 +115,8 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(arma::mat& output)
     if (std::abs(s[i]) <= 1e-20)
       normalization(i, i) = 0.0;
 
-  output = semiKernel * U * normalization * V;
+  projection = U * normalization * V;
+  output = semiKernel * projection;
 }
 
 } // namespace kernel
@@ -0,0 +1,231 @@
+/**
+ * @file incremental_pca_method.hpp
+ *
+ * Implementation of the incremental covariance method for use in the Principal
+ * Components Analysis method, which can consume the data in batches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_PCA_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_PCA_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental PCA policy.  The mean and the covariance
+ * matrix of the data are accumulated one batch of points at a time (merging the
+ * statistics of each batch as in Chan, Golub and LeVeque's pairwise update),
+ * and the principal components are the eigenvectors of the covariance matrix.
+ * Only one batch and the d x d covariance have to be held in memory, so a
+ * dataset larger than the memory can be streamed through Update():
+ *
+ * @code
+ * IncrementalPCAPolicy ipca;
+ * ipca.Reset(dimensionality);
+ * while (...) // For each batch of points.
+ *   ipca.Update(batch);
+ *
+ * arma::vec eigVal;
+ * arma::mat eigvec;
+ * ipca.Components(eigVal, eigvec);
+ * @endcode
+ *
+ * Forming the covariance takes O(n d^2) time and its eigendecomposition
+ * O(d^3), so this policy is best suited to data with many more points than
+ * dimensions.  When used with the PCA class, the centered data is consumed in
+ * batches of BatchSize() points.
+ */
+class IncrementalPCAPolicy
+{
+ public:
+  /**
+   * Use the incremental covariance method to perform the principal components
+   * analysis (PCA).
+   *
+   * @param batchSize Number of points processed at a time by Apply().
+   */
+  IncrementalPCAPolicy(const size_t batchSize = 10000) :
+      batchSize(batchSize),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * incremental covariance method.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& /* data */,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t /* rank */)
+  {
+    Reset(centeredData.n_rows);
+    const size_t step = std::max(batchSize, (size_t) 1);
+    for (size_t begin = 0; begin < centeredData.n_cols; begin += step)
+    {
+      const size_t end = std::min(begin + step, (size_t) centeredData.n_cols);
+      Update(centeredData.cols(begin, end - 1));
+    }
+
+    Components(eigVal, eigvec);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Forget the points seen so far, and prepare to see points of the given
+   * dimensionality.
+   *
+   * @param dimensionality Dimensionality of the points.
+   */
+  void Reset(const size_t dimensionality)
+  {
+    numPoints = 0;
+    mean.zeros(dimensionality);
+    scatter.zeros(dimensionality, dimensionality);
+  }
+
+  /**
+   * Add the given batch of points (one per column) to the mean and covariance.
+   *
+   * @param batch Points to add.
+   */
+  void Update(const arma::mat& batch)
+  {
+    if (batch.n_cols == 0)
+      return;
+
+    if (batch.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalPCAPolicy::Update(): points have dimensionality "
+          << batch.n_rows << ", but " << mean.n_elem << " was expected.";
+      throw std::invalid_argument(oss.str());
+    }
+
+    const double m = (double) batch.n_cols;
+    const double n = (double) numPoints;
+
+    const arma::vec batchMean = arma::mean(batch, 1);
+    arma::mat centeredBatch = batch;
+    centeredBatch.each_col() -= batchMean;
+
+    // The scatter of the union is the sum of the scatters plus a correction for
+    // the distance between the means.
+    const arma::vec delta = batchMean - mean;
+    scatter += centeredBatch * centeredBatch.t();
+    scatter += (n * m / (n + m)) * (delta * delta.t());
+    mean += (m / (n + m)) * delta;
+    numPoints += batch.n_cols;
+  }
+
+  /**
+   * Compute the principal components of the points seen so far, in order of
+   * decreasing eigenvalue.
+   *
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param scaleData If true, compute the components of the data scaled to unit
+   *     variance in each dimension (as PCA::ScaleData() does).
+   */
+  void Components(arma::vec& eigVal,
+                  arma::mat& eigvec,
+                  const bool scaleData = false) const
+  {
+    // The covariance matrix is X * X' / (N - 1).
+    arma::mat covariance = scatter / (double) (numPoints - 1);
+    if (scaleData)
+    {
+      const arma::vec stdDev = StdDev();
+      covariance /= stdDev * stdDev.t();
+    }
+
+    arma::eig_sym(eigVal, eigvec, covariance);
+
+    // eig_sym() sorts the eigenvalues in increasing order.
+    eigVal = arma::flipud(eigVal);
+    eigvec = arma::fliplr(eigvec);
+
+    // Rounding can make the smallest eigenvalues slightly negative.
+    eigVal.transform([](double x) { return std::max(x, 0.0); });
+  }
+
+  /**
+   * Center (and optionally scale) the given points with the statistics of the
+   * points seen so far, and project them onto the given components.
+   *
+   * @param batch Points to transform.
+   * @param eigvec Components, as returned by Components().
+   * @param transformedData Matrix to put the transformed points into.
+   * @param scaleData Whether the components were computed for scaled data.
+   */
+  void Transform(const arma::mat& batch,
+                 const arma::mat& eigvec,
+                 arma::mat& transformedData,
+                 const bool scaleData = false) const
+  {
+    arma::mat centeredBatch = batch;
+    centeredBatch.each_col() -= mean;
+    if (scaleData)
+      centeredBatch.each_col() /= StdDev();
+
+    transformedData = arma::trans(eigvec) * centeredBatch;
+  }
+
+  //! Get the number of points processed at a time by Apply().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points processed at a time by Apply().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of points seen since the last Reset().
+  size_t NumPoints() const { return numPoints; }
+  //! Get the mean of the points seen since the last Reset().
+  const arma::vec& Mean() const { return mean; }
+
+ private:
+  //! Get the standard deviation of each dimension, with zeros replaced by a
+  //! tiny value so the data can be divided by it.
+  arma::vec StdDev() const
+  {
+    arma::vec stdDev = arma::sqrt(scatter.diag() / (double) (numPoints - 1));
+    for (size_t i = 0; i < stdDev.n_elem; ++i)
+      if (stdDev[i] == 0)
+        stdDev[i] = 1e-50;
+
+    return stdDev;
+  }
+
+  //! Locally stored number of points processed at a time by Apply().
+  size_t batchSize;
+
+  //! Number of points seen since the last Reset().
+  size_t numPoints;
+  //! Mean of the points seen since the last Reset().
+  arma::vec mean;
+  //! Sum of the outer products of the centered points seen since the last
+  //! Reset().
+  arma::mat scatter;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -15,7 +15,9 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 
 #include "pca.hpp"
+#include <mlpack/core/data/batch_reader.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_pca_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -50,7 +52,16 @@ PROGRAM_INFO("Principal Components Analysis",
     "Multiple different decomposition techniques can be used.  The method to "
     "use can be specified with the " +
     PRINT_PARAM_STRING("decomposition_method") + " parameter, and it may take "
-    "the values 'exact', 'randomized', or 'quic'."
+    "the values 'exact', 'randomized', 'randomized-block-krylov', 'quic', or "
+    "'incremental'."
+    "\n\n"
+    "Datasets that do not fit in memory can be given as a filename with the " +
+    PRINT_PARAM_STRING("input_file") + " parameter instead; the file (.mmat, "
+    ".csv, .txt, or .tsv) is then read " + PRINT_PARAM_STRING("batch_size") +
+    " points at a time with the incremental method, once to find the principal"
+    " components and once to transform the points, which are written to the "
+    "file given with " + PRINT_PARAM_STRING("output_file") + " a batch at a "
+    "time."
     "\n\n"
     "For example, to reduce the dimensionality of the matrix " +
     PRINT_DATASET("data") + " to 5 dimensions using randomized SVD for the "
@@ -65,7 +76,7 @@ PROGRAM_INFO("Principal Components Analysis",
         "@doxygen/classmlpack_1_1pca_1_1PCA.html"));
 
 // Parameters for program.
-PARAM_MATRIX_IN_REQ("input", "Input dataset to perform PCA on.", "i");
+PARAM_MATRIX_IN("input", "Input dataset to perform PCA on.", "i");
 PARAM_MATRIX_OUT("output", "Matrix to save modified dataset to.", "o");
 PARAM_INT_IN("new_dimensionality", "Desired dimensionality of output dataset. "
     "If 0, no dimensionality reduction is performed.", "d", 0);
@@ -77,7 +88,14 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal "
     "components analysis: 'exact', 'randomized', 'randomized-block-krylov', "
-    "'quic'.", "c", "exact");
+    "'quic', 'incremental'.", "c", "exact");
+
+PARAM_STRING_IN("input_file", "File holding a dataset to perform PCA on in "
+    "batches, without loading it into memory (instead of --input).", "I", "");
+PARAM_STRING_IN("output_file", "File to write the transformed dataset to in "
+    "batches, when --input_file is given.", "O", "");
+PARAM_INT_IN("batch_size", "Number of points processed at a time with "
+    "--input_file or the 'incremental' decomposition method.", "b", 10000);
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -85,9 +103,10 @@ template<typename DecompositionPolicy>
 void RunPCA(arma::mat& dataset,
             const size_t newDimension,
             const bool scale,
-            const double varToRetain)
+            const double varToRetain,
+            const DecompositionPolicy& decomposition = DecompositionPolicy())
 {
-  PCA<DecompositionPolicy> p(scale);
+  PCA<DecompositionPolicy> p(scale, decomposition);
 
   Log::Info << "Performing PCA on dataset..." << endl;
   double varRetained;
@@ -109,17 +128,154 @@ void RunPCA(arma::mat& dataset,
       dataset.n_rows << " dimensions)." << endl;
 }
 
+//! Run PCA on the dataset in the given file, reading it a batch at a time.
+void RunStreamingPCA(data::BatchReader& reader,
+                     const string& inputFile,
+                     const size_t newDimension,
+                     const bool scale,
+                     const double varToRetain,
+                     const size_t batchSize)
+{
+  IncrementalPCAPolicy decomposition(batchSize);
+  decomposition.Reset(reader.Dimensionality());
+
+  Log::Info << "Performing PCA on dataset in '" << inputFile << "' in batches "
+      << "of " << batchSize << " points..." << endl;
+  Timer::Start("pca");
+
+  // The first pass finds the principal components.
+  arma::mat batch;
+  while (reader.Next(batch, batchSize))
+    decomposition.Update(batch);
+
+  if (decomposition.NumPoints() < 2)
+    Log::Fatal << "Cannot perform PCA on '" << inputFile << "', which holds "
+        << "fewer than two points!" << endl;
+
+  arma::vec eigVal;
+  arma::mat eigvec;
+  decomposition.Components(eigVal, eigvec, scale);
+
+  // Find the dimension we should keep.
+  size_t dimension = newDimension;
+  if (CLI::HasParam("var_to_retain"))
+  {
+    if (CLI::HasParam("new_dimensionality"))
+      Log::Warn << "New dimensionality (-d) ignored because --var_to_retain "
+          << "(-r) was specified." << endl;
+
+    const arma::vec normalized = eigVal / arma::sum(eigVal);
+    double varSum = 0.0;
+    dimension = 0;
+    while ((varSum < varToRetain) && (dimension < normalized.n_elem))
+      varSum += normalized[dimension++];
+  }
+  dimension = std::max(dimension, (size_t) 1);
+  if (dimension < eigvec.n_cols)
+    eigvec.shed_cols(dimension, eigvec.n_cols - 1);
+
+  // The second pass transforms the points.
+  std::unique_ptr<data::BatchWriter> writer;
+  if (CLI::HasParam("output_file"))
+  {
+    writer.reset(new data::BatchWriter(CLI::GetParam<string>("output_file"),
+        dimension, decomposition.NumPoints()));
+  }
+
+  arma::mat* output = NULL;
+  if (CLI::HasParam("output"))
+  {
+    output = &CLI::GetParam<arma::mat>("output");
+    output->set_size(dimension, decomposition.NumPoints());
+  }
+
+  reader.Rewind();
+  arma::mat transformedBatch;
+  while (reader.Next(batch, batchSize))
+  {
+    decomposition.Transform(batch, eigvec, transformedBatch, scale);
+    if (writer)
+      writer->Write(transformedBatch);
+    if (output)
+    {
+      output->cols(reader.PointsRead() - batch.n_cols,
+          reader.PointsRead() - 1) = transformedBatch;
+    }
+  }
+
+  if (writer)
+    writer->Close();
+
+  Timer::Stop("pca");
+
+  const double varRetained = arma::sum(eigVal.subvec(0, dimension - 1)) /
+      arma::sum(eigVal);
+  Log::Info << (varRetained * 100) << "% of variance retained (" << dimension
+      << " dimensions)." << endl;
+}
+
 static void mlpackMain()
 {
-  // Load input dataset.
-  arma::mat& dataset = CLI::GetParam<arma::mat>("input");
+  // Exactly one of the dataset and the dataset file must be given.
+  RequireOnlyOnePassed({ "input", "input_file" }, true);
+  const bool streaming = CLI::HasParam("input_file");
 
   // Issue a warning if the user did not specify an output file.
-  RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+  if (streaming)
+  {
+    RequireAtLeastOnePassed({ "output", "output_file" }, false,
+        "no output will be saved");
+  }
+  else
+  {
+    RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
+    ReportIgnoredParam({{ "input_file", false }}, "output_file");
+  }
+
+  RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+      "batch size must be positive");
+  const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+
+  if (streaming)
+  {
+    // Only the incremental method can be used on batches.
+    if (CLI::HasParam("decomposition_method") &&
+        CLI::GetParam<string>("decomposition_method") != "incremental")
+    {
+      Log::Warn << "Decomposition method ignored because --input_file (-I) "
+          << "was specified; the incremental method is used." << endl;
+    }
+
+    data::BatchReader reader(CLI::GetParam<string>("input_file"));
+    const size_t dimensionality = reader.Dimensionality();
+
+    RequireParamValue<int>("new_dimensionality", [](int x) { return x >= 0; },
+        true, "new dimensionality must be non-negative");
+    std::ostringstream error;
+    error << "cannot be greater than existing dimensionality ("
+        << dimensionality << ")";
+    RequireParamValue<int>("new_dimensionality",
+        [dimensionality](int x) { return x <= (int) dimensionality; }, true,
+        error.str());
+    RequireParamValue<double>("var_to_retain",
+        [](double x) { return x >= 0.0 && x <= 1.0; }, true,
+        "variance retained must be between 0 and 1");
+
+    const size_t newDimension =
+        (CLI::GetParam<int>("new_dimensionality") == 0) ? dimensionality :
+        CLI::GetParam<int>("new_dimensionality");
+    RunStreamingPCA(reader, CLI::GetParam<string>("input_file"), newDimension,
+        CLI::HasParam("scale"), CLI::GetParam<double>("var_to_retain"),
+        batchSize);
+    return;
+  }
+
+  // Load input dataset.
+  arma::mat& dataset = CLI::GetParam<arma::mat>("input");
 
   // Check decomposition method validity.
   RequireParamInSet<string>("decomposition_method", { "exact", "randomized",
-      "randomized-block-krylov", "quic" }, true,
+      "randomized-block-krylov", "quic", "incremental" }, true,
       "unknown decomposition method");
 
   // Find out what dimension we want.
@@ -162,6 +318,11 @@ static void mlpackMain()
   {
     RunPCA<QUICSVDPolicy>(dataset, newDimension, scale, varToRetain);
   }
+  else if (decompositionMethod == "incremental")
+  {
+    RunPCA<IncrementalPCAPolicy>(dataset, newDimension, scale, varToRetain,
+        IncrementalPCAPolicy(batchSize));
+  }
 
   // Now save the results.
   if (CLI::HasParam("output"))
@@ -106,9 +106,50 @@ class Perceptron
              const size_t numClasses,
              const arma::rowvec& instanceWeights = arma::rowvec());
 
+  /**
+   * Train the perceptron on the given data in parallel, by iterative parameter
+   * mixing.  The points are dealt to one shard per OpenMP thread; at each
+   * iteration, every shard runs one perceptron pass over its points starting
+   * from the current weights, and the new weights are the average of the
+   * weights of the shards, weighted by their number of mistakes.  Training
+   * stops when no shard makes a mistake, or after the maximum number of
+   * iterations.  With one thread, this is the same as Train().
+   *
+   * If averaged is true, the final weights and biases are the average of the
+   * mixed ones over all iterations (the averaged perceptron), which usually
+   * generalize better when the data is not linearly separable.
+   *
+   * This training does not reset the model weights, so you can call it on
+   * multiple datasets sequentially.
+   *
+   * @code
+   * @inproceedings{mcdonald2010distributed,
+   *   title = {Distributed Training Strategies for the Structured Perceptron},
+   *   author = {McDonald, Ryan and Hall, Keith and Mann, Gideon},
+   *   booktitle = {Human Language Technologies: The 2010 Annual Conference of
+   *       the North American Chapter of the ACL},
+   *   pages = {456--464},
+   *   year = {2010}
+   * }
+   * @endcode
+   *
+   * @param data Dataset on which training should be performed.
+   * @param labels Labels of the dataset.
+   * @param numClasses Number of classes in the data.
+   * @param averaged Whether to return the averaged weights.
+   * @param instanceWeights Cost matrix. Stores the cost of mispredicting
+   *      instances.  This is useful for boosting.
+   */
+  void TrainParallel(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     const bool averaged = true,
+                     const arma::rowvec& instanceWeights = arma::rowvec());
+
   /**
    * Classification function. After training, use the weights matrix to
-   * classify test, and put the predicted classes in predictedLabels.
+   * classify test, and put the predicted classes in predictedLabels.  The
+   * scores of blocks of points are computed with one matrix product each.
    *
    * @param test Testing data or data to classify.
    * @param predictedLabels Vector to store the predicted classes after
@@ -14,6 +14,10 @@
 
 #include "perceptron.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace perceptron {
 
@@ -106,15 +110,24 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  predictedLabels.set_size(test.n_cols);
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; i++)
+  // The scores are computed in blocks, so that the memory they take stays
+  // bounded for large test sets.
+  const size_t blockSize = 4096;
+  arma::mat scores;
+  arma::uword maxIndex = 0;
+  for (size_t begin = 0; begin < test.n_cols; begin += blockSize)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
-    predictedLabels(0, i) = maxIndex;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols) - 1;
+    scores = weights.t() * test.cols(begin, end);
+    scores.each_col() += biases;
+
+    for (size_t i = 0; i < scores.n_cols; ++i)
+    {
+      scores.col(i).max(maxIndex);
+      predictedLabels(0, begin + i) = maxIndex;
+    }
   }
 }
 
@@ -192,6 +205,111 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
   }
 }
 
+/**
+ * Training function with iterative parameter mixing.  The points are dealt to
+ * the shards in turn, so that each shard sees all the classes even if the data
+ * is sorted by label.
+ */
+template<
+    typename LearnPolicy,
+    typename WeightInitializationPolicy,
+    typename MatType
+>
+void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::
+TrainParallel(const MatType& data,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const bool averaged,
+              const arma::rowvec& instanceWeights)
+{
+  // Do we need to resize the weights?
+  if (weights.n_elem != numClasses)
+  {
+    WeightInitializationPolicy wip;
+    wip.Initialize(weights, biases, data.n_rows, numClasses);
+  }
+
+  size_t numShards = 1;
+  #ifdef HAS_OPENMP
+    numShards = omp_get_max_threads();
+  #endif
+  numShards = std::max(std::min(numShards, (size_t) data.n_cols), (size_t) 1);
+
+  const bool hasWeights = (instanceWeights.n_elem > 0);
+
+  std::vector<arma::mat> shardWeights(numShards);
+  std::vector<arma::vec> shardBiases(numShards);
+  arma::Col<size_t> mistakes(numShards);
+
+  arma::mat weightSum(arma::size(weights), arma::fill::zeros);
+  arma::vec biasSum(arma::size(biases), arma::fill::zeros);
+  size_t iterations = 0;
+
+  while (iterations < maxIterations)
+  {
+    ++iterations;
+
+    #pragma omp parallel for
+    for (omp_size_t s = 0; s < (omp_size_t) numShards; ++s)
+    {
+      arma::mat& w = shardWeights[s];
+      arma::vec& b = shardBiases[s];
+      w = weights;
+      b = biases;
+      mistakes[s] = 0;
+
+      LearnPolicy LP;
+      arma::vec tempLabelMat;
+      arma::uword maxIndex = 0;
+      for (size_t j = s; j < data.n_cols; j += numShards)
+      {
+        tempLabelMat = w.t() * data.col(j) + b;
+        tempLabelMat.max(maxIndex);
+
+        if (maxIndex != labels(0, j))
+        {
+          ++mistakes[s];
+          if (hasWeights)
+            LP.UpdateWeights(data.col(j), w, b, maxIndex, labels(0, j),
+                instanceWeights(j));
+          else
+            LP.UpdateWeights(data.col(j), w, b, maxIndex, labels(0, j));
+        }
+      }
+    }
+
+    // Mix the weights of the shards in proportion to their mistakes; a shard
+    // without mistakes still has the weights it started from.
+    const size_t totalMistakes = arma::accu(mistakes);
+    if (totalMistakes > 0)
+    {
+      weights.zeros();
+      biases.zeros();
+      for (size_t s = 0; s < numShards; ++s)
+      {
+        if (mistakes[s] == 0)
+          continue;
+
+        const double mix = double(mistakes[s]) / totalMistakes;
+        weights += mix * shardWeights[s];
+        biases += mix * shardBiases[s];
+      }
+    }
+
+    weightSum += weights;
+    biasSum += biases;
+
+    if (totalMistakes == 0)
+      break;
+  }
+
+  if (averaged && iterations > 0)
+  {
+    weights = weightSum / iterations;
+    biases = biasSum / iterations;
+  }
+}
+
 //! Serialize the perceptron.
 template<typename LearnPolicy,
          typename WeightInitializationPolicy,
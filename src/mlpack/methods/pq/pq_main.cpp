@@ -0,0 +1,254 @@
+/**
+ * @file pq_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors with a product
+ * quantization index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include "pq_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with Product Quantization",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search on a reference "
+    "set compressed with product quantization (PQ), optionally with an "
+    "inverted file of coarse centroids (IVF-PQ).  Each reference point is "
+    "stored as a code of a few bytes; the candidates can be re-ranked with "
+    "their exact distances.  Models can be saved for future use.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of query points in a reference set compressed with product quantization. "
+    "The dimensions of the points are split into " +
+    PRINT_PARAM_STRING("subspaces") + " groups, and each point is stored as "
+    "the index of the closest of 256 centroids learned with k-means in each "
+    "group, so a code takes " + PRINT_PARAM_STRING("subspaces") + " bytes.  If "
+    + PRINT_PARAM_STRING("lists") + " is more than 1, the points are first "
+    "split into that many lists around coarse centroids, and searches only scan"
+    " the " + PRINT_PARAM_STRING("probes") + " lists closest to the query."
+    "\n\n"
+    "For example, the following will build an index of 16-byte codes in 100 "
+    "lists on " + PRINT_DATASET("input") + ", return 5 neighbors for each point "
+    "in " + PRINT_DATASET("queries") + ", and store the neighbors in " +
+    PRINT_DATASET("neighbors") + " and the index in " + PRINT_MODEL("pq") + ":"
+    "\n\n" +
+    PRINT_CALL("pq", "reference", "input", "subspaces", 16, "lists", 100,
+        "query", "queries", "k", 5, "neighbors", "neighbors", "output_model",
+        "pq") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points.  The distances are approximated from "
+    "the codes, unless " + PRINT_PARAM_STRING("rerank") + " is positive: then "
+    "that many candidates are found from the codes, and the best of them by "
+    "exact distance are returned.  Re-ranking needs the reference set, which "
+    "may be given along with " + PRINT_PARAM_STRING("input_model") + " for "
+    "this purpose (it must then hold the points the model was built on)."
+    "\n\n"
+    "If " + PRINT_PARAM_STRING("query") + " is not given, the reference set is "
+    "used as the query set (each point is then usually its own first "
+    "neighbor).  The recall and the effective error of the search can be "
+    "printed by giving the true neighbors and distances (for instance from the "
+    "knn program).",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("@hnsw", "#hnsw"),
+    SEE_ALSO("Product quantization for nearest neighbor search (pdf)",
+        "https://hal.inria.fr/inria-00514462/document"),
+    SEE_ALSO("mlpack::neighbor::PQSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1PQSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(PQSearch, "input_model", "Input PQ model.", "m");
+PARAM_MODEL_OUT(PQSearch, "output_model", "Output for trained PQ model.", "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+PARAM_MATRIX_IN("true_distances", "Matrix of true distances to compute the "
+    "effective error with (printed when -v is specified).", "D");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+
+PARAM_INT_IN("subspaces", "The number of groups of dimensions, which is the "
+    "size of a code in bytes.", "S", 8);
+PARAM_INT_IN("lists", "The number of lists of the inverted file (1 for plain "
+    "product quantization).", "L", 1);
+PARAM_INT_IN("probes", "The number of lists scanned by searches.", "P", 8);
+PARAM_INT_IN("rerank", "The number of candidates re-ranked with their exact "
+    "distances (0 to not re-rank).", "R", 0);
+PARAM_INT_IN("max_iterations", "The maximum number of iterations of each "
+    "k-means clustering.", "i", 25);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("subspaces", [](int x) { return x > 0; }, true,
+      "number of subspaces must be greater than 0");
+  RequireParamValue<int>("lists", [](int x) { return x > 0; }, true,
+      "number of lists must be greater than 0");
+  RequireParamValue<int>("probes", [](int x) { return x > 0; }, true,
+      "number of probes must be greater than 0");
+  RequireParamValue<int>("rerank", [](int x) { return x >= 0; }, true,
+      "number of re-ranked candidates must not be negative");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+      "maximum number of iterations must not be negative");
+
+  RequireAtLeastOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+  if (CLI::HasParam("k"))
+  {
+    RequireAtLeastOnePassed({ "query", "reference" }, true, "must pass set to "
+        "search");
+  }
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "query");
+  ReportIgnoredParam({{ "k", false }}, "rerank");
+  ReportIgnoredParam({{ "k", false }}, "true_neighbors");
+  ReportIgnoredParam({{ "k", false }}, "true_distances");
+
+  ReportIgnoredParam({{ "input_model", true }}, "subspaces");
+  ReportIgnoredParam({{ "input_model", true }}, "lists");
+  ReportIgnoredParam({{ "input_model", true }}, "max_iterations");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  if (CLI::GetParam<int>("rerank") > 0 && !CLI::HasParam("reference"))
+  {
+    Log::Fatal << "Re-ranking needs the reference set; pass it with "
+        << PRINT_PARAM_STRING("reference") << "." << endl;
+  }
+
+  PQSearch* pq;
+  if (CLI::HasParam("input_model"))
+  {
+    pq = CLI::GetParam<PQSearch*>("input_model");
+  }
+  else
+  {
+    const arma::mat& referenceData = CLI::GetParam<arma::mat>("reference");
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+
+    pq = new PQSearch((size_t) CLI::GetParam<int>("subspaces"),
+        (size_t) CLI::GetParam<int>("lists"), 1,
+        (size_t) CLI::GetParam<int>("max_iterations"));
+
+    Timer::Start("index_building");
+    pq->Train(referenceData);
+    pq->Add(referenceData);
+    Timer::Stop("index_building");
+
+    Log::Info << "Encoded " << pq->Size() << " points with codes of "
+        << pq->Subspaces() << " bytes." << endl;
+  }
+
+  // The search parameter of the model is the given one, or the default one for
+  // a new model.
+  if (CLI::HasParam("probes") || !CLI::HasParam("input_model"))
+    pq->Probes() = (size_t) CLI::GetParam<int>("probes");
+
+  if (CLI::HasParam("k"))
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    const size_t rerank = (size_t) CLI::GetParam<int>("rerank");
+    const arma::mat& queryData = CLI::HasParam("query") ?
+        CLI::GetParam<arma::mat>("query") : CLI::GetParam<arma::mat>("reference");
+
+    Log::Info << "Computing " << k << " approximate nearest neighbors of "
+        << queryData.n_cols << " points, scanning " << pq->Probes()
+        << " lists." << endl;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    Timer::Start("computing_neighbors");
+    if (rerank > 0)
+    {
+      pq->Search(queryData, CLI::GetParam<arma::mat>("reference"), k,
+          neighbors, distances, rerank);
+    }
+    else
+    {
+      pq->Search(queryData, k, neighbors, distances);
+    }
+    Timer::Stop("computing_neighbors");
+
+    Log::Info << "Neighbors computed." << endl;
+
+    // Compute recall and effective error, if desired.
+    if (CLI::HasParam("true_neighbors"))
+    {
+      arma::Mat<size_t>& trueNeighbors =
+          CLI::GetParam<arma::Mat<size_t>>("true_neighbors");
+      if (trueNeighbors.n_rows != neighbors.n_rows ||
+          trueNeighbors.n_cols != neighbors.n_cols)
+      {
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+      }
+
+      Log::Info << "Recall: " << 100 * KNN::Recall(neighbors, trueNeighbors)
+          << endl;
+    }
+
+    if (CLI::HasParam("true_distances"))
+    {
+      arma::mat& trueDistances = CLI::GetParam<arma::mat>("true_distances");
+      if (trueDistances.n_rows != distances.n_rows ||
+          trueDistances.n_cols != distances.n_cols)
+      {
+        Log::Fatal << "The true distances file must have the same number of "
+            << "values as the set of distances being computed!" << endl;
+      }
+
+      Log::Info << "Effective error: " << KNN::EffectiveError(distances,
+          trueDistances) << endl;
+    }
+
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+
+  CLI::GetParam<PQSearch*>("output_model") = pq;
+}
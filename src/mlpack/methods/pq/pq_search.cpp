@@ -0,0 +1,387 @@
+/**
+ * @file pq_search.cpp
+ *
+ * Implementation of the PQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "pq_search.hpp"
+
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+PQSearch::PQSearch(const size_t subspaces,
+                   const size_t lists,
+                   const size_t probes,
+                   const size_t maxIterations) :
+    subspaces(subspaces),
+    lists(lists),
+    probes(probes),
+    maxIterations(maxIterations),
+    dimensionality(0),
+    size(0)
+{
+  // Nothing to do.
+}
+
+PQSearch::PQSearch(const arma::mat& referenceSet,
+                   const size_t subspaces,
+                   const size_t lists,
+                   const size_t probes,
+                   const size_t maxIterations) :
+    subspaces(subspaces),
+    lists(lists),
+    probes(probes),
+    maxIterations(maxIterations),
+    dimensionality(0),
+    size(0)
+{
+  Train(referenceSet);
+  Add(referenceSet);
+}
+
+void PQSearch::Train(const arma::mat& trainingSet)
+{
+  if (subspaces == 0 || subspaces > trainingSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Train(): the number of subspaces (" << subspaces
+        << ") must be between 1 and the dimensionality of the data ("
+        << trainingSet.n_rows << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (lists == 0 || lists > trainingSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Train(): the number of lists (" << lists << ") must be "
+        << "between 1 and the number of training points ("
+        << trainingSet.n_cols << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  dimensionality = trainingSet.n_rows;
+  bounds.resize(subspaces + 1);
+  for (size_t s = 0; s <= subspaces; ++s)
+    bounds[s] = s * dimensionality / subspaces;
+
+  // Learn the coarse centroids.
+  if (lists == 1)
+  {
+    coarseCentroids = arma::mean(trainingSet, 1);
+  }
+  else
+  {
+    kmeans::KMeans<> kmeans(maxIterations);
+    kmeans.Cluster(trainingSet, lists, coarseCentroids);
+  }
+
+  // The sub-quantizers are learned on the differences between the training
+  // points and their coarse centroids.
+  arma::mat residuals(trainingSet.n_rows, trainingSet.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) trainingSet.n_cols; ++i)
+  {
+    const arma::vec point(const_cast<double*>(trainingSet.colptr(i)),
+        trainingSet.n_rows, false, true);
+    residuals.col(i) = point - coarseCentroids.col(NearestList(point));
+  }
+
+  // The clusterings draw from the random number generator of the calling
+  // thread, so they are run in order for the index to only depend on the seed.
+  const size_t codewords = std::min((size_t) 256, (size_t) trainingSet.n_cols);
+  codebook.set_size(dimensionality, codewords);
+  for (size_t s = 0; s < subspaces; ++s)
+  {
+    const arma::mat subspace = residuals.rows(bounds[s], bounds[s + 1] - 1);
+    arma::mat centroids;
+    kmeans::KMeans<> kmeans(maxIterations);
+    kmeans.Cluster(subspace, codewords, centroids);
+    codebook.rows(bounds[s], bounds[s + 1] - 1) = centroids;
+  }
+
+  codes.clear();
+  codes.resize(lists);
+  indices.clear();
+  indices.resize(lists);
+  size = 0;
+}
+
+void PQSearch::Add(const arma::mat& points)
+{
+  if (bounds.empty())
+    throw std::invalid_argument("PQSearch::Add(): the index is not trained");
+
+  if (points.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Add(): the dimensionality of the points ("
+        << points.n_rows << ") is not the dimensionality of the index ("
+        << dimensionality << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Encode the points in parallel, and then append them to their lists.
+  arma::Row<size_t> assignments(points.n_cols);
+  arma::Mat<unsigned char> pointCodes(subspaces, points.n_cols);
+  #pragma omp parallel
+  {
+    arma::vec residual;
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) points.n_cols; ++i)
+    {
+      const arma::vec point(const_cast<double*>(points.colptr(i)),
+          points.n_rows, false, true);
+      assignments[i] = NearestList(point);
+      residual = point - coarseCentroids.col(assignments[i]);
+      Encode(residual, pointCodes.colptr(i));
+    }
+  }
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    codes[assignments[i]].insert(codes[assignments[i]].end(),
+        pointCodes.colptr(i), pointCodes.colptr(i) + subspaces);
+    indices[assignments[i]].push_back(size + i);
+  }
+
+  size += points.n_cols;
+}
+
+void PQSearch::Search(const arma::mat& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances) const
+{
+  CheckSearch(querySet, k);
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+
+  #pragma omp parallel
+  {
+    arma::vec residual;
+    arma::mat table;
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      const arma::vec query(const_cast<double*>(querySet.colptr(i)),
+          querySet.n_rows, false, true);
+      SearchCodes(query, k, candidates, residual, table);
+
+      for (size_t j = 0; j < candidates.size(); ++j)
+      {
+        neighbors(j, i) = candidates[j].second;
+        distances(j, i) = std::sqrt(candidates[j].first);
+      }
+    }
+  }
+}
+
+void PQSearch::Search(const arma::mat& querySet,
+                      const arma::mat& referenceSet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const size_t rerank) const
+{
+  CheckSearch(querySet, k);
+
+  if (referenceSet.n_rows != dimensionality || referenceSet.n_cols != size)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): the reference set (" << referenceSet.n_rows
+        << " x " << referenceSet.n_cols << ") does not hold the points of the "
+        << "index (" << dimensionality << " x " << size << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(DBL_MAX);
+
+  const size_t numCandidates = std::min(std::max(k, rerank), size);
+  #pragma omp parallel
+  {
+    arma::vec residual;
+    arma::mat table;
+    std::vector<Candidate> candidates;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      const arma::vec query(const_cast<double*>(querySet.colptr(i)),
+          querySet.n_rows, false, true);
+      SearchCodes(query, numCandidates, candidates, residual, table);
+
+      for (size_t j = 0; j < candidates.size(); ++j)
+      {
+        candidates[j].first = metric::EuclideanDistance::Evaluate(query,
+            referenceSet.col(candidates[j].second));
+      }
+
+      const size_t found = std::min(k, candidates.size());
+      std::partial_sort(candidates.begin(), candidates.begin() + found,
+          candidates.end());
+      for (size_t j = 0; j < found; ++j)
+      {
+        neighbors(j, i) = candidates[j].second;
+        distances(j, i) = candidates[j].first;
+      }
+    }
+  }
+}
+
+size_t PQSearch::NearestList(const arma::vec& point) const
+{
+  size_t nearest = 0;
+  double nearestDistance = DBL_MAX;
+  for (size_t l = 0; l < coarseCentroids.n_cols; ++l)
+  {
+    const double distance = arma::accu(arma::square(point -
+        coarseCentroids.col(l)));
+    if (distance < nearestDistance)
+    {
+      nearest = l;
+      nearestDistance = distance;
+    }
+  }
+
+  return nearest;
+}
+
+void PQSearch::Encode(const arma::vec& residual, unsigned char* code) const
+{
+  for (size_t s = 0; s < subspaces; ++s)
+  {
+    size_t nearest = 0;
+    double nearestDistance = DBL_MAX;
+    for (size_t j = 0; j < codebook.n_cols; ++j)
+    {
+      const double* centroid = codebook.colptr(j);
+      double distance = 0.0;
+      for (size_t d = bounds[s]; d < bounds[s + 1]; ++d)
+        distance += (residual[d] - centroid[d]) * (residual[d] - centroid[d]);
+
+      if (distance < nearestDistance)
+      {
+        nearest = j;
+        nearestDistance = distance;
+      }
+    }
+
+    code[s] = (unsigned char) nearest;
+  }
+}
+
+void PQSearch::SearchCodes(const arma::vec& query,
+                           const size_t numCandidates,
+                           std::vector<Candidate>& candidates,
+                           arma::vec& residual,
+                           arma::mat& table) const
+{
+  // Find the lists to scan.
+  std::vector<Candidate> nearestLists(coarseCentroids.n_cols);
+  for (size_t l = 0; l < coarseCentroids.n_cols; ++l)
+  {
+    nearestLists[l] = Candidate(arma::accu(arma::square(query -
+        coarseCentroids.col(l))), l);
+  }
+  const size_t scanned = std::min(probes, nearestLists.size());
+  std::partial_sort(nearestLists.begin(), nearestLists.begin() + scanned,
+      nearestLists.end());
+
+  // The best candidates found so far, furthest first.
+  std::priority_queue<Candidate> best;
+  const size_t codewords = codebook.n_cols;
+  table.set_size(codewords, subspaces);
+  for (size_t p = 0; p < scanned; ++p)
+  {
+    const size_t list = nearestLists[p].second;
+    if (indices[list].empty())
+      continue;
+
+    // Entry (j, s) of the lookup table is the squared distance between the
+    // query and centroid j of group s, relative to the coarse centroid.
+    residual = query - coarseCentroids.col(list);
+    for (size_t s = 0; s < subspaces; ++s)
+    {
+      double* column = table.colptr(s);
+      for (size_t j = 0; j < codewords; ++j)
+      {
+        const double* centroid = codebook.colptr(j);
+        double distance = 0.0;
+        for (size_t d = bounds[s]; d < bounds[s + 1]; ++d)
+          distance += (residual[d] - centroid[d]) * (residual[d] - centroid[d]);
+        column[j] = distance;
+      }
+    }
+
+    const double* lookup = table.memptr();
+    const unsigned char* code = codes[list].data();
+    const std::vector<size_t>& listIndices = indices[list];
+    for (size_t i = 0; i < listIndices.size(); ++i, code += subspaces)
+    {
+      double distance = 0.0;
+      for (size_t s = 0; s < subspaces; ++s)
+        distance += lookup[s * codewords + code[s]];
+
+      if (best.size() < numCandidates)
+      {
+        best.push(Candidate(distance, listIndices[i]));
+      }
+      else if (distance < best.top().first)
+      {
+        best.pop();
+        best.push(Candidate(distance, listIndices[i]));
+      }
+    }
+  }
+
+  candidates.resize(best.size());
+  for (size_t i = best.size(); i > 0; --i)
+  {
+    candidates[i - 1] = best.top();
+    best.pop();
+  }
+}
+
+void PQSearch::CheckSearch(const arma::mat& querySet, const size_t k) const
+{
+  if (k > size)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but the index has " << size << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (querySet.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "PQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality of the "
+        << "index (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (probes == 0)
+    throw std::invalid_argument("PQSearch::Search(): probes must be positive");
+}
+
+} // namespace neighbor
+} // namespace mlpack
@@ -0,0 +1,256 @@
+/**
+ * @file pq_search.hpp
+ *
+ * Defines the PQSearch class, which performs approximate nearest neighbor
+ * search on a reference set compressed with product quantization.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PQ_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The PQSearch class is an index for approximate nearest neighbor search with
+ * the Euclidean distance that stores each reference point as a code of
+ * Subspaces() bytes rather than as its coordinates, so that very large
+ * reference sets fit in memory.
+ *
+ * The dimensions are split into Subspaces() contiguous groups, and k-means (the
+ * KMeans class) learns up to 256 centroids in each group from a training set;
+ * each byte of the code of a point is the closest centroid of one group.  If
+ * Lists() is more than 1, the points are first assigned to the closest of
+ * Lists() coarse centroids (also learned with k-means), and the code is that
+ * of the difference between the point and its coarse centroid.  The points of
+ * each coarse centroid form a list, and a search only scans the codes of the
+ * Probes() lists closest to the query (this is the IVF-PQ index; with a single
+ * list, every code is scanned).
+ *
+ * The distance between a query and a code is computed asymmetrically: the
+ * squared distances between the query and the centroids of each group are
+ * computed once per scanned list into a lookup table, and the distance to a
+ * code is then a sum of Subspaces() entries of the table.  The distances are
+ * approximate, so the candidates found may optionally be re-ranked with their
+ * exact distances if the caller still holds the reference set (for instance as
+ * a data::MappedMatrix).
+ *
+ * The training set given to Train() may be a sample of the reference set;
+ * the reference points are then encoded with Add(), possibly in several
+ * batches, and numbered consecutively.
+ *
+ * @code
+ * PQSearch pq(16, 1024);   // 16-byte codes, 1024 lists.
+ * pq.Train(sample);
+ * pq.Add(references);
+ * pq.Probes() = 16;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * pq.Search(queries, 10, neighbors, distances);
+ * @endcode
+ */
+class PQSearch
+{
+ public:
+  /**
+   * Create the index with the given settings; Train() and Add() must be called
+   * before Search().
+   *
+   * @param subspaces Number of groups of dimensions; this is the size of a code
+   *     in bytes.
+   * @param lists Number of coarse centroids (1 for plain product
+   *     quantization).
+   * @param probes Number of lists scanned by searches.
+   * @param maxIterations Maximum number of iterations of each k-means
+   *     clustering.
+   */
+  PQSearch(const size_t subspaces = 8,
+           const size_t lists = 1,
+           const size_t probes = 8,
+           const size_t maxIterations = 25);
+
+  /**
+   * Train the index on the given reference set, and encode it.
+   *
+   * @param referenceSet Set of reference points.
+   * @param subspaces Number of groups of dimensions (the size of a code).
+   * @param lists Number of coarse centroids (1 for plain product
+   *     quantization).
+   * @param probes Number of lists scanned by searches.
+   * @param maxIterations Maximum number of iterations of each k-means
+   *     clustering.
+   */
+  PQSearch(const arma::mat& referenceSet,
+           const size_t subspaces = 8,
+           const size_t lists = 1,
+           const size_t probes = 8,
+           const size_t maxIterations = 25);
+
+  /**
+   * Learn the coarse centroids and the centroids of each group of dimensions
+   * from the given training set, with the current Subspaces(), Lists() and
+   * MaxIterations().  The points that were added before are removed.
+   *
+   * @param trainingSet Set of points to learn the quantizers from (a sample of
+   *     the reference set is enough).
+   */
+  void Train(const arma::mat& trainingSet);
+
+  /**
+   * Encode the given points and add them to the index.  They are numbered
+   * after the points added before, in order.
+   *
+   * @param points Points to add.
+   */
+  void Add(const arma::mat& points);
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the query set
+   * from the codes, in parallel over the query points.  If the scanned lists
+   * hold fewer than k points for a query, the remaining neighbors are SIZE_MAX
+   * and the remaining distances DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the list of neighbors for each point
+   *     (one column per query point).
+   * @param distances Matrix to store the approximate distances to the
+   *     neighbors.
+   */
+  void Search(const arma::mat& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances) const;
+
+  /**
+   * Compute the approximate k nearest neighbors of each point of the query
+   * set, and re-rank the best `rerank` candidates found from the codes with
+   * their exact distances in the given reference set, which must hold the
+   * points that were added to the index, in order.
+   *
+   * @param querySet Set of query points.
+   * @param referenceSet The points that were added to the index.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the list of neighbors for each point
+   *     (one column per query point).
+   * @param distances Matrix to store the exact distances to the neighbors.
+   * @param rerank Number of candidates to re-rank (at least k are).
+   */
+  void Search(const arma::mat& querySet,
+              const arma::mat& referenceSet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t rerank) const;
+
+  //! Get the number of points in the index.
+  size_t Size() const { return size; }
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the number of groups of dimensions (the size of a code in bytes).
+  size_t Subspaces() const { return subspaces; }
+  //! Modify the number of groups of dimensions (only used by the next
+  //! Train()).
+  size_t& Subspaces() { return subspaces; }
+
+  //! Get the number of coarse centroids.
+  size_t Lists() const { return lists; }
+  //! Modify the number of coarse centroids (only used by the next Train()).
+  size_t& Lists() { return lists; }
+
+  //! Get the number of lists scanned by searches.
+  size_t Probes() const { return probes; }
+  //! Modify the number of lists scanned by searches.
+  size_t& Probes() { return probes; }
+
+  //! Get the maximum number of iterations of each k-means clustering.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of each k-means clustering.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the coarse centroids (one column per list).
+  const arma::mat& CoarseCentroids() const { return coarseCentroids; }
+  //! Get the centroids of the groups of dimensions; the rows of each group
+  //! hold the centroids of that group.
+  const arma::mat& Codebook() const { return codebook; }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! A point of the index and its distance to the query.
+  typedef std::pair<double, size_t> Candidate;
+
+  //! Find the list of the given point.
+  size_t NearestList(const arma::vec& point) const;
+
+  //! Encode the difference between a point and the centroid of its list.
+  void Encode(const arma::vec& residual, unsigned char* code) const;
+
+  /**
+   * Find the best numCandidates points for the given query from their codes,
+   * and store them sorted by squared distance.  The residual and table are
+   * scratch space of the calling thread.
+   */
+  void SearchCodes(const arma::vec& query,
+                   const size_t numCandidates,
+                   std::vector<Candidate>& candidates,
+                   arma::vec& residual,
+                   arma::mat& table) const;
+
+  //! Check the settings and the query set of a search.
+  void CheckSearch(const arma::mat& querySet, const size_t k) const;
+
+  //! The number of groups of dimensions.
+  size_t subspaces;
+  //! The number of coarse centroids.
+  size_t lists;
+  //! The number of lists scanned by searches.
+  size_t probes;
+  //! The maximum number of iterations of each k-means clustering.
+  size_t maxIterations;
+
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The first dimension of each group, and the dimensionality of the points.
+  std::vector<size_t> bounds;
+  //! The coarse centroids.
+  arma::mat coarseCentroids;
+  //! The centroids of each group of dimensions.
+  arma::mat codebook;
+
+  //! The codes of the points of each list, one after the other.
+  std::vector<std::vector<unsigned char>> codes;
+  //! The indices of the points of each list.
+  std::vector<std::vector<size_t>> indices;
+  //! The number of points in the index.
+  size_t size;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "pq_search_impl.hpp"
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file pq_search_impl.hpp
+ *
+ * Implementation of templated PQSearch functions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_PQ_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "pq_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename Archive>
+void PQSearch::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(subspaces);
+  ar & BOOST_SERIALIZATION_NVP(lists);
+  ar & BOOST_SERIALIZATION_NVP(probes);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(bounds);
+  ar & BOOST_SERIALIZATION_NVP(coarseCentroids);
+  ar & BOOST_SERIALIZATION_NVP(codebook);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+  ar & BOOST_SERIALIZATION_NVP(indices);
+  ar & BOOST_SERIALIZATION_NVP(size);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
 #include <mlpack/core/data/imputer.hpp>
+#include <mlpack/core/data/binarize.hpp>
 #include <mlpack/core/data/dataset_mapper.hpp>
 #include <mlpack/core/data/map_policies/increment_policy.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
@@ -40,7 +41,18 @@ PROGRAM_INFO("Impute Data",
     "column-wise dataset, and save the result to result.csv, we could run"
     "\n\n"
     "$ mlpack_preprocess_imputer -i dataset.csv -o result.csv -m NULL -d 0 \n"
-    "> -s listwise_deletion",
+    "> -s listwise_deletion"
+    "\n\n"
+    "The imputed dimensions can also be binarized with the given threshold by "
+    "specifying --binarize_threshold (-t): values greater than the threshold "
+    "are set to 1, and the others to 0.  This is done in the same pass over "
+    "each dimension as the imputation, and the dimensions are processed in "
+    "parallel.  For example, to replace 'NULL' in all dimensions with the mean "
+    "of the dimension and then binarize the dataset with a threshold of 0.5, "
+    "we could run"
+    "\n\n"
+    "$ mlpack_preprocess_imputer -i dataset.csv -o result.csv -m NULL \n"
+    "> -s mean -t 0.5",
     SEE_ALSO("@preprocess_binarize", "#preprocess_binarize"),
     SEE_ALSO("@preprocess_describe", "#preprocess_describe"),
     SEE_ALSO("@preprocess_split", "#preprocess_split"));
@@ -54,6 +66,8 @@ PARAM_STRING_IN_REQ("strategy", "imputation strategy to be applied. Strategies "
 PARAM_DOUBLE_IN("custom_value", "User-defined custom imputation value.", "c",
     0.0);
 PARAM_INT_IN("dimension", "The dimension to apply imputation to.", "d", 0);
+PARAM_DOUBLE_IN("binarize_threshold", "If specified, the dimensions are also "
+    "binarized with this threshold after the imputation.", "t", 0.0);
 
 using namespace mlpack;
 using namespace mlpack::util;
@@ -61,6 +75,73 @@ using namespace arma;
 using namespace std;
 using namespace data;
 
+/**
+ * Apply the imputation strategy to the dimensions that need it, and binarize
+ * all the given dimensions if requested.  If the strategy only modifies the
+ * dimension it imputes, each dimension is imputed and binarized in turn, with
+ * the dimensions in parallel; otherwise (for listwise deletion) the dimensions
+ * are imputed one after the other, and binarized afterwards.
+ */
+template<typename StrategyType>
+void Transform(arma::mat& input,
+               const DatasetMapper<MissingPolicy>& info,
+               const StrategyType& strategy,
+               const string& missingValue,
+               const std::vector<size_t>& dimensions,
+               const std::vector<char>& impute,
+               const bool binarize,
+               const double threshold)
+{
+  Imputer<double, DatasetMapper<MissingPolicy>, StrategyType> imputer(info,
+      strategy);
+
+  std::vector<size_t> imputed;
+  for (size_t i = 0; i < dimensions.size(); ++i)
+    if (impute[i])
+      imputed.push_back(dimensions[i]);
+
+  if (!binarize || !ImputesInPlace<StrategyType>::value)
+  {
+    imputer.Impute(input, missingValue, imputed);
+
+    if (binarize && dimensions.size() == input.n_rows)
+    {
+      Binarize(input, input, threshold);
+    }
+    else if (binarize)
+    {
+      for (size_t i = 0; i < dimensions.size(); ++i)
+        Binarize(input, input, threshold, dimensions[i]);
+    }
+    return;
+  }
+
+  // Exceptions can't leave an OpenMP region, so keep them until the end.
+  std::vector<std::exception_ptr> exceptions(dimensions.size());
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) dimensions.size(); ++i)
+  {
+    try
+    {
+      if (impute[i])
+        imputer.Impute(input, missingValue, dimensions[i]);
+
+      double* row = input.memptr() + dimensions[i];
+      for (size_t j = 0; j < input.n_cols; ++j)
+        row[j * input.n_rows] = row[j * input.n_rows] > threshold;
+    }
+    catch (...)
+    {
+      exceptions[i] = std::current_exception();
+    }
+  }
+
+  for (size_t i = 0; i < exceptions.size(); ++i)
+    if (exceptions[i])
+      std::rethrow_exception(exceptions[i]);
+}
+
 static void mlpackMain()
 {
   const string inputFile = CLI::GetParam<string>("input_file");
@@ -91,7 +172,6 @@ static void mlpackMain()
   std::set<std::string> missingSet;
   missingSet.insert(missingValue);
   MissingPolicy policy(missingSet);
-  using MapperType = DatasetMapper<MissingPolicy>;
   DatasetMapper<MissingPolicy> info(policy);
 
   Load(inputFile, input, info, true, true);
@@ -109,6 +189,20 @@ static void mlpackMain()
     }
   }
 
+  // Find the dimensions to process.
+  const bool binarize = CLI::HasParam("binarize_threshold");
+  std::vector<size_t> dimensions;
+  if (CLI::HasParam("dimension"))
+  {
+    dimensions.push_back(dimension);
+  }
+  else
+  {
+    for (size_t i = 0; i < input.n_rows; ++i)
+      dimensions.push_back(i);
+  }
+
+  std::vector<char> impute(dimensions.size(), 0);
   if (dirtyDimensions.size() == 0)
   {
     Log::Warn << "The file does not contain any user-defined missing "
@@ -124,87 +218,60 @@ static void mlpackMain()
   }
   else
   {
-    Timer::Start("imputation");
-    if (CLI::HasParam("dimension"))
-    {
-      // when --dimension is specified,
-      // the program will apply the changes to only the given dimension.
-      Log::Info << "Performing '" << strategy << "' imputation strategy "
-          << "to replace '" << missingValue << "' on dimension " << dimension
-          << "." << endl;
-      if (strategy == "mean")
-      {
-        Imputer<double, MapperType, MeanImputation<double>> imputer(info);
-        imputer.Impute(input, missingValue, dimension);
-      }
-      else if (strategy == "median")
-      {
-        Imputer<double, MapperType, MedianImputation<double>> imputer(info);
-        imputer.Impute(input, missingValue, dimension);
-      }
-      else if (strategy == "listwise_deletion")
-      {
-        Imputer<double, MapperType, ListwiseDeletion<double>> imputer(info);
-        imputer.Impute(input, missingValue, dimension);
-      }
-      else if (strategy == "custom")
-      {
-        CustomImputation<double> strat(customValue);
-        Imputer<double, MapperType, CustomImputation<double>> imputer(
-            info, strat);
-        imputer.Impute(input, missingValue, dimension);
-      }
-      else
-      {
-        Log::Fatal << "'" <<  strategy << "' imputation strategy does not exist"
-            << endl;
-      }
-    }
-    else
+    for (size_t i = 0; i < dimensions.size(); ++i)
     {
-      // when --dimension is not specified,
-      // the program will apply the changes to all dimensions.
-      Log::Info << "Performing '" << strategy << "' imputation strategy "
-          << "to replace '" << missingValue << "' on all dimensions." << endl;
-
-      if (strategy == "mean")
-      {
-        Imputer<double, MapperType, MeanImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
-      }
-      else if (strategy == "median")
-      {
-        Imputer<double, MapperType, MedianImputation<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
-      }
-      else if (strategy == "listwise_deletion")
-      {
-        Imputer<double, MapperType, ListwiseDeletion<double>> imputer(info);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
-      }
-      else if (strategy == "custom")
-      {
-        CustomImputation<double> strat(customValue);
-        Imputer<double, MapperType, CustomImputation<double>> imputer(
-            info, strat);
-        for (size_t i : dirtyDimensions)
-          imputer.Impute(input, missingValue, i);
-      }
-      else
-      {
-        Log::Fatal << "'" <<  strategy << "' imputation strategy does not "
-            << "exist!" << endl;
-      }
+      impute[i] = (std::find(dirtyDimensions.begin(), dirtyDimensions.end(),
+          dimensions[i]) != dirtyDimensions.end());
     }
-    Timer::Stop("imputation");
+  }
 
-    if (!outputFile.empty())
-    {
-      Log::Info << "Saving results to '" << outputFile << "'." << endl;
-      Save(outputFile, input, false);
-    }
+  if (std::find(impute.begin(), impute.end(), 1) == impute.end() && !binarize)
+    return;
+
+  Timer::Start("imputation");
+  if (CLI::HasParam("dimension"))
+  {
+    Log::Info << "Performing '" << strategy << "' imputation strategy "
+        << "to replace '" << missingValue << "' on dimension " << dimension
+        << "." << endl;
+  }
+  else
+  {
+    Log::Info << "Performing '" << strategy << "' imputation strategy "
+        << "to replace '" << missingValue << "' on all dimensions." << endl;
+  }
+
+  const double threshold = CLI::GetParam<double>("binarize_threshold");
+  if (strategy == "mean")
+  {
+    Transform(input, info, MeanImputation<double>(), missingValue, dimensions,
+        impute, binarize, threshold);
+  }
+  else if (strategy == "median")
+  {
+    Transform(input, info, MedianImputation<double>(), missingValue,
+        dimensions, impute, binarize, threshold);
+  }
+  else if (strategy == "listwise_deletion")
+  {
+    Transform(input, info, ListwiseDeletion<double>(), missingValue,
+        dimensions, impute, binarize, threshold);
+  }
+  else if (strategy == "custom")
+  {
+    Transform(input, info, CustomImputation<double>(customValue),
+        missingValue, dimensions, impute, binarize, threshold);
+  }
+  else
+  {
+    Log::Fatal << "'" <<  strategy << "' imputation strategy does not exist!"
+        << endl;
+  }
+  Timer::Stop("imputation");
+
+  if (!outputFile.empty())
+  {
+    Log::Info << "Saving results to '" << outputFile << "'." << endl;
+    Save(outputFile, input, false);
   }
 }
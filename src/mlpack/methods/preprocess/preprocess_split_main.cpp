@@ -35,7 +35,10 @@ PROGRAM_INFO("Split Data",
     "labels works the same way as splitting the data. The output training and "
     "test labels may be saved with the " +
     PRINT_PARAM_STRING("training_labels") + " and " +
-    PRINT_PARAM_STRING("test_labels") + " output parameters, respectively."
+    PRINT_PARAM_STRING("test_labels") + " output parameters, respectively.  "
+    "If " + PRINT_PARAM_STRING("stratify_data") + " is specified, each label "
+    "gets the same share of its points in the test set, so that the "
+    "proportions of the labels are kept in both sets."
     "\n\n"
     "So, a simple example where we want to split the dataset " +
     PRINT_DATASET("X") + " into " + PRINT_DATASET("X_train") + " and " +
@@ -73,6 +76,8 @@ PARAM_DOUBLE_IN("test_ratio", "Ratio of test set; if not set,"
     "the ratio defaults to 0.2", "r", 0.2);
 
 PARAM_INT_IN("seed", "Random seed (0 for std::time(NULL)).", "s", 0);
+PARAM_FLAG("stratify_data", "Stratify the split by the labels, so that each "
+    "label has the same proportion of points in the test set.", "z");
 
 using namespace mlpack;
 using namespace mlpack::util;
@@ -106,6 +111,7 @@ static void mlpackMain()
   {
     ReportIgnoredParam({{ "input_labels", true }}, "training_labels");
     ReportIgnoredParam({{ "input_labels", true }}, "test_labels");
+    ReportIgnoredParam({{ "input_labels", true }}, "stratify_data");
   }
 
   // Check test_ratio.
@@ -129,7 +135,8 @@ static void mlpackMain()
         CLI::GetParam<arma::Mat<size_t>>("input_labels");
     arma::Row<size_t> labelsRow = labels.row(0);
 
-    const auto value = data::Split(data, labelsRow, testRatio);
+    auto value = data::Split(data, labelsRow, testRatio,
+        CLI::HasParam("stratify_data"));
     Log::Info << "Training data contains " << get<0>(value).n_cols << " points."
         << endl;
     Log::Info << "Test data contains " << get<1>(value).n_cols << " points."
@@ -148,7 +155,7 @@ static void mlpackMain()
   }
   else // We have no labels, so just split the dataset.
   {
-    const auto value = data::Split(data, testRatio);
+    auto value = data::Split(data, testRatio);
     Log::Info << "Training data contains " << get<0>(value).n_cols << " points."
         << endl;
     Log::Info << "Test data contains " << get<1>(value).n_cols << " points."
@@ -11,6 +11,7 @@
  */
 
 #include "radical.hpp"
+#include <mlpack/core/math/random.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
@@ -37,15 +38,20 @@ Radical::Radical(const double noiseStdDev,
 void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 {
   Timer::Start("radical_copy_and_perturb");
-  xNew = repmat(x, replicates, 1) + noiseStdDev * randn(replicates * x.n_rows,
-      x.n_cols);
+  // The noise is drawn from the generator of the calling thread, so that
+  // pairs of dimensions can be perturbed in parallel.
+  xNew.set_size(replicates * x.n_rows, x.n_cols);
+  math::RandNormalFill(xNew, 0.0, noiseStdDev);
+  for (size_t i = 0; i < replicates; i++)
+    xNew.rows(i * x.n_rows, (i + 1) * x.n_rows - 1) += x;
   Timer::Stop("radical_copy_and_perturb");
 }
 
 
 double Radical::Vasicek(vec& z) const
 {
-  z = sort(z);
+  // Sort in place, so that the buffer of z is reused.
+  std::sort(z.begin(), z.end());
 
   // Apparently slower.
   /*
@@ -68,28 +74,38 @@ double Radical::Vasicek(vec& z) const
 
 double Radical::DoRadical2D(const mat& matX)
 {
-  CopyAndPerturb(perturbed, matX);
+  return Radical2D(matX, perturbed);
+}
+
 
-  mat::fixed<2, 2> matJacobi;
+double Radical::Radical2D(const mat& matX, mat& perturbedX) const
+{
+  CopyAndPerturb(perturbedX, matX);
 
   vec values(angles);
 
-  for (size_t i = 0; i < angles; i++)
+  // The angles are independent, so they are tried in parallel, each thread
+  // with its own buffers for the rotated coordinates.  When the pairs of
+  // dimensions are already split between threads, this runs on one thread.
+  #pragma omp parallel if (angles > 1)
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    vec candidateY1(perturbedX.n_rows);
+    vec candidateY2(perturbedX.n_rows);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) angles; i++)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+      // This is the rotation of the points by the Jacobi matrix
+      // [cos(theta) sin(theta); -sin(theta) cos(theta)].
+      candidateY1 = cosTheta * perturbedX.col(0) - sinTheta * perturbedX.col(1);
+      candidateY2 = sinTheta * perturbedX.col(0) + cosTheta * perturbedX.col(1);
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+      values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    }
   }
 
   uword indOpt = 0;
@@ -132,42 +148,65 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
   Timer::Start("radical_do_radical");
   matW = matWhitening;
 
-  mat matYSubspace(nPoints, 2);
-
-  mat matJ = eye(nDims, nDims);
+  // Each sweep visits every pair of dimensions once, in the rounds of a
+  // round-robin tournament: the pairs of a round share no dimension, so their
+  // rotations commute, and the angles of a round are found in parallel.
+  std::vector<std::vector<std::pair<size_t, size_t>>> rounds;
+  PairRounds(nDims, rounds);
 
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
 
-    for (size_t i = 0; i < nDims - 1; i++)
+    for (size_t r = 0; r < rounds.size(); r++)
     {
-      for (size_t j = i + 1; j < nDims; j++)
+      const std::vector<std::pair<size_t, size_t>>& pairs = rounds[r];
+
+      // Each pair perturbs its data with its own stream of random numbers, so
+      // the result does not depend on the number of threads.
+      std::vector<math::RandomEngine> streams = math::RandomStreams(
+          pairs.size());
+      const math::RandomEngine engine = math::randGen;
+
+      vec thetaOpt(pairs.size());
+      #pragma omp parallel if (pairs.size() > 1)
       {
-        Log::Debug << "RADICAL 2D on dimensions " << i << " and " << j << "."
-            << std::endl;
+        mat matYSubspace(nPoints, 2);
+        mat perturbedSubspace;
+
+        #pragma omp for schedule(dynamic)
+        for (omp_size_t p = 0; p < (omp_size_t) pairs.size(); p++)
+        {
+          const size_t i = pairs[p].first;
+          const size_t j = pairs[p].second;
 
-        matYSubspace.col(0) = matY.col(i);
-        matYSubspace.col(1) = matY.col(j);
+          math::randGen = streams[p];
+          math::randNormalDist.reset();
 
-        const double thetaOpt = DoRadical2D(matYSubspace);
+          matYSubspace.col(0) = matY.col(i);
+          matYSubspace.col(1) = matY.col(j);
+
+          thetaOpt[p] = Radical2D(matYSubspace, perturbedSubspace);
+        }
+      }
 
-        const double cosThetaOpt = cos(thetaOpt);
-        const double sinThetaOpt = sin(thetaOpt);
+      math::randGen = engine;
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
+      // Rotate each pair of dimensions of the data and of the unmixing
+      // matrix, which is the same as multiplying them by the Jacobi matrix of
+      // each pair.
+      for (size_t p = 0; p < pairs.size(); p++)
+      {
+        Log::Debug << "RADICAL 2D on dimensions " << pairs[p].first << " and "
+            << pairs[p].second << ": angle " << thetaOpt[p] << "." << std::endl;
 
-        matY *= matJ;
+        const double cosThetaOpt = cos(thetaOpt[p]);
+        const double sinThetaOpt = sin(thetaOpt[p]);
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        RotateColumns(matY, pairs[p].first, pairs[p].second, cosThetaOpt,
+            sinThetaOpt);
+        RotateColumns(matW, pairs[p].first, pairs[p].second, cosThetaOpt,
+            sinThetaOpt);
       }
     }
   }
@@ -181,6 +220,42 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
   Timer::Stop("radical_transpose_data");
 }
 
+void Radical::PairRounds(
+    const size_t nDims,
+    std::vector<std::vector<std::pair<size_t, size_t>>>& rounds)
+{
+  rounds.clear();
+  if (nDims < 2)
+    return;
+
+  // With the circle method, one dimension stays in place and the others turn
+  // around it; an odd number of dimensions gets a phantom one, whose partner
+  // sits out the round.
+  const size_t n = (nDims % 2 == 0) ? nDims : nDims + 1;
+  rounds.resize(n - 1);
+  for (size_t r = 0; r < n - 1; r++)
+  {
+    for (size_t k = 0; k < n / 2; k++)
+    {
+      const size_t a = (k == 0) ? n - 1 : (r + k) % (n - 1);
+      const size_t b = (r + n - 1 - k) % (n - 1);
+      if (a < nDims && b < nDims)
+        rounds[r].push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+    }
+  }
+}
+
+void Radical::RotateColumns(mat& matX,
+                            const size_t i,
+                            const size_t j,
+                            const double cosTheta,
+                            const double sinTheta)
+{
+  const vec colI = matX.col(i);
+  matX.col(i) = cosTheta * colI - sinTheta * matX.col(j);
+  matX.col(j) = sinTheta * colI + cosTheta * matX.col(j);
+}
+
 void mlpack::radical::WhitenFeatureMajorMatrix(const mat& matX,
                                                mat& matXWhitened,
                                                mat& matWhitening)
@@ -91,6 +91,19 @@ class Radical
   //! Two-dimensional version of RADICAL.
   double DoRadical2D(const arma::mat& matX);
 
+  /**
+   * Split the pairs of the given number of dimensions into rounds, in which no
+   * two pairs share a dimension, so that the pairs of each round can be
+   * handled in parallel.  There are nDims - 1 rounds for an even number of
+   * dimensions, and nDims rounds for an odd number.
+   *
+   * @param nDims Number of dimensions.
+   * @param rounds Pairs (i, j), with i < j, of each round.
+   */
+  static void PairRounds(
+      const size_t nDims,
+      std::vector<std::vector<std::pair<size_t, size_t>>>& rounds);
+
   //! Get the standard deviation of the additive Gaussian noise.
   double NoiseStdDev() const { return noiseStdDev; }
   //! Modify the standard deviation of the additive Gaussian noise.
@@ -112,6 +125,19 @@ class Radical
   size_t& Sweeps() { return sweeps; }
 
  private:
+  /**
+   * Two-dimensional version of RADICAL, which perturbs the data into the given
+   * matrix, so that it can be called from several threads at once.
+   */
+  double Radical2D(const arma::mat& matX, arma::mat& perturbedX) const;
+
+  //! Rotate columns i and j of the given matrix by the given angle.
+  static void RotateColumns(arma::mat& matX,
+                            const size_t i,
+                            const size_t j,
+                            const double cosTheta,
+                            const double sinTheta);
+
   //! Standard deviation of the Gaussian noise added to the replicates of
   //! the data points during Radical2D.
   double noiseStdDev;
@@ -131,8 +157,6 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
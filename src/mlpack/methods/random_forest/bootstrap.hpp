@@ -3,7 +3,9 @@
  * @author Ryan Curtin
  *
  * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * dataset from the given input dataset, and the MultiplicityBootstrap()
+ * function,
+ * which represents a bootstrap sample by the multiplicity of each point.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -36,8 +38,8 @@ void Bootstrap(const MatType& dataset,
     bootstrapWeights.set_size(weights.n_elem);
 
   // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  arma::uvec indices(dataset.n_cols);
+  math::RandIntFill(indices, 0, (int) dataset.n_cols);
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
     bootstrapDataset.col(i) = dataset.col(indices[i]);
@@ -47,6 +49,46 @@ void Bootstrap(const MatType& dataset,
   }
 }
 
+/**
+ * Given a dataset, draw a bootstrap sample, and represent it by the distinct
+ * points of the sample, each weighted by the number of times it was drawn
+ * (times its weight, if UseWeights is true).  Training a weighted learner on
+ * this dataset is equivalent to training it on the bootstrapped dataset of
+ * Bootstrap(), but only about 63% of the points are copied, and no point is
+ * copied twice.  The distinct points keep their order in the dataset.
+ */
+template<bool UseWeights,
+         typename MatType,
+         typename LabelsType,
+         typename WeightsType>
+void MultiplicityBootstrap(const MatType& dataset,
+                           const LabelsType& labels,
+                           const WeightsType& weights,
+                           MatType& bootstrapDataset,
+                           LabelsType& bootstrapLabels,
+                           arma::rowvec& bootstrapWeights)
+{
+  // Random sampling with replacement, only keeping the number of times each
+  // point is drawn.
+  arma::uvec indices(dataset.n_cols);
+  math::RandIntFill(indices, 0, (int) dataset.n_cols);
+  arma::uvec multiplicities(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    ++multiplicities[indices[i]];
+
+  const arma::uvec distinct = arma::find(multiplicities);
+  bootstrapDataset = dataset.cols(distinct);
+  bootstrapLabels.set_size(distinct.n_elem);
+  bootstrapWeights.set_size(distinct.n_elem);
+  for (size_t i = 0; i < distinct.n_elem; ++i)
+  {
+    bootstrapLabels[i] = labels[distinct[i]];
+    bootstrapWeights[i] = (double) multiplicities[distinct[i]];
+    if (UseWeights)
+      bootstrapWeights[i] *= weights[distinct[i]];
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,239 @@
+/**
+ * @file compact_random_forest.hpp
+ *
+ * Definition of the CompactRandomForest class, a flattened representation of
+ * a trained RandomForest for fast batch inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPACT_RANDOM_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPACT_RANDOM_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The CompactSplitTraits class describes how the CalculateDirection() function
+ * of a split type can be evaluated by a CompactRandomForest.  A split type can
+ * only be flattened if one of the traits is true; specialize this class for
+ * custom split types that behave like the splits below.
+ *
+ * @tparam SplitType The numeric or categorical split type.
+ */
+template<typename SplitType>
+struct CompactSplitTraits
+{
+  //! The split sends a point to child 0 if its value is less than or equal to
+  //! classProbabilities[0], and to child 1 otherwise.
+  static const bool IsBinaryThreshold = false;
+  //! The split sends a point to the child given by its (categorical) value.
+  static const bool IsCategoryIndex = false;
+};
+
+template<typename FitnessFunction>
+struct CompactSplitTraits<BestBinaryNumericSplit<FitnessFunction>>
+{
+  static const bool IsBinaryThreshold = true;
+  static const bool IsCategoryIndex = false;
+};
+
+template<typename FitnessFunction, size_t NumBins>
+struct CompactSplitTraits<BinnedNumericSplit<FitnessFunction, NumBins>>
+{
+  static const bool IsBinaryThreshold = true;
+  static const bool IsCategoryIndex = false;
+};
+
+template<typename FitnessFunction>
+struct CompactSplitTraits<AllCategoricalSplit<FitnessFunction>>
+{
+  static const bool IsBinaryThreshold = false;
+  static const bool IsCategoryIndex = true;
+};
+
+/**
+ * The CompactRandomForest is a read-only, flattened copy of a trained
+ * RandomForest (or of a set of DecisionTrees) that is meant for fast
+ * inference.  Instead of a tree of heap-allocated nodes, all the nodes of all
+ * the trees are stored in a few contiguous arrays (split dimension, split
+ * value, index of the first child and node type), with the children of each
+ * node stored next to each other.  The class probabilities of the leaves are
+ * stored in a single matrix with one column per leaf.
+ *
+ * Batch classification processes the points in blocks: each tree is traversed
+ * for all the points of a block at once, one level at a time, so the nodes at
+ * the top of the tree stay in cache and the inner loop is the same simple
+ * operation for each point.  The predictions and probabilities are the same
+ * as those of the original RandomForest.
+ *
+ * The compact form can be serialized, and loading it is much faster than
+ * loading the RandomForest, since only a few arrays must be read.
+ */
+class CompactRandomForest
+{
+ public:
+  /**
+   * Create an empty compact forest.  Classify() will throw an exception until
+   * trees are added or the forest is loaded.
+   */
+  CompactRandomForest() : numClasses(0) { }
+
+  /**
+   * Create a compact forest from the given trained random forest.  The split
+   * types of the forest must be supported by CompactSplitTraits.
+   *
+   * @param forest Random forest to flatten.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  CompactRandomForest(const RandomForest<FitnessFunction,
+                                         DimensionSelectionType,
+                                         NumericSplitType,
+                                         CategoricalSplitType,
+                                         ElemType>& forest);
+
+  /**
+   * Add the given trained decision tree to the compact forest.  All the trees
+   * of the forest must have the same number of classes.  The split types of
+   * the tree must be supported by CompactSplitTraits.
+   *
+   * @param tree Decision tree to flatten and add.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  void AddTree(const DecisionTree<FitnessFunction,
+                                  NumericSplitType,
+                                  CategoricalSplitType,
+                                  DimensionSelectionType,
+                                  ElemType,
+                                  NoRecursion>& tree);
+
+  /**
+   * Predict the class of the given point.  If the forest is empty, this will
+   * throw an exception.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.  If the forest is empty, this will throw an
+   * exception.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.  If the forest is
+   * empty, this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.  If the forest is empty,
+   * this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees in the forest.
+  size_t NumTrees() const { return treeRoots.n_elem; }
+  //! Get the total number of nodes of all the trees.
+  size_t NumNodes() const { return nodeTypes.n_elem; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Serialize the compact forest.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The types of the nodes.
+  enum NodeType
+  {
+    LEAF = 0,
+    NUMERIC_SPLIT = 1,
+    CATEGORICAL_SPLIT = 2
+  };
+
+  //! Number of points classified together by the batch Classify().
+  static const size_t BlockSize = 64;
+
+  /**
+   * Return the node that a point goes to from the given node, given the value
+   * of the point in the split dimension of the node.  If the node is a leaf,
+   * the node itself is returned.
+   */
+  template<typename ValueType>
+  size_t NextNode(const size_t node, const ValueType value) const;
+
+  /**
+   * Return the column of leafProbabilities of the leaf of the given tree that
+   * the given point falls into.
+   */
+  template<typename VecType>
+  size_t FindLeaf(const size_t tree, const VecType& point) const;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The index of the root node of each tree.
+  arma::Col<size_t> treeRoots;
+  //! The depth of each tree (the number of splits on its longest path).
+  arma::Col<size_t> treeDepths;
+  //! The type of each node (a NodeType).
+  arma::Col<unsigned char> nodeTypes;
+  //! The split dimension of each non-leaf node (0 for leaves, so that it can
+  //! always be read).
+  arma::Col<size_t> splitDimensions;
+  //! The split value of each numeric split node (unused for other nodes).
+  arma::vec splitValues;
+  //! The index of the first child of each non-leaf node (the other children
+  //! follow it), or the column of leafProbabilities of each leaf.
+  arma::Col<size_t> firstChildren;
+  //! The class probabilities of each leaf, one column per leaf.
+  arma::mat leafProbabilities;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "compact_random_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,286 @@
+/**
+ * @file compact_random_forest_impl.hpp
+ *
+ * Implementation of the CompactRandomForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPACT_RANDOM_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPACT_RANDOM_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compact_random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+CompactRandomForest::CompactRandomForest(
+    const RandomForest<FitnessFunction,
+                       DimensionSelectionType,
+                       NumericSplitType,
+                       CategoricalSplitType,
+                       ElemType>& forest) :
+    numClasses(0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void CompactRandomForest::AddTree(const DecisionTree<FitnessFunction,
+                                                     NumericSplitType,
+                                                     CategoricalSplitType,
+                                                     DimensionSelectionType,
+                                                     ElemType,
+                                                     NoRecursion>& tree)
+{
+  typedef DecisionTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+      DimensionSelectionType, ElemType, NoRecursion> TreeType;
+  typedef CompactSplitTraits<NumericSplitType<FitnessFunction>> NumericTraits;
+  typedef CompactSplitTraits<CategoricalSplitType<FitnessFunction>>
+      CategoricalTraits;
+
+  static_assert(NumericTraits::IsBinaryThreshold ||
+      NumericTraits::IsCategoryIndex, "CompactRandomForest::AddTree(): the "
+      "numeric split type is not supported by CompactSplitTraits!");
+  static_assert(CategoricalTraits::IsBinaryThreshold ||
+      CategoricalTraits::IsCategoryIndex, "CompactRandomForest::AddTree(): the "
+      "categorical split type is not supported by CompactSplitTraits!");
+
+  const size_t treeClasses = tree.NumClasses();
+  if (NumTrees() == 0)
+  {
+    numClasses = treeClasses;
+    leafProbabilities.set_size(numClasses, 0);
+  }
+  else if (treeClasses != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "CompactRandomForest::AddTree(): tree has " << treeClasses
+        << " classes, but the forest has " << numClasses << " classes!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Lay the nodes out in breadth-first order, so that the children of each
+  // node are contiguous and the top levels of the tree are close together.
+  const size_t offset = NumNodes();
+  const size_t leafOffset = leafProbabilities.n_cols;
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<size_t> depths(1, 0);
+  std::vector<const TreeType*> leaves;
+  std::vector<unsigned char> types;
+  std::vector<size_t> dimensions, firsts;
+  std::vector<double> values;
+  size_t depth = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType& node = *nodes[i];
+    if (node.NumChildren() == 0)
+    {
+      types.push_back(LEAF);
+      dimensions.push_back(0);
+      values.push_back(0.0);
+      firsts.push_back(leafOffset + leaves.size());
+      leaves.push_back(&node);
+      continue;
+    }
+
+    const bool categorical = ((data::Datatype)
+        node.DimensionTypeOrMajorityClass() == data::Datatype::categorical);
+    const bool threshold = categorical ? CategoricalTraits::IsBinaryThreshold :
+        NumericTraits::IsBinaryThreshold;
+
+    types.push_back(threshold ? NUMERIC_SPLIT : CATEGORICAL_SPLIT);
+    dimensions.push_back(node.SplitDimension());
+    values.push_back(threshold ? node.ClassProbabilities()[0] : 0.0);
+    firsts.push_back(offset + nodes.size());
+    for (size_t c = 0; c < node.NumChildren(); ++c)
+    {
+      nodes.push_back(&node.Child(c));
+      depths.push_back(depths[i] + 1);
+    }
+    depth = std::max(depth, depths[i] + 1);
+  }
+
+  treeRoots.resize(treeRoots.n_elem + 1);
+  treeRoots[treeRoots.n_elem - 1] = offset;
+  treeDepths.resize(treeDepths.n_elem + 1);
+  treeDepths[treeDepths.n_elem - 1] = depth;
+
+  nodeTypes = arma::join_cols(nodeTypes, arma::Col<unsigned char>(types));
+  splitDimensions = arma::join_cols(splitDimensions,
+      arma::Col<size_t>(dimensions));
+  splitValues = arma::join_cols(splitValues, arma::vec(values));
+  firstChildren = arma::join_cols(firstChildren, arma::Col<size_t>(firsts));
+
+  leafProbabilities.resize(numClasses, leafOffset + leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+    leafProbabilities.col(leafOffset + i) = leaves[i]->ClassProbabilities();
+}
+
+template<typename VecType>
+size_t CompactRandomForest::Classify(const VecType& point) const
+{
+  // Pass off to another Classify() overload.
+  size_t predictedClass;
+  arma::vec probabilities;
+  Classify(point, predictedClass, probabilities);
+
+  return predictedClass;
+}
+
+template<typename VecType>
+void CompactRandomForest::Classify(const VecType& point,
+                                   size_t& prediction,
+                                   arma::vec& probabilities) const
+{
+  // Check edge case.
+  if (NumTrees() == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("CompactRandomForest::Classify(): no trees in "
+        "the forest!");
+  }
+
+  probabilities.zeros(numClasses);
+  for (size_t i = 0; i < NumTrees(); ++i)
+    probabilities += leafProbabilities.col(FindLeaf(i, point));
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= NumTrees();
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+
+  // Set prediction.
+  prediction = (size_t) maxIndex;
+}
+
+template<typename MatType>
+void CompactRandomForest::Classify(const MatType& data,
+                                   arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void CompactRandomForest::Classify(const MatType& data,
+                                   arma::Row<size_t>& predictions,
+                                   arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (NumTrees() == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("CompactRandomForest::Classify(): no trees in "
+        "the forest!");
+  }
+
+  probabilities.zeros(numClasses, data.n_cols);
+  predictions.set_size(data.n_cols);
+
+  const size_t blockSize = BlockSize;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t count = std::min(blockSize, (size_t) data.n_cols - begin);
+
+    // Walk each tree for all the points of the block at once, one level at a
+    // time.  Points that reach a leaf early stay there.
+    size_t nodes[BlockSize];
+    for (size_t t = 0; t < NumTrees(); ++t)
+    {
+      std::fill(nodes, nodes + count, treeRoots[t]);
+      for (size_t d = 0; d < treeDepths[t]; ++d)
+      {
+        for (size_t j = 0; j < count; ++j)
+        {
+          nodes[j] = NextNode(nodes[j], data(splitDimensions[nodes[j]],
+              begin + j));
+        }
+      }
+
+      for (size_t j = 0; j < count; ++j)
+      {
+        const double* leaf = leafProbabilities.colptr(firstChildren[nodes[j]]);
+        double* out = probabilities.colptr(begin + j);
+        for (size_t c = 0; c < numClasses; ++c)
+          out[c] += leaf[c];
+      }
+    }
+
+    // Find maximum element after renormalizing probabilities.
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      probabilities.col(j) /= NumTrees();
+      arma::uword maxIndex = 0;
+      probabilities.col(j).max(maxIndex);
+      predictions[j] = (size_t) maxIndex;
+    }
+  }
+}
+
+template<typename Archive>
+void CompactRandomForest::serialize(Archive& ar,
+                                    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+  ar & BOOST_SERIALIZATION_NVP(treeRoots);
+  ar & BOOST_SERIALIZATION_NVP(treeDepths);
+  ar & BOOST_SERIALIZATION_NVP(nodeTypes);
+  ar & BOOST_SERIALIZATION_NVP(splitDimensions);
+  ar & BOOST_SERIALIZATION_NVP(splitValues);
+  ar & BOOST_SERIALIZATION_NVP(firstChildren);
+  ar & BOOST_SERIALIZATION_NVP(leafProbabilities);
+}
+
+template<typename ValueType>
+inline size_t CompactRandomForest::NextNode(const size_t node,
+                                            const ValueType value) const
+{
+  switch (nodeTypes[node])
+  {
+    case NUMERIC_SPLIT:
+      return firstChildren[node] + ((value <= splitValues[node]) ? 0 : 1);
+    case CATEGORICAL_SPLIT:
+      return firstChildren[node] + (size_t) value;
+    default:
+      return node;
+  }
+}
+
+template<typename VecType>
+size_t CompactRandomForest::FindLeaf(const size_t tree,
+                                     const VecType& point) const
+{
+  size_t node = treeRoots[tree];
+  while (nodeTypes[node] != LEAF)
+    node = NextNode(node, point[splitDimensions[node]]);
+
+  return firstChildren[node];
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,40 @@
+/**
+ * @file random_forest.cpp
+ *
+ * Force instantiation of the default RandomForest, and of its training and
+ * batch classification on arma::mat, to reduce compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template class RandomForest<>;
+
+template void RandomForest<>::Train(const arma::mat&,
+                                    const arma::Row<size_t>&,
+                                    const size_t,
+                                    const size_t,
+                                    const size_t);
+
+template void RandomForest<>::Train(const arma::mat&,
+                                    const data::DatasetInfo&,
+                                    const arma::Row<size_t>&,
+                                    const size_t,
+                                    const size_t,
+                                    const size_t);
+
+template void RandomForest<>::Classify(const arma::mat&,
+                                       arma::Row<size_t>&) const;
+
+template void RandomForest<>::Classify(const arma::mat&,
+                                       arma::Row<size_t>&,
+                                       arma::mat&) const;
+
+} // namespace tree
+} // namespace mlpack
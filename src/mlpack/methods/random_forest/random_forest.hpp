@@ -12,6 +12,7 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_RANDOM_FOREST_HPP
 
+#include <mlpack/core/util/parallel.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
 #include "bootstrap.hpp"
@@ -35,7 +36,11 @@ class RandomForest
    * Construct the random forest without any training or specifying the number
    * of trees.  Predict() will throw an exception until Train() is called.
    */
-  RandomForest() { }
+  RandomForest() :
+      numClasses(0),
+      dimensionality(0),
+      weightedBootstrap(false)
+  { }
 
   /**
    * Create a random forest, training on the given labeled training data with
@@ -201,6 +206,211 @@ class RandomForest
              const size_t numTrees = 50,
              const size_t minimumLeafSize = 20);
 
+  /**
+   * Add the given number of trees to the forest, trained on the given labeled
+   * data, and keep the trees that are already in the forest.  The forest must
+   * have been trained, and the data must have the dimensionality and number of
+   * classes of the forest.  The trees are kept in the order they were added,
+   * so RemoveOldestTrees() followed by AddTrees() replaces the oldest trees
+   * with trees trained on new data.
+   *
+   * @param data Dataset to train the new trees on.
+   * @param labels Labels for dataset.
+   * @param numTrees Number of trees to add.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void AddTrees(const MatType& data,
+                const arma::Row<size_t>& labels,
+                const size_t numTrees,
+                const size_t minimumLeafSize = 20);
+
+  /**
+   * Add the given number of trees to the forest, trained on the given labeled
+   * data with the given dataset info; see the other overload.
+   *
+   * @param data Dataset to train the new trees on.
+   * @param datasetInfo Dimension info for the dataset.
+   * @param labels Labels for dataset.
+   * @param numTrees Number of trees to add.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void AddTrees(const MatType& data,
+                const data::DatasetInfo& datasetInfo,
+                const arma::Row<size_t>& labels,
+                const size_t numTrees,
+                const size_t minimumLeafSize = 20);
+
+  /**
+   * Add the given number of trees to the forest, trained on the given weighted
+   * labeled data; see the other overload.
+   *
+   * @param data Dataset to train the new trees on.
+   * @param labels Labels for dataset.
+   * @param weights Weights (importances) of each point in the dataset.
+   * @param numTrees Number of trees to add.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void AddTrees(const MatType& data,
+                const arma::Row<size_t>& labels,
+                const arma::rowvec& weights,
+                const size_t numTrees,
+                const size_t minimumLeafSize = 20);
+
+  /**
+   * Add the given number of trees to the forest, trained on the given weighted
+   * labeled data with the given dataset info; see the other overload.
+   *
+   * @param data Dataset to train the new trees on.
+   * @param datasetInfo Dimension info for the dataset.
+   * @param labels Labels for dataset.
+   * @param weights Weights (importances) of each point in the dataset.
+   * @param numTrees Number of trees to add.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void AddTrees(const MatType& data,
+                const data::DatasetInfo& datasetInfo,
+                const arma::Row<size_t>& labels,
+                const arma::rowvec& weights,
+                const size_t numTrees,
+                const size_t minimumLeafSize = 20);
+
+  /**
+   * Remove the given number of trees that were added to the forest first.  The
+   * number of classes and the dimensionality of the forest are kept, so trees
+   * can be added again even if all the trees are removed.
+   *
+   * @param numTrees Number of trees to remove.
+   */
+  void RemoveOldestTrees(const size_t numTrees);
+
+  /**
+   * Train the given shard of a forest of the given number of trees, for
+   * training a forest on several processes (or nodes): the trees are split
+   * into numShards contiguous shards, each process trains one shard, and the
+   * shards are gathered (for instance serialized) and merged in order with
+   * Merge().  Tree i of the forest draws its random numbers from stream i of
+   * math::RandomStreams(), so if each process seeds the random number
+   * generator with the same global seed (with math::RandomSeed()) before
+   * training its shard, and all the processes have the same data, the merged
+   * forest is the same as the forest given by Train() after that seed on one
+   * process, whatever the number of shards (as long as the nodes of each tree
+   * are not split by OpenMP tasks, which draw from the generators of the
+   * threads that run them; see DecisionTreeParallelMinSize).  Any trees in
+   * the forest are replaced.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the whole forest.
+   * @param shard Index of the shard to train (between 0 and numShards - 1).
+   * @param numShards Number of shards the forest is split into.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void TrainShard(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const size_t numTrees,
+                  const size_t shard,
+                  const size_t numShards,
+                  const size_t minimumLeafSize = 20);
+
+  /**
+   * Train the given shard of a forest of the given number of trees on the
+   * given labeled data with the given dataset info; see the other overload.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Dimension info for the dataset.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param numTrees Number of trees in the whole forest.
+   * @param shard Index of the shard to train (between 0 and numShards - 1).
+   * @param numShards Number of shards the forest is split into.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void TrainShard(const MatType& data,
+                  const data::DatasetInfo& datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const size_t numTrees,
+                  const size_t shard,
+                  const size_t numShards,
+                  const size_t minimumLeafSize = 20);
+
+  /**
+   * Train the given shard of a forest of the given number of trees on the
+   * given weighted labeled data; see the other overload.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param weights Weights (importances) of each point in the dataset.
+   * @param numTrees Number of trees in the whole forest.
+   * @param shard Index of the shard to train (between 0 and numShards - 1).
+   * @param numShards Number of shards the forest is split into.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void TrainShard(const MatType& data,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const arma::rowvec& weights,
+                  const size_t numTrees,
+                  const size_t shard,
+                  const size_t numShards,
+                  const size_t minimumLeafSize = 20);
+
+  /**
+   * Train the given shard of a forest of the given number of trees on the
+   * given weighted labeled data with the given dataset info; see the other
+   * overload.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Dimension info for the dataset.
+   * @param labels Labels for dataset.
+   * @param numClasses Number of classes in dataset.
+   * @param weights Weights (importances) of each point in the dataset.
+   * @param numTrees Number of trees in the whole forest.
+   * @param shard Index of the shard to train (between 0 and numShards - 1).
+   * @param numShards Number of shards the forest is split into.
+   * @param minimumLeafSize Minimum number of points in each tree's leaf nodes.
+   */
+  template<typename MatType>
+  void TrainShard(const MatType& data,
+                  const data::DatasetInfo& datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const arma::rowvec& weights,
+                  const size_t numTrees,
+                  const size_t shard,
+                  const size_t numShards,
+                  const size_t minimumLeafSize = 20);
+
+  /**
+   * Append the trees of the given forest (for instance a shard trained by
+   * another process with TrainShard()) after the trees of this forest.  The
+   * forests must have the same number of classes and dimensionality, unless
+   * this forest has not been trained, in which case it takes those of the
+   * other forest.
+   *
+   * @param other Forest whose trees are copied.
+   */
+  void Merge(const RandomForest& other);
+
+  /**
+   * Append the trees of the given forest after the trees of this forest, as
+   * above, moving them instead of copying them; the other forest is left
+   * without trees.
+   *
+   * @param other Forest whose trees are taken.
+   */
+  void Merge(RandomForest&& other);
+
   /**
    * Predict the class of the given point.  If the random forest has not been
    * trained, this will throw an exception.
@@ -256,6 +466,23 @@ class RandomForest
 
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
+  //! Get the number of classes of the forest (0 if it has not been trained).
+  size_t NumClasses() const { return numClasses; }
+  //! Get the dimensionality of the forest (0 if it has not been trained).
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get whether each tree is trained on a bootstrap sample given as weights.
+  bool WeightedBootstrap() const { return weightedBootstrap; }
+  /**
+   * Modify whether each tree is trained on a bootstrap sample, to be used by
+   * the next call to Train().  The sample of each tree is given to it as the
+   * distinct points that were drawn, weighted by the number of times they were
+   * drawn (see MultiplicityBootstrap()), so the points are only copied once,
+   * and no point is copied twice.  Since the trees are then trained with
+   * weights, the minimum leaf size counts the distinct points of a leaf.  By
+   * default (false), each tree is trained on the whole dataset.
+   */
+  bool& WeightedBootstrap() { return weightedBootstrap; }
 
   /**
    * Serialize the random forest.
@@ -276,6 +503,7 @@ class RandomForest
    * @param weights Weights for each point in the dataset (may be ignored).
    * @param numTrees Number of trees in the forest.
    * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param firstStream Index of the random stream of the first tree.
    * @tparam UseWeights Whether or not to use the weights parameter.
    * @tparam UseDatasetInfo Whether or not to use the datasetInfo parameter.
    * @tparam MatType The type of data matrix (i.e. arma::mat).
@@ -287,16 +515,128 @@ class RandomForest
              const size_t numClasses,
              const arma::rowvec& weights,
              const size_t numTrees,
-             const size_t minimumLeafSize);
+             const size_t minimumLeafSize,
+             const size_t firstStream = 0);
+
+  /**
+   * Train the given shard of a forest; see TrainShard().  The template bool
+   * parameters control whether or not the datasetInfo or weights arguments
+   * should be ignored.
+   */
+  template<bool UseWeights, bool UseDatasetInfo, typename MatType>
+  void TrainShard(const MatType& data,
+                  const data::DatasetInfo& datasetInfo,
+                  const arma::Row<size_t>& labels,
+                  const size_t numClasses,
+                  const arma::rowvec& weights,
+                  const size_t numTrees,
+                  const size_t shard,
+                  const size_t numShards,
+                  const size_t minimumLeafSize);
+
+  /**
+   * Train the given number of new trees and add them to the forest.  The
+   * template bool parameters control whether or not the datasetInfo or weights
+   * arguments should be ignored.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Dimension information for the dataset (may be ignored).
+   * @param labels Labels for the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights for each point in the dataset (may be ignored).
+   * @param numTrees Number of trees to add.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param firstStream Index of the random stream of the first new tree; the
+   *      new trees use the streams firstStream to firstStream + numTrees - 1
+   *      of math::RandomStreams().
+   */
+  template<bool UseWeights, bool UseDatasetInfo, typename MatType>
+  void AddTrees(const MatType& data,
+                const data::DatasetInfo& datasetInfo,
+                const arma::Row<size_t>& labels,
+                const size_t numClasses,
+                const arma::rowvec& weights,
+                const size_t numTrees,
+                const size_t minimumLeafSize,
+                const size_t firstStream = 0);
 
-  //! The trees in the forest.
+  //! The trees in the forest, in the order they were added.
   std::vector<DecisionTreeType> trees;
+  //! The number of classes of the forest.
+  size_t numClasses;
+  //! The dimensionality of the forest.
+  size_t dimensionality;
+  //! Whether each tree is trained on a weighted bootstrap sample.
+  bool weightedBootstrap;
 };
 
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the RandomForest class.  This is written
+//! out because BOOST_TEMPLATE_CLASS_VERSION() can't take a signature with
+//! commas.
+namespace boost {
+namespace serialization {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+struct version<mlpack::tree::RandomForest<FitnessFunction,
+    DimensionSelectionType, NumericSplitType, CategoricalSplitType, ElemType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "random_forest_impl.hpp"
 
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.  The default RandomForest, and its training and batch classification
+ * on arma::mat, are compiled once in the mlpack library (see
+ * random_forest.cpp), instead of in each program that uses them.
+ *
+ * @cond
+ */
+
+namespace mlpack {
+namespace tree {
+
+extern template class RandomForest<>;
+
+extern template void RandomForest<>::Train(const arma::mat&,
+                                           const arma::Row<size_t>&,
+                                           const size_t,
+                                           const size_t,
+                                           const size_t);
+
+extern template void RandomForest<>::Train(const arma::mat&,
+                                           const data::DatasetInfo&,
+                                           const arma::Row<size_t>&,
+                                           const size_t,
+                                           const size_t,
+                                           const size_t);
+
+extern template void RandomForest<>::Classify(const arma::mat&,
+                                              arma::Row<size_t>&) const;
+
+extern template void RandomForest<>::Classify(const arma::mat&,
+                                              arma::Row<size_t>&,
+                                              arma::mat&) const;
+
+} // namespace tree
+} // namespace mlpack
+
+/**
+ * @endcond
+ */
+
 #endif
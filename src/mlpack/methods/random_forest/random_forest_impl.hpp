@@ -36,7 +36,10 @@ RandomForest<
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    numClasses(0),
+    dimensionality(0),
+    weightedBootstrap(false)
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored.
@@ -64,7 +67,10 @@ RandomForest<
                 const arma::Row<size_t>& labels,
                 const size_t numClasses,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    numClasses(0),
+    dimensionality(0),
+    weightedBootstrap(false)
 {
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
@@ -91,7 +97,10 @@ RandomForest<
                 const size_t numClasses,
                 const arma::rowvec& weights,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    numClasses(0),
+    dimensionality(0),
+    weightedBootstrap(false)
 {
   // Pass off work to the Train() method.
   data::DatasetInfo info; // Ignored by Train().
@@ -119,7 +128,10 @@ RandomForest<
                 const size_t numClasses,
                 const arma::rowvec& weights,
                 const size_t numTrees,
-                const size_t minimumLeafSize)
+                const size_t minimumLeafSize) :
+    numClasses(0),
+    dimensionality(0),
+    weightedBootstrap(false)
 {
   // Pass off work to the Train() method.
   Train<true, true>(dataset, datasetInfo, labels, numClasses, weights, numTrees,
@@ -203,7 +215,7 @@ void RandomForest<
 {
   // Pass off to Train().
   data::DatasetInfo info; // Ignored by Train().
-  Train<false, true>(dataset, info, labels, numClasses, weights, numTrees,
+  Train<true, false>(dataset, info, labels, numClasses, weights, numTrees,
       minimumLeafSize);
 }
 
@@ -234,6 +246,326 @@ void RandomForest<
       minimumLeafSize);
 }
 
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::AddTrees(const MatType& dataset,
+            const arma::Row<size_t>& labels,
+            const size_t numTrees,
+            const size_t minimumLeafSize)
+{
+  // Pass off to AddTrees().
+  data::DatasetInfo info; // Ignored by AddTrees().
+  arma::rowvec weights; // Ignored by AddTrees().
+  AddTrees<false, false>(dataset, info, labels, numClasses, weights, numTrees,
+      minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::AddTrees(const MatType& dataset,
+            const data::DatasetInfo& datasetInfo,
+            const arma::Row<size_t>& labels,
+            const size_t numTrees,
+            const size_t minimumLeafSize)
+{
+  // Pass off to AddTrees().
+  arma::rowvec weights; // Ignored by AddTrees().
+  AddTrees<false, true>(dataset, datasetInfo, labels, numClasses, weights,
+      numTrees, minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::AddTrees(const MatType& dataset,
+            const arma::Row<size_t>& labels,
+            const arma::rowvec& weights,
+            const size_t numTrees,
+            const size_t minimumLeafSize)
+{
+  // Pass off to AddTrees().
+  data::DatasetInfo info; // Ignored by AddTrees().
+  AddTrees<true, false>(dataset, info, labels, numClasses, weights, numTrees,
+      minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::AddTrees(const MatType& dataset,
+            const data::DatasetInfo& datasetInfo,
+            const arma::Row<size_t>& labels,
+            const arma::rowvec& weights,
+            const size_t numTrees,
+            const size_t minimumLeafSize)
+{
+  // Pass off to AddTrees().
+  AddTrees<true, true>(dataset, datasetInfo, labels, numClasses, weights,
+      numTrees, minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::RemoveOldestTrees(const size_t numTrees)
+{
+  if (numTrees > trees.size())
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::RemoveOldestTrees(): cannot remove " << numTrees
+        << " trees from a forest of " << trees.size() << " trees!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  trees.erase(trees.begin(), trees.begin() + numTrees);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainShard(const MatType& dataset,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const size_t numTrees,
+              const size_t shard,
+              const size_t numShards,
+              const size_t minimumLeafSize)
+{
+  data::DatasetInfo info; // Ignored by TrainShard().
+  arma::rowvec weights; // Ignored by TrainShard().
+  TrainShard<false, false>(dataset, info, labels, numClasses, weights,
+      numTrees, shard, numShards, minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainShard(const MatType& dataset,
+              const data::DatasetInfo& datasetInfo,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const size_t numTrees,
+              const size_t shard,
+              const size_t numShards,
+              const size_t minimumLeafSize)
+{
+  arma::rowvec weights; // Ignored by TrainShard().
+  TrainShard<false, true>(dataset, datasetInfo, labels, numClasses, weights,
+      numTrees, shard, numShards, minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainShard(const MatType& dataset,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const arma::rowvec& weights,
+              const size_t numTrees,
+              const size_t shard,
+              const size_t numShards,
+              const size_t minimumLeafSize)
+{
+  data::DatasetInfo info; // Ignored by TrainShard().
+  TrainShard<true, false>(dataset, info, labels, numClasses, weights,
+      numTrees, shard, numShards, minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainShard(const MatType& dataset,
+              const data::DatasetInfo& datasetInfo,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const arma::rowvec& weights,
+              const size_t numTrees,
+              const size_t shard,
+              const size_t numShards,
+              const size_t minimumLeafSize)
+{
+  TrainShard<true, true>(dataset, datasetInfo, labels, numClasses, weights,
+      numTrees, shard, numShards, minimumLeafSize);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Merge(const RandomForest& other)
+{
+  RandomForest copy(other);
+  Merge(std::move(copy));
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::Merge(RandomForest&& other)
+{
+  if (other.numClasses == 0)
+  {
+    if (!other.trees.empty())
+    {
+      throw std::invalid_argument("RandomForest::Merge(): the number of "
+          "classes of the other forest is unknown!");
+    }
+
+    return; // Nothing to merge.
+  }
+
+  if (numClasses == 0)
+  {
+    numClasses = other.numClasses;
+    dimensionality = other.dimensionality;
+  }
+  else if (other.numClasses != numClasses)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::Merge(): number of classes of the other forest ("
+        << other.numClasses << ") is not equal to the number of classes of "
+        << "this forest (" << numClasses << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  else if (dimensionality != 0 && other.dimensionality != 0 &&
+      other.dimensionality != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::Merge(): dimensionality of the other forest ("
+        << other.dimensionality << ") is not equal to the dimensionality of "
+        << "this forest (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  else if (dimensionality == 0)
+  {
+    dimensionality = other.dimensionality;
+  }
+
+  trees.reserve(trees.size() + other.trees.size());
+  for (size_t i = 0; i < other.trees.size(); ++i)
+    trees.push_back(std::move(other.trees[i]));
+  other.trees.clear();
+}
+
 template<
     typename FitnessFunction,
     typename DimensionSelectionType,
@@ -333,9 +665,10 @@ void RandomForest<
 
   predictions.set_size(data.n_cols);
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+  ParallelFor(0, data.n_cols, [&](const size_t i)
+  {
     predictions[i] = Classify(data.col(i));
+  });
 }
 
 template<
@@ -368,12 +701,11 @@ void RandomForest<
 
   probabilities.set_size(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < data.n_cols; ++i)
+  ParallelFor(0, data.n_cols, [&](const size_t i)
   {
     arma::vec probs = probabilities.unsafe_col(i);
     Classify(data.col(i), predictions[i], probs);
-  }
+  });
 }
 
 template<
@@ -390,7 +722,7 @@ void RandomForest<
     NumericSplitType,
     CategoricalSplitType,
     ElemType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   size_t numTrees;
   if (Archive::is_loading::value)
@@ -405,6 +737,18 @@ void RandomForest<
     trees.resize(numTrees);
 
   ar & BOOST_SERIALIZATION_NVP(trees);
+
+  // Older versions didn't store the number of classes or the dimensionality.
+  if (version >= 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  }
+  else if (Archive::is_loading::value)
+  {
+    numClasses = trees.empty() ? 0 : trees[0].NumClasses();
+    dimensionality = 0; // Unknown.
+  }
 }
 
 template<
@@ -427,46 +771,168 @@ void RandomForest<
          const size_t numClasses,
          const arma::rowvec& weights,
          const size_t numTrees,
-         const size_t minimumLeafSize)
+         const size_t minimumLeafSize,
+         const size_t firstStream)
 {
-  // Train each tree individually.
-  trees.resize(numTrees); // This will fill the vector with untrained trees.
+  this->numClasses = numClasses;
+  dimensionality = dataset.n_rows;
+
+  // Pass off to AddTrees().
+  trees.clear();
+  AddTrees<UseWeights, UseDatasetInfo>(dataset, datasetInfo, labels,
+      numClasses, weights, numTrees, minimumLeafSize, firstStream);
+}
 
-  #pragma omp parallel for
-  for (omp_size_t i = 0; i < numTrees; ++i)
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<bool UseWeights, bool UseDatasetInfo, typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::TrainShard(const MatType& dataset,
+              const data::DatasetInfo& datasetInfo,
+              const arma::Row<size_t>& labels,
+              const size_t numClasses,
+              const arma::rowvec& weights,
+              const size_t numTrees,
+              const size_t shard,
+              const size_t numShards,
+              const size_t minimumLeafSize)
+{
+  if (shard >= numShards)
   {
-    MatType bootstrapDataset;
-    arma::Row<size_t> bootstrapLabels;
-    arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
-
-    // Now build the decision tree.
-    if (UseWeights)
+    std::ostringstream oss;
+    oss << "RandomForest::TrainShard(): shard " << shard << " is not less "
+        << "than the number of shards (" << numShards << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The shards are contiguous ranges of trees, whose sizes differ by at most
+  // one.  Tree i always uses stream i, so the shards together draw the same
+  // random numbers as the whole forest.
+  const size_t first = shard * numTrees / numShards;
+  const size_t last = (shard + 1) * numTrees / numShards;
+  Train<UseWeights, UseDatasetInfo>(dataset, datasetInfo, labels, numClasses,
+      weights, last - first, minimumLeafSize, first);
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename ElemType
+>
+template<bool UseWeights, bool UseDatasetInfo, typename MatType>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    ElemType
+>::AddTrees(const MatType& dataset,
+            const data::DatasetInfo& datasetInfo,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses,
+            const arma::rowvec& weights,
+            const size_t numTrees,
+            const size_t minimumLeafSize,
+            const size_t firstStream)
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("RandomForest::AddTrees(): the forest has not "
+        "been trained!");
+  }
+
+  if (dimensionality != 0 && dataset.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "RandomForest::AddTrees(): dimensionality of the data ("
+        << dataset.n_rows << ") is not equal to the dimensionality of the "
+        << "forest (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+  dimensionality = dataset.n_rows;
+
+  // Train each new tree individually, after the trees already in the forest.
+  const size_t first = trees.size();
+  trees.resize(first + numTrees); // This adds untrained trees.
+
+  // If there are enough trees to keep every thread busy, train the trees in
+  // parallel (each tree is then trained with tasks, which idle threads can pick
+  // up).  Otherwise, train the trees one by one, and let each tree use all of
+  // the threads.  Each tree draws its bootstrap sample from its own random
+  // number generator, so that the samples don't depend on the number of
+  // threads.  The streams before firstStream belong to trees trained
+  // elsewhere (see TrainShard()).
+  const std::vector<math::RandomEngine> streams =
+      math::RandomStreams(firstStream + numTrees);
+  const math::RandomEngine engine = math::randGen;
+  const size_t treeThreads = (numTrees >= Threads()) ? 0 : 1;
+  ParallelFor(0, numTrees, [&](const size_t i)
+  {
+    math::randGen = streams[firstStream + i];
+
+    if (weightedBootstrap)
     {
+      // The bootstrap sample is given to the tree as weights on the distinct
+      // points that were drawn, so only those points are copied, and the tree
+      // takes them over instead of copying them again.
+      MatType bootstrapDataset;
+      arma::Row<size_t> bootstrapLabels;
+      arma::rowvec bootstrapWeights;
+      MultiplicityBootstrap<UseWeights>(dataset, labels, weights,
+          bootstrapDataset, bootstrapLabels, bootstrapWeights);
+
       if (UseDatasetInfo)
       {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses, weights,
-            minimumLeafSize);
+        trees[first + i].Train(std::move(bootstrapDataset), datasetInfo,
+            std::move(bootstrapLabels), numClasses,
+            std::move(bootstrapWeights), minimumLeafSize);
+      }
+      else
+      {
+        trees[first + i].Train(std::move(bootstrapDataset),
+            std::move(bootstrapLabels), numClasses,
+            std::move(bootstrapWeights), minimumLeafSize);
+      }
+    }
+    else if (UseWeights)
+    {
+      if (UseDatasetInfo)
+      {
+        trees[first + i].Train(dataset, datasetInfo, labels, numClasses,
+            weights, minimumLeafSize);
       }
       else
       {
-        trees[i].Train(dataset, labels, numClasses, weights, minimumLeafSize);
+        trees[first + i].Train(dataset, labels, numClasses, weights,
+            minimumLeafSize);
       }
     }
     else
     {
       if (UseDatasetInfo)
       {
-        trees[i].Train(dataset, datasetInfo, labels, numClasses,
+        trees[first + i].Train(dataset, datasetInfo, labels, numClasses,
             minimumLeafSize);
       }
       else
       {
-        trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
+        trees[first + i].Train(dataset, labels, numClasses, minimumLeafSize);
       }
     }
-  }
+  }, 1, treeThreads);
+  math::randGen = engine;
 }
 
 } // namespace tree
@@ -231,6 +231,44 @@ class RandomizedSVD
     }
   }
 
+  /**
+   * Center the data and apply the randomized SVD to a dataset that is read a
+   * batch of columns at a time from the given source, so that the whole
+   * dataset never has to be in memory; only the sketches, of size
+   * n_rows x (rank + 2) and n_cols x (rank + 2), are held.  Each product of
+   * the method with the data is one pass over the source, so maxIterations + 2
+   * passes are made, and the next batch is read on a background thread while
+   * the current one is multiplied.  The source can be a data::BatchReader, or
+   * any other class with the same Next() and Rewind() methods.
+   *
+   * If SketchElemType is float, the batches and the sketches are held and
+   * multiplied in single precision, which halves their memory and roughly
+   * doubles the speed of the products; the results are given in double
+   * precision.
+   *
+   * @code
+   * data::BatchReader reader("dataset.mmat");
+   * RandomizedSVD rSVD;
+   * rSVD.ApplyBlocks<float>(reader, u, s, v, rank);
+   * @endcode
+   *
+   * @tparam SketchElemType Type of the elements of the sketches.
+   * @tparam SourceType Type of the source of the batches.
+   * @param source Source of the batches of columns of the data.
+   * @param u First unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param v Second unitary matrix.
+   * @param rank Rank of the approximation.
+   * @param batchSize Largest number of columns read at a time.
+   */
+  template<typename SketchElemType = double, typename SourceType>
+  void ApplyBlocks(SourceType& source,
+                   arma::mat& u,
+                   arma::vec& s,
+                   arma::mat& v,
+                   const size_t rank,
+                   const size_t batchSize = 10000);
+
   //! Get the size of the normalized power iterations.
   size_t IteratedPower() const { return iteratedPower; }
   //! Modify the size of the normalized power iterations.
@@ -247,6 +285,22 @@ class RandomizedSVD
   double& Epsilon() { return eps; }
 
  private:
+  //! Convert the given batch to the element type of the sketches.
+  template<typename eT>
+  static const arma::Mat<eT>& ConvertBlock(const arma::mat& block,
+                                           arma::Mat<eT>& converted);
+
+  //! Give the given batch as it is, if the sketches are in double precision.
+  static const arma::mat& ConvertBlock(const arma::mat& block,
+                                       arma::mat& /* converted */)
+  {
+    return block;
+  }
+
+  //! Normalize the columns of the given sketch with an LU or QR decomposition.
+  template<typename eT>
+  static void Normalize(arma::Mat<eT>& q, const bool useQR);
+
   //! Locally stored size of the normalized power iterations.
   size_t iteratedPower;
 
@@ -260,4 +314,7 @@ class RandomizedSVD
 } // namespace svd
 } // namespace mlpack
 
+// Include implementation.
+#include "randomized_svd_impl.hpp"
+
 #endif
@@ -0,0 +1,166 @@
+/**
+ * @file randomized_svd_impl.hpp
+ *
+ * Implementation of the randomized SVD method on a dataset that is read a
+ * batch of columns at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "randomized_svd.hpp"
+
+#include <mlpack/core/data/for_each_batch.hpp>
+
+namespace mlpack {
+namespace svd {
+
+template<typename SketchElemType, typename SourceType>
+void RandomizedSVD::ApplyBlocks(SourceType& source,
+                                arma::mat& u,
+                                arma::vec& s,
+                                arma::mat& v,
+                                const size_t rank,
+                                const size_t batchSize)
+{
+  typedef arma::Mat<SketchElemType> SketchType;
+  typedef arma::Col<SketchElemType> SketchColType;
+  typedef arma::Row<SketchElemType> SketchRowType;
+
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("RandomizedSVD::ApplyBlocks(): the batch size "
+        "must be positive!");
+  }
+
+  if (iteratedPower == 0)
+    iteratedPower = rank + 2;
+
+  const size_t k = iteratedPower;
+
+  // The data are centered as C = A - m 1^T, with m the mean of the points,
+  // but only the products of A with the sketches are formed, and the products
+  // of C are recovered from them: C X = A X - m (1^T X), and
+  // C^T Q = A^T Q - 1 (m^T Q).
+  SketchType converted, y, q;
+  SketchRowType sums;
+  arma::vec mean;
+
+  // Apply the data matrix to a random matrix, which is drawn a batch at a
+  // time, and find the mean of the points with the same pass.
+  const size_t n = data::ForEachBatch(source, batchSize,
+      [&](const arma::mat& block, const size_t /* offset */)
+      {
+        if (y.is_empty())
+        {
+          mean.zeros(block.n_rows);
+          y.zeros(block.n_rows, k);
+          sums.zeros(k);
+        }
+
+        const SketchType omega = arma::randn<SketchType>(block.n_cols, k);
+        y += ConvertBlock(block, converted) * omega;
+        mean += arma::sum(block, 1);
+        sums += arma::sum(omega, 0);
+      });
+
+  if (n == 0)
+  {
+    throw std::invalid_argument("RandomizedSVD::ApplyBlocks(): the source has "
+        "no points!");
+  }
+
+  mean = mean / n + eps;
+  const SketchColType sketchMean = arma::conv_to<SketchColType>::from(mean);
+  y -= sketchMean * sums;
+
+  // Form a matrix Q whose columns constitute a well-conditioned basis for the
+  // columns of the sketch.
+  q = std::move(y);
+  Normalize(q, maxIterations == 0);
+
+  // Perform normalized power iterations; each one forms C (C^T Q) with one
+  // pass, a batch of columns at a time.
+  for (size_t i = 0; i < maxIterations; ++i)
+  {
+    const SketchRowType meanQ = sketchMean.t() * q;
+    y.zeros(q.n_rows, q.n_cols);
+    sums.zeros(q.n_cols);
+
+    data::ForEachBatch(source, batchSize,
+        [&](const arma::mat& block, const size_t /* offset */)
+        {
+          const SketchType& b = ConvertBlock(block, converted);
+          SketchType w = b.t() * q;
+          w.each_row() -= meanQ;
+          y += b * w;
+          sums += arma::sum(w, 0);
+        });
+
+    y -= sketchMean * sums;
+    q = std::move(y);
+
+    // Computing the LU decomposition is more efficient than computing the QR
+    // decomposition, so we only use it in the last iteration, which ensures
+    // that the columns of Q are orthonormal.
+    Normalize(q, i == maxIterations - 1);
+  }
+
+  // C is approximated by Q B with B = Q^T C, so the right singular vectors
+  // and the singular values of C are those of B, whose transpose is formed a
+  // batch of rows at a time.
+  const SketchRowType meanQ = sketchMean.t() * q;
+  SketchType bt(n, q.n_cols);
+  data::ForEachBatch(source, batchSize,
+      [&](const arma::mat& block, const size_t offset)
+      {
+        if (offset + block.n_cols > n)
+        {
+          throw std::runtime_error("RandomizedSVD::ApplyBlocks(): the source "
+              "gave more points than in the first pass!");
+        }
+
+        SketchType w = ConvertBlock(block, converted).t() * q;
+        w.each_row() -= meanQ;
+        bt.rows(offset, offset + block.n_cols - 1) = w;
+      });
+
+  // With B^T = U2 S V2^T, C ~ (Q V2) S U2^T.
+  SketchType u2, v2;
+  SketchColType s2;
+  arma::svd_econ(u2, s2, v2, bt);
+
+  u = arma::conv_to<arma::mat>::from(q * v2);
+  s = arma::conv_to<arma::vec>::from(s2);
+  v = arma::conv_to<arma::mat>::from(u2);
+}
+
+template<typename eT>
+const arma::Mat<eT>& RandomizedSVD::ConvertBlock(const arma::mat& block,
+                                                 arma::Mat<eT>& converted)
+{
+  converted = arma::conv_to<arma::Mat<eT>>::from(block);
+  return converted;
+}
+
+template<typename eT>
+void RandomizedSVD::Normalize(arma::Mat<eT>& q, const bool useQR)
+{
+  arma::Mat<eT> l, r;
+  if (useQR)
+    arma::qr_econ(l, r, q);
+  else
+    arma::lu(l, r, q);
+
+  q = std::move(l);
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,30 @@
+/**
+ * @file range_search.cpp
+ *
+ * Force instantiation of RangeSearch with the default kd-tree, and of that
+ * tree, to reduce compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "range_search.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template class BinarySpaceTree<metric::EuclideanDistance,
+    range::RangeSearchStat,
+    arma::mat,
+    bound::HRectBound,
+    MidpointSplit>;
+
+} // namespace tree
+
+namespace range {
+
+template class RangeSearch<metric::EuclideanDistance, arma::mat, tree::KDTree>;
+
+} // namespace range
+} // namespace mlpack
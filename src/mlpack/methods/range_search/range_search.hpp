@@ -17,6 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include "range_search_stat.hpp"
+#include "range_search_result.hpp"
 
 namespace mlpack {
 namespace range /** Range-search routines. */ {
@@ -33,12 +34,18 @@ class TrainVisitor;
  * @tparam MetricType Metric to use for range search calculations.
  * @tparam MatType Type of data to use.
  * @tparam TreeType Type of tree to use; must satisfy the TreeType policy API.
+ * @tparam DualTreeTraversalType The type of dual tree traversal to use
+ *     (defaults to the tree's default traverser).
  */
 template<typename MetricType = metric::EuclideanDistance,
          typename MatType = arma::mat,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType = tree::KDTree>
+                  typename TreeMatType> class TreeType = tree::KDTree,
+         template<typename RuleType> class DualTreeTraversalType =
+             TreeType<MetricType,
+                      RangeSearchStat,
+                      MatType>::template DualTreeTraverser>
 class RangeSearch
 {
  public:
@@ -187,6 +194,43 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, returning the results in the compact RangeSearchResult format.
+   * The neighbors and distances of query point i are at the positions
+   * result.Offsets()[i] to result.Offsets()[i + 1] - 1 of result.Neighbors()
+   * and result.Distances(), in no particular order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param result Object which will hold the results.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              RangeSearchResult& result);
+
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and give each result to the given callback as soon as it is
+   * found, instead of storing it.  The callback is called as
+   *
+   * @code
+   * callback(queryIndex, referenceIndex, distance);
+   * @endcode
+   *
+   * for each reference point in the range of each query point, with the
+   * indices of the points in the query set and the reference set, in no
+   * particular order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to give the results to.
+   */
+  template<typename CallbackType>
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              CallbackType& callback);
+
   /**
    * Given a pre-built query tree, search for all reference points in the given
    * range for each point in the query set, returning the results in the
@@ -228,6 +272,35 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, returning the results in the
+   * compact RangeSearchResult format.  The query indices are the indices of
+   * the points in the dataset of the query tree.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param result Object which will hold the results.
+   */
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              RangeSearchResult& result);
+
+  /**
+   * Given a pre-built query tree, search for all reference points in the given
+   * range for each point in the query set, and give each result to the given
+   * callback as soon as it is found.  The query indices are the indices of the
+   * points in the dataset of the query tree.
+   *
+   * @param queryTree Tree built on query points.
+   * @param range Range of distances in which to search.
+   * @param callback Callback to give the results to.
+   */
+  template<typename CallbackType>
+  void Search(Tree* queryTree,
+              const math::Range& range,
+              CallbackType& callback);
+
   /**
    * Search for all points in the given range for each point in the reference
    * set (which was passed to the constructor), returning the results in the
@@ -262,6 +335,27 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, returning the results in the compact RangeSearchResult format.  A
+   * point is not returned in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param result Object which will hold the results.
+   */
+  void Search(const math::Range& range, RangeSearchResult& result);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, and give each result to the given callback as soon as it is found.  A
+   * point is not returned in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Callback to give the results to.
+   */
+  template<typename CallbackType>
+  void Search(const math::Range& range, CallbackType& callback);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -272,6 +366,16 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  /**
+   * Get whether the search is parallel.  If true, the query points are split
+   * into blocks that are searched in parallel with OpenMP (with one query tree
+   * per block for dual-tree search), and the results are given to the callback
+   * once the search is done.  This setting is not serialized.
+   */
+  bool Parallel() const { return parallel; }
+  //! Modify whether the search is parallel.
+  bool& Parallel() { return parallel; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
@@ -303,6 +407,8 @@ class RangeSearch
   bool naive;
   //! If true, single-tree computation is used.
   bool singleMode;
+  //! If true, the query points are searched in parallel.
+  bool parallel;
 
   //! Instantiated distance metric.
   MetricType metric;
@@ -312,6 +418,19 @@ class RangeSearch
   //! The total number of scores during the last search.
   size_t scores;
 
+  /**
+   * Search the given query points in parallel, and store the results of each
+   * query point in neighbors and distances.  The reference indices are
+   * mapped to their original order; the query indices are the indices in
+   * querySet.  If sameSet is true, querySet must be the reference set, and
+   * each point is not given in its own results.
+   */
+  void ParallelSearch(const MatType& querySet,
+                      const math::Range& range,
+                      const bool sameSet,
+                      std::vector<std::vector<size_t>>& neighbors,
+                      std::vector<std::vector<double>>& distances);
+
   //! For access to mappings when building models.
   friend class TrainVisitor;
 };
@@ -322,4 +441,37 @@ class RangeSearch
 // Include implementation.
 #include "range_search_impl.hpp"
 
+/**
+ * Don't document these with doxygen; these declarations aren't helpful to
+ * users.  RangeSearch with the default kd-tree, and that kd-tree, are
+ * compiled once in the mlpack library (see range_search.cpp), instead of in
+ * each program that uses them.
+ *
+ * @cond
+ */
+
+namespace mlpack {
+namespace tree {
+
+extern template class BinarySpaceTree<metric::EuclideanDistance,
+    range::RangeSearchStat,
+    arma::mat,
+    bound::HRectBound,
+    MidpointSplit>;
+
+} // namespace tree
+
+namespace range {
+
+extern template class RangeSearch<metric::EuclideanDistance,
+                                  arma::mat,
+                                  tree::KDTree>;
+
+} // namespace range
+} // namespace mlpack
+
+/**
+ * @endcond
+ */
+
 #endif
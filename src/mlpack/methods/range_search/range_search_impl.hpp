@@ -18,6 +18,10 @@
 // The rules for traversal.
 #include "range_search_rules.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace range {
 
@@ -46,8 +50,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::RangeSearch(
     MatType referenceSet,
     const bool naive,
     const bool singleMode,
@@ -59,6 +65,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(!naive),
     naive(naive),
     singleMode(!naive && singleMode),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -70,8 +77,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::RangeSearch(
     Tree* referenceTree,
     const bool singleMode,
     const MetricType metric) :
@@ -80,6 +89,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(false),
     naive(false),
     singleMode(singleMode),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -91,8 +101,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::RangeSearch(
     const bool naive,
     const bool singleMode,
     const MetricType metric) :
@@ -101,6 +113,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(false),
     naive(naive),
     singleMode(singleMode),
+    parallel(false),
     metric(metric),
     baseCases(0),
     scores(0)
@@ -118,8 +131,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::RangeSearch(
     const RangeSearch& other) :
     oldFromNewReferences(other.oldFromNewReferences),
     referenceTree(other.referenceTree ? new Tree(*other.referenceTree) : NULL),
@@ -128,6 +143,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     treeOwner(other.referenceTree),
     naive(other.naive),
     singleMode(other.singleMode),
+    parallel(other.parallel),
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores)
@@ -139,14 +155,17 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::RangeSearch(RangeSearch&& other) :
     oldFromNewReferences(std::move(other.oldFromNewReferences)),
     referenceTree(other.referenceTree),
     referenceSet(other.referenceSet),
     treeOwner(other.treeOwner),
     naive(other.naive),
     singleMode(other.singleMode),
+    parallel(other.parallel),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores)
@@ -159,6 +178,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
   other.treeOwner = true;
   other.naive = false;
   other.singleMode = false;
+  other.parallel = false;
   other.baseCases = 0;
   other.scores = 0;
 }
@@ -167,9 +187,12 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>&
-RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>&
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::operator=(RangeSearch other)
 {
   // Clean memory first.
   if (treeOwner)
@@ -184,6 +207,7 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
   treeOwner = other.treeOwner;
   naive = other.naive;
   singleMode = other.singleMode;
+  parallel = other.parallel;
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
@@ -195,8 +219,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-RangeSearch<MetricType, MatType, TreeType>::~RangeSearch()
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::~RangeSearch()
 {
   if (treeOwner && referenceTree)
     delete referenceTree;
@@ -208,8 +234,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RangeSearch<MetricType, MatType, TreeType>::Train(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Train(
     MatType referenceSet)
 {
   // Clean up the old tree, if we built one.
@@ -246,8 +274,10 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RangeSearch<MetricType, MatType, TreeType>::Train(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Train(
   Tree* referenceTree)
 {
   if (naive)
@@ -266,12 +296,54 @@ template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RangeSearch<MetricType, MatType, TreeType>::Search(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
     const MatType& querySet,
     const math::Range& range,
     std::vector<std::vector<size_t>>& neighbors,
     std::vector<std::vector<double>>& distances)
+{
+  // Resize each vector.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
+
+  VectorResultCallback callback(neighbors, distances);
+  Search(querySet, range, callback);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    RangeSearchResult& result)
+{
+  result.Reset(querySet.n_cols);
+  Search<RangeSearchResult>(querySet, range, result);
+  result.Finalize();
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    CallbackType& callback)
 {
   if (querySet.n_rows != referenceSet->n_rows)
   {
@@ -291,47 +363,42 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
 
-  // If we have built the trees ourselves, then we will have to map all the
-  // indices back to their original indices when this computation is finished.
-  // To avoid extra copies, we will store the unmapped neighbors and distances
-  // in a separate object.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  // Mapping is only necessary if the tree rearranges points.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // Query indices only need to be mapped if we are building the query tree
-    // ourselves.
-    if (!singleMode && !naive)
-    {
-      distancePtr = new std::vector<std::vector<double>>;
-      neighborPtr = new std::vector<std::vector<size_t>>;
-    }
-
-    // Reference indices only need to be mapped if we built the reference tree
-    // ourselves.
-    else if (treeOwner)
-      neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distancePtr->clear();
-  distancePtr->resize(querySet.n_cols);
+  // If we have built the trees ourselves, then the indices given by the rules
+  // must be mapped back to their original indices before they are given to the
+  // callback.  Query indices only need to be mapped if we are building the
+  // query tree ourselves, and reference indices only need to be mapped if we
+  // built the reference tree ourselves.
+  const bool mapQueries = tree::TreeTraits<Tree>::RearrangesDataset &&
+      !singleMode && !naive;
+  const bool mapReferences = tree::TreeTraits<Tree>::RearrangesDataset &&
+      treeOwner;
+  typedef MappedResultCallback<CallbackType> MappedCallbackType;
+  MappedCallbackType mappedCallback(callback,
+      mapQueries ? &oldFromNewQueries : NULL,
+      mapReferences ? &oldFromNewReferences : NULL);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
+  typedef RangeSearchRules<MetricType, Tree, MappedCallbackType> RuleType;
 
   // Reset counts.
   baseCases = 0;
   scores = 0;
 
-  if (naive)
+  if (parallel)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    // The results are buffered per query point, so the callback is not called
+    // concurrently.  The reference indices are already mapped.
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    ParallelSearch(querySet, range, false, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        callback(i, neighbors[i][j], distances[i][j]);
+  }
+  else if (naive)
+  {
+    RuleType rules(*referenceSet, querySet, range, mappedCallback, metric);
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -343,8 +410,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   else if (singleMode)
   {
     // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    RuleType rules(*referenceSet, querySet, range, mappedCallback, metric);
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
     // Now have it traverse for each point.
@@ -364,9 +430,9 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Start("range_search/computing_neighbors");
 
     // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedCallback,
+        metric);
+    DualTreeTraversalType<RuleType> traverser(rules);
 
     traverser.Traverse(*queryTree, *referenceTree);
 
@@ -378,118 +444,88 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 
   Timer::Stop("range_search/computing_neighbors");
+  Timer::Count("range_search/base_cases", baseCases);
+  Timer::Count("range_search/scores", scores);
+}
 
-  // Map points back to original indices, if necessary.
-  if (tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    if (!singleMode && !naive && treeOwner)
-    {
-      // We must map both query and reference indices.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); i++)
-      {
-        // Map distances (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-
-        // Copy each neighbor individually, because we need to map it.
-        neighbors[queryMapping].resize(distances[queryMapping].size());
-        for (size_t j = 0; j < distances[queryMapping].size(); j++)
-          neighbors[queryMapping][j] =
-              oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (!singleMode && !naive)
-    {
-      // We must map query indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
-      distances.clear();
-      distances.resize(querySet.n_cols);
-
-      for (size_t i = 0; i < distances.size(); ++i)
-      {
-        // Map distances and neighbors (copy a column).
-        const size_t queryMapping = oldFromNewQueries[i];
-        distances[queryMapping] = (*distancePtr)[i];
-        neighbors[queryMapping] = (*neighborPtr)[i];
-      }
-
-      // Finished with temporary objects.
-      delete neighborPtr;
-      delete distancePtr;
-    }
-    else if (treeOwner)
-    {
-      // We must map reference indices only.
-      neighbors.clear();
-      neighbors.resize(querySet.n_cols);
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  // Resize each vector.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(queryTree->Dataset().n_cols);
+  distances.clear();
+  distances.resize(queryTree->Dataset().n_cols);
 
-      for (size_t i = 0; i < neighbors.size(); i++)
-      {
-        neighbors[i].resize((*neighborPtr)[i].size());
-        for (size_t j = 0; j < neighbors[i].size(); j++)
-          neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-      }
+  VectorResultCallback callback(neighbors, distances);
+  Search(queryTree, range, callback);
+}
 
-      // Finished with temporary object.
-      delete neighborPtr;
-    }
-  }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
+    Tree* queryTree,
+    const math::Range& range,
+    RangeSearchResult& result)
+{
+  result.Reset(queryTree->Dataset().n_cols);
+  Search<RangeSearchResult>(queryTree, range, result);
+  result.Finalize();
 }
 
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RangeSearch<MetricType, MatType, TreeType>::Search(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
     Tree* queryTree,
     const math::Range& range,
-    std::vector<std::vector<size_t>>& neighbors,
-    std::vector<std::vector<double>>& distances)
+    CallbackType& callback)
 {
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
     return;
 
-  Timer::Start("range_search/computing_neighbors");
-
-  // Get a reference to the query set.
-  const MatType& querySet = queryTree->Dataset();
-
   // Make sure we are in dual-tree mode.
   if (singleMode || naive)
     throw std::invalid_argument("cannot call RangeSearch::Search() with a "
         "query tree when naive or singleMode are set to true");
 
-  // We won't need to map query indices, but will we need to map distances?
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-    neighborPtr = new std::vector<std::vector<size_t>>;
+  Timer::Start("range_search/computing_neighbors");
 
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(querySet.n_cols);
-  distances.clear();
-  distances.resize(querySet.n_cols);
+  // We won't need to map query indices, but will we need to map reference
+  // indices?
+  typedef MappedResultCallback<CallbackType> MappedCallbackType;
+  MappedCallbackType mappedCallback(callback, NULL,
+      (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
+  typedef RangeSearchRules<MetricType, Tree, MappedCallbackType> RuleType;
+  RuleType rules(*referenceSet, queryTree->Dataset(), range, mappedCallback,
+      metric);
 
   // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  DualTreeTraversalType<RuleType> traverser(rules);
 
   traverser.Traverse(*queryTree, *referenceTree);
 
@@ -497,35 +533,59 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   baseCases = rules.BaseCases();
   scores = rules.Scores();
+  Timer::Count("range_search/base_cases", baseCases);
+  Timer::Count("range_search/scores", scores);
+}
 
-  // Do we need to map indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
-  {
-    // We must map reference indices only.
-    neighbors.clear();
-    neighbors.resize(querySet.n_cols);
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  // Resize each vector.
+  neighbors.clear(); // Just in case there was anything in it.
+  neighbors.resize(referenceSet->n_cols);
+  distances.clear();
+  distances.resize(referenceSet->n_cols);
 
-    for (size_t i = 0; i < neighbors.size(); i++)
-    {
-      neighbors[i].resize((*neighborPtr)[i].size());
-      for (size_t j = 0; j < neighbors[i].size(); j++)
-        neighbors[i][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
-    }
+  VectorResultCallback callback(neighbors, distances);
+  Search(range, callback);
+}
 
-    // Finished with temporary object.
-    delete neighborPtr;
-  }
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
+    const math::Range& range,
+    RangeSearchResult& result)
+{
+  result.Reset(referenceSet->n_cols);
+  Search<RangeSearchResult>(range, result);
+  result.Finalize();
 }
 
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RangeSearch<MetricType, MatType, TreeType>::Search(
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+template<typename CallbackType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::Search(
     const math::Range& range,
-    std::vector<std::vector<size_t>>& neighbors,
-    std::vector<std::vector<double>>& distances)
+    CallbackType& callback)
 {
   // If there are no points, there is no search to be done.
   if (referenceSet->n_cols == 0)
@@ -533,29 +593,35 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   Timer::Start("range_search/computing_neighbors");
 
-  // Here, we will use the query set as the reference set.
-  std::vector<std::vector<size_t>>* neighborPtr = &neighbors;
-  std::vector<std::vector<double>>* distancePtr = &distances;
-
-  if (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner)
-  {
-    // We will always need to rearrange in this case.
-    distancePtr = new std::vector<std::vector<double>>;
-    neighborPtr = new std::vector<std::vector<size_t>>;
-  }
-
-  // Resize each vector.
-  neighborPtr->clear(); // Just in case there was anything in it.
-  neighborPtr->resize(referenceSet->n_cols);
-  distancePtr->clear();
-  distancePtr->resize(referenceSet->n_cols);
+  // Here, we will use the query set as the reference set, so if the tree
+  // rearranged the points, both the query and reference indices are mapped.
+  const std::vector<size_t>* mapping =
+      (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
+  typedef MappedResultCallback<CallbackType> MappedCallbackType;
+  MappedCallbackType mappedCallback(callback, mapping, mapping);
 
   // Create the helper object for the traversal.
-  typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  typedef RangeSearchRules<MetricType, Tree, MappedCallbackType> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, mappedCallback, metric,
+      true /* don't return the query in the results */);
 
-  if (naive)
+  if (parallel)
+  {
+    // The query indices are in the order of the reference set, and the
+    // reference indices are already mapped.
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    ParallelSearch(*referenceSet, range, true, neighbors, distances);
+
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      const size_t query = mapping ? (*mapping)[i] : i;
+      for (size_t j = 0; j < neighbors[i].size(); ++j)
+        callback(query, neighbors[i][j], distances[i][j]);
+    }
+  }
+  else if (naive)
   {
     // The naive brute-force solution.
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
@@ -580,7 +646,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   else // Dual-tree recursion.
   {
     // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    DualTreeTraversalType<RuleType> traverser(rules);
 
     traverser.Traverse(*referenceTree, *referenceTree);
 
@@ -589,42 +655,147 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 
   Timer::Stop("range_search/computing_neighbors");
+  Timer::Count("range_search/base_cases", baseCases);
+  Timer::Count("range_search/scores", scores);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::ParallelSearch(
+    const MatType& querySet,
+    const math::Range& range,
+    const bool sameSet,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
+{
+  neighbors.clear();
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
 
-  // Do we need to map the reference indices?
-  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  // The reference indices are given in their original order, if we built the
+  // reference tree ourselves.
+  const std::vector<size_t>* referenceMapping =
+      (tree::TreeTraits<Tree>::RearrangesDataset && treeOwner) ?
+      &oldFromNewReferences : NULL;
+
+  // Split the query points into a few blocks per thread, so that the work is
+  // balanced.  Each block only writes the results of its own query points.
+  size_t numThreads = 1;
+  #ifdef HAS_OPENMP
+  numThreads = omp_get_max_threads();
+  #endif
+  const size_t numBlocks = std::max((size_t) 1,
+      std::min((size_t) querySet.n_cols, 4 * numThreads));
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+
+  typedef MappedResultCallback<VectorResultCallback> BlockCallbackType;
+  typedef RangeSearchRules<MetricType, Tree, BlockCallbackType> RuleType;
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalBaseCases, totalScores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    neighbors.clear();
-    neighbors.resize(referenceSet->n_cols);
-    distances.clear();
-    distances.resize(referenceSet->n_cols);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) querySet.n_cols, begin + blockSize);
+    if (begin >= end)
+      continue;
 
-    for (size_t i = 0; i < distances.size(); i++)
+    MetricType blockMetric(metric);
+    VectorResultCallback vectorCallback(neighbors, distances);
+
+    if (naive || singleMode)
     {
-      // Map distances (copy a column).
-      const size_t refMapping = oldFromNewReferences[i];
-      distances[refMapping] = (*distancePtr)[i];
+      // The query indices given to the rules are the indices in querySet.
+      BlockCallbackType blockCallback(vectorCallback, NULL, referenceMapping);
+      RuleType rules(*referenceSet, querySet, range, blockCallback,
+          blockMetric, sameSet);
+
+      if (naive)
+      {
+        for (size_t i = begin; i < end; ++i)
+          for (size_t j = 0; j < referenceSet->n_cols; ++j)
+            rules.BaseCase(i, j);
 
-      // Copy each neighbor individually, because we need to map it.
-      neighbors[refMapping].resize(distances[refMapping].size());
-      for (size_t j = 0; j < distances[refMapping].size(); j++)
+        totalBaseCases += (end - begin) * referenceSet->n_cols;
+      }
+      else
       {
-        neighbors[refMapping][j] = oldFromNewReferences[(*neighborPtr)[i][j]];
+        typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+        for (size_t i = begin; i < end; ++i)
+          traverser.Traverse(i, *referenceTree);
+
+        totalBaseCases += rules.BaseCases();
+        totalScores += rules.Scores();
+      }
+    }
+    else
+    {
+      // Build a query tree on the block, and map its points back to their
+      // indices in querySet.
+      std::vector<size_t> oldFromNewBlock;
+      Tree* blockTree = BuildTree<Tree>(MatType(querySet.cols(begin,
+          end - 1)), oldFromNewBlock);
+
+      std::vector<size_t> blockQueries(end - begin);
+      for (size_t i = 0; i < blockQueries.size(); ++i)
+        blockQueries[i] = begin + (oldFromNewBlock.empty() ? i :
+            oldFromNewBlock[i]);
+
+      BlockCallbackType blockCallback(vectorCallback, &blockQueries,
+          referenceMapping);
+      RuleType rules(*referenceSet, blockTree->Dataset(), range, blockCallback,
+          blockMetric);
+      DualTreeTraversalType<RuleType> traverser(rules);
+      traverser.Traverse(*blockTree, *referenceTree);
+
+      totalBaseCases += rules.BaseCases();
+      totalScores += rules.Scores();
+
+      delete blockTree;
+
+      // The rules can't tell the points of the block from the reference
+      // points, so remove each query point from its own results.
+      if (sameSet)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          const size_t self = referenceMapping ? (*referenceMapping)[i] : i;
+          for (size_t j = 0; j < neighbors[i].size(); ++j)
+          {
+            if (neighbors[i][j] == self)
+            {
+              neighbors[i].erase(neighbors[i].begin() + j);
+              distances[i].erase(distances[i].begin() + j);
+              break;
+            }
+          }
+        }
       }
     }
-
-    // Finished with temporary objects.
-    delete neighborPtr;
-    delete distancePtr;
   }
+
+  baseCases = totalBaseCases;
+  scores = totalScores;
 }
 
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType>
 template<typename Archive>
-void RangeSearch<MetricType, MatType, TreeType>::serialize(
+void RangeSearch<MetricType, MatType, TreeType,
+DualTreeTraversalType>::serialize(
     Archive& ar,
     const unsigned int /* version */)
 {
@@ -16,6 +16,8 @@
 #include <mlpack/core/util/mlpack_main.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
+#include <mlpack/core/data/for_each_batch.hpp>
 
 #include "range_search.hpp"
 #include "rs_model.hpp"
@@ -62,7 +64,25 @@ PROGRAM_INFO("Range Search",
     " resultant CSV-like files may not be loadable by many programs.  However, "
     "at this time a better way to store this non-square result is not known.  "
     "As a result, any output files will be written as CSVs in this manner, "
-    "regardless of the given extension.",
+    "regardless of the given extension."
+    "\n\n"
+    "Query sets too large to be held in memory can be given with " +
+    PRINT_PARAM_STRING("query_file") + " instead; the file (.mmat, .csv, .txt, "
+    "or .tsv) is then read " + PRINT_PARAM_STRING("query_batch_size") + " "
+    "points at a time, and the results of each batch are appended to the "
+    "output files before the next batch is read.  The reference tree is built "
+    "once and used for every batch."
+    "\n\n"
+    "If only the number of neighbors of each query point is needed, it can be "
+    "saved with " + PRINT_PARAM_STRING("counts") + "; and if the reference "
+    "points are given " + PRINT_PARAM_STRING("weights") + ", the sum of the "
+    "weights of the neighbors of each query point can be saved with " +
+    PRINT_PARAM_STRING("weight_sums") + ".  When neither " +
+    PRINT_PARAM_STRING("neighbors_file") + " nor " +
+    PRINT_PARAM_STRING("distances_file") + " is given, the neighbors are not "
+    "stored, and the nodes of the trees that are entirely in the range of "
+    "a query point are counted at once, without computing the distances of "
+    "their points.",
     SEE_ALSO("@knn", "#knn"),
     SEE_ALSO("Range searching on Wikipedia",
         "https://en.wikipedia.org/wiki/Range_searching"),
@@ -76,6 +96,16 @@ PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
 PARAM_STRING_OUT("distances_file", "File to output distances into.", "d");
 PARAM_STRING_OUT("neighbors_file", "File to output neighbors into.", "n");
 
+// Instead of the neighbors themselves, the number of neighbors of each query
+// point, or the sum of their weights, may be asked for.
+PARAM_UCOL_OUT("counts", "If specified, the number of reference points in the "
+    "range of each query point will be saved here.", "c");
+PARAM_COL_IN("weights", "Weights of the reference points, for "
+    "--weight_sums.", "w");
+PARAM_COL_OUT("weight_sums", "If specified, the sum of the weights of the "
+    "reference points in the range of each query point will be saved here.",
+    "W");
+
 // The option exists to load or save models.
 PARAM_MODEL_IN(RSModel, "input_model", "File containing pre-trained range "
     "search model.", "m");
@@ -88,6 +118,13 @@ PARAM_DOUBLE_IN("max", "Upper bound in range (if not specified, +inf will be "
     "used.", "U", 0.0);
 PARAM_DOUBLE_IN("min", "Lower bound in range.", "L", 0.0);
 
+// Instead, the query points may be read from a file a batch at a time, and the
+// results of each batch written before the next batch is read.
+PARAM_STRING_IN("query_file", "File holding query points to search in "
+    "batches, without loading them into memory (instead of --query).", "Q", "");
+PARAM_INT_IN("query_batch_size", "Number of points read from --query_file at "
+    "a time.", "B", 100000);
+
 // The user may specify the type of tree to use, and a few parameters for tree
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
@@ -104,6 +141,46 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_FLAG("parallel", "If true, the query points are searched in parallel "
+    "with OpenMP.", "P");
+PARAM_INT_IN("threads", "Number of threads to use for parallel search (if 0, "
+    "the OpenMP default is used).", "j", 0);
+
+//! Open the given output file, if it was passed.
+static void OpenResults(const string& paramName, fstream& stream)
+{
+  if (!CLI::HasParam(paramName))
+    return;
+
+  const string filename = CLI::GetParam<string>(paramName);
+  stream.open(filename.c_str(), fstream::out);
+  if (!stream.is_open())
+  {
+    Log::Warn << "Cannot open file '" << filename << "' to save output "
+        << "results to!" << endl;
+  }
+}
+
+//! Write the results of each query point to the given file, one line per point.
+//! We have to do this by hand.
+template<typename ElemType>
+static void SaveResults(fstream& stream,
+                        const vector<vector<ElemType>>& results)
+{
+  // Loop over each point.
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    // Store the results of each point.  We may have 0 points to store, so we
+    // must account for that possibility.
+    for (size_t j = 0; j + 1 < results[i].size(); ++j)
+      stream << results[i][j] << ", ";
+
+    if (results[i].size() > 0)
+      stream << results[i][results[i].size() - 1];
+
+    stream << endl;
+  }
+}
 
 static void mlpackMain()
 {
@@ -127,28 +204,62 @@ static void mlpackMain()
   // If the user specifies a range but not output files, they should be warned.
   if (CLI::HasParam("min") || CLI::HasParam("max"))
   {
-    RequireAtLeastOnePassed({ "neighbors_file", "distances_file" }, false,
-        "no range search results will be saved");
+    RequireAtLeastOnePassed({ "neighbors_file", "distances_file", "counts",
+        "weight_sums" }, false, "no range search results will be saved");
   }
 
   if (!CLI::HasParam("min") && !CLI::HasParam("max"))
   {
     ReportIgnoredParam("neighbors_file", "no range is specified for searching");
     ReportIgnoredParam("distances_file", "no range is specified for searching");
+    ReportIgnoredParam("counts", "no range is specified for searching");
+    ReportIgnoredParam("weight_sums", "no range is specified for searching");
+  }
+
+  // The weights are only used for their sums.
+  if (CLI::HasParam("weight_sums"))
+  {
+    RequireAtLeastOnePassed({ "weights" }, true, "the weights of the reference "
+        "points are needed to sum them");
+  }
+  ReportIgnoredParam({{ "weight_sums", false }}, "weights");
+
+  // The query points can't be given both ways.
+  if (CLI::HasParam("query") && CLI::HasParam("query_file"))
+  {
+    Log::Fatal << "Can only pass one of " << PRINT_PARAM_STRING("query")
+        << " or " << PRINT_PARAM_STRING("query_file") << "!" << endl;
   }
 
   if (CLI::HasParam("input_model") &&
       (CLI::HasParam("min") || CLI::HasParam("max")))
   {
-    RequireAtLeastOnePassed({ "query" }, true, "query set must be passed if "
-        "searching is to be done");
+    RequireAtLeastOnePassed({ "query", "query_file" }, true, "query set must "
+        "be passed if searching is to be done");
   }
 
+  ReportIgnoredParam({{ "query_file", false }}, "query_batch_size");
+  RequireParamValue<int>("query_batch_size", [](int x) { return x > 0; },
+      true, "query batch size must be positive");
+
   // Sanity check on leaf size.
   int lsInt = CLI::GetParam<int>("leaf_size");
   RequireParamValue<int>("leaf_size", [](int x) { return x > 0; }, true,
       "leaf size must be greater than 0");
 
+  // Sanity check on the number of threads.
+  RequireParamValue<int>("threads", [](int x) { return x >= 0; }, true,
+      "number of threads must be non-negative");
+  ReportIgnoredParam({{ "parallel", false }}, "threads");
+  #ifdef HAS_OPENMP
+  if (CLI::GetParam<int>("threads") > 0)
+    omp_set_num_threads(CLI::GetParam<int>("threads"));
+  #else
+  if (CLI::GetParam<int>("threads") > 1)
+    Log::Warn << "mlpack was not compiled with OpenMP support, so only one "
+        << "thread will be used." << endl;
+  #endif
+
   // We either have to load the reference data, or we have to load the model.
   RSModel* rs;
   const bool naive = CLI::HasParam("naive");
@@ -223,6 +334,8 @@ static void mlpackMain()
     rs->LeafSize() = size_t(lsInt);
   }
 
+  rs->Parallel() = CLI::HasParam("parallel");
+
   // Perform search, if desired.
   if (CLI::HasParam("min") || CLI::HasParam("max"))
   {
@@ -246,75 +359,131 @@ static void mlpackMain()
       Log::Warn << PRINT_PARAM_STRING("single_mode") << " ignored because "
           << PRINT_PARAM_STRING("naive") << " is present." << endl;
 
-    // Now run the search.
-    vector<vector<size_t>> neighbors;
-    vector<vector<double>> distances;
+    fstream distancesStr, neighborsStr;
+    OpenResults("distances_file", distancesStr);
+    OpenResults("neighbors_file", neighborsStr);
 
-    if (CLI::HasParam("query"))
-      rs->Search(std::move(queryData), r, neighbors, distances);
-    else
-      rs->Search(r, neighbors, distances);
+    // The neighbors are only found if they are saved; otherwise only their
+    // numbers and weights are computed.
+    const bool findNeighbors = CLI::HasParam("neighbors_file") ||
+        CLI::HasParam("distances_file");
+    const bool findCounts = CLI::HasParam("counts");
+    const bool findSums = CLI::HasParam("weight_sums");
 
-    Log::Info << "Search complete." << endl;
+    arma::vec weights;
+    if (findSums)
+    {
+      weights = std::move(CLI::GetParam<arma::vec>("weights"));
+      if (weights.n_elem != rs->Dataset().n_cols)
+      {
+        Log::Fatal << "The number of weights (" << weights.n_elem << ") does "
+            << "not match the number of reference points ("
+            << rs->Dataset().n_cols << ")!" << endl;
+      }
+    }
 
-    // Save output, if desired.  We have to do this by hand.
-    if (CLI::HasParam("distances_file"))
+    // The numbers of neighbors and the sums of weights of all the query points.
+    arma::Col<size_t> counts;
+    arma::vec sums;
+
+    // Search for the given query points (or the reference set, if NULL), and
+    // save the results, or append their numbers and weights.
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    auto search = [&](arma::mat* queries)
     {
-      const string distancesFile = CLI::GetParam<string>("distances_file");
-      fstream distancesStr(distancesFile.c_str(), fstream::out);
-      if (!distancesStr.is_open())
+      const size_t numQueries = queries ? queries->n_cols :
+          rs->Dataset().n_cols;
+      arma::Col<size_t> queryCounts(numQueries, arma::fill::zeros);
+      arma::vec querySums(numQueries, arma::fill::zeros);
+
+      if (findNeighbors)
       {
-        Log::Warn << "Cannot open file '" << distancesFile << "' to save output"
-            << " distances to!" << endl;
+        if (queries)
+          rs->Search(std::move(*queries), r, neighbors, distances);
+        else
+          rs->Search(r, neighbors, distances);
+
+        if (distancesStr.is_open())
+          SaveResults(distancesStr, distances);
+        if (neighborsStr.is_open())
+          SaveResults(neighborsStr, neighbors);
+
+        for (size_t i = 0; i < neighbors.size(); ++i)
+        {
+          queryCounts[i] = neighbors[i].size();
+          if (findSums)
+            for (size_t j = 0; j < neighbors[i].size(); ++j)
+              querySums[i] += weights[neighbors[i][j]];
+        }
       }
       else
       {
-        // Loop over each point.
-        for (size_t i = 0; i < distances.size(); ++i)
+        if (findCounts)
         {
-          // Store the distances of each point.  We may have 0 points to store,
-          // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < distances[i].size(); ++j)
-            distancesStr << distances[i][j] << ", ";
-
-          if (distances[i].size() > 0)
-            distancesStr << distances[i][distances[i].size() - 1];
-
-          distancesStr << endl;
+          CountResultCallback callback(queryCounts);
+          if (queries && findSums)
+            rs->Search(arma::mat(*queries), r, callback);
+          else if (queries)
+            rs->Search(std::move(*queries), r, callback);
+          else
+            rs->Search(r, callback);
         }
 
-        distancesStr.close();
+        if (findSums)
+        {
+          WeightSumResultCallback callback(weights, querySums);
+          if (queries)
+            rs->Search(std::move(*queries), r, callback);
+          else
+            rs->Search(r, callback);
+        }
       }
-    }
 
-    if (CLI::HasParam("neighbors_file"))
+      if (findCounts)
+        counts = arma::join_cols(counts, queryCounts);
+      if (findSums)
+        sums = arma::join_cols(sums, querySums);
+    };
+
+    if (CLI::HasParam("query_file"))
     {
-      const string neighborsFile = CLI::GetParam<string>("neighbors_file");
-      fstream neighborsStr(neighborsFile.c_str(), fstream::out);
-      if (!neighborsStr.is_open())
+      // Search the query points a batch at a time, and write the results of
+      // each batch before the next one is read.
+      const string queryFile = CLI::GetParam<string>("query_file");
+      const size_t batchSize = (size_t) CLI::GetParam<int>("query_batch_size");
+
+      data::BatchReader reader(queryFile);
+      if (reader.Dimensionality() != rs->Dataset().n_rows)
       {
-        Log::Warn << "Cannot open file '" << neighborsFile << "' to save output"
-            << " neighbor indices to!" << endl;
+        Log::Fatal << "The query points in '" << queryFile << "' have "
+            << reader.Dimensionality() << " dimensions, but the reference "
+            << "points have " << rs->Dataset().n_rows << "!" << endl;
       }
-      else
-      {
-        // Loop over each point.
-        for (size_t i = 0; i < neighbors.size(); ++i)
-        {
-          // Store the neighbors of each point.  We may have 0 points to store,
-          // so we must account for that possibility.
-          for (size_t j = 0; j + 1 < neighbors[i].size(); ++j)
-            neighborsStr << neighbors[i][j] << ", ";
 
-          if (neighbors[i].size() > 0)
-            neighborsStr << neighbors[i][neighbors[i].size() - 1];
+      Log::Info << "Searching query points from '" << queryFile << "' in "
+          << "batches of " << batchSize << " points..." << endl;
 
-          neighborsStr << endl;
-        }
+      const size_t numQueries = data::ForEachBatch(reader, batchSize,
+          [&](const arma::mat& batch, const size_t /* offset */)
+          {
+            arma::mat queries(batch);
+            search(&queries);
+          });
 
-        neighborsStr.close();
-      }
+      Log::Info << "Search complete (" << numQueries << " query points)."
+          << endl;
     }
+    else
+    {
+      search(CLI::HasParam("query") ? &queryData : NULL);
+      Log::Info << "Search complete." << endl;
+    }
+
+    if (findCounts)
+      CLI::GetParam<arma::Col<size_t>>("counts") = std::move(counts);
+    if (findSums)
+      CLI::GetParam<arma::vec>("weight_sums") = std::move(sums);
   }
 
   // Save the output model.
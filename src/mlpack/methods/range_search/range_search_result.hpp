@@ -0,0 +1,430 @@
+/**
+ * @file range_search_result.hpp
+ *
+ * Callbacks that receive the results of a range search as they are found, and
+ * the RangeSearchResult class, which stores the results of a range search in a
+ * compact (compressed sparse row) format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULT_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <unordered_map>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * A range search callback is any object with the method
+ *
+ * @code
+ * void operator()(const size_t queryIndex,
+ *                 const size_t referenceIndex,
+ *                 const double distance);
+ * @endcode
+ *
+ * which is called once for each reference point found in the range of each
+ * query point, as soon as it is found.  The results are not given in any
+ * particular order.
+ *
+ * The VectorResultCallback stores the results in the vector-of-vectors format
+ * used by RangeSearch::Search(): the neighbors and distances given to the
+ * callback must already have one (empty) entry for each query point.
+ *
+ * Callbacks that only aggregate the results, and so don't need the distances
+ * (see RangeCallbackTraits), are given all the descendants of a reference node
+ * at once when the whole node is in the range of a query point, with
+ *
+ * @code
+ * template<typename TreeType>
+ * void AddDescendants(const size_t queryIndex,
+ *                     const TreeType& referenceNode,
+ *                     const size_t begin,
+ *                     const std::vector<size_t>* oldFromNewReferences = NULL);
+ * @endcode
+ *
+ * which adds the descendants begin, ..., referenceNode.NumDescendants() - 1 to
+ * the results of the query point; if oldFromNewReferences is not NULL, the
+ * indices of the descendants must be mapped with it.
+ */
+class VectorResultCallback
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param neighbors Vector to store the neighbors of each query point in.
+   * @param distances Vector to store the distances of each query point in.
+   */
+  VectorResultCallback(std::vector<std::vector<size_t>>& neighbors,
+                       std::vector<std::vector<double>>& distances) :
+      neighbors(neighbors),
+      distances(distances)
+  { /* Nothing to do. */ }
+
+  //! Store the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>& distances;
+};
+
+/**
+ * The RangeCallbackTraits class tells the range search rules whether a callback
+ * can take all the descendants of a reference node at once with
+ * AddDescendants(), without the distances of the points.  By default, the
+ * callbacks are given each result with its distance.
+ */
+template<typename CallbackType>
+class RangeCallbackTraits
+{
+ public:
+  //! Whether the callback has AddDescendants().
+  static const bool AddsDescendants = false;
+};
+
+/**
+ * The CountResultCallback counts the number of reference points in the range of
+ * each query point.  The counts given to the callback must already have one
+ * (zero) element for each query point.  Reference nodes entirely in the range
+ * are counted with their number of descendants, without evaluating the
+ * distances of their points.
+ */
+class CountResultCallback
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param counts Vector to store the number of neighbors of each query point
+   *      in.
+   */
+  CountResultCallback(arma::Col<size_t>& counts) : counts(counts) { }
+
+  //! Count the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t /* referenceIndex */,
+                  const double /* distance */)
+  {
+    ++counts[queryIndex];
+  }
+
+  //! Count the descendants of the given node, from the given one on.
+  template<typename TreeType>
+  void AddDescendants(const size_t queryIndex,
+                      const TreeType& referenceNode,
+                      const size_t begin,
+                      const std::vector<size_t>* /* oldFromNew */ = NULL)
+  {
+    counts[queryIndex] += referenceNode.NumDescendants() - begin;
+  }
+
+ private:
+  //! The number of neighbors of each query point.
+  arma::Col<size_t>& counts;
+};
+
+//! The CountResultCallback takes whole reference nodes.
+template<>
+class RangeCallbackTraits<CountResultCallback>
+{
+ public:
+  static const bool AddsDescendants = true;
+};
+
+/**
+ * The WeightSumResultCallback adds up the weights of the reference points in
+ * the range of each query point.  The sums given to the callback must already
+ * have one (zero) element for each query point.  The sum of the weights of the
+ * descendants of each reference node is computed once, the first time the node
+ * is entirely in the range of a query point, and then reused; so a callback
+ * must only be used for one search (or for searches with the same reference
+ * tree).
+ */
+class WeightSumResultCallback
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param weights Weights of the reference points.
+   * @param sums Vector to store the sum of the weights of the neighbors of each
+   *      query point in.
+   */
+  WeightSumResultCallback(const arma::vec& weights, arma::vec& sums) :
+      weights(weights),
+      sums(sums)
+  { /* Nothing to do. */ }
+
+  //! Add the weight of the given result.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double /* distance */)
+  {
+    sums[queryIndex] += weights[referenceIndex];
+  }
+
+  //! Add the weights of the descendants of the given node, from the given one
+  //! on.
+  template<typename TreeType>
+  void AddDescendants(const size_t queryIndex,
+                      const TreeType& referenceNode,
+                      const size_t begin,
+                      const std::vector<size_t>* oldFromNew = NULL)
+  {
+    std::unordered_map<const void*, double>::iterator it =
+        nodeSums.find(&referenceNode);
+    if (it == nodeSums.end())
+    {
+      double sum = 0.0;
+      for (size_t i = 0; i < referenceNode.NumDescendants(); ++i)
+        sum += weights[Index(referenceNode.Descendant(i), oldFromNew)];
+      it = nodeSums.insert(std::make_pair(&referenceNode, sum)).first;
+    }
+
+    double sum = it->second;
+    for (size_t i = 0; i < begin; ++i)
+      sum -= weights[Index(referenceNode.Descendant(i), oldFromNew)];
+    sums[queryIndex] += sum;
+  }
+
+ private:
+  //! Map the given reference index, if necessary.
+  static size_t Index(const size_t index, const std::vector<size_t>* oldFromNew)
+  {
+    return oldFromNew ? (*oldFromNew)[index] : index;
+  }
+
+  //! The weights of the reference points.
+  const arma::vec& weights;
+  //! The sum of the weights of the neighbors of each query point.
+  arma::vec& sums;
+  //! The sums of the weights of the descendants of the nodes seen so far.
+  std::unordered_map<const void*, double> nodeSums;
+};
+
+//! The WeightSumResultCallback takes whole reference nodes.
+template<>
+class RangeCallbackTraits<WeightSumResultCallback>
+{
+ public:
+  static const bool AddsDescendants = true;
+};
+
+/**
+ * The MappedResultCallback passes the results to another callback after
+ * mapping the indices of the query and reference points from the order of the
+ * trees back to the order of the original datasets.  This is used internally by
+ * RangeSearch when it builds trees that rearrange the datasets.
+ *
+ * @tparam CallbackType Type of the callback to pass the results to.
+ */
+template<typename CallbackType>
+class MappedResultCallback
+{
+ public:
+  /**
+   * Create the callback.
+   *
+   * @param callback Callback to pass the mapped results to.
+   * @param oldFromNewQueries Mapping of the query points, or NULL if the query
+   *      indices are not to be mapped.
+   * @param oldFromNewReferences Mapping of the reference points, or NULL if the
+   *      reference indices are not to be mapped.
+   */
+  MappedResultCallback(CallbackType& callback,
+                       const std::vector<size_t>* oldFromNewQueries,
+                       const std::vector<size_t>* oldFromNewReferences) :
+      callback(callback),
+      oldFromNewQueries(oldFromNewQueries),
+      oldFromNewReferences(oldFromNewReferences)
+  { /* Nothing to do. */ }
+
+  //! Map the given result and pass it to the callback.
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    callback(oldFromNewQueries ? (*oldFromNewQueries)[queryIndex] : queryIndex,
+        oldFromNewReferences ? (*oldFromNewReferences)[referenceIndex] :
+        referenceIndex, distance);
+  }
+
+  /**
+   * Pass the given reference node to the callback, with the mappings.  The
+   * descendants of the node can only be mapped once, so at most one of the
+   * given mapping and the reference mapping of this callback may be given.
+   */
+  template<typename TreeType>
+  void AddDescendants(const size_t queryIndex,
+                      const TreeType& referenceNode,
+                      const size_t begin,
+                      const std::vector<size_t>* oldFromNew = NULL)
+  {
+    callback.AddDescendants(oldFromNewQueries ?
+        (*oldFromNewQueries)[queryIndex] : queryIndex, referenceNode, begin,
+        oldFromNewReferences ? oldFromNewReferences : oldFromNew);
+  }
+
+ private:
+  //! The callback to pass the results to.
+  CallbackType& callback;
+  //! The mapping of the query points (may be NULL).
+  const std::vector<size_t>* oldFromNewQueries;
+  //! The mapping of the reference points (may be NULL).
+  const std::vector<size_t>* oldFromNewReferences;
+};
+
+//! The MappedResultCallback takes whole reference nodes if its callback does.
+template<typename CallbackType>
+class RangeCallbackTraits<MappedResultCallback<CallbackType>>
+{
+ public:
+  static const bool AddsDescendants =
+      RangeCallbackTraits<CallbackType>::AddsDescendants;
+};
+
+/**
+ * The RangeSearchResult class holds the results of a range search in
+ * compressed sparse row format: the neighbors of all the query points are
+ * stored in one array, and the neighbors of query point i are at the positions
+ * Offsets()[i] to Offsets()[i + 1] - 1 of Neighbors() and Distances().  This
+ * takes a constant number of allocations, instead of two per query point for
+ * the vector-of-vectors format, so it is much more compact when there are many
+ * query points.
+ *
+ * RangeSearch::Search() fills the object with Reset(), one call of the
+ * operator() for each result, and Finalize().  The results given to the
+ * operator() are buffered, and Finalize() sorts them by query point; the
+ * neighbors of each query point keep the order in which they were found.
+ */
+class RangeSearchResult
+{
+ public:
+  //! Create an empty result, with no query points.
+  RangeSearchResult() : offsets(1, arma::fill::zeros) { }
+
+  /**
+   * Remove all the results, and prepare to receive the results of the given
+   * number of query points.
+   *
+   * @param numQueries Number of query points.
+   */
+  void Reset(const size_t numQueries)
+  {
+    offsets.zeros(numQueries + 1);
+    neighbors.reset();
+    distances.reset();
+    bufferQueries.clear();
+    bufferNeighbors.clear();
+    bufferDistances.clear();
+  }
+
+  //! Buffer the given result; it is available after Finalize().
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    bufferQueries.push_back(queryIndex);
+    bufferNeighbors.push_back(referenceIndex);
+    bufferDistances.push_back(distance);
+  }
+
+  /**
+   * Sort the buffered results by query point (with a counting sort, so that
+   * the order of the neighbors of each query point is kept), and free the
+   * buffers.
+   */
+  void Finalize()
+  {
+    const size_t numQueries = offsets.n_elem - 1;
+    offsets.zeros();
+    for (size_t i = 0; i < bufferQueries.size(); ++i)
+      ++offsets[bufferQueries[i] + 1];
+    for (size_t i = 0; i < numQueries; ++i)
+      offsets[i + 1] += offsets[i];
+
+    neighbors.set_size(bufferQueries.size());
+    distances.set_size(bufferQueries.size());
+    arma::Col<size_t> positions = offsets;
+    for (size_t i = 0; i < bufferQueries.size(); ++i)
+    {
+      const size_t position = positions[bufferQueries[i]]++;
+      neighbors[position] = bufferNeighbors[i];
+      distances[position] = bufferDistances[i];
+    }
+
+    // Free the memory of the buffers.
+    std::vector<size_t>().swap(bufferQueries);
+    std::vector<size_t>().swap(bufferNeighbors);
+    std::vector<double>().swap(bufferDistances);
+  }
+
+  //! Get the number of query points.
+  size_t NumQueries() const { return offsets.n_elem - 1; }
+
+  //! Get the total number of results.
+  size_t NumResults() const { return neighbors.n_elem; }
+
+  //! Get the number of neighbors of the given query point.
+  size_t NumNeighbors(const size_t queryIndex) const
+  {
+    return offsets[queryIndex + 1] - offsets[queryIndex];
+  }
+
+  //! Get the index of the j'th neighbor of the given query point.
+  size_t Neighbor(const size_t queryIndex, const size_t j) const
+  {
+    return neighbors[offsets[queryIndex] + j];
+  }
+
+  //! Get the distance of the j'th neighbor of the given query point.
+  double Distance(const size_t queryIndex, const size_t j) const
+  {
+    return distances[offsets[queryIndex] + j];
+  }
+
+  //! Get the offsets of the neighbors of each query point (with one extra
+  //! element at the end, the total number of results).
+  const arma::Col<size_t>& Offsets() const { return offsets; }
+
+  //! Get the neighbors of all the query points.
+  const arma::Col<size_t>& Neighbors() const { return neighbors; }
+
+  //! Get the distances of all the query points.
+  const arma::vec& Distances() const { return distances; }
+
+ private:
+  //! The offset of the neighbors of each query point.
+  arma::Col<size_t> offsets;
+  //! The neighbors of all the query points.
+  arma::Col<size_t> neighbors;
+  //! The distances of all the query points.
+  arma::vec distances;
+
+  //! The query points of the results that are not finalized yet.
+  std::vector<size_t> bufferQueries;
+  //! The neighbors of the results that are not finalized yet.
+  std::vector<size_t> bufferNeighbors;
+  //! The distances of the results that are not finalized yet.
+  std::vector<double> bufferDistances;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
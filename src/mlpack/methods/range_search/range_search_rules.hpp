@@ -13,18 +13,28 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/rule_traits.hpp>
+#include <mlpack/core/tree/multi_statistic.hpp>
+#include <mlpack/core/metrics/block_distances.hpp>
+#include "range_search_result.hpp"
+#include "range_search_stat.hpp"
 
 namespace mlpack {
 namespace range {
 
 /**
  * The RangeSearchRules class is a template helper class used by RangeSearch
- * class when performing range searches.
+ * class when performing range searches.  Each result is handed to a callback as
+ * soon as it is found (see range_search_result.hpp); the results are not
+ * stored by the rules.
  *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam CallbackType The type of the callback the results are given to.
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType,
+         typename TreeType,
+         typename CallbackType = VectorResultCallback>
 class RangeSearchRules
 {
  public:
@@ -35,8 +45,8 @@ class RangeSearchRules
    * @param referenceSet Set of reference data.
    * @param querySet Set of query data.
    * @param range Range to search for.
-   * @param neighbors Vector to store resulting neighbors in.
-   * @param distances Vector to store resulting distances in.
+   * @param callback Callback to give the results to, with the indices of the
+   *      points in the given datasets.
    * @param metric Instantiated metric.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
@@ -44,8 +54,7 @@ class RangeSearchRules
   RangeSearchRules(const arma::mat& referenceSet,
                    const arma::mat& querySet,
                    const math::Range& range,
-                   std::vector<std::vector<size_t> >& neighbors,
-                   std::vector<std::vector<double> >& distances,
+                   CallbackType& callback,
                    MetricType& metric,
                    const bool sameSet = false);
 
@@ -107,6 +116,20 @@ class RangeSearchRules
                  TreeType& referenceNode,
                  const double oldScore) const;
 
+  /**
+   * Perform the base cases between the points of two leaves: for each query
+   * point of the query node that Score() does not prune the reference node for,
+   * the base cases with all the points of the reference node.  If the block is
+   * large enough, its distances are computed at once (see
+   * metric::BlockDistances), and only the pairs that may be in the range are
+   * evaluated exactly, so the results do not change.
+   *
+   * @param queryNode Query leaf.
+   * @param referenceNode Reference leaf.
+   * @return The number of base cases that were performed.
+   */
+  size_t BaseCaseBlock(TreeType& queryNode, TreeType& referenceNode);
+
   typedef typename tree::TraversalInfo<TreeType> TraversalInfoType;
 
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
@@ -114,8 +137,12 @@ class RangeSearchRules
 
   //! Get the number of base cases.
   size_t BaseCases() const { return baseCases; }
+  //! Modify the number of base cases.
+  size_t& BaseCases() { return baseCases; }
   //! Get the number of scores (that is, calls to RangeDistance()).
   size_t Scores() const { return scores; }
+  //! Modify the number of scores.
+  size_t& Scores() { return scores; }
 
  private:
   //! The reference set.
@@ -127,11 +154,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The callback the results are given to.
+  CallbackType& callback;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -150,6 +174,28 @@ class RangeSearchRules
   void AddResult(const size_t queryIndex,
                  TreeType& referenceNode);
 
+  /**
+   * Give the descendants of the reference node from the given one on to the
+   * callback all at once, if it can take them (see RangeCallbackTraits) and the
+   * query point can't be one of them.  Returns false if the results must be
+   * given one by one instead.
+   */
+  template<typename C = CallbackType>
+  typename std::enable_if<RangeCallbackTraits<C>::AddsDescendants, bool>::type
+  AddDescendants(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const size_t begin);
+
+  //! The callback can't take whole nodes, so nothing is done.
+  template<typename C = CallbackType>
+  typename std::enable_if<!RangeCallbackTraits<C>::AddsDescendants, bool>::type
+  AddDescendants(const size_t /* queryIndex */,
+                 TreeType& /* referenceNode */,
+                 const size_t /* begin */)
+  {
+    return false;
+  }
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases.
@@ -159,6 +205,19 @@ class RangeSearchRules
 };
 
 } // namespace range
+
+namespace tree {
+
+//! RangeSearchRules can evaluate the base cases between two leaves at once.
+template<typename MetricType, typename TreeType, typename CallbackType>
+class RuleTraits<range::RangeSearchRules<MetricType, TreeType, CallbackType>>
+{
+ public:
+  static const bool HasBaseCaseBlock = true;
+  static const bool HasBaseCaseBatch = false;
+};
+
+} // namespace tree
 } // namespace mlpack
 
 // Include implementation.
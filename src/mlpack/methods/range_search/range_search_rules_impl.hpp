@@ -18,20 +18,18 @@
 namespace mlpack {
 namespace range {
 
-template<typename MetricType, typename TreeType>
-RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
+template<typename MetricType, typename TreeType, typename CallbackType>
+RangeSearchRules<MetricType, TreeType, CallbackType>::RangeSearchRules(
     const arma::mat& referenceSet,
     const arma::mat& querySet,
     const math::Range& range,
-    std::vector<std::vector<size_t> >& neighbors,
-    std::vector<std::vector<double> >& distances,
+    CallbackType& callback,
     MetricType& metric,
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    callback(callback),
     metric(metric),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
@@ -44,9 +42,9 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
 
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
-template<typename MetricType, typename TreeType>
+template<typename MetricType, typename TreeType, typename CallbackType>
 inline force_inline
-double RangeSearchRules<MetricType, TreeType>::BaseCase(
+double RangeSearchRules<MetricType, TreeType, CallbackType>::BaseCase(
     const size_t queryIndex,
     const size_t referenceIndex)
 {
@@ -67,18 +65,16 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastReferenceIndex = referenceIndex;
 
   if (range.Contains(distance))
-  {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
-  }
+    callback(queryIndex, referenceIndex, distance);
 
   return distance;
 }
 
 //! Single-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename CallbackType>
+double RangeSearchRules<MetricType, TreeType, CallbackType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // We must get the minimum and maximum distances and store them in this
   // object.
@@ -95,7 +91,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
     {
       // If the tree has self-children and this is a self-child, the base case
       // was already calculated.
-      baseCase = referenceNode.Parent()->Stat().LastDistance();
+      baseCase = tree::GetStatistic<RangeSearchStat>(
+          referenceNode.Parent()->Stat()).LastDistance();
       lastQueryIndex = queryIndex;
       lastReferenceIndex = referenceNode.Point(0);
     }
@@ -110,7 +107,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
     distances.Hi() = baseCase + referenceNode.FurthestDescendantDistance();
 
     // Update last distance calculation.
-    referenceNode.Stat().LastDistance() = baseCase;
+    tree::GetStatistic<RangeSearchStat>(referenceNode.Stat()).LastDistance() =
+        baseCase;
   }
   else
   {
@@ -136,8 +134,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
 }
 
 //! Single-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename CallbackType>
+double RangeSearchRules<MetricType, TreeType, CallbackType>::Rescore(
     const size_t /* queryIndex */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -147,9 +145,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 }
 
 //! Dual-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename CallbackType>
+double RangeSearchRules<MetricType, TreeType, CallbackType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
 {
   math::Range distances;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -209,8 +208,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
 }
 
 //! Dual-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename CallbackType>
+double RangeSearchRules<MetricType, TreeType, CallbackType>::Rescore(
     TreeType& /* queryNode */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -219,11 +218,75 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
   return oldScore;
 }
 
+//! Base cases between two leaves.
+template<typename MetricType, typename TreeType, typename CallbackType>
+size_t RangeSearchRules<MetricType, TreeType, CallbackType>::BaseCaseBlock(
+    TreeType& queryNode,
+    TreeType& referenceNode)
+{
+  // Find the query points that the reference node can't be pruned for.  The
+  // traversal info is restored before each score, as the traversers do.
+  const TraversalInfoType info = traversalInfo;
+  std::vector<size_t> queries;
+  queries.reserve(queryNode.NumPoints());
+  for (size_t i = 0; i < queryNode.NumPoints(); ++i)
+  {
+    traversalInfo = info;
+    if (Score(queryNode.Point(i), referenceNode) != DBL_MAX)
+      queries.push_back(queryNode.Point(i));
+  }
+
+  const size_t numReferences = referenceNode.NumPoints();
+  if (!metric::BlockDistances<MetricType>::template Worthwhile<arma::mat>(
+      queries.size(), numReferences))
+  {
+    for (size_t i = 0; i < queries.size(); ++i)
+      for (size_t j = 0; j < numReferences; ++j)
+        BaseCase(queries[i], referenceNode.Point(j));
+
+    return queries.size() * numReferences;
+  }
+
+  std::vector<size_t> references(numReferences);
+  for (size_t j = 0; j < numReferences; ++j)
+    references[j] = referenceNode.Point(j);
+
+  arma::mat distances;
+  arma::vec errors;
+  metric::BlockDistances<MetricType>::Evaluate(metric, querySet, queries,
+      referenceSet, references, distances, errors);
+  baseCases += queries.size() * numReferences;
+
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const size_t queryIndex = queries[i];
+    for (size_t j = 0; j < numReferences; ++j)
+    {
+      const size_t referenceIndex = references[j];
+      if (sameSet && (queryIndex == referenceIndex))
+        continue;
+
+      // Only evaluate the distance exactly if it may be in the range.
+      if ((distances(i, j) + errors[i] < range.Lo()) ||
+          (distances(i, j) - errors[i] > range.Hi()))
+        continue;
+
+      const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
+          referenceSet.unsafe_col(referenceIndex));
+      if (range.Contains(distance))
+        callback(queryIndex, referenceIndex, distance);
+    }
+  }
+
+  return queries.size() * numReferences;
+}
+
 //! Add all the points in the given node to the results for the given query
 //! point.
-template<typename MetricType, typename TreeType>
-void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
-                                                       TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename CallbackType>
+void RangeSearchRules<MetricType, TreeType, CallbackType>::AddResult(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // Some types of trees calculate the base case evaluation before Score() is
   // called, so if the base case has already been calculated, then we must avoid
@@ -236,14 +299,9 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     baseCaseMod = 1;
   }
 
-  // Resize distances and neighbors vectors appropriately.  We have to use
-  // reserve() and not resize(), because we don't know if we will encounter the
-  // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  // Callbacks that only aggregate the results don't need the distances.
+  if (AddDescendants(queryIndex, referenceNode, baseCaseMod))
+    return;
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -254,11 +312,30 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
         referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    callback(queryIndex, referenceNode.Descendant(i), distance);
   }
 }
 
+//! Give all the descendants of a reference node to the callback at once.
+template<typename MetricType, typename TreeType, typename CallbackType>
+template<typename C>
+typename std::enable_if<RangeCallbackTraits<C>::AddsDescendants, bool>::type
+RangeSearchRules<MetricType, TreeType, CallbackType>::AddDescendants(
+    const size_t queryIndex,
+    TreeType& referenceNode,
+    const size_t begin)
+{
+  // When the query set is the reference set, the query point must not be in
+  // its own results; it can only be a descendant of a node whose bound
+  // contains it.
+  if ((&referenceSet == &querySet) &&
+      (referenceNode.MinDistance(querySet.unsafe_col(queryIndex)) == 0.0))
+    return false;
+
+  callback.AddDescendants(queryIndex, referenceNode, begin);
+  return true;
+}
+
 } // namespace range
 } // namespace mlpack
 
@@ -116,6 +116,88 @@ class BiSearchVisitor : public boost::static_visitor<void>
                   const size_t leafSize);
 };
 
+/**
+ * MonoCallbackSearchVisitor executes a monochromatic range search on the given
+ * RSType, and gives the results to a callback (see range_search_result.hpp).
+ */
+template<typename CallbackType>
+class MonoCallbackSearchVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The range to search for.
+  const math::Range& range;
+  //! The callback to give the results to.
+  CallbackType& callback;
+
+ public:
+  //! Perform monochromatic search with the given RangeSearch object.
+  template<typename RSType>
+  void operator()(RSType* rs) const;
+
+  //! Construct the MonoCallbackSearchVisitor with the given parameters.
+  MonoCallbackSearchVisitor(const math::Range& range, CallbackType& callback) :
+      range(range),
+      callback(callback)
+  { }
+};
+
+/**
+ * BiCallbackSearchVisitor executes a bichromatic range search on the given
+ * RSType, and gives the results to a callback (see range_search_result.hpp).
+ * As with BiSearchVisitor, the query trees of the tree types that take a leaf
+ * size are built with the leaf size of the model.
+ */
+template<typename CallbackType>
+class BiCallbackSearchVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The query set for the bichromatic search.
+  const arma::mat& querySet;
+  //! Range to search neighbours for.
+  const math::Range& range;
+  //! The callback to give the results to.
+  CallbackType& callback;
+  //! The number of points in a leaf (for BinarySpaceTrees).
+  const size_t leafSize;
+
+  //! Bichromatic range search on the given RSType considering the leafSize.
+  template<typename RSType>
+  void SearchLeaf(RSType* rs) const;
+
+ public:
+  //! Alias template necessary for visual c++ compiler.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  using RSTypeT = RSType<TreeType>;
+
+  //! Default Bichromatic range search on the given RSType instance.
+  template<template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(RSTypeT<TreeType>* rs) const;
+
+  //! Bichromatic range search on the given RSType specialized for KDTrees.
+  void operator()(RSTypeT<tree::KDTree>* rs) const;
+
+  //! Bichromatic range search on the given RSType specialized for BallTrees.
+  void operator()(RSTypeT<tree::BallTree>* rs) const;
+
+  //! Bichromatic range search specialized for octrees.
+  void operator()(RSTypeT<tree::Octree>* rs) const;
+
+  //! Construct the BiCallbackSearchVisitor.
+  BiCallbackSearchVisitor(const arma::mat& querySet,
+                          const math::Range& range,
+                          CallbackType& callback,
+                          const size_t leafSize) :
+      querySet(querySet),
+      range(range),
+      callback(callback),
+      leafSize(leafSize)
+  { }
+};
+
 /**
  * TrainVisitor sets the reference set to a new reference set on the given
  * RSType. We use template specialization to differentiate those tree types that
@@ -209,6 +291,19 @@ class NaiveVisitor : public boost::static_visitor<bool&>
   bool& operator()(RSType* rs) const;
 };
 
+/**
+ * ParallelVisitor exposes the Parallel() method of the given RSType.
+ */
+class ParallelVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  /**
+   * Get a reference to the parallel parameter of the given RangeSearch object.
+   */
+  template<typename RSType>
+  bool& operator()(RSType* rs) const;
+};
+
 class RSModel
 {
  public:
@@ -315,6 +410,11 @@ class RSModel
   //! Modify whether the model is in naive search mode.
   bool& Naive();
 
+  //! Get whether the search is parallel.
+  bool Parallel() const;
+  //! Modify whether the search is parallel.
+  bool& Parallel();
+
   //! Get the leaf size (applicable to everything but the cover tree).
   size_t LeafSize() const { return leafSize; }
   //! Modify the leaf size (applicable to everything but the cover tree).
@@ -373,6 +473,33 @@ class RSModel
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Perform range search, and give each result to the given callback (see
+   * RangeSearch<>::Search()).  With a CountResultCallback or a
+   * WeightSumResultCallback, only the number of neighbors of each query point
+   * or the sum of their weights is computed.  This takes possession of the
+   * query set.
+   *
+   * @param querySet Set of query points.
+   * @param range Range to search for.
+   * @param callback Callback to give the results to.
+   */
+  template<typename CallbackType>
+  void Search(arma::mat&& querySet,
+              const math::Range& range,
+              CallbackType& callback);
+
+  /**
+   * Perform monochromatic range search, with the reference set as the query
+   * set, and give each result to the given callback.  A point is not in its
+   * own range.
+   *
+   * @param range Range to search for.
+   * @param callback Callback to give the results to.
+   */
+  template<typename CallbackType>
+  void Search(const math::Range& range, CallbackType& callback);
+
  private:
   /**
    * Return a string representing the name of the tree.  This is used for
@@ -380,6 +507,9 @@ class RSModel
    */
   std::string TreeName() const;
 
+  //! Log the kind of search that is about to be performed.
+  void LogSearch(const math::Range& range) const;
+
   /**
    * Clean up memory.
    */
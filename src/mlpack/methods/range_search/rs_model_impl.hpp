@@ -184,16 +184,7 @@ inline void RSModel::Search(arma::mat&& querySet,
   if (randomBasis)
     querySet = q * querySet;
 
-  Log::Info << "Search for points in the range [" << range.Lo() << ", "
-      << range.Hi() << "] with ";
-  if (!Naive() && !SingleMode())
-    Log::Info << "dual-tree " << TreeName() << " search..." << std::endl;
-  else if (!Naive())
-    Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
-  else
-    Log::Info << "brute-force (naive) search..." << std::endl;
-
-
+  LogSearch(range);
   BiSearchVisitor search(querySet, range, neighbors, distances,
       leafSize);
   boost::apply_visitor(search, rSearch);
@@ -203,6 +194,39 @@ inline void RSModel::Search(arma::mat&& querySet,
 inline void RSModel::Search(const math::Range& range,
                             std::vector<std::vector<size_t>>& neighbors,
                             std::vector<std::vector<double>>& distances)
+{
+  LogSearch(range);
+  MonoSearchVisitor search(range, neighbors, distances);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Perform range search with a callback.
+template<typename CallbackType>
+void RSModel::Search(arma::mat&& querySet,
+                     const math::Range& range,
+                     CallbackType& callback)
+{
+  // We may need to map the query set randomly.
+  if (randomBasis)
+    querySet = q * querySet;
+
+  LogSearch(range);
+  BiCallbackSearchVisitor<CallbackType> search(querySet, range, callback,
+      leafSize);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Perform range search with a callback (monochromatic case).
+template<typename CallbackType>
+void RSModel::Search(const math::Range& range, CallbackType& callback)
+{
+  LogSearch(range);
+  MonoCallbackSearchVisitor<CallbackType> search(range, callback);
+  boost::apply_visitor(search, rSearch);
+}
+
+// Log the kind of search.
+inline void RSModel::LogSearch(const math::Range& range) const
 {
   Log::Info << "Search for points in the range [" << range.Lo() << ", "
       << range.Hi() << "] with ";
@@ -212,9 +236,6 @@ inline void RSModel::Search(const math::Range& range,
     Log::Info << "single-tree " << TreeName() << " search..." << std::endl;
   else
     Log::Info << "brute-force (naive) search..." << std::endl;
-
-  MonoSearchVisitor search(range, neighbors, distances);
-  boost::apply_visitor(search, rSearch);
 }
 
 // Get the name of the tree type.
@@ -323,7 +344,8 @@ inline void BiSearchVisitor::operator()(RSTypeT<tree::Octree>* rs) const
 template<typename RSType>
 void BiSearchVisitor::SearchLeaf(RSType* rs) const
 {
-  if (!rs->Naive() && !rs->SingleMode())
+  // Parallel search builds its own query trees.
+  if (!rs->Naive() && !rs->SingleMode() && !rs->Parallel())
   {
     // Build a second tree and search.
     Timer::Start("tree_building");
@@ -351,6 +373,84 @@ void BiSearchVisitor::SearchLeaf(RSType* rs) const
     rs->Search(querySet, range, neighbors, distances);
 }
 
+//! Monochromatic range search with a callback on the given RSType instance.
+template<typename CallbackType>
+template<typename RSType>
+void MonoCallbackSearchVisitor<CallbackType>::operator()(RSType* rs) const
+{
+  if (rs)
+    return rs->Search(range, callback);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Default bichromatic range search with a callback on the given RSType.
+template<typename CallbackType>
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void BiCallbackSearchVisitor<CallbackType>::operator()(
+    RSTypeT<TreeType>* rs) const
+{
+  if (rs)
+    return rs->Search(querySet, range, callback);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search with a callback specialized for KDTrees.
+template<typename CallbackType>
+void BiCallbackSearchVisitor<CallbackType>::operator()(
+    RSTypeT<tree::KDTree>* rs) const
+{
+  if (rs)
+    return SearchLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search with a callback specialized for BallTrees.
+template<typename CallbackType>
+void BiCallbackSearchVisitor<CallbackType>::operator()(
+    RSTypeT<tree::BallTree>* rs) const
+{
+  if (rs)
+    return SearchLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search with a callback specialized for octrees.
+template<typename CallbackType>
+void BiCallbackSearchVisitor<CallbackType>::operator()(
+    RSTypeT<tree::Octree>* rs) const
+{
+  if (rs)
+    return SearchLeaf(rs);
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Bichromatic range search with a callback considering the leafSize.
+template<typename CallbackType>
+template<typename RSType>
+void BiCallbackSearchVisitor<CallbackType>::SearchLeaf(RSType* rs) const
+{
+  // Parallel search builds its own query trees.
+  if (!rs->Naive() && !rs->SingleMode() && !rs->Parallel())
+  {
+    // Build a second tree and search, mapping the query points back.
+    Timer::Start("tree_building");
+    Log::Info << "Building query tree..." << std::endl;
+    std::vector<size_t> oldFromNewQueries;
+    typename RSType::Tree queryTree(std::move(querySet), oldFromNewQueries,
+        leafSize);
+    Log::Info << "Tree built." << std::endl;
+    Timer::Stop("tree_building");
+
+    MappedResultCallback<CallbackType> mappedCallback(callback,
+        &oldFromNewQueries, NULL);
+    rs->Search(&queryTree, range, mappedCallback);
+  }
+  else
+    rs->Search(querySet, range, callback);
+}
+
 //! Save parameters for Train.
 inline TrainVisitor::TrainVisitor(arma::mat&& referenceSet,
                                   const size_t leafSize) :
@@ -448,6 +548,15 @@ bool& NaiveVisitor::operator()(RSType* rs) const
   throw std::runtime_error("no range search model initialized");
 }
 
+//! Exposes Parallel() function of given RSType
+template<typename RSType>
+bool& ParallelVisitor::operator()(RSType* rs) const
+{
+  if (rs)
+    return rs->Parallel();
+  throw std::runtime_error("no range search model initialized");
+}
+
 // Serialize the model.
 template<typename Archive>
 void RSModel::serialize(Archive& ar, const unsigned int /* version */)
@@ -489,6 +598,16 @@ inline bool& RSModel::Naive()
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
+inline bool RSModel::Parallel() const
+{
+  return boost::apply_visitor(ParallelVisitor(), rSearch);
+}
+
+inline bool& RSModel::Parallel()
+{
+  return boost::apply_visitor(ParallelVisitor(), rSearch);
+}
+
 } // namespace range
 } // namespace mlpack
 
@@ -107,6 +107,8 @@ PARAM_FLAG("naive", "If true, sampling will be done without using a tree.",
            "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
            "dual-tree search.", "S");
+PARAM_FLAG("parallel", "If true, the query points are searched in parallel "
+    "(in blocks, each with its own random number generator).", "P");
 PARAM_FLAG("sample_at_leaves", "The flag to trigger sampling at leaves.", "L");
 PARAM_FLAG("first_leaf_exact", "The flag to trigger sampling only after "
            "exactly exploring the first leaf.", "X");
@@ -223,6 +225,7 @@ static void mlpackMain()
     rann->Alpha() = CLI::GetParam<double>("alpha");
   if (CLI::HasParam("single_sample_limit"))
     rann->SingleSampleLimit() = CLI::GetParam<double>("single_sample_limit");
+  rann->Parallel() = CLI::HasParam("parallel");
   rann->SampleAtLeaves() = CLI::HasParam("sample_at_leaves");
   rann->FirstLeafExact() = CLI::HasParam("sample_at_leaves");
 
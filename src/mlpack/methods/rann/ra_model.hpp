@@ -225,6 +225,17 @@ class SingleModeVisitor : public boost::static_visitor<bool&>
   bool& operator()(RAType* ra) const;
 };
 
+/**
+ * Exposes the Parallel() method of the given RAType.
+ */
+class ParallelVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Get a reference to the Parallel parameter of the given RASearch object.
+  template<typename RAType>
+  bool& operator()(RAType* ra) const;
+};
+
 /**
  * Exposes the referenceSet of the given RAType.
  */
@@ -362,6 +373,11 @@ class RAModel
   //! Modify whether or not single-tree search is being used.
   bool& SingleMode();
 
+  //! Get whether or not searches are run in parallel.
+  bool Parallel() const;
+  //! Modify whether or not searches are run in parallel.
+  bool& Parallel();
+
   //! Get whether or not naive search is being used.
   bool Naive() const;
   //! Modify whether or not naive search is being used.
@@ -78,7 +78,8 @@ template<typename SortPolicy>
 template<typename RAType>
 void BiSearchVisitor<SortPolicy>::SearchLeaf(RAType* ra) const
 {
-  if (!ra->Naive() && !ra->SingleMode())
+  // A parallel search builds a tree on each block of query points itself.
+  if (!ra->Naive() && !ra->SingleMode() && !ra->Parallel())
   {
     // Build a second tree and search
     Timer::Start("tree_building");
@@ -225,6 +226,15 @@ bool& SingleModeVisitor::operator()(RAType* ra) const
   throw std::runtime_error("no rank-approximate model is initialized");
 }
 
+//! Exposes the Parallel() method of the given RAType.
+template<typename RAType>
+bool& ParallelVisitor::operator()(RAType* ra) const
+{
+  if (ra)
+    return ra->Parallel();
+  throw std::runtime_error("no rank-approximate model is initialized");
+}
+
 //! Exposes the referenceSet of the given RAType.
 template<typename RAType>
 const arma::mat& ReferenceSetVisitor::operator()(RAType* ra) const
@@ -356,6 +366,18 @@ const arma::mat& RAModel<SortPolicy>::Dataset() const
   return boost::apply_visitor(ReferenceSetVisitor(), raSearch);
 }
 
+template<typename SortPolicy>
+bool RAModel<SortPolicy>::Parallel() const
+{
+  return boost::apply_visitor(ParallelVisitor(), raSearch);
+}
+
+template<typename SortPolicy>
+bool& RAModel<SortPolicy>::Parallel()
+{
+  return boost::apply_visitor(ParallelVisitor(), raSearch);
+}
+
 template<typename SortPolicy>
 bool RAModel<SortPolicy>::Naive() const
 {
@@ -329,6 +329,19 @@ class RASearch
   //! Modify whether or not single-tree search is used.
   bool& SingleMode() { return singleMode; }
 
+  /**
+   * Get whether searches with a query set (or with the reference set as the
+   * query set) are run in parallel.  The query points are then split into a
+   * few blocks per thread, and each block is searched (with a tree built on
+   * its points in dual-tree mode) against the shared reference tree.  Each
+   * block samples with the random number generator of its thread, seeded from
+   * the generator of the calling thread, so the results only depend on the
+   * random seed.  Searches with a query tree are not parallelized.
+   */
+  bool Parallel() const { return parallel; }
+  //! Modify whether or not searches are run in parallel.
+  bool& Parallel() { return parallel; }
+
   //! Get the rank-approximation in percentile of the data.
   double Tau() const { return tau; }
   //! Modify the rank-approximation in percentile of the data.
@@ -359,6 +372,17 @@ class RASearch
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Search for the neighbors of the given query set in parallel over blocks of
+   * query points, in the current mode.  If sameSet is true, the query set is
+   * the reference set and each point is removed from its own results.
+   */
+  void ParallelSearch(const MatType& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances,
+                      const bool sameSet);
+
   //! Permutations of reference points during tree building.
   std::vector<size_t> oldFromNewReferences;
   //! Pointer to the root of the reference tree.
@@ -375,6 +399,8 @@ class RASearch
   bool naive;
   //! Indicates if single-tree search is being used (opposed to dual-tree).
   bool singleMode;
+  //! Indicates if searches are run in parallel over blocks of query points.
+  bool parallel;
 
   //! The rank-approximation in percentile of the data (between 0 and 100).
   double tau;
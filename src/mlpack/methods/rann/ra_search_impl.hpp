@@ -17,6 +17,9 @@
 
 #include "ra_search_rules.hpp"
 
+#include <exception>
+#include <memory>
+
 namespace mlpack {
 namespace neighbor {
 
@@ -71,6 +74,7 @@ RASearch(MatType referenceSetIn,
     setOwner(naive),
     naive(naive),
     singleMode(!naive && singleMode), // No single mode if naive.
+    parallel(false),
     tau(tau),
     alpha(alpha),
     sampleAtLeaves(sampleAtLeaves),
@@ -103,6 +107,7 @@ RASearch(Tree* referenceTree,
     setOwner(false),
     naive(false),
     singleMode(singleMode),
+    parallel(false),
     tau(tau),
     alpha(alpha),
     sampleAtLeaves(sampleAtLeaves),
@@ -134,6 +139,7 @@ RASearch(const bool naive,
     setOwner(true),
     naive(naive),
     singleMode(singleMode),
+    parallel(false),
     tau(tau),
     alpha(alpha),
     sampleAtLeaves(sampleAtLeaves),
@@ -259,6 +265,14 @@ Search(const MatType& querySet,
     throw std::invalid_argument(ss.str());
   }
 
+  if (parallel)
+  {
+    Timer::Start("computing_neighbors");
+    ParallelSearch(querySet, k, neighbors, distances, false);
+    Timer::Stop("computing_neighbors");
+    return;
+  }
+
   Timer::Start("computing_neighbors");
 
   // This will hold mappings for query points, if necessary.
@@ -501,6 +515,18 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
     arma::Mat<size_t>& neighbors,
     arma::mat& distances)
 {
+  // Searching the other points for one more neighbor than requested (so that
+  // each point can be removed from its own results) must still leave an
+  // approximate search.
+  if (parallel && k + 1 < (size_t) std::ceil(tau * referenceSet->n_cols /
+      100.0))
+  {
+    Timer::Start("computing_neighbors");
+    ParallelSearch(*referenceSet, k, neighbors, distances, true);
+    Timer::Stop("computing_neighbors");
+    return;
+  }
+
   Timer::Start("computing_neighbors");
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
@@ -581,6 +607,180 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::ParallelSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances,
+    const bool sameSet)
+{
+  typedef RASearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  if (querySet.n_cols == 0)
+    return;
+
+  // The number of blocks doesn't depend on the number of threads, so that the
+  // points sampled for each query don't either; there are enough of them for
+  // the dynamic schedule to balance blocks that are more expensive to search
+  // than others.
+  const size_t numBlocks = std::min((size_t) querySet.n_cols, (size_t) 256);
+  const size_t blockSize = (querySet.n_cols + numBlocks - 1) / numBlocks;
+
+  // When the query set is the reference set, we search for one extra neighbor
+  // and then remove the query point itself from the results.
+  const size_t searchK = sameSet ? k + 1 : k;
+
+  // Naive search samples the same reference points for all the queries (on top
+  // of those sampled for each query), as it does sequentially.
+  arma::uvec distinctSamples;
+  if (naive && !sameSet)
+  {
+    math::ObtainDistinctSamples(0, referenceSet->n_cols,
+        RAUtil::MinimumSamplesReqd(referenceSet->n_cols, k, tau, alpha),
+        distinctSamples);
+  }
+
+  // Each block samples with the generator of its thread, seeded for the block,
+  // so that the results don't depend on the number of threads.  The last seed
+  // reseeds the calling thread once the blocks are done.
+  const std::vector<size_t> seeds = math::RandomSeeds(numBlocks + 1);
+
+  // The reference indices are those of the original reference set, unless we
+  // don't own the tree.
+  const bool mapReferences = !naive && treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset;
+
+  // Exceptions can't leave an OpenMP region, so keep them until the end.
+  std::vector<std::exception_ptr> exceptions(numBlocks);
+  size_t totalDistComputations = 0;
+
+  #pragma omp parallel for schedule(dynamic) reduction(+:totalDistComputations)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    if (begin >= querySet.n_cols)
+      continue;
+    const size_t end = std::min((size_t) querySet.n_cols, begin + blockSize);
+
+    try
+    {
+      math::RandomSeed(seeds[b]);
+
+      // Only dual-tree search needs a tree on the queries of the block.
+      std::vector<size_t> oldFromNewBlock;
+      Tree* blockTree = NULL;
+      MatType blockSet;
+      if (!naive && !singleMode)
+      {
+        blockTree = aux::BuildTree<Tree>(MatType(querySet.cols(begin,
+            end - 1)), oldFromNewBlock);
+      }
+      else
+      {
+        blockSet = querySet.cols(begin, end - 1);
+      }
+      const MatType& blockQueries = blockTree ? blockTree->Dataset() :
+          blockSet;
+
+      // Each thread gets its own copy of the metric, in case it holds state.
+      // The rules log and time their setup, which isn't thread-safe.
+      MetricType blockMetric(metric);
+      std::unique_ptr<RuleType> rules;
+      #pragma omp critical
+      {
+        rules.reset(new RuleType(*referenceSet, blockQueries, searchK,
+            blockMetric, tau, alpha, naive, sampleAtLeaves, firstLeafExact,
+            singleSampleLimit, false));
+      }
+
+      if (naive)
+      {
+        // The monochromatic naive search is exhaustive, as it is sequentially.
+        for (size_t i = 0; i < blockQueries.n_cols; ++i)
+        {
+          if (sameSet)
+          {
+            for (size_t j = 0; j < referenceSet->n_cols; ++j)
+              rules->BaseCase(i, j);
+          }
+          else
+          {
+            for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+              rules->BaseCase(i, (size_t) distinctSamples[j]);
+          }
+        }
+      }
+      else if (singleMode)
+      {
+        if (!referenceTree->IsLeaf())
+        {
+          typename Tree::template SingleTreeTraverser<RuleType> traverser(
+              *rules);
+          for (size_t i = 0; i < blockQueries.n_cols; ++i)
+            traverser.Traverse(i, *referenceTree);
+        }
+      }
+      else
+      {
+        typename Tree::template DualTreeTraverser<RuleType> traverser(*rules);
+        traverser.Traverse(*blockTree, *referenceTree);
+      }
+
+      totalDistComputations += rules->NumDistComputations();
+
+      arma::Mat<size_t> blockNeighbors;
+      arma::mat blockDistances;
+      rules->GetResults(blockNeighbors, blockDistances);
+      delete blockTree;
+
+      // Copy the results into the columns owned by this block.
+      for (size_t i = 0; i < blockNeighbors.n_cols; ++i)
+      {
+        const size_t queryIndex = begin +
+            (oldFromNewBlock.empty() ? i : oldFromNewBlock[i]);
+        const size_t column = (sameSet && mapReferences) ?
+            oldFromNewReferences[queryIndex] : queryIndex;
+
+        size_t j = 0;
+        for (size_t l = 0; l < searchK && j < k; ++l)
+        {
+          // Skip the query point itself (only the first time it is seen).
+          if (sameSet && j == l && blockNeighbors(l, i) == queryIndex)
+            continue;
+
+          const size_t neighbor = blockNeighbors(l, i);
+          neighbors(j, column) = (mapReferences && neighbor != size_t() - 1) ?
+              oldFromNewReferences[neighbor] : neighbor;
+          distances(j, column) = blockDistances(l, i);
+          ++j;
+        }
+      }
+    }
+    catch (...)
+    {
+      exceptions[b] = std::current_exception();
+    }
+  }
+
+  math::RandomSeed(seeds[numBlocks]);
+
+  for (size_t b = 0; b < exceptions.size(); ++b)
+    if (exceptions[b])
+      std::rethrow_exception(exceptions[b]);
+
+  Log::Info << "Parallel search complete." << std::endl;
+  Log::Info << "Average number of distance calculations per query point: "
+      << (totalDistComputations / querySet.n_cols) << "." << std::endl;
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -0,0 +1,72 @@
+/**
+ * @file stratified_sgd.cpp
+ *
+ * Implementation of the StratifiedSGD constructor, which splits the ratings
+ * into blocks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "stratified_sgd.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::svd;
+
+//! Deal n indices to the given number of groups in a random order.
+static arma::Col<size_t> DealGroups(const size_t n, const size_t numGroups)
+{
+  arma::Col<size_t> permutation = arma::linspace<arma::Col<size_t>>(0,
+      n - 1, n);
+  std::shuffle(permutation.begin(), permutation.end(), math::randGen);
+
+  arma::Col<size_t> groups(n);
+  for (size_t i = 0; i < n; ++i)
+    groups[permutation[i]] = i % numGroups;
+
+  return groups;
+}
+
+StratifiedSGD::StratifiedSGD(const arma::mat& data,
+                             const size_t numUsers,
+                             const size_t numItems,
+                             const size_t numBlocks) :
+    numBlocks(numBlocks)
+{
+  if (this->numBlocks == 0)
+  {
+    this->numBlocks = 1;
+    #ifdef HAS_OPENMP
+      this->numBlocks = omp_get_max_threads();
+    #endif
+  }
+
+  // Dealing the users and the items at random keeps the number of ratings of
+  // the blocks about the same, even if the indices are sorted by popularity.
+  const arma::Col<size_t> userGroups = DealGroups(numUsers, this->numBlocks);
+  const arma::Col<size_t> itemGroups = DealGroups(numItems, this->numBlocks);
+
+  // Sort the ratings by block with a counting sort.
+  const size_t totalBlocks = this->numBlocks * this->numBlocks;
+  arma::Col<size_t> blocks(data.n_cols);
+  offsets.zeros(totalBlocks + 1);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    blocks[i] = userGroups[(size_t) data(0, i)] * this->numBlocks +
+        itemGroups[(size_t) data(1, i)];
+    ++offsets[blocks[i] + 1];
+  }
+  offsets = arma::cumsum(offsets);
+
+  arma::Col<size_t> next = offsets.head(totalBlocks);
+  order.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    order[next[blocks[i]]++] = i;
+}
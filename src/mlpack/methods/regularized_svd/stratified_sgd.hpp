@@ -0,0 +1,129 @@
+/**
+ * @file stratified_sgd.hpp
+ *
+ * Definition of the StratifiedSGD class, which runs parallel SGD on a ratings
+ * dataset without locks by splitting the ratings into blocks whose users and
+ * items don't overlap.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_STRATIFIED_SGD_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_STRATIFIED_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * The users and the items of a ratings dataset are each dealt at random to
+ * numBlocks groups, which splits the ratings into numBlocks x numBlocks
+ * blocks.  The blocks (b, (b + s) mod numBlocks) of stratum s share no user
+ * and no item, so the SGD updates of the ratings of the blocks of a stratum
+ * can be run in parallel without locks: the parameter columns of a user or an
+ * item are only ever written by one thread.  An epoch visits each stratum in
+ * turn.  This is the distributed SGD of Gemulla et al., and it is used by the
+ * parallel SGD optimizers of RegularizedSVDFunction, BiasSVDFunction and
+ * SVDPlusPlusFunction.
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title = {Large-scale Matrix Factorization with Distributed Stochastic
+ *       Gradient Descent},
+ *   author = {Gemulla, Rainer and Nijkamp, Erik and Haas, Peter J. and
+ *       Sismanis, Yannis},
+ *   booktitle = {Proceedings of the 17th ACM SIGKDD International Conference
+ *       on Knowledge Discovery and Data Mining},
+ *   pages = {69--77},
+ *   year = {2011}
+ * }
+ * @endcode
+ */
+class StratifiedSGD
+{
+ public:
+  /**
+   * Split the given ratings into blocks.
+   *
+   * @param data Ratings, with one (user, item, rating) column each.
+   * @param numUsers Number of users in the data.
+   * @param numItems Number of items in the data.
+   * @param numBlocks Number of groups of users and of items; 0 means the
+   *     maximum number of threads.
+   */
+  StratifiedSGD(const arma::mat& data,
+                const size_t numUsers,
+                const size_t numItems,
+                const size_t numBlocks = 0);
+
+  /**
+   * Run one epoch: call update(rating, block) for each rating, where block is
+   * the group of its user, and afterStratum() after each stratum.  The ratings
+   * of different blocks are visited in parallel.
+   *
+   * @param update Update of the parameters for one rating.
+   * @param afterStratum Function to call once all the blocks of a stratum are
+   *     done.
+   * @param shuffle If true, the ratings of each block and the strata are
+   *     visited in a random order.
+   */
+  template<typename UpdateType, typename StratumType>
+  void Epoch(const UpdateType& update,
+             const StratumType& afterStratum,
+             const bool shuffle = true);
+
+  /**
+   * Minimize the given function with the settings of the given parallel SGD
+   * optimizer.  At each iteration the objective is computed and an epoch is
+   * run, with update(rating, block, stepSize) for each rating.
+   *
+   * @param optimizer Optimizer to take the settings from.
+   * @param function Function to optimize.
+   * @param iterate Starting point, which is replaced by the final point.
+   * @param update Update of the parameters for one rating.
+   * @param afterStratum Function to call once all the blocks of a stratum are
+   *     done, with the step size.
+   * @return The final objective.
+   */
+  template<typename DecayPolicyType,
+           typename FunctionType,
+           typename UpdateType,
+           typename StratumType>
+  static double Optimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                         FunctionType& function,
+                         arma::mat& iterate,
+                         const UpdateType& update,
+                         const StratumType& afterStratum);
+
+  //! Get the number of groups of users and of items.
+  size_t NumBlocks() const { return numBlocks; }
+
+  //! Get the indices of the ratings, sorted by block.
+  const arma::Col<size_t>& Order() const { return order; }
+
+  //! Get the first position in Order() of each block, and the end.
+  const arma::Col<size_t>& Offsets() const { return offsets; }
+
+ private:
+  //! The number of groups of users and of items.
+  size_t numBlocks;
+
+  //! The indices of the ratings, sorted by block.
+  arma::Col<size_t> order;
+
+  //! The first position in the order of each block (userGroup * numBlocks +
+  //! itemGroup), and the end.
+  arma::Col<size_t> offsets;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+// Include implementation.
+#include "stratified_sgd_impl.hpp"
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file stratified_sgd_impl.hpp
+ *
+ * Implementation of the epochs and the optimization loop of StratifiedSGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_STRATIFIED_SGD_IMPL_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_STRATIFIED_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "stratified_sgd.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace svd {
+
+template<typename UpdateType, typename StratumType>
+void StratifiedSGD::Epoch(const UpdateType& update,
+                          const StratumType& afterStratum,
+                          const bool shuffle)
+{
+  arma::Col<size_t> strata = arma::linspace<arma::Col<size_t>>(0,
+      numBlocks - 1, numBlocks);
+
+  if (shuffle)
+  {
+    for (size_t b = 0; b < numBlocks * numBlocks; ++b)
+    {
+      std::shuffle(order.begin() + offsets[b], order.begin() + offsets[b + 1],
+          math::randGen);
+    }
+    std::shuffle(strata.begin(), strata.end(), math::randGen);
+  }
+
+  for (size_t s = 0; s < numBlocks; ++s)
+  {
+    // The blocks of a stratum share no user and no item, so the updates need
+    // no locks.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t block = b * numBlocks + (b + strata[s]) % numBlocks;
+      for (size_t k = offsets[block]; k < offsets[block + 1]; ++k)
+        update(order[k], (size_t) b);
+    }
+
+    afterStratum();
+  }
+}
+
+template<typename DecayPolicyType,
+         typename FunctionType,
+         typename UpdateType,
+         typename StratumType>
+double StratifiedSGD::Optimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                               FunctionType& function,
+                               arma::mat& iterate,
+                               const UpdateType& update,
+                               const StratumType& afterStratum)
+{
+  double overallObjective = DBL_MAX;
+  double lastObjective;
+
+  StratifiedSGD strata(function.Dataset(), function.NumUsers(),
+      function.NumItems());
+
+  // Iterate till the objective is within tolerance or the maximum number of
+  // allowed iterations is reached. If maxIterations is 0, this will iterate
+  // till convergence.
+  for (size_t i = 1; i != optimizer.MaxIterations(); ++i)
+  {
+    // Calculate the overall objective.
+    lastObjective = overallObjective;
+    overallObjective = 0;
+
+    #pragma omp parallel for reduction(+:overallObjective)
+    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
+    {
+      overallObjective += function.Evaluate(iterate, j);
+    }
+
+    // Output current objective function.
+    Log::Info << "Parallel SGD: iteration " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Parallel SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < optimizer.Tolerance())
+    {
+      Log::Info << "SGD: minimized within tolerance " << optimizer.Tolerance()
+          << "; terminating optimization." << std::endl;
+      return overallObjective;
+    }
+
+    // Get the stepsize for this iteration
+    const double stepSize = optimizer.DecayPolicy().StepSize(i);
+
+    strata.Epoch(
+        [&](const size_t rating, const size_t block)
+        {
+          update(rating, block, stepSize);
+        },
+        [&]()
+        {
+          afterStratum(stepSize);
+        }, optimizer.Shuffle());
+  }
+
+  Log::Info << "\n Parallel SGD terminated with objective : "
+      << overallObjective << std::endl;
+
+  return overallObjective;
+}
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/parallel.hpp>
 #include "worker/one_step_q_learning_worker.hpp"
 #include "worker/one_step_sarsa_worker.hpp"
 #include "worker/n_step_q_learning_worker.hpp"
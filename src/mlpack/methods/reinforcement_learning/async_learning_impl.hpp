@@ -14,7 +14,11 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <atomic>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 namespace mlpack {
 namespace rl {
@@ -71,7 +75,7 @@ void AsyncLearning<
   NetworkType targetNetwork = learningNetwork;
   size_t totalSteps = 0;
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -80,52 +84,33 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
-  /**
-   * Compute the number of threads for the for-loop. In general, we should use
-   * OpenMP task rather than for-loop, here we do so to be compatible with some
-   * compiler. We can switch to OpenMP task once MSVC supports OpenMP 3.0.
-   */
-  size_t numThreads = 0;
-  #pragma omp parallel reduction(+:numThreads)
-  numThreads++;
+  // The threads run until worker 0 stops them, so they must all run at the
+  // same time.  Inside of another parallel region the loop would become tasks,
+  // which may run one after another, so then all the workers run on this
+  // thread.
+  size_t numThreads = Threads();
+  #ifdef HAS_OPENMP
+  if (omp_in_parallel())
+    numThreads = 1;
+  #endif
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
-  for (omp_size_t i = 0; i < numThreads; ++i)
+  // Instead of a shared task queue, thread i owns the workers i,
+  // i + numThreads, i + 2 * numThreads, ... and runs them in turn, so no
+  // worker is ever run by two threads and the threads never wait on each
+  // other.  The workers update the shared networks without locking.
+  const size_t numWorkers = workers.size();
+  ParallelFor(0, std::min(numThreads, numWorkers), [&](const size_t i)
   {
     #pragma omp critical
     {
-      #ifdef HAS_OPENMP
-        Log::Debug << "Thread " << omp_get_thread_num() <<
-            " started." << std::endl;
-      #endif
+      Log::Debug << "Thread " << i << " started." << std::endl;
     }
-    size_t task = std::numeric_limits<size_t>::max();
+
+    size_t task = i;
     while (!stop)
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
-      {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
-
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
-
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
@@ -134,8 +119,13 @@ void AsyncLearning<
       {
         stop = measure(episodeReturn);
       }
+
+      // Move to the next worker of this thread.
+      task += numThreads;
+      if (task >= numWorkers)
+        task = i;
     }
-  }
+  }, 1, numThreads);
 
   // Write back the learning network.
   this->learningNetwork = std::move(learningNetwork);
@@ -14,8 +14,11 @@
 #define MLPACK_METHODS_RL_Q_LEARNING_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mutex>
 
 #include "replay/random_replay.hpp"
+#include "replay/ring_replay.hpp"
+#include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -95,6 +98,42 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Execute an episode in each of the given number of copies of the
+   * environment, in lockstep.  At each step, the action values of the states
+   * of all the copies that haven't reached a terminal state are computed with
+   * a single forward pass of the network, the transitions of all the copies
+   * are stored for replay, and the network is trained once.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @return Return of the episode of each copy of the environment.
+   */
+  arma::vec VectorizedEpisode(const size_t numEnvironments);
+
+  /**
+   * Train the agent with the given number of actor threads and one learner
+   * thread, which run at the same time.  Each actor steps its own copy of the
+   * environment with its own copy of the policy and a snapshot of the learning
+   * network, and stores the transitions in the shared replay memory; the
+   * learner samples from the replay memory and trains the learning network,
+   * whose parameters are copied to the snapshot every snapshotInterval
+   * updates.  The target network is synchronized every
+   * TargetNetworkSyncInterval() updates of the learner.
+   *
+   * If there are fewer threads than actors and learner, each thread runs
+   * several of them in turn.
+   *
+   * @param numActors Number of actors.
+   * @param steps Number of steps of the environments to take in total.
+   * @param snapshotInterval Number of updates of the learner between two
+   *     snapshots of the learning network.
+   * @return Return of each episode the actors finished, in the order they
+   *     were finished.
+   */
+  arma::vec TrainActorLearner(const size_t numActors,
+                              const size_t steps,
+                              const size_t snapshotInterval = 100);
+
   /**
    * @return Total steps from beginning.
    */
@@ -113,6 +152,15 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Sample from the replay memory and train the learning network on the
+   * sampled transitions.
+   *
+   * @param replayMutex If given, the mutex that is held while the replay
+   *     memory is used.
+   */
+  void TrainAgent(std::mutex* replayMutex = NULL);
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -131,6 +179,21 @@ class QLearning
   //! Locally-stored experience method.
   ReplayType replayMethod;
 
+  //! Buffer for the encoded states of the last sample.
+  arma::mat sampledStates;
+
+  //! Buffer for the actions of the last sample.
+  arma::icolvec sampledActions;
+
+  //! Buffer for the rewards of the last sample.
+  arma::colvec sampledRewards;
+
+  //! Buffer for the encoded next states of the last sample.
+  arma::mat sampledNextStates;
+
+  //! Buffer for the termination information of the last sample.
+  arma::icolvec isTerminal;
+
   //! Locally-stored reinforcement learning task.
   EnvironmentType environment;
 
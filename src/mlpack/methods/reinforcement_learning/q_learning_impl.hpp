@@ -14,6 +14,15 @@
 
 #include "q_learning.hpp"
 
+#include <mlpack/core/math/random.hpp>
+
+#include <atomic>
+#include <thread>
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 namespace rl {
 
@@ -113,16 +122,37 @@ double QLearning<
   if (deterministic || totalSteps < config.ExplorationSteps())
     return reward;
 
+  TrainAgent();
+
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent(std::mutex* replayMutex)
+{
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  arma::icolvec sampledActions;
-  arma::colvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::icolvec isTerminal;
+  // Sample from previous experience; the sample buffers are kept between
+  // calls so that their memory is reused.
+  std::unique_lock<std::mutex> lock;
+  if (replayMutex)
+    lock = std::unique_lock<std::mutex>(*replayMutex);
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
+  if (replayMutex)
+    lock.unlock();
 
   // Compute action value for next state with target network.
   arma::mat nextActionValues;
@@ -149,21 +179,28 @@ double QLearning<
    * discounted reward. At terminal state, the agent wont perform any
    * action.
    */
+  arma::colvec tdErrors(sampledNextStates.n_cols);
   for (size_t i = 0; i < sampledNextStates.n_cols; ++i)
   {
-    if (isTerminal[i])
-      target(sampledActions[i], i) = sampledRewards[i];
-    else
-      target(sampledActions[i], i) = sampledRewards[i] + config.Discount() *
-          nextActionValues(bestActions[i], i);
+    double newValue = sampledRewards[i];
+    if (!isTerminal[i])
+      newValue += config.Discount() * nextActionValues(bestActions[i], i);
+
+    tdErrors[i] = newValue - target(sampledActions[i], i);
+    target(sampledActions[i], i) = newValue;
   }
 
+  // Let the replay method use the errors (e.g. to update priorities).
+  if (replayMutex)
+    lock.lock();
+  replayMethod.Update(target, sampledActions, tdErrors);
+  if (replayMutex)
+    lock.unlock();
+
   // Learn form experience.
   arma::mat gradients;
   learningNetwork.Backward(target, gradients);
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
-
-  return reward;
 }
 
 template <
@@ -215,6 +252,265 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::vec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::VectorizedEpisode(const size_t numEnvironments)
+{
+  // Each copy of the environment has its own state, and is active until it
+  // reaches a terminal state or the step limit.
+  std::vector<EnvironmentType> environments(numEnvironments, environment);
+  std::vector<StateType> states(numEnvironments);
+  std::vector<size_t> active(numEnvironments);
+  for (size_t i = 0; i < numEnvironments; ++i)
+  {
+    states[i] = environments[i].InitialSample();
+    active[i] = i;
+  }
+
+  arma::vec totalReturns(numEnvironments, arma::fill::zeros);
+  size_t steps = 0;
+
+  // These are reused at each step.
+  arma::mat encodedStates;
+  arma::mat actionValues;
+  StateType nextState;
+
+  while (true)
+  {
+    // Drop the environments that are finished.
+    size_t numActive = 0;
+    for (size_t i = 0; i < active.size(); ++i)
+      if (!environments[active[i]].IsTerminal(states[active[i]]))
+        active[numActive++] = active[i];
+    active.resize(numActive);
+
+    if (active.empty() || (config.StepLimit() && steps >= config.StepLimit()))
+      break;
+
+    // Get the action values of all the active states with one forward pass.
+    encodedStates.set_size(StateType::dimension, active.size());
+    for (size_t i = 0; i < active.size(); ++i)
+      encodedStates.col(i) = states[active[i]].Encode();
+    learningNetwork.Predict(encodedStates, actionValues);
+
+    // Select the actions, advance each environment, and store the transitions
+    // for replay.
+    for (size_t i = 0; i < active.size(); ++i)
+    {
+      const size_t e = active[i];
+      const ActionType action = policy.Sample(actionValues.col(i),
+          deterministic);
+
+      const double reward = environments[e].Sample(states[e], action,
+          nextState);
+      replayMethod.Store(states[e], action, reward, nextState,
+          environments[e].IsTerminal(nextState));
+
+      totalReturns[e] += reward;
+      states[e] = nextState;
+    }
+    steps++;
+
+    if (deterministic)
+      continue;
+
+    // Learn once for each step of all the environments.
+    if (totalSteps >= config.ExplorationSteps())
+      TrainAgent();
+
+    for (size_t i = 0; i < active.size(); ++i)
+    {
+      totalSteps++;
+
+      // Update target network
+      if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+        targetNetwork = learningNetwork;
+
+      if (totalSteps > config.ExplorationSteps())
+        policy.Anneal();
+    }
+  }
+
+  return totalReturns;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::vec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainActorLearner(const size_t numActors,
+                     const size_t steps,
+                     const size_t snapshotInterval)
+{
+  if (numActors == 0)
+  {
+    throw std::invalid_argument("QLearning::TrainActorLearner(): the number "
+        "of actors must be positive!");
+  }
+
+  if (snapshotInterval == 0)
+  {
+    throw std::invalid_argument("QLearning::TrainActorLearner(): the snapshot "
+        "interval must be positive!");
+  }
+
+  // Each actor has its own copy of the environment, the policy and the
+  // network.
+  std::vector<EnvironmentType> environments(numActors, environment);
+  std::vector<BehaviorPolicyType> policies(numActors, policy);
+  std::vector<NetworkType> actorNetworks(numActors, learningNetwork);
+  std::vector<StateType> states(numActors);
+  std::vector<size_t> actorVersions(numActors, 0);
+  std::vector<size_t> episodeSteps(numActors, 0);
+  std::vector<double> episodeReturns(numActors, 0.0);
+  for (size_t i = 0; i < numActors; ++i)
+    states[i] = environments[i].InitialSample();
+
+  // The parameters of the learning network the actors use, and the number of
+  // times they were replaced.
+  arma::mat snapshot = learningNetwork.Parameters();
+  std::atomic<size_t> snapshotVersion(0);
+  std::mutex snapshotMutex;
+
+  // The actors reserve each step before they take it, so that no more than
+  // the given number of steps is taken, and count it once it's stored.
+  std::atomic<size_t> reservedSteps(0);
+  std::atomic<size_t> storedSteps(0);
+  std::mutex replayMutex;
+
+  std::vector<double> returns;
+  std::mutex returnsMutex;
+  size_t updates = 0;
+
+  // As in AsyncLearning, thread i runs the roles i, i + numThreads, ... in
+  // turn; role 0 is the learner and the others are the actors.  Each thread
+  // draws from its own random stream.
+  const size_t numRoles = numActors + 1;
+  std::vector<math::RandomEngine> streams = math::RandomStreams(numRoles);
+  const math::RandomEngine engine = math::randGen;
+
+  #pragma omp parallel num_threads(numRoles)
+  {
+    size_t threadId = 0;
+    size_t numThreads = 1;
+    #ifdef HAS_OPENMP
+      threadId = omp_get_thread_num();
+      numThreads = omp_get_num_threads();
+    #endif
+
+    math::randGen = streams[threadId];
+    math::randNormalDist.reset();
+
+    arma::colvec actionValue;
+    StateType nextState;
+    while (reservedSteps < steps)
+    {
+      bool idle = true;
+      for (size_t role = threadId; role < numRoles; role += numThreads)
+      {
+        if (role == 0)
+        {
+          // The learner waits until the exploration steps are taken.
+          const size_t stored = storedSteps;
+          if (stored == 0 || stored < config.ExplorationSteps())
+            continue;
+
+          TrainAgent(&replayMutex);
+          idle = false;
+          ++updates;
+
+          if (updates % config.TargetNetworkSyncInterval() == 0)
+            targetNetwork = learningNetwork;
+
+          if (updates % snapshotInterval == 0)
+          {
+            std::lock_guard<std::mutex> lock(snapshotMutex);
+            snapshot = learningNetwork.Parameters();
+            ++snapshotVersion;
+          }
+
+          continue;
+        }
+
+        const size_t a = role - 1;
+        if (reservedSteps++ >= steps)
+          break;
+        idle = false;
+
+        // Refresh the network of the actor if there is a newer snapshot.
+        if (actorVersions[a] != snapshotVersion)
+        {
+          std::lock_guard<std::mutex> lock(snapshotMutex);
+          actorNetworks[a].Parameters() = snapshot;
+          actorVersions[a] = snapshotVersion;
+        }
+
+        actorNetworks[a].Predict(states[a].Encode(), actionValue);
+        const ActionType action = policies[a].Sample(actionValue);
+        const double reward = environments[a].Sample(states[a], action,
+            nextState);
+        const bool isEnd = environments[a].IsTerminal(nextState);
+
+        {
+          std::lock_guard<std::mutex> lock(replayMutex);
+          replayMethod.Store(states[a], action, reward, nextState, isEnd);
+        }
+
+        if (++storedSteps > config.ExplorationSteps())
+          policies[a].Anneal();
+
+        episodeReturns[a] += reward;
+        ++episodeSteps[a];
+        if (isEnd || (config.StepLimit() &&
+            episodeSteps[a] >= config.StepLimit()))
+        {
+          {
+            std::lock_guard<std::mutex> lock(returnsMutex);
+            returns.push_back(episodeReturns[a]);
+          }
+
+          states[a] = environments[a].InitialSample();
+          episodeReturns[a] = 0.0;
+          episodeSteps[a] = 0;
+        }
+        else
+        {
+          states[a] = nextState;
+        }
+      }
+
+      // The learner has nothing to do until the actors have explored.
+      if (idle)
+        std::this_thread::yield();
+    }
+  }
+
+  math::randGen = engine;
+  totalSteps += storedSteps;
+
+  return arma::vec(returns);
+}
+
 } // namespace rl
 } // namespace mlpack
 
@@ -0,0 +1,275 @@
+/**
+ * @file prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+#include "sum_tree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay.
+ *
+ * Like RandomReplay, the interactions between the agent and the environment
+ * are saved to a First-In-First-Out buffer.  But instead of sampling the
+ * experiences uniformly, each experience i is sampled with probability
+ * p_i^alpha / sum_k p_k^alpha, where the priority p_i is the magnitude of the
+ * last temporal-difference error of the experience; new experiences get the
+ * largest priority seen so far, so that they are replayed at least once.  The
+ * priorities are kept in a SumTree, so sampling and updating a priority take
+ * O(log n) time.
+ *
+ * Because the experiences are not sampled uniformly, the updates are biased;
+ * this is corrected with the importance-sampling weights
+ * (n P(i))^-beta / max_j (n P(j))^-beta of the sampled batch, which are applied
+ * by Update().
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{schaul2015prioritized,
+ *  title   = {Prioritized Experience Replay},
+ *  author  = {Schaul, Tom and Quan, John and Antonoglou, Ioannis and
+ *             Silver, David},
+ *  journal = {arXiv preprint arXiv:1511.05952},
+ *  year    = {2015}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class PrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much the priorities are used (0 is uniform sampling).
+   * @param beta Amount of importance-sampling correction (1 is a full
+   *        correction).
+   * @param dimension The dimension of an encoded state.
+   */
+  PrioritizedReplay(const size_t batchSize,
+                    const size_t capacity,
+                    const double alpha = 0.6,
+                    const double beta = 0.4,
+                    const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      alpha(alpha),
+      beta(beta),
+      position(0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      full(false),
+      priorities(capacity),
+      maxPriority(1.0),
+      sampledIndices(batchSize),
+      weights(batchSize)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience, with the largest priority seen so far.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    priorities.Set(position, std::pow(maxPriority, alpha));
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  /**
+   * Sample some experiences in proportion to their priority.  The batch is
+   * stratified: the total priority is split into batchSize equal ranges, and
+   * one experience is sampled from each.  The output matrices are only
+   * reallocated if they don't have the right size already.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    sampledStates.set_size(states.n_rows, batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    sampledNextStates.set_size(nextStates.n_rows, batchSize);
+    isTerminal.set_size(batchSize);
+
+    const double total = priorities.Sum();
+    const double segment = total / batchSize;
+    const double n = (double) Size();
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const size_t index = priorities.FindPrefixSum(
+          (i + math::Random()) * segment);
+      sampledIndices[i] = index;
+
+      // The weights are normalized by the largest weight of the batch below.
+      weights[i] = std::pow(n * priorities.Get(index) / total, -beta);
+
+      sampledStates.col(i) = states.col(index);
+      sampledActions[i] = actions[index];
+      sampledRewards[i] = rewards[index];
+      sampledNextStates.col(i) = nextStates.col(index);
+      isTerminal[i] = this->isTerminal[index];
+    }
+
+    weights /= weights.max();
+  }
+
+  /**
+   * Update the priorities of the last sampled experiences with the given
+   * temporal-difference errors, and apply the importance-sampling weights to
+   * the targets: the target of the sampled action of each experience is moved
+   * towards the prediction so that its error is scaled by the weight of the
+   * experience.  With a squared error loss this scales the gradient of each
+   * experience by its weight.
+   *
+   * @param target The targets of the learning network for the last sample.
+   * @param sampledActions The actions of the last sample.
+   * @param tdErrors The temporal-difference error (target minus prediction)
+   *        of the sampled action of each experience.
+   */
+  void Update(arma::mat& target,
+              const arma::icolvec& sampledActions,
+              const arma::colvec& tdErrors)
+  {
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const double priority = std::abs(tdErrors[i]) + epsilon;
+      priorities.Set(sampledIndices[i], std::pow(priority, alpha));
+      maxPriority = std::max(maxPriority, priority);
+
+      target(sampledActions[i], i) -= (1.0 - weights[i]) * tdErrors[i];
+    }
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  size_t Size() const
+  {
+    return full ? capacity : position;
+  }
+
+  //! Get how much the priorities are used.
+  double Alpha() const { return alpha; }
+
+  //! Get the amount of importance-sampling correction.
+  double Beta() const { return beta; }
+  //! Modify the amount of importance-sampling correction (typically it is
+  //! annealed to 1 during training).
+  double& Beta() { return beta; }
+
+  //! Get the importance-sampling weights of the last sample.
+  const arma::vec& Weights() const { return weights; }
+
+  //! Get the indices of the experiences of the last sample.
+  const arma::Col<size_t>& SampledIndices() const { return sampledIndices; }
+
+ private:
+  //! The smallest priority, so that every experience can be sampled again.
+  static constexpr double epsilon = 1e-6;
+
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! How much the priorities are used.
+  double alpha;
+
+  //! The amount of importance-sampling correction.
+  double beta;
+
+  //! Indicate the position to store new transition.
+  size_t position;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+
+  //! The priority of each experience, to the power alpha.
+  SumTree<double> priorities;
+
+  //! The largest priority seen so far.
+  double maxPriority;
+
+  //! The indices of the experiences of the last sample.
+  arma::Col<size_t> sampledIndices;
+
+  //! The importance-sampling weights of the last sample.
+  arma::vec weights;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
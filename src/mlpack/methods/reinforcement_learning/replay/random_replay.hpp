@@ -125,6 +125,20 @@ class RandomReplay
     isTerminal = this->isTerminal.elem(sampledIndices);
   }
 
+  /**
+   * Update the last sampled experiences with their temporal-difference errors.
+   * Random replay doesn't use them, so this does nothing.
+   *
+   * @param target The targets of the learning network for the last sample.
+   * @param sampledActions The actions of the last sample.
+   * @param tdErrors The temporal-difference error of the sampled action of each
+   *        experience.
+   */
+  void Update(arma::mat& /* target */,
+              const arma::icolvec& /* sampledActions */,
+              const arma::colvec& /* tdErrors */)
+  { /* Nothing to do here. */ }
+
   /**
    * Get the number of transitions in the memory.
    *
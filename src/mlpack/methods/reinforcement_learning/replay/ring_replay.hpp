@@ -0,0 +1,334 @@
+/**
+ * @file ring_replay.hpp
+ *
+ * This file is an implementation of random experience replay which stores each
+ * state only once in a ring buffer of frames.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_RING_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_RING_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/random.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of random experience replay with compact storage.
+ *
+ * RandomReplay keeps both the state and the next state of each transition, but
+ * during an episode the next state of a transition is the state of the
+ * following one, so every state is held twice.  This replay instead keeps the
+ * encoded states in a ring buffer of frames, and each transition only holds the
+ * indices of the frames of its state and of its next state; when the state
+ * given to Store() is the next state of the previous transition, its frame is
+ * reused.
+ *
+ * For image environments, the encoded state is often a stack of the last few
+ * frames, with the oldest frame first.  If a stack size is given, only the
+ * newest frame of each state is stored, together with a link to the frame
+ * before it, and the stacks are put back together when the transitions are
+ * sampled.  The memory then holds about one frame per transition instead of
+ * twice the stack size.
+ *
+ * The samples are gathered into the given matrices without temporaries, so if
+ * the same matrices are passed to each call of Sample(), their memory is
+ * reused.
+ *
+ * When the transitions of several environments are stored in turn the frames
+ * can't be shared, and the oldest transitions are dropped when their frames
+ * are overwritten; the memory then holds about half as many transitions.
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class RingReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of the ring replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param dimension The dimension of an encoded state.
+   * @param stackSize Number of frames stacked in an encoded state; the
+   *     dimension must be a multiple of it.
+   */
+  RingReplay(const size_t batchSize,
+             const size_t capacity,
+             const size_t dimension = StateType::dimension,
+             const size_t stackSize = 1) :
+      batchSize(batchSize),
+      capacity(capacity),
+      dimension(dimension),
+      stackSize(stackSize),
+      frameDimension((stackSize == 0) ? 0 : dimension / stackSize),
+      frameCapacity(capacity + 2 * stackSize),
+      frames(frameDimension, frameCapacity),
+      previous(frameCapacity),
+      frameCount(0),
+      stateFrames(capacity),
+      nextFrames(capacity),
+      firstFrames(capacity),
+      actions(capacity),
+      rewards(capacity),
+      isTerminal(capacity),
+      stored(0),
+      oldest(0),
+      stack(dimension)
+  {
+    if (capacity == 0)
+    {
+      throw std::invalid_argument("RingReplay::RingReplay(): the capacity must "
+          "be positive!");
+    }
+
+    if (stackSize == 0 || dimension % stackSize != 0)
+    {
+      std::ostringstream oss;
+      oss << "RingReplay::RingReplay(): the dimension of a state (" << dimension
+          << ") must be a positive multiple of the stack size (" << stackSize
+          << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  /**
+   * Store the given experience.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    const arma::colvec& encoded = state.Encode();
+    const arma::colvec& nextEncoded = nextState.Encode();
+
+    // Reuse the frame of the last next state if it holds the same state.
+    size_t first;
+    const size_t stateFrame = (stored > 0 &&
+        Chain(nextFrames[(stored - 1) % capacity], first) &&
+        Matches(nextFrames[(stored - 1) % capacity], encoded)) ?
+        nextFrames[(stored - 1) % capacity] : PushStack(encoded);
+
+    // If the next state is the state shifted by one frame, only its newest
+    // frame is new.
+    const size_t nextFrame = std::equal(encoded.memptr() + frameDimension,
+        encoded.memptr() + dimension, nextEncoded.memptr()) ?
+        PushFrame(nextEncoded.memptr() + dimension - frameDimension,
+        stateFrame) : PushStack(nextEncoded);
+
+    const size_t position = stored % capacity;
+    Chain(stateFrame, first);
+    stateFrames[position] = stateFrame;
+    nextFrames[position] = nextFrame;
+    firstFrames[position] = first;
+    actions(position) = action;
+    rewards(position) = reward;
+    isTerminal(position) = isEnd;
+    ++stored;
+
+    // Drop the transitions that were overwritten, or whose frames were.
+    if (stored - oldest > capacity)
+      oldest = stored - capacity;
+    while (firstFrames[oldest % capacity] + frameCapacity < frameCount)
+      ++oldest;
+  }
+
+  /**
+   * Sample some experiences.  The output matrices are only resized if they
+   * don't have the right size already.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    const size_t size = Size();
+    sampledStates.set_size(dimension, batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    sampledNextStates.set_size(dimension, batchSize);
+    isTerminal.set_size(batchSize);
+
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      const size_t position = (oldest + math::RandInt((int) size)) % capacity;
+      Reconstruct(stateFrames[position], sampledStates.colptr(i));
+      Reconstruct(nextFrames[position], sampledNextStates.colptr(i));
+      sampledActions(i) = actions(position);
+      sampledRewards(i) = rewards(position);
+      isTerminal(i) = this->isTerminal(position);
+    }
+  }
+
+  /**
+   * Update the last sampled experiences with their temporal-difference errors.
+   * Ring replay doesn't use them, so this does nothing.
+   *
+   * @param target The targets of the learning network for the last sample.
+   * @param sampledActions The actions of the last sample.
+   * @param tdErrors The temporal-difference error of the sampled action of each
+   *        experience.
+   */
+  void Update(arma::mat& /* target */,
+              const arma::icolvec& /* sampledActions */,
+              const arma::colvec& /* tdErrors */)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  size_t Size() const { return stored - oldest; }
+
+  //! Get the number of frames held in the memory.
+  size_t Frames() const { return std::min(frameCount, frameCapacity); }
+
+ private:
+  /**
+   * Store a frame with a link to the frame before it, and return its index;
+   * a frame which links to itself starts a stack.
+   */
+  size_t PushFrame(const double* frame, const size_t previousFrame)
+  {
+    const size_t index = frameCount++;
+    std::copy(frame, frame + frameDimension,
+        frames.colptr(index % frameCapacity));
+    previous[index % frameCapacity] = previousFrame;
+    return index;
+  }
+
+  //! Store all the frames of an encoded state, and return its newest frame.
+  size_t PushStack(const arma::colvec& encoded)
+  {
+    size_t index = PushFrame(encoded.memptr(), frameCount);
+    for (size_t s = 1; s < stackSize; ++s)
+      index = PushFrame(encoded.memptr() + s * frameDimension, index);
+
+    return index;
+  }
+
+  /**
+   * Find the oldest frame of the stack that ends with the given frame, and
+   * return whether all the frames of that stack are still held.
+   */
+  bool Chain(const size_t frame, size_t& first) const
+  {
+    first = frame;
+    for (size_t s = 1; s < stackSize; ++s)
+    {
+      if (first + frameCapacity < frameCount)
+        return false;
+      first = previous[first % frameCapacity];
+    }
+
+    return first + frameCapacity >= frameCount;
+  }
+
+  //! Write the stack that ends with the given frame to the given memory.
+  void Reconstruct(size_t frame, double* out) const
+  {
+    for (size_t s = stackSize; s > 0; --s)
+    {
+      const double* source = frames.colptr(frame % frameCapacity);
+      std::copy(source, source + frameDimension, out + (s - 1) *
+          frameDimension);
+      frame = previous[frame % frameCapacity];
+    }
+  }
+
+  //! Check whether the stack that ends with the given frame is the state.
+  bool Matches(const size_t frame, const arma::colvec& encoded)
+  {
+    Reconstruct(frame, stack.memptr());
+    return std::equal(stack.memptr(), stack.memptr() + dimension,
+        encoded.memptr());
+  }
+
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Locally-stored dimension of an encoded state.
+  size_t dimension;
+
+  //! Locally-stored number of frames in an encoded state.
+  size_t stackSize;
+
+  //! Locally-stored dimension of a frame.
+  size_t frameDimension;
+
+  //! Locally-stored number of frames the memory holds.
+  size_t frameCapacity;
+
+  //! The ring buffer of frames.
+  arma::mat frames;
+
+  //! The index of the frame before each frame in its stack.
+  std::vector<size_t> previous;
+
+  //! The number of frames stored so far.
+  size_t frameCount;
+
+  //! The index of the newest frame of the state of each transition.
+  std::vector<size_t> stateFrames;
+
+  //! The index of the newest frame of the next state of each transition.
+  std::vector<size_t> nextFrames;
+
+  //! The index of the oldest frame each transition needs.
+  std::vector<size_t> firstFrames;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! The number of transitions stored so far.
+  size_t stored;
+
+  //! The index of the oldest transition still held.
+  size_t oldest;
+
+  //! Buffer for an encoded state.
+  arma::colvec stack;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
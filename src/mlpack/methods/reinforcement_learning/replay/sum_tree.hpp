@@ -0,0 +1,121 @@
+/**
+ * @file sum_tree.hpp
+ *
+ * This file is an implementation of a sum tree, used by prioritized experience
+ * replay to sample elements in proportion to their priority.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A sum tree is a complete binary tree whose leaves hold non-negative values
+ * and whose internal nodes hold the sum of the values of their children.  The
+ * tree is stored implicitly in an array: the root is at index 1, the children
+ * of node i are at 2i and 2i + 1, and the leaves are at the end.  Setting a
+ * value and finding the element at which the running sum of the values reaches
+ * a given mass both take O(log n) time.
+ *
+ * @tparam ElemType Type of the values.
+ */
+template<typename ElemType = double>
+class SumTree
+{
+ public:
+  /**
+   * Construct a sum tree with the given number of elements, all set to 0.
+   *
+   * @param capacity Number of elements.
+   */
+  SumTree(const size_t capacity) :
+      capacity(capacity),
+      leaves(1)
+  {
+    // The leaves are a power of two, so every leaf is on the same level.
+    while (leaves < capacity)
+      leaves *= 2;
+
+    tree.zeros(2 * leaves);
+  }
+
+  /**
+   * Set the value of the given element.
+   *
+   * @param index Index of the element.
+   * @param value New (non-negative) value of the element.
+   */
+  void Set(const size_t index, const ElemType value)
+  {
+    size_t node = index + leaves;
+    tree[node] = value;
+    for (node /= 2; node > 0; node /= 2)
+      tree[node] = tree[2 * node] + tree[2 * node + 1];
+  }
+
+  /**
+   * Get the value of the given element.
+   *
+   * @param index Index of the element.
+   */
+  ElemType Get(const size_t index) const { return tree[index + leaves]; }
+
+  //! Get the sum of the values of all the elements.
+  ElemType Sum() const { return tree[1]; }
+
+  /**
+   * Find the first element at which the running sum of the values exceeds the
+   * given mass.  Elements with a value of 0 are never returned, unless all the
+   * values are 0.
+   *
+   * @param mass Mass to search for, in [0, Sum()).
+   * @return Index of the element.
+   */
+  size_t FindPrefixSum(ElemType mass) const
+  {
+    size_t node = 1;
+    while (node < leaves)
+    {
+      // If the mass is past the left child because of rounding errors, but the
+      // right child is empty, the last element of the left child is taken.
+      const size_t left = 2 * node;
+      if (mass < tree[left] || tree[left + 1] == 0)
+      {
+        node = left;
+      }
+      else
+      {
+        mass -= tree[left];
+        node = left + 1;
+      }
+    }
+
+    return std::min(node - leaves, capacity - 1);
+  }
+
+  //! Get the number of elements.
+  size_t Capacity() const { return capacity; }
+
+ private:
+  //! The number of elements.
+  size_t capacity;
+
+  //! The number of leaves (the smallest power of two at least capacity).
+  size_t leaves;
+
+  //! The nodes of the tree; index 0 is unused.
+  arma::Col<ElemType> tree;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -68,8 +68,9 @@ class OneStepQLearningWorker
   {
     updater.Initialize(learningNetwork.Parameters().n_rows,
         learningNetwork.Parameters().n_cols);
-    // Build local network.
+    // Build local network, and local copy of the target network.
     network = learningNetwork;
+    localTargetNetwork = learningNetwork;
   }
 
   /**
@@ -108,7 +109,7 @@ class OneStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
@@ -132,11 +133,7 @@ class OneStepQLearningWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        localTargetNetwork.Predict(std::get<3>(transition).Encode(), actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -165,18 +162,19 @@ class OneStepQLearningWorker
       updater.Update(learningNetwork.Parameters(),
           config.StepSize(), totalGradients);
 
-      // Sync the local network with the global network.
-      network = learningNetwork;
+      // Sync the local networks with the global networks.  Only the
+      // parameters are copied, without locking, in the spirit of Hogwild!: a
+      // copy may mix the parameters of updates from other workers.
+      network.Parameters() = learningNetwork.Parameters();
+      localTargetNetwork.Parameters() = targetNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
-    // Update global target network.
+    // Update global target network.  Only the values of the parameters are
+    // copied, so the other workers can keep reading them.
     if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+      targetNetwork.Parameters() = learningNetwork.Parameters();
 
     policy.Anneal();
 
@@ -229,6 +227,9 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network of the worker.
+  NetworkType localTargetNetwork;
+
   //! Current state of the agent.
   StateType state;
 };
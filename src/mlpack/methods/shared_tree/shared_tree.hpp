@@ -0,0 +1,82 @@
+/**
+ * @file shared_tree.hpp
+ *
+ * Tree types that can be shared by nearest neighbor search, furthest neighbor
+ * search, range search and kernel density estimation, so that the tree (and the
+ * rearranged dataset) is built and stored once for all of them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SHARED_TREE_SHARED_TREE_HPP
+#define MLPACK_METHODS_SHARED_TREE_SHARED_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/multi_statistic.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search_stat.hpp>
+#include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
+#include <mlpack/methods/neighbor_search/sort_policies/furthest_neighbor_sort.hpp>
+#include <mlpack/methods/range_search/range_search_stat.hpp>
+#include <mlpack/methods/kde/kde_stat.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The statistic of the shared trees: each node holds the statistics of nearest
+ * and furthest neighbor search, range search and KDE, and each of the methods
+ * uses its own.
+ */
+typedef MultiStatistic<
+    neighbor::NeighborSearchStat<neighbor::NearestNeighborSort>,
+    neighbor::NeighborSearchStat<neighbor::FurthestNeighborSort>,
+    range::RangeSearchStat,
+    kde::KDEStat> SharedSearchStat;
+
+/**
+ * A kd-tree that can be shared by NeighborSearch (with either sort policy),
+ * RangeSearch and KDE.  The statistic type the methods ask for is ignored; the
+ * nodes always hold a SharedSearchStat, so every method given SharedKDTree as
+ * its tree type uses the same tree type, and one tree can be built and given
+ * to each of them, without copying it:
+ *
+ * @code
+ * typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+ *     SharedKDTree> KNNType;
+ * typedef RangeSearch<EuclideanDistance, arma::mat, SharedKDTree> RSType;
+ * typedef KDE<GaussianKernel, EuclideanDistance, arma::mat, SharedKDTree>
+ *     KDEType;
+ *
+ * // Build the tree once.  This rearranges the dataset.
+ * std::vector<size_t> oldFromNew;
+ * KNNType::Tree tree(std::move(dataset), oldFromNew);
+ *
+ * // None of these copies the tree or takes ownership of it.  The results of
+ * // the neighbor and range searches refer to the rearranged dataset; map them
+ * // back with oldFromNew.
+ * KNNType knn(&tree);
+ * RSType rangeSearch(&tree);
+ * KDEType kde(0.05, 0.0, GaussianKernel(0.5));
+ * kde.Train(&tree, &oldFromNew);
+ * @endcode
+ *
+ * The methods may not search the tree at the same time, since the statistics
+ * of the nodes are modified during the searches.
+ */
+template<typename MetricType, typename StatisticType, typename MatType>
+using SharedKDTree = KDTree<MetricType, SharedSearchStat, MatType>;
+
+/**
+ * A ball tree that can be shared by NeighborSearch (with either sort policy),
+ * RangeSearch and KDE; see SharedKDTree.
+ */
+template<typename MetricType, typename StatisticType, typename MatType>
+using SharedBallTree = BallTree<MetricType, SharedSearchStat, MatType>;
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,21 @@
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function of softmax regression.  The data may be dense or
+ * sparse; with sparse data (arma::sp_mat), the objective and its gradients are
+ * computed in time linear in the number of nonzero elements.
+ *
+ * The objective and gradient are computed on blocks of columns of the data in
+ * parallel.  The logits of each block are computed once, into a probabilities
+ * buffer that is kept between calls, and are normalized with the (numerically
+ * stable) log-sum-exp of each column, so the objective stays finite for large
+ * parameters.  Because of this buffer, the Evaluate() and Gradient() functions
+ * of one object must not be called at the same time from different threads.
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -32,7 +47,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -83,7 +98,9 @@ class SoftmaxRegressionFunction
                             arma::sp_mat& groundTruth);
 
   /**
-   * Evaluate the probabilities matrix with the passed parameters.
+   * Evaluate the probabilities matrix with the passed parameters.  The largest
+   * logit of each point is subtracted before the exponentials are taken, so
+   * that they do not overflow.
    * probabilities(i, j) =
    *     exp(\theta_i * data_j) / sum_k(exp(\theta_k * data_j)).
    * It represents the probability of data_j belongs to class i.
@@ -151,6 +168,32 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the objective function and its gradient at the same time,
+   * computing the logits of the data only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The value of the objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient on a subset of the data at
+   * the same time, computing the logits of the points only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to use.
+   * @return The value of the objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t start,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -185,10 +228,11 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
-  //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
-  //! Label matrix for the provided data.
-  arma::sp_mat groundTruth;
+  //! Training data matrix.  This is an alias (if MatType is dense) until the
+  //! data is shuffled.
+  MatType data;
+  //! Labels of the points of the data.
+  arma::Row<size_t> labels;
   //! Initial parameter point.
   arma::mat initialPoint;
   //! Number of classes.
@@ -197,9 +241,55 @@ class SoftmaxRegressionFunction
   double lambda;
   //! Intercept term flag.
   bool fitIntercept;
+
+  //! The number of points in each of the blocks of columns that are handled in
+  //! parallel.
+  static const size_t BlockSize = 256;
+
+  //! Buffer for the probabilities of the points of each call, kept to avoid
+  //! allocating them again for batches of the same size.
+  mutable arma::mat probabilities;
+  //! Buffer for the objective of each block of columns.
+  mutable arma::vec blockObjectives;
+  //! Buffers for the gradient accumulated by each thread.
+  mutable std::vector<arma::mat> threadGradients;
+
+  /**
+   * Compute the objective function on the given points, and also its gradient
+   * if gradient is not NULL.  The points are split into blocks of BlockSize
+   * points, which are handled in parallel.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param batchSize Number of data points to use.
+   * @param gradient Matrix to store the gradient into, or NULL.
+   * @return The value of the objective function.
+   */
+  double EvaluateColumns(const arma::mat& parameters,
+                         const size_t start,
+                         const size_t batchSize,
+                         arma::mat* gradient) const;
+
+  //! Reorder the columns of the given dense matrix, so that its column i is
+  //! the old column ordering[i] (and the old column i is the new column
+  //! reverseOrdering[i]).
+  template<typename ElemType>
+  static void ReorderColumns(arma::Mat<ElemType>& matrix,
+                             const arma::uvec& ordering,
+                             const arma::uvec& reverseOrdering);
+
+  //! Reorder the columns of the given sparse matrix, in time linear in its
+  //! number of nonzero elements.
+  template<typename ElemType>
+  static void ReorderColumns(arma::SpMat<ElemType>& matrix,
+                             const arma::uvec& ordering,
+                             const arma::uvec& reverseOrdering);
 };
 
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
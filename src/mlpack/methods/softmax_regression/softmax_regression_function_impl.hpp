@@ -0,0 +1,429 @@
+/**
+ * @file softmax_regression_function_impl.hpp
+ * @author Siddharth Agrawal
+ *
+ * Implementation of function to be optimized for softmax regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "softmax_regression_function.hpp"
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/util/parallel.hpp>
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept) :
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
+    labels(labels),
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  // Initialize the parameters to suitable values.
+  initialPoint = InitializeWeights();
+}
+
+/**
+ * Shuffle the data.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Shuffle()
+{
+  // Determine new ordering.
+  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      data.n_cols - 1, data.n_cols));
+
+  // The sparse matrices are assembled with the batch constructor, so we need
+  // the reverse ordering too.
+  arma::uvec reverseOrdering(ordering.n_elem);
+  for (size_t i = 0; i < ordering.n_elem; ++i)
+    reverseOrdering[ordering[i]] = i;
+
+  ReorderColumns(data, ordering, reverseOrdering);
+
+  arma::Row<size_t> newLabels(labels.n_elem);
+  for (size_t i = 0; i < ordering.n_elem; ++i)
+    newLabels[i] = labels[ordering[i]];
+  labels = std::move(newLabels);
+}
+
+template<typename MatType>
+template<typename ElemType>
+void SoftmaxRegressionFunction<MatType>::ReorderColumns(
+    arma::Mat<ElemType>& matrix,
+    const arma::uvec& ordering,
+    const arma::uvec& /* reverseOrdering */)
+{
+  arma::Mat<ElemType> newMatrix = matrix.cols(ordering);
+  math::ClearAlias(matrix);
+  matrix = std::move(newMatrix);
+}
+
+template<typename MatType>
+template<typename ElemType>
+void SoftmaxRegressionFunction<MatType>::ReorderColumns(
+    arma::SpMat<ElemType>& matrix,
+    const arma::uvec& /* ordering */,
+    const arma::uvec& reverseOrdering)
+{
+  arma::umat newLocations(2, matrix.n_nonzero);
+  arma::Col<ElemType> values(matrix.n_nonzero);
+  typename arma::SpMat<ElemType>::const_iterator it = matrix.begin();
+  size_t loc = 0;
+  while (it != matrix.end())
+  {
+    newLocations(0, loc) = it.row();
+    newLocations(1, loc) = reverseOrdering(it.col());
+    values(loc) = (*it);
+
+    ++it;
+    ++loc;
+  }
+
+  matrix = arma::SpMat<ElemType>(newLocations, values, matrix.n_rows,
+      matrix.n_cols);
+}
+
+/**
+ * Initializes parameter weights to random values taken from a scaled standard
+ * normal distribution. The weights cannot be initialized to zero, as that will
+ * lead to each class output being the same.
+ */
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights()
+{
+  return InitializeWeights(data.n_rows, numClasses, fitIntercept);
+}
+
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+    arma::mat parameters;
+    InitializeWeights(parameters, featureSize, numClasses, fitIntercept);
+    return parameters;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    arma::mat &weights,
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+  // Initialize values to 0.005 * r. 'r' is a matrix of random values taken from
+  // a Gaussian distribution with mean zero and variance one.
+  // If the fitIntercept flag is true, parameters.col(0) is the intercept.
+  if (fitIntercept)
+    weights.randn(numClasses, featureSize + 1);
+  else
+    weights.randn(numClasses, featureSize);
+  weights *= 0.005;
+}
+
+/**
+ * This is equivalent to applying the indicator function to the training
+ * labels.  (The Evaluate() and Gradient() methods use the labels directly
+ * instead.)
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetGroundTruthMatrix(
+    const arma::Row<size_t>& labels, arma::sp_mat& groundTruth)
+{
+  // Calculate the ground truth matrix according to the labels passed. The
+  // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
+  // where each column contains a single entry of '1', marking the label
+  // corresponding to that example.
+
+  // Row pointers and column pointers corresponding to the entries.
+  arma::uvec rowPointers(labels.n_elem);
+  arma::uvec colPointers(labels.n_elem + 1);
+
+  // Row pointers are the labels of the examples, and column pointers are the
+  // number of cumulative entries made uptil that column.
+  for (size_t i = 0; i < labels.n_elem; i++)
+  {
+    rowPointers(i) = labels(i);
+    colPointers(i + 1) = i + 1;
+  }
+
+  // All entries are '1'.
+  arma::vec values;
+  values.ones(labels.n_elem);
+
+  // Calculate the matrix.
+  groundTruth = arma::sp_mat(rowPointers, colPointers, values, numClasses,
+                             labels.n_elem);
+}
+
+/**
+ * Evaluate the probabilities matrix. If fitIntercept flag is true,
+ * it should consider the parameters.cols(0) intercept term.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
+    const arma::mat& parameters,
+    arma::mat& probabilities,
+    const size_t start,
+    const size_t batchSize) const
+{
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     hypothesis = parameters * [1; data].
+    //
+    // Since the cost of join may be high due to the copy of original data,
+    // split the hypothesis computation to two components.
+    probabilities = parameters.cols(1, parameters.n_cols - 1) *
+        data.cols(start, start + batchSize - 1);
+    probabilities.each_col() += parameters.col(0);
+  }
+  else
+  {
+    probabilities = parameters * data.cols(start, start + batchSize - 1);
+  }
+
+  // Subtracting the largest logit of each point doesn't change the
+  // probabilities, but keeps the exponentials from overflowing.
+  probabilities.each_row() -= arma::max(probabilities, 0);
+  probabilities = arma::exp(probabilities);
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+}
+
+/**
+ * Evaluates the objective function given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
+{
+  // The objective function is the negative log likelihood of the model
+  // calculated over all the training examples. Mathematically it is as follows:
+  // log likelihood = sum(1{y_i = j} * log(probability(j))) / m
+  // The sum is over all 'i's and 'j's, where 'i' points to a training example
+  // and 'j' points to a particular class. 1{x} is an indicator function whose
+  // value is 1 only when 'x' is satisfied, otherwise it is 0.
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization to control the
+  // parameter weights.
+  return EvaluateColumns(parameters, 0, data.n_cols, NULL);
+}
+
+/**
+ * Evaluate the objective function for the given points given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize) const
+{
+  return EvaluateColumns(parameters, start, batchSize, NULL);
+}
+
+/**
+ * Calculates and stores the gradient values given a set of parameters.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  EvaluateColumns(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  EvaluateColumns(parameters, start, batchSize, &gradient);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return EvaluateColumns(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return EvaluateColumns(parameters, start, batchSize, &gradient);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateColumns(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize,
+    arma::mat* gradient) const
+{
+  // Each block of points is given to one thread, which computes its logits with
+  // one matrix product into its columns of the probabilities buffer, and then
+  // works on them in place.  A single block is handled by the calling thread.
+  const size_t numBlocks = (batchSize + BlockSize - 1) / BlockSize;
+  const size_t threads = (numBlocks > 1) ? 0 : 1;
+
+  probabilities.set_size(numClasses, batchSize);
+  blockObjectives.set_size(numBlocks);
+  if (gradient)
+  {
+    threadGradients.resize(ParallelForThreads(threads));
+    for (size_t t = 0; t < threadGradients.size(); ++t)
+      threadGradients[t].zeros(parameters.n_rows, parameters.n_cols);
+  }
+
+  ParallelFor(0, numBlocks, [&](const size_t block)
+  {
+    const size_t first = block * BlockSize;
+    const size_t last = std::min(first + BlockSize, batchSize) - 1;
+
+    if (fitIntercept)
+    {
+      // The intercept term parameters.col(0) is treated seperately to avoid
+      // the cost of building the matrix [1; data].
+      probabilities.cols(first, last) =
+          parameters.cols(1, parameters.n_cols - 1) *
+          data.cols(start + first, start + last);
+      probabilities.cols(first, last).each_col() += parameters.col(0);
+    }
+    else
+    {
+      probabilities.cols(first, last) = parameters *
+          data.cols(start + first, start + last);
+    }
+
+    // The negative log likelihood of a point with label y is
+    //     log(sum_k exp(logit_k)) - logit_y,
+    // where the log-sum-exp is computed after subtracting the largest logit.
+    double objective = 0.0;
+    for (size_t i = first; i <= last; ++i)
+    {
+      double* logits = probabilities.colptr(i);
+      const size_t label = labels[start + i];
+
+      double maxLogit = logits[0];
+      for (size_t k = 1; k < numClasses; ++k)
+        maxLogit = std::max(maxLogit, logits[k]);
+
+      const double labelLogit = logits[label];
+      double sum = 0.0;
+      for (size_t k = 0; k < numClasses; ++k)
+      {
+        logits[k] = std::exp(logits[k] - maxLogit);
+        sum += logits[k];
+      }
+
+      objective += std::log(sum) + maxLogit - labelLogit;
+
+      if (gradient)
+      {
+        // The gradient of the point with respect to its logits is its
+        // probabilities minus the indicator of its label.
+        for (size_t k = 0; k < numClasses; ++k)
+          logits[k] /= sum;
+        logits[label] -= 1.0;
+      }
+    }
+    blockObjectives[block] = objective;
+
+    if (gradient)
+    {
+      arma::mat& threadGradient = threadGradients[ThreadId()];
+      if (fitIntercept)
+      {
+        threadGradient.col(0) += arma::sum(probabilities.cols(first, last), 1);
+        threadGradient.cols(1, parameters.n_cols - 1) +=
+            probabilities.cols(first, last) *
+            data.cols(start + first, start + last).t();
+      }
+      else
+      {
+        threadGradient += probabilities.cols(first, last) *
+            data.cols(start + first, start + last).t();
+      }
+    }
+  }, 1, threads);
+
+  if (gradient)
+  {
+    *gradient = threadGradients[0];
+    for (size_t t = 1; t < threadGradients.size(); ++t)
+      *gradient += threadGradients[t];
+    *gradient /= batchSize;
+    *gradient += lambda * parameters;
+  }
+
+  // The cost is the sum of the negative log likelihood and the regularization
+  // terms.
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters %
+      parameters);
+  return arma::accu(blockObjectives) / batchSize + weightDecay;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::PartialGradient(
+    const arma::mat& parameters,
+    const size_t j,
+    arma::sp_mat& gradient) const
+{
+  gradient.zeros(arma::size(parameters));
+
+  arma::mat probabilities;
+  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+
+  // Calculate the required part of the gradient.
+  arma::mat inner = probabilities;
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    inner(labels[i], i) -= 1.0;
+  if (fitIntercept)
+  {
+    if (j == 0)
+    {
+      gradient.col(j) =
+          inner * arma::ones<arma::mat>(data.n_cols, 1) / data.n_cols +
+          lambda * parameters.col(0);
+    }
+    else
+    {
+      gradient.col(j) = inner * data.row(j).t() / data.n_cols + lambda *
+          parameters.col(j);
+    }
+  }
+  else
+  {
+    gradient.col(j) = inner * data.row(j).t() / data.n_cols + lambda *
+        parameters.col(j);
+  }
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -26,7 +26,8 @@ SparseAutoencoderFunction::SparseAutoencoderFunction(const arma::mat& data,
     hiddenSize(hiddenSize),
     lambda(lambda),
     beta(beta),
-    rho(rho)
+    rho(rho),
+    computeInFloat(false)
 {
   // Initialize the parameters to suitable values.
   initialPoint = InitializeWeights();
@@ -74,6 +75,116 @@ const arma::mat SparseAutoencoderFunction::InitializeWeights()
 /** Evaluates the objective function given the parameters.
   */
 double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
+{
+  return Compute(parameters, 0, data.n_cols, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         arma::mat& gradient) const
+{
+  Compute(parameters, 0, data.n_cols, &gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return Compute(parameters, 0, data.n_cols, &gradient);
+}
+
+double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters,
+                                           const size_t begin,
+                                           const size_t batchSize) const
+{
+  return Compute(parameters, begin, batchSize, NULL);
+}
+
+void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
+                                         const size_t begin,
+                                         arma::mat& gradient,
+                                         const size_t batchSize) const
+{
+  Compute(parameters, begin, batchSize, &gradient);
+}
+
+double SparseAutoencoderFunction::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return Compute(parameters, begin, batchSize, &gradient);
+}
+
+void SparseAutoencoderFunction::Shuffle()
+{
+  visitationOrder = arma::shuffle(arma::linspace<arma::uvec>(0,
+      data.n_cols - 1, data.n_cols));
+}
+
+void SparseAutoencoderFunction::ComputeInFloat(const bool useFloat)
+{
+  computeInFloat = useFloat;
+  if (useFloat)
+    floatData = arma::conv_to<arma::fmat>::from(data);
+  else
+    floatData.reset();
+}
+
+double SparseAutoencoderFunction::Compute(const arma::mat& parameters,
+                                          const size_t begin,
+                                          const size_t batchSize,
+                                          arma::mat* gradient) const
+{
+  if (!computeInFloat)
+  {
+    return ComputeBatch(parameters, data, begin, batchSize, gradient,
+        buffers);
+  }
+
+  const arma::fmat floatParameters =
+      arma::conv_to<arma::fmat>::from(parameters);
+  arma::fmat floatGradient;
+  const double cost = ComputeBatch(floatParameters, floatData, begin,
+      batchSize, (gradient == NULL) ? NULL : &floatGradient, floatBuffers);
+
+  if (gradient != NULL)
+    *gradient = arma::conv_to<arma::mat>::from(floatGradient);
+
+  return cost;
+}
+
+template<typename eT>
+double SparseAutoencoderFunction::ComputeBatch(
+    const arma::Mat<eT>& parameters,
+    const arma::Mat<eT>& source,
+    const size_t begin,
+    const size_t batchSize,
+    arma::Mat<eT>* gradient,
+    Buffers<eT>& buffers) const
+{
+  // The order of the points does not matter for the whole dataset.
+  if (begin == 0 && batchSize == source.n_cols)
+    return Compute(parameters, source, gradient, buffers);
+
+  if (visitationOrder.is_empty())
+  {
+    return Compute(parameters, source.cols(begin, begin + batchSize - 1),
+        gradient, buffers);
+  }
+
+  buffers.batch = source.cols(visitationOrder.subvec(begin,
+      begin + batchSize - 1));
+  return Compute(parameters, buffers.batch, gradient, buffers);
+}
+
+template<typename eT, typename DataType>
+double SparseAutoencoderFunction::Compute(const arma::Mat<eT>& parameters,
+                                          const DataType& points,
+                                          arma::Mat<eT>* gradient,
+                                          Buffers<eT>& buffers) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -96,31 +207,35 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
+  // The per point terms are divided by the size of the whole dataset, and the
+  // other terms are scaled by the fraction of the dataset in the batch.
+  const double m = data.n_cols;
+  const double scale = points.n_cols / m;
 
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
+  // Compute activations of the hidden and output layers, in place.
+  arma::Mat<eT>& hiddenLayer = buffers.hiddenLayer;
+  arma::Mat<eT>& outputLayer = buffers.outputLayer;
 
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
+  hiddenLayer = parameters.submat(0, 0, l1 - 1, l2 - 1) * points;
+  hiddenLayer.each_col() += arma::Col<eT>(parameters.submat(0, l2, l1 - 1,
+      l2));
+  hiddenLayer = 1.0 / (1.0 + arma::exp(-hiddenLayer));
 
-  arma::mat rhoCap, diff;
+  outputLayer = parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer;
+  outputLayer.each_col() += arma::Col<eT>(parameters.submat(l3, 0, l3,
+      l2 - 1).t());
+  outputLayer = 1.0 / (1.0 + arma::exp(-outputLayer));
 
   // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
+  arma::Col<eT>& rhoCap = buffers.rhoCap;
+  rhoCap = arma::sum(hiddenLayer, 1) / points.n_cols;
   // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  double wL2SquaredNorm;
+  arma::Mat<eT>& diff = buffers.diff;
+  diff = outputLayer - points;
 
   // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
-      parameters.submat(0, 0, l3 - 1, l2 - 1));
-
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
+  const double wL2SquaredNorm = arma::accu(arma::square(parameters.submat(0,
+      0, l3 - 1, l2 - 1)));
 
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
@@ -128,83 +243,43 @@ double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters) const
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * arma::accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) + (1 - rho) *
-      arma::log((1 - rho) / (1 - rhoCap)));
+  const double sumOfSquaresError = 0.5 * arma::accu(arma::square(diff)) / m;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
+
+  if (gradient != NULL)
+  {
+    // The delta vector for the output layer is given by diff * f'(z), where z
+    // is the preactivation and f is the activation function. The derivative of
+    // the sigmoid function turns out to be f(z) * (1 - f(z)). For every other
+    // layer in the neural network which comes before the output layer, the
+    // delta values are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost
+    // function also includes the KL divergence term, we adjust for that in the
+    // formula below.
+    const arma::Col<eT> klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+        (1 - rhoCap));
+
+    arma::Mat<eT>& delOut = buffers.delOut;
+    arma::Mat<eT>& delHid = buffers.delHid;
+    delOut = diff % outputLayer % (1 - outputLayer);
+    delHid = parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut;
+    delHid.each_col() += klDivGrad;
+    delHid %= hiddenLayer % (1 - hiddenLayer);
+
+    gradient->zeros(2 * hiddenSize + 1, visibleSize + 1);
+
+    // Compute the gradient values using the activations and the delta values.
+    // The formula also accounts for the regularization terms in the objective
+    // function.
+    gradient->submat(0, 0, l1 - 1, l2 - 1) = delHid * points.t() / m +
+        scale * lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
+    gradient->submat(l1, 0, l3 - 1, l2 - 1) = hiddenLayer * delOut.t() / m +
+        scale * lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1);
+    gradient->submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / m;
+    gradient->submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / m).t();
+  }
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
-
-  return cost;
-}
-
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
-                                         arma::mat& gradient) const
-{
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
-
-  // Compute the limits for the parameters w1, w2, b1 and b2.
-  const size_t l1 = hiddenSize;
-  const size_t l2 = visibleSize;
-  const size_t l3 = 2 * hiddenSize;
-
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      arma::repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = arma::sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
-  // The delta vector for the output layer is given by diff * f'(z), where z is
-  // the preactivation and f is the activation function. The derivative of the
-  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
-  // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      arma::repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
-
-  gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (arma::sum(delOut, 1) / data.n_cols).t();
+  return sumOfSquaresError + scale * (weightDecay + klDivergence);
 }
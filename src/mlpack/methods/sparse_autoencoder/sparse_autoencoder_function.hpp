@@ -70,6 +70,70 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluate the objective function and its gradient with one feedforward
+   * pass.  The activations are kept in buffers that are reused by later calls,
+   * so an object of this class must not be used by several threads at once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   * @return The objective function.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function on a batch of points, for optimizers like
+   * SGD.  The reconstruction error of each point is divided by the number of
+   * points as in Evaluate(), and the weight decay and the KL divergence are
+   * scaled by batchSize / NumFunctions(), so the objectives of the batches of
+   * an epoch add up to Evaluate().  The average activations of the hidden
+   * layer are those of the batch, so for small batches the KL divergence is
+   * only estimated.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the objective function on a batch of points; see
+   * the batch version of Evaluate().
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient on a batch of points with
+   * one feedforward pass; see the batch version of Evaluate().
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   * @return The objective function on the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
+  //! Return the number of separable functions (the number of points).
+  size_t NumFunctions() const { return data.n_cols; }
+
+  //! Shuffle the order in which the points are visited by the batches.
+  void Shuffle();
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -144,7 +208,64 @@ class SparseAutoencoderFunction
     return rho;
   }
 
+  /**
+   * Sets whether the objective and the gradient are computed in single
+   * precision.  This about halves the memory traffic of the matrix products;
+   * the parameters and the gradient are still double precision.  A single
+   * precision copy of the data is kept while this is enabled.
+   */
+  void ComputeInFloat(const bool useFloat);
+  //! Gets whether the objective and the gradient are computed in float.
+  bool ComputeInFloat() const { return computeInFloat; }
+
  private:
+  //! The intermediate matrices of the feedforward and backward passes.
+  template<typename eT>
+  struct Buffers
+  {
+    //! The gathered points of a shuffled batch.
+    arma::Mat<eT> batch;
+    //! Activations of the hidden layer.
+    arma::Mat<eT> hiddenLayer;
+    //! Activations of the output layer.
+    arma::Mat<eT> outputLayer;
+    //! Difference between the reconstructed and the original data.
+    arma::Mat<eT> diff;
+    //! Delta values of the output layer.
+    arma::Mat<eT> delOut;
+    //! Delta values of the hidden layer.
+    arma::Mat<eT> delHid;
+    //! Average activations of the hidden layer.
+    arma::Col<eT> rhoCap;
+  };
+
+  /**
+   * Find the batch of points and compute the objective on it, and the gradient
+   * if it is not NULL.
+   */
+  template<typename eT>
+  double ComputeBatch(const arma::Mat<eT>& parameters,
+                      const arma::Mat<eT>& source,
+                      const size_t begin,
+                      const size_t batchSize,
+                      arma::Mat<eT>* gradient,
+                      Buffers<eT>& buffers) const;
+
+  //! Compute the objective on the given points, and the gradient if it is not
+  //! NULL.
+  template<typename eT, typename DataType>
+  double Compute(const arma::Mat<eT>& parameters,
+                 const DataType& points,
+                 arma::Mat<eT>* gradient,
+                 Buffers<eT>& buffers) const;
+
+  //! Compute the objective, and the gradient if it is not NULL, in the
+  //! precision that was asked for.
+  double Compute(const arma::mat& parameters,
+                 const size_t begin,
+                 const size_t batchSize,
+                 arma::mat* gradient) const;
+
   //! The matrix of data points.
   const arma::mat& data;
   //! Initial parameter vector.
@@ -159,6 +280,17 @@ class SparseAutoencoderFunction
   double beta;
   //! Sparsity parameter.
   double rho;
+
+  //! The order in which the batches visit the points (empty for in order).
+  arma::uvec visitationOrder;
+  //! Whether to compute in single precision.
+  bool computeInFloat;
+  //! Single precision copy of the data, if computeInFloat is set.
+  arma::fmat floatData;
+  //! Buffers for double precision.
+  mutable Buffers<double> buffers;
+  //! Buffers for single precision.
+  mutable Buffers<float> floatBuffers;
 };
 
 } // namespace nn
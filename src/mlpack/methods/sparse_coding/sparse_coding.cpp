@@ -39,22 +39,28 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   // lambda2 > 0.
   arma::mat matGram = trans(dictionary) * dictionary;
 
-  codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
+  // Besides the Gram matrix, LARS only needs the correlations of each point
+  // with the atoms.  We compute them all with one product, directly into the
+  // codes, and then replace each by the code of its point; that way there is no
+  // second atoms x points matrix.
+  codes = trans(dictionary) * data;
 
+  #pragma omp parallel
+  {
+    // Each thread encodes its points with its own model, sharing the Gram
+    // matrix.
     bool useCholesky = true;
     regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+    {
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that.
+      const arma::vec correlations = codes.col(i);
+      arma::vec code = codes.unsafe_col(i);
+      lars.TrainCovariance(correlations, code);
+    }
   }
 }
 
@@ -0,0 +1,71 @@
+/**
+ * @file hogwild_sgd.hpp
+ *
+ * Definition of HogwildSGD, which runs parallel SGD on a sparse function
+ * without locks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_SVM_HOGWILD_SGD_HPP
+#define MLPACK_METHODS_SPARSE_SVM_HOGWILD_SGD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * Lock-free parallel SGD (Hogwild!) for separable functions whose terms each
+ * depend on a few coordinates of the parameters, such as the loss of a linear
+ * model on a sparse dataset.  Each epoch, the points are visited in a random
+ * order by all the threads at once; the update of a point reads the
+ * parameters without locks and atomically writes only the coordinates its
+ * term depends on, so threads rarely touch the same coordinates.
+ *
+ * Unlike ens::ParallelSGD, no sparse gradient matrix is built for each point:
+ * the function updates the parameters in place.  The function must have the
+ * following methods:
+ *
+ * @code
+ * size_t NumFunctions() const;
+ * double Evaluate(const arma::mat& parameters, const size_t id) const;
+ * void Update(arma::mat& parameters, const size_t id, const double stepSize)
+ *     const;
+ * @endcode
+ *
+ * where Update() takes an SGD step for the term of the given point, and must
+ * be safe to call for different points at the same time.
+ */
+class HogwildSGD
+{
+ public:
+  /**
+   * Minimize the given function with the settings of the given parallel SGD
+   * optimizer: at most optimizer.MaxIterations() epochs (0 means no limit)
+   * are run, until the objective changes by less than optimizer.Tolerance(),
+   * with the step size optimizer.DecayPolicy().StepSize(epoch).  The points
+   * are shuffled at each epoch if optimizer.Shuffle() is true.  The number of
+   * threads is Threads().
+   *
+   * @param optimizer Optimizer to take the settings from.
+   * @param function Function to optimize.
+   * @param iterate Starting point, which is replaced by the final point.
+   * @return The final objective.
+   */
+  template<typename DecayPolicyType, typename FunctionType>
+  static double Optimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                         FunctionType& function,
+                         arma::mat& iterate);
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "hogwild_sgd_impl.hpp"
+
+#endif
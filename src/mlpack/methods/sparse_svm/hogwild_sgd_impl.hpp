@@ -0,0 +1,93 @@
+/**
+ * @file hogwild_sgd_impl.hpp
+ *
+ * Implementation of the optimization loop of HogwildSGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_SVM_HOGWILD_SGD_IMPL_HPP
+#define MLPACK_METHODS_SPARSE_SVM_HOGWILD_SGD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hogwild_sgd.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/util/parallel.hpp>
+
+namespace mlpack {
+namespace svm {
+
+template<typename DecayPolicyType, typename FunctionType>
+double HogwildSGD::Optimize(ens::ParallelSGD<DecayPolicyType>& optimizer,
+                            FunctionType& function,
+                            arma::mat& iterate)
+{
+  const size_t numFunctions = function.NumFunctions();
+  auto objective = [&]()
+  {
+    double overallObjective = 0.0;
+
+    #pragma omp parallel for reduction(+:overallObjective)
+    for (omp_size_t j = 0; j < (omp_size_t) numFunctions; ++j)
+      overallObjective += function.Evaluate(iterate, j);
+
+    return overallObjective;
+  };
+
+  arma::Col<size_t> order = arma::linspace<arma::Col<size_t>>(0,
+      numFunctions - 1, numFunctions);
+
+  double overallObjective = objective();
+  const size_t maxIterations = optimizer.MaxIterations();
+  for (size_t i = 1; i <= maxIterations || maxIterations == 0; ++i)
+  {
+    if (optimizer.Shuffle())
+      std::shuffle(order.begin(), order.end(), math::randGen);
+
+    // Points are handed out in chunks, so that the threads don't all wait on
+    // the schedule, but are small enough to balance the uneven numbers of
+    // nonzeros of the points.
+    const double stepSize = optimizer.DecayPolicy().StepSize(i);
+    ParallelFor(0, numFunctions, [&](const size_t k)
+    {
+      function.Update(iterate, order[k], stepSize);
+    }, 256);
+
+    // Calculate the overall objective.
+    const double lastObjective = overallObjective;
+    overallObjective = objective();
+
+    // Output current objective function.
+    Log::Info << "Hogwild SGD: epoch " << i << ", objective "
+        << overallObjective << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Log::Warn << "Hogwild SGD: converged to " << overallObjective
+          << "; terminating with failure. Try a smaller step size?"
+          << std::endl;
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < optimizer.Tolerance())
+    {
+      Log::Info << "Hogwild SGD: minimized within tolerance "
+          << optimizer.Tolerance() << "; terminating optimization."
+          << std::endl;
+      return overallObjective;
+    }
+  }
+
+  Log::Info << "Hogwild SGD terminated with objective " << overallObjective
+      << "." << std::endl;
+
+  return overallObjective;
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
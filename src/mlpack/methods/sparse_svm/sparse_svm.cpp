@@ -0,0 +1,86 @@
+/**
+ * @file sparse_svm.cpp
+ *
+ * Implementation of the SparseSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "sparse_svm.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+SparseSVM::SparseSVM(const size_t dimensionality, const double lambda) :
+    parameters(arma::zeros<arma::vec>(dimensionality + 1)),
+    lambda(lambda)
+{
+  // Nothing to do.
+}
+
+SparseSVM::SparseSVM(const arma::sp_mat& data,
+                     const arma::Row<size_t>& labels,
+                     const double lambda) :
+    lambda(lambda)
+{
+  Train(data, labels);
+}
+
+double SparseSVM::Train(const arma::sp_mat& data,
+                        const arma::Row<size_t>& labels)
+{
+  ens::ParallelSGD<ens::ConstantStep> optimizer(20, data.n_cols, 1e-5, true,
+      ens::ConstantStep(0.01));
+  return Train(data, labels, optimizer);
+}
+
+void SparseSVM::Classify(const arma::sp_mat& data,
+                         arma::Row<size_t>& labels) const
+{
+  arma::rowvec scores;
+  Classify(data, labels, scores);
+}
+
+void SparseSVM::Classify(const arma::sp_mat& data,
+                         arma::Row<size_t>& labels,
+                         arma::rowvec& scores) const
+{
+  const size_t dimensionality = Dimensionality();
+  if (data.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVM::Classify(): the dimensionality of the points ("
+        << data.n_rows << ") does not match the model (" << dimensionality
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // One sparse product gives the decision values of all of the points.
+  scores = parameters.head(dimensionality).t() * data;
+  scores += parameters[dimensionality];
+
+  labels.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (scores[i] >= 0.0) ? 1 : 0;
+}
+
+double SparseSVM::ComputeAccuracy(const arma::sp_mat& data,
+                                  const arma::Row<size_t>& labels) const
+{
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVM::ComputeAccuracy(): the number of labels ("
+        << labels.n_elem << ") does not match the number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::Row<size_t> predictions;
+  Classify(data, predictions);
+
+  const size_t correct = arma::accu(predictions == labels);
+  return 100.0 * (double) correct / (double) labels.n_elem;
+}
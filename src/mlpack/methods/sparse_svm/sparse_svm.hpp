@@ -0,0 +1,167 @@
+/**
+ * @file sparse_svm.hpp
+ *
+ * The SparseSVM class, a linear SVM for sparse data trained with lock-free
+ * parallel SGD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_HPP
+#define MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+#include "sparse_svm_function.hpp"
+#include "hogwild_sgd.hpp"
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * An L2-regularized linear SVM for two-class classification of sparse data,
+ * trained by minimizing the hinge loss (see SparseSVMFunction) with Hogwild!
+ * SGD (see HogwildSGD): the threads visit the points at the same time, and a
+ * point only reads and writes the weights of its nonzeros, so the training
+ * scales with the number of threads when the data is sparse.
+ *
+ * The labels are 0 or 1.  A point x is given the label 1 when w^T x + b >= 0.
+ *
+ * @code
+ * arma::sp_mat data; // Points in columns.
+ * arma::Row<size_t> labels; // 0 or 1.
+ *
+ * SparseSVM svm(data, labels, 0.0001);
+ *
+ * arma::Row<size_t> predictions;
+ * svm.Classify(testData, predictions);
+ * @endcode
+ */
+class SparseSVM
+{
+ public:
+  /**
+   * Construct the SparseSVM without training it.  All the parameters of the
+   * model are set to 0.
+   *
+   * @param dimensionality Dimensionality of the data.
+   * @param lambda L2-regularization parameter.
+   */
+  SparseSVM(const size_t dimensionality = 0, const double lambda = 0.0001);
+
+  /**
+   * Construct the SparseSVM and train it on the given data with the default
+   * Hogwild! SGD settings (see Train()).
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points (0 or 1).
+   * @param lambda L2-regularization parameter.
+   */
+  SparseSVM(const arma::sp_mat& data,
+            const arma::Row<size_t>& labels,
+            const double lambda = 0.0001);
+
+  /**
+   * Train the model on the given data with Hogwild! SGD, with 20 epochs and a
+   * constant step size of 0.01.  The existing parameters are the starting
+   * point, unless their size does not match the data, in which case training
+   * starts from zero.
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points (0 or 1).
+   * @return The final objective.
+   */
+  double Train(const arma::sp_mat& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Train the model on the given data with Hogwild! SGD, using the maximum
+   * number of epochs (MaxIterations()), tolerance, shuffling and step size
+   * policy of the given optimizer.  The existing parameters are the starting
+   * point, unless their size does not match the data, in which case training
+   * starts from zero.  The number of threads is Threads().
+   *
+   * @param data Training points, one per column.
+   * @param labels Labels of the points (0 or 1).
+   * @param optimizer Optimizer to take the settings from.
+   * @return The final objective.
+   */
+  template<typename DecayPolicyType>
+  double Train(const arma::sp_mat& data,
+               const arma::Row<size_t>& labels,
+               ens::ParallelSGD<DecayPolicyType>& optimizer);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify (dense or sparse).
+   * @return Predicted label of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels Predicted labels of the points (output).
+   */
+  void Classify(const arma::sp_mat& data, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given points, also returning their decision values
+   * w^T x + b.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels Predicted labels of the points (output).
+   * @param scores Decision values of the points (output).
+   */
+  void Classify(const arma::sp_mat& data,
+                arma::Row<size_t>& labels,
+                arma::rowvec& scores) const;
+
+  /**
+   * Compute the accuracy of the model on the given points, as a percentage
+   * between 0 and 100.
+   *
+   * @param data Points to classify, one per column.
+   * @param labels True labels of the points.
+   * @return Percentage of points whose label is predicted correctly.
+   */
+  double ComputeAccuracy(const arma::sp_mat& data,
+                         const arma::Row<size_t>& labels) const;
+
+  //! Get the dimensionality of the model.
+  size_t Dimensionality() const
+  { return parameters.n_elem == 0 ? 0 : parameters.n_elem - 1; }
+
+  //! Get the parameters (the weights, followed by the bias).
+  const arma::vec& Parameters() const { return parameters; }
+  //! Modify the parameters (the weights, followed by the bias).
+  arma::vec& Parameters() { return parameters; }
+
+  //! Get the L2-regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the L2-regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! The weights of each dimension, followed by the bias.
+  arma::vec parameters;
+  //! The L2-regularization parameter.
+  double lambda;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_svm_impl.hpp"
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * @file sparse_svm_function.cpp
+ * @author Shikhar Bhardwaj
+ *
+ * Implementation of the hinge loss function for training a sparse SVM with the
+ * parallel SGD algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "sparse_svm_function.hpp"
+
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+SparseSVMFunction::SparseSVMFunction(const arma::sp_mat& dataset,
+                                     const arma::vec& labels,
+                                     const double lambda) :
+    initialPoint(arma::zeros<arma::mat>(dataset.n_rows + 1, 1)),
+    dataset(dataset),
+    labels(math::MakeAlias(const_cast<arma::vec&>(labels), false)),
+    lambda(lambda),
+    counts(arma::zeros<arma::vec>(dataset.n_rows))
+{
+  // Count the points with a nonzero in each dimension, to split the
+  // regularization between them.
+  arma::sp_mat::const_iterator it = this->dataset.begin();
+  for (; it != this->dataset.end(); ++it)
+    counts[it.row()] += 1.0;
+}
+
+void SparseSVMFunction::Shuffle()
+{
+  arma::sp_mat newDataset;
+  arma::vec newLabels;
+
+  // Shuffle the data.
+  math::ShuffleData(dataset, labels, newDataset, newLabels);
+
+  math::ClearAlias(labels);
+
+  dataset = std::move(newDataset);
+  labels = std::move(newLabels);
+}
+
+double SparseSVMFunction::Evaluate(const arma::mat& parameters,
+                                   const size_t firstId,
+                                   const size_t batchSize) const
+{
+  // The hinge loss function, and the share of the regularization of the
+  // points.
+  double objective = 0.0;
+  for (size_t i = firstId; i < firstId + batchSize; ++i)
+  {
+    objective += std::max(0.0, 1.0 - Margin(parameters, i));
+
+    arma::sp_mat::const_iterator it = dataset.begin_col(i);
+    for (; it != dataset.end_col(i); ++it)
+    {
+      const double weight = parameters(it.row(), 0);
+      objective += 0.5 * lambda * weight * weight / counts[it.row()];
+    }
+  }
+
+  return objective;
+}
+
+void SparseSVMFunction::Update(arma::mat& parameters,
+                               const size_t id,
+                               const double stepSize) const
+{
+  // Other threads may write the weights while they are read here; as in
+  // Hogwild!, the updates of sparse points rarely collide, and SGD tolerates
+  // the ones that do.
+  const double activeLabel = (Margin(parameters, id) < 1.0) ?
+      labels[id] : 0.0;
+
+  arma::sp_mat::const_iterator it = dataset.begin_col(id);
+  for (; it != dataset.end_col(id); ++it)
+  {
+    const size_t j = it.row();
+    const double step = stepSize * (lambda * parameters(j, 0) / counts[j] -
+        activeLabel * (*it));
+
+    #pragma omp atomic
+    parameters(j, 0) -= step;
+  }
+
+  if (activeLabel != 0.0)
+  {
+    const size_t bias = parameters.n_rows - 1;
+    const double step = stepSize * activeLabel;
+
+    #pragma omp atomic
+    parameters(bias, 0) += step;
+  }
+}
+
+size_t SparseSVMFunction::NumFunctions() const
+{
+  // The number of points in the dataset is the number of functions, as this
+  // is a data dependent function.
+  return dataset.n_cols;
+}
+
+double SparseSVMFunction::Margin(const arma::mat& parameters,
+                                 const size_t id) const
+{
+  double score = parameters(parameters.n_rows - 1, 0);
+  arma::sp_mat::const_iterator it = dataset.begin_col(id);
+  for (; it != dataset.end_col(id); ++it)
+    score += parameters(it.row(), 0) * (*it);
+
+  return labels[id] * score;
+}
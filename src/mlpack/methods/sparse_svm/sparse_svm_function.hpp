@@ -15,14 +15,57 @@
 
 #include <mlpack/prereqs.hpp>
 
+namespace mlpack {
+namespace svm {
+
+/**
+ * The L2-regularized hinge loss of a linear SVM on a sparse dataset, written
+ * as a sum of one function per point so that it can be minimized with the
+ * lock-free parallel SGD of Niu et al. (HogwildSGD or ens::ParallelSGD).  The
+ * parameters are a column of the weights of each dimension followed by the
+ * bias.
+ *
+ * The regularization of each weight is split between the points that have a
+ * nonzero in its dimension, so that the function of a point depends only on
+ * the weights of its nonzeros and the bias:
+ *
+ * f_i(w, b) = max(0, 1 - y_i (w^T x_i + b)) +
+ *     sum_{j : x_ij != 0} (lambda / 2) w_j^2 / d_j,
+ *
+ * where y_i is -1 or +1 and d_j is the number of points with a nonzero in
+ * dimension j.  The sum over all points is the hinge loss plus
+ * (lambda / 2) ||w||^2 (ignoring the weights of dimensions that are zero in
+ * every point, which stay zero).
+ *
+ * @code
+ * @inproceedings{recht2011hogwild,
+ *   title = {Hogwild!: A Lock-Free Approach to Parallelizing Stochastic
+ *       Gradient Descent},
+ *   author = {Niu, Feng and Recht, Benjamin and R{\'e}, Christopher and
+ *       Wright, Stephen J.},
+ *   booktitle = {Advances in Neural Information Processing Systems 24},
+ *   pages = {693--701},
+ *   year = {2011}
+ * }
+ * @endcode
+ */
 class SparseSVMFunction
 {
  public:
   //! Nothing to do for the default constructor.
-  SparseSVMFunction() {}
+  SparseSVMFunction() : lambda(0.0) {}
 
-  //! Member initialization constructor.
-  SparseSVMFunction(const arma::sp_mat& dataset, const arma::vec& labels);
+  /**
+   * Member initialization constructor.  The labels are aliased, so they must
+   * live as long as this object.
+   *
+   * @param dataset The datapoints for training.
+   * @param labels The labels of the points, -1 or +1.
+   * @param lambda L2-regularization parameter.
+   */
+  SparseSVMFunction(const arma::sp_mat& dataset,
+                    const arma::vec& labels,
+                    const double lambda = 0.0);
 
   /**
    * Shuffle the dataset.
@@ -33,18 +76,20 @@ class SparseSVMFunction
    * Evaluate the hinge loss function on the specified datapoints.
    *
    * @param parameters The parameters of the SVM.
-   * @param startId First index of the datapoints to use for function
+   * @param firstId First index of the datapoints to use for function
    *      evaluation.
    * @param batchSize Size of batch to process.
    * @return The value of the loss function at the given parameters.
    */
   double Evaluate(const arma::mat& parameters,
-                  const size_t startId,
-                  const size_t batchSize = 1);
+                  const size_t firstId,
+                  const size_t batchSize = 1) const;
 
   /**
    * Evaluate the gradient the gradient of the hinge loss function, following
-   * the SparseFunctionType requirements on the Gradient function.
+   * the SparseFunctionType requirements on the Gradient function.  Only the
+   * weights of the nonzeros of the points, and the bias, have a nonzero
+   * gradient.
    *
    * @param parameters The parameters of the SVM.
    * @param firstId Index of the datapoint to use for the gradient evaluation.
@@ -55,7 +100,21 @@ class SparseSVMFunction
   void Gradient(const arma::mat& parameters,
                 const size_t firstId,
                 GradType& gradient,
-                const size_t batchSize = 1);
+                const size_t batchSize = 1) const;
+
+  /**
+   * Take an SGD step with the gradient of the function of the given point,
+   * writing only the weights of its nonzeros and the bias.  The writes are
+   * atomic and nothing is locked, so this may be called for different points
+   * at the same time.
+   *
+   * @param parameters The parameters of the SVM, which are updated.
+   * @param id Index of the datapoint.
+   * @param stepSize Step size of the update.
+   */
+  void Update(arma::mat& parameters,
+              const size_t id,
+              const double stepSize) const;
 
   //! Return the initial point for the optimization.
   const arma::mat& InitialPoint() const { return initialPoint; }
@@ -72,10 +131,19 @@ class SparseSVMFunction
   //! Modify the labels.
   arma::vec& Labels() { return labels; }
 
+  //! Get the L2-regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the L2-regularization parameter.
+  double& Lambda() { return lambda; }
+
   //! Return the number of functions.
-  size_t NumFunctions();
+  size_t NumFunctions() const;
 
  private:
+  //! Compute y_i (w^T x_i + b) for the given point, reading only the weights
+  //! of its nonzeros.
+  double Margin(const arma::mat& parameters, const size_t id) const;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
@@ -84,8 +152,17 @@ class SparseSVMFunction
 
   //! The labels, y_i.
   arma::vec labels;
+
+  //! The L2-regularization parameter.
+  double lambda;
+
+  //! The number of points with a nonzero in each dimension, d_j.
+  arma::vec counts;
 };
 
+} // namespace svm
+} // namespace mlpack
+
 // Include implementation
 #include "sparse_svm_function_impl.hpp"
 
@@ -16,64 +16,36 @@
 // In case it hasn't been included yet.
 #include "sparse_svm_function.hpp"
 
-SparseSVMFunction::SparseSVMFunction(
-    const arma::sp_mat& dataset, const arma::vec& labels) :
-    dataset(dataset),
-    labels(math::MakeAlias(const_cast<arma::vec&>(labels), false))
-{ /* Nothing to do */ }
-
-void SparseSVMFunction::Shuffle()
-{
-  arma::sp_mat newDataset;
-  arma::vec newLabels;
-
-  // Shuffle the data.
-  math::ShuffleData(dataset, labels, newDataset, newLabels);
-
-  math::ClearAlias(newLabels);
-
-  dataset = std::move(newDataset);
-  labels = std::move(newLabels);
-}
-
-double SparseSVMFunction::Evaluate(const arma::mat& parameters,
-                                   const size_t firstId,
-                                   const size_t batchSize)
-{
-  // The hinge loss function.
-  const size_t lastId = firstId + batchSize - 1;
-  return arma::accu(arma::max(0.0, 1 - labels.subvec(firstId, lastId) %
-      dataset.cols(firstId, lastId) *
-      arma::repmat(parameters, 1, batchSize).t()));
-}
+namespace mlpack {
+namespace svm {
 
 template <typename GradType>
 void SparseSVMFunction::Gradient(const arma::mat& parameters,
                                  const size_t firstId,
                                  GradType& gradient,
-                                 const size_t batchSize)
+                                 const size_t batchSize) const
 {
   // Evaluate the gradient of the hinge loss function.
-  const size_t lastId = firstId + batchSize - 1;
-  arma::vec dots = 1 - labels.subvec(firstId, lastId) %
-      dataset.cols(firstId, lastId) *
-      arma::repmat(parameters, 1, batchSize).t();
   gradient = GradType(parameters.n_rows, 1);
-  for (size_t i = 0; i < batchSize; ++i)
+  const size_t bias = parameters.n_rows - 1;
+  for (size_t i = firstId; i < firstId + batchSize; ++i)
   {
-    if (dots[i] >= 0)
+    // The hinge loss only has a gradient for points inside the margin.
+    const double activeLabel = (Margin(parameters, i) < 1.0) ? labels[i] : 0.0;
+
+    arma::sp_mat::const_iterator it = dataset.begin_col(i);
+    for (; it != dataset.end_col(i); ++it)
     {
-      // Is this correct?
-      gradient += -1 * GradType(dataset.col(id) * labels(id));
+      const size_t j = it.row();
+      gradient(j, 0) += lambda * parameters(j, 0) / counts[j] -
+          activeLabel * (*it);
     }
+
+    gradient(bias, 0) -= activeLabel;
   }
 }
 
-size_t SparseSVMFunction::NumFunctions()
-{
-  // The number of points in the dataset is the number of functions, as this
-  // is a data dependent function.
-  return dataset.n_cols;
-}
+} // namespace svm
+} // namespace mlpack
 
 #endif // MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_FUNCTION_IMPL_HPP
@@ -0,0 +1,89 @@
+/**
+ * @file sparse_svm_impl.hpp
+ *
+ * Implementation of the templated methods of the SparseSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_IMPL_HPP
+#define MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_svm.hpp"
+
+namespace mlpack {
+namespace svm {
+
+template<typename DecayPolicyType>
+double SparseSVM::Train(const arma::sp_mat& data,
+                        const arma::Row<size_t>& labels,
+                        ens::ParallelSGD<DecayPolicyType>& optimizer)
+{
+  if (data.n_cols != labels.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVM::Train(): the number of labels (" << labels.n_elem
+        << ") does not match the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+    throw std::invalid_argument("SparseSVM::Train(): no training points!");
+
+  if (arma::max(labels) > 1)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVM::Train(): the labels must be 0 or 1, not "
+        << arma::max(labels) << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The hinge loss takes labels of -1 and +1.
+  const arma::vec responses = 2.0 * arma::conv_to<arma::vec>::from(labels) -
+      1.0;
+  SparseSVMFunction function(data, responses, lambda);
+
+  arma::mat iterate;
+  if (parameters.n_elem == data.n_rows + 1)
+    iterate = parameters;
+  else
+    iterate = function.InitialPoint();
+
+  const double objective = HogwildSGD::Optimize(optimizer, function, iterate);
+  parameters = iterate.col(0);
+
+  return objective;
+}
+
+template<typename VecType>
+size_t SparseSVM::Classify(const VecType& point) const
+{
+  const size_t dimensionality = Dimensionality();
+  if (point.n_elem != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVM::Classify(): the dimensionality of the point ("
+        << point.n_elem << ") does not match the model (" << dimensionality
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double score = arma::as_scalar(
+      parameters.head(dimensionality).t() * point) + parameters[dimensionality];
+  return (score >= 0.0) ? 1 : 0;
+}
+
+template<typename Archive>
+void SparseSVM::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameters);
+  ar & BOOST_SERIALIZATION_NVP(lambda);
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif
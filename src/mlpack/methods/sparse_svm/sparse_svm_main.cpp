@@ -0,0 +1,217 @@
+/**
+ * @file sparse_svm_main.cpp
+ *
+ * Main executable for the sparse linear SVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "sparse_svm.hpp"
+
+#include <ensmallen.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::svm;
+using namespace mlpack::util;
+
+PROGRAM_INFO("Sparse Linear SVM",
+    // Short description.
+    "An implementation of an L2-regularized linear SVM for two-class "
+    "classification of sparse data, trained with lock-free parallel SGD.  "
+    "Given labeled data, a model can be trained and saved for future use; or, "
+    "a pre-trained model can be used to classify new points.",
+    // Long description.
+    "An implementation of an L2-regularized linear SVM for two-class "
+    "classification, which minimizes the hinge loss with the lock-free "
+    "parallel SGD algorithm Hogwild!.  All of the threads visit the points at "
+    "the same time, and each point only reads and writes the weights of its "
+    "nonzero dimensions, so training is fast on sparse data.  The datasets are "
+    "stored as sparse matrices once loaded."
+    "\n\n"
+    "This program allows loading a model (via the " +
+    PRINT_PARAM_STRING("input_model") + " parameter) or training a model given "
+    "training data (specified with the " + PRINT_PARAM_STRING("training") +
+    " parameter) and labels (specified with the " +
+    PRINT_PARAM_STRING("labels") + " parameter), or both of those things at "
+    "once.  The labels must be 0 or 1.  The model can be saved with the " +
+    PRINT_PARAM_STRING("output_model") + " output parameter."
+    "\n\n"
+    "The training is controlled by the L2 regularization parameter " +
+    PRINT_PARAM_STRING("lambda") + ", the " + PRINT_PARAM_STRING("step_size") +
+    " of SGD, the maximum number of epochs (passes over the data) " +
+    PRINT_PARAM_STRING("max_iterations") + ", and the " +
+    PRINT_PARAM_STRING("tolerance") + " on the change of the objective between "
+    "epochs at which training terminates.  The points are visited in a random "
+    "order each epoch, unless " + PRINT_PARAM_STRING("no_shuffle") + " is "
+    "given."
+    "\n\n"
+    "The points of a test dataset (specified with the " +
+    PRINT_PARAM_STRING("test") + " parameter) can be classified; the predicted "
+    "labels can be saved with the " + PRINT_PARAM_STRING("predictions") +
+    " output parameter, and the decision values of the points with the " +
+    PRINT_PARAM_STRING("scores") + " output parameter."
+    "\n\n"
+    "As an example, to train a model on the data '" + PRINT_DATASET("data") +
+    "' with labels '" + PRINT_DATASET("labels") + "' with L2 regularization of "
+    "0.001, saving the model to '" + PRINT_MODEL("svm_model") + "', the "
+    "following command may be used:"
+    "\n\n" +
+    PRINT_CALL("sparse_svm", "training", "data", "labels", "labels", "lambda",
+        0.001, "output_model", "svm_model") +
+    "\n\n"
+    "Then, to use that model to predict classes for the dataset '" +
+    PRINT_DATASET("test") + "', storing the predictions in '" +
+    PRINT_DATASET("predictions") + "', the following command may be used: "
+    "\n\n" +
+    PRINT_CALL("sparse_svm", "input_model", "svm_model", "test", "test",
+        "predictions", "predictions"),
+    SEE_ALSO("@logistic_regression", "#logistic_regression"),
+    SEE_ALSO("@perceptron", "#perceptron"),
+    SEE_ALSO("Hogwild!: A Lock-Free Approach to Parallelizing Stochastic "
+        "Gradient Descent (pdf)", "https://arxiv.org/pdf/1106.5730.pdf"),
+    SEE_ALSO("mlpack::svm::SparseSVM C++ class documentation",
+        "@doxygen/classmlpack_1_1svm_1_1SparseSVM.html"));
+
+// Training parameters.
+PARAM_MATRIX_IN("training", "A matrix containing the training set.", "t");
+PARAM_UROW_IN("labels", "A matrix containing labels (0 or 1) for the points "
+    "in the training set.", "l");
+
+// Optimizer parameters.
+PARAM_DOUBLE_IN("lambda", "L2-regularization parameter for training.", "L",
+    0.0001);
+PARAM_DOUBLE_IN("step_size", "Step size for SGD.", "s", 0.01);
+PARAM_INT_IN("max_iterations", "Maximum number of epochs of SGD (0 indicates "
+    "no limit).", "n", 20);
+PARAM_DOUBLE_IN("tolerance", "Convergence tolerance on the change of the "
+    "objective.", "e", 1e-5);
+PARAM_FLAG("no_shuffle", "Don't shuffle the order of the points at each "
+    "epoch.", "S");
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "r", 0);
+
+// Model loading/saving.
+PARAM_MODEL_IN(SparseSVM, "input_model", "Existing model (parameters).", "m");
+PARAM_MODEL_OUT(SparseSVM, "output_model", "Output for trained sparse SVM "
+    "model.", "M");
+
+// Testing.
+PARAM_MATRIX_IN("test", "Matrix containing test dataset.", "T");
+PARAM_UROW_OUT("predictions", "If test data is specified, this matrix is where "
+    "the predictions for the test set will be saved.", "P");
+PARAM_ROW_OUT("scores", "If test data is specified, this matrix is where the "
+    "decision values of the test points will be saved.", "p");
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) std::time(NULL));
+
+  // One of training and input_model must be specified.
+  RequireAtLeastOnePassed({ "training", "input_model" }, true);
+  if (CLI::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "labels" }, true, "labels are needed for "
+        "training");
+  }
+
+  RequireAtLeastOnePassed({ "output_model", "predictions", "scores" }, false,
+      "no output will be saved");
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "scores");
+  ReportIgnoredParam({{ "training", false }}, "step_size");
+  ReportIgnoredParam({{ "training", false }}, "max_iterations");
+  ReportIgnoredParam({{ "training", false }}, "tolerance");
+  ReportIgnoredParam({{ "training", false }}, "no_shuffle");
+
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; },
+      true, "lambda must be positive or zero");
+  RequireParamValue<double>("step_size", [](double x) { return x > 0.0; },
+      true, "step size must be positive");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; },
+      true, "max_iterations must be positive or zero");
+  RequireParamValue<double>("tolerance", [](double x) { return x >= 0.0; },
+      true, "tolerance must be positive or zero");
+
+  SparseSVM* model;
+  if (CLI::HasParam("input_model"))
+    model = CLI::GetParam<SparseSVM*>("input_model");
+  else
+    model = new SparseSVM();
+
+  if (CLI::HasParam("training"))
+  {
+    const arma::sp_mat trainingData(CLI::GetParam<arma::mat>("training"));
+    const arma::Row<size_t> labels =
+        std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+
+    if (labels.n_elem != trainingData.n_cols)
+    {
+      // Clean memory if needed.
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "The labels must have the same number of points as the "
+          << "training dataset." << endl;
+    }
+
+    if (labels.n_elem > 0 && arma::max(labels) > 1)
+    {
+      // Clean memory if needed.
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "The labels must be either 0 or 1, not "
+          << arma::max(labels) << "!" << endl;
+    }
+
+    model->Lambda() = CLI::GetParam<double>("lambda");
+    ens::ParallelSGD<ens::ConstantStep> optimizer(
+        (size_t) CLI::GetParam<int>("max_iterations"), trainingData.n_cols,
+        CLI::GetParam<double>("tolerance"), !CLI::HasParam("no_shuffle"),
+        ens::ConstantStep(CLI::GetParam<double>("step_size")));
+
+    Log::Info << "Training sparse SVM on " << trainingData.n_cols
+        << " points with " << trainingData.n_nonzero << " nonzeros, with "
+        << Threads() << " threads." << endl;
+    Timer::Start("training");
+    model->Train(trainingData, labels, optimizer);
+    Timer::Stop("training");
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    const arma::sp_mat testData(CLI::GetParam<arma::mat>("test"));
+    if (testData.n_rows != model->Dimensionality())
+    {
+      const size_t dimensionality = model->Dimensionality();
+
+      // Clean memory if needed.
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "Test data dimensionality (" << testData.n_rows << ") "
+          << "must be the same as the dimensionality of the model ("
+          << dimensionality << ")!" << endl;
+    }
+
+    Timer::Start("testing");
+    arma::Row<size_t> predictions;
+    arma::rowvec scores;
+    model->Classify(testData, predictions, scores);
+    Timer::Stop("testing");
+
+    CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+    CLI::GetParam<arma::rowvec>("scores") = std::move(scores);
+  }
+
+  CLI::GetParam<SparseSVM*>("output_model") = model;
+}
@@ -15,6 +15,7 @@
 
 #include "svdplusplus_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/methods/regularized_svd/stratified_sgd.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -399,88 +400,44 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
     mlpack::svd::SVDPlusPlusFunction<arma::mat>& function,
     arma::mat& iterate)
 {
-  double overallObjective = DBL_MAX;
-  double lastObjective;
-
-  // The order in which the functions will be visited.
-  arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
-
-  const arma::mat data = function.Dataset();
-  const arma::sp_mat implicitData = function.ImplicitDataset();
+  const arma::mat& data = function.Dataset();
+  const arma::sp_mat& implicitData = function.ImplicitDataset();
   const size_t numUsers = function.NumUsers();
   const size_t numItems = function.NumItems();
   const double lambda = function.Lambda();
+  const size_t implicitStart = numUsers + numItems;
 
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
-  // Iterate till the objective is within tolerance or the maximum number of
-  // allowed iterations is reached. If maxIterations is 0, this will iterate
-  // till convergence.
-  for (size_t i = 1; i != maxIterations; ++i)
-  {
-    // Calculate the overall objective.
-    lastObjective = overallObjective;
-    overallObjective = 0;
-
-    #pragma omp parallel for reduction(+:overallObjective)
-    for (omp_size_t j = 0; j < (omp_size_t) function.NumFunctions(); ++j)
-    {
-      overallObjective += function.Evaluate(iterate, j);
-    }
-
-    // Output current objective function.
-    mlpack::Log::Info << "Parallel SGD: iteration " << i << ", objective "
-        << overallObjective << "." << std::endl;
-
-    if (std::isnan(overallObjective) || std::isinf(overallObjective))
-    {
-      mlpack::Log::Warn << "Parallel SGD: converged to " << overallObjective
-          << "; terminating with failure. Try a smaller step size?"
-          << std::endl;
-      return overallObjective;
-    }
-
-    if (std::abs(lastObjective - overallObjective) < tolerance)
-    {
-      mlpack::Log::Info << "SGD: minimized within tolerance " << tolerance
-          << "; terminating optimization." << std::endl;
-      return overallObjective;
-    }
-
-    // Get the stepsize for this iteration
-    double stepSize = decayPolicy.StepSize(i);
-
-    if (shuffle) // Determine order of visitation.
-      std::shuffle(visitationOrder.begin(), visitationOrder.end(),
-          mlpack::math::randGen);
-
-    #pragma omp parallel
-    {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+  // The ratings are split into blocks whose users and items don't overlap, so
+  // the user and item columns are updated without locks.  The implicit item
+  // vectors of a user aren't in the block of the item, so their updates are
+  // summed for each block and applied once the stratum is done.
+  size_t numBlocks = 1;
+  #ifdef HAS_OPENMP
+    numBlocks = omp_get_max_threads();
+  #endif
+  std::vector<arma::mat> implicitUpdates(numBlocks,
+      arma::zeros<arma::mat>(rank, numItems));
+  std::vector<arma::vec> userVecs(numBlocks, arma::vec(rank));
+
+  return mlpack::svd::StratifiedSGD::Optimize(*this, function, iterate,
+      [&](const size_t j, const size_t block, const double stepSize)
       {
         // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
+        const size_t user = data(0, j);
+        const size_t item = data(1, j) + numUsers;
 
         // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
+        const double rating = data(2, j);
         const double userBias = iterate(rank, user);
         const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
+
+        // Iterate through each item which the user interacted with to
+        // calculate user vector.
+        arma::vec& userVec = userVecs[block];
+        userVec.zeros();
         arma::sp_mat::const_iterator it = implicitData.begin_col(user);
         arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
         size_t implicitCount = 0;
@@ -493,65 +450,50 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
           userVec /= std::sqrt(implicitCount);
         userVec += iterate.col(user).subvec(0, rank - 1);
 
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
+        const double ratingError = rating - userBias - itemBias -
+            arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
+
+        // Update of item implicit vectors, which uses the item vector before
+        // it is updated.
+        arma::mat& implicitUpdate = implicitUpdates[block];
         it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
+        for (; it != it_end; ++it)
         {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
+          implicitUpdate.col(it.row()) += stepSize * 2.0 * (lambda /
+              implicitCount * iterate.col(implicitStart +
+              it.row()).subvec(0, rank - 1) - ratingError /
+              std::sqrt(implicitCount) * iterate.col(item).subvec(0, rank - 1));
         }
 
         // Gradient is non-zero only for the parameter columns corresponding to
         // the example.
         for (size_t i = 0; i < rank; ++i)
         {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
+          const double userValue = iterate(i, user);
+          const double itemValue = iterate(i, item);
+          iterate(i, user) -= stepSize * 2 * (lambda * userValue -
+              ratingError * itemValue);
+          iterate(i, item) -= stepSize * 2 * (lambda * itemValue -
+              ratingError * userVec(i));
         }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
+        iterate(rank, user) -= stepSize * 2 * (lambda * userBias -
+            ratingError);
+        iterate(rank, item) -= stepSize * 2 * (lambda * itemBias -
+            ratingError);
+      },
+      [&](const double /* stepSize */)
+      {
+        #pragma omp parallel for
+        for (omp_size_t k = 0; k < (omp_size_t) numItems; ++k)
         {
-          for (size_t i = 0; i < rank; ++i)
+          for (size_t b = 0; b < numBlocks; ++b)
           {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
+            iterate.col(implicitStart + k).subvec(0, rank - 1) -=
+                implicitUpdates[b].col(k);
+            implicitUpdates[b].col(k).zeros();
           }
         }
-      }
-    }
-  }
-  mlpack::Log::Info << "\n Parallel SGD terminated with objective : "
-      << overallObjective << std::endl;
-
-  return overallObjective;
+      });
 }
 
 } // namespace ens
@@ -891,4 +891,58 @@ BOOST_AUTO_TEST_CASE(DecisionStumpSerializationTest)
   }
 }
 
+/**
+ * Train AdaBoost with each weak learner trained on a random half of the iris
+ * dataset, and make sure that the Hamming loss bound still holds and that
+ * Classify() gives the labels with the highest weighted vote.
+ */
+BOOST_AUTO_TEST_CASE(SubsampledRoundsIris)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset iris.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for iris_labels.txt");
+
+  const size_t numClasses = 3;
+  DecisionStump<> ds(inputData, labels.row(0), numClasses, 6);
+
+  AdaBoost<DecisionStump<>> a(inputData, labels.row(0), numClasses, ds, 50,
+      1e-10, 0.5);
+  BOOST_REQUIRE_GT(a.WeakLearners(), 0);
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(inputData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, inputData.n_cols);
+
+  const double hammingLoss = (double) arma::accu(predictedLabels !=
+      labels.row(0)) / labels.n_cols;
+  BOOST_REQUIRE_LE(hammingLoss, a.ZtProduct());
+
+  // Find the votes one point at a time.
+  arma::mat votes(numClasses, inputData.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < a.WeakLearners(); ++i)
+  {
+    arma::Row<size_t> weakLabels;
+    a.WeakLearner(i).Classify(inputData, weakLabels);
+    for (size_t j = 0; j < inputData.n_cols; ++j)
+      votes(weakLabels[j], j) += a.Alpha(i);
+  }
+
+  for (size_t j = 0; j < inputData.n_cols; ++j)
+  {
+    arma::uword maxIndex = 0;
+    votes.col(j).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels[j], maxIndex);
+  }
+
+  // A subsample ratio outside of (0, 1] is not accepted.
+  BOOST_REQUIRE_THROW(a.Train(inputData, labels.row(0), numClasses, ds, 50,
+      1e-10, 0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(a.Train(inputData, labels.row(0), numClasses, ds, 50,
+      1e-10, 1.5), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
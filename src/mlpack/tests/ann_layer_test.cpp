@@ -17,6 +17,8 @@
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
 #include <mlpack/methods/ann/init_rules/const_init.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
+#include <mlpack/methods/ann/init_rules/he_init.hpp>
+#include <mlpack/methods/ann/init_rules/glorot_init.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 #include <mlpack/methods/ann/rnn.hpp>
 
@@ -1037,6 +1039,53 @@ BOOST_AUTO_TEST_CASE(SimpleConcatLayerTest)
   BOOST_REQUIRE_EQUAL(arma::accu(delta), 0);
 }
 
+/**
+ * Make sure that after the first pass the modules of the Concat layer write
+ * their outputs in place, and that the results don't change.
+ */
+BOOST_AUTO_TEST_CASE(ConcatInPlaceTest)
+{
+  Concat<> module(true, false);
+  module.Add<Linear<> >(10, 3);
+  module.Add<Linear<> >(10, 5);
+
+  Linear<>* moduleA = boost::get<Linear<>*>(module.Model()[0]);
+  moduleA->Parameters().randu();
+  moduleA->Reset();
+  Linear<>* moduleB = boost::get<Linear<>*>(module.Model()[1]);
+  moduleB->Parameters().randu();
+  moduleB->Reset();
+
+  arma::mat input(10, 1, arma::fill::randu), output, error, delta;
+  const arma::mat outputA = moduleA->Parameters().submat(0, 0, 29, 0);
+  for (size_t pass = 0; pass < 3; ++pass)
+  {
+    module.Forward(std::move(input), std::move(output));
+
+    BOOST_REQUIRE_EQUAL(output.n_rows, 5);
+    BOOST_REQUIRE_EQUAL(output.n_cols, 2);
+    BOOST_REQUIRE(moduleA->OutputParameter().memptr() == output.colptr(0));
+    BOOST_REQUIRE(moduleB->OutputParameter().memptr() == output.colptr(1));
+
+    arma::mat expectedA = arma::reshape(outputA, 3, 10) * input +
+        moduleA->Parameters().submat(30, 0, 32, 0);
+    for (size_t r = 0; r < 3; ++r)
+      BOOST_REQUIRE_CLOSE(output(r, 0), expectedA(r), 1e-5);
+    BOOST_REQUIRE_SMALL(output(3, 0), 1e-10);
+    BOOST_REQUIRE_SMALL(output(4, 0), 1e-10);
+
+    // The error of each module is its column of the error.
+    error.randu(5, 2);
+    module.Backward(std::move(input), std::move(error), std::move(delta));
+
+    BOOST_REQUIRE_EQUAL(delta.n_rows, 10);
+    BOOST_REQUIRE_EQUAL(delta.n_cols, 2);
+    arma::mat expectedDelta = arma::reshape(outputA, 3, 10).t() *
+        error.submat(0, 0, 2, 0);
+    CheckMatrices(delta.col(0), expectedDelta);
+  }
+}
+
 /**
  * Concat layer numerical gradient test.
  */
@@ -1196,6 +1245,133 @@ BOOST_AUTO_TEST_CASE(SimpleLookupLayerTest)
   BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
 }
 
+/**
+ * Make sure the Lookup gradient sums the error of repeated columns, and that
+ * a sparse update only changes the looked-up columns.
+ */
+BOOST_AUTO_TEST_CASE(LookupSparseGradientTest)
+{
+  arma::mat input("2; 5; 2"), error, gradient, output;
+  error.randu(4, 3);
+
+  Lookup<> module(6, 4);
+  module.Parameters().randu();
+  module.Forward(std::move(input), std::move(output));
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  BOOST_REQUIRE_EQUAL(module.SparseColumns().n_elem, 2);
+  BOOST_REQUIRE_EQUAL(module.SparseColumns()[0], 1);
+  BOOST_REQUIRE_EQUAL(module.SparseColumns()[1], 4);
+
+  arma::mat expected(4, 6, arma::fill::zeros);
+  expected.col(1) = error.col(0) + error.col(2);
+  expected.col(4) = error.col(1);
+  CheckMatrices(gradient, expected);
+  CheckMatrices(module.SparseGradient(), expected.cols(arma::uvec("1 4")));
+
+  // With SGD, the update is the same as a dense SGD step.
+  Lookup<> sgdModule(6, 4, SparseRowUpdate<>(0.1));
+  sgdModule.Parameters().randu();
+  const arma::mat sgdWeights = sgdModule.Parameters();
+  arma::mat sgdGradient;
+  sgdModule.Gradient(std::move(input), std::move(error),
+      std::move(sgdGradient));
+
+  CheckMatrices(sgdModule.Parameters(), sgdWeights - 0.1 * expected);
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(sgdGradient)), 1e-10);
+
+  // With lazy Adam, the first step of each looked-up parameter is the step
+  // size times the sign of its gradient, and the other columns don't change.
+  Lookup<> adamModule(6, 4, SparseRowUpdate<>(0.01, true));
+  adamModule.Parameters().randu();
+  const arma::mat adamWeights = adamModule.Parameters();
+  arma::mat adamGradient;
+  adamModule.Gradient(std::move(input), std::move(error),
+      std::move(adamGradient));
+
+  for (size_t c = 0; c < 6; ++c)
+  {
+    for (size_t r = 0; r < 4; ++r)
+    {
+      const double change = adamModule.Parameters()(r, c) - adamWeights(r, c);
+      if (c == 1 || c == 4)
+        BOOST_REQUIRE_CLOSE(change, -0.01, 0.1);
+      else
+        BOOST_REQUIRE_SMALL(change, 1e-10);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(adamModule.Update().Iteration(), 1);
+}
+
+/**
+ * Make sure that pooling a batch of multi-channel inputs gives the same
+ * results as pooling each point and each channel alone, and check the
+ * gradients of the pooling layers.
+ */
+BOOST_AUTO_TEST_CASE(BatchedPoolingTest)
+{
+  // Two points with three 5 x 4 channels.
+  arma::mat input(60, 2, arma::fill::randu);
+
+  MaxPooling<> maxPooling(2, 2, 2, 2);
+  maxPooling.InputWidth() = 5;
+  maxPooling.InputHeight() = 4;
+  MeanPooling<> meanPooling(3, 2, 2, 2);
+  meanPooling.InputWidth() = 5;
+  meanPooling.InputHeight() = 4;
+
+  arma::mat maxOutput, meanOutput;
+  maxPooling.Forward(std::move(input), std::move(maxOutput));
+  meanPooling.Forward(std::move(input), std::move(meanOutput));
+  BOOST_REQUIRE_EQUAL(maxOutput.n_rows, 2 * 2 * 3);
+  BOOST_REQUIRE_EQUAL(maxOutput.n_cols, 2);
+  BOOST_REQUIRE_EQUAL(meanOutput.n_rows, 2 * 2 * 3);
+
+  for (size_t p = 0; p < 2; ++p)
+  {
+    for (size_t s = 0; s < 3; ++s)
+    {
+      arma::mat slice = arma::reshape(input.col(p).subvec(20 * s,
+          20 * s + 19), 5, 4);
+      for (size_t j = 0; j < 2; ++j)
+      {
+        for (size_t i = 0; i < 2; ++i)
+        {
+          const double expectedMax = slice.submat(2 * i, 2 * j, 2 * i + 1,
+              2 * j + 1).max();
+          const double expectedMean = arma::accu(slice.submat(2 * i, 2 * j,
+              2 * i + 2, 2 * j + 1)) / 6.0;
+          BOOST_REQUIRE_CLOSE(maxOutput(4 * s + i + 2 * j, p), expectedMax,
+              1e-5);
+          BOOST_REQUIRE_CLOSE(meanOutput(4 * s + i + 2 * j, p), expectedMean,
+              1e-5);
+        }
+      }
+    }
+  }
+
+  // The error of each window goes back to its maximum.
+  arma::mat error(maxOutput.n_rows, 2, arma::fill::randu), delta;
+  maxPooling.Backward(std::move(input), std::move(error), std::move(delta));
+  BOOST_REQUIRE_EQUAL(delta.n_rows, 60);
+  BOOST_REQUIRE_CLOSE(arma::accu(delta), arma::accu(error), 1e-5);
+  for (size_t k = 0; k < delta.n_elem; ++k)
+    if (delta[k] != 0.0)
+      BOOST_REQUIRE(arma::any(arma::vectorise(maxOutput) == input[k]));
+
+  // Check the Jacobians on one point.
+  arma::mat point(60, 1);
+  MaxPooling<> maxModule(2, 2, 2, 2);
+  maxModule.InputWidth() = 5;
+  maxModule.InputHeight() = 4;
+  BOOST_REQUIRE_LE(JacobianTest(maxModule, point), 1e-5);
+
+  MeanPooling<> meanModule(3, 2, 2, 2);
+  meanModule.InputWidth() = 5;
+  meanModule.InputHeight() = 4;
+  BOOST_REQUIRE_LE(JacobianTest(meanModule, point), 1e-5);
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -1307,6 +1483,34 @@ BOOST_AUTO_TEST_CASE(BatchNormTest)
   CheckMatrices(output, result, 1e-1);
 }
 
+/**
+ * Make sure that the statistics of the training data that the BatchNorm layer
+ * accumulates over several batches are the mean and variance of all points,
+ * and that the forward pass normalizes each batch with its own statistics.
+ */
+BOOST_AUTO_TEST_CASE(BatchNormRunningStatisticsTest)
+{
+  arma::mat first = arma::randn(5, 7) * 3 + 2;
+  arma::mat second = arma::randn(5, 12) - 1;
+  arma::mat output;
+
+  BatchNorm<> model(5);
+  model.Reset();
+  model.Deterministic() = false;
+
+  model.Forward(std::move(first), std::move(output));
+  arma::mat expected = first.each_col() - arma::mean(first, 1);
+  expected.each_col() /= arma::sqrt(arma::var(first, 1, 1) + 1e-8);
+  CheckMatrices(output, expected, 1e-4);
+
+  model.Forward(std::move(second), std::move(output));
+
+  const arma::mat all = arma::join_rows(first, second);
+  CheckMatrices(model.TrainingMean(), arma::mat(arma::mean(all, 1)), 1e-4);
+  CheckMatrices(model.TrainingVariance(), arma::mat(arma::var(all, 1, 1)),
+      1e-4);
+}
+
 /**
  * BatchNorm layer numerical gradient test.
  */
@@ -2183,4 +2387,95 @@ BOOST_AUTO_TEST_CASE(LayerNormSerializationTest)
   ANNLayerSerializationTest(layer);
 }
 
+/**
+ * Make sure that the Linear, LogSoftMax and Convolution layers, the negative
+ * log likelihood and the initialization rules work with single precision, and
+ * give the same results as with double precision.
+ */
+BOOST_AUTO_TEST_CASE(SinglePrecisionLayerTest)
+{
+  arma::mat input = arma::randu(10, 4);
+  arma::fmat fInput = arma::conv_to<arma::fmat>::from(input);
+  arma::mat target("1 3 2 5");
+  arma::fmat fTarget = arma::conv_to<arma::fmat>::from(target);
+
+  Linear<> linear(10, 5);
+  Linear<arma::fmat, arma::fmat> fLinear(10, 5);
+  GlorotInitialization().Initialize(linear.Parameters(), 55, 1);
+  fLinear.Parameters() = arma::conv_to<arma::fmat>::from(linear.Parameters());
+  linear.Reset();
+  fLinear.Reset();
+
+  LogSoftMax<> logSoftMax;
+  LogSoftMax<arma::fmat, arma::fmat> fLogSoftMax;
+  NegativeLogLikelihood<> nll;
+  NegativeLogLikelihood<arma::fmat, arma::fmat> fNll;
+
+  // Forward pass.
+  arma::mat hidden, output;
+  arma::fmat fHidden, fOutput;
+  linear.Forward(std::move(input), std::move(hidden));
+  fLinear.Forward(std::move(fInput), std::move(fHidden));
+  logSoftMax.Forward(std::move(hidden), std::move(output));
+  fLogSoftMax.Forward(std::move(fHidden), std::move(fOutput));
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(fOutput), 1e-2);
+
+  const double loss = nll.Forward(std::move(output), std::move(target));
+  const double fLoss = fNll.Forward(std::move(fOutput), std::move(fTarget));
+  BOOST_REQUIRE_CLOSE(loss, fLoss, 1e-3);
+
+  // Backward pass and gradient.
+  arma::mat error, delta, backward;
+  arma::fmat fError, fDelta, fBackward;
+  nll.Backward(std::move(output), std::move(target), std::move(error));
+  fNll.Backward(std::move(fOutput), std::move(fTarget), std::move(fError));
+  logSoftMax.Backward(std::move(output), std::move(error), std::move(delta));
+  fLogSoftMax.Backward(std::move(fOutput), std::move(fError),
+      std::move(fDelta));
+  linear.Backward(std::move(hidden), std::move(delta), std::move(backward));
+  fLinear.Backward(std::move(fHidden), std::move(fDelta),
+      std::move(fBackward));
+  CheckMatrices(backward, arma::conv_to<arma::mat>::from(fBackward), 1e-2);
+
+  arma::mat gradient(55, 1);
+  arma::fmat fGradient(55, 1);
+  linear.Gradient(std::move(input), std::move(delta), std::move(gradient));
+  fLinear.Gradient(std::move(fInput), std::move(fDelta), std::move(fGradient));
+  CheckMatrices(gradient, arma::conv_to<arma::mat>::from(fGradient), 1e-2);
+
+  // Now the same with a convolution.
+  arma::mat image = arma::randu(25, 2);
+  arma::fmat fImage = arma::conv_to<arma::fmat>::from(image);
+
+  Convolution<> conv(1, 2, 3, 3, 1, 1, 0, 0, 5, 5);
+  Convolution<Im2ColConvolution<ValidConvolution>,
+              Im2ColConvolution<FullConvolution>,
+              Im2ColConvolution<ValidConvolution>,
+              arma::fmat, arma::fmat> fConv(1, 2, 3, 3, 1, 1, 0, 0, 5, 5);
+  HeInitialization().Initialize(conv.Parameters(), 20, 1);
+  fConv.Parameters() = arma::conv_to<arma::fmat>::from(conv.Parameters());
+  conv.Reset();
+  fConv.Reset();
+
+  arma::mat convOutput, convBackward, convGradient;
+  arma::fmat fConvOutput, fConvBackward, fConvGradient;
+  conv.Forward(std::move(image), std::move(convOutput));
+  fConv.Forward(std::move(fImage), std::move(fConvOutput));
+  CheckMatrices(convOutput, arma::conv_to<arma::mat>::from(fConvOutput), 1e-2);
+
+  conv.Backward(std::move(image), std::move(convOutput),
+      std::move(convBackward));
+  fConv.Backward(std::move(fImage), std::move(fConvOutput),
+      std::move(fConvBackward));
+  CheckMatrices(convBackward, arma::conv_to<arma::mat>::from(fConvBackward),
+      1e-2);
+
+  conv.Gradient(std::move(image), std::move(convOutput),
+      std::move(convGradient));
+  fConv.Gradient(std::move(fImage), std::move(fConvOutput),
+      std::move(fConvGradient));
+  CheckMatrices(convGradient, arma::conv_to<arma::mat>::from(fConvGradient),
+      1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
 #include <mlpack/methods/block_krylov_svd/randomized_block_krylov_svd.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -109,4 +110,42 @@ BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDNoisyLowRankTest)
   BOOST_REQUIRE_SMALL(error, 1e-2);
 }
 
+/**
+ * The randomized block krylov SVD of a dataset read a batch at a time, in
+ * double and single precision, should be close to the exact SVD.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDApplyBlocksTest)
+{
+  arma::mat data;
+  CreateNoisyLowRankMatrix(data, 100, 500, 5, 0.5);
+
+  const size_t rank = 5;
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+  arma::svd_econ(U1, s1, V1, data);
+
+  {
+    data::BatchWriter writer("test_bksvd_blocks.mmat", 100, 500);
+    writer.Write(data);
+    writer.Close();
+  }
+
+  data::BatchReader reader("test_bksvd_blocks.mmat");
+  svd::RandomizedBlockKrylovSVD rSVDB(10, 20);
+  rSVDB.ApplyBlocks(reader, U2, s2, V2, rank, 64);
+
+  BOOST_REQUIRE_EQUAL(U2.n_rows, 100);
+  BOOST_REQUIRE_EQUAL(V2.n_rows, 500);
+
+  double error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
+  BOOST_REQUIRE_SMALL(error, 1e-2);
+
+  rSVDB.ApplyBlocks<float>(reader, U2, s2, V2, rank, 64);
+  remove("test_bksvd_blocks.mmat");
+
+  error = arma::max(arma::abs(s1.subvec(0, rank) - s2.subvec(0, rank)));
+  BOOST_REQUIRE_SMALL(error, 1e-2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -32,6 +32,8 @@
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/similarity_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/regression_interpolation.hpp>
+#include <mlpack/methods/cf/item_search_policies/fastmks_item_search.hpp>
+#include <mlpack/methods/cf/item_search_policies/lsh_item_search.hpp>
 
 #include <iostream>
 
@@ -509,6 +511,175 @@ void Serialization()
   }
 }
 
+/**
+ * Make sure that the batched weighted ratings of the decomposition policy and
+ * the recommendations match the ratings computed one user at a time.
+ */
+template<typename DecompositionPolicy>
+void WeightedRatingsRecommendations()
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  DecompositionPolicy decomposition;
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+  const size_t numItems = c.CleanedData().n_rows;
+
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0, 19, 20);
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  c.Decomposition().template GetNeighborhood<EuclideanSearch>(users, 5,
+      neighborhood, similarities);
+
+  arma::mat weights(neighborhood.n_rows, neighborhood.n_cols,
+      arma::fill::randu);
+  arma::mat ratings;
+  c.Decomposition().GetWeightedRatings(neighborhood, weights, ratings);
+  BOOST_REQUIRE_EQUAL(ratings.n_rows, numItems);
+  BOOST_REQUIRE_EQUAL(ratings.n_cols, users.n_elem);
+
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::vec expected(numItems, arma::fill::zeros);
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      arma::vec neighborRatings;
+      c.Decomposition().GetRatingOfUser(neighborhood(j, i), neighborRatings);
+      expected += weights(j, i) * neighborRatings;
+    }
+
+    for (size_t j = 0; j < numItems; ++j)
+      BOOST_REQUIRE_CLOSE(ratings(j, i), expected[j], 1e-5);
+  }
+
+  // Now check the recommendations, with the default AverageInterpolation.
+  // When rated items are included, they are the best items of the ratings.
+  const size_t numRecs = 5;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations, users, false);
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, users.n_elem);
+
+  weights.fill(1.0 / neighborhood.n_rows);
+  c.Decomposition().GetWeightedRatings(neighborhood, weights, ratings);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::uvec order = arma::sort_index(ratings.col(i), "descend");
+    for (size_t p = 0; p < numRecs; ++p)
+      BOOST_REQUIRE_EQUAL(recommendations(p, i), order[p]);
+  }
+
+  // Rated items are never recommended by default.
+  c.GetRecommendations(numRecs, recommendations, users);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t p = 0; p < numRecs; ++p)
+    {
+      BOOST_REQUIRE_LT(recommendations(p, i), numItems);
+      BOOST_REQUIRE_EQUAL(c.CleanedData()(recommendations(p, i), users[i]),
+          0.0);
+    }
+  }
+}
+
+/**
+ * Make sure that the recommendations found with FastMKSItemSearch are the same
+ * as the ones found by rating all of the items, and that the ones found with
+ * LSHItemSearch are valid.
+ */
+template<typename DecompositionPolicy>
+void ItemSearchRecommendations()
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  DecompositionPolicy decomposition;
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+  const size_t numItems = c.CleanedData().n_rows;
+
+  const size_t numRecs = 5;
+  arma::Col<size_t> users = arma::linspace<arma::Col<size_t> >(0, 49, 50);
+  arma::Mat<size_t> recommendations, fastmksRecommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+
+  // The index is built once, and used for both calls.
+  FastMKSItemSearch fastmksSearch;
+  c.GetRecommendations(fastmksSearch, numRecs, fastmksRecommendations, users);
+  BOOST_REQUIRE(fastmksSearch.Trained());
+  CheckMatrices(fastmksRecommendations, recommendations);
+
+  c.GetRecommendations(fastmksSearch, numRecs, fastmksRecommendations,
+      users.subvec(10, 19));
+  CheckMatrices(fastmksRecommendations, recommendations.cols(10, 19));
+
+  LSHItemSearch lshSearch(5, 20);
+  arma::Mat<size_t> lshRecommendations;
+  c.GetRecommendations(lshSearch, numRecs, lshRecommendations, users);
+  BOOST_REQUIRE_EQUAL(lshRecommendations.n_rows, numRecs);
+  BOOST_REQUIRE_EQUAL(lshRecommendations.n_cols, users.n_elem);
+  for (size_t i = 0; i < lshRecommendations.n_elem; ++i)
+  {
+    // LSH may not find enough items for some users.
+    if (lshRecommendations[i] == numItems)
+      continue;
+
+    BOOST_REQUIRE_LT(lshRecommendations[i], numItems);
+    BOOST_REQUIRE_EQUAL(c.CleanedData()(lshRecommendations[i],
+        users[i / numRecs]), 0.0);
+  }
+}
+
+/**
+ * Train on all the users but the last one, fold in half of the ratings of the
+ * last user, and make sure its other ratings are predicted reasonably well.
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = OverallMeanNormalization>
+void FoldInUsersPredict(const double rmseBound = 2.0)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  const size_t newUser = (size_t) arma::max(dataset.row(0));
+  const arma::uvec trainCols = arma::find(dataset.row(0) != newUser);
+  const arma::mat trainData = dataset.cols(trainCols);
+
+  DecompositionPolicy decomposition;
+  CFType<DecompositionPolicy, NormalizationType> c(trainData, decomposition,
+      5, 5, 30);
+  const size_t numItems = c.CleanedData().n_rows;
+
+  // Only the items that are in the model can be folded in.
+  const arma::uvec userCols = arma::find((dataset.row(0) == newUser) %
+      (dataset.row(1) < numItems));
+  const arma::mat userData = dataset.cols(userCols);
+  BOOST_REQUIRE_GT(userData.n_cols, 10);
+
+  const size_t half = userData.n_cols / 2;
+  c.FoldInUsers(userData.head_cols(half));
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, newUser + 1);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, newUser + 1);
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_nonzero, trainData.n_cols + half);
+
+  double totalError = 0.0;
+  for (size_t i = half; i < userData.n_cols; ++i)
+  {
+    const double prediction = c.Predict(newUser, userData(1, i));
+    totalError += std::pow(prediction - userData(2, i), 2.0);
+  }
+
+  const double rmse = std::sqrt(totalError / (userData.n_cols - half));
+  BOOST_REQUIRE_LT(rmse, rmseBound);
+
+  // Items that are not in the model can't be folded in with the users.
+  arma::mat badData(3, 1);
+  badData(0, 0) = newUser;
+  badData(1, 0) = numItems;
+  badData(2, 0) = 3.0;
+  BOOST_REQUIRE_THROW(c.FoldInUsers(badData), std::invalid_argument);
+}
+
 /**
  * Make sure that correct number of recommendations are generated when query
  * set for randomized SVD.
@@ -1228,4 +1399,201 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>(2.0);
 }
 
+/**
+ * Make sure that the batched ratings and recommendations are right for NMF.
+ */
+BOOST_AUTO_TEST_CASE(CFWeightedRatingsNMFTest)
+{
+  WeightedRatingsRecommendations<NMFPolicy>();
+}
+
+/**
+ * Make sure that the batched ratings and recommendations are right for Bias
+ * SVD, which adds the biases of the users and items.
+ */
+BOOST_AUTO_TEST_CASE(CFWeightedRatingsBiasSVDTest)
+{
+  WeightedRatingsRecommendations<BiasSVDPolicy>();
+}
+
+/**
+ * Make sure that the batched ratings and recommendations are right for
+ * SVDPlusPlus, which adds the implicit feedback of the users.
+ */
+BOOST_AUTO_TEST_CASE(CFWeightedRatingsSVDPPTest)
+{
+  WeightedRatingsRecommendations<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure that recommendations with an item index are right for NMF.
+ */
+BOOST_AUTO_TEST_CASE(CFItemSearchNMFTest)
+{
+  ItemSearchRecommendations<NMFPolicy>();
+}
+
+/**
+ * Make sure that recommendations with an item index are right for Bias SVD,
+ * whose item vectors include the item biases.
+ */
+BOOST_AUTO_TEST_CASE(CFItemSearchBiasSVDTest)
+{
+  ItemSearchRecommendations<BiasSVDPolicy>();
+}
+
+/**
+ * Make sure that a user folded into a Regularized SVD model gets reasonable
+ * predictions.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInUsersRegSVDTest)
+{
+  FoldInUsersPredict<RegSVDPolicy>();
+}
+
+/**
+ * Make sure that a user folded into a Bias SVD model with user mean
+ * normalization gets reasonable predictions.
+ */
+BOOST_AUTO_TEST_CASE(CFFoldInUsersBiasSVDTest)
+{
+  FoldInUsersPredict<BiasSVDPolicy, UserMeanNormalization>();
+}
+
+/**
+ * Make sure that the batch GetWeights() of an interpolation policy gives the
+ * same weights as the single-user one, and that the batch Predict() agrees with
+ * the single-combination one.
+ */
+template<typename InterpolationPolicy>
+void BatchInterpolation()
+{
+  arma::mat dataset, savedCols;
+  GetDatasets(dataset, savedCols);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 10);
+
+  const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 49,
+      50);
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  c.Decomposition().template GetNeighborhood<EuclideanSearch>(users, 5,
+      neighborhood, similarities);
+
+  arma::mat weights;
+  InterpolationPolicy batchInterpolation(c.CleanedData());
+  batchInterpolation.GetWeights(weights, c.Decomposition(), users,
+      neighborhood, similarities, c.CleanedData());
+  BOOST_REQUIRE_EQUAL(weights.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, 50);
+
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    InterpolationPolicy interpolation(c.CleanedData());
+    arma::vec userWeights(5);
+    interpolation.GetWeights(userWeights, c.Decomposition(), users(i),
+        neighborhood.col(i), similarities.col(i), c.CleanedData());
+
+    for (size_t j = 0; j < 5; ++j)
+      BOOST_REQUIRE_SMALL(userWeights(j) - weights(j, i), 1e-8);
+  }
+
+  arma::Mat<size_t> combinations(2, savedCols.n_cols);
+  for (size_t i = 0; i < savedCols.n_cols; ++i)
+  {
+    combinations(0, i) = size_t(savedCols(0, i));
+    combinations(1, i) = size_t(savedCols(1, i));
+  }
+
+  arma::vec predictions;
+  c.template Predict<EuclideanSearch, InterpolationPolicy>(combinations,
+      predictions);
+  for (size_t i = 0; i < combinations.n_cols; ++i)
+  {
+    const double prediction = c.template Predict<EuclideanSearch,
+        InterpolationPolicy>(combinations(0, i), combinations(1, i));
+    BOOST_REQUIRE_CLOSE(prediction, predictions[i], 1e-8);
+  }
+}
+
+/**
+ * Make sure the batch weights of AverageInterpolation are right.
+ */
+BOOST_AUTO_TEST_CASE(CFBatchAverageInterpolationTest)
+{
+  BatchInterpolation<AverageInterpolation>();
+}
+
+/**
+ * Make sure the batch weights of SimilarityInterpolation are right.
+ */
+BOOST_AUTO_TEST_CASE(CFBatchSimilarityInterpolationTest)
+{
+  BatchInterpolation<SimilarityInterpolation>();
+}
+
+/**
+ * Make sure the batch weights of RegressionInterpolation are right.
+ */
+BOOST_AUTO_TEST_CASE(CFBatchRegressionInterpolationTest)
+{
+  BatchInterpolation<RegressionInterpolation>();
+}
+
+/**
+ * Make sure that RegressionInterpolation solves the linear system of Bell and
+ * Koren, computed directly from the predicted ratings of the neighbors.
+ */
+BOOST_AUTO_TEST_CASE(CFRegressionInterpolationSystemTest)
+{
+  arma::mat dataset, savedCols;
+  GetDatasets(dataset, savedCols);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 10);
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  const arma::mat& w = c.Decomposition().W();
+  const arma::mat& h = c.Decomposition().H();
+
+  const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 9,
+      10);
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  c.Decomposition().template GetNeighborhood<EuclideanSearch>(users, 5,
+      neighborhood, similarities);
+
+  arma::mat weights;
+  RegressionInterpolation interpolation(cleanedData);
+  interpolation.GetWeights(weights, c.Decomposition(), users, neighborhood,
+      similarities, cleanedData);
+
+  for (size_t u = 0; u < users.n_elem; ++u)
+  {
+    const arma::vec userRating(cleanedData.col(users(u)));
+    const size_t support = arma::accu(userRating != 0);
+    if (support == 0)
+      continue;
+
+    arma::mat coeff(5, 5);
+    arma::vec constant(5);
+    for (size_t i = 0; i < 5; ++i)
+    {
+      const arma::vec iPrediction = w * h.col(neighborhood(i, u));
+      for (size_t j = 0; j < 5; ++j)
+      {
+        const arma::vec jPrediction = w * h.col(neighborhood(j, u));
+        coeff(i, j) = arma::dot(iPrediction, jPrediction) / cleanedData.n_rows;
+      }
+      constant(i) = arma::dot(iPrediction, userRating) / support;
+    }
+
+    // The weights must solve the system, up to rounding errors.
+    const arma::vec userWeights = weights.col(u);
+    const double residual = arma::norm(coeff * userWeights - constant, 2);
+    BOOST_REQUIRE_LE(residual, 1e-8 * (arma::norm(coeff, 2) *
+        arma::norm(userWeights, 2) + arma::norm(constant, 2)));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -27,6 +27,7 @@ static const std::string testName = "";
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1125,4 +1126,87 @@ BOOST_AUTO_TEST_CASE(CppNameTest)
   BOOST_REQUIRE_EQUAL(CLI::Parameters().at("double").cppType, "double");
 }
 
+// The state of the program run by ServeTest.
+static double serveTestTotal = 0.0;
+static std::vector<GaussianKernel*> serveTestKernels;
+
+//! Add the value to the total, and remember which kernel was used.
+static void ServeTestProgram()
+{
+  if (CLI::GetParam<int>("value") < 0)
+    Log::Fatal << "The value must not be negative!" << endl;
+
+  GaussianKernel* kernel = CLI::GetParam<GaussianKernel*>("kernel");
+  serveTestTotal += CLI::GetParam<int>("value") * kernel->Bandwidth();
+  serveTestKernels.push_back(kernel);
+}
+
+/**
+ * Make sure that the server runs the program for each request, starting from
+ * the parameters of the command line each time, that the models of the command
+ * line are only loaded once, and that a failed request doesn't stop it.
+ */
+BOOST_AUTO_TEST_CASE(ServeTest)
+{
+  AddRequiredCLIOptions();
+
+  GaussianKernel saved(0.5);
+  data::Save("kernel.txt", "model", saved);
+
+  PARAM_MODEL_IN(GaussianKernel, "kernel", "Test kernel", "k");
+  PARAM_INT_IN("value", "Test value", "", 2);
+
+  const char* argv[3];
+  argv[0] = "./test";
+  argv[1] = "--kernel_file";
+  argv[2] = "kernel.txt";
+
+  int argc = 3;
+
+  ParseCommandLine(argc, const_cast<char**>(argv));
+
+  std::istringstream in("--value 4\n"
+                        "\n"
+                        "--value 6\n"
+                        "--value=-1\n"
+                        "--unknown_option 3\n"
+                        "--help\n"
+                        "--value \"2\n"
+                        "--value 8\n"
+                        "exit\n"
+                        "--value 100\n");
+  std::ostringstream out;
+
+  Log::Fatal.ignoreInput = true;
+  Serve(ServeTestProgram, in, out);
+  Log::Fatal.ignoreInput = false;
+
+  // The empty line is skipped, and so is everything after "exit".
+  std::istringstream responses(out.str());
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(responses, line))
+    lines.push_back(line);
+
+  BOOST_REQUIRE_EQUAL(lines.size(), 7);
+  BOOST_REQUIRE_EQUAL(lines[0], "ok");
+  BOOST_REQUIRE_EQUAL(lines[1], "ok");
+  for (size_t i = 2; i < 6; ++i)
+    BOOST_REQUIRE_EQUAL(lines[i].compare(0, 7, "error: "), 0);
+  BOOST_REQUIRE_EQUAL(lines[6], "ok");
+
+  BOOST_REQUIRE_CLOSE(serveTestTotal, (4 + 6 + 8) * 0.5, 1e-5);
+  BOOST_REQUIRE_EQUAL(serveTestKernels.size(), 3);
+  BOOST_REQUIRE_EQUAL(serveTestKernels[0], serveTestKernels[1]);
+  BOOST_REQUIRE_EQUAL(serveTestKernels[0], serveTestKernels[2]);
+
+  // The parameters are those of the command line again.
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<int>("value"), 2);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<GaussianKernel*>("kernel"),
+      serveTestKernels[0]);
+
+  delete CLI::GetParam<GaussianKernel*>("kernel");
+  remove("kernel.txt");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,6 +16,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -141,6 +142,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   Convolution2DMethodTest<NaiveConvolution<ValidConvolution> >(input, filter,
       output);
 
+  // Perform the im2col convolution approach.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
+
   // Perform the convolution trough fft.
   Convolution2DMethodTest<FFTConvolution<ValidConvolution> >(input, filter,
       output);
@@ -178,6 +183,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   Convolution2DMethodTest<NaiveConvolution<FullConvolution> >(input, filter,
       output);
 
+  // Perform the im2col convolution approach.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
+
   // Perform the convolution trough fft.
   Convolution2DMethodTest<FFTConvolution<FullConvolution> >(input, filter,
       output);
@@ -223,6 +232,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution3DTest)
   Convolution3DMethodTest<NaiveConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
 
+  // Perform the im2col convolution approach.
+  Convolution3DMethodTest<Im2ColConvolution<ValidConvolution> >(inputCube,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   Convolution3DMethodTest<FFTConvolution<ValidConvolution> >(inputCube,
       filterCube, outputCube);
@@ -272,6 +285,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution3DTest)
   Convolution3DMethodTest<NaiveConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
 
+  // Perform the im2col convolution approach.
+  Convolution3DMethodTest<Im2ColConvolution<FullConvolution> >(inputCube,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   Convolution3DMethodTest<FFTConvolution<FullConvolution> >(inputCube,
       filterCube, outputCube);
@@ -314,6 +331,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolutionBatchTest)
   ConvolutionMethodBatchTest<NaiveConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
 
+  // Perform the im2col convolution approach.
+  ConvolutionMethodBatchTest<Im2ColConvolution<ValidConvolution> >(input,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   ConvolutionMethodBatchTest<FFTConvolution<ValidConvolution> >(input,
       filterCube, outputCube);
@@ -360,6 +381,10 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
   ConvolutionMethodBatchTest<NaiveConvolution<FullConvolution> >(input,
       filterCube, outputCube);
 
+  // Perform the im2col convolution approach.
+  ConvolutionMethodBatchTest<Im2ColConvolution<FullConvolution> >(input,
+      filterCube, outputCube);
+
   // Perform the convolution trough fft.
   ConvolutionMethodBatchTest<FFTConvolution<FullConvolution> >(input,
       filterCube, outputCube);
@@ -370,4 +395,44 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
       filterCube, outputCube);
 }
 
+/**
+ * Make sure the im2col convolution gives the same results as the naive
+ * convolution with strides and dilation, and when one input is convolved with
+ * several filters at once.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionStrideDilationTest)
+{
+  arma::mat input(11, 11, arma::fill::randu);
+  arma::mat filter(3, 3, arma::fill::randn);
+  arma::cube filters(3, 3, 4, arma::fill::randn);
+
+  for (size_t stride = 1; stride <= 2; ++stride)
+  {
+    for (size_t dilation = 1; dilation <= 2; ++dilation)
+    {
+      arma::mat naiveOutput, im2colOutput;
+      NaiveConvolution<ValidConvolution>::Convolution(input, filter,
+          naiveOutput, stride, stride, dilation, dilation);
+      Im2ColConvolution<ValidConvolution>::Convolution(input, filter,
+          im2colOutput, stride, stride, dilation, dilation);
+      CheckMatrices(naiveOutput, im2colOutput);
+
+      NaiveConvolution<FullConvolution>::Convolution(input, filter,
+          naiveOutput, stride, stride, dilation, dilation);
+      Im2ColConvolution<FullConvolution>::Convolution(input, filter,
+          im2colOutput, stride, stride, dilation, dilation);
+      CheckMatrices(naiveOutput, im2colOutput);
+
+      arma::cube naiveCube, im2colCube;
+      NaiveConvolution<ValidConvolution>::Convolution(input, filters,
+          naiveCube, stride, stride, dilation, dilation);
+      Im2ColConvolution<ValidConvolution>::Convolution(input, filters,
+          im2colCube, stride, stride, dilation, dilation);
+      BOOST_REQUIRE_EQUAL(naiveCube.n_slices, im2colCube.n_slices);
+      for (size_t i = 0; i < naiveCube.n_slices; ++i)
+        CheckMatrices(naiveCube.slice(i), im2colCube.slice(i));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
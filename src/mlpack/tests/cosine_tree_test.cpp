@@ -222,4 +222,81 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * Checks the block version of CosineTree::ModifiedGramSchmidt() on nearly
+ * parallel centroids, for which a single pass of Gram-Schmidt loses
+ * orthogonality, and with an additional basis vector.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeBlockGramSchmidt)
+{
+  const size_t numRows = 30;
+  const size_t numCols = 20;
+
+  arma::mat data = arma::randu(numRows, numCols);
+  CosineTree dummyTree(data, 1, 0.1);
+
+  // All the centroids are close to the first one.
+  const arma::vec direction = arma::randu(numRows);
+  arma::mat basis(numRows, 0);
+  for (size_t i = 0; i < numCols; i++)
+  {
+    arma::vec centroid = direction + 1e-6 * arma::randu(numRows);
+    arma::vec newBasisVector;
+    dummyTree.ModifiedGramSchmidt(basis, centroid, newBasisVector);
+
+    BOOST_REQUIRE_CLOSE(arma::norm(newBasisVector, 2), 1.0, 1e-5);
+    for (size_t j = 0; j < basis.n_cols; j++)
+      BOOST_REQUIRE_SMALL(arma::dot(basis.col(j), newBasisVector), 1e-10);
+
+    basis.insert_cols(basis.n_cols, newBasisVector);
+  }
+
+  // The additional basis vector is taken into account too.
+  arma::vec addCentroid = arma::randu(numRows);
+  arma::vec addBasisVector;
+  dummyTree.ModifiedGramSchmidt(basis, addCentroid, addBasisVector);
+  arma::vec newBasisVector;
+  dummyTree.ModifiedGramSchmidt(basis, arma::vec(arma::randu(numRows)),
+      newBasisVector, &addBasisVector);
+
+  BOOST_REQUIRE_SMALL(arma::dot(addBasisVector, newBasisVector), 1e-10);
+  for (size_t j = 0; j < basis.n_cols; j++)
+    BOOST_REQUIRE_SMALL(arma::dot(basis.col(j), newBasisVector), 1e-10);
+}
+
+/**
+ * Checks that the basis of a cosine tree is orthonormal, and that it captures
+ * a low-rank dataset.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeOrthonormalBasis)
+{
+  const size_t rank = 5;
+  arma::mat data = arma::randu(40, rank) * arma::randu(rank, 200);
+
+  CosineTree ctree(data, 1e-4, 0.1);
+  arma::mat basis;
+  ctree.GetFinalBasis(basis);
+
+  BOOST_REQUIRE_EQUAL(basis.n_rows, 40);
+  BOOST_REQUIRE_GE(basis.n_cols, 1);
+
+  // The nonzero basis vectors must be orthonormal.
+  const arma::mat gram = basis.t() * basis;
+  for (size_t i = 0; i < gram.n_rows; i++)
+  {
+    for (size_t j = 0; j < gram.n_cols; j++)
+    {
+      if (i == j && gram(i, i) > 0.5)
+        BOOST_REQUIRE_CLOSE(gram(i, j), 1.0, 1e-5);
+      else if (i != j)
+        BOOST_REQUIRE_SMALL(gram(i, j), 1e-8);
+    }
+  }
+
+  // The projection of the data onto the basis must be close.
+  const arma::mat projection = basis * (basis.t() * data);
+  BOOST_REQUIRE_LE(arma::norm(data - projection, "fro"),
+      0.1 * arma::norm(data, "fro"));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -25,6 +25,7 @@
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include <mlpack/methods/decision_tree/information_gain.hpp>
+#include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/lars/lars.hpp>
 #include <mlpack/methods/linear_regression/linear_regression.hpp>
@@ -36,6 +37,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include "mock_categorical_data.hpp"
+#include "test_tools.hpp"
 
 using namespace mlpack;
 using namespace mlpack::ann;
@@ -676,4 +678,84 @@ BOOST_AUTO_TEST_CASE(KFoldCVWithDTTestUnevenBinsWeighted)
   BOOST_REQUIRE_GT(accuracy, 0.7);
 }
 
+/**
+ * Test that training the folds in parallel gives the same result as training
+ * them one by one, for an algorithm that doesn't use random numbers, and that
+ * parallel runs are reproducible for one that does.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVParallelTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 200);
+  arma::rowvec responses = arma::randu<arma::rowvec>(5) * data +
+      0.1 * arma::randn<arma::rowvec>(200);
+
+  KFoldCV<LinearRegression, MSE> cv(8, data, responses);
+  const double sequentialMSE = cv.Evaluate(0.01);
+  const arma::vec sequentialParameters = cv.Model().Parameters();
+
+  cv.Parallel() = true;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(0.01), sequentialMSE, 1e-10);
+  CheckMatrices(cv.Model().Parameters(), sequentialParameters);
+
+  // EvaluateModel() leaves the model of the object alone.
+  std::unique_ptr<LinearRegression> model;
+  BOOST_REQUIRE_CLOSE(cv.EvaluateModel(model, 0.01), sequentialMSE, 1e-10);
+  CheckMatrices(model->Parameters(), sequentialParameters);
+
+  // These decision trees split on a random dimension at each node; each fold
+  // seeds its own generator, so two runs from the same seed agree.
+  arma::mat dtData;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(dtData, labels, datasetInfo);
+
+  typedef DecisionTree<InformationGain, BestBinaryNumericSplit,
+      AllCategoricalSplit, RandomDimensionSelect> RandomTree;
+  KFoldCV<RandomTree, Accuracy> treeCV(4, dtData, datasetInfo, labels, 5,
+      false);
+  treeCV.Parallel() = true;
+  math::RandomSeed(42);
+  const double accuracy = treeCV.Evaluate(5);
+  math::RandomSeed(42);
+  BOOST_REQUIRE_CLOSE(treeCV.Evaluate(5), accuracy, 1e-10);
+}
+
+/**
+ * Test that the folds trained on the rotated data (without copies) give the
+ * same models and results as the folds trained on copied subsets, and that the
+ * data are rotated back afterwards.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVInPlaceTest)
+{
+  // An uneven number of points, so that the last bin is larger.
+  arma::mat data = arma::randu<arma::mat>(4, 103);
+  arma::rowvec responses = arma::randu<arma::rowvec>(4) * data +
+      0.1 * arma::randn<arma::rowvec>(103);
+  arma::rowvec weights = arma::randu<arma::rowvec>(103);
+
+  KFoldCV<LinearRegression, MSE> cv(5, data, responses, weights, false);
+  const double inPlaceMSE = cv.Evaluate(0.001);
+  const arma::vec inPlaceParameters = cv.Model().Parameters();
+
+  std::unique_ptr<LinearRegression> model;
+  BOOST_REQUIRE_CLOSE(cv.EvaluateModel(model, 0.001), inPlaceMSE, 1e-10);
+  CheckMatrices(model->Parameters(), inPlaceParameters);
+
+  // The model of the last fold is trained on the last bin and then on the
+  // first three ones.
+  arma::mat trainingData = arma::join_rows(data.cols(80, 102),
+      data.cols(0, 59));
+  arma::rowvec trainingResponses = arma::join_rows(responses.cols(80, 102),
+      responses.cols(0, 59));
+  arma::rowvec trainingWeights = arma::join_rows(weights.cols(80, 102),
+      weights.cols(0, 59));
+  LinearRegression lastFold(trainingData, trainingResponses, trainingWeights,
+      0.001);
+  CheckMatrices(lastFold.Parameters(), inPlaceParameters);
+
+  // The data were rotated back, so a second run gives the same result.
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(0.001), inPlaceMSE, 1e-10);
+  CheckMatrices(cv.Model().Parameters(), inPlaceParameters);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
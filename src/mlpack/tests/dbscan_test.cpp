@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/dbscan/dbscan.hpp>
 #include <mlpack/methods/dbscan/random_point_selection.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -309,4 +310,105 @@ BOOST_AUTO_TEST_CASE(RandomPointSelectionTest)
   BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
 }
 
+// Check that the two given clusterings are the same, up to the labels.
+void CheckSameClustering(const arma::Row<size_t>& a,
+                         const arma::Row<size_t>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.n_elem, b.n_elem);
+  std::map<size_t, size_t> aToB, bToA;
+  for (size_t i = 0; i < a.n_elem; ++i)
+  {
+    // Noise must be noise in both clusterings.
+    BOOST_REQUIRE_EQUAL(a[i] == SIZE_MAX, b[i] == SIZE_MAX);
+    if (a[i] == SIZE_MAX)
+      continue;
+
+    if (aToB.count(a[i]) == 0)
+      aToB[a[i]] = b[i];
+    if (bToA.count(b[i]) == 0)
+      bToA[b[i]] = a[i];
+    BOOST_REQUIRE_EQUAL(aToB[a[i]], b[i]);
+    BOOST_REQUIRE_EQUAL(bToA[b[i]], a[i]);
+  }
+}
+
+/**
+ * Make sure that the dual-tree mode finds the same clusters as the batch mode.
+ */
+BOOST_AUTO_TEST_CASE(DualTreeModeTest)
+{
+  arma::mat points(3, 1000);
+  GaussianDistribution g1(3), g2(3), g3(3);
+  g1.Mean() = arma::vec("0.0 0.0 0.0");
+  g2.Mean() = arma::vec("6.0 6.0 8.0");
+  g3.Mean() = arma::vec("-6.0 1.0 -7.0");
+  for (size_t i = 0; i < 300; ++i)
+    points.col(i) = g1.Random();
+  for (size_t i = 300; i < 600; ++i)
+    points.col(i) = g2.Random();
+  for (size_t i = 600; i < 900; ++i)
+    points.col(i) = g3.Random();
+  // Some sparse points, which will mostly be noise.
+  points.cols(900, 999) = 20.0 * arma::randu<arma::mat>(3, 100) - 10.0;
+
+  DBSCAN<> batch(0.6, 5);
+  arma::Row<size_t> batchAssignments;
+  const size_t batchClusters = batch.Cluster(points, batchAssignments);
+
+  DBSCAN<> dualTree(0.6, 5);
+  dualTree.DualTreeMode() = true;
+  arma::Row<size_t> dualTreeAssignments;
+  const size_t dualTreeClusters = dualTree.Cluster(points,
+      dualTreeAssignments);
+
+  BOOST_REQUIRE_EQUAL(batchClusters, dualTreeClusters);
+  CheckSameClustering(batchAssignments, dualTreeAssignments);
+
+  // Now with a cover tree, which does not rearrange the dataset.
+  DBSCAN<RangeSearch<metric::EuclideanDistance, arma::mat,
+      tree::StandardCoverTree>> coverDualTree(0.6, 5);
+  coverDualTree.DualTreeMode() = true;
+  arma::Row<size_t> coverAssignments;
+  const size_t coverClusters = coverDualTree.Cluster(points, coverAssignments);
+
+  BOOST_REQUIRE_EQUAL(batchClusters, coverClusters);
+  CheckSameClustering(batchAssignments, coverAssignments);
+
+  // With a large epsilon, every node combination is united at once.
+  DBSCAN<> big(100.0, 5);
+  big.DualTreeMode() = true;
+  arma::Row<size_t> bigAssignments;
+  BOOST_REQUIRE_EQUAL(big.Cluster(points, bigAssignments), 1);
+  for (size_t i = 0; i < bigAssignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(bigAssignments[i], 0);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the assignments of the dual-tree mode don't depend on the
+ * number of threads.
+ */
+BOOST_AUTO_TEST_CASE(DualTreeModeThreadsTest)
+{
+  arma::mat points = arma::randu<arma::mat>(2, 2000);
+
+  DBSCAN<> d(0.03, 3);
+  d.DualTreeMode() = true;
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  arma::Row<size_t> serialAssignments;
+  const size_t serialClusters = d.Cluster(points, serialAssignments);
+  omp_set_num_threads(oldThreads);
+
+  BOOST_REQUIRE_EQUAL(clusters, serialClusters);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], serialAssignments[i]);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
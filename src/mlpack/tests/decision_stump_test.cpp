@@ -391,4 +391,31 @@ BOOST_AUTO_TEST_CASE(IntTest)
   BOOST_CHECK_EQUAL(predictedLabels(0, 7), 2);
 }
 
+/**
+ * Make sure the informative dimension is chosen when there are enough points
+ * and dimensions for the dimensions to be searched in parallel.
+ */
+BOOST_AUTO_TEST_CASE(ManyDimensionsSelectionTest)
+{
+  arma::mat trainingData(20, 3000, arma::fill::randu);
+  arma::Row<size_t> labelsIn(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    labelsIn[i] = (trainingData(13, i) > 0.5) ? 1 : 0;
+
+    // Some other dimensions have identical values.
+    trainingData(2, i) = 1.0;
+    trainingData(17, i) = 1.0;
+  }
+
+  DecisionStump<> ds(trainingData, labelsIn, 2, 10);
+  BOOST_REQUIRE_EQUAL(ds.SplitDimension(), 13);
+
+  arma::Row<size_t> predictedLabels;
+  ds.Classify(trainingData, predictedLabels);
+
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, 3000);
+  BOOST_REQUIRE_GE(arma::accu(predictedLabels == labelsIn), 2950);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
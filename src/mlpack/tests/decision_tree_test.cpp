@@ -15,6 +15,8 @@
 #include <mlpack/methods/decision_tree/gini_gain.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 #include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+#include <mlpack/methods/decision_tree/histogram_numeric_split.hpp>
+#include <mlpack/methods/decision_tree/binary_categorical_split.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -367,6 +369,123 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that the weights make no difference.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(gain, weightedGain);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The splitting point should be between 4 and 5.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when each distinct value gets its own bin.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitBestSplitTest)
+{
+  arma::vec values(500);
+  arma::Row<size_t> labels(500);
+  arma::rowvec weights(500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    values[i] = math::RandInt(50);
+    labels[i] = (values[i] + math::RandInt(20) < 35) ? 0 :
+        math::RandInt(1, 3);
+    weights[i] = math::Random(0.5, 1.5);
+  }
+
+  arma::vec bestProbabilities, histogramProbabilities;
+  BestBinaryNumericSplit<InformationGain>::template
+      AuxiliarySplitInfo<double> bestAux;
+  HistogramNumericSplit<InformationGain>::template
+      AuxiliarySplitInfo<double> histogramAux;
+
+  const double bestGain = InformationGain::Evaluate<false>(labels, 3, weights);
+  double gain = BestBinaryNumericSplit<InformationGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 3, weights, 5, 1e-7, bestProbabilities,
+      bestAux);
+  double histogramGain =
+      HistogramNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 3, weights, 5, 1e-7, histogramProbabilities,
+      histogramAux);
+
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_CLOSE(histogramGain, gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(histogramProbabilities.n_elem, 1);
+  BOOST_REQUIRE_CLOSE(histogramProbabilities[0], bestProbabilities[0], 1e-5);
+
+  // Now the same with weights.
+  const double bestWeightedGain = InformationGain::Evaluate<true>(labels, 3,
+      weights);
+  gain = BestBinaryNumericSplit<InformationGain>::SplitIfBetter<true>(
+      bestWeightedGain, values, labels, 3, weights, 5, 1e-7, bestProbabilities,
+      bestAux);
+  histogramGain = HistogramNumericSplit<InformationGain>::SplitIfBetter<true>(
+      bestWeightedGain, values, labels, 3, weights, 5, 1e-7,
+      histogramProbabilities, histogramAux);
+
+  BOOST_REQUIRE_GT(gain, bestWeightedGain);
+  BOOST_REQUIRE_CLOSE(histogramGain, gain, 1e-5);
+  BOOST_REQUIRE_CLOSE(histogramProbabilities[0], bestProbabilities[0], 1e-5);
+}
+
+/**
+ * Check that the HistogramNumericSplit doesn't split a dimension that gives no
+ * gain.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitNoGainTest)
+{
+  arma::vec values(100);
+  arma::Row<size_t> labels(100);
+  arma::rowvec weights;
+  for (size_t i = 0; i < 100; i += 2)
+  {
+    values[i] = i;
+    labels[i] = 0;
+    values[i + 1] = i;
+    labels[i + 1] = 1;
+  }
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 10, 1e-7, classProbabilities, aux);
+
+  // Make sure there was no split.
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -465,6 +584,148 @@ BOOST_AUTO_TEST_CASE(AllCategoricalSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Make sure that the gain AllCategoricalSplit calculates from the counts of
+ * each class in each category is the same as the gain of the labels of each
+ * child, for a feature with many categories.
+ */
+BOOST_AUTO_TEST_CASE(AllCategoricalSplitCountsTest)
+{
+  const size_t numCategories = 200;
+  arma::vec values(5000);
+  arma::Row<size_t> labels(5000);
+  arma::rowvec weights(5000);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    values[i] = i % numCategories;
+    labels[i] = ((i % numCategories) % 3 == 0) ? 0 : math::RandInt(3);
+    weights[i] = math::Random(0.5, 1.0);
+  }
+
+  // Calculate the gain of the split from the labels of each child.
+  double gain = 0.0, weightedGain = 0.0;
+  const double totalWeight = arma::accu(weights);
+  for (size_t c = 0; c < numCategories; ++c)
+  {
+    const arma::uvec points = arma::find(values == c);
+    const arma::Row<size_t> childLabels = labels.cols(points);
+    const arma::rowvec childWeights = weights.cols(points);
+    gain += (double(points.n_elem) / 5000.0) *
+        GiniGain::Evaluate<false>(childLabels, 3, childWeights);
+    weightedGain += (arma::accu(childWeights) / totalWeight) *
+        GiniGain::Evaluate<true>(childLabels, 3, childWeights);
+  }
+
+  arma::vec classProbabilities;
+  AllCategoricalSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+  const double splitGain = AllCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      -DBL_MAX, values, numCategories, labels, 3, weights, 1, 0.0,
+      classProbabilities, aux);
+
+  BOOST_REQUIRE_CLOSE(splitGain, gain, 1e-5);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_EQUAL((size_t) classProbabilities[0], numCategories);
+
+  const double splitWeightedGain =
+      AllCategoricalSplit<GiniGain>::SplitIfBetter<true>(-DBL_MAX, values,
+      numCategories, labels, 3, weights, 1, 0.0, classProbabilities, aux);
+
+  BOOST_REQUIRE_CLOSE(splitWeightedGain, weightedGain, 1e-5);
+}
+
+/**
+ * Check that the BinaryCategoricalSplit groups the categories of a feature
+ * with many categories into the two classes when the classes are given by the
+ * categories.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalSplitSimpleSplitTest)
+{
+  const size_t numCategories = 500;
+  arma::Row<size_t> categoryLabels(numCategories);
+  for (size_t c = 0; c < numCategories; ++c)
+    categoryLabels[c] = math::RandInt(2);
+  // Make sure that both classes are used.
+  categoryLabels[0] = 0;
+  categoryLabels[1] = 1;
+
+  // Category numCategories - 1 has no points.
+  arma::vec values(10000);
+  arma::Row<size_t> labels(10000);
+  for (size_t i = 0; i < 10000; ++i)
+  {
+    values[i] = i % (numCategories - 1);
+    labels[i] = categoryLabels[(size_t) values[i]];
+  }
+  arma::rowvec weights = arma::ones<arma::rowvec>(10000);
+
+  arma::vec classProbabilities;
+  BinaryCategoricalSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, numCategories, labels, 2, weights, 3, 1e-7,
+      classProbabilities, aux);
+  const double weightedGain =
+      BinaryCategoricalSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      numCategories, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a perfect split was made.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+  BOOST_REQUIRE_SMALL(weightedGain, 1e-5);
+
+  // Each category of a class must go to the same child.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, numCategories);
+  BOOST_REQUIRE_EQUAL(BinaryCategoricalSplit<GiniGain>::NumChildren(
+      classProbabilities, aux), 2);
+  const size_t direction = BinaryCategoricalSplit<GiniGain>::CalculateDirection(
+      0.0, classProbabilities, aux);
+  for (size_t c = 0; c < numCategories - 1; ++c)
+  {
+    const size_t expected = (categoryLabels[c] == 0) ? direction :
+        1 - direction;
+    BOOST_REQUIRE_EQUAL(BinaryCategoricalSplit<GiniGain>::CalculateDirection(
+        (double) c, classProbabilities, aux), expected);
+  }
+
+  // The category without points goes to one of the children.
+  BOOST_REQUIRE_LT(BinaryCategoricalSplit<GiniGain>::CalculateDirection(
+      (double) (numCategories - 1), classProbabilities, aux), 2);
+}
+
+/**
+ * Make sure that BinaryCategoricalSplit doesn't split when one of the children
+ * would have fewer than the minimum number of points, or when there is only
+ * one category in the node.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalSplitMinSamplesTest)
+{
+  arma::vec values("0 0 0 1 1 1 2 2 2 2 2 2");
+  arma::Row<size_t> labels("0 0 0 1 1 1 0 0 0 1 1 1");
+  arma::rowvec weights = arma::ones<arma::rowvec>(labels.n_elem);
+
+  arma::vec classProbabilities;
+  BinaryCategoricalSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Every split of the three categories leaves a child with three points.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, 3, labels, 2, weights, 4, 1e-7, classProbabilities,
+      aux);
+
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+
+  arma::vec sameValues(12);
+  sameValues.fill(2);
+  const double sameGain =
+      BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      sameValues, 3, labels, 2, weights, 1, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_EQUAL(sameGain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
 /**
  * A basic construction of the decision tree---ensure that we can create the
  * tree and that it split at least once.
@@ -664,6 +925,48 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(wdcorrect, 0.75);
 }
 
+/**
+ * Test that a decision tree built with the HistogramNumericSplit generalizes
+ * reasonably.
+ */
+BOOST_AUTO_TEST_CASE(HistogramSplitGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Build decision tree.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  // Load testing data.
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  // Get the predicted test labels.
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  // Figure out the accuracy.
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -736,6 +1039,57 @@ BOOST_AUTO_TEST_CASE(CategoricalBuildTestWithWeight)
   BOOST_REQUIRE_GT(correctPct, 0.70);
 }
 
+/**
+ * Test that we can build a decision tree with binary categorical splits on a
+ * simple categorical dataset.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalBuildTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  // Split into a training set and a test set.
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+
+  // Build the tree.
+  typedef DecisionTree<GiniGain, BestBinaryNumericSplit,
+      BinaryCategoricalSplit> TreeType;
+  TreeType tree(trainingData, di, trainingLabels, 5, 10);
+
+  // Every internal node must have two children.
+  std::vector<const TreeType*> nodes(1, &tree);
+  while (!nodes.empty())
+  {
+    const TreeType* node = nodes.back();
+    nodes.pop_back();
+    if (node->NumChildren() == 0)
+      continue;
+
+    BOOST_REQUIRE_EQUAL(node->NumChildren(), 2);
+    nodes.push_back(&node->Child(0));
+    nodes.push_back(&node->Child(1));
+  }
+
+  // Now evaluate the accuracy of the tree.
+  arma::Row<size_t> predictions;
+  tree.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  size_t correct = 0;
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    if (testLabels[i] == predictions[i])
+      ++correct;
+
+  // Make sure we got at least 70% accuracy.
+  const double correctPct = double(correct) / double(testData.n_cols);
+  BOOST_REQUIRE_GT(correctPct, 0.70);
+}
+
 /**
  * Make sure that when we ask for a decision stump, we get one.
  */
@@ -1126,4 +1480,67 @@ BOOST_AUTO_TEST_CASE(RegularisedDecisionTree)
   BOOST_REQUIRE_GT(count, 0);
 }
 
+/**
+ * Check that two decision trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameTree(const TreeType& tree, const TreeType& otherTree)
+{
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), otherTree.NumChildren());
+  for (size_t i = 0; i < tree.NumChildren(); ++i)
+    CheckSameTree(tree.Child(i), otherTree.Child(i));
+}
+
+/**
+ * Make sure that training a decision tree in parallel gives the same tree as
+ * training it serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainingTest)
+{
+  arma::mat dataset(10, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+  {
+    labels[i] = (dataset(2, i) + dataset(5, i) > 1.0) ? 1 : 0;
+    if (math::Random() < 0.1)
+      labels[i] = 2;
+  }
+  arma::rowvec weights(20000);
+  weights.randu();
+
+  data::DatasetInfo info(10);
+
+  // A minimum gain split makes the parallel split search evaluate some of the
+  // dimensions again.
+  DecisionTree<> d(dataset, labels, 3, 5, 0.001);
+  DecisionTree<> wd(dataset, info, labels, 3, weights, 5, 0.001);
+
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  DecisionTree<> serialD(dataset, labels, 3, 5, 0.001);
+  DecisionTree<> serialWd(dataset, info, labels, 3, weights, 5, 0.001);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  CheckSameTree(d, serialD);
+  CheckSameTree(wd, serialWd);
+
+  arma::Row<size_t> predictions, serialPredictions;
+  arma::mat probabilities, serialProbabilities;
+  d.Classify(dataset, predictions, probabilities);
+  serialD.Classify(dataset, serialPredictions, serialProbabilities);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], serialPredictions[i]);
+  CheckMatrices(probabilities, serialProbabilities);
+
+  wd.Classify(dataset, predictions, probabilities);
+  serialWd.Classify(dataset, serialPredictions, serialProbabilities);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], serialPredictions[i]);
+  CheckMatrices(probabilities, serialProbabilities);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -216,6 +216,63 @@ BOOST_AUTO_TEST_CASE(TestSparseSplitData)
   BOOST_REQUIRE_EQUAL(oTest[6], 7);
 }
 
+/**
+ * Check that each split of the given subtree is the one FindSplit() finds by
+ * sorting the points of the node.
+ */
+void CheckPresortedSplits(DTree<arma::mat>& node,
+                          const arma::mat& data,
+                          const size_t minLeafSize)
+{
+  if (node.Left() == NULL)
+    return;
+
+  size_t splitDim;
+  double splitValue, leftError, rightError;
+  BOOST_REQUIRE(node.FindSplit(data, splitDim, splitValue, leftError,
+      rightError, minLeafSize));
+  BOOST_REQUIRE_EQUAL(node.SplitDim(), splitDim);
+  BOOST_REQUIRE_EQUAL(node.SplitValue(), splitValue);
+  BOOST_REQUIRE_EQUAL(node.Left()->End(), node.Right()->Start());
+
+  for (size_t i = node.Start(); i < node.Left()->End(); ++i)
+    BOOST_REQUIRE_LE(data(splitDim, i), splitValue);
+  for (size_t i = node.Right()->Start(); i < node.End(); ++i)
+    BOOST_REQUIRE_GT(data(splitDim, i), splitValue);
+
+  CheckPresortedSplits(*node.Left(), data, minLeafSize);
+  CheckPresortedSplits(*node.Right(), data, minLeafSize);
+}
+
+/**
+ * Make sure that growing a tree with the points sorted ahead of time (and in
+ * parallel, for the large nodes) gives the splits of the sorting search.
+ */
+BOOST_AUTO_TEST_CASE(TestPresortedGrow)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 5000);
+  // Duplicate values must not break the orders.
+  data.row(3) = arma::floor(10 * data.row(3));
+  const arma::mat originalData(data);
+
+  arma::Col<size_t> oldFromNew(data.n_cols);
+  for (size_t i = 0; i < oldFromNew.n_elem; ++i)
+    oldFromNew[i] = i;
+
+  DTree<arma::mat> tree(data);
+  tree.Grow(data, oldFromNew, false, 10, 5);
+
+  BOOST_REQUIRE_GT(tree.SubtreeLeaves(), 1);
+  CheckPresortedSplits(tree, data, 5);
+
+  // The points were reordered with their mappings.
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t d = 0; d < data.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(data(d, i), originalData(d, oldFromNew[i]));
+  }
+}
+
 #endif
 
 // Tests for the public functions.
@@ -398,6 +398,53 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Make sure that the batch log probabilities of a Gaussian match the single
+ * ones, across several blocks of points, for both a full and a diagonal
+ * covariance.
+ */
+BOOST_AUTO_TEST_CASE(GaussianBlockedLogProbabilityTest)
+{
+  arma::vec mean = "1 -2 0.5";
+  arma::mat fullCov("3 1 0.5;"
+                    "1 2 0.2;"
+                    "0.5 0.2 1");
+  arma::mat diagCov("3 0 0;"
+                    "0 2 0;"
+                    "0 0 0.5");
+
+  arma::mat points(3, 2500, arma::fill::randn);
+
+  GaussianDistribution full(mean, fullCov);
+  GaussianDistribution diag(mean, diagCov);
+  BOOST_REQUIRE(!full.IsDiagonal());
+  BOOST_REQUIRE(diag.IsDiagonal());
+
+  arma::vec fullPhis, diagPhis;
+  full.LogProbability(points, fullPhis);
+  diag.LogProbability(points, diagPhis);
+  BOOST_REQUIRE_EQUAL(fullPhis.n_elem, points.n_cols);
+  BOOST_REQUIRE_EQUAL(diagPhis.n_elem, points.n_cols);
+
+  const arma::mat invFullCov = arma::inv(fullCov);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    // Compare with the explicit formula.
+    const arma::vec diff = points.col(i) - mean;
+    const double fullPhi = -0.5 * 3 * std::log(2 * M_PI) -
+        0.5 * std::log(arma::det(fullCov)) -
+        0.5 * arma::as_scalar(diff.t() * invFullCov * diff);
+    const double diagPhi = -0.5 * 3 * std::log(2 * M_PI) -
+        0.5 * std::log(3.0 * 2.0 * 0.5) -
+        0.5 * arma::accu(arma::square(diff) / diagCov.diag());
+
+    BOOST_REQUIRE_CLOSE(fullPhis[i], fullPhi, 1e-5);
+    BOOST_REQUIRE_CLOSE(full.LogProbability(points.col(i)), fullPhi, 1e-5);
+    BOOST_REQUIRE_CLOSE(diagPhis[i], diagPhi, 1e-5);
+    BOOST_REQUIRE_CLOSE(diag.LogProbability(points.col(i)), diagPhi, 1e-5);
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -10,11 +10,16 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/dendrogram.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
 #include <mlpack/core/tree/cover_tree.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::emst;
 using namespace mlpack::tree;
@@ -278,4 +283,172 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+/**
+ * Check the dendrogram of a simple minimum spanning tree, given in arbitrary
+ * order.
+ */
+BOOST_AUTO_TEST_CASE(DendrogramTest)
+{
+  // The points 0, 1, 3, and 7 on a line.
+  arma::mat mst("2 1 0;"
+                "3 2 1;"
+                "4 2 1");
+
+  Dendrogram dendrogram(mst);
+  const arma::mat& linkage = dendrogram.Linkage();
+
+  BOOST_REQUIRE_EQUAL(dendrogram.NumPoints(), 4);
+  BOOST_REQUIRE_EQUAL(linkage.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(linkage.n_cols, 3);
+
+  // Points 0 and 1 are merged into cluster 4.
+  BOOST_REQUIRE_EQUAL(linkage(0, 0), 0);
+  BOOST_REQUIRE_EQUAL(linkage(1, 0), 1);
+  BOOST_REQUIRE_CLOSE(linkage(2, 0), 1.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 0), 2);
+
+  // Then point 2 joins cluster 4, creating cluster 5.
+  BOOST_REQUIRE_EQUAL(linkage(0, 1), 2);
+  BOOST_REQUIRE_EQUAL(linkage(1, 1), 4);
+  BOOST_REQUIRE_CLOSE(linkage(2, 1), 2.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 1), 3);
+
+  // And point 3 joins cluster 5.
+  BOOST_REQUIRE_EQUAL(linkage(0, 2), 3);
+  BOOST_REQUIRE_EQUAL(linkage(1, 2), 5);
+  BOOST_REQUIRE_CLOSE(linkage(2, 2), 4.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(linkage(3, 2), 4);
+
+  arma::Row<size_t> assignments;
+  BOOST_REQUIRE_EQUAL(dendrogram.Cut(1.5, assignments), 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, 4);
+  BOOST_REQUIRE_EQUAL(assignments[0], 0);
+  BOOST_REQUIRE_EQUAL(assignments[1], 0);
+  BOOST_REQUIRE_EQUAL(assignments[2], 1);
+  BOOST_REQUIRE_EQUAL(assignments[3], 2);
+
+  BOOST_REQUIRE_EQUAL(dendrogram.Cut(10.0, assignments), 1);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], 0);
+}
+
+/**
+ * Make sure that a set of edges that is not a spanning tree is rejected.
+ */
+BOOST_AUTO_TEST_CASE(DendrogramCycleTest)
+{
+  arma::mat edges("0 1 0;"
+                  "1 2 2;"
+                  "1 1 1");
+
+  BOOST_REQUIRE_THROW(Dendrogram d(edges), std::invalid_argument);
+}
+
+/**
+ * The mutual reachability MST found by the dual-tree algorithm should have the
+ * same length as the one found by the naive algorithm, and as the one found by
+ * Prim's algorithm.  (Many edges have the same length, so the edges may
+ * differ.)
+ */
+BOOST_AUTO_TEST_CASE(MutualReachabilityTest)
+{
+  arma::mat dataset(3, 300, arma::fill::randu);
+  arma::vec coreDistances(300, arma::fill::randu);
+  coreDistances *= 0.3;
+
+  DualTreeBoruvka<> dtb(dataset);
+  arma::mat dualResults;
+  dtb.ComputeMST(dualResults, coreDistances);
+
+  DualTreeBoruvka<> naive(dataset, true);
+  arma::mat naiveResults;
+  naive.ComputeMST(naiveResults, coreDistances);
+
+  BOOST_REQUIRE_EQUAL(dualResults.n_cols, 299);
+  BOOST_REQUIRE_EQUAL(naiveResults.n_cols, 299);
+
+  // Compute the length with Prim's algorithm.
+  EuclideanDistance metric;
+  arma::vec bestDistances(300);
+  bestDistances.fill(DBL_MAX);
+  std::vector<bool> inTree(300, false);
+  size_t current = 0;
+  double primLength = 0.0;
+  for (size_t i = 1; i < 300; ++i)
+  {
+    inTree[current] = true;
+    size_t next = 0;
+    double nextDistance = DBL_MAX;
+    for (size_t j = 0; j < 300; ++j)
+    {
+      if (inTree[j])
+        continue;
+
+      const double d = std::max(metric.Evaluate(dataset.col(current),
+          dataset.col(j)), std::max(coreDistances[current],
+          coreDistances[j]));
+      bestDistances[j] = std::min(bestDistances[j], d);
+      if (bestDistances[j] < nextDistance)
+      {
+        nextDistance = bestDistances[j];
+        next = j;
+      }
+    }
+
+    primLength += nextDistance;
+    current = next;
+  }
+
+  BOOST_REQUIRE_CLOSE(arma::accu(dualResults.row(2)), primLength, 1e-5);
+  BOOST_REQUIRE_CLOSE(arma::accu(naiveResults.row(2)), primLength, 1e-5);
+
+  // Each edge is at least as long as the core distances of its points.
+  for (size_t i = 0; i < dualResults.n_cols; ++i)
+  {
+    BOOST_REQUIRE_GE(dualResults(2, i) + 1e-10,
+        coreDistances[(size_t) dualResults(0, i)]);
+    BOOST_REQUIRE_GE(dualResults(2, i) + 1e-10,
+        coreDistances[(size_t) dualResults(1, i)]);
+  }
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the results don't depend on the number of threads, both for
+ * the dual-tree and the naive computation.
+ */
+BOOST_AUTO_TEST_CASE(ThreadsTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  const int maxThreads = omp_get_max_threads();
+  for (size_t naive = 0; naive < 2; ++naive)
+  {
+    omp_set_num_threads(1);
+    DualTreeBoruvka<> serialDTB(inputData, (naive == 1));
+    arma::mat serialResults;
+    serialDTB.ComputeMST(serialResults);
+
+    omp_set_num_threads(std::max(maxThreads, 4));
+    DualTreeBoruvka<> parallelDTB(inputData, (naive == 1));
+    arma::mat parallelResults;
+    parallelDTB.ComputeMST(parallelResults);
+    omp_set_num_threads(maxThreads);
+
+    BOOST_REQUIRE_EQUAL(serialResults.n_cols, parallelResults.n_cols);
+    BOOST_REQUIRE_EQUAL(serialResults.n_rows, parallelResults.n_rows);
+    for (size_t i = 0; i < serialResults.n_cols; i++)
+    {
+      BOOST_REQUIRE_EQUAL(serialResults(0, i), parallelResults(0, i));
+      BOOST_REQUIRE_EQUAL(serialResults(1, i), parallelResults(1, i));
+      BOOST_REQUIRE_CLOSE(serialResults(2, i), parallelResults(2, i), 1e-5);
+    }
+  }
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -17,6 +17,10 @@
 #include "test_tools.hpp"
 #include "serialization.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::tree;
 using namespace mlpack::fastmks;
@@ -1082,4 +1086,221 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Make sure that the const searches, which do not modify the reference tree,
+ * give the same results as naive search.
+ */
+BOOST_AUTO_TEST_CASE(ConstSearchTest)
+{
+  arma::mat referenceData(5, 1000, arma::fill::randn);
+  arma::mat queryData(5, 200, arma::fill::randn);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 10, naiveIndices, naiveKernels);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    const FastMKS<LinearKernel> f(referenceData, lk, (mode == 0));
+
+    arma::Mat<size_t> indices;
+    arma::mat kernels;
+    f.Search(queryData, 10, indices, kernels);
+
+    BOOST_REQUIRE_EQUAL(indices.n_rows, 10);
+    BOOST_REQUIRE_EQUAL(indices.n_cols, queryData.n_cols);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(indices[i], naiveIndices[i]);
+      BOOST_REQUIRE_CLOSE(kernels[i], naiveKernels[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that approximate tree search returns kernel values within the
+ * relative error of the exact ones, and exact results when epsilon is 0.
+ */
+BOOST_AUTO_TEST_CASE(FastMKSApproximateTest)
+{
+  arma::mat referenceData(5, 1000, arma::fill::randu);
+  arma::mat queryData(5, 200, arma::fill::randu);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    FastMKS<LinearKernel> f(referenceData, lk, (mode == 0));
+
+    arma::Mat<size_t> indices;
+    arma::mat kernels;
+    f.Search(queryData, 5, indices, kernels);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(indices[i], naiveIndices[i]);
+
+    f.Epsilon() = 0.2;
+    f.Search(queryData, 5, indices, kernels);
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+    {
+      for (size_t j = 0; j < 5; ++j)
+      {
+        BOOST_REQUIRE_LT(indices(j, i), referenceData.n_cols);
+        BOOST_REQUIRE_CLOSE(kernels(j, i), lk.Evaluate(queryData.col(i),
+            referenceData.col(indices(j, i))), 1e-5);
+        BOOST_REQUIRE_GE(1.2 * kernels(j, i), naiveKernels(j, i) - 1e-10);
+      }
+    }
+
+    f.Epsilon() = -1.0;
+    BOOST_REQUIRE_THROW(f.Search(queryData, 5, indices, kernels),
+        std::invalid_argument);
+  }
+}
+
+/**
+ * Make sure that the budget of base cases of single-tree search gives valid
+ * candidates, and that a large budget gives exact results.
+ */
+BOOST_AUTO_TEST_CASE(FastMKSMaxBaseCasesTest)
+{
+  arma::mat referenceData(4, 1000, arma::fill::randn);
+  arma::mat queryData(4, 100, arma::fill::randn);
+  PolynomialKernel pk(2.0, 1.0);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 3, naiveIndices, naiveKernels);
+
+  FastMKSModel model(FastMKSModel::POLYNOMIAL_KERNEL);
+  model.BuildModel(referenceData, pk, true, false, 2.0);
+  model.MaxBaseCases() = 20;
+  BOOST_REQUIRE_EQUAL(model.MaxBaseCases(), 20);
+
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  model.Search(queryData, 3, indices, kernels, 2.0);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_LT(indices(j, i), referenceData.n_cols);
+      BOOST_REQUIRE_CLOSE(kernels(j, i), pk.Evaluate(queryData.col(i),
+          referenceData.col(indices(j, i))), 1e-5);
+      BOOST_REQUIRE_LE(kernels(j, i), naiveKernels(j, i) + 1e-10);
+    }
+  }
+
+  model.MaxBaseCases() = 1000000;
+  model.Search(queryData, 3, indices, kernels, 2.0);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(indices[i], naiveIndices[i]);
+}
+
+#ifdef HAS_OPENMP
+
+// Check that the given search results are the same.
+void CheckSameResults(const arma::Mat<size_t>& indices,
+                      const arma::mat& kernels,
+                      const arma::Mat<size_t>& otherIndices,
+                      const arma::mat& otherKernels)
+{
+  BOOST_REQUIRE_EQUAL(indices.n_rows, otherIndices.n_rows);
+  BOOST_REQUIRE_EQUAL(indices.n_cols, otherIndices.n_cols);
+  BOOST_REQUIRE_EQUAL(kernels.n_rows, otherKernels.n_rows);
+  BOOST_REQUIRE_EQUAL(kernels.n_cols, otherKernels.n_cols);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(indices[i], otherIndices[i]);
+    BOOST_REQUIRE_CLOSE(kernels[i], otherKernels[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the results of each type of search do not depend on the
+ * number of threads.
+ */
+BOOST_AUTO_TEST_CASE(FastMKSThreadsTest)
+{
+  arma::mat referenceData(6, 1500, arma::fill::randu);
+  arma::mat queryData(6, 500, arma::fill::randu);
+  PolynomialKernel pk(2.0, 1.0);
+
+  const int maxThreads = omp_get_max_threads();
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    FastMKS<PolynomialKernel> f(referenceData, pk, (mode == 1), (mode == 0));
+
+    omp_set_num_threads(1);
+    arma::Mat<size_t> indices, monoIndices;
+    arma::mat kernels, monoKernels;
+    f.Search(queryData, 5, indices, kernels);
+    f.Search(5, monoIndices, monoKernels);
+
+    omp_set_num_threads(std::max(maxThreads, 4));
+    arma::Mat<size_t> parallelIndices, parallelMonoIndices;
+    arma::mat parallelKernels, parallelMonoKernels;
+    f.Search(queryData, 5, parallelIndices, parallelKernels);
+    f.Search(5, parallelMonoIndices, parallelMonoKernels);
+
+    CheckSameResults(indices, kernels, parallelIndices, parallelKernels);
+    CheckSameResults(monoIndices, monoKernels, parallelMonoIndices,
+        parallelMonoKernels);
+  }
+
+  omp_set_num_threads(maxThreads);
+}
+
+/**
+ * Make sure that several threads can search with the same model at once.
+ */
+BOOST_AUTO_TEST_CASE(FastMKSModelConcurrentSearchTest)
+{
+  arma::mat referenceData(4, 1000, arma::fill::randn);
+  arma::mat queryData(4, 400, arma::fill::randn);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+  arma::Mat<size_t> naiveIndices;
+  arma::mat naiveKernels;
+  naive.Search(queryData, 3, naiveIndices, naiveKernels);
+
+  const int maxThreads = omp_get_max_threads();
+  omp_set_num_threads(std::max(maxThreads, 4));
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    FastMKSModel model(FastMKSModel::LINEAR_KERNEL);
+    model.BuildModel(referenceData, lk, (mode == 0), false, 2.0);
+    const FastMKSModel& constModel = model;
+
+    // Each block of 50 queries is searched by one thread.
+    std::vector<arma::Mat<size_t>> indices(8);
+    std::vector<arma::mat> kernels(8);
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < 8; ++i)
+    {
+      constModel.Search(queryData.cols(50 * i, 50 * i + 49), 3, indices[i],
+          kernels[i], 2.0);
+    }
+
+    for (size_t i = 0; i < 8; ++i)
+    {
+      CheckSameResults(indices[i], kernels[i],
+          naiveIndices.cols(50 * i, 50 * i + 49),
+          naiveKernels.cols(50 * i, 50 * i + 49));
+    }
+  }
+
+  omp_set_num_threads(maxThreads);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
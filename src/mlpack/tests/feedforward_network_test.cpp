@@ -15,6 +15,8 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/quantized_ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
 
 #include <ensmallen.hpp>
 
@@ -579,4 +581,498 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Make sure that inference-only prediction with a workspace gives the same
+ * results as Predict(), for any batch size and from several threads at once.
+ */
+BOOST_AUTO_TEST_CASE(WorkspacePredictTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(6, 12);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >(0.3);
+  model.Add<Linear<> >(12, 4);
+  model.Add<LogSoftMax<> >();
+
+  arma::mat predictors(6, 53, arma::fill::randu);
+
+  // Predict() needs the network to be frozen first.
+  FFNWorkspace unusedWorkspace;
+  arma::mat unusedResults;
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(model.Predict(predictors, unusedResults,
+      unusedWorkspace), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  model.Freeze();
+
+  arma::mat expected;
+  model.Predict(predictors, expected);
+
+  const size_t batchSizes[4] = { 1, 7, 32, 100 };
+  for (size_t b = 0; b < 4; ++b)
+  {
+    FFNWorkspace workspace(batchSizes[b]);
+    arma::mat results;
+    model.Predict(predictors, results, workspace);
+    CheckMatrices(results, expected);
+
+    // Reusing the workspace gives the same results.
+    model.Predict(predictors.cols(0, 9), results, workspace);
+    CheckMatrices(results, expected.cols(0, 9));
+  }
+
+  // Now predict from several threads, each with its own workspace.
+  std::vector<arma::mat> threadResults(8);
+  #pragma omp parallel for
+  for (omp_size_t t = 0; t < 8; ++t)
+  {
+    FFNWorkspace workspace(5);
+    model.Predict(predictors, threadResults[t], workspace);
+  }
+
+  for (size_t t = 0; t < 8; ++t)
+    CheckMatrices(threadResults[t], expected);
+}
+
+/**
+ * Make sure that splitting the mini-batches across worker replicas gives the
+ * same objective and gradient as the serial evaluation, also for a loss that
+ * is averaged over the batch.
+ */
+template<typename OutputLayerType>
+void CheckWorkersGradient(const arma::mat& responses)
+{
+  FFN<OutputLayerType, RandomInitialization> model;
+  model.Add<Linear<> >(6, 12);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(12, 4);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = arma::randu<arma::mat>(6, 50);
+  model.Responses() = responses;
+
+  arma::mat serialGradient;
+  const double serialObjective = model.EvaluateWithGradient(
+      model.Parameters(), 5, serialGradient, 23);
+
+  const size_t workers[3] = { 2, 4, 30 };
+  for (size_t w = 0; w < 3; ++w)
+  {
+    model.Workers() = workers[w];
+
+    arma::mat gradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 5,
+        gradient, 23);
+
+    BOOST_REQUIRE_CLOSE(objective, serialObjective, 1e-5);
+    CheckMatrices(gradient, serialGradient, 1e-5);
+
+    // The replicas share the parameters, so changing them is seen by the next
+    // evaluation.
+    model.Parameters() *= 0.5;
+    model.Workers() = 1;
+    arma::mat newSerialGradient;
+    const double newSerialObjective = model.EvaluateWithGradient(
+        model.Parameters(), 5, newSerialGradient, 23);
+    model.Workers() = workers[w];
+    const double newObjective = model.EvaluateWithGradient(model.Parameters(),
+        5, gradient, 23);
+
+    BOOST_REQUIRE_CLOSE(newObjective, newSerialObjective, 1e-5);
+    CheckMatrices(gradient, newSerialGradient, 1e-5);
+
+    model.Parameters() *= 2.0;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WorkersGradientTest)
+{
+  arma::mat labels = arma::floor(arma::randu<arma::mat>(1, 50) * 4) + 1;
+  CheckWorkersGradient<NegativeLogLikelihood<> >(labels);
+  CheckWorkersGradient<MeanSquaredError<> >(arma::randu<arma::mat>(4, 50));
+}
+
+/**
+ * Make sure that the memory planner shares memory between buffers exactly when
+ * their lifetimes don't overlap.
+ */
+BOOST_AUTO_TEST_CASE(MemoryPlannerTest)
+{
+  MemoryPlanner planner;
+  const size_t a = planner.Add(4, 0, 1);
+  const size_t b = planner.Add(3, 1, 2);
+  const size_t c = planner.Add(2, 2, 3);
+  planner.Plan();
+
+  // c can reuse the memory of a, but b overlaps both.
+  BOOST_REQUIRE_EQUAL(planner.TotalSize(), 9);
+  BOOST_REQUIRE_EQUAL(planner.ArenaSize(), 7);
+  BOOST_REQUIRE_EQUAL(planner.Offset(a), planner.Offset(c));
+  BOOST_REQUIRE_NE(planner.Offset(a), planner.Offset(b));
+  BOOST_REQUIRE_NE(planner.Offset(c), planner.Offset(b));
+}
+
+/**
+ * Make sure that planned passes, with and without checkpoints, give the same
+ * objectives and gradients as unplanned passes, with less memory.
+ */
+BOOST_AUTO_TEST_CASE(PlannedGradientTest)
+{
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Linear<> >(6, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(10, 10);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(10, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+
+  model.Predictors() = arma::randu<arma::mat>(6, 40);
+  model.Responses() = arma::randu<arma::mat>(3, 40);
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 4,
+      gradient, 16);
+  const double evaluation = model.Evaluate(model.Parameters(), 4, 16);
+
+  model.PlanMemory() = true;
+  size_t fullArenaSize = 0;
+  const size_t intervals[3] = { 0, 2, 3 };
+  for (size_t k = 0; k < 3; ++k)
+  {
+    model.CheckpointInterval() = intervals[k];
+
+    // The second pass reuses the plan and the arena of the first one.
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      arma::mat plannedGradient;
+      const double plannedObjective = model.EvaluateWithGradient(
+          model.Parameters(), 4, plannedGradient, 16);
+      BOOST_REQUIRE_CLOSE(plannedObjective, objective, 1e-5);
+      CheckMatrices(plannedGradient, gradient, 1e-5);
+
+      BOOST_REQUIRE_CLOSE(model.Evaluate(model.Parameters(), 4, 16),
+          evaluation, 1e-5);
+
+      arma::mat results, pairGradient;
+      model.Forward(model.Predictors().cols(4, 19), results);
+      model.Backward(model.Responses().cols(4, 19), pairGradient);
+      CheckMatrices(pairGradient, gradient, 1e-5);
+    }
+
+    const MemoryPlanner& planner = model.TrainingPlan().Planner();
+    BOOST_REQUIRE_LT(planner.ArenaSize(), planner.TotalSize());
+    if (intervals[k] == 0)
+      fullArenaSize = planner.ArenaSize();
+    else
+      BOOST_REQUIRE_LT(planner.ArenaSize(), fullArenaSize);
+  }
+
+  const MemoryPlanner& inferencePlanner = model.InferencePlan().Planner();
+  BOOST_REQUIRE_LT(inferencePlanner.ArenaSize(),
+      inferencePlanner.TotalSize());
+
+  // Unplanned passes are not affected by the earlier planned passes.
+  model.PlanMemory() = false;
+  arma::mat unplannedGradient;
+  BOOST_REQUIRE_CLOSE(model.EvaluateWithGradient(model.Parameters(), 4,
+      unplannedGradient, 16), objective, 1e-5);
+  CheckMatrices(unplannedGradient, gradient, 1e-5);
+}
+
+/**
+ * Make sure that folding BatchNorm layers and fusing activations into the
+ * Linear layers keeps the deterministic output of the network, and that the
+ * fused activations give the same gradient.
+ */
+BOOST_AUTO_TEST_CASE(FuseLayersTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 64);
+  arma::mat responses = arma::randu<arma::mat>(2, 64);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Linear<> >(5, 8);
+  model.Add<BatchNorm<> >(8);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(8, 8);
+  model.Add<LeakyReLU<> >(0.1);
+  model.Add<Linear<> >(8, 6);
+  model.Add<BatchNorm<> >(6);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(6, 2);
+  model.Add<SigmoidLayer<> >();
+
+  // Train for one epoch, so that the BatchNorm layers have statistics.
+  ens::RMSProp opt(0.01, 16, 0.88, 1e-8, data.n_cols, -1);
+  model.Train(data, responses, opt);
+
+  arma::mat predictions, fusedPredictions;
+  model.Predict(data, predictions);
+
+  BOOST_REQUIRE_EQUAL(model.FuseLayers(), 6);
+  BOOST_REQUIRE_EQUAL(model.Model().size(), 4);
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, 5 * 8 + 8 + 8 * 8 + 8 +
+      8 * 6 + 6 + 6 * 2 + 2);
+
+  model.Predict(data, fusedPredictions);
+  CheckMatrices(fusedPredictions, predictions, 1e-5);
+
+  // Without BatchNorm layers, the parameters stay the same and so must the
+  // gradient.
+  FFN<MeanSquaredError<>, RandomInitialization> network;
+  network.Add<Linear<> >(5, 8);
+  network.Add<SigmoidLayer<> >();
+  network.Add<Linear<> >(8, 6);
+  network.Add<LeakyReLU<> >(0.2);
+  network.Add<Linear<> >(6, 4);
+  network.Add<ReLULayer<> >();
+  network.Add<Linear<> >(4, 2);
+  network.Add<TanHLayer<> >();
+  network.Predictors() = data;
+  network.Responses() = responses;
+
+  arma::mat gradient, fusedGradient;
+  const double objective = network.EvaluateWithGradient(network.Parameters(),
+      0, gradient, 32);
+  BOOST_REQUIRE_EQUAL(network.FuseLayers(), 4);
+  const double fusedObjective = network.EvaluateWithGradient(
+      network.Parameters(), 0, fusedGradient, 32);
+
+  BOOST_REQUIRE_CLOSE(fusedObjective, objective, 1e-5);
+  CheckMatrices(fusedGradient, gradient, 1e-5);
+}
+
+/**
+ * Make sure that the int8 quantized network is close to the float network, for
+ * per-channel and per-layer scales, and that it survives serialization.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedFFNTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 100);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Linear<> >(10, 20);
+  model.Add<ReLULayer<> >();
+  model.Add<LinearNoBias<> >(20, 12);
+  model.Add<TanHLayer<> >();
+  model.Add<Linear<> >(12, 5);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  for (size_t perChannel = 0; perChannel < 2; ++perChannel)
+  {
+    QuantizedFFN<MeanSquaredError<>, RandomInitialization> quantized(model,
+        data, perChannel == 1);
+    BOOST_REQUIRE_EQUAL(quantized.QuantizedLayers(), 3);
+    BOOST_REQUIRE_EQUAL(quantized.WeightBytes(), 10 * 20 + 20 * 12 + 12 * 5);
+
+    arma::mat quantizedPredictions;
+    quantized.Predict(data, quantizedPredictions);
+    BOOST_REQUIRE_EQUAL(quantizedPredictions.n_rows, predictions.n_rows);
+    BOOST_REQUIRE_EQUAL(quantizedPredictions.n_cols, predictions.n_cols);
+    BOOST_REQUIRE_LT(arma::norm(quantizedPredictions - predictions, "fro") /
+        arma::norm(predictions, "fro"), 0.05);
+
+    QuantizationReport report = quantized.Report(data);
+    BOOST_REQUIRE_LT(report.relativeError, 0.05);
+    BOOST_REQUIRE_LE(report.meanError, report.maxError);
+    BOOST_REQUIRE_GT(report.agreement, 0.8);
+    BOOST_REQUIRE_EQUAL(report.weightErrors.n_elem, 3);
+    BOOST_REQUIRE_LT(report.weightErrors.max(), 0.02);
+
+    QuantizedFFN<MeanSquaredError<>, RandomInitialization> xmlQuantized,
+        textQuantized, binaryQuantized;
+    SerializeObjectAll(quantized, xmlQuantized, textQuantized,
+        binaryQuantized);
+
+    arma::mat xmlPredictions, textPredictions, binaryPredictions;
+    xmlQuantized.Predict(data, xmlPredictions);
+    textQuantized.Predict(data, textPredictions);
+    binaryQuantized.Predict(data, binaryPredictions);
+    CheckMatrices(xmlPredictions, quantizedPredictions);
+    CheckMatrices(textPredictions, quantizedPredictions);
+    CheckMatrices(binaryPredictions, quantizedPredictions);
+  }
+}
+
+/**
+ * Make sure that a quantized convolution with padding is close to the float
+ * one.
+ */
+BOOST_AUTO_TEST_CASE(QuantizedConvolutionTest)
+{
+  arma::mat data = arma::randu<arma::mat>(2 * 8 * 8, 20);
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Convolution<> >(2, 4, 3, 3, 1, 1, 1, 1, 8, 8);
+  model.Add<ReLULayer<> >();
+  model.Add<Convolution<> >(4, 3, 2, 2, 2, 2, 0, 0, 8, 8);
+  model.Add<ReLULayer<> >();
+  model.Add<Linear<> >(3 * 4 * 4, 3);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  QuantizedFFN<MeanSquaredError<>, RandomInitialization> quantized(model,
+      data);
+  BOOST_REQUIRE_EQUAL(quantized.QuantizedLayers(), 3);
+
+  arma::mat quantizedPredictions;
+  quantized.Predict(data, quantizedPredictions);
+  BOOST_REQUIRE_LT(arma::norm(quantizedPredictions - predictions, "fro") /
+      arma::norm(predictions, "fro"), 0.05);
+}
+
+/**
+ * Make sure that a network can be trained on a dataset streamed from disk, and
+ * that Shuffle() keeps the points with their responses.
+ */
+BOOST_AUTO_TEST_CASE(StreamingTrainTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 200);
+  arma::mat responses = arma::sum(data, 0) / 4.0;
+
+  FFN<MeanSquaredError<>, RandomInitialization> model;
+  model.Add<Linear<> >(4, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 1);
+
+  model.Predictors() = data;
+  model.Responses() = responses;
+  model.Shuffle();
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(arma::accu(model.Predictors().col(i)) / 4.0,
+        model.Responses()(0, i), 1e-5);
+  }
+
+  {
+    data::BatchWriter writer("test_stream_x.mmat", 4, 200);
+    writer.Write(data);
+    writer.Close();
+    data::BatchWriter responsesWriter("test_stream_y.mmat", 1, 200);
+    responsesWriter.Write(responses);
+    responsesWriter.Close();
+  }
+
+  model.ResetParameters();
+  const double initialObjective = model.Evaluate(model.Parameters(), 0, 200);
+
+  {
+    data::BatchLoader loader("test_stream_x.mmat", "test_stream_y.mmat", 50);
+    ens::RMSProp opt(0.01, 10, 0.88, 1e-8, 50, -1);
+    model.Train(loader, opt, 20);
+  }
+
+  model.Predictors() = data;
+  model.Responses() = responses;
+  BOOST_REQUIRE_LT(model.Evaluate(model.Parameters(), 0, 200),
+      initialObjective);
+
+  remove("test_stream_x.mmat");
+  remove("test_stream_y.mmat");
+}
+
+/**
+ * Make sure that a StaticFFN gives the same objective and gradient as an FFN
+ * with the same layers and parameters, that a copy predicts the same, and that
+ * it can be trained.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 64);
+  arma::mat responses = arma::randu<arma::mat>(2, 64);
+
+  FFN<MeanSquaredError<>, RandomInitialization> network;
+  network.Add<Linear<> >(5, 8);
+  network.Add<SigmoidLayer<> >();
+  network.Add<Linear<> >(8, 2);
+  network.Add<TanHLayer<> >();
+  network.ResetParameters();
+  network.Predictors() = data;
+  network.Responses() = responses;
+
+  StaticFFN<MeanSquaredError<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, TanHLayer<> > model(Linear<>(5, 8),
+      SigmoidLayer<>(), Linear<>(8, 2), TanHLayer<>());
+  model.ResetParameters();
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem,
+      network.Parameters().n_elem);
+  model.Parameters() = network.Parameters();
+  model.Predictors() = data;
+  model.Responses() = responses;
+
+  arma::mat gradient, staticGradient;
+  const double objective = network.EvaluateWithGradient(network.Parameters(),
+      0, gradient, 32);
+  const double staticObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, staticGradient, 32);
+
+  BOOST_REQUIRE_CLOSE(staticObjective, objective, 1e-5);
+  CheckMatrices(staticGradient, gradient, 1e-5);
+
+  arma::mat predictions, staticPredictions, copyPredictions;
+  network.Predict(data, predictions);
+  model.Predict(data, staticPredictions);
+  CheckMatrices(staticPredictions, predictions, 1e-5);
+
+  StaticFFN<MeanSquaredError<>, RandomInitialization, Linear<>,
+      SigmoidLayer<>, Linear<>, TanHLayer<> > copy(model);
+  copy.Predict(data, copyPredictions);
+  CheckMatrices(copyPredictions, staticPredictions, 1e-10);
+
+  // Training the copy doesn't change the original network.
+  const double before = copy.Evaluate(data, responses);
+  ens::RMSProp opt(0.01, 16, 0.99, 1e-8, 20 * data.n_cols, -1);
+  copy.Train(data, responses, opt);
+  BOOST_REQUIRE_LT(copy.Evaluate(data, responses), before);
+
+  model.Predict(data, copyPredictions);
+  CheckMatrices(copyPredictions, staticPredictions, 1e-10);
+}
+
+/**
+ * Make sure that profiling times the passes through each layer and counts the
+ * floating point operations of the Linear layers.
+ */
+BOOST_AUTO_TEST_CASE(FFNProfileTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 64);
+  arma::mat responses = arma::randu<arma::mat>(2, 64);
+
+  FFN<MeanSquaredError<>, RandomInitialization> network;
+  network.Add<Linear<> >(5, 8);
+  network.Add<SigmoidLayer<> >();
+  network.Add<Linear<> >(8, 2);
+  network.Profile() = true;
+  network.Predictors() = data;
+  network.Responses() = responses;
+
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  const uint64_t batchSize = 32;
+  arma::mat gradient;
+  network.EvaluateWithGradient(network.Parameters(), 0, gradient, batchSize);
+
+  // The first layer has no backward pass.
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("ffn_layer_0_flops"),
+      2 * 2 * 5 * 8 * batchSize);
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("ffn_layer_1_flops"), (uint64_t) 0);
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("ffn_layer_2_flops"),
+      3 * 2 * 8 * 2 * batchSize);
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("ffn_layer_2_bytes"),
+      3 * sizeof(double) * (8 * 2 + 2 + (8 + 2) * batchSize));
+
+  std::ostringstream report;
+  network.ProfileReport(report);
+  BOOST_REQUIRE_NE(report.str().find("Linear"), std::string::npos);
+  BOOST_REQUIRE_NE(report.str().find("SigmoidFunction"), std::string::npos);
+
+  Timer::DisableTiming();
+  Timer::ResetAll();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
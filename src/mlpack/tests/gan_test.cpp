@@ -129,6 +129,68 @@ BOOST_AUTO_TEST_CASE(GANTest)
   BOOST_REQUIRE_LE(generatedStd - originalStd, 0.2);
 }
 
+/**
+ * Make sure that a pipelined training step gives the same objective and
+ * gradient as a sequential one, and that Generate() returns the requested
+ * number of samples.
+ */
+BOOST_AUTO_TEST_CASE(GANPipelinedTest)
+{
+  const size_t batchSize = 8;
+  const size_t noiseDim = 2;
+
+  arma::mat trainData(1, 64);
+  trainData.imbue( [&]() { return arma::as_scalar(RandNormal(4, 0.5));});
+
+  FFN<CrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 8);
+  discriminator.Add<ReLULayer<> >();
+  discriminator.Add<Linear<> >(8, 1);
+  discriminator.Add<SigmoidLayer<> >();
+
+  FFN<CrossEntropyError<> > generator;
+  generator.Add<Linear<> >(noiseDim, 8);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(8, 1);
+
+  GaussianInitialization gaussian(0, 0.1);
+  std::function<double ()> noiseFunction = [](){ return math::Random(-8, 8); };
+  GAN<FFN<CrossEntropyError<> >,
+      GaussianInitialization,
+      std::function<double()> >
+  gan(trainData, generator, discriminator, gaussian, noiseFunction,
+      noiseDim, batchSize, 1, 0, 1);
+  GAN<FFN<CrossEntropyError<> >,
+      GaussianInitialization,
+      std::function<double()> >
+  pipelinedGan(trainData, generator, discriminator, gaussian, noiseFunction,
+      noiseDim, batchSize, 1, 0, 1);
+  gan.Reset();
+  pipelinedGan.Reset();
+  pipelinedGan.Parameters() = gan.Parameters();
+  pipelinedGan.Pipelined() = true;
+
+  arma::mat gradient, pipelinedGradient;
+  math::RandomSeed(12);
+  const double objective = gan.EvaluateWithGradient(gan.Parameters(), 8,
+      gradient, batchSize);
+  math::RandomSeed(12);
+  const double pipelinedObjective = pipelinedGan.EvaluateWithGradient(
+      pipelinedGan.Parameters(), 8, pipelinedGradient, batchSize);
+
+  BOOST_REQUIRE_CLOSE(objective, pipelinedObjective, 1e-8);
+  BOOST_REQUIRE_EQUAL(gradient.n_elem, pipelinedGradient.n_elem);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(gradient[i] - pipelinedGradient[i], 1e-10);
+
+  // The last batch of samples is smaller than the batch size.
+  arma::mat samples;
+  gan.Generate(20, samples);
+  BOOST_REQUIRE_EQUAL(samples.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(samples.n_cols, 20);
+  BOOST_REQUIRE(samples.is_finite());
+}
+
 /*
  * Tests the GAN implementation of the O'Reilly Test on the MNIST dataset.
  * It's not viable to train on bigger parameters due to time constraints.
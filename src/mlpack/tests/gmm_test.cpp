@@ -18,9 +18,14 @@
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
 #include <mlpack/methods/gmm/diagonal_constraint.hpp>
 #include <mlpack/methods/gmm/eigenvalue_ratio_constraint.hpp>
+#include <mlpack/methods/gmm/kd_tree_e_step.hpp>
+#include <mlpack/methods/gmm/distributed_em_fit.hpp>
+#include <mlpack/methods/gmm/stochastic_em_fit.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
+#include "serialization.hpp"
+#include "thread_all_reduce.hpp"
 
 using namespace mlpack;
 using namespace mlpack::gmm;
@@ -78,6 +83,81 @@ BOOST_AUTO_TEST_CASE(GMMProbabilityComponentTest)
   BOOST_REQUIRE_CLOSE(gmm.Probability("1.4 0", 1), 0.0067568972024, 1e-5);
 }
 
+/**
+ * Test that GMM::LogProbability() for many observations at once matches the
+ * log probability of each observation.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchLogProbabilityTest)
+{
+  // Create a GMM (same as the last test).
+  GMM gmm(2, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Weights() = "0.3 0.7";
+
+  arma::mat observations("0 1 2 3 -1 1.4 50;"
+                         "0 1 2 3 5.3 0 -40");
+  arma::vec logProbabilities;
+  gmm.LogProbability(observations, logProbabilities);
+
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_elem, observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(logProbabilities[i],
+        gmm.LogProbability(observations.col(i)), 1e-5);
+
+  arma::vec probabilities;
+  gmm.Probability(observations, probabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, observations.n_cols);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    if (probabilities[i] == 0.0)
+      BOOST_REQUIRE_SMALL(gmm.Probability(observations.col(i)), 1e-300);
+    else
+      BOOST_REQUIRE_CLOSE(probabilities[i],
+          gmm.Probability(observations.col(i)), 1e-5);
+  }
+}
+
+/**
+ * Make sure that the log probabilities of each component match the single ones,
+ * across several blocks of observations, and that Classify() picks the most
+ * likely component.
+ */
+BOOST_AUTO_TEST_CASE(GMMComponentLogProbabilitiesTest)
+{
+  GMM gmm(3, 2);
+  gmm.Component(0) = distribution::GaussianDistribution("0 0", "1 0; 0 1");
+  gmm.Component(1) = distribution::GaussianDistribution("3 3", "2 1; 1 2");
+  gmm.Component(2) = distribution::GaussianDistribution("-3 2", "0.5 0; 0 3");
+  gmm.Weights() = "0.3 0.5 0.2";
+
+  arma::mat observations(2, 2100, arma::fill::randn);
+  observations *= 3;
+
+  arma::mat logProbabilities;
+  gmm.ComponentLogProbabilities(observations, logProbabilities);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(logProbabilities.n_cols, observations.n_cols);
+
+  arma::Row<size_t> labels;
+  gmm.Classify(observations, labels);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, observations.n_cols);
+
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    size_t best = 0;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const double logProbability = gmm.LogProbability(observations.col(i), j);
+      BOOST_REQUIRE_CLOSE(logProbabilities(j, i), logProbability, 1e-5);
+      if (logProbability > gmm.LogProbability(observations.col(i), best))
+        best = j;
+    }
+
+    BOOST_REQUIRE_EQUAL(labels[i], best);
+  }
+}
+
 /**
  * Test training a model on only one Gaussian (randomly generated) in two
  * dimensions.  We will vary the dataset size from small to large.  The EM
@@ -894,4 +974,410 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
   }
 }
 
+/**
+ * Make sure that the parallel EM algorithm gives the same model regardless of
+ * the number of threads, on a dataset with several blocks of observations.
+ */
+BOOST_AUTO_TEST_CASE(EMFitThreadIndependenceTest)
+{
+  // Generate points from three Gaussians.
+  arma::mat data(3, 6000);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::vec mean(3, arma::fill::zeros);
+    mean[i] = 5.0;
+    distribution::GaussianDistribution d(mean, (i + 1) * arma::eye(3, 3));
+    for (size_t j = 0; j < 2000; ++j)
+      data.col(2000 * i + j) = d.Random();
+  }
+
+  // Start both runs from the same initial model.
+  std::vector<distribution::GaussianDistribution> dists(3,
+      distribution::GaussianDistribution(3));
+  for (size_t i = 0; i < 3; ++i)
+    dists[i].Mean() = data.col(2000 * i);
+  arma::vec weights(3);
+  weights.fill(1.0 / 3.0);
+
+  std::vector<distribution::GaussianDistribution> serialDists(dists);
+  arma::vec serialWeights(weights);
+
+  EMFit<> em(50, 1e-10);
+  em.Estimate(data, dists, weights, true);
+
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  em.Estimate(data, serialDists, serialWeights, true);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(weights[i], serialWeights[i], 1e-8);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(dists[i].Mean()[j] + 10.0,
+          serialDists[i].Mean()[j] + 10.0, 1e-8);
+      for (size_t k = 0; k < 3; ++k)
+      {
+        BOOST_REQUIRE_CLOSE(dists[i].Covariance()(j, k) + 1.0,
+            serialDists[i].Covariance()(j, k) + 1.0, 1e-8);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that KDTreeEStep gives the same statistics as NaiveEStep (for
+ * diagonal covariances) when nothing is pruned, and close statistics with the
+ * default tolerance.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeEStepStatisticsTest)
+{
+  std::vector<distribution::GaussianDistribution> dists;
+  dists.push_back(distribution::GaussianDistribution("0.0 1.0 0.0",
+      "1.0 0.0 0.0; 0.0 0.8 0.0; 0.0 0.0 1.0"));
+  dists.push_back(distribution::GaussianDistribution("2.0 -1.0 5.0",
+      "3.0 0.0 0.0; 0.0 1.2 0.0; 0.0 0.0 1.3"));
+  dists.push_back(distribution::GaussianDistribution("0.0 5.0 -3.0",
+      "2.0 0.0 0.0; 0.0 0.3 0.0; 0.0 0.0 1.0"));
+  arma::vec weights("0.2 0.3 0.5");
+
+  arma::mat points(3, 5000);
+  for (size_t i = 0; i < 5000; ++i)
+    points.col(i) = dists[i % 3].Random();
+
+  NaiveEStep naive;
+  naive.Initialize(points);
+  arma::vec counts;
+  std::vector<arma::vec> means;
+  std::vector<arma::mat> covariances;
+  const double l = naive.Statistics(dists, weights, counts, means,
+      covariances);
+
+  // With a tolerance of 0, every point is evaluated exactly.
+  KDTreeEStep exact(0.0);
+  exact.Initialize(points);
+  arma::vec exactCounts;
+  std::vector<arma::vec> exactMeans;
+  std::vector<arma::mat> exactCovariances;
+  const double exactL = exact.Statistics(dists, weights, exactCounts,
+      exactMeans, exactCovariances);
+
+  BOOST_REQUIRE_EQUAL(exact.Evaluated(), 5000);
+  BOOST_REQUIRE_CLOSE(exactL, l, 1e-5);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(exactCounts[i], counts[i], 1e-5);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(exactMeans[i][j] + 10.0, means[i][j] + 10.0, 1e-5);
+      BOOST_REQUIRE_CLOSE(exactCovariances[i](j, j), covariances[i](j, j),
+          1e-5);
+    }
+  }
+
+  // With the default tolerance, some nodes are summarized.
+  KDTreeEStep approx;
+  approx.Initialize(points);
+  arma::vec approxCounts;
+  std::vector<arma::vec> approxMeans;
+  std::vector<arma::mat> approxCovariances;
+  const double approxL = approx.Statistics(dists, weights, approxCounts,
+      approxMeans, approxCovariances);
+
+  BOOST_REQUIRE_GT(approx.Summarized(), 0);
+  BOOST_REQUIRE_LT(approx.Evaluated(), 5000);
+  BOOST_REQUIRE_CLOSE(approxL, l, 1.0);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(approxCounts[i], counts[i], 1.0);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_SMALL(approxMeans[i][j] - means[i][j], 0.05);
+      BOOST_REQUIRE_SMALL(approxCovariances[i](j, j) - covariances[i](j, j),
+          0.05);
+    }
+  }
+
+  // Probabilities of 1 give the same result as no probabilities.
+  KDTreeEStep weighted;
+  weighted.Initialize(points, arma::ones<arma::vec>(5000));
+  arma::vec weightedCounts;
+  std::vector<arma::vec> weightedMeans;
+  std::vector<arma::mat> weightedCovariances;
+  const double weightedL = weighted.Statistics(dists, weights, weightedCounts,
+      weightedMeans, weightedCovariances);
+
+  BOOST_REQUIRE_CLOSE(weightedL, approxL, 1e-10);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(weightedCounts[i], approxCounts[i], 1e-10);
+}
+
+/**
+ * Make sure we can fit a diagonal GMM reasonably with KDTreeEStep.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeEStepDiagonalGMMTrainTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0 0.0", "1.0 0.0 0.0;"
+                                                       "0.0 0.8 0.0;"
+                                                       "0.0 0.0 1.0");
+  distribution::GaussianDistribution d2("2.0 -1.0 5.0", "3.0 0.0 0.0;"
+                                                        "0.0 1.2 0.0;"
+                                                        "0.0 0.0 1.3");
+  distribution::GaussianDistribution d3("0.0 5.0 -3.0", "2.0 0.0 0.0;"
+                                                        "0.0 0.3 0.0;"
+                                                        "0.0 0.0 1.0");
+
+  arma::mat points(3, 5000);
+  for (size_t i = 0; i < 5000; i++)
+  {
+    double randValue = math::Random();
+
+    if (randValue <= 0.20) // p(d1) = 0.20
+      points.col(i) = d1.Random();
+    else if (randValue <= 0.50) // p(d2) = 0.30
+      points.col(i) = d2.Random();
+    else // p(d3) = 0.50
+      points.col(i) = d3.Random();
+  }
+
+  GMM g(3, 3);
+  g.Train<EMFit<kmeans::KMeans<>, DiagonalConstraint, KDTreeEStep>>(points, 5);
+
+  // Order by weights so that we can compare to the right Gaussian.
+  arma::uvec sortedIndices = sort_index(g.Weights());
+  const distribution::GaussianDistribution* dists[3] = { &d1, &d2, &d3 };
+  const double trueWeights[3] = { 0.2, 0.3, 0.5 };
+  for (size_t k = 0; k < 3; ++k)
+  {
+    const distribution::GaussianDistribution& d = g.Component(
+        sortedIndices[k]);
+    BOOST_REQUIRE_SMALL(g.Weights()[sortedIndices[k]] - trueWeights[k], 0.1);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_SMALL(d.Mean()[i] - dists[k]->Mean()[i], 0.4);
+      for (size_t j = 0; j < 3; ++j)
+      {
+        const double v = d.Covariance()(i, j);
+        if (i == j)
+          BOOST_REQUIRE_SMALL(v - dists[k]->Covariance()(i, j), 0.5);
+        else
+          BOOST_REQUIRE_SMALL(v, 1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that distributed EM on a single process gives the model of EMFit,
+ * and that the "processes" of threads that hold the partitions of the dataset
+ * all find the same model.
+ */
+BOOST_AUTO_TEST_CASE(DistributedEMFitThreadTest)
+{
+  distribution::GaussianDistribution d1("0 0", "1 0.3; 0.3 1");
+  distribution::GaussianDistribution d2("4 3", "2 -0.5; -0.5 1");
+  arma::mat observations(2, 6000);
+  for (size_t i = 0; i < 6000; ++i)
+    observations.col(i) = (i % 3 == 0) ? d2.Random() : d1.Random();
+
+  std::vector<distribution::GaussianDistribution> initialDists(2,
+      distribution::GaussianDistribution("0 0", "1 0; 0 1"));
+  initialDists[1].Mean() = arma::vec("3 3");
+  const arma::vec initialWeights("0.5 0.5");
+
+  std::vector<distribution::GaussianDistribution> dists = initialDists;
+  arma::vec weights = initialWeights;
+  EMFit<> em(500, 1e-10);
+  em.Estimate(observations, dists, weights, true);
+
+  std::vector<distribution::GaussianDistribution> singleDists = initialDists;
+  arma::vec singleWeights = initialWeights;
+  DistributedEMFit<> singleEM(500, 1e-10);
+  singleEM.Estimate(observations, singleDists, singleWeights);
+
+  const size_t numThreads = 3;
+  const size_t bounds[numThreads + 1] = { 0, 1000, 4500, 6000 };
+  ThreadAllReduceState state(numThreads);
+  std::vector<std::vector<distribution::GaussianDistribution>> threadDists(
+      numThreads, initialDists);
+  std::vector<arma::vec> threadWeights(numThreads, initialWeights);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread([&, t]()
+    {
+      const arma::mat part = observations.cols(bounds[t], bounds[t + 1] - 1);
+      DistributedEMFit<ThreadAllReduce> threadEM(500, 1e-10,
+          ThreadAllReduce(&state));
+      threadEM.Estimate(part, threadDists[t], threadWeights[t]);
+    }));
+  }
+  for (size_t t = 0; t < numThreads; ++t)
+    threads[t].join();
+
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    CheckMatrices(threadWeights[t], threadWeights[0], 1e-12);
+    for (size_t i = 0; i < 2; ++i)
+    {
+      CheckMatrices(threadDists[t][i].Mean(), threadDists[0][i].Mean(),
+          1e-12);
+      CheckMatrices(threadDists[t][i].Covariance(),
+          threadDists[0][i].Covariance(), 1e-12);
+    }
+  }
+
+  for (size_t i = 0; i < 2; ++i)
+  {
+    CheckMatrices(singleDists[i].Mean(), dists[i].Mean(), 1e-4);
+    CheckMatrices(singleDists[i].Covariance(), dists[i].Covariance(), 1e-4);
+    CheckMatrices(threadDists[0][i].Mean(), dists[i].Mean(), 1e-4);
+    CheckMatrices(threadDists[0][i].Covariance(), dists[i].Covariance(),
+        1e-4);
+  }
+  CheckMatrices(singleWeights, weights, 1e-4);
+  CheckMatrices(threadWeights[0], weights, 1e-4);
+
+  // The smaller Gaussian has about a third of the points.
+  const size_t small = (weights[0] < weights[1]) ? 0 : 1;
+  BOOST_REQUIRE_CLOSE(weights[small], 1.0 / 3.0, 5.0);
+}
+
+/**
+ * Make sure that stochastic EM, in mini-batches, gives a model close to that of
+ * batch EM from the same initial model.
+ */
+BOOST_AUTO_TEST_CASE(StochasticEMFitTest)
+{
+  distribution::GaussianDistribution d1("0 0", "1 0.3; 0.3 1");
+  distribution::GaussianDistribution d2("6 5", "2 -0.5; -0.5 1");
+  arma::mat observations(2, 20000);
+  for (size_t i = 0; i < 20000; ++i)
+    observations.col(i) = (i % 3 == 0) ? d2.Random() : d1.Random();
+
+  std::vector<distribution::GaussianDistribution> initialDists(2,
+      distribution::GaussianDistribution("0 0", "1 0; 0 1"));
+  initialDists[1].Mean() = arma::vec("4 4");
+  const arma::vec initialWeights("0.5 0.5");
+
+  std::vector<distribution::GaussianDistribution> dists = initialDists;
+  arma::vec weights = initialWeights;
+  EMFit<> em(500, 1e-10);
+  em.Estimate(observations, dists, weights, true);
+
+  std::vector<distribution::GaussianDistribution> stochasticDists =
+      initialDists;
+  arma::vec stochasticWeights = initialWeights;
+  StochasticEMFit<> stochasticEM(500, 3);
+  stochasticEM.Estimate(observations, stochasticDists, stochasticWeights,
+      true);
+
+  // There are 40 batches in each pass.
+  BOOST_REQUIRE_GT(stochasticEM.Steps(), (size_t) 0);
+  BOOST_REQUIRE_LE(stochasticEM.Steps(), (size_t) 120);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    BOOST_REQUIRE_SMALL(arma::norm(stochasticDists[i].Mean() -
+        dists[i].Mean()), 0.1);
+    BOOST_REQUIRE_SMALL(arma::norm(stochasticDists[i].Covariance() -
+        dists[i].Covariance()), 0.2);
+  }
+  BOOST_REQUIRE_SMALL(std::abs(stochasticWeights[0] - weights[0]), 0.02);
+  BOOST_REQUIRE_SMALL(std::abs(arma::accu(stochasticWeights) - 1.0), 1e-10);
+}
+
+/**
+ * Make sure that GMM::Update() on a stream of batches, starting from an
+ * untrained model, fits the model about as well as batch training.
+ */
+BOOST_AUTO_TEST_CASE(GMMUpdateTest)
+{
+  distribution::GaussianDistribution d1("0 0", "1 0.3; 0.3 1");
+  distribution::GaussianDistribution d2("6 5", "2 -0.5; -0.5 1");
+  arma::mat observations(2, 15000);
+  for (size_t i = 0; i < 15000; ++i)
+    observations.col(i) = (i % 3 == 0) ? d2.Random() : d1.Random();
+
+  GMM gmm(2, 2);
+  for (size_t b = 0; b < 30; ++b)
+    gmm.Update(observations.cols(500 * b, 500 * (b + 1) - 1));
+  BOOST_REQUIRE_EQUAL(gmm.Updater().Steps(), 30);
+
+  GMM batchGMM(2, 2);
+  batchGMM.Train(observations);
+
+  // Compare the log-likelihoods of held-out points.
+  arma::mat testObservations(2, 3000);
+  for (size_t i = 0; i < 3000; ++i)
+    testObservations.col(i) = (i % 3 == 0) ? d2.Random() : d1.Random();
+  arma::vec logProbabilities, batchLogProbabilities;
+  gmm.LogProbability(testObservations, logProbabilities);
+  batchGMM.LogProbability(testObservations, batchLogProbabilities);
+  BOOST_REQUIRE_CLOSE(arma::accu(logProbabilities),
+      arma::accu(batchLogProbabilities), 1.0);
+
+  // The smaller Gaussian has about a third of the points.
+  const size_t small = (gmm.Weights()[0] < gmm.Weights()[1]) ? 0 : 1;
+  BOOST_REQUIRE_CLOSE(gmm.Weights()[small], 1.0 / 3.0, 10.0);
+  BOOST_REQUIRE_SMALL(arma::norm(gmm.Component(small).Mean() - d2.Mean()),
+      0.2);
+  BOOST_REQUIRE_SMALL(arma::norm(gmm.Component(1 - small).Mean() -
+      d1.Mean()), 0.2);
+
+  // Training forgets the running statistics.
+  gmm.Train(observations);
+  BOOST_REQUIRE_EQUAL(gmm.Updater().Steps(), 0);
+  gmm.Update(observations.cols(0, 499), true);
+  BOOST_REQUIRE_EQUAL(gmm.Updater().Steps(), 1);
+}
+
+/**
+ * Make sure that the running statistics of GMM::Update() are serialized, so
+ * that a loaded model continues the stream in the same way.
+ */
+BOOST_AUTO_TEST_CASE(GMMUpdateSerializationTest)
+{
+  distribution::GaussianDistribution d1("0 0", "1 0.3; 0.3 1");
+  distribution::GaussianDistribution d2("6 5", "2 -0.5; -0.5 1");
+  arma::mat observations(2, 3000);
+  for (size_t i = 0; i < 3000; ++i)
+    observations.col(i) = (i % 3 == 0) ? d2.Random() : d1.Random();
+
+  GMM gmm(2, 2);
+  gmm.Update(observations.cols(0, 999));
+  gmm.Update(observations.cols(1000, 1999));
+
+  GMM xmlGMM, textGMM, binaryGMM;
+  SerializeObjectAll(gmm, xmlGMM, textGMM, binaryGMM);
+
+  gmm.Update(observations.cols(2000, 2999));
+  xmlGMM.Update(observations.cols(2000, 2999));
+  textGMM.Update(observations.cols(2000, 2999));
+  binaryGMM.Update(observations.cols(2000, 2999));
+
+  BOOST_REQUIRE_EQUAL(xmlGMM.Updater().Steps(), 3);
+  BOOST_REQUIRE_EQUAL(textGMM.Updater().Steps(), 3);
+  BOOST_REQUIRE_EQUAL(binaryGMM.Updater().Steps(), 3);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    CheckMatrices(gmm.Component(i).Mean(), xmlGMM.Component(i).Mean());
+    CheckMatrices(gmm.Component(i).Mean(), textGMM.Component(i).Mean());
+    CheckMatrices(gmm.Component(i).Mean(), binaryGMM.Component(i).Mean());
+    CheckMatrices(gmm.Component(i).Covariance(),
+        xmlGMM.Component(i).Covariance());
+    CheckMatrices(gmm.Component(i).Covariance(),
+        textGMM.Component(i).Covariance());
+    CheckMatrices(gmm.Component(i).Covariance(),
+        binaryGMM.Component(i).Covariance());
+  }
+  CheckMatrices(gmm.Weights(), xmlGMM.Weights());
+  CheckMatrices(gmm.Weights(), textGMM.Weights());
+  CheckMatrices(gmm.Weights(), binaryGMM.Weights());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,276 @@
+/**
+ * @file gradient_boosting_test.cpp
+ *
+ * Tests for the GradientBoosting class and related classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/mse_gain.hpp>
+#include <mlpack/methods/gradient_boosting/gradient_boosting.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(GradientBoostingTest);
+
+/**
+ * Make sure the MSE gain is the negated variance, with and without weights.
+ */
+BOOST_AUTO_TEST_CASE(MSEGainTest)
+{
+  arma::rowvec responses("1 2 3 4");
+  arma::rowvec weights("1 1 1 1");
+
+  BOOST_REQUIRE_CLOSE(MSEGain::Evaluate<false>(responses, weights), -1.25,
+      1e-5);
+  BOOST_REQUIRE_CLOSE(MSEGain::Evaluate<true>(responses, weights), -1.25,
+      1e-5);
+
+  // Weighting the first point by 3 is the same as repeating it.
+  weights[0] = 3.0;
+  arma::rowvec repeated("1 1 1 2 3 4");
+  BOOST_REQUIRE_CLOSE(MSEGain::Evaluate<true>(responses, weights),
+      MSEGain::Evaluate<false>(repeated, weights), 1e-5);
+
+  BOOST_REQUIRE_CLOSE(MSEGain::EvaluateSums(10.0, 30.0, 4.0), -1.25, 1e-5);
+
+  // Constant responses have no error.
+  arma::rowvec constant("2 2 2");
+  BOOST_REQUIRE_SMALL(MSEGain::Evaluate<false>(constant, weights), 1e-10);
+  BOOST_REQUIRE_SMALL(MSEGain::EvaluateSums(0.0, 0.0, 0.0), 1e-10);
+}
+
+/**
+ * Make sure that each distinct value gets its own bin if there are few, and
+ * that the bins are consistent with their upper edges.
+ */
+BOOST_AUTO_TEST_CASE(FeatureBinnerTest)
+{
+  arma::mat data(2, 1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    data(0, i) = (double) (i % 5);
+    data(1, i) = math::Random();
+  }
+
+  FeatureBinner binner(data, 32);
+  BOOST_REQUIRE_EQUAL(binner.Dimensionality(), 2);
+  BOOST_REQUIRE_EQUAL(binner.NumBins(0), 5);
+  BOOST_REQUIRE_EQUAL(binner.NumBins(1), 32);
+
+  arma::Mat<unsigned char> bins;
+  binner.Bin(data, bins);
+  BOOST_REQUIRE_EQUAL(bins.n_rows, 1000);
+  BOOST_REQUIRE_EQUAL(bins.n_cols, 2);
+
+  arma::Col<size_t> counts(32, arma::fill::zeros);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL((size_t) bins(i, 0), i % 5);
+    ++counts[bins(i, 1)];
+
+    // The split between bins is the same as the split at the upper edge.
+    for (size_t d = 0; d < 2; ++d)
+    {
+      for (size_t b = 0; b + 1 < binner.NumBins(d); ++b)
+      {
+        BOOST_REQUIRE_EQUAL(bins(i, d) <= b,
+            data(d, i) <= binner.UpperEdge(d, b));
+      }
+    }
+  }
+
+  // The quantile bins should hold about the same number of points.
+  for (size_t b = 0; b < 32; ++b)
+    BOOST_REQUIRE_LE(counts[b], 2 * 1000 / 32);
+}
+
+/**
+ * A regression tree of depth 1 should find the step of a step function.
+ */
+BOOST_AUTO_TEST_CASE(RegressionTreeStepTest)
+{
+  // With few points, each value has its own bin, so the step can be found
+  // exactly.
+  arma::mat data(3, 200);
+  data.randu();
+  arma::rowvec targets(200);
+  for (size_t i = 0; i < 200; ++i)
+    targets[i] = (data(1, i) <= 0.3) ? -2.0 : 5.0;
+
+  FeatureBinner binner(data);
+  arma::Mat<unsigned char> bins;
+  binner.Bin(data, bins);
+
+  std::vector<size_t> points(200), features = { 0, 1, 2 };
+  for (size_t i = 0; i < 200; ++i)
+    points[i] = i;
+
+  RegressionTree<> tree;
+  tree.Train(bins, binner, targets, points, features, 1, 1);
+
+  BOOST_REQUIRE_EQUAL(tree.NumNodes(), 3);
+  BOOST_REQUIRE_EQUAL(tree.SplitFeature(0), 1);
+  for (size_t i = 0; i < 200; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(tree.Predict(data.col(i)), targets[i], 1e-5);
+    BOOST_REQUIRE_EQUAL(tree.Leaf(bins, i), tree.Leaf(data.col(i)));
+  }
+
+  // With a depth of 0, the tree is a leaf with the mean target.
+  tree.Train(bins, binner, targets, points, features, 0, 1);
+  BOOST_REQUIRE_EQUAL(tree.NumNodes(), 1);
+  BOOST_REQUIRE_CLOSE(tree.Value(0), arma::mean(targets), 1e-5);
+}
+
+/**
+ * Gradient boosting with the squared error should fit a smooth nonlinear
+ * function, and more trees should fit it better.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingSquaredErrorTest)
+{
+  arma::mat data(2, 2000);
+  data.randu();
+  data *= 4.0;
+  arma::rowvec responses = arma::sin(data.row(0)) + 0.25 *
+      arma::square(data.row(1));
+
+  arma::mat testData(2, 500);
+  testData.randu();
+  testData *= 4.0;
+  arma::rowvec testResponses = arma::sin(testData.row(0)) + 0.25 *
+      arma::square(testData.row(1));
+
+  GradientBoosting small, large;
+  small.Train<SquaredErrorLoss>(data, responses, 5, 0.1, 4, 10);
+  large.Train<SquaredErrorLoss>(data, responses, 200, 0.1, 4, 10);
+  BOOST_REQUIRE_EQUAL(large.NumTrees(), 200);
+  BOOST_REQUIRE_EQUAL(large.Dimensionality(), 2);
+
+  arma::rowvec smallPredictions, largePredictions;
+  small.Predict(testData, smallPredictions);
+  large.Predict(testData, largePredictions);
+
+  const double smallError = arma::mean(arma::square(smallPredictions -
+      testResponses));
+  const double largeError = arma::mean(arma::square(largePredictions -
+      testResponses));
+
+  BOOST_REQUIRE_LT(largeError, smallError);
+  BOOST_REQUIRE_LT(largeError, 0.02);
+}
+
+/**
+ * With the absolute error, a few huge outliers should not move the
+ * predictions much.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingAbsoluteErrorTest)
+{
+  arma::mat data(1, 1000);
+  data.randu();
+  arma::rowvec responses = 2.0 * data.row(0);
+  for (size_t i = 0; i < 1000; i += 50)
+    responses[i] += 1000.0;
+
+  GradientBoosting absolute, squared;
+  absolute.Train<AbsoluteErrorLoss>(data, responses, 100, 0.2, 3, 10);
+  squared.Train<SquaredErrorLoss>(data, responses, 100, 0.2, 3, 10);
+
+  arma::mat testData = arma::linspace<arma::rowvec>(0.05, 0.95, 19);
+  arma::rowvec expected = 2.0 * testData.row(0);
+  arma::rowvec absolutePredictions, squaredPredictions;
+  absolute.Predict(testData, absolutePredictions);
+  squared.Predict(testData, squaredPredictions);
+
+  BOOST_REQUIRE_CLOSE(absolute.InitialValue(), arma::median(responses), 1e-5);
+  BOOST_REQUIRE_LT(arma::max(arma::abs(absolutePredictions - expected)), 0.25);
+  BOOST_REQUIRE_GT(arma::max(arma::abs(squaredPredictions - expected)), 1.0);
+}
+
+/**
+ * Subsampling should still learn, and be reproducible with the same seed.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingSubsampleTest)
+{
+  arma::mat data(4, 1000);
+  data.randu();
+  arma::rowvec responses = 3.0 * data.row(0) - data.row(2);
+
+  GradientBoosting a, b;
+  math::RandomSeed(42);
+  a.Train<SquaredErrorLoss>(data, responses, 100, 0.1, 3, 5, 0.5, 0.5);
+  math::RandomSeed(42);
+  b.Train<SquaredErrorLoss>(data, responses, 100, 0.1, 3, 5, 0.5, 0.5);
+
+  arma::rowvec aPredictions, bPredictions;
+  a.Predict(data, aPredictions);
+  b.Predict(data, bPredictions);
+
+  CheckMatrices(aPredictions, bPredictions);
+  BOOST_REQUIRE_LT(arma::mean(arma::square(aPredictions - responses)), 0.05);
+}
+
+/**
+ * Invalid parameters should throw.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingInvalidParametersTest)
+{
+  arma::mat data(2, 100);
+  data.randu();
+  arma::rowvec responses(100, arma::fill::randu);
+  arma::rowvec shortResponses(99, arma::fill::randu);
+
+  GradientBoosting gb;
+  BOOST_REQUIRE_THROW(gb.Train(data, shortResponses), std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(data, responses, 10, 0.0),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(data, responses, 10, 0.1, 3, 10, 1.5),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(gb.Train(data, responses, 10, 0.1, 3, 10, 1.0, 1.0, 1),
+      std::invalid_argument);
+
+  gb.Train(data, responses, 10);
+  arma::mat wrongData(3, 10, arma::fill::randu);
+  arma::rowvec predictions;
+  BOOST_REQUIRE_THROW(gb.Predict(wrongData, predictions),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure a serialized model predicts the same.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingSerializationTest)
+{
+  arma::mat data(3, 500);
+  data.randu();
+  arma::rowvec responses = data.row(0) % data.row(1) + data.row(2);
+
+  GradientBoosting gb;
+  gb.Train<SquaredErrorLoss>(data, responses, 20, 0.1, 3, 5);
+
+  arma::rowvec predictions;
+  gb.Predict(data, predictions);
+
+  GradientBoosting xmlGb, textGb, binaryGb;
+  SerializeObjectAll(gb, xmlGb, textGb, binaryGb);
+
+  arma::rowvec xmlPredictions, textPredictions, binaryPredictions;
+  xmlGb.Predict(data, xmlPredictions);
+  textGb.Predict(data, textPredictions);
+  binaryGb.Predict(data, binaryPredictions);
+
+  BOOST_REQUIRE_EQUAL(xmlGb.NumTrees(), 20);
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, textPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,258 @@
+/**
+ * @file hdbscan_test.cpp
+ *
+ * Test the HDBSCAN implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hdbscan/hdbscan.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::hdbscan;
+using namespace mlpack::emst;
+using namespace mlpack::metric;
+using namespace mlpack::tree;
+
+BOOST_AUTO_TEST_SUITE(HDBSCANTest);
+
+// Generate three well-separated Gaussian clusters of 100 points each; the
+// points of cluster i are in the columns 100i to 100i + 99.
+arma::mat ThreeClusters()
+{
+  arma::mat points(2, 300, arma::fill::randn);
+  points.cols(100, 199).row(0) += 20.0;
+  points.cols(200, 299).row(1) += 20.0;
+  return points;
+}
+
+/**
+ * Check the condensed tree of a simple dendrogram by hand.
+ */
+BOOST_AUTO_TEST_CASE(CondensedTreeTest)
+{
+  // Two pairs of points: 0 and 1 at distance 1, 2 and 3 at distance 1, and
+  // the pairs at distance 4.
+  arma::mat mst("0 2 1;"
+                "1 3 2;"
+                "1 1 4");
+  Dendrogram dendrogram(mst);
+  CondensedTree tree(dendrogram.Linkage(), 2);
+
+  // The root splits into two clusters at lambda 0.25, and each of them loses
+  // both of its points at lambda 1.
+  BOOST_REQUIRE_EQUAL(tree.NumClusters(), 3);
+  BOOST_REQUIRE_EQUAL(tree.Tree().n_rows, 4);
+  BOOST_REQUIRE_EQUAL(tree.Tree().n_cols, 6);
+
+  size_t clusterChildren = 0;
+  std::vector<size_t> pointParents(4, 0);
+  for (size_t i = 0; i < tree.Tree().n_cols; ++i)
+  {
+    const size_t child = (size_t) tree.Tree()(1, i);
+    if (child >= 4)
+    {
+      BOOST_REQUIRE_EQUAL(tree.Tree()(0, i), 4);
+      BOOST_REQUIRE_CLOSE(tree.Tree()(2, i), 0.25, 1e-5);
+      BOOST_REQUIRE_EQUAL(tree.Tree()(3, i), 2);
+      ++clusterChildren;
+    }
+    else
+    {
+      BOOST_REQUIRE_CLOSE(tree.Tree()(2, i), 1.0, 1e-5);
+      BOOST_REQUIRE_EQUAL(tree.Tree()(3, i), 1);
+      pointParents[child] = (size_t) tree.Tree()(0, i);
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(clusterChildren, 2);
+  BOOST_REQUIRE_EQUAL(pointParents[0], pointParents[1]);
+  BOOST_REQUIRE_EQUAL(pointParents[2], pointParents[3]);
+  BOOST_REQUIRE_NE(pointParents[0], pointParents[2]);
+
+  // The stability of each child cluster is (1 - 0.25) * 2.
+  BOOST_REQUIRE_CLOSE(tree.Stabilities()[1], 1.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(tree.Stabilities()[2], 1.5, 1e-5);
+
+  arma::Row<size_t> assignments;
+  BOOST_REQUIRE_EQUAL(tree.ExtractClusters(assignments), 2);
+  BOOST_REQUIRE_EQUAL(assignments[0], assignments[1]);
+  BOOST_REQUIRE_EQUAL(assignments[2], assignments[3]);
+  BOOST_REQUIRE_NE(assignments[0], assignments[2]);
+}
+
+/**
+ * Every point of the dataset should appear exactly once as a child in the
+ * condensed tree.
+ */
+BOOST_AUTO_TEST_CASE(CondensedTreePointsTest)
+{
+  arma::mat points = ThreeClusters();
+
+  HDBSCAN<> h(5);
+  arma::Row<size_t> assignments;
+  arma::mat condensedTree;
+  h.Cluster(points, assignments, condensedTree);
+
+  BOOST_REQUIRE_EQUAL(condensedTree.n_rows, 4);
+  arma::Col<size_t> counts(points.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < condensedTree.n_cols; ++i)
+  {
+    // Children clusters follow their parents.
+    BOOST_REQUIRE_GE(condensedTree(0, i), points.n_cols);
+    if (condensedTree(1, i) < points.n_cols)
+      ++counts[(size_t) condensedTree(1, i)];
+    else
+      BOOST_REQUIRE_GT(condensedTree(1, i), condensedTree(0, i));
+  }
+
+  for (size_t i = 0; i < counts.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
+/**
+ * Make sure that three well-separated clusters are found.
+ */
+BOOST_AUTO_TEST_CASE(ThreeClusterTest)
+{
+  arma::mat points = ThreeClusters();
+
+  HDBSCAN<> h(10);
+  arma::Row<size_t> assignments;
+  const size_t clusters = h.Cluster(points, assignments);
+
+  BOOST_REQUIRE_EQUAL(clusters, 3);
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
+
+  // Find the label of each cluster from its points, skipping noise.
+  size_t noise = 0;
+  arma::Col<size_t> labels(3);
+  labels.fill(SIZE_MAX);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    if (assignments[i] == SIZE_MAX)
+    {
+      ++noise;
+      continue;
+    }
+
+    BOOST_REQUIRE_LT(assignments[i], 3);
+    if (labels[i / 100] == SIZE_MAX)
+      labels[i / 100] = assignments[i];
+    BOOST_REQUIRE_EQUAL(assignments[i], labels[i / 100]);
+  }
+
+  // Only a few points may be noise.
+  BOOST_REQUIRE_LT(noise, 30);
+  BOOST_REQUIRE_NE(labels[0], labels[1]);
+  BOOST_REQUIRE_NE(labels[0], labels[2]);
+  BOOST_REQUIRE_NE(labels[1], labels[2]);
+}
+
+// Make sure that the points clustered by both clusterings are clustered the
+// same way, up to the numbering of the clusters.
+void CheckSameClusters(const arma::Row<size_t>& a, const arma::Row<size_t>& b)
+{
+  BOOST_REQUIRE_EQUAL(a.n_elem, b.n_elem);
+  std::map<size_t, size_t> aToB, bToA;
+  for (size_t i = 0; i < a.n_elem; ++i)
+  {
+    if (a[i] == SIZE_MAX || b[i] == SIZE_MAX)
+      continue;
+
+    if (aToB.count(a[i]) == 0)
+      aToB[a[i]] = b[i];
+    if (bToA.count(b[i]) == 0)
+      bToA[b[i]] = a[i];
+
+    BOOST_REQUIRE_EQUAL(aToB[a[i]], b[i]);
+    BOOST_REQUIRE_EQUAL(bToA[b[i]], a[i]);
+  }
+}
+
+/**
+ * The clustering should not depend on the type of tree.
+ */
+BOOST_AUTO_TEST_CASE(TreeTypeTest)
+{
+  arma::mat points = ThreeClusters();
+
+  HDBSCAN<> kd(10);
+  arma::Row<size_t> kdAssignments;
+  const size_t kdClusters = kd.Cluster(points, kdAssignments);
+
+  HDBSCAN<EuclideanDistance, arma::mat, StandardCoverTree> cover(10);
+  arma::Row<size_t> coverAssignments;
+  const size_t coverClusters = cover.Cluster(points, coverAssignments);
+
+  HDBSCAN<EuclideanDistance, arma::mat, BallTree> ball(10);
+  arma::Row<size_t> ballAssignments;
+  const size_t ballClusters = ball.Cluster(points, ballAssignments);
+
+  BOOST_REQUIRE_EQUAL(kdClusters, coverClusters);
+  BOOST_REQUIRE_EQUAL(kdClusters, ballClusters);
+
+  // The mutual reachability distances have many ties, so the minimum spanning
+  // trees (and the numbering of the clusters, and maybe some noise points) may
+  // differ.
+  CheckSameClusters(kdAssignments, coverAssignments);
+  CheckSameClusters(kdAssignments, ballAssignments);
+}
+
+/**
+ * Check the core distances against a brute-force computation.
+ */
+BOOST_AUTO_TEST_CASE(CoreDistancesTest)
+{
+  arma::mat points(3, 100, arma::fill::randu);
+
+  HDBSCAN<> h(5, 4);
+  arma::vec coreDistances;
+  h.CoreDistances(points, coreDistances);
+
+  BOOST_REQUIRE_EQUAL(coreDistances.n_elem, points.n_cols);
+  EuclideanDistance metric;
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    arma::vec distances(points.n_cols);
+    for (size_t j = 0; j < points.n_cols; ++j)
+      distances[j] = metric.Evaluate(points.col(i), points.col(j));
+
+    // The point itself is the first of the four neighbors.
+    distances = arma::sort(distances);
+    BOOST_REQUIRE_CLOSE(coreDistances[i], distances[3], 1e-5);
+  }
+
+  // With one point, the core distances are 0.
+  h.MinPoints() = 1;
+  h.CoreDistances(points, coreDistances);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(coreDistances[i], 0.0);
+}
+
+/**
+ * Make sure invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(InvalidParametersTest)
+{
+  arma::mat points(3, 10, arma::fill::randu);
+  arma::Row<size_t> assignments;
+
+  HDBSCAN<> small(1);
+  BOOST_REQUIRE_THROW(small.Cluster(points, assignments),
+      std::invalid_argument);
+
+  // Not enough points for the core distances.
+  HDBSCAN<> large(20);
+  BOOST_REQUIRE_THROW(large.Cluster(points, assignments),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -10,6 +10,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/hmm_online_filter.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -1287,5 +1288,379 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
           hmm2.Emission()[j].Probabilities()[i], 1e-3);
 }
 
+/**
+ * Make sure that the forward-backward algorithm gives the same log-likelihood
+ * as a straightforward log-domain forward algorithm on a long sequence, and that
+ * the state probabilities are normalized.
+ */
+BOOST_AUTO_TEST_CASE(GMMHMMLongSequenceEstimateTest)
+{
+  HMM<GMM> hmm(3, GMM(2, 2));
+  hmm.Transition() = arma::mat("0.8 0.1 0.0;"
+                               "0.2 0.8 0.3;"
+                               "0.0 0.1 0.7");
+  for (size_t s = 0; s < 3; ++s)
+  {
+    hmm.Emission()[s].Weights() = "0.4 0.6";
+    hmm.Emission()[s].Component(0) = GaussianDistribution(
+        arma::vec(3.0 * s * arma::ones<arma::vec>(2)),
+        arma::mat("1.0 0.2; 0.2 1.0"));
+    hmm.Emission()[s].Component(1) = GaussianDistribution(
+        arma::vec(arma::vec("1.0 -1.0") - 2.0 * s),
+        arma::mat("0.5 0.0; 0.0 0.8"));
+  }
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  hmm.Generate(5000, dataSeq, stateSeq);
+
+  // The reference log-likelihood.
+  const double inf = std::numeric_limits<double>::infinity();
+  arma::vec logForward(3);
+  for (size_t s = 0; s < 3; ++s)
+    logForward[s] = std::log(hmm.Initial()[s]) +
+        hmm.Emission()[s].LogProbability(dataSeq.col(0));
+  for (size_t t = 1; t < dataSeq.n_cols; ++t)
+  {
+    arma::vec next(3);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      double sum = -inf;
+      for (size_t i = 0; i < 3; ++i)
+        sum = math::LogAdd(sum, logForward[i] +
+            std::log(hmm.Transition()(j, i)));
+      next[j] = sum + hmm.Emission()[j].LogProbability(dataSeq.col(t));
+    }
+    logForward = next;
+  }
+  const double logLikelihood = math::AccuLog(logForward);
+
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(dataSeq), logLikelihood, 1e-8);
+
+  arma::mat stateProb;
+  BOOST_REQUIRE_CLOSE(hmm.Estimate(dataSeq, stateProb), logLikelihood, 1e-8);
+  BOOST_REQUIRE_EQUAL(stateProb.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(stateProb.n_cols, dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; ++t)
+    BOOST_REQUIRE_CLOSE(arma::accu(stateProb.col(t)), 1.0, 1e-8);
+}
+
+/**
+ * Make sure that the batched Viterbi gives the same results as running the
+ * Viterbi algorithm on each sequence.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMBatchPredictTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.5 0.2 0.3;"
+                               "0.3 0.6 0.1;"
+                               "0.2 0.2 0.6");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("3.0 1.0", "1.0 0.3; 0.3 1.5");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 4.0", "0.8 0.0; 0.0 0.5");
+
+  // Generate sequences of different lengths.
+  std::vector<arma::mat> dataSeq(50);
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(10 + 20 * i, dataSeq[i], stateSeq);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeq;
+  arma::vec logLikelihoods;
+  hmm.Predict(dataSeq, stateSeq, logLikelihoods);
+
+  BOOST_REQUIRE_EQUAL(stateSeq.size(), dataSeq.size());
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, dataSeq.size());
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    arma::Row<size_t> singleStateSeq;
+    const double logLikelihood = hmm.Predict(dataSeq[i], singleStateSeq);
+
+    BOOST_REQUIRE_EQUAL(stateSeq[i].n_elem, singleStateSeq.n_elem);
+    for (size_t t = 0; t < singleStateSeq.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(stateSeq[i][t], singleStateSeq[t]);
+    BOOST_REQUIRE_CLOSE(logLikelihoods[i], logLikelihood, 1e-10);
+  }
+}
+
+/**
+ * Make sure that training on many sequences gives the same model no matter the
+ * number of threads.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMParallelTrainTest)
+{
+  HMM<GaussianDistribution> hmm(2, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.7 0.4; 0.3 0.6");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("4.0 2.0", "1.2 0.4; 0.4 0.9");
+
+  std::vector<arma::mat> dataSeq(40);
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(200, dataSeq[i], stateSeq);
+  }
+
+  // Start from a poor guess.
+  HMM<GaussianDistribution> hmm1(2, GaussianDistribution(2));
+  hmm1.Emission()[0].Mean() = "0.5 -0.5";
+  hmm1.Emission()[1].Mean() = "3.0 3.0";
+  HMM<GaussianDistribution> hmm2(hmm1);
+
+  hmm1.Train(dataSeq);
+
+#ifdef HAS_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+
+  hmm2.Train(dataSeq);
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  // The partial results of each thread are combined in a different order, so
+  // the results are only equal up to rounding.
+  for (size_t i = 0; i < 2; ++i)
+    BOOST_REQUIRE_SMALL(hmm1.Initial()[i] - hmm2.Initial()[i], 1e-5);
+
+  for (size_t i = 0; i < 4; ++i)
+    BOOST_REQUIRE_SMALL(hmm1.Transition()[i] - hmm2.Transition()[i], 1e-5);
+
+  for (size_t s = 0; s < 2; ++s)
+  {
+    for (size_t d = 0; d < 2; ++d)
+      BOOST_REQUIRE_SMALL(hmm1.Emission()[s].Mean()[d] -
+          hmm2.Emission()[s].Mean()[d], 1e-5);
+    for (size_t d = 0; d < 4; ++d)
+      BOOST_REQUIRE_SMALL(hmm1.Emission()[s].Covariance()[d] -
+          hmm2.Emission()[s].Covariance()[d], 1e-5);
+  }
+}
+
+/**
+ * Create a left-to-right discrete HMM with the given number of states: each
+ * state either stays or moves to the next state, so the transition matrix is
+ * sparse, and each state emits one of four symbols.
+ */
+HMM<DiscreteDistribution> LeftToRightHMM(const size_t states)
+{
+  arma::mat transition(states, states, arma::fill::zeros);
+  for (size_t i = 0; i < states - 1; ++i)
+  {
+    transition(i, i) = 0.7;
+    transition(i + 1, i) = 0.3;
+  }
+  transition(states - 1, states - 1) = 1.0;
+
+  arma::vec initial(states, arma::fill::zeros);
+  initial.subvec(0, 4).fill(0.2);
+
+  std::vector<DiscreteDistribution> emission(states, DiscreteDistribution(4));
+  for (size_t i = 0; i < states; ++i)
+  {
+    emission[i].Probabilities() = arma::randu<arma::vec>(4) + 0.1;
+    emission[i].Probabilities() /= arma::accu(emission[i].Probabilities());
+  }
+
+  return HMM<DiscreteDistribution>(initial, transition, emission);
+}
+
+/**
+ * Compute the log-likelihood of the given state sequence and data sequence.
+ */
+double PathLogLikelihood(const HMM<DiscreteDistribution>& hmm,
+                         const arma::mat& dataSeq,
+                         const arma::Row<size_t>& stateSeq)
+{
+  double logLikelihood = std::log(hmm.Initial()[stateSeq[0]]);
+  for (size_t t = 0; t < dataSeq.n_cols; ++t)
+  {
+    if (t > 0)
+      logLikelihood += std::log(hmm.Transition()(stateSeq[t], stateSeq[t - 1]));
+    logLikelihood += hmm.Emission()[stateSeq[t]].LogProbability(
+        dataSeq.col(t));
+  }
+
+  return logLikelihood;
+}
+
+/**
+ * Make sure that the sparse transitions of a left-to-right HMM give the same
+ * results as dense transitions, by comparing with the same HMM where
+ * every transition has a negligible probability.
+ */
+BOOST_AUTO_TEST_CASE(SparseTransitionTest)
+{
+  HMM<DiscreteDistribution> hmm = LeftToRightHMM(60);
+  HMM<DiscreteDistribution> denseHmm(hmm);
+  denseHmm.Transition() += 1e-200;
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  hmm.Generate(150, dataSeq, stateSeq);
+
+  // Check the Viterbi algorithm.
+  arma::Row<size_t> sparseStates, denseStates;
+  const double sparseLogLikelihood = hmm.Predict(dataSeq, sparseStates);
+  const double denseLogLikelihood = denseHmm.Predict(dataSeq, denseStates);
+
+  BOOST_REQUIRE_EQUAL(sparseStates.n_elem, denseStates.n_elem);
+  for (size_t t = 0; t < sparseStates.n_elem; ++t)
+    BOOST_REQUIRE_EQUAL(sparseStates[t], denseStates[t]);
+  BOOST_REQUIRE_CLOSE(sparseLogLikelihood, denseLogLikelihood, 1e-8);
+  BOOST_REQUIRE_CLOSE(sparseLogLikelihood,
+      PathLogLikelihood(hmm, dataSeq, sparseStates), 1e-8);
+
+  // Check the forward-backward algorithm.
+  arma::mat sparseStateProb, denseStateProb;
+  const double sparseEstimate = hmm.Estimate(dataSeq, sparseStateProb);
+  const double denseEstimate = denseHmm.Estimate(dataSeq, denseStateProb);
+
+  BOOST_REQUIRE_CLOSE(sparseEstimate, denseEstimate, 1e-8);
+  BOOST_REQUIRE_CLOSE(hmm.LogLikelihood(dataSeq),
+      denseHmm.LogLikelihood(dataSeq), 1e-8);
+  BOOST_REQUIRE_EQUAL(sparseStateProb.n_rows, denseStateProb.n_rows);
+  BOOST_REQUIRE_EQUAL(sparseStateProb.n_cols, denseStateProb.n_cols);
+  for (size_t i = 0; i < sparseStateProb.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(sparseStateProb[i] - denseStateProb[i], 1e-8);
+}
+
+/**
+ * Make sure that beam pruning of the Viterbi algorithm gives the exact result
+ * with a wide enough beam, and a valid state sequence with a narrow beam.
+ */
+BOOST_AUTO_TEST_CASE(BeamViterbiTest)
+{
+  HMM<DiscreteDistribution> hmm = LeftToRightHMM(60);
+
+  std::vector<arma::mat> dataSeq(10);
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(100 + 10 * i, dataSeq[i], stateSeq);
+  }
+
+  std::vector<arma::Row<size_t>> beamStates;
+  arma::vec beamLogLikelihoods;
+  hmm.Predict(dataSeq, beamStates, beamLogLikelihoods, 3);
+
+  BOOST_REQUIRE_EQUAL(beamStates.size(), dataSeq.size());
+  for (size_t i = 0; i < dataSeq.size(); ++i)
+  {
+    arma::Row<size_t> exactStates, wideStates, narrowStates;
+    const double exact = hmm.Predict(dataSeq[i], exactStates);
+    const double wide = hmm.Predict(dataSeq[i], wideStates, 60);
+    const double narrow = hmm.Predict(dataSeq[i], narrowStates, 3);
+
+    // A beam of all states is the exact algorithm.
+    BOOST_REQUIRE_EQUAL(exactStates.n_elem, wideStates.n_elem);
+    for (size_t t = 0; t < exactStates.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(exactStates[t], wideStates[t]);
+    BOOST_REQUIRE_CLOSE(exact, wide, 1e-10);
+
+    // A narrow beam can't find a more probable sequence, and its
+    // log-likelihood must be that of the sequence it found.
+    BOOST_REQUIRE_EQUAL(narrowStates.n_elem, dataSeq[i].n_cols);
+    BOOST_REQUIRE_LE(narrow, exact + 1e-10);
+    BOOST_REQUIRE_CLOSE(narrow, PathLogLikelihood(hmm, dataSeq[i],
+        narrowStates), 1e-8);
+
+    // The batch prediction gives the same sequence.
+    BOOST_REQUIRE_EQUAL(beamStates[i].n_elem, narrowStates.n_elem);
+    for (size_t t = 0; t < narrowStates.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL(beamStates[i][t], narrowStates[t]);
+    BOOST_REQUIRE_CLOSE(beamLogLikelihoods[i], narrow, 1e-10);
+  }
+}
+
+/**
+ * Feed the given data sequence to an online filter with the given lag, in
+ * batches of the given size, and make sure that after each batch the filtered
+ * and smoothed probabilities and the log-likelihood are the same as those of
+ * the forward-backward algorithm on the observations so far.
+ */
+template<typename Distribution>
+void CheckOnlineFilter(const HMM<Distribution>& hmm,
+                       const arma::mat& dataSeq,
+                       const size_t lag,
+                       const size_t batchSize)
+{
+  HMMOnlineFilter<Distribution> filter(hmm, lag);
+  BOOST_REQUIRE_EQUAL(filter.Time(), 0);
+
+  double logLikelihood = 0.0;
+  for (size_t begin = 0; begin < dataSeq.n_cols; begin += batchSize)
+  {
+    const size_t end = std::min(begin + batchSize, (size_t) dataSeq.n_cols);
+    logLikelihood += filter.Update(dataSeq.cols(begin, end - 1));
+    BOOST_REQUIRE_EQUAL(filter.Time(), end);
+
+    arma::mat stateProb, forwardProb, backwardProb;
+    arma::vec scales;
+    const double estimate = hmm.Estimate(dataSeq.cols(0, end - 1), stateProb,
+        forwardProb, backwardProb, scales);
+
+    BOOST_REQUIRE_CLOSE(filter.LogLikelihood(), estimate, 1e-8);
+    BOOST_REQUIRE_CLOSE(logLikelihood, estimate, 1e-8);
+    for (size_t i = 0; i < forwardProb.n_rows; ++i)
+    {
+      BOOST_REQUIRE_SMALL(filter.StateProbabilities()[i] -
+          forwardProb(i, end - 1), 1e-8);
+      BOOST_REQUIRE_SMALL(filter.SmoothedProbabilities()[i] -
+          stateProb(i, filter.SmoothedTime()), 1e-8);
+    }
+  }
+
+  // A reset filter starts the sequence again.
+  filter.Reset();
+  BOOST_REQUIRE_EQUAL(filter.Time(), 0);
+  filter.Update(dataSeq.col(0));
+  BOOST_REQUIRE_CLOSE(filter.LogLikelihood(),
+      hmm.LogLikelihood(dataSeq.col(0)), 1e-8);
+}
+
+/**
+ * Make sure that the online filter and fixed-lag smoother of a Gaussian HMM
+ * agree with the forward-backward algorithm.
+ */
+BOOST_AUTO_TEST_CASE(GaussianHMMOnlineFilterTest)
+{
+  HMM<GaussianDistribution> hmm(3, GaussianDistribution(2));
+  hmm.Transition() = arma::mat("0.5 0.2 0.3;"
+                               "0.3 0.6 0.1;"
+                               "0.2 0.2 0.6");
+  hmm.Emission()[0] = GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  hmm.Emission()[1] = GaussianDistribution("3.0 1.0", "1.0 0.3; 0.3 1.5");
+  hmm.Emission()[2] = GaussianDistribution("-2.0 4.0", "0.8 0.0; 0.0 0.5");
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  hmm.Generate(60, dataSeq, stateSeq);
+
+  CheckOnlineFilter(hmm, dataSeq, 0, 1);
+  CheckOnlineFilter(hmm, dataSeq, 4, 1);
+  CheckOnlineFilter(hmm, dataSeq, 4, 7);
+}
+
+/**
+ * Make sure that the online filter and fixed-lag smoother of an HMM with
+ * sparse transitions agree with the forward-backward algorithm.
+ */
+BOOST_AUTO_TEST_CASE(SparseHMMOnlineFilterTest)
+{
+  HMM<DiscreteDistribution> hmm = LeftToRightHMM(60);
+
+  arma::mat dataSeq;
+  arma::Row<size_t> stateSeq;
+  hmm.Generate(80, dataSeq, stateSeq);
+
+  CheckOnlineFilter(hmm, dataSeq, 0, 1);
+  CheckOnlineFilter(hmm, dataSeq, 10, 3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
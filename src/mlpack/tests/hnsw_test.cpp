@@ -0,0 +1,157 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/hnsw/hnsw.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the recall of the search against the exact neighbors is high
+ * with the default parameters, and that it does not decrease with a larger ef.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  math::RandomSeed(3);
+  arma::mat reference(10, 2000, arma::fill::randu);
+  arma::mat query(10, 200, arma::fill::randu);
+  const size_t k = 10;
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, k, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(reference);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(query, k, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, query.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, k);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, query.n_cols);
+
+  const double recall = HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors);
+  BOOST_REQUIRE_GE(recall, 0.9);
+
+  // The distances must be those of the neighbors, in increasing order.
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    for (size_t j = 0; j < k; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), reference.n_cols);
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          query.col(i), reference.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+
+  hnsw.Ef() = 200;
+  hnsw.Search(query, k, neighbors, distances);
+  BOOST_REQUIRE_GE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      recall);
+}
+
+/**
+ * Make sure that the monochromatic search doesn't return each point as its own
+ * neighbor, and that it finds the exact neighbors of a small set.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  arma::mat reference(3, 100, arma::fill::randu);
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(4, trueNeighbors, trueDistances);
+
+  // With ef as large as the reference set, the search is exact.
+  HNSWSearch<> hnsw(reference, 4, 100, 100);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(4, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 100);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  BOOST_REQUIRE_CLOSE(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      1.0, 1e-5);
+}
+
+/**
+ * Make sure that the graph only depends on the random seed, and that too large
+ * values of k and invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(HNSWDeterminismTest)
+{
+  arma::mat reference(5, 1000, arma::fill::randu);
+
+  math::RandomSeed(10);
+  HNSWSearch<> hnsw1(reference);
+  math::RandomSeed(10);
+  HNSWSearch<> hnsw2(reference);
+
+  BOOST_REQUIRE_EQUAL(hnsw1.Layers(), hnsw2.Layers());
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    BOOST_REQUIRE(hnsw1.Links(i, 0) == hnsw2.Links(i, 0));
+    BOOST_REQUIRE_LE(hnsw1.Links(i, 0).size(), 2 * hnsw1.M());
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(hnsw1.Search(reference, 1001, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw1.Search(1000, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(HNSWSearch<>(reference, 1), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(HNSWSerializationTest)
+{
+  arma::mat reference(4, 300, arma::fill::randu);
+  arma::mat query(4, 30, arma::fill::randu);
+
+  HNSWSearch<> hnsw(reference, 8, 50, 20);
+  HNSWSearch<> xmlHnsw, textHnsw, binaryHnsw;
+  SerializeObjectAll(hnsw, xmlHnsw, textHnsw, binaryHnsw);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(query, 3, neighbors, distances);
+  xmlHnsw.Search(query, 3, xmlNeighbors, xmlDistances);
+  textHnsw.Search(query, 3, textNeighbors, textDistances);
+  binaryHnsw.Search(query, 3, binaryNeighbors, binaryDistances);
+
+  BOOST_REQUIRE_EQUAL(xmlHnsw.M(), 8);
+  BOOST_REQUIRE_EQUAL(xmlHnsw.Ef(), 20);
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
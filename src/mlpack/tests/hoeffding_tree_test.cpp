@@ -16,6 +16,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
+#include <mlpack/methods/hoeffding_trees/hoeffding_forest.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -863,6 +864,61 @@ BOOST_AUTO_TEST_CASE(NumericHoeffdingTreeTest)
   BOOST_REQUIRE_GT(batchCorrect, 6000);
 }
 
+/**
+ * Make sure that training a tree in streaming mode on batches of points gives
+ * exactly the same tree as training it on one point at a time, even when the
+ * leaves split in the middle of a batch.
+ */
+BOOST_AUTO_TEST_CASE(StreamingBatchEquivalenceTest)
+{
+  // Generate data with a categorical feature that matters.
+  arma::mat dataset(4, 12000);
+  arma::Row<size_t> labels(12000);
+  data::DatasetInfo info(4);
+  info.MapString<double>("a", 3);
+  info.MapString<double>("b", 3);
+  info.MapString<double>("c", 3);
+  for (size_t i = 0; i < 12000; ++i)
+  {
+    const size_t category = mlpack::math::RandInt(3);
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random() + (category == 0 ? 1.0 : 0.0);
+    dataset(2, i) = mlpack::math::Random();
+    dataset(3, i) = category;
+    labels[i] = (dataset(1, i) > 1.0) ? 0 : ((dataset(0, i) > 0.3) ? 1 :
+        category);
+  }
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  TreeType pointTree(info, 3, 0.95, 5000, 50, 50);
+  for (size_t i = 0; i < 12000; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  // Use batches that don't line up with the check interval.
+  TreeType batchTree(info, 3, 0.95, 5000, 50, 50);
+  for (size_t i = 0; i < 12000; i += 777)
+  {
+    const size_t last = std::min(i + 777, (size_t) 12000) - 1;
+    arma::mat batch = dataset.cols(i, last);
+    arma::Row<size_t> batchLabels = labels.cols(i, last);
+    batchTree.Train(batch, batchLabels, false);
+  }
+
+  BOOST_REQUIRE_GT(pointTree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(batchTree.NumDescendants(), pointTree.NumDescendants());
+  BOOST_REQUIRE_EQUAL(batchTree.SplitDimension(), pointTree.SplitDimension());
+
+  arma::Row<size_t> pointPredictions, batchPredictions;
+  arma::rowvec pointProbabilities, batchProbabilities;
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+  for (size_t i = 0; i < 12000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(batchPredictions[i], pointPredictions[i]);
+    BOOST_REQUIRE_EQUAL(batchProbabilities[i], pointProbabilities[i]);
+  }
+}
+
 /**
  * The same as the previous test, but with the numeric binary split, and with a
  * categorical feature.
@@ -1462,4 +1518,159 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeModelSerializationTest)
   }
 }
 
+/**
+ * Generate the three-class numeric dataset of NumericHoeffdingTreeTest.
+ */
+void ThreeClassNumericDataset(arma::mat& dataset, arma::Row<size_t>& labels)
+{
+  dataset.set_size(3, 9000);
+  labels.set_size(9000);
+  for (size_t i = 0; i < 9000; i += 3)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::Random();
+    dataset(2, i) = mlpack::math::Random();
+    labels[i] = 0;
+
+    dataset(0, i + 1) = mlpack::math::Random();
+    dataset(1, i + 1) = mlpack::math::Random() - 1.0;
+    dataset(2, i + 1) = mlpack::math::Random() + 0.5;
+    labels[i + 1] = 2;
+
+    dataset(0, i + 2) = mlpack::math::Random();
+    dataset(1, i + 2) = mlpack::math::Random() + 1.0;
+    dataset(2, i + 2) = mlpack::math::Random() + 0.8;
+    labels[i + 2] = 1;
+  }
+}
+
+/**
+ * Make sure that a forest trained on mini-batches of a stream is accurate, and
+ * that its batch predictions are those of each point.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestAccuracyTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ThreeClassNumericDataset(dataset, labels);
+  data::DatasetInfo info(3);
+
+  HoeffdingForest<> forest(info, 3, 5);
+  for (size_t i = 0; i < 9000; i += 1000)
+  {
+    arma::mat batch = dataset.cols(i, i + 999);
+    arma::Row<size_t> batchLabels = labels.cols(i, i + 999);
+    forest.Train(batch, batchLabels);
+  }
+
+  BOOST_REQUIRE_EQUAL(forest.NumTrees(), 5);
+  for (size_t t = 0; t < forest.NumTrees(); ++t)
+    BOOST_REQUIRE_GT(forest.Tree(t).NumChildren(), 0);
+
+  arma::Row<size_t> predictions;
+  arma::rowvec probabilities;
+  forest.Classify(dataset, predictions, probabilities);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    size_t prediction;
+    double probability;
+    forest.Classify(dataset.col(i), prediction, probability);
+    BOOST_REQUIRE_EQUAL(predictions[i], prediction);
+    BOOST_REQUIRE_EQUAL(probabilities[i], probability);
+    BOOST_REQUIRE_GE(probability, 1.0 / 3.0);
+    BOOST_REQUIRE_LE(probability, 1.0);
+
+    if (predictions[i] == labels[i])
+      ++correct;
+  }
+
+  BOOST_REQUIRE_GT(correct, 6000);
+}
+
+/**
+ * Make sure that the forest only depends on the random seed.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestSeedTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ThreeClassNumericDataset(dataset, labels);
+  data::DatasetInfo info(3);
+
+  math::RandomSeed(12);
+  HoeffdingForest<> forest(dataset, info, labels, 3, 4, 1.0, 0.95, 0, 50, 50);
+  math::RandomSeed(12);
+  HoeffdingForest<> otherForest(dataset, info, labels, 3, 4, 1.0, 0.95, 0, 50,
+      50);
+
+  for (size_t t = 0; t < forest.NumTrees(); ++t)
+  {
+    BOOST_REQUIRE_EQUAL(forest.Tree(t).NumDescendants(),
+        otherForest.Tree(t).NumDescendants());
+  }
+
+  arma::Row<size_t> predictions, otherPredictions;
+  forest.Classify(dataset, predictions);
+  otherForest.Classify(dataset, otherPredictions);
+  CheckMatrices(predictions, otherPredictions);
+}
+
+/**
+ * Make sure that a serialized or copied forest gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestSerializationTest)
+{
+  arma::mat dataset;
+  arma::Row<size_t> labels;
+  ThreeClassNumericDataset(dataset, labels);
+  data::DatasetInfo info(3);
+
+  HoeffdingForest<> forest(dataset, info, labels, 3, 3, 2.0);
+  HoeffdingForest<> xmlForest, textForest, binaryForest;
+  SerializeObjectAll(forest, xmlForest, textForest, binaryForest);
+  HoeffdingForest<> copiedForest(forest);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.NumTrees(), 3);
+  BOOST_REQUIRE_EQUAL(textForest.Lambda(), 2.0);
+  BOOST_REQUIRE_EQUAL(binaryForest.NumClasses(), 3);
+
+  arma::Row<size_t> predictions, xmlPredictions, textPredictions,
+      binaryPredictions, copiedPredictions;
+  forest.Classify(dataset, predictions);
+  xmlForest.Classify(dataset, xmlPredictions);
+  textForest.Classify(dataset, textPredictions);
+  binaryForest.Classify(dataset, binaryPredictions);
+  copiedForest.Classify(dataset, copiedPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(predictions, copiedPredictions);
+}
+
+/**
+ * Make sure that invalid forests and mini-batches throw.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingForestInvalidTest)
+{
+  data::DatasetInfo info(3);
+  BOOST_REQUIRE_THROW(HoeffdingForest<>(info, 3, 0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(HoeffdingForest<>(info, 0, 5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(HoeffdingForest<>(info, 3, 5, 0.0),
+      std::invalid_argument);
+
+  arma::Row<size_t> predictions;
+  HoeffdingForest<> untrained;
+  BOOST_REQUIRE_THROW(untrained.Classify(arma::mat(3, 10), predictions),
+      std::invalid_argument);
+
+  HoeffdingForest<> forest(info, 3, 5);
+  arma::Row<size_t> labels(10, arma::fill::zeros);
+  BOOST_REQUIRE_THROW(forest.Train(arma::mat(4, 10, arma::fill::randu),
+      labels), std::invalid_argument);
+  BOOST_REQUIRE_THROW(forest.Train(arma::mat(3, 9, arma::fill::randu),
+      labels), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -326,6 +326,104 @@ BOOST_AUTO_TEST_CASE(HPTTest)
   BOOST_REQUIRE_CLOSE(expectedObjective, objective, 1e-5);
 }
 
+/**
+ * Test that assessing the candidates of GridSearch in parallel finds the same
+ * hyper-parameters and model as GridSearch.
+ */
+BOOST_AUTO_TEST_CASE(HPTParallelGridSearchTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      hpt(validationSize, xs, ys);
+  std::tie(expectedLambda1, expectedLambda2) = hpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      parallelHpt(validationSize, xs, ys);
+  parallelHpt.Parallel() = true;
+  std::tie(actualLambda1, actualLambda2) = parallelHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(), parallelHpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(parallelHpt.BestModel(), validationXs,
+      validationYs);
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(), objective, 1e-5);
+}
+
+/**
+ * Test that SuccessiveHalving assesses fewer candidates on all the training
+ * points than GridSearch, finds a candidate no better than the best one of
+ * GridSearch, and finds the same one as GridSearch when it has a single round.
+ */
+BOOST_AUTO_TEST_CASE(HPTSuccessiveHalvingTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, GridSearch>
+      hpt(validationSize, xs, ys);
+  std::tie(expectedLambda1, expectedLambda2) = hpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  // The 28 candidates are first trained on a third of the training points,
+  // then the best 9 of them on all of them.
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      shHpt(validationSize, xs, ys);
+  shHpt.Optimizer().MinFraction() = 1.0 / 3;
+  std::tie(actualLambda1, actualLambda2) = shHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_EQUAL(shHpt.Optimizer().Rounds(), 2);
+  BOOST_REQUIRE_CLOSE(shHpt.Optimizer().Cost(), 28.0 / 3 + 9, 1e-5);
+  BOOST_REQUIRE_GE(shHpt.BestObjective(), hpt.BestObjective() * (1 - 1e-7));
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+  double objective = MSE::Evaluate(shHpt.BestModel(), validationXs,
+      validationYs);
+  BOOST_REQUIRE_CLOSE(shHpt.BestObjective(), objective, 1e-5);
+
+  // With a single round, SuccessiveHalving is a parallel GridSearch.
+  HyperParameterTuner<LARS, MSE, SimpleCV, SuccessiveHalving>
+      gridHpt(validationSize, xs, ys);
+  gridHpt.Optimizer().MinFraction() = 1.0;
+  gridHpt.Parallel() = true;
+  std::tie(actualLambda1, actualLambda2) = gridHpt.Optimize(
+      Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  BOOST_REQUIRE_EQUAL(gridHpt.Optimizer().Rounds(), 1);
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(), gridHpt.BestObjective(), 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda1, actualLambda1, 1e-5);
+  BOOST_REQUIRE_CLOSE(expectedLambda2, actualLambda2, 1e-5);
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
@@ -229,6 +229,39 @@ BOOST_AUTO_TEST_CASE(MedianImputationTest)
   BOOST_REQUIRE_CLOSE(rowWiseInput(2, 2), 4.0, 1e-5);
 }
 
+/**
+ * Make sure that imputing several dimensions at once gives the same result as
+ * imputing them one by one.
+ */
+BOOST_AUTO_TEST_CASE(ImputerMultipleDimensionsTest)
+{
+  fstream f;
+  f.open("test_file.csv", fstream::out);
+  f << "a, 2, 3, 4" << endl;
+  f << "5, a, 7, a" << endl;
+  f << "8, 9, a, 1" << endl;
+  f << "a, 3, 6, 5" << endl;
+  f.close();
+
+  arma::mat input;
+  MissingPolicy policy({"a"});
+  DatasetMapper<MissingPolicy> info(policy);
+  BOOST_REQUIRE(data::Load("test_file.csv", input, info) == true);
+  remove("test_file.csv");
+
+  arma::mat serialInput(input);
+  Imputer<double, DatasetMapper<MissingPolicy>, MedianImputation<double>>
+      imputer(info);
+  for (size_t d = 0; d < 4; ++d)
+    imputer.Impute(serialInput, "a", d);
+
+  imputer.Impute(input, "a", std::vector<size_t>({ 0, 1, 2, 3 }));
+
+  CheckMatrices(input, serialInput);
+  BOOST_REQUIRE_CLOSE(input(0, 0), 6.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(input(3, 1), 4.0, 1e-5);
+}
+
 /**
  * Make sure ListwiseDeletion method deletes the whole column (if column wise)
  * or the row (if row wise) containing value of 0.
@@ -560,6 +560,202 @@ BOOST_AUTO_TEST_CASE(OneDimensionalTest)
     BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError*100);
 }
 
+/**
+ * Test parallel dual-tree implementation results against brute force results.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeKDETest)
+{
+  arma::mat reference = arma::randu(3, 500);
+  arma::mat query = arma::randu(3, 200);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.4;
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  // Parallel dual-tree KDE.
+  metric::EuclideanDistance metric;
+  KDE<GaussianKernel,
+      metric::EuclideanDistance,
+      arma::mat,
+      tree::KDTree>
+      kde(relError, 0.0, kernel, KDEMode::PARALLEL_DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+  kde.Evaluate(query, treeEstimations);
+
+  // Check whether results are equal.
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError*100);
+}
+
+/**
+ * Test parallel dual-tree monochromatic evaluation with a cover tree against
+ * brute force results that skip each point itself.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeMonochromaticKDETest)
+{
+  arma::mat reference = arma::randu(2, 300);
+  arma::vec bfEstimations = arma::vec(reference.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations;
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  metric::EuclideanDistance metric;
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    for (size_t j = 0; j < reference.n_cols; ++j)
+    {
+      if (i != j)
+      {
+        bfEstimations(i) += kernel.Evaluate(
+            metric.Evaluate(reference.col(i), reference.col(j)));
+      }
+    }
+  }
+  bfEstimations /= reference.n_cols;
+
+  // Parallel dual-tree KDE.
+  KDE<GaussianKernel,
+      metric::EuclideanDistance,
+      arma::mat,
+      tree::StandardCoverTree>
+      kde(relError, 0.0, kernel, KDEMode::PARALLEL_DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+  kde.Evaluate(treeEstimations);
+
+  // Check whether results are equal.
+  BOOST_REQUIRE_EQUAL(treeEstimations.n_elem, reference.n_cols);
+  for (size_t i = 0; i < reference.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError*100);
+}
+
+/**
+ * Test Monte Carlo estimations against brute force results.  Each estimation is
+ * only bounded with some probability, so this checks that almost all of them
+ * are within the relative error and all of them are close.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloGaussianKDETest)
+{
+  math::RandomSeed(17);
+  arma::mat reference = arma::randu(6, 5000);
+  arma::mat query = arma::randu(6, 100);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.5;
+  const double relError = 0.05;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  // Monte Carlo KDE, in single-tree and dual-tree modes.
+  metric::EuclideanDistance metric;
+  for (const KDEMode mode : { KDEMode::SINGLE_TREE_MODE,
+                              KDEMode::DUAL_TREE_MODE })
+  {
+    KDE<GaussianKernel,
+        metric::EuclideanDistance,
+        arma::mat,
+        tree::KDTree>
+        kde(relError, 0.0, kernel, mode, metric, true, 0.95, 100, 3, 0.4);
+    kde.Train(reference);
+    kde.Evaluate(query, treeEstimations);
+
+    size_t withinBounds = 0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      const double error = std::abs(bfEstimations[i] - treeEstimations[i]) /
+          bfEstimations[i];
+      if (error <= relError)
+        ++withinBounds;
+      BOOST_REQUIRE_LE(error, 3 * relError);
+    }
+    BOOST_REQUIRE_GE(withinBounds, 85);
+  }
+}
+
+/**
+ * Invalid Monte Carlo parameters should throw.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloInvalidParametersTest)
+{
+  typedef KDE<GaussianKernel, metric::EuclideanDistance, arma::mat,
+      tree::KDTree> KDEType;
+  GaussianKernel kernel(0.5);
+  metric::EuclideanDistance metric;
+  BOOST_REQUIRE_THROW(KDEType(0.05, 0.0, kernel, DUAL_TREE_MODE, metric, true,
+      1.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDEType(0.05, 0.0, kernel, DUAL_TREE_MODE, metric, true,
+      0.95, 1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDEType(0.05, 0.0, kernel, DUAL_TREE_MODE, metric, true,
+      0.95, 100, 0.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDEType(0.05, 0.0, kernel, DUAL_TREE_MODE, metric, true,
+      0.95, 100, 3, 1.5), std::invalid_argument);
+
+  KDEType kde(0.05, 0.0, kernel, DUAL_TREE_MODE, metric, true);
+  BOOST_REQUIRE_THROW(kde.MCProb(0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.MCBreakCoefficient(0.0), std::invalid_argument);
+}
+
+/**
+ * Make sure that an anytime evaluation without a budget is as accurate as the
+ * single-tree evaluation, and that with a budget the true densities are within
+ * the returned errors.
+ */
+BOOST_AUTO_TEST_CASE(AnytimeKDETest)
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = arma::randu(2, 100);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(0.3);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  KDE<GaussianKernel,
+      metric::EuclideanDistance,
+      arma::mat,
+      tree::KDTree>
+      kde(relError, 0.0, kernel);
+  kde.Train(reference);
+
+  arma::vec estimations, errors;
+  kde.AnytimeEvaluate(query, 0, 0.0, estimations, errors);
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], estimations[i], relError * 100);
+    BOOST_REQUIRE_EQUAL(errors[i], 0.0);
+  }
+
+  // Stop after the first leaf of each query point.
+  kde.AnytimeEvaluate(query, 1, 0.0, estimations, errors);
+  size_t unfinished = 0;
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    if (errors[i] > 0.0)
+      ++unfinished;
+
+    BOOST_REQUIRE_LE(std::abs(bfEstimations[i] - estimations[i]),
+        errors[i] + relError * bfEstimations[i] + 1e-12);
+  }
+  BOOST_REQUIRE_GT(unfinished, 0);
+}
+
 /**
  * Test a case where an empty reference set is given to train the model.
  */
@@ -818,4 +1014,150 @@ BOOST_AUTO_TEST_CASE(NotTrained)
   BOOST_REQUIRE_THROW(kde.Evaluate(estimations), std::runtime_error);
 }
 
+/**
+ * Dual-tree KDE with large leaves (so that the base cases between leaves are
+ * computed in blocks) should still be within the error tolerance of the brute
+ * force estimations.
+ */
+BOOST_AUTO_TEST_CASE(BlockBaseCaseTest)
+{
+  arma::mat reference = arma::randu(3, 2000) + 20.0;
+  arma::mat query = arma::randu(3, 500) + 20.0;
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations;
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.01;
+
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  typedef KDTree<EuclideanDistance, kde::KDEStat, arma::mat> Tree;
+  std::vector<size_t> oldFromNewQueries, oldFromNewReferences;
+  Tree* queryTree = new Tree(query, oldFromNewQueries, 64);
+  Tree* referenceTree = new Tree(reference, oldFromNewReferences, 64);
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+      kde(relError, 0.0, kernel);
+  kde.Train(referenceTree, &oldFromNewReferences);
+  kde.Evaluate(queryTree, oldFromNewQueries, treeEstimations);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError * 100);
+
+  delete queryTree;
+  delete referenceTree;
+}
+
+/**
+ * Test the dual-tree KDE with the parallel breadth-first traverser against
+ * brute force results.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBreadthFirstKDETest)
+{
+  arma::mat reference = arma::randu(2, 500);
+  arma::mat query = arma::randu(2, 300);
+  arma::vec bfEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  arma::vec treeEstimations = arma::vec(query.n_cols, arma::fill::zeros);
+  const double kernelBandwidth = 0.3;
+  const double relError = 0.01;
+
+  // Brute force KDE.
+  GaussianKernel kernel(kernelBandwidth);
+  BruteForceKDE<GaussianKernel>(reference,
+                                query,
+                                bfEstimations,
+                                kernel);
+
+  // Parallel breadth-first KDE.
+  metric::EuclideanDistance metric;
+  KDE<GaussianKernel,
+      metric::EuclideanDistance,
+      arma::mat,
+      tree::KDTree,
+      tree::KDTree<metric::EuclideanDistance,
+                   kde::KDEStat,
+                   arma::mat>::template ParallelBreadthFirstDualTreeTraverser>
+      kde(relError, 0.0, kernel, KDEMode::DUAL_TREE_MODE, metric);
+  kde.Train(reference);
+  kde.Evaluate(query, treeEstimations);
+
+  // Check whether results are equal.
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], treeEstimations[i], relError*100);
+}
+
+/**
+ * Test the evaluation of several bandwidths in one traversal against brute
+ * force results, in each mode, with and without a query set.
+ */
+BOOST_AUTO_TEST_CASE(MultiBandwidthKDETest)
+{
+  arma::mat reference = arma::randu(2, 500);
+  arma::mat query = arma::randu(2, 100);
+  const arma::vec bandwidths("0.1 0.3 1.0");
+  const double relError = 0.01;
+
+  // Brute force estimations of each bandwidth, with the query set and leaving
+  // each reference point out.
+  arma::mat bfEstimations(bandwidths.n_elem, query.n_cols, arma::fill::zeros);
+  arma::mat bfMonoEstimations(bandwidths.n_elem, reference.n_cols,
+      arma::fill::zeros);
+  metric::EuclideanDistance metric;
+  for (size_t b = 0; b < bandwidths.n_elem; ++b)
+  {
+    GaussianKernel kernel(bandwidths[b]);
+    arma::vec densities(query.n_cols, arma::fill::zeros);
+    BruteForceKDE<GaussianKernel>(reference, query, densities, kernel);
+    bfEstimations.row(b) = densities.t();
+
+    for (size_t i = 0; i < reference.n_cols; ++i)
+      for (size_t j = 0; j < reference.n_cols; ++j)
+        if (i != j)
+          bfMonoEstimations(b, i) += kernel.Evaluate(
+              metric.Evaluate(reference.col(i), reference.col(j)));
+  }
+  bfMonoEstimations /= reference.n_cols;
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, GaussianKernel(), (mode == 0) ? DUAL_TREE_MODE :
+        SINGLE_TREE_MODE);
+    kde.Train(reference);
+
+    arma::mat estimations, monoEstimations;
+    kde.Evaluate(query, bandwidths, estimations);
+    kde.Evaluate(bandwidths, monoEstimations);
+
+    BOOST_REQUIRE_EQUAL(estimations.n_rows, bandwidths.n_elem);
+    BOOST_REQUIRE_EQUAL(estimations.n_cols, query.n_cols);
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_rows, bandwidths.n_elem);
+    BOOST_REQUIRE_EQUAL(monoEstimations.n_cols, reference.n_cols);
+    for (size_t i = 0; i < estimations.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], estimations[i], relError * 100);
+    for (size_t i = 0; i < monoEstimations.n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], monoEstimations[i],
+          relError * 100);
+    }
+  }
+}
+
+/**
+ * Make sure that invalid bandwidths are rejected.
+ */
+BOOST_AUTO_TEST_CASE(MultiBandwidthInvalidTest)
+{
+  arma::mat reference = arma::randu(2, 100);
+  KDE<> kde;
+  kde.Train(reference);
+
+  arma::mat estimations;
+  BOOST_REQUIRE_THROW(kde.Evaluate(arma::vec(), estimations),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.Evaluate(arma::vec("0.5 0.0"), estimations),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.Evaluate(arma::mat(reference), arma::vec("-1.0"),
+      estimations), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_features_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_pca.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -150,4 +151,138 @@ BOOST_AUTO_TEST_CASE(CircleTransformationTestNystroem)
   BOOST_REQUIRE_EQUAL(ranges[1].Contains(ranges[2]), false);
 }
 
+/**
+ * With many random Fourier features, the leading eigenvalues of approximate
+ * kernel PCA should be close to those of exact kernel PCA, and the transformed
+ * data should have the requested number of dimensions.
+ */
+BOOST_AUTO_TEST_CASE(RandomFourierFeaturesEigenvaluesTest)
+{
+  arma::mat dataset;
+  dataset.randn(3, 200);
+
+  GaussianKernel kernel(2.0);
+
+  arma::mat exactTransformed;
+  arma::vec exactEigval;
+  arma::mat exactEigvec;
+  KernelPCA<GaussianKernel> exact(kernel, true);
+  exact.Apply(dataset, exactTransformed, exactEigval, exactEigvec);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    const bool orthogonal = (trial == 1);
+    arma::mat transformed;
+    arma::vec eigval;
+    arma::mat eigvec;
+    KernelPCA<GaussianKernel, RandomFourierFeaturesRule<GaussianKernel> >
+        approx(kernel, true,
+        RandomFourierFeaturesRule<GaussianKernel>(5000, orthogonal, 64));
+    approx.Apply(dataset, transformed, eigval, eigvec, 3);
+
+    BOOST_REQUIRE_EQUAL(transformed.n_rows, 3);
+    BOOST_REQUIRE_EQUAL(transformed.n_cols, dataset.n_cols);
+    BOOST_REQUIRE_EQUAL(eigvec.n_rows, 5000);
+    BOOST_REQUIRE_EQUAL(eigvec.n_cols, 3);
+    BOOST_REQUIRE_EQUAL(approx.Rule().Frequencies().n_rows, 5000);
+
+    for (size_t i = 0; i < 3; ++i)
+      BOOST_REQUIRE_CLOSE(eigval[i], exactEigval[i], 10.0);
+
+    // The variance of each component is its eigenvalue.
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(arma::accu(arma::square(transformed.row(i))),
+          eigval[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Test that the Laplacian kernel can be approximated with orthogonal random
+ * Fourier features.
+ */
+BOOST_AUTO_TEST_CASE(RandomFourierFeaturesLaplacianTest)
+{
+  arma::mat dataset;
+  dataset.randn(3, 300);
+
+  arma::mat exactTransformed;
+  arma::vec exactEigval;
+  arma::mat exactEigvec;
+  LaplacianKernel kernel(2.0);
+  KernelPCA<LaplacianKernel> exact(kernel, true);
+  exact.Apply(dataset, exactTransformed, exactEigval, exactEigvec);
+
+  arma::mat transformed;
+  arma::vec eigval;
+  arma::mat eigvec;
+  KernelPCA<LaplacianKernel, RandomFourierFeaturesRule<LaplacianKernel> >
+      approx(kernel, true,
+      RandomFourierFeaturesRule<LaplacianKernel>(10000, true));
+  approx.Apply(dataset, transformed, eigval, eigvec, 2);
+
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, 2);
+  BOOST_REQUIRE_CLOSE(eigval[0], exactEigval[0], 15.0);
+}
+
+/**
+ * Check that Train() and Transform() embed the training points like Apply()
+ * does, and that embedding the points in two batches gives the same result as
+ * embedding them at once.
+ */
+template<typename KernelPCAType>
+void CheckOutOfSampleTransform(KernelPCAType& kpca, const size_t dimension)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+
+  math::RandomSeed(10);
+  arma::mat applied, eigvec;
+  arma::vec eigval;
+  kpca.Apply(dataset, applied, eigval, eigvec, dimension);
+
+  math::RandomSeed(10);
+  kpca.Train(dataset, dimension);
+  BOOST_REQUIRE_EQUAL(kpca.EigenValues().n_elem, eigval.n_elem);
+
+  // Only the requested components are kept.
+  arma::mat transformed;
+  kpca.Transform(dataset, transformed);
+  BOOST_REQUIRE_EQUAL(transformed.n_rows, dimension);
+  CheckMatrices(transformed, applied.rows(0, dimension - 1), 1e-5);
+
+  arma::mat first, second;
+  kpca.Transform(dataset.cols(0, 49), first);
+  kpca.Transform(dataset.cols(50, 199), second);
+  CheckMatrices(arma::join_rows(first, second), transformed, 1e-5);
+}
+
+/**
+ * Embedding the training points with Transform() should give the result of
+ * Apply(), for each kernel rule, with and without centering.
+ */
+BOOST_AUTO_TEST_CASE(KernelPCATransformTest)
+{
+  KernelPCA<GaussianKernel> naive(GaussianKernel(0.5));
+  CheckOutOfSampleTransform(naive, 5);
+
+  KernelPCA<GaussianKernel> centered(GaussianKernel(0.5), true);
+  CheckOutOfSampleTransform(centered, 5);
+
+  KernelPCA<GaussianKernel, NystroemKernelRule<GaussianKernel>> nystroem(
+      GaussianKernel(0.5));
+  CheckOutOfSampleTransform(nystroem, 20);
+
+  KernelPCA<GaussianKernel, RandomFourierFeaturesRule<GaussianKernel>> rff(
+      GaussianKernel(0.5), true, RandomFourierFeaturesRule<GaussianKernel>(
+      100, false, 64));
+  CheckOutOfSampleTransform(rff, 2);
+
+  // The model can't be used before it is trained.
+  KernelPCA<GaussianKernel> untrained;
+  arma::mat transformed;
+  BOOST_REQUIRE_THROW(untrained.Transform(arma::randu<arma::mat>(3, 10),
+      transformed), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -20,6 +20,8 @@
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/kernel_matrix.hpp>
+#include <mlpack/core/math/fast_exp.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -209,6 +211,42 @@ BOOST_AUTO_TEST_CASE(MDFullCovarianceTest)
   BOOST_REQUIRE_CLOSE(md.Evaluate(b, a), 15.7, 1e-5);
 }
 
+/**
+ * Make sure the decomposition of a positive definite and of a singular
+ * covariance matrix gives back the matrix, and that the Euclidean distance
+ * between transformed points is the Mahalanobis distance.
+ */
+BOOST_AUTO_TEST_CASE(MDDecomposeTest)
+{
+  const arma::mat factor = arma::randu<arma::mat>(3, 5);
+  const arma::mat covariances[] = { factor.t() * factor + 0.1 *
+      arma::eye<arma::mat>(5, 5), factor.t() * factor };
+
+  for (size_t c = 0; c < 2; ++c)
+  {
+    MahalanobisDistance<true> md(covariances[c]);
+
+    arma::mat transformation;
+    md.Decompose(transformation);
+    BOOST_REQUIRE_SMALL(arma::accu(arma::abs(transformation.t() *
+        transformation - covariances[c])), 1e-8);
+
+    const arma::mat points = arma::randu<arma::mat>(5, 10);
+    arma::mat transformed;
+    md.Transform(points, transformed);
+    for (size_t i = 1; i < points.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(transformed.col(0),
+          transformed.col(i)), md.Evaluate(points.col(0), points.col(i)),
+          1e-5);
+    }
+  }
+
+  MahalanobisDistance<true> empty;
+  arma::mat transformation;
+  BOOST_REQUIRE_THROW(empty.Decompose(transformation), std::invalid_argument);
+}
+
 /**
  * Simple test case for the cosine distance.
  */
@@ -609,6 +647,57 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure that the kernel values found from the spectra, one by one and a
+ * row at a time, are the same as the ones found by merging the maps of
+ * substrings, for short substrings with exact codes and long ones with hashes.
+ */
+BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateRowTest)
+{
+  std::vector<std::vector<std::string> > dataset(1);
+  dataset[0].push_back("Mellow jello, mellow yellow.");
+  dataset[0].push_back("the yellow jello is mellow");
+  dataset[0].push_back("abcabcabcabcabcabcabcabcabc");
+  dataset[0].push_back("ab");
+  dataset[0].push_back("123 ABCABCABCABCABCABC jello");
+
+  arma::mat points(2, dataset[0].size(), arma::fill::zeros);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points(1, i) = i;
+
+  const size_t ps[] = { 1, 3, 5, 14 };
+  for (size_t k = 0; k < 4; ++k)
+  {
+    PSpectrumStringKernel p(dataset, ps[k]);
+
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      arma::rowvec row;
+      p.EvaluateRow(arma::vec(points.col(i)), points, row);
+      BOOST_REQUIRE_EQUAL(row.n_elem, points.n_cols);
+
+      for (size_t j = 0; j < points.n_cols; ++j)
+      {
+        // Merge the maps of substrings directly.
+        double expected = 0.0;
+        const std::map<std::string, int>& a = p.Counts()[0][i];
+        const std::map<std::string, int>& b = p.Counts()[0][j];
+        std::map<std::string, int>::const_iterator it;
+        for (it = a.begin(); it != a.end(); ++it)
+        {
+          if (b.count(it->first) > 0)
+            expected += it->second * b.at(it->first);
+        }
+
+        const arma::vec a2 = points.col(i);
+        const arma::vec b2 = points.col(j);
+        BOOST_REQUIRE_CLOSE(p.Evaluate(a2, b2), expected, 1e-5);
+        BOOST_REQUIRE_CLOSE(row[j], expected, 1e-5);
+      }
+    }
+  }
+}
+
 /**
  * Cauchy Kernel test.
  */
@@ -622,4 +711,124 @@ BOOST_AUTO_TEST_CASE(CauchyKernelTest)
   BOOST_REQUIRE_CLOSE(ck.Evaluate(b, a), 0.92592588, 1e-5);
 }
 
+/**
+ * Compute the kernel matrices of the given kernel with KernelMatrix() and with
+ * one evaluation per entry, and make sure they match.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType kernel)
+{
+  // Use a tile size that doesn't divide the number of points.
+  arma::mat a(4, 70, arma::fill::randu);
+  arma::mat b(4, 45, arma::fill::randu);
+
+  arma::mat kernelMatrix, crossKernelMatrix;
+  KernelMatrix(a, kernel, kernelMatrix, 16);
+  KernelMatrix(a, b, kernel, crossKernelMatrix, 16);
+
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_rows, 70);
+  BOOST_REQUIRE_EQUAL(kernelMatrix.n_cols, 70);
+  BOOST_REQUIRE_EQUAL(crossKernelMatrix.n_rows, 70);
+  BOOST_REQUIRE_EQUAL(crossKernelMatrix.n_cols, 45);
+
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(a.col(i), a.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(kernelMatrix(i, j), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(kernelMatrix(i, j), value, 1e-4);
+
+      // The matrix must be exactly symmetric.
+      BOOST_REQUIRE_EQUAL(kernelMatrix(i, j), kernelMatrix(j, i));
+    }
+  }
+
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      const double value = kernel.Evaluate(a.col(i), b.col(j));
+      if (std::abs(value) < 1e-8)
+        BOOST_REQUIRE_SMALL(crossKernelMatrix(i, j), 1e-8);
+      else
+        BOOST_REQUIRE_CLOSE(crossKernelMatrix(i, j), value, 1e-4);
+    }
+  }
+}
+
+/**
+ * Make sure KernelMatrix() gives the same kernel matrices as evaluating the
+ * kernel on each pair of points, for the kernels computed with matrix products
+ * and for a kernel that is evaluated entry by entry.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixTest)
+{
+  CheckKernelMatrix(LinearKernel());
+  CheckKernelMatrix(PolynomialKernel(3.0, 1.0));
+  CheckKernelMatrix(HyperbolicTangentKernel(0.5, 0.2));
+  CheckKernelMatrix(GaussianKernel(0.7));
+  CheckKernelMatrix(LaplacianKernel(0.7));
+  CheckKernelMatrix(EpanechnikovKernel(0.9));
+  CheckKernelMatrix(CauchyKernel(0.7));
+  CheckKernelMatrix(CosineDistance());
+}
+
+/**
+ * Make sure that FastExp() is as accurate as std::exp() with the default
+ * number of terms, accurate to about 1e-8 with 7 terms, and gives 0 for very
+ * small values.
+ */
+BOOST_AUTO_TEST_CASE(FastExpTest)
+{
+  arma::vec x = arma::linspace<arma::vec>(-700.0, 700.0, 1001);
+  x[0] = -800.0;
+  arma::vec values = x;
+  arma::vec roughValues = x;
+  math::FastExp(values);
+  math::FastExp<7>(roughValues);
+
+  BOOST_REQUIRE_EQUAL(values[0], 0.0);
+  BOOST_REQUIRE_EQUAL(roughValues[0], 0.0);
+  for (size_t i = 1; i < x.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(values[i], std::exp(x[i]), 1e-10);
+    BOOST_REQUIRE_CLOSE(roughValues[i], std::exp(x[i]), 1e-6);
+  }
+}
+
+/**
+ * Make sure that the kernel values of a point with many points, computed at
+ * once, are the values of Evaluate() on each pair.
+ */
+template<typename KernelType>
+void CheckBatchEvaluate(KernelType kernel)
+{
+  arma::mat points(4, 50, arma::fill::randn);
+  const arma::vec point = points.col(7) + 0.1;
+
+  arma::vec values;
+  kernel.Evaluate(point, points, values);
+
+  BOOST_REQUIRE_EQUAL(values.n_elem, points.n_cols);
+  for (size_t j = 0; j < points.n_cols; ++j)
+  {
+    const double expected = kernel.Evaluate(point, points.col(j));
+    if (std::abs(expected) < 1e-10)
+      BOOST_REQUIRE_SMALL(values[j], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(values[j], expected, 1e-8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(KernelBatchEvaluateTest)
+{
+  CheckBatchEvaluate(GaussianKernel(1.3));
+  CheckBatchEvaluate(LaplacianKernel(0.8));
+  CheckBatchEvaluate(EpanechnikovKernel(2.5));
+  CheckBatchEvaluate(CauchyKernel(0.7));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -16,8 +16,13 @@
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/kmeans_plus_plus_initialization.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
+#include <mlpack/methods/kmeans/spherical_kmeans.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
@@ -25,6 +30,11 @@
 #include <boost/test/unit_test.hpp>
 #include <mlpack/methods/kmeans/kill_empty_clusters.hpp>
 #include "test_tools.hpp"
+#include "thread_all_reduce.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -737,4 +747,439 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Check that the given initial centroids are points of the dataset, and that
+ * there is one in each of the well-separated blobs of the dataset (blob i holds
+ * the points with label i).
+ */
+void CheckSpreadCentroids(const arma::mat& dataset,
+                          const arma::Row<size_t>& labels,
+                          const size_t clusters,
+                          const arma::mat& centroids)
+{
+  BOOST_REQUIRE_EQUAL(centroids.n_rows, dataset.n_rows);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, clusters);
+
+  std::vector<size_t> blobCentroids(clusters, 0);
+  for (size_t i = 0; i < clusters; ++i)
+  {
+    size_t j;
+    for (j = 0; j < dataset.n_cols; ++j)
+    {
+      if (metric::EuclideanDistance::Evaluate(centroids.col(i),
+          dataset.col(j)) < 1e-10)
+        break;
+    }
+
+    BOOST_REQUIRE_LT(j, dataset.n_cols);
+    ++blobCentroids[labels[j]];
+  }
+
+  for (size_t b = 0; b < clusters; ++b)
+    BOOST_REQUIRE_EQUAL(blobCentroids[b], 1);
+}
+
+/**
+ * Make sure that k-means++ and k-means|| choose one initial centroid in each
+ * of several well-separated blobs, and that k-means then converges quickly.
+ */
+BOOST_AUTO_TEST_CASE(KMeansPlusPlusAndParallelInitializationTest)
+{
+  const size_t clusters = 8;
+  arma::mat dataset(3, 100 * clusters);
+  arma::Row<size_t> labels(100 * clusters);
+  for (size_t b = 0; b < clusters; ++b)
+  {
+    arma::vec center(3, arma::fill::zeros);
+    center[b % 3] = 100.0 * (b + 1);
+    for (size_t i = 0; i < 100; ++i)
+    {
+      dataset.col(100 * b + i) = center + arma::randn<arma::vec>(3);
+      labels[100 * b + i] = b;
+    }
+  }
+
+  arma::mat centroids;
+  KMeansPlusPlusInitialization().Cluster(dataset, clusters, centroids);
+  CheckSpreadCentroids(dataset, labels, clusters, centroids);
+
+  KMeansParallelInitialization(2.0, 3).Cluster(dataset, clusters, centroids);
+  CheckSpreadCentroids(dataset, labels, clusters, centroids);
+
+  // With only one round, there may be too few candidates; there must still be
+  // the right number of centroids.
+  KMeansParallelInitialization(0.1, 1).Cluster(dataset, clusters, centroids);
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, clusters);
+
+  // Starting from k-means++, k-means finds the blobs.
+  KMeans<EuclideanDistance, KMeansPlusPlusInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(dataset, clusters, assignments);
+  for (size_t b = 0; b < clusters; ++b)
+    for (size_t i = 1; i < 100; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[100 * b + i], assignments[100 * b]);
+}
+
+/**
+ * Make sure mini-batch k-means finds the three classes of the simple dataset.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(100);
+
+  // Start with one centroid near each class.
+  arma::mat centroids("1.0 9.0 -9.0;"
+                      "1.0 9.0  4.0");
+  arma::Row<size_t> assignments;
+  kmeans.Cluster((arma::mat) trans(kMeansData), 3, assignments, centroids,
+      false, true);
+
+  for (size_t i = 0; i < 13; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), 0);
+  for (size_t i = 13; i < 20; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), 1);
+  for (size_t i = 20; i < 30; i++)
+    BOOST_REQUIRE_EQUAL(assignments(i), 2);
+}
+
+/**
+ * Stream batches of points from three Gaussians through KMeans::Update() and
+ * make sure the centroids end up at the means of the Gaussians.
+ */
+BOOST_AUTO_TEST_CASE(KMeansStreamingUpdateTest)
+{
+  arma::mat means("0.0 10.0 -10.0;"
+                  "0.0 10.0   5.0");
+  KMeans<> kmeans;
+
+  arma::mat centroids("1.0 9.0 -9.0;"
+                      "1.0 9.0  4.0");
+  arma::Col<size_t> counts;
+  for (size_t b = 0; b < 50; ++b)
+  {
+    arma::mat batch = arma::randn<arma::mat>(2, 300);
+    for (size_t i = 0; i < batch.n_cols; ++i)
+      batch.col(i) += means.col(i % 3);
+
+    kmeans.Update(batch, 3, centroids, counts);
+  }
+
+  BOOST_REQUIRE_EQUAL(counts.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(arma::accu(counts), 50 * 300);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_SMALL(centroids[i] - means[i], 0.1);
+
+  // Initializing from a batch that is too small should fail.
+  arma::mat emptyCentroids;
+  arma::Col<size_t> newCounts;
+  arma::mat smallBatch = arma::randu<arma::mat>(2, 2);
+  BOOST_REQUIRE_THROW(kmeans.Update(smallBatch, 3, emptyCentroids, newCounts),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure a single NaiveKMeans iteration with the matrix multiplication-based
+ * search gives the same centroids as a brute-force computation.
+ */
+BOOST_AUTO_TEST_CASE(NaiveKMeansIterateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 1500);
+  arma::mat centroids = arma::randu<arma::mat>(10, 25);
+
+  // Brute-force assignment.
+  arma::mat bfCentroids(10, 25, arma::fill::zeros);
+  arma::Col<size_t> bfCounts(25, arma::fill::zeros);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    double minDistance = DBL_MAX;
+    size_t closest = 0;
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double distance = EuclideanDistance::Evaluate(dataset.col(i),
+          centroids.col(j));
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closest = j;
+      }
+    }
+
+    bfCentroids.col(closest) += dataset.col(i);
+    bfCounts[closest]++;
+  }
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+    if (bfCounts[j] != 0)
+      bfCentroids.col(j) /= bfCounts[j];
+
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, metric);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  naive.Iterate(centroids, newCentroids, counts);
+
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(counts[j], bfCounts[j]);
+    if (counts[j] == 0)
+      continue;
+
+    for (size_t d = 0; d < centroids.n_rows; ++d)
+      BOOST_REQUIRE_CLOSE(newCentroids(d, j), bfCentroids(d, j), 1e-5);
+  }
+}
+
+/**
+ * Run a few iterations of the given Lloyd step type with the given number of
+ * threads, starting from the given centroids.
+ */
+template<typename LloydStepType>
+void RunLloydIterations(const arma::mat& dataset,
+                        const size_t numThreads,
+                        arma::mat& centroids,
+                        arma::Col<size_t>& counts,
+                        size_t& distanceCalculations)
+{
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(numThreads);
+#else
+  (void) numThreads;
+#endif
+
+  EuclideanDistance metric;
+  LloydStepType step(dataset, metric);
+  arma::mat newCentroids;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    step.Iterate(centroids, newCentroids, counts);
+    centroids = newCentroids;
+  }
+  distanceCalculations = step.DistanceCalculations();
+
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+}
+
+/**
+ * Make sure that the parallel Elkan, Hamerly, and dual-tree iterations give the
+ * same results as with a single thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelLloydStepTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 3000);
+  const arma::mat initialCentroids = arma::randu<arma::mat>(5, 20);
+
+  arma::mat serialElkan(initialCentroids), parallelElkan(initialCentroids);
+  arma::Col<size_t> serialElkanCounts, parallelElkanCounts;
+  size_t serialElkanCalcs, parallelElkanCalcs;
+  RunLloydIterations<ElkanKMeans<EuclideanDistance, arma::mat>>(dataset, 1,
+      serialElkan, serialElkanCounts, serialElkanCalcs);
+  RunLloydIterations<ElkanKMeans<EuclideanDistance, arma::mat>>(dataset, 4,
+      parallelElkan, parallelElkanCounts, parallelElkanCalcs);
+
+  arma::mat serialHamerly(initialCentroids), parallelHamerly(initialCentroids);
+  arma::Col<size_t> serialHamerlyCounts, parallelHamerlyCounts;
+  size_t serialHamerlyCalcs, parallelHamerlyCalcs;
+  RunLloydIterations<HamerlyKMeans<EuclideanDistance, arma::mat>>(dataset, 1,
+      serialHamerly, serialHamerlyCounts, serialHamerlyCalcs);
+  RunLloydIterations<HamerlyKMeans<EuclideanDistance, arma::mat>>(dataset, 4,
+      parallelHamerly, parallelHamerlyCounts, parallelHamerlyCalcs);
+
+  arma::mat serialDualTree(initialCentroids), parallelDualTree(
+      initialCentroids);
+  arma::Col<size_t> serialDualTreeCounts, parallelDualTreeCounts;
+  size_t serialDualTreeCalcs, parallelDualTreeCalcs;
+  RunLloydIterations<DefaultDualTreeKMeans<EuclideanDistance, arma::mat>>(
+      dataset, 1, serialDualTree, serialDualTreeCounts, serialDualTreeCalcs);
+  RunLloydIterations<DefaultDualTreeKMeans<EuclideanDistance, arma::mat>>(
+      dataset, 4, parallelDualTree, parallelDualTreeCounts,
+      parallelDualTreeCalcs);
+
+  // The pruning of each point does not depend on the other points.
+  BOOST_REQUIRE_EQUAL(serialElkanCalcs, parallelElkanCalcs);
+  BOOST_REQUIRE_EQUAL(serialHamerlyCalcs, parallelHamerlyCalcs);
+
+  for (size_t j = 0; j < initialCentroids.n_cols; ++j)
+  {
+    BOOST_REQUIRE_EQUAL(serialElkanCounts[j], parallelElkanCounts[j]);
+    BOOST_REQUIRE_EQUAL(serialHamerlyCounts[j], parallelHamerlyCounts[j]);
+    BOOST_REQUIRE_EQUAL(serialDualTreeCounts[j], parallelDualTreeCounts[j]);
+    BOOST_REQUIRE_EQUAL(serialElkanCounts[j], serialHamerlyCounts[j]);
+    BOOST_REQUIRE_EQUAL(serialElkanCounts[j], serialDualTreeCounts[j]);
+  }
+
+  for (size_t i = 0; i < initialCentroids.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(serialElkan[i], parallelElkan[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(serialHamerly[i], parallelHamerly[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(serialDualTree[i], parallelDualTree[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(serialElkan[i], serialHamerly[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that a NaiveKMeans iteration on sparse data gives the same result
+ * as on the same dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparseNaiveKMeansIterateTest)
+{
+  arma::sp_mat sparseDataset;
+  sparseDataset.sprandu(100, 2000, 0.05);
+  const arma::mat dataset(sparseDataset);
+  const arma::mat centroids = dataset.cols(0, 9);
+
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> dense(dataset, metric);
+  NaiveKMeans<EuclideanDistance, arma::sp_mat> sparse(sparseDataset, metric);
+
+  arma::mat denseCentroids, sparseCentroids;
+  arma::Col<size_t> denseCounts, sparseCounts;
+  const double denseResidual = dense.Iterate(centroids, denseCentroids,
+      denseCounts);
+  const double sparseResidual = sparse.Iterate(centroids, sparseCentroids,
+      sparseCounts);
+
+  BOOST_REQUIRE_CLOSE(denseResidual, sparseResidual, 1e-5);
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+    BOOST_REQUIRE_EQUAL(denseCounts[j], sparseCounts[j]);
+  for (size_t i = 0; i < denseCentroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(denseCentroids[i] + 1.0, sparseCentroids[i] + 1.0,
+        1e-5);
+}
+
+/**
+ * Make sure that spherical k-means clusters sparse points by their direction,
+ * regardless of their norms, and gives centroids with unit norm.
+ */
+BOOST_AUTO_TEST_CASE(SphericalKMeansTest)
+{
+  // Two groups of "documents" that use disjoint sets of words, with very
+  // different lengths.
+  arma::sp_mat data(1000, 200);
+  for (size_t i = 0; i < 200; ++i)
+  {
+    const size_t firstWord = (i < 100) ? 0 : 500;
+    const double length = (i % 2 == 0) ? 1.0 : 100.0;
+    for (size_t w = 0; w < 5; ++w)
+      data(firstWord + math::RandInt(500), i) += length * math::Random();
+  }
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      SphericalKMeans, arma::sp_mat> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat centroids(1000, 2, arma::fill::zeros);
+  centroids(0, 0) = 1.0;
+  centroids(500, 1) = 1.0;
+  kmeans.Cluster(data, 2, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < 200; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], (size_t) ((i < 100) ? 0 : 1));
+
+  for (size_t j = 0; j < 2; ++j)
+    BOOST_REQUIRE_CLOSE(arma::norm(centroids.col(j), 2), 1.0, 1e-5);
+}
+
+/**
+ * Generate three Gaussian clusters, and initial centroids that are close to
+ * them.
+ */
+void DistributedKMeansDataset(arma::mat& data, arma::mat& centroids)
+{
+  data.randn(3, 3000);
+  data.cols(0, 999).each_col() += arma::vec("5 0 0");
+  data.cols(1000, 1999).each_col() += arma::vec("0 5 0");
+  centroids = data.cols(arma::uvec("0 1000 2000"));
+}
+
+/**
+ * Make sure that the sum of the statistics of the partitions of a dataset are
+ * the statistics of the whole dataset, and that the update gives the next
+ * centroids of k-means.
+ */
+BOOST_AUTO_TEST_CASE(DistributedKMeansStatisticsTest)
+{
+  arma::mat data, centroids;
+  DistributedKMeansDataset(data, centroids);
+
+  DistributedKMeans<> kmeans;
+  arma::vec statistics, partStatistics;
+  kmeans.LocalStatistics(data, centroids, statistics);
+  arma::vec sumStatistics(statistics.n_elem, arma::fill::zeros);
+  const size_t bounds[4] = { 0, 700, 2300, 3000 };
+  for (size_t p = 0; p < 3; ++p)
+  {
+    const arma::mat part = data.cols(bounds[p], bounds[p + 1] - 1);
+    kmeans.LocalStatistics(part, centroids, partStatistics);
+    sumStatistics += partStatistics;
+  }
+
+  BOOST_REQUIRE_EQUAL(statistics.n_elem, 12);
+  for (size_t i = 0; i < statistics.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sumStatistics[i], statistics[i], 1e-8);
+
+  arma::mat newCentroids = centroids;
+  kmeans.Update(sumStatistics, newCentroids);
+
+  arma::mat otherCentroids;
+  arma::Col<size_t> counts;
+  EuclideanDistance metric;
+  NaiveKMeans<EuclideanDistance, arma::mat> step(data, metric);
+  step.Iterate(centroids, otherCentroids, counts);
+  CheckMatrices(newCentroids, otherCentroids, 1e-8);
+}
+
+/**
+ * Make sure that distributed k-means on a single process gives the result of
+ * k-means, and that the "processes" of threads that hold the partitions of the
+ * dataset all find the same centroids.
+ */
+BOOST_AUTO_TEST_CASE(DistributedKMeansThreadTest)
+{
+  arma::mat data, initialCentroids;
+  DistributedKMeansDataset(data, initialCentroids);
+
+  KMeans<EuclideanDistance, SampleInitialization, AllowEmptyClusters> kmeans;
+  arma::mat centroids = initialCentroids;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 3, assignments, centroids, false, true);
+
+  arma::mat singleCentroids = initialCentroids;
+  DistributedKMeans<> singleKMeans;
+  singleKMeans.Cluster(data, singleCentroids);
+  CheckMatrices(singleCentroids, centroids, 1e-5);
+
+  // One of the partitions is empty.
+  const size_t numThreads = 4;
+  const size_t bounds[numThreads + 1] = { 0, 1200, 1200, 2100, 3000 };
+  ThreadAllReduceState state(numThreads);
+  std::vector<arma::mat> threadCentroids(numThreads, initialCentroids);
+  std::vector<arma::Row<size_t>> threadAssignments(numThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    threads.push_back(std::thread([&, t]()
+    {
+      const arma::mat part = (bounds[t] == bounds[t + 1]) ?
+          arma::mat(3, 0) : arma::mat(data.cols(bounds[t], bounds[t + 1] - 1));
+      DistributedKMeans<ThreadAllReduce> threadKMeans(1000,
+          ThreadAllReduce(&state));
+      threadKMeans.Cluster(part, threadCentroids[t], threadAssignments[t]);
+    }));
+  }
+  for (size_t t = 0; t < numThreads; ++t)
+    threads[t].join();
+
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    CheckMatrices(threadCentroids[t], threadCentroids[0], 1e-12);
+    BOOST_REQUIRE_EQUAL(threadAssignments[t].n_elem,
+        bounds[t + 1] - bounds[t]);
+    for (size_t i = 0; i < threadAssignments[t].n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(threadAssignments[t][i], assignments[bounds[t] + i]);
+  }
+  CheckMatrices(threadCentroids[0], centroids, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
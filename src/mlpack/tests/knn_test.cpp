@@ -10,8 +10,14 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/typedef.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/dynamic_neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/nn_descent.hpp>
+#include <mlpack/methods/neighbor_search/resumable_neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/sharded_neighbor_search.hpp>
+#include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
@@ -270,6 +276,41 @@ BOOST_AUTO_TEST_CASE(TrainTreeTest)
   }
 }
 
+/**
+ * Test that searching with a tree whose nodes have been packed gives the same
+ * results as searching with the original tree.
+ */
+BOOST_AUTO_TEST_CASE(PackedTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 500);
+  arma::mat querySet = arma::randu<arma::mat>(5, 100);
+
+  const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+  for (size_t m = 0; m < 2; ++m)
+  {
+    KNN::Tree tree(dataset);
+    KNN::Tree packedTree(dataset);
+    packedTree.PackNodes();
+
+    KNN knn(std::move(tree), modes[m]);
+    KNN packedKnn(std::move(packedTree), modes[m]);
+
+    arma::Mat<size_t> neighbors, packedNeighbors;
+    arma::mat distances, packedDistances;
+    knn.Search(querySet, 5, neighbors, distances);
+    packedKnn.Search(querySet, 5, packedNeighbors, packedDistances);
+
+    CheckMatrices(neighbors, packedNeighbors);
+    CheckMatrices(distances, packedDistances);
+
+    knn.Search(5, neighbors, distances);
+    packedKnn.Search(5, packedNeighbors, packedDistances);
+
+    CheckMatrices(neighbors, packedNeighbors);
+    CheckMatrices(distances, packedDistances);
+  }
+}
+
 /**
  * Test that training with a tree throws an exception when in naive mode.
  */
@@ -719,6 +760,71 @@ BOOST_AUTO_TEST_CASE(DualTreeVsNaive2)
   }
 }
 
+/**
+ * Test the parallel dual-tree nearest-neighbors method with the naive method.
+ * This uses both a query and reference dataset.
+ *
+ * Errors are produced if the results are not identical.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive1)
+{
+  arma::mat dataset;
+
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  KNN knn(dataset, PARALLEL_DUAL_TREE_MODE);
+
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree;
+  arma::mat distancesTree;
+  knn.Search(dataset, 15, neighborsTree, distancesTree);
+
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(dataset, 15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree(i), neighborsNaive(i));
+    BOOST_REQUIRE_CLOSE(distancesTree(i), distancesNaive(i), 1e-5);
+  }
+}
+
+/**
+ * Test the parallel dual-tree nearest-neighbors method with the naive method.
+ * This uses only a reference dataset, so the query points must be excluded
+ * from their own results.
+ *
+ * Errors are produced if the results are not identical.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeVsNaive2)
+{
+  arma::mat dataset;
+
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  KNN knn(dataset, PARALLEL_DUAL_TREE_MODE);
+
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree;
+  arma::mat distancesTree;
+  knn.Search(15, neighborsTree, distancesTree);
+
+  arma::Mat<size_t> neighborsNaive;
+  arma::mat distancesNaive;
+  naive.Search(15, neighborsNaive, distancesNaive);
+
+  for (size_t i = 0; i < neighborsTree.n_elem; i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighborsTree[i], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
 /**
  * Test the single-tree nearest-neighbors method with the naive method.  This
  * uses only a reference dataset.
@@ -1143,6 +1249,51 @@ BOOST_AUTO_TEST_CASE(KNNModelTest)
   }
 }
 
+/**
+ * Ensure that an NSModel on single precision data gives the same results as
+ * exact search in double precision, for every exact tree type.
+ */
+BOOST_AUTO_TEST_CASE(KNNFloatModelTest)
+{
+  typedef NSModel<NearestNeighborSort, arma::fmat> KNNFloatModel;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  for (size_t t = KNNFloatModel::KD_TREE; t <= KNNFloatModel::OCTREE; ++t)
+  {
+    // Search on spill trees is approximate.
+    if (t == KNNFloatModel::SPILL_TREE)
+      continue;
+
+    for (size_t j = 0; j < 2; ++j)
+    {
+      KNNFloatModel model((KNNFloatModel::TreeTypes) t);
+      model.BuildModel(arma::conv_to<arma::fmat>::from(referenceData), 20,
+          (j == 0) ? DUAL_TREE_MODE : SINGLE_TREE_MODE);
+
+      arma::Mat<size_t> neighbors;
+      arma::mat distances;
+      model.Search(arma::conv_to<arma::fmat>::from(queryData), 3, neighbors,
+          distances);
+
+      BOOST_REQUIRE_EQUAL(neighbors.n_rows, baselineNeighbors.n_rows);
+      BOOST_REQUIRE_EQUAL(neighbors.n_cols, baselineNeighbors.n_cols);
+      BOOST_REQUIRE_EQUAL(model.Dataset().n_cols, referenceData.n_cols);
+      for (size_t k = 0; k < distances.n_elem; ++k)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors[k], baselineNeighbors[k]);
+        BOOST_REQUIRE_CLOSE(distances[k], baselineDistances[k], 1e-3);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(KNNModelMonochromaticTest)
 {
   // Ensure that we can build an NSModel<NearestNeighborSearch> and get correct
@@ -1466,4 +1617,731 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Make sure that the greedy traversal of a block of query points gives the
+ * same results as the greedy traversal of each query point.
+ */
+BOOST_AUTO_TEST_CASE(GreedyBlockTraversalTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance,
+      TreeType> RuleType;
+  TreeType tree(dataset, 40);
+  EuclideanDistance metric;
+
+  RuleType rules(tree.Dataset(), querySet, 5, metric);
+  GreedySingleTreeTraverser<TreeType, RuleType> traverser(rules);
+  traverser.MinBaseCases() = 5;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Traverse(i, tree);
+
+  RuleType blockRules(tree.Dataset(), querySet, 5, metric);
+  GreedySingleTreeTraverser<TreeType, RuleType> blockTraverser(blockRules);
+  blockTraverser.MinBaseCases() = 5;
+  std::vector<size_t> queries(querySet.n_cols);
+  for (size_t i = 0; i < queries.size(); ++i)
+    queries[i] = i;
+  blockTraverser.Traverse(queries, tree);
+
+  arma::Mat<size_t> neighbors, blockNeighbors;
+  arma::mat distances, blockDistances;
+  rules.GetResults(neighbors, distances);
+  blockRules.GetResults(blockNeighbors, blockDistances);
+
+  BOOST_REQUIRE_EQUAL(traverser.NumPrunes(), blockTraverser.NumPrunes());
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], blockNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], blockDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the heaps of candidates of the rules keep the k best
+ * candidates of each query point, sorted, for the nearest and furthest
+ * neighbor sorts and for k larger than the number of reference points.
+ */
+template<typename SortPolicy>
+void CheckCandidateHeaps(const size_t k)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 50);
+  arma::mat querySet = arma::randu<arma::mat>(3, 20);
+
+  typedef KDTree<EuclideanDistance, NeighborSearchStat<SortPolicy>,
+      arma::mat> TreeType;
+  EuclideanDistance metric;
+  NeighborSearchRules<SortPolicy, EuclideanDistance, TreeType> rules(dataset,
+      querySet, k, metric);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      rules.BaseCase(i, j);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  rules.GetResults(neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    arma::vec trueDistances(dataset.n_cols);
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      trueDistances[j] = metric.Evaluate(querySet.col(i), dataset.col(j));
+    const arma::uvec order = arma::sort_index(trueDistances,
+        SortPolicy::IsBetter(0.0, 1.0) ? "ascend" : "descend");
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (j < dataset.n_cols)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(j, i), order[j]);
+        BOOST_REQUIRE_CLOSE(distances(j, i), trueDistances[order[j]], 1e-5);
+      }
+      else
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(j, i), size_t() - 1);
+        BOOST_REQUIRE_EQUAL(distances(j, i), SortPolicy::WorstDistance());
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CandidateHeapTest)
+{
+  CheckCandidateHeaps<NearestNeighborSort>(1);
+  CheckCandidateHeaps<NearestNeighborSort>(7);
+  CheckCandidateHeaps<NearestNeighborSort>(60);
+  CheckCandidateHeaps<FurthestNeighborSort>(1);
+  CheckCandidateHeaps<FurthestNeighborSort>(8);
+  CheckCandidateHeaps<FurthestNeighborSort>(60);
+}
+
+// Get the points of the dataset that are still in the reference set of the
+// given dynamic search, and their ids; the column of each point of the dataset
+// is its id.
+template<typename DynamicSearchType>
+arma::mat LivePoints(const DynamicSearchType& dynamicSearch,
+                     const arma::mat& dataset,
+                     std::vector<size_t>& ids)
+{
+  ids.clear();
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    if (dynamicSearch.Contains(i))
+      ids.push_back(i);
+
+  arma::mat points(dataset.n_rows, ids.size());
+  for (size_t i = 0; i < ids.size(); ++i)
+    points.col(i) = dataset.col(ids[i]);
+
+  return points;
+}
+
+// Compare the results of dynamic search with the given naive results on the
+// live points.
+void CheckDynamicResults(const arma::Mat<size_t>& neighbors,
+                         const arma::mat& distances,
+                         const arma::Mat<size_t>& naiveNeighbors,
+                         const arma::mat& naiveDistances,
+                         const std::vector<size_t>& ids)
+{
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, naiveNeighbors.n_rows);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, naiveNeighbors.n_cols);
+  BOOST_REQUIRE_EQUAL(distances.n_rows, naiveDistances.n_rows);
+  BOOST_REQUIRE_EQUAL(distances.n_cols, naiveDistances.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], ids[naiveNeighbors[i]]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Insert points in batches of different sizes and make sure that the results
+ * are the same as naive search on all the points.
+ */
+BOOST_AUTO_TEST_CASE(DynamicKNNInsertTest)
+{
+  arma::mat dataset(3, 468, arma::fill::randu);
+  arma::mat querySet(3, 50, arma::fill::randu);
+
+  DynamicNeighborSearch<NearestNeighborSort> knn(DUAL_TREE_MODE, 0.0, 16);
+
+  const size_t batches[] = { 100, 37, 1, 250, 80 };
+  size_t inserted = 0;
+  for (size_t b = 0; b < 5; ++b)
+  {
+    const size_t firstId = knn.Insert(dataset.cols(inserted,
+        inserted + batches[b] - 1));
+    BOOST_REQUIRE_EQUAL(firstId, inserted);
+    inserted += batches[b];
+    BOOST_REQUIRE_EQUAL(knn.NumPoints(), inserted);
+
+    // No level may hold more points than its capacity.
+    for (size_t l = 0; l < knn.NumLevels(); ++l)
+      BOOST_REQUIRE_LE(knn.LevelSize(l), knn.MinLevelSize() << l);
+
+    std::vector<size_t> ids;
+    KNN naive(LivePoints(knn, dataset.cols(0, inserted - 1), ids),
+        NAIVE_MODE);
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+    knn.Search(querySet, 5, neighbors, distances);
+    naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+    CheckDynamicResults(neighbors, distances, naiveNeighbors, naiveDistances,
+        ids);
+  }
+}
+
+/**
+ * Remove points and make sure that the results are the same as naive search on
+ * the remaining points.
+ */
+BOOST_AUTO_TEST_CASE(DynamicKNNRemoveTest)
+{
+  arma::mat dataset(4, 600, arma::fill::randu);
+  arma::mat querySet(4, 40, arma::fill::randu);
+
+  DynamicNeighborSearch<NearestNeighborSort> knn(SINGLE_TREE_MODE, 0.0, 32);
+  knn.Insert(dataset.cols(0, 299));
+  knn.Insert(dataset.cols(300, 599));
+
+  // Remove a random half of the points, checking the results along the way.
+  arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(0, 599, 600));
+  for (size_t i = 0; i < 300; ++i)
+  {
+    knn.Remove(order[i]);
+    BOOST_REQUIRE_EQUAL(knn.Contains(order[i]), false);
+    BOOST_REQUIRE_EQUAL(knn.NumPoints(), 599 - i);
+
+    if (i % 50 != 49)
+      continue;
+
+    std::vector<size_t> ids;
+    KNN naive(LivePoints(knn, dataset, ids), NAIVE_MODE);
+
+    arma::Mat<size_t> neighbors, naiveNeighbors;
+    arma::mat distances, naiveDistances;
+    knn.Search(querySet, 10, neighbors, distances);
+    naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+
+    CheckDynamicResults(neighbors, distances, naiveNeighbors, naiveDistances,
+        ids);
+  }
+
+  // Removing a point twice, or a point that does not exist, is an error.
+  BOOST_REQUIRE_THROW(knn.Remove(order[0]), std::invalid_argument);
+  BOOST_REQUIRE_THROW(knn.Remove(600), std::invalid_argument);
+
+  // New points get new ids.
+  BOOST_REQUIRE_EQUAL(knn.Insert(dataset.cols(0, 9)), 600);
+  BOOST_REQUIRE_EQUAL(knn.NumPoints(), 310);
+  BOOST_REQUIRE_EQUAL(knn.NumIds(), 610);
+}
+
+/**
+ * Make sure that furthest neighbor search with cover trees works too.
+ */
+BOOST_AUTO_TEST_CASE(DynamicKFNCoverTreeTest)
+{
+  arma::mat dataset(3, 400, arma::fill::randu);
+  arma::mat querySet(3, 30, arma::fill::randu);
+
+  DynamicNeighborSearch<FurthestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> kfn(DUAL_TREE_MODE, 0.0, 20);
+  for (size_t b = 0; b < 4; ++b)
+    kfn.Insert(dataset.cols(100 * b, 100 * b + 99));
+
+  for (size_t i = 0; i < 400; i += 3)
+    kfn.Remove(i);
+
+  std::vector<size_t> ids;
+  KFN naive(LivePoints(kfn, dataset, ids), NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  kfn.Search(querySet, 4, neighbors, distances);
+  naive.Search(querySet, 4, naiveNeighbors, naiveDistances);
+
+  CheckDynamicResults(neighbors, distances, naiveNeighbors, naiveDistances,
+      ids);
+}
+
+/**
+ * Make sure that invalid searches are rejected.
+ */
+BOOST_AUTO_TEST_CASE(DynamicKNNInvalidTest)
+{
+  arma::mat dataset(3, 10, arma::fill::randu);
+  DynamicNeighborSearch<NearestNeighborSort> knn;
+  knn.Insert(dataset);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(knn.Search(dataset, 11, neighbors, distances),
+      std::invalid_argument);
+
+  arma::mat wrongDimensions(4, 5, arma::fill::randu);
+  BOOST_REQUIRE_THROW(knn.Insert(wrongDimensions), std::invalid_argument);
+
+  BOOST_REQUIRE_THROW(DynamicNeighborSearch<NearestNeighborSort>(
+      DUAL_TREE_MODE, 0.0, 0), std::invalid_argument);
+}
+
+/**
+ * Make sure that the fixed-dimensionality KNN gives the same results as KNN in
+ * each search mode.
+ */
+BOOST_AUTO_TEST_CASE(FixedKNNTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  arma::mat querySet(3, 200, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 5, neighbors, distances);
+
+  const NeighborSearchMode modes[] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    FixedKNN<3> fixedKnn(dataset, modes[m]);
+    arma::Mat<size_t> fixedNeighbors;
+    arma::mat fixedDistances;
+    fixedKnn.Search(querySet, 5, fixedNeighbors, fixedDistances);
+
+    BOOST_REQUIRE_EQUAL(fixedNeighbors.n_rows, neighbors.n_rows);
+    BOOST_REQUIRE_EQUAL(fixedNeighbors.n_cols, neighbors.n_cols);
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(fixedNeighbors[i], neighbors[i]);
+      BOOST_REQUIRE_CLOSE(fixedDistances[i], distances[i], 1e-5);
+    }
+  }
+}
+
+// Make sure that a dual-tree search on the given tree (with large leaves, so
+// that the base cases between leaves are computed in blocks) gives the same
+// results as a naive search.
+template<typename SearchType>
+void CheckBlockBaseCases(typename SearchType::Tree&& tree)
+{
+  SearchType naive(tree.Dataset(), NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  SearchType dualTree(std::move(tree));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  dualTree.Search(5, neighbors, distances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Dual-tree search with large leaves should give exactly the same results as
+ * the naive search, even on data far from the origin.
+ */
+BOOST_AUTO_TEST_CASE(KNNBlockBaseCaseTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2000) + 100.0;
+
+  std::vector<size_t> oldFromNew;
+  CheckBlockBaseCases<KNN>(KNN::Tree(dataset, oldFromNew, 64));
+  CheckBlockBaseCases<KFN>(KFN::Tree(dataset, oldFromNew, 64));
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      Octree> OctreeKNN;
+  CheckBlockBaseCases<OctreeKNN>(OctreeKNN::Tree(dataset, oldFromNew, 64));
+
+  typedef NeighborSearch<NearestNeighborSort, SquaredEuclideanDistance>
+      SquaredKNN;
+  CheckBlockBaseCases<SquaredKNN>(SquaredKNN::Tree(dataset, oldFromNew, 64));
+}
+
+/**
+ * Test the dual-tree nearest-neighbors method with the parallel breadth-first
+ * traverser against the naive method, both with a query set and without one.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBreadthFirstKNNTest)
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      KDTree, KDTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat>::template ParallelBreadthFirstDualTreeTraverser>
+      ParallelKNN;
+
+  ParallelKNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(querySet, 10, neighbors, distances);
+  naive.Search(querySet, 10, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+
+  knn.Search(10, neighbors, distances);
+  naive.Search(10, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that the k-nearest-neighbor graph of NN-Descent is well-formed and
+ * has a high recall, with both random and random projection tree
+ * initialization.
+ */
+BOOST_AUTO_TEST_CASE(NNDescentTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  const size_t k = 10;
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(k, trueNeighbors, trueDistances);
+
+  for (size_t rpTrees = 0; rpTrees < 3; rpTrees += 2)
+  {
+    NNDescent<> nnd(20, 0.5, 0.001, rpTrees);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    nnd.Compute(dataset, k, neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, k);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, dataset.n_cols);
+    BOOST_REQUIRE_EQUAL(distances.n_rows, k);
+    BOOST_REQUIRE_EQUAL(distances.n_cols, dataset.n_cols);
+    BOOST_REQUIRE_GT(nnd.Iterations(), 0);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      for (size_t j = 0; j < k; ++j)
+      {
+        BOOST_REQUIRE_NE(neighbors(j, i), i);
+        const double distance = metric::EuclideanDistance::Evaluate(
+            dataset.col(i), dataset.col(neighbors(j, i)));
+        BOOST_REQUIRE_CLOSE(distances(j, i), distance, 1e-5);
+        if (j > 0)
+          BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+      }
+    }
+
+    BOOST_REQUIRE_GT(KNN::Recall(neighbors, trueNeighbors), 0.9);
+  }
+}
+
+/**
+ * Make sure that a search on a sharded reference set gives the same results as
+ * a search on the whole reference set, also with a shard smaller than k.
+ */
+BOOST_AUTO_TEST_CASE(ShardedKNNTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 302);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  const size_t k = 5;
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors, trueMonoNeighbors;
+  arma::mat trueDistances, trueMonoDistances;
+  knn.Search(queryData, k, trueNeighbors, trueDistances);
+  knn.Search(k, trueMonoNeighbors, trueMonoDistances);
+
+  for (int mode = NAIVE_MODE; mode <= DUAL_TREE_MODE; ++mode)
+  {
+    ShardedNeighborSearch<NearestNeighborSort> sharded(
+        referenceData.cols(0, 299), 3, (NeighborSearchMode) mode);
+    BOOST_REQUIRE_EQUAL(sharded.AddShard(referenceData.cols(300, 301)), 300);
+    BOOST_REQUIRE_EQUAL(sharded.NumShards(), 4);
+    BOOST_REQUIRE_EQUAL(sharded.NumPoints(), 302);
+    BOOST_REQUIRE_EQUAL(sharded.ShardSize(3), 2);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    sharded.Search(queryData, k, neighbors, distances);
+    CheckMatrices(neighbors, trueNeighbors);
+    CheckMatrices(distances, trueDistances);
+
+    sharded.Search(k, neighbors, distances);
+    CheckMatrices(neighbors, trueMonoNeighbors);
+    CheckMatrices(distances, trueMonoDistances);
+  }
+
+  // Merging the results of two halves of the reference set gives the results
+  // of the whole set, in either order.
+  KNN left(referenceData.cols(0, 150));
+  KNN right(referenceData.cols(151, 301));
+  arma::Mat<size_t> leftNeighbors, rightNeighbors;
+  arma::mat leftDistances, rightDistances;
+  left.Search(queryData, k, leftNeighbors, leftDistances);
+  right.Search(queryData, k, rightNeighbors, rightDistances);
+  rightNeighbors += 151;
+
+  arma::Mat<size_t> neighbors = leftNeighbors;
+  arma::mat distances = leftDistances;
+  ShardedNeighborSearch<NearestNeighborSort>::MergeResults(neighbors,
+      distances, rightNeighbors, rightDistances);
+  CheckMatrices(neighbors, trueNeighbors);
+  CheckMatrices(distances, trueDistances);
+
+  ShardedNeighborSearch<NearestNeighborSort>::MergeResults(rightNeighbors,
+      rightDistances, leftNeighbors, leftDistances);
+  CheckMatrices(rightNeighbors, trueNeighbors);
+  CheckMatrices(rightDistances, trueDistances);
+
+  arma::Mat<size_t> smallNeighbors(k - 1, queryData.n_cols);
+  arma::mat smallDistances(k - 1, queryData.n_cols);
+  BOOST_REQUIRE_THROW(ShardedNeighborSearch<NearestNeighborSort>::MergeResults(
+      neighbors, distances, smallNeighbors, smallDistances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that k-NN with a KDTree on data transformed by
+ * MahalanobisDistance::Transform() finds the Mahalanobis nearest neighbors.
+ */
+BOOST_AUTO_TEST_CASE(MahalanobisTransformedKNNTest)
+{
+  const arma::mat factor = arma::randu<arma::mat>(4, 4) +
+      arma::eye<arma::mat>(4, 4);
+  MahalanobisDistance<true> distance(factor.t() * factor);
+
+  const arma::mat references = arma::randu<arma::mat>(4, 300);
+  const arma::mat queries = arma::randu<arma::mat>(4, 40);
+  const size_t k = 5;
+
+  arma::mat transformedReferences, transformedQueries;
+  distance.Transform(references, transformedReferences);
+  distance.Transform(queries, transformedQueries);
+
+  KNN knn(std::move(transformedReferences));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(transformedQueries, k, neighbors, distances);
+
+  // Compare with an exhaustive search with the Mahalanobis distance.
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    arma::vec all(references.n_cols);
+    for (size_t r = 0; r < references.n_cols; ++r)
+      all[r] = distance.Evaluate(queries.col(q), references.col(r));
+    const arma::uvec order = arma::sort_index(all);
+
+    for (size_t i = 0; i < k; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(i, q), order[i]);
+      BOOST_REQUIRE_CLOSE(distances(i, q), all[order[i]], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the batches of neighbors of a ResumableNeighborSearch are the
+ * same as the neighbors found by a search for all of them at once.
+ */
+template<typename SearchType>
+void CheckResumableResults(SearchType& search,
+                           const std::vector<size_t>& batches,
+                           const arma::Mat<size_t>& trueNeighbors,
+                           const arma::mat& trueDistances)
+{
+  size_t begin = 0;
+  for (size_t b = 0; b < batches.size(); ++b)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    search.Next(batches[b], neighbors, distances);
+
+    BOOST_REQUIRE_EQUAL(neighbors.n_rows, batches[b]);
+    BOOST_REQUIRE_EQUAL(neighbors.n_cols, trueNeighbors.n_cols);
+    for (size_t q = 0; q < neighbors.n_cols; ++q)
+    {
+      BOOST_REQUIRE_EQUAL(search.NumReturned(q), begin + batches[b]);
+      for (size_t i = 0; i < batches[b]; ++i)
+      {
+        BOOST_REQUIRE_EQUAL(neighbors(i, q), trueNeighbors(begin + i, q));
+        BOOST_REQUIRE_CLOSE(distances(i, q), trueDistances(begin + i, q),
+            1e-5);
+      }
+    }
+
+    begin += batches[b];
+  }
+}
+
+/**
+ * Make sure that resumed k-nearest-neighbor searches return the same neighbors
+ * as one search, and calculate fewer distances than a full search.
+ */
+BOOST_AUTO_TEST_CASE(ResumableKNNTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  arma::mat querySet(3, 50, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 50, naiveNeighbors, naiveDistances);
+
+  ResumableNeighborSearch<NearestNeighborSort> knn(dataset);
+  knn.Start(querySet);
+  BOOST_REQUIRE_EQUAL(knn.NumQueries(), 50);
+  BOOST_REQUIRE_EQUAL(knn.BaseCases(), 0);
+
+  std::vector<size_t> batches = { 10, 40 };
+  CheckResumableResults(knn, batches, naiveNeighbors, naiveDistances);
+  BOOST_REQUIRE_LT(knn.BaseCases(), 50 * 1000);
+
+  // Starting again gives the same results.
+  knn.Start(querySet);
+  batches = { 1, 4, 45 };
+  CheckResumableResults(knn, batches, naiveNeighbors, naiveDistances);
+}
+
+/**
+ * Make sure that resumed k-furthest-neighbor searches with the cover tree
+ * (which has self-children) return the same neighbors as one search.
+ */
+BOOST_AUTO_TEST_CASE(ResumableKFNCoverTreeTest)
+{
+  arma::mat dataset(3, 400, arma::fill::randu);
+  arma::mat querySet(3, 30, arma::fill::randu);
+
+  KFN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 8, naiveNeighbors, naiveDistances);
+
+  ResumableNeighborSearch<FurthestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> kfn(dataset);
+  kfn.Start(querySet);
+
+  const std::vector<size_t> batches = { 3, 5 };
+  CheckResumableResults(kfn, batches, naiveNeighbors, naiveDistances);
+}
+
+/**
+ * Make sure that a resumed search returns every reference point once, and
+ * then fills the results with invalid neighbors.
+ */
+BOOST_AUTO_TEST_CASE(ResumableKNNExhaustTest)
+{
+  arma::mat dataset(2, 20, arma::fill::randu);
+  arma::mat querySet(2, 3, arma::fill::randu);
+
+  ResumableNeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      BallTree> knn(dataset);
+  knn.Start(querySet);
+
+  arma::Col<size_t> neighbors;
+  arma::vec distances;
+  knn.Next(1, 15, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(knn.NumReturned(0), 0);
+  BOOST_REQUIRE_EQUAL(knn.NumReturned(1), 15);
+
+  arma::Col<size_t> moreNeighbors;
+  arma::vec moreDistances;
+  knn.Next(1, 10, moreNeighbors, moreDistances);
+  BOOST_REQUIRE_EQUAL(knn.NumReturned(1), 20);
+
+  // The distances are sorted, and every point is returned once.
+  std::vector<bool> returned(20, false);
+  for (size_t i = 0; i < 15; ++i)
+  {
+    returned[neighbors[i]] = true;
+    if (i > 0)
+      BOOST_REQUIRE_LE(distances[i - 1], distances[i]);
+  }
+  BOOST_REQUIRE_LE(distances[14], moreDistances[0]);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE(!returned[moreNeighbors[i]]);
+    returned[moreNeighbors[i]] = true;
+  }
+  for (size_t i = 5; i < 10; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(moreNeighbors[i], size_t(-1));
+    BOOST_REQUIRE_EQUAL(moreDistances[i], DBL_MAX);
+  }
+
+  BOOST_REQUIRE_THROW(knn.Next(3, 1, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that an anytime search without a budget is exact, and that with a
+ * budget the neighbors found are no better than the true ones, and the true
+ * ones wherever they are within the returned bounds.
+ */
+BOOST_AUTO_TEST_CASE(AnytimeKNNTest)
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  arma::mat querySet(3, 100, arma::fill::randu);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::vec bounds;
+  BOOST_REQUIRE_THROW(naive.AnytimeSearch(querySet, 5, 0, 0.0, neighbors,
+      distances, bounds), std::invalid_argument);
+
+  KNN knn(dataset);
+  knn.AnytimeSearch(querySet, 5, 0, 0.0, neighbors, distances, bounds);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(bounds[i], NearestNeighborSort::WorstDistance());
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), naiveNeighbors(j, i));
+      BOOST_REQUIRE_CLOSE(distances(j, i), naiveDistances(j, i), 1e-5);
+    }
+  }
+
+  // Stop after the first leaf of each query point.
+  knn.AnytimeSearch(querySet, 5, 1, 0.0, neighbors, distances, bounds);
+  size_t unfinished = 0;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (bounds[i] != NearestNeighborSort::WorstDistance())
+      ++unfinished;
+
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_GE(distances(j, i), naiveDistances(j, i) - 1e-10);
+      if (distances(j, i) <= bounds[i])
+        BOOST_REQUIRE_CLOSE(distances(j, i), naiveDistances(j, i), 1e-5);
+    }
+  }
+  BOOST_REQUIRE_GT(unfinished, 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
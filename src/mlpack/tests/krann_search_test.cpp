@@ -20,6 +20,10 @@
 #include <mlpack/methods/rann/ra_search.hpp>
 #include <mlpack/methods/rann/ra_model.hpp>
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace std;
 using namespace mlpack;
 using namespace mlpack::neighbor;
@@ -212,6 +216,94 @@ BOOST_AUTO_TEST_CASE(DualTreeSearch)
   BOOST_REQUIRE_LT(numQueriesFail, maxNumQueriesFail);
 }
 
+// Test the guarantees of KRANN when the query points are searched in parallel,
+// in single-tree and dual-tree mode.
+BOOST_AUTO_TEST_CASE(ParallelSearchGuaranteeTest)
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  data::Load("rann_test_r_3_900.csv", refData, true);
+  data::Load("rann_test_q_3_100.csv", queryData, true);
+
+  arma::Mat<size_t> qrRanks;
+  data::Load("rann_test_qr_ranks.csv", qrRanks, true, false); // No transpose.
+
+  // 1% of 900 is 9, so the rank is expected to be less than 10.
+  const size_t expectedRankErrorUB = 10;
+  const size_t numRounds = 1000;
+  const size_t threshold = floor(numRounds *
+      (0.95 - (1.96 * sqrt(0.95 * 0.05 / numRounds))));
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    RASearch<> parallelRann(refData, false, (mode == 0), 1.0, 0.95, false,
+        false, 5);
+    parallelRann.Parallel() = true;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    arma::Col<size_t> numSuccessRounds(queryData.n_cols);
+    numSuccessRounds.fill(0);
+    for (size_t rounds = 0; rounds < numRounds; rounds++)
+    {
+      parallelRann.Search(queryData, 1, neighbors, distances);
+
+      for (size_t i = 0; i < queryData.n_cols; i++)
+        if (qrRanks(i, neighbors(0, i)) < expectedRankErrorUB)
+          numSuccessRounds[i]++;
+    }
+
+    size_t numQueriesFail = 0;
+    for (size_t i = 0; i < queryData.n_cols; i++)
+      if (numSuccessRounds[i] < threshold)
+        numQueriesFail++;
+
+    BOOST_REQUIRE_LT(numQueriesFail, 6);
+  }
+}
+
+// Make sure that the parallel search returns the same neighbors for the same
+// random seed whatever the number of threads, and that the monochromatic
+// search doesn't return points as their own neighbors.
+BOOST_AUTO_TEST_CASE(ParallelSearchDeterminismTest)
+{
+  arma::mat dataset(4, 2000, arma::fill::randn);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RASearch<> rann(dataset, (mode == 0), (mode == 1));
+    rann.Parallel() = true;
+
+    arma::Mat<size_t> neighbors1, neighbors2;
+    arma::mat distances1, distances2;
+
+    #ifdef HAS_OPENMP
+      const int threads = omp_get_max_threads();
+      omp_set_num_threads(1);
+    #endif
+    math::RandomSeed(20);
+    rann.Search(3, neighbors1, distances1);
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(std::max(threads, 4));
+    #endif
+    math::RandomSeed(20);
+    rann.Search(3, neighbors2, distances2);
+    #ifdef HAS_OPENMP
+      omp_set_num_threads(threads);
+    #endif
+
+    BOOST_REQUIRE_EQUAL(neighbors1.n_rows, 3);
+    BOOST_REQUIRE_EQUAL(neighbors1.n_cols, 2000);
+    CheckMatrices(neighbors1, neighbors2);
+    CheckMatrices(distances1, distances2);
+
+    for (size_t i = 0; i < neighbors1.n_cols; ++i)
+      for (size_t j = 0; j < neighbors1.n_rows; ++j)
+        BOOST_REQUIRE_NE(neighbors1(j, i), i);
+  }
+}
+
 // Test rank-approximate search with just a single dataset.  These tests just
 // ensure that the method runs okay.
 BOOST_AUTO_TEST_CASE(SingleDatasetNaiveSearch)
@@ -352,4 +352,104 @@ BOOST_AUTO_TEST_CASE(TrainingConstructorWithNonDefaultsTest)
     BOOST_REQUIRE_CLOSE(beta[i], lars2.Beta()[i], 1e-5);
 }
 
+/**
+ * Make sure that training twice on data of the same dimensionality uses the
+ * Gram matrix of the new data.
+ */
+BOOST_AUTO_TEST_CASE(RetrainSameDimensionalityTest)
+{
+  arma::mat origX, newX;
+  arma::rowvec origY, newY;
+  GenerateProblem(origX, origY, 1000, 50);
+  GenerateProblem(newX, newY, 750, 50);
+
+  for (size_t useCholesky = 0; useCholesky < 2; ++useCholesky)
+  {
+    LARS lars((useCholesky == 1), 0.1, 0.1);
+    arma::vec betaOpt;
+    lars.Train(origX, origY, betaOpt);
+    lars.Train(newX, newY, betaOpt);
+
+    arma::vec errCorr = (newX * trans(newX) + 0.1 *
+          arma::eye(50, 50)) * betaOpt - newX * newY.t();
+
+    LARSVerifyCorrectness(betaOpt, errCorr, 0.1);
+  }
+}
+
+/**
+ * Make sure that training from the correlations and the Gram matrix gives the
+ * same solution as training on the data.
+ */
+BOOST_AUTO_TEST_CASE(TrainCovarianceTest)
+{
+  arma::mat X;
+  arma::rowvec y;
+  GenerateProblem(X, y, 500, 30);
+
+  for (size_t useCholesky = 0; useCholesky < 2; ++useCholesky)
+  {
+    LARS lars1((useCholesky == 1), 0.5, 0.25);
+    arma::vec beta1;
+    lars1.Train(X, y, beta1);
+
+    arma::mat gram = X * X.t();
+    if (useCholesky == 0)
+      gram.diag() += 0.25;
+    LARS lars2((useCholesky == 1), gram, 0.5, 0.25);
+    arma::vec beta2;
+    lars2.TrainCovariance(X * y.t(), beta2);
+
+    BOOST_REQUIRE_EQUAL(beta1.n_elem, beta2.n_elem);
+    for (size_t i = 0; i < beta1.n_elem; ++i)
+    {
+      if (std::abs(beta1[i]) < 1e-10)
+        BOOST_REQUIRE_SMALL(beta2[i], 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(beta1[i], beta2[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that solving many responses at once gives the same solutions as
+ * training on each of them, for both layouts of the data.
+ */
+BOOST_AUTO_TEST_CASE(SolveTest)
+{
+  arma::mat X = arma::randn(20, 200);
+  arma::mat responses = arma::randn(10, 20) * X;
+
+  for (size_t useCholesky = 0; useCholesky < 2; ++useCholesky)
+  {
+    LARS lars((useCholesky == 1), 0.1, 0.05);
+    arma::mat betas, rowMajorBetas;
+    lars.Solve(X, responses, betas);
+    lars.Solve(arma::mat(X.t()), responses, rowMajorBetas, false);
+
+    BOOST_REQUIRE_EQUAL(betas.n_rows, 20);
+    BOOST_REQUIRE_EQUAL(betas.n_cols, 10);
+    for (size_t i = 0; i < responses.n_rows; ++i)
+    {
+      arma::vec beta;
+      arma::rowvec y = responses.row(i);
+      lars.Train(X, y, beta);
+
+      for (size_t j = 0; j < beta.n_elem; ++j)
+      {
+        if (std::abs(beta[j]) < 1e-10)
+        {
+          BOOST_REQUIRE_SMALL(betas(j, i), 1e-10);
+          BOOST_REQUIRE_SMALL(rowMajorBetas(j, i), 1e-10);
+        }
+        else
+        {
+          BOOST_REQUIRE_CLOSE(betas(j, i), beta[j], 1e-5);
+          BOOST_REQUIRE_CLOSE(rowMajorBetas(j, i), beta[j], 1e-5);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -78,6 +78,43 @@ BOOST_AUTO_TEST_CASE(TestCenterB)
       BOOST_REQUIRE_CLOSE(tmp_out(row, col), (double) (col - 2.5) * row, 1e-5);
 }
 
+/**
+ * Make sure centering a matrix in place gives the same result as centering it
+ * into another matrix.
+ */
+BOOST_AUTO_TEST_CASE(TestCenterInPlace)
+{
+  mat tmp = randu<mat>(4, 50) * 10 + 3;
+  mat tmp_out;
+  Center(tmp, tmp_out);
+
+  mat tmp_in_place(tmp);
+  Center(tmp_in_place);
+  BOOST_REQUIRE_SMALL(accu(abs(tmp_in_place - tmp_out)), 1e-10);
+
+  // With the same object as the input and the output.
+  Center(tmp, tmp);
+  BOOST_REQUIRE_SMALL(accu(abs(tmp - tmp_out)), 1e-10);
+}
+
+/**
+ * Make sure the covariance accumulated over blocks of columns matches the
+ * covariance of the centered data, also when the mean is far from zero.
+ */
+BOOST_AUTO_TEST_CASE(TestBlockedCcov)
+{
+  const mat mixing = randu<mat>(4, 4);
+  mat data = mixing * randn<mat>(4, 3000);
+  data.each_col() += vec("1e4 -2e4 3e4 5");
+
+  const mat centered = data.each_col() - mean(data, 1);
+  const mat expected = centered * centered.t() / (data.n_cols - 1);
+
+  BOOST_REQUIRE_SMALL(accu(abs(ccov(data) - expected)), 1e-5);
+  BOOST_REQUIRE_SMALL(accu(abs(ccov(data, 1) - expected *
+      (data.n_cols - 1) / data.n_cols)), 1e-5);
+}
+
 BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
 {
   // After whitening using eigendecomposition, the covariance of
@@ -200,6 +200,74 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTrainTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrain.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that a model updated with batches of data is the same as a model
+ * trained on all the data at once.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionUpdateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(1000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(1000);
+
+  LinearRegression lr(dataset, responses, weights, 0.3);
+
+  // Start from a trained model, then from an empty one.
+  LinearRegression lrTrained(dataset.cols(0, 399), responses.subvec(0, 399),
+      weights.subvec(0, 399), 0.3);
+  LinearRegression lrEmpty;
+  lrEmpty.Lambda() = 0.3;
+  for (size_t i = 0; i < 1000; i += 200)
+  {
+    if (i >= 400)
+    {
+      lrTrained.Update(dataset.cols(i, i + 199), responses.subvec(i, i + 199),
+          weights.subvec(i, i + 199));
+    }
+    lrEmpty.Update(dataset.cols(i, i + 199), responses.subvec(i, i + 199),
+        weights.subvec(i, i + 199));
+  }
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, 6);
+  BOOST_REQUIRE_EQUAL(lrTrained.Parameters().n_elem, 6);
+  BOOST_REQUIRE_EQUAL(lrEmpty.Parameters().n_elem, 6);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrTrained.Parameters()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrEmpty.Parameters()[i], 1e-5);
+  }
+
+  // Data of the wrong dimension can't be added.
+  BOOST_REQUIRE_THROW(lrEmpty.Update(arma::randu<arma::mat>(4, 10),
+      arma::randu<arma::rowvec>(10)), std::invalid_argument);
+}
+
+/**
+ * Make sure that an update with a forgetting factor is the same as training on
+ * all the data with the older points weighted down by that factor.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionForgettingTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 600);
+  arma::rowvec responses = arma::randu<arma::rowvec>(600);
+
+  LinearRegression lrUpdate(dataset.cols(0, 299), responses.subvec(0, 299),
+      0.1);
+  lrUpdate.Update(dataset.cols(300, 599), responses.subvec(300, 599), 0.25);
+
+  arma::rowvec weights(600);
+  weights.subvec(0, 299).fill(0.25);
+  weights.subvec(300, 599).fill(1.0);
+  LinearRegression lr(dataset, responses, weights, 0.1);
+
+  BOOST_REQUIRE_EQUAL(lr.Parameters().n_elem, lrUpdate.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrUpdate.Parameters()[i], 1e-5);
+
+  BOOST_REQUIRE_THROW(lrUpdate.Update(dataset, responses, 1.5),
+      std::invalid_argument);
+}
+
 /*
  * Linear regression serialization test.
  */
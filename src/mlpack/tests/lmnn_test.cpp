@@ -14,6 +14,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/util/parallel.hpp>
 #include <mlpack/methods/lmnn/lmnn.hpp>
 #include <ensmallen.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
@@ -100,6 +101,59 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * Recomputing the impostors of some of the points (where only one class has
+ * points to recompute) should give the same impostors as computing them all.
+ */
+BOOST_AUTO_TEST_CASE(LMNNImpostorsSubsetTest)
+{
+  arma::mat dataset = arma::randu(3, 300);
+  arma::Row<size_t> labels(300);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  Constraints<> constraint(dataset, labels, 2);
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+    norm(i) = arma::norm(dataset.col(i));
+
+  arma::Mat<size_t> impostors(2, dataset.n_cols);
+  arma::mat distances(2, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  // Recompute the impostors of the points of class 1 only.
+  arma::Mat<size_t> subsetImpostors(2, dataset.n_cols, arma::fill::zeros);
+  arma::mat subsetDistances(2, dataset.n_cols, arma::fill::zeros);
+  arma::uvec points(dataset.n_cols);
+  size_t numPoints = 0;
+  for (size_t i = 1; i < dataset.n_cols; i += 3)
+    points(numPoints++) = i;
+  constraint.Impostors(subsetImpostors, subsetDistances, dataset, labels,
+      norm, points, numPoints);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 2; ++j)
+    {
+      if (labels[i] == 1)
+      {
+        BOOST_REQUIRE_EQUAL(subsetImpostors(j, i), impostors(j, i));
+        BOOST_REQUIRE_CLOSE(subsetDistances(j, i), distances(j, i), 1e-5);
+      }
+      else
+      {
+        BOOST_REQUIRE_EQUAL(subsetImpostors(j, i), 0);
+      }
+    }
+  }
+
+  // With no points to recompute, nothing should change.
+  constraint.Impostors(subsetImpostors, subsetDistances, dataset, labels,
+      norm, points, 0);
+  BOOST_REQUIRE_EQUAL(subsetImpostors(0, 1), impostors(0, 1));
+}
+
 //
 // Tests for the LMNNFunction
 //
@@ -732,4 +786,53 @@ BOOST_AUTO_TEST_CASE(LMNNFunctionGradientTest4)
   }
 }
 
+/**
+ * Make sure that the gradients (computed with the triplets of the points split
+ * between threads) don't depend on the number of threads, and that the
+ * non-separable, separable and EvaluateWithGradient() gradients agree on a
+ * dataset large enough to have several blocks of points.
+ */
+BOOST_AUTO_TEST_CASE(LMNNGradientThreadsTest)
+{
+  arma::mat dataset = arma::randu(3, 600);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  const arma::mat transformation = "1.0 0.2 0.0; 0.0 1.0 0.1; 0.3 0.0 1.0";
+
+  arma::mat gradients[2], batchGradients[2], ewgGradients[2],
+      batchEWGGradients[2];
+  double objectives[2], batchObjectives[2];
+  const size_t threads[2] = { 1, 4 };
+  for (size_t t = 0; t < 2; ++t)
+  {
+    ScopedThreads scoped(threads[t]);
+
+    LMNNFunction<> lmnnfn(dataset, labels, 2, 0.5, 1);
+    lmnnfn.Gradient(transformation, gradients[t]);
+
+    LMNNFunction<> batchLMNNFn(dataset, labels, 2, 0.5, 1);
+    batchLMNNFn.Gradient(transformation, 0, batchGradients[t], 600);
+
+    LMNNFunction<> ewgLMNNFn(dataset, labels, 2, 0.5, 1);
+    objectives[t] = ewgLMNNFn.EvaluateWithGradient(transformation,
+        ewgGradients[t]);
+
+    LMNNFunction<> batchEWGLMNNFn(dataset, labels, 2, 0.5, 1);
+    batchObjectives[t] = batchEWGLMNNFn.EvaluateWithGradient(transformation,
+        0, batchEWGGradients[t], 600);
+  }
+
+  for (size_t t = 0; t < 2; ++t)
+  {
+    CheckMatrices(gradients[t], gradients[0], 1e-8);
+    CheckMatrices(batchGradients[t], gradients[0], 1e-8);
+    CheckMatrices(ewgGradients[t], gradients[0], 1e-8);
+    CheckMatrices(batchEWGGradients[t], gradients[0], 1e-8);
+    BOOST_REQUIRE_CLOSE(objectives[t], objectives[0], 1e-8);
+    BOOST_REQUIRE_CLOSE(batchObjectives[t], objectives[0], 1e-8);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,8 @@
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/batch_loader.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
 #include <mlpack/core/data/load_arff.hpp>
 #include <mlpack/core/data/map_policies/missing_policy.hpp>
 
@@ -1819,6 +1821,141 @@ BOOST_AUTO_TEST_CASE(CaseTest)
   BOOST_CHECK_EQUAL(dataset.n_cols, 3);
 }
 
+/**
+ * Nominal ARFF attributes have their values mapped in the order of the header,
+ * and a pre-existing DatasetInfo keeps its mappings.
+ */
+BOOST_AUTO_TEST_CASE(NominalARFFTest)
+{
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute color {red, green, 'light blue'}" << endl;
+  f << "@attribute size numeric" << endl;
+  f << "@attribute \"shape\" { square,circle }" << endl;
+  f << "@data" << endl;
+  f << "green, 1.5, circle" << endl;
+  f << "'light blue', 2, square" << endl;
+  f << "% a comment" << endl;
+  f << endl;
+  f << "red, 3, circle % another comment" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dataset, info);
+
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), 3);
+  BOOST_REQUIRE(info.Type(0) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(1) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(0), 3);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 2);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 3);
+
+  BOOST_REQUIRE_EQUAL(dataset(0, 0), 1);
+  BOOST_REQUIRE_EQUAL(dataset(0, 1), 2);
+  BOOST_REQUIRE_EQUAL(dataset(0, 2), 0);
+  BOOST_REQUIRE_CLOSE(dataset(1, 0), 1.5, 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(1, 1), 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(dataset(1, 2), 3.0, 1e-5);
+  BOOST_REQUIRE_EQUAL(dataset(2, 0), 1);
+  BOOST_REQUIRE_EQUAL(dataset(2, 1), 0);
+  BOOST_REQUIRE_EQUAL(dataset(2, 2), 1);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(2, 0), "light blue");
+
+  // Loading again with the same DatasetInfo gives the same mappings.
+  arma::mat dataset2;
+  data::LoadARFF("test.arff", dataset2, info);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(0), 3);
+  CheckMatrices(dataset, dataset2);
+
+  // A value that is not in the header is an error.
+  f.open("test.arff", fstream::out);
+  f << "@attribute color {red, green}" << endl;
+  f << "@data" << endl;
+  f << "red" << endl;
+  f << "blue" << endl;
+  f.close();
+
+  DatasetInfo info2;
+  BOOST_REQUIRE_THROW(data::LoadARFF("test.arff", dataset2, info2),
+      std::runtime_error);
+
+  remove("test.arff");
+}
+
+/**
+ * Load an ARFF file with more lines than are parsed at once, and make sure
+ * that string attributes are mapped in the order of the file and that the
+ * first error of the file is the one reported.
+ */
+BOOST_AUTO_TEST_CASE(LargeARFFTest)
+{
+  const size_t points = 150000;
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation large" << endl;
+  f << "@attribute a numeric" << endl;
+  f << "@attribute b string" << endl;
+  f << "@attribute c {x, y, z}" << endl;
+  f << "@data" << endl;
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << i << ".5, s" << ((points - i) % 1000) << ", "
+        << (char) ('x' + i % 3) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dataset, info);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, points);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 1000);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 3);
+
+  for (size_t i = 0; i < points; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(dataset(0, i), i + 0.5, 1e-5);
+    // The first 1000 points have new strings, in order.
+    BOOST_REQUIRE_EQUAL(dataset(1, i), i % 1000);
+    BOOST_REQUIRE_EQUAL(dataset(2, i), i % 3);
+  }
+
+  // Break two lines; the first one must be the one reported.
+  f.open("test.arff", fstream::out);
+  f << "@attribute a numeric" << endl;
+  f << "@data" << endl;
+  for (size_t i = 0; i < points; ++i)
+  {
+    if (i == 100001)
+      f << "?" << endl;
+    else if (i == 120000)
+      f << "bad" << endl;
+    else
+      f << i << endl;
+  }
+  f.close();
+
+  DatasetInfo info2;
+  try
+  {
+    data::LoadARFF("test.arff", dataset, info2);
+    BOOST_FAIL("LoadARFF() should have thrown!");
+  }
+  catch (std::runtime_error& e)
+  {
+    BOOST_REQUIRE_EQUAL(std::string(e.what()), "Missing values ('?') not "
+        "supported, at line 100004 token 0: \"?\".");
+  }
+
+  remove("test.arff");
+}
+
 /**
  * Test that a CSV with the wrong number of columns fails.
  */
@@ -1971,6 +2108,601 @@ BOOST_AUTO_TEST_CASE(LoadCSVNoTransposeTXTTest)
   remove("test.txt");
 }
 
+/**
+ * Make sure that a large CSV with categorical dimensions gives the same
+ * mappings as a line-by-line parse would, even when the lines are parsed in
+ * parallel and a dimension only becomes categorical near the end of the file.
+ */
+BOOST_AUTO_TEST_CASE(LargeCategoricalCSVLoadTest)
+{
+  const size_t lines = 20000;
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < lines; ++i)
+  {
+    f << i << ", c" << ((i * 7) % 5) << ", ";
+    if (i == 15000)
+      f << "x";
+    else
+      f << (0.5 * i);
+    f << endl;
+  }
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", matrix, info, true));
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, lines);
+
+  BOOST_REQUIRE(info.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == Datatype::categorical);
+
+  // The categories of the second dimension are mapped in the order they first
+  // appear: c0, c2, c4, c1, c3.
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 5);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 1), "c0");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(1, 1), "c2");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(2, 1), "c4");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(3, 1), "c1");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(4, 1), "c3");
+
+  // Every token of the third dimension is unique, so each line gets its own
+  // mapping.
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), lines);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(15000, 2), "x");
+
+  const size_t order[5] = { 0, 3, 1, 4, 2 };
+  for (size_t i = 0; i < lines; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(matrix(0, i), (double) i);
+    BOOST_REQUIRE_EQUAL(matrix(1, i), (double) order[(i * 7) % 5]);
+    BOOST_REQUIRE_EQUAL(matrix(2, i), (double) i);
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure that the mappings of many categorical dimensions, which are mapped
+ * in parallel, are each given in the order of the lines.
+ */
+BOOST_AUTO_TEST_CASE(ManyCategoricalDimensionsCSVLoadTest)
+{
+  const size_t lines = 5000;
+  const size_t dims = 12;
+  fstream f;
+  f.open("test.csv", fstream::out);
+  for (size_t i = 0; i < lines; ++i)
+  {
+    for (size_t d = 0; d < dims; ++d)
+    {
+      // Dimension d has d + 2 categories, that appear in the order
+      // 0, d + 1, d, ..., 1.
+      f << "d" << d << "_" << ((i * (d + 1)) % (d + 2));
+      f << ((d == dims - 1) ? "\n" : ", ");
+    }
+  }
+  f.close();
+
+  arma::mat matrix;
+  DatasetInfo info;
+  BOOST_REQUIRE(data::Load("test.csv", matrix, info, true));
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, dims);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, lines);
+
+  for (size_t d = 0; d < dims; ++d)
+  {
+    BOOST_REQUIRE(info.Type(d) == Datatype::categorical);
+    BOOST_REQUIRE_EQUAL(info.NumMappings(d), d + 2);
+
+    for (size_t i = 0; i < lines; ++i)
+    {
+      // The k'th line holds the k'th new category, for k < d + 2.
+      const size_t category = (i * (d + 1)) % (d + 2);
+      const size_t mapping = (category == 0) ? 0 : d + 2 - category;
+      BOOST_REQUIRE_EQUAL(matrix(d, i), (double) mapping);
+      if (i < d + 2)
+      {
+        std::ostringstream oss;
+        oss << "d" << d << "_" << category;
+        BOOST_REQUIRE_EQUAL(info.UnmapString(i, d), oss.str());
+      }
+    }
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Make sure a matrix saved as .mmat loads back identically, without being
+ * transposed.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadMappedMatrixTest)
+{
+  arma::mat m(5, 100, arma::fill::randu);
+  BOOST_REQUIRE(data::Save("test.mmat", m));
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test.mmat", loaded));
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, m.n_rows);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, m.n_cols);
+  for (size_t i = 0; i < m.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(loaded[i], m[i]);
+
+  // Loading as another type converts the elements.
+  arma::fmat floatLoaded;
+  BOOST_REQUIRE(data::Load("test.mmat", floatLoaded));
+  BOOST_REQUIRE_EQUAL(floatLoaded.n_rows, m.n_rows);
+  BOOST_REQUIRE_EQUAL(floatLoaded.n_cols, m.n_cols);
+  for (size_t i = 0; i < m.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(floatLoaded[i], (float) m[i]);
+
+  remove("test.mmat");
+}
+
+/**
+ * Make sure a MappedMatrix uses the mapped file directly, and rejects files of
+ * the wrong element type or that aren't .mmat files.
+ */
+BOOST_AUTO_TEST_CASE(MappedMatrixTest)
+{
+  arma::Mat<size_t> m(3, 50);
+  for (size_t i = 0; i < m.n_elem; ++i)
+    m[i] = i * i;
+  data::SaveMappedMatrix("test.mmat", m);
+
+  {
+    data::MappedMatrix<size_t> mapped("test.mmat");
+    const arma::Mat<size_t>& mappedMatrix = mapped.Matrix();
+
+    BOOST_REQUIRE_EQUAL(mappedMatrix.n_rows, 3);
+    BOOST_REQUIRE_EQUAL(mappedMatrix.n_cols, 50);
+    for (size_t i = 0; i < m.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(mappedMatrix[i], i * i);
+
+    // The file holds size_t elements, not doubles.
+    BOOST_REQUIRE_THROW(data::MappedMatrix<double> wrongType("test.mmat"),
+        std::runtime_error);
+  }
+
+  // A truncated file is rejected.
+  std::vector<char> contents;
+  {
+    std::ifstream in("test.mmat", std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream out("test.mmat", std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), contents.size() - 8);
+  }
+  BOOST_REQUIRE_THROW(data::MappedMatrix<size_t> truncated("test.mmat"),
+      std::runtime_error);
+
+  // So is a file of another format.
+  fstream f;
+  f.open("test.mmat", fstream::out | fstream::trunc);
+  f << "1, 2, 3" << endl;
+  f.close();
+  BOOST_REQUIRE_THROW(data::MappedMatrix<size_t> notMapped("test.mmat"),
+      std::runtime_error);
+  arma::mat notLoaded;
+  BOOST_REQUIRE(!data::Load("test.mmat", notLoaded));
+
+  remove("test.mmat");
+}
+
+/**
+ * Make sure a BatchReader reads text and .mmat files in batches, and that a
+ * BatchWriter writes them back.
+ */
+BOOST_AUTO_TEST_CASE(BatchReaderWriterTest)
+{
+  arma::mat m(3, 25, arma::fill::randu);
+
+  const std::vector<std::string> filenames = { "test_batch.csv",
+      "test_batch.txt", "test_batch.mmat" };
+  for (const std::string& filename : filenames)
+  {
+    {
+      data::BatchWriter writer(filename, 3, 25);
+      writer.Write(m.cols(0, 9));
+      writer.Write(m.cols(10, 24));
+      writer.Close();
+    }
+
+    data::BatchReader reader(filename);
+    BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 3);
+
+    // Read the file twice, to check Rewind().
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      arma::mat batch;
+      arma::mat all(3, 0);
+      size_t batches = 0;
+      while (reader.Next(batch, 7))
+      {
+        BOOST_REQUIRE_LE(batch.n_cols, 7);
+        all = arma::join_rows(all, batch);
+        ++batches;
+      }
+
+      BOOST_REQUIRE_EQUAL(batches, 4);
+      BOOST_REQUIRE_EQUAL(reader.PointsRead(), 25);
+      BOOST_REQUIRE_EQUAL(all.n_cols, 25);
+      for (size_t i = 0; i < m.n_elem; ++i)
+        BOOST_REQUIRE_EQUAL(all[i], m[i]);
+
+      reader.Rewind();
+    }
+
+    remove(filename.c_str());
+  }
+
+  // Writing more points than announced is an error.
+  data::BatchWriter writer("test_batch.csv", 3, 10);
+  BOOST_REQUIRE_THROW(writer.Write(m), std::runtime_error);
+  remove("test_batch.csv");
+
+  // So is a line with the wrong number of values.
+  fstream f;
+  f.open("test_batch.csv", fstream::out | fstream::trunc);
+  f << "1, 2, 3" << endl << endl << "4, 5" << endl;
+  f.close();
+  data::BatchReader reader("test_batch.csv");
+  arma::mat batch;
+  BOOST_REQUIRE_THROW(reader.Next(batch, 10), std::runtime_error);
+  remove("test_batch.csv");
+}
+
+/**
+ * Make sure a BatchWriter can write a file without knowing the number of points
+ * in advance.
+ */
+BOOST_AUTO_TEST_CASE(BatchWriterUnknownSizeTest)
+{
+  arma::mat m(4, 13, arma::fill::randu);
+
+  const std::vector<std::string> filenames = { "test_batch.csv",
+      "test_batch.mmat" };
+  for (const std::string& filename : filenames)
+  {
+    {
+      data::BatchWriter writer(filename, 4);
+      writer.Write(m.cols(0, 4));
+      writer.Write(m.cols(5, 12));
+      BOOST_REQUIRE_EQUAL(writer.PointsWritten(), 13);
+      writer.Close();
+    }
+
+    arma::mat loaded;
+    BOOST_REQUIRE(data::Load(filename, loaded));
+    BOOST_REQUIRE_EQUAL(loaded.n_rows, 4);
+    BOOST_REQUIRE_EQUAL(loaded.n_cols, 13);
+    for (size_t i = 0; i < m.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(loaded[i], m[i]);
+
+    remove(filename.c_str());
+  }
+}
+
+/**
+ * Make sure a BatchReader reads the points of Armadillo binary (and HDF5, if
+ * available) files saved by data::Save() in batches.
+ */
+BOOST_AUTO_TEST_CASE(BatchReaderBinaryTest)
+{
+  arma::mat m(3, 25, arma::fill::randu);
+
+  std::vector<std::string> filenames = { "test_batch.bin" };
+#ifdef HAS_HDF5
+  filenames.push_back("test_batch.h5");
+#endif
+  for (const std::string& filename : filenames)
+  {
+    BOOST_REQUIRE(data::Save(filename, m));
+
+    data::BatchReader reader(filename);
+    BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 3);
+
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      arma::mat batch;
+      arma::mat all(3, 0);
+      size_t batches = 0;
+      while (reader.Next(batch, 7))
+      {
+        BOOST_REQUIRE_EQUAL(batch.n_rows, 3);
+        BOOST_REQUIRE_LE(batch.n_cols, 7);
+        all = arma::join_rows(all, batch);
+        ++batches;
+      }
+
+      BOOST_REQUIRE_EQUAL(batches, 4);
+      BOOST_REQUIRE_EQUAL(reader.PointsRead(), 25);
+      BOOST_REQUIRE_EQUAL(all.n_cols, 25);
+      for (size_t i = 0; i < m.n_elem; ++i)
+        BOOST_REQUIRE_EQUAL(all[i], m[i]);
+
+      reader.Rewind();
+    }
+
+    remove(filename.c_str());
+  }
+}
+
+/**
+ * Make sure a BatchReader maps the categorical dimensions of a text file the
+ * same way in every batch, and the same way as data::Load().
+ */
+BOOST_AUTO_TEST_CASE(BatchReaderCategoricalTest)
+{
+  // The last dimension only holds a string on the last line, so its earlier
+  // values must be mapped too.
+  fstream f;
+  f.open("test_batch.csv", fstream::out | fstream::trunc);
+  f << "1,a,3" << endl;
+  f << "2,b,4" << endl;
+  f << "3,a,3" << endl;
+  f << "4,c,5" << endl;
+  f << "5,b,x" << endl;
+  f.close();
+
+  arma::mat loaded;
+  data::DatasetInfo loadedInfo;
+  BOOST_REQUIRE(data::Load("test_batch.csv", loaded, loadedInfo));
+
+  data::DatasetInfo info;
+  data::BatchReader reader("test_batch.csv", info);
+  BOOST_REQUIRE_EQUAL(info.Dimensionality(), 3);
+  BOOST_REQUIRE(info.Type(0) == data::Datatype::numeric);
+  BOOST_REQUIRE(info.Type(1) == data::Datatype::categorical);
+  BOOST_REQUIRE(info.Type(2) == data::Datatype::categorical);
+
+  arma::mat batch;
+  arma::mat all(3, 0);
+  while (reader.Next(batch, 2))
+    all = arma::join_rows(all, batch);
+
+  BOOST_REQUIRE_EQUAL(all.n_cols, 5);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 3);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(2), 4);
+  for (size_t i = 0; i < loaded.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(all[i], loaded[i]);
+
+  // Reading the file again with the same mappings gives the same values.
+  data::BatchReader secondReader("test_batch.csv", info);
+  BOOST_REQUIRE(secondReader.Next(batch, 5));
+  for (size_t i = 0; i < loaded.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(batch[i], loaded[i]);
+
+  remove("test_batch.csv");
+}
+
+/**
+ * Make sure a BatchLoader visits each point exactly once per epoch, with its
+ * response, for mapped and text files, with and without prefetching.
+ */
+BOOST_AUTO_TEST_CASE(BatchLoaderTest)
+{
+  // The first value of each point is its index, and its response is twice the
+  // index.
+  arma::mat predictors(3, 53, arma::fill::randu);
+  predictors.row(0) = arma::regspace<arma::rowvec>(0, 52);
+  arma::mat responses = 2 * predictors.row(0);
+
+  const std::vector<std::string> extensions = { "csv", "mmat" };
+  for (const std::string& extension : extensions)
+  {
+    const std::string predictorsFile = "test_loader_x." + extension;
+    const std::string responsesFile = "test_loader_y." + extension;
+    {
+      data::BatchWriter writer(predictorsFile, 3, 53);
+      writer.Write(predictors);
+      writer.Close();
+      data::BatchWriter responsesWriter(responsesFile, 1, 53);
+      responsesWriter.Write(responses);
+      responsesWriter.Close();
+    }
+
+    for (size_t prefetch = 0; prefetch < 2; ++prefetch)
+    {
+      data::BatchLoader loader(predictorsFile, responsesFile, 8, true, 20,
+          prefetch == 1);
+      BOOST_REQUIRE_EQUAL(loader.Dimensionality(), 3);
+      BOOST_REQUIRE_EQUAL(loader.ResponseDimensionality(), 1);
+      BOOST_REQUIRE_EQUAL(loader.Mapped(), extension == "mmat");
+
+      arma::uvec firstOrder;
+      for (size_t epoch = 0; epoch < 2; ++epoch)
+      {
+        arma::mat batchPredictors, batchResponses;
+        arma::uvec seen(53, arma::fill::zeros);
+        arma::uvec visitOrder;
+        while (loader.Next(batchPredictors, batchResponses))
+        {
+          BOOST_REQUIRE_LE(batchPredictors.n_cols, 8);
+          BOOST_REQUIRE_EQUAL(batchResponses.n_cols, batchPredictors.n_cols);
+          for (size_t i = 0; i < batchPredictors.n_cols; ++i)
+          {
+            const size_t index = (size_t) batchPredictors(0, i);
+            BOOST_REQUIRE_LT(index, 53);
+            BOOST_REQUIRE_EQUAL(batchResponses(0, i), 2.0 * index);
+            BOOST_REQUIRE_CLOSE(batchPredictors(1, i), predictors(1, index),
+                1e-5);
+            ++seen[index];
+            visitOrder.resize(visitOrder.n_elem + 1);
+            visitOrder[visitOrder.n_elem - 1] = index;
+          }
+        }
+
+        BOOST_REQUIRE_EQUAL(loader.PointsRead(), 53);
+        BOOST_REQUIRE_EQUAL(arma::accu(seen == 1), 53);
+
+        // The points are shuffled, and again in each epoch.
+        BOOST_REQUIRE_GT(arma::accu(visitOrder !=
+            arma::regspace<arma::uvec>(0, 52)), 0);
+        if (epoch == 0)
+          firstOrder = visitOrder;
+        else
+          BOOST_REQUIRE_GT(arma::accu(visitOrder != firstOrder), 0);
+
+        loader.Rewind();
+      }
+    }
+
+    remove(predictorsFile.c_str());
+    remove(responsesFile.c_str());
+  }
+
+  // The files must hold the same number of points.
+  {
+    data::BatchWriter writer("test_loader_x.csv", 3, 53);
+    writer.Write(predictors);
+    writer.Close();
+    data::BatchWriter responsesWriter("test_loader_y.csv", 1, 50);
+    responsesWriter.Write(responses.cols(0, 49));
+    responsesWriter.Close();
+  }
+
+  data::BatchLoader loader("test_loader_x.csv", "test_loader_y.csv", 100,
+      false, 100, true);
+  arma::mat batchPredictors, batchResponses;
+  BOOST_REQUIRE_THROW(loader.Next(batchPredictors, batchResponses),
+      std::runtime_error);
+  remove("test_loader_x.csv");
+  remove("test_loader_y.csv");
+}
+
+/**
+ * Make sure a libsvm file is parsed correctly, including comments, blank lines,
+ * query ids, unsorted features and explicit zeros.
+ */
+BOOST_AUTO_TEST_CASE(LoadLibSVMTest)
+{
+  fstream f;
+  f.open("test.svm", fstream::out);
+  f << "# A comment." << endl;
+  f << "1 1:0.5 3:2" << endl;
+  f << "-1 qid:3 4:-1.5 2:1e-2 # Another comment." << endl;
+  f << endl;
+  f << "1 2:0 \r" << endl;
+  f << "0" << endl;
+  f.close();
+
+  arma::sp_mat matrix;
+  arma::Row<int> labels;
+  BOOST_REQUIRE(data::Load("test.svm", matrix, labels));
+
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(matrix.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(matrix.n_nonzero, 4);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 4);
+
+  BOOST_REQUIRE_EQUAL(labels[0], 1);
+  BOOST_REQUIRE_EQUAL(labels[1], -1);
+  BOOST_REQUIRE_EQUAL(labels[2], 1);
+  BOOST_REQUIRE_EQUAL(labels[3], 0);
+
+  BOOST_REQUIRE_CLOSE((double) matrix(0, 0), 0.5, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) matrix(2, 0), 2.0, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) matrix(1, 1), 0.01, 1e-5);
+  BOOST_REQUIRE_CLOSE((double) matrix(3, 1), -1.5, 1e-5);
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(matrix.col(2))), 0.0);
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(matrix.col(3))), 0.0);
+
+  // Unsigned labels can't hold -1.
+  arma::Row<size_t> unsignedLabels;
+  BOOST_REQUIRE(!data::Load("test.svm", matrix, unsignedLabels));
+
+  // The dimensionality can be larger than the largest index, but not smaller.
+  data::LoadLibSVM("test.svm", matrix, labels, 10);
+  BOOST_REQUIRE_EQUAL(matrix.n_rows, 10);
+  BOOST_REQUIRE_THROW(data::LoadLibSVM("test.svm", matrix, labels, 3),
+      std::runtime_error);
+
+  remove("test.svm");
+}
+
+/**
+ * Make sure malformed libsvm files are rejected.
+ */
+BOOST_AUTO_TEST_CASE(LoadLibSVMInvalidTest)
+{
+  const char* invalidLines[] = { "1 0:1.0", "1 3:1.0 3:2.0", "1 a:1.0",
+      "1 2:x", "1 2", "one 1:1" };
+
+  for (size_t i = 0; i < 6; ++i)
+  {
+    fstream f;
+    f.open("test.svm", fstream::out | fstream::trunc);
+    f << "1 1:1" << endl << invalidLines[i] << endl;
+    f.close();
+
+    arma::sp_mat matrix;
+    arma::rowvec labels;
+    BOOST_REQUIRE(!data::Load("test.svm", matrix, labels));
+    BOOST_REQUIRE_THROW(data::LoadLibSVM("test.svm", matrix, labels),
+        std::runtime_error);
+  }
+
+  // Sparse matrices can only be loaded from libsvm files.
+  arma::sp_mat matrix;
+  arma::rowvec labels;
+  BOOST_REQUIRE(!data::Load("test.csv", matrix, labels));
+
+  remove("test.svm");
+}
+
+/**
+ * Save a large random sparse dataset in libsvm format and make sure it loads
+ * back identically; the file is big enough to be parsed in several blocks when
+ * OpenMP is enabled.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadLibSVMTest)
+{
+  arma::sp_mat matrix;
+  matrix.sprandu(200, 20000, 0.05);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(0, 5);
+
+  // Make sure the last row is used, so that the dimensionality is right.
+  matrix(199, 0) = 1.0;
+
+  BOOST_REQUIRE(data::Save("test.svm", matrix, labels));
+
+  arma::sp_mat loaded;
+  arma::Row<size_t> loadedLabels;
+  BOOST_REQUIRE(data::Load("test.svm", loaded, loadedLabels));
+
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, matrix.n_rows);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, matrix.n_cols);
+  BOOST_REQUIRE_EQUAL(loaded.n_nonzero, matrix.n_nonzero);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(loadedLabels[i], labels[i]);
+
+  // The values are written with enough digits to be read back exactly.
+  arma::sp_mat::const_iterator it = matrix.begin();
+  arma::sp_mat::const_iterator loadedIt = loaded.begin();
+  for ( ; it != matrix.end(); ++it, ++loadedIt)
+  {
+    BOOST_REQUIRE_EQUAL(loadedIt.row(), it.row());
+    BOOST_REQUIRE_EQUAL(loadedIt.col(), it.col());
+    BOOST_REQUIRE_EQUAL((double) *loadedIt, (double) *it);
+  }
+
+  // A dense matrix can't be saved this way.
+  BOOST_REQUIRE(!data::Save("test.csv", matrix, labels));
+
+  remove("test.svm");
+}
+
 /**
  * Make sure DatasetMapper properly unmaps from non-unique strings.
  */
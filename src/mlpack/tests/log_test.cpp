@@ -6,6 +6,7 @@
  **/
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/async_log.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -14,6 +15,66 @@ using namespace mlpack;
 
 BOOST_AUTO_TEST_SUITE(LogTest);
 
+/**
+ * Make sure that the operands of MLPACK_LOG_INFO are only evaluated when
+ * Log::Info is shown.
+ */
+BOOST_AUTO_TEST_CASE(LogMacroLazyEvaluationTest)
+{
+  size_t evaluations = 0;
+  auto evaluate = [&evaluations]() { return ++evaluations; };
+
+  const bool ignoreInput = Log::Info.ignoreInput;
+  std::ostringstream output;
+  std::streambuf* original = std::cout.rdbuf(output.rdbuf());
+
+  Log::Info.ignoreInput = true;
+  MLPACK_LOG_INFO << "value " << evaluate() << std::endl;
+  BOOST_REQUIRE_EQUAL(evaluations, 0);
+
+  Log::Info.ignoreInput = false;
+  // The macro can be the body of an unbraced if.
+  if (evaluations == 0)
+    MLPACK_LOG_INFO << "value " << evaluate() << std::endl;
+  else
+    evaluations = 10;
+
+  std::cout.rdbuf(original);
+  Log::Info.ignoreInput = ignoreInput;
+
+  BOOST_REQUIRE_EQUAL(evaluations, 1);
+  // The prefix may be colored.
+  const std::string line = output.str();
+  BOOST_REQUIRE_GE(line.size(), 8);
+  BOOST_REQUIRE_EQUAL(line.substr(line.size() - 8), "value 1\n");
+}
+
+/**
+ * Make sure that AsyncLog writes all the lines, in order, both when flushed and
+ * when destroyed, even when the ring buffer is full.
+ */
+BOOST_AUTO_TEST_CASE(AsyncLogTest)
+{
+  std::ostringstream stream, expected;
+  {
+    util::AsyncLog asyncLog(stream, 4);
+    for (size_t i = 0; i < 100; ++i)
+    {
+      stream << "line " << i << std::endl;
+      expected << "line " << i << std::endl;
+    }
+
+    asyncLog.Flush();
+    BOOST_REQUIRE_EQUAL(stream.str(), expected.str());
+
+    // A partial line is written when the AsyncLog object is destroyed.
+    stream << "end";
+    expected << "end";
+  }
+
+  BOOST_REQUIRE_EQUAL(stream.str(), expected.str());
+}
+
 /**
  * Simple log assert test. Be careful the test halts the program execution, so
  * run the test at the end of all other tests.
@@ -841,6 +841,175 @@ BOOST_AUTO_TEST_CASE(ParallelMonochromatic)
 }
 #endif
 
+/**
+ * Test: queries are hashed in blocks, so make sure that searching for the whole
+ * query set at once gives the same results as searching for each query point
+ * separately.
+ */
+BOOST_AUTO_TEST_CASE(BlockedSearchTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(10, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(10, 300);
+
+  LSHSearch<> lshTest(rdata, 5, 10, 0.5);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lshTest.Search(qdata, 3, neighbors, distances, 0, 2);
+
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    arma::Mat<size_t> singleNeighbors;
+    arma::mat singleDistances;
+    lshTest.Search(qdata.col(i), 3, singleNeighbors, singleDistances, 0, 2);
+
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), singleNeighbors(j, 0));
+      BOOST_REQUIRE_EQUAL(distances(j, i), singleDistances(j, 0));
+    }
+  }
+}
+
+/**
+ * Test: inserting points into a trained model should give the same model as
+ * training on all of the points at once.
+ */
+BOOST_AUTO_TEST_CASE(InsertTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(10, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(10, 100);
+  arma::cube projections = arma::randn<arma::cube>(10, 5, 8);
+
+  // With an unlimited bucket size, the contents of each bucket do not depend
+  // on the order in which points are added.
+  math::RandomSeed(42);
+  LSHSearch<> lsh(rdata, projections, 0.5, 99901, 0);
+
+  math::RandomSeed(42);
+  LSHSearch<> incrementalLsh(rdata.cols(0, 599), projections, 0.5, 99901, 0);
+  incrementalLsh.Insert(rdata.cols(600, 899));
+  incrementalLsh.Insert(rdata.cols(900, 999));
+
+  CheckMatrices(lsh.ReferenceSet(), incrementalLsh.ReferenceSet());
+
+  arma::Mat<size_t> neighbors, incrementalNeighbors;
+  arma::mat distances, incrementalDistances;
+  lsh.Search(qdata, 3, neighbors, distances);
+  incrementalLsh.Search(qdata, 3, incrementalNeighbors, incrementalDistances);
+
+  CheckMatrices(neighbors, incrementalNeighbors);
+  CheckMatrices(distances, incrementalDistances);
+}
+
+/**
+ * Test: with no maximum bucket size, the contiguous rows of the second hash
+ * table hold each point once per table, before and after points are inserted
+ * and removed.
+ */
+BOOST_AUTO_TEST_CASE(BucketLayoutTest)
+{
+  arma::mat rdata(4, 300, arma::fill::randu);
+  LSHSearch<> lsh(rdata, 3, 5, 0.2, 997, 0);
+
+  for (size_t s = 0; s < 3; ++s)
+  {
+    if (s == 1)
+      lsh.Insert(arma::randu<arma::mat>(4, 50));
+    else if (s == 2)
+      lsh.Remove(arma::regspace<arma::uvec>(0, 3, 299));
+
+    const size_t numPoints = lsh.ReferenceSet().n_cols;
+    const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+    BOOST_REQUIRE_EQUAL(offsets.n_elem, lsh.NumBuckets() + 1);
+    BOOST_REQUIRE_EQUAL(offsets[0], 0);
+    BOOST_REQUIRE_EQUAL(offsets[lsh.NumBuckets()], 5 * numPoints);
+
+    arma::Col<size_t> counts(numPoints, arma::fill::zeros);
+    for (size_t row = 0; row < lsh.NumBuckets(); ++row)
+    {
+      const arma::Col<size_t> bucket = lsh.Bucket(row);
+      BOOST_REQUIRE_EQUAL(bucket.n_elem, offsets[row + 1] - offsets[row]);
+      for (size_t j = 0; j < bucket.n_elem; ++j)
+      {
+        BOOST_REQUIRE_LT(bucket[j], numPoints);
+        ++counts[bucket[j]];
+      }
+    }
+
+    for (size_t i = 0; i < numPoints; ++i)
+      BOOST_REQUIRE_EQUAL(counts[i], 5);
+  }
+
+  BOOST_REQUIRE_THROW(lsh.Bucket(lsh.NumBuckets()), std::invalid_argument);
+}
+
+/**
+ * Test: inserting points should never exceed the maximum bucket size.
+ */
+BOOST_AUTO_TEST_CASE(InsertBucketSizeTest)
+{
+  // Every point is the same, so every point lands in the same bucket.
+  arma::mat rdata = arma::ones<arma::mat>(3, 10);
+
+  LSHSearch<> lsh(rdata, 2, 1, 1.0, 99901, 15);
+  lsh.Insert(arma::ones<arma::mat>(3, 10));
+
+  BOOST_REQUIRE_EQUAL(lsh.ReferenceSet().n_cols, 20);
+  BOOST_REQUIRE_EQUAL(lsh.NumBuckets(), 1);
+  BOOST_REQUIRE_LE(lsh.Bucket(0).n_elem, 15);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(arma::ones<arma::mat>(3, 1), 15, neighbors, distances);
+
+  // The first 15 points should have been kept.  All of the distances are the
+  // same, so the order of the neighbors is arbitrary.
+  arma::Col<size_t> sortedNeighbors = arma::sort(neighbors.col(0));
+  for (size_t i = 0; i < 15; ++i)
+    BOOST_REQUIRE_EQUAL(sortedNeighbors[i], i);
+}
+
+/**
+ * Test: removing points from a trained model should give the same results as
+ * training on the remaining points.
+ */
+BOOST_AUTO_TEST_CASE(RemoveTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(10, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(10, 100);
+  arma::cube projections = arma::randn<arma::cube>(10, 5, 8);
+
+  // Remove every third point.
+  arma::uvec removed = arma::regspace<arma::uvec>(0, 3, 999);
+  arma::uvec kept(1000 - removed.n_elem);
+  for (size_t i = 0, j = 0; i < 1000; ++i)
+    if (i % 3 != 0)
+      kept[j++] = i;
+
+  math::RandomSeed(42);
+  LSHSearch<> lsh(rdata.cols(kept), projections, 0.5, 99901, 0);
+
+  math::RandomSeed(42);
+  LSHSearch<> decrementalLsh(rdata, projections, 0.5, 99901, 0);
+  decrementalLsh.Remove(removed);
+
+  CheckMatrices(lsh.ReferenceSet(), decrementalLsh.ReferenceSet());
+
+  arma::Mat<size_t> neighbors, decrementalNeighbors;
+  arma::mat distances, decrementalDistances;
+  lsh.Search(qdata, 3, neighbors, distances);
+  decrementalLsh.Search(qdata, 3, decrementalNeighbors, decrementalDistances);
+
+  CheckMatrices(neighbors, decrementalNeighbors);
+  CheckMatrices(distances, decrementalDistances);
+
+  // Removing a point that does not exist is an error.
+  arma::uvec invalid(1);
+  invalid[0] = 1000;
+  BOOST_REQUIRE_THROW(lsh.Remove(invalid), std::invalid_argument);
+}
+
 // Test the copy constructor and the copy operator.
 BOOST_AUTO_TEST_CASE(CopyConstructorAndOperatorTest)
 {
@@ -469,4 +469,50 @@ BOOST_AUTO_TEST_CASE(DBSCANRandomSelectionFlagTest)
   BOOST_REQUIRE_GT(arma::accu(orderedOutput != randomOutput), 0);
 }
 
+/**
+ * Check that the dual-tree union mode finds the same number of clusters and
+ * the same noise points as the default search.
+ */
+BOOST_AUTO_TEST_CASE(DBSCANDualTreeUnionTest)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Unable to load dataset iris.csv!");
+
+  SetInputParam("input", inputData);
+  SetInputParam("epsilon", 0.5);
+
+  mlpackMain();
+
+  arma::Row<size_t> output;
+  output = std::move(CLI::GetParam<arma::Row<size_t>>("assignments"));
+
+  bindings::tests::CleanMemory();
+
+  CLI::GetSingleton().Parameters()["input"].wasPassed = false;
+
+  SetInputParam("input", inputData);
+  SetInputParam("epsilon", 0.5);
+  SetInputParam("dual_tree_union", true);
+
+  mlpackMain();
+
+  arma::Row<size_t> dualTreeOutput;
+  dualTreeOutput = std::move(CLI::GetParam<arma::Row<size_t>>("assignments"));
+
+  BOOST_REQUIRE_EQUAL(output.n_elem, dualTreeOutput.n_elem);
+  size_t numClusters = 0, dualTreeNumClusters = 0;
+  for (size_t i = 0; i < output.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(output[i] == SIZE_MAX, dualTreeOutput[i] == SIZE_MAX);
+    if (output[i] != SIZE_MAX)
+    {
+      numClusters = std::max(numClusters, output[i] + 1);
+      dualTreeNumClusters = std::max(dualTreeNumClusters,
+          dualTreeOutput[i] + 1);
+    }
+  }
+  BOOST_REQUIRE_EQUAL(numClusters, dualTreeNumClusters);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -129,4 +129,27 @@ BOOST_AUTO_TEST_CASE(EMSTFirstTwoOutputRowsIntegerTest)
   }
 }
 
+/**
+ * Make sure that the dendrogram has one merge for each edge, and that the last
+ * merge holds all the points.
+ */
+BOOST_AUTO_TEST_CASE(EMSTDendrogramTest)
+{
+  arma::mat x;
+  if (!data::Load("test_data_3_1000.csv", x))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  SetInputParam("input", std::move(x));
+
+  mlpackMain();
+
+  const arma::mat& dendrogram = CLI::GetParam<arma::mat>("dendrogram");
+  const arma::mat& output = CLI::GetParam<arma::mat>("output");
+  BOOST_REQUIRE_EQUAL(dendrogram.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(dendrogram.n_cols, 999);
+  BOOST_REQUIRE_EQUAL(dendrogram(3, 998), 1000);
+  for (size_t i = 0; i < dendrogram.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(dendrogram(2, i), output(2, i), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,151 @@
+/**
+ * @file gradient_boosting_test.cpp
+ *
+ * Test mlpackMain() of gradient_boosting_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "GradientBoosting";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/gradient_boosting/gradient_boosting_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct GradientBoostingTestFixture
+{
+ public:
+  GradientBoostingTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~GradientBoostingTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(GradientBoostingMainTest,
+                         GradientBoostingTestFixture);
+
+/**
+ * Make sure the predictions have the right size, and that a saved model gives
+ * the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingModelReuseTest)
+{
+  arma::mat data(3, 300, arma::fill::randu);
+  arma::rowvec responses = 2.0 * data.row(0) - data.row(1);
+  arma::mat testData(3, 50, arma::fill::randu);
+
+  SetInputParam("training", std::move(data));
+  SetInputParam("training_responses", std::move(responses));
+  SetInputParam("test", testData);
+  SetInputParam("num_trees", 20);
+  SetInputParam("max_depth", 3);
+
+  mlpackMain();
+
+  const arma::rowvec predictions =
+      CLI::GetParam<arma::rowvec>("output_predictions");
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 50);
+
+  CLI::GetSingleton().Parameters()["training"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["training_responses"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["num_trees"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["max_depth"].wasPassed = false;
+
+  SetInputParam("input_model",
+      CLI::GetParam<GradientBoosting*>("output_model"));
+  SetInputParam("test", std::move(testData));
+
+  mlpackMain();
+
+  CheckMatrices(predictions, CLI::GetParam<arma::rowvec>("output_predictions"));
+}
+
+/**
+ * Make sure that the absolute error loss can be used.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingAbsoluteLossTest)
+{
+  arma::mat data(2, 200, arma::fill::randu);
+  arma::rowvec responses = data.row(0) + data.row(1);
+
+  SetInputParam("training", data);
+  SetInputParam("training_responses", std::move(responses));
+  SetInputParam("test", std::move(data));
+  SetInputParam("loss", std::string("absolute"));
+  SetInputParam("num_trees", 10);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<GradientBoosting*>("output_model")->
+      NumTrees(), 10);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::rowvec>("output_predictions").n_elem,
+      200);
+}
+
+/**
+ * Make sure invalid parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingInvalidParametersTest)
+{
+  arma::mat data(2, 100, arma::fill::randu);
+  arma::rowvec responses(100, arma::fill::randu);
+
+  SetInputParam("training", data);
+  SetInputParam("training_responses", responses);
+  SetInputParam("loss", std::string("huber"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  SetInputParam("loss", std::string("squared"));
+  SetInputParam("subsample", 0.0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  SetInputParam("subsample", 1.0);
+  SetInputParam("bins", 300);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure a mismatch between the responses and the points is rejected.
+ */
+BOOST_AUTO_TEST_CASE(GradientBoostingResponsesSizeTest)
+{
+  arma::mat data(2, 100, arma::fill::randu);
+  arma::rowvec responses(99, arma::fill::randu);
+
+  SetInputParam("training", std::move(data));
+  SetInputParam("training_responses", std::move(responses));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,113 @@
+/**
+ * @file hdbscan_test.cpp
+ *
+ * Test mlpackMain() of hdbscan_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HDBSCAN";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hdbscan/hdbscan_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct HDBSCANTestFixture
+{
+ public:
+  HDBSCANTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~HDBSCANTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(HDBSCANMainTest, HDBSCANTestFixture);
+
+/**
+ * Check that the number of output labels and the number of input points are
+ * equal, and that the condensed tree has four rows.
+ */
+BOOST_AUTO_TEST_CASE(HDBSCANOutputDimensionTest)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Cannot load iris.csv!");
+
+  const size_t inputSize = inputData.n_cols;
+  SetInputParam("input", std::move(inputData));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Row<size_t>>("assignments").n_cols,
+      inputSize);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("condensed_tree").n_rows, 4);
+}
+
+/**
+ * Make sure that every tree type gives the same number of clusters.
+ */
+BOOST_AUTO_TEST_CASE(HDBSCANTreeTypeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Cannot load iris.csv!");
+
+  SetInputParam("input", inputData);
+  SetInputParam("tree_type", std::string("kd"));
+
+  mlpackMain();
+
+  // Count the distinct labels (noise included).
+  const size_t kdLabels = arma::Row<size_t>(arma::unique(
+      CLI::GetParam<arma::Row<size_t>>("assignments"))).n_elem;
+
+  bindings::tests::CleanMemory();
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("tree_type", std::string("cover"));
+
+  mlpackMain();
+
+  const size_t coverLabels = arma::Row<size_t>(arma::unique(
+      CLI::GetParam<arma::Row<size_t>>("assignments"))).n_elem;
+
+  BOOST_REQUIRE_EQUAL(kdLabels, coverLabels);
+}
+
+/**
+ * Make sure that a minimum cluster size of 1 is rejected.
+ */
+BOOST_AUTO_TEST_CASE(HDBSCANInvalidMinClusterSizeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Cannot load iris.csv!");
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("min_cluster_size", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -174,4 +174,66 @@ BOOST_AUTO_TEST_CASE(HMMViterbiGMMHMMCheckDimensionsTest)
   BOOST_REQUIRE_EQUAL(out.n_cols, observations.n_cols);
 }
 
+/**
+ * Make sure that concatenated sequences with lengths give the same results as
+ * each sequence on its own.
+ */
+BOOST_AUTO_TEST_CASE(HMMViterbiLengthsTest)
+{
+  HMMModel* h = new HMMModel(GaussianHMM);
+  *(h->GaussianHMM()) = HMM<GaussianDistribution>(2, GaussianDistribution(2));
+  h->GaussianHMM()->Transition() = arma::mat("0.7 0.4; 0.3 0.6");
+  h->GaussianHMM()->Emission()[0] = GaussianDistribution("0.0 0.0",
+      "1.0 0.0; 0.0 1.0");
+  h->GaussianHMM()->Emission()[1] = GaussianDistribution("3.0 2.0",
+      "1.0 0.2; 0.2 1.0");
+
+  arma::mat seq1, seq2;
+  arma::Row<size_t> states;
+  h->GaussianHMM()->Generate(30, seq1, states);
+  h->GaussianHMM()->Generate(45, seq2, states);
+
+  arma::Row<size_t> states1, states2;
+  const double logLikelihood1 = h->GaussianHMM()->Predict(seq1, states1);
+  const double logLikelihood2 = h->GaussianHMM()->Predict(seq2, states2);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", arma::mat(arma::join_rows(seq1, seq2)));
+  SetInputParam("lengths", arma::Row<size_t>("30 45"));
+
+  mlpackMain();
+
+  arma::Mat<size_t> out = CLI::GetParam<arma::Mat<size_t> >("output");
+  arma::vec logLikelihoods = CLI::GetParam<arma::vec>("log_likelihoods");
+
+  BOOST_REQUIRE_EQUAL(out.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(out.n_cols, 75);
+  for (size_t i = 0; i < 30; ++i)
+    BOOST_REQUIRE_EQUAL(out[i], states1[i]);
+  for (size_t i = 0; i < 45; ++i)
+    BOOST_REQUIRE_EQUAL(out[30 + i], states2[i]);
+
+  BOOST_REQUIRE_EQUAL(logLikelihoods.n_elem, 2);
+  BOOST_REQUIRE_CLOSE(logLikelihoods[0], logLikelihood1, 1e-10);
+  BOOST_REQUIRE_CLOSE(logLikelihoods[1], logLikelihood2, 1e-10);
+}
+
+/**
+ * Make sure that lengths that don't match the number of observations cause an
+ * error.
+ */
+BOOST_AUTO_TEST_CASE(HMMViterbiBadLengthsTest)
+{
+  HMMModel* h = new HMMModel(GaussianHMM);
+  *(h->GaussianHMM()) = HMM<GaussianDistribution>(2, GaussianDistribution(2));
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", arma::mat(2, 20, arma::fill::randu));
+  SetInputParam("lengths", arma::Row<size_t>("10 5"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
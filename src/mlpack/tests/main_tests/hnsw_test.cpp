@@ -0,0 +1,141 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(HNSWMainTest, HNSWTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions, with and
+ * without a query set.
+ */
+BOOST_AUTO_TEST_CASE(HNSWOutputDimensionTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+      100);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 100);
+
+  bindings::tests::CleanMemory();
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", arma::mat(arma::randu<arma::mat>(5, 40)));
+  SetInputParam("k", (int) 3);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 3);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+      40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 3);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 40);
+}
+
+/**
+ * Ensure that k, the number of links, ef_construction and ef are checked.
+ */
+BOOST_AUTO_TEST_CASE(HNSWParamValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  const std::vector<std::pair<std::string, int>> invalid = {
+      { "k", -2 }, { "links", 1 }, { "ef_construction", 0 }, { "ef", 0 } };
+  for (size_t i = 0; i < invalid.size(); ++i)
+  {
+    SetInputParam("reference", reference);
+    if (invalid[i].first != "k")
+      SetInputParam("k", (int) 6);
+    SetInputParam(invalid[i].first, invalid[i].second);
+
+    Log::Fatal.ignoreInput = true;
+    BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+    Log::Fatal.ignoreInput = false;
+
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+    CLI::RestoreSettings(testName);
+  }
+}
+
+/**
+ * Make sure that a saved model gives the same neighbors, and that its ef can
+ * be changed.
+ */
+BOOST_AUTO_TEST_CASE(HNSWModelReuseTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 200);
+  arma::mat query = arma::randu<arma::mat>(5, 20);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 4);
+
+  mlpackMain();
+
+  arma::Mat<size_t> neighbors = CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  HNSWSearch<>* model = CLI::GetParam<HNSWSearch<>*>("output_model");
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 4);
+
+  mlpackMain();
+
+  CheckMatrices(neighbors, CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+
+  SetInputParam("input_model", model);
+  SetInputParam("query", std::move(query));
+  SetInputParam("ef", (int) 100);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<HNSWSearch<>*>("output_model")->Ef(), 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -405,4 +405,78 @@ BOOST_AUTO_TEST_CASE(KDEMainInvalidRelativeError)
   Log::Fatal.ignoreInput = false;
 }
 
+/**
+ * Ensure Monte Carlo estimations can be used and bad parameters are rejected.
+ */
+BOOST_AUTO_TEST_CASE(KDEMainMonteCarlo)
+{
+  arma::mat reference = arma::randu<arma::mat>(2, 1000);
+  arma::mat query = arma::randu<arma::mat>(2, 20);
+
+  // Main params.
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("monte_carlo", true);
+
+  Log::Fatal.ignoreInput = true;
+  // Invalid probability.
+  SetInputParam("mc_probability", 1.0);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  SetInputParam("mc_probability", 0.95);
+
+  // Invalid initial sample size.
+  SetInputParam("initial_sample_size", 1);
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  // Valid values.
+  SetInputParam("initial_sample_size", 20);
+  BOOST_REQUIRE_NO_THROW(mlpackMain());
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::vec>("predictions").n_elem, 20);
+}
+
+/**
+ * Ensure the estimations of query points read from a file in batches are the
+ * same as the estimations of the whole query set.
+ */
+BOOST_AUTO_TEST_CASE(KDEMainStreamingQueries)
+{
+  arma::mat reference = arma::randu<arma::mat>(3, 300);
+  arma::mat query = arma::randu<arma::mat>(3, 101);
+  if (!data::Save("kde_queries.csv", query))
+    BOOST_FAIL("Unable to save dataset kde_queries.csv!");
+
+  // The estimations are exact, so they don't depend on the query trees.
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("rel_error", 0.0);
+  SetInputParam("abs_error", 0.0);
+
+  mlpackMain();
+
+  arma::vec estimations = std::move(CLI::GetParam<arma::vec>("predictions"));
+
+  ResetKDESettings();
+
+  SetInputParam("reference", reference);
+  SetInputParam("query_file", std::string("kde_queries.csv"));
+  SetInputParam("query_batch_size", 25);
+  SetInputParam("predictions_file", std::string("kde_predictions.csv"));
+  SetInputParam("rel_error", 0.0);
+  SetInputParam("abs_error", 0.0);
+
+  mlpackMain();
+
+  arma::mat streamedEstimations;
+  if (!data::Load("kde_predictions.csv", streamedEstimations))
+    BOOST_FAIL("Unable to load dataset kde_predictions.csv!");
+
+  BOOST_REQUIRE_EQUAL(streamedEstimations.n_elem, query.n_cols);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(streamedEstimations[i], estimations[i], 1e-5);
+
+  remove("kde_queries.csv");
+  remove("kde_predictions.csv");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
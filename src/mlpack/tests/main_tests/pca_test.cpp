@@ -115,4 +115,62 @@ BOOST_AUTO_TEST_CASE(PCATooHighNewDimensionalityTest)
   Log::Fatal.ignoreInput = false;
 }
 
+/**
+ * Make sure that PCA on a dataset file read in batches gives the same result as
+ * PCA on the loaded dataset.
+ */
+BOOST_AUTO_TEST_CASE(PCAInputFileTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 100);
+  data::Save("pca_input.csv", x);
+
+  SetInputParam("input_file", std::string("pca_input.csv"));
+  SetInputParam("output_file", std::string("pca_output.mmat"));
+  SetInputParam("new_dimensionality", (int) 3);
+  SetInputParam("batch_size", (int) 30);
+
+  mlpackMain();
+
+  arma::mat streamed;
+  data::Load("pca_output.mmat", streamed);
+  BOOST_REQUIRE_EQUAL(streamed.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(streamed.n_cols, 100);
+
+  bindings::tests::CleanMemory();
+  CLI::ClearSettings();
+  CLI::RestoreSettings(testName);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 3);
+
+  mlpackMain();
+
+  // The components are only defined up to their sign.
+  const arma::mat& output = CLI::GetParam<arma::mat>("output");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (arma::dot(streamed.row(i), output.row(i)) < 0)
+      streamed.row(i) *= -1;
+  }
+  CheckMatrices(streamed, output, 1e-4);
+
+  remove("pca_input.csv");
+  remove("pca_output.mmat");
+}
+
+/**
+ * Make sure that only one of the dataset and the dataset file can be given.
+ */
+BOOST_AUTO_TEST_CASE(PCAInputAndInputFileTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 5);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("input_file", std::string("pca_input.csv"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,147 @@
+/**
+ * @file pq_test.cpp
+ *
+ * Test mlpackMain() of pq_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "PQ";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/pq/pq_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct PQTestFixture
+{
+ public:
+  PQTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~PQTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(PQMainTest, PQTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+BOOST_AUTO_TEST_CASE(PQOutputDimensionTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(6, 300);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", arma::mat(arma::randu<arma::mat>(6, 40)));
+  SetInputParam("subspaces", (int) 3);
+  SetInputParam("lists", (int) 4);
+  SetInputParam("k", (int) 5);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 5);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+      40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 5);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<PQSearch*>("output_model")->Subspaces(),
+      3);
+}
+
+/**
+ * Ensure that k, the number of subspaces, lists, probes and re-ranked
+ * candidates are checked, and that re-ranking needs the reference set.
+ */
+BOOST_AUTO_TEST_CASE(PQParamValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(4, 100);
+
+  const std::vector<std::pair<std::string, int>> invalid = {
+      { "k", -1 }, { "subspaces", 0 }, { "lists", 0 }, { "probes", 0 },
+      { "rerank", -1 } };
+  for (size_t i = 0; i < invalid.size(); ++i)
+  {
+    SetInputParam("reference", reference);
+    if (invalid[i].first != "k")
+      SetInputParam("k", (int) 3);
+    SetInputParam(invalid[i].first, invalid[i].second);
+
+    Log::Fatal.ignoreInput = true;
+    BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+    Log::Fatal.ignoreInput = false;
+
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+    CLI::RestoreSettings(testName);
+  }
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("subspaces", (int) 2);
+  mlpackMain();
+
+  PQSearch* model = CLI::GetParam<PQSearch*>("output_model");
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("query", arma::mat(arma::randu<arma::mat>(4, 10)));
+  SetInputParam("k", (int) 3);
+  SetInputParam("rerank", (int) 20);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure that re-ranking with a saved model and the reference set returns
+ * the exact distances.
+ */
+BOOST_AUTO_TEST_CASE(PQRerankTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(4, 200);
+  arma::mat query = arma::randu<arma::mat>(4, 20);
+
+  SetInputParam("reference", reference);
+  SetInputParam("subspaces", (int) 2);
+  mlpackMain();
+
+  PQSearch* model = CLI::GetParam<PQSearch*>("output_model");
+  CLI::GetSingleton().Parameters()["subspaces"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 3);
+  SetInputParam("rerank", (int) 200);
+
+  mlpackMain();
+
+  // Re-ranking all the points gives the exact neighbors.
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  neighbor::KNN knn(reference);
+  knn.Search(query, 3, trueNeighbors, trueDistances);
+
+  CheckMatrices(trueNeighbors, CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(trueDistances, CLI::GetParam<arma::mat>("distances"));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -144,6 +144,38 @@ BOOST_AUTO_TEST_CASE(PreprocessImputerListwiseDimensionTest)
   BOOST_REQUIRE_EQUAL(outputData.n_rows, 3); // Input Dimension.
 }
 
+/**
+ * Check that the imputed data are binarized when a threshold is given.
+ */
+BOOST_AUTO_TEST_CASE(PreprocessImputerBinarizeTest)
+{
+  arma::mat inputData;
+  data::Load("preprocess_imputer_test.csv", inputData);
+
+  SetInputParam("input_file", (std::string) "preprocess_imputer_test.csv");
+  SetInputParam("missing_value", (std::string) "nan");
+  SetInputParam("strategy", (std::string) "mean");
+  SetInputParam("binarize_threshold", (double) 0.5);
+  SetInputParam("output_file",
+      (std::string) "preprocess_imputer_output_test.csv");
+
+  mlpackMain();
+
+  arma::mat outputData;
+  data::Load(CLI::GetParam<std::string>("output_file"), outputData);
+  BOOST_REQUIRE_EQUAL(outputData.n_cols, inputData.n_cols);
+  BOOST_REQUIRE_EQUAL(outputData.n_rows, 3);
+
+  // Every value should be binarized, and the values that were not missing
+  // should be binarized with the threshold.
+  for (size_t i = 0; i < outputData.n_elem; ++i)
+  {
+    BOOST_REQUIRE(outputData[i] == 0.0 || outputData[i] == 1.0);
+    if (!std::isnan(inputData[i]))
+      BOOST_REQUIRE_EQUAL(outputData[i], (inputData[i] > 0.5) ? 1.0 : 0.0);
+  }
+}
+
 /**
  * Check that invalid strategy can't be specified.
  */
@@ -248,6 +248,57 @@ BOOST_AUTO_TEST_CASE(RangeSeachTestwithQuery)
   remove(distanceFile.c_str());
 }
 
+/**
+ * Check that the results of query points read from a file in batches are
+ * correct.
+ */
+BOOST_AUTO_TEST_CASE(RangeSearchTestWithQueryFile)
+{
+  arma::mat queryData = {{5, 3, 1}, {4, 2, 4}, {3, 1, 7}};
+  arma::mat x = {{0, 3, 3, 4, 3, 1},
+                 {4, 4, 4, 5, 5, 2},
+                 {0, 1, 2, 2, 3, 3}};
+
+  vector<vector<double>> distanceVal = {
+                {2.82843, 2.23607, 1.73205, 2.23607, 4.47214},
+                {3.74166, 2, 2.23607, 3.31662, 3.60555, 2.82843},
+                {4.58258, 4.47214}};
+  vector<vector<size_t>> neighborVal = {{1, 2, 3, 4, 5},
+                                        {0, 1, 2, 3, 4, 5},
+                                        {4, 5}};
+
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  string queryFile = "rs_queries.csv";
+  string distanceFile = "distances.csv";
+  string neighborsFile = "neighbors.csv";
+  double minVal = 0, maxVal = 5;
+
+  if (!data::Save(queryFile, queryData))
+    BOOST_FAIL("Unable to save dataset rs_queries.csv!");
+
+  // The last batch only holds one point.
+  SetInputParam("query_file", queryFile);
+  SetInputParam("query_batch_size", 2);
+  SetInputParam("reference", move(x));
+  SetInputParam("min", minVal);
+  SetInputParam("max", maxVal);
+  SetInputParam("distances_file", distanceFile);
+  SetInputParam("neighbors_file", neighborsFile);
+
+  mlpackMain();
+
+  neighbors = ReadData<size_t>(neighborsFile);
+  distances = ReadData<double>(distanceFile);
+
+  CheckMatrices(neighbors, neighborVal);
+  CheckMatrices(distances, distanceVal);
+
+  remove(queryFile.c_str());
+  remove(neighborsFile.c_str());
+  remove(distanceFile.c_str());
+}
+
 /**
  * Train a model using a synthetic dataset and then output the model, and ensure
  * it can be used again.
@@ -570,4 +621,39 @@ BOOST_AUTO_TEST_CASE(SingleModeTest)
   remove(distanceFile.c_str());
 }
 
+/**
+ * Check the number of neighbors and the sums of their weights for a small
+ * synthetic input case (the same as in RangeSearchTest), without saving the
+ * neighbors.
+ */
+BOOST_AUTO_TEST_CASE(RangeSearchCountsTest)
+{
+  arma::mat x = {{0, 3, 3, 4, 3, 1},
+                 {4, 4, 4, 5, 5, 2},
+                 {0, 1, 2, 2, 3, 3}};
+  arma::vec weights = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  double minVal = 0, maxVal = 3;
+
+  SetInputParam("reference", move(x));
+  SetInputParam("min", minVal);
+  SetInputParam("max", maxVal);
+  SetInputParam("weights", move(weights));
+  SetInputParam("counts", arma::Col<size_t>());
+  SetInputParam("weight_sums", arma::vec());
+
+  mlpackMain();
+
+  const arma::Col<size_t>& counts = CLI::GetParam<arma::Col<size_t>>("counts");
+  const arma::vec& sums = CLI::GetParam<arma::vec>("weight_sums");
+  const size_t countVal[] = { 0, 3, 4, 3, 3, 1 };
+  const double sumVal[] = { 0, 12, 17, 10, 9, 3 };
+  BOOST_REQUIRE_EQUAL(counts.n_elem, 6);
+  BOOST_REQUIRE_EQUAL(sums.n_elem, 6);
+  for (size_t i = 0; i < 6; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(counts[i], countVal[i]);
+    BOOST_REQUIRE_CLOSE(sums[i] + 1.0, sumVal[i] + 1.0, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,136 @@
+/**
+ * @file simhash_test.cpp
+ *
+ * Test mlpackMain() of simhash_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "SimHash";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/lsh/simhash_main.cpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct SimHashTestFixture
+{
+ public:
+  SimHashTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~SimHashTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(SimHashMainTest, SimHashTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+BOOST_AUTO_TEST_CASE(SimHashOutputDimensionTest)
+{
+  arma::mat reference = arma::randn<arma::mat>(6, 300);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", arma::mat(arma::randn<arma::mat>(6, 40)));
+  SetInputParam("bits", (int) 8);
+  SetInputParam("tables", (int) 4);
+  SetInputParam("k", (int) 5);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 5);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+      40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 5);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<SimHashSearch*>("output_model")->Bits(),
+      8);
+}
+
+/**
+ * Ensure that k, the number of bits, tables, probes and re-ranked candidates
+ * are checked.
+ */
+BOOST_AUTO_TEST_CASE(SimHashParamValidityTest)
+{
+  arma::mat reference = arma::randn<arma::mat>(4, 100);
+
+  const std::vector<std::pair<std::string, int>> invalid = {
+      { "k", -1 }, { "bits", 0 }, { "bits", 65 }, { "tables", 0 },
+      { "num_probes", -1 }, { "rerank", -1 } };
+  for (size_t i = 0; i < invalid.size(); ++i)
+  {
+    SetInputParam("reference", reference);
+    if (invalid[i].first != "k")
+      SetInputParam("k", (int) 3);
+    SetInputParam(invalid[i].first, invalid[i].second);
+
+    Log::Fatal.ignoreInput = true;
+    BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+    Log::Fatal.ignoreInput = false;
+
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+    CLI::RestoreSettings(testName);
+  }
+}
+
+/**
+ * Make sure that a saved model gives the same neighbors, and that its search
+ * parameters can be changed.
+ */
+BOOST_AUTO_TEST_CASE(SimHashModelReuseTest)
+{
+  arma::mat reference = arma::randn<arma::mat>(5, 200);
+  arma::mat query = arma::randn<arma::mat>(5, 20);
+
+  SetInputParam("reference", reference);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 3);
+  SetInputParam("num_probes", (int) 2);
+  mlpackMain();
+
+  const arma::Mat<size_t> neighbors =
+      CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  const arma::mat distances = CLI::GetParam<arma::mat>("distances");
+  SimHashSearch* model = CLI::GetParam<SimHashSearch*>("output_model");
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["num_probes"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 3);
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<SimHashSearch*>("output_model")->Probes(),
+      2);
+  CheckMatrices(neighbors, CLI::GetParam<arma::Mat<size_t>>("neighbors"));
+  CheckMatrices(distances, CLI::GetParam<arma::mat>("distances"));
+
+  SetInputParam("rerank", (int) 4);
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<SimHashSearch*>("output_model")->Rerank(),
+      4);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,149 @@
+/**
+ * @file sparse_svm_test.cpp
+ *
+ * Test mlpackMain() of sparse_svm_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+static const std::string testName = "SparseSVM";
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/sparse_svm/sparse_svm_main.cpp>
+#include "test_helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct SparseSVMTestFixture
+{
+ public:
+  SparseSVMTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~SparseSVMTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(SparseSVMMainTest, SparseSVMTestFixture);
+
+/**
+ * Generate sparse points whose labels are given by a random hyperplane, as a
+ * dense matrix.
+ */
+static void SeparableData(const arma::vec& weights,
+                          const size_t points,
+                          arma::mat& data,
+                          arma::Row<size_t>& labels)
+{
+  data = arma::mat(arma::sprandu<arma::sp_mat>(weights.n_elem, points, 0.1));
+  const arma::rowvec scores = weights.t() * data;
+
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = (scores[i] > 0.0) ? 1 : 0;
+}
+
+/**
+ * Train a model, classify test points with it, and make sure the saved model
+ * gives the same predictions.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMTrainAndReloadTest)
+{
+  const arma::vec weights = arma::randn<arma::vec>(30);
+  arma::mat trainData, testData;
+  arma::Row<size_t> trainLabels, testLabels;
+  SeparableData(weights, 1000, trainData, trainLabels);
+  SeparableData(weights, 200, testData, testLabels);
+
+  SetInputParam("training", std::move(trainData));
+  SetInputParam("labels", std::move(trainLabels));
+  SetInputParam("test", testData);
+  SetInputParam("step_size", 0.1);
+
+  mlpackMain();
+
+  const arma::Row<size_t> predictions =
+      std::move(CLI::GetParam<arma::Row<size_t>>("predictions"));
+  const arma::rowvec& scores = CLI::GetParam<arma::rowvec>("scores");
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 200);
+  BOOST_REQUIRE_EQUAL(scores.n_elem, 200);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], (size_t) (scores[i] >= 0.0 ? 1 : 0));
+    if (predictions[i] == testLabels[i])
+      ++correct;
+  }
+  BOOST_REQUIRE_GT(correct, 160);
+
+  // Reuse the model.
+  SparseSVM* model = CLI::GetParam<SparseSVM*>("output_model");
+  CLI::GetSingleton().Parameters()["training"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["labels"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["test"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["step_size"].wasPassed = false;
+
+  SetInputParam("input_model", model);
+  SetInputParam("test", std::move(testData));
+
+  mlpackMain();
+
+  const arma::Row<size_t>& reloadedPredictions =
+      CLI::GetParam<arma::Row<size_t>>("predictions");
+  CheckMatrices(predictions, reloadedPredictions);
+}
+
+/**
+ * Make sure labels other than 0 and 1 are rejected.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMInvalidLabelsTest)
+{
+  arma::mat trainData = arma::randu<arma::mat>(5, 10);
+  arma::Row<size_t> labels(10);
+  labels.zeros();
+  labels[4] = 2;
+
+  SetInputParam("training", std::move(trainData));
+  SetInputParam("labels", std::move(labels));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure test points of the wrong dimensionality are rejected.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMWrongTestDimensionalityTest)
+{
+  arma::mat trainData = arma::randu<arma::mat>(5, 10);
+  arma::Row<size_t> labels(10);
+  for (size_t i = 0; i < 10; ++i)
+    labels[i] = i % 2;
+
+  SetInputParam("training", std::move(trainData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("test", arma::mat(arma::randu<arma::mat>(4, 10)));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -832,6 +832,38 @@ BOOST_AUTO_TEST_CASE(InplaceShuffleTest)
     BOOST_REQUIRE_EQUAL(counts[i], 1);
 }
 
+/**
+ * Make sure that PermuteColumns() and GatherColumns() reorder the columns like
+ * cols(ordering), and that ShuffledOrdering() gives a permutation.
+ */
+BOOST_AUTO_TEST_CASE(PermuteColumnsTest)
+{
+  arma::mat data(4, 50, arma::fill::randu);
+  arma::Row<size_t> labels = arma::linspace<arma::Row<size_t>>(0, 49, 50);
+
+  const arma::uvec ordering = ShuffledOrdering(data.n_cols);
+  BOOST_REQUIRE_EQUAL(ordering.n_elem, data.n_cols);
+  const arma::uvec sorted = arma::sort(ordering);
+  for (size_t i = 0; i < sorted.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(sorted[i], i);
+
+  const arma::mat expected = data.cols(ordering);
+
+  arma::mat gathered;
+  GatherColumns(data, ordering, gathered);
+  CheckMatrices(gathered, expected);
+
+  arma::mat permuted(data);
+  arma::Row<size_t> permutedLabels(labels);
+  PermuteColumns(permuted, ordering);
+  PermuteColumns(permutedLabels, ordering);
+  CheckMatrices(permuted, expected);
+  for (size_t i = 0; i < ordering.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(permutedLabels[i], ordering[i]);
+
+  BOOST_REQUIRE_EQUAL(ShuffledOrdering(0).n_elem, (size_t) 0);
+}
+
 /**
  * Make sure shuffling sparse data works when the input and output matrices are
  * the same.
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/matrix_completion/matrix_completion.hpp>
+#include <mlpack/methods/matrix_completion/factored_matrix_completion.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -64,4 +65,50 @@ BOOST_AUTO_TEST_CASE(UniformMatrixCompletionSDP)
   }
 }
 
+/**
+ * Make sure that the factored solver recovers a random low rank matrix from
+ * half of its entries, and that the dense overload of Recover() gives the whole
+ * matrix.
+ */
+BOOST_AUTO_TEST_CASE(UniformMatrixCompletionFactored)
+{
+  const size_t m = 120;
+  const size_t n = 80;
+  const arma::mat xorig = arma::randu<arma::mat>(m, 3) *
+      arma::randu<arma::mat>(3, n);
+
+  // Take half of the entries, without replacement.
+  const arma::uvec permutation = arma::shuffle(arma::linspace<arma::uvec>(0,
+      m * n - 1, m * n));
+  const arma::uvec entries = permutation.head(m * n / 2);
+  arma::umat indices(2, entries.n_elem);
+  arma::vec values(entries.n_elem);
+  for (size_t i = 0; i < entries.n_elem; ++i)
+  {
+    indices(0, i) = entries[i] % m;
+    indices(1, i) = entries[i] / m;
+    values(i) = xorig(indices(0, i), indices(1, i));
+  }
+
+  FactoredMatrixCompletion mc(m, n, indices, values, 3, 1e-8, 500, 1e-12);
+  arma::mat w, h;
+  mc.Recover(w, h);
+
+  BOOST_REQUIRE_EQUAL(w.n_rows, m);
+  BOOST_REQUIRE_EQUAL(w.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(h.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(h.n_cols, n);
+
+  const double err = arma::norm(xorig - w * h, "fro") /
+      arma::norm(xorig, "fro");
+  BOOST_REQUIRE_SMALL(err, 1e-3);
+
+  // The dense overload gives the whole matrix.
+  arma::mat recovered;
+  mc.MaxIterations() = 1;
+  mc.Recover(recovered);
+  BOOST_REQUIRE_EQUAL(recovered.n_rows, m);
+  BOOST_REQUIRE_EQUAL(recovered.n_cols, n);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
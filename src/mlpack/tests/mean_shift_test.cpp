@@ -15,6 +15,10 @@
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
 using namespace mlpack;
 using namespace mlpack::meanshift;
 using namespace mlpack::distribution;
@@ -165,4 +169,47 @@ BOOST_AUTO_TEST_CASE(GaussianClustering)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+#ifdef HAS_OPENMP
+
+// The clustering should not depend on the number of threads, with or without
+// seeds.
+BOOST_AUTO_TEST_CASE(MeanShiftThreadsTest)
+{
+  GaussianDistribution g1("0.0 0.0 0.0", arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2("5.0 5.0 5.0", 2 * arma::eye<arma::mat>(3, 3));
+
+  arma::mat dataset(3, 1000);
+  for (size_t i = 0; i < 500; ++i)
+    dataset.col(i) = g1.Random();
+  for (size_t i = 500; i < 1000; ++i)
+    dataset.col(i) = g2.Random();
+
+  const int maxThreads = omp_get_max_threads();
+  for (size_t useSeeds = 0; useSeeds < 2; ++useSeeds)
+  {
+    MeanShift<> meanShift(2.9);
+
+    omp_set_num_threads(1);
+    arma::Row<size_t> serialAssignments;
+    arma::mat serialCentroids;
+    meanShift.Cluster(dataset, serialAssignments, serialCentroids, true,
+        (useSeeds == 1));
+
+    omp_set_num_threads(std::max(maxThreads, 4));
+    arma::Row<size_t> parallelAssignments;
+    arma::mat parallelCentroids;
+    meanShift.Cluster(dataset, parallelAssignments, parallelCentroids, true,
+        (useSeeds == 1));
+    omp_set_num_threads(maxThreads);
+
+    BOOST_REQUIRE_EQUAL(serialCentroids.n_cols, parallelCentroids.n_cols);
+    for (size_t i = 0; i < serialCentroids.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(serialCentroids[i], parallelCentroids[i], 1e-5);
+    for (size_t i = 0; i < serialAssignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(serialAssignments[i], parallelAssignments[i]);
+  }
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
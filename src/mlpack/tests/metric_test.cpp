@@ -10,6 +10,8 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/fixed_lmetric.hpp>
+#include <mlpack/core/metrics/block_distances.hpp>
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
 
@@ -87,4 +89,125 @@ BOOST_AUTO_TEST_CASE(LINFMetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+// Make sure that the fixed-dimensionality metric gives the same results as the
+// corresponding LMetric, for points of its dimensionality and of any other
+// dimensionality.
+template<typename FixedMetricType, typename MetricType>
+void CheckFixedLMetric()
+{
+  arma::mat points(FixedMetricType::Dimensions, 20, arma::fill::randn);
+  arma::mat otherPoints(FixedMetricType::Dimensions + 2, 2, arma::fill::randn);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    arma::vec distances;
+    FixedMetricType::Evaluate(points.col(i), points, distances);
+    BOOST_REQUIRE_EQUAL(distances.n_elem, points.n_cols);
+
+    for (size_t j = 0; j < points.n_cols; ++j)
+    {
+      const double distance = MetricType::Evaluate(points.col(i),
+          points.col(j));
+      BOOST_REQUIRE_CLOSE(FixedMetricType::Evaluate(points.col(i),
+          points.col(j)), distance, 1e-5);
+      BOOST_REQUIRE_CLOSE(distances[j], distance, 1e-5);
+    }
+  }
+
+  BOOST_REQUIRE_CLOSE(FixedMetricType::Evaluate(otherPoints.col(0),
+      otherPoints.col(1)), MetricType::Evaluate(otherPoints.col(0),
+      otherPoints.col(1)), 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(FixedLMetricTest)
+{
+  CheckFixedLMetric<FixedManhattanDistance<2>, ManhattanDistance>();
+  CheckFixedLMetric<FixedSquaredEuclideanDistance<3>,
+      SquaredEuclideanDistance>();
+  CheckFixedLMetric<FixedEuclideanDistance<3>, EuclideanDistance>();
+  CheckFixedLMetric<FixedEuclideanDistance<16>, EuclideanDistance>();
+  CheckFixedLMetric<FixedChebyshevDistance<4>, ChebyshevDistance>();
+  CheckFixedLMetric<FixedLMetric<5, 3, true>, LMetric<3, true>>();
+}
+
+/**
+ * Make sure that differences of unsigned points are taken correctly.
+ */
+BOOST_AUTO_TEST_CASE(FixedLMetricUnsignedTest)
+{
+  arma::Col<size_t> a(5);
+  a << 1 << 2 << 1 << 0 << 5;
+
+  arma::Col<size_t> b(5);
+  b << 2 << 5 << 2 << 0 << 1;
+
+  BOOST_REQUIRE_EQUAL(FixedManhattanDistance<5>::Evaluate(a, b), 9);
+  BOOST_REQUIRE_EQUAL(FixedSquaredEuclideanDistance<5>::Evaluate(a, b), 27);
+  BOOST_REQUIRE_EQUAL(FixedChebyshevDistance<5>::Evaluate(a, b), 4);
+}
+
+/**
+ * Sparse points should be handled correctly too.
+ */
+BOOST_AUTO_TEST_CASE(FixedLMetricSparseTest)
+{
+  arma::sp_mat points;
+  points.sprandu(4, 10, 0.5);
+
+  for (size_t i = 1; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(FixedEuclideanDistance<4>::Evaluate(points.col(0),
+        points.col(i)), EuclideanDistance::Evaluate(points.col(0),
+        points.col(i)), 1e-5);
+  }
+}
+
+// Make sure that the block of distances is within its error bounds of the
+// distances computed one at a time.
+template<typename MetricType>
+void CheckBlockDistances(const arma::mat& points)
+{
+  std::vector<size_t> queries, references;
+  for (size_t i = 0; i < points.n_cols; i += 2)
+    queries.push_back(i);
+  for (size_t i = 1; i < points.n_cols; i += 3)
+    references.push_back(i);
+
+  MetricType metric;
+  arma::mat distances;
+  arma::vec errors;
+  BlockDistances<MetricType>::Evaluate(metric, points, queries, points,
+      references, distances, errors);
+
+  BOOST_REQUIRE_EQUAL(distances.n_rows, queries.size());
+  BOOST_REQUIRE_EQUAL(distances.n_cols, references.size());
+  BOOST_REQUIRE_EQUAL(errors.n_elem, queries.size());
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    for (size_t j = 0; j < references.size(); ++j)
+    {
+      const double distance = metric.Evaluate(points.col(queries[i]),
+          points.col(references[j]));
+      BOOST_REQUIRE_LE(std::abs(distances(i, j) - distance), errors[i] + 1e-12);
+      BOOST_REQUIRE_SMALL(distances(i, j) - distance, 1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BlockDistancesTest)
+{
+  arma::mat points = arma::randu<arma::mat>(6, 100) + 1000.0;
+
+  CheckBlockDistances<EuclideanDistance>(points);
+  CheckBlockDistances<SquaredEuclideanDistance>(points);
+  CheckBlockDistances<ManhattanDistance>(points);
+
+  BOOST_REQUIRE(BlockDistances<EuclideanDistance>::Worthwhile<arma::mat>(64,
+      64));
+  BOOST_REQUIRE(!BlockDistances<EuclideanDistance>::Worthwhile<arma::sp_mat>(
+      64, 64));
+  BOOST_REQUIRE(!BlockDistances<ManhattanDistance>::Worthwhile<arma::mat>(64,
+      64));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,111 @@
+/**
+ * @file mvu_test.cpp
+ *
+ * Tests for Maximum Variance Unfolding, with and without landmarks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/mvu/mvu.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::mvu;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(MVUTest);
+
+/**
+ * A point in the affine span of its neighbors should be reconstructed by its
+ * barycentric coordinates.
+ */
+BOOST_AUTO_TEST_CASE(ReconstructionWeightsTest)
+{
+  arma::mat reference("0 1 0; 0 0 1");
+  arma::mat query("0.3; 0.5");
+  arma::Mat<size_t> neighbors(3, 1);
+  neighbors.col(0) = arma::Col<size_t>("2 0 1");
+
+  arma::mat weights;
+  MVU::ReconstructionWeights(reference, query, neighbors, weights, 1e-9);
+
+  BOOST_REQUIRE_EQUAL(weights.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(weights.n_cols, 1);
+  BOOST_REQUIRE_CLOSE(weights(0, 0), 0.5, 1e-3);
+  BOOST_REQUIRE_CLOSE(weights(1, 0), 0.2, 1e-3);
+  BOOST_REQUIRE_CLOSE(weights(2, 0), 0.3, 1e-3);
+}
+
+/**
+ * Unfold points of a plane in three dimensions with landmarks; the distances
+ * between neighboring landmarks should be kept, and every point should get
+ * coordinates.
+ */
+BOOST_AUTO_TEST_CASE(LandmarkUnfoldTest)
+{
+  math::RandomSeed(42);
+
+  arma::mat plane = 4.0 * arma::randu<arma::mat>(2, 300);
+  arma::mat basis;
+  arma::mat r;
+  arma::qr_econ(basis, r, arma::randn<arma::mat>(3, 2));
+  const arma::mat data = basis * plane;
+
+  MVU mvu(data);
+  arma::mat output;
+  mvu.Unfold(2, 5, output, 40);
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 300);
+  BOOST_REQUIRE(output.is_finite());
+
+  const arma::uvec& landmarks = mvu.Landmarks();
+  BOOST_REQUIRE_EQUAL(landmarks.n_elem, 40);
+  for (size_t i = 1; i < landmarks.n_elem; ++i)
+    BOOST_REQUIRE_LT(landmarks[i - 1], landmarks[i]);
+
+  // The embedding of the landmarks should keep the distances of the neighbor
+  // graph, on average.
+  const arma::mat landmarkData = data.cols(landmarks);
+  const arma::mat landmarkOutput = output.cols(landmarks);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  KNN knn(landmarkData);
+  knn.Search(5, neighbors, distances);
+
+  double error = 0.0;
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      const double d = arma::norm(landmarkOutput.col(i) -
+          landmarkOutput.col(neighbors(j, i)));
+      error += std::abs(d - distances(j, i)) / distances(j, i);
+    }
+  }
+
+  BOOST_REQUIRE_LT(error / neighbors.n_elem, 0.1);
+}
+
+/**
+ * Invalid parameters should be rejected.
+ */
+BOOST_AUTO_TEST_CASE(UnfoldInvalidParametersTest)
+{
+  arma::mat data(3, 20, arma::fill::randu);
+  MVU mvu(data);
+  arma::mat output;
+
+  BOOST_REQUIRE_THROW(mvu.Unfold(0, 5, output), std::invalid_argument);
+  BOOST_REQUIRE_THROW(mvu.Unfold(4, 5, output), std::invalid_argument);
+  BOOST_REQUIRE_THROW(mvu.Unfold(2, 0, output), std::invalid_argument);
+  BOOST_REQUIRE_THROW(mvu.Unfold(2, 5, output, 5), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
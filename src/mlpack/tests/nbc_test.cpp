@@ -314,4 +314,95 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Make sure that training incrementally on several batches gives the same model
+ * as training on all the points at once.
+ */
+BOOST_AUTO_TEST_CASE(SeparateTrainBatchIncrementalTest)
+{
+  arma::mat data(5, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = math::RandInt(0, 3);
+    data.col(i) += labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, 3, false);
+  NaiveBayesClassifier<> nbcTrain(data.n_rows, 3);
+  for (size_t i = 0; i < data.n_cols; i += 1300)
+  {
+    const size_t last = std::min(i + 1300, (size_t) data.n_cols) - 1;
+    nbcTrain.Train(data.cols(i, last), labels.cols(i, last), 3, true);
+  }
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(nbc.Means()[i], nbcTrain.Means()[i], 1e-5);
+  for (size_t i = 0; i < nbc.Variances().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(nbc.Variances()[i], nbcTrain.Variances()[i], 1e-5);
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], nbcTrain.Probabilities()[i],
+        1e-5);
+  }
+}
+
+/**
+ * Make sure the class probabilities computed for many points at once match the
+ * direct computation, even for a feature that is constant in each class.
+ */
+BOOST_AUTO_TEST_CASE(NaiveBayesClassifierProbabilitiesTest)
+{
+  arma::mat data(4, 1000, arma::fill::randn);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = i % 2;
+    data(0, i) += 3.0 * labels[i];
+    data(3, i) = 1000.0 + labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, 2, false);
+
+  arma::mat testData(4, 200, arma::fill::randn);
+  testData.row(3).fill(1000.0);
+  testData(3, 0) = 1001.0;
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbc.Classify(testData, predictions, probabilities);
+
+  for (size_t j = 0; j < testData.n_cols; ++j)
+  {
+    arma::vec logLikelihoods(2);
+    for (size_t c = 0; c < 2; ++c)
+    {
+      logLikelihoods[c] = std::log(nbc.Probabilities()[c]);
+      for (size_t k = 0; k < testData.n_rows; ++k)
+      {
+        const double diff = testData(k, j) - nbc.Means()(k, c);
+        logLikelihoods[c] -= 0.5 * std::log(2 * M_PI * nbc.Variances()(k, c)) +
+            0.5 * diff * diff / nbc.Variances()(k, c);
+      }
+    }
+
+    // The constant feature decides the class.
+    const size_t expected = (j == 0) ? 1 : 0;
+    BOOST_REQUIRE_EQUAL(predictions[j], expected);
+    BOOST_REQUIRE_EQUAL(nbc.Classify(testData.col(j)), expected);
+
+    const double maxLogLikelihood = arma::max(logLikelihoods);
+    const arma::vec expectedProbs = arma::exp(logLikelihoods -
+        maxLogLikelihood) / arma::accu(arma::exp(logLikelihoods -
+        maxLogLikelihood));
+    for (size_t c = 0; c < 2; ++c)
+    {
+      if (expectedProbs[c] < 1e-10)
+        BOOST_REQUIRE_SMALL(probabilities(c, j), 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(probabilities(c, j), expectedProbs[c], 1e-5);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
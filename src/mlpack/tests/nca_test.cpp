@@ -249,6 +249,89 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * Ensure that evaluating the separable objective on a batch gives the sum of the
+ * objectives of the points in the batch.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxSeparableBatchObjective)
+{
+  arma::mat data           = "-0.1 -0.1 -0.1  0.1  0.1  0.1;"
+                             " 1.0  0.0 -1.0  1.0  0.0 -1.0 ";
+  arma::Row<size_t> labels = " 0    0    0    1    1    1   ";
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+
+  arma::mat coordinates = "1.2 0.3; -0.4 0.8";
+  double sum = 0;
+  for (size_t i = 0; i < 6; ++i)
+    sum += sef.Evaluate(coordinates, i, 1);
+
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates, 0, 6), sum, 1e-5);
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates), sum, 1e-5);
+}
+
+/**
+ * If the neighborhoods hold every other point, truncating the softmax should
+ * not change the objective or the gradient.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncatedFullNeighborhood)
+{
+  arma::mat data;
+  data.randu(3, 40);
+  arma::Row<size_t> labels(40);
+  for (size_t i = 0; i < 40; ++i)
+    labels[i] = (data(0, i) > 0.5) ? 1 : 0;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> truncatedSef(data, labels);
+  truncatedSef.Neighbors() = 39;
+
+  arma::mat coordinates;
+  coordinates.randu(3, 3);
+  coordinates *= 3.0;
+
+  BOOST_REQUIRE_CLOSE(truncatedSef.Evaluate(coordinates),
+      sef.Evaluate(coordinates), 1e-5);
+  BOOST_REQUIRE_CLOSE(truncatedSef.Evaluate(coordinates, 5, 10),
+      sef.Evaluate(coordinates, 5, 10), 1e-5);
+
+  arma::mat gradient, truncatedGradient;
+  sef.Gradient(coordinates, gradient);
+  truncatedSef.Gradient(coordinates, truncatedGradient);
+  CheckMatrices(truncatedGradient, gradient, 1e-5);
+
+  sef.Gradient(coordinates, 5, gradient, 10);
+  truncatedSef.Gradient(coordinates, 5, truncatedGradient, 10);
+  CheckMatrices(truncatedGradient, gradient, 1e-5);
+}
+
+/**
+ * Truncating the softmax to the nearest points should give an objective close to
+ * the full objective, since faraway points contribute very little.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncatedNeighborhoodApproximation)
+{
+  arma::mat data;
+  data.randu(2, 200);
+  data *= 10.0;
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = (data(0, i) > 5.0) ? 1 : 0;
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> truncatedSef(data, labels);
+  truncatedSef.Neighbors() = 40;
+
+  arma::mat coordinates = arma::eye<arma::mat>(2, 2);
+  BOOST_REQUIRE_CLOSE(truncatedSef.Evaluate(coordinates),
+      sef.Evaluate(coordinates), 1.0);
+
+  // Asking for as many neighbors as points is an error.
+  truncatedSef.Neighbors() = 200;
+  BOOST_REQUIRE_THROW(truncatedSef.Evaluate(coordinates, 0, 1),
+      std::invalid_argument);
+}
+
 //
 // Tests for the NCA algorithm.
 //
@@ -346,4 +346,82 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+/**
+ * Make sure that the two given trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameStructure(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameStructure(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that building the given tree type with all threads gives the same
+ * tree and mappings as building it with one thread.  The dataset is large
+ * enough that the partitions of the top nodes are computed in parallel.
+ */
+template<typename TreeType>
+void CheckParallelConstruction()
+{
+  arma::mat dataset;
+  dataset.randu(3, 100000);
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+
+  std::vector<size_t> serialOldFromNew;
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  TreeType serialTree(dataset, serialOldFromNew);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  BOOST_REQUIRE(oldFromNew == serialOldFromNew);
+  CheckMatrices(tree.Dataset(), serialTree.Dataset());
+  CheckSameStructure(tree, serialTree);
+
+  // The mappings must still be correct.
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Dataset()(0, i), dataset(0, oldFromNew[i]));
+    BOOST_REQUIRE_EQUAL(tree.Dataset()(2, i), dataset(2, oldFromNew[i]));
+  }
+}
+
+/**
+ * Building an octree in parallel should give the same tree as building it
+ * serially.
+ */
+BOOST_AUTO_TEST_CASE(ParallelConstructionTest)
+{
+  CheckParallelConstruction<Octree<>>();
+}
+
+/**
+ * The points of an octree are sorted in Z-order before the splits, so building
+ * an octree on the dataset of another one must not move any point.
+ */
+BOOST_AUTO_TEST_CASE(MortonOrderTest)
+{
+  arma::mat dataset;
+  dataset.randu(3, 5000);
+
+  Octree<> tree(dataset, 5);
+
+  std::vector<size_t> oldFromNew;
+  Octree<> sortedTree(tree.Dataset(), oldFromNew, 5);
+
+  CheckMatrices(tree.Dataset(), sortedTree.Dataset());
+  CheckSameStructure(tree, sortedTree);
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], i);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,128 @@
+/**
+ * @file parallel_test.cpp
+ *
+ * Tests for ParallelFor(), ParallelInvoke() and the functions that set the
+ * number of threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/parallel.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+
+BOOST_AUTO_TEST_SUITE(ParallelTest);
+
+/**
+ * Make sure that ParallelFor() calls the function exactly once for each index,
+ * for several grain sizes and numbers of threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelForIndicesTest)
+{
+  for (const size_t grain : { 1, 7, 1000 })
+  {
+    for (const size_t threads : { 0, 1, 3 })
+    {
+      arma::Col<size_t> calls(1003, arma::fill::zeros);
+      ParallelFor(0, calls.n_elem, [&](const size_t i)
+      {
+        calls[i]++;
+      }, grain, threads);
+
+      for (size_t i = 0; i < calls.n_elem; ++i)
+        BOOST_REQUIRE_EQUAL(calls[i], 1);
+    }
+  }
+
+  // An empty range doesn't call the function.
+  size_t calls = 0;
+  ParallelFor(5, 5, [&](const size_t /* i */) { ++calls; });
+  BOOST_REQUIRE_EQUAL(calls, 0);
+}
+
+/**
+ * Make sure that nested ParallelFor() loops and ParallelInvoke() visit every
+ * index once, and only use the threads of the outer loop.
+ */
+BOOST_AUTO_TEST_CASE(NestedParallelForTest)
+{
+  // The checks are done after the loops, since Boost.Test can't be used from
+  // several threads.
+  const size_t outerThreads = ParallelForThreads();
+  arma::Mat<size_t> calls(50, 40, arma::fill::zeros);
+  arma::Mat<size_t> threadIds(50, 40, arma::fill::zeros);
+  arma::Col<size_t> innerThreads(40, arma::fill::zeros);
+  ParallelFor(0, calls.n_cols, [&](const size_t j)
+  {
+    // The inner loop runs in the team of the outer loop.
+    innerThreads[j] = ParallelForThreads();
+    ParallelFor(0, calls.n_rows, [&](const size_t i)
+    {
+      threadIds(i, j) = ThreadId();
+      calls(i, j)++;
+    });
+  });
+
+  for (size_t i = 0; i < calls.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(calls[i], 1);
+    BOOST_REQUIRE_LT(threadIds[i], outerThreads);
+  }
+  for (size_t j = 0; j < innerThreads.n_elem; ++j)
+    BOOST_REQUIRE_LE(innerThreads[j], outerThreads);
+
+  // Sum a range recursively with ParallelInvoke().
+  std::function<size_t(size_t, size_t)> sum = [&](const size_t begin,
+                                                  const size_t end)
+  {
+    if (end - begin <= 16)
+    {
+      size_t result = 0;
+      for (size_t i = begin; i < end; ++i)
+        result += i;
+      return result;
+    }
+
+    size_t left = 0, right = 0;
+    const size_t middle = (begin + end) / 2;
+    ParallelInvoke([&]() { left = sum(begin, middle); },
+                   [&]() { right = sum(middle, end); });
+    return left + right;
+  };
+  BOOST_REQUIRE_EQUAL(sum(0, 10000), 10000 * 9999 / 2);
+}
+
+/**
+ * Make sure that ScopedThreads sets the number of threads while it exists, and
+ * restores it afterwards.
+ */
+BOOST_AUTO_TEST_CASE(ScopedThreadsTest)
+{
+  const size_t threads = Threads();
+  {
+    ScopedThreads scoped(1);
+    BOOST_REQUIRE_EQUAL(Threads(), 1);
+    BOOST_REQUIRE_EQUAL(ParallelForThreads(), 1);
+
+    // 0 leaves the number of threads as it is.
+    ScopedThreads unchanged(0);
+    BOOST_REQUIRE_EQUAL(Threads(), 1);
+  }
+  BOOST_REQUIRE_EQUAL(Threads(), threads);
+
+  #ifdef HAS_OPENMP
+  {
+    ScopedThreads scoped(3);
+    BOOST_REQUIRE_EQUAL(Threads(), 3);
+  }
+  BOOST_REQUIRE_EQUAL(Threads(), threads);
+  #endif
+}
+
+BOOST_AUTO_TEST_SUITE_END();
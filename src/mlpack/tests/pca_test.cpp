@@ -13,6 +13,7 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_pca_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
@@ -207,6 +208,16 @@ BOOST_AUTO_TEST_CASE(ArmaComparisonRandomizedPCATest)
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonIncrementalPCATest)
+{
+  // Use batches smaller than the dataset.
+  IncrementalPCAPolicy decomposition(128);
+  ArmaComparisonPCA<IncrementalPCAPolicy>(false, decomposition);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -236,6 +247,67 @@ BOOST_AUTO_TEST_CASE(RandomizedPCADimensionalityReductionTest)
   PCADimensionalityReduction<RandomizedSVDPolicy>();
 }
 
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does (which should be correct!).
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCADimensionalityReductionTest)
+{
+  IncrementalPCAPolicy decomposition(2);
+  PCADimensionalityReduction<IncrementalPCAPolicy>(false, decomposition);
+}
+
+/**
+ * Make sure that streaming batches of points through the incremental policy
+ * gives the same components and transformed points as exact PCA, with and
+ * without scaling.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAStreamingTest)
+{
+  arma::mat data = arma::randn<arma::mat>(4, 1000);
+  data.row(1) = 3.0 * data.row(0) + 0.5 * data.row(1) + 10.0;
+  data.row(3) *= 20.0;
+
+  for (size_t scale = 0; scale < 2; ++scale)
+  {
+    arma::mat transformed, eigvec;
+    arma::vec eigVal;
+    PCA<ExactSVDPolicy> exactPCA(scale == 1);
+    exactPCA.Apply(data, transformed, eigVal, eigvec);
+
+    // Stream the points in uneven batches.
+    IncrementalPCAPolicy ipca;
+    ipca.Reset(data.n_rows);
+    for (size_t begin = 0; begin < data.n_cols; begin += 300)
+      ipca.Update(data.cols(begin, std::min(begin + 299,
+          (size_t) data.n_cols - 1)));
+
+    BOOST_REQUIRE_EQUAL(ipca.NumPoints(), 1000);
+    CheckMatrices(ipca.Mean(), arma::vec(arma::mean(data, 1)), 1e-5);
+
+    arma::mat streamedEigvec, streamedTransformed;
+    arma::vec streamedEigVal;
+    ipca.Components(streamedEigVal, streamedEigvec, scale == 1);
+    ipca.Transform(data, streamedEigvec, streamedTransformed, scale == 1);
+
+    for (size_t i = 0; i < eigVal.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(streamedEigVal[i], eigVal[i], 1e-5);
+
+    // The components are only defined up to their sign.
+    for (size_t i = 0; i < eigvec.n_cols; ++i)
+    {
+      if (arma::dot(streamedEigvec.col(i), eigvec.col(i)) < 0)
+      {
+        streamedEigvec.col(i) *= -1;
+        streamedTransformed.row(i) *= -1;
+      }
+    }
+
+    CheckMatrices(streamedEigvec, eigvec, 1e-4);
+    CheckMatrices(streamedTransformed, transformed, 1e-4);
+  }
+}
+
 /**
  * Test that dimensionality reduction with QUIC-SVD PCA works the same way
  * as the Exact-SVD PCA method.
@@ -255,4 +255,52 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that parallel training converges on linearly separable data, that
+ * the averaged weights classify it well too, and that Classify() gives the
+ * class of the highest score of each point.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrainSeparable)
+{
+  // Three well-separated Gaussian blobs, sorted by class.
+  const size_t pointsPerClass = 300;
+  mat trainData(2, 3 * pointsPerClass);
+  Row<size_t> labels(3 * pointsPerClass);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    vec center(2, fill::zeros);
+    if (c > 0)
+      center(c - 1) = 10.0;
+
+    for (size_t i = 0; i < pointsPerClass; ++i)
+    {
+      trainData.col(c * pointsPerClass + i) = center + randn<vec>(2);
+      labels(c * pointsPerClass + i) = c;
+    }
+  }
+
+  Perceptron<> p(3, 2, 1000);
+  p.TrainParallel(trainData, labels, 3, false);
+
+  Row<size_t> predictedLabels;
+  p.Classify(trainData, predictedLabels);
+  BOOST_REQUIRE_EQUAL(predictedLabels.n_elem, trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+  {
+    // The labels are the classes with the highest scores.
+    uword maxIndex;
+    vec scores = p.Weights().t() * trainData.col(i) + p.Biases();
+    scores.max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictedLabels(i), maxIndex);
+
+    BOOST_REQUIRE_EQUAL(predictedLabels(i), labels(i));
+  }
+
+  Perceptron<> averaged(3, 2, 1000);
+  averaged.TrainParallel(trainData, labels, 3);
+  averaged.Classify(trainData, predictedLabels);
+  const size_t correct = accu(predictedLabels == labels);
+  BOOST_REQUIRE_GE(correct, 0.95 * trainData.n_cols);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,186 @@
+/**
+ * @file pq_search_test.cpp
+ *
+ * Unit tests for the 'PQSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/pq/pq_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(PQSearchTest);
+
+/**
+ * Make sure that the recall from the codes is reasonable, and that re-ranking
+ * the candidates with the exact distances makes it (almost) perfect.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchRecallTest)
+{
+  math::RandomSeed(5);
+  arma::mat reference(8, 2000, arma::fill::randu);
+  arma::mat query(8, 100, arma::fill::randu);
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, 5, trueNeighbors, trueDistances);
+
+  PQSearch pq(reference, 4);
+  BOOST_REQUIRE_EQUAL(pq.Size(), 2000);
+  BOOST_REQUIRE_EQUAL(pq.Codebook().n_cols, 256);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(query, 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 100);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.7);
+
+  pq.Search(query, reference, 5, neighbors, distances, 100);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.95);
+  BOOST_REQUIRE_SMALL(KNN::EffectiveError(distances, trueDistances), 0.01);
+
+  // The re-ranked distances are exact.
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          query.col(i), reference.col(neighbors(j, i))), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that an inverted index scanning all its lists finds neighbors as
+ * well as the plain index, and that scanning fewer lists returns valid results.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchListsTest)
+{
+  math::RandomSeed(6);
+  arma::mat reference(6, 1500, arma::fill::randu);
+  arma::mat query(6, 50, arma::fill::randu);
+
+  KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, 3, trueNeighbors, trueDistances);
+
+  PQSearch pq(reference, 3, 10, 10);
+  BOOST_REQUIRE_EQUAL(pq.CoarseCentroids().n_cols, 10);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(query, reference, 3, neighbors, distances, 50);
+  BOOST_REQUIRE_GE(KNN::Recall(neighbors, trueNeighbors), 0.95);
+
+  pq.Probes() = 2;
+  pq.Search(query, 3, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), reference.n_cols);
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+    }
+  }
+}
+
+/**
+ * Make sure that points added in several batches are encoded and numbered as
+ * if they were added at once.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchAddTest)
+{
+  arma::mat reference(4, 600, arma::fill::randu);
+  arma::mat query(4, 20, arma::fill::randu);
+
+  math::RandomSeed(7);
+  PQSearch pq1(2, 4);
+  pq1.Train(reference.cols(0, 299));
+  pq1.Add(reference);
+
+  math::RandomSeed(7);
+  PQSearch pq2(2, 4);
+  pq2.Train(reference.cols(0, 299));
+  pq2.Add(reference.cols(0, 99));
+  pq2.Add(reference.cols(100, 599));
+
+  BOOST_REQUIRE_EQUAL(pq2.Size(), 600);
+
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+  pq1.Search(query, 4, neighbors1, distances1);
+  pq2.Search(query, 4, neighbors2, distances2);
+  CheckMatrices(neighbors1, neighbors2);
+  CheckMatrices(distances1, distances2);
+
+  BOOST_REQUIRE_THROW(pq2.Add(arma::mat(3, 10, arma::fill::randu)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that invalid settings and searches are rejected.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchInvalidTest)
+{
+  arma::mat reference(4, 100, arma::fill::randu);
+
+  BOOST_REQUIRE_THROW(PQSearch(reference, 5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(PQSearch(reference, 0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(PQSearch(reference, 2, 101), std::invalid_argument);
+
+  PQSearch untrained;
+  BOOST_REQUIRE_THROW(untrained.Add(reference), std::invalid_argument);
+
+  PQSearch pq(reference, 2);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(pq.Search(reference, 101, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Search(arma::mat(3, 10), 1, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(pq.Search(reference, reference.cols(0, 49), 1,
+      neighbors, distances, 10), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized index gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(PQSearchSerializationTest)
+{
+  arma::mat reference(6, 400, arma::fill::randu);
+  arma::mat query(6, 20, arma::fill::randu);
+
+  PQSearch pq(reference, 3, 4, 2);
+  PQSearch xmlPq, textPq, binaryPq;
+  SerializeObjectAll(pq, xmlPq, textPq, binaryPq);
+
+  BOOST_REQUIRE_EQUAL(xmlPq.Size(), 400);
+  BOOST_REQUIRE_EQUAL(textPq.Probes(), 2);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  pq.Search(query, 3, neighbors, distances);
+  xmlPq.Search(query, 3, xmlNeighbors, xmlDistances);
+  textPq.Search(query, 3, textNeighbors, textDistances);
+  binaryPq.Search(query, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
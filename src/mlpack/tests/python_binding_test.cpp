@@ -71,6 +71,36 @@ BOOST_AUTO_TEST_CASE(PyOptionTest)
   CLI::ClearSettings();
 }
 
+/**
+ * Restoring the same settings again should reset the values of the parameters.
+ */
+BOOST_AUTO_TEST_CASE(RestoreSettingsResetTest)
+{
+  CLI::ClearSettings();
+  programName = "test_reset";
+  PyOption<double> po1(1.0, "reset_double", "test", "", "double", false, true,
+      false);
+  PyOption<int> po2(3, "reset_int", "test", "", "int", false, true, false);
+
+  CLI::RestoreSettings(programName);
+  CLI::GetParam<double>("reset_double") = 5.0;
+  CLI::SetPassed("reset_double");
+  BOOST_REQUIRE(CLI::HasParam("reset_double"));
+
+  CLI::RestoreSettings(programName);
+  BOOST_REQUIRE(!CLI::HasParam("reset_double"));
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<double>("reset_double"), 1.0);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<int>("reset_int"), 3);
+
+  // Settings restored after others were cleared are copied in full.
+  CLI::RestoreSettings("test_unknown", false);
+  BOOST_REQUIRE_EQUAL(CLI::Parameters().count("reset_double"), 0);
+  CLI::RestoreSettings(programName);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<double>("reset_double"), 1.0);
+
+  CLI::ClearSettings();
+}
+
 /**
  * Make sure GetParam() works.
  */
@@ -173,6 +173,208 @@ BOOST_AUTO_TEST_CASE(CartPoleWithDoubleDQN)
   BOOST_REQUIRE(converged);
 }
 
+//! Test DQN with prioritized experience replay in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithPrioritizedDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  size_t episodes = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    PrioritizedReplay<CartPole> replayMethod(10, 10000, 0.6, 0.4);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy),
+        decltype(replayMethod)> agent(std::move(config), std::move(model),
+        std::move(policy), std::move(replayMethod));
+
+    arma::running_stat<double> averageReturn;
+
+    for (episodes = 0; episodes <= 1000; ++episodes)
+    {
+      double episodeReturn = agent.Episode();
+      averageReturn(episodeReturn);
+
+      /**
+       * Reaching running average return 35 is enough to show it works.
+       * For the speed of the test case, I didn't set high criterion.
+       */
+      Log::Debug << "Average return: " << averageReturn.mean()
+          << " Episode return: " << episodeReturn << std::endl;
+      if (averageReturn.mean() > 35)
+      {
+        agent.Deterministic() = true;
+        arma::running_stat<double> testReturn;
+        for (size_t i = 0; i < 10; ++i)
+          testReturn(agent.Episode());
+        Log::Debug << "Average return in deterministic test: "
+            << testReturn.mean() << std::endl;
+        break;
+      }
+    }
+
+    if (episodes < 1000)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN with vectorized environments in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithVectorizedDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  size_t episodes = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    RandomReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy)>
+        agent(std::move(config), std::move(model), std::move(policy),
+        std::move(replayMethod));
+
+    arma::running_stat<double> averageReturn;
+
+    // Each vectorized episode runs 4 episodes of the environment.
+    for (episodes = 0; episodes <= 250; ++episodes)
+    {
+      arma::vec episodeReturns = agent.VectorizedEpisode(4);
+      BOOST_REQUIRE_EQUAL(episodeReturns.n_elem, 4);
+      for (size_t i = 0; i < episodeReturns.n_elem; ++i)
+        averageReturn(episodeReturns[i]);
+
+      Log::Debug << "Average return: " << averageReturn.mean()
+          << " Episode returns: " << episodeReturns.t();
+      if (averageReturn.mean() > 35)
+      {
+        agent.Deterministic() = true;
+        arma::vec testReturns = agent.VectorizedEpisode(10);
+        Log::Debug << "Average return in deterministic test: "
+            << arma::mean(testReturns) << std::endl;
+        break;
+      }
+    }
+
+    if (episodes < 250)
+    {
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
+//! Test DQN with actors and a learner in Cart Pole task.
+BOOST_AUTO_TEST_CASE(CartPoleWithActorLearnerDQN)
+{
+  // It isn't guaranteed that the network will converge in the specified number
+  // of iterations using random weights. If this works 1 of 4 times, I'm fine
+  // with that.
+  size_t rounds = 0;
+  bool converged = false;
+  for (size_t trial = 0; trial < 4; ++trial)
+  {
+    // Set up the network.
+    FFN<MeanSquaredError<>, GaussianInitialization> model(MeanSquaredError<>(),
+        GaussianInitialization(0, 0.001));
+    model.Add<Linear<>>(4, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 20);
+    model.Add<ReLULayer<>>();
+    model.Add<Linear<>>(20, 2);
+
+    // Set up the policy and replay method.
+    GreedyPolicy<CartPole> policy(1.0, 1000, 0.1);
+    RingReplay<CartPole> replayMethod(10, 10000);
+
+    TrainingConfig config;
+    config.StepSize() = 0.01;
+    config.Discount() = 0.9;
+    config.TargetNetworkSyncInterval() = 100;
+    config.ExplorationSteps() = 100;
+    config.DoubleQLearning() = false;
+    config.StepLimit() = 200;
+
+    // Set up the DQN agent.
+    QLearning<CartPole, decltype(model), AdamUpdate, decltype(policy),
+        RingReplay<CartPole>> agent(std::move(config), std::move(model),
+        std::move(policy), std::move(replayMethod));
+
+    // Each round takes 1000 steps with two actors.
+    for (rounds = 0; rounds < 50; ++rounds)
+    {
+      const arma::vec episodeReturns = agent.TrainActorLearner(2, 1000, 10);
+      BOOST_REQUIRE_EQUAL(agent.TotalSteps(), 1000 * (rounds + 1));
+      BOOST_REQUIRE_LE(arma::accu(episodeReturns), 1000.0);
+
+      Log::Debug << "Average return: " << arma::mean(episodeReturns)
+          << std::endl;
+      if (episodeReturns.n_elem > 0 && arma::mean(episodeReturns) > 35)
+        break;
+    }
+
+    if (rounds < 50)
+    {
+      agent.Deterministic() = true;
+      const double testReturn = agent.Episode();
+      Log::Debug << "Return in deterministic test: " << testReturn
+          << std::endl;
+      converged = true;
+      break;
+    }
+  }
+
+  BOOST_REQUIRE(converged);
+}
+
 //! Test DQN in Acrobot task.
 BOOST_AUTO_TEST_CASE(AcrobotWithDQN)
 {
@@ -187,6 +187,38 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   }
 }
 
+/**
+ * If there is one table that holds every reference point, QDAFN looks at all
+ * of them, so the k furthest neighbors should be exact (and sorted furthest
+ * first, like the results of KFN).
+ */
+BOOST_AUTO_TEST_CASE(QDAFNExhaustiveExactTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 100);
+
+  QDAFN<> qdafn(dataset, 1, 100);
+
+  arma::Mat<size_t> neighbors, trueNeighbors;
+  arma::mat distances, trueDistances;
+  qdafn.Search(dataset, 5, neighbors, distances);
+
+  KFN kfn(dataset);
+  kfn.Search(dataset, 5, trueNeighbors, trueDistances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 100);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], trueNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+  }
+
+  // The packed candidate set holds the points of the table in order of their
+  // projection.
+  BOOST_REQUIRE_EQUAL(qdafn.CandidateSet().n_cols, 100);
+  BOOST_REQUIRE_EQUAL(qdafn.NumProjections(), 1);
+}
+
 // Make sure QDAFN works with sparse data.
 BOOST_AUTO_TEST_CASE(SparseTest)
 {
@@ -58,4 +58,65 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * Make sure that the rounds of pairs of dimensions hold each pair once, and
+ * that no two pairs of a round share a dimension.
+ */
+BOOST_AUTO_TEST_CASE(Radical_Test_PairRounds)
+{
+  for (size_t nDims = 1; nDims < 12; ++nDims)
+  {
+    std::vector<std::vector<std::pair<size_t, size_t>>> rounds;
+    Radical::PairRounds(nDims, rounds);
+
+    arma::Mat<size_t> seen(nDims, nDims, arma::fill::zeros);
+    for (size_t r = 0; r < rounds.size(); ++r)
+    {
+      arma::Col<size_t> used(nDims, arma::fill::zeros);
+      for (size_t p = 0; p < rounds[r].size(); ++p)
+      {
+        const size_t i = rounds[r][p].first;
+        const size_t j = rounds[r][p].second;
+        BOOST_REQUIRE_LT(i, j);
+        BOOST_REQUIRE_LT(j, nDims);
+
+        ++seen(i, j);
+        ++used[i];
+        ++used[j];
+      }
+
+      BOOST_REQUIRE_LE(used.max(), 1);
+    }
+
+    for (size_t i = 0; i < nDims; ++i)
+      for (size_t j = i + 1; j < nDims; ++j)
+        BOOST_REQUIRE_EQUAL(seen(i, j), 1);
+  }
+}
+
+/**
+ * Make sure that the unmixing matrix maps the data to the estimated
+ * independent components, and that the same seed gives the same components.
+ */
+BOOST_AUTO_TEST_CASE(Radical_Test_UnmixingMatrix)
+{
+  mat matX;
+  data::Load("data_3d_mixed.txt", matX);
+
+  Radical rad(0.175, 5, 100, matX.n_rows - 1);
+
+  mat matY, matW;
+  math::RandomSeed(12);
+  rad.DoRadical(matX, matY, matW);
+
+  CheckMatrices(matY, matW * matX, 1e-5);
+
+  mat matY2, matW2;
+  math::RandomSeed(12);
+  rad.DoRadical(matX, matY2, matW2);
+
+  CheckMatrices(matY, matY2);
+  CheckMatrices(matW, matW2);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
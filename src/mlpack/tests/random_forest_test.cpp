@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/compact_random_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -116,6 +117,72 @@ BOOST_AUTO_TEST_CASE(EmptyClassifyTest)
       pointProbabilities), std::invalid_argument);
 }
 
+/**
+ * Make sure the multiplicity bootstrap gives distinct points of the dataset, in
+ * order, whose weights are the number of times they were drawn.
+ */
+BOOST_AUTO_TEST_CASE(MultiplicityBootstrapTest)
+{
+  arma::mat dataset(1, 1000);
+  dataset.row(0) = arma::linspace<arma::rowvec>(1000, 1999, 1000);
+  arma::Row<size_t> labels = arma::linspace<arma::Row<size_t>>(0, 999, 1000);
+  arma::rowvec weights(1000);
+  weights.fill(0.5);
+
+  arma::mat bootstrapDataset;
+  arma::Row<size_t> bootstrapLabels;
+  arma::rowvec bootstrapWeights;
+  MultiplicityBootstrap<false>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights);
+
+  BOOST_REQUIRE_EQUAL(bootstrapDataset.n_rows, 1);
+  BOOST_REQUIRE_EQUAL(bootstrapLabels.n_elem, bootstrapDataset.n_cols);
+  BOOST_REQUIRE_EQUAL(bootstrapWeights.n_elem, bootstrapDataset.n_cols);
+  BOOST_REQUIRE_LT(bootstrapDataset.n_cols, 1000);
+  BOOST_REQUIRE_CLOSE(arma::accu(bootstrapWeights), 1000.0, 1e-5);
+  for (size_t i = 0; i < bootstrapDataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(bootstrapDataset(0, i),
+        (double) (1000 + bootstrapLabels[i]));
+    BOOST_REQUIRE_GE(bootstrapWeights[i], 1.0);
+    if (i > 0)
+      BOOST_REQUIRE_GT(bootstrapLabels[i], bootstrapLabels[i - 1]);
+  }
+
+  // With weights, the multiplicities are multiplied by the weights.
+  MultiplicityBootstrap<true>(dataset, labels, weights, bootstrapDataset,
+      bootstrapLabels, bootstrapWeights);
+  BOOST_REQUIRE_CLOSE(arma::accu(bootstrapWeights), 500.0, 1e-5);
+}
+
+/**
+ * Make sure a random forest trained on weighted bootstrap samples performs
+ * well.
+ */
+BOOST_AUTO_TEST_CASE(WeightedBootstrapLearningTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<GiniGain, RandomDimensionSelect> rf;
+  BOOST_REQUIRE_EQUAL(rf.WeightedBootstrap(), false);
+  rf.WeightedBootstrap() = true;
+  rf.Train(dataset, labels, 3, 20 /* 20 trees */, 5);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+
+  const size_t correct = arma::accu(predictions == testLabels);
+  BOOST_REQUIRE_GE(correct, size_t(0.7 * testDataset.n_cols));
+}
+
 /**
  * Test unweighted numeric learning, making sure that we get better performance
  * than a single decision tree.
@@ -395,4 +462,270 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
       binaryProbabilities);
 }
 
+/**
+ * Make sure trees can be added to a trained forest and the oldest trees can be
+ * replaced, and that the forest keeps its number of classes and dimensionality
+ * through serialization.
+ */
+BOOST_AUTO_TEST_CASE(AddAndReplaceTreesTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf;
+  BOOST_REQUIRE_THROW(rf.AddTrees(dataset, labels, 5), std::invalid_argument);
+
+  rf.Train(dataset, labels, 3, 5 /* 5 trees */, 10);
+  BOOST_REQUIRE_EQUAL(rf.NumClasses(), 3);
+  BOOST_REQUIRE_EQUAL(rf.Dimensionality(), dataset.n_rows);
+
+  // Adding trees keeps the old ones.
+  arma::Row<size_t> oldPredictions, newPredictions;
+  rf.Tree(4).Classify(dataset, oldPredictions);
+  rf.AddTrees(dataset, labels, 3, 10);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 8);
+  rf.Tree(4).Classify(dataset, newPredictions);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(oldPredictions[i], newPredictions[i]);
+
+  // The dimensionality must match.
+  arma::mat otherDataset = dataset.rows(0, 1);
+  BOOST_REQUIRE_THROW(rf.AddTrees(otherDataset, labels, 2),
+      std::invalid_argument);
+
+  // Replace the five oldest trees.
+  rf.RemoveOldestTrees(5);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 3);
+  rf.AddTrees(dataset, labels, 5, 10);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 8);
+  BOOST_REQUIRE_THROW(rf.RemoveOldestTrees(9), std::invalid_argument);
+
+  // The forest still learns the training set reasonably.
+  arma::Row<size_t> predictions;
+  rf.Classify(dataset, predictions);
+  BOOST_REQUIRE_GE(arma::accu(predictions == labels),
+      size_t(0.7 * dataset.n_cols));
+
+  // Even an empty forest keeps its classes and dimensionality.
+  RandomForest<> xmlForest, textForest, binaryForest;
+  rf.RemoveOldestTrees(8);
+  SerializeObjectAll(rf, xmlForest, textForest, binaryForest);
+  BOOST_REQUIRE_EQUAL(xmlForest.NumClasses(), 3);
+  BOOST_REQUIRE_EQUAL(textForest.NumClasses(), 3);
+  BOOST_REQUIRE_EQUAL(binaryForest.Dimensionality(), dataset.n_rows);
+
+  binaryForest.AddTrees(dataset, labels, 2, 10);
+  BOOST_REQUIRE_EQUAL(binaryForest.NumTrees(), 2);
+  BOOST_REQUIRE_EQUAL(binaryForest.Tree(0).NumClasses(), 3);
+}
+
+/**
+ * Make sure that a forest trained in shards from the same seed, gathered
+ * through serialization and merged, is the same as the forest trained at once.
+ */
+BOOST_AUTO_TEST_CASE(ShardedTrainingTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  math::RandomSeed(42);
+  RandomForest<> rf(dataset, labels, 3, 7 /* 7 trees */, 10);
+
+  // First three shards of 2, 2 and 3 trees, then eight shards, one of which is
+  // empty.
+  for (size_t numShards = 3; numShards <= 8; numShards += 5)
+  {
+    RandomForest<> merged;
+    for (size_t shard = 0; shard < numShards; ++shard)
+    {
+      math::RandomSeed(42);
+      RandomForest<> part;
+      part.TrainShard(dataset, labels, 3, 7, shard, numShards, 10);
+      BOOST_REQUIRE_EQUAL(part.NumTrees(),
+          (shard + 1) * 7 / numShards - shard * 7 / numShards);
+
+      RandomForest<> xmlPart, textPart, binaryPart;
+      SerializeObjectAll(part, xmlPart, textPart, binaryPart);
+      merged.Merge(std::move(binaryPart));
+      BOOST_REQUIRE_EQUAL(binaryPart.NumTrees(), 0);
+    }
+
+    BOOST_REQUIRE_EQUAL(merged.NumTrees(), 7);
+    BOOST_REQUIRE_EQUAL(merged.NumClasses(), 3);
+    BOOST_REQUIRE_EQUAL(merged.Dimensionality(), dataset.n_rows);
+
+    for (size_t t = 0; t < 7; ++t)
+    {
+      arma::Row<size_t> predictions, mergedPredictions;
+      rf.Tree(t).Classify(dataset, predictions);
+      merged.Tree(t).Classify(dataset, mergedPredictions);
+      for (size_t i = 0; i < dataset.n_cols; ++i)
+        BOOST_REQUIRE_EQUAL(predictions[i], mergedPredictions[i]);
+    }
+
+    arma::Row<size_t> predictions, mergedPredictions;
+    arma::mat probabilities, mergedProbabilities;
+    rf.Classify(dataset, predictions, probabilities);
+    merged.Classify(dataset, mergedPredictions, mergedProbabilities);
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      BOOST_REQUIRE_EQUAL(predictions[i], mergedPredictions[i]);
+    CheckMatrices(probabilities, mergedProbabilities);
+  }
+
+  // Copying merge keeps the other forest.
+  RandomForest<> copy;
+  copy.Merge(rf);
+  BOOST_REQUIRE_EQUAL(copy.NumTrees(), 7);
+  BOOST_REQUIRE_EQUAL(rf.NumTrees(), 7);
+
+  // The shard must exist, and merged forests must match.
+  RandomForest<> part;
+  BOOST_REQUIRE_THROW(part.TrainShard(dataset, labels, 3, 7, 3, 3, 10),
+      std::invalid_argument);
+  part.Train(dataset, labels, 4, 2, 10);
+  BOOST_REQUIRE_THROW(copy.Merge(part), std::invalid_argument);
+  arma::mat otherDataset = dataset.rows(0, 1);
+  part.Train(otherDataset, labels, 3, 2, 10);
+  BOOST_REQUIRE_THROW(copy.Merge(part), std::invalid_argument);
+  BOOST_REQUIRE_EQUAL(copy.NumTrees(), 7);
+}
+
+/**
+ * Make sure that a compact random forest gives the same predictions and
+ * probabilities as the random forest it was built from on numeric data.
+ */
+BOOST_AUTO_TEST_CASE(CompactRandomForestNumericTest)
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    BOOST_FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1);
+  CompactRandomForest crf(rf);
+
+  BOOST_REQUIRE_EQUAL(crf.NumTrees(), 20);
+  BOOST_REQUIRE_EQUAL(crf.NumClasses(), 3);
+
+  arma::Row<size_t> predictions, compactPredictions;
+  arma::mat probabilities, compactProbabilities;
+  rf.Classify(dataset, predictions, probabilities);
+  crf.Classify(dataset, compactPredictions, compactProbabilities);
+
+  CheckMatrices(predictions, compactPredictions);
+  CheckMatrices(probabilities, compactProbabilities);
+
+  // Check the single-point classification too.
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    crf.Classify(dataset.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(prediction, predictions[i]);
+    BOOST_REQUIRE_EQUAL(crf.Classify(dataset.col(i)), predictions[i]);
+    for (size_t j = 0; j < pointProbabilities.n_elem; ++j)
+      BOOST_REQUIRE_CLOSE(pointProbabilities[j] + 1.0,
+          probabilities(j, i) + 1.0, 1e-10);
+  }
+}
+
+/**
+ * Make sure that a compact random forest gives the same predictions and
+ * probabilities as the random forest it was built from on categorical data.
+ */
+BOOST_AUTO_TEST_CASE(CompactRandomForestCategoricalTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  RandomForest<> rf(d, di, l, 5, 10 /* 10 trees */, 5);
+  CompactRandomForest crf(rf);
+
+  arma::Row<size_t> predictions, compactPredictions;
+  arma::mat probabilities, compactProbabilities;
+  rf.Classify(d, predictions, probabilities);
+  crf.Classify(d, compactPredictions, compactProbabilities);
+
+  CheckMatrices(predictions, compactPredictions);
+  CheckMatrices(probabilities, compactProbabilities);
+}
+
+/**
+ * Make sure that a compact forest built from single decision trees gives the
+ * same results as the trees, and that an empty compact forest throws.
+ */
+BOOST_AUTO_TEST_CASE(CompactRandomForestDecisionTreeTest)
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    BOOST_FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  CompactRandomForest crf;
+  arma::Row<size_t> predictions;
+  BOOST_REQUIRE_THROW(crf.Classify(dataset, predictions),
+      std::invalid_argument);
+
+  DecisionTree<> dt(dataset, labels, 3, 5);
+  crf.AddTree(dt);
+
+  arma::Row<size_t> compactPredictions;
+  arma::mat probabilities, compactProbabilities;
+  dt.Classify(dataset, predictions, probabilities);
+  crf.Classify(dataset, compactPredictions, compactProbabilities);
+
+  CheckMatrices(probabilities, compactProbabilities);
+
+  // A tree with a different number of classes can't be added.
+  DecisionTree<> otherDt(dataset, labels, 4, 5);
+  BOOST_REQUIRE_THROW(crf.AddTree(otherDt), std::invalid_argument);
+}
+
+// Make sure we can serialize a compact random forest.
+BOOST_AUTO_TEST_CASE(CompactRandomForestSerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 10);
+  CompactRandomForest crf(rf);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  crf.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  RandomForest<> otherRf(dataset, labels, 3, 3, 50);
+  CompactRandomForest xmlForest, textForest, binaryForest(otherRf);
+  SerializeObjectAll(crf, xmlForest, textForest, binaryForest);
+
+  BOOST_REQUIRE_EQUAL(xmlForest.NumNodes(), crf.NumNodes());
+  BOOST_REQUIRE_EQUAL(textForest.NumNodes(), crf.NumNodes());
+  BOOST_REQUIRE_EQUAL(binaryForest.NumNodes(), crf.NumNodes());
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+
+  xmlForest.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textForest.Classify(dataset, textPredictions, textProbabilities);
+  binaryForest.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -97,4 +97,97 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+/**
+ * Make sure that the generator gives the same numbers for the same seed, and
+ * that jumping ahead gives another stream.
+ */
+BOOST_AUTO_TEST_CASE(XoshiroJumpTest)
+{
+  RandomEngine a(42), b(42);
+  BOOST_REQUIRE(a == b);
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(a(), b());
+
+  RandomEngine c(b);
+  c.Jump();
+  BOOST_REQUIRE(b != c);
+
+  size_t same = 0;
+  for (size_t i = 0; i < 1000; ++i)
+    if (b() == c())
+      ++same;
+  BOOST_REQUIRE_EQUAL(same, 0);
+
+  // Jumping is deterministic too.
+  a.Jump();
+  b = RandomEngine(42);
+  b.discard(100);
+  b.Jump();
+  BOOST_REQUIRE(a == b);
+}
+
+/**
+ * Make sure that RandomStreams() gives distinct generators, and that tasks
+ * drawing from them give the same numbers whatever the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(RandomStreamsTest)
+{
+  const size_t n = 16;
+  RandomSeed(1234);
+  std::vector<RandomEngine> streams = RandomStreams(n);
+  BOOST_REQUIRE_EQUAL(streams.size(), n);
+  for (size_t i = 1; i < n; ++i)
+    BOOST_REQUIRE(streams[i] != streams[i - 1]);
+
+  arma::mat serial(100, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    RandomEngine engine = streams[i];
+    for (size_t j = 0; j < serial.n_rows; ++j)
+      serial(j, i) = UniformFromBits(engine());
+  }
+
+  const RandomEngine engine = randGen;
+  arma::mat parallel(100, n);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    randGen = streams[i];
+    arma::vec column(parallel.n_rows);
+    RandomFill(column);
+    parallel.col(i) = column;
+  }
+  randGen = engine;
+
+  CheckMatrices(serial, parallel);
+}
+
+/**
+ * Make sure that the bulk fill functions give numbers in the right ranges with
+ * about the right moments, and the same numbers as the scalar functions.
+ */
+BOOST_AUTO_TEST_CASE(RandomFillTest)
+{
+  RandomSeed(5);
+  arma::vec uniform(10000);
+  RandomFill(uniform, -2.0, 3.0);
+  BOOST_REQUIRE_GE(uniform.min(), -2.0);
+  BOOST_REQUIRE_LT(uniform.max(), 3.0);
+  BOOST_REQUIRE_SMALL(arma::mean(uniform) - 0.5, 0.1);
+
+  RandomSeed(5);
+  for (size_t i = 0; i < uniform.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(uniform[i], Random(-2.0, 3.0));
+
+  arma::Col<size_t> ints(10000);
+  RandIntFill(ints, 3, 8);
+  BOOST_REQUIRE_EQUAL(ints.min(), 3);
+  BOOST_REQUIRE_EQUAL(ints.max(), 7);
+
+  arma::mat normal(100, 100);
+  RandNormalFill(normal, 1.0, 2.0);
+  BOOST_REQUIRE_SMALL(arma::mean(arma::vectorise(normal)) - 1.0, 0.1);
+  BOOST_REQUIRE_SMALL(arma::stddev(arma::vectorise(normal)) - 2.0, 0.1);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/batch_reader.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -64,4 +65,87 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * A source of batches of the columns of a matrix in memory.
+ */
+class MatrixBatchSource
+{
+ public:
+  MatrixBatchSource(const arma::mat& data) : data(data), position(0) { }
+
+  bool Next(arma::mat& batch, const size_t batchSize)
+  {
+    if (position == data.n_cols)
+      return false;
+
+    const size_t end = std::min(position + batchSize, (size_t) data.n_cols);
+    batch = data.cols(position, end - 1);
+    position = end;
+    return true;
+  }
+
+  void Rewind() { position = 0; }
+
+ private:
+  const arma::mat& data;
+  size_t position;
+};
+
+/**
+ * The randomized SVD of a dataset read a batch at a time, from a file and from
+ * memory in single precision, should be close to the exact SVD of the centered
+ * data.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDApplyBlocksTest)
+{
+  arma::mat data = arma::randn<arma::mat>(20, 3) *
+      arma::diagmat(arma::vec("10 5 1")) * arma::randn<arma::mat>(3, 300);
+  data.each_col() += arma::randu<arma::vec>(20);
+
+  arma::mat centeredData;
+  math::Center(data, centeredData);
+
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  {
+    data::BatchWriter writer("test_rsvd_blocks.mmat", 20, 300);
+    writer.Write(data);
+    writer.Close();
+  }
+
+  arma::mat U2, V2;
+  arma::vec s2;
+  data::BatchReader reader("test_rsvd_blocks.mmat");
+  svd::RandomizedSVD rSVD(0, 2);
+  rSVD.ApplyBlocks(reader, U2, s2, V2, 3, 37);
+  remove("test_rsvd_blocks.mmat");
+
+  BOOST_REQUIRE_EQUAL(U2.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(V2.n_rows, 300);
+
+  double error = arma::norm(s2.subvec(0, 2) - s1.subvec(0, 2), "frob") /
+      arma::norm(s1.subvec(0, 2), "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  // The sketches in single precision give a coarser factorization.
+  MatrixBatchSource source(data);
+  rSVD.ApplyBlocks<float>(source, U2, s2, V2, 3, 50);
+
+  error = arma::norm(s2.subvec(0, 2) - s1.subvec(0, 2), "frob") /
+      arma::norm(s1.subvec(0, 2), "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-3);
+
+  reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  error = arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
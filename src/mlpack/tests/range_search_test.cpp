@@ -1696,4 +1696,381 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * Make sure that the compact results hold the same results, in the same order,
+ * as the vector-of-vectors results, with every search mode.
+ */
+BOOST_AUTO_TEST_CASE(CompactResultTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  const Range r(0.1, 0.3);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(referenceData, mode == 0, mode == 1);
+
+    vector<vector<size_t>> neighbors;
+    vector<vector<double>> distances;
+    RangeSearchResult result;
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      if (mono == 0)
+      {
+        rs.Search(queryData, r, neighbors, distances);
+        rs.Search(queryData, r, result);
+      }
+      else
+      {
+        rs.Search(r, neighbors, distances);
+        rs.Search(r, result);
+      }
+
+      BOOST_REQUIRE_EQUAL(result.NumQueries(), neighbors.size());
+      BOOST_REQUIRE_EQUAL(result.Offsets().n_elem, neighbors.size() + 1);
+
+      size_t total = 0;
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(result.NumNeighbors(i), neighbors[i].size());
+        for (size_t j = 0; j < neighbors[i].size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(result.Neighbor(i, j), neighbors[i][j]);
+          BOOST_REQUIRE_EQUAL(result.Distance(i, j), distances[i][j]);
+        }
+        total += neighbors[i].size();
+      }
+
+      BOOST_REQUIRE_GT(total, 0);
+      BOOST_REQUIRE_EQUAL(result.NumResults(), total);
+    }
+  }
+}
+
+// A range search callback that counts the results and checks each of them.
+class CheckingCallback
+{
+ public:
+  CheckingCallback(const arma::mat& querySet,
+                   const arma::mat& referenceSet,
+                   const Range& range) :
+      querySet(querySet), referenceSet(referenceSet), range(range), count(0)
+  { }
+
+  void operator()(const size_t queryIndex,
+                  const size_t referenceIndex,
+                  const double distance)
+  {
+    const double trueDistance = EuclideanDistance::Evaluate(
+        querySet.col(queryIndex), referenceSet.col(referenceIndex));
+    BOOST_REQUIRE_CLOSE(distance, trueDistance, 1e-5);
+    BOOST_REQUIRE(range.Contains(distance));
+    ++count;
+  }
+
+  const arma::mat& querySet;
+  const arma::mat& referenceSet;
+  const Range& range;
+  size_t count;
+};
+
+/**
+ * Make sure that the streaming search gives each result to the callback once,
+ * with the original indices of the points.
+ */
+BOOST_AUTO_TEST_CASE(CallbackSearchTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 300);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  const Range r(0.1, 0.3);
+
+  // The dual-tree search builds trees on both sets, so both the query and the
+  // reference indices must be mapped.
+  RangeSearch<> rs(referenceData);
+
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  rs.Search(queryData, r, neighbors, distances);
+  size_t total = 0;
+  for (size_t i = 0; i < neighbors.size(); ++i)
+    total += neighbors[i].size();
+
+  CheckingCallback callback(queryData, referenceData, r);
+  rs.Search(queryData, r, callback);
+  BOOST_REQUIRE_GT(callback.count, 0);
+  BOOST_REQUIRE_EQUAL(callback.count, total);
+
+  // Now the monochromatic search.
+  rs.Search(r, neighbors, distances);
+  total = 0;
+  for (size_t i = 0; i < neighbors.size(); ++i)
+    total += neighbors[i].size();
+
+  CheckingCallback monoCallback(referenceData, referenceData, r);
+  rs.Search(r, monoCallback);
+  BOOST_REQUIRE_GT(monoCallback.count, 0);
+  BOOST_REQUIRE_EQUAL(monoCallback.count, total);
+}
+
+/**
+ * Dual-tree range search with large leaves (so that the base cases between
+ * leaves are computed in blocks) should give exactly the same results as naive
+ * search, even on data far from the origin.
+ */
+BOOST_AUTO_TEST_CASE(BlockBaseCaseTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000) + 50.0;
+  arma::mat querySet = arma::randu<arma::mat>(3, 300) + 50.0;
+  const Range range(0.05, 0.15);
+
+  RangeSearch<>::Tree tree(dataset, 64);
+  RangeSearch<> dualTree(&tree);
+  RangeSearch<> naive(tree.Dataset(), true);
+
+  vector<vector<size_t>> neighbors, naiveNeighbors;
+  vector<vector<double>> distances, naiveDistances;
+  dualTree.Search(querySet, range, neighbors, distances);
+  naive.Search(querySet, range, naiveNeighbors, naiveDistances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.size(), naiveNeighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    vector<pair<size_t, double>> results, naiveResults;
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+      results.push_back(make_pair(neighbors[i][j], distances[i][j]));
+    for (size_t j = 0; j < naiveNeighbors[i].size(); ++j)
+    {
+      naiveResults.push_back(make_pair(naiveNeighbors[i][j],
+          naiveDistances[i][j]));
+    }
+    sort(results.begin(), results.end());
+    sort(naiveResults.begin(), naiveResults.end());
+
+    BOOST_REQUIRE_EQUAL(results.size(), naiveResults.size());
+    for (size_t j = 0; j < results.size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(results[j].first, naiveResults[j].first);
+      BOOST_REQUIRE_CLOSE(results[j].second, naiveResults[j].second, 1e-5);
+    }
+  }
+}
+
+/**
+ * Dual-tree range search with the parallel breadth-first traverser should give
+ * the same results as naive search.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBreadthFirstRangeSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 300);
+  const Range range(0.05, 0.15);
+
+  typedef RangeSearch<EuclideanDistance, arma::mat, KDTree,
+      KDTree<EuclideanDistance, RangeSearchStat,
+      arma::mat>::template ParallelBreadthFirstDualTreeTraverser>
+      ParallelRangeSearch;
+
+  ParallelRangeSearch dualTree(dataset);
+  RangeSearch<> naive(dataset, true);
+
+  vector<vector<size_t>> neighbors, naiveNeighbors;
+  vector<vector<double>> distances, naiveDistances;
+  dualTree.Search(querySet, range, neighbors, distances);
+  naive.Search(querySet, range, naiveNeighbors, naiveDistances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.size(), naiveNeighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    vector<pair<size_t, double>> results, naiveResults;
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+      results.push_back(make_pair(neighbors[i][j], distances[i][j]));
+    for (size_t j = 0; j < naiveNeighbors[i].size(); ++j)
+    {
+      naiveResults.push_back(make_pair(naiveNeighbors[i][j],
+          naiveDistances[i][j]));
+    }
+    sort(results.begin(), results.end());
+    sort(naiveResults.begin(), naiveResults.end());
+
+    BOOST_REQUIRE_EQUAL(results.size(), naiveResults.size());
+    for (size_t j = 0; j < results.size(); ++j)
+    {
+      BOOST_REQUIRE_EQUAL(results[j].first, naiveResults[j].first);
+      BOOST_REQUIRE_CLOSE(results[j].second, naiveResults[j].second, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that parallel naive, single-tree and dual-tree search give the same
+ * results as naive search, in both the bichromatic and the monochromatic case.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const Range range(0.05, 0.2);
+  const Range monoRange(0.0, 0.1);
+
+  RangeSearch<> naive(dataset, true);
+  vector<vector<size_t>> naiveNeighbors, naiveMonoNeighbors;
+  vector<vector<double>> naiveDistances, naiveMonoDistances;
+  naive.Search(querySet, range, naiveNeighbors, naiveDistances);
+  naive.Search(monoRange, naiveMonoNeighbors, naiveMonoDistances);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(dataset, mode == 0, mode == 1);
+    rs.Parallel() = true;
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      if (mono == 0)
+        rs.Search(querySet, range, neighbors, distances);
+      else
+        rs.Search(monoRange, neighbors, distances);
+
+      const vector<vector<size_t>>& baselineNeighbors = (mono == 0) ?
+          naiveNeighbors : naiveMonoNeighbors;
+      const vector<vector<double>>& baselineDistances = (mono == 0) ?
+          naiveDistances : naiveMonoDistances;
+
+      BOOST_REQUIRE_EQUAL(neighbors.size(), baselineNeighbors.size());
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        vector<pair<size_t, double>> results, baselineResults;
+        for (size_t j = 0; j < neighbors[i].size(); ++j)
+          results.push_back(make_pair(neighbors[i][j], distances[i][j]));
+        for (size_t j = 0; j < baselineNeighbors[i].size(); ++j)
+        {
+          baselineResults.push_back(make_pair(baselineNeighbors[i][j],
+              baselineDistances[i][j]));
+        }
+        sort(results.begin(), results.end());
+        sort(baselineResults.begin(), baselineResults.end());
+
+        BOOST_REQUIRE_EQUAL(results.size(), baselineResults.size());
+        for (size_t j = 0; j < results.size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(results[j].first, baselineResults[j].first);
+          BOOST_REQUIRE_CLOSE(results[j].second, baselineResults[j].second,
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Check that the count and weight sum callbacks give the numbers and the sums
+ * of the weights of the neighbors found by naive search, with the given type
+ * of range search, in the bichromatic and the monochromatic case.
+ */
+template<typename RangeSearchType>
+void CheckAggregates(const arma::mat& referenceData,
+                     const arma::mat& queryData,
+                     const Range& range,
+                     const bool singleMode)
+{
+  const arma::vec weights = arma::randu<arma::vec>(referenceData.n_cols);
+
+  RangeSearch<> naive(referenceData, true);
+  vector<vector<size_t>> neighbors, monoNeighbors;
+  vector<vector<double>> distances;
+  naive.Search(queryData, range, neighbors, distances);
+  naive.Search(range, monoNeighbors, distances);
+
+  RangeSearchType rs(referenceData, false, singleMode);
+  for (size_t mono = 0; mono < 2; ++mono)
+  {
+    const vector<vector<size_t>>& baseline = (mono == 0) ? neighbors :
+        monoNeighbors;
+
+    arma::Col<size_t> counts(baseline.size(), arma::fill::zeros);
+    arma::vec sums(baseline.size(), arma::fill::zeros);
+    CountResultCallback countCallback(counts);
+    WeightSumResultCallback sumCallback(weights, sums);
+    if (mono == 0)
+    {
+      rs.Search(queryData, range, countCallback);
+      rs.Search(queryData, range, sumCallback);
+    }
+    else
+    {
+      rs.Search(range, countCallback);
+      rs.Search(range, sumCallback);
+    }
+
+    size_t total = 0;
+    for (size_t i = 0; i < baseline.size(); ++i)
+    {
+      double sum = 0.0;
+      for (size_t j = 0; j < baseline[i].size(); ++j)
+        sum += weights[baseline[i][j]];
+
+      BOOST_REQUIRE_EQUAL(counts[i], baseline[i].size());
+      BOOST_REQUIRE_SMALL(sums[i] - sum, 1e-8);
+      total += counts[i];
+    }
+    BOOST_REQUIRE_GT(total, 0);
+  }
+}
+
+/**
+ * Make sure that counting the neighbors, and summing their weights, gives the
+ * same results as finding them, with trees that rearrange the points and with
+ * cover trees (which compute a base case before whole nodes are added).
+ */
+BOOST_AUTO_TEST_CASE(CountAndWeightSumTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  // The range is wide enough that many nodes are entirely inside it.
+  const Range range(0.0, 0.5);
+  CheckAggregates<RangeSearch<>>(referenceData, queryData, range, false);
+  CheckAggregates<RangeSearch<>>(referenceData, queryData, range, true);
+
+  typedef RangeSearch<EuclideanDistance, arma::mat, StandardCoverTree>
+      CoverTreeRangeSearch;
+  CheckAggregates<CoverTreeRangeSearch>(referenceData, queryData, range,
+      false);
+  CheckAggregates<CoverTreeRangeSearch>(referenceData, queryData, range, true);
+
+  // Make sure that the lower bound of the range is respected too.
+  CheckAggregates<RangeSearch<>>(referenceData, queryData, Range(0.2, 0.6),
+      false);
+}
+
+/**
+ * Make sure that RSModel counts the neighbors of the query points in their
+ * original order when it builds a query tree itself.
+ */
+BOOST_AUTO_TEST_CASE(RSModelCountTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  const Range range(0.0, 0.4);
+
+  RangeSearch<> naive(referenceData, true);
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  naive.Search(queryData, range, neighbors, distances);
+
+  RSModel model(RSModel::TreeTypes::BALL_TREE, false);
+  arma::mat referenceCopy(referenceData);
+  model.BuildModel(std::move(referenceCopy), 5, false, false);
+
+  arma::Col<size_t> counts(queryData.n_cols, arma::fill::zeros);
+  CountResultCallback callback(counts);
+  arma::mat queryCopy(queryData);
+  model.Search(std::move(queryCopy), range, callback);
+
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -118,6 +118,66 @@ BOOST_AUTO_TEST_CASE(BinaryRBMClassificationTest)
   BOOST_REQUIRE_GE(rbmClassificationAccuracy, classificationAccuracy - 6.0);
 }
 
+/*
+ * Check the batched free energy of the BinaryRBM against its definition, and
+ * make sure that the Gibbs chains are reproducible and that persistent chains
+ * continue from their last samples.
+ */
+BOOST_AUTO_TEST_CASE(BinaryRBMGibbsChainsTest)
+{
+  const size_t visibleSize = 6;
+  const size_t hiddenSize = 4;
+  const size_t numChains = 40;
+
+  arma::mat data = arma::round(arma::randu<arma::mat>(visibleSize,
+      numChains));
+
+  GaussianInitialization gaussian(0, 0.5);
+  RBM<GaussianInitialization> model(data, gaussian, visibleSize, hiddenSize,
+      numChains, 2, 1, 2, 8, 1, true);
+  RBM<GaussianInitialization> other(data, gaussian, visibleSize, hiddenSize,
+      numChains, 2, 1, 2, 8, 1, true);
+  model.Reset();
+  other.Reset();
+  other.Parameters() = model.Parameters();
+
+  // The free energy of each point.
+  arma::rowvec energies;
+  model.FreeEnergy(data, energies);
+  BOOST_REQUIRE_EQUAL(energies.n_elem, numChains);
+  for (size_t i = 0; i < numChains; ++i)
+  {
+    const arma::vec preActivation = model.Weight().slice(0) * data.col(i) +
+        model.HiddenBias();
+    const double expected = -arma::dot(data.col(i), model.VisibleBias()) -
+        arma::accu(arma::log(1 + arma::exp(preActivation)));
+    BOOST_REQUIRE_CLOSE(energies(i), expected, 1e-5);
+  }
+  BOOST_REQUIRE_CLOSE(model.FreeEnergy(arma::mat(data)),
+      arma::accu(energies), 1e-5);
+
+  // The chains give binary samples, which only depend on the seed.
+  arma::mat output, otherOutput;
+  math::RandomSeed(5);
+  model.Gibbs(arma::mat(data), std::move(output));
+  math::RandomSeed(5);
+  other.Gibbs(arma::mat(data), std::move(otherOutput));
+
+  BOOST_REQUIRE_EQUAL(output.n_rows, visibleSize);
+  BOOST_REQUIRE_EQUAL(output.n_cols, numChains);
+  BOOST_REQUIRE_EQUAL(arma::accu((output != 0) % (output != 1)), 0);
+  BOOST_REQUIRE_EQUAL(arma::accu(output != otherOutput), 0);
+
+  // The persistent chains continue from their state, whatever the input.
+  math::RandomSeed(9);
+  model.Gibbs(arma::zeros<arma::mat>(visibleSize, numChains),
+      std::move(output));
+  math::RandomSeed(9);
+  other.Gibbs(arma::ones<arma::mat>(visibleSize, numChains),
+      std::move(otherOutput));
+  BOOST_REQUIRE_EQUAL(arma::accu(output != otherOutput), 0);
+}
+
 /*
  * Tests the SpikeSlabRBM implementation on the Digits dataset.
  */
@@ -1384,4 +1384,120 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Check that a bulk-loaded tree is valid and gives the same nearest neighbors
+ * as a naive search after more points are inserted into it.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoad(const BulkLoadType bulkLoadType)
+{
+  const size_t numIter = 50;
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+  Tree tree(dataset, bulkLoadType, 20, 6, 5, 2);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), GetMinLevel(tree));
+
+  // The nodes are fully packed: 50 leaves of 20 points, 10 nodes above them
+  // and 2 below the root.
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), 4);
+
+  // Each point must be in exactly one leaf.
+  std::vector<size_t> counts(dataset.n_cols, 0);
+  std::vector<const Tree*> stack(1, &tree);
+  while (!stack.empty())
+  {
+    const Tree* node = stack.back();
+    stack.pop_back();
+    for (size_t i = 0; i < node->NumPoints(); i++)
+      counts[node->Point(i)]++;
+    for (size_t i = 0; i < node->NumChildren(); i++)
+      stack.push_back(&node->Child(i));
+  }
+  for (size_t i = 0; i < counts.size(); i++)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  // Now insert some more points, in the same way as PointDynamicAdd.
+  tree.Dataset().reshape(8, 1000 + numIter);
+  dataset.reshape(8, 1000 + numIter);
+  arma::mat tmpData;
+  tmpData.randu(8, numIter);
+  for (size_t i = 0; i < numIter; i++)
+  {
+    tree.Dataset().col(1000 + i) = tmpData.col(i);
+    dataset.col(1000 + i) = tmpData.col(i);
+    tree.InsertPoint(1000 + i);
+  }
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000 + numIter);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+// Test that trees bulk-loaded with the STR packing are valid and can still be
+// modified.
+BOOST_AUTO_TEST_CASE(STRBulkLoadTest)
+{
+  CheckBulkLoad<RTree>(STR_BULK_LOAD);
+  CheckBulkLoad<RStarTree>(STR_BULK_LOAD);
+  CheckBulkLoad<XTree>(STR_BULK_LOAD);
+}
+
+// Test that trees bulk-loaded with the Hilbert packing are valid and can still
+// be modified.
+BOOST_AUTO_TEST_CASE(HilbertBulkLoadTest)
+{
+  CheckBulkLoad<RTree>(HILBERT_BULK_LOAD);
+  CheckBulkLoad<RStarTree>(HILBERT_BULK_LOAD);
+  CheckBulkLoad<XTree>(HILBERT_BULK_LOAD);
+}
+
+// Test that a tree whose points fit into one leaf is bulk-loaded correctly, and
+// that the moved dataset is taken over.
+BOOST_AUTO_TEST_CASE(SmallBulkLoadTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 15);
+  typedef RTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(std::move(dataset), STR_BULK_LOAD);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_elem, 0);
+  BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 15);
+  BOOST_REQUIRE(tree.IsLeaf());
+  BOOST_REQUIRE_EQUAL(tree.NumPoints(), 15);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1224,4 +1224,158 @@ BOOST_AUTO_TEST_CASE(MultiTimestepTest)
   BOOST_REQUIRE_LE(err, 0.025);
 }
 
+/**
+ * Predict random sequences at once, in windows shorter than the sequences, and
+ * in chunks with PredictStateful(); carrying the state must give the same
+ * predictions each time.
+ */
+template<typename RecurrentLayerType>
+void StatefulPredictionTest()
+{
+  const size_t steps = 12;
+  arma::cube input = arma::randu<arma::cube>(3, 4, steps);
+
+  RNN<MeanSquaredError<> > model(steps);
+  model.Add<Linear<> >(3, 5);
+  model.Add<RecurrentLayerType>(5, 5);
+  model.Add<Linear<> >(5, 2);
+  model.ResetParameters();
+
+  arma::cube prediction;
+  model.Predict(input, prediction);
+  BOOST_REQUIRE_EQUAL(prediction.n_rows, 2);
+  BOOST_REQUIRE_EQUAL(prediction.n_cols, 4);
+  BOOST_REQUIRE_EQUAL(prediction.n_slices, steps);
+
+  // Windows of 5 steps carry the state of the cells from one to the next.
+  model.Rho() = 5;
+  arma::cube windowedPrediction;
+  model.Predict(input, windowedPrediction);
+  CheckMatrices(prediction, windowedPrediction);
+
+  arma::cube first, second;
+  model.PredictStateful(input.slices(0, 6), first);
+  model.PredictStateful(input.slices(7, steps - 1), second);
+  CheckMatrices(arma::cube(prediction.slices(0, 6)), first);
+  CheckMatrices(arma::cube(prediction.slices(7, steps - 1)), second);
+
+  // After ResetState(), the sequences start over.
+  model.ResetState();
+  model.PredictStateful(input.slices(0, 6), first);
+  CheckMatrices(arma::cube(prediction.slices(0, 6)), first);
+}
+
+/**
+ * Ensure LSTMs carry their state across windows and stateful predictions.
+ */
+BOOST_AUTO_TEST_CASE(LSTMStatefulPredictionTest)
+{
+  StatefulPredictionTest<LSTM<> >();
+}
+
+/**
+ * Ensure fast LSTMs carry their state across windows and stateful predictions.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMStatefulPredictionTest)
+{
+  StatefulPredictionTest<FastLSTM<> >();
+}
+
+/**
+ * Ensure GRUs carry their state across windows and stateful predictions.
+ */
+BOOST_AUTO_TEST_CASE(GRUStatefulPredictionTest)
+{
+  StatefulPredictionTest<GRU<> >();
+}
+
+/**
+ * Train on padded sequences of different lengths: the padding must not change
+ * the objective or the gradient, and a padded sequence must have the gradient
+ * of the same sequence without padding.
+ */
+template<typename RecurrentLayerType>
+void SequenceLengthsTest()
+{
+  const size_t steps = 8;
+  arma::cube input = arma::randu<arma::cube>(2, 3, steps);
+  arma::cube responses = arma::randu<arma::cube>(1, 3, steps);
+  arma::Row<size_t> lengths("8 5 3");
+
+  RNN<MeanSquaredError<> > model(steps);
+  model.Add<Linear<> >(2, 4);
+  model.Add<RecurrentLayerType>(4, 4);
+  model.Add<Linear<> >(4, 1);
+  model.ResetParameters();
+
+  model.Predictors() = input;
+  model.Responses() = responses;
+  model.SequenceLengths() = lengths;
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 3);
+
+  // Change the padding.
+  input.subcube(0, 1, 5, 1, 1, steps - 1).randu();
+  input.subcube(0, 2, 3, 1, 2, steps - 1).randu();
+  responses.subcube(0, 1, 5, 0, 1, steps - 1).randu();
+  responses.subcube(0, 2, 3, 0, 2, steps - 1).randu();
+  model.Predictors() = input;
+  model.Responses() = responses;
+  arma::mat paddedGradient;
+  const double paddedObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, paddedGradient, 3);
+
+  BOOST_REQUIRE_CLOSE(objective, paddedObjective, 1e-5);
+  CheckMatrices(gradient, paddedGradient);
+
+  // The last sequence on its own.
+  arma::mat sequenceGradient;
+  const double sequenceObjective = model.EvaluateWithGradient(
+      model.Parameters(), 2, sequenceGradient, 1);
+
+  model.Predictors() = input.subcube(0, 2, 0, 1, 2, 2);
+  model.Responses() = responses.subcube(0, 2, 0, 0, 2, 2);
+  model.SequenceLengths().clear();
+  arma::mat unpaddedGradient;
+  const double unpaddedObjective = model.EvaluateWithGradient(
+      model.Parameters(), 0, unpaddedGradient, 1);
+
+  BOOST_REQUIRE_CLOSE(sequenceObjective, unpaddedObjective, 1e-5);
+  CheckMatrices(sequenceGradient, unpaddedGradient);
+
+  // Training packs the sequences by decreasing length.
+  StandardSGD opt(1e-3, 1, 6, -100, false);
+  model.Train(input, responses, arma::Row<size_t>("3 8 5"), opt);
+  BOOST_REQUIRE_EQUAL(model.SequenceLengths()[0], 8);
+  BOOST_REQUIRE_EQUAL(model.SequenceLengths()[1], 5);
+  BOOST_REQUIRE_EQUAL(model.SequenceLengths()[2], 3);
+  CheckMatrices(arma::mat(model.Predictors().slice(0).col(0)),
+      arma::mat(input.slice(0).col(1)));
+}
+
+/**
+ * Ensure LSTMs ignore the padding of shorter sequences.
+ */
+BOOST_AUTO_TEST_CASE(LSTMSequenceLengthsTest)
+{
+  SequenceLengthsTest<LSTM<> >();
+}
+
+/**
+ * Ensure fast LSTMs ignore the padding of shorter sequences.
+ */
+BOOST_AUTO_TEST_CASE(FastLSTMSequenceLengthsTest)
+{
+  SequenceLengthsTest<FastLSTM<> >();
+}
+
+/**
+ * Ensure GRUs ignore the padding of shorter sequences.
+ */
+BOOST_AUTO_TEST_CASE(GRUSequenceLengthsTest)
+{
+  SequenceLengthsTest<GRU<> >();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/regularized_svd/stratified_sgd.hpp>
 
 #include <ensmallen.hpp>
 
@@ -251,6 +252,122 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimize)
   BOOST_REQUIRE_SMALL(relativeError, 1e-2);
 }
 
+/**
+ * Make sure that StratifiedSGD visits each rating once per epoch, and that the
+ * blocks of a stratum share no user and no item.
+ */
+BOOST_AUTO_TEST_CASE(StratifiedSGDBlocksTest)
+{
+  const size_t numUsers = 40;
+  const size_t numItems = 30;
+  const size_t numRatings = 500;
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  StratifiedSGD strata(data, numUsers, numItems, 4);
+  BOOST_REQUIRE_EQUAL(strata.NumBlocks(), 4);
+  BOOST_REQUIRE_EQUAL(strata.Offsets().n_elem, 17);
+  BOOST_REQUIRE_EQUAL(strata.Offsets()[16], numRatings);
+
+  arma::Col<size_t> visits(numRatings, arma::fill::zeros);
+  arma::Col<size_t> visitStratum(numRatings);
+  arma::Col<size_t> visitBlock(numRatings);
+  size_t stratum = 0;
+  strata.Epoch(
+      [&](const size_t rating, const size_t block)
+      {
+        ++visits[rating];
+        visitStratum[rating] = stratum;
+        visitBlock[rating] = block;
+      },
+      [&]() { ++stratum; });
+
+  BOOST_REQUIRE_EQUAL(stratum, 4);
+  for (size_t i = 0; i < numRatings; ++i)
+    BOOST_REQUIRE_EQUAL(visits[i], 1);
+
+  // In each stratum, every user and every item belongs to a single block.
+  for (size_t s = 0; s < 4; ++s)
+  {
+    std::vector<int> userBlocks(numUsers, -1), itemBlocks(numItems, -1);
+    for (size_t i = 0; i < numRatings; ++i)
+    {
+      if (visitStratum[i] != s)
+        continue;
+
+      const size_t user = data(0, i);
+      const size_t item = data(1, i);
+      if (userBlocks[user] == -1)
+        userBlocks[user] = visitBlock[i];
+      if (itemBlocks[item] == -1)
+        itemBlocks[item] = visitBlock[i];
+
+      BOOST_REQUIRE_EQUAL(userBlocks[user], (int) visitBlock[i]);
+      BOOST_REQUIRE_EQUAL(itemBlocks[item], (int) visitBlock[i]);
+    }
+  }
+}
+
+// Test Regularized SVD with the stratified parallel SGD.
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeStratified)
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t iterations = 30;
+  const size_t rank = 10;
+  const double alpha = 0.01;
+  const double lambda = 0.01;
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  // Make the Reg SVD function and the optimizer; the step size doesn't decay
+  // during the run, and each iteration is one epoch.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+  ExponentialBackoff decayPolicy(10 * iterations, alpha, 0.5);
+  ParallelSGD<ExponentialBackoff> optimizer(iterations + 1, numRatings, 1e-10,
+      true, decayPolicy);
+
+  // Obtain optimized parameters after training.
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  // Get predicted ratings from optimized parameters.
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  // Calculate relative error.
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  // Relative error should be small.
+  BOOST_REQUIRE_SMALL(relativeError, 1e-2);
+}
+
 // The test is only compiled if the user has specified OpenMP to be
 // used.
 #ifdef HAS_OPENMP
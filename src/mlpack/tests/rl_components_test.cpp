@@ -19,6 +19,8 @@
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/ring_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/prioritized_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -166,6 +168,275 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Construct a ring replay instance and check that it stores and samples the
+ * transitions like random replay, with one frame for each state of an episode.
+ */
+BOOST_AUTO_TEST_CASE(RingReplayTest)
+{
+  RingReplay<MountainCar> replay(1, 3);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+  replay.Store(state, action, reward, nextState, env.IsTerminal(nextState));
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+
+  //! So far there should be only one record in the memory
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  CheckMatrices(state.Encode(), sampledState);
+  BOOST_REQUIRE_EQUAL(action, arma::as_scalar(sampledAction));
+  BOOST_REQUIRE_CLOSE(reward, arma::as_scalar(sampledReward), 1e-5);
+  CheckMatrices(nextState.Encode(), sampledNextState);
+  BOOST_REQUIRE_EQUAL(false, arma::as_scalar(sampledTerminal));
+  BOOST_REQUIRE_EQUAL(1, replay.Size());
+  BOOST_REQUIRE_EQUAL(2, replay.Frames());
+
+  //! Continue the episode; each new transition only adds its next state.
+  MountainCar::State lastState = nextState;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    MountainCar::State newState;
+    reward = env.Sample(lastState, action, newState);
+    replay.Store(lastState, action, reward, newState, false);
+    lastState = newState;
+  }
+  BOOST_REQUIRE_EQUAL(3, replay.Size());
+  BOOST_REQUIRE_EQUAL(4, replay.Frames());
+
+  //! Overwrite the memory with a nonsense record; these transitions don't
+  //! share frames, so only two of them fit.
+  for (size_t i = 0; i < 5; ++i)
+    replay.Store(nextState, action, reward, state, true);
+
+  BOOST_REQUIRE_EQUAL(2, replay.Size());
+
+  //! Sample several times, the original record shouldn't appear
+  for (size_t i = 0; i < 30; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+
+    CheckMatrices(state.Encode(), sampledNextState);
+    CheckMatrices(nextState.Encode(), sampledState);
+    BOOST_REQUIRE_EQUAL(true, arma::as_scalar(sampledTerminal));
+  }
+}
+
+/**
+ * Check that ring replay puts the stacks of frames back together, also after
+ * the ring buffer has wrapped around.
+ */
+BOOST_AUTO_TEST_CASE(RingReplayFrameStackTest)
+{
+  // Each state holds the last two frames (t, -t) of the episode, with the
+  // oldest frame first.
+  RingReplay<MountainCar> replay(16, 10, 4, 2);
+  arma::colvec frames(4);
+  frames(0) = 0;
+  frames(1) = 0;
+  frames(2) = 0;
+  frames(3) = 0;
+
+  MountainCar::State state(frames);
+  for (size_t t = 1; t <= 30; ++t)
+  {
+    frames(0) = frames(2);
+    frames(1) = frames(3);
+    frames(2) = t;
+    frames(3) = -((double) t);
+    MountainCar::State nextState(frames);
+    replay.Store(state, MountainCar::Action::forward, t, nextState, false);
+    state = nextState;
+
+    if (t == 6)
+    {
+      // The first state has both of its frames, and each transition adds one.
+      BOOST_REQUIRE_EQUAL(6, replay.Size());
+      BOOST_REQUIRE_EQUAL(8, replay.Frames());
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(10, replay.Size());
+
+  arma::mat sampledStates, sampledNextStates;
+  arma::icolvec sampledActions, sampledTerminal;
+  arma::colvec sampledRewards;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    replay.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, sampledTerminal);
+
+    BOOST_REQUIRE_EQUAL(sampledStates.n_rows, 4);
+    BOOST_REQUIRE_EQUAL(sampledStates.n_cols, 16);
+    for (size_t j = 0; j < sampledStates.n_cols; ++j)
+    {
+      // Only the last ten transitions are held, and the states have to be
+      // consistent with their rewards.
+      const double t = sampledRewards(j);
+      BOOST_REQUIRE_GE(t, 21);
+      BOOST_REQUIRE_CLOSE(sampledStates(0, j), t - 2, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledStates(1, j), 2 - t, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledStates(2, j), t - 1, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledStates(3, j), 1 - t, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextStates(0, j), t - 1, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextStates(1, j), 1 - t, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextStates(2, j), t, 1e-5);
+      BOOST_REQUIRE_CLOSE(sampledNextStates(3, j), -t, 1e-5);
+    }
+  }
+}
+
+/**
+ * Check that the sum tree gives the right sums and finds the right elements.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeTest)
+{
+  // A capacity that isn't a power of two.
+  SumTree<double> tree(5);
+  const arma::vec values("1.0 0.0 2.5 0.5 3.0");
+  for (size_t i = 0; i < values.n_elem; ++i)
+    tree.Set(i, values[i]);
+
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 7.0, 1e-10);
+  for (size_t i = 0; i < values.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(tree.Get(i), values[i]);
+
+  // Check the element found for a range of masses.
+  arma::vec cumulative = arma::cumsum(values);
+  for (double mass = 0.0; mass < 7.0; mass += 0.1)
+  {
+    size_t expected = 0;
+    while (cumulative[expected] <= mass)
+      ++expected;
+
+    BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(mass), expected);
+  }
+
+  // Masses past the end (from rounding errors) give the last nonzero element.
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(7.0), 4);
+
+  // Update a value.
+  tree.Set(4, 0.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 4.0, 1e-10);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(3.9), 3);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(4.0), 3);
+}
+
+/**
+ * Check that prioritized replay samples the experiences in proportion to their
+ * priority, and that updating the priorities changes the sampling.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayTest)
+{
+  PrioritizedReplay<MountainCar> replay(100, 4, 1.0, 1.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+
+  // Store four experiences with different rewards to tell them apart.
+  for (size_t i = 0; i < 4; ++i)
+    replay.Store(state, action, (double) i, nextState, false);
+  BOOST_REQUIRE_EQUAL(replay.Size(), 4);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  BOOST_REQUIRE_EQUAL(sampledState.n_cols, 100);
+  BOOST_REQUIRE_EQUAL(sampledReward.n_elem, 100);
+
+  // Give a priority of 0 to every experience except the third one.
+  arma::mat target(3, 100, arma::fill::zeros);
+  arma::colvec tdErrors(100);
+  for (size_t i = 0; i < 100; ++i)
+    tdErrors[i] = (sampledReward[i] == 2.0) ? 10.0 : 0.0;
+  replay.Update(target, sampledAction, tdErrors);
+
+  // Now (almost) only the third experience can be sampled, so all the weights
+  // are the same.
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(sampledReward[i], 2.0);
+    BOOST_REQUIRE_EQUAL(replay.SampledIndices()[i], 2);
+    BOOST_REQUIRE_CLOSE(replay.Weights()[i], 1.0, 1e-5);
+  }
+}
+
+/**
+ * Check the importance-sampling weights of prioritized replay, and that they
+ * are applied to the targets.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayWeightsTest)
+{
+  PrioritizedReplay<MountainCar> replay(4, 2, 1.0, 1.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+
+  replay.Store(state, action, 0.0, nextState, false);
+  replay.Store(state, action, 1.0, nextState, false);
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  // Both experiences have the same priority, so each is sampled twice and the
+  // weights are all 1.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(replay.SampledIndices()[i], (i < 2) ? 0 : 1);
+    BOOST_REQUIRE_CLOSE(replay.Weights()[i], 1.0, 1e-5);
+  }
+
+  // Give priorities 3 and 1 to the experiences.
+  arma::mat target(3, 4, arma::fill::zeros);
+  arma::colvec tdErrors(4);
+  for (size_t i = 0; i < 4; ++i)
+    tdErrors[i] = (sampledReward[i] == 0.0) ? 3.0 : -1.0;
+  replay.Update(target, sampledAction, tdErrors);
+
+  // Now the probabilities are 0.75 and 0.25, so the weights are
+  // (2 * 0.75)^-1 / 2 and (2 * 0.25)^-1 / 2.
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(replay.SampledIndices()[i], (i < 3) ? 0 : 1);
+    BOOST_REQUIRE_CLOSE(replay.Weights()[i], (i < 3) ? (1.0 / 3.0) : 1.0,
+        1e-3);
+  }
+
+  // The error of the sampled action is scaled by the weight.
+  target.zeros();
+  tdErrors.fill(3.0);
+  replay.Update(target, sampledAction, tdErrors);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_SMALL(target(sampledAction[i], i) - 3.0 *
+        (replay.Weights()[i] - 1.0), 1e-10);
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
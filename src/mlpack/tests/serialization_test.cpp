@@ -361,6 +361,29 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeOverwriteTest)
   CheckTrees(tree, xmlTree, textTree, binaryTree);
 }
 
+/**
+ * Make sure that a tree saved in the blob format is loaded as the same tree,
+ * with its nodes packed.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeBlobTest)
+{
+  arma::mat data;
+  data.randu(3, 100);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data);
+
+  arma::mat otherData;
+  otherData.randu(5, 50);
+  TreeType blobTree(otherData);
+
+  BOOST_REQUIRE(data::Save("tree.blob", "tree", tree));
+  BOOST_REQUIRE(data::Load("tree.blob", "tree", blobTree));
+  remove("tree.blob");
+
+  BOOST_REQUIRE(blobTree.IsPacked());
+  CheckTrees(tree, blobTree, blobTree, blobTree);
+}
+
 BOOST_AUTO_TEST_CASE(CoverTreeTest)
 {
   arma::mat data;
@@ -656,6 +679,97 @@ BOOST_AUTO_TEST_CASE(KNNTest)
   CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
 }
 
+/**
+ * Make sure that a KNN model saved in the blob format gives the same results,
+ * and that a file that isn't a blob model is rejected.
+ */
+BOOST_AUTO_TEST_CASE(KNNBlobTest)
+{
+  using neighbor::KNN;
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  KNN knn(dataset, DUAL_TREE_MODE);
+  KNN knnBlob;
+
+  BOOST_REQUIRE(data::Save("knn.blob", "knn", knn));
+  BOOST_REQUIRE(data::Load("knn.blob", "knn", knnBlob));
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 1000);
+
+  arma::mat distances, blobDistances;
+  arma::Mat<size_t> neighbors, blobNeighbors;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  knnBlob.Search(querySet, 5, blobNeighbors, blobDistances);
+
+  CheckMatrices(distances, blobDistances, blobDistances, blobDistances);
+  CheckMatrices(neighbors, blobNeighbors, blobNeighbors, blobNeighbors);
+
+  // A model in another format is not a blob model.
+  BOOST_REQUIRE(data::Save("knn.bin", "knn", knn));
+  BOOST_REQUIRE(!data::Load("knn.bin", "knn", knnBlob, false,
+      data::format::blob));
+  remove("knn.blob");
+  remove("knn.bin");
+}
+
+/**
+ * Make sure that a compact blob tree is rebuilt as the same tree.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeCompactBlobTest)
+{
+  arma::mat data;
+  data.randu(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data);
+  TreeType compactTree(data);
+
+  BOOST_REQUIRE(data::Save("tree.blob", "tree", tree, false,
+      data::format::compact_blob));
+  BOOST_REQUIRE(data::Load("tree.blob", "tree", compactTree));
+  remove("tree.blob");
+
+  CheckTrees(tree, compactTree, compactTree, compactTree);
+}
+
+/**
+ * Make sure that a KNN model saved as a compact blob is smaller than a blob,
+ * and gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(KNNCompactBlobTest)
+{
+  using neighbor::KNN;
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+
+  KNN knn(dataset, DUAL_TREE_MODE);
+  KNN knnBlob;
+
+  BOOST_REQUIRE(data::Save("knn.blob", "knn", knn));
+  BOOST_REQUIRE(data::Save("knn-compact.blob", "knn", knn, false,
+      data::format::compact_blob));
+  BOOST_REQUIRE(data::Load("knn-compact.blob", "knn", knnBlob));
+
+  std::ifstream blobFile("knn.blob", std::ios::binary | std::ios::ate);
+  std::ifstream compactFile("knn-compact.blob", std::ios::binary |
+      std::ios::ate);
+  BOOST_REQUIRE_LT((size_t) compactFile.tellg(), (size_t) blobFile.tellg());
+  blobFile.close();
+  compactFile.close();
+  remove("knn.blob");
+  remove("knn-compact.blob");
+
+  arma::mat querySet = arma::randu<arma::mat>(5, 1000);
+
+  arma::mat distances, blobDistances;
+  arma::Mat<size_t> neighbors, blobNeighbors;
+
+  knn.Search(querySet, 5, neighbors, distances);
+  knnBlob.Search(querySet, 5, blobNeighbors, blobDistances);
+
+  CheckMatrices(distances, blobDistances, blobDistances, blobDistances);
+  CheckMatrices(neighbors, blobNeighbors, blobNeighbors, blobNeighbors);
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTest)
 {
   using regression::SoftmaxRegression;
@@ -1055,16 +1169,17 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
+  BOOST_REQUIRE_EQUAL(lsh.NumBuckets(), xmlLsh.NumBuckets());
+  BOOST_REQUIRE_EQUAL(lsh.NumBuckets(), textLsh.NumBuckets());
+  BOOST_REQUIRE_EQUAL(lsh.NumBuckets(), binaryLsh.NumBuckets());
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+  for (size_t i = 0; i < lsh.NumBuckets(); ++i)
+  {
+    CheckMatrices(lsh.Bucket(i), xmlLsh.Bucket(i), textLsh.Bucket(i),
+        binaryLsh.Bucket(i));
+  }
 }
 
 // Make sure serialization works for the decision stump.
@@ -0,0 +1,229 @@
+/**
+ * @file shared_tree_test.cpp
+ *
+ * Tests for MultiStatistic and for the trees shared by NeighborSearch,
+ * RangeSearch and KDE.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/shared_tree/shared_tree.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+using namespace mlpack::kernel;
+using namespace mlpack::math;
+using namespace mlpack::metric;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::tree;
+
+typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+    SharedKDTree> SharedKNN;
+typedef NeighborSearch<FurthestNeighborSort, EuclideanDistance, arma::mat,
+    SharedKDTree> SharedKFN;
+typedef SharedKNN::Tree SharedTreeType;
+
+BOOST_AUTO_TEST_SUITE(SharedTreeTest);
+
+/**
+ * Map the results of a search on a shared tree back to the original indices
+ * of the reference points (and of the query points, for monochromatic search).
+ */
+void MapResults(const std::vector<size_t>& oldFromNew,
+                const bool monochromatic,
+                arma::Mat<size_t>& neighbors,
+                arma::mat& distances)
+{
+  arma::Mat<size_t> mappedNeighbors(neighbors.n_rows, neighbors.n_cols);
+  arma::mat mappedDistances(distances.n_rows, distances.n_cols);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    const size_t column = monochromatic ? oldFromNew[i] : i;
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      mappedNeighbors(j, column) = oldFromNew[neighbors(j, i)];
+    mappedDistances.col(column) = distances.col(i);
+  }
+
+  neighbors = std::move(mappedNeighbors);
+  distances = std::move(mappedDistances);
+}
+
+/**
+ * Make sure that each statistic of a MultiStatistic is separate, and that
+ * GetStatistic() gives the statistic itself for other statistic types.
+ */
+BOOST_AUTO_TEST_CASE(MultiStatisticTest)
+{
+  typedef MultiStatistic<NeighborSearchStat<NearestNeighborSort>,
+      NeighborSearchStat<FurthestNeighborSort>, RangeSearchStat> StatType;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+  KDTree<EuclideanDistance, StatType, arma::mat> tree(dataset);
+
+  StatType& stat = tree.Stat();
+  BOOST_REQUIRE_EQUAL(GetStatistic<NeighborSearchStat<NearestNeighborSort>>(
+      stat).FirstBound(), DBL_MAX);
+  BOOST_REQUIRE_EQUAL(GetStatistic<NeighborSearchStat<FurthestNeighborSort>>(
+      stat).FirstBound(), 0.0);
+
+  GetStatistic<RangeSearchStat>(stat).LastDistance() = 3.0;
+  GetStatistic<NeighborSearchStat<NearestNeighborSort>>(stat).LastDistance() =
+      2.0;
+  const StatType& constStat = stat;
+  BOOST_REQUIRE_EQUAL(GetStatistic<RangeSearchStat>(constStat).LastDistance(),
+      3.0);
+  BOOST_REQUIRE_EQUAL(GetStatistic<NeighborSearchStat<NearestNeighborSort>>(
+      constStat).LastDistance(), 2.0);
+  BOOST_REQUIRE_EQUAL(GetStatistic<NeighborSearchStat<FurthestNeighborSort>>(
+      constStat).LastDistance(), 0.0);
+
+  RangeSearchStat rangeStat;
+  BOOST_REQUIRE_EQUAL(&GetStatistic<RangeSearchStat>(rangeStat), &rangeStat);
+}
+
+/**
+ * Make sure that nearest and furthest neighbor search on one shared tree give
+ * the same results as with their own trees.
+ */
+BOOST_AUTO_TEST_CASE(SharedTreeNeighborSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  std::vector<size_t> oldFromNew;
+  SharedTreeType tree(dataset, oldFromNew);
+
+  SharedKNN knn(&tree);
+  SharedKFN kfn(&tree);
+
+  arma::Mat<size_t> neighbors, sharedNeighbors;
+  arma::mat distances, sharedDistances;
+
+  KNN baselineKNN(dataset);
+  baselineKNN.Search(querySet, 5, neighbors, distances);
+  knn.Search(querySet, 5, sharedNeighbors, sharedDistances);
+  MapResults(oldFromNew, false, sharedNeighbors, sharedDistances);
+  CheckMatrices(neighbors, sharedNeighbors);
+  CheckMatrices(distances, sharedDistances);
+
+  KFN baselineKFN(dataset);
+  baselineKFN.Search(querySet, 5, neighbors, distances);
+  kfn.Search(querySet, 5, sharedNeighbors, sharedDistances);
+  MapResults(oldFromNew, false, sharedNeighbors, sharedDistances);
+  CheckMatrices(neighbors, sharedNeighbors);
+  CheckMatrices(distances, sharedDistances);
+}
+
+/**
+ * Make sure that monochromatic searches on a shared tree, which modify the
+ * statistics of the tree, are correct when several objects take turns on it.
+ */
+BOOST_AUTO_TEST_CASE(SharedTreeMonochromaticTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+
+  std::vector<size_t> oldFromNew;
+  SharedTreeType tree(dataset, oldFromNew);
+
+  SharedKNN knn1(&tree), knn2(&tree);
+  SharedKFN kfn(&tree);
+
+  arma::Mat<size_t> knnNeighbors, kfnNeighbors, sharedNeighbors;
+  arma::mat knnDistances, kfnDistances, sharedDistances;
+
+  KNN baselineKNN(dataset);
+  baselineKNN.Search(4, knnNeighbors, knnDistances);
+  KFN baselineKFN(dataset);
+  baselineKFN.Search(4, kfnNeighbors, kfnDistances);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    knn1.Search(4, sharedNeighbors, sharedDistances);
+    MapResults(oldFromNew, true, sharedNeighbors, sharedDistances);
+    CheckMatrices(knnNeighbors, sharedNeighbors);
+    CheckMatrices(knnDistances, sharedDistances);
+
+    kfn.Search(4, sharedNeighbors, sharedDistances);
+    MapResults(oldFromNew, true, sharedNeighbors, sharedDistances);
+    CheckMatrices(kfnNeighbors, sharedNeighbors);
+    CheckMatrices(kfnDistances, sharedDistances);
+
+    knn2.Search(4, sharedNeighbors, sharedDistances);
+    MapResults(oldFromNew, true, sharedNeighbors, sharedDistances);
+    CheckMatrices(knnNeighbors, sharedNeighbors);
+    CheckMatrices(knnDistances, sharedDistances);
+  }
+}
+
+/**
+ * Make sure that range search and KDE on a shared tree give the same results
+ * as with their own trees, and that the tree still works for neighbor search
+ * afterwards.
+ */
+BOOST_AUTO_TEST_CASE(SharedTreeRangeSearchKDETest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  std::vector<size_t> oldFromNew;
+  SharedTreeType tree(dataset, oldFromNew);
+
+  // Range search.
+  const Range range(0.1, 0.3);
+  RangeSearch<> baselineRS(dataset);
+  std::vector<std::vector<size_t>> neighbors, sharedNeighbors;
+  std::vector<std::vector<double>> distances, sharedDistances;
+  baselineRS.Search(querySet, range, neighbors, distances);
+
+  RangeSearch<EuclideanDistance, arma::mat, SharedKDTree> rs(&tree);
+  rs.Search(querySet, range, sharedNeighbors, sharedDistances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.size(), sharedNeighbors.size());
+  for (size_t i = 0; i < neighbors.size(); ++i)
+  {
+    for (size_t j = 0; j < sharedNeighbors[i].size(); ++j)
+      sharedNeighbors[i][j] = oldFromNew[sharedNeighbors[i][j]];
+    std::sort(neighbors[i].begin(), neighbors[i].end());
+    std::sort(sharedNeighbors[i].begin(), sharedNeighbors[i].end());
+    BOOST_REQUIRE(neighbors[i] == sharedNeighbors[i]);
+  }
+
+  // KDE.
+  KDE<GaussianKernel, EuclideanDistance, arma::mat> baselineKDE(0.01, 0.0,
+      GaussianKernel(0.2));
+  baselineKDE.Train(dataset);
+  arma::vec estimations, sharedEstimations;
+  baselineKDE.Evaluate(querySet, estimations);
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, SharedKDTree> kde(0.01,
+      0.0, GaussianKernel(0.2));
+  kde.Train(&tree, &oldFromNew);
+  kde.Evaluate(querySet, sharedEstimations);
+
+  BOOST_REQUIRE_EQUAL(estimations.n_elem, sharedEstimations.n_elem);
+  for (size_t i = 0; i < estimations.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(estimations[i], sharedEstimations[i], 1e-5);
+
+  // The tree is still usable for neighbor search.
+  arma::Mat<size_t> knnNeighbors, sharedKNNNeighbors;
+  arma::mat knnDistances, sharedKNNDistances;
+  KNN baselineKNN(dataset);
+  baselineKNN.Search(querySet, 3, knnNeighbors, knnDistances);
+  SharedKNN knn(&tree);
+  knn.Search(querySet, 3, sharedKNNNeighbors, sharedKNNDistances);
+  MapResults(oldFromNew, false, sharedKNNNeighbors, sharedKNNDistances);
+  CheckMatrices(knnNeighbors, sharedKNNNeighbors);
+  CheckMatrices(knnDistances, sharedKNNDistances);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
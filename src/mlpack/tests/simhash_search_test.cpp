@@ -0,0 +1,216 @@
+/**
+ * @file simhash_search_test.cpp
+ *
+ * Unit tests for the 'SimHashSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/core/kernels/cosine_distance.hpp>
+#include <mlpack/methods/lsh/simhash_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(SimHashSearchTest);
+
+/**
+ * Make sure that the Hamming distance counts the differing bits of all the
+ * words.
+ */
+BOOST_AUTO_TEST_CASE(SimHashHammingDistanceTest)
+{
+  const uint64_t a[3] = { 0, 0xFFFFFFFFFFFFFFFFULL, 0x00F0 };
+  const uint64_t b[3] = { 0x8000000000000001ULL, 0, 0x0F00 };
+
+  BOOST_REQUIRE_EQUAL(SimHashSearch::HammingDistance(a, a, 3), 0);
+  BOOST_REQUIRE_EQUAL(SimHashSearch::HammingDistance(a, b, 1), 2);
+  BOOST_REQUIRE_EQUAL(SimHashSearch::HammingDistance(a, b, 3), 74);
+  BOOST_REQUIRE_EQUAL(SimHashSearch::HammingDistance(b, a, 3), 74);
+}
+
+/**
+ * Make sure that the codes do not depend on the norm of the points, and that
+ * the code of the opposite of a point has all its bits flipped.
+ */
+BOOST_AUTO_TEST_CASE(SimHashCodesTest)
+{
+  arma::mat reference(5, 50, arma::fill::randn);
+  SimHashSearch simhash(reference, 10, 3);
+
+  BOOST_REQUIRE_EQUAL(simhash.Codes().size(), 150);
+  BOOST_REQUIRE_EQUAL(simhash.Projections().n_rows, 30);
+  BOOST_REQUIRE_EQUAL(simhash.Projections().n_cols, 5);
+
+  arma::mat points(5, 3);
+  points.col(0) = reference.col(4);
+  points.col(1) = 3.0 * reference.col(4);
+  points.col(2) = -reference.col(4);
+  std::vector<uint64_t> codes;
+  simhash.Hash(points, codes);
+
+  BOOST_REQUIRE_EQUAL(codes.size(), 9);
+  const uint64_t mask = (((uint64_t) 1) << 10) - 1;
+  for (size_t t = 0; t < 3; ++t)
+  {
+    BOOST_REQUIRE_EQUAL(codes[t], simhash.Codes()[4 * 3 + t]);
+    BOOST_REQUIRE_EQUAL(codes[3 + t], codes[t]);
+    BOOST_REQUIRE_EQUAL(codes[6 + t], ~codes[t] & mask);
+  }
+}
+
+/**
+ * Make sure that the neighbors are exact when every point is a candidate: with
+ * a single bit and one probe, both buckets are searched.
+ */
+BOOST_AUTO_TEST_CASE(SimHashExactTest)
+{
+  arma::mat reference(6, 200, arma::fill::randn);
+  arma::mat query(6, 20, arma::fill::randn);
+
+  SimHashSearch simhash(reference, 1, 1, 1);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  simhash.Search(query, 4, neighbors, distances);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    arma::vec trueDistances(reference.n_cols);
+    for (size_t j = 0; j < reference.n_cols; ++j)
+    {
+      trueDistances[j] = 1.0 - kernel::CosineDistance::Evaluate(query.col(i),
+          reference.col(j));
+    }
+    const arma::uvec order = arma::sort_index(trueDistances);
+
+    for (size_t j = 0; j < 4; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), order[j]);
+      BOOST_REQUIRE_CLOSE(distances(j, i), trueDistances[order[j]], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that slightly perturbed reference points find the point they come
+ * from, with and without multiprobe and Hamming re-ranking.
+ */
+BOOST_AUTO_TEST_CASE(SimHashRecallTest)
+{
+  math::RandomSeed(7);
+  arma::mat reference(20, 2000, arma::fill::randn);
+  const arma::uvec sources = arma::regspace<arma::uvec>(0, 10, 1999);
+  arma::mat query = reference.cols(sources);
+  query += 0.1 * arma::randn<arma::mat>(query.n_rows, query.n_cols);
+
+  SimHashSearch simhash(reference, 12, 10);
+  for (size_t s = 0; s < 3; ++s)
+  {
+    simhash.Probes() = (s == 0) ? 0 : 4;
+    simhash.Rerank() = (s == 2) ? 5 : 0;
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    simhash.Search(query, 1, neighbors, distances);
+
+    size_t found = 0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+      if (neighbors(0, i) == sources[i])
+        ++found;
+
+    BOOST_REQUIRE_GE((double) found / query.n_cols, 0.95);
+  }
+}
+
+/**
+ * Make sure that a point is not its own neighbor when the reference set is
+ * searched.
+ */
+BOOST_AUTO_TEST_CASE(SimHashMonochromaticTest)
+{
+  arma::mat reference(8, 300, arma::fill::randn);
+  SimHashSearch simhash(reference, 4, 4, 2);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  simhash.Search(3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 300);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+      if (neighbors(j, i) != SIZE_MAX)
+      {
+        BOOST_REQUIRE_LT(neighbors(j, i), 300);
+        BOOST_REQUIRE_GE(distances(j, i), -1e-10);
+        BOOST_REQUIRE_LE(distances(j, i), 2.0 + 1e-10);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that invalid settings and searches throw.
+ */
+BOOST_AUTO_TEST_CASE(SimHashInvalidTest)
+{
+  arma::mat reference(4, 100, arma::fill::randn);
+
+  BOOST_REQUIRE_THROW(SimHashSearch(reference, 0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(SimHashSearch(reference, 65), std::invalid_argument);
+  BOOST_REQUIRE_THROW(SimHashSearch(reference, 8, 0), std::invalid_argument);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  SimHashSearch untrained;
+  BOOST_REQUIRE_THROW(untrained.Search(reference, 1, neighbors, distances),
+      std::invalid_argument);
+
+  SimHashSearch simhash(reference, 8, 2);
+  BOOST_REQUIRE_THROW(simhash.Search(reference, 101, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(simhash.Search(100, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(simhash.Search(arma::mat(3, 10), 1, neighbors,
+      distances), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(SimHashSerializationTest)
+{
+  arma::mat reference(6, 400, arma::fill::randn);
+  arma::mat query(6, 20, arma::fill::randn);
+
+  SimHashSearch simhash(reference, 8, 5, 3, 50);
+  SimHashSearch xmlSimHash, textSimHash, binarySimHash;
+  SerializeObjectAll(simhash, xmlSimHash, textSimHash, binarySimHash);
+
+  BOOST_REQUIRE_EQUAL(xmlSimHash.Bits(), 8);
+  BOOST_REQUIRE_EQUAL(textSimHash.Probes(), 3);
+  BOOST_REQUIRE_EQUAL(binarySimHash.Rerank(), 50);
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  simhash.Search(query, 3, neighbors, distances);
+  xmlSimHash.Search(query, 3, xmlNeighbors, xmlDistances);
+  textSimHash.Search(query, 3, textNeighbors, textDistances);
+  binarySimHash.Search(query, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -38,7 +38,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -83,9 +83,9 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionRegularizationEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -125,8 +125,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -668,4 +668,214 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * Make sure that the objective function and its gradient are the same for the
+ * sparse and dense representations of the same data, with and without the
+ * intercept term.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSparseTest)
+{
+  const size_t points = 500;
+  const size_t inputSize = 20;
+  const size_t numClasses = 4;
+
+  arma::sp_mat dataset;
+  dataset.sprandu(inputSize, points, 0.1);
+  arma::mat denseDataset(dataset);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction<> srf(denseDataset, labels, numClasses, 0.1,
+        (intercept == 1));
+    SoftmaxRegressionFunction<arma::sp_mat> srfSparse(dataset, labels,
+        numClasses, 0.1, (intercept == 1));
+
+    arma::mat parameters;
+    parameters.randu(numClasses, inputSize + intercept);
+
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters),
+        srfSparse.Evaluate(parameters), 1e-5);
+    BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters, 100, 50),
+        srfSparse.Evaluate(parameters, 100, 50), 1e-5);
+
+    arma::mat gradient, sparseGradient;
+    srf.Gradient(parameters, gradient);
+    srfSparse.Gradient(parameters, sparseGradient);
+    CheckMatrices(gradient, sparseGradient, 1e-5);
+
+    srf.Gradient(parameters, 100, gradient, 50);
+    srfSparse.Gradient(parameters, 100, sparseGradient, 50);
+    CheckMatrices(gradient, sparseGradient, 1e-5);
+  }
+}
+
+/**
+ * Make sure that EvaluateWithGradient() gives the same objective and gradient
+ * as Evaluate() and Gradient(), with any number of threads and for batches
+ * that span several of the blocks of points handled in parallel.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluateWithGradientTest)
+{
+  const size_t points = 1500;
+  const size_t inputSize = 15;
+  const size_t numClasses = 6;
+
+  arma::mat dataset;
+  dataset.randu(inputSize, points);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction<> srf(dataset, labels, numClasses, 0.1,
+        (intercept == 1));
+
+    arma::mat parameters;
+    parameters.randu(numClasses, inputSize + intercept);
+
+    arma::mat gradient;
+    srf.Gradient(parameters, gradient);
+    const double objective = srf.Evaluate(parameters);
+    arma::mat batchGradient;
+    srf.Gradient(parameters, 200, batchGradient, 700);
+    const double batchObjective = srf.Evaluate(parameters, 200, 700);
+
+    for (size_t threads = 1; threads <= 4; threads *= 2)
+    {
+      ScopedThreads scopedThreads(threads);
+
+      arma::mat fusedGradient;
+      BOOST_REQUIRE_CLOSE(srf.EvaluateWithGradient(parameters, fusedGradient),
+          objective, 1e-5);
+      CheckMatrices(gradient, fusedGradient, 1e-5);
+
+      BOOST_REQUIRE_CLOSE(srf.EvaluateWithGradient(parameters, 200,
+          fusedGradient, 700), batchObjective, 1e-5);
+      CheckMatrices(batchGradient, fusedGradient, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the objective and gradient stay finite and correct when the
+ * logits are too large to be exponentiated directly.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionLargeLogitsTest)
+{
+  const size_t points = 300;
+  const size_t inputSize = 5;
+  const size_t numClasses = 3;
+
+  arma::mat dataset;
+  dataset.randu(inputSize, points);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction<> srf(dataset, labels, numClasses, 0);
+
+  // exp() of these logits overflows.
+  arma::mat parameters;
+  parameters.randu(numClasses, inputSize);
+  parameters *= 1000.0;
+
+  // Compute the negative log likelihood and its gradient with the log-sum-exp
+  // of each point.
+  double objective = 0.0;
+  arma::mat gradient(numClasses, inputSize, arma::fill::zeros);
+  for (size_t i = 0; i < points; ++i)
+  {
+    arma::vec logits = parameters * dataset.col(i);
+    const double maxLogit = arma::max(logits);
+    const double logSum = maxLogit + std::log(arma::accu(arma::exp(logits -
+        maxLogit)));
+    objective += logSum - logits[labels[i]];
+
+    arma::vec probabilities = arma::exp(logits - logSum);
+    probabilities[labels[i]] -= 1.0;
+    gradient += probabilities * dataset.col(i).t();
+  }
+  objective /= points;
+  gradient /= points;
+
+  arma::mat fusedGradient;
+  const double fusedObjective = srf.EvaluateWithGradient(parameters,
+      fusedGradient);
+  BOOST_REQUIRE(std::isfinite(fusedObjective));
+  BOOST_REQUIRE_CLOSE(fusedObjective, objective, 1e-5);
+  CheckMatrices(gradient, fusedGradient, 1e-5);
+
+  arma::mat probabilities;
+  srf.GetProbabilitiesMatrix(parameters, probabilities, 0, points);
+  BOOST_REQUIRE(probabilities.is_finite());
+}
+
+/**
+ * Train softmax regression on the sparse and dense representations of the same
+ * data with L-BFGS and make sure that the models are the same.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseLBFGSTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 800, 0.3);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  SoftmaxRegression sr(denseDataset, labels, 3, 0.1, true);
+  SoftmaxRegression srSparse(dataset, labels, 3, 0.1, true);
+
+  BOOST_REQUIRE_EQUAL(sr.Parameters().n_elem, srSparse.Parameters().n_elem);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sr.Parameters()[i], srSparse.Parameters()[i], 5e-4);
+
+  // The predictions on the sparse data must match too.
+  arma::mat probabilities, sparseProbabilities;
+  srSparse.Classify(denseDataset, probabilities);
+  srSparse.Classify(dataset, sparseProbabilities);
+  CheckMatrices(probabilities, sparseProbabilities, 1e-5);
+
+  BOOST_REQUIRE_CLOSE(srSparse.ComputeAccuracy(denseDataset, labels),
+      srSparse.ComputeAccuracy(dataset, labels), 1e-5);
+}
+
+/**
+ * Train softmax regression on the sparse and dense representations of the same
+ * data with shuffled SGD, and make sure the models are the same: the shuffled
+ * visitation orders must be the same, and the labels must follow their points.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseSGDTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(10, 800, 0.3);
+  arma::mat denseDataset(dataset);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+    labels[i] = math::RandInt(0, 3);
+
+  // Both models start from the same point.
+  SoftmaxRegression sr(10, 3, false);
+  SoftmaxRegression srSparse(sr);
+
+  ens::SGD<> sgd(0.01, 32, 3 * 800);
+  math::RandomSeed(42);
+  sr.Train(denseDataset, labels, 3, sgd);
+
+  ens::SGD<> sgdSparse(0.01, 32, 3 * 800);
+  math::RandomSeed(42);
+  srSparse.Train(dataset, labels, 3, sgdSparse);
+
+  BOOST_REQUIRE_EQUAL(sr.Parameters().n_elem, srSparse.Parameters().n_elem);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sr.Parameters()[i], srSparse.Parameters()[i], 1e-3);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -268,4 +268,69 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * Make sure that EvaluateWithGradient() gives the same results as Evaluate()
+ * and Gradient(), that the batch objectives are consistent with their
+ * gradients, and that computing in float gives about the same results.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionEvaluateWithGradient)
+{
+  const size_t points = 200;
+  const size_t vSize = 12;
+  const size_t hSize = 6;
+
+  arma::mat data;
+  data.randu(vSize, points);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.01, 3, 0.1);
+  const arma::mat parameters = saf.GetInitialPoint();
+
+  arma::mat gradient, fusedGradient;
+  const double cost = saf.Evaluate(parameters);
+  saf.Gradient(parameters, gradient);
+  const double fusedCost = saf.EvaluateWithGradient(parameters,
+      fusedGradient);
+
+  BOOST_REQUIRE_CLOSE(cost, fusedCost, 1e-8);
+  CheckMatrices(gradient, fusedGradient);
+
+  // The whole dataset as one batch is the same as the whole objective.
+  arma::mat batchGradient;
+  BOOST_REQUIRE_CLOSE(saf.EvaluateWithGradient(parameters, 0, batchGradient,
+      points), cost, 1e-8);
+  CheckMatrices(gradient, batchGradient);
+
+  // Check the gradient of a shuffled batch numerically.
+  saf.Shuffle();
+  arma::mat perturbed = parameters;
+  const double batchCost = saf.EvaluateWithGradient(perturbed, 50,
+      batchGradient, 40);
+  BOOST_REQUIRE_CLOSE(saf.Evaluate(perturbed, 50, 40), batchCost, 1e-8);
+
+  const double epsilon = 1e-5;
+  for (size_t i = 0; i < perturbed.n_elem; i += 7)
+  {
+    // The cells that are not parameters have no gradient.
+    perturbed[i] += epsilon;
+    const double costPlus = saf.Evaluate(perturbed, 50, 40);
+    perturbed[i] -= 2 * epsilon;
+    const double costMinus = saf.Evaluate(perturbed, 50, 40);
+    perturbed[i] += epsilon;
+
+    const double numGradient = (costPlus - costMinus) / (2 * epsilon);
+    if (std::abs(numGradient) < 1e-8)
+      BOOST_REQUIRE_SMALL(batchGradient[i], 1e-6);
+    else
+      BOOST_REQUIRE_CLOSE(numGradient, batchGradient[i], 1e-2);
+  }
+
+  // Single precision gives about the same objective and gradient.
+  saf.ComputeInFloat(true);
+  arma::mat floatGradient;
+  BOOST_REQUIRE_CLOSE(saf.EvaluateWithGradient(parameters, floatGradient),
+      cost, 1e-3);
+  BOOST_REQUIRE_LT(arma::norm(floatGradient - gradient, "fro"),
+      1e-4 * std::max(arma::norm(gradient, "fro"), 1.0));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
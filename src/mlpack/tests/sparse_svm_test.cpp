@@ -0,0 +1,184 @@
+/**
+ * @file sparse_svm_test.cpp
+ *
+ * Tests for SparseSVMFunction, HogwildSGD and SparseSVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/sparse_svm/sparse_svm.hpp>
+#include <ensmallen.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+BOOST_AUTO_TEST_SUITE(SparseSVMTest);
+
+/**
+ * Generate sparse points in 50 dimensions whose labels are given by a random
+ * hyperplane.
+ */
+static void SeparableData(const arma::vec& weights,
+                          const size_t points,
+                          arma::sp_mat& data,
+                          arma::Row<size_t>& labels)
+{
+  data = arma::sprandu<arma::sp_mat>(weights.n_elem, points, 0.1);
+  const arma::rowvec scores = weights.t() * data;
+
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+    labels[i] = (scores[i] > 0.0) ? 1 : 0;
+}
+
+/**
+ * Make sure the gradient of each point matches finite differences of its
+ * objective, that Update() takes a step along it, and that the objective of a
+ * batch is the sum of the objectives of its points.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMFunctionGradientTest)
+{
+  const arma::sp_mat data = arma::sprandu<arma::sp_mat>(10, 20, 0.3);
+  arma::vec labels(20);
+  for (size_t i = 0; i < 20; ++i)
+    labels[i] = (i % 2 == 0) ? 1.0 : -1.0;
+
+  SparseSVMFunction function(data, labels, 0.5);
+  BOOST_REQUIRE_EQUAL(function.NumFunctions(), 20);
+  BOOST_REQUIRE_EQUAL(function.InitialPoint().n_rows, 11);
+
+  const arma::mat parameters = arma::randn<arma::mat>(11, 1);
+  double totalObjective = 0.0;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    arma::sp_mat sparseGradient;
+    function.Gradient(parameters, i, sparseGradient);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, 11);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, 1);
+    const arma::mat gradient(sparseGradient);
+
+    for (size_t j = 0; j < 11; ++j)
+    {
+      arma::mat forward = parameters, backward = parameters;
+      forward(j, 0) += 1e-6;
+      backward(j, 0) -= 1e-6;
+      const double numerical = (function.Evaluate(forward, i) -
+          function.Evaluate(backward, i)) / 2e-6;
+
+      BOOST_REQUIRE_SMALL(gradient(j, 0) - numerical, 1e-5);
+    }
+
+    arma::mat updated = parameters;
+    function.Update(updated, i, 0.1);
+    for (size_t j = 0; j < 11; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(updated(j, 0) + 1.0,
+          parameters(j, 0) - 0.1 * gradient(j, 0) + 1.0, 1e-8);
+    }
+
+    totalObjective += function.Evaluate(parameters, i);
+  }
+
+  BOOST_REQUIRE_CLOSE(function.Evaluate(parameters, 0, 20), totalObjective,
+      1e-8);
+}
+
+/**
+ * Train on sparse linearly separable data, and make sure nearly all of the
+ * training and test points are classified correctly.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMSeparableTest)
+{
+  const arma::vec weights = arma::randn<arma::vec>(50);
+  arma::sp_mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  SeparableData(weights, 2000, data, labels);
+  SeparableData(weights, 500, testData, testLabels);
+
+  SparseSVM svm(50, 1e-4);
+  ens::ParallelSGD<ens::ConstantStep> optimizer(50, data.n_cols, 1e-8, true,
+      ens::ConstantStep(0.1));
+  const double objective = svm.Train(data, labels, optimizer);
+
+  BOOST_REQUIRE(std::isfinite(objective));
+  BOOST_REQUIRE_EQUAL(svm.Dimensionality(), 50);
+  BOOST_REQUIRE_GT(svm.ComputeAccuracy(data, labels), 90.0);
+  BOOST_REQUIRE_GT(svm.ComputeAccuracy(testData, testLabels), 85.0);
+
+  // Training on one thread must work the same way.
+  {
+    ScopedThreads threads(1);
+    SparseSVM serialSVM(50, 1e-4);
+    serialSVM.Train(data, labels, optimizer);
+
+    BOOST_REQUIRE_GT(serialSVM.ComputeAccuracy(data, labels), 90.0);
+  }
+
+  // So must the default settings.
+  SparseSVM defaultSVM(data, labels);
+  BOOST_REQUIRE_GT(defaultSVM.ComputeAccuracy(data, labels), 80.0);
+}
+
+/**
+ * Make sure the batch Classify() agrees with the classification of single
+ * points, dense or sparse, and with the decision values.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMClassifyTest)
+{
+  const arma::vec weights = arma::randn<arma::vec>(50);
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  SeparableData(weights, 300, data, labels);
+
+  SparseSVM svm(data, labels);
+
+  arma::Row<size_t> predictions;
+  arma::rowvec scores;
+  svm.Classify(data, predictions, scores);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 300);
+  BOOST_REQUIRE_EQUAL(scores.n_elem, 300);
+
+  const arma::vec& parameters = svm.Parameters();
+  for (size_t i = 0; i < 300; ++i)
+  {
+    const arma::vec point(data.col(i));
+    const arma::sp_vec sparsePoint(data.col(i));
+    BOOST_REQUIRE_EQUAL(svm.Classify(point), predictions[i]);
+    BOOST_REQUIRE_EQUAL(svm.Classify(sparsePoint), predictions[i]);
+    BOOST_REQUIRE_EQUAL(predictions[i], (size_t) (scores[i] >= 0.0 ? 1 : 0));
+
+    const double score = arma::dot(parameters.head(50), point) +
+        parameters[50];
+    BOOST_REQUIRE_SMALL(scores[i] - score, 1e-10);
+  }
+}
+
+/**
+ * Make sure invalid training and test data is rejected.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMInvalidDataTest)
+{
+  const arma::sp_mat data = arma::sprandu<arma::sp_mat>(10, 20, 0.3);
+  arma::Row<size_t> labels(20);
+  labels.zeros();
+  labels[3] = 1;
+
+  SparseSVM svm(10);
+  BOOST_REQUIRE_THROW(svm.Train(data, labels.head(19)), std::invalid_argument);
+
+  labels[5] = 2;
+  BOOST_REQUIRE_THROW(svm.Train(data, labels), std::invalid_argument);
+
+  arma::Row<size_t> predictions;
+  const arma::sp_mat testData = arma::sprandu<arma::sp_mat>(9, 20, 0.3);
+  BOOST_REQUIRE_THROW(svm.Classify(testData, predictions),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
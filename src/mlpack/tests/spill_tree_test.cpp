@@ -15,6 +15,11 @@
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <boost/test/unit_test.hpp>
 #include <stack>
+#include "serialization.hpp"
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
 
 using namespace mlpack;
 using namespace mlpack::tree;
@@ -308,4 +313,149 @@ BOOST_AUTO_TEST_CASE(SpillTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Make sure that the descendants of each node of a tree with overlapping nodes
+ * are the descendants of its left child followed by those of its right child,
+ * and that every point of the dataset is held by some leaf.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeDescendantsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 3000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, 0.05);
+
+  std::vector<bool> found(dataset.n_cols, false);
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+    found[tree.Descendant(i)] = true;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE(found[i]);
+
+  size_t overlappingNodes = 0;
+  std::stack<TreeType*> nodes;
+  nodes.push(&tree);
+  while (!nodes.empty())
+  {
+    TreeType* node = nodes.top();
+    nodes.pop();
+
+    if (node->IsLeaf())
+    {
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+        BOOST_REQUIRE_EQUAL(node->Point(i), node->Descendant(i));
+      continue;
+    }
+
+    if (node->Overlap())
+      ++overlappingNodes;
+
+    const size_t leftDescendants = node->Left()->NumDescendants();
+    for (size_t i = 0; i < leftDescendants; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(node->Descendant(i), node->Left()->Descendant(i));
+    }
+    for (size_t i = 0; i < node->Right()->NumDescendants(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(node->Descendant(leftDescendants + i),
+          node->Right()->Descendant(i));
+    }
+
+    nodes.push(node->Left());
+    nodes.push(node->Right());
+  }
+
+  BOOST_REQUIRE_GT(overlappingNodes, 0);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that a tree built in parallel is the same as one built with a
+ * single thread.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeParallelConstructionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 20000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  TreeType serialTree(dataset, 0.02);
+  omp_set_num_threads(std::max(threads, 4));
+  TreeType parallelTree(dataset, 0.02);
+  omp_set_num_threads(threads);
+
+  std::stack<std::pair<TreeType*, TreeType*>> nodes;
+  nodes.push(std::make_pair(&serialTree, &parallelTree));
+  while (!nodes.empty())
+  {
+    TreeType* serialNode = nodes.top().first;
+    TreeType* parallelNode = nodes.top().second;
+    nodes.pop();
+
+    BOOST_REQUIRE_EQUAL(serialNode->NumChildren(),
+        parallelNode->NumChildren());
+    BOOST_REQUIRE_EQUAL(serialNode->NumDescendants(),
+        parallelNode->NumDescendants());
+    BOOST_REQUIRE_EQUAL(serialNode->Overlap(), parallelNode->Overlap());
+    for (size_t i = 0; i < serialNode->NumDescendants(); ++i)
+    {
+      BOOST_REQUIRE_EQUAL(serialNode->Descendant(i),
+          parallelNode->Descendant(i));
+    }
+
+    if (!serialNode->IsLeaf())
+    {
+      nodes.push(std::make_pair(serialNode->Left(), parallelNode->Left()));
+      nodes.push(std::make_pair(serialNode->Right(), parallelNode->Right()));
+    }
+  }
+}
+#endif
+
+/**
+ * Make sure that a serialized tree has the same structure and points.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeSerializationTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, 0.1);
+  TreeType* xmlTree;
+  TreeType* textTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, textTree, binaryTree);
+
+  for (TreeType* loadedTree : { xmlTree, textTree, binaryTree })
+  {
+    BOOST_REQUIRE_EQUAL(loadedTree->NumDescendants(), tree.NumDescendants());
+    for (size_t i = 0; i < tree.NumDescendants(); ++i)
+      BOOST_REQUIRE_EQUAL(loadedTree->Descendant(i), tree.Descendant(i));
+
+    std::stack<std::pair<TreeType*, TreeType*>> nodes;
+    nodes.push(std::make_pair(&tree, loadedTree));
+    while (!nodes.empty())
+    {
+      TreeType* node = nodes.top().first;
+      TreeType* loadedNode = nodes.top().second;
+      nodes.pop();
+
+      BOOST_REQUIRE_EQUAL(node->NumPoints(), loadedNode->NumPoints());
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+        BOOST_REQUIRE_EQUAL(node->Point(i), loadedNode->Point(i));
+
+      if (!node->IsLeaf())
+      {
+        nodes.push(std::make_pair(node->Left(), loadedNode->Left()));
+        nodes.push(std::make_pair(node->Right(), loadedNode->Right()));
+      }
+    }
+  }
+
+  delete xmlTree;
+  delete textTree;
+  delete binaryTree;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
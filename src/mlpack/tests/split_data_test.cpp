@@ -170,4 +170,88 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Make sure that an in-place split reorders the input into aliases of a
+ * training set and a test set with the right points.
+ */
+BOOST_AUTO_TEST_CASE(SplitInPlaceTest)
+{
+  mat input(10, 497);
+  input.randu();
+  const mat original(input);
+
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  std::tie(trainData, testData, trainLabels, testLabels) =
+      SplitInPlace(input, labels, 0.3);
+
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(testData.n_cols, size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(trainLabels.n_elem, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(testLabels.n_elem, size_t(0.3 * 497));
+
+  // The sets should use the memory of the input.
+  BOOST_REQUIRE_EQUAL(trainData.memptr(), input.memptr());
+  BOOST_REQUIRE_EQUAL(testData.memptr(), input.colptr(trainData.n_cols));
+  BOOST_REQUIRE_EQUAL(trainLabels.memptr(), labels.memptr());
+
+  CompareData(original, trainData, trainLabels);
+  CompareData(original, testData, testLabels);
+  CheckDuplication(trainLabels, testLabels);
+
+  // Without labels, the points should still all be there.
+  mat input2(original);
+  mat trainData2, testData2;
+  std::tie(trainData2, testData2) = SplitInPlace(input2, 0.3);
+  BOOST_REQUIRE_EQUAL(trainData2.n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(testData2.n_cols, size_t(0.3 * 497));
+  CheckMatEqual(original, input2);
+}
+
+/**
+ * Make sure that a stratified split keeps the proportions of the labels, and
+ * that the in-place version gives the same split for the same seed.
+ */
+BOOST_AUTO_TEST_CASE(StratifiedSplitTest)
+{
+  // 3 classes with 100, 50 and 30 points, in blocks.
+  mat input(3, 180);
+  input.randu();
+  Row<size_t> labels(180);
+  labels.subvec(0, 99).fill(0);
+  labels.subvec(100, 149).fill(1);
+  labels.subvec(150, 179).fill(2);
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  math::RandomSeed(12);
+  Split(input, labels, trainData, testData, trainLabels, testLabels, 0.2,
+      true);
+
+  BOOST_REQUIRE_EQUAL(testData.n_cols, 36);
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 144);
+  BOOST_REQUIRE_EQUAL(accu(testLabels == 0), 20);
+  BOOST_REQUIRE_EQUAL(accu(testLabels == 1), 10);
+  BOOST_REQUIRE_EQUAL(accu(testLabels == 2), 6);
+  BOOST_REQUIRE_EQUAL(accu(trainLabels == 0), 80);
+  BOOST_REQUIRE_EQUAL(accu(trainLabels == 1), 40);
+  BOOST_REQUIRE_EQUAL(accu(trainLabels == 2), 24);
+
+  mat input2(input);
+  Row<size_t> labels2(labels);
+  mat trainData2, testData2;
+  Row<size_t> trainLabels2, testLabels2;
+  math::RandomSeed(12);
+  std::tie(trainData2, testData2, trainLabels2, testLabels2) =
+      SplitInPlace(input2, labels2, 0.2, true);
+
+  CheckMatrices(trainData, trainData2);
+  CheckMatrices(testData, testData2);
+  BOOST_REQUIRE(all(trainLabels == trainLabels2));
+  BOOST_REQUIRE(all(testLabels == testLabels2));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
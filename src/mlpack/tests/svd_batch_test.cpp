@@ -192,4 +192,36 @@ BOOST_AUTO_TEST_CASE(SVDBatchNegativeElementTest)
   BOOST_REQUIRE_CLOSE(arma::norm(test, "fro"), arma::norm(result, "fro"), 9.0);
 }
 
+/**
+ * Make sure the sparse updates take the same steps as the dense updates.
+ */
+BOOST_AUTO_TEST_CASE(SVDBatchSparseDenseUpdateTest)
+{
+  sp_mat sparseData;
+  sparseData.sprandu(60, 40, 0.2);
+  mat denseData(sparseData);
+
+  mat sparseW = randu<mat>(60, 4);
+  mat sparseH = randu<mat>(4, 40);
+  mat denseW(sparseW), denseH(sparseH);
+
+  SVDBatchLearning sparseUpdate(0.01, 0.1, 0.2, 0.5);
+  SVDBatchLearning denseUpdate(0.01, 0.1, 0.2, 0.5);
+  sparseUpdate.Initialize(sparseData, 4);
+  denseUpdate.Initialize(denseData, 4);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    sparseUpdate.WUpdate(sparseData, sparseW, sparseH);
+    sparseUpdate.HUpdate(sparseData, sparseW, sparseH);
+    denseUpdate.WUpdate(denseData, denseW, denseH);
+    denseUpdate.HUpdate(denseData, denseW, denseH);
+  }
+
+  for (size_t i = 0; i < sparseW.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparseW[i], denseW[i], 1e-7);
+  for (size_t i = 0; i < sparseH.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(sparseH[i], denseH[i], 1e-7);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -14,6 +14,7 @@
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/termination_policies/incomplete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/complete_incremental_termination.hpp>
@@ -146,4 +147,46 @@ BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalRegularizationTest)
   BOOST_REQUIRE_LT(regularizedRMSE, regularRMSE + 0.105);
 }
 
+/**
+ * Make sure that parallel incremental learning reduces the error of the
+ * factorization of a low-rank sparse matrix.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalConvergenceTest)
+{
+  // Observe a rank-3 matrix at some of its elements.
+  const mat full = randu<mat>(100, 3) * randu<mat>(3, 100);
+  sp_mat data;
+  data.sprandu(100, 100, 0.3);
+  for (sp_mat::iterator it = data.begin(); it != data.end(); ++it)
+    *it = full(it.row(), it.col());
+
+  mat w = randu<mat>(100, 3);
+  mat h = randu<mat>(3, 100);
+
+  // Compute the root mean squared error at the observed elements.
+  auto rmse = [&data](const mat& basis, const mat& encoding)
+  {
+    double sumSquares = 0.0;
+    for (sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+    {
+      const double error = *it - dot(basis.row(it.row()),
+          encoding.col(it.col()));
+      sumSquares += error * error;
+    }
+    return std::sqrt(sumSquares / data.n_nonzero);
+  };
+
+  const double initialRMSE = rmse(w, h);
+
+  SVDParallelIncrementalLearning svd(0.01);
+  svd.Initialize(data, 3);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    svd.WUpdate(data, w, h);
+    svd.HUpdate(data, w, h);
+  }
+
+  BOOST_REQUIRE_LT(rmse(w, h), 0.5 * initialRMSE);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
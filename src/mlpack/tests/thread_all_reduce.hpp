@@ -0,0 +1,85 @@
+/**
+ * @file thread_all_reduce.hpp
+ *
+ * An all-reduce policy over threads, to test the distributed algorithms with
+ * several "processes" in one test.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_THREAD_ALL_REDUCE_HPP
+#define MLPACK_TESTS_THREAD_ALL_REDUCE_HPP
+
+#include <mlpack/core.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace mlpack {
+
+/**
+ * The state shared by the threads of a ThreadAllReduce: each call to Sum()
+ * blocks until every thread has called it, like MPI_Allreduce().
+ */
+class ThreadAllReduceState
+{
+ public:
+  ThreadAllReduceState(const size_t numThreads) :
+      numThreads(numThreads), arrived(0), generation(0) { }
+
+  //! Sum the values over all the threads.
+  void Sum(arma::vec& values)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (arrived == 0)
+      sum = values;
+    else
+      sum += values;
+
+    const size_t currentGeneration = generation;
+    if (++arrived == numThreads)
+    {
+      // The last thread to arrive publishes the sum and wakes the others up.
+      result = sum;
+      arrived = 0;
+      ++generation;
+      condition.notify_all();
+    }
+    else
+    {
+      condition.wait(lock, [&]() { return generation != currentGeneration; });
+    }
+
+    values = result;
+  }
+
+ private:
+  size_t numThreads;
+  size_t arrived;
+  size_t generation;
+  arma::vec sum;
+  arma::vec result;
+  std::mutex mutex;
+  std::condition_variable condition;
+};
+
+/**
+ * An all-reduce policy (see math::SingleProcessAllReduce) for threads that
+ * share a ThreadAllReduceState.
+ */
+class ThreadAllReduce
+{
+ public:
+  ThreadAllReduce(ThreadAllReduceState* state = NULL) : state(state) { }
+
+  void Sum(arma::vec& values) { state->Sum(values); }
+
+ private:
+  ThreadAllReduceState* state;
+};
+
+} // namespace mlpack
+
+#endif
@@ -19,6 +19,8 @@
 #endif
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/hardware_counters.hpp>
+#include <mlpack/core/util/memory_usage.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -147,4 +149,186 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+/**
+ * A scoped timer should be stopped when it goes out of scope, and nested
+ * scoped timers should both be counted.
+ */
+BOOST_AUTO_TEST_CASE(ScopedTimerTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  {
+    ScopedTimer outer("outer_timer");
+    {
+      ScopedTimer inner("inner_timer");
+      #ifdef _WIN32
+      Sleep(10);
+      #else
+      usleep(10000);
+      #endif
+    }
+
+    BOOST_REQUIRE(!CLI::GetSingleton().timer.GetState("inner_timer",
+        std::this_thread::get_id()));
+    BOOST_REQUIRE(CLI::GetSingleton().timer.GetState("outer_timer",
+        std::this_thread::get_id()));
+  }
+
+  BOOST_REQUIRE(!CLI::GetSingleton().timer.GetState("outer_timer",
+      std::this_thread::get_id()));
+  BOOST_REQUIRE_GE(Timer::Get("inner_timer").count(), 10000);
+  BOOST_REQUIRE_GE(Timer::Get("outer_timer").count(),
+      Timer::Get("inner_timer").count());
+}
+
+/**
+ * Counters should accumulate, and should be removed by ResetAll().
+ */
+BOOST_AUTO_TEST_CASE(CounterTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("test_counter"), 0u);
+  Timer::Count("test_counter");
+  Timer::Count("test_counter", 10);
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("test_counter"), 11u);
+
+  // Disabled timing should not change the counters.
+  Timer::DisableTiming();
+  Timer::Count("test_counter", 5);
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("test_counter"), 11u);
+
+  Timer::ResetAll();
+  BOOST_REQUIRE_EQUAL(Timer::GetCount("test_counter"), 0u);
+}
+
+/**
+ * Make sure the JSON and trace exports contain the timers and counters.
+ */
+BOOST_AUTO_TEST_CASE(TimerExportTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+  Timer::EnableTracing();
+
+  {
+    ScopedTimer outer("export_timer");
+    ScopedTimer inner("export_\"inner\"_timer");
+  }
+  Timer::Count("export_counter", 3);
+
+  std::ostringstream json;
+  Timer::ExportJSON(json);
+  BOOST_REQUIRE_NE(json.str().find("\"timers\""), std::string::npos);
+  BOOST_REQUIRE_NE(json.str().find("\"export_timer\": "), std::string::npos);
+  BOOST_REQUIRE_NE(json.str().find("\"export_\\\"inner\\\"_timer\": "),
+      std::string::npos);
+  BOOST_REQUIRE_NE(json.str().find("\"export_counter\": 3"),
+      std::string::npos);
+
+  std::ostringstream trace;
+  Timer::ExportTrace(trace);
+  BOOST_REQUIRE_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.str().find("{\"name\": \"export_timer\", "
+      "\"cat\": \"mlpack\", \"ph\": \"X\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.str().find("{\"name\": \"export_counter\", "
+      "\"ph\": \"C\""), std::string::npos);
+
+  Timer::DisableTracing();
+  Timer::ResetAll();
+}
+
+/**
+ * Make sure that the memory of timers is recorded when memory profiling is
+ * enabled, and is in the JSON export.
+ */
+BOOST_AUTO_TEST_CASE(TimerMemoryTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+  Timer::EnableMemoryProfiling();
+
+  {
+    ScopedTimer t("memory_timer");
+    util::CountAllocation(1000);
+  }
+
+  // Without memory profiling, nothing is recorded.
+  Timer::DisableMemoryProfiling();
+  {
+    ScopedTimer t("no_memory_timer");
+    util::CountAllocation(1000);
+  }
+
+  // Other threads may allocate at the same time.
+  const TimerMemory memory = Timer::GetMemory("memory_timer");
+  BOOST_REQUIRE_GE(memory.allocated, 1000u);
+  #if defined(__linux__) || defined(__APPLE__)
+  BOOST_REQUIRE_GT(memory.peakRSS, 0u);
+  #endif
+
+  const TimerMemory noMemory = Timer::GetMemory("no_memory_timer");
+  BOOST_REQUIRE_EQUAL(noMemory.allocated, 0u);
+  BOOST_REQUIRE_EQUAL(noMemory.peakRSS, 0u);
+
+  std::ostringstream json;
+  Timer::ExportJSON(json);
+  BOOST_REQUIRE_NE(json.str().find("\"memory\""), std::string::npos);
+  BOOST_REQUIRE_NE(json.str().find("\"memory_timer\": {\"peak_rss\": "),
+      std::string::npos);
+  BOOST_REQUIRE_EQUAL(json.str().find("\"no_memory_timer\": {"),
+      std::string::npos);
+
+  Timer::ResetAll();
+}
+
+/**
+ * Make sure that the hardware counters of timers are recorded if they can be
+ * read, and are in the JSON export.
+ */
+BOOST_AUTO_TEST_CASE(TimerHardwareCountersTest)
+{
+  Timer::ResetAll();
+  Timer::EnableTiming();
+  Timer::EnableHardwareCounters();
+
+  // The counters may not be available (for instance in a container).
+  util::HardwareCounterValues values;
+  const bool available = util::ReadHardwareCounters(values);
+
+  double sum = 0.0;
+  {
+    ScopedTimer t("counted_timer");
+    for (size_t i = 0; i < 100000; ++i)
+      sum += std::sqrt((double) i);
+  }
+  BOOST_REQUIRE_GT(sum, 0.0);
+
+  Timer::DisableHardwareCounters();
+
+  const util::HardwareCounterValues counted =
+      Timer::GetHardwareCounters("counted_timer");
+  if (available)
+  {
+    BOOST_REQUIRE_GT(counted.instructions, 100000u);
+    BOOST_REQUIRE_GT(counted.cycles, 0u);
+  }
+  else
+  {
+    BOOST_REQUIRE_EQUAL(counted.instructions, 0u);
+    BOOST_REQUIRE_EQUAL(counted.cycles, 0u);
+  }
+
+  std::ostringstream json;
+  Timer::ExportJSON(json);
+  BOOST_REQUIRE_NE(json.str().find("\"hardware_counters\""),
+      std::string::npos);
+  BOOST_REQUIRE_EQUAL(json.str().find("\"counted_timer\": {\"cycles\": ") !=
+      std::string::npos, available);
+
+  Timer::ResetAll();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
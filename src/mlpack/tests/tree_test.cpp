@@ -1042,6 +1042,65 @@ BOOST_AUTO_TEST_CASE(HRectBoundDiameter)
   BOOST_REQUIRE_SMALL(d.Diameter(), 1e-5);
 }
 
+/**
+ * Make sure that the distances to several bounds at once are the distances to
+ * each of them, and that the minimum and maximum distances agree with
+ * RangeDistance(), for several metrics.
+ */
+template<typename MetricType>
+void CheckBatchRangeDistance()
+{
+  const size_t dim = 7;
+  HRectBound<MetricType> b(dim);
+  std::vector<HRectBound<MetricType>> others(5, HRectBound<MetricType>(dim));
+  for (size_t d = 0; d < dim; ++d)
+  {
+    const double lo = math::Random(-2.0, 2.0);
+    b[d] = math::Range(lo, lo + math::Random(0.0, 1.0));
+    for (size_t i = 0; i < others.size(); ++i)
+    {
+      const double otherLo = math::Random(-2.0, 2.0);
+      others[i][d] = math::Range(otherLo, otherLo + math::Random(0.0, 1.0));
+    }
+  }
+
+  // One bound overlaps this one.
+  others[3] = b;
+
+  std::vector<const HRectBound<MetricType>*> pointers;
+  for (size_t i = 0; i < others.size(); ++i)
+    pointers.push_back(&others[i]);
+
+  std::vector<math::Range> ranges;
+  b.RangeDistance(pointers, ranges);
+  BOOST_REQUIRE_EQUAL(ranges.size(), others.size());
+
+  for (size_t i = 0; i < others.size(); ++i)
+  {
+    const math::Range range = b.RangeDistance(others[i]);
+    BOOST_REQUIRE_CLOSE(ranges[i].Hi(), range.Hi(), 1e-5);
+    BOOST_REQUIRE_CLOSE(ranges[i].Hi(), b.MaxDistance(others[i]), 1e-5);
+    if (i == 3)
+    {
+      BOOST_REQUIRE_SMALL(ranges[i].Lo(), 1e-10);
+      BOOST_REQUIRE_SMALL(b.MinDistance(others[i]), 1e-10);
+    }
+    else
+    {
+      BOOST_REQUIRE_CLOSE(ranges[i].Lo(), range.Lo(), 1e-5);
+      BOOST_REQUIRE_CLOSE(ranges[i].Lo(), b.MinDistance(others[i]), 1e-5);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HRectBoundBatchRangeDistance)
+{
+  CheckBatchRangeDistance<LMetric<1, false>>();
+  CheckBatchRangeDistance<LMetric<2, false>>();
+  CheckBatchRangeDistance<LMetric<2, true>>();
+  CheckBatchRangeDistance<LMetric<3, true>>();
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1803,6 +1862,91 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeMoveConstructorTest)
   BOOST_REQUIRE_EQUAL(tree2.NumChildren(), 2);
 }
 
+/**
+ * Make sure that packing the nodes of a BinarySpaceTree preserves the structure
+ * of the tree and places all of the non-root nodes in contiguous memory.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreePackNodesTest)
+{
+  arma::mat dataset(5, 1000);
+  dataset.randu();
+
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  const NodeLayout layouts[] = { BREADTH_FIRST_LAYOUT, VAN_EMDE_BOAS_LAYOUT };
+  for (size_t l = 0; l < 2; ++l)
+  {
+    TreeType tree(dataset, 5);
+    TreeType packed(dataset, 5);
+    BOOST_REQUIRE(!packed.IsPacked());
+
+    packed.PackNodes(layouts[l]);
+    BOOST_REQUIRE(packed.IsPacked());
+
+    // Moving the tree should keep the arena.
+    TreeType moved(std::move(packed));
+    BOOST_REQUIRE(moved.IsPacked());
+    BOOST_REQUIRE(!packed.IsPacked());
+
+    // Walk both trees simultaneously.
+    std::stack<std::pair<TreeType*, TreeType*>> stack;
+    stack.push(std::make_pair(&tree, &moved));
+    TreeType* minNode = moved.Left();
+    TreeType* maxNode = moved.Left();
+    size_t numNodes = 0;
+    while (!stack.empty())
+    {
+      TreeType* node = stack.top().first;
+      TreeType* packedNode = stack.top().second;
+      stack.pop();
+
+      BOOST_REQUIRE_EQUAL(node->Begin(), packedNode->Begin());
+      BOOST_REQUIRE_EQUAL(node->Count(), packedNode->Count());
+      BOOST_REQUIRE_EQUAL(node->NumChildren(), packedNode->NumChildren());
+      BOOST_REQUIRE_EQUAL(&node->Dataset(), &tree.Dataset());
+      BOOST_REQUIRE_EQUAL(&packedNode->Dataset(), &moved.Dataset());
+      for (size_t d = 0; d < dataset.n_rows; ++d)
+      {
+        BOOST_REQUIRE_EQUAL(node->Bound()[d].Lo(), packedNode->Bound()[d].Lo());
+        BOOST_REQUIRE_EQUAL(node->Bound()[d].Hi(), packedNode->Bound()[d].Hi());
+      }
+
+      if (packedNode != &moved)
+      {
+        ++numNodes;
+        minNode = std::min(minNode, packedNode);
+        maxNode = std::max(maxNode, packedNode);
+      }
+
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(packedNode->Child(i).Parent(), packedNode);
+        stack.push(std::make_pair(&node->Child(i), &packedNode->Child(i)));
+      }
+    }
+
+    // All of the nodes must be adjacent in memory.
+    BOOST_REQUIRE_EQUAL((size_t) (maxNode - minNode) + 1, numNodes);
+
+    // The copy of a packed tree is a regular tree.
+    TreeType copy(moved);
+    BOOST_REQUIRE(!copy.IsPacked());
+    BOOST_REQUIRE_EQUAL(copy.NumDescendants(), tree.NumDescendants());
+  }
+}
+
+/**
+ * PackNodes() may only be called on the root of the tree.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreePackNodesNonRootTest)
+{
+  arma::mat dataset(5, 1000);
+  dataset.randu();
+
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset);
+
+  BOOST_REQUIRE_THROW(tree.Left()->PackNodes(), std::invalid_argument);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -1951,6 +2095,51 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+// Make sure that the furthest descendant distance of each node bounds the
+// distance to all of its descendants.
+template<typename TreeType, typename MetricType>
+void CheckFurthestDescendantDistance(const TreeType& node)
+{
+  const typename TreeType::Mat& dataset = node.Dataset();
+  for (size_t i = 0; i < node.NumDescendants(); ++i)
+  {
+    const double distance = MetricType::Evaluate(dataset.col(node.Point()),
+        dataset.col(node.Descendant(i)));
+    BOOST_REQUIRE_LE(distance, node.FurthestDescendantDistance() + 1e-10);
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CheckFurthestDescendantDistance<TreeType, MetricType>(node.Child(i));
+}
+
+/**
+ * Create a cover tree on low-dimensional clustered data, where most distance
+ * computations during construction can be skipped, and make sure it's
+ * accurate.
+ */
+BOOST_AUTO_TEST_CASE(ClusteredCoverTreeConstructionTest)
+{
+  arma::mat dataset(2, 1500, arma::fill::randn);
+  dataset.cols(500, 999) += 30.0;
+  dataset.cols(1000, 1499) -= 30.0;
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  arma::vec counts;
+  counts.zeros(1500);
+  RecurseTreeCountLeaves(tree, counts);
+
+  for (size_t i = 0; i < 1500; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1500);
+  CheckSelfChild<TreeType>(tree);
+  CheckCovering<TreeType, LMetric<2, true> >(tree);
+  CheckFurthestDescendantDistance<TreeType, LMetric<2, true> >(tree);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -2277,4 +2466,73 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+/**
+ * Make sure that the two given trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameStructure(const TreeType& a, const TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameStructure(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that building the given tree type with all threads gives the same
+ * tree and mappings as building it with one thread.  The dataset is large
+ * enough that the partitions of the top nodes are computed in parallel.
+ */
+template<typename TreeType>
+void CheckParallelConstruction()
+{
+  arma::mat dataset;
+  dataset.randu(3, 100000);
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+
+  std::vector<size_t> serialOldFromNew;
+#ifdef HAS_OPENMP
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  TreeType serialTree(dataset, serialOldFromNew);
+#ifdef HAS_OPENMP
+  omp_set_num_threads(prevNumThreads);
+#endif
+
+  BOOST_REQUIRE(oldFromNew == serialOldFromNew);
+  CheckMatrices(tree.Dataset(), serialTree.Dataset());
+  CheckSameStructure(tree, serialTree);
+
+  // The mappings must still be correct.
+  for (size_t i = 0; i < oldFromNew.size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(tree.Dataset()(0, i), dataset(0, oldFromNew[i]));
+    BOOST_REQUIRE_EQUAL(tree.Dataset()(2, i), dataset(2, oldFromNew[i]));
+  }
+}
+
+/**
+ * Building a kd-tree in parallel should give the same tree as building it
+ * serially.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeParallelConstructionTest)
+{
+  CheckParallelConstruction<KDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+}
+
+/**
+ * Building a mean-split kd-tree in parallel should give the same tree as
+ * building it serially.
+ */
+BOOST_AUTO_TEST_CASE(MeanSplitKDTreeParallelConstructionTest)
+{
+  CheckParallelConstruction<MeanSplitKDTree<EuclideanDistance, EmptyStatistic,
+      arma::mat>>();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,47 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Make sure that the concurrent union-find gives the same components as the
+ * serial one, with the smallest element of each component as its root.
+ */
+BOOST_AUTO_TEST_CASE(ConcurrentUnionFindTest)
+{
+  const size_t n = 10000;
+  arma::uvec pairs = arma::randi<arma::uvec>(4000,
+      arma::distr_param(0, (int) n - 1));
+
+  UnionFind serial(n);
+  ConcurrentUnionFind concurrent(n);
+  for (size_t i = 0; i < pairs.n_elem; i += 2)
+    serial.Union(pairs[i], pairs[i + 1]);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) pairs.n_elem; i += 2)
+    concurrent.Union(pairs[i], pairs[i + 1]);
+
+  // Two elements must be in the same component in both structures, or in
+  // neither.
+  std::map<size_t, size_t> serialToConcurrent;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t serialRoot = serial.Find(i);
+    const size_t concurrentRoot = concurrent.Find(i);
+    BOOST_REQUIRE_LE(concurrentRoot, i);
+    BOOST_REQUIRE_EQUAL(concurrent.Find(concurrentRoot), concurrentRoot);
+
+    if (serialToConcurrent.count(serialRoot) == 0)
+      serialToConcurrent[serialRoot] = concurrentRoot;
+    BOOST_REQUIRE_EQUAL(serialToConcurrent[serialRoot], concurrentRoot);
+  }
+
+  // The smallest element of each component is its root, and the components
+  // are distinct.
+  std::set<size_t> concurrentRoots;
+  for (auto it = serialToConcurrent.begin(); it != serialToConcurrent.end();
+      ++it)
+    concurrentRoots.insert(it->second);
+  BOOST_REQUIRE_EQUAL(concurrentRoots.size(), serialToConcurrent.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END();